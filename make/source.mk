@@ -1,6 +1,10 @@
 COMMON_SRC = \
             build/build_config.c \
             build/debug.c \
+            build/debug_capture.c \
+            build/trace.c \
+            build/profile.c \
+            build/trace.c \
             build/version.c \
             $(TARGET_DIR_SRC) \
             main.c \
@@ -15,9 +19,11 @@ COMMON_SRC = \
             drivers/bus_i2c_soft.c \
             drivers/bus_spi.c \
             drivers/bus_spi_config.c \
+            drivers/bus_spi_dma.c \
             drivers/bus_spi_pinconfig.c \
             drivers/buttons.c \
             drivers/display.c \
+            drivers/dma_common.c \
             drivers/exti.c \
             drivers/io.c \
             drivers/light_led.c \
@@ -26,10 +32,12 @@ COMMON_SRC = \
             drivers/rcc.c \
             drivers/serial.c \
             drivers/serial_pinconfig.c \
+            drivers/serial_tx_paced.c \
             drivers/serial_uart.c \
             drivers/serial_uart_pinconfig.c \
             drivers/sound_beeper.c \
             drivers/stack_check.c \
+            drivers/swi.c \
             drivers/system.c \
             drivers/timer_common.c \
             drivers/timer.c \
@@ -38,15 +46,19 @@ COMMON_SRC = \
             drivers/transponder_ir_erlt.c \
             fc/board_info.c \
             fc/config.c \
+            fc/direct_setpoint.c \
             fc/fc_dispatch.c \
             fc/fc_hardfaults.c \
             fc/fc_tasks.c \
+            fc/flight_summary.c \
+            fc/perf_report.c \
             fc/runtime_config.c \
             interface/msp.c \
             interface/msp_box.c \
             interface/tramp_protocol.c \
             interface/smartaudio_protocol.c \
             io/beeper.c \
+            io/offload.c \
             io/piniobox.c \
             io/serial.c \
             io/statusindicator.c \
@@ -71,6 +83,7 @@ FC_SRC = \
             fc/controlrate_profile.c \
             drivers/camera_control.c \
             drivers/accgyro/gyro_sync.c \
+            drivers/accgyro/accgyro_spi_dma.c \
             drivers/pwm_esc_detect.c \
             drivers/pwm_output.c \
             drivers/rx/rx_spi.c \
@@ -85,12 +98,14 @@ FC_SRC = \
             flight/position.c \
             flight/failsafe.c \
             flight/gps_rescue.c \
+            flight/idle_control.c \
             flight/imu.c \
             flight/mixer.c \
             flight/mixer_tricopter.c \
             flight/pid.c \
             flight/servos.c \
             flight/servos_tricopter.c \
+            flight/thrust_curve.c \
             interface/cli.c \
             interface/settings.c \
             io/serial_4way.c \
@@ -101,6 +116,8 @@ FC_SRC = \
             rx/msp.c \
             rx/pwm.c \
             rx/rx.c \
+            rx/rx_frame_buffer.c \
+            rx/rx_latency.c \
             rx/rx_spi.c \
             rx/crsf.c \
             rx/sbus.c \
@@ -115,12 +132,17 @@ FC_SRC = \
             sensors/acceleration.c \
             sensors/boardalignment.c \
             sensors/compass.c \
+            sensors/compass_calibration.c \
             sensors/gyro.c \
+            sensors/gyro_fusion.c \
             sensors/gyroanalyse.c \
             sensors/initialisation.c \
+            sensors/rpm_filter.c \
             blackbox/blackbox.c \
             blackbox/blackbox_encoding.c \
+            blackbox/blackbox_gyro_capture.c \
             blackbox/blackbox_io.c \
+            blackbox/blackbox_trigger.c \
             cms/cms.c \
             cms/cms_menu_blackbox.c \
             cms/cms_menu_builtin.c \
@@ -139,6 +161,7 @@ FC_SRC = \
             drivers/serial_escserial.c \
             drivers/vtx_common.c \
             io/dashboard.c \
+            io/displayport_framebuffer.c \
             io/displayport_max7456.c \
             io/displayport_msp.c \
             io/displayport_oled.c \
@@ -153,6 +176,7 @@ FC_SRC = \
             sensors/barometer.c \
             sensors/rangefinder.c \
             telemetry/telemetry.c \
+            telemetry/telemetry_values.c \
             telemetry/crsf.c \
             telemetry/srxl.c \
             telemetry/frsky_hub.c \
@@ -165,6 +189,7 @@ FC_SRC = \
             telemetry/ibus.c \
             telemetry/ibus_shared.c \
             sensors/esc_sensor.c \
+            sensors/esc_stats.c \
             io/vtx_string.c \
             io/vtx.c \
             io/vtx_rtc6705.c \
@@ -192,6 +217,8 @@ SIZE_OPTIMISED_SRC  := ""
 
 ifneq ($(TARGET),$(filter $(TARGET),$(F1_TARGETS)))
 SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
+            blackbox/blackbox_gyro_capture.c \
+            build/debug_capture.c \
             common/encoding.c \
             common/filter.c \
             common/maths.c \
@@ -202,6 +229,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             drivers/accgyro/accgyro_mpu6050.c \
             drivers/accgyro/accgyro_mpu6500.c \
             drivers/accgyro/accgyro_spi_bmi160.c \
+            drivers/accgyro/accgyro_spi_dma.c \
             drivers/accgyro/accgyro_spi_icm20689.c \
             drivers/accgyro/accgyro_spi_mpu6000.c \
             drivers/accgyro/accgyro_spi_mpu6500.c \
@@ -216,6 +244,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             drivers/buf_writer.c \
             drivers/bus.c \
             drivers/bus_spi.c \
+            drivers/bus_spi_dma.c \
             drivers/exti.c \
             drivers/io.c \
             drivers/pwm_output.c \
@@ -227,13 +256,20 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             fc/fc_core.c \
             fc/fc_tasks.c \
             fc/fc_rc.c \
+            fc/direct_setpoint.c \
+            fc/flight_summary.c \
+            fc/perf_report.c \
             fc/rc_controls.c \
             fc/runtime_config.c \
+            flight/idle_control.c \
             flight/imu.c \
             flight/mixer.c \
             flight/pid.c \
+            flight/thrust_curve.c \
             rx/ibus.c \
             rx/rx.c \
+            rx/rx_frame_buffer.c \
+            rx/rx_latency.c \
             rx/rx_spi.c \
             rx/crsf.c \
             rx/sbus.c \
@@ -246,7 +282,9 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             sensors/acceleration.c \
             sensors/boardalignment.c \
             sensors/gyro.c \
+            sensors/gyro_fusion.c \
             sensors/gyroanalyse.c \
+            sensors/rpm_filter.c \
             $(CMSIS_SRC) \
             $(DEVICE_STDPERIPH_SRC) \
 
@@ -355,6 +393,7 @@ SRC += \
             drivers/flash.c \
             drivers/flash_m25p16.c \
             drivers/flash_w25m.c \
+            drivers/flash_w25n01g.c \
             io/flashfs.c \
             pg/flash.c \
             $(MSC_SRC)
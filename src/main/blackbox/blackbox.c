@@ -30,10 +30,13 @@
 #include "blackbox.h"
 #include "blackbox_encoding.h"
 #include "blackbox_fielddefs.h"
+#include "blackbox_gyro_capture.h"
 #include "blackbox_io.h"
+#include "blackbox_trigger.h"
 
 #include "build/build_config.h"
 #include "build/debug.h"
+#include "build/profile.h"
 #include "build/version.h"
 
 #include "common/axis.h"
@@ -64,15 +67,20 @@
 #include "flight/servos.h"
 
 #include "io/beeper.h"
+#include "io/flashfs.h"
 #include "io/gps.h"
 #include "io/serial.h"
 
 #include "rx/rx.h"
+#include "rx/rx_latency.h"
+
+#include "scheduler/scheduler.h"
 
 #include "sensors/acceleration.h"
 #include "sensors/barometer.h"
 #include "sensors/battery.h"
 #include "sensors/compass.h"
+#include "sensors/esc_stats.h"
 #include "sensors/gyro.h"
 #include "sensors/rangefinder.h"
 
@@ -84,16 +92,31 @@
 #define DEFAULT_BLACKBOX_DEVICE     BLACKBOX_DEVICE_SERIAL
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 1);
+PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 8);
 
 PG_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig,
     .p_ratio = 32,
     .device = DEFAULT_BLACKBOX_DEVICE,
     .record_acc = 1,
-    .mode = BLACKBOX_MODE_NORMAL
+    .mode = BLACKBOX_MODE_NORMAL,
+    .gyro_capture = BLACKBOX_GYRO_CAPTURE_OFF,
+    .trigger = 0,
+    .trigger_pre_ms = 500,
+    .trigger_post_ms = 1000,
+    .trigger_background_ms = 1000,
+    .rate_control = 1,
+    .high_resolution = 0,
+    .compression = 0,
+    .mirror = BLACKBOX_MIRROR_OFF,
+    .erase_mode = BLACKBOX_ERASE_FULL
 );
 
 #define BLACKBOX_SHUTDOWN_TIMEOUT_MILLIS 200
+#define BLACKBOX_TRIGGER_SHUTDOWN_TIMEOUT_MILLIS 2000 // writing out a full trigger ring over a slow serial port
+#define BLACKBOX_SYSINFO_LINE_TIME_US 20 // time needed to format and write one system information header line
+
+#define BLACKBOX_RATE_SHIFT_MAX 5               // slowest P frame rate is 1/32 of the configured one
+#define BLACKBOX_RATE_RESTORE_INTERVALS 32      // I intervals without back-pressure before the P frame rate is raised again
 
 // Some macros to make writing FLIGHT_LOG_FIELD_* constants shorter:
 
@@ -102,6 +125,7 @@ PG_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig,
 #define CONDITION(x) CONCAT(FLIGHT_LOG_FIELD_CONDITION_, x)
 #define UNSIGNED FLIGHT_LOG_FIELD_UNSIGNED
 #define SIGNED FLIGHT_LOG_FIELD_SIGNED
+#define FIELD_STATE(type, member) .stateType = BLACKBOX_FIELD_STATE_ ## type, .stateOffset = offsetof(blackboxMainState_t, member)
 
 static const char blackboxHeader[] =
     "H Product:Blackbox flight data recorder by Nicholas Sherlock\n"
@@ -149,6 +173,51 @@ typedef struct blackboxConditionalFieldDefinition_s {
     uint8_t condition; // Decide whether this field should appear in the log
 } blackboxConditionalFieldDefinition_t;
 
+typedef struct blackboxMainState_s {
+    uint32_t time;
+
+    int32_t axisPID_P[XYZ_AXIS_COUNT];
+    int32_t axisPID_I[XYZ_AXIS_COUNT];
+    int32_t axisPID_D[XYZ_AXIS_COUNT];
+    int32_t axisPID_F[XYZ_AXIS_COUNT];
+
+    int16_t rcCommand[4];
+    int16_t gyroADC[XYZ_AXIS_COUNT];
+    int16_t setpoint[XYZ_AXIS_COUNT];
+    int16_t accADC[XYZ_AXIS_COUNT];
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    int16_t motor[MAX_SUPPORTED_MOTORS];
+    int16_t servo[MAX_SUPPORTED_SERVOS];
+
+    uint16_t vbatLatest;
+    int32_t amperageLatest;
+
+#ifdef USE_BARO
+    int32_t BaroAlt;
+#endif
+#ifdef USE_MAG
+    int16_t magADC[XYZ_AXIS_COUNT];
+#endif
+#ifdef USE_RANGEFINDER
+    int32_t surfaceRaw;
+#endif
+    uint16_t rssi;
+#ifdef USE_RX_LATENCY_STATISTICS
+    uint16_t rxLatency;
+#endif
+} blackboxMainState_t;
+
+// How a main frame field is stored in blackboxMainState_t
+typedef enum {
+    BLACKBOX_FIELD_STATE_ITERATION = 0, // not stored in the state, the loop iteration of the frame
+    BLACKBOX_FIELD_STATE_U32,
+    BLACKBOX_FIELD_STATE_S32,
+    BLACKBOX_FIELD_STATE_U16,
+    BLACKBOX_FIELD_STATE_S16
+} blackboxFieldStateType_e;
+
+STATIC_ASSERT(sizeof(blackboxMainState_t) <= UINT8_MAX, blackbox_main_state_too_large_for_field_offsets);
+
 typedef struct blackboxDeltaFieldDefinition_s {
     const char *name;
     int8_t fieldNameIndex;
@@ -159,79 +228,91 @@ typedef struct blackboxDeltaFieldDefinition_s {
     uint8_t Ppredict;
     uint8_t Pencode;
     uint8_t condition; // Decide whether this field should appear in the log
+
+    // Where the encoders find the field value, see blackboxFieldStateType_e
+    uint8_t stateType;
+    uint8_t stateOffset;
 } blackboxDeltaFieldDefinition_t;
 
 /**
  * Description of the blackbox fields we are writing in our main intra (I) and inter (P) frames. This description is
- * written into the flight log header so the log can be properly interpreted (but these definitions don't actually cause
- * the encoding to happen, we have to encode the flight log ourselves in write{Inter|Intra}frame() in a way that matches
- * the encoding we've promised here).
+ * written into the flight log header so the log can be properly interpreted, and write{Inter|Intra}frame() encode the
+ * fields from it, reading each value from blackboxMainState_t at the field's state offset. Only the predictors and
+ * encodings handled there may be used here.
  */
 static const blackboxDeltaFieldDefinition_t blackboxMainFields[] = {
     /* loopIteration doesn't appear in P frames since it always increments */
-    {"loopIteration",-1, UNSIGNED, .Ipredict = PREDICT(0),     .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(INC),           .Pencode = FLIGHT_LOG_FIELD_ENCODING_NULL, CONDITION(ALWAYS)},
+    {"loopIteration",-1, UNSIGNED, .Ipredict = PREDICT(0),     .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(INC),           .Pencode = FLIGHT_LOG_FIELD_ENCODING_NULL, CONDITION(ALWAYS), .stateType = BLACKBOX_FIELD_STATE_ITERATION},
     /* Time advances pretty steadily so the P-frame prediction is a straight line */
-    {"time",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisP",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisP",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisP",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
+    {"time",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), FIELD_STATE(U32, time)},
+    {"axisP",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), FIELD_STATE(S32, axisPID_P[0])},
+    {"axisP",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), FIELD_STATE(S32, axisPID_P[1])},
+    {"axisP",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), FIELD_STATE(S32, axisPID_P[2])},
     /* I terms get special packed encoding in P frames: */
-    {"axisI",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS)},
-    {"axisI",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS)},
-    {"axisI",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS)},
-    {"axisD",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_0)},
-    {"axisD",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_1)},
-    {"axisD",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_2)},
-    {"axisF",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisF",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisF",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
+    {"axisI",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS), FIELD_STATE(S32, axisPID_I[0])},
+    {"axisI",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS), FIELD_STATE(S32, axisPID_I[1])},
+    {"axisI",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS), FIELD_STATE(S32, axisPID_I[2])},
+    {"axisD",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_0), FIELD_STATE(S32, axisPID_D[0])},
+    {"axisD",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_1), FIELD_STATE(S32, axisPID_D[1])},
+    {"axisD",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_2), FIELD_STATE(S32, axisPID_D[2])},
+    {"axisF",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), FIELD_STATE(S32, axisPID_F[0])},
+    {"axisF",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), FIELD_STATE(S32, axisPID_F[1])},
+    {"axisF",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), FIELD_STATE(S32, axisPID_F[2])},
     /* rcCommands are encoded together as a group in P-frames: */
-    {"rcCommand",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"rcCommand",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"rcCommand",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
+    {"rcCommand",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), FIELD_STATE(S16, rcCommand[0])},
+    {"rcCommand",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), FIELD_STATE(S16, rcCommand[1])},
+    {"rcCommand",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), FIELD_STATE(S16, rcCommand[2])},
     /* Throttle is always in the range [minthrottle..maxthrottle]: */
-    {"rcCommand",   3, UNSIGNED, .Ipredict = PREDICT(MINTHROTTLE), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
+    {"rcCommand",   3, UNSIGNED, .Ipredict = PREDICT(MINTHROTTLE), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), FIELD_STATE(S16, rcCommand[3])},
 
-    {"vbatLatest",    -1, UNSIGNED, .Ipredict = PREDICT(VBATREF),  .Iencode = ENCODING(NEG_14BIT),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_VBAT},
-    {"amperageLatest",-1, SIGNED,   .Ipredict = PREDICT(0),        .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC},
+    {"vbatLatest",    -1, UNSIGNED, .Ipredict = PREDICT(VBATREF),  .Iencode = ENCODING(NEG_14BIT),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_VBAT, FIELD_STATE(U16, vbatLatest)},
+    {"amperageLatest",-1, SIGNED,   .Ipredict = PREDICT(0),        .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC, FIELD_STATE(S32, amperageLatest)},
 
 #ifdef USE_MAG
-    {"magADC",      0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG},
-    {"magADC",      1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG},
-    {"magADC",      2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG},
+    {"magADC",      0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG, FIELD_STATE(S16, magADC[0])},
+    {"magADC",      1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG, FIELD_STATE(S16, magADC[1])},
+    {"magADC",      2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG, FIELD_STATE(S16, magADC[2])},
 #endif
 #ifdef USE_BARO
-    {"BaroAlt",    -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_BARO},
+    {"BaroAlt",    -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_BARO, FIELD_STATE(S32, BaroAlt)},
 #endif
 #ifdef USE_RANGEFINDER
-    {"surfaceRaw",   -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER},
+    {"surfaceRaw",   -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER, FIELD_STATE(S32, surfaceRaw)},
+#endif
+    {"rssi",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RSSI, FIELD_STATE(U16, rssi)},
+#ifdef USE_RX_LATENCY_STATISTICS
+    /* Time from the end of the receiver frame to the motor update using it, the tagged group above is already full */
+    {"rxLatency",  -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_RX_LATENCY, FIELD_STATE(U16, rxLatency)},
 #endif
-    {"rssi",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RSSI},
 
     /* Gyros and accelerometers base their P-predictions on the average of the previous 2 frames to reduce noise impact */
-    {"gyroADC",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"gyroADC",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"gyroADC",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"accSmooth",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC},
-    {"accSmooth",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC},
-    {"accSmooth",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC},
-    {"debug",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
-    {"debug",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
-    {"debug",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
-    {"debug",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
+    {"gyroADC",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), FIELD_STATE(S16, gyroADC[0])},
+    {"gyroADC",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), FIELD_STATE(S16, gyroADC[1])},
+    {"gyroADC",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), FIELD_STATE(S16, gyroADC[2])},
+    /* Setpoints are only logged in high resolution, the unscaled ones can be derived from rcCommand */
+    {"setpoint",    0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_HIGH_RESOLUTION, FIELD_STATE(S16, setpoint[0])},
+    {"setpoint",    1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_HIGH_RESOLUTION, FIELD_STATE(S16, setpoint[1])},
+    {"setpoint",    2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_HIGH_RESOLUTION, FIELD_STATE(S16, setpoint[2])},
+    {"accSmooth",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC, FIELD_STATE(S16, accADC[0])},
+    {"accSmooth",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC, FIELD_STATE(S16, accADC[1])},
+    {"accSmooth",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC, FIELD_STATE(S16, accADC[2])},
+    {"debug",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG, FIELD_STATE(S16, debug[0])},
+    {"debug",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG, FIELD_STATE(S16, debug[1])},
+    {"debug",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG, FIELD_STATE(S16, debug[2])},
+    {"debug",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG, FIELD_STATE(S16, debug[3])},
     /* Motors only rarely drops under minthrottle (when stick falls below mincommand), so predict minthrottle for it and use *unsigned* encoding (which is large for negative numbers but more compact for positive ones): */
-    {"motor",       0, UNSIGNED, .Ipredict = PREDICT(MINMOTOR), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(AVERAGE_2), .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_1)},
+    {"motor",       0, UNSIGNED, .Ipredict = PREDICT(MINMOTOR), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(AVERAGE_2), .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_1), FIELD_STATE(S16, motor[0])},
     /* Subsequent motors base their I-frame values on the first one, P-frame values on the average of last two frames: */
-    {"motor",       1, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_2)},
-    {"motor",       2, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_3)},
-    {"motor",       3, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_4)},
-    {"motor",       4, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_5)},
-    {"motor",       5, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_6)},
-    {"motor",       6, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_7)},
-    {"motor",       7, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_8)},
+    {"motor",       1, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_2), FIELD_STATE(S16, motor[1])},
+    {"motor",       2, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_3), FIELD_STATE(S16, motor[2])},
+    {"motor",       3, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_4), FIELD_STATE(S16, motor[3])},
+    {"motor",       4, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_5), FIELD_STATE(S16, motor[4])},
+    {"motor",       5, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_6), FIELD_STATE(S16, motor[5])},
+    {"motor",       6, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_7), FIELD_STATE(S16, motor[6])},
+    {"motor",       7, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_8), FIELD_STATE(S16, motor[7])},
 
     /* Tricopter tail servo */
-    {"servo",       5, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(TRICOPTER)}
+    {"servo",       5, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(TRICOPTER), FIELD_STATE(S16, servo[5])}
 };
 
 #ifdef USE_GPS
@@ -260,7 +341,14 @@ static const blackboxSimpleFieldDefinition_t blackboxSlowFields[] = {
 
     {"failsafePhase",         -1, UNSIGNED, PREDICT(0),      ENCODING(TAG2_3S32)},
     {"rxSignalReceived",      -1, UNSIGNED, PREDICT(0),      ENCODING(TAG2_3S32)},
-    {"rxFlightChannelsValid", -1, UNSIGNED, PREDICT(0),      ENCODING(TAG2_3S32)}
+    {"rxFlightChannelsValid", -1, UNSIGNED, PREDICT(0),      ENCODING(TAG2_3S32)},
+#ifdef USE_ESC_STATS
+    // over all motors in the last ESC statistics window
+    {"escTemperatureMax",     -1, SIGNED,   PREDICT(0),      ENCODING(SIGNED_VB)},
+    {"escCurrentMax",         -1, UNSIGNED, PREDICT(0),      ENCODING(UNSIGNED_VB)},
+    {"escErpmMin",            -1, UNSIGNED, PREDICT(0),      ENCODING(UNSIGNED_VB)},
+    {"escErpmMax",            -1, UNSIGNED, PREDICT(0),      ENCODING(UNSIGNED_VB)},
+#endif
 };
 
 typedef enum BlackboxState {
@@ -273,6 +361,7 @@ typedef enum BlackboxState {
     BLACKBOX_STATE_SEND_GPS_G_HEADER,
     BLACKBOX_STATE_SEND_SLOW_HEADER,
     BLACKBOX_STATE_SEND_SYSINFO,
+    BLACKBOX_STATE_SEND_GYRO_CAPTURE_HEADER,
     BLACKBOX_STATE_PAUSED,
     BLACKBOX_STATE_RUNNING,
     BLACKBOX_STATE_SHUTTING_DOWN,
@@ -281,37 +370,6 @@ typedef enum BlackboxState {
     BLACKBOX_STATE_ERASED
 } BlackboxState;
 
-
-typedef struct blackboxMainState_s {
-    uint32_t time;
-
-    int32_t axisPID_P[XYZ_AXIS_COUNT];
-    int32_t axisPID_I[XYZ_AXIS_COUNT];
-    int32_t axisPID_D[XYZ_AXIS_COUNT];
-    int32_t axisPID_F[XYZ_AXIS_COUNT];
-
-    int16_t rcCommand[4];
-    int16_t gyroADC[XYZ_AXIS_COUNT];
-    int16_t accADC[XYZ_AXIS_COUNT];
-    int16_t debug[DEBUG16_VALUE_COUNT];
-    int16_t motor[MAX_SUPPORTED_MOTORS];
-    int16_t servo[MAX_SUPPORTED_SERVOS];
-
-    uint16_t vbatLatest;
-    int32_t amperageLatest;
-
-#ifdef USE_BARO
-    int32_t BaroAlt;
-#endif
-#ifdef USE_MAG
-    int16_t magADC[XYZ_AXIS_COUNT];
-#endif
-#ifdef USE_RANGEFINDER
-    int32_t surfaceRaw;
-#endif
-    uint16_t rssi;
-} blackboxMainState_t;
-
 typedef struct blackboxGpsState_s {
     int32_t GPS_home[2];
     int32_t GPS_coord[2];
@@ -325,6 +383,12 @@ typedef struct blackboxSlowState_s {
     uint8_t failsafePhase;
     bool rxSignalReceived;
     bool rxFlightChannelsValid;
+#ifdef USE_ESC_STATS
+    int8_t escTemperatureMax;
+    uint16_t escCurrentMax;
+    uint16_t escErpmMin;
+    uint16_t escErpmMax;
+#endif
 } __attribute__((__packed__)) blackboxSlowState_t; // We pack this struct so that padding doesn't interfere with memcmp()
 
 //From rc_controls.c
@@ -361,9 +425,21 @@ static uint16_t blackboxIFrameIndex;
 STATIC_UNIT_TESTED int16_t blackboxIInterval = 0;
 // number of flight loop iterations before logging P-frame
 STATIC_UNIT_TESTED int16_t blackboxPInterval = 0;
+#ifdef USE_BLACKBOX_RATE_CONTROL
+// blackboxPInterval is multiplied by 2^blackboxRateShift while the device cannot keep up
+STATIC_UNIT_TESTED uint8_t blackboxRateShift;
+static uint8_t blackboxRateGoodIntervals;
+static int16_t blackboxRatePIntervalLogged;
+#endif
 STATIC_UNIT_TESTED int32_t blackboxSInterval = 0;
 STATIC_UNIT_TESTED int32_t blackboxSlowFrameIterationTimer;
 static bool blackboxLoggedAnyFrames;
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+// The current log holds the full rate gyro capture instead of flight data frames
+static bool blackboxGyroCaptureLog;
+
+static void blackboxLogGyroCapture(void);
+#endif
 
 /*
  * We store voltages in I-frames relative to this, which was the voltage when the blackbox was activated.
@@ -372,6 +448,9 @@ static bool blackboxLoggedAnyFrames;
  */
 static uint16_t vbatReference;
 
+// Gyro and setpoint are logged multiplied by this, 1 unless in high resolution
+static float blackboxValueScale = 1.0f;
+
 static blackboxGpsState_t gpsHistory;
 static blackboxSlowState_t slowHistory;
 
@@ -381,8 +460,45 @@ static blackboxMainState_t blackboxHistoryRing[3];
 // These point into blackboxHistoryRing, use them to know where to store history of a given age (0, 1 or 2 generations old)
 static blackboxMainState_t* blackboxHistory[3];
 
+// Indexes into blackboxMainFields of the fields logged in the current log, resolved from the conditions at log start
+#define BLACKBOX_PLAN_GROUP_END         0x80    // last field of a tagged group in P frames
+#define BLACKBOX_PLAN_FIELD_INDEX_MASK  0x7F
+STATIC_ASSERT(ARRAYLEN(blackboxMainFields) <= BLACKBOX_PLAN_FIELD_INDEX_MASK, too_many_main_fields_for_plan);
+
+static uint8_t blackboxMainFieldPlan[ARRAYLEN(blackboxMainFields)];
+static uint8_t blackboxMainFieldPlanLength;
+// Values of the constant I frame predictors, MOTOR_0 is taken from the frame itself
+static uint16_t blackboxPredictorValue[FLIGHT_LOG_FIELD_PREDICTOR_MINMOTOR + 1];
+
 static bool blackboxModeActivationConditionPresent = false;
 
+#ifdef USE_BLACKBOX_DEFERRED_ENCODING
+// The PID loop only captures the main state of the frames to log, TASK_BLACKBOX encodes and writes them.
+#define BLACKBOX_CAPTURE_RING_SIZE 16   // must be a power of 2
+
+typedef enum {
+    BLACKBOX_CAPTURE_IFRAME     = 1 << 0,
+    BLACKBOX_CAPTURE_PFRAME     = 1 << 1,
+    BLACKBOX_CAPTURE_GPS_HOME   = 1 << 2,
+} blackboxCaptureFlags_e;
+
+typedef struct blackboxCapture_s {
+    blackboxMainState_t state;
+    uint32_t iteration;
+    uint8_t flags;
+} blackboxCapture_t;
+
+static blackboxCapture_t blackboxCaptureRing[BLACKBOX_CAPTURE_RING_SIZE];
+// Single producer (the PID loop, possibly in interrupt context) and single consumer (TASK_BLACKBOX)
+static volatile uint8_t blackboxCaptureHead;
+static volatile uint8_t blackboxCaptureTail;
+// Set when a frame was dropped because the ring was full, the next frame is then logged as a resumed I frame
+static volatile bool blackboxCaptureDropped;
+
+static void blackboxCaptureReset(void);
+static void blackboxEncodeCaptured(void);
+#endif
+
 /**
  * Return true if it is safe to edit the Blackbox configuration.
  */
@@ -450,6 +566,13 @@ static bool testBlackboxConditionUncached(FlightLogFieldCondition condition)
     case FLIGHT_LOG_FIELD_CONDITION_RSSI:
         return rxConfig()->rssi_channel > 0 || feature(FEATURE_RSSI_ADC);
 
+    case FLIGHT_LOG_FIELD_CONDITION_RX_LATENCY:
+#ifdef USE_RX_LATENCY_STATISTICS
+        return rxFrameTimeUs() != 0;
+#else
+        return false;
+#endif
+
     case FLIGHT_LOG_FIELD_CONDITION_NOT_LOGGING_EVERY_FRAME:
         return blackboxConfig()->p_ratio != 1;
 
@@ -459,6 +582,9 @@ static bool testBlackboxConditionUncached(FlightLogFieldCondition condition)
     case FLIGHT_LOG_FIELD_CONDITION_DEBUG:
         return debugMode != DEBUG_NONE;
 
+    case FLIGHT_LOG_FIELD_CONDITION_HIGH_RESOLUTION:
+        return blackboxConfig()->high_resolution;
+
     case FLIGHT_LOG_FIELD_CONDITION_NEVER:
         return false;
 
@@ -482,14 +608,87 @@ static bool testBlackboxCondition(FlightLogFieldCondition condition)
     return (blackboxConditionCache & (1 << condition)) != 0;
 }
 
+// Build the main frame encoding plan from the cached conditions, so the frame writers don't have to test them
+static void blackboxBuildMainFieldPlan(void)
+{
+    blackboxMainFieldPlanLength = 0;
+    for (unsigned i = 0; i < ARRAYLEN(blackboxMainFields); i++) {
+        if (testBlackboxCondition(blackboxMainFields[i].condition)) {
+            blackboxMainFieldPlan[blackboxMainFieldPlanLength++] = i;
+        }
+    }
+
+    // Consecutive fields with the same tagged P encoding are written as groups of up to 3, 4 or 8 fields
+    int groupLength = 0;
+    for (int i = 0; i < blackboxMainFieldPlanLength; i++) {
+        const uint8_t encode = blackboxMainFields[blackboxMainFieldPlan[i]].Pencode;
+        int groupMax;
+        switch (encode) {
+        case FLIGHT_LOG_FIELD_ENCODING_TAG2_3S32:
+            groupMax = 3;
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_4S16:
+            groupMax = 4;
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_8SVB:
+            groupMax = 8;
+            break;
+        default:
+            continue;
+        }
+
+        groupLength++;
+        if (groupLength == groupMax || i + 1 == blackboxMainFieldPlanLength
+            || blackboxMainFields[blackboxMainFieldPlan[i + 1]].Pencode != encode) {
+            blackboxMainFieldPlan[i] |= BLACKBOX_PLAN_GROUP_END;
+            groupLength = 0;
+        }
+    }
+
+    memset(blackboxPredictorValue, 0, sizeof(blackboxPredictorValue));
+    blackboxPredictorValue[FLIGHT_LOG_FIELD_PREDICTOR_MINTHROTTLE] = motorConfig()->minthrottle;
+    blackboxPredictorValue[FLIGHT_LOG_FIELD_PREDICTOR_1500] = 1500;
+    blackboxPredictorValue[FLIGHT_LOG_FIELD_PREDICTOR_VBATREF] = vbatReference;
+    //Motors can be below minimum output when disarmed, but that doesn't happen much
+    blackboxPredictorValue[FLIGHT_LOG_FIELD_PREDICTOR_MINMOTOR] = lrintf(motorOutputLow);
+}
+
+static bool isGyroCaptureLog(void)
+{
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+    return blackboxGyroCaptureLog;
+#else
+    return false;
+#endif
+}
+
+static bool blackboxIsTriggerLog(void)
+{
+#ifdef USE_BLACKBOX_TRIGGER
+    return blackboxTriggerIsEnabled();
+#else
+    return false;
+#endif
+}
+
 static void blackboxSetState(BlackboxState newState)
 {
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+    // Samples are only captured while running, the ones still in the ring are encoded while paused
+    if (newState == BLACKBOX_STATE_RUNNING && blackboxGyroCaptureLog) {
+        blackboxGyroCaptureStart();
+    } else {
+        blackboxGyroCaptureStop();
+    }
+#endif
+
     //Perform initial setup required for the new state
     switch (newState) {
     case BLACKBOX_STATE_PREPARE_LOG_FILE:
         blackboxLoggedAnyFrames = false;
         break;
     case BLACKBOX_STATE_SEND_HEADER:
+    case BLACKBOX_STATE_SEND_GYRO_CAPTURE_HEADER:
         blackboxHeaderBudget = 0;
         xmitState.headerIndex = 0;
         xmitState.u.startTime = millis();
@@ -516,94 +715,60 @@ static void blackboxSetState(BlackboxState newState)
     blackboxState = newState;
 }
 
-static void writeIntraframe(void)
+// Read a main frame field from the given state, see blackboxFieldStateType_e
+static int32_t blackboxMainFieldValue(const blackboxMainState_t *state, const blackboxDeltaFieldDefinition_t *field)
+{
+    const uint8_t *value = (const uint8_t *)state + field->stateOffset;
+
+    switch (field->stateType) {
+    case BLACKBOX_FIELD_STATE_U32:
+        return *(const uint32_t *)value;
+    case BLACKBOX_FIELD_STATE_S32:
+        return *(const int32_t *)value;
+    case BLACKBOX_FIELD_STATE_U16:
+        return *(const uint16_t *)value;
+    case BLACKBOX_FIELD_STATE_S16:
+    default:
+        return *(const int16_t *)value;
+    }
+}
+
+STATIC_UNIT_TESTED void writeIntraframe(uint32_t iteration)
 {
     blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
 
     blackboxWrite('I');
 
-    blackboxWriteUnsignedVB(blackboxIteration);
-    blackboxWriteUnsignedVB(blackboxCurrent->time);
-
-    blackboxWriteSignedVBArray(blackboxCurrent->axisPID_P, XYZ_AXIS_COUNT);
-    blackboxWriteSignedVBArray(blackboxCurrent->axisPID_I, XYZ_AXIS_COUNT);
+    for (int i = 0; i < blackboxMainFieldPlanLength; i++) {
+        const blackboxDeltaFieldDefinition_t *field = &blackboxMainFields[blackboxMainFieldPlan[i] & BLACKBOX_PLAN_FIELD_INDEX_MASK];
 
-    // Don't bother writing the current D term if the corresponding PID setting is zero
-    for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
-        if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0 + x)) {
-            blackboxWriteSignedVB(blackboxCurrent->axisPID_D[x]);
+        int32_t value;
+        if (field->stateType == BLACKBOX_FIELD_STATE_ITERATION) {
+            value = iteration;
+        } else {
+            value = blackboxMainFieldValue(blackboxCurrent, field);
         }
-    }
-
-    blackboxWriteSignedVBArray(blackboxCurrent->axisPID_F, XYZ_AXIS_COUNT);
-
-    // Write roll, pitch and yaw first:
-    blackboxWriteSigned16VBArray(blackboxCurrent->rcCommand, 3);
-
-    /*
-     * Write the throttle separately from the rest of the RC data so we can apply a predictor to it.
-     * Throttle lies in range [minthrottle..maxthrottle]:
-     */
-    blackboxWriteUnsignedVB(blackboxCurrent->rcCommand[THROTTLE] - motorConfig()->minthrottle);
-
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_VBAT)) {
-        /*
-         * Our voltage is expected to decrease over the course of the flight, so store our difference from
-         * the reference:
-         *
-         * Write 14 bits even if the number is negative (which would otherwise result in 32 bits)
-         */
-        blackboxWriteUnsignedVB((vbatReference - blackboxCurrent->vbatLatest) & 0x3FFF);
-    }
-
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC)) {
-        // 12bit value directly from ADC
-        blackboxWriteSignedVB(blackboxCurrent->amperageLatest);
-    }
-
-#ifdef USE_MAG
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_MAG)) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->magADC, XYZ_AXIS_COUNT);
-    }
-#endif
-
-#ifdef USE_BARO
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_BARO)) {
-        blackboxWriteSignedVB(blackboxCurrent->BaroAlt);
-    }
-#endif
 
-#ifdef USE_RANGEFINDER
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER)) {
-        blackboxWriteSignedVB(blackboxCurrent->surfaceRaw);
-    }
-#endif
-
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RSSI)) {
-        blackboxWriteUnsignedVB(blackboxCurrent->rssi);
-    }
-
-    blackboxWriteSigned16VBArray(blackboxCurrent->gyroADC, XYZ_AXIS_COUNT);
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_ACC)) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->accADC, XYZ_AXIS_COUNT);
-    }
-
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_DEBUG)) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->debug, DEBUG16_VALUE_COUNT);
-    }
-
-    //Motors can be below minimum output when disarmed, but that doesn't happen much
-    blackboxWriteUnsignedVB(blackboxCurrent->motor[0] - motorOutputLow);
-
-    //Motors tend to be similar to each other so use the first motor's value as a predictor of the others
-    const int motorCount = getMotorCount();
-    for (int x = 1; x < motorCount; x++) {
-        blackboxWriteSignedVB(blackboxCurrent->motor[x] - blackboxCurrent->motor[0]);
-    }
+        if (field->Ipredict == FLIGHT_LOG_FIELD_PREDICTOR_MOTOR_0) {
+            //Motors tend to be similar to each other so use the first motor's value as a predictor of the others
+            value -= blackboxCurrent->motor[0];
+        } else {
+            value -= blackboxPredictorValue[field->Ipredict];
+        }
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_TRICOPTER)) {
-        //Assume the tail spends most of its time around the center
-        blackboxWriteSignedVB(blackboxCurrent->servo[5] - 1500);
+        switch (field->Iencode) {
+        case FLIGHT_LOG_FIELD_ENCODING_UNSIGNED_VB:
+            blackboxWriteUnsignedVB(value);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_NEG_14BIT:
+            // Write 14 bits even if the number is negative (which would otherwise result in 32 bits)
+            blackboxWriteUnsignedVB(-value & 0x3FFF);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_SIGNED_VB:
+        default:
+            blackboxWriteSignedVB(value);
+            break;
+        }
     }
 
     //Rotate our history buffers:
@@ -618,127 +783,135 @@ static void writeIntraframe(void)
     blackboxLoggedAnyFrames = true;
 }
 
-static void blackboxWriteMainStateArrayUsingAveragePredictor(int arrOffsetInHistory, int count)
-{
-    int16_t *curr  = (int16_t*) ((char*) (blackboxHistory[0]) + arrOffsetInHistory);
-    int16_t *prev1 = (int16_t*) ((char*) (blackboxHistory[1]) + arrOffsetInHistory);
-    int16_t *prev2 = (int16_t*) ((char*) (blackboxHistory[2]) + arrOffsetInHistory);
-
-    for (int i = 0; i < count; i++) {
-        // Predictor is the average of the previous two history states
-        int32_t predictor = (prev1[i] + prev2[i]) / 2;
-
-        blackboxWriteSignedVB(curr[i] - predictor);
-    }
-}
-
-static void writeInterframe(void)
+STATIC_UNIT_TESTED void writeInterframe(void)
 {
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
-    blackboxMainState_t *blackboxLast = blackboxHistory[1];
+    const blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
+    const blackboxMainState_t *blackboxLast = blackboxHistory[1];
+    const blackboxMainState_t *blackboxLastLast = blackboxHistory[2];
 
+#ifdef USE_BLACKBOX_MIRROR
+    blackboxFrameDeltaBegin();
+#endif
     blackboxWrite('P');
 
-    //No need to store iteration count since its delta is always 1
-
-    /*
-     * Since the difference between the difference between successive times will be nearly zero (due to consistent
-     * looptime spacing), use second-order differences.
-     */
-    blackboxWriteSignedVB((int32_t) (blackboxHistory[0]->time - 2 * blackboxHistory[1]->time + blackboxHistory[2]->time));
-
+    // Values of the tagged group being collected, groups are closed by BLACKBOX_PLAN_GROUP_END
     int32_t deltas[8];
-    arraySubInt32(deltas, blackboxCurrent->axisPID_P, blackboxLast->axisPID_P, XYZ_AXIS_COUNT);
-    blackboxWriteSignedVBArray(deltas, XYZ_AXIS_COUNT);
+    int deltaCount = 0;
 
-    /*
-     * The PID I field changes very slowly, most of the time +-2, so use an encoding
-     * that can pack all three fields into one byte in that situation.
-     */
-    arraySubInt32(deltas, blackboxCurrent->axisPID_I, blackboxLast->axisPID_I, XYZ_AXIS_COUNT);
-    blackboxWriteTag2_3S32(deltas);
+    for (int i = 0; i < blackboxMainFieldPlanLength; i++) {
+        const blackboxDeltaFieldDefinition_t *field = &blackboxMainFields[blackboxMainFieldPlan[i] & BLACKBOX_PLAN_FIELD_INDEX_MASK];
 
-    /*
-     * The PID D term is frequently set to zero for yaw, which makes the result from the calculation
-     * always zero. So don't bother recording D results when PID D terms are zero.
-     */
-    for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
-        if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0 + x)) {
-            blackboxWriteSignedVB(blackboxCurrent->axisPID_D[x] - blackboxLast->axisPID_D[x]);
+        if (field->Pencode == FLIGHT_LOG_FIELD_ENCODING_NULL) {
+            //No need to store iteration count since its delta is always 1
+            continue;
         }
-    }
 
-    arraySubInt32(deltas, blackboxCurrent->axisPID_F, blackboxLast->axisPID_F, XYZ_AXIS_COUNT);
-    blackboxWriteSignedVBArray(deltas, XYZ_AXIS_COUNT);
+        const int32_t value = blackboxMainFieldValue(blackboxCurrent, field);
+        const int32_t last = blackboxMainFieldValue(blackboxLast, field);
+        int32_t delta;
 
-    /*
-     * RC tends to stay the same or fairly small for many frames at a time, so use an encoding that
-     * can pack multiple values per byte:
-     */
-    for (int x = 0; x < 4; x++) {
-        deltas[x] = blackboxCurrent->rcCommand[x] - blackboxLast->rcCommand[x];
-    }
-
-    blackboxWriteTag8_4S16(deltas);
-
-    //Check for sensors that are updated periodically (so deltas are normally zero)
-    int optionalFieldCount = 0;
-
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_VBAT)) {
-        deltas[optionalFieldCount++] = (int32_t) blackboxCurrent->vbatLatest - blackboxLast->vbatLatest;
-    }
-
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC)) {
-        deltas[optionalFieldCount++] = blackboxCurrent->amperageLatest - blackboxLast->amperageLatest;
-    }
+        switch (field->Ppredict) {
+        case FLIGHT_LOG_FIELD_PREDICTOR_STRAIGHT_LINE:
+            /*
+             * Since the difference between the difference between successive times will be nearly zero (due to consistent
+             * looptime spacing), use second-order differences.
+             */
+            delta = (int32_t)((uint32_t)value - 2 * (uint32_t)last + (uint32_t)blackboxMainFieldValue(blackboxLastLast, field));
+            break;
+        case FLIGHT_LOG_FIELD_PREDICTOR_AVERAGE_2:
+            // Gyros, accs and motors are noisy, so base their predictions on the average of the previous two history states
+            delta = value - (last + blackboxMainFieldValue(blackboxLastLast, field)) / 2;
+            break;
+        case FLIGHT_LOG_FIELD_PREDICTOR_PREVIOUS:
+        default:
+            delta = value - last;
+            break;
+        }
 
-#ifdef USE_MAG
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_MAG)) {
-        for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
-            deltas[optionalFieldCount++] = blackboxCurrent->magADC[x] - blackboxLast->magADC[x];
+        switch (field->Pencode) {
+        case FLIGHT_LOG_FIELD_ENCODING_TAG2_3S32:
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_4S16:
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_8SVB:
+            deltas[deltaCount++] = delta;
+            if (blackboxMainFieldPlan[i] & BLACKBOX_PLAN_GROUP_END) {
+                if (field->Pencode == FLIGHT_LOG_FIELD_ENCODING_TAG2_3S32) {
+                    blackboxWriteTag2_3S32(deltas);
+                } else if (field->Pencode == FLIGHT_LOG_FIELD_ENCODING_TAG8_4S16) {
+                    blackboxWriteTag8_4S16(deltas);
+                } else {
+                    blackboxWriteTag8_8SVB(deltas, deltaCount);
+                }
+                deltaCount = 0;
+            }
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_SIGNED_VB:
+        default:
+            blackboxWriteSignedVB(delta);
+            break;
         }
     }
+#ifdef USE_BLACKBOX_MIRROR
+    blackboxFrameDeltaEnd();
 #endif
 
-#ifdef USE_BARO
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_BARO)) {
-        deltas[optionalFieldCount++] = blackboxCurrent->BaroAlt - blackboxLast->BaroAlt;
-    }
-#endif
+    //Rotate our history buffers
+    blackboxHistory[2] = blackboxHistory[1];
+    blackboxHistory[1] = blackboxHistory[0];
+    blackboxHistory[0] = ((blackboxHistory[0] - blackboxHistoryRing + 1) % 3) + blackboxHistoryRing;
 
-#ifdef USE_RANGEFINDER
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER)) {
-        deltas[optionalFieldCount++] = blackboxCurrent->surfaceRaw - blackboxLast->surfaceRaw;
-    }
-#endif
+    blackboxLoggedAnyFrames = true;
+}
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RSSI)) {
-        deltas[optionalFieldCount++] = (int32_t) blackboxCurrent->rssi - blackboxLast->rssi;
-    }
+#ifdef UNIT_TEST
+// Prepare the main frame encoders as blackboxStart() does
+void blackboxStartMainFrames(void)
+{
+    blackboxHistory[0] = &blackboxHistoryRing[0];
+    blackboxHistory[1] = &blackboxHistoryRing[1];
+    blackboxHistory[2] = &blackboxHistoryRing[2];
 
-    blackboxWriteTag8_8SVB(deltas, optionalFieldCount);
+    vbatReference = getBatteryVoltageLatest();
+    blackboxBuildConditionCache();
+    blackboxBuildMainFieldPlan();
+}
 
-    //Since gyros, accs and motors are noisy, base their predictions on the average of the history:
-    blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, gyroADC),   XYZ_AXIS_COUNT);
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_ACC)) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, accADC), XYZ_AXIS_COUNT);
-    }
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_DEBUG)) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, debug), DEBUG16_VALUE_COUNT);
-    }
-    blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, motor),     getMotorCount());
+int blackboxMainFieldCount(void)
+{
+    return blackboxMainFieldPlanLength;
+}
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_TRICOPTER)) {
-        blackboxWriteSignedVB(blackboxCurrent->servo[5] - blackboxLast->servo[5]);
-    }
+void blackboxGetMainFieldEncoding(int field, blackboxMainFieldEncoding_t *encoding)
+{
+    const blackboxDeltaFieldDefinition_t *definition = &blackboxMainFields[blackboxMainFieldPlan[field] & BLACKBOX_PLAN_FIELD_INDEX_MASK];
+
+    encoding->Ipredict = definition->Ipredict;
+    encoding->Iencode = definition->Iencode;
+    encoding->Ppredict = definition->Ppredict;
+    encoding->Pencode = definition->Pencode;
+    encoding->groupEnd = blackboxMainFieldPlan[field] & BLACKBOX_PLAN_GROUP_END;
+    encoding->iteration = definition->stateType == BLACKBOX_FIELD_STATE_ITERATION;
+}
 
-    //Rotate our history buffers
-    blackboxHistory[2] = blackboxHistory[1];
-    blackboxHistory[1] = blackboxHistory[0];
-    blackboxHistory[0] = ((blackboxHistory[0] - blackboxHistoryRing + 1) % 3) + blackboxHistoryRing;
+// Set a field of the main state that the next main frame is written from
+void blackboxSetMainFieldValue(int field, int32_t value)
+{
+    const blackboxDeltaFieldDefinition_t *definition = &blackboxMainFields[blackboxMainFieldPlan[field] & BLACKBOX_PLAN_FIELD_INDEX_MASK];
+    uint8_t *state = (uint8_t *)blackboxHistory[0] + definition->stateOffset;
 
-    blackboxLoggedAnyFrames = true;
+    switch (definition->stateType) {
+    case BLACKBOX_FIELD_STATE_U32:
+    case BLACKBOX_FIELD_STATE_S32:
+        *(int32_t *)state = value;
+        break;
+    case BLACKBOX_FIELD_STATE_U16:
+    case BLACKBOX_FIELD_STATE_S16:
+        *(int16_t *)state = value;
+        break;
+    default:
+        break;
+    }
 }
+#endif
 
 /* Write the contents of the global "slowHistory" to the log as an "S" frame. Because this data is logged so
  * infrequently, delta updates are not reasonable, so we log independent frames. */
@@ -759,6 +932,13 @@ static void writeSlowFrame(void)
     values[2] = slowHistory.rxFlightChannelsValid ? 1 : 0;
     blackboxWriteTag2_3S32(values);
 
+#ifdef USE_ESC_STATS
+    blackboxWriteSignedVB(slowHistory.escTemperatureMax);
+    blackboxWriteUnsignedVB(slowHistory.escCurrentMax);
+    blackboxWriteUnsignedVB(slowHistory.escErpmMin);
+    blackboxWriteUnsignedVB(slowHistory.escErpmMax);
+#endif
+
     blackboxSlowFrameIterationTimer = 0;
 }
 
@@ -772,6 +952,14 @@ static void loadSlowState(blackboxSlowState_t *slow)
     slow->failsafePhase = failsafePhase();
     slow->rxSignalReceived = rxIsReceivingSignal();
     slow->rxFlightChannelsValid = rxAreFlightChannelsValid();
+#ifdef USE_ESC_STATS
+    // changes at most once per statistics window, so these do not add many slow frames
+    const escStats_t *escStats = getEscStats(ESC_STATS_COMBINED);
+    slow->escTemperatureMax = escStatsIsValid(escStats, ESC_STATS_TEMPERATURE) ? escStats->values[ESC_STATS_TEMPERATURE].max : 0;
+    slow->escCurrentMax = escStatsIsValid(escStats, ESC_STATS_CURRENT) ? escStats->values[ESC_STATS_CURRENT].max : 0;
+    slow->escErpmMin = escStatsIsValid(escStats, ESC_STATS_ERPM) ? escStats->values[ESC_STATS_ERPM].min : 0;
+    slow->escErpmMax = escStatsIsValid(escStats, ESC_STATS_ERPM) ? escStats->values[ESC_STATS_ERPM].max : 0;
+#endif
 }
 
 /**
@@ -832,6 +1020,12 @@ static void blackboxResetIterationTimers(void)
     blackboxIFrameIndex = 0;
     blackboxPFrameIndex = 0;
     blackboxSlowFrameIterationTimer = 0;
+#ifdef USE_BLACKBOX_RATE_CONTROL
+    blackboxRateShift = 0;
+    blackboxRateGoodIntervals = 0;
+    blackboxRatePIntervalLogged = blackboxPInterval;
+    blackboxDeviceTakeBackPressure();
+#endif
 }
 
 /**
@@ -862,10 +1056,27 @@ static void blackboxStart(void)
      * cache those now.
      */
     blackboxBuildConditionCache();
+    blackboxValueScale = blackboxConfig()->high_resolution ? BLACKBOX_HIGH_RESOLUTION_SCALE : 1.0f;
+    blackboxBuildMainFieldPlan();
 
     blackboxModeActivationConditionPresent = isModeActivationConditionPresent(BOXBLACKBOX);
 
     blackboxResetIterationTimers();
+#ifdef USE_BLACKBOX_DEFERRED_ENCODING
+    blackboxCaptureReset();
+#endif
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+    blackboxGyroCaptureLog = blackboxConfig()->gyro_capture != BLACKBOX_GYRO_CAPTURE_OFF;
+    blackboxGyroCaptureReset(blackboxConfig()->gyro_capture == BLACKBOX_GYRO_CAPTURE_RAW_FILTERED);
+#endif
+#ifdef USE_BLACKBOX_TRIGGER
+    blackboxTriggerInit(blackboxConfig()->trigger && !isGyroCaptureLog(),
+        blackboxConfig()->trigger_pre_ms, blackboxConfig()->trigger_post_ms, blackboxConfig()->trigger_background_ms);
+    if (!isGyroCaptureLog()) {
+        // Write the header to RAM and start logging frames right after it, the device catches up meanwhile
+        blackboxTriggerBacklogStart(micros());
+    }
+#endif
 
     /*
      * Record the beeper's current idea of the last arming beep time, so that we can detect it changing when
@@ -890,6 +1101,19 @@ void blackboxFinish(void)
         break;
     case BLACKBOX_STATE_RUNNING:
     case BLACKBOX_STATE_PAUSED:
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+        blackboxGyroCaptureStop();
+        blackboxLogGyroCapture();
+#endif
+#ifdef USE_BLACKBOX_DEFERRED_ENCODING
+        blackboxEncodeCaptured();
+#endif
+#ifdef USE_BLACKBOX_TRIGGER
+        // Always keep what led up to the end of the log
+        if (blackboxTriggerIsEnabled()) {
+            blackboxTriggerFire(micros());
+        }
+#endif
         blackboxLogEvent(FLIGHT_LOG_EVENT_LOG_END, NULL);
         FALLTHROUGH;
     default:
@@ -990,11 +1214,9 @@ static void writeGPSFrame(timeUs_t currentTimeUs)
 /**
  * Fill the current state of the blackbox using values read from the flight controller
  */
-static void loadMainState(timeUs_t currentTimeUs)
+static void loadMainState(blackboxMainState_t *blackboxCurrent, timeUs_t currentTimeUs)
 {
 #ifndef UNIT_TEST
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
-
     blackboxCurrent->time = currentTimeUs;
 
     for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
@@ -1002,7 +1224,8 @@ static void loadMainState(timeUs_t currentTimeUs)
         blackboxCurrent->axisPID_I[i] = pidData[i].I;
         blackboxCurrent->axisPID_D[i] = pidData[i].D;
         blackboxCurrent->axisPID_F[i] = pidData[i].F;
-        blackboxCurrent->gyroADC[i] = lrintf(gyro.gyroADCf[i]);
+        blackboxCurrent->gyroADC[i] = lrintf(constrainf(gyro.gyroADCf[i] * blackboxValueScale, INT16_MIN, INT16_MAX));
+        blackboxCurrent->setpoint[i] = lrintf(constrainf(getSetpointRate(i) * blackboxValueScale, INT16_MIN, INT16_MAX));
         blackboxCurrent->accADC[i] = lrintf(acc.accADC[i]);
 #ifdef USE_MAG
         blackboxCurrent->magADC[i] = mag.magADC[i];
@@ -1036,11 +1259,16 @@ static void loadMainState(timeUs_t currentTimeUs)
 
     blackboxCurrent->rssi = getRssi();
 
+#ifdef USE_RX_LATENCY_STATISTICS
+    blackboxCurrent->rxLatency = MIN(rxLatencyStats()->lastUs, UINT16_MAX);
+#endif
+
 #ifdef USE_SERVOS
     //Tail servo for tricopters
     blackboxCurrent->servo[5] = servo[5];
 #endif
 #else
+    UNUSED(blackboxCurrent);
     UNUSED(currentTimeUs);
 #endif // UNIT_TEST
 }
@@ -1215,7 +1443,7 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("P ratio", "%d",                         blackboxConfig()->p_ratio);
         BLACKBOX_PRINT_HEADER_LINE("minthrottle", "%d",                     motorConfig()->minthrottle);
         BLACKBOX_PRINT_HEADER_LINE("maxthrottle", "%d",                     motorConfig()->maxthrottle);
-        BLACKBOX_PRINT_HEADER_LINE("gyro_scale","0x%x",                     castFloatBytesToInt(1.0f));
+        BLACKBOX_PRINT_HEADER_LINE("gyro_scale","0x%x",                     castFloatBytesToInt(1.0f / blackboxValueScale));
         BLACKBOX_PRINT_HEADER_LINE("motorOutput", "%d,%d",                  motorOutputLowInt,motorOutputHighInt);
         BLACKBOX_PRINT_HEADER_LINE("acc_1G", "%u",                          acc.dev.acc_1G);
 
@@ -1241,6 +1469,7 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("looptime", "%d",                        gyro.targetLooptime);
         BLACKBOX_PRINT_HEADER_LINE("gyro_sync_denom", "%d",                 gyroConfig()->gyro_sync_denom);
         BLACKBOX_PRINT_HEADER_LINE("pid_process_denom", "%d",               pidConfig()->pid_process_denom);
+        BLACKBOX_PRINT_HEADER_LINE("pid_yaw_denom", "%d",                   pidConfig()->pid_yaw_denom);
         BLACKBOX_PRINT_HEADER_LINE("thr_mid", "%d",                         currentControlRateProfile->thrMid8);
         BLACKBOX_PRINT_HEADER_LINE("thr_expo", "%d",                        currentControlRateProfile->thrExpo8);
         BLACKBOX_PRINT_HEADER_LINE("tpa_rate", "%d",                        currentControlRateProfile->dynThrPID);
@@ -1304,6 +1533,7 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("gyro_lowpass_hz", "%d",                 gyroConfig()->gyro_lowpass_hz);
         BLACKBOX_PRINT_HEADER_LINE("gyro_lowpass2_type", "%d",              gyroConfig()->gyro_lowpass2_type);
         BLACKBOX_PRINT_HEADER_LINE("gyro_lowpass2_hz", "%d",                gyroConfig()->gyro_lowpass2_hz);
+        BLACKBOX_PRINT_HEADER_LINE("gyro_kalman_r", "%d",                   gyroConfig()->gyro_kalman_r);
         BLACKBOX_PRINT_HEADER_LINE("gyro_notch_hz", "%d,%d",                gyroConfig()->gyro_soft_notch_hz_1,
                                                                             gyroConfig()->gyro_soft_notch_hz_2);
         BLACKBOX_PRINT_HEADER_LINE("gyro_notch_cutoff", "%d,%d",            gyroConfig()->gyro_soft_notch_cutoff_1,
@@ -1335,6 +1565,22 @@ static bool blackboxWriteSysinfo(void)
                                                                             rcSmoothingGetValue(RC_SMOOTHING_VALUE_DERIVATIVE_ACTIVE));
         BLACKBOX_PRINT_HEADER_LINE("rc_smoothing_rx_average", "%d",         rcSmoothingGetValue(RC_SMOOTHING_VALUE_AVERAGE_FRAME));
 #endif // USE_RC_SMOOTHING_FILTER
+#ifdef USE_BLACKBOX_TRIGGER
+        BLACKBOX_PRINT_HEADER_LINE("trigger", "%d,%d,%d,%d",                blackboxConfig()->trigger,
+                                                                            blackboxConfig()->trigger_pre_ms,
+                                                                            blackboxConfig()->trigger_post_ms,
+                                                                            blackboxConfig()->trigger_background_ms);
+#endif
+        BLACKBOX_PRINT_HEADER_LINE("high_resolution_scale", "%d",           lrintf(blackboxValueScale));
+#ifdef USE_BLACKBOX_MIRROR
+        BLACKBOX_PRINT_HEADER_LINE("mirror", "%d",                          blackboxConfig()->mirror);
+#endif
+#ifdef USE_BLACKBOX_COMPRESSION
+        BLACKBOX_PRINT_HEADER_LINE("compression", "%d",                     blackboxConfig()->compression);
+#endif
+#ifdef USE_BLACKBOX_RATE_CONTROL
+        BLACKBOX_PRINT_HEADER_LINE("rate_control", "%d",                    blackboxConfig()->rate_control);
+#endif
 
 
         default:
@@ -1346,6 +1592,77 @@ static bool blackboxWriteSysinfo(void)
     return false;
 }
 
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+/**
+ * Transmit the next line of the gyro capture header, which replaces all other headers for such a log. Returns true iff
+ * transmission is complete.
+ */
+static bool blackboxWriteGyroCaptureHeader(void)
+{
+    // The field list is the longest line
+    if (blackboxDeviceReserveBufferSpace(128) != BLACKBOX_RESERVE_SUCCESS) {
+        return false;
+    }
+
+    char buf[FORMATTED_DATE_TIME_BUFSIZE];
+
+    switch (xmitState.headerIndex) {
+    case 0:
+        blackboxPrintfHeaderLine("Product", "%s", "Blackbox gyro capture");
+        break;
+    case 1:
+        blackboxPrintfHeaderLine("Data version", "%d", BLACKBOX_GYRO_CAPTURE_DATA_VERSION);
+        break;
+    case 2:
+        blackboxPrintfHeaderLine("Firmware revision", "%s %s (%s) %s", FC_FIRMWARE_NAME, FC_VERSION_STRING, shortGitRevision, targetName);
+        break;
+    case 3:
+        blackboxPrintfHeaderLine("Log start datetime", "%s", blackboxGetStartDateTime(buf));
+        break;
+    case 4:
+        blackboxPrintfHeaderLine("looptime", "%d", gyro.targetLooptime);
+        break;
+    case 5:
+        // deg/s per LSB of gyroADCRaw
+        blackboxPrintfHeaderLine("gyro_scale", "0x%x", castFloatBytesToInt(gyroScale()));
+        break;
+    case 6:
+        blackboxPrintfHeaderLine("gyroADCf_scale", "0x%x", castFloatBytesToInt(1.0f / BLACKBOX_GYRO_CAPTURE_FILTERED_SCALE));
+        break;
+    case 7:
+        if (blackboxConfig()->gyro_capture == BLACKBOX_GYRO_CAPTURE_RAW_FILTERED) {
+            blackboxPrintfHeaderLine("Fields", "%s", "time,gyroADCRaw[0],gyroADCRaw[1],gyroADCRaw[2],gyroADCf[0],gyroADCf[1],gyroADCf[2]");
+        } else {
+            blackboxPrintfHeaderLine("Fields", "%s", "time,gyroADCRaw[0],gyroADCRaw[1],gyroADCRaw[2]");
+        }
+        break;
+    default:
+        return true;
+    }
+
+    xmitState.headerIndex++;
+    return false;
+}
+#endif
+
+/**
+ * Write as many system information header lines as fit before a realtime task is due. Returns true iff transmission
+ * is complete.
+ */
+static bool blackboxWriteSysinfoChunk(void)
+{
+    while (true) {
+        const uint32_t headerIndex = xmitState.headerIndex;
+        if (blackboxWriteSysinfo()) {
+            return true;
+        }
+        // stop if no line could be written, or there is no time left to write another one
+        if (xmitState.headerIndex == headerIndex || schedulerTaskShouldYield(BLACKBOX_SYSINFO_LINE_TIME_US)) {
+            return false;
+        }
+    }
+}
+
 /**
  * Write the given event to the log immediately
  */
@@ -1356,6 +1673,8 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data)
         return;
     }
 
+    blackboxFrameBegin();
+
     //Shared header for event frames
     blackboxWrite('E');
     blackboxWrite(event);
@@ -1382,13 +1701,36 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data)
         blackboxWriteUnsignedVB(data->loggingResume.logIteration);
         blackboxWriteUnsignedVB(data->loggingResume.currentTime);
         break;
+    case FLIGHT_LOG_EVENT_TASK_GOVERNOR:
+        blackboxWrite(data->taskGovernor.level);
+        blackboxWriteUnsignedVB(data->taskGovernor.systemLoad);
+        break;
+    case FLIGHT_LOG_EVENT_LOG_RATE:
+        blackboxWriteUnsignedVB(data->logRate.pInterval);
+        break;
     case FLIGHT_LOG_EVENT_LOG_END:
         blackboxWriteString("End of log");
         blackboxWrite(0);
         break;
     }
+
+    blackboxFrameEnd();
 }
 
+#ifdef USE_BLACKBOX_TRIGGER
+// Events around which the full rate data is of interest
+static bool blackboxTriggerConditionActive(void)
+{
+    return IS_RC_MODE_ACTIVE(BOXBLACKBOX)
+        || crashRecoveryModeActive()
+        || gyroOverflowDetected()
+#ifdef USE_YAW_SPIN_RECOVERY
+        || gyroYawSpinDetected()
+#endif
+        || failsafeIsActive();
+}
+#endif
+
 /* If an arming beep has played since it was last logged, write the time of the arming beep to the log as a synchronization point */
 static void blackboxCheckAndLogArmingBeep(void)
 {
@@ -1442,6 +1784,51 @@ STATIC_UNIT_TESTED bool blackboxShouldLogGpsHomeFrame(void)
 }
 #endif // GPS
 
+#ifdef USE_BLACKBOX_RATE_CONTROL
+// P frame interval in use, stretched while the device cannot keep up
+static int16_t blackboxEffectivePInterval(void)
+{
+    const int32_t pInterval = (int32_t)blackboxPInterval << blackboxRateShift;
+    return MIN(pInterval, blackboxIInterval);
+}
+
+// Called at each I interval boundary, so a rate change always starts on an I frame
+static void blackboxUpdateRateControl(void)
+{
+    const uint16_t backPressure = blackboxDeviceTakeBackPressure();
+
+    if (!blackboxConfig()->rate_control || blackboxPInterval == 0) {
+        blackboxRateShift = 0;
+        return;
+    }
+
+    if (backPressure) {
+        blackboxRateGoodIntervals = 0;
+        if (blackboxRateShift < BLACKBOX_RATE_SHIFT_MAX && blackboxEffectivePInterval() < blackboxIInterval) {
+            blackboxRateShift++;
+        }
+    } else if (blackboxRateShift > 0 && ++blackboxRateGoodIntervals >= BLACKBOX_RATE_RESTORE_INTERVALS) {
+        blackboxRateGoodIntervals = 0;
+        blackboxRateShift--;
+    }
+}
+
+// Record a P frame rate change in the log, so the viewer knows the gaps between frames are intentional
+static void blackboxCheckAndLogRate(void)
+{
+    const int16_t pInterval = blackboxEffectivePInterval();
+    if (pInterval != blackboxRatePIntervalLogged) {
+        flightLogEvent_logRate_t eventData = {
+            .pInterval = pInterval,
+        };
+        blackboxLogEvent(FLIGHT_LOG_EVENT_LOG_RATE, (flightLogEventData_t *)&eventData);
+        blackboxRatePIntervalLogged = pInterval;
+    }
+}
+#else
+#define blackboxEffectivePInterval() blackboxPInterval
+#endif
+
 // Called once every FC loop in order to keep track of how many FC loop iterations have passed
 STATIC_UNIT_TESTED void blackboxAdvanceIterationTimers(void)
 {
@@ -1452,16 +1839,38 @@ STATIC_UNIT_TESTED void blackboxAdvanceIterationTimers(void)
         blackboxLoopIndex = 0;
         blackboxIFrameIndex++;
         blackboxPFrameIndex = 0;
-    } else if (++blackboxPFrameIndex >= blackboxPInterval) {
+#ifdef USE_BLACKBOX_RATE_CONTROL
+        blackboxUpdateRateControl();
+#endif
+    } else if (++blackboxPFrameIndex >= blackboxEffectivePInterval()) {
         blackboxPFrameIndex = 0;
     }
 }
 
-// Called once every FC loop in order to log the current state
-STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
+// Write the frames of one logged iteration, with its main state already in blackboxHistory[0] if a main frame is logged
+static void blackboxWriteIteration(timeUs_t currentTimeUs, uint32_t iteration, bool logIFrame, bool logPFrame, bool logGpsHome)
 {
+#ifdef USE_BLACKBOX_TRIGGER
+    if (blackboxTriggerIsEnabled() && blackboxTriggerConditionActive()) {
+        blackboxTriggerFire(currentTimeUs);
+    }
+#endif
+
+    blackboxFrameBegin();
+
+#ifdef USE_BLACKBOX_TRIGGER
+    if (logIFrame && blackboxTriggerIsEnabled() && blackboxTriggerMarkKeyframe(iteration, currentTimeUs)) {
+        // Frames before this one were dropped
+        flightLogEvent_loggingResume_t resume = {
+            .logIteration = iteration,
+            .currentTime = currentTimeUs,
+        };
+        blackboxLogEvent(FLIGHT_LOG_EVENT_LOGGING_RESUME, (flightLogEventData_t *)&resume);
+    }
+#endif
+
     // Write a keyframe every blackboxIInterval frames so we can resynchronise upon missing frames
-    if (blackboxShouldLogIFrame()) {
+    if (logIFrame) {
         /*
          * Don't log a slow frame if the slow data didn't change ("I" frames are already large enough without adding
          * an additional item to write at the same time). Unless we're *only* logging "I" frames, then we have no choice.
@@ -1470,25 +1879,30 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
             writeSlowFrameIfNeeded();
         }
 
-        loadMainState(currentTimeUs);
-        writeIntraframe();
+        PROFILE_BEGIN(PROFILE_BLACKBOX_ENCODE);
+        writeIntraframe(iteration);
+        PROFILE_END(PROFILE_BLACKBOX_ENCODE);
+#ifdef USE_BLACKBOX_RATE_CONTROL
+        blackboxCheckAndLogRate();
+#endif
     } else {
         blackboxCheckAndLogArmingBeep();
         blackboxCheckAndLogFlightMode(); // Check for FlightMode status change event
 
-        if (blackboxShouldLogPFrame()) {
+        if (logPFrame) {
             /*
              * We assume that slow frames are only interesting in that they aid the interpretation of the main data stream.
              * So only log slow frames during loop iterations where we log a main frame.
              */
             writeSlowFrameIfNeeded();
 
-            loadMainState(currentTimeUs);
+            PROFILE_BEGIN(PROFILE_BLACKBOX_ENCODE);
             writeInterframe();
+            PROFILE_END(PROFILE_BLACKBOX_ENCODE);
         }
 #ifdef USE_GPS
         if (feature(FEATURE_GPS)) {
-            if (blackboxShouldLogGpsHomeFrame()) {
+            if (logGpsHome) {
                 writeGPSHomeFrame();
                 writeGPSFrame(currentTimeUs);
             } else if (gpsSol.numSat != gpsHistory.GPS_numSat
@@ -1498,11 +1912,132 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
                 writeGPSFrame(currentTimeUs);
             }
         }
+#else
+        UNUSED(logGpsHome);
 #endif
     }
 
+    blackboxFrameEnd();
+
+#ifdef USE_BLACKBOX_TRIGGER
+    blackboxTriggerDrain(currentTimeUs);
+#endif
+}
+
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+// Encode and write the captured gyro samples
+static void blackboxLogGyroCapture(void)
+{
+    if (blackboxGyroCaptureEncode()) {
+        blackboxLoggedAnyFrames = true;
+        blackboxDeviceFlush();
+    }
+}
+#endif
+
+#ifdef USE_BLACKBOX_DEFERRED_ENCODING
+static void blackboxCaptureIteration(timeUs_t currentTimeUs, uint8_t flags)
+{
+    const uint8_t head = blackboxCaptureHead;
+    if (((head + 1) & (BLACKBOX_CAPTURE_RING_SIZE - 1)) == blackboxCaptureTail) {
+        blackboxCaptureDropped = true;
+        return;
+    }
+
+    blackboxCapture_t *capture = &blackboxCaptureRing[head];
+    loadMainState(&capture->state, currentTimeUs);
+    capture->iteration = blackboxIteration;
+    capture->flags = flags;
+
+    __DMB(); // the capture must be complete before the encoder can see it
+    blackboxCaptureHead = (head + 1) & (BLACKBOX_CAPTURE_RING_SIZE - 1);
+}
+
+static void blackboxCaptureReset(void)
+{
+    blackboxCaptureTail = blackboxCaptureHead;
+    blackboxCaptureDropped = false;
+}
+
+// Encode and write all captured frames
+static void blackboxEncodeCaptured(void)
+{
+    bool wroteFrames = false;
+
+    while (blackboxCaptureTail != blackboxCaptureHead) {
+        __DMB();
+        const blackboxCapture_t *capture = &blackboxCaptureRing[blackboxCaptureTail];
+        bool logIFrame = capture->flags & BLACKBOX_CAPTURE_IFRAME;
+
+        if (blackboxCaptureDropped) {
+            // Frames are missing before this one, so tell the decoder and restart the predictors with an I frame
+            blackboxCaptureDropped = false;
+            flightLogEvent_loggingResume_t resume = {
+                .logIteration = capture->iteration,
+                .currentTime = capture->state.time,
+            };
+            blackboxLogEvent(FLIGHT_LOG_EVENT_LOGGING_RESUME, (flightLogEventData_t *)&resume);
+            logIFrame = true;
+        }
+
+        memcpy(blackboxHistory[0], &capture->state, sizeof(blackboxMainState_t));
+        blackboxWriteIteration(capture->state.time, capture->iteration, logIFrame, capture->flags & BLACKBOX_CAPTURE_PFRAME, capture->flags & BLACKBOX_CAPTURE_GPS_HOME);
+
+        blackboxCaptureTail = (blackboxCaptureTail + 1) & (BLACKBOX_CAPTURE_RING_SIZE - 1);
+        wroteFrames = true;
+    }
+
+    if (wroteFrames) {
+        blackboxDeviceFlush();
+    }
+}
+
+/**
+ * Encode the frames captured by the PID loop, from TASK_BLACKBOX.
+ */
+void blackboxEncodeUpdate(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    if (blackboxState == BLACKBOX_STATE_RUNNING || blackboxState == BLACKBOX_STATE_PAUSED) {
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+        if (blackboxGyroCaptureLog) {
+            blackboxLogGyroCapture();
+            return;
+        }
+#endif
+        blackboxEncodeCaptured();
+    } else {
+        blackboxCaptureReset();
+    }
+}
+#endif
+
+// Called once every FC loop in order to log the current state
+STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
+{
+    const bool logIFrame = blackboxShouldLogIFrame();
+    const bool logPFrame = !logIFrame && blackboxShouldLogPFrame();
+    bool logGpsHome = false;
+#ifdef USE_GPS
+    if (!logIFrame && feature(FEATURE_GPS)) {
+        logGpsHome = blackboxShouldLogGpsHomeFrame();
+    }
+#endif
+
+#ifdef USE_BLACKBOX_DEFERRED_ENCODING
+    if (logIFrame || logPFrame || logGpsHome) {
+        blackboxCaptureIteration(currentTimeUs, (logIFrame ? BLACKBOX_CAPTURE_IFRAME : 0) | (logPFrame ? BLACKBOX_CAPTURE_PFRAME : 0) | (logGpsHome ? BLACKBOX_CAPTURE_GPS_HOME : 0));
+    }
+#else
+    if (logIFrame || logPFrame) {
+        loadMainState(blackboxHistory[0], currentTimeUs);
+    }
+    blackboxWriteIteration(currentTimeUs, blackboxIteration, logIFrame, logPFrame, logGpsHome);
+
     //Flush every iteration so that our runtime variance is minimized
     blackboxDeviceFlush();
+#endif
 }
 
 /**
@@ -1510,12 +2045,25 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
  */
 void blackboxUpdate(timeUs_t currentTimeUs)
 {
+#ifdef USE_BLACKBOX_TRIGGER
+    if (blackboxTriggerIsBacklogged()) {
+        // Pass on the header written so far
+        blackboxTriggerDrain(currentTimeUs);
+        blackboxDeviceFlush();
+    }
+#endif
+
     switch (blackboxState) {
     case BLACKBOX_STATE_STOPPED:
         if (ARMING_FLAG(ARMED)) {
             blackboxOpen();
             blackboxStart();
         }
+#ifdef USE_FLASHFS_ERASE_AHEAD
+        else if (blackboxConfig()->device == BLACKBOX_DEVICE_FLASH) {
+            flashfsEraseAheadUpdate();
+        }
+#endif
 #ifdef USE_FLASHFS
         if (IS_RC_MODE_ACTIVE(BOXBLACKBOXERASE)) {
             blackboxSetState(BLACKBOX_STATE_START_ERASE);
@@ -1524,7 +2072,7 @@ void blackboxUpdate(timeUs_t currentTimeUs)
         break;
     case BLACKBOX_STATE_PREPARE_LOG_FILE:
         if (blackboxDeviceBeginLog()) {
-            blackboxSetState(BLACKBOX_STATE_SEND_HEADER);
+            blackboxSetState(isGyroCaptureLog() ? BLACKBOX_STATE_SEND_GYRO_CAPTURE_HEADER : BLACKBOX_STATE_SEND_HEADER);
         }
         break;
     case BLACKBOX_STATE_SEND_HEADER:
@@ -1535,7 +2083,7 @@ void blackboxUpdate(timeUs_t currentTimeUs)
          * Once the UART has had time to init, transmit the header in chunks so we don't overflow its transmit
          * buffer, overflow the OpenLog's buffer, or keep the main loop busy for too long.
          */
-        if (millis() > xmitState.u.startTime + 100) {
+        if (blackboxConfig()->device != BLACKBOX_DEVICE_SERIAL || millis() > xmitState.u.startTime + 100) {
             if (blackboxDeviceReserveBufferSpace(BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION) == BLACKBOX_RESERVE_SUCCESS) {
                 for (int i = 0; i < BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION && blackboxHeader[xmitState.headerIndex] != '\0'; i++, xmitState.headerIndex++) {
                     blackboxWrite(blackboxHeader[xmitState.headerIndex]);
@@ -1591,7 +2139,15 @@ void blackboxUpdate(timeUs_t currentTimeUs)
         //On entry of this state, xmitState.headerIndex is 0
 
         //Keep writing chunks of the system info headers until it returns true to signal completion
-        if (blackboxWriteSysinfo()) {
+        if (blackboxWriteSysinfoChunk()) {
+#ifdef USE_BLACKBOX_TRIGGER
+            if (blackboxTriggerIsBacklogged()) {
+                // The header is complete in RAM, the frames queue behind it
+                blackboxTriggerBacklogHeaderEnd();
+                blackboxSetState(BLACKBOX_STATE_RUNNING);
+                break;
+            }
+#endif
             /*
              * Wait for header buffers to drain completely before data logging begins to ensure reliable header delivery
              * (overflowing circular buffers causes all data to be discarded, so the first few logged iterations
@@ -1602,6 +2158,15 @@ void blackboxUpdate(timeUs_t currentTimeUs)
             }
         }
         break;
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+    case BLACKBOX_STATE_SEND_GYRO_CAPTURE_HEADER:
+        blackboxReplenishHeaderBudget();
+        //On entry of this state, xmitState.headerIndex is 0 and startTime is intialised
+        if (millis() > xmitState.u.startTime + 100 && blackboxWriteGyroCaptureHeader() && blackboxDeviceFlushForce()) {
+            blackboxSetState(BLACKBOX_STATE_RUNNING);
+        }
+        break;
+#endif
     case BLACKBOX_STATE_PAUSED:
         // Only allow resume to occur during an I-frame iteration, so that we have an "I" base to work from
         if (IS_RC_MODE_ACTIVE(BOXBLACKBOX) && blackboxShouldLogIFrame()) {
@@ -1614,16 +2179,29 @@ void blackboxUpdate(timeUs_t currentTimeUs)
             blackboxLogEvent(FLIGHT_LOG_EVENT_LOGGING_RESUME, (flightLogEventData_t *) &resume);
             blackboxSetState(BLACKBOX_STATE_RUNNING);
 
-            blackboxLogIteration(currentTimeUs);
+            if (!isGyroCaptureLog()) {
+                blackboxLogIteration(currentTimeUs);
+            }
         }
+#if defined(USE_BLACKBOX_GYRO_CAPTURE) && !defined(USE_BLACKBOX_DEFERRED_ENCODING)
+        if (blackboxGyroCaptureLog) {
+            blackboxLogGyroCapture();
+        }
+#endif
         // Keep the logging timers ticking so our log iteration continues to advance
         blackboxAdvanceIterationTimers();
         break;
     case BLACKBOX_STATE_RUNNING:
         // On entry to this state, blackboxIteration, blackboxPFrameIndex and blackboxIFrameIndex are reset to 0
         // Prevent the Pausing of the log on the mode switch if in Motor Test Mode
-        if (blackboxModeActivationConditionPresent && !IS_RC_MODE_ACTIVE(BOXBLACKBOX) && !startedLoggingInTestMode) {
+        // In trigger logging the mode switch is a trigger instead
+        if (blackboxModeActivationConditionPresent && !IS_RC_MODE_ACTIVE(BOXBLACKBOX) && !startedLoggingInTestMode && !blackboxIsTriggerLog()) {
             blackboxSetState(BLACKBOX_STATE_PAUSED);
+        } else if (isGyroCaptureLog()) {
+#if defined(USE_BLACKBOX_GYRO_CAPTURE) && !defined(USE_BLACKBOX_DEFERRED_ENCODING)
+            // The samples are captured by the gyro loop, just write them out
+            blackboxLogGyroCapture();
+#endif
         } else {
             blackboxLogIteration(currentTimeUs);
         }
@@ -1637,6 +2215,13 @@ void blackboxUpdate(timeUs_t currentTimeUs)
          *
          * Don't wait longer than it could possibly take if something funky happens.
          */
+#ifdef USE_BLACKBOX_TRIGGER
+        // Write out the rest of the trigger window first
+        if (blackboxTriggerDrain(micros()) && millis() < xmitState.u.startTime + BLACKBOX_TRIGGER_SHUTDOWN_TIMEOUT_MILLIS) {
+            blackboxDeviceFlush();
+            break;
+        }
+#endif
         if (blackboxDeviceEndLog(blackboxLoggedAnyFrames) && (millis() > xmitState.u.startTime + BLACKBOX_SHUTDOWN_TIMEOUT_MILLIS || blackboxDeviceFlushForce())) {
             blackboxDeviceClose();
             blackboxSetState(BLACKBOX_STATE_STOPPED);
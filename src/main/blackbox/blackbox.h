@@ -42,11 +42,32 @@ typedef enum BlackboxMode {
     BLACKBOX_MODE_ALWAYS_ON
 } BlackboxMode;
 
+typedef enum {
+    BLACKBOX_GYRO_CAPTURE_OFF = 0,
+    BLACKBOX_GYRO_CAPTURE_RAW,
+    BLACKBOX_GYRO_CAPTURE_RAW_FILTERED
+} blackboxGyroCapture_e;
+
+typedef enum {
+    BLACKBOX_MIRROR_OFF = 0,
+    BLACKBOX_MIRROR_FULL,       // the serial port gets the same log as the flash or SD card
+    BLACKBOX_MIRROR_KEYFRAMES   // the serial port gets the log without P frames, at the I frame rate
+} blackboxMirror_e;
+
+typedef enum {
+    BLACKBOX_ERASE_FULL = 0,
+    BLACKBOX_ERASE_INCREMENTAL  // a flash is erased in the background while disarmed, ahead of the new logs
+} blackboxEraseMode_e;
+
+#define BLACKBOX_HIGH_RESOLUTION_SCALE 10
+
 typedef enum FlightLogEvent {
     FLIGHT_LOG_EVENT_SYNC_BEEP = 0,
     FLIGHT_LOG_EVENT_INFLIGHT_ADJUSTMENT = 13,
     FLIGHT_LOG_EVENT_LOGGING_RESUME = 14,
     FLIGHT_LOG_EVENT_FLIGHTMODE = 30, // Add new event type for flight mode status.
+    FLIGHT_LOG_EVENT_TASK_GOVERNOR = 31,
+    FLIGHT_LOG_EVENT_LOG_RATE = 32,
     FLIGHT_LOG_EVENT_LOG_END = 255
 } FlightLogEvent;
 
@@ -55,6 +76,16 @@ typedef struct blackboxConfig_s {
     uint8_t device;
     uint8_t record_acc;
     uint8_t mode;
+    uint8_t gyro_capture;   // log only the gyro at the full gyro rate, see blackboxGyroCapture_e
+    uint8_t trigger;        // only log at the full rate around trigger events
+    uint16_t trigger_pre_ms;
+    uint16_t trigger_post_ms;
+    uint16_t trigger_background_ms; // interval of the I frames logged outside of trigger windows, 0 for none
+    uint8_t rate_control;   // lower the P frame rate while the device cannot keep up
+    uint8_t high_resolution; // log gyro and setpoint in 1/BLACKBOX_HIGH_RESOLUTION_SCALE deg/s
+    uint8_t compression;    // Huffman code the frames of each logging iteration
+    uint8_t mirror;         // copy a flash or SD card log to the blackbox serial port, see blackboxMirror_e
+    uint8_t erase_mode;     // how the logs on a flash are erased, see blackboxEraseMode_e
 } blackboxConfig_t;
 
 PG_DECLARE(blackboxConfig_t, blackboxConfig);
@@ -64,6 +95,7 @@ void blackboxLogEvent(FlightLogEvent event, union flightLogEventData_u *data);
 
 void blackboxInit(void);
 void blackboxUpdate(timeUs_t currentTimeUs);
+void blackboxEncodeUpdate(timeUs_t currentTimeUs);
 void blackboxSetStartDateTime(const char *dateTime, timeMs_t timeNowMs);
 int blackboxCalculatePDenom(int rateNum, int rateDenom);
 uint8_t blackboxGetRateDenom(void);
@@ -80,4 +112,21 @@ STATIC_UNIT_TESTED bool writeSlowFrameIfNeeded(void);
 STATIC_UNIT_TESTED void blackboxAdvanceIterationTimers(void);
 extern int32_t blackboxSInterval;
 extern int32_t blackboxSlowFrameIterationTimer;
+
+// Main frame encoder access for the round trip tests, fields are numbered in the order they are logged
+typedef struct blackboxMainFieldEncoding_s {
+    uint8_t Ipredict;
+    uint8_t Iencode;
+    uint8_t Ppredict;
+    uint8_t Pencode;
+    bool groupEnd;      // last field of a tagged group in P frames
+    bool iteration;     // the loop iteration of the frame, not a value of the main state
+} blackboxMainFieldEncoding_t;
+
+STATIC_UNIT_TESTED void writeIntraframe(uint32_t iteration);
+STATIC_UNIT_TESTED void writeInterframe(void);
+void blackboxStartMainFrames(void);
+int blackboxMainFieldCount(void);
+void blackboxGetMainFieldEncoding(int field, blackboxMainFieldEncoding_t *encoding);
+void blackboxSetMainFieldValue(int field, int32_t value);
 #endif
@@ -38,6 +38,7 @@ typedef enum FlightLogFieldCondition {
     FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC,
     FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER,
     FLIGHT_LOG_FIELD_CONDITION_RSSI,
+    FLIGHT_LOG_FIELD_CONDITION_RX_LATENCY,
 
     FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0,
     FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_1,
@@ -47,6 +48,7 @@ typedef enum FlightLogFieldCondition {
 
     FLIGHT_LOG_FIELD_CONDITION_ACC,
     FLIGHT_LOG_FIELD_CONDITION_DEBUG,
+    FLIGHT_LOG_FIELD_CONDITION_HIGH_RESOLUTION,
 
     FLIGHT_LOG_FIELD_CONDITION_NEVER,
 
@@ -130,6 +132,15 @@ typedef struct flightLogEvent_loggingResume_s {
     uint32_t currentTime;
 } flightLogEvent_loggingResume_t;
 
+typedef struct flightLogEvent_taskGovernor_s {
+    uint8_t level;
+    uint16_t systemLoad;
+} flightLogEvent_taskGovernor_t;
+
+typedef struct flightLogEvent_logRate_s {
+    uint16_t pInterval; // loop iterations between P frames from here on
+} flightLogEvent_logRate_t;
+
 #define FLIGHT_LOG_EVENT_INFLIGHT_ADJUSTMENT_FUNCTION_FLOAT_VALUE_FLAG 128
 
 typedef union flightLogEventData_u {
@@ -137,6 +148,8 @@ typedef union flightLogEventData_u {
     flightLogEvent_flightMode_t flightMode; // New event data
     flightLogEvent_inflightAdjustment_t inflightAdjustment;
     flightLogEvent_loggingResume_t loggingResume;
+    flightLogEvent_taskGovernor_t taskGovernor;
+    flightLogEvent_logRate_t logRate;
 } flightLogEventData_t;
 
 typedef struct flightLogEvent_s {
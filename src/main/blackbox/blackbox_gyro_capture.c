@@ -0,0 +1,168 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Full gyro rate capture of the unfiltered (and optionally filtered) gyro, for spectrum analysis.
+ *
+ * The gyro loop pushes samples into a ring, the blackbox encoder drains it into blocks:
+ *
+ *   'R', sample count (VB), samples dropped before this block (VB),
+ *   first sample:   time (VB), gyroADCRaw[3] (signed VB) [, gyroADCf[3] (signed VB)]
+ *   other samples:  time delta (VB), gyroADCRaw[3] deltas (signed VB) [, gyroADCf[3] deltas (signed VB)]
+ *
+ * Every block starts with absolute values, so the decoder resynchronises after dropped samples.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+
+#include "blackbox_encoding.h"
+#include "blackbox_gyro_capture.h"
+#include "blackbox_io.h"
+
+#include "common/axis.h"
+#include "common/maths.h"
+
+#define BLACKBOX_GYRO_CAPTURE_RING_SIZE 64      // must be a power of 2
+#define BLACKBOX_GYRO_CAPTURE_BLOCK_SAMPLES 16  // keeps a block well within the frame buffer
+
+typedef struct blackboxGyroSample_s {
+    uint32_t time;
+    int16_t raw[XYZ_AXIS_COUNT];
+    int16_t filtered[XYZ_AXIS_COUNT];
+} blackboxGyroSample_t;
+
+FAST_RAM_ZERO_INIT volatile bool blackboxGyroCaptureActive;
+
+static blackboxGyroSample_t blackboxGyroCaptureRing[BLACKBOX_GYRO_CAPTURE_RING_SIZE];
+// Single producer (the gyro loop) and single consumer (the blackbox encoder)
+static volatile uint8_t blackboxGyroCaptureHead;
+static volatile uint8_t blackboxGyroCaptureTail;
+static volatile uint32_t blackboxGyroCaptureDropped;
+static bool blackboxGyroCaptureFiltered;
+
+// Discard all captured samples, call before starting a new log while the capture is stopped
+void blackboxGyroCaptureReset(bool logFiltered)
+{
+    blackboxGyroCaptureFiltered = logFiltered;
+    blackboxGyroCaptureTail = blackboxGyroCaptureHead;
+    blackboxGyroCaptureDropped = 0;
+}
+
+void blackboxGyroCaptureStart(void)
+{
+    blackboxGyroCaptureActive = true;
+}
+
+void blackboxGyroCaptureStop(void)
+{
+    blackboxGyroCaptureActive = false;
+}
+
+FAST_CODE void blackboxGyroCaptureSample(timeUs_t currentTimeUs, const int16_t *gyroADCRaw, const float *gyroADCf)
+{
+    const uint8_t head = blackboxGyroCaptureHead;
+    if (((head + 1) & (BLACKBOX_GYRO_CAPTURE_RING_SIZE - 1)) == blackboxGyroCaptureTail) {
+        blackboxGyroCaptureDropped++;
+        return;
+    }
+
+    blackboxGyroSample_t *sample = &blackboxGyroCaptureRing[head];
+    sample->time = currentTimeUs;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        sample->raw[axis] = gyroADCRaw[axis];
+        sample->filtered[axis] = constrainf(gyroADCf[axis] * BLACKBOX_GYRO_CAPTURE_FILTERED_SCALE, INT16_MIN, INT16_MAX);
+    }
+
+#ifndef UNIT_TEST
+    __DMB(); // the sample must be complete before the encoder can see it
+#endif
+    blackboxGyroCaptureHead = (head + 1) & (BLACKBOX_GYRO_CAPTURE_RING_SIZE - 1);
+}
+
+static void writeGyroCaptureBlock(int count)
+{
+    const blackboxGyroSample_t *previous = NULL;
+
+    blackboxWrite('R');
+    blackboxWriteUnsignedVB(count);
+    blackboxWriteUnsignedVB(blackboxGyroCaptureDropped);
+    blackboxGyroCaptureDropped = 0;
+
+    for (int i = 0; i < count; i++) {
+        const blackboxGyroSample_t *sample = &blackboxGyroCaptureRing[blackboxGyroCaptureTail];
+
+        if (previous) {
+            blackboxWriteUnsignedVB(sample->time - previous->time);
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                blackboxWriteSignedVB(sample->raw[axis] - previous->raw[axis]);
+            }
+            if (blackboxGyroCaptureFiltered) {
+                for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                    blackboxWriteSignedVB(sample->filtered[axis] - previous->filtered[axis]);
+                }
+            }
+        } else {
+            blackboxWriteUnsignedVB(sample->time);
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                blackboxWriteSignedVB(sample->raw[axis]);
+            }
+            if (blackboxGyroCaptureFiltered) {
+                for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                    blackboxWriteSignedVB(sample->filtered[axis]);
+                }
+            }
+        }
+
+        previous = sample;
+        // The producer never writes the slot behind the tail, so previous stays valid until the block is complete
+        blackboxGyroCaptureTail = (blackboxGyroCaptureTail + 1) & (BLACKBOX_GYRO_CAPTURE_RING_SIZE - 1);
+    }
+}
+
+/**
+ * Encode the captured samples into blocks and write them to the device. Returns true if anything was written.
+ */
+bool blackboxGyroCaptureEncode(void)
+{
+    bool wroteBlocks = false;
+
+    while (true) {
+        const int available = (blackboxGyroCaptureHead - blackboxGyroCaptureTail) & (BLACKBOX_GYRO_CAPTURE_RING_SIZE - 1);
+        if (available == 0) {
+            break;
+        }
+#ifndef UNIT_TEST
+        __DMB();
+#endif
+
+        blackboxFrameBegin();
+        writeGyroCaptureBlock(MIN(available, BLACKBOX_GYRO_CAPTURE_BLOCK_SAMPLES));
+        blackboxFrameEnd();
+        wroteBlocks = true;
+    }
+
+    return wroteBlocks;
+}
+#endif // USE_BLACKBOX_GYRO_CAPTURE
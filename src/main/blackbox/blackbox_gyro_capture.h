@@ -0,0 +1,37 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+#define BLACKBOX_GYRO_CAPTURE_DATA_VERSION 1
+#define BLACKBOX_GYRO_CAPTURE_FILTERED_SCALE 10.0f  // gyroADCf is logged in 0.1 deg/s
+
+extern volatile bool blackboxGyroCaptureActive;
+
+void blackboxGyroCaptureReset(bool logFiltered);
+void blackboxGyroCaptureStart(void);
+void blackboxGyroCaptureStop(void);
+void blackboxGyroCaptureSample(timeUs_t currentTimeUs, const int16_t *gyroADCRaw, const float *gyroADCf);
+bool blackboxGyroCaptureEncode(void);
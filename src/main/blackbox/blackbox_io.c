@@ -30,8 +30,13 @@
 
 #include "blackbox.h"
 #include "blackbox_io.h"
+#include "blackbox_trigger.h"
 
+#include "common/huffman.h"
 #include "common/maths.h"
+#include "common/time.h"
+
+#include "drivers/time.h"
 
 #include "flight/pid.h"
 
@@ -52,6 +57,43 @@ int32_t blackboxHeaderBudget;
 static serialPort_t *blackboxPort = NULL;
 static portSharing_e blackboxPortSharing;
 
+#ifdef USE_BLACKBOX_MIRROR
+// Serial port that gets a copy of a flash or SD card log, see blackboxMirror_e
+static serialPort_t *blackboxMirrorPort = NULL;
+static portSharing_e blackboxMirrorPortSharing;
+
+// Start of the delta coded frame in the frame buffer that a keyframe mirror skips, or -1 for none
+static int blackboxMirrorSkipStart = -1;
+static int blackboxMirrorSkipEnd;
+static bool blackboxMirrorSkipping;     // the frame buffer currently ends within the skipped frame
+
+static void blackboxMirrorWrite(const uint8_t *data, int length);
+#endif
+
+// A complete logging iteration is encoded into this buffer and then written to the device at once
+#define BLACKBOX_FRAME_BUFFER_SIZE 256
+
+static uint8_t blackboxFrameBuffer[BLACKBOX_FRAME_BUFFER_SIZE];
+static int blackboxFrameBufferLength;
+static uint8_t blackboxFrameDepth;  // frames may nest, e.g. events written from within a logging iteration
+
+#ifdef USE_BLACKBOX_COMPRESSION
+/*
+ * Compressed frames are written as a 'Z' block: 'Z', the uncompressed and the compressed length as unsigned VB,
+ * then the frames Huffman coded with huffmanTable, the table of the compressed dataflash reads.
+ */
+#define BLACKBOX_COMPRESSED_HEADER_MAX_SIZE 5
+#define BLACKBOX_COMPRESSION_MIN_LENGTH     8   // shorter frames don't save enough to pay for the block header
+
+// One spare byte, the encoder clears the byte after the last one it fills
+static uint8_t blackboxCompressedBuffer[BLACKBOX_COMPRESSED_HEADER_MAX_SIZE + BLACKBOX_FRAME_BUFFER_SIZE + 1];
+#endif
+
+#ifdef USE_BLACKBOX_RATE_CONTROL
+// Number of writes the device could not take in full since it was last read
+static uint16_t blackboxDeviceBackPressure;
+#endif
+
 #ifdef USE_SDCARD
 
 static struct {
@@ -75,6 +117,15 @@ static struct {
 
 #endif // USE_SDCARD
 
+#ifdef USE_FLASHFS_LOG_INDEX
+// Where and when the current flash log started, for its entry of the flash log index
+static struct {
+    uint32_t start;
+    uint32_t armTime;
+    timeMs_t startTime;
+} blackboxFlashLog;
+#endif
+
 void blackboxOpen(void)
 {
     serialPort_t *sharedBlackboxAndMspPort = findSharedSerialPort(FUNCTION_BLACKBOX, FUNCTION_MSP);
@@ -83,60 +134,319 @@ void blackboxOpen(void)
     }
 }
 
-void blackboxWrite(uint8_t value)
+void blackboxDeviceWrite(const uint8_t *data, int length)
 {
     switch (blackboxConfig()->device) {
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
-        flashfsWriteByte(value); // Write byte asynchronously
-        break;
+#ifdef USE_BLACKBOX_RATE_CONTROL
+        if (flashfsGetWriteBufferFreeSpace() < (uint32_t)length && !flashfsIsReady()) {
+            blackboxDeviceBackPressure++;
+        }
 #endif
+        flashfsWrite(data, length, false); // Write asynchronously
+        break;
+#endif // USE_FLASHFS
+
 #ifdef USE_SDCARD
     case BLACKBOX_DEVICE_SDCARD:
-        afatfs_fputc(blackboxSDCard.logFile, value);
-        break;
+#ifdef USE_BLACKBOX_RATE_CONTROL
+        if (afatfs_fwrite(blackboxSDCard.logFile, data, length) < (uint32_t)length) {
+            blackboxDeviceBackPressure++;
+        }
+#else
+        afatfs_fwrite(blackboxSDCard.logFile, data, length); // Ignore failures due to buffers filling up
 #endif
+        break;
+#endif // USE_SDCARD
+
     case BLACKBOX_DEVICE_SERIAL:
     default:
-        serialWrite(blackboxPort, value);
+#ifdef USE_BLACKBOX_RATE_CONTROL
+        if (serialTxBytesFree(blackboxPort) < (uint32_t)length) {
+            blackboxDeviceBackPressure++;
+        }
+#endif
+        serialWriteBuf(blackboxPort, data, length);
         break;
     }
+
+#ifdef USE_BLACKBOX_MIRROR
+    if (blackboxMirrorPort && blackboxConfig()->mirror == BLACKBOX_MIRROR_FULL) {
+        blackboxMirrorWrite(data, length);
+    }
+#endif
 }
 
-// Print the null-terminated string 's' to the blackbox device and return the number of bytes written
-int blackboxWriteString(const char *s)
+#ifdef USE_BLACKBOX_RATE_CONTROL
+/**
+ * Return how many writes since the last call dropped data or had to wait for the device, and restart counting.
+ */
+uint16_t blackboxDeviceTakeBackPressure(void)
 {
-    int length;
-    const uint8_t *pos;
+    const uint16_t backPressure = blackboxDeviceBackPressure;
+    blackboxDeviceBackPressure = 0;
+    return backPressure;
+}
+#endif
 
+/**
+ * Return how many bytes the device can currently take without dropping any.
+ */
+uint32_t blackboxDeviceWriteBufferFree(void)
+{
     switch (blackboxConfig()->device) {
+#ifdef USE_FLASHFS
+    case BLACKBOX_DEVICE_FLASH:
+        return flashfsGetWriteBufferFreeSpace();
+#endif
+#ifdef USE_SDCARD
+    case BLACKBOX_DEVICE_SDCARD:
+        return afatfs_getFreeBufferSpace();
+#endif
+    case BLACKBOX_DEVICE_SERIAL:
+    default:
+        return serialTxBytesFree(blackboxPort);
+    }
+}
+
+#ifdef USE_BLACKBOX_COMPRESSION
+static uint8_t *blackboxPutUnsignedVB(uint8_t *dst, uint32_t value)
+{
+    while (value > 127) {
+        *dst++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *dst++ = value;
+    return dst;
+}
+
+/**
+ * Huffman code the frame buffer into a 'Z' block. Returns the start of the block and sets *length to its length,
+ * or returns NULL if the frames don't get shorter.
+ */
+static const uint8_t *blackboxCompressFrameBuffer(int *length)
+{
+    if (blackboxFrameBufferLength < BLACKBOX_COMPRESSION_MIN_LENGTH) {
+        return NULL;
+    }
+
+    huffmanState_t state = {
+        .bytesWritten = 0,
+        .outByte = blackboxCompressedBuffer + BLACKBOX_COMPRESSED_HEADER_MAX_SIZE,
+        .outBufLen = blackboxFrameBufferLength,
+        .outBit = 0x80,
+    };
+    *state.outByte = 0;
+
+    if (huffmanEncodeBufStreaming(&state, blackboxFrameBuffer, blackboxFrameBufferLength, huffmanTable) == -1) {
+        return NULL;
+    }
+    if (state.outBit != 0x80) {
+        ++state.bytesWritten;
+    }
+
+    uint8_t header[BLACKBOX_COMPRESSED_HEADER_MAX_SIZE];
+    uint8_t *headerEnd = header;
+    *headerEnd++ = 'Z';
+    headerEnd = blackboxPutUnsignedVB(headerEnd, blackboxFrameBufferLength);
+    headerEnd = blackboxPutUnsignedVB(headerEnd, state.bytesWritten);
+    const int headerLength = headerEnd - header;
+
+    const int blockLength = headerLength + state.bytesWritten;
+    if (blockLength >= blackboxFrameBufferLength) {
+        return NULL;
+    }
+
+    // Put the header right in front of the compressed frames
+    uint8_t *block = blackboxCompressedBuffer + BLACKBOX_COMPRESSED_HEADER_MAX_SIZE - headerLength;
+    memcpy(block, header, headerLength);
+    *length = blockLength;
+    return block;
+}
+#endif
+
+#ifdef USE_BLACKBOX_MIRROR
+static void blackboxMirrorWrite(const uint8_t *data, int length)
+{
+    // Drop what doesn't fit whole, a decoder resynchronises on the next frame
+    if (serialTxBytesFree(blackboxMirrorPort) >= (uint32_t)length) {
+        serialWriteBuf(blackboxMirrorPort, data, length);
+    }
+}
+
+// Pass the frame buffer without its delta coded frame to a keyframe mirror
+static void blackboxMirrorKeyframes(void)
+{
+    if (blackboxMirrorSkipStart < 0) {
+        blackboxMirrorWrite(blackboxFrameBuffer, blackboxFrameBufferLength);
+        return;
+    }
+
+    blackboxMirrorWrite(blackboxFrameBuffer, blackboxMirrorSkipStart);
+    if (blackboxMirrorSkipping) {
+        // The frame continues in the next buffer
+        blackboxMirrorSkipStart = 0;
+    } else {
+        blackboxMirrorWrite(blackboxFrameBuffer + blackboxMirrorSkipEnd, blackboxFrameBufferLength - blackboxMirrorSkipEnd);
+        blackboxMirrorSkipStart = -1;
+    }
+}
+
+/**
+ * Mark the start and the end of a frame that can only be decoded with the frames before it, a keyframe mirror
+ * leaves it out.
+ */
+void blackboxFrameDeltaBegin(void)
+{
+    blackboxMirrorSkipStart = blackboxFrameBufferLength;
+    blackboxMirrorSkipping = true;
+}
+
+void blackboxFrameDeltaEnd(void)
+{
+    blackboxMirrorSkipEnd = blackboxFrameBufferLength;
+    blackboxMirrorSkipping = false;
+}
+#endif
+
+static void blackboxFrameBufferFlush(void)
+{
+    if (blackboxFrameBufferLength > 0) {
+#ifdef USE_BLACKBOX_MIRROR
+        if (blackboxMirrorPort && blackboxConfig()->mirror == BLACKBOX_MIRROR_KEYFRAMES) {
+            blackboxMirrorKeyframes();
+        }
+#endif
+
+        const uint8_t *data = blackboxFrameBuffer;
+        int length = blackboxFrameBufferLength;
+#ifdef USE_BLACKBOX_COMPRESSION
+        if (blackboxConfig()->compression) {
+            const uint8_t *block = blackboxCompressFrameBuffer(&length);
+            if (block) {
+                data = block;
+            }
+        }
+#endif
+
+#ifdef USE_BLACKBOX_TRIGGER
+        if (blackboxTriggerIsEnabled()) {
+            blackboxTriggerWrite(data, length);
+        } else
+#endif
+        {
+            blackboxDeviceWrite(data, length);
+        }
+        blackboxFrameBufferLength = 0;
+    }
+}
+
+/**
+ * Collect everything written until blackboxFrameEnd() and hand it to the device in a single write.
+ */
+void blackboxFrameBegin(void)
+{
+    if (blackboxFrameDepth++ == 0) {
+        blackboxFrameBufferLength = 0;
+#ifdef USE_BLACKBOX_MIRROR
+        blackboxMirrorSkipStart = -1;
+        blackboxMirrorSkipping = false;
+#endif
+#ifdef USE_BLACKBOX_TRIGGER
+        if (blackboxTriggerIsEnabled()) {
+            blackboxTriggerFrameStart();
+        }
+#endif
+    }
+}
 
+void blackboxFrameEnd(void)
+{
+    if (--blackboxFrameDepth == 0) {
+        blackboxFrameBufferFlush();
+#ifdef USE_BLACKBOX_TRIGGER
+        if (blackboxTriggerIsEnabled()) {
+            blackboxTriggerFrameEnd();
+        }
+#endif
+    }
+}
+
+void blackboxWrite(uint8_t value)
+{
+    if (blackboxFrameDepth) {
+        if (blackboxFrameBufferLength == BLACKBOX_FRAME_BUFFER_SIZE) {
+            // Frames this large are rare, just pass on what we have so far
+            blackboxFrameBufferFlush();
+        }
+        blackboxFrameBuffer[blackboxFrameBufferLength++] = value;
+        return;
+    }
+
+#ifdef USE_BLACKBOX_TRIGGER
+    if (blackboxTriggerIsBacklogged()) {
+        blackboxTriggerBacklogWrite(&value, 1);
+#ifdef USE_BLACKBOX_MIRROR
+        // A full mirror gets the header from the backlog along with the device
+        if (blackboxMirrorPort && blackboxConfig()->mirror == BLACKBOX_MIRROR_KEYFRAMES) {
+            serialWrite(blackboxMirrorPort, value);
+        }
+#endif
+        return;
+    }
+#endif
+
+    switch (blackboxConfig()->device) {
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
-        length = strlen(s);
-        flashfsWrite((const uint8_t*) s, length, false); // Write asynchronously
+        flashfsWriteByte(value); // Write byte asynchronously
         break;
-#endif // USE_FLASHFS
-
+#endif
 #ifdef USE_SDCARD
     case BLACKBOX_DEVICE_SDCARD:
-        length = strlen(s);
-        afatfs_fwrite(blackboxSDCard.logFile, (const uint8_t*) s, length); // Ignore failures due to buffers filling up
+        afatfs_fputc(blackboxSDCard.logFile, value);
         break;
-#endif // USE_SDCARD
-
+#endif
     case BLACKBOX_DEVICE_SERIAL:
     default:
-        pos = (uint8_t*) s;
-        while (*pos) {
-            serialWrite(blackboxPort, *pos);
-            pos++;
-        }
-
-        length = pos - (uint8_t*) s;
+        serialWrite(blackboxPort, value);
         break;
     }
 
+#ifdef USE_BLACKBOX_MIRROR
+    // Outside of frames only the header is written, every mirror gets that
+    if (blackboxMirrorPort) {
+        serialWrite(blackboxMirrorPort, value);
+    }
+#endif
+}
+
+// Print the null-terminated string 's' to the blackbox device and return the number of bytes written
+int blackboxWriteString(const char *s)
+{
+    const int length = strlen(s);
+
+    if (blackboxFrameDepth) {
+        for (int i = 0; i < length; i++) {
+            blackboxWrite(s[i]);
+        }
+    } else {
+#ifdef USE_BLACKBOX_TRIGGER
+        if (blackboxTriggerIsBacklogged()) {
+            blackboxTriggerBacklogWrite((const uint8_t*) s, length);
+        } else
+#endif
+        {
+            blackboxDeviceWrite((const uint8_t*) s, length);
+        }
+#ifdef USE_BLACKBOX_MIRROR
+        if (blackboxMirrorPort && blackboxConfig()->mirror == BLACKBOX_MIRROR_KEYFRAMES) {
+            blackboxMirrorWrite((const uint8_t*) s, length);
+        }
+#endif
+    }
+
     return length;
 }
 
@@ -154,7 +464,7 @@ void blackboxDeviceFlush(void)
          * devices will progressively write in the background without Blackbox calling anything.
          */
     case BLACKBOX_DEVICE_FLASH:
-        flashfsFlushAsync();
+        flashfsFlushAsync(false);
         break;
 #endif // USE_FLASHFS
 
@@ -177,7 +487,7 @@ bool blackboxDeviceFlushForce(void)
 
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
-        return flashfsFlushAsync();
+        return flashfsFlushAsync(true);
 #endif // USE_FLASHFS
 
 #ifdef USE_SDCARD
@@ -194,68 +504,92 @@ bool blackboxDeviceFlushForce(void)
 }
 
 /**
- * Attempt to open the logging device. Returns true if successful.
+ * Open the serial port with FUNCTION_BLACKBOX and work out how fast the header may be written to it.
  */
-bool blackboxDeviceOpen(void)
+static serialPort_t *blackboxSerialOpen(portSharing_e *portSharing, uint8_t *maxHeaderBytesPerIteration)
 {
-    switch (blackboxConfig()->device) {
-    case BLACKBOX_DEVICE_SERIAL:
-        {
-            serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_BLACKBOX);
-            baudRate_e baudRateIndex;
-            portOptions_e portOptions = SERIAL_PARITY_NO | SERIAL_NOT_INVERTED;
+    serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_BLACKBOX);
+    baudRate_e baudRateIndex;
+    portOptions_e portOptions = SERIAL_PARITY_NO | SERIAL_NOT_INVERTED;
 
-            if (!portConfig) {
-                return false;
-            }
+    if (!portConfig) {
+        return NULL;
+    }
 
-            blackboxPortSharing = determinePortSharing(portConfig, FUNCTION_BLACKBOX);
-            baudRateIndex = portConfig->blackbox_baudrateIndex;
+    *portSharing = determinePortSharing(portConfig, FUNCTION_BLACKBOX);
+    baudRateIndex = portConfig->blackbox_baudrateIndex;
 
-            if (baudRates[baudRateIndex] == 230400) {
-                /*
-                 * OpenLog's 230400 baud rate is very inaccurate, so it requires a larger inter-character gap in
-                 * order to maintain synchronization.
-                 */
-                portOptions |= SERIAL_STOPBITS_2;
-            } else {
-                portOptions |= SERIAL_STOPBITS_1;
-            }
+    if (baudRates[baudRateIndex] == 230400) {
+        /*
+         * OpenLog's 230400 baud rate is very inaccurate, so it requires a larger inter-character gap in
+         * order to maintain synchronization.
+         */
+        portOptions |= SERIAL_STOPBITS_2;
+    } else {
+        portOptions |= SERIAL_STOPBITS_1;
+    }
 
-            blackboxPort = openSerialPort(portConfig->identifier, FUNCTION_BLACKBOX, NULL, NULL, baudRates[baudRateIndex],
-                BLACKBOX_SERIAL_PORT_MODE, portOptions);
+    serialPort_t *port = openSerialPort(portConfig->identifier, FUNCTION_BLACKBOX, NULL, NULL, baudRates[baudRateIndex],
+        BLACKBOX_SERIAL_PORT_MODE, portOptions);
+
+    /*
+     * The slowest MicroSD cards have a write latency approaching 400ms. The OpenLog's buffer is about 900
+     * bytes. In order for its buffer to be able to absorb this latency we must write slower than 6000 B/s.
+     *
+     * The OpenLager has a 125KB buffer for when the the MicroSD card is busy, so when the user configures
+     * high baud rates, assume the OpenLager is in use and so there is no need to constrain the writes.
+     *
+     * In all other cases, constrain the writes as follows:
+     *
+     *     Bytes per loop iteration = floor((looptime_ns / 1000000.0) * 6000)
+     *                              = floor((looptime_ns * 6000) / 1000000.0)
+     *                              = floor((looptime_ns * 3) / 500.0)
+     *                              = (looptime_ns * 3) / 500
+     */
+
+
+    switch (baudRateIndex) {
+    case BAUD_1000000:
+    case BAUD_1500000:
+    case BAUD_2000000:
+    case BAUD_2470000:
+        // assume OpenLager in use, so do not constrain writes
+        *maxHeaderBytesPerIteration = BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION;
+        break;
+    default:
+        *maxHeaderBytesPerIteration = constrain((targetPidLooptime * 3) / 500, 1, BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION);
+        break;
+    };
 
-            /*
-             * The slowest MicroSD cards have a write latency approaching 400ms. The OpenLog's buffer is about 900
-             * bytes. In order for its buffer to be able to absorb this latency we must write slower than 6000 B/s.
-             *
-             * The OpenLager has a 125KB buffer for when the the MicroSD card is busy, so when the user configures
-             * high baud rates, assume the OpenLager is in use and so there is no need to constrain the writes.
-             *
-             * In all other cases, constrain the writes as follows:
-             *
-             *     Bytes per loop iteration = floor((looptime_ns / 1000000.0) * 6000)
-             *                              = floor((looptime_ns * 6000) / 1000000.0)
-             *                              = floor((looptime_ns * 3) / 500.0)
-             *                              = (looptime_ns * 3) / 500
-             */
+    return port;
+}
 
+#ifdef USE_BLACKBOX_MIRROR
+// Open the serial mirror of a flash or SD card log, the log goes ahead without it if that fails
+static void blackboxMirrorOpen(void)
+{
+    if (blackboxConfig()->mirror == BLACKBOX_MIRROR_OFF) {
+        return;
+    }
 
-            switch (baudRateIndex) {
-            case BAUD_1000000:
-            case BAUD_1500000:
-            case BAUD_2000000:
-            case BAUD_2470000:
-                // assume OpenLager in use, so do not constrain writes
-                blackboxMaxHeaderBytesPerIteration = BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION;
-                break;
-            default:
-                blackboxMaxHeaderBytesPerIteration = constrain((targetPidLooptime * 3) / 500, 1, BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION);
-                break;
-            };
-
-            return blackboxPort != NULL;
-        }
+    uint8_t maxHeaderBytesPerIteration;
+    blackboxMirrorPort = blackboxSerialOpen(&blackboxMirrorPortSharing, &maxHeaderBytesPerIteration);
+    if (blackboxMirrorPort) {
+        // The header goes out to both, at the pace of the slower one
+        blackboxMaxHeaderBytesPerIteration = MIN(blackboxMaxHeaderBytesPerIteration, maxHeaderBytesPerIteration);
+    }
+}
+#endif
+
+/**
+ * Attempt to open the logging device. Returns true if successful.
+ */
+bool blackboxDeviceOpen(void)
+{
+    switch (blackboxConfig()->device) {
+    case BLACKBOX_DEVICE_SERIAL:
+        blackboxPort = blackboxSerialOpen(&blackboxPortSharing, &blackboxMaxHeaderBytesPerIteration);
+        return blackboxPort != NULL;
         break;
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
@@ -264,6 +598,9 @@ bool blackboxDeviceOpen(void)
         }
 
         blackboxMaxHeaderBytesPerIteration = BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION;
+#ifdef USE_BLACKBOX_MIRROR
+        blackboxMirrorOpen();
+#endif
 
         return true;
         break;
@@ -275,6 +612,9 @@ bool blackboxDeviceOpen(void)
         }
 
         blackboxMaxHeaderBytesPerIteration = BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION;
+#ifdef USE_BLACKBOX_MIRROR
+        blackboxMirrorOpen();
+#endif
 
         return true;
         break;
@@ -292,7 +632,7 @@ void blackboxEraseAll(void)
 {
     switch (blackboxConfig()->device) {
     case BLACKBOX_DEVICE_FLASH:
-        flashfsEraseCompletely();
+        blackboxEraseFlash();
         break;
     default:
         //not supported
@@ -300,6 +640,21 @@ void blackboxEraseAll(void)
     }
 }
 
+/**
+ * Erase the logs on the flash, incrementally if set by blackbox_erase_mode and the blackbox logs to the flash.
+ * The sectors are then erased later while disarmed, so the erase is done as soon as the log index is.
+ */
+void blackboxEraseFlash(void)
+{
+#ifdef USE_FLASHFS_ERASE_AHEAD
+    if (blackboxConfig()->erase_mode == BLACKBOX_ERASE_INCREMENTAL && blackboxConfig()->device == BLACKBOX_DEVICE_FLASH) {
+        flashfsEraseIncrementally();
+        return;
+    }
+#endif
+    flashfsEraseCompletely();
+}
+
 /**
  * Check to see if erasing is done
  */
@@ -346,6 +701,16 @@ void blackboxDeviceClose(void)
     default:
         ;
     }
+
+#ifdef USE_BLACKBOX_MIRROR
+    if (blackboxMirrorPort) {
+        closeSerialPort(blackboxMirrorPort);
+        blackboxMirrorPort = NULL;
+        if (blackboxMirrorPortSharing == PORTSHARING_SHARED) {
+            mspSerialAllocatePorts();
+        }
+    }
+#endif
 }
 
 #ifdef USE_SDCARD
@@ -471,6 +836,31 @@ static bool blackboxSDCardBeginLog(void)
  *
  * Keep calling until the function returns true (open is complete).
  */
+#ifdef USE_FLASHFS_LOG_INDEX
+static void blackboxFlashBeginLog(void)
+{
+    blackboxFlashLog.start = flashfsGetOffset();
+    blackboxFlashLog.startTime = millis();
+#ifdef USE_RTC_TIME
+    rtcTime_t now;
+    blackboxFlashLog.armTime = rtcGet(&now) ? rtcTimeGetSeconds(&now) : 0;
+#else
+    blackboxFlashLog.armTime = 0;
+#endif
+}
+
+static void blackboxFlashEndLog(void)
+{
+    const flashfsLogIndexEntry_t entry = {
+        .start = blackboxFlashLog.start,
+        .size = flashfsGetOffset() - blackboxFlashLog.start,
+        .armTime = blackboxFlashLog.armTime,
+        .duration = MIN((millis() - blackboxFlashLog.startTime) / 1000, (timeMs_t)UINT16_MAX),
+    };
+    flashfsLogIndexAppend(&entry);
+}
+#endif
+
 bool blackboxDeviceBeginLog(void)
 {
     switch (blackboxConfig()->device) {
@@ -478,6 +868,11 @@ bool blackboxDeviceBeginLog(void)
     case BLACKBOX_DEVICE_SDCARD:
         return blackboxSDCardBeginLog();
 #endif // USE_SDCARD
+#ifdef USE_FLASHFS_LOG_INDEX
+    case BLACKBOX_DEVICE_FLASH:
+        blackboxFlashBeginLog();
+        return true;
+#endif
     default:
         return true;
     }
@@ -493,7 +888,7 @@ bool blackboxDeviceBeginLog(void)
  */
 bool blackboxDeviceEndLog(bool retainLog)
 {
-#ifndef USE_SDCARD
+#if !defined(USE_SDCARD) && !defined(USE_FLASHFS_LOG_INDEX)
     UNUSED(retainLog);
 #endif
 
@@ -512,6 +907,17 @@ bool blackboxDeviceEndLog(bool retainLog)
         }
         return false;
 #endif // USE_SDCARD
+#ifdef USE_FLASHFS_LOG_INDEX
+    case BLACKBOX_DEVICE_FLASH:
+        // Index the log once all of it is on the flash
+        if (!flashfsFlushAsync(true) || !flashfsIsReady()) {
+            return false;
+        }
+        if (retainLog) {
+            blackboxFlashEndLog();
+        }
+        return true;
+#endif
     default:
         return true;
     }
@@ -571,6 +977,23 @@ void blackboxReplenishHeaderBudget(void)
     default:
         freeSpace = 0;
     }
+#ifdef USE_BLACKBOX_TRIGGER
+    if (blackboxTriggerIsBacklogged()) {
+        // The header goes to RAM, so it isn't limited by the rate of the device
+        blackboxHeaderBudget = blackboxTriggerBacklogFree();
+#ifdef USE_BLACKBOX_MIRROR
+        if (blackboxMirrorPort && blackboxConfig()->mirror == BLACKBOX_MIRROR_KEYFRAMES) {
+            blackboxHeaderBudget = MIN(blackboxHeaderBudget, (int32_t)serialTxBytesFree(blackboxMirrorPort));
+        }
+#endif
+        return;
+    }
+#endif
+#ifdef USE_BLACKBOX_MIRROR
+    if (blackboxMirrorPort) {
+        freeSpace = MIN(freeSpace, (int32_t)serialTxBytesFree(blackboxMirrorPort));
+    }
+#endif
     blackboxHeaderBudget = MIN(MIN(freeSpace, blackboxHeaderBudget + blackboxMaxHeaderBytesPerIteration), BLACKBOX_MAX_ACCUMULATED_HEADER_BUDGET);
 }
 
@@ -601,11 +1024,8 @@ blackboxBufferReserveStatus_e blackboxDeviceReserveBufferSpace(int32_t bytes)
     // Handle failure:
     switch (blackboxConfig()->device) {
     case BLACKBOX_DEVICE_SERIAL:
-        /*
-         * One byte of the tx buffer isn't available for user data (due to its circular list implementation),
-         * hence the -1. Note that the USB VCP implementation doesn't use a buffer and has txBufferSize set to zero.
-         */
-        if (blackboxPort->txBufferSize && bytes > (int32_t) blackboxPort->txBufferSize - 1) {
+        // Note that the USB VCP implementation doesn't use a buffer and has no tx ring buffer set up.
+        if (blackboxPort->txRing.buffer && bytes > (int32_t) byteRingSize(&blackboxPort->txRing)) {
             return BLACKBOX_RESERVE_PERMANENT_FAILURE;
         }
         return BLACKBOX_RESERVE_TEMPORARY_FAILURE;
@@ -622,7 +1042,7 @@ blackboxBufferReserveStatus_e blackboxDeviceReserveBufferSpace(int32_t bytes)
              * that the Blackbox header writing code doesn't have to guess about the best time to ask flashfs to
              * flush, and doesn't stall waiting for a flush that would otherwise not automatically be called.
              */
-            flashfsFlushAsync();
+            flashfsFlushAsync(true);
         }
         return BLACKBOX_RESERVE_TEMPORARY_FAILURE;
 #endif // USE_FLASHFS
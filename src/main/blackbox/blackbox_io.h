@@ -43,6 +43,13 @@ extern int32_t blackboxHeaderBudget;
 void blackboxOpen(void);
 void blackboxWrite(uint8_t value);
 int blackboxWriteString(const char *s);
+void blackboxFrameBegin(void);
+void blackboxFrameEnd(void);
+void blackboxDeviceWrite(const uint8_t *data, int length);
+uint32_t blackboxDeviceWriteBufferFree(void);
+uint16_t blackboxDeviceTakeBackPressure(void);
+void blackboxFrameDeltaBegin(void);
+void blackboxFrameDeltaEnd(void);
 
 void blackboxDeviceFlush(void);
 bool blackboxDeviceFlushForce(void);
@@ -50,6 +57,7 @@ bool blackboxDeviceOpen(void);
 void blackboxDeviceClose(void);
 
 void blackboxEraseAll(void);
+void blackboxEraseFlash(void);
 bool isBlackboxErased(void);
 
 bool blackboxDeviceBeginLog(void);
@@ -0,0 +1,360 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Trigger logging: while not triggered, the encoded frames are kept in a RAM ring that covers the last preTriggerMs.
+ * Only an occasional background I frame is written to the device. A trigger writes the ring out, followed by the
+ * frames of the next postTriggerMs, so the device gets the full rate data around each event.
+ *
+ * The ring always starts at an I frame, or continues the stream exactly where the device left it. When neither is the
+ * case a LOGGING_RESUME event tells the decoder about the gap.
+ *
+ * The same ring also holds the backlog at the start of every log: the header is rendered into it as fast as the CPU
+ * allows, and the frames follow right behind it while the device catches up. This works like a trigger at the start
+ * of the log, whether trigger logging is enabled or not.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_BLACKBOX_TRIGGER
+
+#include "blackbox.h"
+#include "blackbox_io.h"
+#include "blackbox_trigger.h"
+
+#include "common/maths.h"
+#include "common/utils.h"
+
+#define BLACKBOX_TRIGGER_KEYFRAME_COUNT 32      // must be a power of 2
+#define BLACKBOX_TRIGGER_DRAIN_CHUNK 512        // most bytes handed to the device per call
+
+typedef struct blackboxTriggerKeyframe_s {
+    uint32_t position;
+    uint32_t iteration;
+    timeUs_t time;
+} blackboxTriggerKeyframe_t;
+
+static uint8_t triggerBuffer[BLACKBOX_TRIGGER_BUFFER_SIZE];
+// Free running positions in the stream, the ring holds the bytes from tail up to head
+static uint32_t triggerHead;
+static uint32_t triggerTail;
+
+// I frames in the ring, oldest first, only tracked while not triggered
+static blackboxTriggerKeyframe_t triggerKeyframes[BLACKBOX_TRIGGER_KEYFRAME_COUNT];
+static uint8_t triggerKeyframeFirst;
+static uint8_t triggerKeyframeCount;
+
+static bool triggerEnabled;
+static bool triggerConfigured;  // trigger logging was asked for, triggerEnabled is also set during the backlog
+static bool backlogged;         // the ring holds the start of the log, which the device has not caught up with yet
+static bool backlogHeader;      // the header is still being written into the backlog
+static bool triggered;
+static timeUs_t triggerEndUs;
+static timeDelta_t preTriggerUs;
+static timeDelta_t postTriggerUs;
+static timeDelta_t backgroundUs;
+static timeUs_t lastBackgroundUs;
+static bool backgroundDue;
+
+// The device holds the stream up to devicePosition, so the ring continues it without a gap from there
+static bool deviceContinuous;
+static uint32_t devicePosition;
+// Set when frames could not be stored, they are then dropped until the next I frame
+static bool resyncNeeded;
+
+// State of the frame being written
+static uint32_t frameStart;
+static bool frameToDevice;
+static bool frameDropped;
+
+void blackboxTriggerInit(bool enabled, uint16_t preTriggerMs, uint16_t postTriggerMs, uint16_t backgroundMs)
+{
+    triggerEnabled = enabled;
+    triggerConfigured = enabled;
+    backlogged = false;
+    backlogHeader = false;
+    preTriggerUs = preTriggerMs * 1000;
+    postTriggerUs = postTriggerMs * 1000;
+    backgroundUs = backgroundMs * 1000;
+
+    triggerHead = 0;
+    triggerTail = 0;
+    triggerKeyframeFirst = 0;
+    triggerKeyframeCount = 0;
+    triggered = false;
+    backgroundDue = true;
+    // Nothing but the headers has been written, which the first I frame continues
+    deviceContinuous = true;
+    devicePosition = 0;
+    resyncNeeded = false;
+    frameToDevice = false;
+    frameDropped = false;
+}
+
+bool blackboxTriggerIsEnabled(void)
+{
+    return triggerEnabled;
+}
+
+bool blackboxTriggerIsTriggered(void)
+{
+    return triggered;
+}
+
+static void dropOldestKeyframe(void)
+{
+    triggerKeyframeFirst = (triggerKeyframeFirst + 1) & (BLACKBOX_TRIGGER_KEYFRAME_COUNT - 1);
+    triggerKeyframeCount--;
+    triggerTail = triggerKeyframeCount ? triggerKeyframes[triggerKeyframeFirst].position : frameStart;
+
+    if (deviceContinuous && (int32_t)(triggerTail - devicePosition) > 0) {
+        // What the device is missing has been discarded
+        deviceContinuous = false;
+    }
+}
+
+static void writeLoggingResume(uint32_t iteration, timeUs_t time)
+{
+    // The FLIGHT_LOG_EVENT_LOGGING_RESUME event, straight to the device ahead of the ring
+    uint8_t event[2 + 2 * 5];
+    int length = 0;
+
+    event[length++] = 'E';
+    event[length++] = FLIGHT_LOG_EVENT_LOGGING_RESUME;
+    const uint32_t values[] = { iteration, time };
+    for (unsigned i = 0; i < ARRAYLEN(values); i++) {
+        uint32_t value = values[i];
+        while (value > 127) {
+            event[length++] = (uint8_t)(value | 0x80);
+            value >>= 7;
+        }
+        event[length++] = value;
+    }
+
+    blackboxDeviceWrite(event, length);
+}
+
+/**
+ * Start writing the ring to the device, or extend the post trigger window if already triggered.
+ */
+void blackboxTriggerFire(timeUs_t currentTimeUs)
+{
+    triggerEndUs = currentTimeUs + postTriggerUs;
+    if (triggered) {
+        return;
+    }
+    triggered = true;
+
+    if (deviceContinuous) {
+        // Skip what the device already has
+        triggerTail = devicePosition;
+    } else if (triggerKeyframeCount) {
+        writeLoggingResume(triggerKeyframes[triggerKeyframeFirst].iteration, triggerKeyframes[triggerKeyframeFirst].time);
+    } else {
+        triggerTail = triggerHead;
+        resyncNeeded = true;
+    }
+    triggerKeyframeCount = 0;
+}
+
+/**
+ * Hand buffered data to the device while triggered. Returns true if data is still waiting to be written.
+ */
+bool blackboxTriggerDrain(timeUs_t currentTimeUs)
+{
+    if (!triggered) {
+        return false;
+    }
+
+    uint32_t space = MIN(blackboxDeviceWriteBufferFree(), (uint32_t)BLACKBOX_TRIGGER_DRAIN_CHUNK);
+    while (triggerHead != triggerTail && space) {
+        const uint32_t index = triggerTail & (BLACKBOX_TRIGGER_BUFFER_SIZE - 1);
+        const uint32_t length = MIN(MIN(triggerHead - triggerTail, BLACKBOX_TRIGGER_BUFFER_SIZE - index), space);
+        blackboxDeviceWrite(&triggerBuffer[index], length);
+        triggerTail += length;
+        space -= length;
+    }
+
+    if (triggerHead != triggerTail) {
+        return true;
+    }
+
+    if (backlogged) {
+        if (backlogHeader) {
+            return false;
+        }
+        // The device has caught up with the start of the log
+        backlogged = false;
+        triggerEnabled = triggerConfigured;
+        if (!triggerEnabled) {
+            triggered = false;
+            return false;
+        }
+    }
+
+    if (cmpTimeUs(currentTimeUs, triggerEndUs) >= 0) {
+        // The post trigger window is over, go back to buffering
+        triggered = false;
+        deviceContinuous = !resyncNeeded;
+        devicePosition = triggerHead;
+        resyncNeeded = false;
+    }
+    return false;
+}
+
+void blackboxTriggerFrameStart(void)
+{
+    frameStart = triggerHead;
+    frameToDevice = false;
+    // Frames without an I frame to predict from are useless
+    frameDropped = resyncNeeded || (!triggered && triggerKeyframeCount == 0 && !deviceContinuous);
+}
+
+/**
+ * Called at the start of an I frame. Returns true if a LOGGING_RESUME event must precede it.
+ */
+bool blackboxTriggerMarkKeyframe(uint32_t iteration, timeUs_t currentTimeUs)
+{
+    frameDropped = false;
+
+    if (triggered) {
+        const bool resume = resyncNeeded;
+        resyncNeeded = false;
+        return resume;
+    }
+
+    if (triggerKeyframeCount == BLACKBOX_TRIGGER_KEYFRAME_COUNT) {
+        dropOldestKeyframe();
+    }
+    blackboxTriggerKeyframe_t *keyframe = &triggerKeyframes[(triggerKeyframeFirst + triggerKeyframeCount) & (BLACKBOX_TRIGGER_KEYFRAME_COUNT - 1)];
+    keyframe->position = frameStart;
+    keyframe->iteration = iteration;
+    keyframe->time = currentTimeUs;
+    triggerKeyframeCount++;
+
+    // Keep the newest I frame from before the pre trigger window, so that the whole window can be decoded
+    while (triggerKeyframeCount > 1
+        && cmpTimeUs(currentTimeUs, triggerKeyframes[(triggerKeyframeFirst + 1) & (BLACKBOX_TRIGGER_KEYFRAME_COUNT - 1)].time) >= preTriggerUs) {
+        dropOldestKeyframe();
+    }
+
+    bool resume = false;
+    if (backgroundUs && (backgroundDue || cmpTimeUs(currentTimeUs, lastBackgroundUs) >= backgroundUs)) {
+        frameToDevice = true;
+        backgroundDue = false;
+        lastBackgroundUs = currentTimeUs;
+        resume = !deviceContinuous;
+    }
+    return resume;
+}
+
+void blackboxTriggerWrite(const uint8_t *data, int length)
+{
+    if (frameToDevice) {
+        blackboxDeviceWrite(data, length);
+    }
+    if (frameDropped) {
+        return;
+    }
+
+    while (BLACKBOX_TRIGGER_BUFFER_SIZE - (triggerHead - triggerTail) < (uint32_t)length) {
+        if (!triggered && triggerKeyframeCount > 1) {
+            dropOldestKeyframe();
+        } else {
+            // No room, so discard this frame and resynchronise on the next I frame
+            triggerHead = frameStart;
+            if (triggered) {
+                resyncNeeded = true;
+            } else {
+                triggerTail = frameStart;
+                triggerKeyframeCount = 0;
+                deviceContinuous = false;
+            }
+            frameDropped = true;
+            return;
+        }
+    }
+
+    const uint32_t index = triggerHead & (BLACKBOX_TRIGGER_BUFFER_SIZE - 1);
+    const uint32_t contiguous = MIN((uint32_t)length, BLACKBOX_TRIGGER_BUFFER_SIZE - index);
+    memcpy(&triggerBuffer[index], data, contiguous);
+    memcpy(triggerBuffer, data + contiguous, length - contiguous);
+    triggerHead += length;
+}
+
+void blackboxTriggerFrameEnd(void)
+{
+    if (frameToDevice) {
+        // The ring continues the stream from the end of this background frame
+        deviceContinuous = true;
+        devicePosition = triggerHead;
+        frameToDevice = false;
+    }
+}
+
+/**
+ * Collect the header and the first frames of a log in the ring, so that logging starts without waiting for the device.
+ */
+void blackboxTriggerBacklogStart(timeUs_t currentTimeUs)
+{
+    backlogged = true;
+    backlogHeader = true;
+    triggerEnabled = true;
+    triggered = true;
+    // Only a trigger that happens meanwhile keeps the device getting every frame once the backlog is written
+    triggerEndUs = currentTimeUs;
+}
+
+bool blackboxTriggerIsBacklogged(void)
+{
+    return backlogHeader;
+}
+
+// How many header bytes the backlog can still take
+uint32_t blackboxTriggerBacklogFree(void)
+{
+    return BLACKBOX_TRIGGER_BUFFER_SIZE - (triggerHead - triggerTail);
+}
+
+/**
+ * Add header bytes to the backlog. The caller keeps within blackboxTriggerBacklogFree(), the header must never be
+ * dropped.
+ */
+void blackboxTriggerBacklogWrite(const uint8_t *data, int length)
+{
+    length = MIN((uint32_t)length, blackboxTriggerBacklogFree());
+
+    const uint32_t index = triggerHead & (BLACKBOX_TRIGGER_BUFFER_SIZE - 1);
+    const uint32_t contiguous = MIN((uint32_t)length, BLACKBOX_TRIGGER_BUFFER_SIZE - index);
+    memcpy(&triggerBuffer[index], data, contiguous);
+    memcpy(triggerBuffer, data + contiguous, length - contiguous);
+    triggerHead += length;
+}
+
+// The header is complete, the frames that follow are logged into the backlog until the device has caught up
+void blackboxTriggerBacklogHeaderEnd(void)
+{
+    backlogHeader = false;
+}
+#endif // USE_BLACKBOX_TRIGGER
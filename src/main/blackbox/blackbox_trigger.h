@@ -0,0 +1,47 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+#ifndef BLACKBOX_TRIGGER_BUFFER_SIZE
+#define BLACKBOX_TRIGGER_BUFFER_SIZE 8192   // must be a power of 2
+#endif
+
+void blackboxTriggerInit(bool enabled, uint16_t preTriggerMs, uint16_t postTriggerMs, uint16_t backgroundMs);
+bool blackboxTriggerIsEnabled(void);
+bool blackboxTriggerIsTriggered(void);
+void blackboxTriggerFire(timeUs_t currentTimeUs);
+bool blackboxTriggerDrain(timeUs_t currentTimeUs);
+
+void blackboxTriggerFrameStart(void);
+bool blackboxTriggerMarkKeyframe(uint32_t iteration, timeUs_t currentTimeUs);
+void blackboxTriggerWrite(const uint8_t *data, int length);
+void blackboxTriggerFrameEnd(void);
+
+void blackboxTriggerBacklogStart(timeUs_t currentTimeUs);
+bool blackboxTriggerIsBacklogged(void);
+uint32_t blackboxTriggerBacklogFree(void);
+void blackboxTriggerBacklogWrite(const uint8_t *data, int length);
+void blackboxTriggerBacklogHeaderEnd(void);
@@ -75,4 +75,5 @@ const char * const debugModeNames[DEBUG_COUNT] = {
     "RX_SIGNAL_LOSS",
     "RC_SMOOTHING_RATE",
     "ANTI_GRAVITY",
+    "DYN_LPF",
 };
@@ -24,7 +24,24 @@
 extern int16_t debug[DEBUG16_VALUE_COUNT];
 extern uint8_t debugMode;
 
+#ifdef USE_DEBUG_CAPTURE
+#define DEBUG_CAPTURE_MODE_COUNT 4
+
+// Per debug mode, the bank of debugCaptureSlots it is captured into, 0 when it is not captured
+extern uint8_t debugCaptureBank[];
+extern int16_t debugCaptureSlots[DEBUG_CAPTURE_MODE_COUNT + 1][DEBUG16_VALUE_COUNT];
+
+#define DEBUG_SET(mode, index, value) { \
+    const uint8_t debugSetBank_ = debugCaptureBank[(mode)]; \
+    if (debugMode == (mode) || debugSetBank_) { \
+        const int16_t debugSetValue_ = (value); \
+        if (debugMode == (mode)) {debug[(index)] = debugSetValue_;} \
+        debugCaptureSlots[debugSetBank_][(index)] = debugSetValue_; \
+    } \
+}
+#else
 #define DEBUG_SET(mode, index, value) {if (debugMode == (mode)) {debug[(index)] = (value);}}
+#endif
 
 #define DEBUG_SECTION_TIMES
 
@@ -93,6 +110,7 @@ typedef enum {
     DEBUG_RX_SIGNAL_LOSS,
     DEBUG_RC_SMOOTHING_RATE,
     DEBUG_ANTI_GRAVITY,
+    DEBUG_DYN_LPF,
     DEBUG_COUNT
 } debugType_e;
 
@@ -0,0 +1,159 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Capture of the debug values of several debug modes at once, every gyro loop, into a RAM ring.
+ *
+ * Each captured mode gets a bank of DEBUG16_VALUE_COUNT slots that DEBUG_SET writes besides debug[], independent of
+ * debug_mode. The banks are copied into the ring at the end of every gyro loop, which then holds the most recent
+ * samples until the capture is stopped, and the samples are read out once it has stopped.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_DEBUG_CAPTURE
+
+#include "build/debug.h"
+
+#include "debug_capture.h"
+
+#define DEBUG_CAPTURE_BARRIER() asm volatile ("": : :"memory") // compiler memory barrier
+
+FAST_RAM_ZERO_INIT uint8_t debugCaptureBank[DEBUG_COUNT];
+FAST_RAM_ZERO_INIT int16_t debugCaptureSlots[DEBUG_CAPTURE_MODE_COUNT + 1][DEBUG16_VALUE_COUNT];
+
+static int16_t captureBuffer[DEBUG_CAPTURE_BUFFER_VALUES];
+static volatile uint8_t captureState;
+static uint8_t captureModes[DEBUG_CAPTURE_MODE_COUNT];
+static uint8_t captureModeCount;
+static uint16_t captureSampleValues;
+static uint16_t captureCapacity;        // in samples
+static uint16_t captureIndex;           // where the next sample goes
+static uint32_t captureTaken;
+static uint32_t captureLimit;           // samples to take before stopping, 0 to run until stopped
+
+// Starts capturing the given modes every gyro loop, for sampleCount loops or until stopped when 0
+bool debugCaptureStart(const uint8_t *modes, int modeCount, uint32_t sampleCount)
+{
+    if (modeCount < 1 || modeCount > DEBUG_CAPTURE_MODE_COUNT) {
+        return false;
+    }
+    for (int i = 0; i < modeCount; i++) {
+        if (modes[i] == DEBUG_NONE || modes[i] >= DEBUG_COUNT || memchr(modes, modes[i], i)) {
+            return false;
+        }
+    }
+
+    captureState = DEBUG_CAPTURE_IDLE;
+    DEBUG_CAPTURE_BARRIER();
+
+    memset(debugCaptureBank, 0, sizeof(debugCaptureBank));
+    memset(debugCaptureSlots, 0, sizeof(debugCaptureSlots));
+    for (int i = 0; i < modeCount; i++) {
+        captureModes[i] = modes[i];
+        debugCaptureBank[modes[i]] = i + 1;
+    }
+    captureModeCount = modeCount;
+    captureSampleValues = modeCount * DEBUG16_VALUE_COUNT;
+    captureCapacity = DEBUG_CAPTURE_BUFFER_VALUES / captureSampleValues;
+    captureIndex = 0;
+    captureTaken = 0;
+    captureLimit = sampleCount;
+
+    DEBUG_CAPTURE_BARRIER();
+    captureState = DEBUG_CAPTURE_RUNNING;
+
+    return true;
+}
+
+void debugCaptureStop(void)
+{
+    if (captureState == DEBUG_CAPTURE_RUNNING) {
+        captureState = DEBUG_CAPTURE_STOPPED;
+        memset(debugCaptureBank, 0, sizeof(debugCaptureBank));
+    }
+}
+
+// Called at the end of each gyro loop
+FAST_CODE void debugCaptureSample(void)
+{
+    if (captureState != DEBUG_CAPTURE_RUNNING) {
+        return;
+    }
+
+    memcpy(&captureBuffer[captureIndex * captureSampleValues], debugCaptureSlots[1], captureSampleValues * sizeof(int16_t));
+    if (++captureIndex == captureCapacity) {
+        captureIndex = 0;
+    }
+
+    if (++captureTaken == captureLimit) {
+        debugCaptureStop();
+    }
+}
+
+debugCaptureState_e debugCaptureGetState(void)
+{
+    return captureState;
+}
+
+int debugCaptureModeCount(void)
+{
+    return captureState == DEBUG_CAPTURE_IDLE ? 0 : captureModeCount;
+}
+
+uint8_t debugCaptureMode(int index)
+{
+    return captureModes[index];
+}
+
+uint16_t debugCaptureCapacity(void)
+{
+    return captureState == DEBUG_CAPTURE_IDLE ? 0 : captureCapacity;
+}
+
+uint32_t debugCaptureSamplesTaken(void)
+{
+    return captureState == DEBUG_CAPTURE_IDLE ? 0 : captureTaken;
+}
+
+uint16_t debugCaptureSamplesHeld(void)
+{
+    if (captureState == DEBUG_CAPTURE_IDLE) {
+        return 0;
+    }
+    return captureTaken < captureCapacity ? captureTaken : captureCapacity;
+}
+
+// The values of the index-th held sample, oldest first, DEBUG16_VALUE_COUNT per captured mode. Only once stopped.
+const int16_t *debugCaptureGetSample(uint16_t index)
+{
+    if (captureState != DEBUG_CAPTURE_STOPPED || index >= debugCaptureSamplesHeld()) {
+        return NULL;
+    }
+
+    const uint16_t oldest = captureTaken < captureCapacity ? 0 : captureIndex;
+    return &captureBuffer[((oldest + index) % captureCapacity) * captureSampleValues];
+}
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "build/debug.h"
+
+#ifndef DEBUG_CAPTURE_BUFFER_VALUES
+#define DEBUG_CAPTURE_BUFFER_VALUES 4096    // int16 values, 256 gyro loops with 4 modes captured, 1024 with 1
+#endif
+
+typedef enum {
+    DEBUG_CAPTURE_IDLE = 0,
+    DEBUG_CAPTURE_RUNNING,
+    DEBUG_CAPTURE_STOPPED,
+} debugCaptureState_e;
+
+bool debugCaptureStart(const uint8_t *modes, int modeCount, uint32_t sampleCount);
+void debugCaptureStop(void);
+void debugCaptureSample(void);
+
+debugCaptureState_e debugCaptureGetState(void);
+int debugCaptureModeCount(void);
+uint8_t debugCaptureMode(int index);
+uint16_t debugCaptureCapacity(void);
+uint32_t debugCaptureSamplesTaken(void);
+uint16_t debugCaptureSamplesHeld(void);
+const int16_t *debugCaptureGetSample(uint16_t index);
@@ -0,0 +1,77 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_PROFILE
+
+#include "common/maths.h"
+
+#include "profile.h"
+
+FAST_RAM_ZERO_INIT profileProbe_t profileProbes[PROFILE_COUNT];
+
+const char * const profileNames[PROFILE_COUNT] = {
+    "GYRO_READ",
+    "GYRO_RPM_FILTER",
+    "GYRO_STATIC_FILTERS",
+    "GYRO_DYN_NOTCH",
+    "GYRO_ANALYSE",
+    "PID",
+    "MIXER",
+    "DSHOT_ENCODE",
+    "RX_DECODE",
+    "BLACKBOX_ENCODE",
+};
+
+// The DWT cycle counter is started by cycleCounterInit(), it is the timebase of micros()
+void profileInit(void)
+{
+    profileReset();
+}
+
+void profileReset(void)
+{
+    memset(profileProbes, 0, sizeof(profileProbes));
+    for (int i = 0; i < PROFILE_COUNT; i++) {
+        profileProbes[i].minCycles = UINT32_MAX;
+    }
+}
+
+FAST_CODE void profileRecord(profileId_e id, uint32_t cycles)
+{
+    profileProbe_t *probe = &profileProbes[id];
+    probe->count++;
+    probe->totalCycles += cycles;
+    probe->minCycles = MIN(probe->minCycles, cycles);
+    probe->maxCycles = MAX(probe->maxCycles, cycles);
+    const int bucket = cycles < 2 ? 0 : MIN(31 - __builtin_clz(cycles), PROFILE_HISTOGRAM_BUCKET_COUNT - 1);
+    probe->histogram[bucket]++;
+}
+
+uint32_t profileCyclesToNs(uint32_t cycles)
+{
+    return (uint64_t)cycles * 1000 / (SystemCoreClock / 1000000);
+}
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Code sections timed with the DWT cycle counter, see PROFILE_BEGIN and PROFILE_END
+typedef enum {
+    PROFILE_GYRO_READ = 0,
+    PROFILE_GYRO_RPM_FILTER,
+    PROFILE_GYRO_STATIC_FILTERS,
+    PROFILE_GYRO_DYN_NOTCH,
+    PROFILE_GYRO_ANALYSE,
+    PROFILE_PID,
+    PROFILE_MIXER,
+    PROFILE_DSHOT_ENCODE,
+    PROFILE_RX_DECODE,
+    PROFILE_BLACKBOX_ENCODE,
+    PROFILE_COUNT
+} profileId_e;
+
+#define PROFILE_HISTOGRAM_BUCKET_COUNT 16
+
+typedef struct profileProbe_s {
+    uint32_t startCycles;
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+    uint32_t histogram[PROFILE_HISTOGRAM_BUCKET_COUNT];   // log2 histogram, bucket n counts 2^n to 2^(n+1)-1 cycles
+} profileProbe_t;
+
+#ifdef USE_PROFILE
+extern profileProbe_t profileProbes[PROFILE_COUNT];
+extern const char * const profileNames[PROFILE_COUNT];
+
+void profileInit(void);
+void profileReset(void);
+void profileRecord(profileId_e id, uint32_t cycles);
+uint32_t profileCyclesToNs(uint32_t cycles);
+
+#define PROFILE_BEGIN(id) { profileProbes[(id)].startCycles = DWT->CYCCNT; }
+#define PROFILE_END(id) { profileRecord((id), DWT->CYCCNT - profileProbes[(id)].startCycles); }
+#else
+#define PROFILE_BEGIN(id) {}
+#define PROFILE_END(id) {}
+#endif
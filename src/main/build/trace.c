@@ -0,0 +1,125 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Event trace of the task switches, interrupts and DMA transfers, with the DWT cycle counter as timestamp.
+ *
+ * While a debugger has enabled ITM stimulus port 0 the events stream out through the SWO pin. Otherwise they are
+ * recorded into a RAM ring between traceStart() and traceStop(), which keeps the latest TRACE_BUFFER_EVENTS and is
+ * read out over MSP once stopped. src/utils/trace_to_json.pl turns either into a Chrome trace / Perfetto timeline.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_TRACE
+
+#include "build/atomic.h"
+
+#include "drivers/nvic.h"
+
+#include "trace.h"
+
+#define TRACE_ITM_PORT 0
+
+static traceEvent_t traceBuffer[TRACE_BUFFER_EVENTS];
+static volatile uint8_t traceState;
+static volatile uint32_t traceHead;         // free running
+
+static bool traceItmEnabled(void)
+{
+    return (ITM->TCR & ITM_TCR_ITMENA_Msk) && (ITM->TER & (1 << TRACE_ITM_PORT));
+}
+
+static void traceItmWrite(uint32_t value)
+{
+    while (ITM->PORT[TRACE_ITM_PORT].u32 == 0) {
+        // the stimulus port FIFO is full
+    }
+    ITM->PORT[TRACE_ITM_PORT].u32 = value;
+}
+
+FAST_CODE void traceRecord(traceEventType_e type, uint8_t id, uint16_t arg)
+{
+    const uint32_t event = type | id << 8 | arg << 16;
+
+    if (traceItmEnabled()) {
+        // both words of an event go out together, and the timestamps in order
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            traceItmWrite(DWT->CYCCNT);
+            traceItmWrite(event);
+        }
+        return;
+    }
+
+    if (traceState != TRACE_RUNNING) {
+        return;
+    }
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        traceEvent_t *slot = &traceBuffer[traceHead & (TRACE_BUFFER_EVENTS - 1)];
+        slot->cycles = DWT->CYCCNT;
+        slot->event = event;
+        traceHead++;
+    }
+}
+
+void traceStart(void)
+{
+    traceState = TRACE_IDLE;
+    traceHead = 0;
+    traceState = TRACE_RUNNING;
+}
+
+void traceStop(void)
+{
+    if (traceState == TRACE_RUNNING) {
+        traceState = TRACE_STOPPED;
+    }
+}
+
+traceState_e traceGetState(void)
+{
+    return traceState;
+}
+
+uint32_t traceEventsRecorded(void)
+{
+    return traceHead;
+}
+
+uint16_t traceEventsHeld(void)
+{
+    return traceHead < TRACE_BUFFER_EVENTS ? traceHead : TRACE_BUFFER_EVENTS;
+}
+
+// The index-th held event, oldest first. Only once stopped.
+const traceEvent_t *traceGetEvent(uint16_t index)
+{
+    if (traceState != TRACE_STOPPED || index >= traceEventsHeld()) {
+        return NULL;
+    }
+
+    const uint32_t oldest = traceHead - traceEventsHeld();
+    return &traceBuffer[(oldest + index) & (TRACE_BUFFER_EVENTS - 1)];
+}
+
+#endif
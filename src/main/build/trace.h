@@ -0,0 +1,72 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef TRACE_BUFFER_EVENTS
+#define TRACE_BUFFER_EVENTS 1024    // must be a power of 2
+#endif
+
+typedef enum {
+    TRACE_TASK_START = 0,       // id is the cfTaskId_e
+    TRACE_TASK_END,
+    TRACE_ISR_ENTER,            // id is the traceIsr_e, arg the instance
+    TRACE_ISR_EXIT,
+    TRACE_DMA_START,            // id is the traceIsr_e of the transfer complete interrupt, arg the instance
+    TRACE_DMA_COMPLETE,
+    TRACE_EVENT_TYPE_COUNT
+} traceEventType_e;
+
+typedef enum {
+    TRACE_ISR_GYRO_EXTI = 0,
+    TRACE_ISR_MOTOR_DMA,
+    TRACE_ISR_UART,
+    TRACE_ISR_COUNT
+} traceIsr_e;
+
+// As stored in the RAM ring and sent over MSP, and as two words on ITM stimulus port 0
+typedef struct traceEvent_s {
+    uint32_t cycles;            // DWT cycle counter
+    uint32_t event;             // type | id << 8 | arg << 16
+} traceEvent_t;
+
+typedef enum {
+    TRACE_IDLE = 0,
+    TRACE_RUNNING,
+    TRACE_STOPPED,
+} traceState_e;
+
+#ifdef USE_TRACE
+void traceRecord(traceEventType_e type, uint8_t id, uint16_t arg);
+
+void traceStart(void);
+void traceStop(void);
+traceState_e traceGetState(void);
+uint32_t traceEventsRecorded(void);
+uint16_t traceEventsHeld(void);
+const traceEvent_t *traceGetEvent(uint16_t index);
+
+#define TRACE_EVENT(type, id, arg) { traceRecord((type), (id), (arg)); }
+#else
+#define TRACE_EVENT(type, id, arg) {}
+#endif
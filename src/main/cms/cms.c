@@ -209,6 +209,75 @@ static CMS_Menu menuErr = {
 #define cmsPageDebug()
 #endif
 
+// Raw values of the dynamic entries on the page when they were last polled, so only the values that changed are drawn again
+#define CMS_POLLED_VALUE_COUNT 16
+static int32_t cmsPolledValue[CMS_POLLED_VALUE_COUNT];
+static uint16_t cmsPolledValueValid;   // bit per row of the page
+
+static bool cmsGetEntryValue(const OSD_Entry *p, int32_t *value)
+{
+    if (!p->data) {
+        return false;
+    }
+
+    switch (p->type) {
+    case OME_Bool:
+        *value = *(uint8_t *)p->data;
+        return true;
+
+#ifdef USE_OSD
+    case OME_VISIBLE:
+        *value = *(uint16_t *)p->data;
+        return true;
+#endif
+
+    case OME_UINT8:
+        *value = *((OSD_UINT8_t *)p->data)->val;
+        return true;
+
+    case OME_INT8:
+        *value = *((OSD_INT8_t *)p->data)->val;
+        return true;
+
+    case OME_UINT16:
+        *value = *((OSD_UINT16_t *)p->data)->val;
+        return true;
+
+    case OME_INT16:
+        *value = *((OSD_INT16_t *)p->data)->val;
+        return true;
+
+    case OME_FLOAT:
+        *value = *((OSD_FLOAT_t *)p->data)->val;
+        return true;
+
+    case OME_TAB:
+        *value = *((OSD_TAB_t *)p->data)->val;
+        return true;
+
+    default:
+        // strings can change in place, so they are drawn again on every poll
+        return false;
+    }
+}
+
+static bool cmsPolledValueChanged(const OSD_Entry *p, uint8_t row)
+{
+    int32_t value;
+    if (row >= CMS_POLLED_VALUE_COUNT || !cmsGetEntryValue(p, &value)) {
+        return true;
+    }
+
+    if ((cmsPolledValueValid & (1 << row)) && cmsPolledValue[row] == value) {
+        return false;
+    }
+
+    cmsPolledValue[row] = value;
+    cmsPolledValueValid |= 1 << row;
+
+    return true;
+}
+
 static void cmsUpdateMaxRow(displayPort_t *instance)
 {
     UNUSED(instance);
@@ -526,9 +595,10 @@ static void cmsDrawMenu(displayPort_t *pDisplay, uint32_t currentTimeUs)
             SET_PRINTVALUE(p);
         }
         pDisplay->cleared = false;
+        cmsPolledValueValid = 0;
     } else if (drawPolled) {
-        for (p = pageTop ; p <= pageTop + pageMaxRow ; p++) {
-            if (IS_DYNAMIC(p))
+        for (p = pageTop, i = 0; p <= pageTop + pageMaxRow; p++, i++) {
+            if (IS_DYNAMIC(p) && cmsPolledValueChanged(p, i))
                 SET_PRINTVALUE(p);
         }
     }
@@ -1098,6 +1168,8 @@ void cmsUpdate(uint32_t currentTimeUs)
         }
 
         cmsDrawMenu(pCurrentDisplay, currentTimeUs);
+        // displays with a framebuffer only send the changes here
+        displayDrawScreen(pCurrentDisplay);
 
         if (currentTimeMs > lastCmsHeartBeatMs + 500) {
             // Heart beat for external CMS display device @ 500msec
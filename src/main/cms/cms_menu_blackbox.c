@@ -158,7 +158,7 @@ static long cmsx_EraseFlash(displayPort_t *pDisplay, const void *ptr)
     displayWrite(pDisplay, 5, 3, "ERASING FLASH...");
     displayResync(pDisplay); // Was max7456RefreshAll(); Why at this timing?
 
-    flashfsEraseCompletely();
+    blackboxEraseFlash();
     while (!flashfsIsReady()) {
         delay(100);
     }
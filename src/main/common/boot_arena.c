@@ -0,0 +1,111 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Memory for the large buffers of the subsystems that only some configurations run.
+ *
+ * The buffers are handed out while booting, by the init of a subsystem the loaded config enables, and are never
+ * freed. A subsystem that is not enabled takes nothing, so a target short of RAM can set a BOOT_ARENA_SIZE for the
+ * subsystems it expects to run together instead of reserving every buffer it has compiled in.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/utils.h"
+
+#include "drivers/max7456.h"
+
+#include "io/asyncfatfs/asyncfatfs.h"
+
+#include "boot_arena.h"
+
+#ifndef BOOT_ARENA_SIZE
+#ifdef USE_SDCARD
+#define BOOT_ARENA_SDCARD_SIZE  BOOT_ARENA_ALIGN(AFATFS_CACHE_SIZE)
+#else
+#define BOOT_ARENA_SDCARD_SIZE  0
+#endif
+#ifdef USE_MAX7456
+#define BOOT_ARENA_MAX7456_SIZE BOOT_ARENA_ALIGN(MAX7456_SCREEN_BUFFER_SIZE + MAX7456_SHADOW_BUFFER_SIZE)
+#else
+#define BOOT_ARENA_MAX7456_SIZE 0
+#endif
+#define BOOT_ARENA_SIZE         (BOOT_ARENA_SDCARD_SIZE + BOOT_ARENA_MAX7456_SIZE)
+#endif
+
+static size_t bootArenaUsedSize;
+
+static bootArenaAllocation_t bootArenaAllocations[BOOT_ARENA_MAX_ALLOCATIONS];
+static int bootArenaAllocationsCount;
+
+#if BOOT_ARENA_SIZE > 0
+// Not DMA_RAM, the F3 and F4 CCM is not reachable by DMA
+static uint8_t bootArena[BOOT_ARENA_SIZE] DMA_ALIGNED;
+
+// Returns zeroed memory aligned to BOOT_ARENA_ALIGNMENT, or NULL if the arena is full
+void *bootArenaAllocate(size_t size, const char *owner)
+{
+    const size_t alignedSize = BOOT_ARENA_ALIGN(size);
+    if (alignedSize > BOOT_ARENA_SIZE - bootArenaUsedSize || bootArenaAllocationsCount >= BOOT_ARENA_MAX_ALLOCATIONS) {
+        return NULL;
+    }
+
+    void *memory = &bootArena[bootArenaUsedSize];
+    bootArenaUsedSize += alignedSize;
+
+    bootArenaAllocations[bootArenaAllocationsCount].owner = owner;
+    bootArenaAllocations[bootArenaAllocationsCount].size = alignedSize;
+    bootArenaAllocationsCount++;
+
+    return memory;
+}
+#else
+// Nothing compiled in takes from the arena, so there is none
+void *bootArenaAllocate(size_t size, const char *owner)
+{
+    UNUSED(size);
+    UNUSED(owner);
+
+    return NULL;
+}
+#endif
+
+size_t bootArenaSize(void)
+{
+    return BOOT_ARENA_SIZE;
+}
+
+size_t bootArenaUsed(void)
+{
+    return bootArenaUsedSize;
+}
+
+int bootArenaAllocationCount(void)
+{
+    return bootArenaAllocationsCount;
+}
+
+const bootArenaAllocation_t *bootArenaGetAllocation(int index)
+{
+    return &bootArenaAllocations[index];
+}
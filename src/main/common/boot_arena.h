@@ -0,0 +1,40 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BOOT_ARENA_ALIGNMENT        32      // whole data cache lines, so DMA buffers can be allocated too
+#define BOOT_ARENA_ALIGN(size)      (((size) + BOOT_ARENA_ALIGNMENT - 1) & ~(BOOT_ARENA_ALIGNMENT - 1))
+#define BOOT_ARENA_MAX_ALLOCATIONS  8
+
+typedef struct bootArenaAllocation_s {
+    const char *owner;
+    uint16_t size;
+} bootArenaAllocation_t;
+
+void *bootArenaAllocate(size_t size, const char *owner);
+
+size_t bootArenaSize(void);
+size_t bootArenaUsed(void);
+int bootArenaAllocationCount(void);
+const bootArenaAllocation_t *bootArenaGetAllocation(int index);
@@ -108,8 +108,8 @@ void biquadFilterInit(biquadFilter_t *filter, float filterFreq, uint32_t refresh
 {
     // setup variables
     const float omega = 2.0f * M_PI_FLOAT * filterFreq * refreshRate * 0.000001f;
-    const float sn = sin_approx(omega);
-    const float cs = cos_approx(omega);
+    float sn, cs;
+    sincos_approx(omega, &sn, &cs);
     const float alpha = sn / (2.0f * Q);
 
     float b0 = 0, b1 = 0, b2 = 0, a0 = 0, a1 = 0, a2 = 0;
@@ -225,3 +225,284 @@ FAST_CODE float laggedMovingAverageUpdate(laggedMovingAverage_t *filter, float i
     const uint16_t denom = filter->primed ? filter->windowSize : filter->movingWindowIndex;
     return filter->movingSum  / denom;
 }
+
+// Filter banks
+
+void pt1FilterBank3Init(pt1FilterBank3_t *filter, float k)
+{
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        filter->state[i] = 0.0f;
+    }
+    filter->k = k;
+}
+
+FAST_CODE void pt1FilterBank3Apply(pt1FilterBank3_t *filter, float *values)
+{
+    const float k = filter->k;
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        filter->state[i] = filter->state[i] + k * (values[i] - filter->state[i]);
+        values[i] = filter->state[i];
+    }
+}
+
+void pt1GainTableInit(pt1GainTable_t *table, float minHz, float maxHz, float dT)
+{
+    const float hzPerIndex = MAX(maxHz - minHz, 1.0f) / (FILTER_LOWPASS_TABLE_SIZE - 1);
+
+    table->minHz = minHz;
+    table->indexPerHz = 1.0f / hzPerIndex;
+    for (int i = 0; i < FILTER_LOWPASS_TABLE_SIZE; i++) {
+        const float RC = 1 / (2 * M_PI_FLOAT * (minHz + i * hzPerIndex));
+        table->k[i] = dT / (RC + dT);
+    }
+}
+
+// The PT1 gain for a cutoff between the minimum and maximum of the table, without the division of pt1FilterGain
+FAST_CODE float pt1GainFromTable(const pt1GainTable_t *table, float cutoffHz)
+{
+    const float position = constrainf((cutoffHz - table->minHz) * table->indexPerHz, 0.0f, FILTER_LOWPASS_TABLE_SIZE - 1);
+    const int i = MIN((int)position, FILTER_LOWPASS_TABLE_SIZE - 2);
+    const float fraction = position - i;
+
+    return table->k[i] + fraction * (table->k[i + 1] - table->k[i]);
+}
+
+static void biquadFilterBank3SetCoefficients(biquadFilterBank3_t *filter, int index, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType)
+{
+    biquadFilter_t coefficients;
+    biquadFilterInit(&coefficients, filterFreq, refreshRate, Q, filterType);
+
+    filter->b0[index] = coefficients.b0;
+    filter->b1[index] = coefficients.b1;
+    filter->b2[index] = coefficients.b2;
+    filter->a1[index] = coefficients.a1;
+    filter->a2[index] = coefficients.a2;
+}
+
+void biquadFilterBank3InitLPF(biquadFilterBank3_t *filter, float filterFreq, uint32_t refreshRate)
+{
+    biquadFilterBank3Init(filter, filterFreq, refreshRate, BIQUAD_Q, FILTER_LPF);
+}
+
+void biquadFilterBank3Init(biquadFilterBank3_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType)
+{
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        biquadFilterBank3SetCoefficients(filter, i, filterFreq, refreshRate, Q, filterType);
+        filter->x1[i] = filter->x2[i] = 0;
+        filter->y1[i] = filter->y2[i] = 0;
+    }
+}
+
+// Retunes every filter of the bank to the same Butterworth lowpass, keeping their state
+void biquadFilterBank3UpdateLPF(biquadFilterBank3_t *filter, float filterFreq, uint32_t refreshRate)
+{
+    biquadFilterBank3SetCoefficients(filter, 0, filterFreq, refreshRate, BIQUAD_Q, FILTER_LPF);
+    for (int i = 1; i < FILTER_BANK_SIZE; i++) {
+        filter->b0[i] = filter->b0[0];
+        filter->b1[i] = filter->b1[0];
+        filter->b2[i] = filter->b2[0];
+        filter->a1[i] = filter->a1[0];
+        filter->a2[i] = filter->a2[0];
+    }
+}
+
+// Retunes a single filter of the bank, keeping its state
+FAST_CODE void biquadFilterBank3Update(biquadFilterBank3_t *filter, int index, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType)
+{
+    biquadFilterBank3SetCoefficients(filter, index, filterFreq, refreshRate, Q, filterType);
+}
+
+// Retunes a single notch of the bank, keeping its state. omegaScale is 2 * pi * refreshRate in seconds,
+// so it can be worked out once when several notches are retuned together
+FAST_CODE void biquadFilterBank3UpdateNotch(biquadFilterBank3_t *filter, int index, float filterFreq, float omegaScale, float Q)
+{
+    const float omega = filterFreq * omegaScale;
+    float sn, cs;
+    sincos_approx(omega, &sn, &cs);
+    const float alpha = sn / (2.0f * Q);
+    const float a0Rcp = 1.0f / (1.0f + alpha);
+
+    filter->b0[index] = a0Rcp;
+    filter->b1[index] = -2.0f * cs * a0Rcp;
+    filter->b2[index] = a0Rcp;
+    filter->a1[index] = filter->b1[index];
+    filter->a2[index] = (1.0f - alpha) * a0Rcp;
+}
+
+// Retunes every filter of the bank to the same notch, keeping their state
+FAST_CODE void biquadFilterBank3SetNotch(biquadFilterBank3_t *filter, float filterFreq, float omegaScale, float Q)
+{
+    biquadFilterBank3UpdateNotch(filter, 0, filterFreq, omegaScale, Q);
+    for (int i = 1; i < FILTER_BANK_SIZE; i++) {
+        filter->b0[i] = filter->b0[0];
+        filter->b1[i] = filter->b1[0];
+        filter->b2[i] = filter->b2[0];
+        filter->a1[i] = filter->a1[0];
+        filter->a2[i] = filter->a2[0];
+    }
+}
+
+void biquadNotchTableInit(biquadNotchTable_t *table, float minHz, float maxHz, uint32_t refreshRate, float Q)
+{
+    const float hzPerIndex = MAX(maxHz - minHz, 1.0f) / (BIQUAD_NOTCH_TABLE_SIZE - 1);
+    const float omegaScale = 2.0f * M_PI_FLOAT * refreshRate * 0.000001f;
+    biquadFilterBank3_t notch;
+
+    table->minHz = minHz;
+    table->indexPerHz = 1.0f / hzPerIndex;
+    for (int i = 0; i < BIQUAD_NOTCH_TABLE_SIZE; i++) {
+        biquadFilterBank3UpdateNotch(&notch, 0, minHz + i * hzPerIndex, omegaScale, Q);
+        table->b0[i] = notch.b0[0];
+        table->a1[i] = notch.a1[0];
+    }
+}
+
+// Retunes a single notch of the bank from the table, keeping its state. The cost does not depend on the frequency,
+// and there is no trigonometry or division, so many notches can be retuned in one loop
+FAST_CODE void biquadFilterBank3UpdateNotchFromTable(biquadFilterBank3_t *filter, int index, const biquadNotchTable_t *table, float filterFreq)
+{
+    const float position = constrainf((filterFreq - table->minHz) * table->indexPerHz, 0.0f, BIQUAD_NOTCH_TABLE_SIZE - 1);
+    const int i = MIN((int)position, BIQUAD_NOTCH_TABLE_SIZE - 2);
+    const float fraction = position - i;
+
+    filter->b0[index] = table->b0[i] + fraction * (table->b0[i + 1] - table->b0[i]);
+    filter->b1[index] = table->a1[i] + fraction * (table->a1[i + 1] - table->a1[i]);
+    filter->b2[index] = filter->b0[index];
+    filter->a1[index] = filter->b1[index];
+    filter->a2[index] = 2.0f * filter->b0[index] - 1.0f;
+}
+
+// Retunes every filter of the bank to the same notch from the table, keeping their state
+FAST_CODE void biquadFilterBank3SetNotchFromTable(biquadFilterBank3_t *filter, const biquadNotchTable_t *table, float filterFreq)
+{
+    biquadFilterBank3UpdateNotchFromTable(filter, 0, table, filterFreq);
+    for (int i = 1; i < FILTER_BANK_SIZE; i++) {
+        filter->b0[i] = filter->b0[0];
+        filter->b1[i] = filter->b1[0];
+        filter->b2[i] = filter->b2[0];
+        filter->a1[i] = filter->a1[0];
+        filter->a2[i] = filter->a2[0];
+    }
+}
+
+void biquadLowpassTableInit(biquadLowpassTable_t *table, float minHz, float maxHz, uint32_t refreshRate)
+{
+    const float hzPerIndex = MAX(maxHz - minHz, 1.0f) / (FILTER_LOWPASS_TABLE_SIZE - 1);
+    biquadFilter_t lowpass;
+
+    table->minHz = minHz;
+    table->indexPerHz = 1.0f / hzPerIndex;
+    for (int i = 0; i < FILTER_LOWPASS_TABLE_SIZE; i++) {
+        biquadFilterInitLPF(&lowpass, minHz + i * hzPerIndex, refreshRate);
+        table->a1[i] = lowpass.a1;
+        table->a2[i] = lowpass.a2;
+    }
+}
+
+// Retunes every filter of the bank to the same Butterworth lowpass from the table, keeping their state
+FAST_CODE void biquadFilterBank3SetLowpassFromTable(biquadFilterBank3_t *filter, const biquadLowpassTable_t *table, float cutoffHz)
+{
+    const float position = constrainf((cutoffHz - table->minHz) * table->indexPerHz, 0.0f, FILTER_LOWPASS_TABLE_SIZE - 1);
+    const int i = MIN((int)position, FILTER_LOWPASS_TABLE_SIZE - 2);
+    const float fraction = position - i;
+
+    const float a1 = table->a1[i] + fraction * (table->a1[i + 1] - table->a1[i]);
+    const float a2 = table->a2[i] + fraction * (table->a2[i + 1] - table->a2[i]);
+    const float b0 = (1.0f + a1 + a2) * 0.25f;
+    for (int j = 0; j < FILTER_BANK_SIZE; j++) {
+        filter->b0[j] = b0;
+        filter->b1[j] = 2.0f * b0;
+        filter->b2[j] = b0;
+        filter->a1[j] = a1;
+        filter->a2[j] = a2;
+    }
+}
+
+FAST_CODE void biquadFilterBank3ApplyDF1(biquadFilterBank3_t *filter, float *values)
+{
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        const float input = values[i];
+        const float result = filter->b0[i] * input + filter->b1[i] * filter->x1[i] + filter->b2[i] * filter->x2[i] - filter->a1[i] * filter->y1[i] - filter->a2[i] * filter->y2[i];
+
+        filter->x2[i] = filter->x1[i];
+        filter->x1[i] = input;
+
+        filter->y2[i] = filter->y1[i];
+        filter->y1[i] = result;
+
+        values[i] = result;
+    }
+}
+
+// Transposed direct form 2, as biquadFilterApply
+FAST_CODE void biquadFilterBank3Apply(biquadFilterBank3_t *filter, float *values)
+{
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        const float input = values[i];
+        const float result = filter->b0[i] * input + filter->x1[i];
+        filter->x1[i] = filter->b1[i] * input - filter->a1[i] * result + filter->x2[i];
+        filter->x2[i] = filter->b2[i] * input - filter->a2[i] * result;
+        values[i] = result;
+    }
+}
+
+// Kalman filter bank, steady state gains of a constant rate change model from the tracking index lambda
+
+// R adapts within a factor of 16 of the configured noise, moving the bandwidth within about a half and twice
+#define KALMAN_R_ADAPT_RANGE 16.0f
+
+static void kalmanFilterBank3SetGains(kalmanFilterBank3_t *filter, int index, float r)
+{
+    const float lambda = sqrtf(filter->q / r);
+    const float root = (4.0f + lambda - sqrtf(8.0f * lambda + lambda * lambda)) / 4.0f;
+    filter->alpha[index] = 1.0f - root * root;
+    filter->beta[index] = 2.0f * (2.0f - filter->alpha[index]) - 4.0f * root;
+}
+
+// Process noise variance giving the rate gain k of a PT1 at the measurement noise variance r
+float kalmanFilterProcessNoise(float k, float r)
+{
+    const float root = sqrtf(1.0f - k);
+    const float beta = 2.0f * (2.0f - k) - 4.0f * root;
+    const float lambda = beta / root;
+    return lambda * lambda * r;
+}
+
+void kalmanFilterBank3Init(kalmanFilterBank3_t *filter, float q, float r)
+{
+    memset(filter, 0, sizeof(*filter));
+    filter->q = q;
+    filter->rMin = r / KALMAN_R_ADAPT_RANGE;
+    filter->rMax = r * KALMAN_R_ADAPT_RANGE;
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        kalmanFilterBank3SetGains(filter, i, r);
+    }
+}
+
+FAST_CODE void kalmanFilterBank3Apply(kalmanFilterBank3_t *filter, float *values)
+{
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        const float prediction = filter->x[i] + filter->v[i];
+        const float innovation = values[i] - prediction;
+        filter->x[i] = prediction + filter->alpha[i] * innovation;
+        filter->v[i] += filter->beta[i] * innovation;
+        values[i] = filter->x[i];
+
+        filter->innovationSum[i] += innovation;
+        filter->innovationSquaredSum[i] += innovation * innovation;
+    }
+
+    if (++filter->windowCount < KALMAN_WINDOW_SIZE) {
+        return;
+    }
+    filter->windowCount = 0;
+
+    // the innovation variance is R / (1 - alpha) in the steady state
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        const float mean = filter->innovationSum[i] * (1.0f / KALMAN_WINDOW_SIZE);
+        const float variance = filter->innovationSquaredSum[i] * (1.0f / KALMAN_WINDOW_SIZE) - mean * mean;
+        kalmanFilterBank3SetGains(filter, i, constrainf((1.0f - filter->alpha[i]) * variance, filter->rMin, filter->rMax));
+        filter->innovationSum[i] = 0.0f;
+        filter->innovationSquaredSum[i] = 0.0f;
+    }
+}
@@ -41,6 +41,69 @@ typedef struct biquadFilter_s {
     float x1, x2, y1, y2;
 } biquadFilter_t;
 
+// Banks of three filters, stepped together so the three gyro axes are filtered in a single call.
+// The coefficients are per filter, so the filters may be tuned independently (eg dynamic notch).
+#define FILTER_BANK_SIZE 3
+
+typedef struct pt1FilterBank3_s {
+    float state[FILTER_BANK_SIZE];
+    float k;
+} pt1FilterBank3_t;
+
+typedef struct biquadFilterBank3_s {
+    float b0[FILTER_BANK_SIZE], b1[FILTER_BANK_SIZE], b2[FILTER_BANK_SIZE], a1[FILTER_BANK_SIZE], a2[FILTER_BANK_SIZE];
+    float x1[FILTER_BANK_SIZE], x2[FILTER_BANK_SIZE], y1[FILTER_BANK_SIZE], y2[FILTER_BANK_SIZE];
+} biquadFilterBank3_t;
+
+// Notch coefficients at evenly spaced frequencies for one Q and sample rate, so retuning a notch is a lookup and
+// linear interpolation. For a notch b1 == a1, b2 == b0 and a2 == 2 * b0 - 1, so two coefficients are enough,
+// and the zeros stay on the unit circle when interpolating.
+#define BIQUAD_NOTCH_TABLE_SIZE 256
+
+typedef struct biquadNotchTable_s {
+    float minHz;
+    float indexPerHz;
+    float b0[BIQUAD_NOTCH_TABLE_SIZE];
+    float a1[BIQUAD_NOTCH_TABLE_SIZE];
+} biquadNotchTable_t;
+
+// Lowpass gains and coefficients at evenly spaced cutoffs for one sample rate, so a lowpass following the throttle
+// is retuned without a division or trigonometry. The PT1 gain and the Butterworth poles change smoothly with the
+// cutoff, so fewer points than for a notch are enough. The Butterworth section has unity gain at DC, so its zeros
+// are worked out from the poles and b0 == b2 == (1 + a1 + a2) / 4, b1 == 2 * b0.
+#define FILTER_LOWPASS_TABLE_SIZE 64
+
+typedef struct pt1GainTable_s {
+    float minHz;
+    float indexPerHz;
+    float k[FILTER_LOWPASS_TABLE_SIZE];
+} pt1GainTable_t;
+
+typedef struct biquadLowpassTable_s {
+    float minHz;
+    float indexPerHz;
+    float a1[FILTER_LOWPASS_TABLE_SIZE];
+    float a2[FILTER_LOWPASS_TABLE_SIZE];
+} biquadLowpassTable_t;
+
+// Steady state Kalman filter of the rate and its change per sample (an alpha-beta filter), for each of the three axes.
+// The rate change is extrapolated, so a ramp is followed without lag. The measurement noise variance R is estimated
+// from the variance of the innovations over a window of samples, and the gains are worked out again at the end of
+// each window, a noisier gyro gets lower gains and is smoothed more.
+#define KALMAN_WINDOW_SIZE 32
+
+typedef struct kalmanFilterBank3_s {
+    float x[FILTER_BANK_SIZE];          // estimated rate
+    float v[FILTER_BANK_SIZE];          // estimated change of the rate per sample
+    float alpha[FILTER_BANK_SIZE];
+    float beta[FILTER_BANK_SIZE];
+    float innovationSum[FILTER_BANK_SIZE];
+    float innovationSquaredSum[FILTER_BANK_SIZE];
+    float q;                            // process noise variance
+    float rMin, rMax;                   // limits of the estimated measurement noise variance
+    uint8_t windowCount;
+} kalmanFilterBank3_t;
+
 typedef struct laggedMovingAverage_s {
     uint16_t movingWindowIndex;
     uint16_t windowSize;
@@ -52,6 +115,7 @@ typedef struct laggedMovingAverage_s {
 typedef enum {
     FILTER_PT1 = 0,
     FILTER_BIQUAD,
+    FILTER_KALMAN,
 } lowpassFilterType_e;
 
 typedef enum {
@@ -83,3 +147,26 @@ float pt1FilterApply(pt1Filter_t *filter, float input);
 
 void slewFilterInit(slewFilter_t *filter, float slewLimit, float threshold);
 float slewFilterApply(slewFilter_t *filter, float input);
+
+void pt1FilterBank3Init(pt1FilterBank3_t *filter, float k);
+void pt1FilterBank3Apply(pt1FilterBank3_t *filter, float *values);
+void pt1GainTableInit(pt1GainTable_t *table, float minHz, float maxHz, float dT);
+float pt1GainFromTable(const pt1GainTable_t *table, float cutoffHz);
+
+void biquadFilterBank3InitLPF(biquadFilterBank3_t *filter, float filterFreq, uint32_t refreshRate);
+void biquadFilterBank3Init(biquadFilterBank3_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType);
+void biquadFilterBank3UpdateLPF(biquadFilterBank3_t *filter, float filterFreq, uint32_t refreshRate);
+void biquadFilterBank3Update(biquadFilterBank3_t *filter, int index, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType);
+void biquadFilterBank3UpdateNotch(biquadFilterBank3_t *filter, int index, float filterFreq, float omegaScale, float Q);
+void biquadFilterBank3SetNotch(biquadFilterBank3_t *filter, float filterFreq, float omegaScale, float Q);
+void biquadFilterBank3Apply(biquadFilterBank3_t *filter, float *values);
+void biquadNotchTableInit(biquadNotchTable_t *table, float minHz, float maxHz, uint32_t refreshRate, float Q);
+void biquadFilterBank3UpdateNotchFromTable(biquadFilterBank3_t *filter, int index, const biquadNotchTable_t *table, float filterFreq);
+void biquadFilterBank3SetNotchFromTable(biquadFilterBank3_t *filter, const biquadNotchTable_t *table, float filterFreq);
+void biquadLowpassTableInit(biquadLowpassTable_t *table, float minHz, float maxHz, uint32_t refreshRate);
+void biquadFilterBank3SetLowpassFromTable(biquadFilterBank3_t *filter, const biquadLowpassTable_t *table, float cutoffHz);
+void biquadFilterBank3ApplyDF1(biquadFilterBank3_t *filter, float *values);
+
+float kalmanFilterProcessNoise(float k, float r);
+void kalmanFilterBank3Init(kalmanFilterBank3_t *filter, float q, float r);
+void kalmanFilterBank3Apply(kalmanFilterBank3_t *filter, float *values);
@@ -0,0 +1,105 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#include "common/filter.h"
+#include "common/filter_fixed.h"
+
+static int32_t filterCoeffToFixed(float coeff)
+{
+    return lrintf(coeff * (1 << FILTER_FIXED_COEFF_SHIFT));
+}
+
+// 64 bit products, rounded back to the sample format
+static inline int32_t filterFixedRound(int64_t acc)
+{
+    return (int32_t)((acc + (1 << (FILTER_FIXED_COEFF_SHIFT - 1))) >> FILTER_FIXED_COEFF_SHIFT);
+}
+
+// PT1 Low Pass filter bank
+
+void pt1FilterBank3FixedInit(pt1FilterBank3Fixed_t *filter, float k)
+{
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        filter->state[i] = 0;
+    }
+    filter->k = filterCoeffToFixed(k);
+}
+
+FAST_CODE void pt1FilterBank3FixedApply(pt1FilterBank3Fixed_t *filter, int32_t *values)
+{
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        filter->state[i] += filterFixedRound((int64_t)filter->k * (values[i] - filter->state[i]));
+        values[i] = filter->state[i];
+    }
+}
+
+// Biquad filter bank, the coefficients are worked out in floating point and then converted
+
+static void biquadFilterBank3FixedSetCoefficients(biquadFilterBank3Fixed_t *filter, const biquadFilter_t *coefficients)
+{
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        filter->b0[i] = filterCoeffToFixed(coefficients->b0);
+        filter->b1[i] = filterCoeffToFixed(coefficients->b1);
+        filter->b2[i] = filterCoeffToFixed(coefficients->b2);
+        filter->a1[i] = filterCoeffToFixed(coefficients->a1);
+        filter->a2[i] = filterCoeffToFixed(coefficients->a2);
+        filter->x1[i] = filter->x2[i] = 0;
+        filter->y1[i] = filter->y2[i] = 0;
+    }
+}
+
+void biquadFilterBank3FixedInitLPF(biquadFilterBank3Fixed_t *filter, float filterFreq, uint32_t refreshRate)
+{
+    biquadFilter_t coefficients;
+    biquadFilterInitLPF(&coefficients, filterFreq, refreshRate);
+    biquadFilterBank3FixedSetCoefficients(filter, &coefficients);
+}
+
+void biquadFilterBank3FixedInit(biquadFilterBank3Fixed_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType)
+{
+    biquadFilter_t coefficients;
+    biquadFilterInit(&coefficients, filterFreq, refreshRate, Q, filterType);
+    biquadFilterBank3FixedSetCoefficients(filter, &coefficients);
+}
+
+// Direct form 1, which unlike direct form 2 keeps no intermediate state that could overflow
+FAST_CODE void biquadFilterBank3FixedApply(biquadFilterBank3Fixed_t *filter, int32_t *values)
+{
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        const int32_t input = values[i];
+        const int64_t acc = (int64_t)filter->b0[i] * input + (int64_t)filter->b1[i] * filter->x1[i] + (int64_t)filter->b2[i] * filter->x2[i]
+            - (int64_t)filter->a1[i] * filter->y1[i] - (int64_t)filter->a2[i] * filter->y2[i];
+        const int32_t result = filterFixedRound(acc);
+
+        filter->x2[i] = filter->x1[i];
+        filter->x1[i] = input;
+
+        filter->y2[i] = filter->y1[i];
+        filter->y1[i] = result;
+
+        values[i] = result;
+    }
+}
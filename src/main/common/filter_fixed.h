@@ -0,0 +1,57 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/filter.h"
+
+// Fixed point versions of the filter banks, for processors without an FPU.
+// Samples are Q15.16, eg degrees per second * 65536, and coefficients are Q1.30 so that the biquad's can reach +-2.
+#define FILTER_FIXED_SAMPLE_SHIFT 16
+#define FILTER_FIXED_COEFF_SHIFT  30
+
+typedef struct pt1FilterBank3Fixed_s {
+    int32_t state[FILTER_BANK_SIZE];
+    int32_t k;
+} pt1FilterBank3Fixed_t;
+
+typedef struct biquadFilterBank3Fixed_s {
+    int32_t b0[FILTER_BANK_SIZE], b1[FILTER_BANK_SIZE], b2[FILTER_BANK_SIZE], a1[FILTER_BANK_SIZE], a2[FILTER_BANK_SIZE];
+    int32_t x1[FILTER_BANK_SIZE], x2[FILTER_BANK_SIZE], y1[FILTER_BANK_SIZE], y2[FILTER_BANK_SIZE];
+} biquadFilterBank3Fixed_t;
+
+static inline int32_t filterFloatToFixed(float value)
+{
+    return (int32_t)(value * (1 << FILTER_FIXED_SAMPLE_SHIFT));
+}
+
+static inline float filterFixedToFloat(int32_t value)
+{
+    return value * (1.0f / (1 << FILTER_FIXED_SAMPLE_SHIFT));
+}
+
+void pt1FilterBank3FixedInit(pt1FilterBank3Fixed_t *filter, float k);
+void pt1FilterBank3FixedApply(pt1FilterBank3Fixed_t *filter, int32_t *values);
+
+void biquadFilterBank3FixedInitLPF(biquadFilterBank3Fixed_t *filter, float filterFreq, uint32_t refreshRate);
+void biquadFilterBank3FixedInit(biquadFilterBank3Fixed_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType);
+void biquadFilterBank3FixedApply(biquadFilterBank3Fixed_t *filter, int32_t *values);
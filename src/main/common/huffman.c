@@ -28,80 +28,143 @@
 #include "huffman.h"
 
 
+/*
+ * The codes are at most 16 bits long and left aligned in the table. The encoder ORs whole codes into a 32 bit
+ * accumulator and stores it a byte at a time. The decoder looks up the codes of up to HUFFMAN_DECODE_FAST_BITS
+ * bits, which are most of a stream, with the next byte of the input and searches the table for the longer ones.
+ */
+
 int huffmanEncodeBuf(uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inLen, const huffmanTable_t *huffmanTable)
 {
-    int ret = 0;
-
-    uint8_t *outByte = outBuf;
-    *outByte = 0;
-    uint8_t outBit = 0x80;
-
-    for (int ii = 0; ii < inLen; ++ii) {
-        const int huffCodeLen = huffmanTable[*inBuf].codeLen;
-        const uint16_t huffCode = huffmanTable[*inBuf].code;
-        ++inBuf;
-        uint16_t testBit = 0x8000;
-
-        for (int jj = 0; jj < huffCodeLen; ++jj) {
-            if (huffCode & testBit) {
-                *outByte |= outBit;
-            }
-
-            testBit >>= 1;
-            outBit >>= 1;
-            if (outBit == 0) {
-                outBit = 0x80;
-                ++outByte;
-                *outByte = 0;
-                ++ret;
-            }
-
-            if (ret >= outBufLen && ii < inLen - 1 && jj < huffCodeLen - 1) {
-                return -1;
-            }
-        }
+    huffmanState_t state = {
+        .bytesWritten = 0,
+        .outByte = outBuf,
+        .outBufLen = outBufLen,
+        .outBit = 0x80,
+    };
+
+    if (huffmanEncodeBufStreaming(&state, inBuf, inLen, huffmanTable) == -1) {
+        return -1;
     }
-    if (outBit != 0x80) {
+    if (state.outBit != 0x80) {
         // ensure last character in output buffer is counted
-        ++ret;
+        ++state.bytesWritten;
     }
-    return ret;
+    return state.bytesWritten;
 }
 
+// Leaves the state unchanged if the output would not fit in outBufLen bytes
 int huffmanEncodeBufStreaming(huffmanState_t *state, const uint8_t *inBuf, int inLen, const huffmanTable_t *huffmanTable)
 {
-    uint8_t *savedOutBytePtr = state->outByte;
-    uint8_t savedOutByte = *savedOutBytePtr;
+    uint8_t *outByte = state->outByte;
+    const uint8_t savedOutByte = *outByte;
+    int bytesWritten = state->bytesWritten;
+
+    // continue the partly filled byte
+    int accBits = 0;
+    for (uint8_t outBit = state->outBit; outBit != 0x80; outBit <<= 1) {
+        ++accBits;
+    }
+    uint32_t acc = accBits ? (uint32_t)savedOutByte << 24 : 0;
 
     for (const uint8_t *pos = inBuf, *end = inBuf + inLen; pos < end; ++pos) {
-        const int huffCodeLen = huffmanTable[*pos].codeLen;
-        const uint16_t huffCode = huffmanTable[*pos].code;
-        uint16_t testBit = 0x8000;
-
-        for (int jj = 0; jj < huffCodeLen; ++jj) {
-            if (huffCode & testBit) {
-                *state->outByte |= state->outBit;
+        acc |= ((uint32_t)huffmanTable[*pos].code << 16) >> accBits;
+        accBits += huffmanTable[*pos].codeLen;
+        while (accBits >= 8) {
+            if (bytesWritten >= state->outBufLen) {
+                *state->outByte = savedOutByte;
+                return -1;
             }
+            *outByte++ = acc >> 24;
+            ++bytesWritten;
+            acc <<= 8;
+            accBits -= 8;
+        }
+    }
+
+    if (accBits) {
+        if (bytesWritten >= state->outBufLen) {
+            *state->outByte = savedOutByte;
+            return -1;
+        }
+        *outByte = acc >> 24;
+    }
 
-            testBit >>= 1;
-            state->outBit >>= 1;
-            if (state->outBit == 0) {
-                state->outBit = 0x80;
-                ++state->outByte;
-                *state->outByte = 0;
-                ++state->bytesWritten;
+    state->outByte = outByte;
+    state->bytesWritten = bytesWritten;
+    state->outBit = 0x80 >> accBits;
+    return 0;
+}
+
+void huffmanDecodeTableInit(huffmanDecodeTable_t *decodeTable, const huffmanTable_t *huffmanTable)
+{
+    for (int ii = 0; ii < HUFFMAN_DECODE_FAST_SIZE; ++ii) {
+        decodeTable->fast[ii] = 0;
+    }
+    for (int symbol = 0; symbol < HUFFMAN_TABLE_SIZE; ++symbol) {
+        const int codeLen = huffmanTable[symbol].codeLen;
+        if (codeLen && codeLen <= HUFFMAN_DECODE_FAST_BITS) {
+            // every index starting with the code
+            const int first = huffmanTable[symbol].code >> (16 - HUFFMAN_DECODE_FAST_BITS);
+            for (int ii = 0; ii < 1 << (HUFFMAN_DECODE_FAST_BITS - codeLen); ++ii) {
+                decodeTable->fast[first + ii] = symbol << 4 | codeLen;
             }
+        }
+    }
+}
+
+/*
+ * Decodes until outBufLen characters are written, the EOF code or the end of the input. The streams carry their
+ * uncompressed size, which should be the outBufLen as the bits padding the last byte may look like a code.
+ * Returns the count of characters written, or -1 if the input holds a code that is not in the table.
+ */
+int huffmanDecode(uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inLen, const huffmanTable_t *huffmanTable, const huffmanDecodeTable_t *decodeTable)
+{
+    const uint8_t *inEnd = inBuf + inLen;
+    uint32_t acc = 0;
+    int accBits = 0;
+    int outCount = 0;
+
+    while (outCount < outBufLen) {
+        while (accBits <= 24 && inBuf < inEnd) {
+            acc |= (uint32_t)*inBuf++ << (24 - accBits);
+            accBits += 8;
+        }
+        if (accBits == 0) {
+            break;
+        }
 
-            // if buffer is filled and we haven't finished compressing
-            if (state->bytesWritten >= state->outBufLen && (pos < end - 1 || jj < huffCodeLen - 1)) {
-                // restore savedOutByte
-                *savedOutBytePtr = savedOutByte;
+        int symbol;
+        int codeLen;
+        const uint16_t fast = decodeTable->fast[acc >> (32 - HUFFMAN_DECODE_FAST_BITS)];
+        if (fast) {
+            symbol = fast >> 4;
+            codeLen = fast & 0x0f;
+        } else {
+            const uint16_t window = acc >> 16;
+            for (symbol = 0; symbol < HUFFMAN_TABLE_SIZE; ++symbol) {
+                codeLen = huffmanTable[symbol].codeLen;
+                if (codeLen > HUFFMAN_DECODE_FAST_BITS && ((window ^ huffmanTable[symbol].code) >> (16 - codeLen)) == 0) {
+                    break;
+                }
+            }
+            if (symbol == HUFFMAN_TABLE_SIZE) {
                 return -1;
             }
         }
-    }
+        if (codeLen > accBits) {
+            // the bits padding the last byte, or a truncated input
+            return accBits < 8 ? outCount : -1;
+        }
+        if (symbol == HUFFMAN_EOF_SYMBOL) {
+            break;
+        }
 
-    return 0;
+        outBuf[outCount++] = symbol;
+        acc <<= codeLen;
+        accBits -= codeLen;
+    }
+    return outCount;
 }
 
 #endif
@@ -23,6 +23,7 @@
 #include <stdint.h>
 
 #define HUFFMAN_TABLE_SIZE 257 // 256 characters plus EOF
+#define HUFFMAN_EOF_SYMBOL 256
 typedef struct huffmanTable_s {
     uint8_t     codeLen;
     uint16_t    code;
@@ -35,6 +36,13 @@ typedef struct huffmanState_s {
     uint8_t     outBit;
 } huffmanState_t;
 
+#define HUFFMAN_DECODE_FAST_BITS 8
+#define HUFFMAN_DECODE_FAST_SIZE (1 << HUFFMAN_DECODE_FAST_BITS)
+
+typedef struct huffmanDecodeTable_s {
+    uint16_t    fast[HUFFMAN_DECODE_FAST_SIZE];    // symbol << 4 | code length by the leading bits, 0 for the longer codes
+} huffmanDecodeTable_t;
+
 extern const huffmanTable_t huffmanTable[HUFFMAN_TABLE_SIZE];
 
 struct huffmanInfo_s {
@@ -45,3 +53,5 @@ struct huffmanInfo_s {
 
 int huffmanEncodeBuf(uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inLen, const huffmanTable_t *huffmanTable);
 int huffmanEncodeBufStreaming(huffmanState_t *state, const uint8_t *inBuf, int inLen, const huffmanTable_t *huffmanTable);
+void huffmanDecodeTableInit(huffmanDecodeTable_t *decodeTable, const huffmanTable_t *huffmanTable);
+int huffmanDecode(uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inLen, const huffmanTable_t *huffmanTable, const huffmanDecodeTable_t *decodeTable);
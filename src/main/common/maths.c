@@ -43,6 +43,13 @@
 #define sinPolyCoef7 -1.980661520e-4f                                          // Double: -1.980661520135080504411629636078917643846e-4
 #define sinPolyCoef9  2.600054768e-6f                                          // Double:  2.600054767890361277123254766503271638682e-6
 #endif
+// The polynomial for -PI/2..PI/2
+static inline float sinPoly(float x)
+{
+    float x2 = x * x;
+    return x + x * x2 * (sinPolyCoef3 + x2 * (sinPolyCoef5 + x2 * (sinPolyCoef7 + x2 * sinPolyCoef9)));
+}
+
 float sin_approx(float x)
 {
     int32_t xint = x;
@@ -51,8 +58,7 @@ float sin_approx(float x)
     while (x < -M_PIf) x += (2.0f * M_PIf);
     if (x >  (0.5f * M_PIf)) x =  (0.5f * M_PIf) - (x - (0.5f * M_PIf));   // We just pick -90..+90 Degree
     else if (x < -(0.5f * M_PIf)) x = -(0.5f * M_PIf) - ((0.5f * M_PIf) + x);
-    float x2 = x * x;
-    return x + x * x2 * (sinPolyCoef3 + x2 * (sinPolyCoef5 + x2 * (sinPolyCoef7 + x2 * sinPolyCoef9)));
+    return sinPoly(x);
 }
 
 float cos_approx(float x)
@@ -60,6 +66,24 @@ float cos_approx(float x)
     return sin_approx(x + (0.5f * M_PIf));
 }
 
+// Both from one range reduction, cos(x) = sin(PI/2 - |x|) needs no folding once x is in -PI..PI.
+// sincos_approx maximum absolute error = 2.801418e-06 (sin), 2.741814e-06 (cos)
+void sincos_approx(float x, float *sinx, float *cosx)
+{
+    int32_t xint = x;
+    if (xint < -32 || xint > 32) {                                          // Stop here on error input (5 * 360 Deg)
+        *sinx = 0.0f;
+        *cosx = 0.0f;
+        return;
+    }
+    while (x >  M_PIf) x -= (2.0f * M_PIf);                                 // always wrap input angle to -PI..PI
+    while (x < -M_PIf) x += (2.0f * M_PIf);
+    *cosx = sinPoly((0.5f * M_PIf) - fabsf(x));
+    if (x >  (0.5f * M_PIf)) x =  M_PIf - x;                                // We just pick -90..+90 Degree
+    else if (x < -(0.5f * M_PIf)) x = -M_PIf - x;
+    *sinx = sinPoly(x);
+}
+
 // Initial implementation by Crashpilot1000 (https://github.com/Crashpilot1000/HarakiriWebstore1/blob/396715f73c6fcf859e0db0f34e12fe44bace6483/src/mw.c#L1292)
 // Polynomial coefficients by Andor (http://www.dsprelated.com/showthread/comp.dsp/21872-1.php) optimized by Ledvinap to save one multiplication
 // Max absolute error 0,000027 degree
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <math.h>
 #include <stdint.h>
 
 #ifndef sq
@@ -124,6 +125,7 @@ float quickMedianFilter9f(float * v);
 #if defined(FAST_MATH) || defined(VERY_FAST_MATH)
 float sin_approx(float x);
 float cos_approx(float x);
+void sincos_approx(float x, float *sinx, float *cosx);
 float atan2_approx(float y, float x);
 float acos_approx(float x);
 #define tan_approx(x)       (sin_approx(x) / cos_approx(x))
@@ -133,6 +135,7 @@ float pow_approx(float a, float b);
 #else
 #define sin_approx(x)   sinf(x)
 #define cos_approx(x)   cosf(x)
+#define sincos_approx(x, sinx, cosx) do { *(sinx) = sinf(x); *(cosx) = cosf(x); } while (0)
 #define atan2_approx(y,x)   atan2f(y,x)
 #define acos_approx(x)      acosf(x)
 #define tan_approx(x)       tanf(x)
@@ -141,6 +144,12 @@ float pow_approx(float a, float b);
 #define pow_approx(a, b)    powf(b, a)
 #endif
 
+// Exact, the FPU square root and division are faster than the bit trick with a Newton step
+static inline float invSqrt(float x)
+{
+    return 1.0f / sqrtf(x);
+}
+
 void arraySubInt32(int32_t *dest, int32_t *array1, int32_t *array2, int count);
 
 int16_t qPercent(fix12_t q);
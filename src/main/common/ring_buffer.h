@@ -0,0 +1,186 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Ring buffer for one producer and one consumer, such as a receive interrupt and the serial task.
+ *
+ * The producer only writes the head and the consumer only writes the tail, so neither side ever masks interrupts.
+ * Both indices run freely and are masked on access, which needs a power of two size, and lets the whole buffer be
+ * used since a full ring is told from an empty one by the count. The element stores are ordered before the index
+ * store that publishes them by a compiler barrier, which is enough on a single core.
+ *
+ * RING_BUFFER_DEFINE(name, type) defines name_t and its functions for a ring of type elements. The spans are for
+ * DMA and bulk copies, they end at the end of the buffer and the rest follows from its start.
+ */
+
+#define RING_BUFFER_BARRIER() asm volatile ("": : :"memory") // compiler memory barrier
+
+#define RING_BUFFER_IS_POWER_OF_2(size) ((size) > 0 && ((size) & ((size) - 1)) == 0)
+
+#define RING_BUFFER_DEFINE(name, type)                                                                  \
+typedef struct name##_s {                                                                               \
+    volatile type *buffer;                                                                              \
+    uint32_t mask;                                                                                      \
+    volatile uint32_t head;                                                                             \
+    volatile uint32_t tail;                                                                             \
+} name##_t;                                                                                             \
+                                                                                                        \
+/* size has to be a power of two */                                                                     \
+static inline void name##Init(name##_t *ring, volatile type *buffer, uint32_t size)                     \
+{                                                                                                       \
+    ring->buffer = buffer;                                                                              \
+    ring->mask = size - 1;                                                                              \
+    ring->head = 0;                                                                                     \
+    ring->tail = 0;                                                                                     \
+}                                                                                                       \
+                                                                                                        \
+static inline uint32_t name##Size(const name##_t *ring)                                                 \
+{                                                                                                       \
+    return ring->mask + 1;                                                                              \
+}                                                                                                       \
+                                                                                                        \
+static inline uint32_t name##Count(const name##_t *ring)                                                \
+{                                                                                                       \
+    return ring->head - ring->tail;                                                                     \
+}                                                                                                       \
+                                                                                                        \
+static inline uint32_t name##Free(const name##_t *ring)                                                 \
+{                                                                                                       \
+    return ring->mask + 1 - (ring->head - ring->tail);                                                  \
+}                                                                                                       \
+                                                                                                        \
+static inline bool name##IsEmpty(const name##_t *ring)                                                  \
+{                                                                                                       \
+    return ring->head == ring->tail;                                                                    \
+}                                                                                                       \
+                                                                                                        \
+/* Producer, false if the ring is full */                                                               \
+static inline bool name##Push(name##_t *ring, type value)                                               \
+{                                                                                                       \
+    const uint32_t head = ring->head;                                                                   \
+    if (head - ring->tail > ring->mask) {                                                               \
+        return false;                                                                                   \
+    }                                                                                                   \
+    ring->buffer[head & ring->mask] = value;                                                            \
+    RING_BUFFER_BARRIER();                                                                              \
+    ring->head = head + 1;                                                                              \
+    return true;                                                                                        \
+}                                                                                                       \
+                                                                                                        \
+/* Consumer, false if the ring is empty */                                                              \
+static inline bool name##Pop(name##_t *ring, type *value)                                               \
+{                                                                                                       \
+    const uint32_t tail = ring->tail;                                                                   \
+    if (ring->head == tail) {                                                                           \
+        return false;                                                                                   \
+    }                                                                                                   \
+    RING_BUFFER_BARRIER();                                                                              \
+    *value = ring->buffer[tail & ring->mask];                                                           \
+    RING_BUFFER_BARRIER();                                                                              \
+    ring->tail = tail + 1;                                                                              \
+    return true;                                                                                        \
+}                                                                                                       \
+                                                                                                        \
+/* Producer, the free space from the head up to the end of the buffer */                                \
+static inline uint32_t name##WriteSpan(const name##_t *ring, type **span)                               \
+{                                                                                                       \
+    const uint32_t head = ring->head;                                                                   \
+    const uint32_t index = head & ring->mask;                                                           \
+    const uint32_t freeCount = ring->mask + 1 - (head - ring->tail);                                    \
+    const uint32_t toEnd = ring->mask + 1 - index;                                                      \
+    *span = (type *)&ring->buffer[index];                                                               \
+    return freeCount < toEnd ? freeCount : toEnd;                                                       \
+}                                                                                                       \
+                                                                                                        \
+/* Producer, publishes count elements written to the write span */                                      \
+static inline void name##Commit(name##_t *ring, uint32_t count)                                         \
+{                                                                                                       \
+    RING_BUFFER_BARRIER();                                                                              \
+    ring->head += count;                                                                                \
+}                                                                                                       \
+                                                                                                        \
+/* Consumer, the elements from the tail up to the end of the buffer */                                  \
+static inline uint32_t name##ReadSpan(const name##_t *ring, const type **span)                          \
+{                                                                                                       \
+    const uint32_t tail = ring->tail;                                                                   \
+    const uint32_t index = tail & ring->mask;                                                           \
+    const uint32_t count = ring->head - tail;                                                           \
+    const uint32_t toEnd = ring->mask + 1 - index;                                                      \
+    RING_BUFFER_BARRIER();                                                                              \
+    *span = (const type *)&ring->buffer[index];                                                         \
+    return count < toEnd ? count : toEnd;                                                               \
+}                                                                                                       \
+                                                                                                        \
+/* Consumer, frees count elements of the read span */                                                   \
+static inline void name##Consume(name##_t *ring, uint32_t count)                                        \
+{                                                                                                       \
+    RING_BUFFER_BARRIER();                                                                              \
+    ring->tail += count;                                                                                \
+}                                                                                                       \
+                                                                                                        \
+/* Producer, returns how many of the values fitted */                                                   \
+static inline uint32_t name##PushBulk(name##_t *ring, const type *values, uint32_t count)               \
+{                                                                                                       \
+    uint32_t pushed = 0;                                                                                \
+    while (pushed < count) {                                                                            \
+        type *span;                                                                                     \
+        uint32_t spanCount = name##WriteSpan(ring, &span);                                              \
+        if (spanCount == 0) {                                                                           \
+            break;                                                                                      \
+        }                                                                                               \
+        if (spanCount > count - pushed) {                                                               \
+            spanCount = count - pushed;                                                                 \
+        }                                                                                               \
+        memcpy(span, values + pushed, spanCount * sizeof(type));                                        \
+        name##Commit(ring, spanCount);                                                                  \
+        pushed += spanCount;                                                                            \
+    }                                                                                                   \
+    return pushed;                                                                                      \
+}                                                                                                       \
+                                                                                                        \
+/* Consumer, returns how many values were taken */                                                      \
+static inline uint32_t name##PopBulk(name##_t *ring, type *values, uint32_t count)                      \
+{                                                                                                       \
+    uint32_t popped = 0;                                                                                \
+    while (popped < count) {                                                                            \
+        const type *span;                                                                               \
+        uint32_t spanCount = name##ReadSpan(ring, &span);                                               \
+        if (spanCount == 0) {                                                                           \
+            break;                                                                                      \
+        }                                                                                               \
+        if (spanCount > count - popped) {                                                               \
+            spanCount = count - popped;                                                                 \
+        }                                                                                               \
+        memcpy(values + popped, span, spanCount * sizeof(type));                                        \
+        name##Consume(ring, spanCount);                                                                 \
+        popped += spanCount;                                                                            \
+    }                                                                                                   \
+    return popped;                                                                                      \
+}
+
+// the bytes of the serial ports
+RING_BUFFER_DEFINE(byteRing, uint8_t)
@@ -0,0 +1,137 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/time.h"
+
+/*
+ * A topic is a value with a single producer that any number of consumers take snapshots of.
+ *
+ * The producer publishes the whole value with a timestamp and never waits. A consumer copies the
+ * value and retries if a publish overtook the copy, so the snapshot is consistent whichever of the
+ * two runs in interrupt context. A consumer that interrupted a publish cannot wait for it to end,
+ * it gets TOPIC_READ_BUSY and keeps its previous snapshot.
+ *
+ * TOPIC_DECLARE goes in the header of the producer and TOPIC_DEFINE in its source file.
+ */
+typedef struct topic_s {
+    volatile uint32_t sequence; // twice the number of publishes, plus one while a publish is in progress
+    timeUs_t timestamp;
+    uint16_t size;
+    void *value;
+} topic_t;
+
+// Per consumer state, zero before the first read
+typedef struct topicSubscriber_s {
+    uint32_t sequence;          // of the last snapshot taken
+    timeUs_t timestamp;         // publish time of the last snapshot taken
+} topicSubscriber_t;
+
+typedef enum {
+    TOPIC_READ_NONE = 0,        // nothing published yet
+    TOPIC_READ_BUSY,            // a publish was in progress at every attempt
+    TOPIC_READ_UNCHANGED,       // nothing published since the last snapshot
+    TOPIC_READ_NEW,
+} topicReadResult_e;
+
+#define TOPIC_READ_ATTEMPTS 3
+
+#define TOPIC_BARRIER() asm volatile ("": : :"memory") // compiler memory barrier
+
+// Called by the only producer of the topic
+static inline void topicPublish(topic_t *topic, const void *value, timeUs_t currentTimeUs)
+{
+    const uint32_t sequence = topic->sequence;
+    topic->sequence = sequence + 1;
+    TOPIC_BARRIER();
+
+    memcpy(topic->value, value, topic->size);
+    topic->timestamp = currentTimeUs;
+
+    TOPIC_BARRIER();
+    topic->sequence = sequence + 2;
+}
+
+// Copies the latest value if it was published after the last snapshot of the subscriber
+static inline topicReadResult_e topicRead(const topic_t *topic, void *value, topicSubscriber_t *subscriber)
+{
+    for (int attempt = 0; attempt < TOPIC_READ_ATTEMPTS; attempt++) {
+        const uint32_t start = topic->sequence;
+        if (start == 0 || start == 1) {
+            return TOPIC_READ_NONE;
+        }
+        if (start == subscriber->sequence) {
+            return TOPIC_READ_UNCHANGED;
+        }
+        if (start & 1) {
+            continue;
+        }
+        TOPIC_BARRIER();
+
+        memcpy(value, topic->value, topic->size);
+        const timeUs_t timestamp = topic->timestamp;
+
+        TOPIC_BARRIER();
+        if (topic->sequence == start) {
+            subscriber->sequence = start;
+            subscriber->timestamp = timestamp;
+            return TOPIC_READ_NEW;
+        }
+    }
+
+    return TOPIC_READ_BUSY;
+}
+
+// Whether a read would take a new snapshot, without copying the value
+static inline bool topicHasNew(const topic_t *topic, const topicSubscriber_t *subscriber)
+{
+    return (topic->sequence & ~1) != subscriber->sequence;
+}
+
+static inline uint32_t topicPublishCount(const topic_t *topic)
+{
+    return topic->sequence >> 1;
+}
+
+// The topic is declared again at the end, so the macro takes the semicolon after it like a declaration does
+#define TOPIC_DECLARE(name, type) \
+    extern topic_t name##Topic; \
+    static inline void name##Publish(const type *value, timeUs_t currentTimeUs) \
+    { \
+        topicPublish(&name##Topic, value, currentTimeUs); \
+    } \
+    static inline topicReadResult_e name##Read(type *value, topicSubscriber_t *subscriber) \
+    { \
+        return topicRead(&name##Topic, value, subscriber); \
+    } \
+    static inline bool name##HasNew(const topicSubscriber_t *subscriber) \
+    { \
+        return topicHasNew(&name##Topic, subscriber); \
+    } \
+    extern topic_t name##Topic
+
+#define TOPIC_DEFINE(name, type) \
+    static type name##TopicValue; \
+    topic_t name##Topic = { .size = sizeof(type), .value = &name##TopicValue }
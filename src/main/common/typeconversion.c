@@ -82,6 +82,77 @@ void i2a(int num, char *bf)
     ui2a(num, 10, 0, bf);
 }
 
+/*
+ * Fixed width decimal formatting for display code, without the cost of the printf engine.
+ * Each function null terminates the string and returns a pointer to the terminator, so further characters can be appended.
+ */
+
+// Right aligned in at least width characters and padded with spaces, like printf's %<width>d
+char *i2aPadded(int num, unsigned width, char *bf)
+{
+    char digits[10];
+    unsigned value = num < 0 ? -(unsigned)num : (unsigned)num;
+    unsigned len = 0;
+
+    do {
+        digits[len++] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+
+    for (unsigned i = len + (num < 0); i < width; i++) {
+        *bf++ = ' ';
+    }
+    if (num < 0) {
+        *bf++ = '-';
+    }
+    while (len) {
+        *bf++ = digits[--len];
+    }
+    *bf = 0;
+
+    return bf;
+}
+
+// At least width digits, padded with zeros, like printf's %0<width>u
+char *ui2aZeroPadded(unsigned num, unsigned width, char *bf)
+{
+    char digits[10];
+    unsigned len = 0;
+
+    do {
+        digits[len++] = '0' + num % 10;
+        num /= 10;
+    } while (num);
+
+    for (unsigned i = len; i < width; i++) {
+        *bf++ = '0';
+    }
+    while (len) {
+        *bf++ = digits[--len];
+    }
+    *bf = 0;
+
+    return bf;
+}
+
+// num / 10^decimals with a fixed decimal point, the integer part right aligned in at least intWidth characters,
+// e.g. 1234 with 2 decimals and an intWidth of 3 gives " 12.34"
+char *ufixed2a(unsigned num, unsigned decimals, unsigned intWidth, char *bf)
+{
+    unsigned scale = 1;
+    for (unsigned i = 0; i < decimals; i++) {
+        scale *= 10;
+    }
+
+    bf = i2aPadded(num / scale, intWidth, bf);
+    if (decimals) {
+        *bf++ = '.';
+        bf = ui2aZeroPadded(num % scale, decimals, bf);
+    }
+
+    return bf;
+}
+
 int a2d(char ch)
 {
     if (ch >= '0' && ch <= '9')
@@ -26,6 +26,9 @@ void uli2a(unsigned long int num, unsigned int base, int uc, char *bf);
 void li2a(long num, char *bf);
 void ui2a(unsigned int num, unsigned int base, int uc, char *bf);
 void i2a(int num, char *bf);
+char *i2aPadded(int num, unsigned width, char *bf);
+char *ui2aZeroPadded(unsigned num, unsigned width, char *bf);
+char *ufixed2a(unsigned num, unsigned decimals, unsigned intWidth, char *bf);
 char a2i(char ch, const char **src, int base, int *nump);
 char *ftoa(float x, char *floatString);
 float fastA2F(const char *p);
@@ -27,6 +27,7 @@
 #include "build/build_config.h"
 
 #include "common/crc.h"
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "config/config_eeprom.h"
@@ -49,6 +50,7 @@ typedef enum {
 } configRecordFlags_e;
 
 #define CR_CLASSIFICATION_MASK  (0x3)
+#define CR_ELEMENT_DELTAS       (1 << 2)    // the record holds an array PG as element deltas, see below
 #define CRC_START_VALUE         0xFFFF
 #define CRC_CHECK_VALUE         0x1D0F  // pre-calculated value of CRC that includes the CRC itself
 
@@ -58,7 +60,7 @@ typedef struct {
     uint8_t magic_be;           // magic number, should be 0xBE
 } PG_PACKED configHeader_t;
 
-// Header for each stored PG.
+// Header for each stored PG. Each record is followed by its CRC, so that a corrupted record only resets its own PG.
 typedef struct {
     // split up.
     uint16_t size;
@@ -71,11 +73,49 @@ typedef struct {
     uint8_t pg[];
 } PG_PACKED configRecord_t;
 
+/*
+ * Most elements of an array PG, like the PID and rate profiles, are the same as the first one. Unless it comes out
+ * bigger, such a PG is stored as the element size and the first element, followed for each other element by the
+ * count of runs in which it differs from the first one, and the runs.
+ */
+typedef struct {
+    uint16_t elementSize;
+} PG_PACKED elementDeltasHeader_t;
+
+typedef struct {
+    uint16_t offset;
+    uint8_t length;
+    uint8_t data[];
+} PG_PACKED elementDeltaRun_t;
+
+#define ELEMENT_DELTA_RUN_MAX_LENGTH    255
+#define ELEMENT_DELTA_RUN_MAX_COUNT     255
+
 // Footer for the saved copy.
 typedef struct {
     uint16_t terminator;
 } PG_PACKED configFooter_t;
-// checksum is appended just after footer. It is not included in footer to make checksum calculation consistent
+
+#ifdef USE_CONFIG_JOURNAL
+#define CONFIG_WORD_SIZE            4   // The streamer pads the saved copy to a whole flash word
+
+/*
+ * Saves append the PGs that changed to a journal after the stored config, so that most saves program a few words
+ * instead of erasing the config sector. Journal records are stored like the others, padded to a whole flash word;
+ * the latest record of a PG wins. Once the journal is full the config is written out in full again, which compacts
+ * it. A record torn by a power loss fails its CRC and ends the journal.
+ */
+#define CONFIG_JOURNAL_ERASED_SIZE  0xFFFF
+
+static const uint8_t *journalStart;
+static const uint8_t *journalEnd;
+#endif
+
+/*
+ * Where the search for the next record starts. Records are saved in the order of the PG registry, so loading
+ * every PG in that order finds each record at the first try.
+ */
+static const uint8_t *findCursor;
 
 // Used to check the compiler packing at build time.
 typedef struct {
@@ -92,6 +132,30 @@ void initEEPROM(void)
 
     BUILD_BUG_ON(sizeof(configFooter_t) != 2);
     BUILD_BUG_ON(sizeof(configRecord_t) != 6);
+    BUILD_BUG_ON(sizeof(elementDeltaRun_t) != 3);
+}
+
+static uint16_t configRecordStorageSize(uint16_t recordSize)
+{
+    return recordSize + sizeof(uint16_t);
+}
+
+#ifdef USE_CONFIG_JOURNAL
+static uint32_t alignToConfigWord(uint32_t size)
+{
+    return (size + CONFIG_WORD_SIZE - 1) & ~(CONFIG_WORD_SIZE - 1);
+}
+
+static uint16_t journalRecordStorageSize(uint16_t recordSize)
+{
+    return alignToConfigWord(configRecordStorageSize(recordSize));
+}
+#endif
+
+// CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
+static bool isConfigRecordCrcValid(const configRecord_t *record)
+{
+    return crc16_ccitt_update(CRC_START_VALUE, record, configRecordStorageSize(record->size)) == CRC_CHECK_VALUE;
 }
 
 bool isEEPROMVersionValid(void)
@@ -106,7 +170,7 @@ bool isEEPROMVersionValid(void)
     return true;
 }
 
-// Scan the EEPROM config. Returns true if the config is valid.
+// Scan the EEPROM config. Returns true if the config can be loaded; the records are checked as they're loaded.
 bool isEEPROMStructureValid(void)
 {
     const uint8_t *p = &__config_start;
@@ -116,8 +180,6 @@ bool isEEPROMStructureValid(void)
         return false;
     }
 
-    uint16_t crc = CRC_START_VALUE;
-    crc = crc16_ccitt_update(crc, header, sizeof(*header));
     p += sizeof(*header);
 
     for (;;) {
@@ -127,30 +189,44 @@ bool isEEPROMStructureValid(void)
             // Found the end.  Stop scanning.
             break;
         }
-        if (p + record->size >= &__config_end
+        if (p + configRecordStorageSize(record->size) >= &__config_end
             || record->size < sizeof(*record)) {
             // Too big or too small.
             return false;
         }
 
-        crc = crc16_ccitt_update(crc, p, record->size);
-
-        p += record->size;
+        p += configRecordStorageSize(record->size);
     }
 
-    const configFooter_t *footer = (const configFooter_t *)p;
-    crc = crc16_ccitt_update(crc, footer, sizeof(*footer));
-    p += sizeof(*footer);
-
-    // include stored CRC in the CRC calculation
-    const uint16_t *storedCrc = (const uint16_t *)p;
-    crc = crc16_ccitt_update(crc, storedCrc, sizeof(*storedCrc));
-    p += sizeof(storedCrc);
+    p += sizeof(configFooter_t);
 
     eepromConfigSize = p - &__config_start;
+    findCursor = NULL;
+
+#ifdef USE_CONFIG_JOURNAL
+    p = &__config_start + alignToConfigWord(eepromConfigSize);
+    journalStart = p;
 
-    // CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
-    return crc == CRC_CHECK_VALUE;
+    while (p + sizeof(configRecord_t) <= &__config_end) {
+        const configRecord_t *record = (const configRecord_t *)p;
+
+        if (record->size == CONFIG_JOURNAL_ERASED_SIZE
+            || record->size < sizeof(*record)
+            || p + journalRecordStorageSize(record->size) > &__config_end
+            || !isConfigRecordCrcValid(record)) {
+            break;
+        }
+
+        p += journalRecordStorageSize(record->size);
+    }
+
+    journalEnd = p;
+    if (journalEnd > journalStart) {
+        eepromConfigSize = journalEnd - &__config_start;
+    }
+#endif
+
+    return true;
 }
 
 uint16_t getEEPROMConfigSize(void)
@@ -163,53 +239,301 @@ uint16_t getEEPROMConfigSize(void)
 // this function assumes that EEPROM content is valid
 static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFlags_e classification)
 {
-    const uint8_t *p = &__config_start;
-    p += sizeof(configHeader_t);             // skip header
-    while (true) {
+    const configRecord_t *found = NULL;
+    const uint8_t *first = &__config_start + sizeof(configHeader_t);   // skip header
+    const uint8_t *from = findCursor ? findCursor : first;
+    const uint8_t *p = from;
+    bool wrapped = false;
+
+    // Search from the cursor to the end, then from the first record up to the cursor
+    while (!wrapped || p < from) {
         const configRecord_t *record = (const configRecord_t *)p;
         if (record->size == 0
-            || p + record->size >= &__config_end
-            || record->size < sizeof(*record))
+            || p + configRecordStorageSize(record->size) >= &__config_end
+            || record->size < sizeof(*record)) {
+            if (wrapped || from == first) {
+                break;
+            }
+            wrapped = true;
+            p = first;
+            continue;
+        }
+        p += configRecordStorageSize(record->size);
+        if (pgN(reg) == record->pgn
+            && (record->flags & CR_CLASSIFICATION_MASK) == classification) {
+            found = record;
+            findCursor = p;
             break;
+        }
+    }
+
+#ifdef USE_CONFIG_JOURNAL
+    // A later copy in the journal replaces the stored one
+    for (p = journalStart; p && p < journalEnd; ) {
+        const configRecord_t *record = (const configRecord_t *)p;
         if (pgN(reg) == record->pgn
-            && (record->flags & CR_CLASSIFICATION_MASK) == classification)
-            return record;
-        p += record->size;
+            && (record->flags & CR_CLASSIFICATION_MASK) == classification) {
+            found = record;
+        }
+        p += journalRecordStorageSize(record->size);
+    }
+#endif
+
+    return found;
+}
+
+// Rebuild an array PG from its first element and the deltas of the others, like pgLoad does from a whole copy
+static bool loadElementDeltas(const pgRegistry_t *reg, const configRecord_t *record)
+{
+    const uint8_t *p = record->pg;
+    const uint8_t *end = (const uint8_t *)record + record->size;
+
+    if (p + sizeof(elementDeltasHeader_t) > end) {
+        pgReset(reg);
+        return false;
+    }
+    const uint16_t elementSize = ((const elementDeltasHeader_t *)p)->elementSize;
+    p += sizeof(elementDeltasHeader_t);
+    if (elementSize == 0 || p + elementSize > end) {
+        pgReset(reg);
+        return false;
     }
-    // record not found
-    return NULL;
+
+    // resets the PG, then takes the first element if the version matches
+    if (!pgLoad(reg, p, elementSize, record->version)) {
+        return false;
+    }
+    p += elementSize;
+
+    // The elements are placed as they were stored, as if the whole copy had been loaded
+    uint8_t *base = reg->address;
+    const int regSize = pgSize(reg);
+    for (int elementOffset = elementSize; p < end; elementOffset += elementSize) {
+        if (elementOffset < regSize) {
+            memcpy(base + elementOffset, base, MIN(elementSize, regSize - elementOffset));
+        }
+
+        const uint8_t runCount = *p++;
+        for (int i = 0; i < runCount; i++) {
+            const elementDeltaRun_t *run = (const elementDeltaRun_t *)p;
+            if (p + sizeof(*run) > end || p + sizeof(*run) + run->length > end || run->offset + run->length > elementSize) {
+                pgReset(reg);
+                return false;
+            }
+
+            const int offset = elementOffset + run->offset;
+            if (offset < regSize) {
+                memcpy(base + offset, run->data, MIN(run->length, regSize - offset));
+            }
+            p += sizeof(*run) + run->length;
+        }
+    }
+
+    return true;
+}
+
+static bool loadConfigRecord(const pgRegistry_t *reg, const configRecord_t *record)
+{
+    if (record->flags & CR_ELEMENT_DELTAS) {
+        return loadElementDeltas(reg, record);
+    }
+
+    // pgLoad will handle version mismatch
+    return pgLoad(reg, record->pg, record->size - offsetof(configRecord_t, pg), record->version);
 }
 
 // Initialize all PG records from EEPROM.
-// This functions processes all PGs sequentially, scanning EEPROM for each one. This is suboptimal,
-//   but each PG is loaded/initialized exactly once and in defined order.
+// This functions processes all PGs sequentially, in the order they were saved in. A PG whose record is corrupted is
+//   reset on its own, a PG that has no record fails the load.
 bool loadEEPROM(void)
 {
     bool success = true;
 
     PG_FOREACH(reg) {
         const configRecord_t *rec = findEEPROM(reg, CR_CLASSICATION_SYSTEM);
-        if (rec) {
-            // config from EEPROM is available, use it to initialize PG. pgLoad will handle version mismatch
-            if (!pgLoad(reg, rec->pg, rec->size - offsetof(configRecord_t, pg), rec->version)) {
+        if (rec && isConfigRecordCrcValid(rec)) {
+            // config from EEPROM is available, use it to initialize PG
+            if (!loadConfigRecord(reg, rec)) {
                 success = false;
             }
         } else {
             pgReset(reg);
 
-            success = false;
+            if (!rec) {
+                success = false;
+            }
         }
     }
 
     return success;
 }
 
+// Check that every PG has a record that is intact, e.g. after writing the config
+static bool isEEPROMContentValid(void)
+{
+    PG_FOREACH(reg) {
+        const configRecord_t *rec = findEEPROM(reg, CR_CLASSICATION_SYSTEM);
+        if (!rec || !isConfigRecordCrcValid(rec)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Where a record goes: the streamer when saving, nowhere when it is only measured, or compared with a stored record
+typedef struct recordSink_s {
+    config_streamer_t *streamer;
+    uint16_t crc;
+    const uint8_t *stored;
+    uint16_t storedSize;
+    bool differs;
+    uint16_t size;
+} recordSink_t;
+
+static void recordSinkWrite(recordSink_t *sink, const void *data, uint16_t length)
+{
+    if (sink->streamer) {
+        config_streamer_write(sink->streamer, data, length);
+        sink->crc = crc16_ccitt_update(sink->crc, data, length);
+    }
+    if (sink->stored && !sink->differs) {
+        sink->differs = sink->size + length > sink->storedSize || memcmp(sink->stored + sink->size, data, length) != 0;
+    }
+    sink->size += length;
+}
+
+// A gap of equal bytes shorter than a run header is cheaper to carry in the run than to start a new one
+static int elementDeltaRunEnd(const uint8_t *element, const uint8_t *first, int start, int elementSize)
+{
+    int end = start + 1;
+    int equalCount = 0;
+    while (end + equalCount < elementSize && end + equalCount - start < ELEMENT_DELTA_RUN_MAX_LENGTH) {
+        if (element[end + equalCount] != first[end + equalCount]) {
+            end += equalCount + 1;
+            equalCount = 0;
+        } else if (++equalCount >= (int)sizeof(elementDeltaRun_t)) {
+            break;
+        }
+    }
+    return end;
+}
+
+// Write the runs in which an element differs from the first one, or only count them without a sink
+static int writeElementDeltaRuns(recordSink_t *sink, const uint8_t *element, const uint8_t *first, int elementSize)
+{
+    int runCount = 0;
+    for (int offset = 0; offset < elementSize; ) {
+        if (element[offset] == first[offset]) {
+            offset++;
+            continue;
+        }
+
+        const int end = elementDeltaRunEnd(element, first, offset, elementSize);
+        if (sink) {
+            const elementDeltaRun_t run = {
+                .offset = offset,
+                .length = end - offset,
+            };
+            recordSinkWrite(sink, &run, sizeof(run));
+            recordSinkWrite(sink, &element[offset], run.length);
+        }
+        runCount++;
+        offset = end;
+    }
+    return runCount;
+}
+
+// Returns false if an element differs from the first one in too many runs
+static bool writeElementDeltas(recordSink_t *sink, const pgRegistry_t *reg)
+{
+    const int elementSize = reg->elementSize;
+    const uint8_t *first = reg->address;
+
+    const elementDeltasHeader_t header = {
+        .elementSize = elementSize,
+    };
+    recordSinkWrite(sink, &header, sizeof(header));
+    recordSinkWrite(sink, first, elementSize);
+
+    for (int elementOffset = elementSize; elementOffset + elementSize <= pgSize(reg); elementOffset += elementSize) {
+        const uint8_t *element = first + elementOffset;
+        const int runCount = writeElementDeltaRuns(NULL, element, first, elementSize);
+        if (runCount > ELEMENT_DELTA_RUN_MAX_COUNT) {
+            return false;
+        }
+
+        const uint8_t storedRunCount = runCount;
+        recordSinkWrite(sink, &storedRunCount, sizeof(storedRunCount));
+        writeElementDeltaRuns(sink, element, first, elementSize);
+    }
+
+    return true;
+}
+
+static bool useElementDeltas(const pgRegistry_t *reg)
+{
+    if (!reg->elementSize || pgSize(reg) < 2 * reg->elementSize) {
+        return false;
+    }
+
+    recordSink_t sink = { 0 };
+    return writeElementDeltas(&sink, reg) && sink.size < pgSize(reg);
+}
+
+static void writeConfigRecordPayload(recordSink_t *sink, const pgRegistry_t *reg, bool elementDeltas)
+{
+    if (elementDeltas) {
+        writeElementDeltas(sink, reg);
+    } else {
+        recordSinkWrite(sink, reg->address, pgSize(reg));
+    }
+}
+
+static uint16_t configRecordSize(const pgRegistry_t *reg, bool elementDeltas)
+{
+    recordSink_t sink = { 0 };
+    writeConfigRecordPayload(&sink, reg, elementDeltas);
+    return sizeof(configRecord_t) + sink.size;
+}
+
+// Stream the record of a PG, followed by its CRC. Returns the size of the record.
+static uint16_t writeConfigRecord(config_streamer_t *streamer, const pgRegistry_t *reg)
+{
+    const bool elementDeltas = useElementDeltas(reg);
+    configRecord_t record = {
+        .size = configRecordSize(reg, elementDeltas),
+        .pgn = pgN(reg),
+        .version = pgVersion(reg),
+        .flags = 0
+    };
+
+    record.flags |= CR_CLASSICATION_SYSTEM;
+    if (elementDeltas) {
+        record.flags |= CR_ELEMENT_DELTAS;
+    }
+
+    recordSink_t sink = {
+        .streamer = streamer,
+        .crc = CRC_START_VALUE,
+    };
+    recordSinkWrite(&sink, &record, sizeof(record));
+    writeConfigRecordPayload(&sink, reg, elementDeltas);
+
+    // include inverted CRC in big endian format in the CRC
+    const uint16_t invertedBigEndianCrc = ~(((sink.crc & 0xFF) << 8) | (sink.crc >> 8));
+    config_streamer_write(streamer, (uint8_t *)&invertedBigEndianCrc, sizeof(sink.crc));
+
+    return record.size;
+}
+
 static bool writeSettingsToEEPROM(void)
 {
     config_streamer_t streamer;
     config_streamer_init(&streamer);
 
     config_streamer_start(&streamer, (uintptr_t)&__config_start, &__config_end - &__config_start);
+    findCursor = NULL;
 
     configHeader_t header = {
         .eepromConfigVersion =  EEPROM_CONF_VERSION,
@@ -217,22 +541,8 @@ static bool writeSettingsToEEPROM(void)
     };
 
     config_streamer_write(&streamer, (uint8_t *)&header, sizeof(header));
-    uint16_t crc = CRC_START_VALUE;
-    crc = crc16_ccitt_update(crc, (uint8_t *)&header, sizeof(header));
     PG_FOREACH(reg) {
-        const uint16_t regSize = pgSize(reg);
-        configRecord_t record = {
-            .size = sizeof(configRecord_t) + regSize,
-            .pgn = pgN(reg),
-            .version = pgVersion(reg),
-            .flags = 0
-        };
-
-        record.flags |= CR_CLASSICATION_SYSTEM;
-        config_streamer_write(&streamer, (uint8_t *)&record, sizeof(record));
-        crc = crc16_ccitt_update(crc, (uint8_t *)&record, sizeof(record));
-        config_streamer_write(&streamer, reg->address, regSize);
-        crc = crc16_ccitt_update(crc, reg->address, regSize);
+        writeConfigRecord(&streamer, reg);
     }
 
     configFooter_t footer = {
@@ -240,11 +550,6 @@ static bool writeSettingsToEEPROM(void)
     };
 
     config_streamer_write(&streamer, (uint8_t *)&footer, sizeof(footer));
-    crc = crc16_ccitt_update(crc, (uint8_t *)&footer, sizeof(footer));
-
-    // include inverted CRC in big endian format in the CRC
-    const uint16_t invertedBigEndianCrc = ~(((crc & 0xFF) << 8) | (crc >> 8));
-    config_streamer_write(&streamer, (uint8_t *)&invertedBigEndianCrc, sizeof(crc));
 
     config_streamer_flush(&streamer);
 
@@ -253,8 +558,94 @@ static bool writeSettingsToEEPROM(void)
     return success;
 }
 
+#ifdef USE_CONFIG_JOURNAL
+static bool pgChangedSinceSave(const pgRegistry_t *reg)
+{
+    const configRecord_t *rec = findEEPROM(reg, CR_CLASSICATION_SYSTEM);
+    const bool elementDeltas = useElementDeltas(reg);
+
+    if (!rec
+        || !isConfigRecordCrcValid(rec)
+        || rec->version != pgVersion(reg)
+        || !(rec->flags & CR_ELEMENT_DELTAS) != !elementDeltas) {
+        return true;
+    }
+
+    recordSink_t sink = {
+        .stored = rec->pg,
+        .storedSize = rec->size - sizeof(configRecord_t),
+    };
+    writeConfigRecordPayload(&sink, reg, elementDeltas);
+
+    return sink.differs || sink.size != sink.storedSize;
+}
+
+// Append the PGs that changed since the last save to the journal. Returns false if the config has to be written in full.
+static bool writeChangesToJournal(void)
+{
+    if (!journalStart) {
+        return false;
+    }
+
+    uint32_t journalSize = 0;
+    PG_FOREACH(reg) {
+        if (pgChangedSinceSave(reg)) {
+            journalSize += journalRecordStorageSize(configRecordSize(reg, useElementDeltas(reg)));
+        }
+    }
+
+    if (journalSize == 0) {
+        // Nothing to save
+        return true;
+    }
+
+    if (journalEnd + journalSize > &__config_end) {
+        return false;
+    }
+
+    // A torn record is followed by programmed bytes, they can't be written again without an erase
+    for (const uint8_t *p = journalEnd; p < journalEnd + journalSize; p++) {
+        if (*p != 0xFF) {
+            return false;
+        }
+    }
+
+    config_streamer_t streamer;
+    config_streamer_init(&streamer);
+
+    config_streamer_start(&streamer, (uintptr_t)journalEnd, journalSize);
+
+    PG_FOREACH(reg) {
+        if (!pgChangedSinceSave(reg)) {
+            continue;
+        }
+
+        const uint16_t recordSize = writeConfigRecord(&streamer, reg);
+
+        static const uint8_t padding[CONFIG_WORD_SIZE];
+        config_streamer_write(&streamer, padding, journalRecordStorageSize(recordSize) - configRecordStorageSize(recordSize));
+    }
+
+    config_streamer_flush(&streamer);
+
+    if (config_streamer_finish(&streamer) != 0) {
+        return false;
+    }
+
+    // Every record must read back, or the config is written in full
+    const uint8_t *expectedEnd = journalEnd + journalSize;
+    return isEEPROMStructureValid() && journalEnd == expectedEnd;
+}
+#endif
+
 void writeConfigToEEPROM(void)
 {
+#ifdef USE_CONFIG_JOURNAL
+    if (isEEPROMVersionValid() && isEEPROMStructureValid() && writeChangesToJournal()) {
+        return;
+    }
+#endif
+
     bool success = false;
     // write it
     for (int attempt = 0; attempt < 3 && !success; attempt++) {
@@ -263,7 +654,7 @@ void writeConfigToEEPROM(void)
         }
     }
 
-    if (success && isEEPROMVersionValid() && isEEPROMStructureValid()) {
+    if (success && isEEPROMVersionValid() && isEEPROMStructureValid() && isEEPROMContentValid()) {
         return;
     }
 
@@ -46,6 +46,8 @@
 #define GYRO_32KHZ_HARDWARE_LPF_NORMAL       0
 #define GYRO_32KHZ_HARDWARE_LPF_EXPERIMENTAL 1
 
+#define GYRO_FIFO_MAX_SAMPLES 8
+
 typedef enum {
     GYRO_RATE_1_kHz,
     GYRO_RATE_1100_Hz,
@@ -55,6 +57,19 @@ typedef enum {
     GYRO_RATE_32_kHz,
 } gyroRateKHz_e;
 
+#ifdef USE_GYRO_ODR_TRACKING
+// Phase locked estimate of the data ready interrupts of the gyro, its clock drifts against the MCU clock
+typedef struct gyroOdrTracker_s {
+    timeUs_t dataReadyAtUs;                                 // of the last data ready taken into the estimate
+    uint32_t dataReadyCount;
+    float phaseOffsetUs;                                    // estimated time of that data ready, relative to dataReadyAtUs
+    float periodUs;                                         // estimated time between data ready interrupts, in MCU time
+    float nominalPeriodUs;
+    uint16_t lockedCount;                                   // updates since the estimate last lost the data ready edges
+    bool started;
+} gyroOdrTracker_t;
+#endif
+
 typedef struct gyroDev_s {
 #if defined(SIMULATOR_BUILD) && defined(SIMULATOR_MULTITHREAD)
     pthread_mutex_t lock;
@@ -62,15 +77,24 @@ typedef struct gyroDev_s {
     sensorGyroInitFuncPtr initFn;                             // initialize function
     sensorGyroReadFuncPtr readFn;                             // read 3 axis data function
     sensorGyroReadDataFuncPtr temperatureFn;                  // read temperature if available
+    sensorGyroDataReadyFuncPtr dataReadyFn;                   // called from the data ready interrupt if set
     extiCallbackRec_t exti;
     busDevice_t bus;
     float scale;                                            // scalefactor
+    volatile timeUs_t dataReadyAtUs;                        // time of the last data ready interrupt
+    volatile uint32_t dataReadyCount;                       // data ready interrupts so far
+#ifdef USE_GYRO_ODR_TRACKING
+    gyroOdrTracker_t odrTracker;
+#endif
     float gyroZero[XYZ_AXIS_COUNT];
     float gyroADC[XYZ_AXIS_COUNT];                        // gyro data after calibration and alignment
     float gyroADCf[XYZ_AXIS_COUNT];
     int32_t gyroADCRawPrevious[XYZ_AXIS_COUNT];
     int16_t gyroADCRaw[XYZ_AXIS_COUNT];
     int16_t temperature;
+#ifdef USE_GYRO_FIFO
+    int16_t fifoADCRaw[GYRO_FIFO_MAX_SAMPLES][XYZ_AXIS_COUNT]; // samples of the last FIFO read, oldest first
+#endif
     mpuConfiguration_t mpuConfiguration;
     mpuDetectionResult_t mpuDetectionResult;
     sensor_align_e gyroAlign;
@@ -80,6 +104,11 @@ typedef struct gyroDev_s {
     uint8_t hardware_lpf;
     uint8_t hardware_32khz_lpf;
     uint8_t mpuDividerDrops;
+#ifdef USE_GYRO_FIFO
+    uint8_t fifoSampleCount;
+    bool useFifo;                                           // set before initFn to request FIFO reads
+    bool fifoEnabled;                                       // set by initFn if the driver reads the FIFO
+#endif
     ioTag_t mpuIntExtiTag;
     uint8_t gyroHasOverflowProtection;
     gyroSensor_e gyroHardware;
@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <math.h>
 #include <string.h>
 
 #include "platform.h"
@@ -28,6 +29,7 @@
 #include "build/atomic.h"
 #include "build/build_config.h"
 #include "build/debug.h"
+#include "build/trace.h"
 
 #include "common/maths.h"
 #include "common/utils.h"
@@ -53,6 +55,8 @@
 #include "drivers/accgyro/accgyro_spi_mpu6500.h"
 #include "drivers/accgyro/accgyro_spi_mpu9250.h"
 #include "drivers/accgyro/accgyro_mpu.h"
+#include "drivers/accgyro/accgyro_spi_dma.h"
+#include "drivers/accgyro/gyro_sync.h"
 
 mpuResetFnPtr mpuResetFn;
 
@@ -108,6 +112,7 @@ static void mpu6050FindRevision(gyroDev_t *gyro)
 #if defined(MPU_INT_EXTI)
 static void mpuIntExtiHandler(extiCallbackRec_t *cb)
 {
+    TRACE_EVENT(TRACE_ISR_ENTER, TRACE_ISR_GYRO_EXTI, 0);
 #ifdef DEBUG_MPU_DATA_READY_INTERRUPT
     static uint32_t lastCalledAtUs = 0;
     const uint32_t nowUs = micros();
@@ -115,11 +120,23 @@ static void mpuIntExtiHandler(extiCallbackRec_t *cb)
     lastCalledAtUs = nowUs;
 #endif
     gyroDev_t *gyro = container_of(cb, gyroDev_t, exti);
+    gyroSyncDataReady(gyro, micros());
+#ifdef USE_GYRO_SPI_DMA
+    if (gyroSpiDmaStartRead(gyro)) {
+        // dataReady is set when the transfer completes
+        TRACE_EVENT(TRACE_ISR_EXIT, TRACE_ISR_GYRO_EXTI, 0);
+        return;
+    }
+#endif
     gyro->dataReady = true;
+    if (gyro->dataReadyFn) {
+        gyro->dataReadyFn();
+    }
 #ifdef DEBUG_MPU_DATA_READY_INTERRUPT
     const uint32_t now2Us = micros();
     debug[1] = (uint16_t)(now2Us - nowUs);
 #endif
+    TRACE_EVENT(TRACE_ISR_EXIT, TRACE_ISR_GYRO_EXTI, 0);
 }
 
 static void mpuIntExtiInit(gyroDev_t *gyro)
@@ -152,10 +169,55 @@ static void mpuIntExtiInit(gyroDev_t *gyro)
 }
 #endif // MPU_INT_EXTI
 
+#ifdef USE_GYRO_SPI_DMA
+// DMA reads burst read the accelerometer, temperature and gyro registers
+#define MPU_DMA_READ_LENGTH     14
+#define MPU_DMA_GYRO_OFFSET     8
+// the sum restarts if the accelerometer is not read for this many gyro samples
+#define MPU_DMA_ACC_MAX_SAMPLES 64
+
+// accelerometer samples accumulated by the gyro reads, averaged by the next accelerometer read
+static int32_t dmaAccSum[XYZ_AXIS_COUNT];
+static uint8_t dmaAccSampleCount;
+// chip select of the sensor the accelerometer is read from, only its gyro reads are accumulated when both gyros use DMA
+static IO_t dmaAccCsnPin;
+#endif
+
 bool mpuAccRead(accDev_t *acc)
 {
     uint8_t data[6];
 
+#ifdef USE_GYRO_SPI_DMA
+    if (gyroSpiDmaIsActive(&acc->bus)) {
+        // the accelerometer shares the gyro DMA read, the bus must not be used directly
+        dmaAccCsnPin = acc->bus.busdev_u.spi.csnPin;
+        int32_t sum[XYZ_AXIS_COUNT];
+        uint8_t sampleCount;
+        ATOMIC_BLOCK(NVIC_PRIO_GYRO_PID_SWI) {
+            memcpy(sum, dmaAccSum, sizeof(sum));
+            sampleCount = dmaAccSampleCount;
+            memset(dmaAccSum, 0, sizeof(dmaAccSum));
+            dmaAccSampleCount = 0;
+        }
+
+        if (sampleCount) {
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                acc->ADCRaw[axis] = sum[axis] / sampleCount;
+            }
+            return true;
+        }
+
+        // no gyro read since the last call, use the latest sample
+        if (!gyroSpiDmaReadSample(&acc->bus, data, sizeof(data))) {
+            return false;
+        }
+        acc->ADCRaw[X] = (int16_t)((data[0] << 8) | data[1]);
+        acc->ADCRaw[Y] = (int16_t)((data[2] << 8) | data[3]);
+        acc->ADCRaw[Z] = (int16_t)((data[4] << 8) | data[5]);
+        return true;
+    }
+#endif
+
     const bool ack = busReadRegisterBuffer(&acc->bus, MPU_RA_ACCEL_XOUT_H, data, 6);
     if (!ack) {
         return false;
@@ -201,6 +263,113 @@ bool mpuGyroReadSPI(gyroDev_t *gyro)
     return true;
 }
 
+#ifdef USE_GYRO_FIFO
+// The FIFO holds the gyro axes only, so each sample is 6 bytes
+#define MPU_FIFO_SAMPLE_SIZE        6
+#define MPU_FIFO_EN_GYRO_XYZ        0x70
+#define MPU_USER_CTRL_FIFO_EN       0x40
+#define MPU_USER_CTRL_FIFO_RST      0x04
+
+static void mpuGyroFifoReset(gyroDev_t *gyro)
+{
+    const uint8_t userCtrl = spiBusReadRegister(&gyro->bus, MPU_RA_USER_CTRL);
+    spiBusWriteRegister(&gyro->bus, MPU_RA_USER_CTRL, userCtrl | MPU_USER_CTRL_FIFO_EN | MPU_USER_CTRL_FIFO_RST);
+}
+
+/*
+ * Reads all the samples collected since the last call in a single burst,
+ * so oversampling the gyro costs one bus transaction per loop rather than per sample.
+ */
+static bool mpuGyroReadFifoSPI(gyroDev_t *gyro)
+{
+    uint8_t data[GYRO_FIFO_MAX_SAMPLES * MPU_FIFO_SAMPLE_SIZE];
+
+    if (!spiBusReadRegisterBuffer(&gyro->bus, MPU_RA_FIFO_COUNTH, data, 2)) {
+        return false;
+    }
+    const uint16_t fifoCount = (data[0] << 8) | data[1];
+    if (fifoCount % MPU_FIFO_SAMPLE_SIZE) {
+        // out of step with the sample boundaries, most likely after a FIFO overflow
+        mpuGyroFifoReset(gyro);
+        return false;
+    }
+    const uint8_t sampleCount = MIN(fifoCount / MPU_FIFO_SAMPLE_SIZE, GYRO_FIFO_MAX_SAMPLES);
+    if (sampleCount == 0) {
+        return false;
+    }
+    if (!spiBusReadRegisterBuffer(&gyro->bus, MPU_RA_FIFO_R_W, data, sampleCount * MPU_FIFO_SAMPLE_SIZE)) {
+        return false;
+    }
+    if (fifoCount > GYRO_FIFO_MAX_SAMPLES * MPU_FIFO_SAMPLE_SIZE) {
+        // fallen behind, drop the backlog rather than let latency build up
+        mpuGyroFifoReset(gyro);
+    }
+
+    for (int i = 0; i < sampleCount; i++) {
+        const uint8_t *sample = &data[i * MPU_FIFO_SAMPLE_SIZE];
+        gyro->fifoADCRaw[i][X] = (int16_t)((sample[0] << 8) | sample[1]);
+        gyro->fifoADCRaw[i][Y] = (int16_t)((sample[2] << 8) | sample[3]);
+        gyro->fifoADCRaw[i][Z] = (int16_t)((sample[4] << 8) | sample[5]);
+    }
+    gyro->fifoSampleCount = sampleCount;
+
+    // gyroADCRaw holds the latest sample, as for non FIFO reads
+    gyro->gyroADCRaw[X] = gyro->fifoADCRaw[sampleCount - 1][X];
+    gyro->gyroADCRaw[Y] = gyro->fifoADCRaw[sampleCount - 1][Y];
+    gyro->gyroADCRaw[Z] = gyro->fifoADCRaw[sampleCount - 1][Z];
+
+    return true;
+}
+
+// Called at the end of the driver initialisation, once the sample rate is configured
+void mpuGyroFifoInit(gyroDev_t *gyro)
+{
+    if (!gyro->useFifo || gyro->bus.bustype != BUSTYPE_SPI) {
+        return;
+    }
+
+    spiBusWriteRegister(&gyro->bus, MPU_RA_FIFO_EN, MPU_FIFO_EN_GYRO_XYZ);
+    mpuGyroFifoReset(gyro);
+
+    gyro->readFn = mpuGyroReadFifoSPI;
+    gyro->fifoEnabled = true;
+}
+#endif
+
+#ifdef USE_GYRO_SPI_DMA
+static bool mpuGyroReadSpiDma(gyroDev_t *gyro)
+{
+    if (!gyroSpiDmaIsActive(&gyro->bus)) {
+        // DMA reads start once all sensors are configured
+        return mpuGyroReadSPI(gyro);
+    }
+
+    uint8_t data[MPU_DMA_READ_LENGTH];
+    if (!gyroSpiDmaReadSample(&gyro->bus, data, MPU_DMA_READ_LENGTH)) {
+        return false;
+    }
+
+    gyro->gyroADCRaw[X] = (int16_t)((data[MPU_DMA_GYRO_OFFSET + 0] << 8) | data[MPU_DMA_GYRO_OFFSET + 1]);
+    gyro->gyroADCRaw[Y] = (int16_t)((data[MPU_DMA_GYRO_OFFSET + 2] << 8) | data[MPU_DMA_GYRO_OFFSET + 3]);
+    gyro->gyroADCRaw[Z] = (int16_t)((data[MPU_DMA_GYRO_OFFSET + 4] << 8) | data[MPU_DMA_GYRO_OFFSET + 5]);
+
+    // the accelerometer data was read in the same transfer, accumulate it for mpuAccRead()
+    if (gyro->bus.busdev_u.spi.csnPin != dmaAccCsnPin) {
+        return true;
+    }
+    if (dmaAccSampleCount >= MPU_DMA_ACC_MAX_SAMPLES) {
+        memset(dmaAccSum, 0, sizeof(dmaAccSum));
+        dmaAccSampleCount = 0;
+    }
+    dmaAccSum[X] += (int16_t)((data[0] << 8) | data[1]);
+    dmaAccSum[Y] += (int16_t)((data[2] << 8) | data[3]);
+    dmaAccSum[Z] += (int16_t)((data[4] << 8) | data[5]);
+    dmaAccSampleCount++;
+
+    return true;
+}
+#endif
+
 #ifdef USE_SPI
 static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro)
 {
@@ -216,7 +385,7 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro)
     spiBusSetInstance(&gyro->bus, MPU6000_SPI_INSTANCE);
 #endif
 #ifdef MPU6000_CS_PIN
-    gyro->bus.busdev_u.spi.csnPin = gyro->bus.busdev_u.spi.csnPin == IO_NONE ? IOGetByTag(IO_TAG(MPU6000_CS_PIN)) : gyro->bus.busdev_u.spi.csnPin;
+    spiBusSetCsPin(&gyro->bus, gyro->bus.busdev_u.spi.csnPin == IO_NONE ? IOGetByTag(IO_TAG(MPU6000_CS_PIN)) : gyro->bus.busdev_u.spi.csnPin);
 #endif
     sensor = mpu6000SpiDetect(&gyro->bus);
     if (sensor != MPU_NONE) {
@@ -230,7 +399,7 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro)
     spiBusSetInstance(&gyro->bus, MPU6500_SPI_INSTANCE);
 #endif
 #ifdef MPU6500_CS_PIN
-    gyro->bus.busdev_u.spi.csnPin = gyro->bus.busdev_u.spi.csnPin == IO_NONE ? IOGetByTag(IO_TAG(MPU6500_CS_PIN)) : gyro->bus.busdev_u.spi.csnPin;
+    spiBusSetCsPin(&gyro->bus, gyro->bus.busdev_u.spi.csnPin == IO_NONE ? IOGetByTag(IO_TAG(MPU6500_CS_PIN)) : gyro->bus.busdev_u.spi.csnPin);
 #endif
     sensor = mpu6500SpiDetect(&gyro->bus);
     // some targets using MPU_9250_SPI, ICM_20608_SPI or ICM_20602_SPI state sensor is MPU_65xx_SPI
@@ -245,7 +414,7 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro)
     spiBusSetInstance(&gyro->bus, MPU9250_SPI_INSTANCE);
 #endif
 #ifdef MPU9250_CS_PIN
-    gyro->bus.busdev_u.spi.csnPin = gyro->bus.busdev_u.spi.csnPin == IO_NONE ? IOGetByTag(IO_TAG(MPU9250_CS_PIN)) : gyro->bus.busdev_u.spi.csnPin;
+    spiBusSetCsPin(&gyro->bus, gyro->bus.busdev_u.spi.csnPin == IO_NONE ? IOGetByTag(IO_TAG(MPU9250_CS_PIN)) : gyro->bus.busdev_u.spi.csnPin);
 #endif
     sensor = mpu9250SpiDetect(&gyro->bus);
     if (sensor != MPU_NONE) {
@@ -260,7 +429,7 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro)
     spiBusSetInstance(&gyro->bus, ICM20649_SPI_INSTANCE);
 #endif
 #ifdef ICM20649_CS_PIN
-    gyro->bus.busdev_u.spi.csnPin = gyro->bus.busdev_u.spi.csnPin == IO_NONE ? IOGetByTag(IO_TAG(ICM20649_CS_PIN)) : gyro->bus.busdev_u.spi.csnPin;
+    spiBusSetCsPin(&gyro->bus, gyro->bus.busdev_u.spi.csnPin == IO_NONE ? IOGetByTag(IO_TAG(ICM20649_CS_PIN)) : gyro->bus.busdev_u.spi.csnPin);
 #endif
     sensor = icm20649SpiDetect(&gyro->bus);
     if (sensor != MPU_NONE) {
@@ -274,7 +443,7 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro)
     spiBusSetInstance(&gyro->bus, ICM20689_SPI_INSTANCE);
 #endif
 #ifdef ICM20689_CS_PIN
-    gyro->bus.busdev_u.spi.csnPin = gyro->bus.busdev_u.spi.csnPin == IO_NONE ? IOGetByTag(IO_TAG(ICM20689_CS_PIN)) : gyro->bus.busdev_u.spi.csnPin;
+    spiBusSetCsPin(&gyro->bus, gyro->bus.busdev_u.spi.csnPin == IO_NONE ? IOGetByTag(IO_TAG(ICM20689_CS_PIN)) : gyro->bus.busdev_u.spi.csnPin);
 #endif
     sensor = icm20689SpiDetect(&gyro->bus);
     // icm20689SpiDetect detects ICM20602 and ICM20689
@@ -289,7 +458,7 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro)
     spiBusSetInstance(&gyro->bus, BMI160_SPI_INSTANCE);
 #endif
 #ifdef BMI160_CS_PIN
-    gyro->bus.busdev_u.spi.csnPin = gyro->bus.busdev_u.spi.csnPin == IO_NONE ? IOGetByTag(IO_TAG(BMI160_CS_PIN)) : gyro->bus.busdev_u.spi.csnPin;
+    spiBusSetCsPin(&gyro->bus, gyro->bus.busdev_u.spi.csnPin == IO_NONE ? IOGetByTag(IO_TAG(BMI160_CS_PIN)) : gyro->bus.busdev_u.spi.csnPin);
 #endif
     sensor = bmi160Detect(&gyro->bus);
     if (sensor != MPU_NONE) {
@@ -305,7 +474,7 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro)
 void mpuDetect(gyroDev_t *gyro)
 {
     // MPU datasheet specifies 30ms.
-    delay(35);
+    delayUntilUptimeMs(35);
 
 #ifdef USE_I2C
     if (gyro->bus.bustype == BUSTYPE_NONE) {
@@ -348,12 +517,55 @@ void mpuDetect(gyroDev_t *gyro)
 #endif
 }
 
+// Reads the die temperature in degrees C
+static bool mpuReadTemperature(gyroDev_t *gyro, int16_t *temperatureData)
+{
+    uint8_t data[2];
+
+#ifdef USE_GYRO_SPI_DMA
+    if (gyroSpiDmaIsActive(&gyro->bus)) {
+        // the temperature follows the accelerometer in the DMA burst
+        uint8_t sample[MPU_DMA_GYRO_OFFSET];
+        if (!gyroSpiDmaReadSample(&gyro->bus, sample, sizeof(sample))) {
+            return false;
+        }
+        data[0] = sample[6];
+        data[1] = sample[7];
+    } else
+#endif
+    if (!busReadRegisterBuffer(&gyro->bus, MPU_RA_TEMP_OUT_H, data, 2)) {
+        return false;
+    }
+
+    const int16_t raw = (int16_t)((data[0] << 8) | data[1]);
+    switch (gyro->mpuDetectionResult.sensor) {
+    case MPU_60x0:
+    case MPU_60x0_SPI:
+        *temperatureData = lrintf(raw / 340.0f + 36.53f);
+        break;
+    default:
+        *temperatureData = lrintf(raw / 333.87f + 21.0f);
+        break;
+    }
+    return true;
+}
+
 void mpuGyroInit(gyroDev_t *gyro)
 {
+    if (!gyro->temperatureFn) {
+        gyro->temperatureFn = mpuReadTemperature;
+    }
 #ifdef MPU_INT_EXTI
     mpuIntExtiInit(gyro);
-#else
-    UNUSED(gyro);
+#ifdef USE_GYRO_SPI_DMA
+    if (gyro->readFn == mpuGyroReadSPI
+#ifdef USE_GYRO_FIFO
+        && !gyro->useFifo
+#endif
+        && gyroSpiDmaInit(gyro, MPU_RA_ACCEL_XOUT_H, MPU_DMA_READ_LENGTH)) {
+        gyro->readFn = mpuGyroReadSpiDma;
+    }
+#endif
 #endif
 }
 
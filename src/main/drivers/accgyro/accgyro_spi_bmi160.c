@@ -48,6 +48,8 @@
 
 #include "accgyro.h"
 #include "accgyro_spi_bmi160.h"
+#include "accgyro_spi_dma.h"
+#include "gyro_sync.h"
 
 
 /* BMI160 Registers */
@@ -55,6 +57,10 @@
 #define BMI160_REG_PMU_STAT 0x03
 #define BMI160_REG_GYR_DATA_X_LSB 0x0C
 #define BMI160_REG_ACC_DATA_X_LSB 0x12
+
+// DMA reads burst read the gyro then the accelerometer registers
+#define BMI160_DMA_READ_LENGTH 12
+#define BMI160_DMA_ACC_OFFSET 6
 #define BMI160_REG_STATUS 0x1B
 #define BMI160_REG_TEMPERATURE_0 0x20
 #define BMI160_REG_ACC_CONF 0x40
@@ -103,7 +109,7 @@ uint8_t bmi160Detect(const busDevice_t *bus)
     IOHi(bus->busdev_u.spi.csnPin);
 #endif
 
-    spiSetDivisor(bus->busdev_u.spi.instance, BMI160_SPI_DIVISOR);
+    spiBusSetDivisor(bus, BMI160_SPI_DIVISOR);
 
     /* Read this address to activate SPI (see p. 84) */
     spiBusReadRegister(bus, 0x7F);
@@ -245,7 +251,17 @@ extiCallbackRec_t bmi160IntCallbackRec;
 void bmi160ExtiHandler(extiCallbackRec_t *cb)
 {
     gyroDev_t *gyro = container_of(cb, gyroDev_t, exti);
+    gyroSyncDataReady(gyro, micros());
+#ifdef USE_GYRO_SPI_DMA
+    if (gyroSpiDmaStartRead(gyro)) {
+        // dataReady is set when the transfer completes
+        return;
+    }
+#endif
     gyro->dataReady = true;
+    if (gyro->dataReadyFn) {
+        gyro->dataReadyFn();
+    }
 }
 
 static void bmi160IntExtiInit(gyroDev_t *gyro)
@@ -285,9 +301,23 @@ bool bmi160AccRead(accDev_t *acc)
     uint8_t bmi160_rx_buf[BUFFER_SIZE];
     static const uint8_t bmi160_tx_buf[BUFFER_SIZE] = {BMI160_REG_ACC_DATA_X_LSB | 0x80, 0, 0, 0, 0, 0, 0};
 
-    IOLo(acc->bus.busdev_u.spi.csnPin);
+#ifdef USE_GYRO_SPI_DMA
+    if (gyroSpiDmaIsActive(&acc->bus)) {
+        // the accelerometer shares the gyro DMA read, the bus must not be used directly
+        uint8_t data[BMI160_DMA_READ_LENGTH];
+        if (!gyroSpiDmaReadSample(&acc->bus, data, BMI160_DMA_READ_LENGTH)) {
+            return false;
+        }
+        acc->ADCRaw[X] = (int16_t)((data[BMI160_DMA_ACC_OFFSET + 1] << 8) | data[BMI160_DMA_ACC_OFFSET + 0]);
+        acc->ADCRaw[Y] = (int16_t)((data[BMI160_DMA_ACC_OFFSET + 3] << 8) | data[BMI160_DMA_ACC_OFFSET + 2]);
+        acc->ADCRaw[Z] = (int16_t)((data[BMI160_DMA_ACC_OFFSET + 5] << 8) | data[BMI160_DMA_ACC_OFFSET + 4]);
+        return true;
+    }
+#endif
+
+    IOFastLo(&acc->bus.busdev_u.spi.csn);
     spiTransfer(acc->bus.busdev_u.spi.instance, bmi160_tx_buf, bmi160_rx_buf, BUFFER_SIZE);   // receive response
-    IOHi(acc->bus.busdev_u.spi.csnPin);
+    IOFastHi(&acc->bus.busdev_u.spi.csn);
 
     acc->ADCRaw[X] = (int16_t)((bmi160_rx_buf[IDX_ACCEL_XOUT_H] << 8) | bmi160_rx_buf[IDX_ACCEL_XOUT_L]);
     acc->ADCRaw[Y] = (int16_t)((bmi160_rx_buf[IDX_ACCEL_YOUT_H] << 8) | bmi160_rx_buf[IDX_ACCEL_YOUT_L]);
@@ -313,9 +343,9 @@ bool bmi160GyroRead(gyroDev_t *gyro)
     uint8_t bmi160_rx_buf[BUFFER_SIZE];
     static const uint8_t bmi160_tx_buf[BUFFER_SIZE] = {BMI160_REG_GYR_DATA_X_LSB | 0x80, 0, 0, 0, 0, 0, 0};
 
-    IOLo(gyro->bus.busdev_u.spi.csnPin);
+    IOFastLo(&gyro->bus.busdev_u.spi.csn);
     spiTransfer(gyro->bus.busdev_u.spi.instance, bmi160_tx_buf, bmi160_rx_buf, BUFFER_SIZE);   // receive response
-    IOHi(gyro->bus.busdev_u.spi.csnPin);
+    IOFastHi(&gyro->bus.busdev_u.spi.csn);
 
     gyro->gyroADCRaw[X] = (int16_t)((bmi160_rx_buf[IDX_GYRO_XOUT_H] << 8) | bmi160_rx_buf[IDX_GYRO_XOUT_L]);
     gyro->gyroADCRaw[Y] = (int16_t)((bmi160_rx_buf[IDX_GYRO_YOUT_H] << 8) | bmi160_rx_buf[IDX_GYRO_YOUT_L]);
@@ -324,11 +354,36 @@ bool bmi160GyroRead(gyroDev_t *gyro)
     return true;
 }
 
+#ifdef USE_GYRO_SPI_DMA
+static bool bmi160GyroReadSpiDma(gyroDev_t *gyro)
+{
+    if (!gyroSpiDmaIsActive(&gyro->bus)) {
+        // DMA reads start once all sensors are configured
+        return bmi160GyroRead(gyro);
+    }
+
+    uint8_t data[BMI160_DMA_READ_LENGTH];
+    if (!gyroSpiDmaReadSample(&gyro->bus, data, BMI160_DMA_READ_LENGTH)) {
+        return false;
+    }
+
+    gyro->gyroADCRaw[X] = (int16_t)((data[1] << 8) | data[0]);
+    gyro->gyroADCRaw[Y] = (int16_t)((data[3] << 8) | data[2]);
+    gyro->gyroADCRaw[Z] = (int16_t)((data[5] << 8) | data[4]);
+
+    return true;
+}
+#endif
 
 void bmi160SpiGyroInit(gyroDev_t *gyro)
 {
     BMI160_Init(&gyro->bus);
     bmi160IntExtiInit(gyro);
+#ifdef USE_GYRO_SPI_DMA
+    if (gyroSpiDmaInit(gyro, BMI160_REG_GYR_DATA_X_LSB, BMI160_DMA_READ_LENGTH)) {
+        gyro->readFn = bmi160GyroReadSpiDma;
+    }
+#endif
 }
 
 void bmi160SpiAccInit(accDev_t *acc)
@@ -0,0 +1,303 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_GYRO_SPI_DMA
+
+#include "drivers/bus.h"
+#include "drivers/bus_spi.h"
+#include "drivers/dma.h"
+#include "drivers/io.h"
+#include "drivers/nvic.h"
+
+#include "drivers/accgyro/accgyro.h"
+#include "drivers/accgyro/accgyro_spi_dma.h"
+
+// Each DMA driven gyro must be the only device on its SPI bus. A second gyro is read by DMA when the target assigns
+// it streams too, the two are then on separate buses and both transfers are started by the data ready interrupt of
+// the first gyro, so that they run at the same time and the gyro task is signalled once both have completed.
+
+#if defined(USE_DUAL_GYRO) && defined(GYRO_2_SPI_DMA_RX_STREAM) && defined(GYRO_2_SPI_DMA_TX_STREAM)
+#define GYRO_SPI_DMA_COUNT 2
+#else
+#define GYRO_SPI_DMA_COUNT 1
+#endif
+
+typedef struct gyroSpiDmaStreams_s {
+    DMA_Stream_TypeDef *rxStream;
+    DMA_Stream_TypeDef *txStream;
+    uint32_t channel;
+} gyroSpiDmaStreams_t;
+
+static const gyroSpiDmaStreams_t gyroSpiDmaStreams[GYRO_SPI_DMA_COUNT] = {
+    { GYRO_SPI_DMA_RX_STREAM, GYRO_SPI_DMA_TX_STREAM, GYRO_SPI_DMA_CHANNEL },
+#if GYRO_SPI_DMA_COUNT > 1
+    { GYRO_2_SPI_DMA_RX_STREAM, GYRO_2_SPI_DMA_TX_STREAM, GYRO_2_SPI_DMA_CHANNEL },
+#endif
+};
+
+typedef struct gyroSpiDma_s {
+    gyroDev_t *gyro;
+    dmaChannelDescriptor_t *rxDescriptor;
+    dmaChannelDescriptor_t *txDescriptor;
+    uint8_t length;
+    uint8_t txBuffer[GYRO_SPI_DMA_MAX_LENGTH + 1];
+    uint8_t rxBuffer[2][GYRO_SPI_DMA_MAX_LENGTH + 1];
+    uint8_t writeIndex;
+    volatile uint8_t readIndex;
+    volatile uint32_t sampleCount;
+    volatile bool transferInProgress;
+} gyroSpiDma_t;
+
+static gyroSpiDma_t gyroSpiDma[GYRO_SPI_DMA_COUNT];
+static uint8_t dmaGyroCount;
+static bool dmaEnabled;
+
+// both gyros are read together, the transfers of the pair still running and whether one of them failed
+static bool dmaPaired;
+static volatile uint8_t dmaPairPending;
+static volatile bool dmaPairFailed;
+
+static gyroSpiDma_t *gyroSpiDmaByBus(const busDevice_t *bus)
+{
+    if (bus->bustype != BUSTYPE_SPI) {
+        return NULL;
+    }
+    for (int i = 0; i < dmaGyroCount; i++) {
+        if (gyroSpiDma[i].gyro->bus.busdev_u.spi.csnPin == bus->busdev_u.spi.csnPin) {
+            return &gyroSpiDma[i];
+        }
+    }
+    return NULL;
+}
+
+static void gyroSpiDmaEndTransfer(gyroSpiDma_t *dma)
+{
+    SPI_TypeDef *instance = dma->gyro->bus.busdev_u.spi.instance;
+
+    // the rx stream completes after the last byte has been clocked in, so the bus is idle
+    IOFastHi(&dma->gyro->bus.busdev_u.spi.csn);
+    SPI_I2S_DMACmd(instance, SPI_I2S_DMAReq_Tx | SPI_I2S_DMAReq_Rx, DISABLE);
+    DMA_Cmd(dma->txDescriptor->ref, DISABLE);
+    DMA_Cmd(dma->rxDescriptor->ref, DISABLE);
+    DMA_CLEAR_FLAG(dma->txDescriptor, DMA_IT_TCIF | DMA_IT_HTIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF);
+    DMA_CLEAR_FLAG(dma->rxDescriptor, DMA_IT_TCIF | DMA_IT_HTIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF);
+
+    dma->transferInProgress = false;
+}
+
+static void gyroSpiDmaSignalDataReady(gyroDev_t *gyro)
+{
+    gyro->dataReady = true;
+    if (gyro->dataReadyFn) {
+        gyro->dataReadyFn();
+    }
+}
+
+static void gyroSpiDmaRxHandler(dmaChannelDescriptor_t *descriptor)
+{
+    gyroSpiDma_t *dma = &gyroSpiDma[descriptor->userParam];
+    bool completed;
+
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TEIF)) {
+        // drop the sample, the next data ready interrupt starts a new transfer
+        gyroSpiDmaEndTransfer(dma);
+        completed = false;
+    } else if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
+        gyroSpiDmaEndTransfer(dma);
+
+        // publish the completed buffer and fill the other one next time
+        dma->readIndex = dma->writeIndex;
+        dma->writeIndex ^= 1;
+        dma->sampleCount++;
+        completed = true;
+    } else {
+        return;
+    }
+
+    if (!dmaPaired) {
+        if (completed) {
+            gyroSpiDmaSignalDataReady(dma->gyro);
+        }
+        return;
+    }
+
+    // the sample pair is only complete once the transfers of both gyros are, the handlers share a priority so
+    // they do not preempt each other
+    if (!completed) {
+        dmaPairFailed = true;
+    }
+    if (--dmaPairPending == 0 && !dmaPairFailed) {
+        for (int i = 0; i < dmaGyroCount; i++) {
+            gyroSpiDmaSignalDataReady(gyroSpiDma[i].gyro);
+        }
+    }
+}
+
+static void gyroSpiDmaInitStream(const gyroSpiDma_t *dma, DMA_Stream_TypeDef *stream, uint32_t channel, uint32_t direction, const uint8_t *buffer)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    DMA_DeInit(stream);
+    DMA_StructInit(&DMA_InitStructure);
+    DMA_InitStructure.DMA_Channel = channel;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&dma->gyro->bus.busdev_u.spi.instance->DR;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)buffer;
+    DMA_InitStructure.DMA_DIR = direction;
+    DMA_InitStructure.DMA_BufferSize = dma->length;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_Init(stream, &DMA_InitStructure);
+}
+
+// Prepares DMA reads of length bytes starting at readRegister, reads are not started until gyroSpiDmaEnable() is called
+bool gyroSpiDmaInit(gyroDev_t *gyro, uint8_t readRegister, uint8_t length)
+{
+    if (dmaGyroCount >= GYRO_SPI_DMA_COUNT || gyro->bus.bustype != BUSTYPE_SPI || length > GYRO_SPI_DMA_MAX_LENGTH) {
+        return false;
+    }
+    for (int i = 0; i < dmaGyroCount; i++) {
+        if (gyroSpiDma[i].gyro->bus.busdev_u.spi.instance == gyro->bus.busdev_u.spi.instance) {
+            // a transfer would clash with the one of the gyro already on the bus
+            return false;
+        }
+    }
+
+    const int index = dmaGyroCount;
+    const gyroSpiDmaStreams_t *streams = &gyroSpiDmaStreams[index];
+    gyroSpiDma_t *dma = &gyroSpiDma[index];
+
+    dma->gyro = gyro;
+    dma->length = length + 1;
+
+    memset(dma->txBuffer, 0xFF, sizeof(dma->txBuffer));
+    dma->txBuffer[0] = readRegister | 0x80;
+
+    const dmaIdentifier_e rxIdentifier = dmaGetIdentifier(streams->rxStream);
+    const dmaIdentifier_e txIdentifier = dmaGetIdentifier(streams->txStream);
+    dmaInit(rxIdentifier, OWNER_GYRO_DMA, RESOURCE_INDEX(index));
+    dmaInit(txIdentifier, OWNER_GYRO_DMA, RESOURCE_INDEX(index));
+    dma->rxDescriptor = dmaGetDescriptorByIdentifier(rxIdentifier);
+    dma->txDescriptor = dmaGetDescriptorByIdentifier(txIdentifier);
+
+    gyroSpiDmaInitStream(dma, streams->txStream, streams->channel, DMA_DIR_MemoryToPeripheral, dma->txBuffer);
+    gyroSpiDmaInitStream(dma, streams->rxStream, streams->channel, DMA_DIR_PeripheralToMemory, dma->rxBuffer[0]);
+
+    DMA_ITConfig(streams->rxStream, DMA_IT_TC | DMA_IT_TE, ENABLE);
+    dmaSetHandler(rxIdentifier, gyroSpiDmaRxHandler, NVIC_PRIO_GYRO_SPI_DMA, index);
+
+    dmaGyroCount++;
+    return true;
+}
+
+// Called once all the sensors are configured, from then on the buses belong to the DMA
+void gyroSpiDmaEnable(void)
+{
+    if (dmaGyroCount) {
+        dmaPaired = dmaGyroCount > 1;
+        dmaEnabled = true;
+    }
+}
+
+static void gyroSpiDmaStartTransfer(gyroSpiDma_t *dma)
+{
+    dma->transferInProgress = true;
+
+    SPI_TypeDef *instance = dma->gyro->bus.busdev_u.spi.instance;
+
+    // streams are left configured by gyroSpiDmaInit, only the buffer and count need setting
+    dma->rxDescriptor->ref->M0AR = (uint32_t)dma->rxBuffer[dma->writeIndex];
+    dma->rxDescriptor->ref->NDTR = dma->length;
+    dma->txDescriptor->ref->NDTR = dma->length;
+
+    // discard any stale byte left in the data register
+    (void)instance->DR;
+
+    IOFastLo(&dma->gyro->bus.busdev_u.spi.csn);
+    DMA_Cmd(dma->rxDescriptor->ref, ENABLE);
+    DMA_Cmd(dma->txDescriptor->ref, ENABLE);
+    SPI_I2S_DMACmd(instance, SPI_I2S_DMAReq_Tx | SPI_I2S_DMAReq_Rx, ENABLE);
+}
+
+// Called from the data ready interrupt, returns false if the gyro is not read by DMA
+bool gyroSpiDmaStartRead(gyroDev_t *gyro)
+{
+    if (!dmaEnabled) {
+        return false;
+    }
+    gyroSpiDma_t *dma = gyroSpiDmaByBus(&gyro->bus);
+    if (!dma) {
+        return false;
+    }
+
+    if (!dmaPaired) {
+        if (!dma->transferInProgress) {
+            gyroSpiDmaStartTransfer(dma);
+        }
+        // otherwise the previous sample is still being transferred, skip this one
+        return true;
+    }
+
+    if (dma != &gyroSpiDma[0] || dmaPairPending) {
+        // the data ready of the first gyro starts the reads of both
+        return true;
+    }
+    dmaPairPending = dmaGyroCount;
+    dmaPairFailed = false;
+    for (int i = 0; i < dmaGyroCount; i++) {
+        gyroSpiDmaStartTransfer(&gyroSpiDma[i]);
+    }
+
+    return true;
+}
+
+bool gyroSpiDmaIsActive(const busDevice_t *bus)
+{
+    return dmaEnabled && gyroSpiDmaByBus(bus);
+}
+
+// Copies the register data of the latest completed transfer of the gyro on the bus, without the leading register address byte
+bool gyroSpiDmaReadSample(const busDevice_t *bus, uint8_t *data, uint8_t length)
+{
+    const gyroSpiDma_t *dma = gyroSpiDmaByBus(bus);
+    if (!dma || dma->sampleCount == 0 || length >= dma->length) {
+        return false;
+    }
+
+    // retry if a transfer completed while copying, a buffer is only rewritten two transfers after being published
+    uint32_t sampleCount;
+    do {
+        sampleCount = dma->sampleCount;
+        memcpy(data, &dma->rxBuffer[dma->readIndex][1], length);
+    } while (sampleCount != dma->sampleCount);
+
+    return true;
+}
+
+#endif // USE_GYRO_SPI_DMA
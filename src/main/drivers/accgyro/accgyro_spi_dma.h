@@ -0,0 +1,40 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// DMA driven gyro data read.
+// The data ready interrupt starts a burst read of the sensor data registers, the DMA completion interrupt
+// publishes the sample into one of two buffers, so the gyro task only copies memory and never waits on the bus.
+// Two gyros on separate buses are read at the same time, both transfers start from the first gyro's data ready.
+
+#define GYRO_SPI_DMA_MAX_LENGTH 16
+
+struct gyroDev_s;
+struct busDevice_s;
+
+bool gyroSpiDmaInit(struct gyroDev_s *gyro, uint8_t readRegister, uint8_t length);
+void gyroSpiDmaEnable(void);
+bool gyroSpiDmaStartRead(struct gyroDev_s *gyro);
+bool gyroSpiDmaIsActive(const struct busDevice_s *bus);
+bool gyroSpiDmaReadSample(const struct busDevice_s *bus, uint8_t *data, uint8_t length);
@@ -97,7 +97,7 @@ void icm20649AccInit(accDev_t *acc)
     // 1,024 LSB/g 30g
     acc->acc_1G = acc->acc_high_fsr ? 1024 : 2048;
 
-    spiSetDivisor(acc->bus.busdev_u.spi.instance, SPI_CLOCK_STANDARD);
+    spiBusSetDivisor(&acc->bus, SPI_CLOCK_STANDARD);
 
     spiBusWriteRegister(&acc->bus, ICM20649_RA_REG_BANK_SEL, 2 << 4); // config in bank 2
     delay(15);
@@ -125,7 +125,7 @@ void icm20649GyroInit(gyroDev_t *gyro)
 {
     mpuGyroInit(gyro);
 
-    spiSetDivisor(gyro->bus.busdev_u.spi.instance, SPI_CLOCK_STANDARD); // ensure proper speed
+    spiBusSetDivisor(&gyro->bus, SPI_CLOCK_STANDARD); // ensure proper speed
 
     spiBusWriteRegister(&gyro->bus, ICM20649_RA_REG_BANK_SEL, 0 << 4); // select bank 0 just to be safe
     delay(15);
@@ -25,11 +25,15 @@
  *      Author: borisb
  */
 
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
+#include "common/maths.h"
+
 #include "drivers/sensor.h"
 #include "drivers/accgyro/accgyro.h"
 #include "drivers/accgyro/gyro_sync.h"
@@ -90,3 +94,93 @@ uint32_t gyroSetSampleRate(gyroDev_t *gyro, uint8_t lpf, uint8_t gyroSyncDenomin
     const uint32_t targetLooptime = (uint32_t)(gyroSyncDenominator * gyroSamplePeriod);
     return targetLooptime;
 }
+
+#ifdef USE_GYRO_ODR_TRACKING
+// Gains of the phase locked loop, the frequency gain a quarter of the square of the phase gain damps it critically
+#define GYRO_ODR_PHASE_GAIN             (1.0f / 8)
+#define GYRO_ODR_FREQUENCY_GAIN         (GYRO_ODR_PHASE_GAIN * GYRO_ODR_PHASE_GAIN / 4)
+#define GYRO_ODR_LOCKED_UPDATES         64
+#define GYRO_ODR_MAX_DEVIATION          0.05f   // of the nominal period, far beyond the tolerance of the sensor clocks
+
+void gyroOdrTrackerInit(gyroDev_t *gyro, float nominalPeriodUs)
+{
+    gyroOdrTracker_t *tracker = &gyro->odrTracker;
+
+    memset(tracker, 0, sizeof(*tracker));
+    tracker->nominalPeriodUs = nominalPeriodUs;
+    tracker->periodUs = nominalPeriodUs;
+}
+
+/*
+ * Takes the data ready interrupts since the last call into the estimate, returns how many there were.
+ *
+ * Each interrupt time is compared with the time predicted from the estimated phase and period, the phase follows a
+ * fraction of the error and the period a smaller one, so the jitter of the interrupt latency averages out while the
+ * drift of the gyro clock is followed. Interrupts missed between two calls just lengthen the prediction.
+ */
+FAST_CODE uint32_t gyroOdrTrackerUpdate(gyroDev_t *gyro)
+{
+    gyroOdrTracker_t *tracker = &gyro->odrTracker;
+
+    uint32_t dataReadyCount;
+    timeUs_t dataReadyAtUs;
+    do {
+        dataReadyCount = gyro->dataReadyCount;
+        dataReadyAtUs = gyro->dataReadyAtUs;
+    } while (dataReadyCount != gyro->dataReadyCount);
+
+    const uint32_t periods = dataReadyCount - tracker->dataReadyCount;
+    if (periods == 0) {
+        return 0;
+    }
+
+    const float phaseErrorUs = cmpTimeUs(dataReadyAtUs, tracker->dataReadyAtUs) - tracker->phaseOffsetUs - periods * tracker->periodUs;
+    if (!tracker->started || fabsf(phaseErrorUs) > tracker->periodUs / 2) {
+        // the first interrupt, or the estimate lost the interrupts, start again from this one
+        tracker->phaseOffsetUs = 0;
+        tracker->lockedCount = 0;
+        tracker->started = true;
+    } else {
+        const float maxDeviationUs = tracker->nominalPeriodUs * GYRO_ODR_MAX_DEVIATION;
+        tracker->periodUs = constrainf(tracker->periodUs + GYRO_ODR_FREQUENCY_GAIN * phaseErrorUs / periods,
+            tracker->nominalPeriodUs - maxDeviationUs, tracker->nominalPeriodUs + maxDeviationUs);
+        // the estimated time of this interrupt, relative to its measured time
+        tracker->phaseOffsetUs = -(1.0f - GYRO_ODR_PHASE_GAIN) * phaseErrorUs;
+        if (tracker->lockedCount < GYRO_ODR_LOCKED_UPDATES) {
+            tracker->lockedCount++;
+        }
+    }
+
+    tracker->dataReadyAtUs = dataReadyAtUs;
+    tracker->dataReadyCount = dataReadyCount;
+
+    return periods;
+}
+
+bool gyroOdrTrackerIsLocked(const gyroDev_t *gyro)
+{
+    return gyro->odrTracker.lockedCount >= GYRO_ODR_LOCKED_UPDATES;
+}
+
+// Whether the data ready interrupt is running but has not fired since the last update, a read would repeat the last sample
+bool gyroOdrTrackerAwaitingDataReady(const gyroDev_t *gyro, timeUs_t currentTimeUs)
+{
+    const gyroOdrTracker_t *tracker = &gyro->odrTracker;
+
+    return gyroOdrTrackerIsLocked(gyro) && gyro->dataReadyCount == tracker->dataReadyCount
+        && cmpTimeUs(currentTimeUs, tracker->dataReadyAtUs) < 2 * tracker->periodUs;
+}
+
+float gyroOdrTrackerPeriodUs(const gyroDev_t *gyro)
+{
+    return gyro->odrTracker.periodUs;
+}
+
+// Estimated time of the data ready interrupt the given number of periods after the last update
+timeUs_t gyroOdrTrackerDataReadyAtUs(const gyroDev_t *gyro, int periods)
+{
+    const gyroOdrTracker_t *tracker = &gyro->odrTracker;
+
+    return tracker->dataReadyAtUs + lrintf(tracker->phaseOffsetUs + periods * tracker->periodUs);
+}
+#endif
@@ -29,5 +29,22 @@
 
 #include "drivers/accgyro/accgyro.h"
 
+// Called from the data ready interrupt of the gyro
+static inline void gyroSyncDataReady(gyroDev_t *gyro, timeUs_t currentTimeUs)
+{
+    // the time first, a reader rereads the count to catch an interrupt between the two
+    gyro->dataReadyAtUs = currentTimeUs;
+    gyro->dataReadyCount++;
+}
+
 bool gyroSyncCheckUpdate(gyroDev_t *gyro);
 uint32_t gyroSetSampleRate(gyroDev_t *gyro, uint8_t lpf, uint8_t gyroSyncDenominator, bool gyro_use_32khz);
+
+#ifdef USE_GYRO_ODR_TRACKING
+void gyroOdrTrackerInit(gyroDev_t *gyro, float nominalPeriodUs);
+uint32_t gyroOdrTrackerUpdate(gyroDev_t *gyro);
+bool gyroOdrTrackerIsLocked(const gyroDev_t *gyro);
+bool gyroOdrTrackerAwaitingDataReady(const gyroDev_t *gyro, timeUs_t currentTimeUs);
+float gyroOdrTrackerPeriodUs(const gyroDev_t *gyro);
+timeUs_t gyroOdrTrackerDataReadyAtUs(const gyroDev_t *gyro, int periods);
+#endif
@@ -26,11 +26,13 @@
 
 #ifdef USE_ADC
 
+#include "build/atomic.h"
 #include "build/build_config.h"
 #include "build/debug.h"
 
 #include "drivers/adc_impl.h"
 #include "drivers/io.h"
+#include "drivers/nvic.h"
 
 #include "pg/adc.h"
 
@@ -39,7 +41,18 @@
 //#define DEBUG_ADC_CHANNELS
 
 adcOperatingConfig_t adcOperatingConfig[ADC_CHANNEL_COUNT];
-volatile uint16_t adcValues[ADC_CHANNEL_COUNT];
+DMA_RAM_ZERO_INIT volatile uint16_t adcValues[ADC_CHANNEL_COUNT * ADC_RING_SEQUENCES];
+
+#ifdef USE_ADC_OVERSAMPLING
+#define ADC_BLOCK_SEQUENCES (ADC_RING_SEQUENCES / 2)
+// limits the sum of a channel nobody averages, so it cannot overflow
+#define ADC_AVERAGE_MAX_SAMPLES 4096
+
+// indexed by the DMA index of the channel
+static volatile uint16_t adcBlockAverage[ADC_CHANNEL_COUNT];
+static volatile uint32_t adcSampleSum[ADC_CHANNEL_COUNT];
+static volatile uint16_t adcSampleCount[ADC_CHANNEL_COUNT];
+#endif
 
 #ifdef USE_ADC_INTERNAL
 uint16_t adcTSCAL1;
@@ -98,7 +111,57 @@ uint16_t adcGetChannel(uint8_t channel)
         debug[3] = adcValues[adcOperatingConfig[3].dmaIndex];
     }
 #endif
+#ifdef USE_ADC_OVERSAMPLING
+    return adcBlockAverage[adcOperatingConfig[channel].dmaIndex];
+#else
     return adcValues[adcOperatingConfig[channel].dmaIndex];
+#endif
+}
+
+#ifdef USE_ADC_OVERSAMPLING
+// Called from the DMA interrupt with the half of the ring that was just filled
+void adcAccumulate(const volatile uint16_t *sequences, uint8_t channelCount)
+{
+    for (int index = 0; index < channelCount; index++) {
+        uint32_t blockSum = 0;
+        for (int sequence = 0; sequence < ADC_BLOCK_SEQUENCES; sequence++) {
+            blockSum += sequences[sequence * channelCount + index];
+        }
+        adcBlockAverage[index] = blockSum / ADC_BLOCK_SEQUENCES;
+
+        if (adcSampleCount[index] >= ADC_AVERAGE_MAX_SAMPLES) {
+            adcSampleSum[index] = 0;
+            adcSampleCount[index] = 0;
+        }
+        adcSampleSum[index] += blockSum;
+        adcSampleCount[index] += ADC_BLOCK_SEQUENCES;
+    }
+}
+#endif
+
+// Mean of all samples converted since the previous call, so nothing between two task runs is missed.
+// Resets the channel, so only one consumer per channel may use it.
+uint16_t adcGetChannelAverage(uint8_t channel)
+{
+#ifdef USE_ADC_OVERSAMPLING
+    const uint8_t index = adcOperatingConfig[channel].dmaIndex;
+    uint32_t sum;
+    uint16_t count;
+    ATOMIC_BLOCK(NVIC_PRIO_ADC_DMA) {
+        sum = adcSampleSum[index];
+        count = adcSampleCount[index];
+        adcSampleSum[index] = 0;
+        adcSampleCount[index] = 0;
+    }
+
+    if (count == 0) {
+        // called again before the next block completed
+        return adcBlockAverage[index];
+    }
+    return sum / count;
+#else
+    return adcGetChannel(channel);
+#endif
 }
 
 // Verify a pin designated by tag has connection to an ADC instance designated by device
@@ -131,4 +194,10 @@ uint16_t adcGetChannel(uint8_t channel)
     UNUSED(channel);
     return 0;
 }
+
+uint16_t adcGetChannelAverage(uint8_t channel)
+{
+    UNUSED(channel);
+    return 0;
+}
 #endif
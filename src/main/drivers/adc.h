@@ -78,6 +78,7 @@ typedef struct adcOperatingConfig_s {
 struct adcConfig_s;
 void adcInit(const struct adcConfig_s *config);
 uint16_t adcGetChannel(uint8_t channel);
+uint16_t adcGetChannelAverage(uint8_t channel);
 
 #ifdef USE_ADC_INTERNAL
 extern uint16_t adcVREFINTCAL;
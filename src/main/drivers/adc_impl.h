@@ -50,6 +50,13 @@ typedef struct adcTagMap_s {
 #define ADC_DEVICES_34  ((1 << ADCDEV_3)|(1 << ADCDEV_4))
 #define ADC_DEVICES_123 ((1 << ADCDEV_1)|(1 << ADCDEV_2)|(1 << ADCDEV_3))
 
+#ifdef USE_ADC_OVERSAMPLING
+// conversion sequences in the circular DMA buffer, each half is accumulated once the DMA has filled it
+#define ADC_RING_SEQUENCES 32
+#else
+#define ADC_RING_SEQUENCES 1
+#endif
+
 typedef struct adcDevice_s {
     ADC_TypeDef* ADCx;
     rccPeriphTag_t rccADC;
@@ -68,8 +75,11 @@ typedef struct adcDevice_s {
 extern const adcDevice_t adcHardware[];
 extern const adcTagMap_t adcTagMap[ADC_TAG_MAP_COUNT];
 extern adcOperatingConfig_t adcOperatingConfig[ADC_CHANNEL_COUNT];
-extern volatile uint16_t adcValues[ADC_CHANNEL_COUNT];
+extern volatile uint16_t adcValues[ADC_CHANNEL_COUNT * ADC_RING_SEQUENCES];
 
 uint8_t adcChannelByTag(ioTag_t ioTag);
 ADCDevice adcDeviceByInstance(ADC_TypeDef *instance);
 bool adcVerifyPin(ioTag_t tag, ADCDevice device);
+#ifdef USE_ADC_OVERSAMPLING
+void adcAccumulate(const volatile uint16_t *sequences, uint8_t channelCount);
+#endif
@@ -35,6 +35,7 @@
 #include "io_impl.h"
 #include "rcc.h"
 #include "dma.h"
+#include "nvic.h"
 
 #include "drivers/sensor.h"
 
@@ -187,6 +188,22 @@ uint16_t adcInternalReadTempsensor(void)
 }
 #endif
 
+#ifdef USE_ADC_OVERSAMPLING
+static void adcDmaIRQHandler(dmaChannelDescriptor_t *descriptor)
+{
+    const uint8_t channelCount = descriptor->userParam;
+
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_HTIF)) {
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_HTIF);
+        adcAccumulate(&adcValues[0], channelCount);
+    }
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+        adcAccumulate(&adcValues[channelCount * ADC_RING_SEQUENCES / 2], channelCount);
+    }
+}
+#endif
+
 void adcInit(const adcConfig_t *config)
 {
     uint8_t i;
@@ -290,15 +307,20 @@ void adcInit(const adcConfig_t *config)
     DMA_InitStructure.DMA_Channel = adc.channel;
     DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)adcValues;
     DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
-    DMA_InitStructure.DMA_BufferSize = configuredAdcChannels;
+    DMA_InitStructure.DMA_BufferSize = configuredAdcChannels * ADC_RING_SEQUENCES;
     DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
-    DMA_InitStructure.DMA_MemoryInc = configuredAdcChannels > 1 ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = configuredAdcChannels * ADC_RING_SEQUENCES > 1 ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
     DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
     DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
     DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
     DMA_InitStructure.DMA_Priority = DMA_Priority_High;
     DMA_Init(adc.DMAy_Streamx, &DMA_InitStructure);
 
+#ifdef USE_ADC_OVERSAMPLING
+    dmaSetHandler(dmaGetIdentifier(adc.DMAy_Streamx), adcDmaIRQHandler, NVIC_PRIO_ADC_DMA, configuredAdcChannels);
+    DMA_ITConfig(adc.DMAy_Streamx, DMA_IT_HT | DMA_IT_TC, ENABLE);
+#endif
+
     DMA_Cmd(adc.DMAy_Streamx, ENABLE);
 
     ADC_SoftwareStartConv(adc.ADCx);
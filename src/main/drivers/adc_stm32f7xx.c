@@ -26,6 +26,8 @@
 
 #ifdef USE_ADC
 
+#include "common/utils.h"
+
 #include "drivers/accgyro/accgyro.h"
 #include "drivers/system.h"
 
@@ -33,6 +35,7 @@
 #include "io_impl.h"
 #include "rcc.h"
 #include "dma.h"
+#include "nvic.h"
 
 #include "drivers/sensor.h"
 
@@ -214,6 +217,24 @@ uint16_t adcInternalReadTempsensor(void)
 }
 #endif
 
+#ifdef USE_ADC_OVERSAMPLING
+static void adcDmaIRQHandler(dmaChannelDescriptor_t *descriptor)
+{
+    UNUSED(descriptor);
+    HAL_DMA_IRQHandler(&adc.DmaHandle);
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    adcAccumulate(&adcValues[0], hadc->Init.NbrOfConversion);
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    adcAccumulate(&adcValues[hadc->Init.NbrOfConversion * ADC_RING_SEQUENCES / 2], hadc->Init.NbrOfConversion);
+}
+#endif
+
 void adcInit(const adcConfig_t *config)
 {
     uint8_t i;
@@ -304,7 +325,7 @@ void adcInit(const adcConfig_t *config)
     adc.DmaHandle.Init.Channel = adc.channel;
     adc.DmaHandle.Init.Direction = DMA_PERIPH_TO_MEMORY;
     adc.DmaHandle.Init.PeriphInc = DMA_PINC_DISABLE;
-    adc.DmaHandle.Init.MemInc = configuredAdcChannels > 1 ? DMA_MINC_ENABLE : DMA_MINC_DISABLE;
+    adc.DmaHandle.Init.MemInc = configuredAdcChannels * ADC_RING_SEQUENCES > 1 ? DMA_MINC_ENABLE : DMA_MINC_DISABLE;
     adc.DmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
     adc.DmaHandle.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
     adc.DmaHandle.Init.Mode = DMA_CIRCULAR;
@@ -322,9 +343,12 @@ void adcInit(const adcConfig_t *config)
 
     __HAL_LINKDMA(&adc.ADCHandle, DMA_Handle, adc.DmaHandle);
 
-    //HAL_CLEANINVALIDATECACHE((uint32_t*)&adcValues, configuredAdcChannels);
+#ifdef USE_ADC_OVERSAMPLING
+    // the HAL enables the half and full transfer interrupts, which call the conversion callbacks
+    dmaSetHandler(dmaGetIdentifier(adc.DMAy_Streamx), adcDmaIRQHandler, NVIC_PRIO_ADC_DMA, 0);
+#endif
 
-    if (HAL_ADC_Start_DMA(&adc.ADCHandle, (uint32_t*)&adcValues, configuredAdcChannels) != HAL_OK)
+    if (HAL_ADC_Start_DMA(&adc.ADCHandle, (uint32_t*)&adcValues, configuredAdcChannels * ADC_RING_SEQUENCES) != HAL_OK)
     {
         /* Start Conversation Error */
     }
@@ -188,7 +188,7 @@ bool bmp085Detect(const bmp085Config_t *config, baroDev_t *baro)
     UNUSED(config);
 #endif
 
-    delay(20); // datasheet says 10ms, we'll be careful and do 20.
+    delayUntilUptimeMs(20); // datasheet says 10ms, we'll be careful and do 20.
 
     busDevice_t *busdev = &baro->busdev;
 
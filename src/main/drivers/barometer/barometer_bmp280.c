@@ -75,7 +75,7 @@ void bmp280BusInit(busDevice_t *busdev)
         IOHi(busdev->busdev_u.spi.csnPin); // Disable
         IOInit(busdev->busdev_u.spi.csnPin, OWNER_BARO_CS, 0);
         IOConfigGPIO(busdev->busdev_u.spi.csnPin, IOCFG_OUT_PP);
-        spiSetDivisor(busdev->busdev_u.spi.instance, SPI_CLOCK_STANDARD); // XXX
+        spiBusSetDivisor(busdev, SPI_CLOCK_STANDARD); // XXX
     }
 #else
     UNUSED(busdev);
@@ -95,7 +95,7 @@ void bmp280BusDeinit(busDevice_t *busdev)
 
 bool bmp280Detect(baroDev_t *baro)
 {
-    delay(20);
+    delayUntilUptimeMs(20);
 
     busDevice_t *busdev = &baro->busdev;
     bool defaultAddressApplied = false;
@@ -143,27 +143,98 @@ static void bmp280_start_ut(baroDev_t *baro)
     // dummy
 }
 
+// On an interrupt driven I2C bus the data read completes after bmp280_get_up() returns, and is used by the next calculation
+static uint8_t bmp280_data[BMP280_DATA_FRAME_SIZE];
+static bool bmp280_read_pending;
+
+static void bmp280_decode(void)
+{
+    bmp280_up = (int32_t)((((uint32_t)(bmp280_data[0])) << 12) | (((uint32_t)(bmp280_data[1])) << 4) | ((uint32_t)bmp280_data[2] >> 4));
+    bmp280_ut = (int32_t)((((uint32_t)(bmp280_data[3])) << 12) | (((uint32_t)(bmp280_data[4])) << 4) | ((uint32_t)bmp280_data[5] >> 4));
+}
+
+static void bmp280_collect(baroDev_t *baro)
+{
+    bool error;
+
+    if (bmp280_read_pending && !busBusy(&baro->busdev, &error)) {
+        bmp280_read_pending = false;
+        if (!error) {
+            bmp280_decode();
+        }
+    }
+}
+
+#ifdef USE_BARO_SPI_BMP280
+// On SPI the data read and measurement start are queued as bus jobs, as for the MS5611.
+// With DMA the data read also completes after bmp280_get_up() returns, and is decoded from the completion callback.
+static const uint8_t bmp280_data_read_cmd = BMP280_PRESSURE_MSB_REG | 0x80;
+static const uint8_t bmp280_meas_cmd[2] = { BMP280_CTRL_MEAS_REG & 0x7f, BMP280_MODE };
+
+static const busSegment_t bmp280_read_segments[] = {
+    { &bmp280_data_read_cmd, NULL, sizeof(bmp280_data_read_cmd), false },
+    { NULL, bmp280_data, sizeof(bmp280_data), true },
+    { NULL, NULL, 0, false },
+};
+
+static const busSegment_t bmp280_meas_segments[] = {
+    { bmp280_meas_cmd, NULL, sizeof(bmp280_meas_cmd), true },
+    { NULL, NULL, 0, false },
+};
+
+static void bmp280_read_complete(uint32_t arg)
+{
+    UNUSED(arg);
+
+    bmp280_decode();
+}
+
+static bool bmp280_submit_read(busDevice_t *busdev)
+{
+    return busdev->bustype == BUSTYPE_SPI && busSubmitJob(busdev, bmp280_read_segments, bmp280_read_complete, 0);
+}
+
+static bool bmp280_submit_measurement(busDevice_t *busdev)
+{
+    return busdev->bustype == BUSTYPE_SPI && busSubmitJob(busdev, bmp280_meas_segments, NULL, 0);
+}
+#else
+#define bmp280_submit_read(busdev) false
+#define bmp280_submit_measurement(busdev) false
+#endif
+
 static void bmp280_get_ut(baroDev_t *baro)
 {
-    UNUSED(baro);
-    // dummy
+    // the read started by bmp280_get_up() has had the conversion time to complete
+    bmp280_collect(baro);
 }
 
 static void bmp280_start_up(baroDev_t *baro)
 {
     // start measurement
     // set oversampling + power mode (forced), and start sampling
-    busWriteRegister(&baro->busdev, BMP280_CTRL_MEAS_REG, BMP280_MODE);
+    if (bmp280_submit_measurement(&baro->busdev)) {
+        return;
+    }
+    if (!busWriteRegisterStart(&baro->busdev, BMP280_CTRL_MEAS_REG, BMP280_MODE)) {
+        busWriteRegister(&baro->busdev, BMP280_CTRL_MEAS_REG, BMP280_MODE);
+    }
 }
 
 static void bmp280_get_up(baroDev_t *baro)
 {
-    uint8_t data[BMP280_DATA_FRAME_SIZE];
-
     // read data from sensor
-    busReadRegisterBuffer(&baro->busdev, BMP280_PRESSURE_MSB_REG, data, BMP280_DATA_FRAME_SIZE);
-    bmp280_up = (int32_t)((((uint32_t)(data[0])) << 12) | (((uint32_t)(data[1])) << 4) | ((uint32_t)data[2] >> 4));
-    bmp280_ut = (int32_t)((((uint32_t)(data[3])) << 12) | (((uint32_t)(data[4])) << 4) | ((uint32_t)data[5] >> 4));
+    if (bmp280_submit_read(&baro->busdev)) {
+        return;
+    }
+    bmp280_read_pending = busReadRegisterBufferStart(&baro->busdev, BMP280_PRESSURE_MSB_REG, bmp280_data, BMP280_DATA_FRAME_SIZE);
+    if (bmp280_read_pending) {
+        // polled buses have already completed the read
+        bmp280_collect(baro);
+    } else {
+        busReadRegisterBuffer(&baro->busdev, BMP280_PRESSURE_MSB_REG, bmp280_data, BMP280_DATA_FRAME_SIZE);
+        bmp280_decode();
+    }
 }
 
 // Returns temperature in DegC, resolution is 0.01 DegC. Output value of "5123" equals 51.23 DegC
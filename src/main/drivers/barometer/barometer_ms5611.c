@@ -71,7 +71,7 @@ void ms5611BusInit(busDevice_t *busdev)
         IOHi(busdev->busdev_u.spi.csnPin); // Disable
         IOInit(busdev->busdev_u.spi.csnPin, OWNER_BARO_CS, 0);
         IOConfigGPIO(busdev->busdev_u.spi.csnPin, IOCFG_OUT_PP);
-        spiSetDivisor(busdev->busdev_u.spi.instance, SPI_CLOCK_STANDARD); // XXX
+        spiBusSetDivisor(busdev, SPI_CLOCK_STANDARD); // XXX
     }
 #else
     UNUSED(busdev);
@@ -95,7 +95,7 @@ bool ms5611Detect(baroDev_t *baro)
     int i;
     bool defaultAddressApplied = false;
 
-    delay(10); // No idea how long the chip takes to power-up, but let's make it 10ms
+    delayUntilUptimeMs(10); // No idea how long the chip takes to power-up, but let's make it 10ms
 
     busDevice_t *busdev = &baro->busdev;
 
@@ -198,24 +198,88 @@ static uint32_t ms5611_read_adc(busDevice_t *busdev)
     return (rxbuf[0] << 16) | (rxbuf[1] << 8) | rxbuf[2];
 }
 
+#ifdef USE_BARO_SPI_MS5611
+// On SPI the ADC reads and conversion starts are queued as bus jobs, so the baro task does not wait on the bus.
+// With DMA the result of a read arrives after the task has run, and is used by the next calculation.
+enum {
+    MS5611_READ_UT = 0,
+    MS5611_READ_UP
+};
+
+static const uint8_t ms5611_adc_read_cmd = CMD_ADC_READ | 0x80;
+static uint8_t ms5611_adc_buf[3];
+static uint8_t ms5611_conv_cmd[2];
+
+static const busSegment_t ms5611_read_segments[] = {
+    { &ms5611_adc_read_cmd, NULL, sizeof(ms5611_adc_read_cmd), false },
+    { NULL, ms5611_adc_buf, sizeof(ms5611_adc_buf), true },
+    { NULL, NULL, 0, false },
+};
+
+static const busSegment_t ms5611_conv_segments[] = {
+    { ms5611_conv_cmd, NULL, sizeof(ms5611_conv_cmd), true },
+    { NULL, NULL, 0, false },
+};
+
+static void ms5611_read_adc_complete(uint32_t arg)
+{
+    const uint32_t adc = (ms5611_adc_buf[0] << 16) | (ms5611_adc_buf[1] << 8) | ms5611_adc_buf[2];
+
+    if (arg == MS5611_READ_UT) {
+        ms5611_ut = adc;
+    } else {
+        ms5611_up = adc;
+    }
+}
+
+static bool ms5611_submit_read_adc(busDevice_t *busdev, uint32_t read)
+{
+    return busdev->bustype == BUSTYPE_SPI && busSubmitJob(busdev, ms5611_read_segments, ms5611_read_adc_complete, read);
+}
+
+static bool ms5611_submit_conversion(busDevice_t *busdev, uint8_t cmd)
+{
+    if (busdev->bustype != BUSTYPE_SPI) {
+        return false;
+    }
+
+    // one buffer is enough, the previous conversion command was sent a conversion time ago
+    ms5611_conv_cmd[0] = cmd & 0x7f;
+    ms5611_conv_cmd[1] = 1;
+
+    return busSubmitJob(busdev, ms5611_conv_segments, NULL, 0);
+}
+#else
+#define ms5611_submit_read_adc(busdev, read) false
+#define ms5611_submit_conversion(busdev, cmd) false
+#endif
+
 static void ms5611_start_ut(baroDev_t *baro)
 {
-    busWriteRegister(&baro->busdev, CMD_ADC_CONV + CMD_ADC_D2 + ms5611_osr, 1); // D2 (temperature) conversion start!
+    if (!ms5611_submit_conversion(&baro->busdev, CMD_ADC_CONV + CMD_ADC_D2 + ms5611_osr)) {
+        busWriteRegister(&baro->busdev, CMD_ADC_CONV + CMD_ADC_D2 + ms5611_osr, 1); // D2 (temperature) conversion start!
+    }
 }
 
 static void ms5611_get_ut(baroDev_t *baro)
 {
-    ms5611_ut = ms5611_read_adc(&baro->busdev);
+    if (!ms5611_submit_read_adc(&baro->busdev, MS5611_READ_UT)) {
+        ms5611_ut = ms5611_read_adc(&baro->busdev);
+    }
 }
 
 static void ms5611_start_up(baroDev_t *baro)
 {
-    busWriteRegister(&baro->busdev, CMD_ADC_CONV + CMD_ADC_D1 + ms5611_osr, 1); // D1 (pressure) conversion start!
+    if (!ms5611_submit_conversion(&baro->busdev, CMD_ADC_CONV + CMD_ADC_D1 + ms5611_osr)) {
+        busWriteRegister(&baro->busdev, CMD_ADC_CONV + CMD_ADC_D1 + ms5611_osr, 1); // D1 (pressure) conversion start!
+    }
 }
 
 static void ms5611_get_up(baroDev_t *baro)
 {
-    ms5611_up = ms5611_read_adc(&baro->busdev);
+    if (!ms5611_submit_read_adc(&baro->busdev, MS5611_READ_UP)) {
+        ms5611_up = ms5611_read_adc(&baro->busdev);
+    }
 }
 
 STATIC_UNIT_TESTED void ms5611_calculate(int32_t *pressure, int32_t *temperature)
@@ -104,7 +104,7 @@ void qmp6988BusInit(busDevice_t *busdev)
         IOHi(busdev->busdev_u.spi.csnPin); 
         IOInit(busdev->busdev_u.spi.csnPin, OWNER_BARO_CS, 0);
         IOConfigGPIO(busdev->busdev_u.spi.csnPin, IOCFG_OUT_PP);
-        spiSetDivisor(busdev->busdev_u.spi.instance, SPI_CLOCK_STANDARD);
+        spiBusSetDivisor(busdev, SPI_CLOCK_STANDARD);
     }
 #else
     UNUSED(busdev);
@@ -115,9 +115,7 @@ void qmp6988BusDeinit(busDevice_t *busdev)
 {
 #ifdef USE_BARO_SPI_QMP6988
     if (busdev->bustype == BUSTYPE_SPI) {
-        IOConfigGPIO(busdev->busdev_u.spi.csnPin, IOCFG_IPU);
-        IORelease(busdev->busdev_u.spi.csnPin);
-        IOInit(busdev->busdev_u.spi.csnPin, OWNER_SPI_PREINIT, 0);
+        spiPreinitCsByIO(busdev->busdev_u.spi.csnPin);
     }
 #else
     UNUSED(busdev);
@@ -142,7 +140,7 @@ bool qmp6988Detect(baroDev_t *baro)
     uint16_t lb=0,hb=0;
     uint32_t lw=0,hw=0,temp1,temp2;
 
-    delay(20);
+    delayUntilUptimeMs(20);
 
     busDevice_t *busdev = &baro->busdev;
     bool defaultAddressApplied = false;
@@ -272,26 +270,97 @@ static void qmp6988_start_ut(baroDev_t *baro)
     // dummy
 }
 
+// On an interrupt driven I2C bus the data read completes after qmp6988_get_up() returns, and is used by the next calculation
+static uint8_t qmp6988_data[QMP6988_DATA_FRAME_SIZE];
+static bool qmp6988_read_pending;
+
+static void qmp6988_decode(void)
+{
+    qmp6988_up = (int32_t)((((uint32_t)(qmp6988_data[0])) << 16) | (((uint32_t)(qmp6988_data[1])) << 8) | ((uint32_t)qmp6988_data[2] ));
+    qmp6988_ut = (int32_t)((((uint32_t)(qmp6988_data[3])) << 16) | (((uint32_t)(qmp6988_data[4])) << 8) | ((uint32_t)qmp6988_data[5]));
+}
+
+static void qmp6988_collect(baroDev_t *baro)
+{
+    bool error;
+
+    if (qmp6988_read_pending && !busBusy(&baro->busdev, &error)) {
+        qmp6988_read_pending = false;
+        if (!error) {
+            qmp6988_decode();
+        }
+    }
+}
+
+#ifdef USE_BARO_SPI_QMP6988
+// On SPI the data read and measurement start are queued as bus jobs, as for the MS5611.
+// With DMA the data read also completes after qmp6988_get_up() returns, and is decoded from the completion callback.
+static const uint8_t qmp6988_data_read_cmd = QMP6988_PRESSURE_MSB_REG | 0x80;
+static const uint8_t qmp6988_meas_cmd[2] = { QMP6988_CTRL_MEAS_REG & 0x7f, QMP6988_PWR_SAMPLE_MODE };
+
+static const busSegment_t qmp6988_read_segments[] = {
+    { &qmp6988_data_read_cmd, NULL, sizeof(qmp6988_data_read_cmd), false },
+    { NULL, qmp6988_data, sizeof(qmp6988_data), true },
+    { NULL, NULL, 0, false },
+};
+
+static const busSegment_t qmp6988_meas_segments[] = {
+    { qmp6988_meas_cmd, NULL, sizeof(qmp6988_meas_cmd), true },
+    { NULL, NULL, 0, false },
+};
+
+static void qmp6988_read_complete(uint32_t arg)
+{
+    UNUSED(arg);
+
+    qmp6988_decode();
+}
+
+static bool qmp6988_submit_read(busDevice_t *busdev)
+{
+    return busdev->bustype == BUSTYPE_SPI && busSubmitJob(busdev, qmp6988_read_segments, qmp6988_read_complete, 0);
+}
+
+static bool qmp6988_submit_measurement(busDevice_t *busdev)
+{
+    return busdev->bustype == BUSTYPE_SPI && busSubmitJob(busdev, qmp6988_meas_segments, NULL, 0);
+}
+#else
+#define qmp6988_submit_read(busdev) false
+#define qmp6988_submit_measurement(busdev) false
+#endif
+
 static void qmp6988_get_ut(baroDev_t *baro)
 {
-    UNUSED(baro);
-    // dummy
+    // the read started by qmp6988_get_up() has had the baro task period to complete
+    qmp6988_collect(baro);
 }
 
 static void qmp6988_start_up(baroDev_t *baro)
 {
     // start measurement
-    busWriteRegister(&baro->busdev, QMP6988_CTRL_MEAS_REG, QMP6988_PWR_SAMPLE_MODE);	
+    if (qmp6988_submit_measurement(&baro->busdev)) {
+        return;
+    }
+    if (!busWriteRegisterStart(&baro->busdev, QMP6988_CTRL_MEAS_REG, QMP6988_PWR_SAMPLE_MODE)) {
+        busWriteRegister(&baro->busdev, QMP6988_CTRL_MEAS_REG, QMP6988_PWR_SAMPLE_MODE);
+    }
 }
 
 static void qmp6988_get_up(baroDev_t *baro)
 {
-    uint8_t data[QMP6988_DATA_FRAME_SIZE];
-
     // read data from sensor
-    busReadRegisterBuffer(&baro->busdev, QMP6988_PRESSURE_MSB_REG, data, QMP6988_DATA_FRAME_SIZE);
-    qmp6988_up = (int32_t)((((uint32_t)(data[0])) << 16) | (((uint32_t)(data[1])) << 8) | ((uint32_t)data[2] ));
-    qmp6988_ut = (int32_t)((((uint32_t)(data[3])) << 16) | (((uint32_t)(data[4])) << 8) | ((uint32_t)data[5]));
+    if (qmp6988_submit_read(&baro->busdev)) {
+        return;
+    }
+    qmp6988_read_pending = busReadRegisterBufferStart(&baro->busdev, QMP6988_PRESSURE_MSB_REG, qmp6988_data, QMP6988_DATA_FRAME_SIZE);
+    if (qmp6988_read_pending) {
+        // polled buses have already completed the read
+        qmp6988_collect(baro);
+    } else {
+        busReadRegisterBuffer(&baro->busdev, QMP6988_PRESSURE_MSB_REG, qmp6988_data, QMP6988_DATA_FRAME_SIZE);
+        qmp6988_decode();
+    }
 }
 
 // Returns temperature in DegC, resolution is 0.01 DegC. Output value of "5123" equals 51.23 DegC
@@ -80,3 +80,82 @@ uint8_t busReadRegister(const busDevice_t *busdev, uint8_t reg)
     return data;
 #endif
 }
+
+// Starts a read that completes in the background where the bus driver supports it, the data is valid once
+// busBusy() returns false. SPI transfers are short enough to complete before returning.
+bool busReadRegisterBufferStart(const busDevice_t *busdev, uint8_t reg, uint8_t *data, uint8_t length)
+{
+#if !defined(USE_SPI) && !defined(USE_I2C)
+    UNUSED(reg);
+    UNUSED(data);
+    UNUSED(length);
+#endif
+    switch (busdev->bustype) {
+#ifdef USE_SPI
+    case BUSTYPE_SPI:
+        return spiBusReadRegisterBuffer(busdev, reg | 0x80, data, length);
+#endif
+#ifdef USE_I2C
+    case BUSTYPE_I2C:
+        return i2cBusReadRegisterBufferStart(busdev, reg, data, length);
+#endif
+    default:
+        return false;
+    }
+}
+
+bool busWriteRegisterStart(const busDevice_t *busdev, uint8_t reg, uint8_t data)
+{
+#if !defined(USE_SPI) && !defined(USE_I2C)
+    UNUSED(reg);
+    UNUSED(data);
+#endif
+    switch (busdev->bustype) {
+#ifdef USE_SPI
+    case BUSTYPE_SPI:
+        return spiBusWriteRegister(busdev, reg & 0x7f, data);
+#endif
+#ifdef USE_I2C
+    case BUSTYPE_I2C:
+        return i2cBusWriteRegisterStart(busdev, reg, data);
+#endif
+    default:
+        return false;
+    }
+}
+
+// Returns true while a transfer started on the device's bus is in progress, error reports how the last one ended
+bool busBusy(const busDevice_t *busdev, bool *error)
+{
+    if (error) {
+        *error = false;
+    }
+
+    switch (busdev->bustype) {
+#ifdef USE_I2C
+    case BUSTYPE_I2C:
+        return i2cBusBusy(busdev, error);
+#endif
+    default:
+        return false;
+    }
+}
+
+// Segments and their buffers must remain valid until the callback is called, which may be from interrupt context.
+// Returns false if the job could not be queued, the synchronous functions above can still be used.
+bool busSubmitJob(const busDevice_t *busdev, const busSegment_t *segments, busJobCallbackFn callback, uint32_t callbackArg)
+{
+#if !defined(USE_SPI)
+    UNUSED(segments);
+    UNUSED(callback);
+    UNUSED(callbackArg);
+#endif
+    switch (busdev->bustype) {
+#ifdef USE_SPI
+    case BUSTYPE_SPI:
+        return spiBusSubmitJob(busdev, segments, callback, callbackArg);
+#endif
+    default:
+        return false;
+    }
+}
@@ -41,6 +41,9 @@ typedef struct busDevice_s {
             SPI_HandleTypeDef* handle; // cached here for efficiency
 #endif
             IO_t csnPin;
+            ioFast_t csn;           // csnPin for the chip select edges, see spiBusSetCsPin()
+            uint16_t divisor;       // applied with the clock mode before each transfer, 0 leaves the bus as it is
+            bool leadingEdge;
         } spi;
         struct deviceI2C_s {
             I2CDevice device;
@@ -53,6 +56,17 @@ typedef struct busDevice_s {
     } busdev_u;
 } busDevice_t;
 
+// One part of a bus job, CS is asserted at the start of each segment.
+// A NULL txData clocks out 0xFF, a NULL rxData discards the bytes read.
+typedef struct busSegment_s {
+    const uint8_t *txData;
+    uint8_t *rxData;
+    uint8_t length;             // a zero length segment terminates the job
+    bool negateCS;              // release CS after this segment, it is always released at the end of the job
+} busSegment_t;
+
+typedef void (*busJobCallbackFn)(uint32_t arg);
+
 #ifdef TARGET_BUS_INIT
 void targetBusInit(void);
 #endif
@@ -60,3 +74,7 @@ void targetBusInit(void);
 bool busWriteRegister(const busDevice_t *bus, uint8_t reg, uint8_t data);
 bool busReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data, uint8_t length);
 uint8_t busReadRegister(const busDevice_t *bus, uint8_t reg);
+bool busReadRegisterBufferStart(const busDevice_t *bus, uint8_t reg, uint8_t *data, uint8_t length);
+bool busWriteRegisterStart(const busDevice_t *bus, uint8_t reg, uint8_t data);
+bool busBusy(const busDevice_t *bus, bool *error);
+bool busSubmitJob(const busDevice_t *bus, const busSegment_t *segments, busJobCallbackFn callback, uint32_t callbackArg);
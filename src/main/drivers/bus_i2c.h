@@ -62,4 +62,11 @@ bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_,
 bool i2cWrite(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t data);
 bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t* buf);
 
+// Non-blocking transfers, one at a time per bus. A start fails while the bus is busy, and buf must remain valid
+// until i2cBusy() returns false. Drivers that only poll the hardware complete the transfer before returning.
+bool i2cReadStart(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t *buf);
+bool i2cWriteStart(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t data);
+bool i2cWriteBufferStart(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t *data);
+bool i2cBusy(I2CDevice device, bool *error);
+
 uint16_t i2cGetErrorCounter(void);
@@ -45,4 +45,19 @@ uint8_t i2cBusReadRegister(const busDevice_t *busdev, uint8_t reg)
     i2cRead(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, 1, &data);
     return data;
 }
+
+bool i2cBusReadRegisterBufferStart(const busDevice_t *busdev, uint8_t reg, uint8_t *data, uint8_t length)
+{
+    return i2cReadStart(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, length, data);
+}
+
+bool i2cBusWriteRegisterStart(const busDevice_t *busdev, uint8_t reg, uint8_t data)
+{
+    return i2cWriteStart(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, data);
+}
+
+bool i2cBusBusy(const busDevice_t *busdev, bool *error)
+{
+    return i2cBusy(busdev->busdev_u.i2c.device, error);
+}
 #endif
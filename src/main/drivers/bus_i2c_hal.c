@@ -163,6 +163,13 @@ static bool i2cHandleHardwareFailure(I2CDevice device)
     return false;
 }
 
+static void i2cWait(I2C_HandleTypeDef *pHandle)
+{
+    uint32_t timeout = I2C_DEFAULT_TIMEOUT;
+
+    while (HAL_I2C_GetState(pHandle) != HAL_I2C_STATE_READY && --timeout > 0) {; }
+}
+
 bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data)
 {
     if (device == I2CINVALID || device > I2CDEV_COUNT) {
@@ -175,6 +182,9 @@ bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_,
         return false;
     }
 
+    // let any transfer started by i2cReadStart() or i2cWriteStart() finish first
+    i2cWait(pHandle);
+
     HAL_StatusTypeDef status;
 
     if (reg_ == 0xFF)
@@ -205,6 +215,8 @@ bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t
         return false;
     }
 
+    i2cWait(pHandle);
+
     HAL_StatusTypeDef status;
 
     if (reg_ == 0xFF)
@@ -218,6 +230,89 @@ bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t
     return true;
 }
 
+bool i2cReadStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *buf)
+{
+    if (device == I2CINVALID || device > I2CDEV_COUNT) {
+        return false;
+    }
+
+    I2C_HandleTypeDef *pHandle = &i2cDevice[device].handle;
+
+    if (!pHandle->Instance || HAL_I2C_GetState(pHandle) != HAL_I2C_STATE_READY) {
+        return false;
+    }
+
+    HAL_StatusTypeDef status;
+
+    if (reg_ == 0xFF)
+        status = HAL_I2C_Master_Receive_IT(pHandle, addr_ << 1, buf, len);
+    else
+        status = HAL_I2C_Mem_Read_IT(pHandle, addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT, buf, len);
+
+    if (status != HAL_OK)
+        return i2cHandleHardwareFailure(device);
+
+    return true;
+}
+
+bool i2cWriteBufferStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data)
+{
+    if (device == I2CINVALID || device > I2CDEV_COUNT) {
+        return false;
+    }
+
+    I2C_HandleTypeDef *pHandle = &i2cDevice[device].handle;
+
+    if (!pHandle->Instance || HAL_I2C_GetState(pHandle) != HAL_I2C_STATE_READY) {
+        return false;
+    }
+
+    HAL_StatusTypeDef status;
+
+    if (reg_ == 0xFF)
+        status = HAL_I2C_Master_Transmit_IT(pHandle, addr_ << 1, data, len_);
+    else
+        status = HAL_I2C_Mem_Write_IT(pHandle, addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT, data, len_);
+
+    if (status != HAL_OK)
+        return i2cHandleHardwareFailure(device);
+
+    return true;
+}
+
+bool i2cWriteStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t data)
+{
+    if (device == I2CINVALID || device > I2CDEV_COUNT) {
+        return false;
+    }
+
+    i2cDevice_t *pDev = &i2cDevice[device];
+
+    if (!pDev->handle.Instance || HAL_I2C_GetState(&pDev->handle) != HAL_I2C_STATE_READY) {
+        return false;
+    }
+
+    // the byte is sent from the interrupt, so it is kept with the bus
+    pDev->writeData = data;
+
+    return i2cWriteBufferStart(device, addr_, reg_, 1, &pDev->writeData);
+}
+
+bool i2cBusy(I2CDevice device, bool *error)
+{
+    if (device == I2CINVALID || device > I2CDEV_COUNT) {
+        return false;
+    }
+
+    I2C_HandleTypeDef *pHandle = &i2cDevice[device].handle;
+
+    if (error) {
+        *error = pHandle->ErrorCode != HAL_I2C_ERROR_NONE;
+    }
+
+    return HAL_I2C_GetState(pHandle) != HAL_I2C_STATE_READY;
+}
+
 void i2cInit(I2CDevice device)
 {
     if (device == I2CINVALID) {
@@ -85,6 +85,7 @@ typedef struct i2cDevice_s {
 #endif
     bool overClock;
     bool pullUp;
+    uint8_t writeData;          // byte sent by i2cWriteStart()
 
     // MCU/Driver dependent member follows
 #if defined(STM32F1) || defined(STM32F4)
@@ -261,6 +261,38 @@ bool i2cRead(I2CDevice device, uint8_t addr, uint8_t reg, uint8_t len, uint8_t *
     return true;
 }
 
+// Transfers are polled, so a started transfer has completed by the time the start returns
+static bool i2cTransferError;
+
+bool i2cReadStart(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t *buf)
+{
+    i2cTransferError = !i2cRead(device, addr_, reg, len, buf);
+    return true;
+}
+
+bool i2cWriteStart(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t data)
+{
+    i2cTransferError = !i2cWrite(device, addr_, reg, data);
+    return true;
+}
+
+bool i2cWriteBufferStart(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t *data)
+{
+    i2cTransferError = !i2cWriteBuffer(device, addr_, reg, len, data);
+    return true;
+}
+
+bool i2cBusy(I2CDevice device, bool *error)
+{
+    UNUSED(device);
+
+    if (error) {
+        *error = i2cTransferError;
+    }
+
+    return false;
+}
+
 uint16_t i2cGetErrorCounter(void)
 {
     return i2cErrorCount;
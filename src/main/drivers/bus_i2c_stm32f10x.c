@@ -161,7 +161,8 @@ static bool i2cHandleHardwareFailure(I2CDevice device)
     return false;
 }
 
-bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data)
+// Starts a transfer run by the event interrupt, fails if one is already in progress on the bus
+static bool i2cStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *buf, bool reading)
 {
     if (device == I2CINVALID || device > I2CDEV_COUNT) {
         return false;
@@ -176,12 +177,16 @@ bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_,
     i2cState_t *state = &i2cDevice[device].state;
     uint32_t timeout = I2C_DEFAULT_TIMEOUT;
 
+    if (state->busy) {
+        return false;
+    }
+
     state->addr = addr_ << 1;
     state->reg = reg_;
-    state->writing = 1;
-    state->reading = 0;
-    state->write_p = data;
-    state->read_p = data;
+    state->writing = !reading;
+    state->reading = reading;
+    state->write_p = buf;
+    state->read_p = buf;
     state->bytes = len_;
     state->busy = 1;
     state->error = false;
@@ -196,7 +201,14 @@ bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_,
         I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, ENABLE);            // allow the interrupts to fire off again
     }
 
-    timeout = I2C_DEFAULT_TIMEOUT;
+    return true;
+}
+
+static bool i2cWait(I2CDevice device)
+{
+    i2cState_t *state = &i2cDevice[device].state;
+    uint32_t timeout = I2C_DEFAULT_TIMEOUT;
+
     while (state->busy && --timeout > 0) {; }
     if (timeout == 0)
         return i2cHandleHardwareFailure(device);
@@ -204,6 +216,18 @@ bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_,
     return !(state->error);
 }
 
+bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data)
+{
+    if (device == I2CINVALID || device > I2CDEV_COUNT) {
+        return false;
+    }
+
+    // let any transfer started by i2cReadStart() or i2cWriteStart() finish first
+    i2cWait(device);
+
+    return i2cStart(device, addr_, reg_, len_, data, false) && i2cWait(device);
+}
+
 bool i2cWrite(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t data)
 {
     return i2cWriteBuffer(device, addr_, reg_, 1, &data);
@@ -215,41 +239,46 @@ bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t
         return false;
     }
 
-    I2C_TypeDef *I2Cx = i2cDevice[device].reg;
+    i2cWait(device);
 
-    if (!I2Cx) {
+    return i2cStart(device, addr_, reg_, len, buf, true) && i2cWait(device);
+}
+
+bool i2cReadStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t *buf)
+{
+    return i2cStart(device, addr_, reg_, len, buf, true);
+}
+
+bool i2cWriteStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t data)
+{
+    if (device == I2CINVALID || device > I2CDEV_COUNT || i2cDevice[device].state.busy) {
         return false;
     }
 
-    i2cState_t *state = &i2cDevice[device].state;
-    uint32_t timeout = I2C_DEFAULT_TIMEOUT;
+    // the byte is sent from the interrupt, so it is kept with the bus
+    i2cDevice[device].writeData = data;
 
-    state->addr = addr_ << 1;
-    state->reg = reg_;
-    state->writing = 0;
-    state->reading = 1;
-    state->read_p = buf;
-    state->write_p = buf;
-    state->bytes = len;
-    state->busy = 1;
-    state->error = false;
+    return i2cStart(device, addr_, reg_, 1, &i2cDevice[device].writeData, false);
+}
 
-    if (!(I2Cx->CR2 & I2C_IT_EVT)) {                                    // if we are restarting the driver
-        if (!(I2Cx->CR1 & I2C_CR1_START)) {                             // ensure sending a start
-            while (I2Cx->CR1 & I2C_CR1_STOP && --timeout > 0) {; }     // wait for any stop to finish sending
-            if (timeout == 0)
-                return i2cHandleHardwareFailure(device);
-            I2C_GenerateSTART(I2Cx, ENABLE);                            // send the start for the new job
-        }
-        I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, ENABLE);            // allow the interrupts to fire off again
+bool i2cWriteBufferStart(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data)
+{
+    return i2cStart(device, addr_, reg_, len_, data, false);
+}
+
+bool i2cBusy(I2CDevice device, bool *error)
+{
+    if (device == I2CINVALID || device > I2CDEV_COUNT) {
+        return false;
     }
 
-    timeout = I2C_DEFAULT_TIMEOUT;
-    while (state->busy && --timeout > 0) {; }
-    if (timeout == 0)
-        return i2cHandleHardwareFailure(device);
+    const i2cState_t *state = &i2cDevice[device].state;
 
-    return !(state->error);
+    if (error) {
+        *error = state->error;
+    }
+
+    return state->busy;
 }
 
 static void i2c_er_handler(I2CDevice device) {
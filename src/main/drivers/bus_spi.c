@@ -28,6 +28,7 @@
 
 #include "drivers/bus.h"
 #include "drivers/bus_spi.h"
+#include "drivers/bus_spi_dma.h"
 #include "drivers/bus_spi_impl.h"
 #include "drivers/exti.h"
 #include "drivers/io.h"
@@ -35,6 +36,13 @@
 
 spiDevice_t spiDevice[SPIDEV_COUNT];
 
+#define SPI_BUS_DEVICE_MAX 8
+
+static const busDevice_t *spiBusDevices[SPI_BUS_DEVICE_MAX];
+static uint8_t spiBusDeviceCount;
+static bool spiBusDeviceOverflow;
+static bool spiDirectUser[SPIDEV_COUNT];
+
 SPIDevice spiDeviceByInstance(SPI_TypeDef *instance)
 {
 #ifdef USE_SPI_DEVICE_1
@@ -118,9 +126,11 @@ uint32_t spiTimeoutUserCallback(SPI_TypeDef *instance)
 
 bool spiBusTransfer(const busDevice_t *bus, const uint8_t *txData, uint8_t *rxData, int length)
 {
-    IOLo(bus->busdev_u.spi.csnPin);
+    spiBusWaitForJobs(bus);
+    spiBusConfigure(bus);
+    IOFastLo(&bus->busdev_u.spi.csn);
     spiTransfer(bus->busdev_u.spi.instance, txData, rxData, length);
-    IOHi(bus->busdev_u.spi.csnPin);
+    IOFastHi(&bus->busdev_u.spi.csn);
     return true;
 }
 
@@ -143,20 +153,24 @@ void spiResetErrorCounter(SPI_TypeDef *instance)
 
 bool spiBusWriteRegister(const busDevice_t *bus, uint8_t reg, uint8_t data)
 {
-    IOLo(bus->busdev_u.spi.csnPin);
+    spiBusWaitForJobs(bus);
+    spiBusConfigure(bus);
+    IOFastLo(&bus->busdev_u.spi.csn);
     spiTransferByte(bus->busdev_u.spi.instance, reg);
     spiTransferByte(bus->busdev_u.spi.instance, data);
-    IOHi(bus->busdev_u.spi.csnPin);
+    IOFastHi(&bus->busdev_u.spi.csn);
 
     return true;
 }
 
 bool spiBusReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data, uint8_t length)
 {
-    IOLo(bus->busdev_u.spi.csnPin);
+    spiBusWaitForJobs(bus);
+    spiBusConfigure(bus);
+    IOFastLo(&bus->busdev_u.spi.csn);
     spiTransferByte(bus->busdev_u.spi.instance, reg | 0x80); // read transaction
     spiTransfer(bus->busdev_u.spi.instance, NULL, data, length);
-    IOHi(bus->busdev_u.spi.csnPin);
+    IOFastHi(&bus->busdev_u.spi.csn);
 
     return true;
 }
@@ -164,10 +178,12 @@ bool spiBusReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data
 uint8_t spiBusReadRegister(const busDevice_t *bus, uint8_t reg)
 {
     uint8_t data;
-    IOLo(bus->busdev_u.spi.csnPin);
+    spiBusWaitForJobs(bus);
+    spiBusConfigure(bus);
+    IOFastLo(&bus->busdev_u.spi.csn);
     spiTransferByte(bus->busdev_u.spi.instance, reg | 0x80); // read transaction
     spiTransfer(bus->busdev_u.spi.instance, NULL, &data, 1);
-    IOHi(bus->busdev_u.spi.csnPin);
+    IOFastHi(&bus->busdev_u.spi.csn);
 
     return data;
 }
@@ -176,5 +192,117 @@ void spiBusSetInstance(busDevice_t *bus, SPI_TypeDef *instance)
 {
     bus->bustype = BUSTYPE_SPI;
     bus->busdev_u.spi.instance = instance;
+    IOFastInit(&bus->busdev_u.spi.csn, bus->busdev_u.spi.csnPin);
+    spiBusRegisterDevice(bus);
+}
+
+// Records a device, so spiBusIsShared() knows who else is on its bus. Devices set up with spiBusSetInstance() are
+// recorded already, this is for devices reached through another one, like a slave of the MPU I2C master.
+void spiBusRegisterDevice(const busDevice_t *bus)
+{
+    for (int i = 0; i < spiBusDeviceCount; i++) {
+        if (spiBusDevices[i] == bus) {
+            return;
+        }
+    }
+    if (spiBusDeviceCount < SPI_BUS_DEVICE_MAX) {
+        spiBusDevices[spiBusDeviceCount++] = bus;
+    } else {
+        spiBusDeviceOverflow = true;
+    }
+}
+
+// For drivers that address the bus by its instance alone, without a busDevice_t, like the SD card
+void spiRegisterDirectUser(SPI_TypeDef *instance)
+{
+    const SPIDevice device = spiDeviceByInstance(instance);
+    if (device != SPIINVALID) {
+        spiDirectUser[device] = true;
+    }
+}
+
+static SPI_TypeDef *spiBusInstance(const busDevice_t *bus)
+{
+    if (bus->bustype == BUSTYPE_MPU_SLAVE) {
+        bus = bus->busdev_u.mpuSlave.master;
+    }
+    return bus->bustype == BUSTYPE_SPI ? bus->busdev_u.spi.instance : NULL;
+}
+
+// Returns true if a device other than the given one uses its bus, or if that cannot be ruled out
+bool spiBusIsShared(const busDevice_t *bus)
+{
+    SPI_TypeDef *instance = spiBusInstance(bus);
+    const SPIDevice device = spiDeviceByInstance(instance);
+    if (device == SPIINVALID || spiDirectUser[device] || spiBusDeviceOverflow) {
+        return true;
+    }
+
+    for (int i = 0; i < spiBusDeviceCount; i++) {
+        if (spiBusDevices[i] != bus && spiBusInstance(spiBusDevices[i]) == instance) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void spiBusSetCsPin(busDevice_t *bus, IO_t csnPin)
+{
+    bus->busdev_u.spi.csnPin = csnPin;
+    IOFastInit(&bus->busdev_u.spi.csn, csnPin);
+}
+
+// The divisor is kept with the device, along with the clock mode the bus is in, and restored before each of its transfers
+void spiBusSetDivisor(busDevice_t *bus, uint16_t divisor)
+{
+    const SPIDevice device = spiDeviceByInstance(bus->busdev_u.spi.instance);
+    if (device != SPIINVALID && !bus->busdev_u.spi.divisor) {
+        bus->busdev_u.spi.leadingEdge = spiDevice[device].leadingEdge;
+    }
+    bus->busdev_u.spi.divisor = divisor;
+
+    spiBusConfigure(bus);
+}
+
+void spiBusSetClockMode(busDevice_t *bus, bool leadingEdge)
+{
+    bus->busdev_u.spi.leadingEdge = leadingEdge;
+
+    spiBusConfigure(bus);
+}
+
+// Only touches the peripheral when the bus was last configured for another device
+void spiBusConfigure(const busDevice_t *bus)
+{
+    if (bus->busdev_u.spi.divisor) {
+        spiSetDivisor(bus->busdev_u.spi.instance, bus->busdev_u.spi.divisor);
+        spiSetClockMode(bus->busdev_u.spi.instance, bus->busdev_u.spi.leadingEdge);
+    }
+}
+
+// Jobs are run by DMA when the bus has DMA streams assigned, otherwise they are run here before returning
+bool spiBusSubmitJob(const busDevice_t *bus, const busSegment_t *segments, busJobCallbackFn callback, uint32_t callbackArg)
+{
+#ifdef USE_SPI_DMA
+    if (spiDmaSubmitJob(bus, segments, callback, callbackArg)) {
+        return true;
+    }
+#endif
+
+    spiBusWaitForJobs(bus);
+    spiBusConfigure(bus);
+    for (const busSegment_t *segment = segments; segment->length; segment++) {
+        IOFastLo(&bus->busdev_u.spi.csn);
+        spiTransfer(bus->busdev_u.spi.instance, segment->txData, segment->rxData, segment->length);
+        if (segment->negateCS || !segment[1].length) {
+            IOFastHi(&bus->busdev_u.spi.csn);
+        }
+    }
+
+    if (callback) {
+        callback(callbackArg);
+    }
+
+    return true;
 }
 #endif
@@ -102,6 +102,7 @@ void spiPreInit(void);
 
 bool spiInit(SPIDevice device);
 void spiSetDivisor(SPI_TypeDef *instance, uint16_t divisor);
+void spiSetClockMode(SPI_TypeDef *instance, bool leadingEdge);
 uint8_t spiTransferByte(SPI_TypeDef *instance, uint8_t data);
 bool spiIsBusBusy(SPI_TypeDef *instance);
 
@@ -118,6 +119,14 @@ bool spiBusWriteRegister(const busDevice_t *bus, uint8_t reg, uint8_t data);
 bool spiBusReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data, uint8_t length);
 uint8_t spiBusReadRegister(const busDevice_t *bus, uint8_t reg);
 void spiBusSetInstance(busDevice_t *bus, SPI_TypeDef *instance);
+void spiBusRegisterDevice(const busDevice_t *bus);
+void spiRegisterDirectUser(SPI_TypeDef *instance);
+bool spiBusIsShared(const busDevice_t *bus);
+void spiBusSetCsPin(busDevice_t *bus, IO_t csnPin);
+void spiBusSetDivisor(busDevice_t *bus, uint16_t divisor);
+void spiBusSetClockMode(busDevice_t *bus, bool leadingEdge);
+void spiBusConfigure(const busDevice_t *bus);
+bool spiBusSubmitJob(const busDevice_t *bus, const busSegment_t *segments, busJobCallbackFn callback, uint32_t callbackArg);
 
 struct spiPinConfig_s;
 void spiPinConfigure(const struct spiPinConfig_s *pConfig);
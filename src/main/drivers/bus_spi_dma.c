@@ -0,0 +1,257 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_SPI_DMA
+
+#include "build/atomic.h"
+
+#include "drivers/bus.h"
+#include "drivers/bus_spi.h"
+#include "drivers/bus_spi_dma.h"
+#include "drivers/bus_spi_impl.h"
+#include "drivers/dma.h"
+#include "drivers/io.h"
+#include "drivers/nvic.h"
+
+// Jobs are queued by the tasks and run from the rx stream completion interrupt, the job at the tail is the one running.
+// Job callbacks are called from that interrupt and must not use the bus themselves.
+
+typedef struct spiDmaHardware_s {
+    DMA_Stream_TypeDef *rxStream;
+    DMA_Stream_TypeDef *txStream;
+    uint32_t channel;
+} spiDmaHardware_t;
+
+static const spiDmaHardware_t spiDmaHardware[SPIDEV_COUNT] = {
+#ifdef SPI1_DMA_RX_STREAM
+    [SPIDEV_1] = { SPI1_DMA_RX_STREAM, SPI1_DMA_TX_STREAM, SPI1_DMA_CHANNEL },
+#endif
+#ifdef SPI2_DMA_RX_STREAM
+    [SPIDEV_2] = { SPI2_DMA_RX_STREAM, SPI2_DMA_TX_STREAM, SPI2_DMA_CHANNEL },
+#endif
+#ifdef SPI3_DMA_RX_STREAM
+    [SPIDEV_3] = { SPI3_DMA_RX_STREAM, SPI3_DMA_TX_STREAM, SPI3_DMA_CHANNEL },
+#endif
+};
+
+typedef struct spiDmaJob_s {
+    const busDevice_t *bus;
+    const busSegment_t *segments;
+    busJobCallbackFn callback;
+    uint32_t callbackArg;
+} spiDmaJob_t;
+
+typedef struct spiDmaBus_s {
+    dmaChannelDescriptor_t *rxDescriptor;
+    dmaChannelDescriptor_t *txDescriptor;
+    spiDmaJob_t jobs[SPI_DMA_JOB_QUEUE_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    const busSegment_t *segment;
+} spiDmaBus_t;
+
+static spiDmaBus_t spiDmaBus[SPIDEV_COUNT];
+
+// source of the bytes clocked out for segments without tx data, and sink for those without rx data
+static const uint8_t spiDmaFill = 0xFF;
+static uint8_t spiDmaDiscard;
+
+static void spiDmaInitStream(DMA_Stream_TypeDef *stream, uint32_t channel, uint32_t direction, SPI_TypeDef *instance)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    DMA_DeInit(stream);
+    DMA_StructInit(&DMA_InitStructure);
+    DMA_InitStructure.DMA_Channel = channel;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&instance->DR;
+    DMA_InitStructure.DMA_DIR = direction;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+    DMA_Init(stream, &DMA_InitStructure);
+}
+
+static void spiDmaSetMemory(DMA_Stream_TypeDef *stream, const uint8_t *buffer, const uint8_t *fill, uint8_t length)
+{
+    // the stream is disabled between segments, so its configuration can be changed
+    if (buffer) {
+        stream->CR |= DMA_SxCR_MINC;
+        stream->M0AR = (uint32_t)buffer;
+    } else {
+        stream->CR &= ~DMA_SxCR_MINC;
+        stream->M0AR = (uint32_t)fill;
+    }
+    stream->NDTR = length;
+}
+
+static void spiDmaStartSegment(spiDmaBus_t *dmaBus)
+{
+    const busSegment_t *segment = dmaBus->segment;
+    const busDevice_t *bus = dmaBus->jobs[dmaBus->tail].bus;
+    SPI_TypeDef *instance = bus->busdev_u.spi.instance;
+
+    spiDmaSetMemory(dmaBus->rxDescriptor->ref, segment->rxData, &spiDmaDiscard, segment->length);
+    spiDmaSetMemory(dmaBus->txDescriptor->ref, segment->txData, &spiDmaFill, segment->length);
+
+    // discard any stale byte left in the data register
+    (void)instance->DR;
+
+    IOFastLo(&bus->busdev_u.spi.csn);
+    DMA_Cmd(dmaBus->rxDescriptor->ref, ENABLE);
+    DMA_Cmd(dmaBus->txDescriptor->ref, ENABLE);
+    SPI_I2S_DMACmd(instance, SPI_I2S_DMAReq_Tx | SPI_I2S_DMAReq_Rx, ENABLE);
+}
+
+static void spiDmaStartJob(spiDmaBus_t *dmaBus)
+{
+    const spiDmaJob_t *job = &dmaBus->jobs[dmaBus->tail];
+
+    spiBusConfigure(job->bus);
+    dmaBus->segment = job->segments;
+    spiDmaStartSegment(dmaBus);
+}
+
+static void spiDmaRxHandler(dmaChannelDescriptor_t *descriptor)
+{
+    const bool transferError = DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TEIF);
+    if (!transferError && !DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
+        return;
+    }
+
+    spiDmaBus_t *dmaBus = &spiDmaBus[descriptor->userParam];
+    const spiDmaJob_t *job = &dmaBus->jobs[dmaBus->tail];
+    const busDevice_t *bus = job->bus;
+
+    // the rx stream completes after the last byte has been clocked in, so the bus is idle
+    SPI_I2S_DMACmd(bus->busdev_u.spi.instance, SPI_I2S_DMAReq_Tx | SPI_I2S_DMAReq_Rx, DISABLE);
+    DMA_Cmd(dmaBus->txDescriptor->ref, DISABLE);
+    DMA_Cmd(dmaBus->rxDescriptor->ref, DISABLE);
+    DMA_CLEAR_FLAG(dmaBus->txDescriptor, DMA_IT_TCIF | DMA_IT_HTIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF);
+    DMA_CLEAR_FLAG(dmaBus->rxDescriptor, DMA_IT_TCIF | DMA_IT_HTIF | DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF);
+
+    const busSegment_t *segment = dmaBus->segment++;
+    if (!transferError && dmaBus->segment->length) {
+        if (segment->negateCS) {
+            IOFastHi(&bus->busdev_u.spi.csn);
+        }
+        spiDmaStartSegment(dmaBus);
+        return;
+    }
+
+    IOFastHi(&bus->busdev_u.spi.csn);
+
+    // a failed job is dropped without calling back, the error is counted as for the polled transfers
+    const busJobCallbackFn callback = transferError ? NULL : job->callback;
+    const uint32_t callbackArg = job->callbackArg;
+    if (transferError) {
+        spiTimeoutUserCallback(bus->busdev_u.spi.instance);
+    }
+
+    dmaBus->tail = (dmaBus->tail + 1) % SPI_DMA_JOB_QUEUE_SIZE;
+    if (dmaBus->tail != dmaBus->head) {
+        spiDmaStartJob(dmaBus);
+    }
+
+    if (callback) {
+        callback(callbackArg);
+    }
+}
+
+// Called from spiInitDevice(), buses without DMA streams assigned, or whose streams are in use, run their jobs polled
+void spiDmaInitDevice(SPIDevice device)
+{
+    const spiDmaHardware_t *hardware = &spiDmaHardware[device];
+    if (!hardware->rxStream || !hardware->txStream) {
+        return;
+    }
+
+    const dmaIdentifier_e rxIdentifier = dmaGetIdentifier(hardware->rxStream);
+    const dmaIdentifier_e txIdentifier = dmaGetIdentifier(hardware->txStream);
+    if (dmaGetOwner(rxIdentifier) != OWNER_FREE || dmaGetOwner(txIdentifier) != OWNER_FREE) {
+        return;
+    }
+
+    spiDmaBus_t *dmaBus = &spiDmaBus[device];
+    SPI_TypeDef *instance = spiDevice[device].dev;
+
+    dmaInit(rxIdentifier, OWNER_SPI_DMA, RESOURCE_INDEX(device));
+    dmaInit(txIdentifier, OWNER_SPI_DMA, RESOURCE_INDEX(device));
+    dmaBus->rxDescriptor = dmaGetDescriptorByIdentifier(rxIdentifier);
+    dmaBus->txDescriptor = dmaGetDescriptorByIdentifier(txIdentifier);
+
+    spiDmaInitStream(hardware->txStream, hardware->channel, DMA_DIR_MemoryToPeripheral, instance);
+    spiDmaInitStream(hardware->rxStream, hardware->channel, DMA_DIR_PeripheralToMemory, instance);
+
+    DMA_ITConfig(hardware->rxStream, DMA_IT_TC | DMA_IT_TE, ENABLE);
+    dmaSetHandler(rxIdentifier, spiDmaRxHandler, NVIC_PRIO_SPI_DMA, device);
+}
+
+// Returns false if the bus has no DMA or its queue is full, the job is then left to the caller
+bool spiDmaSubmitJob(const busDevice_t *bus, const busSegment_t *segments, busJobCallbackFn callback, uint32_t callbackArg)
+{
+    const SPIDevice device = spiDeviceByInstance(bus->busdev_u.spi.instance);
+    if (device == SPIINVALID || !spiDmaBus[device].rxDescriptor || !segments->length) {
+        return false;
+    }
+
+    spiDmaBus_t *dmaBus = &spiDmaBus[device];
+    const uint8_t head = dmaBus->head;
+    const uint8_t nextHead = (head + 1) % SPI_DMA_JOB_QUEUE_SIZE;
+    if (nextHead == dmaBus->tail) {
+        return false;
+    }
+
+    spiDmaJob_t *job = &dmaBus->jobs[head];
+    job->bus = bus;
+    job->segments = segments;
+    job->callback = callback;
+    job->callbackArg = callbackArg;
+
+    ATOMIC_BLOCK(NVIC_PRIO_SPI_DMA) {
+        const bool busIdle = dmaBus->tail == head;
+        dmaBus->head = nextHead;
+        if (busIdle) {
+            spiDmaStartJob(dmaBus);
+        }
+    }
+
+    return true;
+}
+
+void spiDmaWaitForJobs(SPI_TypeDef *instance)
+{
+    const SPIDevice device = spiDeviceByInstance(instance);
+    if (device == SPIINVALID) {
+        return;
+    }
+
+    const spiDmaBus_t *dmaBus = &spiDmaBus[device];
+    while (dmaBus->tail != dmaBus->head);
+}
+
+#endif // USE_SPI_DMA
@@ -0,0 +1,49 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "drivers/bus.h"
+#include "drivers/bus_spi.h"
+
+// DMA driven SPI bus jobs.
+// Each bus with DMA streams assigned queues the jobs submitted by its devices and runs them back to back
+// from the DMA completion interrupt, so the tasks submitting them never wait on the bus.
+
+#define SPI_DMA_JOB_QUEUE_SIZE 8    // one more than the number of jobs that can be queued, a power of two
+
+#ifdef USE_SPI_DMA
+void spiDmaInitDevice(SPIDevice device);
+bool spiDmaSubmitJob(const busDevice_t *bus, const busSegment_t *segments, busJobCallbackFn callback, uint32_t callbackArg);
+void spiDmaWaitForJobs(SPI_TypeDef *instance);
+#endif
+
+// Called before a synchronous transfer, so it cannot interleave with a job running on the same bus
+static inline void spiBusWaitForJobs(const busDevice_t *bus)
+{
+#ifdef USE_SPI_DMA
+    spiDmaWaitForJobs(bus->busdev_u.spi.instance);
+#else
+    UNUSED(bus);
+#endif
+}
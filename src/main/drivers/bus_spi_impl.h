@@ -64,7 +64,8 @@ typedef struct SPIDevice_s {
 #endif
     rccPeriphTag_t rcc;
     volatile uint16_t errorCount;
-    bool leadingEdge;
+    bool leadingEdge;           // clock mode the bus is in
+    uint16_t divisor;           // divisor last applied, 0 until the first spiSetDivisor()
 #if defined(USE_HAL_DRIVER)
     SPI_HandleTypeDef hspi;
     DMA_HandleTypeDef hdma;
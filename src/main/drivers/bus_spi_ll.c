@@ -214,8 +214,17 @@ bool spiTransfer(SPI_TypeDef *instance, const uint8_t *txData, uint8_t *rxData,
     return true;
 }
 
+// The peripheral is only reconfigured when the divisor differs from the one last applied
 void spiSetDivisor(SPI_TypeDef *instance, uint16_t divisor)
 {
+    const SPIDevice device = spiDeviceByInstance(instance);
+    if (device != SPIINVALID) {
+        if (divisor && divisor == spiDevice[device].divisor) {
+            return;
+        }
+        spiDevice[device].divisor = divisor;
+    }
+
 #if !(defined(STM32F1) || defined(STM32F3))
     // SPI2 and SPI3 are on APB1/AHB1 which PCLK is half that of APB2/AHB2.
 
@@ -228,4 +237,18 @@ void spiSetDivisor(SPI_TypeDef *instance, uint16_t divisor)
     LL_SPI_SetBaudRatePrescaler(instance, divisor ? (ffs(divisor | 0x100) - 2) << SPI_CR1_BR_Pos : 0);
     LL_SPI_Enable(instance);
 }
+
+void spiSetClockMode(SPI_TypeDef *instance, bool leadingEdge)
+{
+    const SPIDevice device = spiDeviceByInstance(instance);
+    if (device == SPIINVALID || spiDevice[device].leadingEdge == leadingEdge) {
+        return;
+    }
+    spiDevice[device].leadingEdge = leadingEdge;
+
+    LL_SPI_Disable(instance);
+    LL_SPI_SetClockPolarity(instance, leadingEdge ? SPI_POLARITY_LOW : SPI_POLARITY_HIGH);
+    LL_SPI_SetClockPhase(instance, leadingEdge ? SPI_PHASE_1EDGE : SPI_PHASE_2EDGE);
+    LL_SPI_Enable(instance);
+}
 #endif
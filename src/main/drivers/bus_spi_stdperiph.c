@@ -28,6 +28,7 @@
 
 #include "drivers/bus.h"
 #include "drivers/bus_spi.h"
+#include "drivers/bus_spi_dma.h"
 #include "drivers/bus_spi_impl.h"
 #include "drivers/exti.h"
 #include "drivers/io.h"
@@ -97,6 +98,10 @@ void spiInitDevice(SPIDevice device)
 
     SPI_Init(spi->dev, &spiInit);
     SPI_Cmd(spi->dev, ENABLE);
+
+#ifdef USE_SPI_DMA
+    spiDmaInitDevice(device);
+#endif
 }
 
 // return uint8_t value or -1 when failure
@@ -172,10 +177,19 @@ bool spiTransfer(SPI_TypeDef *instance, const uint8_t *txData, uint8_t *rxData,
     return true;
 }
 
+// The peripheral is only reconfigured when the divisor differs from the one last applied
 void spiSetDivisor(SPI_TypeDef *instance, uint16_t divisor)
 {
 #define BR_BITS ((BIT(5) | BIT(4) | BIT(3)))
 
+    const SPIDevice device = spiDeviceByInstance(instance);
+    if (device != SPIINVALID) {
+        if (divisor && divisor == spiDevice[device].divisor) {
+            return;
+        }
+        spiDevice[device].divisor = divisor;
+    }
+
 #if !(defined(STM32F1) || defined(STM32F3))
     // SPI2 and SPI3 are on APB1/AHB1 which PCLK is half that of APB2/AHB2.
 
@@ -193,4 +207,24 @@ void spiSetDivisor(SPI_TypeDef *instance, uint16_t divisor)
 
 #undef BR_BITS
 }
+
+void spiSetClockMode(SPI_TypeDef *instance, bool leadingEdge)
+{
+    const SPIDevice device = spiDeviceByInstance(instance);
+    if (device == SPIINVALID || spiDevice[device].leadingEdge == leadingEdge) {
+        return;
+    }
+    spiDevice[device].leadingEdge = leadingEdge;
+
+    SPI_Cmd(instance, DISABLE);
+
+    // leading edge is CPOL low with CPHA on the first edge, trailing edge is CPOL high with CPHA on the second edge
+    if (leadingEdge) {
+        instance->CR1 &= ~(SPI_CR1_CPOL | SPI_CR1_CPHA);
+    } else {
+        instance->CR1 |= SPI_CR1_CPOL | SPI_CR1_CPHA;
+    }
+
+    SPI_Cmd(instance, ENABLE);
+}
 #endif
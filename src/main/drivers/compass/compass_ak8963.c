@@ -380,7 +380,7 @@ void ak8963BusInit(const busDevice_t *busdev)
         IOHi(busdev->busdev_u.spi.csnPin);                                                  // Disable
         IOInit(busdev->busdev_u.spi.csnPin, OWNER_COMPASS_CS, 0);
         IOConfigGPIO(busdev->busdev_u.spi.csnPin, IOCFG_OUT_PP);
-        spiSetDivisor(busdev->busdev_u.spi.instance, SPI_CLOCK_STANDARD);
+        spiBusSetDivisor(busdev, SPI_CLOCK_STANDARD);
         break;
 #endif
 
@@ -197,7 +197,7 @@ static void hmc5883SpiInit(busDevice_t *busdev)
     IOInit(busdev->busdev_u.spi.csnPin, OWNER_COMPASS_CS, 0);
     IOConfigGPIO(busdev->busdev_u.spi.csnPin, IOCFG_OUT_PP);
 
-    spiSetDivisor(busdev->busdev_u.spi.instance, SPI_CLOCK_STANDARD);
+    spiBusSetDivisor(busdev, SPI_CLOCK_STANDARD);
 }
 #endif
 
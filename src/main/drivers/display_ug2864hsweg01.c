@@ -20,6 +20,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -173,8 +174,23 @@ static const uint8_t multiWiiFont[][5] = { // Refer to "Times New Roman" Font Da
                 { 0x7A, 0x7E, 0x7E, 0x7E, 0x7A }, //   (131)    - 0x00C8 Vertical Bargraph - 6 (full)
         };
 
+// The dashboard draws into a copy of the display RAM, the pages that changed are sent to the display in the background
+#define OLED_PAGE_COUNT (SCREEN_HEIGHT / 8)
+
+static uint8_t oledFrameBuffer[OLED_PAGE_COUNT][SCREEN_WIDTH];
+static uint8_t oledDirtyPages;
+static uint8_t oledCursorPage;
+static uint8_t oledCursorColumn;
+
+static int8_t oledAddressedPage = -1;   // page the display was pointed at, its data is sent next
+static int8_t oledSendingPage = -1;     // page whose data was sent last
+static uint8_t oledPageAddressCommands[3];
+
 static bool i2c_OLED_send_cmd(busDevice_t *bus, uint8_t command)
 {
+    // the display is pointed somewhere else, so a page waiting for its data has to be addressed again
+    oledAddressedPage = -1;
+
     return i2cWrite(bus->busdev_u.i2c.device, bus->busdev_u.i2c.address, 0x80, command);
 }
 
@@ -189,25 +205,32 @@ static bool i2c_OLED_send_cmdarray(busDevice_t *bus, const uint8_t *commands, si
     return true;
 }
 
-static bool i2c_OLED_send_byte(busDevice_t *bus, uint8_t val)
+static void i2c_OLED_send_byte(uint8_t val)
 {
-    return i2cWrite(bus->busdev_u.i2c.device, bus->busdev_u.i2c.address, 0x40, val);
+    if (oledCursorPage >= OLED_PAGE_COUNT) {
+        return;
+    }
+
+    if (oledFrameBuffer[oledCursorPage][oledCursorColumn] != val) {
+        oledFrameBuffer[oledCursorPage][oledCursorColumn] = val;
+        oledDirtyPages |= 1 << oledCursorPage;
+    }
+
+    if (++oledCursorColumn == SCREEN_WIDTH) {
+        oledCursorColumn = 0;
+        oledCursorPage++;
+    }
 }
 
 void i2c_OLED_clear_display_quick(busDevice_t *bus)
 {
-    static const uint8_t i2c_OLED_cmd_clear_display_quick[] = {
-        0xb0, // set page address to 0
-        0x40, // Display start line register to 0
-        0,    // Set low col address to 0
-        0x10, // Set high col address to 0
-    };
-
-    i2c_OLED_send_cmdarray(bus, i2c_OLED_cmd_clear_display_quick, ARRAYLEN(i2c_OLED_cmd_clear_display_quick));
+    UNUSED(bus);
 
-    for (uint16_t i = 0; i < 1024; i++) {      // fill the display's RAM with graphic... 128*64 pixel picture
-        i2c_OLED_send_byte(bus, 0x00);  // clear
-    }
+    memset(oledFrameBuffer, 0, sizeof(oledFrameBuffer));
+    // the display RAM is unknown after a reset, so all of it is sent
+    oledDirtyPages = (1 << OLED_PAGE_COUNT) - 1;
+    oledCursorPage = 0;
+    oledCursorColumn = 0;
 }
 
 void i2c_OLED_clear_display(busDevice_t *bus)
@@ -216,7 +239,7 @@ void i2c_OLED_clear_display(busDevice_t *bus)
         0xa6, // Set Normal Display
         0xae, // Display OFF
         0x20, // Set Memory Addressing Mode
-        0x00, // Set Memory Addressing Mode to Horizontal addressing mode
+        0x02, // Set Memory Addressing Mode to Page addressing mode, each page is sent on its own
     };
 
     i2c_OLED_send_cmdarray(bus, i2c_OLED_cmd_clear_display_pre, ARRAYLEN(i2c_OLED_cmd_clear_display_pre));
@@ -234,13 +257,10 @@ void i2c_OLED_clear_display(busDevice_t *bus)
 
 void i2c_OLED_set_xy(busDevice_t *bus, uint8_t col, uint8_t row)
 {
-    uint8_t i2c_OLED_cmd_set_xy[] = {
-        0xb0 + row,                                            //set page address
-        0x00 + ((CHARACTER_WIDTH_TOTAL * col) & 0x0f),         //set low col address
-        0x10 + (((CHARACTER_WIDTH_TOTAL * col) >> 4) & 0x0f)   //set high col address
-    };
+    UNUSED(bus);
 
-    i2c_OLED_send_cmdarray(bus, i2c_OLED_cmd_set_xy, ARRAYLEN(i2c_OLED_cmd_set_xy));
+    oledCursorPage = row;
+    oledCursorColumn = (CHARACTER_WIDTH_TOTAL * col) % SCREEN_WIDTH;
 }
 
 void i2c_OLED_set_line(busDevice_t *bus, uint8_t row)
@@ -250,14 +270,16 @@ void i2c_OLED_set_line(busDevice_t *bus, uint8_t row)
 
 void i2c_OLED_send_char(busDevice_t *bus, unsigned char ascii)
 {
+    UNUSED(bus);
+
     unsigned char i;
     uint8_t buffer;
     for (i = 0; i < 5; i++) {
         buffer = multiWiiFont[ascii - 32][i];
         buffer ^= CHAR_FORMAT;  // apply
-        i2c_OLED_send_byte(bus, buffer);
+        i2c_OLED_send_byte(buffer);
     }
-    i2c_OLED_send_byte(bus, CHAR_FORMAT);    // the gap
+    i2c_OLED_send_byte(CHAR_FORMAT);    // the gap
 }
 
 void i2c_OLED_send_string(busDevice_t *bus, const char *string)
@@ -269,6 +291,58 @@ void i2c_OLED_send_string(busDevice_t *bus, const char *string)
     }
 }
 
+// Starts the next transfer of the dirty pages if the bus is free, a page is sent as its address and then its data
+bool i2c_OLED_update(busDevice_t *bus)
+{
+    const I2CDevice device = bus->busdev_u.i2c.device;
+    bool error;
+
+    if (i2cBusy(device, &error)) {
+        return true;
+    }
+
+    if (error) {
+        // the page is still dirty if only its address was lost
+        if (oledSendingPage >= 0) {
+            oledDirtyPages |= 1 << oledSendingPage;
+        }
+        oledAddressedPage = -1;
+    }
+    oledSendingPage = -1;
+
+    if (oledAddressedPage >= 0) {
+        const int8_t page = oledAddressedPage;
+        oledAddressedPage = -1;
+
+        // a page drawn into while its data is sent is marked again and sent once more
+        oledDirtyPages &= ~(1 << page);
+        if (i2cWriteBufferStart(device, bus->busdev_u.i2c.address, 0x40, SCREEN_WIDTH, oledFrameBuffer[page])) {
+            oledSendingPage = page;
+        } else {
+            oledDirtyPages |= 1 << page;
+        }
+        return true;
+    }
+
+    if (!oledDirtyPages) {
+        return false;
+    }
+
+    int8_t page = 0;
+    while (!(oledDirtyPages & (1 << page))) {
+        page++;
+    }
+
+    oledPageAddressCommands[0] = 0xb0 + page; // set page address
+    oledPageAddressCommands[1] = 0x00;        // set low col address to 0
+    oledPageAddressCommands[2] = 0x10;        // set high col address to 0
+    if (i2cWriteBufferStart(device, bus->busdev_u.i2c.address, 0x00, ARRAYLEN(oledPageAddressCommands), oledPageAddressCommands)) {
+        oledAddressedPage = page;
+    }
+
+    return true;
+}
+
 /**
 * according to http://www.adafruit.com/datasheets/UG-2864HSWEG01.pdf Chapter 4.4 Page 15
 */
@@ -40,13 +40,10 @@ typedef struct dmaChannelDescriptor_s {
     resourceOwner_e             owner;
     uint8_t                     resourceIndex;
     uint32_t                    completeFlag;
+    bool                        shareable;      // allocated with dmaAllocateShared()
+    volatile bool               busy;           // a transfer between dmaAcquire() and dmaRelease() is running
 } dmaChannelDescriptor_t;
 
-#if defined(STM32F7)
-//#define HAL_CLEANINVALIDATECACHE(addr, size) (SCB_CleanInvalidateDCache_by_Addr((uint32_t*)((uint32_t)addr & ~0x1f), ((uint32_t)(addr + size + 0x1f) & ~0x1f) - ((uint32_t)addr & ~0x1f)))
-//#define HAL_CLEANCACHE(addr, size) (SCB_CleanDCache_by_Addr((uint32_t*)((uint32_t)addr & ~0x1f), ((uint32_t)(addr + size + 0x1f) & ~0x1f) - ((uint32_t)addr & ~0x1f)))
-
-#endif
 
 #define DMA_IDENTIFIER_TO_INDEX(x) ((x) - 1)
 
@@ -176,3 +173,20 @@ void dmaSetHandler(dmaIdentifier_e identifier, dmaCallbackHandlerFuncPtr callbac
 resourceOwner_e dmaGetOwner(dmaIdentifier_e identifier);
 uint8_t dmaGetResourceIndex(dmaIdentifier_e identifier);
 dmaChannelDescriptor_t* dmaGetDescriptorByIdentifier(const dmaIdentifier_e identifier);
+
+bool dmaAllocate(dmaIdentifier_e identifier, resourceOwner_e owner, uint8_t resourceIndex);
+bool dmaAllocateShared(dmaIdentifier_e identifier, resourceOwner_e owner);
+bool dmaAcquire(dmaIdentifier_e identifier, resourceOwner_e owner);
+void dmaRelease(dmaIdentifier_e identifier);
+uint8_t dmaGetAllocateFailureCount(void);
+uint32_t dmaGetAcquireFailureCount(void);
+
+// Data cache maintenance for DMA buffers outside DMA_RAM. Clean a buffer before the DMA reads it, invalidate a buffer
+// before and after the DMA writes it. Buffers in the DTCM are not cached and are skipped.
+#if defined(STM32F7)
+void dmaCacheClean(const void *buffer, uint32_t size);
+void dmaCacheInvalidate(void *buffer, uint32_t size);
+#else
+#define dmaCacheClean(buffer, size) {}
+#define dmaCacheInvalidate(buffer, size) {}
+#endif
@@ -0,0 +1,104 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "drivers/dma.h"
+
+/*
+ * DMA stream arbitration.
+ *
+ * A stream allocated by one owner is never taken over by another, so a
+ * feature mapped onto a stream that is already in use is left without DMA
+ * instead of silently breaking the other user.
+ *
+ * Owners that only send occasional frames, with no timing relation to each
+ * other, allocate the stream shared. They acquire it for each transfer and
+ * release it from their transfer complete interrupt, reconfiguring the
+ * stream when another owner used it last.
+ */
+
+static uint8_t allocateFailureCount;
+static uint32_t acquireFailureCount;
+
+// Allocates a stream for exclusive use, fails when another owner holds it
+bool dmaAllocate(dmaIdentifier_e identifier, resourceOwner_e owner, uint8_t resourceIndex)
+{
+    const dmaChannelDescriptor_t *descriptor = dmaGetDescriptorByIdentifier(identifier);
+    if (descriptor->owner != OWNER_FREE && (descriptor->owner != owner || descriptor->resourceIndex != resourceIndex)) {
+        allocateFailureCount++;
+        return false;
+    }
+
+    dmaInit(identifier, owner, resourceIndex);
+    return true;
+}
+
+// Allocates a stream that other shared owners can use in turn, fails when an exclusive owner holds it
+bool dmaAllocateShared(dmaIdentifier_e identifier, resourceOwner_e owner)
+{
+    dmaChannelDescriptor_t *descriptor = dmaGetDescriptorByIdentifier(identifier);
+    if (descriptor->owner == OWNER_FREE) {
+        dmaInit(identifier, owner, 0);
+        descriptor->shareable = true;
+        return true;
+    }
+
+    // the stream stays configured for the current owner until this one acquires it
+    if (!descriptor->shareable) {
+        allocateFailureCount++;
+    }
+    return descriptor->shareable;
+}
+
+// Returns false while the transfer of another owner is running.
+// The caller reconfigures the stream if dmaGetOwner() was another owner before acquiring it.
+bool dmaAcquire(dmaIdentifier_e identifier, resourceOwner_e owner)
+{
+    dmaChannelDescriptor_t *descriptor = dmaGetDescriptorByIdentifier(identifier);
+    if (descriptor->busy) {
+        acquireFailureCount++;
+        return false;
+    }
+
+    descriptor->busy = true;
+    descriptor->owner = owner;
+    return true;
+}
+
+void dmaRelease(dmaIdentifier_e identifier)
+{
+    dmaGetDescriptorByIdentifier(identifier)->busy = false;
+}
+
+// Number of allocations refused because the stream was held by another owner
+uint8_t dmaGetAllocateFailureCount(void)
+{
+    return allocateFailureCount;
+}
+
+// Number of transfers that could not start because another owner was using the shared stream
+uint32_t dmaGetAcquireFailureCount(void)
+{
+    return acquireFailureCount;
+}
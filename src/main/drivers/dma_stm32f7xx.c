@@ -139,3 +139,30 @@ uint32_t dmaGetChannel(const uint8_t channel)
 {
     return ((uint32_t)channel*2)<<24;
 }
+
+#define DMA_CACHE_LINE_SIZE 32
+
+static bool dmaBufferIsCached(uint32_t address)
+{
+    // the DTCM ends where SRAM1 starts
+    return address < RAMDTCM_BASE || address >= SRAM1_BASE;
+}
+
+void dmaCacheClean(const void *buffer, uint32_t size)
+{
+    const uint32_t address = (uint32_t)buffer;
+    if (size && dmaBufferIsCached(address)) {
+        const uint32_t lineAddress = address & ~(DMA_CACHE_LINE_SIZE - 1);
+        SCB_CleanDCache_by_Addr((uint32_t *)lineAddress, address + size - lineAddress);
+    }
+}
+
+// Lines are cleaned as well, so that data the CPU wrote next to a buffer that is not DMA_ALIGNED is not lost
+void dmaCacheInvalidate(void *buffer, uint32_t size)
+{
+    const uint32_t address = (uint32_t)buffer;
+    if (size && dmaBufferIsCached(address)) {
+        const uint32_t lineAddress = address & ~(DMA_CACHE_LINE_SIZE - 1);
+        SCB_CleanInvalidateDCache_by_Addr((uint32_t *)lineAddress, address + size - lineAddress);
+    }
+}
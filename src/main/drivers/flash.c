@@ -31,6 +31,7 @@
 #include "flash_impl.h"
 #include "flash_m25p16.h"
 #include "flash_w25m.h"
+#include "flash_w25n01g.h"
 #include "drivers/bus_spi.h"
 #include "drivers/io.h"
 #include "drivers/time.h"
@@ -47,7 +48,7 @@ bool flashInit(const flashConfig_t *flashConfig)
     busdev = &busInstance;
 
     if (flashConfig->csTag) {
-        busdev->busdev_u.spi.csnPin = IOGetByTag(flashConfig->csTag);
+        spiBusSetCsPin(busdev, IOGetByTag(flashConfig->csTag));
     } else {
         return false;
     }
@@ -66,20 +67,21 @@ bool flashInit(const flashConfig_t *flashConfig)
 #ifndef FLASH_SPI_SHARED
     //Maximum speed for standard READ command is 20mHz, other commands tolerate 25mHz
     //spiSetDivisor(busdev->busdev_u.spi.instance, SPI_CLOCK_FAST);
-    spiSetDivisor(busdev->busdev_u.spi.instance, SPI_CLOCK_STANDARD*2);
+    spiBusSetDivisor(busdev, SPI_CLOCK_STANDARD*2);
 #endif
 
     flashDevice.busdev = busdev;
 
-    const uint8_t out[] = { SPIFLASH_INSTRUCTION_RDID, 0, 0, 0 };
+    const uint8_t out[] = { SPIFLASH_INSTRUCTION_RDID, 0, 0, 0, 0 };
 
     delay(50); // short delay required after initialisation of SPI device instance.
 
     /* Just in case transfer fails and writes nothing, so we don't try to verify the ID against random garbage
      * from the stack:
      */
-    uint8_t in[4];
+    uint8_t in[5];
     in[1] = 0;
+    in[2] = 0;
 
     // Clearing the CS bit terminates the command early so we don't have to read the chip UID:
     spiBusTransfer(busdev, out, in, sizeof(out));
@@ -87,6 +89,9 @@ bool flashInit(const flashConfig_t *flashConfig)
     // Manufacturer, memory type, and capacity
     uint32_t chipID = (in[1] << 16) | (in[2] << 8) | (in[3]);
 
+    // A NAND flash answers after a dummy byte
+    uint32_t nandChipID = (in[2] << 16) | (in[3] << 8) | (in[4]);
+
 #ifdef USE_FLASH_M25P16
     if (m25p16_detect(&flashDevice, chipID)) {
         return true;
@@ -99,6 +104,12 @@ bool flashInit(const flashConfig_t *flashConfig)
     }
 #endif
 
+#ifdef USE_FLASH_W25N01G
+    if (w25n01g_detect(&flashDevice, nandChipID)) {
+        return true;
+    }
+#endif
+
     spiPreinitCsByTag(flashConfig->csTag);
 
     return false;
@@ -149,9 +160,12 @@ int flashReadBytes(uint32_t address, uint8_t *buffer, int length)
     return flashDevice.vTable->readBytes(&flashDevice, address, buffer, length);
 }
 
+// Only a NAND flash holds data back until a page is full
 void flashFlush(void)
 {
-    flashDevice.vTable->flush(&flashDevice);
+    if (flashDevice.vTable->flush) {
+        flashDevice.vTable->flush(&flashDevice);
+    }
 }
 
 static const flashGeometry_t noFlashGeometry = {
@@ -25,9 +25,13 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
+#include "common/utils.h"
+
 #ifdef USE_FLASH_M25P16
 
 #include "drivers/bus_spi.h"
+#include "drivers/bus_spi_dma.h"
 #include "drivers/flash.h"
 #include "drivers/flash_impl.h"
 #include "drivers/io.h"
@@ -77,65 +81,117 @@
 
 STATIC_ASSERT(M25P16_PAGESIZE < FLASH_MAX_PAGE_SIZE, M25P16_PAGESIZE_too_small);
 
+// A bus segment is at most 255 bytes long, so a page takes two
+#define M25P16_PROGRAM_SEGMENT_SIZE (M25P16_PAGESIZE / 2)
+
 const flashVTable_t m25p16_vTable;
 
-static void m25p16_disable(busDevice_t *bus)
+/*
+ * Program, erase and status poll operations are submitted as bus jobs, which run by DMA when the bus has DMA
+ * streams, so that they never wait on the bus. A job holds on to its buffers, including the caller's data of
+ * a page program, until it completes, until then the device isn't ready.
+ *
+ * Only one job runs at a time, the device is busy after each one but a status poll.
+ */
+static const uint8_t jobWriteEnable = M25P16_INSTRUCTION_WRITE_ENABLE;
+static const uint8_t statusCommand[2] = { M25P16_INSTRUCTION_READ_STATUS_REG, 0 };
+static uint8_t jobCommand[5];
+static uint8_t statusReply[2];
+static busSegment_t jobSegments[5];
+static volatile bool jobInFlight;
+
+// The device whose status was read by the last status poll, NULL once the status has been consumed
+static flashDevice_t *volatile statusDevice;
+
+static void m25p16_jobComplete(uint32_t arg)
 {
-    IOHi(bus->busdev_u.spi.csnPin);
-    __NOP();
+    UNUSED(arg);
+
+    jobInFlight = false;
 }
 
-static void m25p16_enable(busDevice_t *bus)
+static void m25p16_statusComplete(uint32_t arg)
 {
-    __NOP();
-    IOLo(bus->busdev_u.spi.csnPin);
+    statusDevice = (flashDevice_t *)(uintptr_t)arg;
+    jobInFlight = false;
 }
 
-static void m25p16_transfer(busDevice_t *bus, const uint8_t *txData, uint8_t *rxData, int len)
+static void m25p16_submitJob(flashDevice_t *fdevice, busJobCallbackFn callback)
 {
-    m25p16_enable(bus);
-    spiTransfer(bus->busdev_u.spi.instance, txData, rxData, len);
-    m25p16_disable(bus);
+    jobInFlight = true;
+    spiBusSubmitJob(fdevice->busdev, jobSegments, callback, (uintptr_t)fdevice);
 }
 
 /**
- * Send the given command byte to the device.
+ * Submit the given command after a write enable, the device is busy until the write it starts completes.
  */
-static void m25p16_performOneByteCommand(busDevice_t *bus, uint8_t command)
+static void m25p16_submitWriteCommand(flashDevice_t *fdevice, int commandLength, const uint8_t *data, int length)
 {
-    m25p16_enable(bus);
+    busSegment_t *segment = jobSegments;
+    *segment++ = (busSegment_t){ &jobWriteEnable, NULL, 1, true };
+    *segment++ = (busSegment_t){ jobCommand, NULL, commandLength, false };
+    for (int offset = 0; offset < length; offset += M25P16_PROGRAM_SEGMENT_SIZE) {
+        *segment++ = (busSegment_t){ data + offset, NULL, MIN(length - offset, M25P16_PROGRAM_SEGMENT_SIZE), false };
+    }
+    *segment = (busSegment_t){ NULL, NULL, 0, false };
 
-    spiTransferByte(bus->busdev_u.spi.instance, command);
+    fdevice->couldBeBusy = true;
+    statusDevice = NULL;
+    m25p16_submitJob(fdevice, m25p16_jobComplete);
+}
 
-    m25p16_disable(bus);
+static void m25p16_disable(busDevice_t *bus)
+{
+    IOFastHi(&bus->busdev_u.spi.csn);
+    __NOP();
 }
 
-/**
- * The flash requires this write enable command to be sent before commands that would cause
- * a write like program and erase.
- */
-static void m25p16_writeEnable(flashDevice_t *fdevice)
+static void m25p16_enable(busDevice_t *bus)
 {
-    m25p16_performOneByteCommand(fdevice->busdev, M25P16_INSTRUCTION_WRITE_ENABLE);
+    // Polled transfers mustn't interleave with jobs of other devices on the bus
+    spiBusWaitForJobs(bus);
 
-    // Assume that we're about to do some writing, so the device is just about to become busy
-    fdevice->couldBeBusy = true;
+    __NOP();
+    IOFastLo(&bus->busdev_u.spi.csn);
 }
 
-static uint8_t m25p16_readStatus(busDevice_t *bus)
+/**
+ * Send the given command byte to the device.
+ */
+static void m25p16_performOneByteCommand(busDevice_t *bus, uint8_t command)
 {
-    const uint8_t command[2] = { M25P16_INSTRUCTION_READ_STATUS_REG, 0 };
-    uint8_t in[2];
+    m25p16_enable(bus);
 
-    m25p16_transfer(bus, command, in, sizeof(command));
+    spiTransferByte(bus->busdev_u.spi.instance, command);
 
-    return in[1];
+    m25p16_disable(bus);
 }
 
+/**
+ * Never waits for the device. While it could be busy, each call consumes the status read by the previous one
+ * and submits the next status poll. On a bus without DMA the poll completes right away.
+ */
 static bool m25p16_isReady(flashDevice_t *fdevice)
 {
+    if (jobInFlight) {
+        return false;
+    }
+
     // If couldBeBusy is false, don't bother to poll the flash chip for its status
-    fdevice->couldBeBusy = fdevice->couldBeBusy && ((m25p16_readStatus(fdevice->busdev) & M25P16_STATUS_FLAG_WRITE_IN_PROGRESS) != 0);
+    if (fdevice->couldBeBusy) {
+        if (statusDevice != fdevice) {
+            jobSegments[0] = (busSegment_t){ statusCommand, statusReply, sizeof(statusCommand), false };
+            jobSegments[1] = (busSegment_t){ NULL, NULL, 0, false };
+            m25p16_submitJob(fdevice, m25p16_statusComplete);
+
+            if (statusDevice != fdevice) {
+                return false;
+            }
+        }
+
+        statusDevice = NULL;
+        fdevice->couldBeBusy = (statusReply[1] & M25P16_STATUS_FLAG_WRITE_IN_PROGRESS) != 0;
+    }
 
     return !fdevice->couldBeBusy;
 }
@@ -227,24 +283,21 @@ static void m25p16_setCommandAddress(uint8_t *buf, uint32_t address, bool useLon
  */
 static void m25p16_eraseSector(flashDevice_t *fdevice, uint32_t address)
 {
-    uint8_t out[5] = { M25P16_INSTRUCTION_SECTOR_ERASE };
-
-    m25p16_setCommandAddress(&out[1], address, fdevice->isLargeFlash);
-
     m25p16_waitForReady(fdevice, SECTOR_ERASE_TIMEOUT_MILLIS);
 
-    m25p16_writeEnable(fdevice);
+    jobCommand[0] = M25P16_INSTRUCTION_SECTOR_ERASE;
+    m25p16_setCommandAddress(&jobCommand[1], address, fdevice->isLargeFlash);
 
-    m25p16_transfer(fdevice->busdev, out, NULL, sizeof(out));
+    m25p16_submitWriteCommand(fdevice, fdevice->isLargeFlash ? 5 : 4, NULL, 0);
 }
 
 static void m25p16_eraseCompletely(flashDevice_t *fdevice)
 {
     m25p16_waitForReady(fdevice, BULK_ERASE_TIMEOUT_MILLIS);
 
-    m25p16_writeEnable(fdevice);
+    jobCommand[0] = M25P16_INSTRUCTION_BULK_ERASE;
 
-    m25p16_performOneByteCommand(fdevice->busdev, M25P16_INSTRUCTION_BULK_ERASE);
+    m25p16_submitWriteCommand(fdevice, 1, NULL, 0);
 }
 
 static void m25p16_pageProgramBegin(flashDevice_t *fdevice, uint32_t address)
@@ -254,23 +307,17 @@ static void m25p16_pageProgramBegin(flashDevice_t *fdevice, uint32_t address)
     fdevice->currentWriteAddress = address;
 }
 
+/**
+ * Program the data at the current write address. The data must stay untouched until the device is ready again.
+ */
 static void m25p16_pageProgramContinue(flashDevice_t *fdevice, const uint8_t *data, int length)
 {
-    uint8_t command[5] = { M25P16_INSTRUCTION_PAGE_PROGRAM };
-
-    m25p16_setCommandAddress(&command[1], fdevice->currentWriteAddress, fdevice->isLargeFlash);
-
     m25p16_waitForReady(fdevice, DEFAULT_TIMEOUT_MILLIS);
 
-    m25p16_writeEnable(fdevice);
-
-    m25p16_enable(fdevice->busdev);
+    jobCommand[0] = M25P16_INSTRUCTION_PAGE_PROGRAM;
+    m25p16_setCommandAddress(&jobCommand[1], fdevice->currentWriteAddress, fdevice->isLargeFlash);
 
-    spiTransfer(fdevice->busdev->busdev_u.spi.instance, command, NULL, fdevice->isLargeFlash ? 5 : 4);
-
-    spiTransfer(fdevice->busdev->busdev_u.spi.instance, data, NULL, length);
-
-    m25p16_disable(fdevice->busdev);
+    m25p16_submitWriteCommand(fdevice, fdevice->isLargeFlash ? 5 : 4, data, length);
 
     fdevice->currentWriteAddress += length;
 }
@@ -21,7 +21,10 @@
 /*
  * Winbond W25M series stacked die flash driver.
  * Handles homogeneous stack of identical dies by calling die drivers.
- * 
+ *
+ * Consecutive pages alternate between the dies, so that a page is programmed on one die while the next one is
+ * sent to the other. A sector is the same sector of every die, which are erased at the same time.
+ *
  * Author: jflyper
  */
 
@@ -57,7 +60,13 @@ static const flashVTable_t w25m_vTable;
 static flashDevice_t dieDevice[MAX_DIE_COUNT];
 
 static int dieCount;
-static uint32_t dieSize;
+static uint16_t pageSize;
+
+// An erase keeps its die busy for long, the other operations only need the die they go to
+static bool dieErasing[MAX_DIE_COUNT];
+
+// The address following the last page program, where the next one is expected
+static uint32_t nextWriteAddress;
 
 static void w25m_dieSelect(busDevice_t *busdev, int die)
 {
@@ -74,17 +83,38 @@ static void w25m_dieSelect(busDevice_t *busdev, int die)
     activeDie = die;
 }
 
+static int w25m_dieOfAddress(uint32_t address)
+{
+    return (address / pageSize) % dieCount;
+}
+
+static uint32_t w25m_dieAddress(uint32_t address)
+{
+    return (address / pageSize / dieCount) * pageSize + address % pageSize;
+}
+
+static bool w25m_dieIsReady(flashDevice_t *fdevice, int die)
+{
+    if (!dieDevice[die].couldBeBusy) {
+        return true;
+    }
+
+    w25m_dieSelect(fdevice->busdev, die);
+    return dieDevice[die].vTable->isReady(&dieDevice[die]);
+}
+
+/**
+ * Ready once the die of the next page is idle and no erase is running, a program on the other die may still be.
+ */
 static bool w25m_isReady(flashDevice_t *fdevice)
 {
-    UNUSED(fdevice);
+    const int nextWriteDie = w25m_dieOfAddress(nextWriteAddress);
 
     for (int die = 0 ; die < dieCount ; die++) {
-        if (dieDevice[die].couldBeBusy) {
-            w25m_dieSelect(fdevice->busdev, die);
-            if (!dieDevice[die].vTable->isReady(&dieDevice[die])) {
-                return false;
-            }
+        if ((dieErasing[die] || die == nextWriteDie) && !w25m_dieIsReady(fdevice, die)) {
+            return false;
         }
+        dieErasing[die] = false;
     }
 
     return true;
@@ -129,23 +159,26 @@ bool w25m_detect(flashDevice_t *fdevice, uint32_t chipID)
     }
 
     fdevice->geometry.sectors = dieDevice[0].geometry.sectors;
-    fdevice->geometry.sectorSize = dieDevice[0].geometry.sectorSize;
-    fdevice->geometry.pagesPerSector = dieDevice[0].geometry.pagesPerSector;
+    fdevice->geometry.sectorSize = dieDevice[0].geometry.sectorSize * dieCount;
+    fdevice->geometry.pagesPerSector = dieDevice[0].geometry.pagesPerSector * dieCount;
     fdevice->geometry.pageSize = dieDevice[0].geometry.pageSize;
-    dieSize = dieDevice[0].geometry.totalSize;
-    fdevice->geometry.totalSize = dieSize * dieCount;
+    fdevice->geometry.totalSize = dieDevice[0].geometry.totalSize * dieCount;
     fdevice->vTable = &w25m_vTable;
 
+    pageSize = fdevice->geometry.pageSize;
+
     return true;
 }
 
 void w25m_eraseSector(flashDevice_t *fdevice, uint32_t address)
 {
-    int dieNumber = address / dieSize;
+    const uint32_t dieAddress = (address / fdevice->geometry.sectorSize) * dieDevice[0].geometry.sectorSize;
 
-    w25m_dieSelect(fdevice->busdev, dieNumber);
-
-    dieDevice[dieNumber].vTable->eraseSector(&dieDevice[dieNumber], address % dieSize);
+    for (int dieNumber = 0 ; dieNumber < dieCount ; dieNumber++) {
+        w25m_dieSelect(fdevice->busdev, dieNumber);
+        dieDevice[dieNumber].vTable->eraseSector(&dieDevice[dieNumber], dieAddress);
+        dieErasing[dieNumber] = true;
+    }
 }
 
 void w25m_eraseCompletely(flashDevice_t *fdevice)
@@ -153,6 +186,7 @@ void w25m_eraseCompletely(flashDevice_t *fdevice)
     for (int dieNumber = 0 ; dieNumber < dieCount ; dieNumber++) {
         w25m_dieSelect(fdevice->busdev, dieNumber);
         dieDevice[dieNumber].vTable->eraseCompletely(&dieDevice[dieNumber]);
+        dieErasing[dieNumber] = true;
     }
 }
 
@@ -163,17 +197,21 @@ void w25m_pageProgramBegin(flashDevice_t *fdevice, uint32_t address)
 {
     UNUSED(fdevice);
 
-    currentWriteDie = address / dieSize;
+    currentWriteDie = w25m_dieOfAddress(address);
     w25m_dieSelect(fdevice->busdev, currentWriteDie);
-    currentWriteAddress = address % dieSize;
-    dieDevice[currentWriteDie].vTable->pageProgramBegin(&dieDevice[currentWriteDie], currentWriteAddress);
+    currentWriteAddress = address;
+    dieDevice[currentWriteDie].vTable->pageProgramBegin(&dieDevice[currentWriteDie], w25m_dieAddress(address));
 }
 
 void w25m_pageProgramContinue(flashDevice_t *fdevice, const uint8_t *data, int length)
 {
     UNUSED(fdevice);
 
+    w25m_dieSelect(fdevice->busdev, currentWriteDie);
     dieDevice[currentWriteDie].vTable->pageProgramContinue(&dieDevice[currentWriteDie], data, length);
+
+    currentWriteAddress += length;
+    nextWriteAddress = currentWriteAddress;
 }
 
 void w25m_pageProgramFinish(flashDevice_t *fdevice)
@@ -198,13 +236,12 @@ int w25m_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer, in
     int tlen; // transfer length for a round
     int rbytes;
 
-    // Divide a read that spans multiple dies into two.
-    // The loop is executed twice at the most for decent 'length'.
+    // Divide a read that spans multiple pages, which are on alternate dies.
 
     for (rlen = length; rlen; rlen -= tlen) {
-        int dieNumber = address / dieSize;
-        uint32_t dieAddress = address % dieSize;
-        tlen = MIN(dieAddress + rlen, dieSize) - dieAddress;
+        int dieNumber = w25m_dieOfAddress(address);
+        uint32_t dieAddress = w25m_dieAddress(address);
+        tlen = MIN(rlen, (int)(pageSize - address % pageSize));
 
         w25m_dieSelect(fdevice->busdev, dieNumber);
 
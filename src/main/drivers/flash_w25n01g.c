@@ -0,0 +1,542 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Winbond W25N01G 1Gbit SPI NAND flash driver.
+ *
+ * The device runs in buffer mode with its ECC enabled. The data of a page is loaded into the device's page
+ * buffer as the writes arrive, and only programmed into the array once the page is full or on a flush, so that
+ * each page is programmed whole. The buffer loads run as bus jobs, by DMA when the bus has DMA streams, with the
+ * program execute of a full page queued behind its last load.
+ *
+ * A read first moves its page from the array into the same buffer, the buffer keeps the last page read so that
+ * the reads following one another through a page only read it from the array once.
+ *
+ * The blocks marked bad in the factory are mapped onto blocks of a reserved area at the end of the device by
+ * its bad block look up table, so flashfs only ever sees good blocks.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "build/debug.h"
+
+#include "common/maths.h"
+#include "common/utils.h"
+
+#ifdef USE_FLASH_W25N01G
+
+#include "drivers/bus_spi.h"
+#include "drivers/bus_spi_dma.h"
+#include "drivers/flash.h"
+#include "drivers/flash_impl.h"
+#include "drivers/io.h"
+#include "drivers/time.h"
+
+#include "flash_w25n01g.h"
+
+#define W25N01G_INSTRUCTION_RESET                   0xFF
+#define W25N01G_INSTRUCTION_READ_STATUS_REG         0x0F
+#define W25N01G_INSTRUCTION_WRITE_STATUS_REG        0x1F
+#define W25N01G_INSTRUCTION_WRITE_ENABLE            0x06
+#define W25N01G_INSTRUCTION_BB_MANAGEMENT           0xA1
+#define W25N01G_INSTRUCTION_READ_BBM_LUT            0xA5
+#define W25N01G_INSTRUCTION_BLOCK_ERASE             0xD8
+#define W25N01G_INSTRUCTION_PROGRAM_DATA_LOAD       0x02
+#define W25N01G_INSTRUCTION_RANDOM_PROGRAM_DATA_LOAD 0x84
+#define W25N01G_INSTRUCTION_PROGRAM_EXECUTE         0x10
+#define W25N01G_INSTRUCTION_PAGE_DATA_READ          0x13
+#define W25N01G_INSTRUCTION_READ_DATA               0x03
+
+#define W25N01G_PROT_REG                            0xA0
+#define W25N01G_CONF_REG                            0xB0
+#define W25N01G_STAT_REG                            0xC0
+
+#define W25N01G_CONFIG_ECC_ENABLE                   0x10
+#define W25N01G_CONFIG_BUFFER_READ_MODE             0x08
+
+#define W25N01G_STATUS_FLAG_BUSY                    0x01
+#define W25N01G_STATUS_FLAG_ECC_UNCORRECTABLE       0x20
+
+#define W25N01G_BBLUT_ENTRY_ENABLE                  0x8000
+#define W25N01G_BBLUT_BLOCK_MASK                    0x03FF
+
+#define JEDEC_ID_WINBOND_W25N01GV                   0xEFAA21
+
+#define W25N01G_PAGESIZE                            2048
+#define W25N01G_PAGES_PER_BLOCK                     64
+#define W25N01G_BLOCKS                              1024
+
+// The look up table has 20 entries, as many blocks at the end of the device are kept to replace the bad ones
+#define W25N01G_BBLUT_SIZE                          20
+#define W25N01G_USER_BLOCKS                         (W25N01G_BLOCKS - W25N01G_BBLUT_SIZE)
+
+// The first byte of the spare area of a block's first page isn't 0xFF if the block is bad
+#define W25N01G_BB_MARKER_COLUMN                    W25N01G_PAGESIZE
+
+STATIC_ASSERT(W25N01G_PAGESIZE <= FLASH_MAX_PAGE_SIZE, W25N01G_PAGESIZE_too_large);
+
+#define W25N01G_NO_PAGE                             UINT32_MAX
+
+#define PAGE_READ_TIMEOUT_MILLIS                    1
+#define PROGRAM_TIMEOUT_MILLIS                      2
+#define BLOCK_ERASE_TIMEOUT_MILLIS                  15
+#define RESET_TIMEOUT_MILLIS                        2
+
+// A bus segment is at most 255 bytes long
+#define W25N01G_LOAD_SEGMENT_SIZE                   255
+#define W25N01G_LOAD_SEGMENT_COUNT                  ((W25N01G_PAGESIZE + W25N01G_LOAD_SEGMENT_SIZE - 1) / W25N01G_LOAD_SEGMENT_SIZE)
+
+static const flashVTable_t w25n01g_vTable;
+
+static const uint8_t jobWriteEnable = W25N01G_INSTRUCTION_WRITE_ENABLE;
+static uint8_t jobLoadCommand[3];
+static uint8_t jobExecuteCommand[4];
+// The load command, the data, the write enable and program execute of a full page, and the terminator
+static busSegment_t jobSegments[1 + W25N01G_LOAD_SEGMENT_COUNT + 2 + 1];
+static volatile bool jobInFlight;
+
+// The page being loaded into the device's buffer and the page the buffer holds since it was last read
+static uint32_t loadPage = W25N01G_NO_PAGE;
+static uint32_t readPage = W25N01G_NO_PAGE;
+
+static uint8_t lastStatus;
+
+static void w25n01g_jobComplete(uint32_t arg)
+{
+    UNUSED(arg);
+
+    jobInFlight = false;
+}
+
+static void w25n01g_disable(busDevice_t *bus)
+{
+    IOFastHi(&bus->busdev_u.spi.csn);
+    __NOP();
+}
+
+static void w25n01g_enable(busDevice_t *bus)
+{
+    // Polled transfers mustn't interleave with jobs of other devices on the bus
+    spiBusWaitForJobs(bus);
+
+    __NOP();
+    IOFastLo(&bus->busdev_u.spi.csn);
+}
+
+static void w25n01g_performCommand(busDevice_t *bus, const uint8_t *command, int length)
+{
+    w25n01g_enable(bus);
+
+    spiTransfer(bus->busdev_u.spi.instance, command, NULL, length);
+
+    w25n01g_disable(bus);
+}
+
+static void w25n01g_performOneByteCommand(busDevice_t *bus, uint8_t command)
+{
+    w25n01g_performCommand(bus, &command, 1);
+}
+
+// Commands on a page and a block take the page address after a dummy byte
+static void w25n01g_performPageCommand(busDevice_t *bus, uint8_t instruction, uint32_t page)
+{
+    const uint8_t command[4] = { instruction, 0, (page >> 8) & 0xff, page & 0xff };
+
+    w25n01g_performCommand(bus, command, sizeof(command));
+}
+
+static uint8_t w25n01g_readRegister(busDevice_t *bus, uint8_t reg)
+{
+    const uint8_t command[3] = { W25N01G_INSTRUCTION_READ_STATUS_REG, reg, 0 };
+    uint8_t in[3];
+
+    w25n01g_enable(bus);
+
+    spiTransfer(bus->busdev_u.spi.instance, command, in, sizeof(command));
+
+    w25n01g_disable(bus);
+
+    return in[2];
+}
+
+static void w25n01g_writeRegister(busDevice_t *bus, uint8_t reg, uint8_t data)
+{
+    const uint8_t command[3] = { W25N01G_INSTRUCTION_WRITE_STATUS_REG, reg, data };
+
+    w25n01g_performCommand(bus, command, sizeof(command));
+}
+
+static void w25n01g_readColumn(busDevice_t *bus, uint16_t column, uint8_t *buffer, int length)
+{
+    const uint8_t command[4] = { W25N01G_INSTRUCTION_READ_DATA, (column >> 8) & 0xff, column & 0xff, 0 };
+
+    w25n01g_enable(bus);
+
+    spiTransfer(bus->busdev_u.spi.instance, command, NULL, sizeof(command));
+    spiTransfer(bus->busdev_u.spi.instance, NULL, buffer, length);
+
+    w25n01g_disable(bus);
+}
+
+/**
+ * Never waits for the device, the status is read right away as it is only three bytes long.
+ */
+static bool w25n01g_isReady(flashDevice_t *fdevice)
+{
+    if (jobInFlight) {
+        return false;
+    }
+
+    if (fdevice->couldBeBusy) {
+        lastStatus = w25n01g_readRegister(fdevice->busdev, W25N01G_STAT_REG);
+        fdevice->couldBeBusy = (lastStatus & W25N01G_STATUS_FLAG_BUSY) != 0;
+    }
+
+    return !fdevice->couldBeBusy;
+}
+
+static bool w25n01g_waitForReady(flashDevice_t *fdevice, uint32_t timeoutMillis)
+{
+    uint32_t time = millis();
+    while (!w25n01g_isReady(fdevice)) {
+        if (millis() - time > timeoutMillis) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void w25n01g_programExecute(flashDevice_t *fdevice, uint32_t page)
+{
+    w25n01g_performOneByteCommand(fdevice->busdev, W25N01G_INSTRUCTION_WRITE_ENABLE);
+    w25n01g_performPageCommand(fdevice->busdev, W25N01G_INSTRUCTION_PROGRAM_EXECUTE, page);
+
+    fdevice->couldBeBusy = true;
+}
+
+/**
+ * Move the page from the array into the device's buffer, unless the buffer holds it already.
+ *
+ * Returns false if the page has more bit errors than the ECC could correct.
+ */
+static bool w25n01g_pageRead(flashDevice_t *fdevice, uint32_t page)
+{
+    if (readPage == page) {
+        return true;
+    }
+
+    readPage = W25N01G_NO_PAGE;
+
+    w25n01g_performPageCommand(fdevice->busdev, W25N01G_INSTRUCTION_PAGE_DATA_READ, page);
+    fdevice->couldBeBusy = true;
+
+    if (!w25n01g_waitForReady(fdevice, PAGE_READ_TIMEOUT_MILLIS) || (lastStatus & W25N01G_STATUS_FLAG_ECC_UNCORRECTABLE)) {
+        return false;
+    }
+
+    readPage = page;
+    return true;
+}
+
+static bool w25n01g_blockIsMarkedBad(flashDevice_t *fdevice, uint16_t block)
+{
+    uint8_t marker = 0;
+
+    w25n01g_pageRead(fdevice, block * W25N01G_PAGES_PER_BLOCK);
+    w25n01g_readColumn(fdevice->busdev, W25N01G_BB_MARKER_COLUMN, &marker, 1);
+
+    return marker != 0xFF;
+}
+
+/**
+ * Map the blocks marked bad onto the reserved blocks, the entries of the look up table can't be undone.
+ *
+ * This reads the first page of each block, which takes some 100ms at boot.
+ */
+static void w25n01g_remapBadBlocks(flashDevice_t *fdevice)
+{
+    uint8_t command[2] = { W25N01G_INSTRUCTION_READ_BBM_LUT, 0 };
+    uint8_t lut[W25N01G_BBLUT_SIZE * 4];
+
+    w25n01g_enable(fdevice->busdev);
+    spiTransfer(fdevice->busdev->busdev_u.spi.instance, command, NULL, sizeof(command));
+    spiTransfer(fdevice->busdev->busdev_u.spi.instance, NULL, lut, sizeof(lut));
+    w25n01g_disable(fdevice->busdev);
+
+    uint16_t mappedBlocks[W25N01G_BBLUT_SIZE];
+    uint32_t usedReplacements = 0;
+    int entryCount = 0;
+
+    for (int i = 0; i < W25N01G_BBLUT_SIZE; i++) {
+        const uint16_t logicalBlock = (lut[i * 4] << 8) | lut[i * 4 + 1];
+        const uint16_t physicalBlock = ((lut[i * 4 + 2] << 8) | lut[i * 4 + 3]) & W25N01G_BBLUT_BLOCK_MASK;
+        if (logicalBlock & W25N01G_BBLUT_ENTRY_ENABLE) {
+            mappedBlocks[entryCount++] = logicalBlock & W25N01G_BBLUT_BLOCK_MASK;
+            if (physicalBlock >= W25N01G_USER_BLOCKS) {
+                usedReplacements |= 1 << (physicalBlock - W25N01G_USER_BLOCKS);
+            }
+        }
+    }
+
+    for (uint16_t block = 0; block < W25N01G_USER_BLOCKS && entryCount < W25N01G_BBLUT_SIZE; block++) {
+        bool mapped = false;
+        for (int i = 0; i < entryCount; i++) {
+            mapped |= mappedBlocks[i] == block;
+        }
+        if (mapped || !w25n01g_blockIsMarkedBad(fdevice, block)) {
+            continue;
+        }
+
+        for (int replacement = 0; replacement < W25N01G_BBLUT_SIZE; replacement++) {
+            const uint16_t replacementBlock = W25N01G_USER_BLOCKS + replacement;
+            if (usedReplacements & (1 << replacement)) {
+                continue;
+            }
+            usedReplacements |= 1 << replacement;
+            if (w25n01g_blockIsMarkedBad(fdevice, replacementBlock)) {
+                continue;
+            }
+
+            const uint8_t swapCommand[5] = {
+                W25N01G_INSTRUCTION_BB_MANAGEMENT,
+                (block >> 8) & 0xff, block & 0xff,
+                (replacementBlock >> 8) & 0xff, replacementBlock & 0xff
+            };
+            w25n01g_performOneByteCommand(fdevice->busdev, W25N01G_INSTRUCTION_WRITE_ENABLE);
+            w25n01g_performCommand(fdevice->busdev, swapCommand, sizeof(swapCommand));
+            fdevice->couldBeBusy = true;
+            w25n01g_waitForReady(fdevice, PROGRAM_TIMEOUT_MILLIS);
+
+            mappedBlocks[entryCount++] = block;
+            break;
+        }
+    }
+
+    readPage = W25N01G_NO_PAGE;
+}
+
+bool w25n01g_detect(flashDevice_t *fdevice, uint32_t chipID)
+{
+    switch (chipID) {
+    case JEDEC_ID_WINBOND_W25N01GV:
+        fdevice->geometry.sectors = W25N01G_USER_BLOCKS;
+        fdevice->geometry.pagesPerSector = W25N01G_PAGES_PER_BLOCK;
+        fdevice->geometry.pageSize = W25N01G_PAGESIZE;
+        break;
+
+    default:
+        // Unsupported chip or not an SPI NAND flash
+        fdevice->geometry.sectors = 0;
+        fdevice->geometry.pagesPerSector = 0;
+        fdevice->geometry.sectorSize = 0;
+        fdevice->geometry.totalSize = 0;
+        return false;
+    }
+
+    fdevice->geometry.flashType = FLASH_TYPE_NAND;
+    fdevice->geometry.sectorSize = fdevice->geometry.pagesPerSector * fdevice->geometry.pageSize;
+    fdevice->geometry.totalSize = fdevice->geometry.sectorSize * fdevice->geometry.sectors;
+
+    w25n01g_performOneByteCommand(fdevice->busdev, W25N01G_INSTRUCTION_RESET);
+    fdevice->couldBeBusy = true;
+    w25n01g_waitForReady(fdevice, RESET_TIMEOUT_MILLIS);
+
+    // The whole array is write protected after power up
+    w25n01g_writeRegister(fdevice->busdev, W25N01G_PROT_REG, 0);
+    w25n01g_writeRegister(fdevice->busdev, W25N01G_CONF_REG, W25N01G_CONFIG_ECC_ENABLE | W25N01G_CONFIG_BUFFER_READ_MODE);
+
+    w25n01g_remapBadBlocks(fdevice);
+
+    fdevice->vTable = &w25n01g_vTable;
+    return true;
+}
+
+/**
+ * Program the page loaded into the device's buffer so far, if any.
+ */
+static void w25n01g_flush(flashDevice_t *fdevice)
+{
+    if (loadPage == W25N01G_NO_PAGE) {
+        return;
+    }
+
+    w25n01g_waitForReady(fdevice, PROGRAM_TIMEOUT_MILLIS);
+    w25n01g_programExecute(fdevice, loadPage);
+
+    loadPage = W25N01G_NO_PAGE;
+}
+
+static void w25n01g_eraseSector(flashDevice_t *fdevice, uint32_t address)
+{
+    const uint32_t page = address / W25N01G_PAGESIZE;
+
+    // Data loaded for the block would be erased along with it
+    if (loadPage / W25N01G_PAGES_PER_BLOCK == page / W25N01G_PAGES_PER_BLOCK) {
+        loadPage = W25N01G_NO_PAGE;
+    }
+    readPage = W25N01G_NO_PAGE;
+
+    w25n01g_waitForReady(fdevice, BLOCK_ERASE_TIMEOUT_MILLIS);
+
+    w25n01g_performOneByteCommand(fdevice->busdev, W25N01G_INSTRUCTION_WRITE_ENABLE);
+    w25n01g_performPageCommand(fdevice->busdev, W25N01G_INSTRUCTION_BLOCK_ERASE, page);
+
+    fdevice->couldBeBusy = true;
+}
+
+/**
+ * The device has no chip erase, this erases the blocks one after the other and takes seconds.
+ */
+static void w25n01g_eraseCompletely(flashDevice_t *fdevice)
+{
+    loadPage = W25N01G_NO_PAGE;
+
+    for (uint32_t block = 0; block < fdevice->geometry.sectors; block++) {
+        w25n01g_eraseSector(fdevice, block * fdevice->geometry.sectorSize);
+    }
+}
+
+/**
+ * Programs continuing the page being loaded add to it, a program of another page programs that one first.
+ */
+static void w25n01g_pageProgramBegin(flashDevice_t *fdevice, uint32_t address)
+{
+    if (loadPage != W25N01G_NO_PAGE && loadPage != address / W25N01G_PAGESIZE) {
+        w25n01g_flush(fdevice);
+    }
+
+    fdevice->currentWriteAddress = address;
+}
+
+/**
+ * Load the data into the device's buffer at the current write address, the page is programmed once the data fills
+ * it. The data must stay untouched until the device is ready again, and must not cross the end of the page.
+ */
+static void w25n01g_pageProgramContinue(flashDevice_t *fdevice, const uint8_t *data, int length)
+{
+    w25n01g_waitForReady(fdevice, PROGRAM_TIMEOUT_MILLIS);
+
+    const uint32_t page = fdevice->currentWriteAddress / W25N01G_PAGESIZE;
+    const uint16_t column = fdevice->currentWriteAddress % W25N01G_PAGESIZE;
+
+    // A new load sets the rest of the buffer to 0xFF, so that the bytes of the page not written are left alone
+    jobLoadCommand[0] = loadPage == page ? W25N01G_INSTRUCTION_RANDOM_PROGRAM_DATA_LOAD : W25N01G_INSTRUCTION_PROGRAM_DATA_LOAD;
+    jobLoadCommand[1] = (column >> 8) & 0xff;
+    jobLoadCommand[2] = column & 0xff;
+
+    busSegment_t *segment = jobSegments;
+    *segment++ = (busSegment_t){ jobLoadCommand, NULL, sizeof(jobLoadCommand), false };
+    for (int offset = 0; offset < length; offset += W25N01G_LOAD_SEGMENT_SIZE) {
+        *segment++ = (busSegment_t){ data + offset, NULL, MIN(length - offset, W25N01G_LOAD_SEGMENT_SIZE), false };
+    }
+
+    loadPage = page;
+    readPage = W25N01G_NO_PAGE;
+    fdevice->currentWriteAddress += length;
+
+    if (fdevice->currentWriteAddress % W25N01G_PAGESIZE == 0) {
+        // The page is full, program it right after the load
+        segment[-1].negateCS = true;
+        jobExecuteCommand[0] = W25N01G_INSTRUCTION_PROGRAM_EXECUTE;
+        jobExecuteCommand[1] = 0;
+        jobExecuteCommand[2] = (page >> 8) & 0xff;
+        jobExecuteCommand[3] = page & 0xff;
+        *segment++ = (busSegment_t){ &jobWriteEnable, NULL, 1, true };
+        *segment++ = (busSegment_t){ jobExecuteCommand, NULL, sizeof(jobExecuteCommand), false };
+
+        loadPage = W25N01G_NO_PAGE;
+        fdevice->couldBeBusy = true;
+    }
+    *segment = (busSegment_t){ NULL, NULL, 0, false };
+
+    jobInFlight = true;
+    spiBusSubmitJob(fdevice->busdev, jobSegments, w25n01g_jobComplete, 0);
+}
+
+static void w25n01g_pageProgramFinish(flashDevice_t *fdevice)
+{
+    UNUSED(fdevice);
+}
+
+static void w25n01g_pageProgram(flashDevice_t *fdevice, uint32_t address, const uint8_t *data, int length)
+{
+    w25n01g_pageProgramBegin(fdevice, address);
+
+    w25n01g_pageProgramContinue(fdevice, data, length);
+
+    w25n01g_pageProgramFinish(fdevice);
+}
+
+/**
+ * Read `length` bytes into the provided `buffer` from the flash starting from the given `address`, a page that is
+ * still being loaded is programmed first.
+ *
+ * The number of bytes actually read is returned, which is short of the length if a timeout occurred or a page
+ * could not be corrected.
+ */
+static int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer, int length)
+{
+    w25n01g_flush(fdevice);
+
+    if (!w25n01g_waitForReady(fdevice, PROGRAM_TIMEOUT_MILLIS)) {
+        return 0;
+    }
+
+    int bytesRead = 0;
+    while (bytesRead < length) {
+        const uint32_t page = address / W25N01G_PAGESIZE;
+        const uint16_t column = address % W25N01G_PAGESIZE;
+        const int transferLength = MIN(length - bytesRead, W25N01G_PAGESIZE - column);
+
+        if (!w25n01g_pageRead(fdevice, page)) {
+            break;
+        }
+        w25n01g_readColumn(fdevice->busdev, column, buffer + bytesRead, transferLength);
+
+        address += transferLength;
+        bytesRead += transferLength;
+    }
+
+    return bytesRead;
+}
+
+static const flashGeometry_t* w25n01g_getGeometry(flashDevice_t *fdevice)
+{
+    return &fdevice->geometry;
+}
+
+static const flashVTable_t w25n01g_vTable = {
+    .isReady = w25n01g_isReady,
+    .waitForReady = w25n01g_waitForReady,
+    .eraseSector = w25n01g_eraseSector,
+    .eraseCompletely = w25n01g_eraseCompletely,
+    .pageProgramBegin = w25n01g_pageProgramBegin,
+    .pageProgramContinue = w25n01g_pageProgramContinue,
+    .pageProgramFinish = w25n01g_pageProgramFinish,
+    .pageProgram = w25n01g_pageProgram,
+    .flush = w25n01g_flush,
+    .readBytes = w25n01g_readBytes,
+    .getGeometry = w25n01g_getGeometry,
+};
+#endif
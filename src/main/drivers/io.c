@@ -217,6 +217,25 @@ void IOLo(IO_t io)
 #endif
 }
 
+// a missing pin writes here, so its edges are no-ops as with IOHi() and IOLo()
+static uint32_t ioFastNone;
+
+void IOFastInit(ioFast_t *fast, IO_t io)
+{
+    if (!io) {
+        fast->bsrr = &ioFastNone;
+        fast->mask = 0;
+        return;
+    }
+#if defined(STM32F4) && !defined(USE_HAL_DRIVER)
+    // BSRRL and BSRRH are the halves of the one set/reset register
+    fast->bsrr = (volatile uint32_t *)&IO_GPIO(io)->BSRRL;
+#else
+    fast->bsrr = &IO_GPIO(io)->BSRR;
+#endif
+    fast->mask = IO_Pin(io);
+}
+
 void IOToggle(IO_t io)
 {
     if (!io) {
@@ -107,6 +107,19 @@ void IOHi(IO_t io);
 void IOLo(IO_t io);
 void IOToggle(IO_t io);
 
+// Each edge of a fast IO pin is a single store to the set/reset register, without the lookups of IOHi() and IOLo()
+void IOFastInit(ioFast_t *fast, IO_t io);
+
+static inline void IOFastHi(const ioFast_t *fast)
+{
+    *fast->bsrr = fast->mask;
+}
+
+static inline void IOFastLo(const ioFast_t *fast)
+{
+    *fast->bsrr = fast->mask << 16;
+}
+
 void IOInit(IO_t io, resourceOwner_e owner, uint8_t index);
 void IORelease(IO_t io);  // unimplemented
 resourceOwner_e IOGetOwner(IO_t io);
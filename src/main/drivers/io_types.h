@@ -27,6 +27,12 @@
 typedef uint8_t ioTag_t;       // packet tag to specify IO pin
 typedef void* IO_t;            // type specifying IO pin. Currently ioRec_t pointer, but this may change
 
+// IO pin resolved to its set/reset register and mask, for pins toggled on the hot path
+typedef struct ioFast_s {
+    volatile uint32_t *bsrr;
+    uint32_t mask;
+} ioFast_t;
+
 // NONE initializer for ioTag_t variables
 #define IO_TAG_NONE 0
 
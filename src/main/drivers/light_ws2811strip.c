@@ -38,16 +38,15 @@
 
 #include "common/color.h"
 #include "common/colorconversion.h"
+#include "common/utils.h"
 #include "dma.h"
 #include "drivers/io.h"
 #include "light_ws2811strip.h"
 
 #if defined(STM32F1) || defined(STM32F3)
 uint8_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
-#elif defined(STM32F7)
-FAST_RAM_ZERO_INIT uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
 #else
-uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
+DMA_RAM_ZERO_INIT uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
 #endif
 
 volatile uint8_t ws2811LedDataTransferInProgress = 0;
@@ -56,6 +55,13 @@ uint16_t BIT_COMPARE_1 = 0;
 uint16_t BIT_COMPARE_0 = 0;
 
 static hsvColor_t ledColorBuffer[WS2811_LED_STRIP_LENGTH];
+// colours the DMA buffer, or the packed colours with USE_LED_STRIP_HALF_BUFFER_DMA, currently hold.
+// Only the LEDs that differ are converted again.
+static hsvColor_t ledColorSent[WS2811_LED_STRIP_LENGTH];
+static bool ledStripDmaBufferValid = false;
+static ledStripFormatRGB_e ledStripDmaBufferFormat;
+// the colours were encoded but the DMA stream was busy with another shared owner
+static bool ledStripTransferPending = false;
 
 void setLedHsv(uint16_t index, const hsvColor_t *color)
 {
@@ -96,6 +102,7 @@ void setStripColors(const hsvColor_t *colors)
 void ws2811LedStripInit(ioTag_t ioTag)
 {
     memset(ledStripDMABuffer, 0, sizeof(ledStripDMABuffer));
+    ledStripDmaBufferValid = false;
     ws2811LedStripHardwareInit(ioTag);
 
     const hsvColor_t hsv_white = { 0, 255, 255 };
@@ -112,10 +119,15 @@ bool isWS2811LedStripReady(void)
 STATIC_UNIT_TESTED uint16_t dmaBufferOffset;
 static int16_t ledIndex;
 
+static bool ledColorEqual(const hsvColor_t *a, const hsvColor_t *b)
+{
+    return a->h == b->h && a->s == b->s && a->v == b->v;
+}
+
 #define USE_FAST_DMA_BUFFER_IMPL
 #ifdef USE_FAST_DMA_BUFFER_IMPL
 
-STATIC_UNIT_TESTED void fastUpdateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color)
+static uint32_t ws2811PackColor(ledStripFormatRGB_e ledFormat, const rgbColor24bpp_t *color)
 {
     uint32_t packed_colour;
 
@@ -130,10 +142,59 @@ STATIC_UNIT_TESTED void fastUpdateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rg
         break;
     }
 
+    return packed_colour;
+}
+
+// Writes the timer compare values for the 24 bits of a packed colour, MSB first
+static void ws2811ExpandColor(uint32_t packedColor, uint16_t offset)
+{
     for (int8_t index = 23; index >= 0; index--) {
-        ledStripDMABuffer[dmaBufferOffset++] = (packed_colour & (1 << index)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+        ledStripDMABuffer[offset++] = (packedColor & (1 << index)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
     }
 }
+
+STATIC_UNIT_TESTED void fastUpdateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color)
+{
+    ws2811ExpandColor(ws2811PackColor(ledFormat, color), dmaBufferOffset);
+    dmaBufferOffset += WS2811_BITS_PER_LED;
+}
+
+#ifdef USE_LED_STRIP_HALF_BUFFER_DMA
+STATIC_ASSERT(WS2811_DMA_HALF_BUFFER_SIZE >= WS2811_DELAY_BUFFER_LENGTH, ws2811_half_buffer_shorter_than_reset);
+
+static uint32_t ledStripPackedColors[WS2811_LED_STRIP_LENGTH];
+static volatile uint16_t ledStripEncodeIndex;
+static volatile bool ledStripHalfIsReset[2];
+
+// Expands the next LEDs into one half of the DMA buffer, or the reset low time once all of them are queued
+static void ws2811EncodeHalfBuffer(uint8_t half)
+{
+    uint16_t offset = half * WS2811_DMA_HALF_BUFFER_SIZE;
+    const uint16_t end = offset + WS2811_DMA_HALF_BUFFER_SIZE;
+
+    ledStripHalfIsReset[half] = ledStripEncodeIndex >= WS2811_LED_STRIP_LENGTH;
+    while (offset < end) {
+        if (ledStripEncodeIndex < WS2811_LED_STRIP_LENGTH) {
+            ws2811ExpandColor(ledStripPackedColors[ledStripEncodeIndex++], offset);
+            offset += WS2811_BITS_PER_LED;
+        } else {
+            ledStripDMABuffer[offset++] = 0;
+        }
+    }
+}
+
+// Called from the half and full transfer interrupts with the half that was just sent.
+// Returns true when the transfer is complete and the DMA is to be stopped.
+bool ws2811HalfBufferTransferred(uint8_t half)
+{
+    if (ledStripHalfIsReset[half]) {
+        ws2811LedDataTransferInProgress = 0;
+        return true;
+    }
+    ws2811EncodeHalfBuffer(half);
+    return false;
+}
+#endif
 #else
 STATIC_UNIT_TESTED void updateLEDDMABuffer(uint8_t componentValue)
 {
@@ -157,6 +218,8 @@ STATIC_UNIT_TESTED void updateLEDDMABuffer(uint8_t componentValue)
 /*
  * This method is non-blocking unless an existing LED update is in progress.
  * it does not wait until all the LEDs have been updated, that happens in the background.
+ * Only the LEDs whose colour changed since the last transfer are written to the DMA buffer,
+ * and no transfer is started when none changed.
  */
 void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat)
 {
@@ -167,16 +230,29 @@ void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat)
         return;
     }
 
-    dmaBufferOffset = 0;                // reset buffer memory index
+    const bool rebuild = !ledStripDmaBufferValid || ledFormat != ledStripDmaBufferFormat;
+    bool changed = rebuild || ledStripTransferPending;
+
     ledIndex = 0;                       // reset led index
 
     // fill transmit buffer with correct compare values to achieve
     // correct pulse widths according to color values
     while (ledIndex < WS2811_LED_STRIP_LENGTH)
     {
+        if (!rebuild && ledColorEqual(&ledColorBuffer[ledIndex], &ledColorSent[ledIndex])) {
+            ledIndex++;
+            continue;
+        }
+        changed = true;
+        ledColorSent[ledIndex] = ledColorBuffer[ledIndex];
+        dmaBufferOffset = ledIndex * WS2811_BITS_PER_LED;
+
         rgb24 = hsvToRgb24(&ledColorBuffer[ledIndex]);
 
-#ifdef USE_FAST_DMA_BUFFER_IMPL
+#if defined(USE_LED_STRIP_HALF_BUFFER_DMA)
+        // expanded into the DMA buffer from the transfer interrupts
+        ledStripPackedColors[ledIndex] = ws2811PackColor(ledFormat, rgb24);
+#elif defined(USE_FAST_DMA_BUFFER_IMPL)
         fastUpdateLEDDMABuffer(ledFormat, rgb24);
 #else
         switch (ledFormat) {
@@ -198,8 +274,23 @@ void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat)
         ledIndex++;
     }
 
+    if (!changed) {
+        return;
+    }
+    ledStripDmaBufferValid = true;
+    ledStripDmaBufferFormat = ledFormat;
+
+#ifdef USE_LED_STRIP_HALF_BUFFER_DMA
+    ledStripEncodeIndex = 0;
+    ws2811EncodeHalfBuffer(0);
+    ws2811EncodeHalfBuffer(1);
+#endif
+
     ws2811LedDataTransferInProgress = 1;
-    ws2811LedStripDMAEnable();
+    ledStripTransferPending = !ws2811LedStripDMAEnable();
+    if (ledStripTransferPending) {
+        ws2811LedDataTransferInProgress = 0;
+    }
 }
 
 #endif
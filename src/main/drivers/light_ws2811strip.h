@@ -28,9 +28,16 @@
 // for 50us delay
 #define WS2811_DELAY_BUFFER_LENGTH 42
 
+#ifdef USE_LED_STRIP_HALF_BUFFER_DMA
+// the DMA runs circular over two halves, each refilled with the next LEDs while the other is sent
+#define WS2811_DMA_HALF_BUFFER_LEDS 2
+#define WS2811_DMA_HALF_BUFFER_SIZE (WS2811_BITS_PER_LED * WS2811_DMA_HALF_BUFFER_LEDS)
+#define WS2811_DMA_BUFFER_SIZE     (2 * WS2811_DMA_HALF_BUFFER_SIZE)
+#else
 #define WS2811_DATA_BUFFER_SIZE    (WS2811_BITS_PER_LED * WS2811_LED_STRIP_LENGTH)
 // number of bytes needed is #LEDs * 24 bytes + 42 trailing bytes)
 #define WS2811_DMA_BUFFER_SIZE     (WS2811_DATA_BUFFER_SIZE + WS2811_DELAY_BUFFER_LENGTH)
+#endif
 
 #define WS2811_TIMER_MHZ           48
 #define WS2811_CARRIER_HZ          800000
@@ -38,7 +45,7 @@
 void ws2811LedStripInit(ioTag_t ioTag);
 
 void ws2811LedStripHardwareInit(ioTag_t ioTag);
-void ws2811LedStripDMAEnable(void);
+bool ws2811LedStripDMAEnable(void);
 
 void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat);
 
@@ -53,6 +60,10 @@ void setStripColors(const hsvColor_t *colors);
 
 bool isWS2811LedStripReady(void);
 
+#ifdef USE_LED_STRIP_HALF_BUFFER_DMA
+bool ws2811HalfBufferTransferred(uint8_t half);
+#endif
+
 #if defined(STM32F1) || defined(STM32F3)
 extern uint8_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
 #else
@@ -60,6 +60,11 @@ void ws2811LedStripHardwareInit(ioTag_t ioTag)
     if (timerHardware->dmaRef == NULL) {
         return;
     }
+
+    // a stream in use by e.g. a motor is left alone, the strip stays dark
+    if (!dmaAllocate(timerHardware->dmaIrqHandler, OWNER_LED_STRIP, 0)) {
+        return;
+    }
     TimHandle.Instance = timer;
 
     /* Compute the prescaler value */
@@ -108,7 +113,6 @@ void ws2811LedStripHardwareInit(ioTag_t ioTag)
     /* Link hdma_tim to hdma[x] (channelx) */
     __HAL_LINKDMA(&TimHandle, hdma[dmaIndex], hdma_tim);
 
-    dmaInit(timerHardware->dmaIrqHandler, OWNER_LED_STRIP, 0);
     dmaSetHandler(timerHardware->dmaIrqHandler, WS2811_DMA_IRQHandler, NVIC_PRIO_WS2811_DMA, dmaIndex);
 
     /* Initialize TIMx DMA handle */
@@ -145,21 +149,21 @@ void ws2811LedStripHardwareInit(ioTag_t ioTag)
     ws2811Initialised = true;
 }
 
-void ws2811LedStripDMAEnable(void)
+bool ws2811LedStripDMAEnable(void)
 {
     if (!ws2811Initialised) {
-        ws2811LedDataTransferInProgress = 0;
-        return;
+        return false;
     }
 
     if (DMA_SetCurrDataCounter(&TimHandle, timerChannel, ledStripDMABuffer, WS2811_DMA_BUFFER_SIZE) != HAL_OK) {
         /* DMA set error */
-        ws2811LedDataTransferInProgress = 0;
-        return;
+        return false;
     }
     /* Reset timer counter */
     __HAL_TIM_SET_COUNTER(&TimHandle,0);
     /* Enable channel DMA requests */
     TIM_DMACmd(&TimHandle,timerChannel,ENABLE);
+
+    return true;
 }
 #endif
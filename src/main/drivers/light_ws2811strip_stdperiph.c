@@ -46,14 +46,49 @@ static DMA_Channel_TypeDef *dmaRef = NULL;
 #error "No MCU definition in light_ws2811strip_stdperiph.c"
 #endif
 static TIM_TypeDef *timer = NULL;
+static uint16_t timerDmaRequest;
+static dmaIdentifier_e dmaIdentifier;
+// kept to reconfigure the stream after another shared owner used it
+static DMA_InitTypeDef dmaInitStructure;
 
 static void WS2811_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor)
 {
+#ifdef USE_LED_STRIP_HALF_BUFFER_DMA
+    // the circular transfer is stopped once the reset low time queued after the last LED was sent
+    bool transferComplete = false;
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_HTIF)) {
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_HTIF);
+        transferComplete = ws2811HalfBufferTransferred(0);
+    }
     if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+        transferComplete = transferComplete || ws2811HalfBufferTransferred(1);
+    }
+#else
+    const bool transferComplete = DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF);
+    if (transferComplete) {
         ws2811LedDataTransferInProgress = 0;
-        DMA_Cmd(descriptor->ref, DISABLE);
         DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
     }
+#endif
+    if (transferComplete) {
+        DMA_Cmd(descriptor->ref, DISABLE);
+        TIM_DMACmd(timer, timerDmaRequest, DISABLE);
+        dmaRelease(dmaIdentifier);
+    }
+}
+
+static void ws2811LedStripDMAConfigure(void)
+{
+    DMA_Cmd(dmaRef, DISABLE);
+    DMA_DeInit(dmaRef);
+    DMA_Init(dmaRef, &dmaInitStructure);
+#ifdef USE_LED_STRIP_HALF_BUFFER_DMA
+    DMA_ITConfig(dmaRef, DMA_IT_TC | DMA_IT_HT, ENABLE);
+#else
+    DMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
+#endif
+    dmaSetHandler(dmaIdentifier, WS2811_DMA_IRQHandler, NVIC_PRIO_WS2811_DMA, 0);
 }
 
 void ws2811LedStripHardwareInit(ioTag_t ioTag)
@@ -73,6 +108,12 @@ void ws2811LedStripHardwareInit(ioTag_t ioTag)
         return;
     }
 
+    // a stream in use by e.g. a motor is left alone, the strip stays dark
+    dmaIdentifier = timerHardware->dmaIrqHandler;
+    if (!dmaAllocateShared(dmaIdentifier, OWNER_LED_STRIP)) {
+        return;
+    }
+
     ws2811IO = IOGetByTag(ioTag);
     IOInit(ws2811IO, OWNER_LED_STRIP, 0);
 #ifdef STM32F1
@@ -131,15 +172,10 @@ void ws2811LedStripHardwareInit(ioTag_t ioTag)
 
     TIM_Cmd(timer, ENABLE);
 
-    dmaInit(timerHardware->dmaIrqHandler, OWNER_LED_STRIP, 0);
-    dmaSetHandler(timerHardware->dmaIrqHandler, WS2811_DMA_IRQHandler, NVIC_PRIO_WS2811_DMA, 0);
-
     dmaRef = timerHardware->dmaRef;
-    DMA_DeInit(dmaRef);
+    timerDmaRequest = timerDmaSource(timerHardware->channel);
 
     /* configure DMA */
-    DMA_Cmd(dmaRef, DISABLE);
-    DMA_DeInit(dmaRef);
     DMA_StructInit(&DMA_InitStructure);
     DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)timerCCR(timer, timerHardware->channel);
     DMA_InitStructure.DMA_BufferSize = WS2811_DMA_BUFFER_SIZE;
@@ -161,23 +197,41 @@ void ws2811LedStripHardwareInit(ioTag_t ioTag)
     DMA_InitStructure.DMA_Priority = DMA_Priority_High;
     DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
 #endif
+#ifdef USE_LED_STRIP_HALF_BUFFER_DMA
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+#else
     DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+#endif
+    dmaInitStructure = DMA_InitStructure;
 
-    DMA_Init(dmaRef, &DMA_InitStructure);
-    TIM_DMACmd(timer, timerDmaSource(timerHardware->channel), ENABLE);
-    DMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
+    // on a shared stream another owner may hold the configuration, it is then set on the first transfer
+    if (dmaGetOwner(dmaIdentifier) == OWNER_LED_STRIP) {
+        ws2811LedStripDMAConfigure();
+    }
     ws2811Initialised = true;
 }
 
-void ws2811LedStripDMAEnable(void)
+bool ws2811LedStripDMAEnable(void)
 {
-    if (!ws2811Initialised)
-        return;
+    if (!ws2811Initialised) {
+        return false;
+    }
 
+    const bool reconfigure = dmaGetOwner(dmaIdentifier) != OWNER_LED_STRIP;
+    if (!dmaAcquire(dmaIdentifier, OWNER_LED_STRIP)) {
+        return false;
+    }
+    if (reconfigure) {
+        ws2811LedStripDMAConfigure();
+    }
+
+    TIM_DMACmd(timer, timerDmaRequest, ENABLE);
     DMA_SetCurrDataCounter(dmaRef, WS2811_DMA_BUFFER_SIZE);  // load number of bytes to be transferred
     TIM_SetCounter(timer, 0);
     TIM_Cmd(timer, ENABLE);
     DMA_Cmd(dmaRef, ENABLE);
+
+    return true;
 }
 
 #endif
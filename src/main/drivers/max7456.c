@@ -28,6 +28,10 @@
 
 #include "build/debug.h"
 
+#include "common/boot_arena.h"
+#include "common/maths.h"
+#include "common/utils.h"
+
 #include "pg/max7456.h"
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
@@ -35,6 +39,7 @@
 
 #include "drivers/bus_spi.h"
 #include "drivers/dma.h"
+#include "drivers/exti.h"
 #include "drivers/io.h"
 #include "drivers/light_led.h"
 #include "drivers/max7456.h"
@@ -175,15 +180,15 @@
 // On shared SPI buss we want to change clock for OSD chip and restore for other devices.
 
 #ifdef MAX7456_SPI_CLK
-    #define __spiBusTransactionBegin(busdev)        {spiSetDivisor((busdev)->busdev_u.spi.instance, max7456SpiClock);IOLo((busdev)->busdev_u.spi.csnPin);}
+    #define __spiBusTransactionBegin(busdev)        {spiSetDivisor((busdev)->busdev_u.spi.instance, max7456SpiClock);IOFastLo(&(busdev)->busdev_u.spi.csn);}
 #else
-    #define __spiBusTransactionBegin(busdev)        IOLo((busdev)->busdev_u.spi.csnPin)
+    #define __spiBusTransactionBegin(busdev)        IOFastLo(&(busdev)->busdev_u.spi.csn)
 #endif
 
 #ifdef MAX7456_RESTORE_CLK
-    #define __spiBusTransactionEnd(busdev)       {IOHi((busdev)->busdev_u.spi.csnPin);spiSetDivisor((busdev)->busdev_u.spi.instance, MAX7456_RESTORE_CLK);}
+    #define __spiBusTransactionEnd(busdev)       {IOFastHi(&(busdev)->busdev_u.spi.csn);spiSetDivisor((busdev)->busdev_u.spi.instance, MAX7456_RESTORE_CLK);}
 #else
-    #define __spiBusTransactionEnd(busdev)       IOHi((busdev)->busdev_u.spi.csnPin)
+    #define __spiBusTransactionEnd(busdev)       IOFastHi(&(busdev)->busdev_u.spi.csn)
 #endif
 
 #ifndef MAX7456_SPI_CLK
@@ -200,9 +205,21 @@ uint16_t maxScreenSize = VIDEO_BUFFER_CHARS_PAL;
 // We write everything in screenBuffer and then compare
 // screenBuffer with shadowBuffer to upgrade only changed chars.
 // This solution is faster then redrawing entire screen.
+// Both come from the boot arena, so they take no RAM unless the OSD is enabled.
+
+static uint8_t *screenBuffer;
+static uint8_t *shadowBuffer;
+
+// One bit per block of the screen that may differ from the shadow, so that only those blocks are compared and sent
+#define DIRTY_BLOCK_CHARS   32
+#define DIRTY_BLOCK_COUNT   ((VIDEO_BUFFER_CHARS_PAL + DIRTY_BLOCK_CHARS - 1) / DIRTY_BLOCK_CHARS)
+#define DIRTY_BLOCKS_ALL    ((uint32_t)((1ULL << DIRTY_BLOCK_COUNT) - 1))
+STATIC_ASSERT(DIRTY_BLOCK_COUNT <= 32, dirty_blocks_must_fit_in_a_word);
+
+static uint32_t dirtyBlocks;
 
-static uint8_t screenBuffer[VIDEO_BUFFER_CHARS_PAL+40]; // For faster writes we use memcpy so we need some space to don't overwrite buffer
-static uint8_t shadowBuffer[VIDEO_BUFFER_CHARS_PAL];
+// Consecutive changed characters are sent in auto-increment mode when that's shorter than addressing each one
+#define MIN_AUTO_INCREMENT_RUN  4
 
 //Max chars to update in one idle
 
@@ -211,7 +228,7 @@ static uint8_t shadowBuffer[VIDEO_BUFFER_CHARS_PAL];
 volatile bool dmaTransactionInProgress = false;
 #endif
 
-static uint8_t spiBuff[MAX_CHARS2UPDATE*6];
+static DMA_RAM_ZERO_INIT uint8_t spiBuff[MAX_CHARS2UPDATE*6];
 
 static uint8_t  videoSignalCfg;
 static uint8_t  videoSignalReg  = OSD_ENABLE; // OSD_ENABLE required to trigger first ReInit
@@ -223,9 +240,35 @@ static uint8_t  vosRegValue; // VOS (Vertical offset register) value
 static bool max7456Lock         = false;
 static bool fontIsLoading       = false;
 
+// Characters waiting to be programmed into the NVM, the oldest one is being written while fontNvmBusy is set
+#ifndef MAX7456_FONT_QUEUE_SIZE
+#define MAX7456_FONT_QUEUE_SIZE     4
+#endif
+// The display is enabled again once no character has been uploaded for this long
+#define MAX7456_FONT_IDLE_MS        1000
+
+typedef struct max7456FontChar_s {
+    uint8_t address;
+    uint8_t data[MAX7456_FONT_CHAR_BYTES];
+} max7456FontChar_t;
+
+static max7456FontChar_t fontQueue[MAX7456_FONT_QUEUE_SIZE];
+static uint8_t fontQueueHead;
+static uint8_t fontQueueCount;
+static bool fontNvmBusy;
+static uint16_t fontCharsWritten;
+static timeMs_t fontLastUploadMs;
+
+#ifdef USE_MAX7456_VSYNC
+static extiCallbackRec_t vsyncExti;
+static bool vsyncAvailable;
+static volatile uint32_t vsyncFieldCount;
+#endif
+
 static uint8_t max7456DeviceType;
 
 static void max7456DrawScreenSlow(void);
+static void max7456ProcessFontQueue(void);
 
 static uint8_t max7456Send(uint8_t add, uint8_t data)
 {
@@ -405,6 +448,7 @@ void max7456ReInit(void)
 
     // Clear shadow to force redraw all screen in non-dma mode.
     memset(shadowBuffer, 0, maxScreenSize);
+    dirtyBlocks = DIRTY_BLOCKS_ALL;
     if (firstInit) {
         max7456DrawScreenSlow();
         firstInit = false;
@@ -415,6 +459,50 @@ void max7456ReInit(void)
 // Here we init only CS and try to init MAX for first time.
 // Also detect device type (MAX v.s. AT)
 
+#ifdef USE_MAX7456_VSYNC
+static void max7456VsyncExtiHandler(extiCallbackRec_t *cb)
+{
+    UNUSED(cb);
+
+    ++vsyncFieldCount;
+}
+
+// VSYNC is an open-drain output that goes low at the start of each field, the rising edge falls inside vertical blanking
+static void max7456VsyncInit(ioTag_t vsyncTag)
+{
+    if (!vsyncTag) {
+        return;
+    }
+
+    const IO_t vsyncIO = IOGetByTag(vsyncTag);
+    if (!IOIsFreeOrPreinit(vsyncIO)) {
+        return;
+    }
+
+    IOInit(vsyncIO, OWNER_OSD_VSYNC, 0);
+    EXTIHandlerInit(&vsyncExti, max7456VsyncExtiHandler);
+#if defined(STM32F7)
+    EXTIConfig(vsyncIO, &vsyncExti, NVIC_PRIO_MAX7456_VSYNC_EXTI, IO_CONFIG(GPIO_MODE_INPUT, 0, GPIO_PULLUP));
+#else
+    IOConfigGPIO(vsyncIO, IOCFG_IPU);
+    EXTIConfig(vsyncIO, &vsyncExti, NVIC_PRIO_MAX7456_VSYNC_EXTI, EXTI_Trigger_Rising);
+#endif
+    EXTIEnable(vsyncIO, true);
+
+    vsyncAvailable = true;
+}
+
+bool max7456VsyncAvailable(void)
+{
+    return vsyncAvailable;
+}
+
+uint32_t max7456FieldCount(void)
+{
+    return vsyncFieldCount;
+}
+#endif
+
 bool max7456Init(const max7456Config_t *max7456Config, const vcdProfile_t *pVcdProfile, bool cpuOverclock)
 {
     max7456HardwareReset();
@@ -423,12 +511,21 @@ bool max7456Init(const max7456Config_t *max7456Config, const vcdProfile_t *pVcdP
         return false;
     }
 
-    busdev->busdev_u.spi.csnPin = IOGetByTag(max7456Config->csTag);
+    spiBusSetCsPin(busdev, IOGetByTag(max7456Config->csTag));
 
     if (!IOIsFreeOrPreinit(busdev->busdev_u.spi.csnPin)) {
         return false;
     }
 
+    if (!screenBuffer) {
+        uint8_t *buffers = bootArenaAllocate(MAX7456_SCREEN_BUFFER_SIZE + MAX7456_SHADOW_BUFFER_SIZE, "MAX7456");
+        if (!buffers) {
+            return false;
+        }
+        screenBuffer = buffers;
+        shadowBuffer = buffers + MAX7456_SCREEN_BUFFER_SIZE;
+    }
+
     IOInit(busdev->busdev_u.spi.csnPin, OWNER_OSD_CS, 0);
     IOConfigGPIO(busdev->busdev_u.spi.csnPin, SPI_IO_CS_CFG);
     IOHi(busdev->busdev_u.spi.csnPin);
@@ -437,7 +534,7 @@ bool max7456Init(const max7456Config_t *max7456Config, const vcdProfile_t *pVcdP
 
     // Detect device type by writing and reading CA[8] bit at CMAL[6].
     // Do this at half the speed for safety.
-    spiSetDivisor(busdev->busdev_u.spi.instance, MAX7456_SPI_CLK * 2);
+    spiBusSetDivisor(busdev, MAX7456_SPI_CLK * 2);
 
     max7456Send(MAX7456ADD_CMAL, (1 << 6)); // CA[8] bit
 
@@ -472,7 +569,7 @@ bool max7456Init(const max7456Config_t *max7456Config, const vcdProfile_t *pVcdP
     UNUSED(cpuOverclock);
 #endif
 
-    spiSetDivisor(busdev->busdev_u.spi.instance, max7456SpiClock);
+    spiBusSetDivisor(busdev, max7456SpiClock);
 
     // force soft reset on Max7456
     __spiBusTransactionBegin(busdev);
@@ -488,6 +585,10 @@ bool max7456Init(const max7456Config_t *max7456Config, const vcdProfile_t *pVcdP
     dmaSetHandler(MAX7456_DMA_IRQ_HANDLER_ID, max7456_dma_irq_handler, NVIC_PRIO_MAX7456_DMA, 0);
 #endif
 
+#ifdef USE_MAX7456_VSYNC
+    max7456VsyncInit(max7456Config->vsyncTag);
+#endif
+
     // Real init will be made later when driver detect idle.
     return true;
 }
@@ -526,26 +627,38 @@ void max7456Brightness(uint8_t black, uint8_t white)
 }
 
 //just fill with spaces with some tricks
+static void max7456SetChar(int pos, uint8_t c)
+{
+    if (screenBuffer[pos] != c) {
+        screenBuffer[pos] = c;
+        dirtyBlocks |= 1U << (pos / DIRTY_BLOCK_CHARS);
+    }
+}
+
 void max7456ClearScreen(void)
 {
-    memset(screenBuffer, 0x20, VIDEO_BUFFER_CHARS_PAL);
+    for (int pos = 0; pos < VIDEO_BUFFER_CHARS_PAL; pos++) {
+        max7456SetChar(pos, 0x20);
+    }
 }
 
 uint8_t* max7456GetScreenBuffer(void)
 {
+    // The caller may write to any of it
+    dirtyBlocks = DIRTY_BLOCKS_ALL;
     return screenBuffer;
 }
 
 void max7456WriteChar(uint8_t x, uint8_t y, uint8_t c)
 {
-    screenBuffer[y*CHARS_PER_LINE+x] = c;
+    max7456SetChar(y*CHARS_PER_LINE+x, c);
 }
 
 void max7456Write(uint8_t x, uint8_t y, const char *buff)
 {
     for (int i = 0; *(buff+i); i++) {
         if (x+i < CHARS_PER_LINE) {// Do not write over screen
-            screenBuffer[y*CHARS_PER_LINE+x+i] = *(buff+i);
+            max7456SetChar(y*CHARS_PER_LINE+x+i, *(buff+i));
         }
     }
 }
@@ -561,12 +674,8 @@ bool max7456DmaInProgress(void)
 
 bool max7456BuffersSynced(void)
 {
-    for (int i = 0; i < maxScreenSize; i++) {
-        if (screenBuffer[i] != shadowBuffer[i]) {
-            return false;
-        }
-    }
-    return true;
+    // Characters only differ from the shadow in dirty blocks
+    return dirtyBlocks == 0;
 }
 
 void max7456ReInitIfRequired(void)
@@ -619,11 +728,60 @@ void max7456ReInitIfRequired(void)
     //------------   end of (re)init-------------------------------------
 }
 
+// Queue the changed characters of a block in spiBuff, returns the new length of spiBuff
+static int max7456QueueBlock(int block, int buff_len)
+{
+    const int blockEnd = MIN((block + 1) * DIRTY_BLOCK_CHARS, maxScreenSize);
+
+    for (int pos = block * DIRTY_BLOCK_CHARS; pos < blockEnd; pos++) {
+        if (screenBuffer[pos] == shadowBuffer[pos]) {
+            continue;
+        }
+
+        // The END_STRING character would end auto-increment mode, so it always goes on its own
+        int runEnd = pos;
+        while (runEnd < blockEnd && screenBuffer[runEnd] != shadowBuffer[runEnd] && screenBuffer[runEnd] != END_STRING) {
+            runEnd++;
+        }
+
+        spiBuff[buff_len++] = MAX7456ADD_DMAH;
+        spiBuff[buff_len++] = pos >> 8;
+        spiBuff[buff_len++] = MAX7456ADD_DMAL;
+        spiBuff[buff_len++] = pos & 0xff;
+
+        if (runEnd - pos >= MIN_AUTO_INCREMENT_RUN) {
+            spiBuff[buff_len++] = MAX7456ADD_DMM;
+            spiBuff[buff_len++] = displayMemoryModeReg | 1;
+            for (; pos < runEnd; pos++) {
+                spiBuff[buff_len++] = MAX7456ADD_DMDI;
+                spiBuff[buff_len++] = screenBuffer[pos];
+                shadowBuffer[pos] = screenBuffer[pos];
+            }
+            spiBuff[buff_len++] = MAX7456ADD_DMDI;
+            spiBuff[buff_len++] = END_STRING;
+            spiBuff[buff_len++] = MAX7456ADD_DMM;
+            spiBuff[buff_len++] = displayMemoryModeReg;
+            pos--;
+        } else {
+            spiBuff[buff_len++] = MAX7456ADD_DMDI;
+            spiBuff[buff_len++] = screenBuffer[pos];
+            shadowBuffer[pos] = screenBuffer[pos];
+        }
+    }
+
+    return buff_len;
+}
+
 void max7456DrawScreen(void)
 {
-    static uint16_t pos = 0;
+    static int block = 0;
 
-    if (!max7456Lock && !fontIsLoading) {
+    if (fontIsLoading) {
+        max7456ProcessFontQueue();
+        return;
+    }
+
+    if (!max7456Lock && !max7456DmaInProgress()) {
 
         // (Re)Initialize MAX7456 at startup or stall is detected.
 
@@ -631,24 +789,27 @@ void max7456DrawScreen(void)
 
         max7456ReInitIfRequired();
 
+        // Queue whole dirty blocks while a block of changed characters (6 bytes each at worst) still fits
         int buff_len = 0;
-        for (int k = 0; k < MAX_CHARS2UPDATE; k++) {
-            if (screenBuffer[pos] != shadowBuffer[pos]) {
-                spiBuff[buff_len++] = MAX7456ADD_DMAH;
-                spiBuff[buff_len++] = pos >> 8;
-                spiBuff[buff_len++] = MAX7456ADD_DMAL;
-                spiBuff[buff_len++] = pos & 0xff;
-                spiBuff[buff_len++] = MAX7456ADD_DMDI;
-                spiBuff[buff_len++] = screenBuffer[pos];
-                shadowBuffer[pos] = screenBuffer[pos];
+        const int blockCount = (maxScreenSize + DIRTY_BLOCK_CHARS - 1) / DIRTY_BLOCK_CHARS;
+        for (int k = 0; k < blockCount && dirtyBlocks; k++) {
+            if (buff_len + DIRTY_BLOCK_CHARS * 6 > (int)sizeof(spiBuff)) {
+                break;
             }
 
-            if (++pos >= maxScreenSize) {
-                pos = 0;
-                break;
+            if (dirtyBlocks & (1U << block)) {
+                buff_len = max7456QueueBlock(block, buff_len);
+                dirtyBlocks &= ~(1U << block);
+            }
+
+            if (++block >= blockCount) {
+                block = 0;
             }
         }
 
+        // Blocks past the end of an NTSC screen are never sent
+        dirtyBlocks &= (1U << blockCount) - 1;
+
         if (buff_len) {
 #ifdef MAX7456_DMA_CHANNEL_TX
             max7456SendDma(spiBuff, NULL, buff_len);
@@ -683,6 +844,7 @@ static void max7456DrawScreenSlow(void)
         }
         shadowBuffer[xx] = screenBuffer[xx];
     }
+    dirtyBlocks = 0;
 
     max7456Send(MAX7456ADD_DMDI, END_STRING);
     max7456Send(MAX7456ADD_DMM, displayMemoryModeReg);
@@ -706,7 +868,7 @@ static void max7456DrawScreenSlow(void)
 // should not be used when armed
 void max7456RefreshAll(void)
 {
-    if (!max7456Lock) {
+    if (!max7456Lock && !fontIsLoading) {
 #ifdef MAX7456_DMA_CHANNEL_TX
         while (dmaTransactionInProgress);
 #endif
@@ -719,42 +881,93 @@ void max7456RefreshAll(void)
     }
 }
 
-void max7456WriteNvm(uint8_t char_address, const uint8_t *font_data)
+/*
+ * Advances the font upload: collects a finished NVM write, and starts writing the next queued character.
+ * Once the queue has been empty for a while the display is enabled again, through the stall check of the next redraw.
+ */
+static void max7456ProcessFontQueue(void)
 {
-#ifdef MAX7456_DMA_CHANNEL_TX
-    while (dmaTransactionInProgress);
-#endif
-    while (max7456Lock);
+    if (max7456Lock || max7456DmaInProgress()) {
+        return;
+    }
     max7456Lock = true;
 
     __spiBusTransactionBegin(busdev);
-    // disable display
-    fontIsLoading = true;
-    max7456Send(MAX7456ADD_VM0, 0);
 
-    max7456Send(MAX7456ADD_CMAH, char_address); // set start address high
+    if (fontNvmBusy) {
+        // Bit 5 of the status register returns to 0 when the NVM write is done (12ms)
+        if (max7456Send(MAX7456ADD_STAT, 0x00) & STAT_NVR_BUSY) {
+            __spiBusTransactionEnd(busdev);
+            max7456Lock = false;
+            return;
+        }
+        fontNvmBusy = false;
+        fontQueueHead = (fontQueueHead + 1) % MAX7456_FONT_QUEUE_SIZE;
+        fontQueueCount--;
+        fontCharsWritten++;
+    }
+
+    if (fontQueueCount) {
+        const max7456FontChar_t *fontChar = &fontQueue[fontQueueHead];
+
+        // disable display
+        max7456Send(MAX7456ADD_VM0, 0);
+
+        max7456Send(MAX7456ADD_CMAH, fontChar->address); // set start address high
+
+        for (int x = 0; x < MAX7456_FONT_CHAR_BYTES; x++) {
+            max7456Send(MAX7456ADD_CMAL, x); //set start address low
+            max7456Send(MAX7456ADD_CMDI, fontChar->data[x]);
+        }
+
+        // Transfer 54 bytes from shadow ram to NVM
+        max7456Send(MAX7456ADD_CMM, WRITE_NVR);
+        fontNvmBusy = true;
 
-    for (int x = 0; x < 54; x++) {
-        max7456Send(MAX7456ADD_CMAL, x); //set start address low
-        max7456Send(MAX7456ADD_CMDI, font_data[x]);
 #ifdef LED0_TOGGLE
         LED0_TOGGLE;
 #else
         LED1_TOGGLE;
 #endif
+    } else if (millis() - fontLastUploadMs > MAX7456_FONT_IDLE_MS) {
+        fontIsLoading = false;
     }
 
-    // Transfer 54 bytes from shadow ram to NVM
+    __spiBusTransactionEnd(busdev);
+
+    max7456Lock = false;
+}
+
+/*
+ * Queues a character for programming into the NVM and returns straight away, the write itself is done in the background
+ * by max7456DrawScreen(). Only waits while the queue is full.
+ */
+void max7456WriteNvm(uint8_t char_address, const uint8_t *font_data)
+{
+    // the display is kept disabled from the first character until the upload is done
+    fontIsLoading = true;
+    fontLastUploadMs = millis();
 
-    max7456Send(MAX7456ADD_CMM, WRITE_NVR);
+    while (fontQueueCount == MAX7456_FONT_QUEUE_SIZE) {
+        max7456ProcessFontQueue();
+    }
 
-    // Wait until bit 5 in the status register returns to 0 (12ms)
+    max7456FontChar_t *fontChar = &fontQueue[(fontQueueHead + fontQueueCount) % MAX7456_FONT_QUEUE_SIZE];
+    fontChar->address = char_address;
+    memcpy(fontChar->data, font_data, MAX7456_FONT_CHAR_BYTES);
+    fontQueueCount++;
 
-    while ((max7456Send(MAX7456ADD_STAT, 0x00) & STAT_NVR_BUSY) != 0x00);
+    max7456ProcessFontQueue();
+}
 
-    __spiBusTransactionEnd(busdev);
+uint8_t max7456FontQueueLength(void)
+{
+    return fontQueueCount;
+}
 
-    max7456Lock = false;
+uint16_t max7456FontCharsWritten(void)
+{
+    return fontCharsWritten;
 }
 
 #ifdef MAX7456_NRST_PIN
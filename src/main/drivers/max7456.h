@@ -26,6 +26,12 @@
 #define VIDEO_LINES_NTSC          13
 #define VIDEO_LINES_PAL           16
 
+#define MAX7456_FONT_CHAR_BYTES   54
+
+// For faster writes we use memcpy so the screen buffer needs some space to don't overwrite the shadow buffer
+#define MAX7456_SCREEN_BUFFER_SIZE  (VIDEO_BUFFER_CHARS_PAL + 40)
+#define MAX7456_SHADOW_BUFFER_SIZE  VIDEO_BUFFER_CHARS_PAL
+
 extern uint16_t maxScreenSize;
 
 struct vcdProfile_s;
@@ -36,6 +42,8 @@ void    max7456Invert(bool invert);
 void    max7456Brightness(uint8_t black, uint8_t white);
 void    max7456DrawScreen(void);
 void    max7456WriteNvm(uint8_t char_address, const uint8_t *font_data);
+uint8_t max7456FontQueueLength(void);
+uint16_t max7456FontCharsWritten(void);
 uint8_t max7456GetRowsCount(void);
 void    max7456Write(uint8_t x, uint8_t y, const char *buff);
 void    max7456WriteChar(uint8_t x, uint8_t y, uint8_t c);
@@ -44,3 +52,5 @@ void    max7456RefreshAll(void);
 uint8_t* max7456GetScreenBuffer(void);
 bool    max7456DmaInProgress(void);
 bool    max7456BuffersSynced(void);
+bool    max7456VsyncAvailable(void);
+uint32_t max7456FieldCount(void);
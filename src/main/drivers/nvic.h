@@ -64,6 +64,11 @@
 #define NVIC_PRIO_MAG_DATA_READY           NVIC_BUILD_PRIORITY(0x0f, 0x0f)
 #define NVIC_PRIO_CALLBACK                 NVIC_BUILD_PRIORITY(0x0f, 0x0f)
 #define NVIC_PRIO_MAX7456_DMA              NVIC_BUILD_PRIORITY(3, 0)
+#define NVIC_PRIO_MAX7456_VSYNC_EXTI       NVIC_BUILD_PRIORITY(0x0f, 0x0f)
+#define NVIC_PRIO_GYRO_PID_SWI             NVIC_BUILD_PRIORITY(0x0f, 0x0f)
+#define NVIC_PRIO_GYRO_SPI_DMA             NVIC_BUILD_PRIORITY(0x0f, 0x0f)
+#define NVIC_PRIO_ADC_DMA                  NVIC_BUILD_PRIORITY(3, 1)
+#define NVIC_PRIO_SPI_DMA                  NVIC_BUILD_PRIORITY(2, 1)  // above the sensor interrupts, which may wait for the bus
 
 #ifdef USE_HAL_DRIVER
 // utility macros to join/split priority
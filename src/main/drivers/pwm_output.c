@@ -24,6 +24,9 @@
 #include <math.h>
 
 #include "platform.h"
+
+#include "build/profile.h"
+
 #include "drivers/time.h"
 
 #include "drivers/io.h"
@@ -41,13 +44,25 @@ FAST_RAM_ZERO_INIT loadDmaBufferFn *loadDmaBuffer;
 #define DSHOT_COMMAND_DELAY_US 1000
 #define DSHOT_ESCINFO_DELAY_US 12000
 #define DSHOT_BEEP_DELAY_US 100000
+// interval of the motor updates sent while a blocking command is drained
+#define DSHOT_COMMAND_POLL_US 100
 
-typedef struct dshotCommandControl_s {
-    timeUs_t nextCommandAtUs;
+// one more than the number of commands that can be queued, a power of two
+#define DSHOT_COMMAND_QUEUE_SIZE 8
+
+typedef struct dshotCommandQueueEntry_s {
     timeUs_t delayAfterCommandUs;
-    bool waitingForIdle;
     uint8_t repeats;
     uint8_t command[MAX_SUPPORTED_MOTORS];
+} dshotCommandQueueEntry_t;
+
+// Commands are queued by the tasks and drained by the motor updates, the entry at the tail is the one being sent
+typedef struct dshotCommandControl_s {
+    dshotCommandQueueEntry_t queue[DSHOT_COMMAND_QUEUE_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    timeUs_t nextCommandAtUs;
+    bool waitingForIdle;
 } dshotCommandControl_t;
 
 static dshotCommandControl_t dshotCommandControl;
@@ -62,11 +77,14 @@ static pwmOutputPort_t beeperPwm;
 static uint16_t freqBeep = 0;
 #endif
 
-static bool pwmMotorsEnabled = false;
+static FAST_RAM_ZERO_INIT bool pwmMotorsEnabled = false;
 static bool isDshot = false;
 #ifdef USE_DSHOT_DMAR
 FAST_RAM_ZERO_INIT bool useBurstDshot = false;
 #endif
+#ifdef USE_DSHOT_TELEMETRY
+FAST_RAM_ZERO_INIT bool useDshotTelemetry = false;
+#endif
 
 static void pwmOCConfig(TIM_TypeDef *tim, uint8_t channel, uint16_t value, uint8_t output)
 {
@@ -157,11 +175,28 @@ static FAST_CODE void pwmWriteDshot(uint8_t index, float value)
     pwmWriteDshotInt(index, lrintf(value));
 }
 
+#define B(bit) ((bit) ? MOTOR_BIT_1 : MOTOR_BIT_0)
+#define NIBBLE(n) { B((n) & 8), B((n) & 4), B((n) & 2), B((n) & 1) }
+
+// timer compare values of the four bits of each nibble, MSB first
+static const uint8_t dshotNibbleBits[16][4] = {
+    NIBBLE(0x0), NIBBLE(0x1), NIBBLE(0x2), NIBBLE(0x3), NIBBLE(0x4), NIBBLE(0x5), NIBBLE(0x6), NIBBLE(0x7),
+    NIBBLE(0x8), NIBBLE(0x9), NIBBLE(0xa), NIBBLE(0xb), NIBBLE(0xc), NIBBLE(0xd), NIBBLE(0xe), NIBBLE(0xf),
+};
+
+#undef NIBBLE
+#undef B
+
 static FAST_CODE uint8_t loadDmaBufferDshot(uint32_t *dmaBuffer, int stride, uint16_t packet)
 {
-    for (int i = 0; i < 16; i++) {
-        dmaBuffer[i * stride] = (packet & 0x8000) ? MOTOR_BIT_1 : MOTOR_BIT_0;  // MSB first
-        packet <<= 1;
+    for (int i = 0; i < 4; i++) {
+        const uint8_t *bits = dshotNibbleBits[packet >> 12];  // MSB first
+        dmaBuffer[0] = bits[0];
+        dmaBuffer[stride] = bits[1];
+        dmaBuffer[2 * stride] = bits[2];
+        dmaBuffer[3 * stride] = bits[3];
+        dmaBuffer += 4 * stride;
+        packet <<= 4;
     }
 
     return DSHOT_DMA_BUFFER_SIZE;
@@ -284,6 +319,10 @@ void motorDevInit(const motorDevConfig_t *motorConfig, uint16_t idlePulse, uint8
         if (motorConfig->useBurstDshot) {
             useBurstDshot = true;
         }
+#endif
+#ifdef USE_DSHOT_TELEMETRY
+        // the burst DMA is shared by all the channels of a timer, so they cannot be switched to input one by one
+        useDshotTelemetry = motorConfig->useDshotTelemetry && !useBurstDshot;
 #endif
         break;
 #endif
@@ -311,10 +350,14 @@ void motorDevInit(const motorDevConfig_t *motorConfig, uint16_t idlePulse, uint8
 
 #ifdef USE_DSHOT
         if (isDshot) {
-            pwmDshotMotorHardwareConfig(timerHardware,
-                motorIndex,
-                motorConfig->motorPwmProtocol,
-                motorConfig->motorPwmInversion ? timerHardware->output ^ TIMER_OUTPUT_INVERTED : timerHardware->output);
+            uint8_t output = motorConfig->motorPwmInversion ? timerHardware->output ^ TIMER_OUTPUT_INVERTED : timerHardware->output;
+#ifdef USE_DSHOT_TELEMETRY
+            // bidirectional DShot is sent inverted, the ESC replies on the same line
+            if (useDshotTelemetry) {
+                output ^= TIMER_OUTPUT_INVERTED;
+            }
+#endif
+            pwmDshotMotorHardwareConfig(timerHardware, motorIndex, motorConfig->motorPwmProtocol, output);
             motors[motorIndex].enabled = true;
             continue;
         }
@@ -403,19 +446,32 @@ bool allMotorsAreIdle(uint8_t motorCount)
 
 FAST_CODE bool pwmDshotCommandIsQueued(void)
 {
-    return dshotCommandControl.nextCommandAtUs;
+    return dshotCommandControl.head != dshotCommandControl.tail;
 }
 
 FAST_CODE bool pwmDshotCommandIsProcessing(void)
 {
-    return dshotCommandControl.nextCommandAtUs && !dshotCommandControl.waitingForIdle && dshotCommandControl.repeats > 0;
+    return pwmDshotCommandIsQueued() && !dshotCommandControl.waitingForIdle && dshotCommandControl.queue[dshotCommandControl.tail].repeats > 0;
+}
+
+static bool pwmDshotCommandQueueIsFull(void)
+{
+    return ((dshotCommandControl.head + 1) % DSHOT_COMMAND_QUEUE_SIZE) == dshotCommandControl.tail;
 }
 
+static void pwmDshotCommandStart(uint8_t motorCount, timeUs_t timeNowUs, timeDelta_t delayUs)
+{
+    dshotCommandControl.nextCommandAtUs = timeNowUs + delayUs;
+    dshotCommandControl.waitingForIdle = !allMotorsAreIdle(motorCount);
+}
+
+// A blocking command is sent before returning, the others are sent by the following motor updates.
+// Commands are dropped while the queue is full.
 void pwmWriteDshotCommand(uint8_t index, uint8_t motorCount, uint8_t command, bool blocking)
 {
     timeUs_t timeNowUs = micros();
 
-    if (!isMotorProtocolDshot() || (command > DSHOT_MAX_COMMAND) || pwmDshotCommandIsQueued()) {
+    if (!isMotorProtocolDshot() || (command > DSHOT_MAX_COMMAND) || pwmDshotCommandQueueIsFull()) {
         return;
     }
 
@@ -443,41 +499,34 @@ void pwmWriteDshotCommand(uint8_t index, uint8_t motorCount, uint8_t command, bo
         break;
     }
 
-    if (blocking) {
-        delayMicroseconds(DSHOT_INITIAL_DELAY_US - DSHOT_COMMAND_DELAY_US);
-        for (; repeats; repeats--) {
-            delayMicroseconds(DSHOT_COMMAND_DELAY_US);
+    dshotCommandQueueEntry_t *entry = &dshotCommandControl.queue[dshotCommandControl.head];
+    entry->repeats = repeats;
+    entry->delayAfterCommandUs = delayAfterCommandUs;
+    for (unsigned i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        entry->command[i] = (index == i || index == ALL_MOTORS) ? command : DSHOT_CMD_MOTOR_STOP;
+    }
 
-            for (uint8_t i = 0; i < motorCount; i++) {
-                if ((i == index) || (index == ALL_MOTORS)) {
-                    motorDmaOutput_t *const motor = getMotorDmaOutput(i);
-                    motor->requestTelemetry = true;
-                    pwmWriteDshotInt(i, command);
-                }
-            }
+    if (!pwmDshotCommandIsQueued()) {
+        pwmDshotCommandStart(motorCount, timeNowUs, DSHOT_INITIAL_DELAY_US);
+    }
+    // the entry is complete before the motor updates can see it
+    dshotCommandControl.head = (dshotCommandControl.head + 1) % DSHOT_COMMAND_QUEUE_SIZE;
 
-            pwmCompleteDshotMotorUpdate(0);
-        }
-        delayMicroseconds(delayAfterCommandUs);
-    } else {
-        dshotCommandControl.repeats = repeats;
-        dshotCommandControl.nextCommandAtUs = timeNowUs + DSHOT_INITIAL_DELAY_US;
-        dshotCommandControl.delayAfterCommandUs = delayAfterCommandUs;
-        for (unsigned i = 0; i < motorCount; i++) {
-            if (index == i || index == ALL_MOTORS) {
-                dshotCommandControl.command[i] = command;
-            } else {
-                dshotCommandControl.command[i] = command;
+    if (blocking) {
+        // used with the motors disabled, for callers that need the command sent before they carry on
+        while (pwmDshotCommandIsQueued()) {
+            for (uint8_t i = 0; i < motorCount; i++) {
+                pwmWriteDshotInt(i, DSHOT_CMD_MOTOR_STOP);
             }
+            pwmCompleteDshotMotorUpdate(motorCount);
+            delayMicroseconds(DSHOT_COMMAND_POLL_US);
         }
-
-        dshotCommandControl.waitingForIdle = !allMotorsAreIdle(motorCount);
     }
 }
 
 uint8_t pwmGetDshotCommand(uint8_t index)
 {
-    return dshotCommandControl.command[index];
+    return dshotCommandControl.queue[dshotCommandControl.tail].command[index];
 }
 
 FAST_CODE_NOINLINE bool pwmDshotCommandOutputIsEnabled(uint8_t motorCount)
@@ -500,21 +549,42 @@ FAST_CODE_NOINLINE bool pwmDshotCommandOutputIsEnabled(uint8_t motorCount)
     }   
   
     //Timed motor update happening with dshot command
-    if (dshotCommandControl.repeats > 0) {
-        dshotCommandControl.repeats--;
+    dshotCommandQueueEntry_t *entry = &dshotCommandControl.queue[dshotCommandControl.tail];
+    if (entry->repeats > 0) {
+        entry->repeats--;
 
-        if (dshotCommandControl.repeats > 0) {
+        if (entry->repeats > 0) {
             dshotCommandControl.nextCommandAtUs = timeNowUs + DSHOT_COMMAND_DELAY_US;
         } else {
-            dshotCommandControl.nextCommandAtUs = timeNowUs + dshotCommandControl.delayAfterCommandUs;
+            dshotCommandControl.nextCommandAtUs = timeNowUs + entry->delayAfterCommandUs;
         }
     } else {
-        dshotCommandControl.nextCommandAtUs = 0;
+        // the delay after the command has passed, so the next one can follow straight away
+        dshotCommandControl.tail = (dshotCommandControl.tail + 1) % DSHOT_COMMAND_QUEUE_SIZE;
+        if (pwmDshotCommandIsQueued()) {
+            pwmDshotCommandStart(motorCount, timeNowUs, 0);
+        }
     }
 
     return true;
 }
 
+// Encodes the motor value into the DMA buffer, unless the buffer already holds the same value and telemetry request.
+// The packet of a motor at a steady throttle is then encoded only once.
+FAST_CODE uint8_t pwmDshotLoadDmaBuffer(motorDmaOutput_t *const motor, uint32_t *dmaBuffer, int stride)
+{
+    const uint16_t packet = DSHOT_DMA_BUFFER_LOADED | (motor->value << 1) | (motor->requestTelemetry ? 1 : 0);
+    if (packet != motor->dmaBufferPacket) {
+        motor->dmaBufferPacket = packet;
+        PROFILE_BEGIN(PROFILE_DSHOT_ENCODE);
+        motor->dmaBufferSize = loadDmaBuffer(dmaBuffer, stride, prepareDshotPacket(motor));
+        PROFILE_END(PROFILE_DSHOT_ENCODE);
+    }
+    motor->requestTelemetry = false;
+
+    return motor->dmaBufferSize;
+}
+
 FAST_CODE uint16_t prepareDshotPacket(motorDmaOutput_t *const motor)
 {
     uint16_t packet = (motor->value << 1) | (motor->requestTelemetry ? 1 : 0);
@@ -527,6 +597,12 @@ FAST_CODE uint16_t prepareDshotPacket(motorDmaOutput_t *const motor)
         csum ^=  csum_data;   // xor data by nibbles
         csum_data >>= 4;
     }
+#ifdef USE_DSHOT_TELEMETRY
+    // an inverted checksum asks the ESC for the eRPM reply
+    if (useDshotTelemetry) {
+        csum = ~csum;
+    }
+#endif
     csum &= 0xf;
     // append checksum
     packet = (packet << 4) | csum;
@@ -108,8 +108,14 @@ typedef enum {
 
 
 #define DSHOT_DMA_BUFFER_SIZE   18 /* resolution + frame reset (2us) */
+#define DSHOT_DMA_BUFFER_LOADED 0x8000
 #define PROSHOT_DMA_BUFFER_SIZE 6  /* resolution + frame reset (2us) */
 
+#ifdef USE_DSHOT_TELEMETRY
+#define DSHOT_TELEMETRY_INPUT_LEN 32 /* edge timestamps captured from the ESC reply */
+#define DSHOT_TELEMETRY_INVALID   0xffff
+#endif
+
 typedef struct {
     TIM_TypeDef *timer;
 #if defined(USE_DSHOT) && defined(USE_DSHOT_DMAR)
@@ -122,6 +128,9 @@ typedef struct {
     uint32_t dmaBurstBuffer[DSHOT_DMA_BUFFER_SIZE * 4];
 #endif
     uint16_t timerDmaSources;
+#ifdef USE_DSHOT_TELEMETRY
+    uint16_t outputPeriod;
+#endif
 } motorDmaTimer_t;
 
 typedef struct {
@@ -134,11 +143,23 @@ typedef struct {
 #endif
     motorDmaTimer_t *timer;
     volatile bool requestTelemetry;
+    uint16_t dmaBufferPacket;           // value and telemetry bit encoded in the DMA buffer, DSHOT_DMA_BUFFER_LOADED is clear while empty
+    uint8_t dmaBufferSize;
 #if defined(STM32F3) || defined(STM32F4) || defined(STM32F7)
     uint32_t dmaBuffer[DSHOT_DMA_BUFFER_SIZE];
 #else
     uint8_t dmaBuffer[DSHOT_DMA_BUFFER_SIZE];
 #endif
+#ifdef USE_DSHOT_TELEMETRY
+    bool useTelemetry;                  // the channel is switched to input capture after each frame to read the ESC reply
+    volatile bool isInput;
+    uint16_t dshotTelemetryValue;       // eRPM / 100, as reported by the serial ESC sensor
+    uint16_t dshotTelemetryInvalidCount;
+    TIM_OCInitTypeDef ocInitStruct;
+    TIM_ICInitTypeDef icInitStruct;
+    DMA_InitTypeDef dmaInitStruct;
+    uint32_t dmaInputBuffer[DSHOT_TELEMETRY_INPUT_LEN];
+#endif
 } motorDmaOutput_t;
 
 motorDmaOutput_t *getMotorDmaOutput(uint8_t index);
@@ -169,9 +190,13 @@ typedef struct motorDevConfig_s {
     uint8_t  useUnsyncedPwm;
     uint8_t  useBurstDshot;
     ioTag_t  ioTags[MAX_SUPPORTED_MOTORS];
+    uint8_t  useDshotTelemetry;             // Bidirectional DShot, the ESCs reply to each frame with their eRPM
 } motorDevConfig_t;
 
 extern bool useBurstDshot;
+#ifdef USE_DSHOT_TELEMETRY
+extern bool useDshotTelemetry;
+#endif
 
 void motorDevInit(const motorDevConfig_t *motorDevConfig, uint16_t idlePulse, uint8_t motorCount);
 
@@ -192,6 +217,7 @@ bool isMotorProtocolDshot(void);
 typedef uint8_t loadDmaBufferFn(uint32_t *dmaBuffer, int stride, uint16_t packet);  // function pointer used to encode a digital motor value into the DMA buffer representation
 
 uint16_t prepareDshotPacket(motorDmaOutput_t *const motor);
+uint8_t pwmDshotLoadDmaBuffer(motorDmaOutput_t *const motor, uint32_t *dmaBuffer, int stride);
 
 extern loadDmaBufferFn *loadDmaBuffer;
 
@@ -207,6 +233,10 @@ bool pwmDshotCommandIsProcessing(void);
 uint8_t pwmGetDshotCommand(uint8_t index);
 bool pwmDshotCommandOutputIsEnabled(uint8_t motorCount);
 
+#ifdef USE_DSHOT_TELEMETRY
+uint16_t getDshotTelemetry(uint8_t index);
+#endif
+
 #endif
 
 #ifdef USE_BEEPER
@@ -27,6 +27,7 @@
 #ifdef USE_DSHOT
 
 #include "build/debug.h"
+#include "build/trace.h"
 
 #include "drivers/io.h"
 #include "timer.h"
@@ -42,14 +43,133 @@
 #include "rcc.h"
 
 static uint8_t dmaMotorTimerCount = 0;
-static motorDmaTimer_t dmaMotorTimers[MAX_DMA_TIMERS];
-static motorDmaOutput_t dmaMotors[MAX_SUPPORTED_MOTORS];
+static DMA_RAM_ZERO_INIT motorDmaTimer_t dmaMotorTimers[MAX_DMA_TIMERS];
+static DMA_RAM_ZERO_INIT motorDmaOutput_t dmaMotors[MAX_SUPPORTED_MOTORS];
 
 motorDmaOutput_t *getMotorDmaOutput(uint8_t index)
 {
     return &dmaMotors[index];
 }
 
+#ifdef USE_DSHOT_TELEMETRY
+// the ESC reply is 21 GCR bits, sent at 5/4 of the DShot bit rate
+#define DSHOT_TELEMETRY_BITS         21
+// timer ticks per reply bit, times 5 to stay in integers, the timer runs at MOTOR_BITLENGTH ticks per DShot bit
+#define DSHOT_TELEMETRY_BIT_TICKS_X5 (MOTOR_BITLENGTH * 4)
+
+uint16_t getDshotTelemetry(uint8_t index)
+{
+    return dmaMotors[index].dshotTelemetryValue;
+}
+
+/*
+ * The capture holds the timer count at each edge of the reply, an edge marks a 1 bit and the bits after it
+ * up to the next edge are 0. The 20 bits after the start bit are 4 GCR quintets, decoding to a 12 bit
+ * e-period and a 4 bit checksum. Returns eRPM / 100, or DSHOT_TELEMETRY_INVALID.
+ */
+static uint16_t decodeDshotTelemetryPacket(const uint32_t *buffer, uint32_t count)
+{
+    if (count < 2) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+
+    uint32_t value = 0;
+    int bits = 0;
+    for (uint32_t i = 1; i <= count; i++) {
+        int len;
+        if (i < count) {
+            const uint16_t diff = buffer[i] - buffer[i - 1];
+            len = (diff * 5 + DSHOT_TELEMETRY_BIT_TICKS_X5 / 2) / DSHOT_TELEMETRY_BIT_TICKS_X5;
+        } else {
+            // the bits after the last edge run to the end of the reply
+            len = DSHOT_TELEMETRY_BITS - bits;
+        }
+        if (len < 1 || bits + len > DSHOT_TELEMETRY_BITS) {
+            return DSHOT_TELEMETRY_INVALID;
+        }
+        value <<= len;
+        value |= 1 << (len - 1);
+        bits += len;
+    }
+
+    static const uint8_t gcrDecode[32] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 10, 11, 0, 13, 14, 15,
+        0, 0, 2, 3, 0, 5, 6, 7, 0, 0, 8, 1, 0, 4, 12, 0
+    };
+
+    uint32_t decodedValue = gcrDecode[value & 0x1f];
+    decodedValue |= gcrDecode[(value >> 5) & 0x1f] << 4;
+    decodedValue |= gcrDecode[(value >> 10) & 0x1f] << 8;
+    decodedValue |= gcrDecode[(value >> 15) & 0x1f] << 12;
+
+    uint32_t csum = decodedValue;
+    csum = csum ^ (csum >> 8); // xor bytes
+    csum = csum ^ (csum >> 4); // xor nibbles
+    if ((csum & 0xf) != 0xf) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+    decodedValue >>= 4;
+
+    // the largest period means the motor is stopped
+    if (decodedValue == 0x0fff) {
+        return 0;
+    }
+
+    // 9 bit mantissa shifted by a 3 bit exponent gives the e-period in microseconds
+    const uint32_t periodUs = (decodedValue & 0x01ff) << ((decodedValue & 0x0e00) >> 9);
+    if (!periodUs) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+
+    return (1000000 * 60 / 100 + periodUs / 2) / periodUs;
+}
+
+static void pwmDshotSetDirectionOutput(motorDmaOutput_t * const motor, bool output)
+{
+    const timerHardware_t * const timerHardware = motor->timerHardware;
+    TIM_TypeDef *timer = timerHardware->tim;
+    DMA_Stream_TypeDef *dmaRef = timerHardware->dmaRef;
+
+    DMA_Cmd(dmaRef, DISABLE);
+    TIM_DMACmd(timer, motor->timerDmaSource, DISABLE);
+    DMA_DeInit(dmaRef);
+
+    motor->isInput = !output;
+    if (output) {
+        timer->ARR = motor->timer->outputPeriod;
+        timerOCInit(timer, timerHardware->channel, &motor->ocInitStruct);
+        timerOCPreloadConfig(timer, timerHardware->channel, TIM_OCPreload_Enable);
+        motor->dmaInitStruct.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+        motor->dmaInitStruct.DMA_Memory0BaseAddr = (uint32_t)motor->dmaBuffer;
+        motor->dmaInitStruct.DMA_BufferSize = DSHOT_DMA_BUFFER_SIZE;
+    } else {
+        // let the counter run free, so the edges of the reply can be timed
+        timer->ARR = 0xffff;
+        TIM_ICInit(timer, &motor->icInitStruct);
+        motor->dmaInitStruct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+        motor->dmaInitStruct.DMA_Memory0BaseAddr = (uint32_t)motor->dmaInputBuffer;
+        motor->dmaInitStruct.DMA_BufferSize = DSHOT_TELEMETRY_INPUT_LEN;
+    }
+
+    DMA_Init(dmaRef, &motor->dmaInitStruct);
+    DMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
+}
+
+// Decodes the reply captured since the last frame, and turns the channel back to output for the next one
+static void pwmDshotReadTelemetry(motorDmaOutput_t * const motor)
+{
+    const uint32_t count = DSHOT_TELEMETRY_INPUT_LEN - DMA_GetCurrDataCounter(motor->timerHardware->dmaRef);
+    pwmDshotSetDirectionOutput(motor, true);
+
+    const uint16_t value = decodeDshotTelemetryPacket(motor->dmaInputBuffer, count);
+    if (value != DSHOT_TELEMETRY_INVALID) {
+        motor->dshotTelemetryValue = value;
+    } else {
+        motor->dshotTelemetryInvalidCount++;
+    }
+}
+#endif
+
 uint8_t getTimerIndex(TIM_TypeDef *timer)
 {
     for (int i = 0; i < dmaMotorTimerCount; i++) {
@@ -69,6 +189,12 @@ void pwmWriteDshotInt(uint8_t index, uint16_t value)
         return;
     }
 
+#ifdef USE_DSHOT_TELEMETRY
+    if (motor->isInput) {
+        pwmDshotReadTelemetry(motor);
+    }
+#endif
+
     /*If there is a command ready to go overwrite the value and send that instead*/
     if (pwmDshotCommandIsProcessing()) {
         value = pwmGetDshotCommand(index);
@@ -79,17 +205,16 @@ void pwmWriteDshotInt(uint8_t index, uint16_t value)
 
     motor->value = value;
 
-    uint16_t packet = prepareDshotPacket(motor);
     uint8_t bufferSize;
 
 #ifdef USE_DSHOT_DMAR
     if (useBurstDshot) {
-        bufferSize = loadDmaBuffer(&motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)], 4, packet);
+        bufferSize = pwmDshotLoadDmaBuffer(motor, &motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)], 4);
         motor->timer->dmaBurstLength = bufferSize * 4;
     } else
 #endif
     {
-        bufferSize = loadDmaBuffer(motor->dmaBuffer, 1, packet);
+        bufferSize = pwmDshotLoadDmaBuffer(motor, motor->dmaBuffer, 1);
         motor->timer->timerDmaSources |= motor->timerDmaSource;
         DMA_SetCurrDataCounter(motor->timerHardware->dmaRef, bufferSize);
         DMA_Cmd(motor->timerHardware->dmaRef, ENABLE);
@@ -108,6 +233,7 @@ void pwmCompleteDshotMotorUpdate(uint8_t motorCount)
     }
 
     for (int i = 0; i < dmaMotorTimerCount; i++) {
+        TRACE_EVENT(TRACE_DMA_START, TRACE_ISR_MOTOR_DMA, i);
 #ifdef USE_DSHOT_DMAR
         if (useBurstDshot) {
             DMA_SetCurrDataCounter(dmaMotorTimers[i].dmaBurstRef, dmaMotorTimers[i].dmaBurstLength);
@@ -126,6 +252,7 @@ void pwmCompleteDshotMotorUpdate(uint8_t motorCount)
 
 static void motor_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor)
 {
+    TRACE_EVENT(TRACE_ISR_ENTER, TRACE_ISR_MOTOR_DMA, descriptor->userParam);
     if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
         motorDmaOutput_t * const motor = &dmaMotors[descriptor->userParam];
 
@@ -140,8 +267,21 @@ static void motor_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor)
             TIM_DMACmd(motor->timerHardware->tim, motor->timerDmaSource, DISABLE);
         }
 
+#ifdef USE_DSHOT_TELEMETRY
+        // the frame is out, capture the reply until the next frame is written. A full input buffer is noise,
+        // and is left for pwmDshotReadTelemetry() to reject
+        if (motor->useTelemetry && !motor->isInput) {
+            pwmDshotSetDirectionOutput(motor, false);
+            DMA_SetCurrDataCounter(motor->timerHardware->dmaRef, DSHOT_TELEMETRY_INPUT_LEN);
+            DMA_Cmd(motor->timerHardware->dmaRef, ENABLE);
+            TIM_DMACmd(motor->timerHardware->tim, motor->timerDmaSource, ENABLE);
+        }
+#endif
+
         DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+        TRACE_EVENT(TRACE_DMA_COMPLETE, TRACE_ISR_MOTOR_DMA, descriptor->userParam);
     }
+    TRACE_EVENT(TRACE_ISR_EXIT, TRACE_ISR_MOTOR_DMA, descriptor->userParam);
 }
 
 void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t motorIndex, motorPwmProtocolTypes_e pwmProtocolType, uint8_t output)
@@ -216,6 +356,20 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
     timerOCInit(timer, timerHardware->channel, &TIM_OCInitStructure);
     timerOCPreloadConfig(timer, timerHardware->channel, TIM_OCPreload_Enable);
 
+#ifdef USE_DSHOT_TELEMETRY
+    // complementary outputs cannot capture, so those motors are left output only
+    motor->useTelemetry = useDshotTelemetry && !(output & TIMER_OUTPUT_N_CHANNEL);
+    motor->isInput = false;
+    motor->ocInitStruct = TIM_OCInitStructure;
+
+    TIM_ICStructInit(&motor->icInitStruct);
+    motor->icInitStruct.TIM_Channel = timerHardware->channel;
+    motor->icInitStruct.TIM_ICPolarity = TIM_ICPolarity_BothEdge;
+    motor->icInitStruct.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    motor->icInitStruct.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    motor->icInitStruct.TIM_ICFilter = 2;
+#endif
+
     if (output & TIMER_OUTPUT_N_CHANNEL) {
         TIM_CCxNCmd(timer, timerHardware->channel, TIM_CCxN_Enable);
     } else {
@@ -229,6 +383,9 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
     }
 
     motor->timer = &dmaMotorTimers[timerIndex];
+#ifdef USE_DSHOT_TELEMETRY
+    motor->timer->outputPeriod = pwmProtocolType == PWM_TYPE_PROSHOT1000 ? MOTOR_NIBBLE_LENGTH_PROSHOT : MOTOR_BITLENGTH;
+#endif
 
 #ifdef USE_DSHOT_DMAR
     if (useBurstDshot) {
@@ -307,6 +464,9 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
 
     DMA_Init(dmaRef, &DMA_InitStructure);
     DMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
+#ifdef USE_DSHOT_TELEMETRY
+    motor->dmaInitStruct = DMA_InitStructure;
+#endif
 
     motor->configured = true;
 }
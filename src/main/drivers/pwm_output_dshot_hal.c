@@ -26,6 +26,8 @@
 
 #ifdef USE_DSHOT
 
+#include "build/trace.h"
+
 #include "drivers/io.h"
 #include "timer.h"
 #include "pwm_output.h"
@@ -35,8 +37,8 @@
 #include "rcc.h"
 
 static FAST_RAM_ZERO_INIT uint8_t dmaMotorTimerCount = 0;
-static FAST_RAM_ZERO_INIT motorDmaTimer_t dmaMotorTimers[MAX_DMA_TIMERS];
-static FAST_RAM_ZERO_INIT motorDmaOutput_t dmaMotors[MAX_SUPPORTED_MOTORS];
+static DMA_RAM_ZERO_INIT motorDmaTimer_t dmaMotorTimers[MAX_DMA_TIMERS];
+static DMA_RAM_ZERO_INIT motorDmaOutput_t dmaMotors[MAX_SUPPORTED_MOTORS];
 
 motorDmaOutput_t *getMotorDmaOutput(uint8_t index)
 {
@@ -72,17 +74,16 @@ FAST_CODE void pwmWriteDshotInt(uint8_t index, uint16_t value)
 
     motor->value = value;
 
-    uint16_t packet = prepareDshotPacket(motor);
     uint8_t bufferSize;
 
 #ifdef USE_DSHOT_DMAR
     if (useBurstDshot) {
-        bufferSize = loadDmaBuffer(&motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)], 4, packet);
+        bufferSize = pwmDshotLoadDmaBuffer(motor, &motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)], 4);
         motor->timer->dmaBurstLength = bufferSize * 4;
     } else
 #endif
     {    
-        bufferSize = loadDmaBuffer(motor->dmaBuffer, 1, packet);
+        bufferSize = pwmDshotLoadDmaBuffer(motor, motor->dmaBuffer, 1);
         motor->timer->timerDmaSources |= motor->timerDmaSource;
         LL_EX_DMA_SetDataLength(motor->timerHardware->dmaRef, bufferSize);
         LL_EX_DMA_EnableStream(motor->timerHardware->dmaRef);
@@ -101,6 +102,7 @@ FAST_CODE void pwmCompleteDshotMotorUpdate(uint8_t motorCount)
     }
 
     for (int i = 0; i < dmaMotorTimerCount; i++) {
+        TRACE_EVENT(TRACE_DMA_START, TRACE_ISR_MOTOR_DMA, i);
 #ifdef USE_DSHOT_DMAR
         if (useBurstDshot) {
             LL_EX_DMA_SetDataLength(dmaMotorTimers[i].dmaBurstRef, dmaMotorTimers[i].dmaBurstLength);
@@ -124,6 +126,7 @@ FAST_CODE void pwmCompleteDshotMotorUpdate(uint8_t motorCount)
 
 static void motor_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor)
 {
+    TRACE_EVENT(TRACE_ISR_ENTER, TRACE_ISR_MOTOR_DMA, descriptor->userParam);
     if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
         motorDmaOutput_t * const motor = &dmaMotors[descriptor->userParam];
 
@@ -139,7 +142,9 @@ static void motor_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor)
         }
 
         DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+        TRACE_EVENT(TRACE_DMA_COMPLETE, TRACE_ISR_MOTOR_DMA, descriptor->userParam);
     }
+    TRACE_EVENT(TRACE_ISR_EXIT, TRACE_ISR_MOTOR_DMA, descriptor->userParam);
 }
 
 void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t motorIndex, motorPwmProtocolTypes_e pwmProtocolType, uint8_t output)
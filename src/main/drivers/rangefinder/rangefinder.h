@@ -21,11 +21,11 @@
 #pragma once
 
 #include "common/time.h"
+#include "common/topic.h"
 #include "drivers/io_types.h"
 
 #define RANGEFINDER_OUT_OF_RANGE        (-1)
 #define RANGEFINDER_HARDWARE_FAILURE    (-2)
-#define RANGEFINDER_NO_NEW_DATA         (-3)
 
 typedef struct rangefinderHardwarePins_s {
     ioTag_t triggerTag;
@@ -35,7 +35,6 @@ typedef struct rangefinderHardwarePins_s {
 struct rangefinderDev_s;
 typedef void (*rangefinderOpInitFuncPtr)(struct rangefinderDev_s * dev);
 typedef void (*rangefinderOpStartFuncPtr)(struct rangefinderDev_s * dev);
-typedef int32_t (*rangefinderOpReadFuncPtr)(struct rangefinderDev_s * dev);
 
 typedef struct rangefinderDev_s {
     timeMs_t delayMs;
@@ -48,9 +47,15 @@ typedef struct rangefinderDev_s {
     // function pointers
     rangefinderOpInitFuncPtr init;
     rangefinderOpStartFuncPtr update;
-    rangefinderOpReadFuncPtr read;
 } rangefinderDev_t;
 
+// Published by the detected driver as each measurement completes, from interrupt context for the HC-SR04
+typedef struct rangefinderReading_s {
+    int32_t distanceCm;         // or RANGEFINDER_OUT_OF_RANGE, RANGEFINDER_HARDWARE_FAILURE
+} rangefinderReading_t;
+
+TOPIC_DECLARE(rangefinderReading, rangefinderReading_t);
+
 extern int16_t rangefinderMaxRangeCm;
 extern int16_t rangefinderMaxAltWithTiltCm;
 extern int16_t rangefinderCfAltCm;
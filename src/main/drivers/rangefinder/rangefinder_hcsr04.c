@@ -34,7 +34,9 @@
 #include "drivers/exti.h"
 #include "drivers/io.h"
 #include "drivers/nvic.h"
+#include "drivers/pwm_output.h"
 #include "drivers/rcc.h"
+#include "drivers/timer.h"
 
 #include "drivers/rangefinder/rangefinder.h"
 #include "drivers/rangefinder/rangefinder_hcsr04.h"
@@ -42,6 +44,7 @@
 #define HCSR04_MAX_RANGE_CM 400 // 4m, from HC-SR04 spec sheet
 #define HCSR04_DETECTION_CONE_DECIDEGREES 300 // recommended cone angle30 degrees, from HC-SR04 spec sheet
 #define HCSR04_DETECTION_CONE_EXTENDED_DECIDEGREES 450 // in practice 45 degrees seems to work well
+#define HCSR04_TIMER_PERIOD 0x10000
 
 
 /* HC-SR04 consists of ultrasonic transmitter, receiver, and control circuits.
@@ -53,19 +56,51 @@
  *
  */
 
-static volatile timeDelta_t hcsr04SonarPulseTravelTime = 0;
-static volatile timeMs_t lastMeasurementReceivedAt;
-static volatile int32_t lastCalculatedDistance = RANGEFINDER_OUT_OF_RANGE;
 static timeMs_t lastMeasurementStartedAt = 0;
 
 #ifdef USE_EXTI
 static extiCallbackRec_t hcsr04_extiCallbackRec;
 #endif
 
+static const timerHardware_t *echoTimer;
+static timerCCHandlerRec_t hcsr04_edgeCallbackRec;
+
 static IO_t echoIO;
 static IO_t triggerIO;
 
 #if !defined(UNIT_TEST)
+// Called from the echo interrupt once the falling edge ends the pulse
+static void hcsr04_echoReceived(timeDelta_t pulseTravelTimeUs)
+{
+    // The speed of sound is 340 m/s or approx. 29 microseconds per centimeter.
+    // The ping travels out and back, so to find the distance of the
+    // object we take half of the distance traveled.
+    // 340 m/s = 0.034 cm/microsecond = 29.41176471 *2 = 58.82352941 rounded to 59
+    rangefinderReading_t reading = { .distanceCm = pulseTravelTimeUs / 59 };
+    if (reading.distanceCm > HCSR04_MAX_RANGE_CM) {
+        reading.distanceCm = RANGEFINDER_OUT_OF_RANGE;
+    }
+
+    rangefinderReadingPublish(&reading, micros());
+}
+
+// The timer latches both edges of the echo, the pulse is timed without the latency of the interrupt
+static void hcsr04_edgeHandler(timerCCHandlerRec_t *cb, captureCompare_t capture)
+{
+    static captureCompare_t risingCapture;
+    static bool awaitingFallingEdge = false;
+    UNUSED(cb);
+
+    if (!awaitingFallingEdge) {
+        risingCapture = capture;
+    } else {
+        // a 16 bit period at 1MHz is longer than the 38ms no echo pulse
+        hcsr04_echoReceived((captureCompare_t)(capture - risingCapture));
+    }
+    awaitingFallingEdge = !awaitingFallingEdge;
+    timerChICPolarity(echoTimer, !awaitingFallingEdge);
+}
+
 void hcsr04_extiHandler(extiCallbackRec_t* cb)
 {
     static timeUs_t timing_start;
@@ -74,10 +109,9 @@ void hcsr04_extiHandler(extiCallbackRec_t* cb)
     if (IORead(echoIO) != 0) {
         timing_start = micros();
     } else {
-        const timeUs_t timing_stop = micros();
-        if (timing_stop > timing_start) {
-            lastMeasurementReceivedAt = millis();
-            hcsr04SonarPulseTravelTime = timing_stop - timing_start;
+        const timeDelta_t pulseTravelTimeUs = cmpTimeUs(micros(), timing_start);
+        if (pulseTravelTimeUs > 0) {
+            hcsr04_echoReceived(pulseTravelTimeUs);
         }
     }
 }
@@ -118,37 +152,44 @@ void hcsr04_update(rangefinderDev_t *dev)
     // the firing interval of the trigger signal should be greater than 60ms
     // to avoid interference between consecutive measurements
     if (timeNowMs > lastMeasurementStartedAt + HCSR04_MinimumFiringIntervalMs) {
-        // We should have a valid measurement within 60ms of trigger
-        if ((lastMeasurementReceivedAt - lastMeasurementStartedAt) <= HCSR04_MinimumFiringIntervalMs) {
-            // The speed of sound is 340 m/s or approx. 29 microseconds per centimeter.
-            // The ping travels out and back, so to find the distance of the
-            // object we take half of the distance traveled.
-            // 340 m/s = 0.034 cm/microsecond = 29.41176471 *2 = 58.82352941 rounded to 59
-
-            lastCalculatedDistance = hcsr04SonarPulseTravelTime / 59;
-            if (lastCalculatedDistance > HCSR04_MAX_RANGE_CM) {
-                lastCalculatedDistance = RANGEFINDER_OUT_OF_RANGE;
-            }
-        }
-        else {
-            // No measurement within reasonable time - indicate failure
-            lastCalculatedDistance = RANGEFINDER_HARDWARE_FAILURE;
-        }
-
-        // Trigger a new measurement
+        // the echo interrupt publishes the measurement, a missing echo leaves the reading to time out
         lastMeasurementStartedAt = timeNowMs;
         hcsr04_start_reading();
     }
 }
 
-/**
- * Get the distance that was measured by the last pulse, in centimeters.
- */
-int32_t hcsr04_get_distance(rangefinderDev_t *dev)
+#if !defined(UNIT_TEST)
+// Times the echo with input capture if the echo pin has a timer that no motor runs on
+static bool hcsr04ConfigCapture(ioTag_t echoTag)
 {
-    UNUSED(dev);
-    return lastCalculatedDistance;
+    const timerHardware_t *timer = timerGetByTag(echoTag);
+    if (!timer) {
+        return false;
+    }
+
+    // the capture needs a 1MHz timer, the motors set their own rate
+    pwmOutputPort_t *motors = pwmGetMotors();
+    for (int motorIndex = 0; motorIndex < MAX_SUPPORTED_MOTORS; motorIndex++) {
+        if (motors[motorIndex].enabled && motors[motorIndex].channel.tim == timer->tim) {
+            return false;
+        }
+    }
+
+    echoTimer = timer;
+#ifdef STM32F1
+    IOConfigGPIO(echoIO, IOCFG_IPD);
+#else
+    IOConfigGPIOAF(echoIO, IOCFG_AF_PP, timer->alternateFunction);
+#endif
+
+    timerConfigure(timer, (uint16_t)HCSR04_TIMER_PERIOD, PWM_TIMER_1MHZ);
+    timerChCCHandlerInit(&hcsr04_edgeCallbackRec, hcsr04_edgeHandler);
+    timerChConfigCallbacks(timer, &hcsr04_edgeCallbackRec, NULL);
+    timerChConfigIC(timer, true, 0);
+
+    return true;
 }
+#endif
 
 bool hcsr04Detect(rangefinderDev_t *dev, const sonarConfig_t * rangefinderHardwarePins)
 {
@@ -201,11 +242,16 @@ bool hcsr04Detect(rangefinderDev_t *dev, const sonarConfig_t * rangefinderHardwa
 
     if (detected) {
         // Hardware detected - configure the driver
+#if !defined(UNIT_TEST)
+        if (!hcsr04ConfigCapture(rangefinderHardwarePins->echoTag))
+#endif
+        {
 #ifdef USE_EXTI
-        EXTIHandlerInit(&hcsr04_extiCallbackRec, hcsr04_extiHandler);
-        EXTIConfig(echoIO, &hcsr04_extiCallbackRec, NVIC_PRIO_SONAR_EXTI, EXTI_Trigger_Rising_Falling); // TODO - priority!
-        EXTIEnable(echoIO, true);
+            EXTIHandlerInit(&hcsr04_extiCallbackRec, hcsr04_extiHandler);
+            EXTIConfig(echoIO, &hcsr04_extiCallbackRec, NVIC_PRIO_SONAR_EXTI, EXTI_Trigger_Rising_Falling); // TODO - priority!
+            EXTIEnable(echoIO, true);
 #endif
+        }
 
         dev->delayMs = 100;
         dev->maxRangeCm = HCSR04_MAX_RANGE_CM;
@@ -214,7 +260,6 @@ bool hcsr04Detect(rangefinderDev_t *dev, const sonarConfig_t * rangefinderHardwa
 
         dev->init = &hcsr04_init;
         dev->update = &hcsr04_update;
-        dev->read = &hcsr04_get_distance;
 
         return true;
     }
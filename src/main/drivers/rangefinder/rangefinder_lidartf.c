@@ -20,6 +20,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -28,6 +29,8 @@
 #include "build/debug.h"
 #include "build/build_config.h"
 
+#include "common/maths.h"
+
 #include "io/serial.h"
 
 #include "drivers/time.h"
@@ -97,11 +100,10 @@ typedef enum {
     TF_FRAME_STATE_WAIT_START1,
     TF_FRAME_STATE_WAIT_START2,
     TF_FRAME_STATE_READING_PAYLOAD,
-    TF_FRAME_STATE_WAIT_CKSUM,
 } tfFrameState_e;
 
 static tfFrameState_e tfFrameState;
-static uint8_t tfFrame[TF_FRAME_LENGTH];
+static uint8_t tfFrame[TF_FRAME_LENGTH + 1];   // with the checksum
 static uint8_t tfReceivePosition;
 
 // TFmini
@@ -113,7 +115,6 @@ static uint8_t tfCmdTFmini[] = { 0x42, 0x57, 0x02, 0x00, 0x00, 0x00, 0x01, 0x06
 // Same as TFmini for now..
 static uint8_t tfCmdTF02[] = { 0x42, 0x57, 0x02, 0x00, 0x00, 0x00, 0x01, 0x06 };
 
-static int32_t lidarTFValue;
 static uint16_t lidarTFerrors = 0;
 
 static void lidarTFSendCommand(void)
@@ -136,27 +137,73 @@ void lidarTFInit(rangefinderDev_t *dev)
     tfReceivePosition = 0;
 }
 
-void lidarTFUpdate(rangefinderDev_t *dev)
+static timeMs_t lastFrameReceivedMs = 0;
+
+static void lidarTFFrameReceived(void)
 {
-    UNUSED(dev);
-    static timeMs_t lastFrameReceivedMs = 0;
-    const timeMs_t timeNowMs = millis();
+    uint8_t cksum = TF_FRAME_SYNC_BYTE + TF_FRAME_SYNC_BYTE;
+    for (int i = 0 ; i < TF_FRAME_LENGTH ; i++) {
+        cksum += tfFrame[i];
+    }
 
-    if (tfSerialPort == NULL) {
+    if (tfFrame[TF_FRAME_LENGTH] != cksum) {
+        // Checksum error. Simply discard the current frame.
+        ++lidarTFerrors;
+        //DEBUG_SET(DEBUG_LIDAR_TF, 3, lidarTFerrors);
         return;
     }
 
-    while (serialRxBytesWaiting(tfSerialPort)) {
-        uint8_t c = serialRead(tfSerialPort);
+    uint16_t distance = tfFrame[0] | (tfFrame[1] << 8);
+    uint16_t strength = tfFrame[2] | (tfFrame[3] << 8);
+
+    DEBUG_SET(DEBUG_LIDAR_TF, 0, distance);
+    DEBUG_SET(DEBUG_LIDAR_TF, 1, strength);
+    DEBUG_SET(DEBUG_LIDAR_TF, 2, tfFrame[4]);
+    DEBUG_SET(DEBUG_LIDAR_TF, 3, tfFrame[5]);
+
+    rangefinderReading_t reading = { .distanceCm = RANGEFINDER_OUT_OF_RANGE };
+    switch (tfDevtype) {
+    case TF_DEVTYPE_MINI:
+        if (distance >= TF_MINI_RANGE_MIN && distance < TF_MINI_RANGE_MAX) {
+            reading.distanceCm = distance;
+            if (tfFrame[TF_MINI_FRAME_INTEGRAL_TIME] == 7) {
+                // When integral time is long (7), measured distance tends to be longer by 12~13.
+                reading.distanceCm -= 13;
+            }
+        }
+        break;
+
+    case TF_DEVTYPE_02:
+        if (distance >= TF_02_RANGE_MIN && distance < TF_02_RANGE_MAX && tfFrame[TF_02_FRAME_SIG] >= 7) {
+            reading.distanceCm = distance;
+        }
+        break;
+    }
+
+    lastFrameReceivedMs = millis();
+    rangefinderReadingPublish(&reading, micros());
+}
+
+// Parses a run of received bytes, a frame may be split across runs
+static void lidarTFParse(const uint8_t *data, uint32_t count)
+{
+    const uint8_t *end = data + count;
+
+    while (data < end) {
         switch (tfFrameState) {
         case TF_FRAME_STATE_WAIT_START1:
-            if (c == TF_FRAME_SYNC_BYTE) {
+            {
+                const uint8_t *sync = memchr(data, TF_FRAME_SYNC_BYTE, end - data);
+                if (!sync) {
+                    return;
+                }
+                data = sync + 1;
                 tfFrameState = TF_FRAME_STATE_WAIT_START2;
             }
             break;
 
         case TF_FRAME_STATE_WAIT_START2:
-            if (c == TF_FRAME_SYNC_BYTE) {
+            if (*data++ == TF_FRAME_SYNC_BYTE) {
                 tfFrameState = TF_FRAME_STATE_READING_PAYLOAD;
             } else {
                 tfFrameState = TF_FRAME_STATE_WAIT_START1;
@@ -164,79 +211,48 @@ void lidarTFUpdate(rangefinderDev_t *dev)
             break;
 
         case TF_FRAME_STATE_READING_PAYLOAD:
-            tfFrame[tfReceivePosition++] = c;
-            if (tfReceivePosition == TF_FRAME_LENGTH) {
-                tfFrameState = TF_FRAME_STATE_WAIT_CKSUM;
-            }
-            break;
-
-        case TF_FRAME_STATE_WAIT_CKSUM:
             {
-                uint8_t cksum = TF_FRAME_SYNC_BYTE + TF_FRAME_SYNC_BYTE;
-                for (int i = 0 ; i < TF_FRAME_LENGTH ; i++) {
-                    cksum += tfFrame[i];
-                }
-
-                if (c == cksum) {
-
-                    uint16_t distance = tfFrame[0] | (tfFrame[1] << 8);
-                    uint16_t strength = tfFrame[2] | (tfFrame[3] << 8);
-
-                    DEBUG_SET(DEBUG_LIDAR_TF, 0, distance);
-                    DEBUG_SET(DEBUG_LIDAR_TF, 1, strength);
-                    DEBUG_SET(DEBUG_LIDAR_TF, 2, tfFrame[4]);
-                    DEBUG_SET(DEBUG_LIDAR_TF, 3, tfFrame[5]);
-
-                    switch (tfDevtype) {
-                    case TF_DEVTYPE_MINI:
-                        if (distance >= TF_MINI_RANGE_MIN && distance < TF_MINI_RANGE_MAX) {
-                            lidarTFValue = distance;
-                            if (tfFrame[TF_MINI_FRAME_INTEGRAL_TIME] == 7) {
-                                // When integral time is long (7), measured distance tends to be longer by 12~13.
-                                lidarTFValue -= 13;
-                            }
-                        } else {
-                            lidarTFValue = -1;
-                        }
-                        break;
-
-                    case TF_DEVTYPE_02:
-                        if (distance >= TF_02_RANGE_MIN && distance < TF_02_RANGE_MAX && tfFrame[TF_02_FRAME_SIG] >= 7) {
-                            lidarTFValue = distance;
-                        } else {
-                            lidarTFValue = -1;
-                        }
-                        break;
-                    }
-                    lastFrameReceivedMs = timeNowMs;
-                } else {
-                    // Checksum error. Simply discard the current frame.
-                    ++lidarTFerrors;
-                    //DEBUG_SET(DEBUG_LIDAR_TF, 3, lidarTFerrors);
+                // the payload and the checksum
+                const uint32_t length = MIN((uint32_t)(end - data), (uint32_t)(TF_FRAME_LENGTH + 1 - tfReceivePosition));
+                memcpy(&tfFrame[tfReceivePosition], data, length);
+                data += length;
+                tfReceivePosition += length;
+                if (tfReceivePosition == TF_FRAME_LENGTH + 1) {
+                    lidarTFFrameReceived();
+                    tfFrameState = TF_FRAME_STATE_WAIT_START1;
+                    tfReceivePosition = 0;
                 }
             }
-
-            tfFrameState = TF_FRAME_STATE_WAIT_START1;
-            tfReceivePosition = 0;
-
             break;
         }
     }
+}
 
-    // If valid frame hasn't been received for more than a timeout, resend command.
+void lidarTFUpdate(rangefinderDev_t *dev)
+{
+    UNUSED(dev);
 
-    if (timeNowMs - lastFrameReceivedMs > TF_TIMEOUT_MS) {
-        lidarTFSendCommand();
+    if (tfSerialPort == NULL) {
+        return;
     }
-}
 
-// Return most recent device output in cm
+    // parse in place when the driver exposes its receive ring, byte by byte otherwise
+    const uint8_t *data;
+    uint32_t available;
+    while ((available = serialPeekContiguous(tfSerialPort, &data)) > 0) {
+        lidarTFParse(data, available);
+        serialSkip(tfSerialPort, available);
+    }
+    while (serialRxBytesWaiting(tfSerialPort)) {
+        const uint8_t c = serialRead(tfSerialPort);
+        lidarTFParse(&c, 1);
+    }
 
-int32_t lidarTFGetDistance(rangefinderDev_t *dev)
-{
-    UNUSED(dev);
+    // If valid frame hasn't been received for more than a timeout, resend command.
 
-    return lidarTFValue;
+    if (millis() - lastFrameReceivedMs > TF_TIMEOUT_MS) {
+        lidarTFSendCommand();
+    }
 }
 
 static bool lidarTFDetect(rangefinderDev_t *dev, uint8_t devtype)
@@ -262,7 +278,6 @@ static bool lidarTFDetect(rangefinderDev_t *dev, uint8_t devtype)
 
     dev->init = &lidarTFInit;
     dev->update = &lidarTFUpdate;
-    dev->read = &lidarTFGetDistance;
 
     return true;
 }
@@ -76,6 +76,9 @@ typedef enum {
     OWNER_USB_MSC_PIN,
     OWNER_SPI_PREINIT_IPU,
     OWNER_SPI_PREINIT_OPU,
+    OWNER_GYRO_DMA,
+    OWNER_SPI_DMA,
+    OWNER_OSD_VSYNC,
     OWNER_TOTAL_COUNT
 } resourceOwner_e;
 
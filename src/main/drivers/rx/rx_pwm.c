@@ -30,6 +30,7 @@
 
 #include "common/utils.h"
 
+#include "drivers/dma.h"
 #include "drivers/io.h"
 #include "drivers/nvic.h"
 #include "drivers/pwm_output.h"
@@ -106,6 +107,18 @@ typedef struct ppmDevice_s {
 
 static ppmDevice_t ppmDev;
 
+#ifdef USE_PPM_CAPTURE_DMA
+// The timer captures the rising edges into the ring by DMA, and the RX task decodes them as the interrupts would have
+#define PPM_CAPTURE_RING_SIZE 64
+
+static volatile uint16_t ppmCaptureRing[PPM_CAPTURE_RING_SIZE];
+static const timerHardware_t *ppmCaptureTimer;
+static uint8_t ppmCaptureReadIndex;
+static uint16_t ppmCaptureLast;
+
+static void ppmCaptureDmaProcess(void);
+#endif
+
 #define PPM_IN_MIN_SYNC_PULSE_US    2700    // microseconds
 #define PPM_IN_MIN_CHANNEL_PULSE_US 750     // microseconds
 #define PPM_IN_MAX_CHANNEL_PULSE_US 2250    // microseconds
@@ -115,6 +128,11 @@ static ppmDevice_t ppmDev;
 
 bool isPPMDataBeingReceived(void)
 {
+#ifdef USE_PPM_CAPTURE_DMA
+    if (ppmCaptureTimer) {
+        ppmCaptureDmaProcess();
+    }
+#endif
     return (ppmFrameCount != lastPPMFrameCount);
 }
 
@@ -164,6 +182,8 @@ static void ppmResetDevice(void)
     ppmDev.overflowed   = false;
 }
 
+static void ppmProcessPulse(uint32_t deltaTime);
+
 static void ppmOverflowCallback(timerOvrHandlerRec_t* cbRec, captureCompare_t capture)
 {
     UNUSED(cbRec);
@@ -180,8 +200,6 @@ static void ppmEdgeCallback(timerCCHandlerRec_t* cbRec, captureCompare_t capture
     UNUSED(cbRec);
     ppmISREvent(SOURCE_EDGE, capture);
 
-    int32_t i;
-
     uint32_t previousTime = ppmDev.currentTime;
     uint32_t previousCapture = ppmDev.currentCapture;
 
@@ -214,8 +232,67 @@ static void ppmEdgeCallback(timerCCHandlerRec_t* cbRec, captureCompare_t capture
     ppmDev.currentTime = currentTime;
     ppmDev.currentCapture = capture;
 
+    ppmProcessPulse(ppmDev.deltaTime);
+}
+
+#ifdef USE_PPM_CAPTURE_DMA
+// The timer runs free over 16 bits at 1MHz, so the difference of two captures less than 65ms apart is the pulse width
+static void ppmCaptureDmaProcess(void)
+{
+    const uint8_t writeIndex = (PPM_CAPTURE_RING_SIZE - DMA_GetCurrDataCounter(ppmCaptureTimer->dmaRef)) % PPM_CAPTURE_RING_SIZE;
+
+    while (ppmCaptureReadIndex != writeIndex) {
+        const uint16_t capture = ppmCaptureRing[ppmCaptureReadIndex];
+        ppmCaptureReadIndex = (ppmCaptureReadIndex + 1) % PPM_CAPTURE_RING_SIZE;
+
+        ppmDev.deltaTime = (uint16_t)(capture - ppmCaptureLast);
+        ppmCaptureLast = capture;
+        ppmProcessPulse(ppmDev.deltaTime);
+    }
+}
+
+static bool ppmCaptureDmaInit(const timerHardware_t *timer)
+{
+    // a timer shared with the motors does not run over the full 16 bits
+    if (!timer->dmaRef || ppmCountDivisor != 1) {
+        return false;
+    }
+
+    if (!dmaAllocate(dmaGetIdentifier(timer->dmaRef), OWNER_PPMINPUT, 0)) {
+        return false;
+    }
+
+    DMA_InitTypeDef DMA_InitStructure;
+    DMA_StructInit(&DMA_InitStructure);
+    DMA_DeInit(timer->dmaRef);
+
+    DMA_InitStructure.DMA_Channel = timer->dmaChannel;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)timerChCCR(timer);
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)ppmCaptureRing;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStructure.DMA_BufferSize = PPM_CAPTURE_RING_SIZE;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+
+    DMA_Init(timer->dmaRef, &DMA_InitStructure);
+    DMA_Cmd(timer->dmaRef, ENABLE);
+    TIM_DMACmd(timer->tim, timerDmaSource(timer->channel), ENABLE);
+
+    ppmCaptureTimer = timer;
+    return true;
+}
+#endif
+
+static void ppmProcessPulse(uint32_t deltaTime)
+{
+    int32_t i;
+
     /* Sync pulse detection */
-    if (ppmDev.deltaTime > PPM_IN_MIN_SYNC_PULSE_US) {
+    if (deltaTime > PPM_IN_MIN_SYNC_PULSE_US) {
         if (ppmDev.pulseIndex == ppmDev.numChannelsPrevFrame
             && ppmDev.pulseIndex >= PPM_IN_MIN_NUM_CHANNELS
             && ppmDev.pulseIndex <= PPM_IN_MAX_NUM_CHANNELS) {
@@ -250,10 +327,10 @@ static void ppmEdgeCallback(timerCCHandlerRec_t* cbRec, captureCompare_t capture
            if no valid frame is found otherwise we ride over it */
     } else if (ppmDev.tracking) {
         /* Valid pulse duration 0.75 to 2.5 ms*/
-        if (ppmDev.deltaTime > PPM_IN_MIN_CHANNEL_PULSE_US
-            && ppmDev.deltaTime < PPM_IN_MAX_CHANNEL_PULSE_US
+        if (deltaTime > PPM_IN_MIN_CHANNEL_PULSE_US
+            && deltaTime < PPM_IN_MAX_CHANNEL_PULSE_US
             && ppmDev.pulseIndex < PPM_IN_MAX_NUM_CHANNELS) {
-            ppmDev.captures[ppmDev.pulseIndex] = ppmDev.deltaTime;
+            ppmDev.captures[ppmDev.pulseIndex] = deltaTime;
             ppmDev.pulseIndex++;
         } else {
             /* Not a valid pulse duration */
@@ -446,15 +523,22 @@ void ppmRxInit(const ppmConfig_t *ppmConfig)
 #endif
 
     timerConfigure(timer, (uint16_t)PPM_TIMER_PERIOD, PWM_TIMER_1MHZ);
-    timerChCCHandlerInit(&port->edgeCb, ppmEdgeCallback);
-    timerChOvrHandlerInit(&port->overflowCb, ppmOverflowCallback);
-    timerChConfigCallbacks(timer, &port->edgeCb, &port->overflowCb);
 
 #if defined(USE_HAL_DRIVER)
     pwmICConfig(timer->tim, timer->channel, TIM_ICPOLARITY_RISING);
 #else
     pwmICConfig(timer->tim, timer->channel, TIM_ICPolarity_Rising);
 #endif
+
+#ifdef USE_PPM_CAPTURE_DMA
+    if (ppmCaptureDmaInit(timer)) {
+        return;
+    }
+#endif
+
+    timerChCCHandlerInit(&port->edgeCb, ppmEdgeCallback);
+    timerChOvrHandlerInit(&port->overflowCb, ppmOverflowCallback);
+    timerChConfigCallbacks(timer, &port->edgeCb, &port->overflowCb);
 }
 
 uint16_t ppmRead(uint8_t channel)
@@ -44,8 +44,8 @@
 static busDevice_t rxSpiDevice;
 static busDevice_t *busdev = &rxSpiDevice;
 
-#define DISABLE_RX()    {IOHi(busdev->busdev_u.spi.csnPin);}
-#define ENABLE_RX()     {IOLo(busdev->busdev_u.spi.csnPin);}
+#define DISABLE_RX()    {IOFastHi(&busdev->busdev_u.spi.csn);}
+#define ENABLE_RX()     {IOFastLo(&busdev->busdev_u.spi.csn);}
 
 bool rxSpiDeviceInit(const rxSpiConfig_t *rxSpiConfig)
 {
@@ -58,11 +58,11 @@ bool rxSpiDeviceInit(const rxSpiConfig_t *rxSpiConfig)
     const IO_t rxCsPin = IOGetByTag(rxSpiConfig->csnTag);
     IOInit(rxCsPin, OWNER_RX_SPI_CS, 0);
     IOConfigGPIO(rxCsPin, SPI_IO_CS_CFG);
-    busdev->busdev_u.spi.csnPin = rxCsPin;
+    spiBusSetCsPin(busdev, rxCsPin);
 
     DISABLE_RX();
 
-    spiSetDivisor(busdev->busdev_u.spi.instance, SPI_CLOCK_STANDARD);
+    spiBusSetDivisor(busdev, SPI_CLOCK_STANDARD);
 
     return true;
 }
@@ -432,6 +432,8 @@ static void sdcard_sendDataBlockBegin(const uint8_t *buffer, bool multiBlockWrit
         LL_DMA_DeInit(sdcard.dma->dma, sdcard.dma->stream);
         LL_DMA_Init(sdcard.dma->dma, sdcard.dma->stream, &init);
 
+        dmaCacheClean(buffer, SDCARD_BLOCK_SIZE);
+
         LL_DMA_EnableStream(sdcard.dma->dma, sdcard.dma->stream);
 
         LL_SPI_EnableDMAReq_TX(sdcard.instance);
@@ -569,6 +571,7 @@ void sdcard_init(const sdcardConfig_t *config)
     }
 
     sdcard.instance = spiInstanceByDevice(config->device);
+    spiRegisterDirectUser(sdcard.instance);
 
     sdcard.useDMAForTx = config->useDma;
     if (sdcard.useDMAForTx) {
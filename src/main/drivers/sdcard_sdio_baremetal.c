@@ -50,27 +50,35 @@
 #define SDCARD_TIMEOUT_INIT_MILLIS      200
 #define SDCARD_MAX_CONSECUTIVE_FAILURES 8
 
-// Use this to speed up writing to SDCARD... asyncfatfs has limited support for multiblock write
+/*
+ * asyncfatfs hands us one sector at a time, so consecutive sectors of a multi-block write are gathered here and sent
+ * to the card in a single multi-block DMA transfer. The blocks in the cache have already been reported written to the
+ * caller, so the cache must always be transmitted before the multi-block write ends.
+ */
 #define FATFS_BLOCK_CACHE_SIZE 16
-uint8_t writeCache[512 * FATFS_BLOCK_CACHE_SIZE] __attribute__ ((aligned (4)));
-uint32_t cacheCount = 0;
+static uint8_t writeCache[SDCARD_BLOCK_SIZE * FATFS_BLOCK_CACHE_SIZE] DMA_ALIGNED;
+static uint16_t cacheCount = 0;
+static uint32_t cacheStartBlock;
 
-void cache_write(uint8_t *buffer)
+static void cache_write(uint32_t blockIndex, uint8_t *buffer)
 {
-    if (cacheCount == sizeof(writeCache)) {
+    if (cacheCount == FATFS_BLOCK_CACHE_SIZE) {
         // Prevents overflow
         return;
     }
-    memcpy(&writeCache[cacheCount], buffer, 512);
-    cacheCount += 512;
+    if (cacheCount == 0) {
+        cacheStartBlock = blockIndex;
+    }
+    memcpy(&writeCache[cacheCount * SDCARD_BLOCK_SIZE], buffer, SDCARD_BLOCK_SIZE);
+    cacheCount++;
 }
 
-uint16_t cache_getCount(void)
+static uint16_t cache_getCount(void)
 {
-    return (cacheCount / 512);
+    return cacheCount;
 }
 
-void cache_reset(void)
+static void cache_reset(void)
 {
     cacheCount = 0;
 }
@@ -342,9 +350,6 @@ static bool sdcard_isReady()
 static sdcardOperationStatus_e sdcard_endWriteBlocks()
 {
     sdcard.multiWriteBlocksRemain = 0;
-    if (sdcard.useCache) {
-        cache_reset();
-    }
 
     // 8 dummy clocks to guarantee N_WR clocks between the last card response and this token
 
@@ -434,17 +439,12 @@ bool sdcard_poll(void)
 
                 sdcard.failureCount = 0; // Assume the card is good if it can complete a write
 
-                // Still more blocks left to write in a multi-block chain?
-                if (sdcard.multiWriteBlocksRemain > 1) {
-                    sdcard.multiWriteBlocksRemain--;
-                    sdcard.multiWriteNextBlock++;
-                    if (sdcard.useCache) {
-                        cache_reset();
-                    }
+                // The blocks that were gathered in the cache are now on the card
+                cache_reset();
+
+                // Still more blocks left to write in a multi-block chain? (The count was taken when each block was submitted)
+                if (sdcard.multiWriteBlocksRemain > 0) {
                     sdcard.state = SDCARD_STATE_WRITING_MULTIPLE_BLOCKS;
-                } else if (sdcard.multiWriteBlocksRemain == 1) {
-                    // This function changes the sd card state for us whether immediately succesful or delayed:
-                    sdcard_endWriteBlocks();
                 } else {
                     sdcard.state = SDCARD_STATE_READY;
                 }
@@ -525,6 +525,48 @@ bool sdcard_poll(void)
     return sdcard_isReady();
 }
 
+/**
+ * Send the blocks gathered in the write cache to the card in a single multi-block transfer. Their callers have already
+ * been told that their writes completed, so there's nobody to call back.
+ *
+ * Returns true if the transfer was started.
+ */
+static bool sdcard_flushWriteCache(void)
+{
+    sdcard.pendingOperation.buffer = writeCache;
+    sdcard.pendingOperation.blockIndex = cacheStartBlock;
+    sdcard.pendingOperation.callback = NULL;
+    sdcard.pendingOperation.callbackData = 0;
+    sdcard.state = SDCARD_STATE_SENDING_WRITE;
+
+    if (SD_WriteBlocks_DMA(cacheStartBlock, (uint32_t*) writeCache, SDCARD_BLOCK_SIZE, cache_getCount()) != SD_OK) {
+        cache_reset();
+        sdcard_reset();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * End the multi-block write in progress so that a different operation can begin. If the write cache still holds
+ * blocks they are sent to the card first, and the card stays busy until they're written.
+ *
+ * Returns:
+ *     SDCARD_OPERATION_SUCCESS     - The card is ready for a new operation
+ *     SDCARD_OPERATION_BUSY        - Try again later
+ */
+static sdcardOperationStatus_e sdcard_interruptWriteBlocks(void)
+{
+    if (cache_getCount() > 0) {
+        sdcard.multiWriteBlocksRemain = 0;
+        sdcard_flushWriteCache();
+        return SDCARD_OPERATION_BUSY;
+    }
+
+    return sdcard_endWriteBlocks() == SDCARD_OPERATION_SUCCESS ? SDCARD_OPERATION_SUCCESS : SDCARD_OPERATION_BUSY;
+}
+
 /**
  * Write the 512-byte block from the given buffer into the block with the given index.
  *
@@ -551,7 +593,7 @@ sdcardOperationStatus_e sdcard_writeBlock(uint32_t blockIndex, uint8_t *buffer,
         case SDCARD_STATE_WRITING_MULTIPLE_BLOCKS:
             // Do we need to cancel the previous multi-block write?
             if (blockIndex != sdcard.multiWriteNextBlock) {
-                if (sdcard_endWriteBlocks() == SDCARD_OPERATION_SUCCESS) {
+                if (sdcard_interruptWriteBlocks() == SDCARD_OPERATION_SUCCESS) {
                     // Now we've entered the ready state, we can try again
                     goto doMore;
                 } else {
@@ -560,6 +602,21 @@ sdcardOperationStatus_e sdcard_writeBlock(uint32_t blockIndex, uint8_t *buffer,
             }
 
             // We're continuing a multi-block write
+            sdcard.multiWriteBlocksRemain--;
+            sdcard.multiWriteNextBlock++;
+
+            if (sdcard.useCache) {
+                cache_write(blockIndex, buffer);
+
+                if (cache_getCount() == FATFS_BLOCK_CACHE_SIZE || sdcard.multiWriteBlocksRemain == 0) {
+                    if (!sdcard_flushWriteCache()) {
+                        return SDCARD_OPERATION_FAILURE;
+                    }
+                }
+
+                // The caller's buffer has been copied, so they can have it back straight away
+                return SDCARD_OPERATION_SUCCESS;
+            }
         break;
         case SDCARD_STATE_READY:
         break;
@@ -569,31 +626,12 @@ sdcardOperationStatus_e sdcard_writeBlock(uint32_t blockIndex, uint8_t *buffer,
 
     sdcard.pendingOperation.buffer = buffer;
     sdcard.pendingOperation.blockIndex = blockIndex;
-
-    uint16_t block_count = 1;
-    if ((cache_getCount() < FATFS_BLOCK_CACHE_SIZE) &&
-        (sdcard.multiWriteBlocksRemain != 0) && sdcard.useCache) {
-        cache_write(buffer);
-        if (cache_getCount() == FATFS_BLOCK_CACHE_SIZE || sdcard.multiWriteBlocksRemain == 1) {
-            //Relocate buffer
-            buffer = (uint8_t*)writeCache;
-            //Recalculate block index
-            blockIndex -= cache_getCount() - 1;
-            block_count = cache_getCount();
-        } else {
-            sdcard.multiWriteBlocksRemain--;
-            sdcard.multiWriteNextBlock++;
-            sdcard.state = SDCARD_STATE_READY;
-            return SDCARD_OPERATION_SUCCESS;
-        }
-    }
-
     sdcard.pendingOperation.callback = callback;
     sdcard.pendingOperation.callbackData = callbackData;
     sdcard.pendingOperation.chunkIndex = 1; // (for non-DMA transfers) we've sent chunk #0 already
     sdcard.state = SDCARD_STATE_SENDING_WRITE;
 
-    if (SD_WriteBlocks_DMA(blockIndex, (uint32_t*) buffer, 512, block_count) != SD_OK) {
+    if (SD_WriteBlocks_DMA(blockIndex, (uint32_t*) buffer, SDCARD_BLOCK_SIZE, 1) != SD_OK) {
         /* Our write was rejected! This could be due to a bad address but we hope not to attempt that, so assume
          * the card is broken and needs reset.
          */
@@ -629,7 +667,7 @@ sdcardOperationStatus_e sdcard_beginWriteBlocks(uint32_t blockIndex, uint32_t bl
             if (blockIndex == sdcard.multiWriteNextBlock) {
                 // Assume that the caller wants to continue the multi-block write they already have in progress!
                 return SDCARD_OPERATION_SUCCESS;
-            } else if (sdcard_endWriteBlocks() != SDCARD_OPERATION_SUCCESS) {
+            } else if (sdcard_interruptWriteBlocks() != SDCARD_OPERATION_SUCCESS) {
                 return SDCARD_OPERATION_BUSY;
             } // Else we've completed the previous multi-block write and can fall through to start the new one
         } else {
@@ -659,7 +697,7 @@ bool sdcard_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_operationComp
 {
     if (sdcard.state != SDCARD_STATE_READY) {
 		if (sdcard.state == SDCARD_STATE_WRITING_MULTIPLE_BLOCKS) {
-			if (sdcard_endWriteBlocks() != SDCARD_OPERATION_SUCCESS) {
+			if (sdcard_interruptWriteBlocks() != SDCARD_OPERATION_SUCCESS) {
 				return false;
 			}
 		} else {
@@ -209,6 +209,8 @@ typedef struct
     volatile uint32_t RXCplt;		   // SD RX Complete is equal 0 when no transfer
     volatile uint32_t TXCplt;		   // SD TX Complete is equal 0 when no transfer
     volatile uint32_t Operation;        // SD transfer operation (read/write)
+    uint32_t          *RXBuffer;        // buffer of the running read, invalidated in the data cache once the DMA completes
+    uint32_t          RXSize;
 } SD_Handle_t;
 
 typedef enum
@@ -451,6 +453,9 @@ static void SD_DMA_Complete(DMA_Stream_TypeDef* pDMA_Stream)
     		/* Clear all the static flags */
     		SDMMC1->ICR = SDMMC_ICR_STATIC_FLAGS;
 
+    		/* Drop any line of the buffer the CPU speculatively cached during the transfer */
+    		dmaCacheInvalidate(SD_Handle.RXBuffer, SD_Handle.RXSize);
+
     		/* Clear flag */
     		SD_Handle.RXCplt = 0;
 
@@ -546,6 +551,11 @@ static void SD_StartBlockTransfert(uint32_t* pBuffer, uint32_t BlockSize, uint32
     }
 	if (dir == SDMMC_DIR_TX) {
 		SDMMC1->DCTRL               |= SDMMC_DCTRL_DMAEN;                                              // Enable SDMMC1 DMA transfer
+		dmaCacheClean(pBuffer, BlockSize * NumberOfBlocks);                                           // Write the buffer to memory for the DMA
+	} else {
+		SD_Handle.RXBuffer = pBuffer;
+		SD_Handle.RXSize = BlockSize * NumberOfBlocks;
+		dmaCacheInvalidate(pBuffer, BlockSize * NumberOfBlocks);                                      // No dirty line may be evicted over the DMA data
 	}
     pDMA->CR                  &= ~DMA_SxCR_EN;                                                      // Disable the Peripheral
     while (pDMA->CR & DMA_SxCR_EN);
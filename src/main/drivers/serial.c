@@ -20,6 +20,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -74,6 +75,53 @@ uint8_t serialRead(serialPort_t *instance)
     return instance->vTable->serialRead(instance);
 }
 
+// Returns the number of received bytes available in one run at *data, which remain valid until serialSkip().
+// Returns 0 if nothing is waiting or the driver cannot expose its receive buffer.
+uint32_t serialPeekContiguous(const serialPort_t *instance, const uint8_t **data)
+{
+    if (instance->vTable->peekContiguous) {
+        return instance->vTable->peekContiguous(instance, data);
+    }
+    return 0;
+}
+
+void serialSkip(serialPort_t *instance, uint32_t count)
+{
+    if (instance->vTable->skip) {
+        instance->vTable->skip(instance, count);
+    } else {
+        while (count--) {
+            serialRead(instance);
+        }
+    }
+}
+
+// Copies up to count received bytes into data, returning the number copied.
+uint32_t serialReadBuf(serialPort_t *instance, uint8_t *data, uint32_t count)
+{
+    uint32_t total = 0;
+
+    if (instance->vTable->peekContiguous) {
+        const uint8_t *src;
+        uint32_t available;
+        // a wrapped ring buffer takes two runs
+        while (total < count && (available = serialPeekContiguous(instance, &src)) > 0) {
+            if (available > count - total) {
+                available = count - total;
+            }
+            memcpy(data + total, src, available);
+            serialSkip(instance, available);
+            total += available;
+        }
+    } else {
+        while (total < count && serialRxBytesWaiting(instance)) {
+            data[total++] = serialRead(instance);
+        }
+    }
+
+    return total;
+}
+
 void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate)
 {
     instance->vTable->serialSetBaudRate(instance, baudRate);
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/ring_buffer.h"
+
 #include "drivers/io.h"
 #include "pg/pg.h"
 
@@ -66,14 +68,10 @@ typedef struct serialPort_s {
 
     uint32_t baudRate;
 
-    uint32_t rxBufferSize;
-    uint32_t txBufferSize;
-    volatile uint8_t *rxBuffer;
-    volatile uint8_t *txBuffer;
-    uint32_t rxBufferHead;
-    uint32_t rxBufferTail;
-    uint32_t txBufferHead;
-    uint32_t txBufferTail;
+    // filled by the receive interrupt and drained by the transmit interrupt or DMA, a circular RX DMA stream
+    // writes the buffer of rxRing and its data counter takes the place of the ring indices
+    byteRing_t rxRing;
+    byteRing_t txRing;
 
     serialReceiveCallbackPtr rxCallback;
     void *rxCallbackData;
@@ -120,6 +118,10 @@ struct serialPortVTable {
     // Optional functions used to buffer large writes.
     void (*beginWrite)(serialPort_t *instance);
     void (*endWrite)(serialPort_t *instance);
+
+    // Optional functions used to read received data in place, without copying single bytes.
+    uint32_t (*peekContiguous)(const serialPort_t *instance, const uint8_t **data);
+    void (*skip)(serialPort_t *instance, uint32_t count);
 };
 
 void serialWrite(serialPort_t *instance, uint8_t ch);
@@ -127,6 +129,9 @@ uint32_t serialRxBytesWaiting(const serialPort_t *instance);
 uint32_t serialTxBytesFree(const serialPort_t *instance);
 void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count);
 uint8_t serialRead(serialPort_t *instance);
+uint32_t serialReadBuf(serialPort_t *instance, uint8_t *data, uint32_t count);
+uint32_t serialPeekContiguous(const serialPort_t *instance, const uint8_t **data);
+void serialSkip(serialPort_t *instance, uint32_t count);
 void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate);
 void serialSetMode(serialPort_t *instance, portMode_e mode);
 void serialSetCtrlLineStateCb(serialPort_t *instance, void (*cb)(void *context, uint16_t ctrlLineState), void *context);
@@ -210,7 +210,7 @@ static bool isTimerPeriodTooLarge(uint32_t timerPeriod)
 static bool isEscSerialTransmitBufferEmpty(const serialPort_t *instance)
 {
     // start listening
-    return instance->txBufferHead == instance->txBufferTail;
+    return byteRingIsEmpty(&instance->txRing);
 }
 
 static void escSerialOutputPortConfig(const timerHardware_t *timerHardwarePtr)
@@ -227,17 +227,14 @@ static void processTxStateBL(escSerial_t *escSerial)
     }
 
     if (!escSerial->isTransmittingData) {
-        char byteToSend;
+        uint8_t byteToSend = 0;
         if (isEscSerialTransmitBufferEmpty((serialPort_t *)escSerial)) {
             // canreceive
             return;
         }
 
         // data to send
-        byteToSend = escSerial->port.txBuffer[escSerial->port.txBufferTail++];
-        if (escSerial->port.txBufferTail >= escSerial->port.txBufferSize) {
-            escSerial->port.txBufferTail = 0;
-        }
+        byteRingPop(&escSerial->port.txRing, &byteToSend);
 
         // build internal buffer, MSB = Stop Bit (1) + data bits (MSB to LSB) + start bit(0) LSB
         escSerial->internalTxBuffer = (1 << (TX_TOTAL_BITS - 1)) | (byteToSend << 1);
@@ -289,8 +286,7 @@ static void extractAndStoreRxByteBL(escSerial_t *escSerial)
     if (escSerial->port.rxCallback) {
         escSerial->port.rxCallback(rxByte, escSerial->port.rxCallbackData);
     } else {
-        escSerial->port.rxBuffer[escSerial->port.rxBufferHead] = rxByte;
-        escSerial->port.rxBufferHead = (escSerial->port.rxBufferHead + 1) % escSerial->port.rxBufferSize;
+        byteRingPush(&escSerial->port.rxRing, rxByte);
     }
 }
 
@@ -445,7 +441,7 @@ static void processTxStateEsc(escSerial_t *escSerial)
         setTxSignalEsc(escSerial, 1);
     }
     if (!escSerial->isTransmittingData) {
-        char byteToSend;
+        uint8_t byteToSend = 0;
 reload:
         if (isEscSerialTransmitBufferEmpty((serialPort_t *)escSerial)) {
             // canreceive
@@ -465,10 +461,7 @@ reload:
         }
         else{
             // data to send
-            byteToSend = escSerial->port.txBuffer[escSerial->port.txBufferTail++];
-            if (escSerial->port.txBufferTail >= escSerial->port.txBufferSize) {
-                escSerial->port.txBufferTail = 0;
-            }
+            byteRingPop(&escSerial->port.txRing, &byteToSend);
         }
 
 
@@ -565,8 +558,7 @@ static void extractAndStoreRxByteEsc(escSerial_t *escSerial)
     if (escSerial->port.rxCallback) {
         escSerial->port.rxCallback(rxByte, escSerial->port.rxCallbackData);
     } else {
-        escSerial->port.rxBuffer[escSerial->port.rxBufferHead] = rxByte;
-        escSerial->port.rxBufferHead = (escSerial->port.rxBufferHead + 1) % escSerial->port.rxBufferSize;
+        byteRingPush(&escSerial->port.rxRing, rxByte);
     }
 }
 
@@ -646,15 +638,8 @@ static void escSerialTimerRxConfig(const timerHardware_t *timerHardwarePtr, uint
 
 static void resetBuffers(escSerial_t *escSerial)
 {
-    escSerial->port.rxBufferSize = ESCSERIAL_BUFFER_SIZE;
-    escSerial->port.rxBuffer = escSerial->rxBuffer;
-    escSerial->port.rxBufferTail = 0;
-    escSerial->port.rxBufferHead = 0;
-
-    escSerial->port.txBuffer = escSerial->txBuffer;
-    escSerial->port.txBufferSize = ESCSERIAL_BUFFER_SIZE;
-    escSerial->port.txBufferTail = 0;
-    escSerial->port.txBufferHead = 0;
+    byteRingInit(&escSerial->port.rxRing, escSerial->rxBuffer, ESCSERIAL_BUFFER_SIZE);
+    byteRingInit(&escSerial->port.txRing, escSerial->txBuffer, ESCSERIAL_BUFFER_SIZE);
 }
 
 static serialPort_t *openEscSerial(escSerialPortIndex_e portIndex, serialReceiveCallbackPtr callback, uint16_t output, uint32_t baud, portOptions_e options, uint8_t mode)
@@ -782,23 +767,18 @@ static uint32_t escSerialTotalBytesWaiting(const serialPort_t *instance)
 
     escSerial_t *s = (escSerial_t *)instance;
 
-    return (s->port.rxBufferHead - s->port.rxBufferTail) & (s->port.rxBufferSize - 1);
+    return byteRingCount(&s->port.rxRing);
 }
 
 static uint8_t escSerialReadByte(serialPort_t *instance)
 {
-    uint8_t ch;
+    uint8_t ch = 0;
 
     if ((instance->mode & MODE_RX) == 0) {
         return 0;
     }
 
-    if (escSerialTotalBytesWaiting(instance) == 0) {
-        return 0;
-    }
-
-    ch = instance->rxBuffer[instance->rxBufferTail];
-    instance->rxBufferTail = (instance->rxBufferTail + 1) % instance->rxBufferSize;
+    byteRingPop(&instance->rxRing, &ch);
     return ch;
 }
 
@@ -808,8 +788,7 @@ static void escSerialWriteByte(serialPort_t *s, uint8_t ch)
         return;
     }
 
-    s->txBuffer[s->txBufferHead] = ch;
-    s->txBufferHead = (s->txBufferHead + 1) % s->txBufferSize;
+    byteRingPush(&s->txRing, ch);
 }
 
 static void escSerialSetBaudRate(serialPort_t *s, uint32_t baudRate)
@@ -831,9 +810,7 @@ static uint32_t escSerialTxBytesFree(const serialPort_t *instance)
 
     escSerial_t *s = (escSerial_t *)instance;
 
-    uint8_t bytesUsed = (s->port.txBufferHead - s->port.txBufferTail) & (s->port.txBufferSize - 1);
-
-    return (s->port.txBufferSize - 1) - bytesUsed;
+    return byteRingFree(&s->port.txRing);
 }
 
 const struct serialPortVTable escSerialVTable[] = {
@@ -849,7 +826,9 @@ const struct serialPortVTable escSerialVTable[] = {
         .setBaudRateCb = NULL,
         .writeBuf = NULL,
         .beginWrite = NULL,
-        .endWrite = NULL
+        .endWrite = NULL,
+        .peekContiguous = NULL,
+        .skip = NULL
     }
 };
 
@@ -25,6 +25,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -35,6 +36,7 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/nvic.h"
@@ -95,6 +97,7 @@ typedef struct softSerial_s {
 
     uint8_t          softSerialPortIndex;
     timerMode_e      timerMode;
+    volatile bool    bitClockActive;    // overflow callback installed, only while a byte is sent or received
 
     timerOvrHandlerRec_t overCb;
     timerCCHandlerRec_t edgeCb;
@@ -129,6 +132,43 @@ static void serialEnableCC(softSerial_t *softSerial)
 #endif
 }
 
+// In single timer mode the overflow interrupt only runs while a byte is being sent or received,
+// an idle port would otherwise take an interrupt for every bit period.
+static void serialBitClockEnable(softSerial_t *softSerial, bool enable)
+{
+    if (enable) {
+        // a stale update flag would fire the first bit period early
+#ifdef USE_HAL_DRIVER
+        __HAL_TIM_CLEAR_FLAG(softSerial->timerHandle, TIM_FLAG_UPDATE);
+#else
+        TIM_ClearFlag(softSerial->timerHardware->tim, TIM_FLAG_Update);
+#endif
+    }
+    timerChConfigCallbacks(softSerial->timerHardware, &softSerial->edgeCb, enable ? &softSerial->overCb : NULL);
+    softSerial->bitClockActive = enable;
+}
+
+static void serialBitClockStartTx(softSerial_t *softSerial)
+{
+    if (softSerial->timerMode == TIMER_MODE_SINGLE && !softSerial->bitClockActive) {
+        ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+            if (!softSerial->bitClockActive) {
+                serialBitClockEnable(softSerial, true);
+            }
+        }
+    }
+}
+
+static bool serialIsIdle(const softSerial_t *softSerial)
+{
+    const bool txIdle = !(softSerial->port.mode & MODE_TX)
+        || (!softSerial->isTransmittingData && isSoftSerialTransmitBufferEmpty(&softSerial->port)
+            && (softSerial->rxActive || !(softSerial->port.options & SERIAL_BIDIR)));
+    const bool rxIdle = !(softSerial->port.mode & MODE_RX) || softSerial->isSearchingForStartBit;
+
+    return txIdle && rxIdle;
+}
+
 static void serialInputPortActivate(softSerial_t *softSerial)
 {
     if (softSerial->port.options & SERIAL_INVERTED) {
@@ -222,15 +262,8 @@ static void serialTimerConfigureTimebase(const timerHardware_t *timerHardwarePtr
 
 static void resetBuffers(softSerial_t *softSerial)
 {
-    softSerial->port.rxBufferSize = SOFTSERIAL_BUFFER_SIZE;
-    softSerial->port.rxBuffer = softSerial->rxBuffer;
-    softSerial->port.rxBufferTail = 0;
-    softSerial->port.rxBufferHead = 0;
-
-    softSerial->port.txBuffer = softSerial->txBuffer;
-    softSerial->port.txBufferSize = SOFTSERIAL_BUFFER_SIZE;
-    softSerial->port.txBufferTail = 0;
-    softSerial->port.txBufferHead = 0;
+    byteRingInit(&softSerial->port.rxRing, softSerial->rxBuffer, SOFTSERIAL_BUFFER_SIZE);
+    byteRingInit(&softSerial->port.txRing, softSerial->txBuffer, SOFTSERIAL_BUFFER_SIZE);
 }
 
 serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallbackPtr rxCallback, void *rxCallbackData, uint32_t baud, portMode_e mode, portOptions_e options)
@@ -330,13 +363,17 @@ serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallb
         timerChConfigCallbacks(softSerial->timerHardware, &softSerial->edgeCb, NULL);
     } else {
         softSerial->timerMode = TIMER_MODE_SINGLE;
-        timerChConfigCallbacks(softSerial->timerHardware, &softSerial->edgeCb, &softSerial->overCb);
     }
 
 #ifdef USE_HAL_DRIVER
     softSerial->timerHandle = timerFindTimerHandle(softSerial->timerHardware->tim);
 #endif
 
+    if (softSerial->timerMode == TIMER_MODE_SINGLE) {
+        // the bit clock starts with the first byte to send or the first start bit received
+        serialBitClockEnable(softSerial, false);
+    }
+
     if (!(options & SERIAL_BIDIR)) {
         serialOutputPortActivate(softSerial);
         setTxSignal(softSerial, ENABLE);
@@ -368,10 +405,8 @@ void processTxState(softSerial_t *softSerial)
         }
 
         // data to send
-        uint8_t byteToSend = softSerial->port.txBuffer[softSerial->port.txBufferTail++];
-        if (softSerial->port.txBufferTail >= softSerial->port.txBufferSize) {
-            softSerial->port.txBufferTail = 0;
-        }
+        uint8_t byteToSend = 0;
+        byteRingPop(&softSerial->port.txRing, &byteToSend);
 
         // build internal buffer, MSB = Stop Bit (1) + data bits (MSB to LSB) + start bit(0) LSB
         softSerial->internalTxBuffer = (1 << (TX_TOTAL_BITS - 1)) | (byteToSend << 1);
@@ -453,8 +488,7 @@ void extractAndStoreRxByte(softSerial_t *softSerial)
     if (softSerial->port.rxCallback) {
         softSerial->port.rxCallback(rxByte, softSerial->port.rxCallbackData);
     } else {
-        softSerial->port.rxBuffer[softSerial->port.rxBufferHead] = rxByte;
-        softSerial->port.rxBufferHead = (softSerial->port.rxBufferHead + 1) % softSerial->port.rxBufferSize;
+        byteRingPush(&softSerial->port.rxRing, rxByte);
     }
 }
 
@@ -492,6 +526,10 @@ void onSerialTimerOverflow(timerOvrHandlerRec_t *cbRec, captureCompare_t capture
 
     if (self->port.mode & MODE_RX)
         processRxState(self);
+
+    if (self->timerMode == TIMER_MODE_SINGLE && serialIsIdle(self)) {
+        serialBitClockEnable(self, false);
+    }
 }
 
 void onSerialRxPinChange(timerCCHandlerRec_t *cbRec, captureCompare_t capture)
@@ -524,6 +562,10 @@ void onSerialRxPinChange(timerCCHandlerRec_t *cbRec, captureCompare_t capture)
             self->transmissionErrors++;
         }
 
+        if (self->timerMode == TIMER_MODE_SINGLE && !self->bitClockActive) {
+            serialBitClockEnable(self, true);
+        }
+
         timerChConfigIC(self->timerHardware, inverted ? ICPOLARITY_FALLING : ICPOLARITY_RISING, 0);
 #ifdef STM32F7
         serialEnableCC(self);
@@ -568,7 +610,7 @@ uint32_t softSerialRxBytesWaiting(const serialPort_t *instance)
 
     softSerial_t *s = (softSerial_t *)instance;
 
-    return (s->port.rxBufferHead - s->port.rxBufferTail) & (s->port.rxBufferSize - 1);
+    return byteRingCount(&s->port.rxRing);
 }
 
 uint32_t softSerialTxBytesFree(const serialPort_t *instance)
@@ -579,25 +621,18 @@ uint32_t softSerialTxBytesFree(const serialPort_t *instance)
 
     softSerial_t *s = (softSerial_t *)instance;
 
-    uint8_t bytesUsed = (s->port.txBufferHead - s->port.txBufferTail) & (s->port.txBufferSize - 1);
-
-    return (s->port.txBufferSize - 1) - bytesUsed;
+    return byteRingFree(&s->port.txRing);
 }
 
 uint8_t softSerialReadByte(serialPort_t *instance)
 {
-    uint8_t ch;
+    uint8_t ch = 0;
 
     if ((instance->mode & MODE_RX) == 0) {
         return 0;
     }
 
-    if (softSerialRxBytesWaiting(instance) == 0) {
-        return 0;
-    }
-
-    ch = instance->rxBuffer[instance->rxBufferTail];
-    instance->rxBufferTail = (instance->rxBufferTail + 1) % instance->rxBufferSize;
+    byteRingPop(&instance->rxRing, &ch);
     return ch;
 }
 
@@ -607,8 +642,30 @@ void softSerialWriteByte(serialPort_t *s, uint8_t ch)
         return;
     }
 
-    s->txBuffer[s->txBufferHead] = ch;
-    s->txBufferHead = (s->txBufferHead + 1) % s->txBufferSize;
+    byteRingPush(&s->txRing, ch);
+
+    serialBitClockStartTx((softSerial_t *)s);
+}
+
+static void softSerialWriteBuf(serialPort_t *s, const void *data, int count)
+{
+    if ((s->mode & MODE_TX) == 0) {
+        return;
+    }
+
+    const uint8_t *p = data;
+    while (count > 0) {
+        // The timer interrupt drains the buffer, so wait for room the way serialWriteBuf() does
+        uint32_t chunk;
+        while ((chunk = softSerialTxBytesFree(s)) == 0) {
+        };
+
+        chunk = byteRingPushBulk(&s->txRing, p, MIN(chunk, (uint32_t)count));
+        p += chunk;
+        count -= chunk;
+
+        serialBitClockStartTx((softSerial_t *)s);
+    }
 }
 
 void softSerialSetBaudRate(serialPort_t *s, uint32_t baudRate)
@@ -627,7 +684,7 @@ void softSerialSetMode(serialPort_t *instance, portMode_e mode)
 
 bool isSoftSerialTransmitBufferEmpty(const serialPort_t *instance)
 {
-    return instance->txBufferHead == instance->txBufferTail;
+    return byteRingIsEmpty(&instance->txRing);
 }
 
 static const struct serialPortVTable softSerialVTable = {
@@ -640,9 +697,11 @@ static const struct serialPortVTable softSerialVTable = {
     .setMode = softSerialSetMode,
     .setCtrlLineStateCb = NULL,
     .setBaudRateCb = NULL,
-    .writeBuf = NULL,
+    .writeBuf = softSerialWriteBuf,
     .beginWrite = NULL,
-    .endWrite = NULL
+    .endWrite = NULL,
+    .peekContiguous = NULL,
+    .skip = NULL
 };
 
 #endif
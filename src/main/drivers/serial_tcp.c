@@ -27,12 +27,14 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 #include "platform.h"
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "io/serial.h"
@@ -44,9 +46,31 @@ static const struct serialPortVTable tcpVTable; // Forward
 static tcpPort_t tcpSerialPorts[SERIAL_PORT_COUNT];
 static bool tcpPortInitialized[SERIAL_PORT_COUNT];
 static bool tcpStart = false;
+static uint16_t tcpBasePort = BASE_PORT;
+
+void tcpSetBasePort(uint16_t basePort) {
+    tcpBasePort = basePort;
+}
 bool tcpIsStart(void) {
     return tcpStart;
 }
+// sockets of the listening and connected streams, to wait on them
+int tcpGetSockets(int *sockets, int maxCount) {
+    int count = 0;
+    for (int id = 0; id < SERIAL_PORT_COUNT; id++) {
+        if (!tcpPortInitialized[id]) {
+            continue;
+        }
+        const tcpPort_t *s = &tcpSerialPorts[id];
+        if (s->serv && count < maxCount) {
+            sockets[count++] = dyad_getSocket(s->serv);
+        }
+        if (s->conn && count < maxCount) {
+            sockets[count++] = dyad_getSocket(s->conn);
+        }
+    }
+    return count;
+}
 static void onData(dyad_Event *e) {
     tcpPort_t* s = (tcpPort_t*)(e->udata);
     tcpDataIn(s, (uint8_t*)e->data, e->size);
@@ -106,10 +130,10 @@ static tcpPort_t* tcpReconfigure(tcpPort_t *s, int id)
     dyad_setNoDelay(s->serv, 1);
     dyad_addListener(s->serv, DYAD_EVENT_ACCEPT, onAccept, s);
 
-    if (dyad_listenEx(s->serv, NULL, BASE_PORT + id + 1, 10) == 0) {
-        fprintf(stderr, "bind port %u for UART%u\n", (unsigned)BASE_PORT + id + 1, (unsigned)id + 1);
+    if (dyad_listenEx(s->serv, NULL, tcpBasePort + id + 1, 10) == 0) {
+        fprintf(stderr, "bind port %u for UART%u\n", (unsigned)tcpBasePort + id + 1, (unsigned)id + 1);
     } else {
-        fprintf(stderr, "bind port %u for UART%u failed!!\n", (unsigned)BASE_PORT + id + 1, (unsigned)id + 1);
+        fprintf(stderr, "bind port %u for UART%u failed!!\n", (unsigned)tcpBasePort + id + 1, (unsigned)id + 1);
     }
     return s;
 }
@@ -129,12 +153,8 @@ serialPort_t *serTcpOpen(int id, serialReceiveCallbackPtr rxCallback, void *rxCa
     s->port.vTable = &tcpVTable;
 
     // common serial initialisation code should move to serialPort::init()
-    s->port.rxBufferHead = s->port.rxBufferTail = 0;
-    s->port.txBufferHead = s->port.txBufferTail = 0;
-    s->port.rxBufferSize = RX_BUFFER_SIZE;
-    s->port.txBufferSize = TX_BUFFER_SIZE;
-    s->port.rxBuffer = s->rxBuffer;
-    s->port.txBuffer = s->txBuffer;
+    byteRingInit(&s->port.rxRing, s->rxBuffer, RX_BUFFER_SIZE);
+    byteRingInit(&s->port.txRing, s->txBuffer, TX_BUFFER_SIZE);
 
     // callback works for IRQ-based RX ONLY
     s->port.rxCallback = rxCallback;
@@ -151,11 +171,7 @@ uint32_t tcpTotalRxBytesWaiting(const serialPort_t *instance)
     tcpPort_t *s = (tcpPort_t*)instance;
     uint32_t count;
     pthread_mutex_lock(&s->rxLock);
-    if (s->port.rxBufferHead >= s->port.rxBufferTail) {
-        count = s->port.rxBufferHead - s->port.rxBufferTail;
-    } else {
-        count = s->port.rxBufferSize + s->port.rxBufferHead - s->port.rxBufferTail;
-    }
+    count = byteRingCount(&s->port.rxRing);
     pthread_mutex_unlock(&s->rxLock);
 
     return count;
@@ -164,15 +180,9 @@ uint32_t tcpTotalRxBytesWaiting(const serialPort_t *instance)
 uint32_t tcpTotalTxBytesFree(const serialPort_t *instance)
 {
     tcpPort_t *s = (tcpPort_t*)instance;
-    uint32_t bytesUsed;
 
     pthread_mutex_lock(&s->txLock);
-    if (s->port.txBufferHead >= s->port.txBufferTail) {
-        bytesUsed = s->port.txBufferHead - s->port.txBufferTail;
-    } else {
-        bytesUsed = s->port.txBufferSize + s->port.txBufferHead - s->port.txBufferTail;
-    }
-    uint32_t bytesFree = (s->port.txBufferSize - 1) - bytesUsed;
+    uint32_t bytesFree = byteRingFree(&s->port.txRing);
     pthread_mutex_unlock(&s->txLock);
 
     return bytesFree;
@@ -182,23 +192,18 @@ bool isTcpTransmitBufferEmpty(const serialPort_t *instance)
 {
     tcpPort_t *s = (tcpPort_t *)instance;
     pthread_mutex_lock(&s->txLock);
-    bool isEmpty = s->port.txBufferTail == s->port.txBufferHead;
+    bool isEmpty = byteRingIsEmpty(&s->port.txRing);
     pthread_mutex_unlock(&s->txLock);
     return isEmpty;
 }
 
 uint8_t tcpRead(serialPort_t *instance)
 {
-    uint8_t ch;
+    uint8_t ch = 0;
     tcpPort_t *s = (tcpPort_t *)instance;
     pthread_mutex_lock(&s->rxLock);
 
-    ch = s->port.rxBuffer[s->port.rxBufferTail];
-    if (s->port.rxBufferTail + 1 >= s->port.rxBufferSize) {
-        s->port.rxBufferTail = 0;
-    } else {
-        s->port.rxBufferTail++;
-    }
+    byteRingPop(&s->port.rxRing, &ch);
     pthread_mutex_unlock(&s->rxLock);
 
     return ch;
@@ -209,33 +214,46 @@ void tcpWrite(serialPort_t *instance, uint8_t ch)
     tcpPort_t *s = (tcpPort_t *)instance;
     pthread_mutex_lock(&s->txLock);
 
-    s->port.txBuffer[s->port.txBufferHead] = ch;
-    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
-        s->port.txBufferHead = 0;
-    } else {
-        s->port.txBufferHead++;
-    }
+    byteRingPush(&s->port.txRing, ch);
     pthread_mutex_unlock(&s->txLock);
 
     tcpDataOut(s);
 }
 
+static void tcpWriteBuf(serialPort_t *instance, const void *data, int count)
+{
+    tcpPort_t *s = (tcpPort_t *)instance;
+    const uint8_t *p = data;
+
+    while (count > 0) {
+        pthread_mutex_lock(&s->txLock);
+        const int chunk = byteRingPushBulk(&s->port.txRing, p, count);
+        pthread_mutex_unlock(&s->txLock);
+        if (chunk == 0) {
+            // the buffer was drained after the last chunk unless nobody is connected, the rest is dropped then
+            break;
+        }
+        p += chunk;
+        count -= chunk;
+
+        // hand everything to dyad before the ring fills up
+        tcpDataOut(s);
+    }
+}
+
 void tcpDataOut(tcpPort_t *instance)
 {
     tcpPort_t *s = (tcpPort_t *)instance;
     if (s->conn == NULL) return;
     pthread_mutex_lock(&s->txLock);
 
-    if (s->port.txBufferHead < s->port.txBufferTail) {
-        // send data till end of buffer
-        int chunk = s->port.txBufferSize - s->port.txBufferTail;
-        dyad_write(s->conn, (const void *)&s->port.txBuffer[s->port.txBufferTail], chunk);
-        s->port.txBufferTail = 0;
+    // up to the end of the buffer, then the rest from its start
+    const uint8_t *data;
+    uint32_t chunk;
+    while ((chunk = byteRingReadSpan(&s->port.txRing, &data)) > 0) {
+        dyad_write(s->conn, (const void *)data, chunk);
+        byteRingConsume(&s->port.txRing, chunk);
     }
-    int chunk = s->port.txBufferHead - s->port.txBufferTail;
-    if (chunk)
-        dyad_write(s->conn, (const void*)&s->port.txBuffer[s->port.txBufferTail], chunk);
-    s->port.txBufferTail = s->port.txBufferHead;
 
     pthread_mutex_unlock(&s->txLock);
 }
@@ -245,15 +263,8 @@ void tcpDataIn(tcpPort_t *instance, uint8_t* ch, int size)
     tcpPort_t *s = (tcpPort_t *)instance;
     pthread_mutex_lock(&s->rxLock);
 
-    while (size--) {
-//        printf("%c", *ch);
-        s->port.rxBuffer[s->port.rxBufferHead] = *(ch++);
-        if (s->port.rxBufferHead + 1 >= s->port.rxBufferSize) {
-            s->port.rxBufferHead = 0;
-        } else {
-            s->port.rxBufferHead++;
-        }
-    }
+    // what does not fit is dropped
+    byteRingPushBulk(&s->port.rxRing, ch, size);
     pthread_mutex_unlock(&s->rxLock);
 //    printf("\n");
 }
@@ -268,7 +279,9 @@ static const struct serialPortVTable tcpVTable = {
         .setMode = NULL,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
-        .writeBuf = NULL,
+        .writeBuf = tcpWriteBuf,
         .beginWrite = NULL,
         .endWrite = NULL,
+        .peekContiguous = NULL,
+        .skip = NULL,
 };
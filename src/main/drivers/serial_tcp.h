@@ -24,8 +24,8 @@
 #include <pthread.h>
 #include "dyad.h"
 
-#define RX_BUFFER_SIZE    1400
-#define TX_BUFFER_SIZE    1400
+#define RX_BUFFER_SIZE    2048
+#define TX_BUFFER_SIZE    2048
 
 typedef struct {
     serialPort_t port;
@@ -47,6 +47,8 @@ serialPort_t *serTcpOpen(int id, serialReceiveCallbackPtr rxCallback, void *rxCa
 void tcpDataIn(tcpPort_t *instance, uint8_t* ch, int size);
 void tcpDataOut(tcpPort_t *instance);
 
+void tcpSetBasePort(uint16_t basePort); // UARTx binds basePort + x
 bool tcpIsStart(void);
+int tcpGetSockets(int *sockets, int maxCount);
 bool* tcpGetUsed(void);
 tcpPort_t* tcpGetPool(void);
@@ -0,0 +1,92 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Transmit with a gap between the bytes, for the protocols whose devices can't take the bytes back to back.
+ *
+ * The bytes are written from the 1ms system tick, so the gap does not depend on when a task runs and no task waits
+ * for it. By the time the next byte is written the previous one has long left the port, so the write does not race
+ * the transmit interrupt of the port even where the system tick can preempt it.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_SERIAL_TX_PACED
+
+#include "drivers/serial.h"
+
+#include "serial_tx_paced.h"
+
+static serialPort_t * volatile pacedPort;
+static const uint8_t *pacedData;
+static uint8_t pacedBytesRemaining;
+static uint8_t pacedIntervalMs;
+static uint8_t pacedTicksUntilNextByte;
+
+// Starts sending length bytes of data, the first one interval from now. The data must remain valid while busy.
+bool serialTxPacedStart(serialPort_t *port, const uint8_t *data, uint8_t length, uint8_t intervalMs)
+{
+    if (pacedPort || !intervalMs) {
+        return false;
+    }
+
+    pacedData = data;
+    pacedBytesRemaining = length;
+    pacedIntervalMs = intervalMs;
+    pacedTicksUntilNextByte = intervalMs;
+    // the tick only looks at the transfer once the port is set
+    pacedPort = port;
+
+    return true;
+}
+
+void serialTxPacedStop(void)
+{
+    pacedPort = NULL;
+}
+
+// Busy until one interval after the last byte was written, so the port can be switched back to receive
+bool serialTxPacedIsBusy(void)
+{
+    return pacedPort != NULL;
+}
+
+// Called from the system tick interrupt
+void serialTxPacedTick(void)
+{
+    serialPort_t *port = pacedPort;
+    if (!port || --pacedTicksUntilNextByte) {
+        return;
+    }
+
+    if (!pacedBytesRemaining) {
+        pacedPort = NULL;
+        return;
+    }
+
+    serialWrite(port, *pacedData++);
+    pacedBytesRemaining--;
+    pacedTicksUntilNextByte = pacedIntervalMs;
+}
+
+#endif
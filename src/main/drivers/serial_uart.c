@@ -27,12 +27,14 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
 #include "build/build_config.h"
 #include "build/atomic.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/dma.h"
@@ -44,6 +46,10 @@
 #include "drivers/serial_uart.h"
 #include "drivers/serial_uart_impl.h"
 
+// the buffers are rings indexed by masking
+STATIC_ASSERT(RING_BUFFER_IS_POWER_OF_2(UART_RX_BUFFER_SIZE), uart_rx_buffer_size_not_a_power_of_2);
+STATIC_ASSERT(RING_BUFFER_IS_POWER_OF_2(UART_TX_BUFFER_SIZE), uart_tx_buffer_size_not_a_power_of_2);
+
 static void uartSetBaudRate(serialPort_t *instance, uint32_t baudRate)
 {
     uartPort_t *uartPort = (uartPort_t *)instance;
@@ -80,24 +86,18 @@ void uartTryStartTxDMA(uartPort_t *s)
 
         // DMA_Cmd(s->txDMAStream, DISABLE); // XXX It's already disabled.
 
-        if (s->port.txBufferHead == s->port.txBufferTail) {
+        if (byteRingIsEmpty(&s->port.txRing)) {
             // No more data to transmit.
             s->txDMAEmpty = true;
             return;
         }
 
-        // Start a new transaction.
-
-        DMA_MemoryTargetConfig(s->txDMAStream, (uint32_t)&s->port.txBuffer[s->port.txBufferTail], DMA_Memory_0);
-        //s->txDMAStream->M0AR = (uint32_t)&s->port.txBuffer[s->port.txBufferTail];
-        if (s->port.txBufferHead > s->port.txBufferTail) {
-            s->txDMAStream->NDTR = s->port.txBufferHead - s->port.txBufferTail;
-            s->port.txBufferTail = s->port.txBufferHead;
-        }
-        else {
-            s->txDMAStream->NDTR = s->port.txBufferSize - s->port.txBufferTail;
-            s->port.txBufferTail = 0;
-        }
+        // Start a new transaction, up to the end of the buffer.
+        const uint8_t *data;
+        const uint32_t count = byteRingReadSpan(&s->port.txRing, &data);
+        DMA_MemoryTargetConfig(s->txDMAStream, (uint32_t)data, DMA_Memory_0);
+        s->txDMAStream->NDTR = count;
+        byteRingConsume(&s->port.txRing, count);
         s->txDMAEmpty = false;
 
     reenable:
@@ -117,22 +117,18 @@ void uartTryStartTxDMA(uartPort_t *s)
             goto reenable;
         }
 
-        if (s->port.txBufferHead == s->port.txBufferTail) {
+        if (byteRingIsEmpty(&s->port.txRing)) {
             // No more data to transmit.
             s->txDMAEmpty = true;
             return;
         }
 
-        // Start a new transaction.
-
-        s->txDMAChannel->CMAR = (uint32_t)&s->port.txBuffer[s->port.txBufferTail];
-        if (s->port.txBufferHead > s->port.txBufferTail) {
-            s->txDMAChannel->CNDTR = s->port.txBufferHead - s->port.txBufferTail;
-            s->port.txBufferTail = s->port.txBufferHead;
-        } else {
-            s->txDMAChannel->CNDTR = s->port.txBufferSize - s->port.txBufferTail;
-            s->port.txBufferTail = 0;
-        }
+        // Start a new transaction, up to the end of the buffer.
+        const uint8_t *data;
+        const uint32_t count = byteRingReadSpan(&s->port.txRing, &data);
+        s->txDMAChannel->CMAR = (uint32_t)data;
+        s->txDMAChannel->CNDTR = count;
+        byteRingConsume(&s->port.txRing, count);
         s->txDMAEmpty = false;
 
     reenable:
@@ -141,71 +137,95 @@ void uartTryStartTxDMA(uartPort_t *s)
     }
 }
 
+// Index in the RX ring buffer of the next byte the DMA stream will write, the stream runs circular over the buffer
+// so its counters take the place of the ring indices
+static uint32_t uartRxDMAHead(const uartPort_t *s)
+{
+#ifdef STM32F4
+    return byteRingSize(&s->port.rxRing) - s->rxDMAStream->NDTR;
+#else
+    return byteRingSize(&s->port.rxRing) - s->rxDMAChannel->CNDTR;
+#endif
+}
+
 static uint32_t uartTotalRxBytesWaiting(const serialPort_t *instance)
 {
     const uartPort_t *s = (const uartPort_t*)instance;
 #ifdef STM32F4
     if (s->rxDMAStream) {
-        uint32_t rxDMAHead = s->rxDMAStream->NDTR;
 #else
     if (s->rxDMAChannel) {
-        uint32_t rxDMAHead = s->rxDMAChannel->CNDTR;
 #endif
-        if (rxDMAHead >= s->rxDMAPos) {
-            return rxDMAHead - s->rxDMAPos;
+        // rxDMAPos counts down like the DMA data counter
+        const uint32_t rxBufferSize = byteRingSize(&s->port.rxRing);
+        const uint32_t rxDMAHead = uartRxDMAHead(s);
+        const uint32_t rxDMATail = rxBufferSize - s->rxDMAPos;
+        if (rxDMAHead >= rxDMATail) {
+            return rxDMAHead - rxDMATail;
         } else {
-            return s->port.rxBufferSize + rxDMAHead - s->rxDMAPos;
+            return rxBufferSize + rxDMAHead - rxDMATail;
         }
     }
 
-    if (s->port.rxBufferHead >= s->port.rxBufferTail) {
-        return s->port.rxBufferHead - s->port.rxBufferTail;
-    } else {
-        return s->port.rxBufferSize + s->port.rxBufferHead - s->port.rxBufferTail;
-    }
+    return byteRingCount(&s->port.rxRing);
 }
 
-static uint32_t uartTotalTxBytesFree(const serialPort_t *instance)
+static uint32_t uartPeekContiguous(const serialPort_t *instance, const uint8_t **data)
 {
     const uartPort_t *s = (const uartPort_t*)instance;
 
-    uint32_t bytesUsed;
+#ifdef STM32F4
+    if (s->rxDMAStream) {
+#else
+    if (s->rxDMAChannel) {
+#endif
+        const uint32_t rxBufferSize = byteRingSize(&s->port.rxRing);
+        const uint32_t head = uartRxDMAHead(s);
+        const uint32_t tail = rxBufferSize - s->rxDMAPos;
 
-    if (s->port.txBufferHead >= s->port.txBufferTail) {
-        bytesUsed = s->port.txBufferHead - s->port.txBufferTail;
+        *data = (const uint8_t *)&s->port.rxRing.buffer[tail];
+
+        // stop at the end of the buffer, the remainder follows from index 0
+        return (head >= tail) ? head - tail : rxBufferSize - tail;
+    }
+
+    return byteRingReadSpan(&s->port.rxRing, data);
+}
+
+static void uartSkip(serialPort_t *instance, uint32_t count)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+#ifdef STM32F4
+    if (s->rxDMAStream) {
+#else
+    if (s->rxDMAChannel) {
+#endif
+        s->rxDMAPos = (count < s->rxDMAPos) ? s->rxDMAPos - count : s->rxDMAPos + byteRingSize(&s->port.rxRing) - count;
     } else {
-        bytesUsed = s->port.txBufferSize + s->port.txBufferHead - s->port.txBufferTail;
+        byteRingConsume(&s->port.rxRing, count);
     }
+}
+
+static uint32_t uartTotalTxBytesFree(const serialPort_t *instance)
+{
+    const uartPort_t *s = (const uartPort_t*)instance;
+
+    const uint32_t bytesFree = byteRingFree(&s->port.txRing);
 
 #ifdef STM32F4
     if (s->txDMAStream) {
-        /*
-         * When we queue up a DMA request, we advance the Tx buffer tail before the transfer finishes, so we must add
-         * the remaining size of that in-progress transfer here instead:
-         */
-        bytesUsed += s->txDMAStream->NDTR;
+        // The Tx buffer tail is advanced when a DMA transfer is queued, the bytes that transfer has still to send are not free yet
+        const uint32_t bytesInTransfer = s->txDMAStream->NDTR;
 #else
     if (s->txDMAChannel) {
-        /*
-         * When we queue up a DMA request, we advance the Tx buffer tail before the transfer finishes, so we must add
-         * the remaining size of that in-progress transfer here instead:
-         */
-        bytesUsed += s->txDMAChannel->CNDTR;
+        // The Tx buffer tail is advanced when a DMA transfer is queued, the bytes that transfer has still to send are not free yet
+        const uint32_t bytesInTransfer = s->txDMAChannel->CNDTR;
 #endif
-        /*
-         * If the Tx buffer is being written to very quickly, we might have advanced the head into the buffer
-         * space occupied by the current DMA transfer. In that case the "bytesUsed" total will actually end up larger
-         * than the total Tx buffer size, because we'll end up transmitting the same buffer region twice. (So we'll be
-         * transmitting a garbage mixture of old and new bytes).
-         *
-         * Be kind to callers and pretend like our buffer can only ever be 100% full.
-         */
-        if (bytesUsed >= s->port.txBufferSize - 1) {
-            return 0;
-        }
+        return bytesFree > bytesInTransfer ? bytesFree - bytesInTransfer : 0;
     }
 
-    return (s->port.txBufferSize - 1) - bytesUsed;
+    return bytesFree;
 }
 
 static bool isUartTransmitBufferEmpty(const serialPort_t *instance)
@@ -218,12 +238,30 @@ static bool isUartTransmitBufferEmpty(const serialPort_t *instance)
 #endif
         return s->txDMAEmpty;
     else
-        return s->port.txBufferTail == s->port.txBufferHead;
+        return byteRingIsEmpty(&s->port.txRing);
+}
+
+// Hands everything the RX DMA stream has written so far to the receive callback.
+// Called from the idle line and RX DMA interrupts, so a frame costs one interrupt instead of one per byte.
+void uartRxDMADeliver(uartPort_t *s)
+{
+    if (!s->port.rxCallback) {
+        return;
+    }
+
+    const uint8_t *data;
+    uint32_t count;
+    while ((count = uartPeekContiguous(&s->port, &data)) > 0) {
+        for (uint32_t i = 0; i < count; i++) {
+            s->port.rxCallback(data[i], s->port.rxCallbackData);
+        }
+        uartSkip(&s->port, count);
+    }
 }
 
 static uint8_t uartRead(serialPort_t *instance)
 {
-    uint8_t ch;
+    uint8_t ch = 0;
     uartPort_t *s = (uartPort_t *)instance;
 
 #ifdef STM32F4
@@ -231,31 +269,19 @@ static uint8_t uartRead(serialPort_t *instance)
 #else
     if (s->rxDMAChannel) {
 #endif
-        ch = s->port.rxBuffer[s->port.rxBufferSize - s->rxDMAPos];
+        const uint32_t rxBufferSize = byteRingSize(&s->port.rxRing);
+        ch = s->port.rxRing.buffer[rxBufferSize - s->rxDMAPos];
         if (--s->rxDMAPos == 0)
-            s->rxDMAPos = s->port.rxBufferSize;
+            s->rxDMAPos = rxBufferSize;
     } else {
-        ch = s->port.rxBuffer[s->port.rxBufferTail];
-        if (s->port.rxBufferTail + 1 >= s->port.rxBufferSize) {
-            s->port.rxBufferTail = 0;
-        } else {
-            s->port.rxBufferTail++;
-        }
+        byteRingPop(&s->port.rxRing, &ch);
     }
 
     return ch;
 }
 
-static void uartWrite(serialPort_t *instance, uint8_t ch)
+static void uartStartTx(uartPort_t *s)
 {
-    uartPort_t *s = (uartPort_t *)instance;
-    s->port.txBuffer[s->port.txBufferHead] = ch;
-    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
-        s->port.txBufferHead = 0;
-    } else {
-        s->port.txBufferHead++;
-    }
-
 #ifdef STM32F4
     if (s->txDMAStream)
 #else
@@ -268,6 +294,34 @@ static void uartWrite(serialPort_t *instance, uint8_t ch)
     }
 }
 
+static void uartWrite(serialPort_t *instance, uint8_t ch)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+    // dropped if the buffer is full, rather than overwriting what is still to be sent
+    byteRingPush(&s->port.txRing, ch);
+
+    uartStartTx(s);
+}
+
+static void uartWriteBuf(serialPort_t *instance, const void *data, int count)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+    const uint8_t *p = data;
+
+    while (count > 0) {
+        // Block while the buffer is full, as the byte-wise fallback in serialWriteBuf() does
+        uint32_t chunk;
+        while ((chunk = uartTotalTxBytesFree(instance)) == 0) {
+        };
+
+        chunk = byteRingPushBulk(&s->port.txRing, p, MIN(chunk, (uint32_t)count));
+        p += chunk;
+        count -= chunk;
+
+        uartStartTx(s);
+    }
+}
+
 const struct serialPortVTable uartVTable[] = {
     {
         .serialWrite = uartWrite,
@@ -279,9 +333,11 @@ const struct serialPortVTable uartVTable[] = {
         .setMode = uartSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
-        .writeBuf = NULL,
+        .writeBuf = uartWriteBuf,
         .beginWrite = NULL,
         .endWrite = NULL,
+        .peekContiguous = uartPeekContiguous,
+        .skip = uartSkip,
     }
 };
 
@@ -27,11 +27,13 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "platform.h"
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 #include "drivers/io.h"
 #include "drivers/nvic.h"
@@ -136,7 +138,7 @@ void uartReconfigure(uartPort_t *uartPort)
             /* Associate the initialized DMA handle to the UART handle */
             __HAL_LINKDMA(&uartPort->Handle, hdmarx, uartPort->rxDMAHandle);
 
-            HAL_UART_Receive_DMA(&uartPort->Handle, (uint8_t*)uartPort->port.rxBuffer, uartPort->port.rxBufferSize);
+            HAL_UART_Receive_DMA(&uartPort->Handle, (uint8_t*)uartPort->port.rxRing.buffer, byteRingSize(&uartPort->port.rxRing));
 
             uartPort->rxDMAPos = __HAL_DMA_GET_COUNTER(&uartPort->rxDMAHandle);
 
@@ -201,9 +203,6 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr callback, v
 
     s->txDMAEmpty = true;
 
-    // common serial initialisation code should move to serialPort::init()
-    s->port.rxBufferHead = s->port.rxBufferTail = 0;
-    s->port.txBufferHead = s->port.txBufferTail = 0;
     // callback works for IRQ-based RX ONLY
     s->port.rxCallback = callback;
     s->port.rxCallbackData = callbackData;
@@ -232,24 +231,17 @@ void uartSetMode(serialPort_t *instance, portMode_e mode)
 
 void uartStartTxDMA(uartPort_t *s)
 {
-    uint16_t size = 0;
-    uint32_t fromwhere=0;
     HAL_UART_StateTypeDef state = HAL_UART_GetState(&s->Handle);
-    if ((state & HAL_UART_STATE_BUSY_TX) == HAL_UART_STATE_BUSY_TX)
+    if ((state & HAL_UART_STATE_BUSY_TX) == HAL_UART_STATE_BUSY_TX || byteRingIsEmpty(&s->port.txRing))
         return;
 
-    if (s->port.txBufferHead > s->port.txBufferTail) {
-        size = s->port.txBufferHead - s->port.txBufferTail;
-        fromwhere = s->port.txBufferTail;
-        s->port.txBufferTail = s->port.txBufferHead;
-    } else {
-        size = s->port.txBufferSize - s->port.txBufferTail;
-        fromwhere = s->port.txBufferTail;
-        s->port.txBufferTail = 0;
-    }
+    // up to the end of the buffer, the rest is sent by the next transfer
+    const uint8_t *data;
+    const uint16_t size = byteRingReadSpan(&s->port.txRing, &data);
+    byteRingConsume(&s->port.txRing, size);
     s->txDMAEmpty = false;
-    //HAL_CLEANCACHE((uint8_t *)&s->port.txBuffer[fromwhere],size);
-    HAL_UART_Transmit_DMA(&s->Handle, (uint8_t *)&s->port.txBuffer[fromwhere], size);
+    //HAL_CLEANCACHE((uint8_t *)data,size);
+    HAL_UART_Transmit_DMA(&s->Handle, (uint8_t *)data, size);
 }
 
 uint32_t uartTotalRxBytesWaiting(const serialPort_t *instance)
@@ -262,50 +254,26 @@ uint32_t uartTotalRxBytesWaiting(const serialPort_t *instance)
         if (rxDMAHead >= s->rxDMAPos) {
             return rxDMAHead - s->rxDMAPos;
         } else {
-            return s->port.rxBufferSize + rxDMAHead - s->rxDMAPos;
+            return byteRingSize(&s->port.rxRing) + rxDMAHead - s->rxDMAPos;
         }
     }
 
-    if (s->port.rxBufferHead >= s->port.rxBufferTail) {
-        return s->port.rxBufferHead - s->port.rxBufferTail;
-    } else {
-        return s->port.rxBufferSize + s->port.rxBufferHead - s->port.rxBufferTail;
-    }
+    return byteRingCount(&s->port.rxRing);
 }
 
 uint32_t uartTotalTxBytesFree(const serialPort_t *instance)
 {
     uartPort_t *s = (uartPort_t*)instance;
 
-    uint32_t bytesUsed;
-
-    if (s->port.txBufferHead >= s->port.txBufferTail) {
-        bytesUsed = s->port.txBufferHead - s->port.txBufferTail;
-    } else {
-        bytesUsed = s->port.txBufferSize + s->port.txBufferHead - s->port.txBufferTail;
-    }
+    const uint32_t bytesFree = byteRingFree(&s->port.txRing);
 
     if (s->txDMAStream) {
-        /*
-         * When we queue up a DMA request, we advance the Tx buffer tail before the transfer finishes, so we must add
-         * the remaining size of that in-progress transfer here instead:
-         */
-        bytesUsed += __HAL_DMA_GET_COUNTER(s->Handle.hdmatx);
-
-        /*
-         * If the Tx buffer is being written to very quickly, we might have advanced the head into the buffer
-         * space occupied by the current DMA transfer. In that case the "bytesUsed" total will actually end up larger
-         * than the total Tx buffer size, because we'll end up transmitting the same buffer region twice. (So we'll be
-         * transmitting a garbage mixture of old and new bytes).
-         *
-         * Be kind to callers and pretend like our buffer can only ever be 100% full.
-         */
-        if (bytesUsed >= s->port.txBufferSize - 1) {
-            return 0;
-        }
+        // The Tx buffer tail is advanced when a DMA transfer is queued, the bytes that transfer has still to send are not free yet
+        const uint32_t bytesInTransfer = __HAL_DMA_GET_COUNTER(s->Handle.hdmatx);
+        return bytesFree > bytesInTransfer ? bytesFree - bytesInTransfer : 0;
     }
 
-    return (s->port.txBufferSize - 1) - bytesUsed;
+    return bytesFree;
 }
 
 bool isUartTransmitBufferEmpty(const serialPort_t *instance)
@@ -314,40 +282,28 @@ bool isUartTransmitBufferEmpty(const serialPort_t *instance)
     if (s->txDMAStream)
         return s->txDMAEmpty;
     else
-        return s->port.txBufferTail == s->port.txBufferHead;
+        return byteRingIsEmpty(&s->port.txRing);
 }
 
 uint8_t uartRead(serialPort_t *instance)
 {
-    uint8_t ch;
+    uint8_t ch = 0;
     uartPort_t *s = (uartPort_t *)instance;
 
     if (s->rxDMAStream) {
-        ch = s->port.rxBuffer[s->port.rxBufferSize - s->rxDMAPos];
+        const uint32_t rxBufferSize = byteRingSize(&s->port.rxRing);
+        ch = s->port.rxRing.buffer[rxBufferSize - s->rxDMAPos];
         if (--s->rxDMAPos == 0)
-            s->rxDMAPos = s->port.rxBufferSize;
+            s->rxDMAPos = rxBufferSize;
     } else {
-        ch = s->port.rxBuffer[s->port.rxBufferTail];
-        if (s->port.rxBufferTail + 1 >= s->port.rxBufferSize) {
-            s->port.rxBufferTail = 0;
-        } else {
-            s->port.rxBufferTail++;
-        }
+        byteRingPop(&s->port.rxRing, &ch);
     }
 
     return ch;
 }
 
-void uartWrite(serialPort_t *instance, uint8_t ch)
+static void uartStartTx(uartPort_t *s)
 {
-    uartPort_t *s = (uartPort_t *)instance;
-    s->port.txBuffer[s->port.txBufferHead] = ch;
-    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
-        s->port.txBufferHead = 0;
-    } else {
-        s->port.txBufferHead++;
-    }
-
     if (s->txDMAStream) {
         if (!(s->txDMAStream->CR & 1))
             uartStartTxDMA(s);
@@ -356,6 +312,34 @@ void uartWrite(serialPort_t *instance, uint8_t ch)
     }
 }
 
+void uartWrite(serialPort_t *instance, uint8_t ch)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+    // dropped if the buffer is full, rather than overwriting what is still to be sent
+    byteRingPush(&s->port.txRing, ch);
+
+    uartStartTx(s);
+}
+
+static void uartWriteBuf(serialPort_t *instance, const void *data, int count)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+    const uint8_t *p = data;
+
+    while (count > 0) {
+        // Block while the buffer is full, as the byte-wise fallback in serialWriteBuf() does
+        uint32_t chunk;
+        while ((chunk = uartTotalTxBytesFree(instance)) == 0) {
+        };
+
+        chunk = byteRingPushBulk(&s->port.txRing, p, MIN(chunk, (uint32_t)count));
+        p += chunk;
+        count -= chunk;
+
+        uartStartTx(s);
+    }
+}
+
 const struct serialPortVTable uartVTable[] = {
     {
         .serialWrite = uartWrite,
@@ -367,9 +351,11 @@ const struct serialPortVTable uartVTable[] = {
         .setMode = uartSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
-        .writeBuf = NULL,
+        .writeBuf = uartWriteBuf,
         .beginWrite = NULL,
         .endWrite = NULL,
+        .peekContiguous = NULL,
+        .skip = NULL,
     }
 };
 
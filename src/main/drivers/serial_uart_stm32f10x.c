@@ -132,10 +132,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 
     s->port.baudRate = baudRate;
 
-    s->port.rxBuffer = uartdev->rxBuffer;
-    s->port.txBuffer = uartdev->txBuffer;
-    s->port.rxBufferSize = ARRAYLEN(uartdev->rxBuffer);
-    s->port.txBufferSize = ARRAYLEN(uartdev->txBuffer);
+    byteRingInit(&s->port.rxRing, uartdev->rxBuffer, ARRAYLEN(uartdev->rxBuffer));
+    byteRingInit(&s->port.txRing, uartdev->txBuffer, ARRAYLEN(uartdev->txBuffer));
 
     const uartHardware_t *hardware = uartdev->hardware;
 
@@ -198,18 +196,13 @@ void uartIrqHandler(uartPort_t *s)
         if (s->port.rxCallback) {
             s->port.rxCallback(s->USARTx->DR, s->port.rxCallbackData);
         } else {
-            s->port.rxBuffer[s->port.rxBufferHead++] = s->USARTx->DR;
-            if (s->port.rxBufferHead >= s->port.rxBufferSize) {
-                s->port.rxBufferHead = 0;
-            }
+            byteRingPush(&s->port.rxRing, s->USARTx->DR);
         }
     }
     if (SR & USART_FLAG_TXE) {
-        if (s->port.txBufferTail != s->port.txBufferHead) {
-            s->USARTx->DR = s->port.txBuffer[s->port.txBufferTail++];
-            if (s->port.txBufferTail >= s->port.txBufferSize) {
-                s->port.txBufferTail = 0;
-            }
+        uint8_t ch;
+        if (byteRingPop(&s->port.txRing, &ch)) {
+            s->USARTx->DR = ch;
         } else {
             USART_ITConfig(s->USARTx, USART_IT_TXE, DISABLE);
         }
@@ -27,6 +27,8 @@
 
 #include "platform.h"
 
+#include "build/trace.h"
+
 #include "drivers/system.h"
 #include "drivers/dma.h"
 #include "drivers/io.h"
@@ -245,6 +247,8 @@ const uartHardware_t uartHardware[UARTDEV_COUNT] = {
 
 void uartIrqHandler(uartPort_t *s)
 {
+    TRACE_EVENT(TRACE_ISR_ENTER, TRACE_ISR_UART, s->port.identifier);
+
     UART_HandleTypeDef *huart = &s->Handle;
     /* UART in mode Receiver ---------------------------------------------------*/
     if ((__HAL_UART_GET_IT(huart, UART_IT_RXNE) != RESET)) {
@@ -253,8 +257,7 @@ void uartIrqHandler(uartPort_t *s)
         if (s->port.rxCallback) {
             s->port.rxCallback(rbyte, s->port.rxCallbackData);
         } else {
-            s->port.rxBuffer[s->port.rxBufferHead] = rbyte;
-            s->port.rxBufferHead = (s->port.rxBufferHead + 1) % s->port.rxBufferSize;
+            byteRingPush(&s->port.rxRing, rbyte);
         }
         CLEAR_BIT(huart->Instance->CR1, (USART_CR1_PEIE));
 
@@ -288,17 +291,17 @@ void uartIrqHandler(uartPort_t *s)
     if (!s->txDMAStream && (__HAL_UART_GET_IT(huart, UART_IT_TXE) != RESET)) {
         /* Check that a Tx process is ongoing */
         if (huart->gState != HAL_UART_STATE_BUSY_TX) {
-            if (s->port.txBufferTail == s->port.txBufferHead) {
+            uint8_t ch;
+            if (!byteRingPop(&s->port.txRing, &ch)) {
                 huart->TxXferCount = 0;
                 /* Disable the UART Transmit Data Register Empty Interrupt */
                 CLEAR_BIT(huart->Instance->CR1, USART_CR1_TXEIE);
             } else {
                 if ((huart->Init.WordLength == UART_WORDLENGTH_9B) && (huart->Init.Parity == UART_PARITY_NONE)) {
-                    huart->Instance->TDR = (((uint16_t) s->port.txBuffer[s->port.txBufferTail]) & (uint16_t) 0x01FFU);
+                    huart->Instance->TDR = (((uint16_t) ch) & (uint16_t) 0x01FFU);
                 } else {
-                    huart->Instance->TDR = (uint8_t)(s->port.txBuffer[s->port.txBufferTail]);
+                    huart->Instance->TDR = ch;
                 }
-                s->port.txBufferTail = (s->port.txBufferTail + 1) % s->port.txBufferSize;
             }
         }
     }
@@ -310,11 +313,13 @@ void uartIrqHandler(uartPort_t *s)
             handleUsartTxDma(s);
         }
     }
+
+    TRACE_EVENT(TRACE_ISR_EXIT, TRACE_ISR_UART, s->port.identifier);
 }
 
 static void handleUsartTxDma(uartPort_t *s)
 {
-    if (s->port.txBufferHead != s->port.txBufferTail)
+    if (!byteRingIsEmpty(&s->port.txRing))
         uartStartTxDMA(s);
     else
     {
@@ -343,10 +348,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 
     s->port.baudRate = baudRate;
 
-    s->port.rxBuffer = uartdev->rxBuffer;
-    s->port.txBuffer = uartdev->txBuffer;
-    s->port.rxBufferSize = ARRAYLEN(uartdev->rxBuffer);
-    s->port.txBufferSize = ARRAYLEN(uartdev->txBuffer);
+    byteRingInit(&s->port.rxRing, uartdev->rxBuffer, ARRAYLEN(uartdev->rxBuffer));
+    byteRingInit(&s->port.txRing, uartdev->txBuffer, ARRAYLEN(uartdev->txBuffer));
 
     const uartHardware_t *hardware = uartdev->hardware;
 
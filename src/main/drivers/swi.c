@@ -0,0 +1,67 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_SWI
+
+#include "drivers/nvic.h"
+#include "drivers/swi.h"
+
+// The FLASH interrupt is not used by the firmware, so it is borrowed as software interrupt.
+// It is only ever set pending from software.
+#define SWI_IRQn        FLASH_IRQn
+
+static swiCallbackFn *swiCallback;
+
+void swiInit(swiCallbackFn *fn, int irqPriority)
+{
+    swiCallback = fn;
+
+#if defined(USE_HAL_DRIVER)
+    HAL_NVIC_SetPriority(SWI_IRQn, NVIC_PRIORITY_BASE(irqPriority), NVIC_PRIORITY_SUB(irqPriority));
+    HAL_NVIC_EnableIRQ(SWI_IRQn);
+#else
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    NVIC_InitStructure.NVIC_IRQChannel = SWI_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(irqPriority);
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = NVIC_PRIORITY_SUB(irqPriority);
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+#endif
+}
+
+FAST_CODE void swiTrigger(void)
+{
+    NVIC_SetPendingIRQ(SWI_IRQn);
+}
+
+FAST_CODE void FLASH_IRQHandler(void)
+{
+    if (swiCallback) {
+        swiCallback();
+    }
+}
+
+#endif // USE_SWI
@@ -27,15 +27,21 @@
 
 #include "drivers/light_led.h"
 #include "drivers/nvic.h"
+#include "drivers/serial_tx_paced.h"
 #include "drivers/sound_beeper.h"
+#include "drivers/time.h"
 
 #include "system.h"
 
 // cycles per microsecond
 static uint32_t usTicks = 0;
+// microseconds and nanoseconds per cycle in fixed point, rounded up so that whole microseconds come out exact
+static uint32_t cyclesToUsQ32 = 0;
+static uint32_t cyclesToNsQ16 = 0;
 // current uptime for 1kHz systick timer. will rollover after 49 days. hopefully we won't care.
 static volatile uint32_t sysTickUptime = 0;
-static volatile uint32_t sysTickValStamp = 0;
+// DWT cycle count at the SysTick reload that started the current millisecond
+static volatile uint32_t sysTickCycleCount = 0;
 // cached value of RCC->CSR
 uint32_t cachedRccCsrValue;
 
@@ -48,71 +54,84 @@ void cycleCounterInit(void)
     RCC_GetClocksFreq(&clocks);
     usTicks = clocks.SYSCLK_Frequency / 1000000;
 #endif
+    cyclesToUsQ32 = ((1ULL << 32) + usTicks - 1) / usTicks;
+    cyclesToNsQ16 = ((1000ULL << 16) + usTicks - 1) / usTicks;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#ifdef STM32F7
+    // the F7 DWT registers are write protected until unlocked
+    DWT->LAR = 0xC5ACCE55;
+#endif
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 // SysTick
 
-static volatile int sysTickPending = 0;
-
 void SysTick_Handler(void)
 {
     ATOMIC_BLOCK(NVIC_PRIO_MAX) {
         sysTickUptime++;
-        sysTickValStamp = SysTick->VAL;
-        sysTickPending = 0;
+        // Both count the core clock, so this is the cycle count at the reload however late the handler runs
+        sysTickCycleCount = DWT->CYCCNT - (SysTick->LOAD - SysTick->VAL);
         (void)(SysTick->CTRL);
     }
+#ifdef USE_SERIAL_TX_PACED
+    serialTxPacedTick();
+#endif
 #ifdef USE_HAL_DRIVER
     // used by the HAL for some timekeeping and timeouts, should always be 1ms
     HAL_IncTick();
 #endif
 }
 
-// Return system uptime in microseconds (rollover in 70minutes)
-
-uint32_t microsISR(void)
+// The cycles since the last reload are counted even while the SysTick interrupt waits, so the uptime read from the
+// cycle counter is valid in any context
+static uint32_t cyclesSinceSysTick(uint32_t *ms)
 {
-    register uint32_t ms, pending, cycle_cnt;
+    uint32_t cycleCount;
 
-    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
-        cycle_cnt = SysTick->VAL;
-
-        if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) {
-            // Update pending.
-            // Record it for multiple calls within the same rollover period
-            // (Will be cleared when serviced).
-            // Note that multiple rollovers are not considered.
-
-            sysTickPending = 1;
-
-            // Read VAL again to ensure the value is read after the rollover.
+    do {
+        *ms = sysTickUptime;
+        cycleCount = sysTickCycleCount;
+    } while (*ms != sysTickUptime);
 
-            cycle_cnt = SysTick->VAL;
-        }
+    return DWT->CYCCNT - cycleCount;
+}
 
-        ms = sysTickUptime;
-        pending = sysTickPending;
-    }
+// Return system uptime in microseconds (rollover in 70minutes)
+uint32_t micros(void)
+{
+    uint32_t ms;
+    const uint32_t cycles = cyclesSinceSysTick(&ms);
 
-    return ((ms + pending) * 1000) + (usTicks * 1000 - cycle_cnt) / usTicks;
+    return ms * 1000 + (uint32_t)(((uint64_t)cycles * cyclesToUsQ32) >> 32);
 }
 
-uint32_t micros(void)
+// micros() is valid in interrupts too
+uint32_t microsISR(void)
 {
-    register uint32_t ms, cycle_cnt;
+    return micros();
+}
 
-    // Call microsISR() in interrupt and elevated (non-zero) BASEPRI context
+// Return system uptime in nanoseconds (rollover in 4 seconds), for timing short sections of code
+uint32_t nanos(void)
+{
+    uint32_t ms;
+    const uint32_t cycles = cyclesSinceSysTick(&ms);
 
-    if ((SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) || (__get_BASEPRI())) {
-        return microsISR();
-    }
+    return ms * 1000000 + (uint32_t)(((uint64_t)cycles * cyclesToNsQ16) >> 16);
+}
 
-    do {
-        ms = sysTickUptime;
-        cycle_cnt = SysTick->VAL;
-    } while (ms != sysTickUptime || cycle_cnt > sysTickValStamp);
+// Return the free running DWT cycle counter (rollover in 20 seconds at 216MHz)
+uint32_t ticks(void)
+{
+    return DWT->CYCCNT;
+}
 
-    return (ms * 1000) + (usTicks * 1000 - cycle_cnt) / usTicks;
+timeDelta_t ticks_diff_us(uint32_t begin, uint32_t end)
+{
+    return ((uint64_t)(end - begin) * cyclesToUsQ32) >> 32;
 }
 
 // Return system uptime in milliseconds (rollover in 49 days)
@@ -30,6 +30,16 @@ void delay(timeMs_t ms);
 timeUs_t micros(void);
 timeUs_t microsISR(void);
 timeMs_t millis(void);
+uint32_t nanos(void);
+
+// Waits until the system has been up for the given time, for the power up time of devices probed at boot
+static inline void delayUntilUptimeMs(timeMs_t uptimeMs)
+{
+    const timeMs_t now = millis();
+    if (now < uptimeMs) {
+        delay(uptimeMs - now);
+    }
+}
 
 uint32_t ticks(void);
 timeDelta_t ticks_diff_us(uint32_t begin, uint32_t end);
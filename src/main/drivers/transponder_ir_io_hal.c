@@ -48,7 +48,7 @@ static uint16_t timerChannel = 0;
 #error "Transponder (via HAL) not supported on this MCU."
 #endif
 
-transponder_t transponder;
+DMA_RAM_ZERO_INIT transponder_t transponder;
 bool transponderInitialised = false;
 
 static void TRANSPONDER_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor)
@@ -72,6 +72,10 @@ void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder)
         return;
     }
 
+    if (!dmaAllocate(timerHardware->dmaIrqHandler, OWNER_TRANSPONDER, 0)) {
+        return;
+    }
+
     /* Time base configuration */
 
     TimHandle.Instance = timer;
@@ -108,7 +112,8 @@ void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder)
     hdma_tim.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
     hdma_tim.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
     hdma_tim.Init.Mode = DMA_NORMAL;
-    hdma_tim.Init.Priority = DMA_PRIORITY_HIGH;
+    // the motor streams win the arbitration of the DMA controller, a compare value only has to land within a carrier period
+    hdma_tim.Init.Priority = DMA_PRIORITY_LOW;
     hdma_tim.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
     hdma_tim.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
     hdma_tim.Init.MemBurst = DMA_MBURST_SINGLE;
@@ -122,7 +127,6 @@ void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder)
     /* Link hdma_tim to hdma[x] (channelx) */
     __HAL_LINKDMA(&TimHandle, hdma[dmaIndex], hdma_tim);
 
-    dmaInit(timerHardware->dmaIrqHandler, OWNER_TRANSPONDER, 0);
     dmaSetHandler(timerHardware->dmaIrqHandler, TRANSPONDER_DMA_IRQHandler, NVIC_PRIO_TRANSPONDER_DMA, dmaIndex);
 
     /* Initialize TIMx DMA handle */
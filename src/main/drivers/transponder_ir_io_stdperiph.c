@@ -50,6 +50,11 @@ static DMA_Stream_TypeDef *dmaRef = NULL;
 #error "Transponder not supported on this MCU."
 #endif
 
+static uint16_t timerDmaRequest;
+static dmaIdentifier_e dmaIdentifier = DMA_NONE;
+// kept to reconfigure the stream after another shared owner used it
+static DMA_InitTypeDef dmaInitStructure;
+
 transponder_t transponder;
 
 static void TRANSPONDER_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor)
@@ -58,10 +63,21 @@ static void TRANSPONDER_DMA_IRQHandler(dmaChannelDescriptor_t* descriptor)
         transponderIrDataTransferInProgress = 0;
 
         DMA_Cmd(descriptor->ref, DISABLE);
+        TIM_DMACmd(timer, timerDmaRequest, DISABLE);
         DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+        dmaRelease(dmaIdentifier);
     }
 }
 
+static void transponderIrDMAConfigure(void)
+{
+    DMA_Cmd(dmaRef, DISABLE);
+    DMA_DeInit(dmaRef);
+    DMA_Init(dmaRef, &dmaInitStructure);
+    DMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
+    dmaSetHandler(dmaIdentifier, TRANSPONDER_DMA_IRQHandler, NVIC_PRIO_TRANSPONDER_DMA, 0);
+}
+
 void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder)
 {
     if (!ioTag) {
@@ -79,13 +95,16 @@ void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder)
         return;
     }
 
+    // a stream in use by e.g. a motor is left alone, the transponder stays silent
+    if (!dmaAllocateShared(timerHardware->dmaIrqHandler, OWNER_TRANSPONDER)) {
+        return;
+    }
+    dmaIdentifier = timerHardware->dmaIrqHandler;
+
     transponderIO = IOGetByTag(ioTag);
     IOInit(transponderIO, OWNER_TRANSPONDER, 0);
     IOConfigGPIOAF(transponderIO, IO_CONFIG(GPIO_Mode_AF, GPIO_Speed_50MHz, GPIO_OType_PP, GPIO_PuPd_DOWN), timerHardware->alternateFunction);
 
-    dmaInit(timerHardware->dmaIrqHandler, OWNER_TRANSPONDER, 0);
-    dmaSetHandler(timerHardware->dmaIrqHandler, TRANSPONDER_DMA_IRQHandler, NVIC_PRIO_TRANSPONDER_DMA, 0);
-
     RCC_ClockCmd(timerRCC(timer), ENABLE);
 
     uint16_t prescaler = timerGetPrescalerByDesiredMhz(timer, transponder->timer_hz);
@@ -120,8 +139,7 @@ void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder)
 
     /* configure DMA */
     dmaRef = timerHardware->dmaRef;
-    DMA_Cmd(dmaRef, DISABLE);
-    DMA_DeInit(dmaRef);
+    timerDmaRequest = timerDmaSource(timerHardware->channel);
 
     DMA_StructInit(&DMA_InitStructure);
     DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)timerCCR(timer, timerHardware->channel);
@@ -146,13 +164,14 @@ void transponderIrHardwareInit(ioTag_t ioTag, transponder_t *transponder)
     DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
 #endif
     DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
-    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
-
-    DMA_Init(dmaRef, &DMA_InitStructure);
+    // the motor streams win the arbitration of the DMA controller, a compare value only has to land within a carrier period
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+    dmaInitStructure = DMA_InitStructure;
 
-    TIM_DMACmd(timer, timerDmaSource(timerHardware->channel), ENABLE);
-
-    DMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
+    // on a shared stream another owner may hold the configuration, it is then set on the first transfer
+    if (dmaGetOwner(dmaIdentifier) == OWNER_TRANSPONDER) {
+        transponderIrDMAConfigure();
+    }
 }
 
 bool transponderIrInit(const ioTag_t ioTag, const transponderProvider_e provider)
@@ -204,6 +223,17 @@ void transponderIrUpdateData(const uint8_t* transponderData)
 
 void transponderIrDMAEnable(transponder_t *transponder)
 {
+    const bool reconfigure = dmaGetOwner(dmaIdentifier) != OWNER_TRANSPONDER;
+    if (dmaIdentifier == DMA_NONE || !dmaAcquire(dmaIdentifier, OWNER_TRANSPONDER)) {
+        // the frame is skipped, transponders repeat it continuously
+        transponderIrDataTransferInProgress = 0;
+        return;
+    }
+    if (reconfigure) {
+        transponderIrDMAConfigure();
+    }
+
+    TIM_DMACmd(timer, timerDmaRequest, ENABLE);
     DMA_SetCurrDataCounter(dmaRef, transponder->dma_buffer_size);  // load number of bytes to be transferred
     TIM_SetCounter(timer, 0);
     TIM_Cmd(timer, ENABLE);
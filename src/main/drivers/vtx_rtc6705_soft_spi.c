@@ -20,6 +20,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -31,6 +32,8 @@
 #include "drivers/time.h"
 #include "drivers/vtx_rtc6705.h"
 
+#include "fc/fc_dispatch.h"
+
 #define DP_5G_MASK                  0x7000
 #define PA5G_BS_MASK                0x0E00
 #define PA5G_PW_MASK                0x0180
@@ -85,43 +88,87 @@ void rtc6705IOInit(void)
     DISABLE_RTC6705;
     IOInit(rtc6705CsnPin, OWNER_SPI_CS, RESOURCE_SOFT_OFFSET);
     IOConfigGPIO(rtc6705CsnPin, IOCFG_OUT_PP);
+
+    // the register writes are clocked out from the dispatch queue
+    dispatchEnable();
 }
 
-static void rtc6705_write_register(uint8_t addr, uint32_t data)
+// The register writes are bit-banged from the dispatch queue, one clock edge per step, so the
+// millisecond clock phases do not block the main loop. A write waiting for an earlier one to
+// finish is replaced by a later write to the same register.
+#define RTC6705_WRITE_BIT_COUNT         25      // 4 address bits, the write bit and 20 data bits, LSB first
+#define RTC6705_WRITE_QUEUE_SIZE        4
+#define RTC6705_CLOCK_PHASE_US          1000
+
+static uint32_t writeQueue[RTC6705_WRITE_QUEUE_SIZE];
+static uint8_t writeQueueCount;
+static uint32_t writeWord;
+static int writeStep;                   // -1 before the chip select, then two clock edges per bit
+static bool writeInProgress;
+
+static void rtc6705WriteStep(dispatchEntry_t *self);
+
+static dispatchEntry_t rtc6705WriteDispatch = {
+    .dispatch = rtc6705WriteStep
+};
+
+static void rtc6705StartNextWrite(int delayUs)
+{
+    writeWord = writeQueue[0];
+    writeQueueCount--;
+    memmove(&writeQueue[0], &writeQueue[1], writeQueueCount * sizeof(writeQueue[0]));
+    writeStep = -1;
+    writeInProgress = true;
+    dispatchAdd(&rtc6705WriteDispatch, delayUs);
+}
+
+static void rtc6705WriteStep(dispatchEntry_t *self)
 {
-    ENABLE_RTC6705;
-    delay(1);
-    // send address
-    for (int i = 0; i < 4; i++) {
-        if ((addr >> i) & 1) {
-            RTC6705_SPIDATA_ON;
+    if (writeStep < 0) {
+        ENABLE_RTC6705;
+    } else if (writeStep < 2 * RTC6705_WRITE_BIT_COUNT) {
+        if (writeStep & 1) {
+            RTC6705_SPICLK_OFF;
         } else {
-            RTC6705_SPIDATA_OFF;
+            if ((writeWord >> (writeStep / 2)) & 1) {
+                RTC6705_SPIDATA_ON;
+            } else {
+                RTC6705_SPIDATA_OFF;
+            }
+            RTC6705_SPICLK_ON;
         }
-
-        RTC6705_SPICLK_ON;
-        delay(1);
-        RTC6705_SPICLK_OFF;
-        delay(1);
-    }
-    // Write bit
-    RTC6705_SPIDATA_ON;
-    RTC6705_SPICLK_ON;
-    delay(1);
-    RTC6705_SPICLK_OFF;
-    delay(1);
-    for (int i = 0; i < 20; i++) {
-        if ((data >> i) & 1) {
-            RTC6705_SPIDATA_ON;
+    } else {
+        DISABLE_RTC6705;
+        if (writeQueueCount) {
+            rtc6705StartNextWrite(RTC6705_CLOCK_PHASE_US);
         } else {
-            RTC6705_SPIDATA_OFF;
+            writeInProgress = false;
         }
-        RTC6705_SPICLK_ON;
-        delay(1);
-        RTC6705_SPICLK_OFF;
-        delay(1);
+        return;
+    }
+
+    writeStep++;
+    dispatchAdd(self, RTC6705_CLOCK_PHASE_US);
+}
+
+static void rtc6705_write_register(uint8_t addr, uint32_t data)
+{
+    const uint32_t word = (addr & 0x0F) | (1 << 4) | ((data & 0xFFFFF) << 5);
+
+    bool queued = false;
+    for (int i = 0; i < writeQueueCount; i++) {
+        if ((writeQueue[i] & 0x0F) == (addr & 0x0F)) {
+            writeQueue[i] = word;
+            queued = true;
+        }
+    }
+    if (!queued && writeQueueCount < RTC6705_WRITE_QUEUE_SIZE) {
+        writeQueue[writeQueueCount++] = word;
+    }
+
+    if (!writeInProgress && writeQueueCount) {
+        rtc6705StartNextWrite(0);
     }
-    DISABLE_RTC6705;
 }
 
 void rtc6705SetFrequency(uint16_t channel_freq)
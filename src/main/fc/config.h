@@ -41,6 +41,7 @@ typedef struct systemConfig_s {
     uint8_t rateProfile6PosSwitch;
     uint8_t cpu_overclock;
     uint8_t powerOnArmingGraceTime; // in seconds
+    uint8_t task_governor_load;     // system load in percent above which background tasks are slowed down, 0 = off
     char boardIdentifier[sizeof(TARGET_BOARD_IDENTIFIER) + 1];
 } systemConfig_t;
 
@@ -0,0 +1,145 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Setpoints from a companion computer over MSP, flown by the next PID loop instead of the sticks.
+ *
+ * The setpoints skip the RX task, its frame status polling and the RC smoothing. The MSP handler publishes
+ * each one with the time it was received and the PID loop takes the latest once the RC commands are processed,
+ * so the latency is the wait for the next PID loop. They are flown while the DIRECT SETPOINT mode is active.
+ * A setpoint older than the timeout is dropped, then the sticks take over, or the failsafe procedure starts
+ * when it is configured and setpoints had been flown.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_DIRECT_SETPOINT
+
+#include "common/maths.h"
+
+#include "fc/direct_setpoint.h"
+#include "fc/rc_modes.h"
+
+#include "flight/failsafe.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+PG_REGISTER_WITH_RESET_TEMPLATE(directSetpointConfig_t, directSetpointConfig, PG_DIRECT_SETPOINT_CONFIG, 0);
+
+PG_RESET_TEMPLATE(directSetpointConfig_t, directSetpointConfig,
+    .direct_setpoint_timeout_ms = 100,
+    .direct_setpoint_failsafe = false,
+);
+
+TOPIC_DEFINE(directSetpoint, directSetpoint_t);
+
+static topicSubscriber_t directSetpointSubscriber;
+static directSetpoint_t directSetpointLatest;
+static bool directSetpointLatestFlown;
+static directSetpointStats_t directSetpointStats;
+static bool directSetpointActive;       // the last PID loop flew a setpoint
+static bool directSetpointEngaged;      // setpoints were flown since the mode was switched on
+static bool directSetpointTimedOut;
+
+// Called by the MSP handler
+bool directSetpointReceive(const directSetpoint_t *setpoint, timeUs_t currentTimeUs)
+{
+    if (setpoint->mode >= DIRECT_SETPOINT_MODE_COUNT) {
+        return false;
+    }
+    directSetpointPublish(setpoint, currentTimeUs);
+    directSetpointStats.received++;
+    return true;
+}
+
+// Called by the PID loop once the RC commands are processed, gives the setpoint to fly instead of the sticks
+FAST_CODE bool directSetpointUpdate(directSetpoint_t *setpoint, timeUs_t currentTimeUs)
+{
+    directSetpointActive = false;
+    if (!IS_RC_MODE_ACTIVE(BOXDIRECTSETPOINT)) {
+        directSetpointEngaged = false;
+        directSetpointTimedOut = false;
+        return false;
+    }
+
+    if (directSetpointRead(&directSetpointLatest, &directSetpointSubscriber) == TOPIC_READ_NEW) {
+        directSetpointLatestFlown = false;
+    }
+    if (directSetpointSubscriber.sequence == 0) {
+        // nothing received yet
+        return false;
+    }
+
+    const timeDelta_t ageUs = cmpTimeUs(currentTimeUs, directSetpointSubscriber.timestamp);
+    if (ageUs > directSetpointConfig()->direct_setpoint_timeout_ms * 1000) {
+        if (directSetpointEngaged && !directSetpointTimedOut) {
+            directSetpointStats.timeouts++;
+        }
+        directSetpointTimedOut = true;
+        return false;
+    }
+    directSetpointTimedOut = false;
+
+    if (failsafeIsActive()) {
+        // the failsafe procedure flies the craft until it has recovered
+        return false;
+    }
+
+    if (!directSetpointLatestFlown) {
+        directSetpointLatestFlown = true;
+        directSetpointStats.flown++;
+        directSetpointStats.lastSenderTimeUs = directSetpointLatest.senderTimeUs;
+        directSetpointStats.latencyLastUs = ageUs;
+        directSetpointStats.latencyMaxUs = MAX(directSetpointStats.latencyMaxUs, ageUs);
+        directSetpointStats.latencyTotalUs += ageUs;
+    }
+
+    *setpoint = directSetpointLatest;
+    directSetpointActive = true;
+    directSetpointEngaged = true;
+    return true;
+}
+
+bool directSetpointIsActive(void)
+{
+    return directSetpointActive;
+}
+
+// Checked by the failsafe, the setpoints stopped after they had been flown
+bool directSetpointFailsafeRequested(void)
+{
+    return directSetpointConfig()->direct_setpoint_failsafe && directSetpointEngaged && directSetpointTimedOut;
+}
+
+const directSetpointStats_t *directSetpointGetStats(void)
+{
+    return &directSetpointStats;
+}
+
+timeDelta_t directSetpointLatencyAverageUs(void)
+{
+    return directSetpointStats.flown ? directSetpointStats.latencyTotalUs / directSetpointStats.flown : 0;
+}
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+#include "common/topic.h"
+
+#include "pg/pg.h"
+
+typedef enum {
+    DIRECT_SETPOINT_RATE = 0,           // roll, pitch and yaw rates in deg/s
+    DIRECT_SETPOINT_ATTITUDE,           // roll and pitch angles in 0.1 degree for the angle modes, yaw rate in deg/s
+    DIRECT_SETPOINT_MODE_COUNT
+} directSetpointMode_e;
+
+typedef struct directSetpointConfig_s {
+    uint16_t direct_setpoint_timeout_ms;    // setpoints older than this are no longer flown
+    uint8_t direct_setpoint_failsafe;       // off: the sticks take over after a timeout, on: the failsafe procedure starts
+} directSetpointConfig_t;
+
+PG_DECLARE(directSetpointConfig_t, directSetpointConfig);
+
+typedef struct directSetpoint_s {
+    uint32_t senderTimeUs;              // clock of the sender, echoed back with the latency of the setpoint flown
+    uint8_t mode;                       // directSetpointMode_e
+    int16_t axis[3];                    // roll, pitch and yaw
+    uint16_t throttle;                  // 1000 to 2000
+} directSetpoint_t;
+
+TOPIC_DECLARE(directSetpoint, directSetpoint_t);
+
+typedef struct directSetpointStats_s {
+    uint32_t received;
+    uint32_t flown;                     // setpoints taken by a PID loop
+    uint32_t timeouts;
+    uint32_t lastSenderTimeUs;          // of the last setpoint flown
+    timeDelta_t latencyLastUs;          // from the setpoint received to the PID loop flying it
+    timeDelta_t latencyMaxUs;
+    uint64_t latencyTotalUs;
+} directSetpointStats_t;
+
+bool directSetpointReceive(const directSetpoint_t *setpoint, timeUs_t currentTimeUs);
+bool directSetpointUpdate(directSetpoint_t *setpoint, timeUs_t currentTimeUs);
+bool directSetpointIsActive(void);
+bool directSetpointFailsafeRequested(void);
+const directSetpointStats_t *directSetpointGetStats(void);
+timeDelta_t directSetpointLatencyAverageUs(void);
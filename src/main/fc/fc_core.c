@@ -26,6 +26,8 @@
 #include "platform.h"
 
 #include "build/debug.h"
+#include "build/debug_capture.h"
+#include "build/profile.h"
 
 #include "blackbox/blackbox.h"
 
@@ -56,6 +58,8 @@
 #include "fc/controlrate_profile.h"
 #include "fc/fc_core.h"
 #include "fc/fc_rc.h"
+#include "fc/flight_summary.h"
+#include "fc/perf_report.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
@@ -76,6 +80,7 @@
 #include "io/vtx_rtc6705.h"
 
 #include "rx/rx.h"
+#include "rx/rx_latency.h"
 
 #include "scheduler/scheduler.h"
 
@@ -101,6 +106,11 @@ enum {
 
 #define GYRO_WATCHDOG_DELAY 80 //  delay for gyro sync
 
+#ifdef USE_GYRO_ODR_TRACKING
+#define GYRO_LOOP_DATA_READY_DELAY_US           20    // from the data ready interrupt to the gyro loop, covers the DMA read it may start
+#define PID_MEASURED_LOOPTIME_UPDATE_INTERVAL   1000  // gyro loops between updates of the PID loop time from the measured gyro rate
+#endif
+
 #ifdef USE_RUNAWAY_TAKEOFF
 #define RUNAWAY_TAKEOFF_PIDSUM_THRESHOLD         600   // The pidSum threshold required to trigger - corresponds to a pidSum value of 60% (raw 600) in the blackbox viewer
 #define RUNAWAY_TAKEOFF_ACTIVATE_DELAY           75000 // (75ms) Time in microseconds where pidSum is above threshold to trigger
@@ -123,7 +133,7 @@ enum {
 int16_t magHold;
 #endif
 
-static bool flipOverAfterCrashMode = false;
+static FAST_RAM_ZERO_INIT bool flipOverAfterCrashMode = false;
 
 static uint32_t disarmAt;     // Time of automatic disarm when "Don't spin the motors when armed" is enabled and auto_disarm_delay is nonzero
 
@@ -223,12 +233,6 @@ void updateArmingStatus(void)
             unsetArmingDisabled(ARMING_DISABLED_ANGLE);
         }
 
-        if (averageSystemLoadPercent > 100) {
-            setArmingDisabled(ARMING_DISABLED_LOAD);
-        } else {
-            unsetArmingDisabled(ARMING_DISABLED_LOAD);
-        }
-
         if (isCalibrating()) {
             setArmingDisabled(ARMING_DISABLED_CALIBRATING);
         } else {
@@ -300,6 +304,9 @@ void disarm(void)
     if (ARMING_FLAG(ARMED)) {
         DISABLE_ARMING_FLAG(ARMED);
         lastDisarmTimeUs = micros();
+#ifdef USE_FLIGHT_SUMMARY
+        flightSummaryFinish(lastDisarmTimeUs);
+#endif
 
 #ifdef USE_BLACKBOX
         if (blackboxConfig()->device && blackboxConfig()->mode != BLACKBOX_MODE_ALWAYS_ON) { // Close the log upon disarm except when logging mode is ALWAYS ON
@@ -358,6 +365,12 @@ void tryArm(void)
 
         ENABLE_ARMING_FLAG(ARMED);
         ENABLE_ARMING_FLAG(WAS_EVER_ARMED);
+#ifdef USE_RX_LATENCY_STATISTICS
+        rxLatencyReset();
+#endif
+#ifdef USE_FLIGHT_SUMMARY
+        flightSummaryStart();
+#endif
 
         resetTryingToArm();
 
@@ -446,7 +459,7 @@ static void updateInflightCalibrationState(void)
 void updateMagHold(void)
 {
     if (ABS(rcCommand[YAW]) < 15 && FLIGHT_MODE(MAG_MODE)) {
-        int16_t dif = DECIDEGREES_TO_DEGREES(attitude.values.yaw) - magHold;
+        int16_t dif = DECIDEGREES_TO_DEGREES(getAttitude()->values.yaw) - magHold;
         if (dif <= -180)
             dif += 360;
         if (dif >= +180)
@@ -455,7 +468,7 @@ void updateMagHold(void)
         if (STATE(SMALL_ANGLE))
             rcCommand[YAW] -= dif * currentPidProfile->pid[PID_MAG].P / 30;    // 18 deg
     } else
-        magHold = DECIDEGREES_TO_DEGREES(attitude.values.yaw);
+        magHold = DECIDEGREES_TO_DEGREES(getAttitude()->values.yaw);
 }
 #endif
 
@@ -525,7 +538,7 @@ uint8_t calculateThrottlePercent(void)
     return ret;
 }
 
-static bool airmodeIsActivated;
+static FAST_RAM_ZERO_INIT bool airmodeIsActivated;
 
 bool isAirmodeActivated()
 {
@@ -771,7 +784,7 @@ bool processRx(timeUs_t currentTimeUs)
         if (IS_RC_MODE_ACTIVE(BOXMAG)) {
             if (!FLIGHT_MODE(MAG_MODE)) {
                 ENABLE_FLIGHT_MODE(MAG_MODE);
-                magHold = DECIDEGREES_TO_DEGREES(attitude.values.yaw);
+                magHold = DECIDEGREES_TO_DEGREES(getAttitude()->values.yaw);
             }
         } else {
             DISABLE_FLIGHT_MODE(MAG_MODE);
@@ -848,7 +861,9 @@ static FAST_CODE void subTaskPidController(timeUs_t currentTimeUs)
     uint32_t startTime = 0;
     if (debugMode == DEBUG_PIDLOOP) {startTime = micros();}
     // PID - note this is function pointer set by setPIDController()
+    PROFILE_BEGIN(PROFILE_PID);
     pidController(currentPidProfile, &accelerometerConfig()->accelerometerTrims, currentTimeUs);
+    PROFILE_END(PROFILE_PID);
     DEBUG_SET(DEBUG_PIDLOOP, 1, micros() - startTime);
 
 #ifdef USE_RUNAWAY_TAKEOFF
@@ -944,7 +959,9 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
         startTime = micros();
     }
 
+    PROFILE_BEGIN(PROFILE_MIXER);
     mixTable(currentTimeUs, currentPidProfile->vbatPidCompensation);
+    PROFILE_END(PROFILE_MIXER);
 
 #ifdef USE_SERVOS
     // motor outputs are used as sources for servo mixing, so motors must be calculated using mixTable() before servos.
@@ -955,6 +972,13 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
 
     writeMotors();
 
+#ifdef USE_RX_LATENCY_STATISTICS
+    rxLatencyMotorsUpdated(micros());
+#endif
+#ifdef USE_PERF_REPORT
+    perfReportMotorsUpdated(currentTimeUs);
+#endif
+
     DEBUG_SET(DEBUG_PIDLOOP, 2, micros() - startTime);
 }
 
@@ -980,9 +1004,32 @@ static FAST_CODE_NOINLINE void subTaskRcCommand(timeUs_t currentTimeUs)
 
     processRcCommand();
 
+#ifdef USE_RX_LATENCY_STATISTICS
+    rxLatencyRcCommandUpdated();
+#endif
 }
 
 // Function for loop trigger
+#ifdef USE_GYRO_ODR_TRACKING
+// Keeps the gyro loop in phase with the data ready interrupts of the gyro, whose clock drifts against the MCU clock
+static FAST_CODE void gyroLoopAlign(void)
+{
+    static uint32_t looptimeUpdateCounter = 0;
+
+    // the next loop runs just after the sample it reads is ready, so it neither reads the previous sample again
+    // nor one that has been waiting for most of a loop
+    timeUs_t dataReadyAtUs;
+    if (gyroGetNextLoopDataReadyUs(&dataReadyAtUs)) {
+        schedulerAlignTask(TASK_GYROPID, dataReadyAtUs + GYRO_LOOP_DATA_READY_DELAY_US);
+    }
+
+    if (++looptimeUpdateCounter >= PID_MEASURED_LOOPTIME_UPDATE_INTERVAL) {
+        looptimeUpdateCounter = 0;
+        pidUpdateMeasuredLooptime(gyroGetMeasuredLooptimeUs() * pidConfig()->pid_process_denom);
+    }
+}
+#endif
+
 FAST_CODE void taskMainPidLoop(timeUs_t currentTimeUs)
 {
     static uint32_t pidUpdateCounter = 0;
@@ -991,6 +1038,10 @@ FAST_CODE void taskMainPidLoop(timeUs_t currentTimeUs)
     if (lockMainPID() != 0) return;
 #endif
 
+#ifdef USE_PERF_REPORT
+    perfReportGyroLoop(currentTimeUs);
+#endif
+
     // DEBUG_PIDLOOP, timings for:
     // 0 - gyroUpdate()
     // 1 - subTaskPidController()
@@ -998,18 +1049,31 @@ FAST_CODE void taskMainPidLoop(timeUs_t currentTimeUs)
     // 3 - subTaskPidSubprocesses()
     gyroUpdate(currentTimeUs);
     DEBUG_SET(DEBUG_PIDLOOP, 0, micros() - currentTimeUs);
+#ifdef USE_GYRO_ODR_TRACKING
+    gyroLoopAlign();
+#endif
 
     if (pidUpdateCounter++ % pidConfig()->pid_process_denom == 0) {
         subTaskRcCommand(currentTimeUs);
+#ifdef USE_IMU_FAST_PROPAGATION
+        imuPropagateAttitude(targetPidLooptime);
+#endif
         subTaskPidController(currentTimeUs);
         subTaskMotorUpdate(currentTimeUs);
         subTaskPidSubprocesses(currentTimeUs);
+    } else {
+        mixerOversampleMotors();
     }
 
-    if (debugMode == DEBUG_CYCLETIME) {
-        debug[0] = getTaskDeltaTime(TASK_SELF);
-        debug[1] = averageSystemLoadPercent;
-    }
+    DEBUG_SET(DEBUG_CYCLETIME, 0, getTaskDeltaTime(TASK_GYROPID));
+    DEBUG_SET(DEBUG_CYCLETIME, 1, averageSystemLoadPercent);
+
+#ifdef USE_DEBUG_CAPTURE
+    debugCaptureSample();
+#endif
+#ifdef USE_FLIGHT_SUMMARY
+    flightSummaryUpdate();
+#endif
 }
 
 
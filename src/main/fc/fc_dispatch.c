@@ -30,7 +30,18 @@
 
 #include "fc/fc_dispatch.h"
 
-static dispatchEntry_t *head = NULL;
+#ifdef SIMULATOR_BUILD
+// no interrupts add entries in the simulator
+#define DISPATCH_ATOMIC_BLOCK
+#else
+#include "build/atomic.h"
+
+#include "drivers/nvic.h"
+
+#define DISPATCH_ATOMIC_BLOCK ATOMIC_BLOCK(NVIC_PRIO_MAX)
+#endif
+
+static dispatchEntry_t * volatile head = NULL;
 static bool dispatchEnabled = false;
 
 bool dispatchIsEnabled(void)
@@ -43,25 +54,44 @@ void dispatchEnable(void)
     dispatchEnabled = true;
 }
 
+// Lets TASK_DISPATCH run on the first scheduler pass after an entry is due instead of at a fixed rate
+bool dispatchCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    UNUSED(currentDeltaTimeUs);
+
+    const dispatchEntry_t *first = head;
+    return first && cmp32(currentTimeUs, first->delayedUntil) >= 0;
+}
+
 void dispatchProcess(uint32_t currentTime)
 {
-    for (dispatchEntry_t **p = &head; *p; ) {
-        if (cmp32(currentTime, (*p)->delayedUntil) < 0)
+    for (;;) {
+        dispatchEntry_t *current = NULL;
+        // entries may be added from interrupts, unlink under the lock and run the handler outside it
+        DISPATCH_ATOMIC_BLOCK {
+            if (head && cmp32(currentTime, head->delayedUntil) >= 0) {
+                current = head;
+                head = head->next;
+            }
+        }
+        if (!current) {
             break;
-        // unlink entry first, so handler can replan self
-        dispatchEntry_t *current = *p;
-        *p = (*p)->next;
+        }
+        // entry is unlinked first, so handler can replan self
         (*current->dispatch)(current);
     }
 }
 
+// Safe to call from interrupts, the insertion walks at most the entries already queued
 void dispatchAdd(dispatchEntry_t *entry, int delayUs)
 {
     uint32_t delayedUntil = micros() + delayUs;
     entry->delayedUntil = delayedUntil;
-    dispatchEntry_t **p = &head;
-    while (*p && cmp32((*p)->delayedUntil, delayedUntil) < 0)
-        p = &(*p)->next;
-    entry->next = *p;
-    *p = entry;
+    DISPATCH_ATOMIC_BLOCK {
+        dispatchEntry_t * volatile *p = &head;
+        while (*p && cmp32((*p)->delayedUntil, delayedUntil) <= 0)
+            p = &(*p)->next;
+        entry->next = *p;
+        *p = entry;
+    }
 }
@@ -149,6 +149,7 @@
 
 #include "flight/failsafe.h"
 #include "flight/imu.h"
+#include "flight/idle_control.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/servos.h"
@@ -161,6 +162,7 @@
 
 #include "build/build_config.h"
 #include "build/debug.h"
+#include "build/profile.h"
 
 #ifdef TARGET_PREINIT
 void targetPreInit(void);
@@ -225,6 +227,10 @@ void init(void)
 
     systemInit();
 
+#ifdef USE_PROFILE
+    profileInit();
+#endif
+
     // initialize IO (needed for all IO operations)
     IOInitGlobal();
 
@@ -318,7 +324,8 @@ void init(void)
     OverclockRebootIfNecessary(systemConfig()->cpu_overclock);
 #endif
 
-    delay(100);
+    // let the sensors power up
+    delayUntilUptimeMs(100);
 
     timerInit();  // timer must be initialized before any channel is allocated
 
@@ -491,6 +498,12 @@ void init(void)
     validateAndFixGyroConfig();
     pidInit(currentPidProfile);
     accInitFilters();
+#ifdef USE_DSHOT
+    mixerInitMotorOversample(gyro.targetLooptime);
+#endif
+#ifdef USE_IDLE_CONTROL
+    idleControlInit(motorOutputLow, motorOutputHigh, targetPidLooptime);
+#endif
 
 #ifdef USE_PID_AUDIO
     pidAudioInit();
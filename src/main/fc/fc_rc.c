@@ -35,6 +35,7 @@
 #include "fc/config.h"
 #include "fc/controlrate_profile.h"
 #include "drivers/time.h"
+#include "fc/direct_setpoint.h"
 #include "fc/fc_core.h"
 #include "fc/fc_rc.h"
 #include "fc/rc_controls.h"
@@ -53,10 +54,12 @@
 
 typedef float (applyRatesFn)(const int axis, float rcCommandf, const float rcCommandfAbs);
 
-static float setpointRate[3], rcDeflection[3], rcDeflectionAbs[3];
-static float throttlePIDAttenuation;
-static bool reverseMotors = false;
-static applyRatesFn *applyRates;
+static FAST_RAM_ZERO_INIT float setpointRate[3], rcDeflection[3], rcDeflectionAbs[3];
+static FAST_RAM_ZERO_INIT float throttlePIDAttenuation;
+static FAST_RAM_ZERO_INIT bool reverseMotors = false;
+#ifdef USE_DIRECT_SETPOINT
+static FAST_RAM_ZERO_INIT bool directSetpointApplied;
+#endif
 uint16_t currentRxRefreshRate;
 
 FAST_RAM_ZERO_INIT uint8_t interpolationChannels;
@@ -77,8 +80,11 @@ enum {
 #define RC_SMOOTHING_RX_RATE_CHANGE_PERCENT     20    // Look for samples varying this much from the current detected frame rate to initiate retraining
 #define RC_SMOOTHING_RX_RATE_MIN_US             1000  // 1ms
 #define RC_SMOOTHING_RX_RATE_MAX_US             50000 // 50ms or 20hz
+#define RC_SMOOTHING_PREDICTIVE_AVERAGE_SAMPLES 16    // Frame interval and jitter averages follow 1/16th of each new sample
+#define RC_SMOOTHING_PREDICTIVE_MIN_SAMPLES     8     // Frames to measure before predicting, the raw channel values are used until then
 
 static FAST_RAM_ZERO_INIT rcSmoothingFilter_t rcSmoothingData;
+static FAST_RAM_ZERO_INIT rcSmoothingPredictor_t rcSmoothingPredictor;
 #endif // USE_RC_SMOOTHING_FILTER
 
 float getSetpointRate(int axis)
@@ -114,6 +120,22 @@ static int16_t rcLookupThrottle(int32_t tmp)
 #define SETPOINT_RATE_LIMIT 1998.0f
 #define RC_RATE_INCREMENTAL 14.54f
 
+// The rate curves are odd, so the table holds the rate for the stick deflection from 0 to 1 and the sign is applied
+// after the lookup. The super rate makes the curve steepest at full deflection, where the segments are 1/128 of the
+// stick travel.
+#define RATE_LOOKUP_LENGTH 129
+static float lookupRate[XYZ_AXIS_COUNT][RATE_LOOKUP_LENGTH];    // lookup table for the rate curves, deg/s
+
+static FAST_CODE float rcLookupRate(int axis, float rcCommandf, float rcCommandfAbs)
+{
+    const float position = MIN(rcCommandfAbs, 1.0f) * (RATE_LOOKUP_LENGTH - 1);
+    const int index = MIN((int)position, RATE_LOOKUP_LENGTH - 2);
+    const float fraction = position - index;
+    const float *lookup = lookupRate[axis];
+    const float angleRate = lookup[index] + fraction * (lookup[index + 1] - lookup[index]);
+    return rcCommandf < 0 ? -angleRate : angleRate;
+}
+
 float applyBetaflightRates(const int axis, float rcCommandf, const float rcCommandfAbs)
 {
     if (currentControlRateProfile->rcExpo[axis]) {
@@ -167,13 +189,36 @@ static void calculateSetpointRate(int axis)
         const float rcCommandfAbs = ABS(rcCommandf);
         rcDeflectionAbs[axis] = rcCommandfAbs;
 
-        angleRate = applyRates(axis, rcCommandf, rcCommandfAbs);
+        angleRate = rcLookupRate(axis, rcCommandf, rcCommandfAbs);
     }
     setpointRate[axis] = constrainf(angleRate, -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT); // Rate limit protection (deg/sec)
 
     DEBUG_SET(DEBUG_ANGLERATE, axis, angleRate);
 }
 
+#ifdef USE_DIRECT_SETPOINT
+// Replaces the setpoints and the throttle derived from the sticks
+static FAST_CODE void applyDirectSetpoint(const directSetpoint_t *setpoint)
+{
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        float angleRate;
+        if (setpoint->mode == DIRECT_SETPOINT_ATTITUDE && axis != FD_YAW) {
+            // the angle modes level to the deflection times the angle limit, the rate is for the horizon mode
+            rcDeflection[axis] = constrainf(setpoint->axis[axis] / (10.0f * currentPidProfile->levelAngleLimit), -1.0f, 1.0f);
+            rcDeflectionAbs[axis] = ABS(rcDeflection[axis]);
+            angleRate = rcLookupRate(axis, rcDeflection[axis], rcDeflectionAbs[axis]);
+        } else {
+            // no stick deflection based modifications, as for the GPS rescue
+            rcDeflection[axis] = 0;
+            rcDeflectionAbs[axis] = 0;
+            angleRate = setpoint->axis[axis];
+        }
+        setpointRate[axis] = constrainf(angleRate, -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT);
+    }
+    rcCommand[THROTTLE] = constrain(setpoint->throttle, PWM_RANGE_MIN, PWM_RANGE_MAX);
+}
+#endif
+
 static void scaleRcCommandToFpvCamAngle(void)
 {
     //recalculate sin/cos only when rxConfig()->fpvCamAngleDegrees changed
@@ -183,8 +228,7 @@ static void scaleRcCommandToFpvCamAngle(void)
 
     if (lastFpvCamAngleDegrees != rxConfig()->fpvCamAngleDegrees) {
         lastFpvCamAngleDegrees = rxConfig()->fpvCamAngleDegrees;
-        cosFactor = cos_approx(rxConfig()->fpvCamAngleDegrees * RAD);
-        sinFactor = sin_approx(rxConfig()->fpvCamAngleDegrees * RAD);
+        sincos_approx(rxConfig()->fpvCamAngleDegrees * RAD, &sinFactor, &cosFactor);
     }
 
     float roll = setpointRate[ROLL];
@@ -532,6 +576,125 @@ FAST_CODE uint8_t processRcSmoothingFilter(void)
 
     return interpolationChannels;
 }
+
+// Measures the rx frame interval and its jitter online, so links that change rate (CRSF dynamic rate,
+// Spektrum 11/22ms) need no training phase
+static FAST_CODE_NOINLINE void rcSmoothingPredictorUpdateRate(rcSmoothingPredictor_t *predictor, timeUs_t frameTimeUs)
+{
+    const timeDelta_t frameIntervalUs = cmpTimeUs(frameTimeUs, predictor->frameTimeUs);
+    predictor->frameTimeUs = frameTimeUs;
+
+    if (!rxIsReceivingSignal() || !rcSmoothingRxRateValid(frameIntervalUs)) {
+        // failsafe or a gap in the frames, start measuring again
+        predictor->sampleCount = 0;
+        return;
+    }
+
+    if (predictor->sampleCount == 0) {
+        predictor->frameIntervalUs = frameIntervalUs;
+        predictor->frameJitterUs = 0;
+    } else {
+        const float errorUs = frameIntervalUs - predictor->frameIntervalUs;
+        predictor->frameIntervalUs += errorUs / RC_SMOOTHING_PREDICTIVE_AVERAGE_SAMPLES;
+        predictor->frameJitterUs += (fabsf(errorUs) - predictor->frameJitterUs) / RC_SMOOTHING_PREDICTIVE_AVERAGE_SAMPLES;
+    }
+    if (predictor->sampleCount < RC_SMOOTHING_PREDICTIVE_MIN_SAMPLES) {
+        predictor->sampleCount++;
+    }
+
+    // The filter only has to hide the correction made at each frame, so its time constant is half the
+    // frame interval plus the jitter, and it follows the measured rate
+    const float timeConstantUs = predictor->frameIntervalUs / 2 + predictor->frameJitterUs;
+    const uint16_t inputCutoffFrequency = lrintf(1e6f / (2 * M_PIf * timeConstantUs));
+    if (inputCutoffFrequency != rcSmoothingData.inputCutoffFrequency) {
+        rcSmoothingData.inputCutoffFrequency = inputCutoffFrequency;
+        const float gain = pt1FilterGain(inputCutoffFrequency, targetPidLooptime * 1e-6f);
+        for (int i = 0; i < PRIMARY_CHANNEL_COUNT; i++) {
+            pt1FilterUpdateCutoff(&predictor->filter[i], gain);
+        }
+    }
+
+    // the feedforward derivative filter is only retuned when the rate changes noticeably, as it has to be reinitialised
+    const int averageFrameTimeUs = lrintf(predictor->frameIntervalUs);
+    if (rxConfig()->rc_smoothing_derivative_type != RC_SMOOTHING_DERIVATIVE_OFF && rxConfig()->rc_smoothing_derivative_cutoff == 0
+        && ABS(averageFrameTimeUs - rcSmoothingData.averageFrameTimeUs) * 100 > rcSmoothingData.averageFrameTimeUs * RC_SMOOTHING_RX_RATE_CHANGE_PERCENT) {
+        rcSmoothingData.derivativeCutoffFrequency = calcRcSmoothingCutoff(averageFrameTimeUs, (rxConfig()->rc_smoothing_derivative_type == RC_SMOOTHING_DERIVATIVE_PT1));
+        pidInitSetpointDerivativeLpf(rcSmoothingData.derivativeCutoffFrequency, rxConfig()->rc_smoothing_debug_axis, rxConfig()->rc_smoothing_derivative_type);
+        rcSmoothingData.averageFrameTimeUs = averageFrameTimeUs;
+    } else if (rcSmoothingData.averageFrameTimeUs == 0) {
+        rcSmoothingData.averageFrameTimeUs = averageFrameTimeUs;
+    }
+}
+
+// Extrapolates each channel along the slope of its last two frames, from the receive time of the latest
+// frame, then smooths the result. Compared to interpolation this removes a frame of lag, and the
+// derivative used by feedforward stays constant between frames instead of stepping.
+FAST_CODE uint8_t processRcSmoothingPredictor(void)
+{
+    rcSmoothingPredictor_t *predictor = &rcSmoothingPredictor;
+    static FAST_RAM_ZERO_INIT bool initialized;
+
+    if (!initialized) {
+        initialized = true;
+        if (rxConfig()->rc_smoothing_derivative_type != RC_SMOOTHING_DERIVATIVE_OFF && rxConfig()->rc_smoothing_derivative_cutoff) {
+            rcSmoothingData.derivativeCutoffFrequency = rxConfig()->rc_smoothing_derivative_cutoff;
+            pidInitSetpointDerivativeLpf(rcSmoothingData.derivativeCutoffFrequency, rxConfig()->rc_smoothing_debug_axis, rxConfig()->rc_smoothing_derivative_type);
+        }
+    }
+
+    const timeUs_t currentTimeUs = micros();
+
+    if (isRXDataNew) {
+        // drivers that timestamp their frames give the actual receive time, others the time the rx task ran
+        const timeUs_t frameTimeUs = rxFrameTimeUs() ? rxFrameTimeUs() : currentTimeUs;
+        rcSmoothingPredictorUpdateRate(predictor, frameTimeUs);
+
+        const float frameIntervalUs = predictor->frameIntervalUs;
+        for (int i = 0; i < PRIMARY_CHANNEL_COUNT; i++) {
+            if ((1 << i) & interpolationChannels) {
+                const float rxData = rcCommand[i];
+                predictor->slope[i] = frameIntervalUs > 0 ? (rxData - predictor->lastRxData[i]) / frameIntervalUs : 0;
+                predictor->lastRxData[i] = rxData;
+            }
+        }
+
+        if (debugMode == DEBUG_RC_SMOOTHING_RATE) {
+            DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 0, currentRxRefreshRate);
+            DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 1, predictor->sampleCount);
+            DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 2, lrintf(predictor->frameIntervalUs));
+            DEBUG_SET(DEBUG_RC_SMOOTHING_RATE, 3, lrintf(predictor->frameJitterUs));
+        }
+    }
+
+    const bool predict = predictor->sampleCount >= RC_SMOOTHING_PREDICTIVE_MIN_SAMPLES;
+    // never extrapolate further than one frame, a late frame means the link is stalling rather than the stick moving
+    const float elapsedUs = constrainf(cmpTimeUs(currentTimeUs, predictor->frameTimeUs), 0, predictor->frameIntervalUs);
+
+    for (int i = 0; i < PRIMARY_CHANNEL_COUNT; i++) {
+        if ((1 << i) & interpolationChannels) {
+            if (predict) {
+                float predicted = predictor->lastRxData[i] + predictor->slope[i] * elapsedUs;
+                if (i == THROTTLE) {
+                    predicted = constrainf(predicted, PWM_RANGE_MIN, PWM_RANGE_MAX);
+                } else {
+                    predicted = constrainf(predicted, -500, 500);
+                }
+                rcCommand[i] = pt1FilterApply(&predictor->filter[i], predicted);
+            } else {
+                // not enough frames measured yet, pass the channel through and keep the filter primed
+                rcCommand[i] = predictor->lastRxData[i];
+                predictor->filter[i].state = predictor->lastRxData[i];
+            }
+        }
+    }
+
+    if (debugMode == DEBUG_RC_SMOOTHING) {
+        DEBUG_SET(DEBUG_RC_SMOOTHING, 0, lrintf(predictor->lastRxData[rxConfig()->rc_smoothing_debug_axis]));
+        DEBUG_SET(DEBUG_RC_SMOOTHING, 3, rcSmoothingData.averageFrameTimeUs);
+    }
+
+    return interpolationChannels;
+}
 #endif // USE_RC_SMOOTHING_FILTER
 
 FAST_CODE void processRcCommand(void)
@@ -547,6 +710,9 @@ FAST_CODE void processRcCommand(void)
     case RC_SMOOTHING_TYPE_FILTER:
         updatedChannel = processRcSmoothingFilter();
         break;
+    case RC_SMOOTHING_TYPE_PREDICTIVE:
+        updatedChannel = processRcSmoothingPredictor();
+        break;
 #endif // USE_RC_SMOOTHING_FILTER
     case RC_SMOOTHING_TYPE_INTERPOLATION:
     default:
@@ -578,6 +744,21 @@ FAST_CODE void processRcCommand(void)
     if (isRXDataNew) {
         isRXDataNew = false;
     }
+
+#ifdef USE_DIRECT_SETPOINT
+    directSetpoint_t directSetpoint;
+    if (directSetpointUpdate(&directSetpoint, micros())) {
+        applyDirectSetpoint(&directSetpoint);
+        directSetpointApplied = true;
+    } else if (directSetpointApplied) {
+        // back to the sticks without waiting for the next RX frame
+        directSetpointApplied = false;
+        updateRcCommands();
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            calculateSetpointRate(axis);
+        }
+    }
+#endif
 }
 
 FAST_CODE FAST_CODE_NOINLINE void updateRcCommands(void)
@@ -683,6 +864,30 @@ bool isMotorsReversed(void)
     return reverseMotors;
 }
 
+// Rebuilds the rate curve tables, whenever the rates of the current rate profile change
+void initRcRates(void)
+{
+    applyRatesFn *applyRates;
+    switch (currentControlRateProfile->rates_type) {
+    case RATES_TYPE_BETAFLIGHT:
+    default:
+        applyRates = applyBetaflightRates;
+
+        break;
+    case RATES_TYPE_RACEFLIGHT:
+        applyRates = applyRaceFlightRates;
+
+        break;
+    }
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        for (int i = 0; i < RATE_LOOKUP_LENGTH; i++) {
+            const float rcCommandf = (float)i / (RATE_LOOKUP_LENGTH - 1);
+            lookupRate[axis][i] = applyRates(axis, rcCommandf, rcCommandf);
+        }
+    }
+}
+
 void initRcProcessing(void)
 {
     for (int i = 0; i < THROTTLE_LOOKUP_LENGTH; i++) {
@@ -696,17 +901,7 @@ void initRcProcessing(void)
         lookupThrottleRC[i] = PWM_RANGE_MIN + (PWM_RANGE_MAX - PWM_RANGE_MIN) * lookupThrottleRC[i] / 1000; // [MINTHROTTLE;MAXTHROTTLE]
     }
 
-    switch (currentControlRateProfile->rates_type) {
-    case RATES_TYPE_BETAFLIGHT:
-    default:
-        applyRates = applyBetaflightRates;
-
-        break;
-    case RATES_TYPE_RACEFLIGHT:
-        applyRates = applyRaceFlightRates;
-
-        break;
-    }
+    initRcRates();
 
     interpolationChannels = 0;
     switch (rxConfig()->rcInterpolationChannels) {
@@ -38,6 +38,7 @@ float getThrottlePIDAttenuation(void);
 void updateRcCommands(void);
 void resetYawAxis(void);
 void initRcProcessing(void);
+void initRcRates(void);
 bool isMotorsReversed(void);
 bool rcSmoothingIsEnabled(void);
 int rcSmoothingGetValue(int whichValue);
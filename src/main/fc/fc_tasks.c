@@ -24,6 +24,9 @@
 
 #include "platform.h"
 
+#include "blackbox/blackbox.h"
+#include "blackbox/blackbox_fielddefs.h"
+
 #include "build/debug.h"
 
 #include "cms/cms.h"
@@ -36,10 +39,15 @@
 #include "drivers/accgyro/accgyro.h"
 #include "drivers/camera_control.h"
 #include "drivers/compass/compass.h"
+#include "drivers/max7456.h"
 #include "drivers/sensor.h"
 #include "drivers/serial.h"
 #include "drivers/serial_usb_vcp.h"
+#include "drivers/nvic.h"
+#include "drivers/pwm_output.h"
 #include "drivers/stack_check.h"
+#include "drivers/swi.h"
+#include "drivers/time.h"
 #include "drivers/transponder_ir.h"
 #include "drivers/usb_io.h"
 #include "drivers/vtx_common.h"
@@ -48,6 +56,7 @@
 #include "fc/fc_core.h"
 #include "fc/fc_rc.h"
 #include "fc/fc_dispatch.h"
+#include "fc/flight_summary.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
 
@@ -64,6 +73,7 @@
 #include "io/dashboard.h"
 #include "io/gps.h"
 #include "io/ledstrip.h"
+#include "io/offload.h"
 #include "io/osd.h"
 #include "io/osd_slave.h"
 #include "io/piniobox.h"
@@ -86,6 +96,7 @@
 #include "sensors/battery.h"
 #include "sensors/compass.h"
 #include "sensors/esc_sensor.h"
+#include "sensors/esc_stats.h"
 #include "sensors/gyro.h"
 #include "sensors/sensors.h"
 #include "sensors/rangefinder.h"
@@ -130,6 +141,23 @@ static bool taskSerialCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime
 }
 #endif
 
+#ifdef USE_MAX7456_VSYNC
+// Runs the OSD task once per video field, falls back to the task period while the camera provides no sync
+static bool osdVsyncCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    static uint32_t lastFieldCount;
+    const uint32_t fieldCount = max7456FieldCount();
+    if (fieldCount != lastFieldCount) {
+        lastFieldCount = fieldCount;
+        return true;
+    }
+
+    return currentDeltaTimeUs >= 2 * TASK_PERIOD_HZ(60);
+}
+#endif
+
 static void taskHandleSerial(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs);
@@ -152,6 +180,9 @@ static void taskHandleSerial(timeUs_t currentTimeUs)
     bool evaluateMspData = osdSlaveIsLocked ?  MSP_SKIP_NON_MSP_DATA : MSP_EVALUATE_NON_MSP_DATA;;
 #endif
     mspSerialProcess(evaluateMspData, mspFcProcessCommand, mspFcProcessReply);
+#ifdef USE_MSP_STREAMING
+    mspSerialProcessStreams(currentTimeUs, mspFcProcessCommand);
+#endif
 }
 
 static void taskBatteryAlerts(timeUs_t currentTimeUs)
@@ -183,13 +214,19 @@ static void taskUpdateRxMain(timeUs_t currentTimeUs)
 
 #ifdef USE_USB_CDC_HID
     if (!ARMING_FLAG(ARMED)) {
-        sendRcDataToHid();
+        sendRcDataToHid(currentTimeUs);
     }
 #endif
 
     // updateRcCommands sets rcCommand, which is needed by updateAltHoldState and updateSonarAltHoldState
     updateRcCommands();
     updateArmingStatus();
+#ifdef USE_GYRO_TEMP_COMPENSATION
+    gyroSaveBiasTableIfUpdated();
+#endif
+#ifdef USE_FLIGHT_SUMMARY
+    flightSummarySaveIfPending();
+#endif
 }
 #endif
 
@@ -207,6 +244,14 @@ static void taskUpdateBaro(timeUs_t currentTimeUs)
 }
 #endif
 
+#ifdef USE_RANGEFINDER
+static void taskUpdateRangefinder(timeUs_t currentTimeUs)
+{
+    rangefinderUpdate(currentTimeUs);
+    rangefinderProcess(getCosTiltAngle());
+}
+#endif
+
 #if defined(USE_BARO) || defined(USE_GPS)
 static void taskCalculateAltitude(timeUs_t currentTimeUs)
 {
@@ -236,6 +281,109 @@ static void taskCameraControl(uint32_t currentTime)
 }
 #endif
 
+#ifdef USE_GYRO_INTERRUPT_PID
+static FAST_CODE void taskGyroPidInterrupt(void)
+{
+    schedulerExecuteInterruptDrivenTask(micros());
+}
+#endif
+
+#ifdef USE_TASK_LOAD_GOVERNOR
+// Background tasks that are slowed down while the system load is above task_governor_load
+static const cfTaskId_e governedTasks[] = {
+#ifdef USE_LED_STRIP
+    TASK_LEDSTRIP,
+#endif
+#ifdef USE_DASHBOARD
+    TASK_DASHBOARD,
+#endif
+#ifdef USE_OSD
+    TASK_OSD,
+#endif
+#ifdef USE_TELEMETRY
+    TASK_TELEMETRY,
+#endif
+    TASK_BATTERY_VOLTAGE,
+    TASK_BATTERY_CURRENT,
+    TASK_BATTERY_ALERTS,
+};
+
+#define TASK_GOVERNOR_LEVEL_MAX             3   // each level doubles the period, up to 8 times the normal period
+#define TASK_GOVERNOR_HYSTERESIS_PERCENT    10
+#define TASK_GOVERNOR_RESTORE_CYCLES        10  // TASK_SYSTEM cycles the load has to stay low before stepping back
+
+static timeDelta_t governedTaskPeriod[ARRAYLEN(governedTasks)];
+static uint8_t taskGovernorLevel;
+static uint8_t taskGovernorRestoreCount;
+
+static void taskGovernorInit(void)
+{
+    for (unsigned i = 0; i < ARRAYLEN(governedTasks); i++) {
+        governedTaskPeriod[i] = cfTasks[governedTasks[i]].desiredPeriod;
+    }
+    taskGovernorLevel = 0;
+    taskGovernorRestoreCount = 0;
+}
+
+static void taskGovernorSetLevel(uint8_t level)
+{
+    taskGovernorLevel = level;
+    for (unsigned i = 0; i < ARRAYLEN(governedTasks); i++) {
+        rescheduleTask(governedTasks[i], governedTaskPeriod[i] << level);
+    }
+
+#ifdef USE_BLACKBOX
+    flightLogEvent_taskGovernor_t eventData;
+    eventData.level = level;
+    eventData.systemLoad = averageSystemLoadPercent;
+    blackboxLogEvent(FLIGHT_LOG_EVENT_TASK_GOVERNOR, (flightLogEventData_t *)&eventData);
+#endif
+}
+
+static void taskGovernorUpdate(void)
+{
+    const uint8_t loadLimit = systemConfig()->task_governor_load;
+    if (loadLimit == 0) {
+        if (taskGovernorLevel > 0) {
+            taskGovernorSetLevel(0);
+        }
+        return;
+    }
+
+    if (averageSystemLoadPercent > loadLimit) {
+        taskGovernorRestoreCount = 0;
+        if (taskGovernorLevel < TASK_GOVERNOR_LEVEL_MAX) {
+            taskGovernorSetLevel(taskGovernorLevel + 1);
+        }
+    } else if (taskGovernorLevel > 0 && averageSystemLoadPercent + TASK_GOVERNOR_HYSTERESIS_PERCENT < loadLimit) {
+        if (++taskGovernorRestoreCount >= TASK_GOVERNOR_RESTORE_CYCLES) {
+            taskGovernorRestoreCount = 0;
+            taskGovernorSetLevel(taskGovernorLevel - 1);
+        }
+    } else {
+        taskGovernorRestoreCount = 0;
+    }
+}
+#endif
+
+static void taskSystem(timeUs_t currentTimeUs)
+{
+    taskSystemLoad(currentTimeUs);
+
+    // the load only changes here, so its arming flag is kept here rather than in updateArmingStatus()
+    if (!ARMING_FLAG(ARMED)) {
+        if (averageSystemLoadPercent > 100) {
+            setArmingDisabled(ARMING_DISABLED_LOAD);
+        } else {
+            unsetArmingDisabled(ARMING_DISABLED_LOAD);
+        }
+    }
+
+#ifdef USE_TASK_LOAD_GOVERNOR
+    taskGovernorUpdate();
+#endif
+}
+
 void fcTasksInit(void)
 {
     schedulerInit();
@@ -270,6 +418,16 @@ void fcTasksInit(void)
     if (sensors(SENSOR_GYRO)) {
         rescheduleTask(TASK_GYROPID, gyro.targetLooptime);
         setTaskEnabled(TASK_GYROPID, true);
+#ifdef USE_GYRO_INTERRUPT_PID
+        // run the PID loop from a software interrupt triggered by the gyro data ready interrupt,
+        // so it preempts whatever task the scheduler is running
+        if (pidConfig()->pid_gyro_interrupt) {
+            swiInit(taskGyroPidInterrupt, NVIC_PRIO_GYRO_PID_SWI);
+            if (gyroSetDataReadyFn(swiTrigger)) {
+                schedulerSetInterruptDrivenTask(TASK_GYROPID);
+            }
+        }
+#endif
     }
 
     if (sensors(SENSOR_ACC)) {
@@ -279,6 +437,10 @@ void fcTasksInit(void)
     }
 
     setTaskEnabled(TASK_RX, true);
+    if (rxIsFrameSignalled()) {
+        // the RX driver signals complete frames, so rxUpdateCheck() only needs polling for failsafe and the 50Hz fallback
+        schedulerSetTaskSignalled(TASK_RX, TASK_PERIOD_HZ(200));
+    }
 
     setTaskEnabled(TASK_DISPATCH, dispatchIsEnabled());
 
@@ -294,6 +456,9 @@ void fcTasksInit(void)
 #ifdef USE_BARO
     setTaskEnabled(TASK_BARO, sensors(SENSOR_BARO));
 #endif
+#ifdef USE_RANGEFINDER
+    setTaskEnabled(TASK_RANGEFINDER, sensors(SENSOR_RANGEFINDER));
+#endif
 #if defined(USE_BARO) || defined(USE_GPS)
     setTaskEnabled(TASK_ALTITUDE, sensors(SENSOR_BARO) || feature(FEATURE_GPS));
 #endif
@@ -319,6 +484,11 @@ void fcTasksInit(void)
     setTaskEnabled(TASK_TRANSPONDER, feature(FEATURE_TRANSPONDER));
 #endif
 #ifdef USE_OSD
+#ifdef USE_MAX7456_VSYNC
+    if (max7456VsyncAvailable()) {
+        cfTasks[TASK_OSD].checkFunc = osdVsyncCheck;
+    }
+#endif
     setTaskEnabled(TASK_OSD, feature(FEATURE_OSD) && osdInitialized());
 #endif
 #ifdef USE_BST
@@ -327,12 +497,28 @@ void fcTasksInit(void)
 #ifdef USE_ESC_SENSOR
     setTaskEnabled(TASK_ESC_SENSOR, feature(FEATURE_ESC_SENSOR));
 #endif
+#ifdef USE_ESC_STATS
+    bool escStatsEnabled = feature(FEATURE_ESC_SENSOR);
+#ifdef USE_DSHOT_TELEMETRY
+    escStatsEnabled = escStatsEnabled || useDshotTelemetry;
+#endif
+    setTaskEnabled(TASK_ESC_STATS, escStatsEnabled);
+#endif
 #ifdef USE_ADC_INTERNAL
     setTaskEnabled(TASK_ADC_INTERNAL, true);
 #endif
 #ifdef USE_PINIOBOX
     setTaskEnabled(TASK_PINIOBOX, true);
 #endif
+#ifdef USE_BLACKBOX_DEFERRED_ENCODING
+    setTaskEnabled(TASK_BLACKBOX, blackboxConfig()->device != BLACKBOX_DEVICE_NONE);
+#endif
+#if defined(USE_OFFLOAD) && !defined(USE_OSD_SLAVE)
+    if (offloadIsEnabled()) {
+        setTaskEnabled(TASK_OFFLOAD, true);
+        rescheduleTask(TASK_OFFLOAD, TASK_PERIOD_HZ(offloadConfig()->offload_rate_hz));
+    }
+#endif
 #ifdef USE_CMS
 #ifdef USE_MSP_DISPLAYPORT
     setTaskEnabled(TASK_CMS, true);
@@ -352,13 +538,16 @@ void fcTasksInit(void)
     setTaskEnabled(TASK_RCDEVICE, rcdeviceIsEnabled());
 #endif
 #endif
+#ifdef USE_TASK_LOAD_GOVERNOR
+    taskGovernorInit();
+#endif
 }
 
 cfTask_t cfTasks[TASK_COUNT] = {
     [TASK_SYSTEM] = {
         .taskName = "SYSTEM",
         .subTaskName = "LOAD",
-        .taskFunc = taskSystemLoad,
+        .taskFunc = taskSystem,
         .desiredPeriod = TASK_PERIOD_HZ(10),        // 10Hz, every 100 ms
         .staticPriority = TASK_PRIORITY_MEDIUM_HIGH,
     },
@@ -384,6 +573,15 @@ cfTask_t cfTasks[TASK_COUNT] = {
 #endif
     },
 
+#ifdef USE_SERIAL_PASSTHROUGH
+    [TASK_SERIAL_PASSTHROUGH] = {
+        .taskName = "SERIAL_PASSTHROUGH",
+        .taskFunc = serialPassthroughUpdate,
+        .desiredPeriod = TASK_PERIOD_HZ(2000),      // 2 kHz keeps up with the 128 byte UART receive buffer @ 2 Mbaud
+        .staticPriority = TASK_PRIORITY_HIGH,
+    },
+#endif
+
     [TASK_BATTERY_ALERTS] = {
         .taskName = "BATTERY_ALERTS",
         .taskFunc = taskBatteryAlerts,
@@ -465,8 +663,9 @@ cfTask_t cfTasks[TASK_COUNT] = {
 
     [TASK_DISPATCH] = {
         .taskName = "DISPATCH",
+        .checkFunc = dispatchCheck,
         .taskFunc = dispatchProcess,
-        .desiredPeriod = TASK_PERIOD_HZ(1000),
+        .desiredPeriod = TASK_PERIOD_HZ(1000),      // event driven, the period only ages the task
         .staticPriority = TASK_PRIORITY_HIGH,
     },
 
@@ -506,6 +705,15 @@ cfTask_t cfTasks[TASK_COUNT] = {
     },
 #endif
 
+#ifdef USE_RANGEFINDER
+    [TASK_RANGEFINDER] = {
+        .taskName = "RANGEFINDER",
+        .taskFunc = taskUpdateRangefinder,
+        .desiredPeriod = TASK_PERIOD_HZ(10),
+        .staticPriority = TASK_PRIORITY_LOW,
+    },
+#endif
+
 #if defined(USE_BARO) || defined(USE_GPS)
     [TASK_ALTITUDE] = {
         .taskName = "ALTITUDE",
@@ -519,7 +727,7 @@ cfTask_t cfTasks[TASK_COUNT] = {
     [TASK_DASHBOARD] = {
         .taskName = "DASHBOARD",
         .taskFunc = dashboardUpdate,
-        .desiredPeriod = TASK_PERIOD_HZ(10),
+        .desiredPeriod = TASK_PERIOD_HZ(100),   // each run sends at most one transfer of the display pages
         .staticPriority = TASK_PRIORITY_LOW,
     },
 #endif
@@ -563,7 +771,17 @@ cfTask_t cfTasks[TASK_COUNT] = {
 #ifdef USE_ESC_SENSOR
     [TASK_ESC_SENSOR] = {
         .taskName = "ESC_SENSOR",
+        .checkFunc = escSensorCheck,
         .taskFunc = escSensorProcess,
+        .desiredPeriod = TASK_PERIOD_HZ(100),       // If event-based scheduling doesn't work, fallback to periodic scheduling
+        .staticPriority = TASK_PRIORITY_LOW,
+    },
+#endif
+
+#ifdef USE_ESC_STATS
+    [TASK_ESC_STATS] = {
+        .taskName = "ESC_STATS",
+        .taskFunc = escStatsUpdate,
         .desiredPeriod = TASK_PERIOD_HZ(100),       // 100 Hz, 10ms
         .staticPriority = TASK_PRIORITY_LOW,
     },
@@ -590,8 +808,9 @@ cfTask_t cfTasks[TASK_COUNT] = {
 #ifdef USE_RCDEVICE
     [TASK_RCDEVICE] = {
         .taskName = "RCDEVICE",
+        .checkFunc = rcdeviceCheck,
         .taskFunc = rcdeviceUpdate,
-        .desiredPeriod = TASK_PERIOD_HZ(20),
+        .desiredPeriod = TASK_PERIOD_HZ(20),        // event driven, see rcdeviceCheck()
         .staticPriority = TASK_PRIORITY_MEDIUM,
     },
 #endif
@@ -622,5 +841,23 @@ cfTask_t cfTasks[TASK_COUNT] = {
         .staticPriority = TASK_PRIORITY_IDLE
     },
 #endif
+
+#ifdef USE_BLACKBOX_DEFERRED_ENCODING
+    [TASK_BLACKBOX] = {
+        .taskName = "BLACKBOX",
+        .taskFunc = blackboxEncodeUpdate,
+        .desiredPeriod = TASK_PERIOD_HZ(1000),      // drains the capture ring, which holds 16 frames
+        .staticPriority = TASK_PRIORITY_MEDIUM,
+    },
+#endif
+
+#ifdef USE_OFFLOAD
+    [TASK_OFFLOAD] = {
+        .taskName = "OFFLOAD",
+        .taskFunc = offloadUpdate,
+        .desiredPeriod = TASK_PERIOD_HZ(20),        // rescheduled to offload_rate_hz
+        .staticPriority = TASK_PRIORITY_LOW,
+    },
+#endif
 #endif
 };
@@ -0,0 +1,235 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Summary of each flight computed while flying, to triage a craft without downloading its blackbox log.
+ *
+ * Every gyro loop adds the gyro noise before and after the filters, taken as the gyro less a lowpass of the
+ * filtered gyro that follows the motion, whether the motor outputs were saturated and whether the loop started
+ * late. The tracked dynamic notch peaks and the system load are checked once per block of loops. The summary is
+ * added to the log in the config at disarm, and the config is written once disarmed if flight_summary_save is on.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_FLIGHT_SUMMARY
+
+#include "common/filter.h"
+#include "common/maths.h"
+
+#include "config/feature.h"
+
+#include "drivers/time.h"
+
+#include "fc/config.h"
+#include "fc/flight_summary.h"
+#include "fc/runtime_config.h"
+
+#include "flight/mixer.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#include "scheduler/scheduler.h"
+
+#include "sensors/gyro.h"
+#ifdef USE_GYRO_DATA_ANALYSE
+#include "sensors/gyroanalyse.h"
+#endif
+
+PG_REGISTER(flightSummaryLog_t, flightSummaryLog, PG_FLIGHT_SUMMARY_LOG, 0);
+
+PG_REGISTER_WITH_RESET_TEMPLATE(flightSummaryConfig_t, flightSummaryConfig, PG_FLIGHT_SUMMARY_CONFIG, 0);
+
+PG_RESET_TEMPLATE(flightSummaryConfig_t, flightSummaryConfig,
+    .flight_summary_save = false,
+);
+
+enum {
+    NOISE_PREFILTERED = 0,
+    NOISE_FILTERED,
+    NOISE_COUNT
+};
+
+typedef struct flightSummaryState_s {
+    bool running;
+    bool dynNotch;
+    timeUs_t startUs;
+    timeDelta_t overrunUs;
+    pt1FilterBank3_t motionFilter;
+    uint16_t blockLoops;
+    float blockSquares[NOISE_COUNT][XYZ_AXIS_COUNT];
+    float meanSquaresTotal[NOISE_COUNT][XYZ_AXIS_COUNT];    // of the complete blocks
+    uint32_t loops;
+    uint32_t saturatedLoops;
+    uint32_t overruns;
+    uint16_t dynNotchMinHz;
+    uint16_t dynNotchMaxHz;
+    uint16_t maxLoadPercent;
+} flightSummaryState_t;
+
+static FAST_RAM_ZERO_INIT flightSummaryState_t flightSummaryState;
+static bool flightSummarySavePending;
+
+// Called at arming
+void flightSummaryStart(void)
+{
+    flightSummaryState_t *state = &flightSummaryState;
+    memset(state, 0, sizeof(*state));
+    pt1FilterBank3Init(&state->motionFilter, pt1FilterGain(FLIGHT_SUMMARY_MOTION_HZ, gyro.targetLooptime * 1e-6f));
+    state->dynNotch = feature(FEATURE_DYNAMIC_FILTER);
+    state->overrunUs = 2 * gyro.targetLooptime;
+    state->dynNotchMinHz = UINT16_MAX;
+    state->startUs = micros();
+    state->running = true;
+}
+
+static void flightSummaryUpdateBlock(flightSummaryState_t *state)
+{
+    for (int i = 0; i < NOISE_COUNT; i++) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            state->meanSquaresTotal[i][axis] += state->blockSquares[i][axis] / FLIGHT_SUMMARY_BLOCK_LOOPS;
+            state->blockSquares[i][axis] = 0;
+        }
+    }
+    state->blockLoops = 0;
+
+#ifdef USE_GYRO_DATA_ANALYSE
+    if (state->dynNotch) {
+        const gyroAnalyseState_t *analyse = gyroAnalyseState();
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            for (int n = 0; n < analyse->notchCount; n++) {
+                state->dynNotchMinHz = MIN(state->dynNotchMinHz, analyse->centerFreq[axis][n]);
+                state->dynNotchMaxHz = MAX(state->dynNotchMaxHz, analyse->centerFreq[axis][n]);
+            }
+        }
+    }
+#endif
+
+    state->maxLoadPercent = MAX(state->maxLoadPercent, averageSystemLoadPercent);
+}
+
+// Called at the end of each gyro loop
+FAST_CODE void flightSummaryUpdate(void)
+{
+    flightSummaryState_t *state = &flightSummaryState;
+    if (!state->running) {
+        return;
+    }
+
+    float motion[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        motion[axis] = gyro.gyroADCf[axis];
+    }
+    pt1FilterBank3Apply(&state->motionFilter, motion);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float prefilteredNoise = gyroGetPrefilteredRate(axis) - motion[axis];
+        const float filteredNoise = gyro.gyroADCf[axis] - motion[axis];
+        state->blockSquares[NOISE_PREFILTERED][axis] += sq(prefilteredNoise);
+        state->blockSquares[NOISE_FILTERED][axis] += sq(filteredNoise);
+    }
+
+    if (mixerIsOutputSaturated(FD_ROLL, 0)) {
+        state->saturatedLoops++;
+    }
+    if (getTaskDeltaTime(TASK_GYROPID) > state->overrunUs) {
+        state->overruns++;
+    }
+
+    state->loops++;
+    if (++state->blockLoops == FLIGHT_SUMMARY_BLOCK_LOOPS) {
+        flightSummaryUpdateBlock(state);
+    }
+}
+
+static uint16_t flightSummaryRms(const flightSummaryState_t *state, int i, int axis)
+{
+    const float meanSquare = (state->meanSquaresTotal[i][axis] * FLIGHT_SUMMARY_BLOCK_LOOPS + state->blockSquares[i][axis]) / state->loops;
+    return MIN(lrintf(sqrtf(meanSquare) * 10), UINT16_MAX);
+}
+
+// Called at disarming, adds the summary to the log
+void flightSummaryFinish(timeUs_t currentTimeUs)
+{
+    flightSummaryState_t *state = &flightSummaryState;
+    if (!state->running) {
+        return;
+    }
+    state->running = false;
+    if (!state->loops) {
+        return;
+    }
+
+    flightSummaryLog_t *log = flightSummaryLogMutable();
+    flightSummary_t *summary = &log->flights[log->flightCount % FLIGHT_SUMMARY_COUNT];
+    log->flightCount++;
+
+    summary->flightNumber = log->flightCount;
+    summary->durationS = MIN(cmpTimeUs(currentTimeUs, state->startUs) / 1000000, UINT16_MAX);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        summary->gyroNoisePrefilteredRms[axis] = flightSummaryRms(state, NOISE_PREFILTERED, axis);
+        summary->gyroNoiseFilteredRms[axis] = flightSummaryRms(state, NOISE_FILTERED, axis);
+    }
+    summary->motorSaturationPermille = (uint64_t)state->saturatedLoops * 1000 / state->loops;
+    const bool dynNotchTracked = state->dynNotchMaxHz > 0;
+    summary->dynNotchMinHz = dynNotchTracked ? state->dynNotchMinHz : 0;
+    summary->dynNotchMaxHz = state->dynNotchMaxHz;
+    summary->loopOverruns = MIN(state->overruns, (uint32_t)UINT16_MAX);
+    summary->maxLoadPercent = MAX(state->maxLoadPercent, averageSystemLoadPercent);
+
+    flightSummarySavePending = flightSummaryConfig()->flight_summary_save;
+}
+
+// Called from a task, the config is written once the craft is disarmed
+void flightSummarySaveIfPending(void)
+{
+    if (flightSummarySavePending && !ARMING_FLAG(ARMED)) {
+        flightSummarySavePending = false;
+        writeEEPROM();
+    }
+}
+
+void flightSummaryClear(void)
+{
+    memset(flightSummaryLogMutable(), 0, sizeof(flightSummaryLog_t));
+    flightSummarySavePending = flightSummaryConfig()->flight_summary_save;
+}
+
+int flightSummaryCount(void)
+{
+    return MIN(flightSummaryLog()->flightCount, (uint32_t)FLIGHT_SUMMARY_COUNT);
+}
+
+// index 0 is the newest flight
+const flightSummary_t *flightSummaryGet(int index)
+{
+    if (index < 0 || index >= flightSummaryCount()) {
+        return NULL;
+    }
+    const flightSummaryLog_t *log = flightSummaryLog();
+    return &log->flights[(log->flightCount - 1 - index) % FLIGHT_SUMMARY_COUNT];
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/axis.h"
+#include "common/time.h"
+
+#include "pg/pg.h"
+
+#define FLIGHT_SUMMARY_COUNT            4       // flights kept, the oldest is replaced
+#define FLIGHT_SUMMARY_BLOCK_LOOPS      1024    // gyro loops summed before the sums are reduced to a mean
+#define FLIGHT_SUMMARY_MOTION_HZ        20      // the gyro below this is taken as motion, above as noise
+
+typedef struct flightSummary_s {
+    uint32_t flightNumber;                              // counts the flights since the summaries were cleared
+    uint16_t durationS;
+    uint16_t gyroNoisePrefilteredRms[XYZ_AXIS_COUNT];   // 0.1 deg/s
+    uint16_t gyroNoiseFilteredRms[XYZ_AXIS_COUNT];      // 0.1 deg/s
+    uint16_t motorSaturationPermille;                   // of the gyro loops
+    uint16_t dynNotchMinHz;                             // range of the peaks tracked by the dynamic notch, 0 without it
+    uint16_t dynNotchMaxHz;
+    uint16_t loopOverruns;                              // gyro loops started more than a looptime late
+    uint16_t maxLoadPercent;
+} flightSummary_t;
+
+// Kept in the config, so saved with it
+typedef struct flightSummaryLog_s {
+    uint32_t flightCount;                               // the newest is flights[(flightCount - 1) % FLIGHT_SUMMARY_COUNT]
+    flightSummary_t flights[FLIGHT_SUMMARY_COUNT];
+} flightSummaryLog_t;
+
+PG_DECLARE(flightSummaryLog_t, flightSummaryLog);
+
+typedef struct flightSummaryConfig_s {
+    uint8_t flight_summary_save;                        // write the config once disarmed, to keep the summaries
+} flightSummaryConfig_t;
+
+PG_DECLARE(flightSummaryConfig_t, flightSummaryConfig);
+
+void flightSummaryStart(void);
+void flightSummaryUpdate(void);
+void flightSummaryFinish(timeUs_t currentTimeUs);
+void flightSummarySaveIfPending(void);
+void flightSummaryClear(void);
+int flightSummaryCount(void);
+const flightSummary_t *flightSummaryGet(int index);
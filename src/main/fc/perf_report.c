@@ -0,0 +1,214 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Self-test report of the gyro loop timing, for comparing boards and configurations.
+ *
+ * A measurement runs for a number of seconds while disarmed, the gyro loop, gyro read and motor
+ * update report their timings while it runs. The load of the tasks, the bus errors and the DMA
+ * conflicts are the differences of their counters between the start and the end of the window.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_PERF_REPORT
+
+#include "common/maths.h"
+
+#include "drivers/bus_i2c.h"
+#include "drivers/bus_spi.h"
+#include "drivers/dma.h"
+#include "drivers/time.h"
+
+#include "fc/runtime_config.h"
+
+#include "scheduler/scheduler.h"
+
+#include "sensors/gyro.h"
+
+#include "perf_report.h"
+
+static perfReport_t perfReport;
+
+static timeUs_t lastDataReadyAtUs;
+static timeUs_t taskExecutionTimeAtStartUs[TASK_COUNT];
+#ifdef USE_SPI
+static uint16_t spiErrorsAtStart[SPIDEV_COUNT];
+#endif
+#ifdef USE_I2C
+static uint16_t i2cErrorsAtStart;
+#endif
+static uint32_t dmaAcquireFailuresAtStart;
+
+static void perfLatencyAdd(perfLatency_t *latency, timeDelta_t latencyUs)
+{
+    if (latencyUs < 0) {
+        return;
+    }
+    if (latency->count == 0 || latencyUs < latency->minUs) {
+        latency->minUs = latencyUs;
+    }
+    latency->maxUs = MAX(latency->maxUs, latencyUs);
+    latency->totalUs += latencyUs;
+    latency->count++;
+}
+
+timeDelta_t perfLatencyAverageUs(const perfLatency_t *latency)
+{
+    return latency->count ? latency->totalUs / latency->count : 0;
+}
+
+bool perfReportStart(int durationS)
+{
+    if (ARMING_FLAG(ARMED)) {
+        return false;
+    }
+
+    memset(&perfReport, 0, sizeof(perfReport));
+    perfReport.durationUs = constrain(durationS, 1, PERF_REPORT_DURATION_MAX_S) * 1000000;
+    perfReport.targetLooptimeUs = gyro.targetLooptime;
+
+    for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        cfTaskInfo_t taskInfo;
+        getTaskInfo(taskId, &taskInfo);
+        taskExecutionTimeAtStartUs[taskId] = taskInfo.totalExecutionTime;
+    }
+#ifdef USE_SPI
+    for (SPIDevice device = SPIDEV_1; device < SPIDEV_COUNT; device++) {
+        spiErrorsAtStart[device] = spiGetErrorCounter(spiInstanceByDevice(device));
+    }
+#endif
+#ifdef USE_I2C
+    i2cErrorsAtStart = i2cGetErrorCounter();
+#endif
+    dmaAcquireFailuresAtStart = dmaGetAcquireFailureCount();
+    lastDataReadyAtUs = 0;
+
+    perfReport.startedAtUs = micros();
+    perfReport.state = PERF_REPORT_RUNNING;
+    return true;
+}
+
+static void perfReportFinish(void)
+{
+    for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        cfTaskInfo_t taskInfo;
+        getTaskInfo(taskId, &taskInfo);
+        perfReport.taskExecutionTimeUs[taskId] = taskInfo.totalExecutionTime - taskExecutionTimeAtStartUs[taskId];
+    }
+#ifdef USE_SPI
+    for (SPIDevice device = SPIDEV_1; device < SPIDEV_COUNT; device++) {
+        perfReport.spiErrors += (uint16_t)(spiGetErrorCounter(spiInstanceByDevice(device)) - spiErrorsAtStart[device]);
+    }
+#endif
+#ifdef USE_I2C
+    perfReport.i2cErrors = (uint16_t)(i2cGetErrorCounter() - i2cErrorsAtStart);
+#endif
+    perfReport.dmaAcquireFailures = dmaGetAcquireFailureCount() - dmaAcquireFailuresAtStart;
+    perfReport.dmaAllocateFailures = dmaGetAllocateFailureCount();
+
+    perfReport.state = PERF_REPORT_DONE;
+}
+
+bool perfReportIsRunning(void)
+{
+    return perfReport.state == PERF_REPORT_RUNNING;
+}
+
+const perfReport_t *perfReportGet(void)
+{
+    return &perfReport;
+}
+
+// Called at the start of each gyro loop
+FAST_CODE void perfReportGyroLoop(timeUs_t currentTimeUs)
+{
+    if (perfReport.state != PERF_REPORT_RUNNING) {
+        return;
+    }
+    if (ARMING_FLAG(ARMED)) {
+        perfReport.state = PERF_REPORT_ABORTED;
+        return;
+    }
+    if (cmpTimeUs(currentTimeUs, perfReport.startedAtUs) >= perfReport.durationUs) {
+        perfReportFinish();
+        return;
+    }
+
+    // the first period may have started before the window
+    if (cmpTimeUs(currentTimeUs, perfReport.startedAtUs) > perfReport.targetLooptimeUs) {
+        const timeDelta_t deviationUs = getTaskDeltaTime(TASK_GYROPID) - perfReport.targetLooptimeUs;
+        perfReport.periodCount++;
+        perfReport.periodDeviationTotalUs += deviationUs;
+        perfReport.periodDeviationSquaredTotalUs += (int64_t)deviationUs * deviationUs;
+        perfReport.jitterHistogram[MIN(ABS(deviationUs), PERF_REPORT_JITTER_BUCKET_COUNT - 1)]++;
+    }
+}
+
+// Called after a successful gyro read, dataReadyAtUs is the time of the data ready interrupt if the sensor has one
+FAST_CODE void perfReportGyroRead(timeUs_t dataReadyAtUs, timeUs_t readStartUs)
+{
+    const timeUs_t currentTimeUs = micros();
+    perfLatencyAdd(&perfReport.gyroRead, cmpTimeUs(currentTimeUs, readStartUs));
+    if (dataReadyAtUs && dataReadyAtUs != lastDataReadyAtUs) {
+        lastDataReadyAtUs = dataReadyAtUs;
+        perfLatencyAdd(&perfReport.extiToRead, cmpTimeUs(currentTimeUs, dataReadyAtUs));
+    }
+}
+
+// Called once the motor outputs have been written
+FAST_CODE void perfReportMotorsUpdated(timeUs_t loopStartUs)
+{
+    if (perfReport.state == PERF_REPORT_RUNNING) {
+        perfLatencyAdd(&perfReport.gyroToMotor, cmpTimeUs(micros(), loopStartUs));
+    }
+}
+
+// Standard deviation of the gyro loop period
+float perfReportJitterStdDevUs(void)
+{
+    if (!perfReport.periodCount) {
+        return 0;
+    }
+    const float meanUs = (float)perfReport.periodDeviationTotalUs / perfReport.periodCount;
+    const float variance = (float)perfReport.periodDeviationSquaredTotalUs / perfReport.periodCount - meanUs * meanUs;
+    return variance > 0 ? sqrtf(variance) : 0;
+}
+
+// Deviation of the gyro loop period from the target looptime not exceeded by the given percentage of the periods
+timeDelta_t perfReportJitterPercentileUs(int percentile)
+{
+    const uint64_t countAtPercentile = ((uint64_t)perfReport.periodCount * percentile + 99) / 100;
+    uint32_t count = 0;
+    for (int i = 0; i < PERF_REPORT_JITTER_BUCKET_COUNT; i++) {
+        count += perfReport.jitterHistogram[i];
+        if (count >= countAtPercentile) {
+            return i;
+        }
+    }
+    return PERF_REPORT_JITTER_BUCKET_COUNT - 1;
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+#include "scheduler/scheduler.h"
+
+#define PERF_REPORT_DURATION_DEFAULT_S      10
+#define PERF_REPORT_DURATION_MAX_S          600
+#define PERF_REPORT_JITTER_BUCKET_COUNT     64  // 1us buckets of the loop period deviation, the last collects everything above
+
+typedef enum {
+    PERF_REPORT_IDLE = 0,
+    PERF_REPORT_RUNNING,
+    PERF_REPORT_DONE,
+    PERF_REPORT_ABORTED,        // the craft was armed during the measurement
+} perfReportState_e;
+
+typedef struct perfLatency_s {
+    uint32_t count;
+    timeDelta_t minUs;
+    timeDelta_t maxUs;
+    uint64_t totalUs;
+} perfLatency_t;
+
+// Timing of the gyro loop and the load of the tasks over a measurement window while disarmed
+typedef struct perfReport_s {
+    perfReportState_e state;
+    timeUs_t startedAtUs;
+    timeDelta_t durationUs;
+    timeDelta_t targetLooptimeUs;
+    perfLatency_t extiToRead;           // gyro data ready interrupt to the sample read by the gyro loop
+    perfLatency_t gyroToMotor;          // start of the gyro loop to the motor outputs written
+    perfLatency_t gyroRead;             // time on the gyro bus for each read
+    uint32_t periodCount;               // TASK_GYROPID periods, as deviations from the target looptime
+    int64_t periodDeviationTotalUs;
+    uint64_t periodDeviationSquaredTotalUs;
+    uint32_t jitterHistogram[PERF_REPORT_JITTER_BUCKET_COUNT];
+    uint32_t taskExecutionTimeUs[TASK_COUNT];   // total execution time of each task during the window
+    uint32_t spiErrors;
+    uint32_t i2cErrors;
+    uint32_t dmaAcquireFailures;        // transfers delayed by a shared DMA stream being busy
+    uint8_t dmaAllocateFailures;        // streams left without DMA because another owner holds them, since boot
+} perfReport_t;
+
+bool perfReportStart(int durationS);
+bool perfReportIsRunning(void);
+const perfReport_t *perfReportGet(void);
+
+void perfReportGyroLoop(timeUs_t currentTimeUs);
+void perfReportGyroRead(timeUs_t dataReadyAtUs, timeUs_t readStartUs);
+void perfReportMotorsUpdated(timeUs_t loopStartUs);
+
+timeDelta_t perfLatencyAverageUs(const perfLatency_t *latency);
+float perfReportJitterStdDevUs(void);
+timeDelta_t perfReportJitterPercentileUs(int percentile);
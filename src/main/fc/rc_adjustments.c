@@ -454,6 +454,27 @@ static int applyStepAdjustment(controlRateConfig_t *controlRateConfig, uint8_t a
     return newValue;
 }
 
+// The setpoint rates are looked up from tables of the rate curves, which are rebuilt when a rate changes
+static bool isRateCurveAdjustment(adjustmentFunction_e adjustmentFunction)
+{
+    switch (adjustmentFunction) {
+    case ADJUSTMENT_RC_RATE:
+    case ADJUSTMENT_RC_EXPO:
+    case ADJUSTMENT_PITCH_ROLL_RATE:
+    case ADJUSTMENT_YAW_RATE:
+    case ADJUSTMENT_PITCH_RATE:
+    case ADJUSTMENT_ROLL_RATE:
+    case ADJUSTMENT_RC_RATE_YAW:
+    case ADJUSTMENT_ROLL_RC_RATE:
+    case ADJUSTMENT_PITCH_RC_RATE:
+    case ADJUSTMENT_ROLL_RC_EXPO:
+    case ADJUSTMENT_PITCH_RC_EXPO:
+        return true;
+    default:
+        return false;
+    }
+}
+
 static int applyAbsoluteAdjustment(controlRateConfig_t *controlRateConfig, adjustmentFunction_e adjustmentFunction, int value)
 {
     int newValue;
@@ -719,6 +740,9 @@ void processRcAdjustments(controlRateConfig_t *controlRateConfig)
 
             newValue = applyStepAdjustment(controlRateConfig, adjustmentFunction, delta);
             pidInitConfig(pidProfile);
+            if (isRateCurveAdjustment(adjustmentFunction)) {
+                initRcRates();
+            }
         } else if (adjustmentState->config->mode == ADJUSTMENT_MODE_SELECT) {
             int switchPositions = adjustmentState->config->data.switchPositions;
             if (adjustmentFunction == ADJUSTMENT_RATE_PROFILE && systemConfig()->rateProfile6PosSwitch) {
@@ -758,6 +782,9 @@ void processRcAdjustments(controlRateConfig_t *controlRateConfig)
             lastRcData[index] = rcData[channelIndex];
             applyAbsoluteAdjustment(controlRateConfig, adjustmentRange->adjustmentFunction, value);
             pidInitConfig(pidProfile);
+            if (isRateCurveAdjustment(adjustmentRange->adjustmentFunction)) {
+                initRcRates();
+            }
         }
     }
 }
@@ -23,6 +23,7 @@
 #include <stdbool.h>
 
 #include "common/filter.h"
+#include "common/time.h"
 #include "pg/pg.h"
 
 typedef enum rc_alias {
@@ -63,7 +64,8 @@ typedef enum {
 
 typedef enum {
     RC_SMOOTHING_TYPE_INTERPOLATION,
-    RC_SMOOTHING_TYPE_FILTER
+    RC_SMOOTHING_TYPE_FILTER,
+    RC_SMOOTHING_TYPE_PREDICTIVE
 } rcSmoothingType_e;
 
 typedef enum {
@@ -128,6 +130,16 @@ typedef struct rcSmoothingFilter_s {
     rcSmoothingFilterTraining_t training;
 } rcSmoothingFilter_t;
 
+typedef struct rcSmoothingPredictor_s {
+    float frameIntervalUs;      // running average of the rx frame interval
+    float frameJitterUs;        // running average of the deviation from it
+    int sampleCount;
+    timeUs_t frameTimeUs;       // receive time of the latest frame
+    float lastRxData[4];
+    float slope[4];             // change per us between the last two frames
+    pt1Filter_t filter[4];
+} rcSmoothingPredictor_t;
+
 typedef struct rcControlsConfig_s {
     uint8_t deadband;                       // introduce a deadband around the stick center for pitch and roll axis. Must be greater than zero.
     uint8_t yaw_deadband;                   // introduce a deadband around the stick center for yaw axis. Must be greater than zero.
@@ -28,6 +28,7 @@
 
 #include "common/bitarray.h"
 #include "common/maths.h"
+#include "common/utils.h"
 #include "drivers/time.h"
 
 #include "config/feature.h"
@@ -44,6 +45,7 @@
 
 boxBitmask_t rcModeActivationMask; // one bit per mode defined in boxId_e
 static boxBitmask_t stickyModesEverDisabled;
+static bool lastChannelStepsValid;
 
 PG_REGISTER_ARRAY(modeActivationCondition_t, MAX_MODE_ACTIVATION_CONDITION_COUNT, modeActivationConditions,
                   PG_MODE_ACTIVATION_PROFILE, 1);
@@ -56,6 +58,8 @@ bool IS_RC_MODE_ACTIVE(boxId_e boxId)
 void rcModeUpdate(boxBitmask_t *newState)
 {
     rcModeActivationMask = *newState;
+    // the next updateActivatedModes() evaluates the conditions again
+    lastChannelStepsValid = false;
 }
 
 bool isAirmodeActive(void) {
@@ -98,44 +102,182 @@ void updateMasksForStickyModes(const modeActivationCondition_t *mac, boxBitmask_
     }
 }
 
-void updateActivatedModes(void)
+// The mode activation conditions are compiled into segments of the steps of each aux channel they use. Each segment
+// holds the modes whose conditions on that channel disagree with their logic there, so the modes follow from one
+// lookup per channel. The sticky modes depend on time and are still evaluated condition by condition.
+
+#define MODE_ACTIVATION_SEGMENT_COUNT (3 * MAX_MODE_ACTIVATION_CONDITION_COUNT)
+
+typedef struct modeActivationSegment_s {
+    uint8_t endStep;                // the segment covers the steps below this one and above the previous segment
+    boxBitmask_t mask;
+} modeActivationSegment_t;
+
+typedef struct modeActivationChannel_s {
+    uint8_t auxChannelIndex;
+    uint8_t firstSegment;
+    uint8_t segmentCount;
+} modeActivationChannel_t;
+
+static modeActivationCondition_t compiledConditions[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+static bool conditionsCompiled;
+static modeActivationSegment_t activationSegments[MODE_ACTIVATION_SEGMENT_COUNT];
+static modeActivationChannel_t activationChannels[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+static uint8_t activationChannelCount;
+static boxBitmask_t constantMask;       // modes of AND conditions that can never be active
+static boxBitmask_t andMask;
+static uint8_t stickyConditions[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+static uint8_t stickyConditionCount;
+static uint8_t linkedConditions[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+static uint8_t linkedConditionCount;
+static uint8_t lastChannelSteps[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+
+static bool isStickyMode(boxId_e modeId)
+{
+    return modeId == BOXPARALYZE;
+}
+
+static uint8_t auxChannelStep(uint8_t auxChannelIndex)
+{
+    const uint16_t channelValue = constrain(rcData[auxChannelIndex + NON_AUX_CHANNEL_COUNT], CHANNEL_RANGE_MIN, CHANNEL_RANGE_MAX - 1);
+    return (channelValue - CHANNEL_RANGE_MIN) / 25;
+}
+
+static void compileModeActivationConditions(void)
 {
-    boxBitmask_t newMask, andMask, stickyModes;
+    memcpy(compiledConditions, modeActivationConditions(0), sizeof(compiledConditions));
+    conditionsCompiled = true;
+    lastChannelStepsValid = false;
+
+    memset(&constantMask, 0, sizeof(constantMask));
     memset(&andMask, 0, sizeof(andMask));
-    memset(&newMask, 0, sizeof(newMask));
-    memset(&stickyModes, 0, sizeof(stickyModes));
-    bitArraySet(&stickyModes, BOXPARALYZE);
+    activationChannelCount = 0;
+    stickyConditionCount = 0;
+    linkedConditionCount = 0;
 
-    // determine which conditions set/clear the mode
+    // a condition follows AND logic once any earlier condition of its mode did
+    bool conditionAnd[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+    bool channelUsed[MAX_AUX_CHANNEL_COUNT] = { false };
     for (int i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
-        const modeActivationCondition_t *mac = modeActivationConditions(i);
+        const modeActivationCondition_t *mac = &compiledConditions[i];
+        conditionAnd[i] = false;
 
-        // Skip linked macs for now to fully determine target states
         if (mac->linkedTo) {
+            linkedConditions[linkedConditionCount++] = i;
+        } else if (isStickyMode(mac->modeId)) {
+            stickyConditions[stickyConditionCount++] = i;
+        } else if (mac->modeId < CHECKBOX_ITEM_COUNT) {
+            conditionAnd[i] = mac->modeLogic == MODELOGIC_AND || bitArrayGet(&andMask, mac->modeId);
+            if (conditionAnd[i]) {
+                bitArraySet(&andMask, mac->modeId);
+            }
+            if (!IS_RANGE_USABLE(&mac->range)) {
+                if (conditionAnd[i]) {
+                    bitArraySet(&constantMask, mac->modeId);
+                }
+            } else if (mac->auxChannelIndex < MAX_AUX_CHANNEL_COUNT) {
+                channelUsed[mac->auxChannelIndex] = true;
+            }
+        }
+    }
+
+    uint8_t segmentCount = 0;
+    for (int auxChannelIndex = 0; auxChannelIndex < MAX_AUX_CHANNEL_COUNT; auxChannelIndex++) {
+        if (!channelUsed[auxChannelIndex]) {
             continue;
         }
 
-        if (bitArrayGet(&stickyModes, mac->modeId)) {
-            updateMasksForStickyModes(mac, &andMask, &newMask);
-        } else if (mac->modeId < CHECKBOX_ITEM_COUNT) {
-            updateMasksForMac(mac, &andMask, &newMask);
+        modeActivationChannel_t *channel = &activationChannels[activationChannelCount++];
+        channel->auxChannelIndex = auxChannelIndex;
+        channel->firstSegment = segmentCount;
+
+        // the segments end at each range boundary on the channel, in order
+        uint8_t startStep = 0;
+        while (startStep < MAX_MODE_RANGE_STEP) {
+            uint8_t endStep = MAX_MODE_RANGE_STEP;
+            for (int i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
+                const modeActivationCondition_t *mac = &compiledConditions[i];
+                if (mac->auxChannelIndex == auxChannelIndex && IS_RANGE_USABLE(&mac->range) && !mac->linkedTo && !isStickyMode(mac->modeId)) {
+                    if (mac->range.startStep > startStep && mac->range.startStep < endStep) {
+                        endStep = mac->range.startStep;
+                    }
+                    if (mac->range.endStep > startStep && mac->range.endStep < endStep) {
+                        endStep = mac->range.endStep;
+                    }
+                }
+            }
+
+            modeActivationSegment_t *segment = &activationSegments[segmentCount++];
+            segment->endStep = endStep;
+            memset(&segment->mask, 0, sizeof(segment->mask));
+            for (int i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
+                const modeActivationCondition_t *mac = &compiledConditions[i];
+                if (mac->auxChannelIndex == auxChannelIndex && IS_RANGE_USABLE(&mac->range) && !mac->linkedTo && !isStickyMode(mac->modeId)
+                    && mac->modeId < CHECKBOX_ITEM_COUNT) {
+                    const bool active = startStep >= mac->range.startStep && startStep < mac->range.endStep;
+                    if (conditionAnd[i] != active) {
+                        bitArraySet(&segment->mask, mac->modeId);
+                    }
+                }
+            }
+            startStep = endStep;
         }
+
+        channel->segmentCount = segmentCount - channel->firstSegment;
     }
+}
 
-    bitArrayXor(&newMask, sizeof(&newMask), &newMask, &andMask);
+void updateActivatedModes(void)
+{
+    if (!conditionsCompiled || memcmp(compiledConditions, modeActivationConditions(0), sizeof(compiledConditions))) {
+        compileModeActivationConditions();
+    }
 
-    // Update linked modes
-    for (int i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
-        const modeActivationCondition_t *mac = modeActivationConditions(i);
+    // without sticky modes the modes only change with the steps of the aux channels
+    bool stepsChanged = !lastChannelStepsValid;
+    for (int i = 0; i < activationChannelCount; i++) {
+        const uint8_t step = auxChannelStep(activationChannels[i].auxChannelIndex);
+        stepsChanged |= step != lastChannelSteps[i];
+        lastChannelSteps[i] = step;
+    }
+    lastChannelStepsValid = true;
+    if (!stepsChanged && !stickyConditionCount) {
+        return;
+    }
 
-        if (!mac->linkedTo) {
-            continue;
+    boxBitmask_t newMask = constantMask;
+    for (int i = 0; i < activationChannelCount; i++) {
+        const modeActivationChannel_t *channel = &activationChannels[i];
+        const modeActivationSegment_t *segment = &activationSegments[channel->firstSegment];
+        while (lastChannelSteps[i] >= segment->endStep) {
+            segment++;
         }
+        for (unsigned j = 0; j < ARRAYLEN(newMask.bits); j++) {
+            newMask.bits[j] |= segment->mask.bits[j];
+        }
+    }
+    bitArrayXor(&newMask, sizeof(newMask), &newMask, (boxBitmask_t *)&andMask);
+
+    if (stickyConditionCount) {
+        boxBitmask_t stickyAndMask, stickyNewMask;
+        memset(&stickyAndMask, 0, sizeof(stickyAndMask));
+        memset(&stickyNewMask, 0, sizeof(stickyNewMask));
+        for (int i = 0; i < stickyConditionCount; i++) {
+            updateMasksForStickyModes(&compiledConditions[stickyConditions[i]], &stickyAndMask, &stickyNewMask);
+        }
+        bitArrayXor(&stickyNewMask, sizeof(stickyNewMask), &stickyNewMask, &stickyAndMask);
+        for (unsigned j = 0; j < ARRAYLEN(newMask.bits); j++) {
+            newMask.bits[j] |= stickyNewMask.bits[j];
+        }
+    }
 
+    // Update linked modes
+    for (int i = 0; i < linkedConditionCount; i++) {
+        const modeActivationCondition_t *mac = &compiledConditions[linkedConditions[i]];
         bitArrayCopy(&newMask, mac->linkedTo, mac->modeId);
     }
 
-    rcModeUpdate(&newMask);
+    rcModeActivationMask = newMask;
 }
 
 bool isModeActivationConditionPresent(boxId_e modeId)
@@ -34,6 +34,7 @@
 #include "drivers/time.h"
 
 #include "fc/config.h"
+#include "fc/direct_setpoint.h"
 #include "fc/fc_core.h"
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
@@ -196,6 +197,12 @@ void failsafeUpdateState(void)
         receivingRxData = false; // force Stage2
     }
 
+#ifdef USE_DIRECT_SETPOINT
+    if (directSetpointFailsafeRequested()) {
+        receivingRxData = false; // the companion computer stopped sending setpoints
+    }
+#endif
+
     // Beep RX lost only if we are not seeing data and we have been armed earlier
     if (!receivingRxData && ARMING_FLAG(WAS_EVER_ARMED)) {
         beeperMode = BEEPER_RX_LOST;
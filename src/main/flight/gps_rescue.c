@@ -416,7 +416,7 @@ void rescueAttainPosition()
 // Very similar to maghold function on betaflight/cleanflight
 void setBearing(int16_t desiredHeading)
 {
-    float errorAngle = (attitude.values.yaw / 10.0f) - desiredHeading;
+    float errorAngle = (getAttitude()->values.yaw / 10.0f) - desiredHeading;
 
     // Determine the most efficient direction to rotate
     if (errorAngle <= -180) {
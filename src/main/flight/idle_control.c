@@ -0,0 +1,133 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Closed-loop idle, raises the command of each motor just enough to keep it at or above a minimum rpm.
+ *
+ * A PI controller per motor runs on the rpm reported by the ESC telemetry and sets a floor under the motor
+ * command. The gains are precomputed in motor output units, so an update is a multiply-accumulate and two
+ * clamps per motor. The floor never rises more than the configured increase above the idle.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_IDLE_CONTROL
+
+#include "common/maths.h"
+
+#include "config/feature.h"
+
+#include "drivers/pwm_output_counts.h"
+
+#include "flight/idle_control.h"
+#include "flight/mixer.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#include "sensors/rpm_filter.h"
+
+PG_REGISTER_WITH_RESET_TEMPLATE(idleControlConfig_t, idleControlConfig, PG_IDLE_CONTROL_CONFIG, 0);
+
+PG_RESET_TEMPLATE(idleControlConfig_t, idleControlConfig,
+    .idle_min_rpm = 0,
+    .idle_p = 5,
+    .idle_i = 50,
+    .idle_max_increase = 5,
+);
+
+static FAST_RAM_ZERO_INIT uint8_t idleMotorCount;
+static FAST_RAM_ZERO_INIT bool idleRunning;
+static FAST_RAM_ZERO_INIT float idleOutputLow;
+static FAST_RAM_ZERO_INIT float idleMinFrequencyHz;
+static FAST_RAM_ZERO_INIT float idlePGain;          // motor output per Hz below the minimum
+static FAST_RAM_ZERO_INIT float idleIGain;          // motor output per Hz below the minimum per PID loop
+static FAST_RAM_ZERO_INIT float idleMaxIncrease;
+static FAST_RAM_ZERO_INIT float idleIntegral[MAX_SUPPORTED_MOTORS];
+static FAST_RAM_ZERO_INIT float idleFloor[MAX_SUPPORTED_MOTORS];
+
+static void idleControlReset(void)
+{
+    memset(idleIntegral, 0, sizeof(idleIntegral));
+    memset(idleFloor, 0, sizeof(idleFloor));
+    idleRunning = false;
+}
+
+void idleControlInit(float motorOutputLow, float motorOutputHigh, uint32_t pidLooptimeUs)
+{
+    idleMotorCount = 0;
+    idleControlReset();
+
+    const idleControlConfig_t *config = idleControlConfig();
+    // 3D mode has an idle on either side of the deadband, and the telemetry does not report the direction
+    if (config->idle_min_rpm == 0 || feature(FEATURE_3D) || !rpmHasMotorFrequencies() || motorOutputHigh <= motorOutputLow) {
+        return;
+    }
+
+    const float outputPerHz = (motorOutputHigh - motorOutputLow) / 100.0f * 60.0f / 1000.0f;
+    idleOutputLow = motorOutputLow;
+    idleMinFrequencyHz = config->idle_min_rpm / 60.0f;
+    idlePGain = config->idle_p * outputPerHz;
+    idleIGain = config->idle_i * outputPerHz * pidLooptimeUs * 0.000001f;
+    idleMaxIncrease = (motorOutputHigh - motorOutputLow) * config->idle_max_increase / 100.0f;
+    idleMotorCount = MIN(getMotorCount(), MAX_SUPPORTED_MOTORS);
+}
+
+// Called once per mixer run, the controller only runs while the motors are meant to spin
+FAST_CODE void idleControlUpdate(bool active)
+{
+    if (idleMotorCount == 0) {
+        return;
+    }
+    if (!active) {
+        if (idleRunning) {
+            idleControlReset();
+        }
+        return;
+    }
+    idleRunning = true;
+
+    for (int motor = 0; motor < idleMotorCount; motor++) {
+        float frequencyHz;
+        if (!rpmReadMotorFrequencyHz(motor, &frequencyHz)) {
+            // the floor is held until the telemetry of the motor is current again
+            continue;
+        }
+        const float errorHz = idleMinFrequencyHz - frequencyHz;
+        idleIntegral[motor] = constrainf(idleIntegral[motor] + idleIGain * errorHz, 0.0f, idleMaxIncrease);
+        idleFloor[motor] = idleOutputLow + constrainf(idlePGain * errorHz + idleIntegral[motor], 0.0f, idleMaxIncrease);
+    }
+}
+
+// Raises a motor output to the floor of the motor. Outputs below idle, such as the disarm command, are passed through.
+FAST_CODE float idleControlApply(int motor, float motorOutput)
+{
+    if (motorOutput < idleOutputLow) {
+        return motorOutput;
+    }
+    return MAX(motorOutput, idleFloor[motor]);
+}
+
+#endif // USE_IDLE_CONTROL
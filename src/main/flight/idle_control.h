@@ -0,0 +1,40 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pg/pg.h"
+
+typedef struct idleControlConfig_s {
+    uint16_t idle_min_rpm;          // the motors are held at or above this rpm while armed, 0 disables the controller
+    uint8_t idle_p;                 // percent of the motor range added per 1000 rpm below the minimum
+    uint8_t idle_i;                 // percent of the motor range added per second per 1000 rpm below the minimum
+    uint8_t idle_max_increase;      // most the idle is raised, in percent of the motor range
+} idleControlConfig_t;
+
+PG_DECLARE(idleControlConfig_t, idleControlConfig);
+
+void idleControlInit(float motorOutputLow, float motorOutputHigh, uint32_t pidLooptimeUs);
+void idleControlUpdate(bool active);
+float idleControlApply(int motor, float motorOutput);
@@ -50,6 +50,17 @@
 #include "sensors/gyro.h"
 #include "sensors/sensors.h"
 
+#ifdef USE_IMU_FAST_PROPAGATION
+#include "build/atomic.h"
+
+#include "drivers/nvic.h"
+
+// the PID loop may run from an interrupt and propagate q at the same time
+#define IMU_ATOMIC_BLOCK ATOMIC_BLOCK(NVIC_PRIO_GYRO_PID_SWI)
+#else
+#define IMU_ATOMIC_BLOCK
+#endif
+
 #if defined(SIMULATOR_BUILD) && defined(SIMULATOR_MULTITHREAD)
 #include <stdio.h>
 #include <pthread.h>
@@ -109,7 +120,18 @@ quaternion headfree = QUATERNION_INITIALIZE;
 quaternion offset = QUATERNION_INITIALIZE;
 
 // absolute angle inclination in multiple of 0.1 degree    180 deg = 1800
-attitudeEulerAngles_t attitude = EULER_INITIALIZE;
+STATIC_UNIT_TESTED attitudeEulerAngles_t attitude = EULER_INITIALIZE;
+
+TOPIC_DEFINE(attitudeAngles, attitudeEulerAngles_t);
+
+// rMat and attitude are computed from q on demand, each remembers the generation of q it was computed from
+#ifdef USE_IMU_FAST_PROPAGATION
+static volatile uint32_t quaternionGeneration;
+#else
+static uint32_t quaternionGeneration;
+#endif
+static uint32_t rMatGeneration;
+static uint32_t eulerGeneration;
 
 PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 0);
 
@@ -140,6 +162,17 @@ STATIC_UNIT_TESTED void imuComputeRotationMatrix(void){
     rMat[1][0] = -2.0f * (qP.xy - -qP.wz);
     rMat[2][0] = -2.0f * (qP.xz + -qP.wy);
 #endif
+
+    rMatGeneration = quaternionGeneration;
+}
+
+static void imuRefreshRotationMatrix(void)
+{
+    IMU_ATOMIC_BLOCK {
+        if (rMatGeneration != quaternionGeneration) {
+            imuComputeRotationMatrix();
+        }
+    }
 }
 
 /*
@@ -188,6 +221,17 @@ void imuInit(void)
 #endif
 }
 
+// Accumulates the earth frame acceleration without gravity, integrated by the altitude estimator
+static void imuAccumulateAcceleration(timeDelta_t deltaT)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        accSum[axis] += lrintf(rMat[axis][X] * accAverage[X] + rMat[axis][Y] * accAverage[Y] + rMat[axis][Z] * accAverage[Z]);
+    }
+    accSum[Z] -= acc.dev.acc_1G;
+    accSumCount++;
+    accTimeSum += deltaT;
+}
+
 void imuResetAccelerationSum(void)
 {
     accSum[0] = 0;
@@ -197,9 +241,32 @@ void imuResetAccelerationSum(void)
     accTimeSum = 0;
 }
 
-static float invSqrt(float x)
+static FAST_CODE void imuIntegrateQuaternion(float dt, float gx, float gy, float gz)
 {
-    return 1.0f / sqrtf(x);
+    // Integrate rate of change of quaternion
+    gx *= (0.5f * dt);
+    gy *= (0.5f * dt);
+    gz *= (0.5f * dt);
+
+    quaternion buffer;
+    buffer.w = q.w;
+    buffer.x = q.x;
+    buffer.y = q.y;
+    buffer.z = q.z;
+
+    q.w += (-buffer.x * gx - buffer.y * gy - buffer.z * gz);
+    q.x += (+buffer.w * gx + buffer.y * gz - buffer.z * gy);
+    q.y += (+buffer.w * gy - buffer.x * gz + buffer.z * gx);
+    q.z += (+buffer.w * gz + buffer.x * gy - buffer.y * gx);
+
+    // Normalise quaternion
+    float recipNorm = invSqrt(sq(q.w) + sq(q.x) + sq(q.y) + sq(q.z));
+    q.w *= recipNorm;
+    q.x *= recipNorm;
+    q.y *= recipNorm;
+    q.z *= recipNorm;
+
+    quaternionGeneration++;
 }
 
 static void imuMahonyAHRSupdate(float dt, float gx, float gy, float gz,
@@ -223,7 +290,9 @@ static void imuMahonyAHRSupdate(float dt, float gx, float gy, float gz,
             courseOverGround += (2.0f * M_PIf);
         }
 
-        const float ez_ef = (- sin_approx(courseOverGround) * rMat[0][0] - cos_approx(courseOverGround) * rMat[1][0]);
+        float sinCourse, cosCourse;
+        sincos_approx(courseOverGround, &sinCourse, &cosCourse);
+        const float ez_ef = (- sinCourse * rMat[0][0] - cosCourse * rMat[1][0]);
 
         ex = rMat[2][0] * ez_ef;
         ey = rMat[2][1] * ez_ef;
@@ -294,36 +363,21 @@ static void imuMahonyAHRSupdate(float dt, float gx, float gy, float gz,
         integralFBz = 0.0f;
     }
 
+#ifdef USE_IMU_FAST_PROPAGATION
+    // the gyro has already been integrated at the PID rate by imuPropagateAttitude(), only apply the correction
+    gx = 0.0f;
+    gy = 0.0f;
+    gz = 0.0f;
+#endif
+
     // Apply proportional and integral feedback
     gx += dcmKpGain * ex + integralFBx;
     gy += dcmKpGain * ey + integralFBy;
     gz += dcmKpGain * ez + integralFBz;
 
-    // Integrate rate of change of quaternion
-    gx *= (0.5f * dt);
-    gy *= (0.5f * dt);
-    gz *= (0.5f * dt);
-
-    quaternion buffer;
-    buffer.w = q.w;
-    buffer.x = q.x;
-    buffer.y = q.y;
-    buffer.z = q.z;
-
-    q.w += (-buffer.x * gx - buffer.y * gy - buffer.z * gz);
-    q.x += (+buffer.w * gx + buffer.y * gz - buffer.z * gy);
-    q.y += (+buffer.w * gy - buffer.x * gz + buffer.z * gx);
-    q.z += (+buffer.w * gz + buffer.x * gy - buffer.y * gx);
-
-    // Normalise quaternion
-    float recipNorm = invSqrt(sq(q.w) + sq(q.x) + sq(q.y) + sq(q.z));
-    q.w *= recipNorm;
-    q.x *= recipNorm;
-    q.y *= recipNorm;
-    q.z *= recipNorm;
-
-    // Pre-compute rotation matrix from quaternion
-    imuComputeRotationMatrix();
+    IMU_ATOMIC_BLOCK {
+        imuIntegrateQuaternion(dt, gx, gy, gz);
+    }
 }
 
 STATIC_UNIT_TESTED void imuUpdateEulerAngles(void)
@@ -344,8 +398,21 @@ STATIC_UNIT_TESTED void imuUpdateEulerAngles(void)
 
     if (attitude.values.yaw < 0)
         attitude.values.yaw += 3600;
+}
 
-    // Update small angle state
+static void imuRefreshEulerAngles(void)
+{
+    IMU_ATOMIC_BLOCK {
+        if (eulerGeneration != quaternionGeneration) {
+            imuRefreshRotationMatrix();
+            imuUpdateEulerAngles();
+            eulerGeneration = rMatGeneration;
+        }
+    }
+}
+
+STATIC_UNIT_TESTED void imuUpdateSmallAngleState(void)
+{
     if (rMat[2][2] > smallAngleCosZ) {
         ENABLE_STATE(SMALL_ANGLE);
     } else {
@@ -468,6 +535,7 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs)
         if (useCOG && shouldInitializeGPSHeading()) {
             // Reset our reference and reinitialize quaternion.  This will likely ideally happen more than once per flight, but for now,
             // shouldInitializeGPSHeading() returns true only once.
+            imuRefreshEulerAngles();
             imuComputeQuaternionFromRPY(&qP, attitude.values.roll, attitude.values.pitch, gpsSol.groundCourse);
 
             useCOG = false; // Don't use the COG when we first reinitialize.  Next time around though, yes.
@@ -478,6 +546,8 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs)
 #if defined(SIMULATOR_BUILD) && defined(SKIP_IMU_CALC)
     UNUSED(imuMahonyAHRSupdate);
     UNUSED(imuIsAccelerometerHealthy);
+    UNUSED(imuUpdateSmallAngleState);
+    UNUSED(imuAccumulateAcceleration);
     UNUSED(useAcc);
     UNUSED(useMag);
     UNUSED(useCOG);
@@ -490,9 +560,13 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs)
 //  printf("[imu]deltaT = %u, imuDeltaT = %u, currentTimeUs = %u, micros64_real = %lu\n", deltaT, imuDeltaT, currentTimeUs, micros64_real());
     deltaT = imuDeltaT;
 #endif
+    // the correction is based on the current attitude
+    imuRefreshRotationMatrix();
+
     float gyroAverage[XYZ_AXIS_COUNT];
     gyroGetAccumulationAverage(gyroAverage);
-    if (accGetAccumulationAverage(accAverage)) {
+    const bool haveAccAverage = accGetAccumulationAverage(accAverage);
+    if (haveAccAverage) {
         useAcc = imuIsAccelerometerHealthy(accAverage);
     }
 
@@ -502,7 +576,13 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs)
                         useMag, mag.magADC[X], mag.magADC[Y], mag.magADC[Z],
                         useCOG, courseOverGround,  imuCalcKpGain(currentTimeUs, useAcc, gyroAverage));
 
-    imuUpdateEulerAngles();
+    imuRefreshRotationMatrix();
+    imuUpdateSmallAngleState();
+
+    if (haveAccAverage) {
+        // includes the accelerations that make the accelerometer unusable for the attitude correction
+        imuAccumulateAcceleration(deltaT);
+    }
 #endif
 }
 
@@ -513,10 +593,11 @@ int calculateThrottleAngleCorrection(void)
     * small angle < 0.86 deg
     * TODO: Define this small angle in config.
     */
-    if (rMat[2][2] <= 0.015f) {
+    const float cosTiltAngle = getCosTiltAngle();
+    if (cosTiltAngle <= 0.015f) {
         return 0;
     }
-    int angle = lrintf(acos_approx(rMat[2][2]) * throttleAngleScale);
+    int angle = lrintf(acos_approx(cosTiltAngle) * throttleAngleScale);
     if (angle > 900)
         angle = 900;
     return lrintf(throttleAngleValue * sin_approx(angle / (900.0f * M_PIf / 2.0f)));
@@ -543,6 +624,8 @@ void imuUpdateAttitude(timeUs_t currentTimeUs)
         }
         mixerSetThrottleAngleCorrection(throttleAngleCorrection);
 
+        attitudeAnglesPublish(getAttitude(), currentTimeUs);
+
     } else {
         acc.accADC[X] = 0;
         acc.accADC[Y] = 0;
@@ -550,6 +633,22 @@ void imuUpdateAttitude(timeUs_t currentTimeUs)
     }
 }
 
+#ifdef USE_IMU_FAST_PROPAGATION
+/*
+ * Propagates the attitude with the filtered gyro once per PID loop, imuUpdateAttitude() then only adds the accelerometer,
+ * magnetometer and GPS corrections. rMat and attitude are computed when they are next read.
+ */
+FAST_CODE void imuPropagateAttitude(timeDelta_t dtUs)
+{
+    if (!sensors(SENSOR_ACC) || !acc.isAccelUpdatedAtLeastOnce) {
+        return;
+    }
+
+    imuIntegrateQuaternion(dtUs * 1e-6f,
+                           DEGREES_TO_RADIANS(gyro.gyroADCf[X]), DEGREES_TO_RADIANS(gyro.gyroADCf[Y]), DEGREES_TO_RADIANS(gyro.gyroADCf[Z]));
+}
+#endif
+
 bool shouldInitializeGPSHeading()
 {
     static bool initialized = false;
@@ -565,9 +664,18 @@ bool shouldInitializeGPSHeading()
 
 float getCosTiltAngle(void)
 {
+    imuRefreshRotationMatrix();
+
     return rMat[2][2];
 }
 
+const attitudeEulerAngles_t *getAttitude(void)
+{
+    imuRefreshEulerAngles();
+
+    return &attitude;
+}
+
 void getQuaternion(quaternion *quat)
 {
    quat->w = q.w;
@@ -590,14 +698,14 @@ void imuComputeQuaternionFromRPY(quaternionProducts *quatProd, int16_t initialRo
         initialYaw -= 3600;
     }
 
-    const float cosRoll = cos_approx(DECIDEGREES_TO_RADIANS(initialRoll) * 0.5f);
-    const float sinRoll = sin_approx(DECIDEGREES_TO_RADIANS(initialRoll) * 0.5f);
+    float sinRoll, cosRoll;
+    sincos_approx(DECIDEGREES_TO_RADIANS(initialRoll) * 0.5f, &sinRoll, &cosRoll);
 
-    const float cosPitch = cos_approx(DECIDEGREES_TO_RADIANS(initialPitch) * 0.5f);
-    const float sinPitch = sin_approx(DECIDEGREES_TO_RADIANS(initialPitch) * 0.5f);
+    float sinPitch, cosPitch;
+    sincos_approx(DECIDEGREES_TO_RADIANS(initialPitch) * 0.5f, &sinPitch, &cosPitch);
 
-    const float cosYaw = cos_approx(DECIDEGREES_TO_RADIANS(-initialYaw) * 0.5f);
-    const float sinYaw = sin_approx(DECIDEGREES_TO_RADIANS(-initialYaw) * 0.5f);
+    float sinYaw, cosYaw;
+    sincos_approx(DECIDEGREES_TO_RADIANS(-initialYaw) * 0.5f, &sinYaw, &cosYaw);
 
     const float q0 = cosRoll * cosPitch * cosYaw + sinRoll * sinPitch * sinYaw;
     const float q1 = sinRoll * cosPitch * cosYaw - cosRoll * sinPitch * sinYaw;
@@ -627,6 +735,7 @@ void imuSetAttitudeRPY(float roll, float pitch, float yaw)
     attitude.values.roll = roll * 10;
     attitude.values.pitch = pitch * 10;
     attitude.values.yaw = yaw * 10;
+    eulerGeneration = quaternionGeneration;
 
     IMU_UNLOCK;
 }
@@ -639,8 +748,7 @@ void imuSetAttitudeQuat(float w, float x, float y, float z)
     q.y = y;
     q.z = z;
 
-    imuComputeRotationMatrix();
-    imuUpdateEulerAngles();
+    quaternionGeneration++;
 
     IMU_UNLOCK;
 }
@@ -673,13 +781,14 @@ void imuQuaternionComputeProducts(quaternion *quat, quaternionProducts *quatProd
 
 bool imuQuaternionHeadfreeOffsetSet(void)
 {
-    if ((ABS(attitude.values.roll) < 450)  && (ABS(attitude.values.pitch) < 450)) {
+    const attitudeEulerAngles_t *currentAttitude = getAttitude();
+
+    if ((ABS(currentAttitude->values.roll) < 450)  && (ABS(currentAttitude->values.pitch) < 450)) {
         const float yaw = -atan2_approx((+2.0f * (qP.wz + qP.xy)), (+1.0f - 2.0f * (qP.yy + qP.zz)));
 
-        offset.w = cos_approx(yaw/2);
+        sincos_approx(yaw/2, &offset.z, &offset.w);
         offset.x = 0;
         offset.y = 0;
-        offset.z = sin_approx(yaw/2);
 
         return true;
     } else {
@@ -23,6 +23,7 @@
 #include "common/axis.h"
 #include "common/time.h"
 #include "common/maths.h"
+#include "common/topic.h"
 #include "pg/pg.h"
 
 // Exported symbols
@@ -54,7 +55,7 @@ typedef union {
 } attitudeEulerAngles_t;
 #define EULER_INITIALIZE  { { 0, 0, 0 } }
 
-extern attitudeEulerAngles_t attitude;
+TOPIC_DECLARE(attitudeAngles, attitudeEulerAngles_t);
 
 typedef struct accDeadband_s {
     uint8_t xy;                 // set the acc deadband for xy-Axis
@@ -82,8 +83,10 @@ typedef struct imuRuntimeConfig_s {
 void imuConfigure(uint16_t throttle_correction_angle, uint8_t throttle_correction_value);
 
 float getCosTiltAngle(void);
+const attitudeEulerAngles_t *getAttitude(void);
 void getQuaternion(quaternion * q);
 void imuUpdateAttitude(timeUs_t currentTimeUs);
+void imuPropagateAttitude(timeDelta_t dtUs);
 
 void imuResetAccelerationSum(void);
 void imuInit(void);
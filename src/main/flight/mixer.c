@@ -55,9 +55,11 @@
 #include "flight/failsafe.h"
 #include "flight/imu.h"
 #include "flight/gps_rescue.h"
+#include "flight/idle_control.h"
 #include "flight/mixer.h"
 #include "flight/mixer_tricopter.h"
 #include "flight/pid.h"
+#include "flight/thrust_curve.h"
 
 #include "rx/rx.h"
 
@@ -75,7 +77,7 @@ PG_RESET_TEMPLATE(mixerConfig_t, mixerConfig,
     .crashflip_motor_percent = 0,
 );
 
-PG_REGISTER_WITH_RESET_FN(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 1);
+PG_REGISTER_WITH_RESET_FN(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 2);
 
 void pgResetFn_motorConfig(motorConfig_t *motorConfig)
 {
@@ -121,11 +123,30 @@ static FAST_RAM_ZERO_INIT uint8_t motorCount;
 static FAST_RAM_ZERO_INIT float motorMixRange;
 
 float FAST_RAM_ZERO_INIT motor[MAX_SUPPORTED_MOTORS];
-float motor_disarmed[MAX_SUPPORTED_MOTORS];
+float FAST_RAM_ZERO_INIT motor_disarmed[MAX_SUPPORTED_MOTORS];
 
 mixerMode_e currentMixerMode;
 static motorMixer_t currentMixer[MAX_SUPPORTED_MOTORS];
 
+// currentMixer with the PID mixer scaling folded in, one row per axis so the mix of all motors is a single pass
+typedef struct mixerMatrix_s {
+    float roll[MAX_SUPPORTED_MOTORS];
+    float pitch[MAX_SUPPORTED_MOTORS];
+    float yaw[MAX_SUPPORTED_MOTORS];
+    float throttle[MAX_SUPPORTED_MOTORS];
+} mixerMatrix_t;
+
+static FAST_RAM_ZERO_INIT mixerMatrix_t mixerMatrix;
+
+#ifdef USE_DSHOT
+// DShot frames sent on the gyro loops between PID updates, either repeating the motor outputs
+// or stepping towards them from the previous ones over the PID loop
+static FAST_RAM_ZERO_INIT uint8_t motorOversample;
+static FAST_RAM_ZERO_INIT uint8_t motorOversampleCount;
+static FAST_RAM_ZERO_INIT uint8_t motorOversampleStepsLeft;
+static FAST_RAM_ZERO_INIT float motorOversampleStep[MAX_SUPPORTED_MOTORS];
+#endif
+
 static FAST_RAM_ZERO_INIT int throttleAngleCorrection;
 
 
@@ -416,7 +437,45 @@ void initEscEndpoints(void)
 
     rcCommandThrottleRange3dLow = rcCommand3dDeadBandLow - PWM_RANGE_MIN;
     rcCommandThrottleRange3dHigh = PWM_RANGE_MAX - rcCommand3dDeadBandHigh;
+
+#ifdef USE_THRUST_CURVE
+    // the curve covers the range from idle to full throttle, which 3D mode splits in two
+    if (!feature(FEATURE_3D)) {
+        thrustCurveInit(motorOutputLow, motorOutputHigh);
+    }
+#endif
+}
+
+#ifdef USE_DSHOT
+// ESC turnaround before a bidirectional DShot reply
+#define MOTOR_OVERSAMPLE_TELEMETRY_TURNAROUND_US 30
+
+void mixerInitMotorOversample(uint32_t gyroLooptimeUs)
+{
+    motorOversample = MOTOR_OVERSAMPLE_OFF;
+    motorOversampleCount = pidConfig()->pid_process_denom;
+    if (!isMotorProtocolDshot() || motorOversampleCount < 2) {
+        return;
+    }
+
+    // a frame, and the reply to it, has to be complete before the next gyro loop
+    uint32_t frameUs = DSHOT_DMA_BUFFER_SIZE * MOTOR_BITLENGTH * 1000000 / getDshotHz(motorConfig()->dev.motorPwmProtocol);
+#ifdef USE_DSHOT_TELEMETRY
+    if (useDshotTelemetry) {
+        frameUs = 2 * frameUs + MOTOR_OVERSAMPLE_TELEMETRY_TURNAROUND_US;
+    }
+#endif
+    if (frameUs >= gyroLooptimeUs) {
+        return;
+    }
+
+    motorOversample = pidConfig()->motor_oversample;
+    if (motorOversample == MOTOR_OVERSAMPLE_INTERPOLATE && feature(FEATURE_3D)) {
+        // stepping would cross the deadband between the directions
+        motorOversample = MOTOR_OVERSAMPLE_HOLD;
+    }
 }
+#endif
 
 void mixerInit(mixerMode_e mixerMode)
 {
@@ -428,6 +487,17 @@ void mixerInit(mixerMode_e mixerMode)
     }
 }
 
+static void mixerBuildMatrix(void)
+{
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        const bool used = i < motorCount;
+        mixerMatrix.roll[i] = used ? currentMixer[i].roll / PID_MIXER_SCALING : 0.0f;
+        mixerMatrix.pitch[i] = used ? currentMixer[i].pitch / PID_MIXER_SCALING : 0.0f;
+        mixerMatrix.yaw[i] = used ? currentMixer[i].yaw / PID_MIXER_SCALING : 0.0f;
+        mixerMatrix.throttle[i] = used ? currentMixer[i].throttle : 0.0f;
+    }
+}
+
 #ifndef USE_QUAD_MIXER_ONLY
 
 void mixerConfigureOutput(void)
@@ -455,6 +525,7 @@ void mixerConfigureOutput(void)
                 currentMixer[i] = mixers[currentMixerMode].motor[i];
         }
     }
+    mixerBuildMatrix();
     mixerResetDisarmedMotors();
 }
 
@@ -480,6 +551,7 @@ void mixerConfigureOutput(void)
     for (int i = 0; i < motorCount; i++) {
         currentMixer[i] = mixerQuadX[i];
     }
+    mixerBuildMatrix();
     mixerResetDisarmedMotors();
 }
 #endif // USE_QUAD_MIXER_ONLY
@@ -502,6 +574,23 @@ void writeMotors(void)
     }
 }
 
+// Called on the gyro loops without a PID update
+FAST_CODE void mixerOversampleMotors(void)
+{
+#ifdef USE_DSHOT
+    if (motorOversample == MOTOR_OVERSAMPLE_OFF) {
+        return;
+    }
+    if (motorOversampleStepsLeft > 0) {
+        for (int i = 0; i < motorCount; i++) {
+            motor[i] += motorOversampleStep[i];
+        }
+        motorOversampleStepsLeft--;
+    }
+    writeMotors();
+#endif
+}
+
 static void writeAllMotors(int16_t mc)
 {
     // Sends commands to all motors
@@ -690,29 +779,57 @@ static void applyFlipOverAfterCrashModeToMotors(void)
     }
 }
 
-static void applyMixToMotors(float motorMix[MAX_SUPPORTED_MOTORS])
+// mixScale normalises the mix when its range exceeds the motor range
+static void applyMixToMotors(const float motorMix[MAX_SUPPORTED_MOTORS], float mixScale)
 {
+    // conditions that are the same for every motor are resolved before the loop
+    const float mixGain = motorOutputRange * motorOutputMixSign * mixScale;
+    const float throttleGain = motorOutputRange * throttle;
+    const bool tricopter = mixerIsTricopter();
+    const bool failsafeActive = failsafeIsActive();
+    // Prevent getting into special reserved range
+    const bool failsafeDshot = failsafeActive && isMotorProtocolDshot();
+    const float outputMin = failsafeActive ? disarmMotorOutput : motorRangeMin;
+    // Motor stop handling
+    const bool motorStop = feature(FEATURE_MOTOR_STOP) && ARMING_FLAG(ARMED) && !feature(FEATURE_3D) && !isAirmodeActive()
+        && rcData[THROTTLE] < rxConfig()->mincheck;
+#ifdef USE_DSHOT
+    const bool interpolate = motorOversample == MOTOR_OVERSAMPLE_INTERPOLATE && ARMING_FLAG(ARMED);
+    motorOversampleStepsLeft = interpolate ? motorOversampleCount - 1 : 0;
+#endif
+#ifdef USE_IDLE_CONTROL
+    idleControlUpdate(ARMING_FLAG(ARMED) && !motorStop);
+#endif
+
     // Now add in the desired throttle, but keep in a range that doesn't clip adjusted
     // roll/pitch/yaw. This could move throttle down, but also up for those low throttle flips.
     for (int i = 0; i < motorCount; i++) {
-        float motorOutput = motorOutputMin + (motorOutputRange * (motorOutputMixSign * motorMix[i] + throttle * currentMixer[i].throttle));
-        if (mixerIsTricopter()) {
+        float motorOutput = motorOutputMin + mixGain * motorMix[i] + throttleGain * mixerMatrix.throttle[i];
+        if (tricopter) {
             motorOutput += mixerTricopterMotorCorrection(i);
         }
-        if (failsafeIsActive()) {
-            if (isMotorProtocolDshot()) {
-                motorOutput = (motorOutput < motorRangeMin) ? disarmMotorOutput : motorOutput; // Prevent getting into special reserved range
-            }
-            motorOutput = constrain(motorOutput, disarmMotorOutput, motorRangeMax);
-        } else {
-            motorOutput = constrain(motorOutput, motorRangeMin, motorRangeMax);
+        if (failsafeDshot && motorOutput < motorRangeMin) {
+            motorOutput = disarmMotorOutput;
         }
-        // Motor stop handling
-        if (feature(FEATURE_MOTOR_STOP) && ARMING_FLAG(ARMED) && !feature(FEATURE_3D) && !isAirmodeActive()) {
-            if (((rcData[THROTTLE]) < rxConfig()->mincheck)) {
-                motorOutput = disarmMotorOutput;
-            }
+        motorOutput = constrain(motorOutput, outputMin, motorRangeMax);
+#ifdef USE_THRUST_CURVE
+        motorOutput = thrustCurveApply(motorOutput);
+#endif
+#ifdef USE_IDLE_CONTROL
+        motorOutput = idleControlApply(i, motorOutput);
+#endif
+        if (motorStop) {
+            motorOutput = disarmMotorOutput;
         }
+#ifdef USE_DSHOT
+        // only step between outputs that spin the motor, stopping and starting is immediate
+        if (interpolate && motor[i] >= motorOutputLow && motorOutput >= motorOutputLow) {
+            motorOversampleStep[i] = (motorOutput - motor[i]) / motorOversampleCount;
+            motorOutput = motor[i] + motorOversampleStep[i];
+        } else {
+            motorOversampleStep[i] = 0.0f;
+        }
+#endif
         motor[i] = motorOutput;
     }
 
@@ -742,6 +859,9 @@ float applyThrottleLimit(float throttle)
 FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensation)
 {
     if (isFlipOverAfterCrashMode()) {
+#ifdef USE_DSHOT
+        motorOversampleStepsLeft = 0;
+#endif
         applyFlipOverAfterCrashModeToMotors();
         return;
     }
@@ -749,11 +869,15 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
     // Find min and max throttle based on conditions. Throttle has to be known before mixing
     calculateThrottleAndCurrentMotorEndpoints(currentTimeUs);
 
-    // Calculate and Limit the PID sum
+    // Calculate voltage compensation
+    const float vbatCompensationFactor = vbatPidCompensation ? calculateVbatPidCompensation() : 1.0f;
+
+    // Calculate and Limit the PID sum, the mixer scaling is part of the mixer matrix
+    // and the voltage compensation is applied once per axis rather than once per motor
     const float scaledAxisPidRoll =
-        constrainf(pidData[FD_ROLL].Sum, -currentPidProfile->pidSumLimit, currentPidProfile->pidSumLimit) / PID_MIXER_SCALING;
+        constrainf(pidData[FD_ROLL].Sum, -currentPidProfile->pidSumLimit, currentPidProfile->pidSumLimit) * vbatCompensationFactor;
     const float scaledAxisPidPitch =
-        constrainf(pidData[FD_PITCH].Sum, -currentPidProfile->pidSumLimit, currentPidProfile->pidSumLimit) / PID_MIXER_SCALING;
+        constrainf(pidData[FD_PITCH].Sum, -currentPidProfile->pidSumLimit, currentPidProfile->pidSumLimit) * vbatCompensationFactor;
 
     uint16_t yawPidSumLimit = currentPidProfile->pidSumLimitYaw;
 
@@ -765,20 +889,22 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
 #endif // USE_YAW_SPIN_RECOVERY
 
     float scaledAxisPidYaw =
-        constrainf(pidData[FD_YAW].Sum, -yawPidSumLimit, yawPidSumLimit) / PID_MIXER_SCALING;
+        constrainf(pidData[FD_YAW].Sum, -yawPidSumLimit, yawPidSumLimit) * vbatCompensationFactor;
 
     if (!mixerConfig()->yaw_motors_reversed) {
         scaledAxisPidYaw = -scaledAxisPidYaw;
     }
 
-    // Calculate voltage compensation
-    const float vbatCompensationFactor = vbatPidCompensation ? calculateVbatPidCompensation() : 1.0f;
-
     // Apply the throttle_limit_percent to scale or limit the throttle based on throttle_limit_type
     if (currentControlRateProfile->throttle_limit_type != THROTTLE_LIMIT_TYPE_OFF) {
         throttle = applyThrottleLimit(throttle);
     }
 
+#ifdef USE_BATTERY_SAG_COMPENSATION
+    // Scale the throttle with the precomputed no-load voltage drop of the pack, so hover throttle stays the same through the flight
+    throttle = constrainf(throttle * getBatterySagCompensationFactor(), 0.0f, 1.0f);
+#endif
+
 #ifdef USE_YAW_SPIN_RECOVERY
     // 50% throttle provides the maximum authority for yaw recovery when airmode is not active.
     // When airmode is active the throttle setting doesn't impact recovery authority.
@@ -791,12 +917,10 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
     float motorMix[MAX_SUPPORTED_MOTORS];
     float motorMixMax = 0, motorMixMin = 0;
     for (int i = 0; i < motorCount; i++) {
-        float mix =
-            scaledAxisPidRoll  * currentMixer[i].roll +
-            scaledAxisPidPitch * currentMixer[i].pitch +
-            scaledAxisPidYaw   * currentMixer[i].yaw;
-
-        mix *= vbatCompensationFactor;  // Add voltage compensation
+        const float mix =
+            scaledAxisPidRoll  * mixerMatrix.roll[i] +
+            scaledAxisPidPitch * mixerMatrix.pitch[i] +
+            scaledAxisPidYaw   * mixerMatrix.yaw[i];
 
         if (mix > motorMixMax) {
             motorMixMax = mix;
@@ -807,6 +931,12 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
     }
 
     pidUpdateAntiGravityThrottleFilter(throttle);
+
+#ifdef USE_DYN_LPF
+    // the noise grows with the throttle, so the lowpass cutoffs follow it
+    gyroUpdateDynLpf(throttle);
+    pidUpdateDynLpf(throttle);
+#endif
     
 #if defined(USE_THROTTLE_BOOST)
     if (throttleBoost > 0.0f) {
@@ -824,10 +954,10 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
 #endif
 
     motorMixRange = motorMixMax - motorMixMin;
+    float mixScale = 1.0f;
     if (motorMixRange > 1.0f) {
-        for (int i = 0; i < motorCount; i++) {
-            motorMix[i] /= motorMixRange;
-        }
+        // the mix is normalised when it is applied to the motors
+        mixScale = 1.0f / motorMixRange;
         // Get the maximum correction by setting offset to center when airmode enabled
         if (isAirmodeActive()) {
             throttle = 0.5f;
@@ -840,7 +970,7 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
     }
 
     // Apply the mix to motor endpoints
-    applyMixToMotors(motorMix);
+    applyMixToMotors(motorMix, mixScale);
 }
 
 float convertExternalToMotor(uint16_t externalValue)
@@ -871,12 +1001,20 @@ float convertExternalToMotor(uint16_t externalValue)
         break;
     }
 
+#ifdef USE_THRUST_CURVE
+    // external values are proportional to thrust, as the mixer output is
+    return thrustCurveApply(motorValue);
+#else
     return (float)motorValue;
+#endif
 }
 
 uint16_t convertMotorToExternal(float motorValue)
 {
     uint16_t externalValue;
+#ifdef USE_THRUST_CURVE
+    motorValue = thrustCurveInverse(motorValue);
+#endif
     switch ((int)isMotorProtocolDshot()) {
 #ifdef USE_DSHOT
     case true:
@@ -106,6 +106,12 @@ typedef struct motorConfig_s {
 
 PG_DECLARE(motorConfig_t, motorConfig);
 
+typedef enum {
+    MOTOR_OVERSAMPLE_OFF = 0,
+    MOTOR_OVERSAMPLE_HOLD,
+    MOTOR_OVERSAMPLE_INTERPOLATE
+} motorOversample_e;
+
 #define CHANNEL_FORWARDING_DISABLED (uint8_t)0xFF
 
 extern const mixer_t mixers[];
@@ -128,6 +134,8 @@ void mixerResetDisarmedMotors(void);
 void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensation);
 void syncMotors(bool enabled);
 void writeMotors(void);
+void mixerInitMotorOversample(uint32_t gyroLooptimeUs);
+void mixerOversampleMotors(void);
 void stopMotors(void);
 void stopPwmAllMotors(void);
 
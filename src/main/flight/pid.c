@@ -31,6 +31,7 @@
 #include "common/axis.h"
 #include "common/maths.h"
 #include "common/filter.h"
+#include "common/utils.h"
 
 #include "config/config_reset.h"
 #include "pg/pg.h"
@@ -75,13 +76,24 @@ static FAST_RAM_ZERO_INIT bool inCrashRecoveryMode = false;
 static FAST_RAM_ZERO_INIT float dT;
 static FAST_RAM_ZERO_INIT float pidFrequency;
 
+// Yaw may run on every yawPidDenom PID loop only, so the integration and differentiation use the period of each axis
+static FAST_RAM_ZERO_INIT float pidAxisDt[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT float pidAxisFrequency[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT uint8_t yawPidDenom;
+static FAST_RAM_ZERO_INIT uint8_t yawPidCountdown;
+static FAST_RAM_ZERO_INIT bool yawPidDue;
+// the angle and horizon outer loop runs on every levelDenom PID loop, at PID_LEVEL_MAX_FREQUENCY_HZ at most
+static FAST_RAM_ZERO_INIT uint8_t levelDenom;
+static FAST_RAM_ZERO_INIT uint8_t levelCountdown;
+static FAST_RAM_ZERO_INIT bool levelDue;
+
 static FAST_RAM_ZERO_INIT uint8_t antiGravityMode;
 static FAST_RAM_ZERO_INIT float antiGravityThrottleHpf;
 static FAST_RAM_ZERO_INIT uint16_t itermAcceleratorGain;
 static FAST_RAM float antiGravityOsdCutoff = 1.0f;
 static FAST_RAM_ZERO_INIT bool antiGravityEnabled;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(pidConfig_t, pidConfig, PG_PID_CONFIG, 2);
+PG_REGISTER_WITH_RESET_TEMPLATE(pidConfig_t, pidConfig, PG_PID_CONFIG, 5);
 
 #ifdef STM32F10X
 #define PID_PROCESS_DENOM_DEFAULT       1
@@ -96,11 +108,13 @@ PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
     .pid_process_denom = PID_PROCESS_DENOM_DEFAULT,
     .runaway_takeoff_prevention = true,
     .runaway_takeoff_deactivate_throttle = 25,  // throttle level % needed to accumulate deactivation time
-    .runaway_takeoff_deactivate_delay = 500     // Accumulated time (in milliseconds) before deactivation in successful takeoff
+    .runaway_takeoff_deactivate_delay = 500,    // Accumulated time (in milliseconds) before deactivation in successful takeoff
+    .pid_yaw_denom = 1,
 );
 #else
 PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
-    .pid_process_denom = PID_PROCESS_DENOM_DEFAULT
+    .pid_process_denom = PID_PROCESS_DENOM_DEFAULT,
+    .pid_yaw_denom = 1,
 );
 #endif
 
@@ -111,7 +125,7 @@ PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
 
 #define ANTI_GRAVITY_THROTTLE_FILTER_CUTOFF 15  // The anti gravity throttle highpass filter cutoff
 
-PG_REGISTER_ARRAY_WITH_RESET_FN(pidProfile_t, MAX_PROFILE_COUNT, pidProfiles, PG_PID_PROFILE, 5);
+PG_REGISTER_ARRAY_WITH_RESET_FN(pidProfile_t, MAX_PROFILE_COUNT, pidProfiles, PG_PID_PROFILE, 6);
 
 void resetPidProfile(pidProfile_t *pidProfile)
 {
@@ -168,6 +182,8 @@ void resetPidProfile(pidProfile_t *pidProfile)
         .abs_control_limit = 90,
         .abs_control_error_limit = 20,
         .antiGravityMode = ANTI_GRAVITY_SMOOTH,
+        .dyn_lpf_dterm_min_hz = 0,
+        .dyn_lpf_dterm_max_hz = 250,
     );
 }
 
@@ -178,15 +194,51 @@ void pgResetFn_pidProfiles(pidProfile_t *pidProfiles)
     }
 }
 
+static void pidSetDt(float pidLooptimeUs)
+{
+    dT = pidLooptimeUs * 1e-6f;
+    pidFrequency = 1.0f / dT;
+
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        pidAxisDt[axis] = axis == FD_YAW ? dT * yawPidDenom : dT;
+        pidAxisFrequency[axis] = 1.0f / pidAxisDt[axis];
+    }
+}
+
 static void pidSetTargetLooptime(uint32_t pidLooptime)
 {
     targetPidLooptime = pidLooptime;
-    dT = targetPidLooptime * 1e-6f;
-    pidFrequency = 1.0f / dT;
+    yawPidDenom = constrain(pidConfig()->pid_yaw_denom, 1, MAX_PID_YAW_DENOM);
+    pidSetDt(targetPidLooptime);
+    yawPidCountdown = 0;
+
+    const uint32_t levelLooptime = 1000000 / PID_LEVEL_MAX_FREQUENCY_HZ;
+    const uint32_t denom = targetPidLooptime ? MAX((levelLooptime + targetPidLooptime - 1) / targetPidLooptime, 1U) : 1U;
+    levelDenom = MIN(denom, (uint32_t)UINT8_MAX);
+    levelCountdown = 0;
+}
+
+// True on every denom-th call
+static bool pidLoopDue(uint8_t *countdown, uint8_t denom)
+{
+    if (*countdown == 0) {
+        *countdown = denom - 1;
+        return true;
+    }
+    (*countdown)--;
+    return false;
 }
 
 static FAST_RAM float itermAccelerator = 1.0f;
 
+#ifdef USE_GYRO_ODR_TRACKING
+// Integrates and differentiates over the loop time measured against the gyro clock, the filters keep their setup
+void pidUpdateMeasuredLooptime(float pidLooptimeUs)
+{
+    pidSetDt(pidLooptimeUs);
+}
+#endif
+
 void pidSetItermAccelerator(float newItermAccelerator)
 {
     itermAccelerator = newItermAccelerator;
@@ -204,17 +256,29 @@ void pidStabilisationState(pidStabilisationState_e pidControllerState)
 
 const angle_index_t rcAliasToAngleIndexMap[] = { AI_ROLL, AI_PITCH };
 
+// D-term filter stages, each stage filters the axes together
+typedef enum {
+    DTERM_FILTER_STAGE_NONE = 0,
+    DTERM_FILTER_STAGE_PT1,
+    DTERM_FILTER_STAGE_BIQUAD,
+} dtermFilterStage_e;
+
 typedef union dtermLowpass_u {
-    pt1Filter_t pt1Filter;
-    biquadFilter_t biquadFilter;
+    pt1FilterBank3_t pt1Filter;
+    biquadFilterBank3_t biquadFilter;
 } dtermLowpass_t;
 
-static FAST_RAM_ZERO_INIT filterApplyFnPtr dtermNotchApplyFn;
-static FAST_RAM_ZERO_INIT biquadFilter_t dtermNotch[XYZ_AXIS_COUNT];
-static FAST_RAM_ZERO_INIT filterApplyFnPtr dtermLowpassApplyFn;
-static FAST_RAM_ZERO_INIT dtermLowpass_t dtermLowpass[XYZ_AXIS_COUNT];
-static FAST_RAM_ZERO_INIT filterApplyFnPtr dtermLowpass2ApplyFn;
-static FAST_RAM_ZERO_INIT pt1Filter_t dtermLowpass2[XYZ_AXIS_COUNT];
+typedef void (*dtermFilterChainFnPtr)(float *gyroRateDterm);
+
+static FAST_RAM_ZERO_INIT uint8_t dtermNotchStage;
+static FAST_RAM_ZERO_INIT biquadFilterBank3_t dtermNotch;
+static FAST_RAM_ZERO_INIT uint8_t dtermLowpassStage;
+static FAST_RAM_ZERO_INIT dtermLowpass_t dtermLowpass;
+static FAST_RAM_ZERO_INIT uint8_t dtermLowpass2Stage;
+static FAST_RAM_ZERO_INIT pt1FilterBank3_t dtermLowpass2;
+// roll and pitch, and yaw when it has a D gain
+static FAST_RAM_ZERO_INIT uint8_t dtermFilterAxisCount;
+static FAST_RAM_ZERO_INIT dtermFilterChainFnPtr dtermFilterChainFn;
 static FAST_RAM_ZERO_INIT filterApplyFnPtr ptermYawLowpassApplyFn;
 static FAST_RAM_ZERO_INIT pt1Filter_t ptermYawLowpass;
 #if defined(USE_ITERM_RELAX)
@@ -234,18 +298,167 @@ static FAST_RAM_ZERO_INIT uint8_t rcSmoothingFilterType;
 
 static FAST_RAM_ZERO_INIT pt1Filter_t antiGravityThrottleLpf;
 
-void pidInitFilters(const pidProfile_t *pidProfile)
+#ifdef USE_DYN_LPF
+typedef union dtermDynLpfTable_u {
+    pt1GainTable_t pt1Gain;
+    biquadLowpassTable_t biquadLowpass;
+} dtermDynLpfTable_t;
+
+static FAST_RAM_ZERO_INIT uint8_t dynLpfStage;
+static FAST_RAM_ZERO_INIT float dynLpfMinHz;
+static FAST_RAM_ZERO_INIT float dynLpfRangeHz;
+static dtermDynLpfTable_t dynLpfTable;
+#endif
+
+// As pt1FilterBank3Apply() and biquadFilterBank3Apply(), over the first axisCount filters of the bank
+__attribute__((always_inline)) static inline void dtermPt1FilterBankApply(pt1FilterBank3_t *filter, float *values, int axisCount)
 {
-    BUILD_BUG_ON(FD_YAW != 2); // ensure yaw axis is 2
+    const float k = filter->k;
+    for (int axis = 0; axis < axisCount; axis++) {
+        filter->state[axis] = filter->state[axis] + k * (values[axis] - filter->state[axis]);
+        values[axis] = filter->state[axis];
+    }
+}
 
-    if (targetPidLooptime == 0) {
-        // no looptime set, so set all the filters to null
-        dtermNotchApplyFn = nullFilterApply;
-        dtermLowpassApplyFn = nullFilterApply;
-        ptermYawLowpassApplyFn = nullFilterApply;
-        return;
+__attribute__((always_inline)) static inline void dtermBiquadFilterBankApply(biquadFilterBank3_t *filter, float *values, int axisCount)
+{
+    for (int axis = 0; axis < axisCount; axis++) {
+        const float input = values[axis];
+        const float result = filter->b0[axis] * input + filter->x1[axis];
+        filter->x1[axis] = filter->b1[axis] * input - filter->a1[axis] * result + filter->x2[axis];
+        filter->x2[axis] = filter->b2[axis] * input - filter->a2[axis] * result;
+        values[axis] = result;
     }
+}
 
+// Runs the axes through the D-term filter stages, when the stages are constants the disabled ones compile away
+__attribute__((always_inline)) static inline void dtermApplyFilterChain(float *gyroRateDterm, int axisCount,
+    uint8_t notchStage, uint8_t lowpassStage, uint8_t lowpass2Stage)
+{
+    if (notchStage != DTERM_FILTER_STAGE_NONE) {
+        dtermBiquadFilterBankApply(&dtermNotch, gyroRateDterm, axisCount);
+    }
+    switch (lowpassStage) {
+    case DTERM_FILTER_STAGE_PT1:
+        dtermPt1FilterBankApply(&dtermLowpass.pt1Filter, gyroRateDterm, axisCount);
+        break;
+    case DTERM_FILTER_STAGE_BIQUAD:
+        dtermBiquadFilterBankApply(&dtermLowpass.biquadFilter, gyroRateDterm, axisCount);
+        break;
+    default:
+        break;
+    }
+    if (lowpass2Stage != DTERM_FILTER_STAGE_NONE) {
+        dtermPt1FilterBankApply(&dtermLowpass2, gyroRateDterm, axisCount);
+    }
+}
+
+static FAST_CODE void dtermFilterChainGeneric(float *gyroRateDterm)
+{
+    dtermApplyFilterChain(gyroRateDterm, dtermFilterAxisCount, dtermNotchStage, dtermLowpassStage, dtermLowpass2Stage);
+}
+
+#define NONE    DTERM_FILTER_STAGE_NONE
+#define PT1     DTERM_FILTER_STAGE_PT1
+#define BIQUAD  DTERM_FILTER_STAGE_BIQUAD
+
+// Specialised chains for the common combinations of notch, lowpass and lowpass2, on all axes or roll and pitch only
+#define DTERM_FILTER_CHAIN(axisCount, notch, lowpass, lowpass2) \
+static FAST_CODE void dtermFilterChain_ ## axisCount ## _ ## notch ## _ ## lowpass ## _ ## lowpass2(float *gyroRateDterm) \
+{ \
+    dtermApplyFilterChain(gyroRateDterm, axisCount, notch, lowpass, lowpass2); \
+}
+
+DTERM_FILTER_CHAIN(3, NONE, PT1, NONE)
+DTERM_FILTER_CHAIN(3, NONE, PT1, PT1)
+DTERM_FILTER_CHAIN(3, NONE, BIQUAD, NONE)
+DTERM_FILTER_CHAIN(3, NONE, BIQUAD, PT1)
+DTERM_FILTER_CHAIN(3, BIQUAD, PT1, PT1)
+DTERM_FILTER_CHAIN(3, BIQUAD, BIQUAD, PT1)
+DTERM_FILTER_CHAIN(2, NONE, PT1, NONE)
+DTERM_FILTER_CHAIN(2, NONE, PT1, PT1)
+DTERM_FILTER_CHAIN(2, NONE, BIQUAD, NONE)
+DTERM_FILTER_CHAIN(2, NONE, BIQUAD, PT1)
+DTERM_FILTER_CHAIN(2, BIQUAD, PT1, PT1)
+DTERM_FILTER_CHAIN(2, BIQUAD, BIQUAD, PT1)
+
+typedef struct dtermFilterChain_s {
+    uint8_t axisCount;
+    uint8_t notchStage;
+    uint8_t lowpassStage;
+    uint8_t lowpass2Stage;
+    dtermFilterChainFnPtr fn;
+} dtermFilterChain_t;
+
+#define DTERM_FILTER_CHAIN_ENTRY(axisCount, notch, lowpass, lowpass2) \
+    { axisCount, notch, lowpass, lowpass2, dtermFilterChain_ ## axisCount ## _ ## notch ## _ ## lowpass ## _ ## lowpass2 }
+
+static const dtermFilterChain_t dtermFilterChains[] = {
+    DTERM_FILTER_CHAIN_ENTRY(3, NONE, PT1, NONE),
+    DTERM_FILTER_CHAIN_ENTRY(3, NONE, PT1, PT1),
+    DTERM_FILTER_CHAIN_ENTRY(3, NONE, BIQUAD, NONE),
+    DTERM_FILTER_CHAIN_ENTRY(3, NONE, BIQUAD, PT1),
+    DTERM_FILTER_CHAIN_ENTRY(3, BIQUAD, PT1, PT1),
+    DTERM_FILTER_CHAIN_ENTRY(3, BIQUAD, BIQUAD, PT1),
+    DTERM_FILTER_CHAIN_ENTRY(2, NONE, PT1, NONE),
+    DTERM_FILTER_CHAIN_ENTRY(2, NONE, PT1, PT1),
+    DTERM_FILTER_CHAIN_ENTRY(2, NONE, BIQUAD, NONE),
+    DTERM_FILTER_CHAIN_ENTRY(2, NONE, BIQUAD, PT1),
+    DTERM_FILTER_CHAIN_ENTRY(2, BIQUAD, PT1, PT1),
+    DTERM_FILTER_CHAIN_ENTRY(2, BIQUAD, BIQUAD, PT1),
+};
+
+#undef DTERM_FILTER_CHAIN
+#undef DTERM_FILTER_CHAIN_ENTRY
+#undef NONE
+#undef PT1
+#undef BIQUAD
+
+// Selects the chain function for the stages and the yaw D gain, falling back to the generic chain for uncommon combinations
+static void pidInitDtermFilterChain(const pidProfile_t *pidProfile)
+{
+    // the yaw D-term is not worked out without a yaw D gain, so neither is its filtering
+    dtermFilterAxisCount = pidProfile->pid[FD_YAW].D > 0 ? XYZ_AXIS_COUNT : 2;
+
+    dtermFilterChainFn = dtermFilterChainGeneric;
+    for (unsigned i = 0; i < ARRAYLEN(dtermFilterChains); i++) {
+        const dtermFilterChain_t *chain = &dtermFilterChains[i];
+        if (chain->axisCount == dtermFilterAxisCount && chain->notchStage == dtermNotchStage
+            && chain->lowpassStage == dtermLowpassStage && chain->lowpass2Stage == dtermLowpass2Stage) {
+            dtermFilterChainFn = chain->fn;
+            break;
+        }
+    }
+}
+
+// The settings the D-term stages were last set up for, so a retune only works out the stages whose settings changed
+typedef struct dtermFilterSettings_s {
+    uint16_t notchHz;
+    uint16_t notchCutoff;
+    uint16_t lowpassHz;
+    uint16_t lowpass2Hz;
+    uint16_t dynLpfMaxHz;
+    uint8_t lowpassType;
+} dtermFilterSettings_t;
+
+static dtermFilterSettings_t dtermFilterSettings;
+
+// Steps of a retune of the filters, one is taken each PID loop
+typedef enum {
+    PID_FILTER_UPDATE_NONE = 0,
+    PID_FILTER_UPDATE_DTERM_NOTCH,
+    PID_FILTER_UPDATE_DTERM_LOWPASS,
+    PID_FILTER_UPDATE_DTERM_LOWPASS2,
+    PID_FILTER_UPDATE_LOWPASSES,
+    PID_FILTER_UPDATE_COUNT
+} pidFilterUpdateStep_e;
+
+static FAST_RAM_ZERO_INIT uint8_t filterUpdateStep;
+static const pidProfile_t *filterUpdateProfile;
+
+// With retune the coefficients of an unchanged stage are worked out again keeping its state, otherwise the stage is reset
+static void pidInitDtermNotch(const pidProfile_t *pidProfile, bool retune)
+{
     const uint32_t pidFrequencyNyquist = pidFrequency / 2; // No rounding needed
 
     uint16_t dTermNotchHz;
@@ -259,67 +472,231 @@ void pidInitFilters(const pidProfile_t *pidProfile)
         }
     }
 
+    if (retune && dTermNotchHz == dtermFilterSettings.notchHz && pidProfile->dterm_notch_cutoff == dtermFilterSettings.notchCutoff) {
+        return;
+    }
+    dtermFilterSettings.notchHz = dTermNotchHz;
+    dtermFilterSettings.notchCutoff = pidProfile->dterm_notch_cutoff;
+
     if (dTermNotchHz != 0 && pidProfile->dterm_notch_cutoff != 0) {
-        dtermNotchApplyFn = (filterApplyFnPtr)biquadFilterApply;
         const float notchQ = filterGetNotchQ(dTermNotchHz, pidProfile->dterm_notch_cutoff);
-        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-            biquadFilterInit(&dtermNotch[axis], dTermNotchHz, targetPidLooptime, notchQ, FILTER_NOTCH);
+        if (retune && dtermNotchStage == DTERM_FILTER_STAGE_BIQUAD) {
+            biquadFilterBank3SetNotch(&dtermNotch, dTermNotchHz, 2.0f * M_PIf * targetPidLooptime * 0.000001f, notchQ);
+        } else {
+            biquadFilterBank3Init(&dtermNotch, dTermNotchHz, targetPidLooptime, notchQ, FILTER_NOTCH);
         }
+        dtermNotchStage = DTERM_FILTER_STAGE_BIQUAD;
     } else {
-        dtermNotchApplyFn = nullFilterApply;
+        dtermNotchStage = DTERM_FILTER_STAGE_NONE;
     }
+}
 
-    //2nd Dterm Lowpass Filter
-    if (pidProfile->dterm_lowpass2_hz == 0 || pidProfile->dterm_lowpass2_hz > pidFrequencyNyquist) {
-    	dtermLowpass2ApplyFn = nullFilterApply;
-    } else {
-        dtermLowpass2ApplyFn = (filterApplyFnPtr)pt1FilterApply;
-        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-            pt1FilterInit(&dtermLowpass2[axis], pt1FilterGain(pidProfile->dterm_lowpass2_hz, dT));
-        }
+static void pidInitDtermLowpass(const pidProfile_t *pidProfile, bool retune)
+{
+    const uint32_t pidFrequencyNyquist = pidFrequency / 2;
+
+    uint16_t dTermLowpassHz = pidProfile->dterm_lowpass_hz;
+    uint16_t dynLpfMaxHz = 0;
+#ifdef USE_DYN_LPF
+    // the first lowpass starts at the minimum cutoff of the dynamic lowpass
+    if (pidProfile->dyn_lpf_dterm_min_hz > 0) {
+        dTermLowpassHz = pidProfile->dyn_lpf_dterm_min_hz;
+        dynLpfMaxHz = constrain(pidProfile->dyn_lpf_dterm_max_hz, dTermLowpassHz, pidFrequencyNyquist);
     }
+#endif
 
-    if (pidProfile->dterm_lowpass_hz == 0 || pidProfile->dterm_lowpass_hz > pidFrequencyNyquist) {
-        dtermLowpassApplyFn = nullFilterApply;
-    } else {
+    if (retune && dTermLowpassHz == dtermFilterSettings.lowpassHz && dynLpfMaxHz == dtermFilterSettings.dynLpfMaxHz
+        && pidProfile->dterm_filter_type == dtermFilterSettings.lowpassType) {
+        return;
+    }
+    dtermFilterSettings.lowpassHz = dTermLowpassHz;
+    dtermFilterSettings.dynLpfMaxHz = dynLpfMaxHz;
+    dtermFilterSettings.lowpassType = pidProfile->dterm_filter_type;
+
+    uint8_t lowpassStage = DTERM_FILTER_STAGE_NONE;
+    if (dTermLowpassHz != 0 && dTermLowpassHz <= pidFrequencyNyquist) {
         switch (pidProfile->dterm_filter_type) {
-        default:
-            dtermLowpassApplyFn = nullFilterApply;
-            break;
         case FILTER_PT1:
-            dtermLowpassApplyFn = (filterApplyFnPtr)pt1FilterApply;
-            for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-                pt1FilterInit(&dtermLowpass[axis].pt1Filter, pt1FilterGain(pidProfile->dterm_lowpass_hz, dT));
-            }
+            lowpassStage = DTERM_FILTER_STAGE_PT1;
             break;
         case FILTER_BIQUAD:
-            dtermLowpassApplyFn = (filterApplyFnPtr)biquadFilterApply;
-            for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-                biquadFilterInitLPF(&dtermLowpass[axis].biquadFilter, pidProfile->dterm_lowpass_hz, targetPidLooptime);
-            }
+            lowpassStage = DTERM_FILTER_STAGE_BIQUAD;
+            break;
+        default:
+            break;
+        }
+    }
+    retune = retune && lowpassStage == dtermLowpassStage;
+
+#ifdef USE_DYN_LPF
+    dynLpfStage = DTERM_FILTER_STAGE_NONE;
+#endif
+    switch (lowpassStage) {
+    case DTERM_FILTER_STAGE_PT1:
+        if (retune) {
+            dtermLowpass.pt1Filter.k = pt1FilterGain(dTermLowpassHz, dT);
+        } else {
+            pt1FilterBank3Init(&dtermLowpass.pt1Filter, pt1FilterGain(dTermLowpassHz, dT));
+        }
+        break;
+    case DTERM_FILTER_STAGE_BIQUAD:
+        if (retune) {
+            biquadFilterBank3UpdateLPF(&dtermLowpass.biquadFilter, dTermLowpassHz, targetPidLooptime);
+        } else {
+            biquadFilterBank3InitLPF(&dtermLowpass.biquadFilter, dTermLowpassHz, targetPidLooptime);
+        }
+        break;
+    default:
+        break;
+    }
+    dtermLowpassStage = lowpassStage;
+
+#ifdef USE_DYN_LPF
+    if (dynLpfMaxHz > 0) {
+        dynLpfMinHz = dTermLowpassHz;
+        dynLpfRangeHz = dynLpfMaxHz - dTermLowpassHz;
+        switch (dtermLowpassStage) {
+        case DTERM_FILTER_STAGE_PT1:
+            pt1GainTableInit(&dynLpfTable.pt1Gain, dTermLowpassHz, dynLpfMaxHz, dT);
+            dynLpfStage = dtermLowpassStage;
+            break;
+        case DTERM_FILTER_STAGE_BIQUAD:
+            biquadLowpassTableInit(&dynLpfTable.biquadLowpass, dTermLowpassHz, dynLpfMaxHz, targetPidLooptime);
+            dynLpfStage = dtermLowpassStage;
+            break;
+        default:
             break;
         }
     }
+#endif
+}
+
+//2nd Dterm Lowpass Filter
+static void pidInitDtermLowpass2(const pidProfile_t *pidProfile, bool retune)
+{
+    const uint32_t pidFrequencyNyquist = pidFrequency / 2;
+
+    if (retune && pidProfile->dterm_lowpass2_hz == dtermFilterSettings.lowpass2Hz) {
+        return;
+    }
+    dtermFilterSettings.lowpass2Hz = pidProfile->dterm_lowpass2_hz;
+
+    if (pidProfile->dterm_lowpass2_hz == 0 || pidProfile->dterm_lowpass2_hz > pidFrequencyNyquist) {
+        dtermLowpass2Stage = DTERM_FILTER_STAGE_NONE;
+    } else {
+        const float k = pt1FilterGain(pidProfile->dterm_lowpass2_hz, dT);
+        if (retune && dtermLowpass2Stage == DTERM_FILTER_STAGE_PT1) {
+            dtermLowpass2.k = k;
+        } else {
+            pt1FilterBank3Init(&dtermLowpass2, k);
+        }
+        dtermLowpass2Stage = DTERM_FILTER_STAGE_PT1;
+    }
+}
 
-    if (pidProfile->yaw_lowpass_hz == 0 || pidProfile->yaw_lowpass_hz > pidFrequencyNyquist) {
+// The single pole lowpasses of the P, I and anti gravity terms
+static void pidInitLowpasses(const pidProfile_t *pidProfile, bool retune)
+{
+    // the yaw P lowpass runs with the yaw PID
+    if (pidProfile->yaw_lowpass_hz == 0 || pidProfile->yaw_lowpass_hz > pidAxisFrequency[FD_YAW] / 2) {
         ptermYawLowpassApplyFn = nullFilterApply;
     } else {
+        const float k = pt1FilterGain(pidProfile->yaw_lowpass_hz, pidAxisDt[FD_YAW]);
+        if (retune && ptermYawLowpassApplyFn != nullFilterApply) {
+            pt1FilterUpdateCutoff(&ptermYawLowpass, k);
+        } else {
+            pt1FilterInit(&ptermYawLowpass, k);
+        }
         ptermYawLowpassApplyFn = (filterApplyFnPtr)pt1FilterApply;
-        pt1FilterInit(&ptermYawLowpass, pt1FilterGain(pidProfile->yaw_lowpass_hz, dT));
     }
 
 #if defined(USE_THROTTLE_BOOST)
-    pt1FilterInit(&throttleLpf, pt1FilterGain(pidProfile->throttle_boost_cutoff, dT));
+    if (retune) {
+        pt1FilterUpdateCutoff(&throttleLpf, pt1FilterGain(pidProfile->throttle_boost_cutoff, dT));
+    } else {
+        pt1FilterInit(&throttleLpf, pt1FilterGain(pidProfile->throttle_boost_cutoff, dT));
+    }
 #endif
 #if defined(USE_ITERM_RELAX)
     if (itermRelax) {
         for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
-            pt1FilterInit(&windupLpf[i], pt1FilterGain(itermRelaxCutoff, dT));
+            if (retune) {
+                pt1FilterUpdateCutoff(&windupLpf[i], pt1FilterGain(itermRelaxCutoff, pidAxisDt[i]));
+            } else {
+                pt1FilterInit(&windupLpf[i], pt1FilterGain(itermRelaxCutoff, pidAxisDt[i]));
+            }
         }
     }
 #endif
 
-    pt1FilterInit(&antiGravityThrottleLpf, pt1FilterGain(ANTI_GRAVITY_THROTTLE_FILTER_CUTOFF, dT));
+    if (!retune) {
+        pt1FilterInit(&antiGravityThrottleLpf, pt1FilterGain(ANTI_GRAVITY_THROTTLE_FILTER_CUTOFF, dT));
+    }
+}
+
+void pidInitFilters(const pidProfile_t *pidProfile)
+{
+    BUILD_BUG_ON(FD_YAW != 2); // ensure yaw axis is 2
+
+    filterUpdateStep = PID_FILTER_UPDATE_NONE;
+
+    if (targetPidLooptime == 0) {
+        // no looptime set, so set all the filters to null
+        dtermNotchStage = DTERM_FILTER_STAGE_NONE;
+        dtermLowpassStage = DTERM_FILTER_STAGE_NONE;
+        dtermLowpass2Stage = DTERM_FILTER_STAGE_NONE;
+#ifdef USE_DYN_LPF
+        dynLpfStage = DTERM_FILTER_STAGE_NONE;
+#endif
+        pidInitDtermFilterChain(pidProfile);
+        ptermYawLowpassApplyFn = nullFilterApply;
+        return;
+    }
+
+    pidInitDtermNotch(pidProfile, false);
+    pidInitDtermLowpass2(pidProfile, false);
+    pidInitDtermLowpass(pidProfile, false);
+    pidInitDtermFilterChain(pidProfile);
+    pidInitLowpasses(pidProfile, false);
+}
+
+// Retunes the filters to the profile without resetting their state, so the profile can be changed in flight. The
+// work is spread over the next PID loops, a stage at a time, and stages whose settings did not change are skipped.
+void pidUpdateFilters(const pidProfile_t *pidProfile)
+{
+    if (targetPidLooptime == 0) {
+        pidInitFilters(pidProfile);
+        return;
+    }
+
+    filterUpdateProfile = pidProfile;
+    filterUpdateStep = PID_FILTER_UPDATE_DTERM_NOTCH;
+}
+
+static void pidProcessFilterUpdate(void)
+{
+    switch (filterUpdateStep) {
+    case PID_FILTER_UPDATE_DTERM_NOTCH:
+        pidInitDtermNotch(filterUpdateProfile, true);
+        break;
+    case PID_FILTER_UPDATE_DTERM_LOWPASS:
+        pidInitDtermLowpass(filterUpdateProfile, true);
+        break;
+    case PID_FILTER_UPDATE_DTERM_LOWPASS2:
+        pidInitDtermLowpass2(filterUpdateProfile, true);
+        break;
+    case PID_FILTER_UPDATE_LOWPASSES:
+        pidInitLowpasses(filterUpdateProfile, true);
+        break;
+    default:
+        break;
+    }
+    // a stage may have been switched on, off or to another type
+    pidInitDtermFilterChain(filterUpdateProfile);
+
+    if (++filterUpdateStep == PID_FILTER_UPDATE_COUNT) {
+        filterUpdateStep = PID_FILTER_UPDATE_NONE;
+    }
 }
 
 #ifdef USE_RC_SMOOTHING_FILTER
@@ -332,10 +709,10 @@ void pidInitSetpointDerivativeLpf(uint16_t filterCutoff, uint8_t debugAxis, uint
         for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
             switch (rcSmoothingFilterType) {
                 case RC_SMOOTHING_DERIVATIVE_PT1:
-                    pt1FilterInit(&setpointDerivativePt1[axis], pt1FilterGain(filterCutoff, dT));
+                    pt1FilterInit(&setpointDerivativePt1[axis], pt1FilterGain(filterCutoff, pidAxisDt[axis]));
                     break;
                 case RC_SMOOTHING_DERIVATIVE_BIQUAD:
-                    biquadFilterInitLPF(&setpointDerivativeBiquad[axis], filterCutoff, targetPidLooptime);
+                    biquadFilterInitLPF(&setpointDerivativeBiquad[axis], filterCutoff, targetPidLooptime * (axis == FD_YAW ? yawPidDenom : 1));
                     break;
             }
         }
@@ -348,10 +725,10 @@ void pidUpdateSetpointDerivativeLpf(uint16_t filterCutoff)
         for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
             switch (rcSmoothingFilterType) {
                 case RC_SMOOTHING_DERIVATIVE_PT1:
-                    pt1FilterUpdateCutoff(&setpointDerivativePt1[axis], pt1FilterGain(filterCutoff, dT));
+                    pt1FilterUpdateCutoff(&setpointDerivativePt1[axis], pt1FilterGain(filterCutoff, pidAxisDt[axis]));
                     break;
                 case RC_SMOOTHING_DERIVATIVE_BIQUAD:
-                    biquadFilterUpdateLPF(&setpointDerivativeBiquad[axis], filterCutoff, targetPidLooptime);
+                    biquadFilterUpdateLPF(&setpointDerivativeBiquad[axis], filterCutoff, targetPidLooptime * (axis == FD_YAW ? yawPidDenom : 1));
                     break;
             }
         }
@@ -369,6 +746,7 @@ typedef struct pidCoefficient_s {
 static FAST_RAM_ZERO_INIT pidCoefficient_t pidCoefficient[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT float maxVelocity[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT float feedForwardTransition;
+static FAST_RAM_ZERO_INIT bool feedForwardEnabled;
 static FAST_RAM_ZERO_INIT float levelGain, horizonGain, horizonTransition, horizonCutoffDegrees, horizonFactorRatio;
 static FAST_RAM_ZERO_INIT float ITermWindupPointInv;
 static FAST_RAM_ZERO_INIT uint8_t horizonTiltExpertMode;
@@ -423,6 +801,25 @@ void pidUpdateAntiGravityThrottleFilter(float throttle)
     }
 }
 
+#ifdef USE_DYN_LPF
+// Moves the cutoff of the first D lowpass between the minimum and maximum with the throttle, from 0 to 1
+FAST_CODE void pidUpdateDynLpf(float throttle)
+{
+    const float cutoffHz = dynLpfMinHz + constrainf(throttle, 0.0f, 1.0f) * dynLpfRangeHz;
+    switch (dynLpfStage) {
+    case DTERM_FILTER_STAGE_PT1:
+        dtermLowpass.pt1Filter.k = pt1GainFromTable(&dynLpfTable.pt1Gain, cutoffHz);
+        break;
+    case DTERM_FILTER_STAGE_BIQUAD:
+        biquadFilterBank3SetLowpassFromTable(&dtermLowpass.biquadFilter, &dynLpfTable.biquadLowpass, cutoffHz);
+        break;
+    default:
+        return;
+    }
+    DEBUG_SET(DEBUG_DYN_LPF, 1, lrintf(cutoffHz));
+}
+#endif
+
 void pidInitConfig(const pidProfile_t *pidProfile)
 {
     if (pidProfile->feedForwardTransition == 0) {
@@ -430,11 +827,15 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     } else {
         feedForwardTransition = 100.0f / pidProfile->feedForwardTransition;
     }
+    feedForwardEnabled = false;
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
         pidCoefficient[axis].Kp = PTERM_SCALE * pidProfile->pid[axis].P;
         pidCoefficient[axis].Ki = ITERM_SCALE * pidProfile->pid[axis].I;
         pidCoefficient[axis].Kd = DTERM_SCALE * pidProfile->pid[axis].D;
         pidCoefficient[axis].Kf = FEEDFORWARD_SCALE * (pidProfile->pid[axis].F / 100.0f);
+        if (pidCoefficient[axis].Kf > 0) {
+            feedForwardEnabled = true;
+        }
     }
 
     levelGain = pidProfile->pid[PID_LEVEL].P / 10.0f;
@@ -444,7 +845,7 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     horizonCutoffDegrees = (175 - pidProfile->horizon_tilt_effect) * 1.8f;
     horizonFactorRatio = (100 - pidProfile->horizon_tilt_effect) * 0.01f;
     maxVelocity[FD_ROLL] = maxVelocity[FD_PITCH] = pidProfile->rateAccelLimit * 100 * dT;
-    maxVelocity[FD_YAW] = pidProfile->yawRateAccelLimit * 100 * dT;
+    maxVelocity[FD_YAW] = pidProfile->yawRateAccelLimit * 100 * pidAxisDt[FD_YAW];
     const float ITermWindupPoint = (float)pidProfile->itermWindupPointPercent / 100.0f;
     ITermWindupPointInv = 1.0f / (1.0f - ITermWindupPoint);
     itermAcceleratorGain = pidProfile->itermAcceleratorGain;
@@ -454,6 +855,7 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     crashRecoveryRate = pidProfile->crash_recovery_rate;
     crashGyroThreshold = pidProfile->crash_gthreshold;
     crashDtermThreshold = pidProfile->crash_dthreshold;
+    pidInitDtermFilterChain(pidProfile);
     crashSetpointThreshold = pidProfile->crash_setpoint_threshold;
     crashLimitYaw = pidProfile->crash_limit_yaw;
     itermLimit = pidProfile->itermLimit;
@@ -527,7 +929,8 @@ static float calcHorizonLevelStrength(void)
     float horizonLevelStrength = 1.0f - MAX(getRcDeflectionAbs(FD_ROLL), getRcDeflectionAbs(FD_PITCH));
 
     // 0 at level, 90 at vertical, 180 at inverted (degrees):
-    const float currentInclination = MAX(ABS(attitude.values.roll), ABS(attitude.values.pitch)) / 10.0f;
+    const attitudeEulerAngles_t *attitude = getAttitude();
+    const float currentInclination = MAX(ABS(attitude->values.roll), ABS(attitude->values.pitch)) / 10.0f;
 
     // horizonTiltExpertMode:  0 = leveling always active when sticks centered,
     //                         1 = leveling can be totally off when inverted
@@ -576,23 +979,38 @@ static float calcHorizonLevelStrength(void)
     return constrainf(horizonLevelStrength, 0, 1);
 }
 
+// The level correction is worked out when levelDue, and held on the PID loops in between
 static float pidLevel(int axis, const pidProfile_t *pidProfile, const rollAndPitchTrims_t *angleTrim, float currentPidSetpoint) {
-    // calculate error angle and limit the angle to the max inclination
-    // rcDeflection is in range [-1.0, 1.0]
-    float angle = pidProfile->levelAngleLimit * getRcDeflection(axis);
+    static float levelCorrection[2];
+    static bool levelCorrectionAngleMode;
+
+    const bool angleMode = FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(GPS_RESCUE_MODE);
+    if (levelDue || angleMode != levelCorrectionAngleMode) {
+        // calculate error angle and limit the angle to the max inclination
+        // rcDeflection is in range [-1.0, 1.0]
+        float angle = pidProfile->levelAngleLimit * getRcDeflection(axis);
 #ifdef USE_GPS_RESCUE
-    angle += gpsRescueAngle[axis] / 100; // ANGLE IS IN CENTIDEGREES
+        angle += gpsRescueAngle[axis] / 100; // ANGLE IS IN CENTIDEGREES
 #endif
-    angle = constrainf(angle, -pidProfile->levelAngleLimit, pidProfile->levelAngleLimit);
-    const float errorAngle = angle - ((attitude.raw[axis] - angleTrim->raw[axis]) / 10.0f);
-    if (FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(GPS_RESCUE_MODE)) {
+        angle = constrainf(angle, -pidProfile->levelAngleLimit, pidProfile->levelAngleLimit);
+        const float errorAngle = angle - ((getAttitude()->raw[axis] - angleTrim->raw[axis]) / 10.0f);
+        if (angleMode) {
+            levelCorrection[axis] = errorAngle * levelGain;
+        } else {
+            levelCorrection[axis] = errorAngle * horizonGain * calcHorizonLevelStrength();
+        }
+        if (axis == FD_PITCH) {
+            levelCorrectionAngleMode = angleMode;
+        }
+    }
+
+    if (angleMode) {
         // ANGLE mode - control is angle based
-        currentPidSetpoint = errorAngle * levelGain;
+        currentPidSetpoint = levelCorrection[axis];
     } else {
         // HORIZON mode - mix of ANGLE and ACRO modes
         // mix in errorAngle to currentPidSetpoint to add a little auto-level feel
-        const float horizonLevelStrength = calcHorizonLevelStrength();
-        currentPidSetpoint = currentPidSetpoint + (errorAngle * horizonGain * horizonLevelStrength);
+        currentPidSetpoint = currentPidSetpoint + levelCorrection[axis];
     }
     return currentPidSetpoint;
 }
@@ -610,7 +1028,7 @@ static float accelerationLimit(int axis, float currentPidSetpoint)
     return currentPidSetpoint;
 }
 
-static timeUs_t crashDetectedAtUs;
+static FAST_RAM_ZERO_INIT timeUs_t crashDetectedAtUs;
 
 static void handleCrashRecovery(
     const pidCrashRecovery_e crash_recovery, const rollAndPitchTrims_t *angleTrim,
@@ -626,7 +1044,7 @@ static void handleCrashRecovery(
             // on roll and pitch axes calculate currentPidSetpoint and errorRate to level the aircraft to recover from crash
             if (sensors(SENSOR_ACC)) {
                 // errorAngle is deviation from horizontal
-                const float errorAngle =  -(attitude.raw[axis] - angleTrim->raw[axis]) / 10.0f;
+                const float errorAngle =  -(getAttitude()->raw[axis] - angleTrim->raw[axis]) / 10.0f;
                 *currentPidSetpoint = errorAngle * levelGain;
                 *errorRate = *currentPidSetpoint - gyroRate;
             }
@@ -641,8 +1059,9 @@ static void handleCrashRecovery(
                    && ABS(gyro.gyroADCf[FD_YAW]) < crashRecoveryRate)) {
             if (sensors(SENSOR_ACC)) {
                 // check aircraft nearly level
-                if (ABS(attitude.raw[FD_ROLL] - angleTrim->raw[FD_ROLL]) < crashRecoveryAngleDeciDegrees
-                   && ABS(attitude.raw[FD_PITCH] - angleTrim->raw[FD_PITCH]) < crashRecoveryAngleDeciDegrees) {
+                const attitudeEulerAngles_t *attitude = getAttitude();
+                if (ABS(attitude->raw[FD_ROLL] - angleTrim->raw[FD_ROLL]) < crashRecoveryAngleDeciDegrees
+                   && ABS(attitude->raw[FD_PITCH] - angleTrim->raw[FD_PITCH]) < crashRecoveryAngleDeciDegrees) {
                     inCrashRecoveryMode = false;
                     BEEP_OFF;
                 }
@@ -750,7 +1169,7 @@ static FAST_CODE_NOINLINE float applyAcroTrainer(int axis, const rollAndPitchTri
         bool resetIterm = false;
         float projectedAngle = 0;
         const int setpointSign = acroTrainerSign(setPoint);
-        const float currentAngle = (attitude.raw[axis] - angleTrim->raw[axis]) / 10.0f;
+        const float currentAngle = (getAttitude()->raw[axis] - angleTrim->raw[axis]) / 10.0f;
         const int angleSign = acroTrainerSign(currentAngle);
 
         if ((acroTrainerAxisState[axis] != 0) && (acroTrainerAxisState[axis] != setpointSign)) {  // stick has reversed - stop limiting
@@ -837,9 +1256,18 @@ void FAST_CODE applySmartFeedforward(int axis)
 }
 #endif // USE_SMART_FEEDFORWARD
 
+#ifdef USE_PID_CONTROLLER_VARIANTS
+// Inlined into each controller variant, so the tests of the mode arguments are resolved at compile time
+#define PID_CONTROLLER_INLINE inline __attribute__((always_inline))
+#else
+#define PID_CONTROLLER_INLINE
+#endif
+
 // Betaflight pid controller, which will be maintained in the future with additional features specialised for current (mini) multirotor usage.
 // Based on 2DOF reference design (matlab)
-void FAST_CODE pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *angleTrim, timeUs_t currentTimeUs)
+// levelMode: angle, horizon or GPS rescue, feedForward: rate mode with a feedforward gain set, acroTrainer: acro trainer active in rate mode
+static PID_CONTROLLER_INLINE void pidControllerApply(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *angleTrim, timeUs_t currentTimeUs,
+    const bool levelMode, const bool feedForward, const bool acroTrainer)
 {
     static float previousGyroRateDterm[XYZ_AXIS_COUNT];
     static float previousPidSetpoint[XYZ_AXIS_COUNT];
@@ -858,34 +1286,36 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, const rollAndPitchT
     }
     DEBUG_SET(DEBUG_ANTI_GRAVITY, 0, lrintf(itermAccelerator * 1000));
     // gradually scale back integration when above windup point
-    const float dynCi = MIN((1.0f - motorMixRange) * ITermWindupPointInv, 1.0f) * dT * itermAccelerator;
+    const float dynCi = MIN((1.0f - motorMixRange) * ITermWindupPointInv, 1.0f) * itermAccelerator;
 
     // Precalculate gyro deta for D-term here, this allows loop unrolling
-    float gyroRateDterm[XYZ_AXIS_COUNT];
-    for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
-        gyroRateDterm[axis] = dtermNotchApplyFn((filter_t *) &dtermNotch[axis], gyro.gyroADCf[axis]);
-        gyroRateDterm[axis] = dtermLowpassApplyFn((filter_t *) &dtermLowpass[axis], gyroRateDterm[axis]);
-        gyroRateDterm[axis] = dtermLowpass2ApplyFn((filter_t *) &dtermLowpass2[axis], gyroRateDterm[axis]);
-    }
+    float gyroRateDterm[XYZ_AXIS_COUNT] = { gyro.gyroADCf[FD_ROLL], gyro.gyroADCf[FD_PITCH], gyro.gyroADCf[FD_YAW] };
+    dtermFilterChainFn(gyroRateDterm);
 
     rotateITermAndAxisError();
 
     // ----------PID controller----------
     for (int axis = FD_ROLL; axis <= FD_YAW; ++axis) {
+        if (axis == FD_YAW && !yawPidDue) {
+            // yaw holds its output until its next update
+            continue;
+        }
 
         float currentPidSetpoint = getSetpointRate(axis);
         if (maxVelocity[axis]) {
             currentPidSetpoint = accelerationLimit(axis, currentPidSetpoint);
         }
         // Yaw control is GYRO based, direct sticks control is applied to rate PID
-        if ((FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(HORIZON_MODE) || FLIGHT_MODE(GPS_RESCUE_MODE)) && axis != FD_YAW) {
+        if (levelMode && axis != FD_YAW) {
             currentPidSetpoint = pidLevel(axis, pidProfile, angleTrim, currentPidSetpoint);
         }
 
 #ifdef USE_ACRO_TRAINER
-        if ((axis != FD_YAW) && acroTrainerActive && !inCrashRecoveryMode) {
+        if (acroTrainer && (axis != FD_YAW) && !inCrashRecoveryMode) {
             currentPidSetpoint = applyAcroTrainer(axis, angleTrim, currentPidSetpoint);
         }
+#else
+        UNUSED(acroTrainer);
 #endif // USE_ACRO_TRAINER
 
         // Handle yaw spin recovery - zero the setpoint on yaw to aid in recovery
@@ -941,8 +1371,8 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, const rollAndPitchT
                 } else {
                     acErrorRate = acErrorRate2;
                 }
-                if (fabsf(acErrorRate * dT) > fabsf(axisError[axis]) ) {
-                    acErrorRate = -axisError[axis] / dT;
+                if (fabsf(acErrorRate * pidAxisDt[axis]) > fabsf(axisError[axis]) ) {
+                    acErrorRate = -axisError[axis] / pidAxisDt[axis];
                 }
             } else {
                 acErrorRate = (gyroRate > gmaxac ? gmaxac : gminac ) - gyroRate;
@@ -958,7 +1388,7 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, const rollAndPitchT
         
 #if defined(USE_ABSOLUTE_CONTROL)
         if (acGain > 0 && isAirmodeActivated()) {
-            axisError[axis] = constrainf(axisError[axis] + acErrorRate * dT, -acErrorLimit, acErrorLimit);
+            axisError[axis] = constrainf(axisError[axis] + acErrorRate * pidAxisDt[axis], -acErrorLimit, acErrorLimit);
             acCorrection = constrainf(axisError[axis] * acGain, -acLimit, acLimit);
             currentPidSetpoint += acCorrection;
             itermErrorRate += acCorrection;
@@ -984,7 +1414,7 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, const rollAndPitchT
         }
 
         // -----calculate I component
-        const float ITermNew = constrainf(ITerm + pidCoefficient[axis].Ki * itermErrorRate * dynCi, -itermLimit, itermLimit);
+        const float ITermNew = constrainf(ITerm + pidCoefficient[axis].Ki * itermErrorRate * dynCi * pidAxisDt[axis], -itermLimit, itermLimit);
         const bool outputSaturated = mixerIsOutputSaturated(axis, errorRate);
         if (outputSaturated == false || ABS(ITermNew) < ABS(ITerm)) {
             // Only increase ITerm if output is not saturated
@@ -995,12 +1425,12 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, const rollAndPitchT
         if (pidCoefficient[axis].Kd > 0) {
 
             // Divide rate change by dT to get differential (ie dr/dt).
-            // dT is fixed and calculated from the target PID loop time
+            // dT is calculated from the PID loop time and the axis rate, not from the time of each loop
             // This is done to avoid DTerm spikes that occur with dynamically
             // calculated deltaT whenever another task causes the PID
             // loop execution to be delayed.
             const float delta =
-                - (gyroRateDterm[axis] - previousGyroRateDterm[axis]) * pidFrequency;
+                - (gyroRateDterm[axis] - previousGyroRateDterm[axis]) * pidAxisFrequency[axis];
 
             detectAndSetCrashRecovery(pidProfile->crash_recovery, axis, currentTimeUs, delta, errorRate);
 
@@ -1013,9 +1443,9 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, const rollAndPitchT
         // -----calculate feedforward component
         
         // Only enable feedforward for rate mode
-        const float feedforwardGain = flightModeFlags ? 0.0f : pidCoefficient[axis].Kf;
-        
-        if (feedforwardGain > 0) {
+        const float feedforwardGain = pidCoefficient[axis].Kf;
+
+        if (feedForward && feedforwardGain > 0) {
 
             // no transition if feedForwardTransition == 0
             float transition = feedForwardTransition > 0 ? MIN(1.f, getRcDeflectionAbs(axis) * feedForwardTransition) : 1;
@@ -1026,7 +1456,7 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, const rollAndPitchT
             pidSetpointDelta = applyRcSmoothingDerivativeFilter(axis, pidSetpointDelta);
 #endif // USE_RC_SMOOTHING_FILTER
 
-            pidData[axis].F = feedforwardGain * transition * pidSetpointDelta * pidFrequency;
+            pidData[axis].F = feedforwardGain * transition * pidSetpointDelta * pidAxisFrequency[axis];
 
 #if defined(USE_SMART_FEEDFORWARD)
             applySmartFeedforward(axis);
@@ -1066,6 +1496,53 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, const rollAndPitchT
     }
 }
 
+// Use the NOINLINE directive to keep these variants out of ITCM RAM, under the same assumption as for the acro trainer
+// that ultimate performance at very high loop rates is not expected in these modes.
+static NOINLINE void pidControllerLevel(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *angleTrim, timeUs_t currentTimeUs)
+{
+    pidControllerApply(pidProfile, angleTrim, currentTimeUs, true, false, false);
+}
+
+#ifdef USE_ACRO_TRAINER
+static NOINLINE void pidControllerAcroTrainer(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *angleTrim, timeUs_t currentTimeUs, bool feedForward)
+{
+    pidControllerApply(pidProfile, angleTrim, currentTimeUs, false, feedForward, true);
+}
+#endif
+
+// The variant is chosen once per loop from the flight modes, whichever task changed them
+void FAST_CODE pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *angleTrim, timeUs_t currentTimeUs)
+{
+    if (filterUpdateStep != PID_FILTER_UPDATE_NONE) {
+        pidProcessFilterUpdate();
+    }
+
+    yawPidDue = pidLoopDue(&yawPidCountdown, yawPidDenom);
+
+    if (FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(HORIZON_MODE) || FLIGHT_MODE(GPS_RESCUE_MODE)) {
+        levelDue = pidLoopDue(&levelCountdown, levelDenom);
+        pidControllerLevel(pidProfile, angleTrim, currentTimeUs);
+        return;
+    }
+    // the level loop runs straight away when a level mode is entered
+    levelCountdown = 0;
+
+    // feedforward is only used in rate mode
+    const bool feedForward = feedForwardEnabled && !flightModeFlags;
+#ifdef USE_ACRO_TRAINER
+    if (acroTrainerActive) {
+        pidControllerAcroTrainer(pidProfile, angleTrim, currentTimeUs, feedForward);
+        return;
+    }
+#endif
+
+    if (feedForward) {
+        pidControllerApply(pidProfile, angleTrim, currentTimeUs, false, true, false);
+    } else {
+        pidControllerApply(pidProfile, angleTrim, currentTimeUs, false, false, false);
+    }
+}
+
 bool crashRecoveryModeActive(void)
 {
     return inCrashRecoveryMode;
@@ -26,6 +26,8 @@
 #include "pg/pg.h"
 
 #define MAX_PID_PROCESS_DENOM       16
+#define MAX_PID_YAW_DENOM           8
+#define PID_LEVEL_MAX_FREQUENCY_HZ  1000    // the angle and horizon outer loop runs at this rate at most
 #define PID_CONTROLLER_BETAFLIGHT   1
 #define PID_MIXER_SCALING           1000.0f
 #define PID_SERVO_MIXER_SCALING     0.7f
@@ -145,6 +147,8 @@ typedef struct pidProfile_s {
     uint8_t abs_control_gain;               // How strongly should the absolute accumulated error be corrected for
     uint8_t abs_control_limit;              // Limit to the correction
     uint8_t abs_control_error_limit;        // Limit to the accumulated error
+    uint16_t dyn_lpf_dterm_min_hz;          // cutoff of the first D lowpass at zero throttle, 0 keeps the static dterm_lowpass_hz
+    uint16_t dyn_lpf_dterm_max_hz;          // cutoff of the first D lowpass at full throttle
 } pidProfile_t;
 
 #ifndef USE_OSD_SLAVE
@@ -156,6 +160,9 @@ typedef struct pidConfig_s {
     uint8_t runaway_takeoff_prevention;          // off, on - enables pidsum runaway disarm logic
     uint16_t runaway_takeoff_deactivate_delay;   // delay in ms for "in-flight" conditions before deactivation (successful flight)
     uint8_t runaway_takeoff_deactivate_throttle; // minimum throttle percent required during deactivation phase
+    uint8_t pid_gyro_interrupt;                  // off, on - run the PID loop from the gyro data ready interrupt instead of the scheduler
+    uint8_t motor_oversample;                    // off, hold, interpolate - update DShot motors on the gyro loops between PID updates
+    uint8_t pid_yaw_denom;                       // run the yaw PID on every pid_yaw_denom PID loop
 } pidConfig_t;
 
 PG_DECLARE(pidConfig_t, pidConfig);
@@ -184,7 +191,10 @@ extern pt1Filter_t throttleLpf;
 void pidResetITerm(void);
 void pidStabilisationState(pidStabilisationState_e pidControllerState);
 void pidSetItermAccelerator(float newItermAccelerator);
+void pidUpdateMeasuredLooptime(float pidLooptimeUs);
 void pidInitFilters(const pidProfile_t *pidProfile);
+void pidUpdateFilters(const pidProfile_t *pidProfile);
+void pidUpdateDynLpf(float throttle);
 void pidInitConfig(const pidProfile_t *pidProfile);
 void pidInit(const pidProfile_t *pidProfile);
 void pidCopyProfile(uint8_t dstPidProfileIndex, uint8_t srcPidProfileIndex);
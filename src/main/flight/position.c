@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <math.h>
 
+#include "build/build_config.h"
 #include "build/debug.h"
 
 #include "common/maths.h"
@@ -39,13 +40,52 @@
 #include "sensors/barometer.h"
 
 static int32_t estimatedAltitude = 0;                // in cm
+static int16_t estimatedVario = 0;                   // in cm/s
 
 #define BARO_UPDATE_FREQUENCY_40HZ (1000 * 25)
 
+// The altitude and vario are propagated with the earth frame vertical acceleration and corrected towards the
+// measured altitude by a critically damped complementary filter, so they follow climbs without the baro lag.
+#define ALTITUDE_FILTER_OMEGA 1.0f                   // crossover frequency in rad/s
+#define ALTITUDE_FILTER_ALT_GAIN (2.0f * ALTITUDE_FILTER_OMEGA)
+#define ALTITUDE_FILTER_VEL_GAIN (ALTITUDE_FILTER_OMEGA * ALTITUDE_FILTER_OMEGA)
 
 #if defined(USE_BARO) || defined(USE_GPS)
 static bool altitudeOffsetSet = false;
 
+STATIC_UNIT_TESTED void updateAltitudeEstimate(int32_t measuredAltitude, float dT, bool resetAltitude)
+{
+    static bool estimateValid = false;
+    static float altitude;                           // in cm
+    static float velocity;                           // in cm/s
+
+    // velocity change since the last update, from the acceleration accumulated by the IMU
+    float velocityChange = 0;
+    if (accSumCount) {
+        velocityChange = accSum[Z] * accVelScale * accTimeSum / accSumCount;
+    }
+    imuResetAccelerationSum();
+
+    if (!estimateValid) {
+        altitude = measuredAltitude;
+        velocity = 0;
+        estimateValid = true;
+    } else if (resetAltitude) {
+        // the altitude reference changed, keep the vario
+        altitude = measuredAltitude;
+    } else {
+        altitude += (velocity + velocityChange * 0.5f) * dT;
+        velocity += velocityChange;
+
+        const float altitudeError = measuredAltitude - altitude;
+        altitude += altitudeError * ALTITUDE_FILTER_ALT_GAIN * dT;
+        velocity += altitudeError * ALTITUDE_FILTER_VEL_GAIN * dT;
+    }
+
+    estimatedAltitude = lrintf(altitude);
+    estimatedVario = lrintf(constrainf(velocity, INT16_MIN, INT16_MAX));
+}
+
 void calculateEstimatedAltitude(timeUs_t currentTimeUs)
 {
     static timeUs_t previousTimeUs = 0;
@@ -57,6 +97,7 @@ void calculateEstimatedAltitude(timeUs_t currentTimeUs)
         return;
     }
     previousTimeUs = currentTimeUs;
+    bool offsetChanged = false;
 
     int32_t baroAlt = 0;
 
@@ -92,23 +133,32 @@ if (sensors(SENSOR_GPS) && STATE(GPS_FIX)) {
         baroAltOffset = baroAlt;
         gpsAltOffset = gpsAlt;
         altitudeOffsetSet = true;
+        offsetChanged = true;
     } else if (!ARMING_FLAG(ARMED) && altitudeOffsetSet) {
         altitudeOffsetSet = false;
     }
     baroAlt -= baroAltOffset;
     gpsAlt -= gpsAltOffset;
     
+    int32_t measuredAltitude = 0;
     if (haveGpsAlt && haveBaroAlt) {
-        estimatedAltitude = gpsAlt * gpsTrust + baroAlt * (1 - gpsTrust);
+        measuredAltitude = gpsAlt * gpsTrust + baroAlt * (1 - gpsTrust);
     } else if (haveGpsAlt) {
-        estimatedAltitude = gpsAlt;
+        measuredAltitude = gpsAlt;
     } else if (haveBaroAlt) {
-        estimatedAltitude = baroAlt;
+        measuredAltitude = baroAlt;
     }
-    
+
+    if (haveGpsAlt || haveBaroAlt) {
+        updateAltitudeEstimate(measuredAltitude, dTime * 1e-6f, offsetChanged);
+    } else {
+        imuResetAccelerationSum();
+    }
+
     DEBUG_SET(DEBUG_ALTITUDE, 0, (int32_t)(100 * gpsTrust));
     DEBUG_SET(DEBUG_ALTITUDE, 1, baroAlt);
     DEBUG_SET(DEBUG_ALTITUDE, 2, gpsAlt);
+    DEBUG_SET(DEBUG_ALTITUDE, 3, estimatedVario);
 }
 
 bool isAltitudeOffset(void)
@@ -122,8 +172,7 @@ int32_t getEstimatedAltitude(void)
     return estimatedAltitude;
 }
 
-// This should be removed or fixed, but it would require changing a lot of other things to get rid of.
 int16_t getEstimatedVario(void)
 {
-    return 0;
+    return estimatedVario;
 }
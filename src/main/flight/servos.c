@@ -98,6 +98,22 @@ static uint8_t servoRuleCount = 0;
 static servoMixer_t currentServoMixer[MAX_SERVO_RULES];
 static int useServo;
 
+// A rule of currentServoMixer with the servo settings it depends on resolved, so the mixer only adds it up.
+// A reversed rule has its rate and limits negated instead of the direction being looked up.
+typedef struct servoMixerCompiledRule_s {
+    int16_t rate;                           // percent of the input, signed by the servo direction
+    int16_t min;                            // limits of the rule output, in servo units around the middle
+    int16_t max;
+    uint8_t targetChannel;
+    uint8_t inputSource;
+    uint8_t speed;
+    uint8_t boxId;                          // the BOXSERVOx mode enabling the rule, 0 for always on
+    uint8_t ruleIndex;                      // rule of currentServoMixer, for its speed limited output
+} servoMixerCompiledRule_t;
+
+static uint8_t servoMixerCompiledRuleCount;
+static servoMixerCompiledRule_t servoMixerCompiledRules[MAX_SERVO_RULES];
+
 
 #define COUNT_SERVO_RULES(rules) (sizeof(rules) / sizeof(servoMixer_t))
 // mixer rule format servo, input, rate, speed, min, max, box
@@ -238,6 +254,40 @@ void servosInit(void)
     }
 }
 
+// Called whenever the rules or the servo settings change
+void servoMixerCompileRules(void)
+{
+    servoMixerCompiledRuleCount = 0;
+
+    for (int i = 0; i < servoRuleCount; i++) {
+        const servoMixer_t *rule = &currentServoMixer[i];
+        const uint8_t target = rule->targetChannel;
+        if (rule->rate == 0 || target >= MAX_SUPPORTED_SERVOS || rule->inputSource >= INPUT_SOURCE_COUNT) {
+            continue;
+        }
+
+        const int servoWidth = servoParams(target)->max - servoParams(target)->min;
+        const int min = rule->min * servoWidth / 100 - servoWidth / 2;
+        const int max = rule->max * servoWidth / 100 - servoWidth / 2;
+
+        servoMixerCompiledRule_t *compiled = &servoMixerCompiledRules[servoMixerCompiledRuleCount++];
+        compiled->targetChannel = target;
+        compiled->inputSource = rule->inputSource;
+        compiled->speed = rule->speed;
+        compiled->boxId = rule->box ? BOXSERVO1 + rule->box - 1 : 0;
+        compiled->ruleIndex = i;
+        if (servoDirection(target, rule->inputSource) < 0) {
+            compiled->rate = -rule->rate;
+            compiled->min = -max;
+            compiled->max = -min;
+        } else {
+            compiled->rate = rule->rate;
+            compiled->min = min;
+            compiled->max = max;
+        }
+    }
+}
+
 void loadCustomServoMixer(void)
 {
     // reset settings
@@ -253,6 +303,8 @@ void loadCustomServoMixer(void)
         currentServoMixer[i] = *customServoMixers(i);
         servoRuleCount++;
     }
+
+    servoMixerCompileRules();
 }
 
 void servoConfigureOutput(void)
@@ -280,6 +332,8 @@ void servoConfigureOutput(void)
             loadCustomServoMixer();
         }
     }
+
+    servoMixerCompileRules();
 }
 
 
@@ -411,8 +465,8 @@ void servoMixer(void)
         }
     }
 
-    input[INPUT_GIMBAL_PITCH] = scaleRange(attitude.values.pitch, -1800, 1800, -500, +500);
-    input[INPUT_GIMBAL_ROLL] = scaleRange(attitude.values.roll, -1800, 1800, -500, +500);
+    input[INPUT_GIMBAL_PITCH] = scaleRange(getAttitude()->values.pitch, -1800, 1800, -500, +500);
+    input[INPUT_GIMBAL_ROLL] = scaleRange(getAttitude()->values.roll, -1800, 1800, -500, +500);
 
     input[INPUT_STABILIZED_THROTTLE] = motor[0] - 1000 - 500;  // Since it derives from rcCommand or mincommand and must be [-500:+500]
 
@@ -436,27 +490,26 @@ void servoMixer(void)
     }
 
     // mix servos according to rules
-    for (int i = 0; i < servoRuleCount; i++) {
+    for (int i = 0; i < servoMixerCompiledRuleCount; i++) {
+        const servoMixerCompiledRule_t *rule = &servoMixerCompiledRules[i];
+        int16_t *output = &currentOutput[rule->ruleIndex];
+
         // consider rule if no box assigned or box is active
-        if (currentServoMixer[i].box == 0 || IS_RC_MODE_ACTIVE(BOXSERVO1 + currentServoMixer[i].box - 1)) {
-            uint8_t target = currentServoMixer[i].targetChannel;
-            uint8_t from = currentServoMixer[i].inputSource;
-            uint16_t servo_width = servoParams(target)->max - servoParams(target)->min;
-            int16_t min = currentServoMixer[i].min * servo_width / 100 - servo_width / 2;
-            int16_t max = currentServoMixer[i].max * servo_width / 100 - servo_width / 2;
-
-            if (currentServoMixer[i].speed == 0)
-                currentOutput[i] = input[from];
+        if (rule->boxId == 0 || IS_RC_MODE_ACTIVE(rule->boxId)) {
+            const int16_t from = input[rule->inputSource];
+
+            if (rule->speed == 0)
+                *output = from;
             else {
-                if (currentOutput[i] < input[from])
-                    currentOutput[i] = constrain(currentOutput[i] + currentServoMixer[i].speed, currentOutput[i], input[from]);
-                else if (currentOutput[i] > input[from])
-                    currentOutput[i] = constrain(currentOutput[i] - currentServoMixer[i].speed, input[from], currentOutput[i]);
+                if (*output < from)
+                    *output = constrain(*output + rule->speed, *output, from);
+                else if (*output > from)
+                    *output = constrain(*output - rule->speed, from, *output);
             }
 
-            servo[target] += servoDirection(target, from) * constrain(((int32_t)currentOutput[i] * currentServoMixer[i].rate) / 100, min, max);
+            servo[rule->targetChannel] += constrain(((int32_t)*output * rule->rate) / 100, rule->min, rule->max);
         } else {
-            currentOutput[i] = 0;
+            *output = 0;
         }
     }
 
@@ -488,8 +541,8 @@ static void servoTable(void)
 
     /*
     case MIXER_GIMBAL:
-        servo[SERVO_GIMBAL_PITCH] = (((int32_t)servoParams(SERVO_GIMBAL_PITCH)->rate * attitude.values.pitch) / 50) + determineServoMiddleOrForwardFromChannel(SERVO_GIMBAL_PITCH);
-        servo[SERVO_GIMBAL_ROLL] = (((int32_t)servoParams(SERVO_GIMBAL_ROLL)->rate * attitude.values.roll) / 50) + determineServoMiddleOrForwardFromChannel(SERVO_GIMBAL_ROLL);
+        servo[SERVO_GIMBAL_PITCH] = (((int32_t)servoParams(SERVO_GIMBAL_PITCH)->rate * getAttitude()->values.pitch) / 50) + determineServoMiddleOrForwardFromChannel(SERVO_GIMBAL_PITCH);
+        servo[SERVO_GIMBAL_ROLL] = (((int32_t)servoParams(SERVO_GIMBAL_ROLL)->rate * getAttitude()->values.roll) / 50) + determineServoMiddleOrForwardFromChannel(SERVO_GIMBAL_ROLL);
         break;
     */
 
@@ -504,12 +557,13 @@ static void servoTable(void)
         servo[SERVO_GIMBAL_ROLL] = determineServoMiddleOrForwardFromChannel(SERVO_GIMBAL_ROLL);
 
         if (IS_RC_MODE_ACTIVE(BOXCAMSTAB)) {
+            const attitudeEulerAngles_t *attitude = getAttitude();
             if (gimbalConfig()->mode == GIMBAL_MODE_MIXTILT) {
-                servo[SERVO_GIMBAL_PITCH] -= (-(int32_t)servoParams(SERVO_GIMBAL_PITCH)->rate) * attitude.values.pitch / 50 - (int32_t)servoParams(SERVO_GIMBAL_ROLL)->rate * attitude.values.roll / 50;
-                servo[SERVO_GIMBAL_ROLL] += (-(int32_t)servoParams(SERVO_GIMBAL_PITCH)->rate) * attitude.values.pitch / 50 + (int32_t)servoParams(SERVO_GIMBAL_ROLL)->rate * attitude.values.roll / 50;
+                servo[SERVO_GIMBAL_PITCH] -= (-(int32_t)servoParams(SERVO_GIMBAL_PITCH)->rate) * attitude->values.pitch / 50 - (int32_t)servoParams(SERVO_GIMBAL_ROLL)->rate * attitude->values.roll / 50;
+                servo[SERVO_GIMBAL_ROLL] += (-(int32_t)servoParams(SERVO_GIMBAL_PITCH)->rate) * attitude->values.pitch / 50 + (int32_t)servoParams(SERVO_GIMBAL_ROLL)->rate * attitude->values.roll / 50;
             } else {
-                servo[SERVO_GIMBAL_PITCH] += (int32_t)servoParams(SERVO_GIMBAL_PITCH)->rate * attitude.values.pitch / 50;
-                servo[SERVO_GIMBAL_ROLL] += (int32_t)servoParams(SERVO_GIMBAL_ROLL)->rate * attitude.values.roll  / 50;
+                servo[SERVO_GIMBAL_PITCH] += (int32_t)servoParams(SERVO_GIMBAL_PITCH)->rate * attitude->values.pitch / 50;
+                servo[SERVO_GIMBAL_ROLL] += (int32_t)servoParams(SERVO_GIMBAL_ROLL)->rate * attitude->values.roll  / 50;
             }
         }
     }
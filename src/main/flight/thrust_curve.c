@@ -0,0 +1,108 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_THRUST_CURVE
+
+#include "common/maths.h"
+
+#include "flight/thrust_curve.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+PG_REGISTER_WITH_RESET_TEMPLATE(thrustCurveConfig_t, thrustCurveConfig, PG_THRUST_CURVE_CONFIG, 0);
+
+PG_RESET_TEMPLATE(thrustCurveConfig_t, thrustCurveConfig,
+    .thrust_curve_points = 0,
+    .thrust_curve = { 0, 7, 13, 20, 27, 33, 40, 47, 53, 60, 67, 73, 80, 87, 93, 100 },
+);
+
+// Each segment of the curve is precomputed as a start and a slope in motor output units, so applying the curve
+// is a multiply, a truncation and one multiply-accumulate per motor. No segments means the curve is off.
+static FAST_RAM_ZERO_INIT uint8_t segmentCount;
+static FAST_RAM_ZERO_INIT float outputLow;
+static FAST_RAM_ZERO_INIT float segmentsPerOutput;
+static FAST_RAM_ZERO_INIT float segmentStart[THRUST_CURVE_POINTS_MAX - 1];
+static FAST_RAM_ZERO_INIT float segmentSlope[THRUST_CURVE_POINTS_MAX - 1];
+
+void thrustCurveInit(float motorOutputLow, float motorOutputHigh)
+{
+    segmentCount = 0;
+
+    const thrustCurveConfig_t *config = thrustCurveConfig();
+    const int pointCount = MIN(config->thrust_curve_points, THRUST_CURVE_POINTS_MAX);
+    if (pointCount < 2 || motorOutputHigh <= motorOutputLow) {
+        return;
+    }
+
+    const float outputRange = motorOutputHigh - motorOutputLow;
+    outputLow = motorOutputLow;
+    segmentsPerOutput = (pointCount - 1) / outputRange;
+
+    // the curve has to be monotonic to be inverted, so no point is allowed below the one before it
+    int previousPercent = 0;
+    float previousOutput = motorOutputLow + outputRange * constrain(config->thrust_curve[0], 0, 100) / 100.0f;
+    for (int i = 1; i < pointCount; i++) {
+        const int percent = constrain(config->thrust_curve[i], previousPercent, 100);
+        const float output = motorOutputLow + outputRange * percent / 100.0f;
+        segmentStart[i - 1] = previousOutput;
+        segmentSlope[i - 1] = output - previousOutput;
+        previousPercent = percent;
+        previousOutput = output;
+    }
+    segmentCount = pointCount - 1;
+}
+
+// Maps a motor output proportional to thrust to the motor command. Outputs below idle, such as the disarm command, are passed through.
+FAST_CODE float thrustCurveApply(float motorOutput)
+{
+    if (segmentCount == 0 || motorOutput < outputLow) {
+        return motorOutput;
+    }
+
+    const float position = MIN((motorOutput - outputLow) * segmentsPerOutput, segmentCount);
+    const int segment = MIN((int)position, segmentCount - 1);
+    return segmentStart[segment] + segmentSlope[segment] * (position - segment);
+}
+
+// Maps a motor command back to the output proportional to thrust, for reporting
+float thrustCurveInverse(float motorOutput)
+{
+    if (segmentCount == 0 || motorOutput < outputLow) {
+        return motorOutput;
+    }
+
+    int segment = 0;
+    while (segment < segmentCount - 1 && motorOutput > segmentStart[segment] + segmentSlope[segment]) {
+        segment++;
+    }
+    float fraction = 1.0f;
+    if (segmentSlope[segment] > 0.0f) {
+        fraction = constrainf((motorOutput - segmentStart[segment]) / segmentSlope[segment], 0.0f, 1.0f);
+    }
+    return outputLow + (segment + fraction) / segmentsPerOutput;
+}
+
+#endif // USE_THRUST_CURVE
@@ -0,0 +1,36 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pg/pg.h"
+
+#define THRUST_CURVE_POINTS_MAX 16
+
+typedef struct thrustCurveConfig_s {
+    uint8_t thrust_curve_points;                        // number of points of thrust_curve used, 0 disables the curve
+    uint8_t thrust_curve[THRUST_CURVE_POINTS_MAX];      // motor command in percent of the motor range for evenly spaced thrust from idle to full
+} thrustCurveConfig_t;
+
+PG_DECLARE(thrustCurveConfig_t, thrustCurveConfig);
+
+void thrustCurveInit(float motorOutputLow, float motorOutputHigh);
+float thrustCurveApply(float motorOutput);
+float thrustCurveInverse(float motorOutput);
@@ -42,11 +42,13 @@ extern uint8_t __config_end;
 
 #include "build/build_config.h"
 #include "build/debug.h"
+#include "build/profile.h"
 #include "build/version.h"
 
 #include "cms/cms.h"
 
 #include "common/axis.h"
+#include "common/boot_arena.h"
 #include "common/color.h"
 #include "common/maths.h"
 #include "common/printf.h"
@@ -90,6 +92,8 @@ extern uint8_t __config_end;
 #include "fc/controlrate_profile.h"
 #include "fc/fc_core.h"
 #include "fc/fc_rc.h"
+#include "fc/flight_summary.h"
+#include "fc/perf_report.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
@@ -175,6 +179,15 @@ static uint32_t bufferIndex = 0;
 
 static bool configIsInCopy = false;
 
+// Between 'batch start' and 'batch end' only errors are printed and the profile changes are applied once at the end
+static struct {
+    bool active;
+    bool pidProfileChanged;
+    bool rateProfileChanged;
+    uint16_t errorCount;
+} cliBatchState;
+static bool cliQuiet = false;
+
 #define CURRENT_PROFILE_INDEX -1
 static int8_t pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
 static int8_t rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
@@ -268,8 +281,25 @@ static void backupAndResetConfigs(void)
     resetConfigs();
 }
 
+// exchanges the active configs and their copies, so the defaults only need to be computed once for a whole dump
+static void swapConfigs(void)
+{
+    PG_FOREACH(pg) {
+        for (unsigned i = 0; i < pg->size; i++) {
+            const uint8_t value = pg->address[i];
+            pg->address[i] = pg->copy[i];
+            pg->copy[i] = value;
+        }
+    }
+
+    configIsInCopy = !configIsInCopy;
+}
+
 static void cliPrint(const char *str)
 {
+    if (cliQuiet) {
+        return;
+    }
     while (*str) {
         bufWriterAppend(cliWriter, *str++);
     }
@@ -314,6 +344,9 @@ typedef enum {
 
 static void cliPrintfva(const char *format, va_list va)
 {
+    if (cliQuiet) {
+        return;
+    }
     tfp_format(cliWriter, cliPutp, format, va);
     bufWriterFlush(cliWriter);
 }
@@ -334,6 +367,9 @@ static bool cliDumpPrintLinef(uint8_t dumpMask, bool equalsDefault, const char *
 
 static void cliWrite(uint8_t ch)
 {
+    if (cliQuiet) {
+        return;
+    }
     bufWriterAppend(cliWriter, ch);
 }
 
@@ -373,12 +409,20 @@ static void cliPrintLinef(const char *format, ...)
 
 static void cliPrintErrorLinef(const char *format, ...)
 {
+    // errors are printed in batch mode too
+    const bool quiet = cliQuiet;
+    cliQuiet = false;
     cliPrint("###ERROR### ");
     va_list va;
     va_start(va, format);
     cliPrintfva(format, va);
     va_end(va);
     cliPrintLinefeed();
+    cliQuiet = quiet;
+
+    if (cliBatchState.active) {
+        cliBatchState.errorCount++;
+    }
 }
 
 
@@ -535,9 +579,11 @@ const void *cliGetDefaultPointer(const clivalue_t *value)
 static void dumpPgValue(const clivalue_t *value, uint8_t dumpMask)
 {
     const pgRegistry_t *pg = pgFind(value->pgn);
+    char name[SETTING_MAX_NAME_LENGTH];
+    settingGetName(value, name);
 #ifdef DEBUG
     if (!pg) {
-        cliPrintLinef("VALUE %s ERROR", value->name);
+        cliPrintLinef("VALUE %s ERROR", name);
         return; // if it's not found, the pgn shouldn't be in the value table!
     }
 #endif
@@ -549,27 +595,16 @@ static void dumpPgValue(const clivalue_t *value, uint8_t dumpMask)
 
     if (((dumpMask & DO_DIFF) == 0) || !equalsDefault) {
         if (dumpMask & SHOW_DEFAULTS && !equalsDefault) {
-            cliPrintf(defaultFormat, value->name);
+            cliPrintf(defaultFormat, name);
             printValuePointer(value, (uint8_t*)pg->address + valueOffset, false);
             cliPrintLinefeed();
         }
-        cliPrintf(format, value->name);
+        cliPrintf(format, name);
         printValuePointer(value, pg->copy + valueOffset, false);
         cliPrintLinefeed();
     }
 }
 
-static void dumpAllValues(uint16_t valueSection, uint8_t dumpMask)
-{
-    for (uint32_t i = 0; i < valueTableEntryCount; i++) {
-        const clivalue_t *value = &valueTable[i];
-        bufWriterFlush(cliWriter);
-        if ((value->type & VALUE_SECTION_MASK) == valueSection) {
-            dumpPgValue(value, dumpMask);
-        }
-    }
-}
-
 static void cliPrintVar(const clivalue_t *var, bool full)
 {
     const void *ptr = cliGetValuePointer(var);
@@ -672,7 +707,7 @@ static void cliSetVar(const clivalue_t *var, const int16_t value)
 static void cliRepeat(char ch, uint8_t len)
 {
     for (int i = 0; i < len; i++) {
-        bufWriterAppend(cliWriter, ch);
+        cliWrite(ch);
     }
     cliPrintLinefeed();
 }
@@ -1201,6 +1236,7 @@ static void cliSerialPassthrough(char *cmdline)
     }
 #endif /* USE_PINIO */
 
+    bufWriterFlush(cliWriter);
     serialPassthrough(cliPort, passThroughPort, NULL, NULL);
 }
 #endif
@@ -1789,6 +1825,7 @@ static void cliServo(char *cmdline)
         servo->middle = arguments[MIDDLE];
         servo->rate = arguments[RATE];
         servo->forwardFromChannel = arguments[FORWARD];
+        servoMixerCompileRules();
 
         cliDumpPrintLinef(0, false, format,
             i,
@@ -1857,6 +1894,7 @@ static void cliServoMix(char *cmdline)
         for (uint32_t i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
             servoParamsMutable(i)->reversedSources = 0;
         }
+        servoMixerCompileRules();
     } else if (strncasecmp(cmdline, "load", 4) == 0) {
         const char *ptr = nextArg(cmdline);
         if (ptr) {
@@ -1914,6 +1952,7 @@ static void cliServoMix(char *cmdline)
             } else {
                 servoParamsMutable(args[SERVO])->reversedSources &= ~(1 << args[INPUT]);
             }
+            servoMixerCompileRules();
         } else {
             cliShowParseError();
             return;
@@ -2040,6 +2079,11 @@ static void cliFlashInfo(char *cmdline)
 
     cliPrintLinef("Flash sectors=%u, sectorSize=%u, pagesPerSector=%u, pageSize=%u, totalSize=%u, usedSize=%u",
             layout->sectors, layout->sectorSize, layout->pagesPerSector, layout->pageSize, layout->totalSize, flashfsGetOffset());
+#ifdef USE_FLASHFS_ERASE_AHEAD
+    if (flashfsGetEraseAheadRemaining()) {
+        cliPrintLinef("Erasing ahead of the logs, %u bytes left", flashfsGetEraseAheadRemaining());
+    }
+#endif
 }
 
 
@@ -2669,6 +2713,7 @@ static void cliGpsPassthrough(char *cmdline)
 {
     UNUSED(cmdline);
 
+    bufWriterFlush(cliWriter);
     gpsEnablePassthrough(cliPort);
 }
 #endif
@@ -2684,11 +2729,11 @@ static void cliPrintGyroRegisters(uint8_t whichSensor)
 static void cliDumpGyroRegisters(char *cmdline)
 {
 #ifdef USE_DUAL_GYRO
-    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_1) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH)) {
+    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_1) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_FUSED)) {
         cliPrintLinef("\r\n# Gyro 1");
         cliPrintGyroRegisters(GYRO_CONFIG_USE_GYRO_1);
     }
-    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_2) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH)) {
+    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_2) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_FUSED)) {
         cliPrintLinef("\r\n# Gyro 2");
         cliPrintGyroRegisters(GYRO_CONFIG_USE_GYRO_2);
     }
@@ -3167,7 +3212,13 @@ static void cliProfile(char *cmdline)
     } else {
         const int i = atoi(cmdline);
         if (i >= 0 && i < MAX_PROFILE_COUNT) {
-            changePidProfile(i);
+            if (cliBatchState.active) {
+                // set only selects the profile, it is loaded at the end of the batch
+                systemConfigMutable()->pidProfileIndex = i;
+                cliBatchState.pidProfileChanged = true;
+            } else {
+                changePidProfile(i);
+            }
             cliProfile("");
         }
     }
@@ -3181,44 +3232,43 @@ static void cliRateProfile(char *cmdline)
     } else {
         const int i = atoi(cmdline);
         if (i >= 0 && i < CONTROL_RATE_PROFILE_COUNT) {
-            changeControlRateProfile(i);
+            if (cliBatchState.active) {
+                systemConfigMutable()->activeRateProfile = i;
+                cliBatchState.rateProfileChanged = true;
+            } else {
+                changeControlRateProfile(i);
+            }
             cliRateProfile("");
         }
     }
 }
 
-static void cliDumpPidProfile(uint8_t pidProfileIndex, uint8_t dumpMask)
+static void cliBatch(char *cmdline)
 {
-    if (pidProfileIndex >= MAX_PROFILE_COUNT) {
-        // Faulty values
-        return;
-    }
-
-    pidProfileIndexToUse = pidProfileIndex;
-
-    cliPrintHashLine("profile");
-    cliProfile("");
-    cliPrintLinefeed();
-    dumpAllValues(PROFILE_VALUE, dumpMask);
-
-    pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
-}
+    if (strncasecmp(cmdline, "start", 5) == 0) {
+        if (!cliBatchState.active) {
+            memset(&cliBatchState, 0, sizeof(cliBatchState));
+            cliBatchState.active = true;
+        }
+        cliQuiet = true;
+    } else if (strncasecmp(cmdline, "end", 3) == 0) {
+        if (!cliBatchState.active) {
+            cliPrintErrorLinef("No batch started");
+            return;
+        }
+        cliBatchState.active = false;
+        cliQuiet = false;
 
-static void cliDumpRateProfile(uint8_t rateProfileIndex, uint8_t dumpMask)
-{
-    if (rateProfileIndex >= CONTROL_RATE_PROFILE_COUNT) {
-        // Faulty values
-        return;
+        if (cliBatchState.pidProfileChanged) {
+            changePidProfile(getCurrentPidProfileIndex());
+        }
+        if (cliBatchState.rateProfileChanged) {
+            changeControlRateProfile(getCurrentControlRateProfileIndex());
+        }
+        cliPrintLinef("# batch end, %d errors", cliBatchState.errorCount);
+    } else {
+        cliShowParseError();
     }
-
-    rateProfileIndexToUse = rateProfileIndex;
-
-    cliPrintHashLine("rateprofile");
-    cliRateProfile("");
-    cliPrintLinefeed();
-    dumpAllValues(PROFILE_RATE_VALUE, dumpMask);
-
-    rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
 }
 
 static void cliSave(char *cmdline)
@@ -3290,12 +3340,14 @@ STATIC_UNIT_TESTED void cliGet(char *cmdline)
     backupAndResetConfigs();
 
     for (uint32_t i = 0; i < valueTableEntryCount; i++) {
-        if (strcasestr(valueTable[i].name, cmdline)) {
+        char name[SETTING_MAX_NAME_LENGTH];
+        settingGetName(&valueTable[i], name);
+        if (strcasestr(name, cmdline)) {
             val = &valueTable[i];
             if (matchedCommands > 0) {
                 cliPrintLinefeed();
             }
-            cliPrintf("%s = ", valueTable[i].name);
+            cliPrintf("%s = ", name);
             cliPrintVar(val, 0);
             cliPrintLinefeed();
             switch (val->type & VALUE_SECTION_MASK) {
@@ -3348,7 +3400,9 @@ STATIC_UNIT_TESTED void cliSet(char *cmdline)
 
         for (uint32_t i = 0; i < valueTableEntryCount; i++) {
             const clivalue_t *val = &valueTable[i];
-            cliPrintf("%s = ", valueTable[i].name);
+            char name[SETTING_MAX_NAME_LENGTH];
+            settingGetName(val, name);
+            cliPrintf("%s = ", name);
             cliPrintVar(val, len); // when len is 1 (when * is passed as argument), it will print min/max values as well, for gui
             cliPrintLinefeed();
         }
@@ -3361,125 +3415,122 @@ STATIC_UNIT_TESTED void cliSet(char *cmdline)
         eqptr++;
         eqptr = skipSpace(eqptr);
 
-        for (uint32_t i = 0; i < valueTableEntryCount; i++) {
-            const clivalue_t *val = &valueTable[i];
+        const clivalue_t *val = findValueByName(cmdline, variableNameLength);
+        if (val) {
+            bool valueChanged = false;
+            int16_t value  = 0;
+            switch (val->type & VALUE_MODE_MASK) {
+            case MODE_DIRECT: {
+                    int16_t value = atoi(eqptr);
+
+                    if (value >= val->config.minmax.min && value <= val->config.minmax.max) {
+                        cliSetVar(val, value);
+                        valueChanged = true;
+                    }
+                }
 
-            // ensure exact match when setting to prevent setting variables with shorter names
-            if (strncasecmp(cmdline, val->name, strlen(val->name)) == 0 && variableNameLength == strlen(val->name)) {
+                break;
+            case MODE_LOOKUP: 
+            case MODE_BITSET: {
+                    int tableIndex;
+                    if ((val->type & VALUE_MODE_MASK) == MODE_BITSET) {
+                        tableIndex = TABLE_OFF_ON;
+                    } else {
+                        tableIndex = val->config.lookup.tableIndex;
+                    }
+                    const lookupTableEntry_t *tableEntry = &lookupTables[tableIndex];
+                    bool matched = false;
+                    for (uint32_t tableValueIndex = 0; tableValueIndex < tableEntry->valueCount && !matched; tableValueIndex++) {
+                        matched = tableEntry->values[tableValueIndex] && strcasecmp(tableEntry->values[tableValueIndex], eqptr) == 0;
 
-                bool valueChanged = false;
-                int16_t value  = 0;
-                switch (val->type & VALUE_MODE_MASK) {
-                case MODE_DIRECT: {
-                        int16_t value = atoi(eqptr);
+                        if (matched) {
+                            value = tableValueIndex;
 
-                        if (value >= val->config.minmax.min && value <= val->config.minmax.max) {
                             cliSetVar(val, value);
                             valueChanged = true;
                         }
                     }
+                }
 
-                    break;
-                case MODE_LOOKUP: 
-                case MODE_BITSET: {
-                        int tableIndex;
-                        if ((val->type & VALUE_MODE_MASK) == MODE_BITSET) {
-                            tableIndex = TABLE_OFF_ON;
-                        } else {
-                            tableIndex = val->config.lookup.tableIndex;
-                        }
-                        const lookupTableEntry_t *tableEntry = &lookupTables[tableIndex];
-                        bool matched = false;
-                        for (uint32_t tableValueIndex = 0; tableValueIndex < tableEntry->valueCount && !matched; tableValueIndex++) {
-                            matched = tableEntry->values[tableValueIndex] && strcasecmp(tableEntry->values[tableValueIndex], eqptr) == 0;
-
-                            if (matched) {
-                                value = tableValueIndex;
-
-                                cliSetVar(val, value);
-                                valueChanged = true;
-                            }
-                        }
-                    }
-
-                    break;
+                break;
 
-                case MODE_ARRAY: {
-                        const uint8_t arrayLength = val->config.array.length;
-                        char *valPtr = eqptr;
-
-                        int i = 0;
-                        while (i < arrayLength && valPtr != NULL) {
-                            // skip spaces
-                            valPtr = skipSpace(valPtr);
-
-                            // process substring starting at valPtr
-                            // note: no need to copy substrings for atoi()
-                            //       it stops at the first character that cannot be converted...
-                            switch (val->type & VALUE_TYPE_MASK) {
-                            default:
-                            case VAR_UINT8:
-                                {
-                                    // fetch data pointer
-                                    uint8_t *data = (uint8_t *)cliGetValuePointer(val) + i;
-                                    // store value
-                                    *data = (uint8_t)atoi((const char*) valPtr);
-                                }
+            case MODE_ARRAY: {
+                    const uint8_t arrayLength = val->config.array.length;
+                    char *valPtr = eqptr;
 
-                                break;
-                            case VAR_INT8:
-                                {
-                                    // fetch data pointer
-                                    int8_t *data = (int8_t *)cliGetValuePointer(val) + i;
-                                    // store value
-                                    *data = (int8_t)atoi((const char*) valPtr);
-                                }
+                    int i = 0;
+                    while (i < arrayLength && valPtr != NULL) {
+                        // skip spaces
+                        valPtr = skipSpace(valPtr);
 
-                                break;
-                            case VAR_UINT16:
-                                {
-                                    // fetch data pointer
-                                    uint16_t *data = (uint16_t *)cliGetValuePointer(val) + i;
-                                    // store value
-                                    *data = (uint16_t)atoi((const char*) valPtr);
-                                }
+                        // process substring starting at valPtr
+                        // note: no need to copy substrings for atoi()
+                        //       it stops at the first character that cannot be converted...
+                        switch (val->type & VALUE_TYPE_MASK) {
+                        default:
+                        case VAR_UINT8:
+                            {
+                                // fetch data pointer
+                                uint8_t *data = (uint8_t *)cliGetValuePointer(val) + i;
+                                // store value
+                                *data = (uint8_t)atoi((const char*) valPtr);
+                            }
 
-                                break;
-                            case VAR_INT16:
-                                {
-                                    // fetch data pointer
-                                    int16_t *data = (int16_t *)cliGetValuePointer(val) + i;
-                                    // store value
-                                    *data = (int16_t)atoi((const char*) valPtr);
-                                }
+                            break;
+                        case VAR_INT8:
+                            {
+                                // fetch data pointer
+                                int8_t *data = (int8_t *)cliGetValuePointer(val) + i;
+                                // store value
+                                *data = (int8_t)atoi((const char*) valPtr);
+                            }
 
-                                break;
+                            break;
+                        case VAR_UINT16:
+                            {
+                                // fetch data pointer
+                                uint16_t *data = (uint16_t *)cliGetValuePointer(val) + i;
+                                // store value
+                                *data = (uint16_t)atoi((const char*) valPtr);
                             }
 
-                            // find next comma (or end of string)
-                            valPtr = strchr(valPtr, ',') + 1;
+                            break;
+                        case VAR_INT16:
+                            {
+                                // fetch data pointer
+                                int16_t *data = (int16_t *)cliGetValuePointer(val) + i;
+                                // store value
+                                *data = (int16_t)atoi((const char*) valPtr);
+                            }
 
-                            i++;
+                            break;
                         }
-                    }
 
-                    // mark as changed
-                    valueChanged = true;
-
-                    break;
+                        // find next comma (or end of string)
+                        valPtr = strchr(valPtr, ',') + 1;
 
+                        i++;
+                    }
                 }
 
-                if (valueChanged) {
-                    cliPrintf("%s set to ", val->name);
-                    cliPrintVar(val, 0);
-                } else {
-                    cliPrintErrorLinef("Invalid value");
-                    cliPrintVarRange(val);
-                }
+                // mark as changed
+                valueChanged = true;
 
-                return;
+                break;
+
+            }
+
+            if (valueChanged) {
+                char name[SETTING_MAX_NAME_LENGTH];
+                settingGetName(val, name);
+                cliPrintf("%s set to ", name);
+                cliPrintVar(val, 0);
+            } else {
+                cliPrintErrorLinef("Invalid value");
+                cliPrintVarRange(val);
             }
+
+            return;
         }
         cliPrintErrorLinef("Invalid name");
     } else {
@@ -3504,6 +3555,12 @@ static void cliStatus(char *cmdline)
     #endif
 
     cliPrintLinef("Voltage: %d * 0.1V (%dS battery - %s)", getBatteryVoltage(), getBatteryCellCount(), getBatteryStateString());
+#ifdef USE_BATTERY_SAG_COMPENSATION
+    if (isAmperageConfigured()) {
+        const uint16_t noLoadVoltage = getBatteryNoLoadVoltage();
+        cliPrintLinef("No load voltage: %d.%02dV, internal resistance: %dmOhm", noLoadVoltage / 100, noLoadVoltage % 100, getBatteryResistance());
+    }
+#endif
 
     cliPrintf("CPU Clock=%dMHz", (SystemCoreClock / 1000000));
 
@@ -3568,6 +3625,18 @@ static void cliStatus(char *cmdline)
     cliPrintLinefeed();
 }
 
+static void cliArena(char *cmdline)
+{
+    UNUSED(cmdline);
+
+    cliPrintLine("Boot arena allocations");
+    for (int i = 0; i < bootArenaAllocationCount(); i++) {
+        const bootArenaAllocation_t *allocation = bootArenaGetAllocation(i);
+        cliPrintLinef("%12s %6d", allocation->owner, allocation->size);
+    }
+    cliPrintLinef("Used %d of %d bytes, %d free", (int)bootArenaUsed(), (int)bootArenaSize(), (int)(bootArenaSize() - bootArenaUsed()));
+}
+
 #ifndef SKIP_TASK_STATISTICS
 static void cliTasks(char *cmdline)
 {
@@ -3626,6 +3695,172 @@ static void cliTasks(char *cmdline)
         getCheckFuncInfo(&checkFuncInfo);
         cliPrintLinef("RX Check Function %19d %7d %25d", checkFuncInfo.maxExecutionTime, checkFuncInfo.averageExecutionTime, checkFuncInfo.totalExecutionTime / 1000);
         cliPrintLinef("Total (excluding SERIAL) %25d.%1d%% %4d.%1d%%", maxLoadSum/10, maxLoadSum%10, averageLoadSum/10, averageLoadSum%10);
+#ifdef USE_TASK_STATISTICS_HISTOGRAM
+        cliPrint("\r\nTask histogram/us        late");
+        for (int i = 1; i <= TASK_HISTOGRAM_BUCKET_COUNT; i++) {
+            if (i < TASK_HISTOGRAM_BUCKET_COUNT) {
+                cliPrintf(" %5d", 1 << i);
+            } else {
+                cliPrintf(" %4d+", 1 << (i - 1));
+            }
+        }
+        cliPrintLinefeed();
+        for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+            cfTaskInfo_t taskInfo;
+            getTaskInfo(taskId, &taskInfo);
+            if (taskInfo.isEnabled) {
+                cliPrintf("%02d - (%15s) %7d", taskId, taskInfo.taskName, taskInfo.lateCount);
+                for (int i = 0; i < TASK_HISTOGRAM_BUCKET_COUNT; i++) {
+                    cliPrintf(" %5d", taskInfo.executionTimeHistogram[i]);
+                }
+                cliPrintLinefeed();
+            }
+        }
+#endif
+    }
+}
+#endif
+
+#ifdef USE_PERF_REPORT
+static void cliPerfLatency(const char *name, const perfLatency_t *latency)
+{
+    if (latency->count) {
+        cliPrintLinef("%16s %7d %7d %7d %7d", name, latency->count, latency->minUs, perfLatencyAverageUs(latency), latency->maxUs);
+    }
+}
+
+static void cliPerf(char *cmdline)
+{
+    if (strncasecmp(cmdline, "start", 5) == 0) {
+        const char *duration = strchr(cmdline, ' ');
+        const int durationS = duration ? atoi(duration) : PERF_REPORT_DURATION_DEFAULT_S;
+        if (durationS < 1 || durationS > PERF_REPORT_DURATION_MAX_S) {
+            cliShowArgumentRangeError("seconds", 1, PERF_REPORT_DURATION_MAX_S);
+        } else if (!perfReportStart(durationS)) {
+            cliPrintLine("Disarm first");
+        } else {
+            cliPrintLinef("Measuring for %ds, run 'perf' for the report", durationS);
+        }
+        return;
+    } else if (*cmdline) {
+        cliShowParseError();
+        return;
+    }
+
+    const perfReport_t *report = perfReportGet();
+    switch (report->state) {
+    case PERF_REPORT_IDLE:
+        cliPrintLine("No report, run 'perf start [<seconds>]' while disarmed");
+        return;
+    case PERF_REPORT_RUNNING:
+        cliPrintLinef("Measuring, %ds left", (report->durationUs - cmpTimeUs(micros(), report->startedAtUs)) / 1000000 + 1);
+        return;
+    case PERF_REPORT_ABORTED:
+        cliPrintLine("Aborted by arming");
+        return;
+    case PERF_REPORT_DONE:
+        break;
+    }
+
+    const int durationMs = report->durationUs / 1000;
+    cliPrintLinef("Perf report over %ds, looptime %dus", report->durationUs / 1000000, report->targetLooptimeUs);
+    cliPrintLine("Latency             count  min/us  avg/us  max/us");
+    cliPerfLatency("gyro EXTI->read", &report->extiToRead);
+    cliPerfLatency("gyro->motors", &report->gyroToMotor);
+    cliPerfLatency("gyro bus read", &report->gyroRead);
+    const int gyroBusLoad = report->gyroRead.totalUs / durationMs;     // in 0.1%
+    cliPrintLinef("Gyro bus busy %d.%d%%", gyroBusLoad / 10, gyroBusLoad % 10);
+
+    const int stdDev = lrintf(perfReportJitterStdDevUs() * 10);
+    cliPrintLinef("Loop period jitter over %d periods: stddev %d.%dus p50 %dus p99 %dus max %d%sus",
+        report->periodCount, stdDev / 10, stdDev % 10,
+        perfReportJitterPercentileUs(50), perfReportJitterPercentileUs(99), perfReportJitterPercentileUs(100),
+        perfReportJitterPercentileUs(100) == PERF_REPORT_JITTER_BUCKET_COUNT - 1 ? "+" : "");
+
+    cliPrintLine("Task CPU");
+    for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        if (report->taskExecutionTimeUs[taskId]) {
+            cfTaskInfo_t taskInfo;
+            getTaskInfo(taskId, &taskInfo);
+            const int load = report->taskExecutionTimeUs[taskId] / durationMs;     // in 0.1%
+            cliPrintLinef("%16s %4d.%1d%%", taskInfo.taskName, load / 10, load % 10);
+        }
+    }
+
+    cliPrintLinef("Bus errors: SPI %d I2C %d", report->spiErrors, report->i2cErrors);
+    cliPrintLinef("DMA conflicts: %d busy, %d streams not allocated", report->dmaAcquireFailures, report->dmaAllocateFailures);
+}
+#endif
+
+#ifdef USE_FLIGHT_SUMMARY
+static void cliFlightSummary(char *cmdline)
+{
+    if (strncasecmp(cmdline, "clear", 5) == 0) {
+        flightSummaryClear();
+        cliPrintLine("Flight summaries cleared");
+        return;
+    } else if (*cmdline) {
+        cliShowParseError();
+        return;
+    }
+
+    const int count = flightSummaryCount();
+    if (!count) {
+        cliPrintLine("No flights");
+        return;
+    }
+
+    // noise in 0.1 deg/s, saturation in 0.1% of the gyro loops
+    cliPrintLine("Flight  time/s  noise roll/pitch/yaw raw -> filtered  sat  notch/Hz  overruns  load");
+    for (int i = 0; i < count; i++) {
+        const flightSummary_t *summary = flightSummaryGet(i);
+        cliPrintLinef("%6d %7d  %4d/%4d/%4d -> %4d/%4d/%4d %4d %4d-%4d %9d %4d%%",
+            summary->flightNumber, summary->durationS,
+            summary->gyroNoisePrefilteredRms[FD_ROLL], summary->gyroNoisePrefilteredRms[FD_PITCH], summary->gyroNoisePrefilteredRms[FD_YAW],
+            summary->gyroNoiseFilteredRms[FD_ROLL], summary->gyroNoiseFilteredRms[FD_PITCH], summary->gyroNoiseFilteredRms[FD_YAW],
+            summary->motorSaturationPermille, summary->dynNotchMinHz, summary->dynNotchMaxHz,
+            summary->loopOverruns, summary->maxLoadPercent);
+    }
+}
+#endif
+
+#ifdef USE_PROFILE
+static void cliProbes(char *cmdline)
+{
+    if (strcasecmp(cmdline, "reset") == 0) {
+        profileReset();
+        cliPrintLine("Probes reset");
+        return;
+    }
+
+    cliPrintLine("               Probe     count  min/ns  avg/ns  max/ns");
+    for (profileId_e id = 0; id < PROFILE_COUNT; id++) {
+        const profileProbe_t *probe = &profileProbes[id];
+        if (probe->count) {
+            const uint32_t averageCycles = probe->totalCycles / probe->count;
+            cliPrintLinef("%20s %9d %7d %7d %7d", profileNames[id], probe->count,
+                profileCyclesToNs(probe->minCycles), profileCyclesToNs(averageCycles), profileCyclesToNs(probe->maxCycles));
+        }
+    }
+
+    cliPrint("\r\nProbe histogram/cycles");
+    for (int i = 1; i <= PROFILE_HISTOGRAM_BUCKET_COUNT; i++) {
+        if (i < PROFILE_HISTOGRAM_BUCKET_COUNT) {
+            cliPrintf(" %6d", 1 << i);
+        } else {
+            cliPrintf(" %5d+", 1 << (i - 1));
+        }
+    }
+    cliPrintLinefeed();
+    for (profileId_e id = 0; id < PROFILE_COUNT; id++) {
+        const profileProbe_t *probe = &profileProbes[id];
+        if (probe->count) {
+            cliPrintf("%22s", profileNames[id]);
+            for (int i = 0; i < PROFILE_HISTOGRAM_BUCKET_COUNT; i++) {
+                cliPrintf(" %6d", probe->histogram[i]);
+            }
+            cliPrintLinefeed();
+        }
     }
 }
 #endif
@@ -3682,6 +3917,17 @@ static void cliRcSmoothing(char *cmdline)
                 cliPrintLine("manual)");
             }
         }
+    } else if (rxConfig()->rc_smoothing_type == RC_SMOOTHING_TYPE_PREDICTIVE) {
+        cliPrintLine("PREDICTIVE");
+        const int avgRxFrameUs = rcSmoothingGetValue(RC_SMOOTHING_VALUE_AVERAGE_FRAME);
+        cliPrint("# Detected RX frame rate: ");
+        if (avgRxFrameUs == 0) {
+            cliPrintLine("NO SIGNAL");
+        } else {
+            cliPrintLinef("%d.%03dms", avgRxFrameUs / 1000, avgRxFrameUs % 1000);
+        }
+        cliPrintLinef("# Active input cutoff: %dhz (auto)", rcSmoothingGetValue(RC_SMOOTHING_VALUE_INPUT_ACTIVE));
+        cliPrintLinef("# Active derivative cutoff: %dhz", rcSmoothingGetValue(RC_SMOOTHING_VALUE_DERIVATIVE_ACTIVE));
     } else {
         cliPrintLine("INTERPOLATION");
     }
@@ -3791,6 +4037,9 @@ const cliResourceValue_t resourceTable[] = {
 #endif
 #ifdef USE_MAX7456
     DEFS( OWNER_OSD_CS,        PG_MAX7456_CONFIG, max7456Config_t, csTag ),
+#ifdef USE_MAX7456_VSYNC
+    DEFS( OWNER_OSD_VSYNC,     PG_MAX7456_CONFIG, max7456Config_t, vsyncTag ),
+#endif
 #endif
 #ifdef USE_SPI
     DEFA( OWNER_SPI_PREINIT_IPU, PG_SPI_PREINIT_IPU_CONFIG, spiCs_t, csnTag, SPI_PREINIT_IPU_COUNT ),
@@ -4149,32 +4398,121 @@ error:
 }
 #endif
 
-static void printConfig(char *cmdline, bool doDiff)
+typedef enum {
+    CLI_DUMP_IDLE = 0,
+    CLI_DUMP_HEADER,
+    CLI_DUMP_NAME,
+    CLI_DUMP_RESOURCES,
+    CLI_DUMP_MIXER,
+    CLI_DUMP_SERVO,
+    CLI_DUMP_FEATURE,
+    CLI_DUMP_BEEPER,
+    CLI_DUMP_MAP,
+    CLI_DUMP_SERIAL,
+    CLI_DUMP_LED,
+    CLI_DUMP_AUX,
+    CLI_DUMP_ADJRANGE,
+    CLI_DUMP_RXRANGE,
+    CLI_DUMP_VTX,
+    CLI_DUMP_RXFAIL,
+    CLI_DUMP_MASTER_HEADER,
+    CLI_DUMP_MASTER,
+    CLI_DUMP_PID_PROFILES,
+    CLI_DUMP_PID_PROFILE_RESTORE,
+    CLI_DUMP_RATE_PROFILES,
+    CLI_DUMP_RATE_PROFILE_RESTORE,
+    CLI_DUMP_FOOTER,
+} cliDumpStage_e;
+
+// dump and diff are printed a section or a value at a time from cliProcess(), so a full output buffer never blocks the main loop
+typedef struct cliDumpState_s {
+    uint8_t stage;
+    uint8_t dumpMask;
+    bool profileStarted;
+    uint8_t profileIndex;
+    uint8_t profileEnd;
+    uint16_t valueIndex;
+} cliDumpState_t;
+
+static cliDumpState_t cliDumpState;
+
+// space that has to be left in the serial tx buffer to print the next part of a dump
+#define CLI_DUMP_TX_SPACE 128
+
+static bool cliDumpMustYield(void)
 {
-    uint8_t dumpMask = DUMP_MASTER;
-    char *options;
-    if ((options = checkCommand(cmdline, "master"))) {
-        dumpMask = DUMP_MASTER; // only
-    } else if ((options = checkCommand(cmdline, "profile"))) {
-        dumpMask = DUMP_PROFILE; // only
-    } else if ((options = checkCommand(cmdline, "rates"))) {
-        dumpMask = DUMP_RATES; // only
-    } else if ((options = checkCommand(cmdline, "all"))) {
-        dumpMask = DUMP_ALL;   // all profiles and rates
+    bufWriterFlush(cliWriter);
+
+    return serialTxBytesFree(cliPort) < CLI_DUMP_TX_SPACE;
+}
+
+// prints the next value of the given section, returns true once the section is complete
+static bool cliDumpNextValue(uint16_t valueSection)
+{
+    while (cliDumpState.valueIndex < valueTableEntryCount) {
+        const clivalue_t *value = &valueTable[cliDumpState.valueIndex++];
+        if ((value->type & VALUE_SECTION_MASK) == valueSection) {
+            dumpPgValue(value, cliDumpState.dumpMask);
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// prints the profile header or the next value of the current profile, returns true once the profile is complete
+static bool cliDumpNextProfileValue(uint16_t valueSection)
+{
+    bool profileComplete = false;
+
+    if (valueSection == PROFILE_VALUE) {
+        pidProfileIndexToUse = cliDumpState.profileIndex;
     } else {
-        options = cmdline;
+        rateProfileIndexToUse = cliDumpState.profileIndex;
     }
 
-    if (doDiff) {
-        dumpMask = dumpMask | DO_DIFF;
+    if (!cliDumpState.profileStarted) {
+        if (valueSection == PROFILE_VALUE) {
+            cliPrintHashLine("profile");
+            cliProfile("");
+        } else {
+            cliPrintHashLine("rateprofile");
+            cliRateProfile("");
+        }
+        cliPrintLinefeed();
+        cliDumpState.profileStarted = true;
+        cliDumpState.valueIndex = 0;
+    } else if (cliDumpNextValue(valueSection)) {
+        cliDumpState.profileStarted = false;
+        profileComplete = true;
     }
-    
-    backupAndResetConfigs();
-    if (checkCommand(options, "defaults")) {
-        dumpMask = dumpMask | SHOW_DEFAULTS;   // add default values as comments for changed values
+
+    pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
+    rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
+
+    return profileComplete;
+}
+
+static void cliDumpSetProfileRange(uint8_t currentIndex, uint8_t count, uint8_t dumpMaskSingle)
+{
+    if (cliDumpState.dumpMask & DUMP_ALL) {
+        cliDumpState.profileIndex = 0;
+        cliDumpState.profileEnd = count;
+    } else {
+        cliDumpState.profileIndex = currentIndex;
+        cliDumpState.profileEnd = (cliDumpState.dumpMask & (DUMP_MASTER | dumpMaskSingle)) && currentIndex < count ? currentIndex + 1 : currentIndex;
     }
+    cliDumpState.profileStarted = false;
+}
 
-    if ((dumpMask & DUMP_MASTER) || (dumpMask & DUMP_ALL)) {
+// prints the next part of the dump, returns false when the current stage is complete
+static bool cliDumpStagePart(void)
+{
+    const uint8_t dumpMask = cliDumpState.dumpMask;
+
+    switch (cliDumpState.stage) {
+    case CLI_DUMP_HEADER:
         cliPrintHashLine("version");
         cliVersion(NULL);
         cliPrintLinefeed();
@@ -4187,7 +4525,7 @@ static void printConfig(char *cmdline, bool doDiff)
         if (dumpMask & DUMP_ALL) {
             cliMcuId(NULL);
 #if defined(USE_BOARD_INFO) && defined(USE_SIGNATURE)
-        cliSignature("");
+            cliSignature("");
 #endif
         }
 
@@ -4197,26 +4535,37 @@ static void printConfig(char *cmdline, bool doDiff)
             cliPrintLinefeed();
         }
 
+        break;
+    case CLI_DUMP_NAME:
         cliPrintHashLine("name");
         printName(dumpMask, &pilotConfig_Copy);
 
+        break;
+    case CLI_DUMP_RESOURCES:
 #ifdef USE_RESOURCE_MGMT
         cliPrintHashLine("resources");
         printResource(dumpMask);
 #endif
 
+        break;
+    case CLI_DUMP_MIXER:
 #ifndef USE_QUAD_MIXER_ONLY
-        cliPrintHashLine("mixer");
-        const bool equalsDefault = mixerConfig_Copy.mixerMode == mixerConfig()->mixerMode;
-        const char *formatMixer = "mixer %s";
-        cliDefaultPrintLinef(dumpMask, equalsDefault, formatMixer, mixerNames[mixerConfig()->mixerMode - 1]);
-        cliDumpPrintLinef(dumpMask, equalsDefault, formatMixer, mixerNames[mixerConfig_Copy.mixerMode - 1]);
+        {
+            cliPrintHashLine("mixer");
+            const bool equalsDefault = mixerConfig_Copy.mixerMode == mixerConfig()->mixerMode;
+            const char *formatMixer = "mixer %s";
+            cliDefaultPrintLinef(dumpMask, equalsDefault, formatMixer, mixerNames[mixerConfig()->mixerMode - 1]);
+            cliDumpPrintLinef(dumpMask, equalsDefault, formatMixer, mixerNames[mixerConfig_Copy.mixerMode - 1]);
 
-        cliDumpPrintLinef(dumpMask, customMotorMixer(0)->throttle == 0.0f, "\r\nmmix reset\r\n");
+            cliDumpPrintLinef(dumpMask, customMotorMixer(0)->throttle == 0.0f, "\r\nmmix reset\r\n");
 
-        printMotorMix(dumpMask, customMotorMixer_CopyArray, customMotorMixer(0));
+            printMotorMix(dumpMask, customMotorMixer_CopyArray, customMotorMixer(0));
+        }
+#endif
 
-#ifdef USE_SERVOS
+        break;
+    case CLI_DUMP_SERVO:
+#if !defined(USE_QUAD_MIXER_ONLY) && defined(USE_SERVOS)
         cliPrintHashLine("servo");
         printServo(dumpMask, servoParams_CopyArray, servoParams(0));
 
@@ -4224,12 +4573,15 @@ static void printConfig(char *cmdline, bool doDiff)
         // print custom servo mixer if exists
         cliDumpPrintLinef(dumpMask, customServoMixers(0)->rate == 0, "smix reset\r\n");
         printServoMix(dumpMask, customServoMixers_CopyArray, customServoMixers(0));
-#endif
 #endif
 
+        break;
+    case CLI_DUMP_FEATURE:
         cliPrintHashLine("feature");
         printFeature(dumpMask, &featureConfig_Copy, featureConfig());
 
+        break;
+    case CLI_DUMP_BEEPER:
 #if defined(USE_BEEPER)
         cliPrintHashLine("beeper");
         printBeeper(dumpMask, beeperConfig_Copy.beeper_off_flags, beeperConfig()->beeper_off_flags, "beeper");
@@ -4240,12 +4592,18 @@ static void printConfig(char *cmdline, bool doDiff)
 #endif
 #endif // USE_BEEPER
 
+        break;
+    case CLI_DUMP_MAP:
         cliPrintHashLine("map");
         printMap(dumpMask, &rxConfig_Copy, rxConfig());
 
+        break;
+    case CLI_DUMP_SERIAL:
         cliPrintHashLine("serial");
         printSerial(dumpMask, &serialConfig_Copy, serialConfig());
 
+        break;
+    case CLI_DUMP_LED:
 #ifdef USE_LED_STRIP
         cliPrintHashLine("led");
         printLed(dumpMask, ledStripConfig_Copy.ledConfigs, ledStripConfig()->ledConfigs);
@@ -4257,30 +4615,52 @@ static void printConfig(char *cmdline, bool doDiff)
         printModeColor(dumpMask, &ledStripConfig_Copy, ledStripConfig());
 #endif
 
+        break;
+    case CLI_DUMP_AUX:
         cliPrintHashLine("aux");
         printAux(dumpMask, modeActivationConditions_CopyArray, modeActivationConditions(0));
 
+        break;
+    case CLI_DUMP_ADJRANGE:
         cliPrintHashLine("adjrange");
         printAdjustmentRange(dumpMask, adjustmentRanges_CopyArray, adjustmentRanges(0));
 
+        break;
+    case CLI_DUMP_RXRANGE:
         cliPrintHashLine("rxrange");
         printRxRange(dumpMask, rxChannelRangeConfigs_CopyArray, rxChannelRangeConfigs(0));
 
+        break;
+    case CLI_DUMP_VTX:
 #ifdef USE_VTX_CONTROL
         cliPrintHashLine("vtx");
         printVtx(dumpMask, &vtxConfig_Copy, vtxConfig());
 #endif
 
+        break;
+    case CLI_DUMP_RXFAIL:
         cliPrintHashLine("rxfail");
         printRxFailsafe(dumpMask, rxFailsafeChannelConfigs_CopyArray, rxFailsafeChannelConfigs(0));
 
+        break;
+    case CLI_DUMP_MASTER_HEADER:
         cliPrintHashLine("master");
-        dumpAllValues(MASTER_VALUE, dumpMask);
+        cliDumpState.valueIndex = 0;
 
+        break;
+    case CLI_DUMP_MASTER:
+        return !cliDumpNextValue(MASTER_VALUE);
+    case CLI_DUMP_PID_PROFILES:
+        if (cliDumpState.profileIndex >= cliDumpState.profileEnd) {
+            return false;
+        }
+        if (cliDumpNextProfileValue(PROFILE_VALUE)) {
+            cliDumpState.profileIndex++;
+        }
+
+        return true;
+    case CLI_DUMP_PID_PROFILE_RESTORE:
         if (dumpMask & DUMP_ALL) {
-            for (uint32_t pidProfileIndex = 0; pidProfileIndex < MAX_PROFILE_COUNT; pidProfileIndex++) {
-                cliDumpPidProfile(pidProfileIndex, dumpMask);
-            }
             cliPrintHashLine("restore original profile selection");
 
             pidProfileIndexToUse = systemConfig_Copy.pidProfileIndex;
@@ -4288,10 +4668,20 @@ static void printConfig(char *cmdline, bool doDiff)
             cliProfile("");
 
             pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
+        }
 
-            for (uint32_t rateIndex = 0; rateIndex < CONTROL_RATE_PROFILE_COUNT; rateIndex++) {
-                cliDumpRateProfile(rateIndex, dumpMask);
-            }
+        break;
+    case CLI_DUMP_RATE_PROFILES:
+        if (cliDumpState.profileIndex >= cliDumpState.profileEnd) {
+            return false;
+        }
+        if (cliDumpNextProfileValue(PROFILE_RATE_VALUE)) {
+            cliDumpState.profileIndex++;
+        }
+
+        return true;
+    case CLI_DUMP_RATE_PROFILE_RESTORE:
+        if (dumpMask & DUMP_ALL) {
             cliPrintHashLine("restore original rateprofile selection");
 
             rateProfileIndexToUse = systemConfig_Copy.activeRateProfile;
@@ -4299,25 +4689,98 @@ static void printConfig(char *cmdline, bool doDiff)
             cliRateProfile("");
 
             rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
+        }
 
+        break;
+    case CLI_DUMP_FOOTER:
+        if (dumpMask & DUMP_ALL) {
             cliPrintHashLine("save configuration");
             cliPrint("save");
-        } else {
-            cliDumpPidProfile(systemConfig_Copy.pidProfileIndex, dumpMask);
+        }
 
-            cliDumpRateProfile(systemConfig_Copy.activeRateProfile, dumpMask);
+        break;
+    }
+
+    return false;
+}
+
+static void cliDumpNextStage(void)
+{
+    cliDumpState.stage++;
+
+    // profile and rates only dumps skip the master sections
+    if (cliDumpState.stage < CLI_DUMP_PID_PROFILES && !(cliDumpState.dumpMask & (DUMP_MASTER | DUMP_ALL))) {
+        cliDumpState.stage = CLI_DUMP_PID_PROFILES;
+    }
+
+    switch (cliDumpState.stage) {
+    case CLI_DUMP_PID_PROFILES:
+        cliDumpSetProfileRange(systemConfig_Copy.pidProfileIndex, MAX_PROFILE_COUNT, DUMP_PROFILE);
+
+        break;
+    case CLI_DUMP_RATE_PROFILES:
+        cliDumpSetProfileRange(systemConfig_Copy.activeRateProfile, CONTROL_RATE_PROFILE_COUNT, DUMP_RATES);
+
+        break;
+    case CLI_DUMP_FOOTER + 1:
+        cliDumpState.stage = CLI_DUMP_IDLE;
+
+        break;
+    }
+}
+
+/*
+ * Prints as much of the pending dump as the serial port can take without waiting.
+ * The defaults are computed once when the dump starts and kept in the config copies. They are only swapped in while a
+ * part is printed, so the flight controller keeps running with the real configuration in between.
+ */
+static void cliDumpProcess(void)
+{
+    swapConfigs();
+
+    do {
+        if (!cliDumpStagePart()) {
+            cliDumpNextStage();
         }
+    } while (cliDumpState.stage != CLI_DUMP_IDLE && !cliDumpMustYield());
+
+    if (cliDumpState.stage == CLI_DUMP_IDLE) {
+        restoreConfigs();
+        cliPrompt();
+    } else {
+        swapConfigs();
+    }
+}
+
+static void printConfig(char *cmdline, bool doDiff)
+{
+    uint8_t dumpMask = DUMP_MASTER;
+    char *options;
+    if ((options = checkCommand(cmdline, "master"))) {
+        dumpMask = DUMP_MASTER; // only
+    } else if ((options = checkCommand(cmdline, "profile"))) {
+        dumpMask = DUMP_PROFILE; // only
+    } else if ((options = checkCommand(cmdline, "rates"))) {
+        dumpMask = DUMP_RATES; // only
+    } else if ((options = checkCommand(cmdline, "all"))) {
+        dumpMask = DUMP_ALL;   // all profiles and rates
+    } else {
+        options = cmdline;
     }
 
-    if (dumpMask & DUMP_PROFILE) {
-        cliDumpPidProfile(systemConfig_Copy.pidProfileIndex, dumpMask);
+    if (doDiff) {
+        dumpMask = dumpMask | DO_DIFF;
     }
 
-    if (dumpMask & DUMP_RATES) {
-        cliDumpRateProfile(systemConfig_Copy.activeRateProfile, dumpMask);
+    if (checkCommand(options, "defaults")) {
+        dumpMask = dumpMask | SHOW_DEFAULTS;   // add default values as comments for changed values
     }
-    // restore configs from copies
-    restoreConfigs();
+
+    cliDumpState.dumpMask = dumpMask;
+    cliDumpState.stage = CLI_DUMP_IDLE;
+    backupAndResetConfigs();
+    cliDumpNextStage();
+    swapConfigs();
 }
 
 static void cliDump(char *cmdline)
@@ -4379,7 +4842,9 @@ static void cliHelp(char *cmdline);
 // should be sorted a..z for bsearch()
 const clicmd_t cmdTable[] = {
     CLI_COMMAND_DEF("adjrange", "configure adjustment ranges", NULL, cliAdjustmentRange),
+    CLI_COMMAND_DEF("arena", "show boot arena usage", NULL, cliArena),
     CLI_COMMAND_DEF("aux", "configure modes", "<index> <mode> <aux> <start> <end> <logic>", cliAux),
+    CLI_COMMAND_DEF("batch", "print only errors until the end of the batch", "start | end", cliBatch),
 #if defined(USE_BEEPER)
 #if defined(USE_DSHOT)
     CLI_COMMAND_DEF("beacon", "enable/disable Dshot beacon for a condition", "list\r\n"
@@ -4420,6 +4885,9 @@ const clicmd_t cmdTable[] = {
     CLI_COMMAND_DEF("flash_write", NULL, "<address> <message>", cliFlashWrite),
 #endif
 #endif
+#ifdef USE_FLIGHT_SUMMARY
+    CLI_COMMAND_DEF("flightsummary", "noise, saturation and loop timing of the last flights", "[clear]", cliFlightSummary),
+#endif
 #ifdef USE_RX_FRSKY_SPI
     CLI_COMMAND_DEF("frsky_bind", "initiate binding for FrSky SPI RX", NULL, cliFrSkyBind),
 #endif
@@ -4451,8 +4919,14 @@ const clicmd_t cmdTable[] = {
     CLI_COMMAND_DEF("msc", "switch into msc mode", NULL, cliMsc),
 #endif
     CLI_COMMAND_DEF("name", "name of craft", NULL, cliName),
+#ifdef USE_PERF_REPORT
+    CLI_COMMAND_DEF("perf", "measure gyro loop timing and task load while disarmed", "[start [<seconds>]]", cliPerf),
+#endif
 #ifndef MINIMAL_CLI
     CLI_COMMAND_DEF("play_sound", NULL, "[<index>]", cliPlaySound),
+#endif
+#ifdef USE_PROFILE
+    CLI_COMMAND_DEF("probes", "show profile probe cycle counts", "[reset]", cliProbes),
 #endif
     CLI_COMMAND_DEF("profile", "change profile", "[<index>]", cliProfile),
     CLI_COMMAND_DEF("rateprofile", "change rate profile", "[<index>]", cliRateProfile),
@@ -4525,6 +4999,11 @@ void cliProcess(void)
     // Be a little bit tricky.  Flush the last inputs buffer, if any.
     bufWriterFlush(cliWriter);
 
+    if (cliDumpState.stage != CLI_DUMP_IDLE) {
+        cliDumpProcess();
+        return;
+    }
+
     while (serialRxBytesWaiting(cliPort)) {
         uint8_t c = serialRead(cliPort);
         if (c == '\t' || c == '?') {
@@ -4600,7 +5079,7 @@ void cliProcess(void)
                 if (cmd < cmdTable + ARRAYLEN(cmdTable))
                     cmd->func(options);
                 else
-                    cliPrint("Unknown command, try 'help'");
+                    cliPrintErrorLinef("Unknown command, try 'help'");
                 bufferIndex = 0;
             }
 
@@ -4610,6 +5089,18 @@ void cliProcess(void)
             if (!cliMode)
                 return;
 
+#ifdef USE_SERIAL_PASSTHROUGH
+            // the port is forwarded from now on, the rest of the input belongs to the other side
+            if (serialPassthroughIsActive()) {
+                return;
+            }
+#endif
+
+            // a dump prints the prompt once it is complete, input waits until then
+            if (cliDumpState.stage != CLI_DUMP_IDLE) {
+                return;
+            }
+
             cliPrompt();
         } else if (c == 127) {
             // backspace
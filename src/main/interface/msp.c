@@ -27,9 +27,13 @@
 #include "platform.h"
 
 #include "blackbox/blackbox.h"
+#include "blackbox/blackbox_io.h"
 
 #include "build/build_config.h"
 #include "build/debug.h"
+#include "build/debug_capture.h"
+#include "build/profile.h"
+#include "build/trace.h"
 #include "build/version.h"
 
 #include "common/axis.h"
@@ -61,8 +65,11 @@
 #include "fc/board_info.h"
 #include "fc/config.h"
 #include "fc/controlrate_profile.h"
+#include "fc/direct_setpoint.h"
+#include "fc/flight_summary.h"
 #include "fc/fc_core.h"
 #include "fc/fc_rc.h"
+#include "fc/perf_report.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
@@ -86,6 +93,7 @@
 #include "io/gps.h"
 #include "io/ledstrip.h"
 #include "io/motors.h"
+#include "io/offload.h"
 #include "io/osd.h"
 #include "io/osd_slave.h"
 #include "io/serial.h"
@@ -110,6 +118,7 @@
 
 #include "rx/rx.h"
 #include "rx/msp.h"
+#include "rx/rx_latency.h"
 
 #include "scheduler/scheduler.h"
 
@@ -121,6 +130,9 @@
 #include "sensors/esc_sensor.h"
 #include "sensors/compass.h"
 #include "sensors/gyro.h"
+#ifdef USE_GYRO_DATA_ANALYSE
+#include "sensors/gyroanalyse.h"
+#endif
 #include "sensors/rangefinder.h"
 #include "sensors/sensors.h"
 
@@ -178,7 +190,7 @@ static void mspEscPassthroughFn(serialPort_t *serialPort)
 }
 #endif
 
-static void mspFc4waySerialCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
+static mspResult_e mspFc4waySerialCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
 {
     const unsigned int dataSize = sbufBytesRemaining(src);
     if (dataSize == 0) {
@@ -222,9 +234,40 @@ static void mspFc4waySerialCommand(sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr
     default:
         sbufWriteU8(dst, 0);
     }
+
+    return MSP_RESULT_ACK;
 }
 #endif //USE_SERIAL_4WAY_BLHELI_INTERFACE
 
+static void mspEepromWriteFn(serialPort_t *serialPort)
+{
+    UNUSED(serialPort);
+
+    writeEEPROM();
+    readEEPROM();
+}
+
+static mspResult_e mspFcEepromWriteCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(src);
+    UNUSED(dst);
+
+#ifndef USE_OSD_SLAVE
+    if (ARMING_FLAG(ARMED)) {
+        return MSP_RESULT_ERROR;
+    }
+#endif
+
+    // Save once the reply has been sent, so the flash erase does not delay it or the other MSP ports
+    if (mspPostProcessFn) {
+        *mspPostProcessFn = mspEepromWriteFn;
+    } else {
+        mspEepromWriteFn(NULL);
+    }
+
+    return MSP_RESULT_ACK;
+}
+
 static void mspRebootFn(serialPort_t *serialPort)
 {
     UNUSED(serialPort);
@@ -318,6 +361,11 @@ static void serializeDataflashSummaryReply(sbuf_t *dst)
         sbufWriteU32(dst, geometry->sectors);
         sbufWriteU32(dst, geometry->totalSize);
         sbufWriteU32(dst, flashfsGetOffset()); // Effectively the current number of bytes stored on the volume
+#ifdef USE_FLASHFS_ERASE_AHEAD
+        sbufWriteU32(dst, flashfsGetEraseAheadRemaining()); // Bytes of old logs still to be erased in the background
+#else
+        sbufWriteU32(dst, 0);
+#endif
     } else
 #endif
 
@@ -327,6 +375,7 @@ static void serializeDataflashSummaryReply(sbuf_t *dst)
         sbufWriteU32(dst, 0);
         sbufWriteU32(dst, 0);
         sbufWriteU32(dst, 0);
+        sbufWriteU32(dst, 0);
     }    
 }
 
@@ -336,7 +385,8 @@ enum compressionType_e {
     HUFFMAN
 };
 
-static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, bool useLegacyFormat, bool allowCompression)
+// Returns the number of bytes read from the flash
+static int serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, bool useLegacyFormat, bool allowCompression)
 {
     BUILD_BUG_ON(MSP_PORT_DATAFLASH_INFO_SIZE < 16);
 
@@ -378,6 +428,8 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
                 sbufWriteU8(dst, 0);
             }
         }
+
+        return bytesRead;
     } else {
 #ifdef USE_HUFFMAN
         // compress in 256-byte chunks
@@ -417,9 +469,27 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
         // payload
         sbufWriteU16(dst, bytesReadTotal);
         sbufAdvance(dst, state.bytesWritten);
+
+        return bytesReadTotal;
 #endif
     }
+    return 0;
 }
+
+#ifdef USE_MSP_STREAMING
+/*
+ * Serialize up to size bytes of the flash from address in the MSP_DATAFLASH_READ reply format.
+ * dst must have MSP_PORT_DATAFLASH_INFO_SIZE bytes of room beyond size.
+ * Returns the number of bytes of flash consumed.
+ */
+int mspFcSerializeDataflashChunk(sbuf_t *dst, uint32_t address, uint16_t size, bool allowCompression)
+{
+    if (address >= flashfsGetSize()) {
+        return 0;
+    }
+    return serializeDataflashReadReply(dst, address, size, false, allowCompression);
+}
+#endif
 #endif // USE_FLASHFS
 #endif // USE_OSD_SLAVE
 
@@ -748,6 +818,13 @@ static bool mspCommonProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst, mspPostProce
         break;
     }
 
+#ifdef USE_MAX7456
+    case MSP_OSD_CHAR_WRITE_STATUS:
+        sbufWriteU8(dst, max7456FontQueueLength());
+        sbufWriteU16(dst, max7456FontCharsWritten());
+        break;
+#endif
+
     default:
         return false;
     }
@@ -830,34 +907,6 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
         }
         break;
 
-    case MSP_RAW_IMU:
-        {
-            // Hack scale due to choice of units for sensor data in multiwii
-
-            uint8_t scale;
-
-            if (acc.dev.acc_1G > 512*4) {
-                scale = 8;
-            } else if (acc.dev.acc_1G > 512*2) {
-                scale = 4;
-            } else if (acc.dev.acc_1G >= 512) {
-                scale = 2;
-            } else {
-                scale = 1;
-            }
-
-            for (int i = 0; i < 3; i++) {
-                sbufWriteU16(dst, lrintf(acc.accADC[i] / scale));
-            }
-            for (int i = 0; i < 3; i++) {
-                sbufWriteU16(dst, gyroRateDps(i));
-            }
-            for (int i = 0; i < 3; i++) {
-                sbufWriteU16(dst, lrintf(mag.magADC[i]));
-            }
-        }
-        break;
-
     case MSP_NAME:
         {
             const int nameLen = strlen(pilotConfig()->name);
@@ -895,38 +944,6 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
         break;
 #endif
 
-    case MSP_MOTOR:
-        for (unsigned i = 0; i < 8; i++) {
-            if (i >= MAX_SUPPORTED_MOTORS || !pwmGetMotors()[i].enabled) {
-                sbufWriteU16(dst, 0);
-                continue;
-            }
-
-            sbufWriteU16(dst, convertMotorToExternal(motor[i]));
-        }
-        break;
-
-    case MSP_RC:
-        for (int i = 0; i < rxRuntimeConfig.channelCount; i++) {
-            sbufWriteU16(dst, rcData[i]);
-        }
-        break;
-
-    case MSP_ATTITUDE:
-        sbufWriteU16(dst, attitude.values.roll);
-        sbufWriteU16(dst, attitude.values.pitch);
-        sbufWriteU16(dst, DECIDEGREES_TO_DEGREES(attitude.values.yaw));
-        break;
-
-    case MSP_ALTITUDE:
-#if defined(USE_BARO) || defined(USE_RANGEFINDER)
-        sbufWriteU32(dst, getEstimatedAltitude());
-#else
-        sbufWriteU32(dst, 0);
-#endif
-        sbufWriteU16(dst, getEstimatedVario());
-        break;
-
     case MSP_SONAR_ALTITUDE:
 #if defined(USE_RANGEFINDER)
         sbufWriteU32(dst, rangefinderGetLatestAltitude());
@@ -1016,6 +1033,54 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
         break;
 #endif
 
+#ifdef USE_GYRO_DATA_ANALYSE
+    case MSP_GYRO_SPECTRUM:
+        {
+            // serialised straight from the analyser, each axis scaled to its largest bin to send one byte per bin
+            const gyroAnalyseState_t *state = gyroAnalyseState();
+            const uint8_t binCount = gyroDataAnalyseBinCount();
+            const uint8_t binOffset = gyroDataAnalyseBinOffset();
+            sbufWriteU16(dst, gyroDataAnalyseSamplingRateHz());
+            sbufWriteU8(dst, binCount);
+            sbufWriteU8(dst, binOffset);
+            sbufWriteU8(dst, state->notchCount);
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                for (int n = 0; n < state->notchCount; n++) {
+                    sbufWriteU16(dst, state->centerFreq[axis][n]);
+                }
+                const float *spectrum = state->spectrum[axis];
+                float maxMagnitude = 0.0f;
+                for (int i = binOffset; i < binCount; i++) {
+                    maxMagnitude = MAX(maxMagnitude, spectrum[i]);
+                }
+                const uint16_t scale = MIN(lrintf(maxMagnitude), UINT16_MAX);
+                sbufWriteU16(dst, scale);
+                const float binScale = scale ? 255.0f / maxMagnitude : 0.0f;
+                for (int i = binOffset; i < binCount; i++) {
+                    sbufWriteU8(dst, lrintf(spectrum[i] * binScale));
+                }
+            }
+        }
+        break;
+#endif
+
+#ifdef USE_RX_LATENCY_STATISTICS
+    case MSP_RX_LATENCY:
+        {
+            const rxLatencyStats_t *stats = rxLatencyStats();
+            sbufWriteU32(dst, stats->count);
+            sbufWriteU32(dst, stats->minUs);
+            sbufWriteU32(dst, rxLatencyAverageUs());
+            sbufWriteU32(dst, stats->maxUs);
+            sbufWriteU8(dst, RX_LATENCY_HISTOGRAM_BUCKET_COUNT);
+            sbufWriteU16(dst, RX_LATENCY_HISTOGRAM_BUCKET_US);
+            for (int i = 0; i < RX_LATENCY_HISTOGRAM_BUCKET_COUNT; i++) {
+                sbufWriteU16(dst, stats->histogram[i]);
+            }
+        }
+        break;
+#endif
+
 #if defined(USE_ESC_SENSOR)
     case MSP_ESC_SENSOR_DATA:
         if (feature(FEATURE_ESC_SENSOR)) {
@@ -1394,70 +1459,467 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
 }
 #endif // USE_OSD_SLAVE
 
-static mspResult_e mspFcProcessOutCommandWithArg(uint8_t cmdMSP, sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+#ifndef USE_OSD_SLAVE
+static mspResult_e mspFcRawImuCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
 {
-#if defined(USE_OSD_SLAVE)
-        UNUSED(dst);
-#endif
+    UNUSED(src);
+    UNUSED(mspPostProcessFn);
 
-    switch (cmdMSP) {
-#if !defined(USE_OSD_SLAVE)
-    case MSP_BOXNAMES:
-        {
-            const int page = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
-            serializeBoxReply(dst, page, &serializeBoxNameFn);
-        }
-        break;
-    case MSP_BOXIDS:
-        {
-            const int page = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
-            serializeBoxReply(dst, page, &serializeBoxPermanentIdFn);
+    // Hack scale due to choice of units for sensor data in multiwii
+
+    uint8_t scale;
+
+    if (acc.dev.acc_1G > 512*4) {
+        scale = 8;
+    } else if (acc.dev.acc_1G > 512*2) {
+        scale = 4;
+    } else if (acc.dev.acc_1G >= 512) {
+        scale = 2;
+    } else {
+        scale = 1;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        sbufWriteU16(dst, lrintf(acc.accADC[i] / scale));
+    }
+    for (int i = 0; i < 3; i++) {
+        sbufWriteU16(dst, gyroRateDps(i));
+    }
+    for (int i = 0; i < 3; i++) {
+        sbufWriteU16(dst, lrintf(mag.magADC[i]));
+    }
+
+    return MSP_RESULT_ACK;
+}
+
+static mspResult_e mspFcMotorCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(src);
+    UNUSED(mspPostProcessFn);
+
+    for (unsigned i = 0; i < 8; i++) {
+        if (i >= MAX_SUPPORTED_MOTORS || !pwmGetMotors()[i].enabled) {
+            sbufWriteU16(dst, 0);
+            continue;
         }
-        break;
+
+        sbufWriteU16(dst, convertMotorToExternal(motor[i]));
+    }
+
+    return MSP_RESULT_ACK;
+}
+
+static mspResult_e mspFcRcCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(src);
+    UNUSED(mspPostProcessFn);
+
+    for (int i = 0; i < rxRuntimeConfig.channelCount; i++) {
+        sbufWriteU16(dst, rcData[i]);
+    }
+
+    return MSP_RESULT_ACK;
+}
+
+static mspResult_e mspFcAttitudeCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(src);
+    UNUSED(mspPostProcessFn);
+
+    const attitudeEulerAngles_t *attitude = getAttitude();
+    sbufWriteU16(dst, attitude->values.roll);
+    sbufWriteU16(dst, attitude->values.pitch);
+    sbufWriteU16(dst, DECIDEGREES_TO_DEGREES(attitude->values.yaw));
+
+    return MSP_RESULT_ACK;
+}
+
+static mspResult_e mspFcAltitudeCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(src);
+    UNUSED(mspPostProcessFn);
+
+#if defined(USE_BARO) || defined(USE_RANGEFINDER)
+    sbufWriteU32(dst, getEstimatedAltitude());
+#else
+    sbufWriteU32(dst, 0);
 #endif
-    case MSP_REBOOT:
-        if (sbufBytesRemaining(src)) {
-            rebootMode = sbufReadU8(src);
+    sbufWriteU16(dst, getEstimatedVario());
+
+    return MSP_RESULT_ACK;
+}
+
+static mspResult_e mspFcBoxNamesCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
 
-            if (rebootMode >= MSP_REBOOT_COUNT
+    const int page = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
+    serializeBoxReply(dst, page, &serializeBoxNameFn);
+
+    return MSP_RESULT_ACK;
+}
+
+static mspResult_e mspFcBoxIdsCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    const int page = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
+    serializeBoxReply(dst, page, &serializeBoxPermanentIdFn);
+
+    return MSP_RESULT_ACK;
+}
+#endif // USE_OSD_SLAVE
+
+static mspResult_e mspFcRebootCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    if (sbufBytesRemaining(src)) {
+        rebootMode = sbufReadU8(src);
+
+        if (rebootMode >= MSP_REBOOT_COUNT
 #if !defined(USE_USB_MSC)
-                || rebootMode == MSP_REBOOT_MSC
+            || rebootMode == MSP_REBOOT_MSC
 #endif
-                ) {
-                return MSP_RESULT_ERROR;
-            }
-        } else {
-            rebootMode = MSP_REBOOT_FIRMWARE;
+            ) {
+            return MSP_RESULT_ERROR;
         }
+    } else {
+        rebootMode = MSP_REBOOT_FIRMWARE;
+    }
 
-        sbufWriteU8(dst, rebootMode);
+    sbufWriteU8(dst, rebootMode);
 
 #if defined(USE_USB_MSC)
-        if (rebootMode == MSP_REBOOT_MSC) {
-            if (mscCheckFilesystemReady()) {
-                sbufWriteU8(dst, 1);
-            } else {
-                sbufWriteU8(dst, 0);
+    if (rebootMode == MSP_REBOOT_MSC) {
+        if (mscCheckFilesystemReady()) {
+            sbufWriteU8(dst, 1);
+        } else {
+            sbufWriteU8(dst, 0);
 
-                return MSP_RESULT_ACK;
-            }
+            return MSP_RESULT_ACK;
         }
+    }
 #endif
 
-        if (mspPostProcessFn) {
-            *mspPostProcessFn = mspRebootFn;
+    if (mspPostProcessFn) {
+        *mspPostProcessFn = mspRebootFn;
+    }
+
+    return MSP_RESULT_ACK;
+}
+
+#ifdef USE_TASK_STATISTICS_HISTOGRAM
+static mspResult_e mspFcTaskStatisticsCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    const cfTaskId_e taskId = sbufBytesRemaining(src) ? sbufReadU8(src) : TASK_GYROPID;
+    if (taskId >= TASK_COUNT) {
+        return MSP_RESULT_ERROR;
+    }
+    cfTaskInfo_t taskInfo;
+    getTaskInfo(taskId, &taskInfo);
+    sbufWriteU8(dst, taskId);
+    sbufWriteU8(dst, taskInfo.isEnabled);
+    sbufWriteU32(dst, taskInfo.desiredPeriod);
+    sbufWriteU32(dst, taskInfo.maxExecutionTime);
+    sbufWriteU32(dst, taskInfo.averageExecutionTime);
+    sbufWriteU32(dst, taskInfo.lateCount);
+    sbufWriteU8(dst, TASK_HISTOGRAM_BUCKET_COUNT);
+    for (int i = 0; i < TASK_HISTOGRAM_BUCKET_COUNT; i++) {
+        sbufWriteU16(dst, taskInfo.executionTimeHistogram[i]);
+    }
+
+    return MSP_RESULT_ACK;
+}
+#endif
+
+#ifdef USE_PROFILE
+// Request: probe id (U8, default 0), reset all probes after the reply if non zero (U8, default 0)
+static mspResult_e mspFcProfileCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    const profileId_e id = sbufBytesRemaining(src) ? sbufReadU8(src) : PROFILE_GYRO_READ;
+    const bool reset = sbufBytesRemaining(src) ? sbufReadU8(src) : false;
+    if (id >= PROFILE_COUNT) {
+        return MSP_RESULT_ERROR;
+    }
+    const profileProbe_t *probe = &profileProbes[id];
+    sbufWriteU8(dst, id);
+    sbufWriteU8(dst, PROFILE_COUNT);
+    sbufWriteU16(dst, SystemCoreClock / 1000000);
+    sbufWriteU32(dst, probe->count);
+    sbufWriteU32(dst, probe->count ? probe->minCycles : 0);
+    sbufWriteU32(dst, probe->maxCycles);
+    sbufWriteU32(dst, probe->count ? probe->totalCycles / probe->count : 0);
+    sbufWriteU8(dst, PROFILE_HISTOGRAM_BUCKET_COUNT);
+    for (int i = 0; i < PROFILE_HISTOGRAM_BUCKET_COUNT; i++) {
+        sbufWriteU32(dst, probe->histogram[i]);
+    }
+    sbufWriteString(dst, profileNames[id]);
+
+    if (reset) {
+        profileReset();
+    }
+
+    return MSP_RESULT_ACK;
+}
+#endif
+
+#ifdef USE_PERF_REPORT
+static void mspWritePerfLatency(sbuf_t *dst, const perfLatency_t *latency)
+{
+    sbufWriteU32(dst, latency->count);
+    sbufWriteU32(dst, latency->minUs);
+    sbufWriteU32(dst, perfLatencyAverageUs(latency));
+    sbufWriteU32(dst, latency->maxUs);
+}
+
+// Request: measurement duration in seconds (U16), optional, starts a new measurement before replying
+static mspResult_e mspFcPerfReportCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    if (sbufBytesRemaining(src) >= 2) {
+        const int durationS = sbufReadU16(src);
+        if (durationS < 1 || durationS > PERF_REPORT_DURATION_MAX_S || !perfReportStart(durationS)) {
+            return MSP_RESULT_ERROR;
         }
+    }
 
+    const perfReport_t *report = perfReportGet();
+    sbufWriteU8(dst, report->state);
+    sbufWriteU32(dst, report->durationUs);
+    sbufWriteU16(dst, report->targetLooptimeUs);
+    mspWritePerfLatency(dst, &report->extiToRead);
+    mspWritePerfLatency(dst, &report->gyroToMotor);
+    mspWritePerfLatency(dst, &report->gyroRead);
+    sbufWriteU32(dst, report->periodCount);
+    sbufWriteU16(dst, lrintf(perfReportJitterStdDevUs() * 10));
+    sbufWriteU16(dst, perfReportJitterPercentileUs(50));
+    sbufWriteU16(dst, perfReportJitterPercentileUs(99));
+    sbufWriteU16(dst, perfReportJitterPercentileUs(100));
+    sbufWriteU8(dst, TASK_COUNT);
+    for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        sbufWriteU32(dst, report->taskExecutionTimeUs[taskId]);
+    }
+    sbufWriteU32(dst, report->spiErrors);
+    sbufWriteU32(dst, report->i2cErrors);
+    sbufWriteU32(dst, report->dmaAcquireFailures);
+    sbufWriteU8(dst, report->dmaAllocateFailures);
+
+    return MSP_RESULT_ACK;
+}
+#endif
+
+#if defined(USE_DEBUG_CAPTURE) || defined(USE_TRACE)
+// First byte of the requests of the RAM captures
+typedef enum {
+    MSP_CAPTURE_ACTION_STATUS = 0,
+    MSP_CAPTURE_ACTION_START,
+    MSP_CAPTURE_ACTION_STOP,
+    MSP_CAPTURE_ACTION_READ,
+} mspCaptureAction_e;
+#endif
+
+#ifdef USE_DEBUG_CAPTURE
+// Request: action (U8), then for START the sample count (U32, 0 until stopped), mode count (U8) and the modes (U8 each),
+// for READ the index of the first sample (U16). READ appends as many samples as fit to the status.
+static mspResult_e mspFcDebugCaptureCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    const uint8_t action = sbufBytesRemaining(src) ? sbufReadU8(src) : MSP_CAPTURE_ACTION_STATUS;
+    uint16_t index = 0;
+    switch (action) {
+    case MSP_CAPTURE_ACTION_STATUS:
+        break;
+    case MSP_CAPTURE_ACTION_READ:
+        if (sbufBytesRemaining(src) < 2 || debugCaptureGetState() != DEBUG_CAPTURE_STOPPED) {
+            return MSP_RESULT_ERROR;
+        }
+        index = sbufReadU16(src);
+        break;
+    case MSP_CAPTURE_ACTION_START: {
+        if (sbufBytesRemaining(src) < 5) {
+            return MSP_RESULT_ERROR;
+        }
+        const uint32_t sampleCount = sbufReadU32(src);
+        const int modeCount = sbufReadU8(src);
+        if (modeCount > DEBUG_CAPTURE_MODE_COUNT || sbufBytesRemaining(src) < modeCount
+            || !debugCaptureStart(sbufPtr(src), modeCount, sampleCount)) {
+            return MSP_RESULT_ERROR;
+        }
+        sbufAdvance(src, modeCount);
+        break;
+    }
+    case MSP_CAPTURE_ACTION_STOP:
+        debugCaptureStop();
         break;
     default:
-        return MSP_RESULT_CMD_UNKNOWN;
+        return MSP_RESULT_ERROR;
+    }
+
+    const int modeCount = debugCaptureModeCount();
+    sbufWriteU8(dst, debugCaptureGetState());
+    sbufWriteU16(dst, gyro.targetLooptime);
+    sbufWriteU16(dst, debugCaptureCapacity());
+    sbufWriteU32(dst, debugCaptureSamplesTaken());
+    sbufWriteU16(dst, debugCaptureSamplesHeld());
+    sbufWriteU8(dst, modeCount);
+    for (int i = 0; i < modeCount; i++) {
+        sbufWriteU8(dst, debugCaptureMode(i));
     }
+
+    if (action == MSP_CAPTURE_ACTION_READ) {
+        const int sampleSize = modeCount * DEBUG16_VALUE_COUNT * sizeof(int16_t);
+        const int sampleCount = MIN(MAX(sbufBytesRemaining(dst) - 3, 0) / sampleSize, 255);
+        sbufWriteU16(dst, index);
+        uint8_t *countPtr = sbufPtr(dst);
+        sbufWriteU8(dst, 0);
+        int written = 0;
+        const int16_t *sample;
+        while (written < sampleCount && (sample = debugCaptureGetSample(index))) {
+            for (int i = 0; i < modeCount * DEBUG16_VALUE_COUNT; i++) {
+                sbufWriteU16(dst, sample[i]);
+            }
+            index++;
+            written++;
+        }
+        *countPtr = written;
+    }
+
     return MSP_RESULT_ACK;
 }
+#endif
+
+#ifdef USE_TRACE
+// Request: action (U8), then for READ the index of the first event (U16). READ appends as many events as fit to the status.
+static mspResult_e mspFcTraceCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    const uint8_t action = sbufBytesRemaining(src) ? sbufReadU8(src) : MSP_CAPTURE_ACTION_STATUS;
+    uint16_t index = 0;
+    switch (action) {
+    case MSP_CAPTURE_ACTION_STATUS:
+        break;
+    case MSP_CAPTURE_ACTION_START:
+        traceStart();
+        break;
+    case MSP_CAPTURE_ACTION_STOP:
+        traceStop();
+        break;
+    case MSP_CAPTURE_ACTION_READ:
+        if (sbufBytesRemaining(src) < 2 || traceGetState() != TRACE_STOPPED) {
+            return MSP_RESULT_ERROR;
+        }
+        index = sbufReadU16(src);
+        break;
+    default:
+        return MSP_RESULT_ERROR;
+    }
+
+    sbufWriteU8(dst, traceGetState());
+    sbufWriteU32(dst, SystemCoreClock);
+    sbufWriteU16(dst, TRACE_BUFFER_EVENTS);
+    sbufWriteU32(dst, traceEventsRecorded());
+    sbufWriteU16(dst, traceEventsHeld());
+
+    if (action == MSP_CAPTURE_ACTION_READ) {
+        const int eventCount = MIN(MAX(sbufBytesRemaining(dst) - 3, 0) / (int)sizeof(traceEvent_t), 255);
+        sbufWriteU16(dst, index);
+        uint8_t *countPtr = sbufPtr(dst);
+        sbufWriteU8(dst, 0);
+        int written = 0;
+        const traceEvent_t *event;
+        while (written < eventCount && (event = traceGetEvent(index))) {
+            sbufWriteU32(dst, event->cycles);
+            sbufWriteU32(dst, event->event);
+            index++;
+            written++;
+        }
+        *countPtr = written;
+    }
+
+    return MSP_RESULT_ACK;
+}
+#endif
+
+#ifdef USE_DIRECT_SETPOINT
+// Request, optional: sender time (U32 us), mode (U8), roll, pitch and yaw (S16), throttle (U16). Replies with the statistics.
+static mspResult_e mspFcDirectSetpointCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    if (sbufBytesRemaining(src)) {
+        if (sbufBytesRemaining(src) < 12) {
+            return MSP_RESULT_ERROR;
+        }
+        directSetpoint_t setpoint;
+        setpoint.senderTimeUs = sbufReadU32(src);
+        setpoint.mode = sbufReadU8(src);
+        for (int axis = 0; axis < 3; axis++) {
+            setpoint.axis[axis] = sbufReadU16(src);
+        }
+        setpoint.throttle = sbufReadU16(src);
+        if (!directSetpointReceive(&setpoint, micros())) {
+            return MSP_RESULT_ERROR;
+        }
+    }
+
+    const directSetpointStats_t *stats = directSetpointGetStats();
+    sbufWriteU8(dst, directSetpointIsActive());
+    sbufWriteU32(dst, stats->lastSenderTimeUs);
+    sbufWriteU32(dst, stats->latencyLastUs);
+    sbufWriteU32(dst, directSetpointLatencyAverageUs());
+    sbufWriteU32(dst, stats->latencyMaxUs);
+    sbufWriteU32(dst, stats->received);
+    sbufWriteU32(dst, stats->flown);
+    sbufWriteU32(dst, stats->timeouts);
+
+    return MSP_RESULT_ACK;
+}
+#endif
+
+#ifdef USE_FLIGHT_SUMMARY
+// Request, optional: clear (U8)
+static mspResult_e mspFcFlightSummaryCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    if (sbufBytesRemaining(src) && sbufReadU8(src)) {
+        flightSummaryClear();
+    }
+
+    const int count = flightSummaryCount();
+    sbufWriteU8(dst, count);
+    for (int i = 0; i < count; i++) {
+        const flightSummary_t *summary = flightSummaryGet(i);
+        sbufWriteU32(dst, summary->flightNumber);
+        sbufWriteU16(dst, summary->durationS);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            sbufWriteU16(dst, summary->gyroNoisePrefilteredRms[axis]);
+        }
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            sbufWriteU16(dst, summary->gyroNoiseFilteredRms[axis]);
+        }
+        sbufWriteU16(dst, summary->motorSaturationPermille);
+        sbufWriteU16(dst, summary->dynNotchMinHz);
+        sbufWriteU16(dst, summary->dynNotchMaxHz);
+        sbufWriteU16(dst, summary->loopOverruns);
+        sbufWriteU16(dst, summary->maxLoadPercent);
+    }
+
+    return MSP_RESULT_ACK;
+}
+#endif
 
 #ifdef USE_FLASHFS
-static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src)
+static mspResult_e mspFcDataFlashReadCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
 {
+    UNUSED(mspPostProcessFn);
+
     const unsigned int dataSize = sbufBytesRemaining(src);
     const uint32_t readAddress = sbufReadU32(src);
     uint16_t readLength;
@@ -1475,6 +1937,179 @@ static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src)
     }
 
     serializeDataflashReadReply(dst, readAddress, readLength, useLegacyFormat, allowCompression);
+
+    return MSP_RESULT_ACK;
+}
+#endif
+
+#ifdef USE_FLASHFS_LOG_INDEX
+#define MSP_DATAFLASH_LOG_INDEX_ENTRY_SIZE 14
+
+/*
+ * Reply with as many entries of the flash log index as fit, starting at the requested one.
+ */
+static mspResult_e mspFcDataFlashLogIndexCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    const int firstEntry = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : 0;
+    const int entryCount = flashfsLogIndexCount();
+    sbufWriteU16(dst, entryCount);
+    sbufWriteU16(dst, firstEntry);
+
+    uint8_t *countPtr = sbufPtr(dst);
+    sbufWriteU8(dst, 0);
+    uint8_t count = 0;
+    flashfsLogIndexEntry_t entry;
+    for (int i = firstEntry; i < entryCount && sbufBytesRemaining(dst) >= MSP_DATAFLASH_LOG_INDEX_ENTRY_SIZE; i++) {
+        if (!flashfsLogIndexRead(i, &entry)) {
+            break;
+        }
+        sbufWriteU32(dst, entry.start);
+        sbufWriteU32(dst, entry.size);
+        sbufWriteU32(dst, entry.armTime);
+        sbufWriteU16(dst, entry.duration);
+        count++;
+    }
+    *countPtr = count;
+
+    return MSP_RESULT_ACK;
+}
+#endif
+
+#ifdef USE_MSP_PG_TRANSFER
+#define MSP_PG_TRANSACTION_MAX_GROUPS 32
+
+#define MSP_PG_WRITE_FLAG_LAST_CHUNK (1 << 0)
+
+typedef enum {
+    MSP_PG_TRANSACTION_BEGIN = 0,
+    MSP_PG_TRANSACTION_COMMIT,
+    MSP_PG_TRANSACTION_ABORT,
+} mspPgTransactionAction_e;
+
+// Writes are staged in the copy of the group, so an incomplete transfer never reaches the active configuration
+static bool mspPgTransactionActive;
+static const pgRegistry_t *mspPgStagedGroups[MSP_PG_TRANSACTION_MAX_GROUPS];
+static uint8_t mspPgStagedGroupCount;
+
+static void mspPgApply(const pgRegistry_t *reg)
+{
+    memcpy(reg->address, reg->copy, pgSize(reg));
+}
+
+/*
+ * MSP2_PG_READ payload: pgn (U16), offset (U16, optional).
+ * Reply: pgn (U16), version (U8), size (U16), offset (U16), followed by as much of the group as fits.
+ */
+static mspResult_e mspFcPgReadCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    const pgRegistry_t *reg = pgFind(sbufReadU16(src));
+    const uint16_t offset = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : 0;
+    if (!reg || offset > pgSize(reg)) {
+        return MSP_RESULT_ERROR;
+    }
+
+    sbufWriteU16(dst, pgN(reg));
+    sbufWriteU8(dst, pgVersion(reg));
+    sbufWriteU16(dst, pgSize(reg));
+    sbufWriteU16(dst, offset);
+    const int length = MIN(pgSize(reg) - offset, sbufBytesRemaining(dst));
+    sbufWriteData(dst, reg->address + offset, length);
+
+    return MSP_RESULT_ACK;
+}
+
+/*
+ * MSP2_PG_WRITE payload: pgn (U16), version (U8), offset (U16), flags (U8), followed by the data.
+ * A write at offset 0 starts from the defaults, so a shorter group from an older firmware loads like pgLoad() does.
+ * The last chunk applies the group, or stages it until the transaction is committed.
+ */
+static mspResult_e mspFcPgWriteCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(dst);
+    UNUSED(mspPostProcessFn);
+
+#ifndef USE_OSD_SLAVE
+    if (ARMING_FLAG(ARMED)) {
+        return MSP_RESULT_ERROR;
+    }
+#endif
+
+    const pgRegistry_t *reg = pgFind(sbufReadU16(src));
+    const uint8_t version = sbufReadU8(src);
+    const uint16_t offset = sbufReadU16(src);
+    const uint8_t flags = sbufReadU8(src);
+    const int length = sbufBytesRemaining(src);
+    if (!reg || version != pgVersion(reg) || offset + length > pgSize(reg)) {
+        return MSP_RESULT_ERROR;
+    }
+
+    if (offset == 0) {
+        pgResetInstance(reg, reg->copy);
+    }
+    sbufReadData(src, reg->copy + offset, length);
+
+    if (flags & MSP_PG_WRITE_FLAG_LAST_CHUNK) {
+        if (!mspPgTransactionActive) {
+            mspPgApply(reg);
+        } else {
+            for (unsigned i = 0; i < mspPgStagedGroupCount; i++) {
+                if (mspPgStagedGroups[i] == reg) {
+                    return MSP_RESULT_ACK;
+                }
+            }
+            if (mspPgStagedGroupCount >= MSP_PG_TRANSACTION_MAX_GROUPS) {
+                return MSP_RESULT_ERROR;
+            }
+            mspPgStagedGroups[mspPgStagedGroupCount++] = reg;
+        }
+    }
+
+    return MSP_RESULT_ACK;
+}
+
+/*
+ * MSP2_PG_TRANSACTION payload: action (U8, see mspPgTransactionAction_e).
+ * Commit applies all staged groups together and saves the configuration once.
+ */
+static mspResult_e mspFcPgTransactionCommand(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+{
+#ifndef USE_OSD_SLAVE
+    if (ARMING_FLAG(ARMED)) {
+        return MSP_RESULT_ERROR;
+    }
+#endif
+
+    switch (sbufReadU8(src)) {
+    case MSP_PG_TRANSACTION_BEGIN:
+        mspPgTransactionActive = true;
+        mspPgStagedGroupCount = 0;
+
+        break;
+    case MSP_PG_TRANSACTION_COMMIT:
+        if (!mspPgTransactionActive) {
+            return MSP_RESULT_ERROR;
+        }
+        for (unsigned i = 0; i < mspPgStagedGroupCount; i++) {
+            mspPgApply(mspPgStagedGroups[i]);
+        }
+        mspPgTransactionActive = false;
+        mspPgStagedGroupCount = 0;
+
+        return mspFcEepromWriteCommand(src, dst, mspPostProcessFn);
+    case MSP_PG_TRANSACTION_ABORT:
+        mspPgTransactionActive = false;
+        mspPgStagedGroupCount = 0;
+
+        break;
+    default:
+        return MSP_RESULT_ERROR;
+    }
+
+    return MSP_RESULT_ACK;
 }
 #endif
 
@@ -1489,10 +2124,6 @@ static mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src)
         resetEEPROM();
         readEEPROM();
         break;
-    case MSP_EEPROM_WRITE:
-        writeEEPROM();
-        readEEPROM();
-        break;
     default:
         // we do not know how to handle the (valid) message, indicate error MSP $M!
         return MSP_RESULT_ERROR;
@@ -1714,6 +2345,7 @@ static mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src)
             servoParamsMutable(i)->rate = sbufReadU8(src);
             servoParamsMutable(i)->forwardFromChannel = sbufReadU8(src);
             servoParamsMutable(i)->reversedSources = sbufReadU32(src);
+            servoMixerCompileRules();
         }
 #endif
         break;
@@ -1909,14 +2541,6 @@ static mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src)
             ENABLE_STATE(CALIBRATE_MAG);
         break;
 
-    case MSP_EEPROM_WRITE:
-        if (ARMING_FLAG(ARMED)) {
-            return MSP_RESULT_ERROR;
-        }
-        writeEEPROM();
-        readEEPROM();
-        break;
-
 #ifdef USE_BLACKBOX
     case MSP_SET_BLACKBOX_CONFIG:
         // Don't allow config to be updated while Blackbox is logging
@@ -2011,7 +2635,11 @@ static mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src)
 
 #ifdef USE_FLASHFS
     case MSP_DATAFLASH_ERASE:
+#ifdef USE_BLACKBOX
+        blackboxEraseFlash();
+#else
         flashfsEraseCompletely();
+#endif
         break;
 #endif
 
@@ -2449,9 +3077,9 @@ static mspResult_e mspCommonProcessInCommand(uint8_t cmdMSP, sbuf_t *src, mspPos
     case MSP_OSD_CHAR_WRITE:
 #ifdef USE_MAX7456
         {
-            uint8_t font_data[64];
+            uint8_t font_data[MAX7456_FONT_CHAR_BYTES];
             const uint8_t addr = sbufReadU8(src);
-            for (int i = 0; i < 54; i++) {
+            for (int i = 0; i < MAX7456_FONT_CHAR_BYTES; i++) {
                 font_data[i] = sbufReadU8(src);
             }
             // !!TODO - replace this with a device independent implementation
@@ -2472,6 +3100,89 @@ static mspResult_e mspCommonProcessInCommand(uint8_t cmdMSP, sbuf_t *src, mspPos
 /*
  * Returns MSP_RESULT_ACK, MSP_RESULT_ERROR or MSP_RESULT_NO_REPLY
  */
+// Must be kept sorted by cmd, looked up by binary search before falling back to the switch based handlers
+static const mspCommandEntry_t mspFcCommands[] = {
+    { MSP_REBOOT,               mspFcRebootCommand,             MSP_COMMAND_FLAG_NONE },
+#ifdef USE_FLASHFS
+    { MSP_DATAFLASH_READ,       mspFcDataFlashReadCommand,      MSP_COMMAND_FLAG_READ_ONLY },
+#endif
+#ifndef USE_OSD_SLAVE
+    { MSP_RAW_IMU,              mspFcRawImuCommand,             MSP_COMMAND_FLAG_READ_ONLY },
+    { MSP_MOTOR,                mspFcMotorCommand,              MSP_COMMAND_FLAG_READ_ONLY },
+    { MSP_RC,                   mspFcRcCommand,                 MSP_COMMAND_FLAG_READ_ONLY },
+    { MSP_ATTITUDE,             mspFcAttitudeCommand,           MSP_COMMAND_FLAG_READ_ONLY },
+    { MSP_ALTITUDE,             mspFcAltitudeCommand,           MSP_COMMAND_FLAG_READ_ONLY },
+    { MSP_BOXNAMES,             mspFcBoxNamesCommand,           MSP_COMMAND_FLAG_READ_ONLY },
+    { MSP_BOXIDS,               mspFcBoxIdsCommand,             MSP_COMMAND_FLAG_READ_ONLY },
+#endif
+#ifdef USE_TASK_STATISTICS_HISTOGRAM
+    { MSP_TASK_STATISTICS,      mspFcTaskStatisticsCommand,     MSP_COMMAND_FLAG_READ_ONLY },
+#endif
+#ifdef USE_FLASHFS_LOG_INDEX
+    { MSP_DATAFLASH_LOG_INDEX,  mspFcDataFlashLogIndexCommand,  MSP_COMMAND_FLAG_READ_ONLY },
+#endif
+#ifdef USE_SERIAL_4WAY_BLHELI_INTERFACE
+    { MSP_SET_4WAY_IF,          mspFc4waySerialCommand,         MSP_COMMAND_FLAG_NONE },
+#endif
+    { MSP_EEPROM_WRITE,         mspFcEepromWriteCommand,        MSP_COMMAND_FLAG_NONE },
+#ifdef USE_MSP_PG_TRANSFER
+    { MSP2_PG_READ,             mspFcPgReadCommand,             MSP_COMMAND_FLAG_READ_ONLY },
+    { MSP2_PG_WRITE,            mspFcPgWriteCommand,            MSP_COMMAND_FLAG_NONE },
+    { MSP2_PG_TRANSACTION,      mspFcPgTransactionCommand,      MSP_COMMAND_FLAG_NONE },
+#endif
+#ifdef USE_PROFILE
+    { MSP2_PROFILE,             mspFcProfileCommand,            MSP_COMMAND_FLAG_NONE },
+#endif
+#ifdef USE_PERF_REPORT
+    { MSP2_PERF_REPORT,         mspFcPerfReportCommand,         MSP_COMMAND_FLAG_NONE },
+#endif
+#ifdef USE_DEBUG_CAPTURE
+    { MSP2_DEBUG_CAPTURE,       mspFcDebugCaptureCommand,       MSP_COMMAND_FLAG_NONE },
+#endif
+#ifdef USE_TRACE
+    { MSP2_TRACE,               mspFcTraceCommand,              MSP_COMMAND_FLAG_NONE },
+#endif
+#ifdef USE_DIRECT_SETPOINT
+    { MSP2_DIRECT_SETPOINT,     mspFcDirectSetpointCommand,     MSP_COMMAND_FLAG_NONE },
+#endif
+#ifdef USE_FLIGHT_SUMMARY
+    { MSP2_FLIGHT_SUMMARY,      mspFcFlightSummaryCommand,      MSP_COMMAND_FLAG_NONE },
+#endif
+};
+
+static const mspCommandEntry_t *mspExtraCommands;
+static unsigned mspExtraCommandCount;
+
+/*
+ * Register a table of additional commands, sorted by cmd, checked after the built in table.
+ * Replaces any previously registered table.
+ */
+void mspRegisterCommands(const mspCommandEntry_t *commands, unsigned count)
+{
+    mspExtraCommands = commands;
+    mspExtraCommandCount = count;
+}
+
+const mspCommandEntry_t *mspFindCommand(const mspCommandEntry_t *commands, unsigned count, uint16_t cmd)
+{
+    unsigned low = 0;
+    unsigned high = count;
+
+    while (low < high) {
+        const unsigned mid = (low + high) / 2;
+        if (commands[mid].cmd < cmd) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (low < count && commands[low].cmd == cmd) {
+        return &commands[low];
+    }
+    return NULL;
+}
+
 mspResult_e mspFcProcessCommand(mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn)
 {
     int ret = MSP_RESULT_ACK;
@@ -2481,22 +3192,17 @@ mspResult_e mspFcProcessCommand(mspPacket_t *cmd, mspPacket_t *reply, mspPostPro
     // initialize reply by default
     reply->cmd = cmd->cmd;
 
-    if (mspCommonProcessOutCommand(cmdMSP, dst, mspPostProcessFn)) {
+    const mspCommandEntry_t *command = mspFindCommand(mspFcCommands, ARRAYLEN(mspFcCommands), cmd->cmd);
+    if (!command && mspExtraCommands) {
+        command = mspFindCommand(mspExtraCommands, mspExtraCommandCount, cmd->cmd);
+    }
+
+    if (command) {
+        ret = command->fn(src, dst, mspPostProcessFn);
+    } else if (mspCommonProcessOutCommand(cmdMSP, dst, mspPostProcessFn)) {
         ret = MSP_RESULT_ACK;
     } else if (mspProcessOutCommand(cmdMSP, dst)) {
         ret = MSP_RESULT_ACK;
-    } else if ((ret = mspFcProcessOutCommandWithArg(cmdMSP, src, dst, mspPostProcessFn)) != MSP_RESULT_CMD_UNKNOWN) {
-        /* ret */;
-#ifdef USE_SERIAL_4WAY_BLHELI_INTERFACE
-    } else if (cmdMSP == MSP_SET_4WAY_IF) {
-        mspFc4waySerialCommand(dst, src, mspPostProcessFn);
-        ret = MSP_RESULT_ACK;
-#endif
-#ifdef USE_FLASHFS
-    } else if (cmdMSP == MSP_DATAFLASH_READ) {
-        mspFcDataFlashReadCommand(dst, src);
-        ret = MSP_RESULT_ACK;
-#endif
     } else {
         ret = mspCommonProcessInCommand(cmdMSP, src, mspPostProcessFn);
     }
@@ -2565,6 +3271,11 @@ void mspFcProcessReply(mspPacket_t *reply)
             }
         }
         break;
+#ifdef USE_OFFLOAD
+    case MSP_OFFLOAD:
+        offloadProcessRecord(src, micros());
+        break;
+#endif
 #endif
     }
 }
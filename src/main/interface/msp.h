@@ -58,8 +58,23 @@ struct serialPort_s;
 typedef void (*mspPostProcessFnPtr)(struct serialPort_s *port); // msp post process function, used for gracefully handling reboots, etc.
 typedef mspResult_e (*mspProcessCommandFnPtr)(mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn);
 typedef void (*mspProcessReplyFnPtr)(mspPacket_t *cmd);
+typedef mspResult_e (*mspCommandFnPtr)(sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn);
+
+typedef enum {
+    MSP_COMMAND_FLAG_NONE       = 0,
+    MSP_COMMAND_FLAG_READ_ONLY  = 1 << 0,   // only reports state, the request payload is optional
+} mspCommandFlags_e;
+
+typedef struct mspCommandEntry_s {
+    uint16_t cmd;
+    mspCommandFnPtr fn;
+    uint8_t flags;
+} mspCommandEntry_t;
 
 
 void mspInit(void);
 mspResult_e mspFcProcessCommand(mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn);
 void mspFcProcessReply(mspPacket_t *reply);
+int mspFcSerializeDataflashChunk(sbuf_t *dst, uint32_t address, uint16_t size, bool allowCompression);
+void mspRegisterCommands(const mspCommandEntry_t *commands, unsigned count);
+const mspCommandEntry_t *mspFindCommand(const mspCommandEntry_t *commands, unsigned count, uint16_t cmd);
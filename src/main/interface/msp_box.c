@@ -25,6 +25,7 @@
 #include "platform.h"
 
 #include "common/bitarray.h"
+#include "common/maths.h"
 #include "common/streambuf.h"
 #include "common/utils.h"
 
@@ -95,11 +96,12 @@ static const box_t boxes[CHECKBOX_ITEM_COUNT] = {
     { BOXPARALYZE, "PARALYZE", 45 },
     { BOXGPSRESCUE, "GPS RESCUE", 46 },
     { BOXACROTRAINER, "ACRO TRAINER", 47 },
+    { BOXDIRECTSETPOINT, "DIRECT SETPOINT", 48 },
 };
 
-// mask of enabled IDs, calculated on startup based on enabled features. boxId_e is used as bit index
-
-static boxBitmask_t activeBoxIds;
+// enabled boxes in boxId_e order, which is the order they are sent over MSP, calculated on startup based on enabled features
+static const box_t *activeBoxes[CHECKBOX_ITEM_COUNT];
+static uint8_t activeBoxCount;
 
 const box_t *findBoxByBoxId(boxId_e boxId)
 {
@@ -121,12 +123,6 @@ const box_t *findBoxByPermanentId(uint8_t permanentId)
     return NULL;
 }
 
-static bool activeBoxIdGet(boxId_e boxId)
-{
-    if (boxId > sizeof(activeBoxIds) * 8)
-        return false;
-    return bitArrayGet(&activeBoxIds, boxId);
-}
 
 void serializeBoxNameFn(sbuf_t *dst, const box_t *box)
 {
@@ -143,22 +139,16 @@ void serializeBoxPermanentIdFn(sbuf_t *dst, const box_t *box)
 // Each page contains at most 32 boxes
 void serializeBoxReply(sbuf_t *dst, int page, serializeBoxFn *serializeBox)
 {
-    unsigned boxIdx = 0;
-    unsigned pageStart = page * 32;
-    unsigned pageEnd = pageStart + 32;
-    for (boxId_e id = 0; id < CHECKBOX_ITEM_COUNT; id++) {
-        if (activeBoxIdGet(id)) {
-            if (boxIdx >= pageStart && boxIdx < pageEnd) {
-                (*serializeBox)(dst, findBoxByBoxId(id));
-            }
-            boxIdx++;                 // count active boxes
-        }
+    const unsigned pageStart = page * 32;
+    const unsigned pageEnd = MIN(pageStart + 32, activeBoxCount);
+    for (unsigned boxIdx = pageStart; boxIdx < pageEnd; boxIdx++) {
+        (*serializeBox)(dst, activeBoxes[boxIdx]);
     }
 }
 
 void initActiveBoxIds(void)
 {
-    // calculate used boxes based on features and set corresponding activeBoxIds bits
+    // calculate used boxes based on features and list them in activeBoxes
     boxBitmask_t ena;  // temporary variable to collect result
     memset(&ena, 0, sizeof(ena));
 
@@ -297,20 +287,25 @@ void initActiveBoxIds(void)
     }
 #endif // USE_ACRO_TRAINER
 
-#undef BME
-    // check that all enabled IDs are in boxes array (check may be skipped when using findBoxById() functions)
-    for (boxId_e boxId = 0;  boxId < CHECKBOX_ITEM_COUNT; boxId++)
-        if (bitArrayGet(&ena, boxId)
-            && findBoxByBoxId(boxId) == NULL)
-            bitArrayClr(&ena, boxId);                 // this should not happen, but handle it gracefully
+#ifdef USE_DIRECT_SETPOINT
+    BME(BOXDIRECTSETPOINT);
+#endif
 
-    activeBoxIds = ena;                               // set global variable
+#undef BME
+    // only enabled IDs that are in boxes array are listed, a missing one should not happen, but is handled gracefully
+    activeBoxCount = 0;
+    for (boxId_e boxId = 0;  boxId < CHECKBOX_ITEM_COUNT; boxId++) {
+        const box_t *box = findBoxByBoxId(boxId);
+        if (bitArrayGet(&ena, boxId) && box) {
+            activeBoxes[activeBoxCount++] = box;
+        }
+    }
 }
 
 // return state of given boxId box, handling ARM and FLIGHT_MODE
 bool getBoxIdState(boxId_e boxid)
 {
-    const uint8_t boxIdToFlightModeMap[] = BOXID_TO_FLIGHT_MODE_MAP_INITIALIZER;
+    static const uint8_t boxIdToFlightModeMap[] = BOXID_TO_FLIGHT_MODE_MAP_INITIALIZER;
 
     // we assume that all boxId below BOXID_FLIGHTMODE_LAST except BOXARM are mapped to flightmode
     STATIC_ASSERT(ARRAYLEN(boxIdToFlightModeMap) == BOXID_FLIGHTMODE_LAST + 1, FLIGHT_MODE_BOXID_MAP_INITIALIZER_does_not_match_boxId_e);
@@ -330,17 +325,13 @@ int packFlightModeFlags(boxBitmask_t *mspFlightModeFlags)
 {
     // Serialize the flags in the order we delivered them, ignoring BOXNAMES and BOXINDEXES
     memset(mspFlightModeFlags, 0, sizeof(boxBitmask_t));
-    // map boxId_e enabled bits to MSP status indexes
-    // only active boxIds are sent in status over MSP, other bits are not counted
-    unsigned mspBoxIdx = 0;           // index of active boxId (matches sent permanentId and boxNames)
-    for (boxId_e boxId = 0; boxId < CHECKBOX_ITEM_COUNT; boxId++) {
-        if (activeBoxIdGet(boxId)) {
-            if (getBoxIdState(boxId))
-                bitArraySet(mspFlightModeFlags, mspBoxIdx);       // box is enabled
-            mspBoxIdx++;                                          // box is active, count it
+    // only active boxIds are sent in status over MSP, their index matches the sent permanentId and boxNames
+    for (unsigned mspBoxIdx = 0; mspBoxIdx < activeBoxCount; mspBoxIdx++) {
+        if (getBoxIdState(activeBoxes[mspBoxIdx]->boxId)) {
+            bitArraySet(mspFlightModeFlags, mspBoxIdx);           // box is enabled
         }
     }
     // return count of used bits
-    return mspBoxIdx;
+    return activeBoxCount;
 }
 #endif // USE_OSD_SLAVE
@@ -234,6 +234,7 @@
 
 #define MSP_SET_TX_INFO                 186 // in message           Used to send runtime information from TX lua scripts to the firmware
 #define MSP_TX_INFO                     187 // out message          Used by TX lua scripts to read information from the firmware
+#define MSP_OFFLOAD                     188 // out message          State pushed to a companion board running the OSD slave build, see io/offload.h
 
 //
 // Multwii original MSP commands
@@ -279,6 +280,11 @@
 #define MSP_GPS_CONFIG           132    //out message         GPS configuration
 #define MSP_COMPASS_CONFIG       133    //out message         Compass configuration
 #define MSP_ESC_SENSOR_DATA      134    //out message         Extra ESC data from 32-Bit ESCs (Temperature, RPM)
+#define MSP_TASK_STATISTICS      135    //out message         Execution time histogram and late count of a scheduler task
+#define MSP_GYRO_SPECTRUM        136    //out message         Dynamic notch analyser magnitude spectrum and notch frequencies per axis
+#define MSP_RX_LATENCY           137    //out message         Receiver frame to motor update latency statistics since arming
+#define MSP_DATAFLASH_LOG_INDEX  138    //out message         Start, size, arm time and duration of the blackbox logs on the dataflash
+#define MSP_OSD_CHAR_WRITE_STATUS 139   //out message         Font characters still queued for the OSD NVM and characters written since boot
 
 #define MSP_SET_RAW_RC           200    //in message          8 rc chan
 #define MSP_SET_RAW_GPS          201    //in message          fix, numsat, lat, lon, alt, speed
@@ -330,3 +336,18 @@
 #define MSP_RTC                  247    //out message         Gets the RTC clock
 #define MSP_SET_BOARD_INFO       248    //in message          Sets the board information for this board
 #define MSP_SET_SIGNATURE        249    //in message          Sets the signature of the board and serial number
+
+// MSPv2 commands, only reachable through MSPv2 framing
+#define MSP2_STREAM_SUBSCRIBE    0x3000 //in message          Register messages the FC pushes periodically on this port, with a bandwidth budget
+#define MSP2_STREAM_DATA         0x3001 //out message         Batch of pushed messages, each as cmd (U16), size (U16) and payload
+#define MSP2_DATAFLASH_STREAM    0x3002 //in message          Start pushing a range of the dataflash as fast as the port drains, length 0 stops
+#define MSP2_DATAFLASH_STREAM_DATA 0x3003 //out message       Pushed dataflash chunk, MSP_DATAFLASH_READ reply format followed by CRC32 (U32)
+#define MSP2_PG_READ             0x3004 //out message         Raw contents of a parameter group, from an offset
+#define MSP2_PG_WRITE            0x3005 //in message          Write a chunk of a parameter group, applied once the last chunk arrives
+#define MSP2_PG_TRANSACTION      0x3006 //in message          Begin, commit (apply and save once) or abort a batch of parameter group writes
+#define MSP2_PROFILE             0x3007 //out message         Cycle counts and histogram of a profile probe, optionally resetting all probes
+#define MSP2_PERF_REPORT         0x3008 //out message         Gyro loop timing, task load, bus and DMA report, a duration (U16 seconds) starts a measurement
+#define MSP2_DEBUG_CAPTURE       0x3009 //in/out message      Start, stop or read out the capture of several debug modes every gyro loop
+#define MSP2_TRACE               0x300A //in/out message      Start, stop or read out the RAM ring of the task, interrupt and DMA event trace
+#define MSP2_DIRECT_SETPOINT     0x300B //in/out message      Setpoint flown by the next PID loop in the DIRECT SETPOINT mode, replies with the latency statistics
+#define MSP2_FLIGHT_SUMMARY      0x300C //in/out message      Noise, saturation and loop timing summaries of the last flights, newest first, a 1 clears them
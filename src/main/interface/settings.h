@@ -39,6 +39,15 @@ typedef enum {
 #ifdef USE_BLACKBOX
     TABLE_BLACKBOX_DEVICE,
     TABLE_BLACKBOX_MODE,
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+    TABLE_BLACKBOX_GYRO_CAPTURE,
+#endif
+#ifdef USE_BLACKBOX_MIRROR
+    TABLE_BLACKBOX_MIRROR,
+#endif
+#ifdef USE_FLASHFS_ERASE_AHEAD
+    TABLE_BLACKBOX_ERASE_MODE,
+#endif
 #endif
     TABLE_CURRENT_METER,
     TABLE_VOLTAGE_METER,
@@ -84,6 +93,10 @@ typedef enum {
 #endif
 #ifdef USE_GYRO_OVERFLOW_CHECK
     TABLE_GYRO_OVERFLOW_CHECK,
+#endif
+#ifdef USE_GYRO_DATA_ANALYSE
+    TABLE_DYN_NOTCH_ANALYSER,
+    TABLE_DYN_NOTCH_BINS,
 #endif
     TABLE_RATES_TYPE,
 #ifdef USE_OVERCLOCK
@@ -112,6 +125,9 @@ typedef enum {
     TABLE_RC_SMOOTHING_INPUT_TYPE,
     TABLE_RC_SMOOTHING_DERIVATIVE_TYPE,
 #endif // USE_RC_SMOOTHING_FILTER
+#ifdef USE_DSHOT
+    TABLE_MOTOR_OVERSAMPLE,
+#endif
     LOOKUP_TABLE_COUNT
 } lookupTableIndex_e;
 
@@ -170,8 +186,10 @@ typedef union {
     uint8_t bitpos;
 } cliValueConfig_t;
 
+#define SETTING_MAX_NAME_LENGTH 48   // including the terminator
+
 typedef struct clivalue_s {
-    const char *name;
+    const char *name;   // may start with a prefix token, use settingGetName()
     const uint8_t type; // see cliValueFlag_e
     const cliValueConfig_t config;
 
@@ -184,6 +202,8 @@ extern const lookupTableEntry_t lookupTables[];
 extern const uint16_t valueTableEntryCount;
 
 extern const clivalue_t valueTable[];
+const clivalue_t *findValueByName(const char *name, unsigned nameLength);
+void settingGetName(const clivalue_t *value, char *name);
 //extern const uint8_t lookupTablesEntryCount;
 
 extern const char * const lookupTableGyroHardware[];
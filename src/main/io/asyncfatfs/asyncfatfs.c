@@ -48,6 +48,7 @@
 
 #include "fat_standard.h"
 #include "drivers/sdcard.h"
+#include "common/boot_arena.h"
 #include "common/maths.h"
 #include "common/time.h"
 #include "common/utils.h"
@@ -58,10 +59,7 @@
     #define ONLY_EXPOSE_FOR_TESTING static
 #endif
 
-#define AFATFS_NUM_CACHE_SECTORS 8
-
 // FAT filesystems are allowed to differ from these parameters, but we choose not to support those weird filesystems:
-#define AFATFS_SECTOR_SIZE  512
 #define AFATFS_NUM_FATS     2
 
 #define AFATFS_MAX_OPEN_FILES 3
@@ -457,13 +455,18 @@ typedef struct afatfs_t {
     } initState;
 #endif
 
-    uint8_t cache[AFATFS_SECTOR_SIZE * AFATFS_NUM_CACHE_SECTORS];
+    uint8_t *cache;  // AFATFS_CACHE_SIZE from the boot arena, read and written by the SD card DMA
     afatfsCacheBlockDescriptor_t cacheDescriptor[AFATFS_NUM_CACHE_SECTORS];
     uint32_t cacheTimer;
 
     int cacheDirtyEntries; // The number of cache entries in the AFATFS_CACHE_STATE_DIRTY state
     bool cacheFlushInProgress;
 
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+    // The sector that continues the multiple block write of the last flushed sector, or 0 if there is none
+    uint32_t multiWriteNextSector;
+#endif
+
     afatfsFile_t openFiles[AFATFS_MAX_OPEN_FILES];
 
 #ifdef AFATFS_USE_FREEFILE
@@ -713,12 +716,18 @@ static void afatfs_cacheFlushSector(int cacheIndex)
             afatfs.cacheDirtyEntries--;
             cacheDescriptor->state = AFATFS_CACHE_STATE_WRITING;
             afatfs.cacheFlushInProgress = true;
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+            afatfs.multiWriteNextSector = cacheDescriptor->consecutiveEraseBlockCount > 1 ? cacheDescriptor->sectorIndex + 1 : 0;
+#endif
             break;
 
         case SDCARD_OPERATION_SUCCESS:
             // Buffer is already transmitted
             afatfs.cacheDirtyEntries--;
             cacheDescriptor->state = AFATFS_CACHE_STATE_IN_SYNC;
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+            afatfs.multiWriteNextSector = cacheDescriptor->consecutiveEraseBlockCount > 1 ? cacheDescriptor->sectorIndex + 1 : 0;
+#endif
             break;
 
         case SDCARD_OPERATION_BUSY:
@@ -827,6 +836,10 @@ static int afatfs_allocateCacheSector(uint32_t sectorIndex)
 
 /**
  * Attempt to flush dirty cache pages out to the sdcard, returning true if all flushable data has been flushed.
+ *
+ * The sector that continues a multiple block write goes first, so that a contiguous file streams to the card in one
+ * long write. While the application is still filling that sector, the other sectors wait for it, unless the cache
+ * is getting full.
  */
 bool afatfs_flush(void)
 {
@@ -836,6 +849,18 @@ bool afatfs_flush(void)
         int earliestSectorIndex = -1;
 
         for (int i = 0; i < AFATFS_NUM_CACHE_SECTORS; i++) {
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+            if (afatfs.multiWriteNextSector && afatfs.cacheDescriptor[i].sectorIndex == afatfs.multiWriteNextSector) {
+                if (afatfs.cacheDescriptor[i].state == AFATFS_CACHE_STATE_DIRTY && !afatfs.cacheDescriptor[i].locked) {
+                    earliestSectorIndex = i;
+                    break;
+                }
+
+                if (afatfs.cacheDescriptor[i].locked && afatfs.cacheDirtyEntries < AFATFS_NUM_CACHE_SECTORS / 2) {
+                    return false;
+                }
+            }
+#endif
             if (afatfs.cacheDescriptor[i].state == AFATFS_CACHE_STATE_DIRTY && !afatfs.cacheDescriptor[i].locked
                 && (earliestSectorIndex == -1 || afatfs.cacheDescriptor[i].writeTimestamp < earliestSectorTime)
             ) {
@@ -3602,6 +3627,15 @@ afatfsError_e afatfs_getLastError(void)
 
 void afatfs_init(void)
 {
+    if (!afatfs.cache) {
+        afatfs.cache = bootArenaAllocate(AFATFS_CACHE_SIZE, "SDCARD");
+        if (!afatfs.cache) {
+            afatfs.lastError = AFATFS_ERROR_GENERIC;
+            afatfs.filesystemState = AFATFS_FILESYSTEM_STATE_FATAL;
+            return;
+        }
+    }
+
     afatfs.filesystemState = AFATFS_FILESYSTEM_STATE_INITIALIZATION;
     afatfs.initPhase = AFATFS_INITIALIZATION_READ_MBR;
     afatfs.lastClusterAllocated = FAT_SMALLEST_LEGAL_CLUSTER_NUMBER;
@@ -3673,8 +3707,10 @@ bool afatfs_destroy(bool dirty)
 #endif
     }
 
-    // Clear the afatfs so it's as if we never ran
+    // Clear the afatfs so it's as if we never ran, the cache can't go back to the boot arena
+    uint8_t *cache = afatfs.cache;
     memset(&afatfs, 0, sizeof(afatfs));
+    afatfs.cache = cache;
 
     return true;
 }
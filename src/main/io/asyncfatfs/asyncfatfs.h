@@ -25,6 +25,22 @@
 
 #include "fat_standard.h"
 
+/*
+ * Each cache sector costs 512 bytes of RAM. A deeper cache lets a log ride out the longer write latencies of the card
+ * without dropping frames, so targets with the RAM to spare get more, and a target may set its own.
+ */
+#ifndef AFATFS_NUM_CACHE_SECTORS
+#if defined(STM32F4) || defined(STM32F7)
+#define AFATFS_NUM_CACHE_SECTORS 16
+#else
+#define AFATFS_NUM_CACHE_SECTORS 8
+#endif
+#endif
+
+// We choose not to support filesystems with other sector sizes
+#define AFATFS_SECTOR_SIZE  512
+#define AFATFS_CACHE_SIZE   (AFATFS_SECTOR_SIZE * AFATFS_NUM_CACHE_SECTORS)
+
 typedef struct afatfsFile_t *afatfsFilePtr_t;
 
 typedef enum {
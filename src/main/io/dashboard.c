@@ -493,7 +493,8 @@ static void showSensorsPage(void)
     }
 #endif
 
-    tfp_sprintf(lineBuffer, format, "I&H", attitude.values.roll, attitude.values.pitch, DECIDEGREES_TO_DEGREES(attitude.values.yaw));
+    const attitudeEulerAngles_t *attitude = getAttitude();
+    tfp_sprintf(lineBuffer, format, "I&H", attitude->values.roll, attitude->values.pitch, DECIDEGREES_TO_DEGREES(attitude->values.yaw));
     padLineBuffer();
     i2c_OLED_set_line(bus, rowIndex++);
     i2c_OLED_send_string(bus, lineBuffer);
@@ -600,6 +601,10 @@ void dashboardUpdate(timeUs_t currentTimeUs)
 {
     static uint8_t previousArmedState = 0;
 
+    if (dashboardPresent) {
+        i2c_OLED_update(bus);
+    }
+
 #ifdef USE_CMS
     if (displayIsGrabbed(displayPort)) {
         return;
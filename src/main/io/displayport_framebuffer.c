@@ -0,0 +1,132 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_DISPLAYPORT_FRAMEBUFFER
+
+#include "common/maths.h"
+
+#include "io/displayport_framebuffer.h"
+
+#define ALL_ROWS(fb) ((uint16_t)((1 << (fb)->rows) - 1))
+
+void displayPortFramebufferInit(displayPortFramebuffer_t *fb, uint8_t rows, uint8_t cols)
+{
+    fb->rows = MIN(rows, DISPLAYPORT_FRAMEBUFFER_ROWS_MAX);
+    fb->cols = MIN(cols, DISPLAYPORT_FRAMEBUFFER_COLS_MAX);
+    memset(fb->buffer, ' ', sizeof(fb->buffer));
+    displayPortFramebufferInvalidate(fb);
+}
+
+/*
+ * Forgets what the remote screen shows, it is cleared and everything on the local screen is sent again.
+ */
+void displayPortFramebufferInvalidate(displayPortFramebuffer_t *fb)
+{
+    memset(fb->shadow, ' ', sizeof(fb->shadow));
+    fb->clearPending = true;
+    fb->dirtyRows = ALL_ROWS(fb);
+}
+
+void displayPortFramebufferClear(displayPortFramebuffer_t *fb)
+{
+    memset(fb->buffer, ' ', fb->rows * fb->cols);
+    fb->dirtyRows = ALL_ROWS(fb);
+}
+
+int displayPortFramebufferWrite(displayPortFramebuffer_t *fb, uint8_t col, uint8_t row, const char *s)
+{
+    if (row >= fb->rows || col >= fb->cols) {
+        return 0;
+    }
+
+    char *dst = &fb->buffer[row * fb->cols + col];
+    const char *end = &fb->buffer[(row + 1) * fb->cols];
+    while (*s && dst < end) {
+        *dst++ = *s++;
+    }
+    fb->dirtyRows |= 1 << row;
+
+    return 0;
+}
+
+void displayPortFramebufferClearSent(displayPortFramebuffer_t *fb)
+{
+    fb->clearPending = false;
+}
+
+/*
+ * Finds the first run of changed characters, at most maxLen long. Unchanged gaps of up to mergeGap characters
+ * are included in the run, when sending them again is cheaper than the overhead of another frame.
+ * Returns false when the remote screen is up to date.
+ * The run is not marked as sent until displayPortFramebufferRunSent() is called, so it can be held back when the link is busy.
+ */
+bool displayPortFramebufferNextRun(displayPortFramebuffer_t *fb, displayPortFramebufferRun_t *run, uint8_t maxLen, uint8_t mergeGap)
+{
+    while (fb->dirtyRows) {
+        const unsigned row = __builtin_ctz(fb->dirtyRows);
+        const char *buffer = &fb->buffer[row * fb->cols];
+        const char *shadow = &fb->shadow[row * fb->cols];
+
+        unsigned start = 0;
+        while (start < fb->cols && buffer[start] == shadow[start]) {
+            start++;
+        }
+        if (start == fb->cols) {
+            fb->dirtyRows &= ~(1 << row);
+            continue;
+        }
+
+        unsigned lastChanged = start;
+        for (unsigned col = start + 1; col < fb->cols && col - start < maxLen; col++) {
+            if (buffer[col] != shadow[col]) {
+                lastChanged = col;
+            } else if (col - lastChanged > mergeGap) {
+                break;
+            }
+        }
+
+        run->row = row;
+        run->col = start;
+        run->len = lastChanged - start + 1;
+        run->text = &buffer[start];
+
+        return true;
+    }
+
+    return false;
+}
+
+void displayPortFramebufferRunSent(displayPortFramebuffer_t *fb, const displayPortFramebufferRun_t *run)
+{
+    memcpy(&fb->shadow[run->row * fb->cols + run->col], run->text, run->len);
+}
+
+bool displayPortFramebufferIsSynced(const displayPortFramebuffer_t *fb)
+{
+    return !fb->clearPending && !fb->dirtyRows;
+}
+
+#endif // USE_DISPLAYPORT_FRAMEBUFFER
@@ -0,0 +1,50 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#define DISPLAYPORT_FRAMEBUFFER_ROWS_MAX    16
+#define DISPLAYPORT_FRAMEBUFFER_COLS_MAX    32
+
+// Local copy of the screen of a remote displayport, so only the characters that changed are sent over the link
+typedef struct displayPortFramebuffer_s {
+    uint8_t rows;
+    uint8_t cols;
+    bool clearPending;          // the remote screen has to be cleared before the next run is sent
+    uint16_t dirtyRows;         // rows where buffer and shadow may differ
+    char buffer[DISPLAYPORT_FRAMEBUFFER_ROWS_MAX * DISPLAYPORT_FRAMEBUFFER_COLS_MAX];  // what the screen should show
+    char shadow[DISPLAYPORT_FRAMEBUFFER_ROWS_MAX * DISPLAYPORT_FRAMEBUFFER_COLS_MAX];  // what the remote screen shows
+} displayPortFramebuffer_t;
+
+typedef struct displayPortFramebufferRun_s {
+    uint8_t row;
+    uint8_t col;
+    uint8_t len;
+    const char *text;           // not null terminated
+} displayPortFramebufferRun_t;
+
+void displayPortFramebufferInit(displayPortFramebuffer_t *fb, uint8_t rows, uint8_t cols);
+void displayPortFramebufferInvalidate(displayPortFramebuffer_t *fb);
+void displayPortFramebufferClear(displayPortFramebuffer_t *fb);
+int displayPortFramebufferWrite(displayPortFramebuffer_t *fb, uint8_t col, uint8_t row, const char *s);
+void displayPortFramebufferClearSent(displayPortFramebuffer_t *fb);
+bool displayPortFramebufferNextRun(displayPortFramebuffer_t *fb, displayPortFramebufferRun_t *run, uint8_t maxLen, uint8_t mergeGap);
+void displayPortFramebufferRunSent(displayPortFramebuffer_t *fb, const displayPortFramebufferRun_t *run);
+bool displayPortFramebufferIsSynced(const displayPortFramebuffer_t *fb);
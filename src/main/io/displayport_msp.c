@@ -37,6 +37,7 @@
 #include "interface/msp.h"
 #include "interface/msp_protocol.h"
 
+#include "io/displayport_framebuffer.h"
 #include "io/displayport_msp.h"
 
 #include "msp/msp_serial.h"
@@ -46,6 +47,16 @@ PG_REGISTER(displayPortProfile_t, displayPortProfileMsp, PG_DISPLAY_PORT_MSP_CON
 
 static displayPort_t mspDisplayPort;
 
+#define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
+
+#ifdef USE_DISPLAYPORT_FRAMEBUFFER
+#define MSP_FRAME_OVERHEAD          6   // $M>, size, cmd and checksum
+#define MSP_OSD_STRING_OVERHEAD     4   // subcmd, row, col and attribute
+
+static displayPortFramebuffer_t mspFramebuffer;
+static bool mspDrawPending;
+#endif
+
 #ifdef USE_CLI
 extern uint8_t cliMode;
 #endif
@@ -82,33 +93,25 @@ static int release(displayPort_t *displayPort)
 {
     uint8_t subcmd[] = { 1 };
 
+#ifdef USE_DISPLAYPORT_FRAMEBUFFER
+    // the remote shows its own screen until the display is grabbed again
+    displayPortFramebufferInvalidate(&mspFramebuffer);
+#endif
+
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
-static int clearScreen(displayPort_t *displayPort)
+static int sendClearScreen(displayPort_t *displayPort)
 {
     uint8_t subcmd[] = { 2 };
 
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
-static int drawScreen(displayPort_t *displayPort)
-{
-    uint8_t subcmd[] = { 4 };
-    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
-}
-
-static int screenSize(const displayPort_t *displayPort)
-{
-    return displayPort->rows * displayPort->cols;
-}
-
-static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, const char *string)
+static int sendString(displayPort_t *displayPort, uint8_t col, uint8_t row, const char *string, int len)
 {
-#define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
     uint8_t buf[MSP_OSD_MAX_STRING_LENGTH + 4];
 
-    int len = strlen(string);
     if (len >= MSP_OSD_MAX_STRING_LENGTH) {
         len = MSP_OSD_MAX_STRING_LENGTH;
     }
@@ -122,6 +125,83 @@ static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, con
     return output(displayPort, MSP_DISPLAYPORT, buf, len + 4);
 }
 
+static int sendDrawScreen(displayPort_t *displayPort)
+{
+    uint8_t subcmd[] = { 4 };
+    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+}
+
+#ifdef USE_DISPLAYPORT_FRAMEBUFFER
+static int clearScreen(displayPort_t *displayPort)
+{
+    UNUSED(displayPort);
+
+    displayPortFramebufferClear(&mspFramebuffer);
+
+    return 0;
+}
+
+/*
+ * Sends the runs of characters that changed since the last call, for as long as they fit in the serial tx buffer,
+ * and tells the remote to draw once its screen is up to date.
+ */
+static int drawScreen(displayPort_t *displayPort)
+{
+    int bytesSent = 0;
+
+    if (mspFramebuffer.clearPending) {
+        if (mspSerialTxBytesFree() < MSP_FRAME_OVERHEAD + 1) {
+            return 0;
+        }
+        bytesSent += sendClearScreen(displayPort);
+        displayPortFramebufferClearSent(&mspFramebuffer);
+        mspDrawPending = true;
+    }
+
+    displayPortFramebufferRun_t run;
+    while (displayPortFramebufferNextRun(&mspFramebuffer, &run, MSP_OSD_MAX_STRING_LENGTH, MSP_FRAME_OVERHEAD + MSP_OSD_STRING_OVERHEAD)) {
+        if (mspSerialTxBytesFree() < (uint32_t)(MSP_FRAME_OVERHEAD + MSP_OSD_STRING_OVERHEAD + run.len)) {
+            return bytesSent;
+        }
+        bytesSent += sendString(displayPort, run.col, run.row, run.text, run.len);
+        displayPortFramebufferRunSent(&mspFramebuffer, &run);
+        mspDrawPending = true;
+    }
+
+    if (mspDrawPending) {
+        bytesSent += sendDrawScreen(displayPort);
+        mspDrawPending = false;
+    }
+
+    return bytesSent;
+}
+#else
+static int clearScreen(displayPort_t *displayPort)
+{
+    return sendClearScreen(displayPort);
+}
+
+static int drawScreen(displayPort_t *displayPort)
+{
+    return sendDrawScreen(displayPort);
+}
+#endif
+
+static int screenSize(const displayPort_t *displayPort)
+{
+    return displayPort->rows * displayPort->cols;
+}
+
+static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, const char *string)
+{
+#ifdef USE_DISPLAYPORT_FRAMEBUFFER
+    UNUSED(displayPort);
+    return displayPortFramebufferWrite(&mspFramebuffer, col, row, string);
+#else
+    return sendString(displayPort, col, row, string, strlen(string));
+#endif
+}
+
 static int writeChar(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t c)
 {
     char buf[2];
@@ -140,20 +220,32 @@ static bool isTransferInProgress(const displayPort_t *displayPort)
 static bool isSynced(const displayPort_t *displayPort)
 {
     UNUSED(displayPort);
+#ifdef USE_DISPLAYPORT_FRAMEBUFFER
+    return displayPortFramebufferIsSynced(&mspFramebuffer);
+#else
     return true;
+#endif
 }
 
 static void resync(displayPort_t *displayPort)
 {
     displayPort->rows = 13 + displayPortProfileMsp()->rowAdjust; // XXX Will reflect NTSC/PAL in the future
     displayPort->cols = 30 + displayPortProfileMsp()->colAdjust;
+#ifdef USE_DISPLAYPORT_FRAMEBUFFER
+    displayPortFramebufferInit(&mspFramebuffer, displayPort->rows, displayPort->cols);
+#endif
     drawScreen(displayPort);
 }
 
 static uint32_t txBytesFree(const displayPort_t *displayPort)
 {
     UNUSED(displayPort);
+#ifdef USE_DISPLAYPORT_FRAMEBUFFER
+    // writes only land in the framebuffer, drawScreen() paces the transmission
+    return UINT32_MAX;
+#else
     return mspSerialTxBytesFree();
+#endif
 }
 
 static const displayPortVTable_t mspDisplayPortVTable = {
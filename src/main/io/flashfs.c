@@ -30,16 +30,32 @@
  *
  * In future, we can add support for multiple different flash chips by adding a flash device driver vtable
  * and make calls through that, at the moment flashfs just calls m25p16_* routines explicitly.
+ *
+ * With USE_FLASHFS_LOG_INDEX the last sector of a NOR flash is not part of the volume, but holds an index of the
+ * logs on it. Its entries are appended in order and only go away when the whole flash is erased.
+ *
+ * With USE_FLASHFS_ERASE_AHEAD the flash can be erased incrementally: the old logs are discarded right away, while
+ * their sectors are erased in the background ahead of the new logs. Until that is done the volume ends at the first
+ * sector that still holds old data. The sectors left to erase are found again after a restart, as the erased space
+ * in front of them.
  */
 
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
 
+#include "platform.h"
+
+#include "common/maths.h"
+#include "common/utils.h"
+
 #include "drivers/flash.h"
 
 #include "io/flashfs.h"
 
+// Longest time a page program can take
+#define FLASHFS_SYNC_WRITE_TIMEOUT_MILLIS 6
+
 static uint8_t flashWriteBuffer[FLASHFS_WRITE_BUFFER_SIZE];
 
 /* The position of our head and tail in the circular flash write buffer.
@@ -48,15 +64,38 @@ static uint8_t flashWriteBuffer[FLASHFS_WRITE_BUFFER_SIZE];
  * oldest byte that has yet to be written to flash.
  *
  * When the circular buffer is empty, head == tail
+ *
+ * The buffer is kept aligned with the flash, the tail is at tailAddress modulo the buffer size, so that a page
+ * doesn't wrap around the end of the buffer when the buffer size is a multiple of the page size.
  */
-static uint8_t bufferHead = 0, bufferTail = 0;
+static uint16_t bufferHead = 0, bufferTail = 0;
 
 // The position of the buffer's tail in the overall flash address space:
 static uint32_t tailAddress = 0;
 
+#ifdef USE_SPI_DMA
+// The bytes before the tail that the flash driver may still be reading by DMA, they aren't free until the flash is ready
+static uint16_t bufferInFlight = 0;
+#endif
+
+// An erase waiting for the flash to become idle, a range of sectors is erased one after the other in the background
+static bool eraseCompletelyPending;
+static uint32_t eraseNextSector, eraseEndSector;
+
+#ifdef USE_FLASHFS_ERASE_AHEAD
+// The sectors of old data yet to be erased by flashfsEraseAheadUpdate()
+static uint32_t eraseAheadAddress, eraseAheadEnd;
+#endif
+
+#ifdef USE_FLASHFS_LOG_INDEX
+// False if the index sector holds anything but index entries, e.g. the logs of a firmware without an index
+static bool logIndexAvailable;
+static int logIndexCount;
+#endif
+
 static void flashfsClearBuffer(void)
 {
-    bufferTail = bufferHead = 0;
+    bufferTail = bufferHead = tailAddress % FLASHFS_WRITE_BUFFER_SIZE;
 }
 
 static bool flashfsBufferIsEmpty(void)
@@ -67,20 +106,93 @@ static bool flashfsBufferIsEmpty(void)
 static void flashfsSetTailAddress(uint32_t address)
 {
     tailAddress = address;
+
+    if (flashfsBufferIsEmpty()) {
+        flashfsClearBuffer();
+    }
 }
 
+#ifdef USE_FLASHFS_LOG_INDEX
+static bool flashfsLogIndexIsSupported(void)
+{
+    const flashGeometry_t *geometry = flashGetGeometry();
+
+    // A NAND page can only be programmed a few times, far less often than it takes to fill it with entries
+    return geometry->flashType == FLASH_TYPE_NOR && geometry->sectors > 1;
+}
+
+static uint32_t flashfsLogIndexAddress(void)
+{
+    return flashGetGeometry()->totalSize - flashGetGeometry()->sectorSize;
+}
+
+static int flashfsLogIndexCapacity(void)
+{
+    return flashGetGeometry()->sectorSize / sizeof(flashfsLogIndexEntry_t);
+}
+#endif
+
+/**
+ * Issue the next part of a pending erase if the flash is idle, never waits for it.
+ *
+ * Returns true if there is no erase left to issue.
+ */
+static bool flashfsEraseContinue(void)
+{
+    if (!eraseCompletelyPending && eraseNextSector >= eraseEndSector) {
+        return true;
+    }
+
+    if (!flashIsReady()) {
+        return false;
+    }
+
+    if (eraseCompletelyPending) {
+        flashEraseCompletely();
+        eraseCompletelyPending = false;
+    } else {
+        flashEraseSector(eraseNextSector * flashGetGeometry()->sectorSize);
+        eraseNextSector++;
+    }
+
+    return !eraseCompletelyPending && eraseNextSector >= eraseEndSector;
+}
+
+/**
+ * The erase runs in the background, poll flashfsIsReady() for its completion.
+ */
 void flashfsEraseCompletely(void)
 {
-    flashEraseCompletely();
+    if (flashGetGeometry()->flashType == FLASH_TYPE_NAND) {
+        // A NAND has no chip erase, its blocks are erased one after the other
+        eraseCompletelyPending = false;
+        eraseNextSector = 0;
+        eraseEndSector = flashGetGeometry()->sectors;
+    } else {
+        eraseCompletelyPending = true;
+        eraseNextSector = eraseEndSector = 0;
+    }
+    flashfsEraseContinue();
 
-    flashfsClearBuffer();
+#ifdef USE_FLASHFS_ERASE_AHEAD
+    eraseAheadAddress = eraseAheadEnd = 0;
+#endif
 
     flashfsSetTailAddress(0);
+
+    flashfsClearBuffer();
+
+#ifdef USE_FLASHFS_LOG_INDEX
+    logIndexAvailable = flashfsLogIndexIsSupported();
+    logIndexCount = 0;
+#endif
 }
 
 /**
  * Start and end must lie on sector boundaries, or they will be rounded out to sector boundaries such that
  * all the bytes in the range [start...end) are erased.
+ *
+ * The sectors are erased in the background, poll flashfsIsReady() for the completion.
  */
 void flashfsEraseRange(uint32_t start, uint32_t end)
 {
@@ -100,17 +212,17 @@ void flashfsEraseRange(uint32_t start, uint32_t end)
         endSector++;
     }
 
-    for (int i = startSector; i < endSector; i++) {
-        flashEraseSector(i * geometry->sectorSize);
-    }
+    eraseNextSector = startSector;
+    eraseEndSector = endSector;
+    flashfsEraseContinue();
 }
 
 /**
- * Return true if the flash is not currently occupied with an operation.
+ * Return true if the flash is not currently occupied with an operation. Drives a pending erase.
  */
 bool flashfsIsReady(void)
 {
-    return flashIsReady();
+    return flashfsEraseContinue() && flashIsReady();
 }
 
 bool flashfsIsSupported(void)
@@ -120,9 +232,26 @@ bool flashfsIsSupported(void)
 
 uint32_t flashfsGetSize(void)
 {
+#ifdef USE_FLASHFS_LOG_INDEX
+    if (flashfsLogIndexIsSupported()) {
+        // The log index takes the last sector
+        return flashfsLogIndexAddress();
+    }
+#endif
     return flashGetGeometry()->totalSize;
 }
 
+// The end of the space that can be written
+static uint32_t flashfsGetFreeSpaceEnd(void)
+{
+#ifdef USE_FLASHFS_ERASE_AHEAD
+    if (eraseAheadAddress < eraseAheadEnd) {
+        return eraseAheadAddress;
+    }
+#endif
+    return flashfsGetSize();
+}
+
 static uint32_t flashfsTransmitBufferUsed(void)
 {
     if (bufferHead >= bufferTail)
@@ -144,7 +273,11 @@ uint32_t flashfsGetWriteBufferSize(void)
  */
 uint32_t flashfsGetWriteBufferFreeSpace(void)
 {
+#ifdef USE_SPI_DMA
+    return flashfsGetWriteBufferSize() - flashfsTransmitBufferUsed() - bufferInFlight;
+#else
     return flashfsGetWriteBufferSize() - flashfsTransmitBufferUsed();
+#endif
 }
 
 const flashGeometry_t* flashfsGetGeometry(void)
@@ -181,7 +314,10 @@ static uint32_t flashfsWriteBuffers(uint8_t const **buffers, uint32_t *bufferSiz
         bytesTotal += bufferSizes[i];
     }
 
-    if (!sync && !flashIsReady()) {
+    if (sync) {
+        // The data must come after the pending erase
+        while (!flashfsEraseContinue());
+    } else if (!flashfsEraseContinue() || !flashIsReady()) {
         return 0;
     }
 
@@ -253,6 +389,13 @@ static uint32_t flashfsWriteBuffers(uint8_t const **buffers, uint32_t *bufferSiz
             break;
     }
 
+#ifdef USE_SPI_DMA
+    if (sync) {
+        // The driver may still be reading the data by DMA, the caller is free to reuse it once we return
+        flashWaitForReady(FLASHFS_SYNC_WRITE_TIMEOUT_MILLIS);
+    }
+#endif
+
     return bytesTotal - bytesTotalRemaining;
 }
 
@@ -311,11 +454,20 @@ static void flashfsAdvanceTailInBuffer(uint32_t delta)
 /**
  * If the flash is ready to accept writes, flush the buffer to it.
  *
+ * Unless forced, this waits until the buffer holds the rest of the page at the tail, so that each page is programmed
+ * whole in one operation. If the page is larger than FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN, that much is enough.
+ *
  * Returns true if all data in the buffer has been flushed to the device, or false if
  * there is still data to be written (call flush again later).
  */
-bool flashfsFlushAsync(void)
+bool flashfsFlushAsync(bool force)
 {
+#ifdef USE_SPI_DMA
+    if (bufferInFlight && flashIsReady()) {
+        bufferInFlight = 0;
+    }
+#endif
+
     if (flashfsBufferIsEmpty()) {
         return true; // Nothing to flush
     }
@@ -325,9 +477,23 @@ bool flashfsFlushAsync(void)
     uint32_t bytesWritten;
 
     flashfsGetDirtyDataBuffers(buffers, bufferSizes);
+
+    if (!force) {
+        const uint16_t pageSize = flashfsGetGeometry()->pageSize;
+        const uint32_t pageRemaining = pageSize - tailAddress % pageSize;
+
+        if (bufferSizes[0] + bufferSizes[1] < MIN(pageRemaining, (uint32_t)FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN)) {
+            return false;
+        }
+    }
+
     bytesWritten = flashfsWriteBuffers(buffers, bufferSizes, 2, false);
     flashfsAdvanceTailInBuffer(bytesWritten);
 
+#ifdef USE_SPI_DMA
+    bufferInFlight = bytesWritten;
+#endif
+
     return flashfsBufferIsEmpty();
 }
 
@@ -351,6 +517,10 @@ void flashfsFlushSync(void)
 
     // We've written our entire buffer now:
     flashfsClearBuffer();
+
+#ifdef USE_SPI_DMA
+    bufferInFlight = 0;
+#endif
 }
 
 void flashfsSeekAbs(uint32_t offset)
@@ -379,57 +549,36 @@ void flashfsWriteByte(uint8_t byte)
     }
 
     if (flashfsTransmitBufferUsed() >= FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN) {
-        flashfsFlushAsync();
+        flashfsFlushAsync(false);
     }
 }
 
 /**
  * Write the given buffer to the flash either synchronously or asynchronously depending on the 'sync' parameter.
  *
+ * The data is always buffered, so that the flash is programmed in whole pages, unless it is too large for the
+ * buffer and a synchronous write was requested.
+ *
  * If writing asynchronously, data will be silently discarded if the buffer overflows.
  * If writing synchronously, the routine will block waiting for the flash to become ready so will never drop data.
  */
 void flashfsWrite(const uint8_t *data, unsigned int len, bool sync)
 {
-    uint8_t const * buffers[3];
-    uint32_t bufferSizes[3];
-
-    // There could be two dirty buffers to write out already:
-    flashfsGetDirtyDataBuffers(buffers, bufferSizes);
-
-    // Plus the buffer the user supplied:
-    buffers[2] = data;
-    bufferSizes[2] = len;
-
-    /*
-     * Would writing this data to our buffer cause our buffer to reach the flush threshold? If so try to write through
-     * to the flash now
-     */
-    if (bufferSizes[0] + bufferSizes[1] + bufferSizes[2] >= FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN) {
-        uint32_t bytesWritten;
-
-        // Attempt to write all three buffers through to the flash asynchronously
-        bytesWritten = flashfsWriteBuffers(buffers, bufferSizes, 3, false);
-
-        if (bufferSizes[0] == 0 && bufferSizes[1] == 0) {
-            // We wrote all the data that was previously buffered
-            flashfsClearBuffer();
-
-            if (bufferSizes[2] == 0) {
-                // And we wrote all the data the user supplied! Job done!
-                return;
-            }
+    if (len > flashfsGetWriteBufferFreeSpace()) {
+        // Try to make room by writing out the data that is already buffered
+        if (sync) {
+            flashfsFlushSync();
         } else {
-            // We only wrote a portion of the old data, so advance the tail to remove the bytes we did write from the buffer
-            flashfsAdvanceTailInBuffer(bytesWritten);
+            flashfsFlushAsync(false);
         }
 
-        // Is the remainder of the data to be written too big to fit in the buffers?
-        if (bufferSizes[0] + bufferSizes[1] + bufferSizes[2] > FLASHFS_WRITE_BUFFER_USABLE) {
+        if (len > flashfsGetWriteBufferFreeSpace()) {
             if (sync) {
-                // Write it through synchronously
-                flashfsWriteBuffers(buffers, bufferSizes, 3, true);
-                flashfsClearBuffer();
+                // The buffer is empty now, so the data is too big for it, write it through synchronously
+                uint8_t const * buffers[1] = { data };
+                uint32_t bufferSizes[1] = { len };
+
+                flashfsWriteBuffers(buffers, bufferSizes, 1, true);
             } else {
                 /*
                  * Silently drop the data the user asked to write (i.e. no-op) since we can't buffer it and they
@@ -439,10 +588,6 @@ void flashfsWrite(const uint8_t *data, unsigned int len, bool sync)
 
             return;
         }
-
-        // Fall through and add the remainder of the incoming data to our buffer
-        data = buffers[2];
-        len = bufferSizes[2];
     }
 
     // Buffer up the data the user supplied instead of writing it right away
@@ -465,6 +610,10 @@ void flashfsWrite(const uint8_t *data, unsigned int len, bool sync)
 
         bufferHead = len;
     }
+
+    if (flashfsTransmitBufferUsed() >= FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN) {
+        flashfsFlushAsync(false);
+    }
 }
 
 /**
@@ -482,6 +631,11 @@ int flashfsReadAbs(uint32_t address, uint8_t *buffer, unsigned int len)
         len = flashfsGetSize() - address;
     }
 
+    // Reads fail until the pending erase is underway
+    if (!flashfsEraseContinue()) {
+        return 0;
+    }
+
     // Since the read could overlap data in our dirty buffers, force a sync to clear those first
     flashfsFlushSync();
 
@@ -523,7 +677,7 @@ int flashfsIdentifyStartOfFreeSpace(void)
     } testBuffer;
 
     int left = 0; // Smallest block index in the search region
-    int right = flashfsGetSize() / FREE_BLOCK_SIZE; // One past the largest block index in the search region
+    int right = flashfsGetFreeSpaceEnd() / FREE_BLOCK_SIZE; // One past the largest block index in the search region
     int mid;
     int result = right;
     int i;
@@ -566,7 +720,7 @@ int flashfsIdentifyStartOfFreeSpace(void)
  */
 bool flashfsIsEOF(void)
 {
-    return tailAddress >= flashfsGetSize();
+    return tailAddress >= flashfsGetFreeSpaceEnd();
 }
 
 void flashfsClose(void)
@@ -586,13 +740,243 @@ void flashfsClose(void)
     }
 }
 
+#ifdef USE_FLASHFS_LOG_INDEX
+/**
+ * Return the number of logs in the index.
+ */
+int flashfsLogIndexCount(void)
+{
+    return logIndexCount;
+}
+
+/**
+ * Read entry index of the log index, the oldest log being entry 0. Returns true if the entry was read.
+ */
+bool flashfsLogIndexRead(int index, flashfsLogIndexEntry_t *entry)
+{
+    if (index < 0 || index >= logIndexCount) {
+        return false;
+    }
+
+    const uint32_t address = flashfsLogIndexAddress() + index * sizeof(*entry);
+    return flashReadBytes(address, (uint8_t *)entry, sizeof(*entry)) == sizeof(*entry);
+}
+
+/**
+ * Add the entry of a log to the end of the index. Returns false if the index is full or unavailable.
+ *
+ * The program operation is started right away, so call this while the flash is idle to avoid waiting for it.
+ */
+bool flashfsLogIndexAppend(const flashfsLogIndexEntry_t *entry)
+{
+    if (!logIndexAvailable || logIndexCount >= flashfsLogIndexCapacity()) {
+        return false;
+    }
+
+    // Static, as the flash driver may still be reading it by DMA after we return
+    static flashfsLogIndexEntry_t indexEntry;
+    indexEntry = *entry;
+    indexEntry.magic = FLASHFS_LOG_INDEX_ENTRY_MAGIC;
+
+    // Entries evenly divide the pages, so they never cross a page boundary
+    flashPageProgram(flashfsLogIndexAddress() + logIndexCount * sizeof(indexEntry), (const uint8_t *)&indexEntry, sizeof(indexEntry));
+    logIndexCount++;
+
+    return true;
+}
+
+static bool flashfsLogIndexEntryIsErased(const flashfsLogIndexEntry_t *entry)
+{
+    const uint8_t *bytes = (const uint8_t *)entry;
+    for (unsigned i = 0; i < sizeof(*entry); i++) {
+        if (bytes[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Count the entries of the index, and check that the index sector holds nothing else.
+ */
+static void flashfsLogIndexInit(void)
+{
+    logIndexAvailable = false;
+    logIndexCount = 0;
+
+    if (!flashfsLogIndexIsSupported()) {
+        return;
+    }
+
+    const uint32_t indexAddress = flashfsLogIndexAddress();
+    const int capacity = flashfsLogIndexCapacity();
+    flashfsLogIndexEntry_t entry;
+
+    // Entries are appended in order, so binary search for the first unused one
+    int left = 0;
+    int right = capacity;
+    while (left < right) {
+        const int mid = (left + right) / 2;
+
+        if (flashReadBytes(indexAddress + mid * sizeof(entry), (uint8_t *)&entry, sizeof(entry)) < (int)sizeof(entry)) {
+            // Unexpected timeout from flash, leave the index alone
+            return;
+        }
+
+        if (entry.magic == FLASHFS_LOG_INDEX_ENTRY_MAGIC) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+
+    if (left < capacity) {
+        // The entry after the last one must be unused, otherwise the sector holds something else
+        if (flashReadBytes(indexAddress + left * sizeof(entry), (uint8_t *)&entry, sizeof(entry)) < (int)sizeof(entry)
+            || !flashfsLogIndexEntryIsErased(&entry)) {
+            return;
+        }
+    }
+
+    logIndexAvailable = true;
+    logIndexCount = left;
+}
+#endif // USE_FLASHFS_LOG_INDEX
+
+#ifdef USE_FLASHFS_ERASE_AHEAD
+// Whether the flash looks erased at the given address, erased flash doesn't appear in the logs as with the free space
+static bool flashfsLooksErasedAt(uint32_t address)
+{
+    uint32_t testBuffer[4];
+
+    if (flashReadBytes(address, (uint8_t *)testBuffer, sizeof(testBuffer)) < (int)sizeof(testBuffer)) {
+        return false;
+    }
+
+    for (unsigned i = 0; i < ARRAYLEN(testBuffer); i++) {
+        if (testBuffer[i] != 0xFFFFFFFF) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Find the old data left by an incremental erase that was interrupted by a restart, behind the new logs and the
+ * sectors that were erased ahead of them.
+ */
+static void flashfsEraseAheadIdentify(void)
+{
+    const uint32_t sectorSize = flashGetGeometry()->sectorSize;
+    const uint32_t size = flashfsGetSize();
+
+    eraseAheadAddress = eraseAheadEnd = 0;
+
+    if (sectorSize == 0) {
+        return;
+    }
+
+    // Skip the sectors full of logs, up to the one where the logs end
+    uint32_t address = 0;
+    while (address < size && !flashfsLooksErasedAt(address) && !flashfsLooksErasedAt(address + sectorSize - 16)) {
+        address += sectorSize;
+    }
+
+    // Then the erased sectors after it
+    address += sectorSize;
+    while (address < size && flashfsLooksErasedAt(address)) {
+        address += sectorSize;
+    }
+
+    if (address >= size) {
+        return; // The free space runs to the end, nothing is left to erase
+    }
+
+    eraseAheadAddress = address;
+    while (address < size && !flashfsLooksErasedAt(address)) {
+        address += sectorSize;
+    }
+    eraseAheadEnd = address;
+}
+
+/**
+ * Discard all the logs, their sectors are erased later by flashfsEraseAheadUpdate(). The log index is erased
+ * right away.
+ */
+void flashfsEraseIncrementally(void)
+{
+    const uint32_t sectorSize = flashGetGeometry()->sectorSize;
+
+    if (sectorSize == 0) {
+        return;
+    }
+
+    // The old data runs to the end of the logs, or to the end of the old data of an incremental erase underway
+    const uint32_t usedEnd = MAX(flashfsGetOffset(), eraseAheadEnd);
+
+    eraseAheadAddress = 0;
+    eraseAheadEnd = MIN((usedEnd + sectorSize - 1) / sectorSize * sectorSize, flashfsGetSize());
+
+    flashfsSetTailAddress(0);
+
+    flashfsClearBuffer();
+
+#ifdef USE_FLASHFS_LOG_INDEX
+    if (flashfsLogIndexIsSupported()) {
+        flashfsEraseRange(flashfsLogIndexAddress(), flashGetGeometry()->totalSize);
+    }
+    logIndexAvailable = flashfsLogIndexIsSupported();
+    logIndexCount = 0;
+#endif
+}
+
+/**
+ * Erase the next sector of old data if the flash is idle. Only call this while nothing is being logged, as the flash
+ * stays busy with the erase for a while.
+ *
+ * Returns true when there is nothing left to erase.
+ */
+bool flashfsEraseAheadUpdate(void)
+{
+    if (eraseAheadAddress >= eraseAheadEnd) {
+        return true;
+    }
+
+    if (!flashfsBufferIsEmpty() || !flashfsEraseContinue() || !flashIsReady()) {
+        return false;
+    }
+
+    flashEraseSector(eraseAheadAddress);
+    eraseAheadAddress += flashGetGeometry()->sectorSize;
+
+    return eraseAheadAddress >= eraseAheadEnd;
+}
+
+/**
+ * Get the number of bytes of old data that are yet to be erased.
+ */
+uint32_t flashfsGetEraseAheadRemaining(void)
+{
+    return eraseAheadAddress < eraseAheadEnd ? eraseAheadEnd - eraseAheadAddress : 0;
+}
+#endif // USE_FLASHFS_ERASE_AHEAD
+
 /**
  * Call after initializing the flash chip in order to set up the filesystem.
  */
 void flashfsInit(void)
 {
+#ifdef USE_FLASHFS_LOG_INDEX
+    flashfsLogIndexInit();
+#endif
+
     // If we have a flash chip present at all
     if (flashfsGetSize() > 0) {
+#ifdef USE_FLASHFS_ERASE_AHEAD
+        flashfsEraseAheadIdentify();
+#endif
+
         // Start the file pointer off at the beginning of free space so caller can start writing immediately
         flashfsSeekAbs(flashfsIdentifyStartOfFreeSpace());
     }
@@ -20,14 +20,42 @@
 
 #pragma once
 
+// Targets can size the buffer by their RAM, it is best a multiple of the 256 byte NOR flash pages,
+// then every page is programmed in one go from a contiguous part of the buffer
+#ifndef FLASHFS_WRITE_BUFFER_SIZE
+#if defined(STM32F4) || defined(STM32F7)
+#define FLASHFS_WRITE_BUFFER_SIZE 1024
+#else
 #define FLASHFS_WRITE_BUFFER_SIZE 128
+#endif
+#endif
 #define FLASHFS_WRITE_BUFFER_USABLE (FLASHFS_WRITE_BUFFER_SIZE - 1)
 
-// Automatically trigger a flush when this much data is in the buffer
-#define FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN 64
+// Automatically trigger a flush when this much data is in the buffer, unless it ends on a page boundary sooner
+#ifndef FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN
+#if FLASHFS_WRITE_BUFFER_SIZE >= 512
+#define FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN 256
+#else
+#define FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN (FLASHFS_WRITE_BUFFER_SIZE / 2)
+#endif
+#endif
+
+#define FLASHFS_LOG_INDEX_ENTRY_MAGIC 0xB10C
+
+// An entry of the log index, written once the log is complete
+typedef struct flashfsLogIndexEntry_s {
+    uint32_t start;     // Flash address of the first byte of the log
+    uint32_t size;      // In bytes
+    uint32_t armTime;   // Seconds since Jan 1 1970 at the start of the log, 0 if the time wasn't known
+    uint16_t duration;  // In seconds
+    uint16_t magic;     // FLASHFS_LOG_INDEX_ENTRY_MAGIC, erased in unused entries
+} flashfsLogIndexEntry_t;
 
 void flashfsEraseCompletely(void);
 void flashfsEraseRange(uint32_t start, uint32_t end);
+void flashfsEraseIncrementally(void);
+bool flashfsEraseAheadUpdate(void);
+uint32_t flashfsGetEraseAheadRemaining(void);
 
 uint32_t flashfsGetSize(void);
 uint32_t flashfsGetOffset(void);
@@ -45,7 +73,7 @@ void flashfsWrite(const uint8_t *data, unsigned int len, bool sync);
 
 int flashfsReadAbs(uint32_t offset, uint8_t *data, unsigned int len);
 
-bool flashfsFlushAsync(void);
+bool flashfsFlushAsync(bool force);
 void flashfsFlushSync(void);
 
 void flashfsClose(void);
@@ -54,3 +82,7 @@ bool flashfsIsSupported(void);
 
 bool flashfsIsReady(void);
 bool flashfsIsEOF(void);
+
+int flashfsLogIndexCount(void);
+bool flashfsLogIndexRead(int index, flashfsLogIndexEntry_t *entry);
+bool flashfsLogIndexAppend(const flashfsLogIndexEntry_t *entry);
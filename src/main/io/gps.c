@@ -66,6 +66,7 @@
 #define LOG_UBLOX_SVINFO 'I'
 #define LOG_UBLOX_POSLLH 'P'
 #define LOG_UBLOX_VELNED 'V'
+#define LOG_UBLOX_PVT    'T'
 
 #define GPS_SV_MAXSATS   16
 
@@ -75,6 +76,7 @@ static char *gpsPacketLogChar = gpsPacketLog;
 // GPS
 // **********************
 int32_t GPS_home[2];
+gpsLocalPosition_t GPS_homeOffset;
 uint16_t GPS_distanceToHome;        // distance to home point in meters
 int16_t GPS_directionToHome;        // direction to home or hol point in degrees
 float dTnav;             // Delta Time in milliseconds for navigation computations, updated with every good GPS read
@@ -219,6 +221,19 @@ static const uint8_t ubloxGalileoInit[] = {
         0x06, 0x08, 0x0E, 0x00, 0x01, 0x00, 0x01, 0x01,     // GLONASS
         0x55, 0x47
 };
+
+// Replace the legacy message set with NAV-PVT (u-blox 7 and later), which carries fix, position,
+// velocity and time in one frame, and raise the navigation rate to 10Hz.
+static const uint8_t ubloxPvtInit[] = {
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x07, 0x01, 0x13, 0x51,           // set PVT MSG rate
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x02, 0x00, 0x0D, 0x46,           // disable POSLLH
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x03, 0x00, 0x0E, 0x48,           // disable STATUS
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x06, 0x00, 0x11, 0x4E,           // disable SOL
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x12, 0x00, 0x1D, 0x66,           // disable VELNED
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x30, 0x0A, 0x45, 0xAC,           // set SVINFO MSG rate (every 10 cycles - keep it at 1Hz)
+
+    0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0x64, 0x00, 0x01, 0x00, 0x01, 0x00, 0x7A, 0x12,             // set rate to 10Hz (measurement period: 100ms, navigation rate: 1 cycle)
+};
 #endif // USE_GPS_UBLOX
 
 typedef enum {
@@ -233,14 +248,15 @@ typedef enum {
 gpsData_t gpsData;
 
 
-PG_REGISTER_WITH_RESET_TEMPLATE(gpsConfig_t, gpsConfig, PG_GPS_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(gpsConfig_t, gpsConfig, PG_GPS_CONFIG, 1);
 
 PG_RESET_TEMPLATE(gpsConfig_t, gpsConfig,
     .provider = GPS_NMEA,
     .sbasMode = SBAS_AUTO,
     .autoConfig = GPS_AUTOCONFIG_ON,
     .autoBaud = GPS_AUTOBAUD_OFF,
-    .gps_ublox_use_galileo = false
+    .gps_ublox_use_galileo = false,
+    .gps_ublox_use_pvt = false
 );
 
 static void shiftPacketLog(void)
@@ -253,11 +269,13 @@ static void shiftPacketLog(void)
 }
 
 static void gpsNewData(uint16_t c);
+static void gpsNewDataBuf(const uint8_t *data, uint32_t length);
 #ifdef USE_GPS_NMEA
 static bool gpsNewFrameNMEA(char c);
 #endif
 #ifdef USE_GPS_UBLOX
 static bool gpsNewFrameUBLOX(uint8_t data);
+static uint32_t gpsNewPayloadUBLOX(const uint8_t *data, uint32_t length);
 #endif
 
 static void gpsSetState(gpsState_e state)
@@ -451,6 +469,16 @@ void gpsInitUblox(void)
                 }
             }
 
+            if (gpsData.messageState == GPS_MESSAGE_STATE_PVT) {
+                if ((gpsConfig()->gps_ublox_use_pvt) && (gpsData.state_position < sizeof(ubloxPvtInit))) {
+                    serialWrite(gpsPort, ubloxPvtInit[gpsData.state_position]);
+                    gpsData.state_position++;
+                } else {
+                    gpsData.state_position = 0;
+                    gpsData.messageState++;
+                }
+            }
+
             if (gpsData.messageState >= GPS_MESSAGE_STATE_ENTRY_COUNT) {
                 // ublox should be initialised, try receiving
                 gpsSetState(GPS_RECEIVING_DATA);
@@ -490,6 +518,13 @@ void gpsUpdate(timeUs_t currentTimeUs)
 {
     // read out available GPS bytes
     if (gpsPort) {
+        // parse in place when the driver exposes its receive ring, byte by byte otherwise
+        const uint8_t *data;
+        uint32_t available;
+        while ((available = serialPeekContiguous(gpsPort, &data)) > 0) {
+            gpsNewDataBuf(data, available);
+            serialSkip(gpsPort, available);
+        }
         while (serialRxBytesWaiting(gpsPort))
             gpsNewData(serialRead(gpsPort));
     }
@@ -536,6 +571,25 @@ void gpsUpdate(timeUs_t currentTimeUs)
 #endif
 }
 
+static void gpsNewDataBuf(const uint8_t *data, uint32_t length)
+{
+    while (length) {
+#ifdef USE_GPS_UBLOX
+        if (gpsConfig()->provider == GPS_UBLOX) {
+            // UBX payloads are copied in one run, only the framing goes through the state machine
+            const uint32_t consumed = gpsNewPayloadUBLOX(data, length);
+            data += consumed;
+            length -= consumed;
+            if (!length) {
+                break;
+            }
+        }
+#endif
+        gpsNewData(*data++);
+        length--;
+    }
+}
+
 static void gpsNewData(uint16_t c)
 {
     if (!gpsNewFrame(c)) {
@@ -956,6 +1010,41 @@ typedef struct {
     ubx_nav_svinfo_channel channel[16];         // 16 satellites * 12 byte
 } ubx_nav_svinfo;
 
+typedef struct {
+    uint32_t time;              // GPS msToW
+    uint16_t year;              // UTC
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    uint8_t valid;              // Bitmask, see ubx_nav_pvt_valid_bits
+    uint32_t time_accuracy;
+    int32_t time_nsec;          // Fraction of second, -1e9..1e9
+    uint8_t fix_type;
+    uint8_t fix_status;         // Bitmask, see ubx_nav_status_bits
+    uint8_t fix_status2;
+    uint8_t satellites;
+    int32_t longitude;
+    int32_t latitude;
+    int32_t altitude_ellipsoid; // mm
+    int32_t altitude_msl;       // mm
+    uint32_t horizontal_accuracy;
+    uint32_t vertical_accuracy;
+    int32_t ned_north;          // mm/s
+    int32_t ned_east;
+    int32_t ned_down;
+    int32_t speed_2d;           // mm/s
+    int32_t heading_2d;         // deg * 1e5
+    uint32_t speed_accuracy;
+    uint32_t heading_accuracy;
+    uint16_t position_DOP;
+    uint8_t res[6];
+    int32_t heading_vehicle;
+    int16_t magnetic_declination;
+    uint16_t magnetic_declination_accuracy;
+} ubx_nav_pvt;
+
 enum {
     PREAMBLE1 = 0xb5,
     PREAMBLE2 = 0x62,
@@ -967,6 +1056,7 @@ enum {
     MSG_POSLLH = 0x2,
     MSG_STATUS = 0x3,
     MSG_SOL = 0x6,
+    MSG_PVT = 0x7,
     MSG_VELNED = 0x12,
     MSG_SVINFO = 0x30,
     MSG_CFG_PRT = 0x00,
@@ -990,6 +1080,12 @@ enum {
     NAV_STATUS_TIME_SECOND_VALID = 8
 } ubx_nav_status_bits;
 
+enum {
+    NAV_PVT_VALID_DATE = 1,
+    NAV_PVT_VALID_TIME = 2,
+    NAV_PVT_FULLY_RESOLVED = 4
+} ubx_nav_pvt_valid_bits;
+
 // Packet checksum accumulators
 static uint8_t _ck_a;
 static uint8_t _ck_b;
@@ -1034,6 +1130,7 @@ static union {
     ubx_nav_solution solution;
     ubx_nav_velned velned;
     ubx_nav_svinfo svinfo;
+    ubx_nav_pvt pvt;
     uint8_t bytes[UBLOX_PAYLOAD_SIZE];
 } _buffer;
 
@@ -1096,6 +1193,40 @@ static bool UBLOX_parse_gps(void)
         gpsSol.groundCourse = (uint16_t) (_buffer.velned.heading_2d / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
         _new_speed = true;
         break;
+    case MSG_PVT:
+        *gpsPacketLogChar = LOG_UBLOX_PVT;
+        next_fix = (_buffer.pvt.fix_status & NAV_STATUS_FIX_VALID) && (_buffer.pvt.fix_type == FIX_3D);
+        gpsSol.llh.lon = _buffer.pvt.longitude;
+        gpsSol.llh.lat = _buffer.pvt.latitude;
+        gpsSol.llh.alt = _buffer.pvt.altitude_msl / 10;  //alt in cm
+        if (next_fix) {
+            ENABLE_STATE(GPS_FIX);
+        } else {
+            DISABLE_STATE(GPS_FIX);
+        }
+        gpsSol.numSat = _buffer.pvt.satellites;
+        gpsSol.hdop = _buffer.pvt.position_DOP;
+        gpsSol.groundSpeed = _buffer.pvt.speed_2d / 10;    // mm/s rescaled to cm/s
+        gpsSol.groundCourse = (uint16_t) (_buffer.pvt.heading_2d / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
+#ifdef USE_RTC_TIME
+        //set clock, when gps time is available
+        if (!rtcHasTime() && (_buffer.pvt.valid & NAV_PVT_VALID_DATE) && (_buffer.pvt.valid & NAV_PVT_VALID_TIME) && (_buffer.pvt.valid & NAV_PVT_FULLY_RESOLVED)) {
+            dateTime_t dt = {
+                .year = _buffer.pvt.year,
+                .month = _buffer.pvt.month,
+                .day = _buffer.pvt.day,
+                .hours = _buffer.pvt.hour,
+                .minutes = _buffer.pvt.min,
+                .seconds = _buffer.pvt.sec,
+                .millis = (_buffer.pvt.time_nsec > 0) ? _buffer.pvt.time_nsec / 1000000 : 0
+            };
+            rtcSetDateTime(&dt);
+        }
+#endif
+        // a single PVT frame carries both, no need to wait for the next one
+        _new_position = true;
+        _new_speed = true;
+        break;
     case MSG_SVINFO:
         *gpsPacketLogChar = LOG_UBLOX_SVINFO;
         GPS_numCh = _buffer.svinfo.numCh;
@@ -1122,6 +1253,31 @@ static bool UBLOX_parse_gps(void)
     return false;
 }
 
+// Consumes payload bytes from data while a frame payload is being received, returning the count used.
+static uint32_t gpsNewPayloadUBLOX(const uint8_t *data, uint32_t length)
+{
+    if (_step != 6) {
+        return 0;
+    }
+
+    if (length > (uint32_t)(_payload_length - _payload_counter)) {
+        length = _payload_length - _payload_counter;
+    }
+
+    if (_payload_counter < UBLOX_PAYLOAD_SIZE) {
+        memcpy(&_buffer.bytes[_payload_counter], data, MIN(length, (uint32_t)(UBLOX_PAYLOAD_SIZE - _payload_counter)));
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        _ck_b += (_ck_a += data[i]);       // checksum byte
+    }
+
+    _payload_counter += length;
+    if (_payload_counter >= _payload_length) {
+        _step++;
+    }
+    return length;
+}
+
 static bool gpsNewFrameUBLOX(uint8_t data)
 {
     bool parsed = false;
@@ -1246,19 +1402,27 @@ void GPS_calc_longitude_scaling(int32_t lat)
 }
 
 
+#define DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR_IN_HUNDREDS_OF_KILOMETERS 1.113195f
+
+// Local tangent plane scales in cm per 1e-7 degree, Q16. They only change when home is set.
+#define GPS_LOCAL_SCALE_SHIFT 16
+static int32_t GPS_northScale;
+static int32_t GPS_eastScale;
+
 void GPS_reset_home_position(void)
 {
     if (STATE(GPS_FIX) && gpsSol.numSat >= 5) {
         GPS_home[LAT] = gpsSol.llh.lat;
         GPS_home[LON] = gpsSol.llh.lon;
         GPS_calc_longitude_scaling(gpsSol.llh.lat); // need an initial value for distance and bearing calc
+        GPS_northScale = lrintf(DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR_IN_HUNDREDS_OF_KILOMETERS * (1 << GPS_LOCAL_SCALE_SHIFT));
+        GPS_eastScale = lrintf(DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR_IN_HUNDREDS_OF_KILOMETERS * GPS_scaleLonDown * (1 << GPS_LOCAL_SCALE_SHIFT));
         // Set ground altitude
         ENABLE_STATE(GPS_FIX_HOME);
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
-#define DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR_IN_HUNDREDS_OF_KILOMETERS 1.113195f
 #define TAN_89_99_DEGREES 5729.57795f
 // Get distance between two points in cm
 // Get bearing from pos1 to pos2, returns an 1deg = 100 precision
@@ -1276,12 +1440,20 @@ void GPS_distance_cm_bearing(int32_t *currentLat1, int32_t *currentLon1, int32_t
 void GPS_calculateDistanceAndDirectionToHome(void)
 {
     if (STATE(GPS_FIX_HOME)) {      // If we don't have home set, do not display anything
-        uint32_t dist;
-        int32_t dir;
-        GPS_distance_cm_bearing(&gpsSol.llh.lat, &gpsSol.llh.lon, &GPS_home[LAT], &GPS_home[LON], &dist, &dir);
-        GPS_distanceToHome = dist / 100;
-        GPS_directionToHome = dir / 100;
+        GPS_homeOffset.north = ((int64_t)(gpsSol.llh.lat - GPS_home[LAT]) * GPS_northScale) >> GPS_LOCAL_SCALE_SHIFT;
+        GPS_homeOffset.east = ((int64_t)(gpsSol.llh.lon - GPS_home[LON]) * GPS_eastScale) >> GPS_LOCAL_SCALE_SHIFT;
+
+        const float north = GPS_homeOffset.north;
+        const float east = GPS_homeOffset.east;
+        GPS_distanceToHome = sqrtf(sq(north) + sq(east)) / 100;
+        // home lies opposite the offset
+        int32_t dir = lrintf(atan2_approx(-east, -north) / RAD);
+        if (dir < 0)
+            dir += 360;
+        GPS_directionToHome = dir % 360;
     } else {
+        GPS_homeOffset.north = 0;
+        GPS_homeOffset.east = 0;
         GPS_distanceToHome = 0;
         GPS_directionToHome = 0;
     }
@@ -1205,6 +1205,11 @@ void ledStripEnable(void)
     ws2811LedStripInit(ledStripConfig()->ioTag);
 }
 
+int ledStripGetCount(void)
+{
+    return ledCounts.count;
+}
+
 static void ledStripDisable(void)
 {
     setStripColor(&HSV(BLACK));
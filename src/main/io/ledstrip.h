@@ -190,6 +190,7 @@ void reevaluateLedConfig(void);
 void ledStripInit(void);
 void ledStripEnable(void);
 void ledStripUpdate(timeUs_t currentTimeUs);
+int ledStripGetCount(void);
 
 bool setModeColor(ledModeIndex_e modeIndex, int modeColorIndex, int colorIndex);
 
@@ -0,0 +1,284 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Offload link from the flight controller to a companion board running the OSD slave build.
+ *
+ * The screen already reaches the companion through the MSP displayport, this adds the state it needs to render
+ * its own elements, encode telemetry or drive the LED strip. The records are pushed on the MSP ports from a low
+ * priority task, frames that do not fit in the transmit buffers are dropped instead of waited for, so a slow
+ * link costs the gyro loop nothing.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_OFFLOAD
+
+#include "common/color.h"
+#include "common/maths.h"
+#include "common/streambuf.h"
+#include "common/utils.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#ifndef USE_OSD_SLAVE
+#include "config/feature.h"
+
+#include "drivers/light_ws2811strip.h"
+
+#include "fc/runtime_config.h"
+
+#include "flight/imu.h"
+#include "flight/position.h"
+
+#include "interface/cli.h"
+#include "interface/msp_protocol.h"
+
+#include "io/gps.h"
+#include "io/ledstrip.h"
+
+#include "msp/msp_serial.h"
+
+#include "rx/rx.h"
+
+#include "sensors/battery.h"
+#endif
+
+#include "offload.h"
+
+#define OFFLOAD_FRAME_OVERHEAD      6   // $M>, size, cmd and checksum
+#define OFFLOAD_FRAME_SIZE_MAX      (3 + OFFLOAD_LEDS_PER_FRAME * 4)    // the LED record is the largest
+
+void offloadWriteState(sbuf_t *dst, const offloadState_t *state)
+{
+    sbufWriteU8(dst, OFFLOAD_RECORD_STATE);
+    sbufWriteU8(dst, state->armingFlags);
+    sbufWriteU16(dst, state->flightModeFlags);
+    sbufWriteU8(dst, state->stateFlags);
+    for (int axis = 0; axis < 3; axis++) {
+        sbufWriteU16(dst, state->attitude[axis]);
+    }
+    sbufWriteU16(dst, state->batteryVoltage);
+    sbufWriteU32(dst, state->amperage);
+    sbufWriteU32(dst, state->mAhDrawn);
+    sbufWriteU16(dst, state->rssi);
+    sbufWriteU32(dst, state->altitudeCm);
+    sbufWriteU16(dst, state->varioCms);
+}
+
+void offloadWriteGps(sbuf_t *dst, const offloadGps_t *gps)
+{
+    sbufWriteU8(dst, OFFLOAD_RECORD_GPS);
+    sbufWriteU8(dst, gps->numSat);
+    sbufWriteU32(dst, gps->lat);
+    sbufWriteU32(dst, gps->lon);
+    sbufWriteU32(dst, gps->altitudeCm);
+    sbufWriteU16(dst, gps->groundSpeed);
+    sbufWriteU16(dst, gps->groundCourse);
+}
+
+// Writes the LEDs from firstIndex on that fit in a frame, returns how many
+int offloadWriteLeds(sbuf_t *dst, int ledCount, int firstIndex, const hsvColor_t *leds)
+{
+    const int count = MIN(ledCount - firstIndex, OFFLOAD_LEDS_PER_FRAME);
+
+    sbufWriteU8(dst, OFFLOAD_RECORD_LEDS);
+    sbufWriteU8(dst, ledCount);
+    sbufWriteU8(dst, firstIndex);
+    for (int i = 0; i < count; i++) {
+        sbufWriteU16(dst, leds[i].h);
+        sbufWriteU8(dst, leds[i].s);
+        sbufWriteU8(dst, leds[i].v);
+    }
+    return count;
+}
+
+#ifdef USE_OSD_SLAVE
+
+static offloadData_t offloadData;
+
+// Called with the payload of each MSP_OFFLOAD frame, returns false for a frame that is not understood
+bool offloadProcessRecord(sbuf_t *src, timeUs_t currentTimeUs)
+{
+    if (sbufBytesRemaining(src) < 1) {
+        return false;
+    }
+
+    switch (sbufReadU8(src)) {
+    case OFFLOAD_RECORD_STATE: {
+        if (sbufBytesRemaining(src) < 28) {
+            return false;
+        }
+        offloadState_t *state = &offloadData.state;
+        state->armingFlags = sbufReadU8(src);
+        state->flightModeFlags = sbufReadU16(src);
+        state->stateFlags = sbufReadU8(src);
+        for (int axis = 0; axis < 3; axis++) {
+            state->attitude[axis] = sbufReadU16(src);
+        }
+        state->batteryVoltage = sbufReadU16(src);
+        state->amperage = sbufReadU32(src);
+        state->mAhDrawn = sbufReadU32(src);
+        state->rssi = sbufReadU16(src);
+        state->altitudeCm = sbufReadU32(src);
+        state->varioCms = sbufReadU16(src);
+        offloadData.stateReceivedAtUs = currentTimeUs;
+        return true;
+    }
+    case OFFLOAD_RECORD_GPS: {
+        if (sbufBytesRemaining(src) < 17) {
+            return false;
+        }
+        offloadGps_t *gps = &offloadData.gps;
+        gps->numSat = sbufReadU8(src);
+        gps->lat = sbufReadU32(src);
+        gps->lon = sbufReadU32(src);
+        gps->altitudeCm = sbufReadU32(src);
+        gps->groundSpeed = sbufReadU16(src);
+        gps->groundCourse = sbufReadU16(src);
+        offloadData.gpsReceivedAtUs = currentTimeUs;
+        return true;
+    }
+    case OFFLOAD_RECORD_LEDS: {
+        if (sbufBytesRemaining(src) < 2) {
+            return false;
+        }
+        const int ledCount = MIN(sbufReadU8(src), OFFLOAD_LED_COUNT);
+        const int firstIndex = sbufReadU8(src);
+        offloadData.ledCount = ledCount;
+        for (int i = firstIndex; i < ledCount && sbufBytesRemaining(src) >= 4; i++) {
+            offloadData.leds[i].h = sbufReadU16(src);
+            offloadData.leds[i].s = sbufReadU8(src);
+            offloadData.leds[i].v = sbufReadU8(src);
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+const offloadData_t *offloadGetData(void)
+{
+    return &offloadData;
+}
+
+#else
+
+PG_REGISTER_WITH_RESET_TEMPLATE(offloadConfig_t, offloadConfig, PG_OFFLOAD_CONFIG, 0);
+
+PG_RESET_TEMPLATE(offloadConfig_t, offloadConfig,
+    .offload_rate_hz = 0,
+    .offload_led_strip = false,
+);
+
+static uint8_t offloadNextLed;
+
+bool offloadIsEnabled(void)
+{
+    return offloadConfig()->offload_rate_hz > 0;
+}
+
+static void offloadPush(sbuf_t *dst, uint8_t *buf)
+{
+    const int len = sbufPtr(dst) - buf;
+    if (mspSerialTxBytesFree() >= (uint32_t)(OFFLOAD_FRAME_OVERHEAD + len)) {
+        mspSerialPush(MSP_OFFLOAD, buf, len, MSP_DIRECTION_REPLY);
+    }
+}
+
+static void offloadCollectState(offloadState_t *state)
+{
+    state->armingFlags = armingFlags;
+    state->flightModeFlags = flightModeFlags;
+    state->stateFlags = stateFlags;
+    const attitudeEulerAngles_t *attitude = getAttitude();
+    for (int axis = 0; axis < 3; axis++) {
+        state->attitude[axis] = attitude->raw[axis];
+    }
+    state->batteryVoltage = getBatteryVoltage();
+    state->amperage = getAmperage();
+    state->mAhDrawn = getMAhDrawn();
+    state->rssi = getRssi();
+    state->altitudeCm = getEstimatedAltitude();
+    state->varioCms = getEstimatedVario();
+}
+
+// Called from the offload task at offload_rate_hz
+void offloadUpdate(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+#ifdef USE_CLI
+    // the frames would end up in the CLI output
+    if (cliMode) {
+        return;
+    }
+#endif
+
+    uint8_t buf[OFFLOAD_FRAME_SIZE_MAX];
+    sbuf_t sbuf;
+
+    offloadState_t state;
+    offloadCollectState(&state);
+    offloadWriteState(sbufInit(&sbuf, buf, buf + sizeof(buf)), &state);
+    offloadPush(&sbuf, buf);
+
+#ifdef USE_GPS
+    if (feature(FEATURE_GPS)) {
+        const offloadGps_t gps = {
+            .numSat = gpsSol.numSat,
+            .lat = gpsSol.llh.lat,
+            .lon = gpsSol.llh.lon,
+            .altitudeCm = gpsSol.llh.alt,
+            .groundSpeed = gpsSol.groundSpeed,
+            .groundCourse = gpsSol.groundCourse,
+        };
+        offloadWriteGps(sbufInit(&sbuf, buf, buf + sizeof(buf)), &gps);
+        offloadPush(&sbuf, buf);
+    }
+#endif
+
+#ifdef USE_LED_STRIP
+    // one frame of LEDs per update, the strip is sent in turns
+    const int ledCount = ledStripGetCount();
+    if (offloadConfig()->offload_led_strip && feature(FEATURE_LED_STRIP) && ledCount) {
+        if (offloadNextLed >= ledCount) {
+            offloadNextLed = 0;
+        }
+        hsvColor_t leds[OFFLOAD_LEDS_PER_FRAME];
+        for (int i = 0; i < OFFLOAD_LEDS_PER_FRAME && offloadNextLed + i < ledCount; i++) {
+            getLedHsv(offloadNextLed + i, &leds[i]);
+        }
+        const int firstIndex = offloadNextLed;
+        offloadNextLed += offloadWriteLeds(sbufInit(&sbuf, buf, buf + sizeof(buf)), ledCount, firstIndex, leds);
+        offloadPush(&sbuf, buf);
+    }
+#endif
+}
+
+#endif // USE_OSD_SLAVE
+
+#endif // USE_OFFLOAD
@@ -0,0 +1,107 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/color.h"
+#include "common/streambuf.h"
+#include "common/time.h"
+
+#include "pg/pg.h"
+
+/*
+ * Offload link to a companion board running the OSD slave build.
+ *
+ * The flight controller pushes MSP_OFFLOAD frames on its MSP ports, next to the MSP_DISPLAYPORT frames that
+ * already carry the OSD screen. The first byte of a frame is the record:
+ *
+ * OFFLOAD_RECORD_STATE     armingFlags U8, flightModeFlags U16, stateFlags U8, roll, pitch and yaw S16 (0.1 deg),
+ *                          battery voltage U16 (0.1V), amperage S32 (0.01A), drawn S32 (mAh), rssi U16 (0-1023),
+ *                          altitude S32 (cm), vario S16 (cm/s)
+ * OFFLOAD_RECORD_GPS       satellites U8, latitude and longitude S32 (1e-7 deg), altitude S32 (cm),
+ *                          ground speed U16 (0.1m/s), ground course U16 (0.1 deg)
+ * OFFLOAD_RECORD_LEDS      LEDs on the strip U8, index of the first LED in the frame U8, then per LED
+ *                          hue U16, saturation U8, value U8, at most OFFLOAD_LEDS_PER_FRAME LEDs per frame
+ */
+
+#define OFFLOAD_LED_COUNT           32
+#define OFFLOAD_LEDS_PER_FRAME      8
+#define OFFLOAD_RATE_HZ_MAX         100
+
+typedef enum {
+    OFFLOAD_RECORD_STATE = 0,
+    OFFLOAD_RECORD_GPS,
+    OFFLOAD_RECORD_LEDS,
+    OFFLOAD_RECORD_COUNT
+} offloadRecord_e;
+
+typedef struct offloadState_s {
+    uint8_t armingFlags;
+    uint16_t flightModeFlags;
+    uint8_t stateFlags;
+    int16_t attitude[3];
+    uint16_t batteryVoltage;
+    int32_t amperage;
+    int32_t mAhDrawn;
+    uint16_t rssi;
+    int32_t altitudeCm;
+    int16_t varioCms;
+} offloadState_t;
+
+typedef struct offloadGps_s {
+    uint8_t numSat;
+    int32_t lat;
+    int32_t lon;
+    int32_t altitudeCm;
+    uint16_t groundSpeed;
+    uint16_t groundCourse;
+} offloadGps_t;
+
+// What the companion last received
+typedef struct offloadData_s {
+    timeUs_t stateReceivedAtUs;     // 0 until the first state record
+    offloadState_t state;
+    timeUs_t gpsReceivedAtUs;
+    offloadGps_t gps;
+    uint8_t ledCount;
+    hsvColor_t leds[OFFLOAD_LED_COUNT];
+} offloadData_t;
+
+typedef struct offloadConfig_s {
+    uint8_t offload_rate_hz;        // state records pushed per second, 0 disables the link
+    uint8_t offload_led_strip;      // push the LED strip colours too
+} offloadConfig_t;
+
+PG_DECLARE(offloadConfig_t, offloadConfig);
+
+void offloadWriteState(sbuf_t *dst, const offloadState_t *state);
+void offloadWriteGps(sbuf_t *dst, const offloadGps_t *gps);
+int offloadWriteLeds(sbuf_t *dst, int ledCount, int firstIndex, const hsvColor_t *leds);
+
+// companion
+bool offloadProcessRecord(sbuf_t *src, timeUs_t currentTimeUs);
+const offloadData_t *offloadGetData(void);
+
+// flight controller
+bool offloadIsEnabled(void);
+void offloadUpdate(timeUs_t currentTimeUs);
@@ -65,6 +65,7 @@
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
 #include "fc/fc_rc.h"
+#include "fc/flight_summary.h"
 #include "fc/runtime_config.h"
 
 #include "flight/position.h"
@@ -87,12 +88,16 @@
 #include "pg/rx.h"
 
 #include "rx/rx.h"
+#include "rx/rx_latency.h"
+
+#include "scheduler/scheduler.h"
 
 #include "sensors/acceleration.h"
 #include "sensors/adcinternal.h"
 #include "sensors/barometer.h"
 #include "sensors/battery.h"
 #include "sensors/esc_sensor.h"
+#include "sensors/esc_stats.h"
 #include "sensors/sensors.h"
 
 #ifdef USE_HARDWARE_REVISION_DETECTION
@@ -151,6 +156,13 @@ static displayPort_t *osdDisplayPort;
 static escSensorData_t *escDataCombined;
 #endif
 
+// Elements of the frame being drawn, drawing is spread over several task invocations if it runs out of time
+#define OSD_DRAW_ELEMENT_TIME_US 30
+
+static uint8_t osdDrawList[OSD_ITEM_COUNT];
+static uint8_t osdDrawListCount;
+static uint8_t osdDrawListIndex;
+
 #define AH_SYMBOL_COUNT 9
 #define AH_SIDEBAR_WIDTH_POS 7
 #define AH_SIDEBAR_HEIGHT_POS 3
@@ -203,7 +215,7 @@ static const uint8_t osdElementDisplayOrder[] = {
     OSD_ANTI_GRAVITY
 };
 
-PG_REGISTER_WITH_RESET_FN(osdConfig_t, osdConfig, PG_OSD_CONFIG, 3);
+PG_REGISTER_WITH_RESET_FN(osdConfig_t, osdConfig, PG_OSD_CONFIG, 4);
 
 /**
  * Gets the correct altitude symbol for the current unit system
@@ -251,6 +263,24 @@ static int32_t osdGetMetersToSelectedUnit(int32_t meters)
     }
 }
 
+#if defined(USE_ESC_SENSOR) && defined(USE_ESC_STATS)
+// Motor with the highest peak temperature in the last ESC statistics window, -1 if none reported one
+static int osdGetHottestEscMotor(void)
+{
+    int hottest = -1;
+    int hottestTemperature = 0;
+    for (int i = 0; i < getMotorCount(); i++) {
+        const escStats_t *escStats = getEscStats(i);
+        if (escStatsIsValid(escStats, ESC_STATS_TEMPERATURE)
+            && (hottest < 0 || escStats->values[ESC_STATS_TEMPERATURE].max > hottestTemperature)) {
+            hottest = i;
+            hottestTemperature = escStats->values[ESC_STATS_TEMPERATURE].max;
+        }
+    }
+    return hottest;
+}
+#endif
+
 #if defined(USE_ADC_INTERNAL) || defined(USE_ESC_SENSOR)
 STATIC_UNIT_TESTED int osdConvertTemperatureToSelectedUnit(int tempInDeciDegrees)
 {
@@ -273,18 +303,34 @@ static char osdGetTemperatureSymbolForSelectedUnit(void)
 }
 #endif
 
+// Appends a glyph to the text of an element and returns the new end of the text.
+// Used with the fixed width helpers of common/typeconversion, which are much cheaper than tfp_sprintf().
+static char *osdAppendChar(char *buff, char c)
+{
+    *buff++ = c;
+    *buff = '\0';
+    return buff;
+}
+
 static void osdFormatAltitudeString(char * buff, int altitude)
 {
     const int alt = osdGetMetersToSelectedUnit(altitude) / 10;
 
-    tfp_sprintf(buff, "%5d %c", alt, osdGetMetersToSelectedUnitSymbol());
+    char *p = i2aPadded(alt, 5, buff);
+    osdAppendChar(osdAppendChar(p, ' '), osdGetMetersToSelectedUnitSymbol());
     buff[5] = buff[4];
     buff[4] = '.';
 }
 
 static void osdFormatPID(char * buff, const char * label, const pidf_t * pid)
 {
-    tfp_sprintf(buff, "%s %3d %3d %3d", label, pid->P, pid->I, pid->D);
+    char *p = buff;
+    while (*label) {
+        *p++ = *label++;
+    }
+    p = osdAppendChar(i2aPadded(pid->P, 3, osdAppendChar(p, ' ')), ' ');
+    p = osdAppendChar(i2aPadded(pid->I, 3, p), ' ');
+    i2aPadded(pid->D, 3, p);
 }
 
 static uint8_t osdGetHeadingIntoDiscreteDirections(int heading, unsigned directions)
@@ -350,12 +396,13 @@ STATIC_UNIT_TESTED void osdFormatTime(char * buff, osd_timer_precision_e precisi
     switch (precision) {
     case OSD_TIMER_PREC_SECOND:
     default:
-        tfp_sprintf(buff, "%02d:%02d", minutes, seconds);
+        ui2aZeroPadded(seconds, 2, osdAppendChar(ui2aZeroPadded(minutes, 2, buff), ':'));
         break;
     case OSD_TIMER_PREC_HUNDREDTHS:
         {
             const int hundredths = (time / 10000) % 100;
-            tfp_sprintf(buff, "%02d:%02d.%02d", minutes, seconds, hundredths);
+            char *p = ui2aZeroPadded(seconds, 2, osdAppendChar(ui2aZeroPadded(minutes, 2, buff), ':'));
+            ui2aZeroPadded(hundredths, 2, osdAppendChar(p, '.'));
             break;
         }
     }
@@ -449,6 +496,178 @@ bool osdWarnGetState(uint8_t warningIndex)
     return osdConfig()->enabledWarnings & (1 << warningIndex);
 }
 
+#ifdef USE_OSD_ELEMENT_CACHE
+// Longest time a cached element is redrawn without being formatted again, so changes its key does not
+// cover (units, craft name, battery cell count) still reach the screen.
+#define OSD_ELEMENT_CACHE_MAX_AGE_US    (1000 * 1000)
+
+typedef struct osdElementRefresh_s {
+    uint8_t item;
+    uint16_t intervalMs;    // minimum time between two formats while the key keeps changing
+} osdElementRefresh_t;
+
+// Elements whose text only depends on the value key returned by osdGetElementKey().
+// Elements that are not listed here are formatted on every frame.
+static const osdElementRefresh_t osdElementRefresh[] = {
+    { OSD_RSSI_VALUE,                  0 },
+    { OSD_MAIN_BATT_VOLTAGE,         500 },
+    { OSD_AVG_CELL_VOLTAGE,          500 },
+    { OSD_CURRENT_DRAW,              200 },
+    { OSD_MAH_DRAWN,                1000 },
+    { OSD_MAIN_BATT_USAGE,          1000 },
+    { OSD_REMAINING_TIME_ESTIMATE,  1000 },
+    { OSD_ALTITUDE,                  200 },
+    { OSD_ITEM_TIMER_1,                0 },
+    { OSD_ITEM_TIMER_2,                0 },
+    { OSD_CRAFT_NAME,                  0 },
+    { OSD_THROTTLE_POS,                0 },
+#ifdef USE_GPS
+    { OSD_GPS_SATS,                 1000 },
+    { OSD_GPS_SPEED,                 200 },
+    { OSD_GPS_LAT,                   200 },
+    { OSD_GPS_LON,                   200 },
+    { OSD_HOME_DIST,                 200 },
+#endif
+#ifdef USE_VTX_COMMON
+    { OSD_VTX_CHANNEL,              1000 },
+#endif
+#ifdef USE_ESC_SENSOR
+    { OSD_ESC_TMP,                  1000 },
+    { OSD_ESC_RPM,                   200 },
+#ifdef USE_ESC_STATS
+    { OSD_ESC_TMP_MAX,              1000 },
+#endif
+#endif
+#ifdef USE_ADC_INTERNAL
+    { OSD_CORE_TEMPERATURE,         1000 },
+#endif
+};
+
+typedef struct osdElementCache_s {
+    bool valid;
+    uint16_t pos;
+    int32_t key;
+    timeUs_t formattedAtUs;
+    char buff[OSD_ELEMENT_BUFFER_LENGTH];
+} osdElementCache_t;
+
+static osdElementCache_t osdElementCache[ARRAYLEN(osdElementRefresh)];
+static uint8_t osdElementCacheSlot[OSD_ITEM_COUNT];    // index + 1 into osdElementCache, 0 when not cached
+static timeUs_t osdElementTimeUs;
+
+static void osdElementCacheInit(void)
+{
+    memset(osdElementCache, 0, sizeof(osdElementCache));
+    memset(osdElementCacheSlot, 0, sizeof(osdElementCacheSlot));
+    for (unsigned i = 0; i < ARRAYLEN(osdElementRefresh); i++) {
+        osdElementCacheSlot[osdElementRefresh[i].item] = i + 1;
+    }
+}
+
+static int32_t osdGetElementKey(uint8_t item)
+{
+    switch (item) {
+    case OSD_RSSI_VALUE:
+        return getRssi();
+
+    case OSD_MAIN_BATT_VOLTAGE:
+        return getBatteryVoltage();
+
+    case OSD_AVG_CELL_VOLTAGE:
+        return osdGetBatteryAverageCellVoltage();
+
+    case OSD_CURRENT_DRAW:
+        return getAmperage();
+
+    case OSD_MAH_DRAWN:
+    case OSD_MAIN_BATT_USAGE:
+        return getMAhDrawn();
+
+    case OSD_REMAINING_TIME_ESTIMATE:
+        return flyTime / 1000000;
+
+    case OSD_ALTITUDE:
+        return getEstimatedAltitude();
+
+    case OSD_ITEM_TIMER_1:
+    case OSD_ITEM_TIMER_2:
+        {
+            const uint16_t timer = osdConfig()->timers[item - OSD_ITEM_TIMER_1];
+            const timeUs_t resolution = OSD_TIMER_PRECISION(timer) == OSD_TIMER_PREC_HUNDREDTHS ? 10000 : 1000000;
+            return osdGetTimerValue(OSD_TIMER_SRC(timer)) / resolution;
+        }
+
+    case OSD_THROTTLE_POS:
+        return rcData[THROTTLE];
+
+#ifdef USE_GPS
+    case OSD_GPS_SATS:
+        return gpsSol.numSat;
+
+    case OSD_GPS_SPEED:
+        return gpsSol.groundSpeed;
+
+    case OSD_GPS_LAT:
+        return gpsSol.llh.lat;
+
+    case OSD_GPS_LON:
+        return gpsSol.llh.lon;
+
+    case OSD_HOME_DIST:
+        return (STATE(GPS_FIX) && STATE(GPS_FIX_HOME)) ? (int32_t)GPS_distanceToHome : -1;
+#endif
+
+#ifdef USE_VTX_COMMON
+    case OSD_VTX_CHANNEL:
+        return (ARMING_FLAG(ARMED) << 24) | (vtxSettingsConfig()->band << 16) | (vtxSettingsConfig()->channel << 8) | vtxSettingsConfig()->power;
+#endif
+
+#ifdef USE_ESC_SENSOR
+    case OSD_ESC_TMP:
+        return escDataCombined ? escDataCombined->temperature : 0;
+
+    case OSD_ESC_RPM:
+        return escDataCombined ? escDataCombined->rpm : 0;
+
+#ifdef USE_ESC_STATS
+    case OSD_ESC_TMP_MAX:
+        {
+            const int motor = osdGetHottestEscMotor();
+            return motor < 0 ? -1 : (motor << 16) | (uint16_t)getEscStats(motor)->values[ESC_STATS_TEMPERATURE].max;
+        }
+#endif
+#endif
+
+#ifdef USE_ADC_INTERNAL
+    case OSD_CORE_TEMPERATURE:
+        return getCoreTemperatureCelsius();
+#endif
+
+    default:
+        // the text only changes with the config, which the maximum cache age takes care of
+        return 0;
+    }
+}
+
+/*
+ * Returns true when the last formatted text of the element can be drawn again.
+ * The text is reused while the key is unchanged, or while the key changes faster than the element's refresh interval.
+ */
+static bool osdElementCacheIsCurrent(const osdElementCache_t *cache, uint8_t slot, uint8_t item, int32_t key)
+{
+    if (!cache->valid || cache->pos != osdConfig()->item_pos[item]) {
+        return false;
+    }
+
+    const timeDelta_t age = cmpTimeUs(osdElementTimeUs, cache->formattedAtUs);
+    if (age < 0 || age >= OSD_ELEMENT_CACHE_MAX_AGE_US) {
+        return false;
+    }
+
+    return key == cache->key || age < osdElementRefresh[slot].intervalMs * 1000;
+}
+#endif
+
 static bool osdDrawSingleElement(uint8_t item)
 {
     if (!VISIBLE(osdConfig()->item_pos[item]) || BLINK(item)) {
@@ -459,6 +678,20 @@ static bool osdDrawSingleElement(uint8_t item)
     uint8_t elemPosY = OSD_Y(osdConfig()->item_pos[item]);
     char buff[OSD_ELEMENT_BUFFER_LENGTH] = "";
 
+#ifdef USE_OSD_ELEMENT_CACHE
+    const uint8_t cacheSlot = osdElementCacheSlot[item];
+    int32_t cacheKey = 0;
+    if (cacheSlot) {
+        const osdElementCache_t *cache = &osdElementCache[cacheSlot - 1];
+        cacheKey = osdGetElementKey(item);
+        if (osdElementCacheIsCurrent(cache, cacheSlot - 1, item, cacheKey)) {
+            // the screen is cleared on every frame, so the text still has to be written again
+            displayWrite(osdDisplayPort, elemPosX, elemPosY, cache->buff);
+            return true;
+        }
+    }
+#endif
+
     switch (item) {
     case OSD_RSSI_VALUE:
         {
@@ -466,39 +699,39 @@ static bool osdDrawSingleElement(uint8_t item)
             if (osdRssi >= 100)
                 osdRssi = 99;
 
-            tfp_sprintf(buff, "%c%2d", SYM_RSSI, osdRssi);
+            i2aPadded(osdRssi, 2, osdAppendChar(buff, SYM_RSSI));
             break;
         }
 
     case OSD_MAIN_BATT_VOLTAGE:
         buff[0] = osdGetBatterySymbol(osdGetBatteryAverageCellVoltage());
-        tfp_sprintf(buff + 1, "%2d.%1d%c", getBatteryVoltage() / 10, getBatteryVoltage() % 10, SYM_VOLT);
+        osdAppendChar(ufixed2a(getBatteryVoltage(), 1, 2, buff + 1), SYM_VOLT);
         break;
 
     case OSD_CURRENT_DRAW:
         {
             const int32_t amperage = getAmperage();
-            tfp_sprintf(buff, "%3d.%02d%c", abs(amperage) / 100, abs(amperage) % 100, SYM_AMP);
+            osdAppendChar(ufixed2a(abs(amperage), 2, 3, buff), SYM_AMP);
             break;
         }
 
     case OSD_MAH_DRAWN:
-        tfp_sprintf(buff, "%4d%c", getMAhDrawn(), SYM_MAH);
+        osdAppendChar(i2aPadded(getMAhDrawn(), 4, buff), SYM_MAH);
         break;
 
 #ifdef USE_GPS
     case OSD_GPS_SATS:
-        tfp_sprintf(buff, "%c%c%2d", SYM_SAT_L, SYM_SAT_R, gpsSol.numSat);
+        i2aPadded(gpsSol.numSat, 2, osdAppendChar(osdAppendChar(buff, SYM_SAT_L), SYM_SAT_R));
         break;
 
     case OSD_GPS_SPEED:
         // FIXME ideally we want to use SYM_KMH symbol but it's not in the font any more, so we use K (M for MPH)
         switch (osdConfig()->units) {
         case OSD_UNIT_IMPERIAL:
-            tfp_sprintf(buff, "%3dM", CM_S_TO_MPH(gpsSol.groundSpeed));
+            osdAppendChar(i2aPadded(CM_S_TO_MPH(gpsSol.groundSpeed), 3, buff), 'M');
             break;
         default:
-            tfp_sprintf(buff, "%3dK", CM_S_TO_KM_H(gpsSol.groundSpeed));
+            osdAppendChar(i2aPadded(CM_S_TO_KM_H(gpsSol.groundSpeed), 3, buff), 'K');
             break;
         }
         break;
@@ -516,7 +749,7 @@ static bool osdDrawSingleElement(uint8_t item)
     case OSD_HOME_DIR:
         if (STATE(GPS_FIX) && STATE(GPS_FIX_HOME)) {
             if (GPS_distanceToHome > 0) {
-                const int h = GPS_directionToHome - DECIDEGREES_TO_DEGREES(attitude.values.yaw);
+                const int h = GPS_directionToHome - DECIDEGREES_TO_DEGREES(getAttitude()->values.yaw);
                 buff[0] = osdGetDirectionSymbolFromHeading(h);
             } else {
                 // We don't have a HOME symbol in the font, by now we use this
@@ -535,7 +768,7 @@ static bool osdDrawSingleElement(uint8_t item)
     case OSD_HOME_DIST:
         if (STATE(GPS_FIX) && STATE(GPS_FIX_HOME)) {
             const int32_t distance = osdGetMetersToSelectedUnit(GPS_distanceToHome);
-            tfp_sprintf(buff, "%d%c", distance, osdGetMetersToSelectedUnitSymbol());
+            osdAppendChar(i2aPadded(distance, 0, buff), osdGetMetersToSelectedUnitSymbol());
         } else {
             // We use this symbol when we don't have a FIX
             buff[0] = SYM_COLON;
@@ -548,7 +781,7 @@ static bool osdDrawSingleElement(uint8_t item)
 #endif // GPS
 
     case OSD_COMPASS_BAR:
-        memcpy(buff, compassBar + osdGetHeadingIntoDiscreteDirections(DECIDEGREES_TO_DEGREES(attitude.values.yaw), 16), 9);
+        memcpy(buff, compassBar + osdGetHeadingIntoDiscreteDirections(DECIDEGREES_TO_DEGREES(getAttitude()->values.yaw), 16), 9);
         buff[9] = 0;
         break;
 
@@ -567,9 +800,9 @@ static bool osdDrawSingleElement(uint8_t item)
             const int remaining_time = (int)((osdConfig()->cap_alarm - mAhDrawn) * ((float)flyTime) / mAhDrawn);
 
             if (mAhDrawn < 0.1 * osdConfig()->cap_alarm) {
-                tfp_sprintf(buff, "--:--");
+                strcpy(buff, "--:--");
             } else if (mAhDrawn > osdConfig()->cap_alarm) {
-                tfp_sprintf(buff, "00:00");
+                strcpy(buff, "00:00");
             } else {
                 osdFormatTime(buff, OSD_TIMER_PREC_SECOND, remaining_time);
             }
@@ -629,7 +862,7 @@ static bool osdDrawSingleElement(uint8_t item)
     case OSD_THROTTLE_POS:
         buff[0] = SYM_THR;
         buff[1] = SYM_THR1;
-        tfp_sprintf(buff + 2, "%3d", (constrain(rcData[THROTTLE], PWM_RANGE_MIN, PWM_RANGE_MAX) - PWM_RANGE_MIN) * 100 / (PWM_RANGE_MAX - PWM_RANGE_MIN));
+        i2aPadded((constrain(rcData[THROTTLE], PWM_RANGE_MIN, PWM_RANGE_MAX) - PWM_RANGE_MIN) * 100 / (PWM_RANGE_MAX - PWM_RANGE_MIN), 3, buff + 2);
         break;
 
 #if defined(USE_VTX_COMMON)
@@ -659,11 +892,12 @@ static bool osdDrawSingleElement(uint8_t item)
             // Get pitch and roll limits in tenths of degrees
             const int maxPitch = osdConfig()->ahMaxPitch * 10;
             const int maxRoll = osdConfig()->ahMaxRoll * 10;
-            const int rollAngle = constrain(attitude.values.roll, -maxRoll, maxRoll);
-            int pitchAngle = constrain(attitude.values.pitch, -maxPitch, maxPitch);
+            const int rollAngle = constrain(getAttitude()->values.roll, -maxRoll, maxRoll);
+            int pitchAngle = constrain(getAttitude()->values.pitch, -maxPitch, maxPitch);
             // Convert pitchAngle to y compensation value
             // (maxPitch / 25) divisor matches previous settings of fixed divisor of 8 and fixed max AHI pitch angle of 20.0 degrees
-            pitchAngle = ((pitchAngle * 25) / maxPitch) - 41; // 41 = 4 * AH_SYMBOL_COUNT + 5
+            // A max pitch of 0 (allowed by the CLI) keeps the horizon level instead of dividing by zero
+            pitchAngle = (maxPitch ? (pitchAngle * 25) / maxPitch : 0) - 41; // 41 = 4 * AH_SYMBOL_COUNT + 5
 
             for (int x = -4; x <= 4; x++) {
                 const int y = ((-rollAngle * x) / 64) - pitchAngle;
@@ -700,7 +934,7 @@ static bool osdDrawSingleElement(uint8_t item)
                 osdGForce += a * a;
             }
             osdGForce = sqrtf(osdGForce) / acc.dev.acc_1G;
-            tfp_sprintf(buff, "%01d.%01dG", (int)osdGForce, (int)(osdGForce * 10) % 10);
+            osdAppendChar(ufixed2a((unsigned)(osdGForce * 10), 1, 1, buff), 'G');
             break;
         }
 
@@ -717,11 +951,11 @@ static bool osdDrawSingleElement(uint8_t item)
         break;
 
     case OSD_POWER:
-        tfp_sprintf(buff, "%4dW", getAmperage() * getBatteryVoltage() / 1000);
+        osdAppendChar(i2aPadded(getAmperage() * getBatteryVoltage() / 1000, 4, buff), 'W');
         break;
 
     case OSD_PIDRATE_PROFILE:
-        tfp_sprintf(buff, "%d-%d", getCurrentPidProfileIndex() + 1, getCurrentControlRateProfileIndex() + 1);
+        i2aPadded(getCurrentControlRateProfileIndex() + 1, 0, osdAppendChar(i2aPadded(getCurrentPidProfileIndex() + 1, 0, buff), '-'));
         break;
 
     case OSD_WARNINGS:
@@ -871,7 +1105,7 @@ static bool osdDrawSingleElement(uint8_t item)
         {
             const int cellV = osdGetBatteryAverageCellVoltage();
             buff[0] = osdGetBatterySymbol(cellV);
-            tfp_sprintf(buff + 1, "%d.%02d%c", cellV / 100, cellV % 100, SYM_VOLT);
+            osdAppendChar(ufixed2a(cellV, 2, 0, buff + 1), SYM_VOLT);
             break;
         }
 
@@ -882,8 +1116,9 @@ static bool osdDrawSingleElement(uint8_t item)
     case OSD_PITCH_ANGLE:
     case OSD_ROLL_ANGLE:
         {
-            const int angle = (item == OSD_PITCH_ANGLE) ? attitude.values.pitch : attitude.values.roll;
-            tfp_sprintf(buff, "%c%02d.%01d", angle < 0 ? '-' : ' ', abs(angle / 10), abs(angle % 10));
+            const int angle = (item == OSD_PITCH_ANGLE) ? getAttitude()->values.pitch : getAttitude()->values.roll;
+            char *p = ui2aZeroPadded(abs(angle / 10), 2, osdAppendChar(buff, angle < 0 ? '-' : ' '));
+            ui2aZeroPadded(abs(angle % 10), 1, osdAppendChar(p, '.'));
             break;
         }
 
@@ -923,8 +1158,8 @@ static bool osdDrawSingleElement(uint8_t item)
 
     case OSD_NUMERICAL_HEADING:
         {
-            const int heading = DECIDEGREES_TO_DEGREES(attitude.values.yaw);
-            tfp_sprintf(buff, "%c%03d", osdGetDirectionSymbolFromHeading(heading), heading);
+            const int heading = DECIDEGREES_TO_DEGREES(getAttitude()->values.yaw);
+            ui2aZeroPadded(heading, 3, osdAppendChar(buff, osdGetDirectionSymbolFromHeading(heading)));
             break;
         }
 
@@ -932,23 +1167,39 @@ static bool osdDrawSingleElement(uint8_t item)
         {
             const int verticalSpeed = osdGetMetersToSelectedUnit(getEstimatedVario());
             const char directionSymbol = verticalSpeed < 0 ? SYM_ARROW_SOUTH : SYM_ARROW_NORTH;
-            tfp_sprintf(buff, "%c%01d.%01d", directionSymbol, abs(verticalSpeed / 100), abs((verticalSpeed % 100) / 10));
+            char *p = ui2aZeroPadded(abs(verticalSpeed / 100), 1, osdAppendChar(buff, directionSymbol));
+            ui2aZeroPadded(abs((verticalSpeed % 100) / 10), 1, osdAppendChar(p, '.'));
             break;
         }
 
 #ifdef USE_ESC_SENSOR
     case OSD_ESC_TMP:
         if (feature(FEATURE_ESC_SENSOR)) {
-            tfp_sprintf(buff, "%3d%c", osdConvertTemperatureToSelectedUnit(escDataCombined->temperature * 10) / 10, osdGetTemperatureSymbolForSelectedUnit());
+            osdAppendChar(i2aPadded(osdConvertTemperatureToSelectedUnit(escDataCombined->temperature * 10) / 10, 3, buff), osdGetTemperatureSymbolForSelectedUnit());
         }
         break;
 
     case OSD_ESC_RPM:
         if (feature(FEATURE_ESC_SENSOR)) {
-            tfp_sprintf(buff, "%5d", escDataCombined == NULL ? 0 : calcEscRpm(escDataCombined->rpm));
+            i2aPadded(escDataCombined == NULL ? 0 : calcEscRpm(escDataCombined->rpm), 5, buff);
+        }
+        break;
+
+#ifdef USE_ESC_STATS
+    case OSD_ESC_TMP_MAX:
+        {
+            // the hottest ESC and its peak temperature, e.g. "E3  65C"
+            const int motor = osdGetHottestEscMotor();
+            if (motor >= 0) {
+                const int temperature = getEscStats(motor)->values[ESC_STATS_TEMPERATURE].max;
+                char *p = i2aPadded(motor + 1, 1, osdAppendChar(buff, 'E'));
+                p = i2aPadded(osdConvertTemperatureToSelectedUnit(temperature * 10) / 10, 4, p);
+                osdAppendChar(p, osdGetTemperatureSymbolForSelectedUnit());
+            }
         }
         break;
 #endif
+#endif
 
 #ifdef USE_RTC_TIME
     case OSD_RTC_DATETIME:
@@ -966,7 +1217,7 @@ static bool osdDrawSingleElement(uint8_t item)
 
 #ifdef USE_ADC_INTERNAL
     case OSD_CORE_TEMPERATURE:
-        tfp_sprintf(buff, "%3d%c", osdConvertTemperatureToSelectedUnit(getCoreTemperatureCelsius() * 10) / 10, osdGetTemperatureSymbolForSelectedUnit());
+        osdAppendChar(i2aPadded(osdConvertTemperatureToSelectedUnit(getCoreTemperatureCelsius() * 10) / 10, 3, buff), osdGetTemperatureSymbolForSelectedUnit());
         break;
 #endif
 
@@ -974,61 +1225,105 @@ static bool osdDrawSingleElement(uint8_t item)
         return false;
     }
 
+#ifdef USE_OSD_ELEMENT_CACHE
+    if (cacheSlot) {
+        osdElementCache_t *cache = &osdElementCache[cacheSlot - 1];
+        cache->valid = true;
+        cache->pos = osdConfig()->item_pos[item];
+        cache->key = cacheKey;
+        cache->formattedAtUs = osdElementTimeUs;
+        memcpy(cache->buff, buff, sizeof(cache->buff));
+    }
+#endif
+
     displayWrite(osdDisplayPort, elemPosX, elemPosY, buff);
 
     return true;
 }
 
-static void osdDrawElements(void)
+static void osdAddToDrawList(uint8_t item)
+{
+    osdDrawList[osdDrawListCount++] = item;
+}
+
+/*
+ * Clears the screen and collects the elements to be drawn in this frame
+ */
+static void osdStartDrawElements(void)
 {
     displayClearScreen(osdDisplayPort);
 
+    osdDrawListCount = 0;
+    osdDrawListIndex = 0;
+
     // Hide OSD when OSDSW mode is active
     if (IS_RC_MODE_ACTIVE(BOXOSD)) {
         return;
     }
 
     if (sensors(SENSOR_ACC)) {
-        osdDrawSingleElement(OSD_ARTIFICIAL_HORIZON);
-        osdDrawSingleElement(OSD_G_FORCE);
+        osdAddToDrawList(OSD_ARTIFICIAL_HORIZON);
+        osdAddToDrawList(OSD_G_FORCE);
     }
 
 
     for (unsigned i = 0; i < sizeof(osdElementDisplayOrder); i++) {
-        osdDrawSingleElement(osdElementDisplayOrder[i]);
+        osdAddToDrawList(osdElementDisplayOrder[i]);
     }
 
 #ifdef USE_GPS
     if (sensors(SENSOR_GPS)) {
-        osdDrawSingleElement(OSD_GPS_SATS);
-        osdDrawSingleElement(OSD_GPS_SPEED);
-        osdDrawSingleElement(OSD_GPS_LAT);
-        osdDrawSingleElement(OSD_GPS_LON);
-        osdDrawSingleElement(OSD_HOME_DIST);
-        osdDrawSingleElement(OSD_HOME_DIR);
+        osdAddToDrawList(OSD_GPS_SATS);
+        osdAddToDrawList(OSD_GPS_SPEED);
+        osdAddToDrawList(OSD_GPS_LAT);
+        osdAddToDrawList(OSD_GPS_LON);
+        osdAddToDrawList(OSD_HOME_DIST);
+        osdAddToDrawList(OSD_HOME_DIR);
     }
 #endif // GPS
 
 #ifdef USE_ESC_SENSOR
     if (feature(FEATURE_ESC_SENSOR)) {
-        osdDrawSingleElement(OSD_ESC_TMP);
-        osdDrawSingleElement(OSD_ESC_RPM);
+        osdAddToDrawList(OSD_ESC_TMP);
+        osdAddToDrawList(OSD_ESC_RPM);
+#ifdef USE_ESC_STATS
+        osdAddToDrawList(OSD_ESC_TMP_MAX);
+#endif
     }
 #endif
 
 #ifdef USE_RTC_TIME
-    osdDrawSingleElement(OSD_RTC_DATETIME);
+    osdAddToDrawList(OSD_RTC_DATETIME);
 #endif
 
 #ifdef USE_OSD_ADJUSTMENTS
-    osdDrawSingleElement(OSD_ADJUSTMENT_RANGE);
+    osdAddToDrawList(OSD_ADJUSTMENT_RANGE);
 #endif
 
 #ifdef USE_ADC_INTERNAL
-    osdDrawSingleElement(OSD_CORE_TEMPERATURE);
+    osdAddToDrawList(OSD_CORE_TEMPERATURE);
 #endif
 }
 
+static bool osdDrawElementsPending(void)
+{
+    return osdDrawListIndex < osdDrawListCount;
+}
+
+/*
+ * Draws the remaining elements of the frame, returning early when a realtime task is due.
+ * Returns true once the frame is complete.
+ */
+static bool osdDrawElements(void)
+{
+    // always draw at least one element, so the frame completes even if the task keeps running late
+    do {
+        osdDrawSingleElement(osdDrawList[osdDrawListIndex++]);
+    } while (osdDrawElementsPending() && !schedulerTaskShouldYield(OSD_DRAW_ELEMENT_TIME_US));
+
+    return !osdDrawElementsPending();
+}
+
 void pgResetFn_osdConfig(osdConfig_t *osdConfig)
 {
     // Position elements near centre of screen and disabled by default
@@ -1105,6 +1400,9 @@ void osdInit(displayPort_t *osdDisplayPortToUse)
     armState = ARMING_FLAG(ARMED);
 
     memset(blinkBits, 0, sizeof(blinkBits));
+#ifdef USE_OSD_ELEMENT_CACHE
+    osdElementCacheInit();
+#endif
 
     displayClearScreen(osdDisplayPort);
 
@@ -1209,6 +1507,15 @@ void osdUpdateAlarms(void)
         } else {
             CLR_BLINK(OSD_ESC_TMP);
         }
+#ifdef USE_ESC_STATS
+        const int motor = osdGetHottestEscMotor();
+        if (osdConfig()->esc_temp_alarm != ESC_TEMP_ALARM_OFF && motor >= 0
+            && getEscStats(motor)->values[ESC_STATS_TEMPERATURE].max >= osdConfig()->esc_temp_alarm) {
+            SET_BLINK(OSD_ESC_TMP_MAX);
+        } else {
+            CLR_BLINK(OSD_ESC_TMP_MAX);
+        }
+#endif
     }
 #endif
 }
@@ -1227,6 +1534,7 @@ void osdResetAlarms(void)
     CLR_BLINK(OSD_ITEM_TIMER_2);
     CLR_BLINK(OSD_REMAINING_TIME_ESTIMATE);
     CLR_BLINK(OSD_ESC_TMP);
+    CLR_BLINK(OSD_ESC_TMP_MAX);
 }
 
 static void osdResetStats(void)
@@ -1444,6 +1752,36 @@ static void osdShowStats(uint16_t endBatteryVoltage)
     }
 #endif
 
+#ifdef USE_RX_LATENCY_STATISTICS
+    if (osdStatGetState(OSD_STAT_RX_LATENCY) && rxLatencyStats()->count) {
+        // average/maximum in ms
+        const timeDelta_t averageUs = rxLatencyAverageUs();
+        const timeDelta_t maxUs = rxLatencyStats()->maxUs;
+        tfp_sprintf(buff, "%d.%1d/%d.%1d", averageUs / 1000, (averageUs / 100) % 10, maxUs / 1000, (maxUs / 100) % 10);
+        osdDisplayStatisticLabel(top++, "RX LATENCY", buff);
+    }
+#endif
+
+#ifdef USE_FLIGHT_SUMMARY
+    const flightSummary_t *summary = flightSummaryGet(0);
+    if (osdStatGetState(OSD_STAT_GYRO_NOISE) && summary) {
+        // largest axis before/after the filters in deg/s
+        int prefiltered = 0;
+        int filtered = 0;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            prefiltered = MAX(prefiltered, summary->gyroNoisePrefilteredRms[axis]);
+            filtered = MAX(filtered, summary->gyroNoiseFilteredRms[axis]);
+        }
+        tfp_sprintf(buff, "%d.%1d/%d.%1d", prefiltered / 10, prefiltered % 10, filtered / 10, filtered % 10);
+        osdDisplayStatisticLabel(top++, "GYRO NOISE", buff);
+    }
+
+    if (osdStatGetState(OSD_STAT_MOTOR_SATURATION) && summary) {
+        tfp_sprintf(buff, "%d.%1d%%", summary->motorSaturationPermille / 10, summary->motorSaturationPermille % 10);
+        osdDisplayStatisticLabel(top++, "MOTOR SATURATED", buff);
+    }
+#endif
+
 }
 
 static void osdShowArmed(void)
@@ -1525,6 +1863,9 @@ STATIC_UNIT_TESTED void osdRefresh(timeUs_t currentTimeUs)
     }
 
     blinkState = (currentTimeUs / 200000) % 2;
+#ifdef USE_OSD_ELEMENT_CACHE
+    osdElementTimeUs = currentTimeUs;
+#endif
 
 #ifdef USE_ESC_SENSOR
     if (feature(FEATURE_ESC_SENSOR)) {
@@ -1535,8 +1876,10 @@ STATIC_UNIT_TESTED void osdRefresh(timeUs_t currentTimeUs)
 #ifdef USE_CMS
     if (!displayIsGrabbed(osdDisplayPort)) {
         osdUpdateAlarms();
-        osdDrawElements();
-        displayHeartbeat(osdDisplayPort);
+        osdStartDrawElements();
+        if (!osdDrawElementsPending() || osdDrawElements()) {
+            displayHeartbeat(osdDisplayPort);
+        }
 #ifdef OSD_CALLS_CMS
     } else {
         cmsUpdate(currentTimeUs);
@@ -1581,7 +1924,14 @@ void osdUpdate(timeUs_t currentTimeUs)
 #endif
 #define STATS_FREQ_DENOM    50
 
-    if (counter % DRAW_FREQ_DENOM == 0) {
+    if (osdDrawElementsPending()) {
+        // finish drawing the frame started by osdRefresh() before doing anything else
+        if (displayIsGrabbed(osdDisplayPort)) {
+            osdDrawListCount = 0;
+        } else if (osdDrawElements()) {
+            displayHeartbeat(osdDisplayPort);
+        }
+    } else if (counter % DRAW_FREQ_DENOM == 0) {
         osdRefresh(currentTimeUs);
         showVisualBeeper = false;
     } else {
@@ -96,6 +96,7 @@ typedef enum {
     OSD_CORE_TEMPERATURE,
     OSD_ANTI_GRAVITY,
     OSD_G_FORCE,
+    OSD_ESC_TMP_MAX,
     OSD_ITEM_COUNT // MUST BE LAST
 } osd_items_e;
 
@@ -123,6 +124,9 @@ typedef enum {
     OSD_STAT_MAX_ALTITUDE,
     OSD_STAT_BLACKBOX,
     OSD_STAT_BLACKBOX_NUMBER,
+    OSD_STAT_RX_LATENCY,
+    OSD_STAT_GYRO_NOISE,
+    OSD_STAT_MOTOR_SATURATION,
     OSD_STAT_COUNT // MUST BE LAST
 } osd_stats_e;
 
@@ -25,6 +25,7 @@
 #include "common/crc.h"
 #include "common/maths.h"
 #include "common/streambuf.h"
+#include "common/utils.h"
 
 #include "drivers/time.h"
 
@@ -111,11 +112,12 @@ static rcdeviceResponseParseContext_t* rcdeviceRespCtxQueueShift(rcdeviceWaiting
 // every time send packet to device, and want to get something from device,
 // it'd better call the method to clear the rx buffer before the packet send,
 // else may be the useless data in rx buffer will cause the response decoding
-// failed.
+// failed. Not while responses are waiting, the flush would drop the responses
+// of the requests already sent.
 static void runcamDeviceFlushRxBuffer(runcamDevice_t *device)
 {
-    while (serialRxBytesWaiting(device->serialPort) > 0) {
-        serialRead(device->serialPort);
+    if (watingResponseQueue.itemCount == 0) {
+        serialSkip(device->serialPort, serialRxBytesWaiting(device->serialPort));
     }
 }
 
@@ -150,8 +152,14 @@ static void runcamDeviceSendPacket(runcamDevice_t *device, uint8_t command, uint
 }
 
 // a common way to send a packet to device, and get response from the device.
-static void runcamDeviceSendRequestAndWaitingResp(runcamDevice_t *device, uint8_t commandID, uint8_t *paramData, uint8_t paramDataLen, timeMs_t tiemout, int maxRetryTimes, void *userInfo, rcdeviceRespParseFunc parseFunc)
+// The requests are pipelined, each is sent straight away and the responses are
+// matched to the requests in order. A request that can't be queued is not sent.
+static bool runcamDeviceSendRequestAndWaitingResp(runcamDevice_t *device, uint8_t commandID, uint8_t *paramData, uint8_t paramDataLen, timeMs_t tiemout, int maxRetryTimes, void *userInfo, rcdeviceRespParseFunc parseFunc)
 {
+    if (!device->serialPort || watingResponseQueue.itemCount >= MAX_WAITING_RESPONSES) {
+        return false;
+    }
+
     runcamDeviceFlushRxBuffer(device);
 
     rcdeviceResponseParseContext_t responseCtx;
@@ -172,6 +180,8 @@ static void runcamDeviceSendRequestAndWaitingResp(runcamDevice_t *device, uint8_
 
     // send packet
     runcamDeviceSendPacket(device, commandID, paramData, paramDataLen);
+
+    return true;
 }
 
 static void runcamDeviceParseV2DeviceInfo(rcdeviceResponseParseContext_t *ctx)
@@ -262,7 +272,7 @@ void runcamDeviceSimulate5KeyOSDCableButtonRelease(runcamDevice_t *device, rcdev
 static rcdeviceResponseParseContext_t* getWaitingResponse(timeMs_t currentTimeMs)
 {
     rcdeviceResponseParseContext_t *respCtx = rcdeviceRespCtxQueuePeekFront(&watingResponseQueue);
-    while (respCtx != NULL && respCtx->timeoutTimestamp != 0 && currentTimeMs > respCtx->timeoutTimestamp) {
+    while (respCtx != NULL && respCtx->timeoutTimestamp != 0 && cmp32(currentTimeMs, respCtx->timeoutTimestamp) > 0) {
         if (respCtx->maxRetryTimes > 0) {
             runcamDeviceSendPacket(respCtx->device, respCtx->command, respCtx->paramData, respCtx->paramDataLen);
             respCtx->timeoutTimestamp = currentTimeMs + respCtx->timeout;
@@ -284,32 +294,63 @@ static rcdeviceResponseParseContext_t* getWaitingResponse(timeMs_t currentTimeMs
     return respCtx;
 }
 
-void rcdeviceReceive(timeUs_t currentTimeUs) 
+// Called by the scheduler, true once the first waiting response has data or has timed out
+bool rcdeviceResponseDue(timeMs_t currentTimeMs)
+{
+    const rcdeviceResponseParseContext_t *respCtx = rcdeviceRespCtxQueuePeekFront(&watingResponseQueue);
+    if (respCtx == NULL) {
+        return false;
+    }
+
+    return serialRxBytesWaiting(respCtx->device->serialPort) || (respCtx->timeoutTimestamp != 0 && cmp32(currentTimeMs, respCtx->timeoutTimestamp) > 0);
+}
+
+static void rcdeviceResponseReceived(rcdeviceResponseParseContext_t *respCtx)
+{
+    // verify the crc value
+    if (respCtx->protocolVer == RCDEVICE_PROTOCOL_VERSION_1_0) {
+        uint8_t crc = 0;
+        for (int i = 0; i < respCtx->recvRespLen; i++) {
+            crc = crc8_dvb_s2(crc, respCtx->recvBuf[i]);
+        }
+        respCtx->result = (crc == 0) ? RCDEVICE_RESP_SUCCESS : RCDEVICE_RESP_INCORRECT_CRC;
+    }
+
+    if (respCtx->parserFunc != NULL) {
+        respCtx->parserFunc(respCtx);
+    }
+
+    // dequeue current response context
+    rcdeviceRespCtxQueueShift(&watingResponseQueue);
+}
+
+void rcdeviceReceive(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs);
     rcdeviceResponseParseContext_t *respCtx = NULL;
-    while ((respCtx = getWaitingResponse(millis())) != NULL && serialRxBytesWaiting(respCtx->device->serialPort)) {
-        const uint8_t c = serialRead(respCtx->device->serialPort);
-        respCtx->recvBuf[respCtx->recvRespLen] = c;
-        respCtx->recvRespLen += 1;
-        
-        // if data received done, trigger callback to parse response data, and update rcdevice state
-        if (respCtx->recvRespLen == respCtx->expectedRespLen) {
-            // verify the crc value
-            if (respCtx->protocolVer == RCDEVICE_PROTOCOL_VERSION_1_0) {
-                uint8_t crc = 0;
-                for (int i = 0; i < respCtx->recvRespLen; i++) {
-                    crc = crc8_dvb_s2(crc, respCtx->recvBuf[i]);
-                }
-                respCtx->result = (crc == 0) ? RCDEVICE_RESP_SUCCESS : RCDEVICE_RESP_INCORRECT_CRC;
-            }
+    while ((respCtx = getWaitingResponse(millis())) != NULL) {
+        // the received data is read in place, a contiguous span of the rx buffer at a time
+        const uint8_t *data;
+        const uint32_t available = serialPeekContiguous(respCtx->device->serialPort, &data);
+        if (available == 0) {
+            break;
+        }
 
-            if (respCtx->parserFunc != NULL) {
-                respCtx->parserFunc(respCtx);
+        uint32_t used = 0;
+        if (respCtx->recvRespLen == 0) {
+            // a response starts with the header, anything before it is noise
+            while (used < available && data[used] != RCDEVICE_PROTOCOL_HEADER) {
+                used++;
             }
+        }
+        const uint32_t count = MIN(available - used, (uint32_t)(respCtx->expectedRespLen - respCtx->recvRespLen));
+        memcpy(&respCtx->recvBuf[respCtx->recvRespLen], &data[used], count);
+        respCtx->recvRespLen += count;
+        serialSkip(respCtx->device->serialPort, used + count);
 
-            // dequeue current response context
-            rcdeviceRespCtxQueueShift(&watingResponseQueue);
+        // if data received done, trigger callback to parse response data, and update rcdevice state
+        if (respCtx->recvRespLen == respCtx->expectedRespLen) {
+            rcdeviceResponseReceived(respCtx);
         }
     }
 }
@@ -29,6 +29,8 @@
 
 #include "cms/cms.h"
 
+#include "drivers/time.h"
+
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
 
@@ -297,6 +299,14 @@ static void rcdevice5KeySimulationProcess(timeUs_t currentTimeUs)
     }
 }
 
+// Runs the task as soon as a response arrives or times out, and at RCDEVICE_UPDATE_PERIOD_US for the switches and sticks
+bool rcdeviceCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    return currentDeltaTimeUs >= RCDEVICE_UPDATE_PERIOD_US || rcdeviceResponseDue(millis());
+}
+
 void rcdeviceUpdate(timeUs_t currentTimeUs)
 {
     rcdeviceReceive(currentTimeUs);
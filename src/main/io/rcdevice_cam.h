@@ -32,6 +32,8 @@
 #define FIVE_KEY_CABLE_JOYSTICK_MID_START 1350
 #define FIVE_KEY_CABLE_JOYSTICK_MID_END 1650
 
+#define RCDEVICE_UPDATE_PERIOD_US (1000000 / 20)
+
 typedef struct rcdeviceSwitchState_s {
     bool isActivated;
 } rcdeviceSwitchState_t;
@@ -40,6 +42,7 @@ extern runcamDevice_t *camDevice;
 extern bool rcdeviceInMenu;
 
 void rcdeviceInit(void);
+bool rcdeviceCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
 void rcdeviceUpdate(timeUs_t currentTimeUs);
 
 bool rcdeviceIsEnabled(void);
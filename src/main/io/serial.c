@@ -26,6 +26,7 @@
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "pg/pg.h"
@@ -57,6 +58,8 @@
 
 #include "msp/msp_serial.h"
 
+#include "scheduler/scheduler.h"
+
 #ifdef USE_TELEMETRY
 #include "telemetry/telemetry.h"
 #endif
@@ -505,57 +508,101 @@ void waitForSerialPortToFinishTransmitting(serialPort_t *serialPort)
     };
 }
 
-#if defined(USE_GPS) || ! defined(SKIP_SERIAL_PASSTHROUGH)
-// Default data consumer for serialPassThrough.
-static void nopConsumer(uint8_t data)
-{
-    UNUSED(data);
-}
+#ifdef USE_SERIAL_PASSTHROUGH
+static serialPort_t *passthroughLeft;
+static serialPort_t *passthroughRight;
+static serialConsumer *passthroughLeftConsumer;
+static serialConsumer *passthroughRightConsumer;
 
 /*
  A high-level serial passthrough implementation. Used by cli to start an
  arbitrary serial passthrough "proxy". Optional callbacks can be given to allow
  for specialized data processing.
+
+ The ports are bridged by TASK_SERIAL_PASSTHROUGH until power cycle. Every other
+ task is stopped, any of them might own one of the ports.
  */
 void serialPassthrough(serialPort_t *left, serialPort_t *right, serialConsumer *leftC, serialConsumer *rightC)
 {
     waitForSerialPortToFinishTransmitting(left);
     waitForSerialPortToFinishTransmitting(right);
 
-    if (!leftC)
-        leftC = &nopConsumer;
-    if (!rightC)
-        rightC = &nopConsumer;
+    passthroughLeft = left;
+    passthroughRight = right;
+    passthroughLeftConsumer = leftC;
+    passthroughRightConsumer = rightC;
 
     LED0_OFF;
     LED1_OFF;
 
+    for (int taskId = 0; taskId < TASK_COUNT; taskId++) {
+        setTaskEnabled(taskId, taskId == TASK_SERIAL_PASSTHROUGH);
+    }
+}
+
+bool serialPassthroughIsActive(void)
+{
+    return passthroughLeft != NULL;
+}
+
+// Moves what one port has received to the transmit buffer of the other, as much as the other port can take, the
+// rest stays in the receive buffer until the next run. Returns the number of bytes moved.
+static uint32_t serialPassthroughForward(serialPort_t *from, serialPort_t *to, serialConsumer *consumer)
+{
+    uint32_t total = 0;
+    uint32_t txFree;
+
+    const uint8_t *data;
+    uint32_t count;
+    // a wrapped receive buffer takes two runs
+    while ((txFree = serialTxBytesFree(to)) > 0 && (count = serialPeekContiguous(from, &data)) > 0) {
+        count = MIN(count, txFree);
+        serialWriteBuf(to, data, count);
+        if (consumer) {
+            for (uint32_t i = 0; i < count; i++) {
+                consumer(data[i]);
+            }
+        }
+        serialSkip(from, count);
+        total += count;
+    }
+
+    // drivers that cannot expose their receive buffer are read a byte at a time
+    while (txFree > 0 && serialRxBytesWaiting(from)) {
+        const uint8_t c = serialRead(from);
+        serialWrite(to, c);
+        if (consumer) {
+            consumer(c);
+        }
+        txFree--;
+        total++;
+    }
+
+    return total;
+}
+
+void serialPassthroughUpdate(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    if (!serialPassthroughIsActive()) {
+        return;
+    }
+
     // Either port might be open in a mode other than MODE_RXTX. We rely on
     // serialRxBytesWaiting() to do the right thing for a TX only port. No
     // special handling is necessary OR performed.
-    while (1) {
-        // TODO: maintain a timestamp of last data received. Use this to
-        // implement a guard interval and check for `+++` as an escape sequence
-        // to return to CLI command mode.
-        // https://en.wikipedia.org/wiki/Escape_sequence#Modem_control
-        if (serialRxBytesWaiting(left)) {
-            LED0_ON;
-            uint8_t c = serialRead(left);
-            // Make sure there is space in the tx buffer
-            while (!serialTxBytesFree(right));
-            serialWrite(right, c);
-            leftC(c);
-            LED0_OFF;
-         }
-         if (serialRxBytesWaiting(right)) {
-             LED0_ON;
-             uint8_t c = serialRead(right);
-             // Make sure there is space in the tx buffer
-             while (!serialTxBytesFree(left));
-             serialWrite(left, c);
-             rightC(c);
-             LED0_OFF;
-         }
-     }
- }
- #endif
+    // TODO: maintain a timestamp of last data received. Use this to
+    // implement a guard interval and check for `+++` as an escape sequence
+    // to return to CLI command mode.
+    // https://en.wikipedia.org/wiki/Escape_sequence#Modem_control
+    const uint32_t forwarded = serialPassthroughForward(passthroughLeft, passthroughRight, passthroughLeftConsumer)
+        + serialPassthroughForward(passthroughRight, passthroughLeft, passthroughRightConsumer);
+
+    if (forwarded) {
+        LED0_ON;
+    } else {
+        LED0_OFF;
+    }
+}
+#endif
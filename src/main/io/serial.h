@@ -23,6 +23,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "common/time.h"
+
 #include "pg/pg.h"
 #include "drivers/serial.h"
 
@@ -172,3 +174,5 @@ baudRate_e lookupBaudRateIndex(uint32_t baudRate);
 // msp/cli/bootloader
 //
 void serialPassthrough(serialPort_t *left, serialPort_t *right, serialConsumer *leftC, serialConsumer *rightC);
+bool serialPassthroughIsActive(void);
+void serialPassthroughUpdate(timeUs_t currentTimeUs);
@@ -64,6 +64,9 @@ void pgResetFn_transponderConfig(transponderConfig_t *transponderConfig)
 static bool transponderInitialised = false;
 static bool transponderRepeat = false;
 
+// the ID the DMA buffer was encoded for, the buffer is sent as it is by every transmission
+static uint8_t encodedData[sizeof(transponderConfig()->data)];
+
 // timers
 static timeUs_t nextUpdateAtUs = 0;
 
@@ -116,7 +119,8 @@ void transponderInit(void)
         return;
     }
 
-    transponderIrUpdateData(transponderConfig()->data);
+    memcpy(encodedData, transponderConfig()->data, sizeof(encodedData));
+    transponderIrUpdateData(encodedData);
 }
 
 void transponderStopRepeating(void)
@@ -135,11 +139,13 @@ void transponderStartRepeating(void)
 
 void transponderUpdateData(void)
 {
-    if (!transponderInitialised) {
+    // an unchanged ID is not encoded again, nor is the transmission in progress waited for
+    if (!transponderInitialised || memcmp(encodedData, transponderConfig()->data, sizeof(encodedData)) == 0) {
         return;
     }
 
-    transponderIrUpdateData(transponderConfig()->data);
+    memcpy(encodedData, transponderConfig()->data, sizeof(encodedData));
+    transponderIrUpdateData(encodedData);
 }
 
 void transponderTransmitOnce(void) {
@@ -23,6 +23,8 @@
 #ifdef USE_USB_CDC_HID
 
 #include "common/maths.h"
+#include "common/time.h"
+#include "common/topic.h"
 
 #include "fc/rc_controls.h"
 
@@ -59,23 +61,46 @@ const uint8_t hidChannelMapping[] = {
     AUX2,     // Wheel
 };
 
-void sendRcDataToHid(void)
+// Matches the bInterval of the HID endpoint, a report is not replaced before the host has polled it
+#define USB_CDC_HID_REPORT_INTERVAL_US 1000
+
+static topicSubscriber_t hidRcChannelsSubscriber;
+
+// The USB driver reads the report from its interrupt after USBD_HID_SendReport() returns,
+// so the next report is built in the other buffer
+static int8_t hidReports[2][USB_CDC_HID_NUM_AXES];
+static uint8_t hidReportIndex;
+static timeUs_t hidLastReportAtUs;
+
+// Called for each RX frame, sends the channels of the frame if the host has polled the previous report
+void sendRcDataToHid(timeUs_t currentTimeUs)
 {
-    int8_t report[8];
+    if (cmpTimeUs(currentTimeUs, hidLastReportAtUs) < USB_CDC_HID_REPORT_INTERVAL_US) {
+        return;
+    }
+
+    rcChannels_t rcChannels;
+    if (rcChannelsRead(&rcChannels, &hidRcChannelsSubscriber) != TOPIC_READ_NEW) {
+        return;
+    }
+
+    hidReportIndex ^= 1;
+    int8_t *report = hidReports[hidReportIndex];
     for (unsigned i = 0; i < USB_CDC_HID_NUM_AXES; i++) {
         const uint8_t channel = hidChannelMapping[i];
-        report[i] = scaleRange(constrain(rcData[channel], PWM_RANGE_MIN, PWM_RANGE_MAX), PWM_RANGE_MIN, PWM_RANGE_MAX, USB_CDC_HID_RANGE_MIN, USB_CDC_HID_RANGE_MAX);
+        report[i] = scaleRange(constrain(rcChannels.data[channel], PWM_RANGE_MIN, PWM_RANGE_MAX), PWM_RANGE_MIN, PWM_RANGE_MAX, USB_CDC_HID_RANGE_MIN, USB_CDC_HID_RANGE_MAX);
         if (i == 1) {
             // For some reason ROLL is inverted in Windows
             report[i] = -report[i];
         }
     }
 #if defined(STM32F4)
-    USBD_HID_SendReport(&USB_OTG_dev, (uint8_t*)report, sizeof(report));
+    USBD_HID_SendReport(&USB_OTG_dev, (uint8_t*)report, USB_CDC_HID_NUM_AXES);
 #elif defined(STM32F7)
-    USBD_HID_SendReport(&USBD_Device, (uint8_t*)report, sizeof(report));
+    USBD_HID_SendReport(&USBD_Device, (uint8_t*)report, USB_CDC_HID_NUM_AXES);
 #else
 # error "MCU does not support USB HID."
 #endif
+    hidLastReportAtUs = currentTimeUs;
 }
 #endif
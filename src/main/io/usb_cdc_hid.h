@@ -20,4 +20,6 @@
 
 #pragma once
 
-void sendRcDataToHid(void);
+#include "common/time.h"
+
+void sendRcDataToHid(timeUs_t currentTimeUs);
@@ -36,6 +36,8 @@
 #include "drivers/time.h"
 #include "drivers/vtx_rtc6705.h"
 
+#include "fc/fc_dispatch.h"
+
 #include "io/vtx_rtc6705.h"
 #include "io/vtx_string.h"
 
@@ -66,6 +68,10 @@ bool vtxRTC6705Init(void)
 {
     vtxCommonSetDevice(&vtxRTC6705);
 
+#ifdef RTC6705_POWER_PIN
+    dispatchEnable();
+#endif
+
     return true;
 }
 
@@ -86,15 +92,35 @@ static void vtxRTC6705Configure(vtxDevice_t *vtxDevice)
     vtxRTC6705SetBandAndChannel(vtxDevice, vtxDevice->band, vtxDevice->channel);
 }
 
+static vtxDevice_t *configureDevice;
+static bool configurePending;
+
+static void vtxRTC6705ConfigureAfterBoot(dispatchEntry_t *self)
+{
+    UNUSED(self);
+
+    configurePending = false;
+    if (configureDevice->powerIndex > 0) {
+        vtxRTC6705Configure(configureDevice);
+    }
+}
+
+static dispatchEntry_t vtxRTC6705ConfigureDispatch = {
+    .dispatch = vtxRTC6705ConfigureAfterBoot
+};
+
+// Configures the device from the dispatch queue once it has booted, rather than waiting for it here
 static void vtxRTC6705EnableAndConfigure(vtxDevice_t *vtxDevice)
 {
     while (!vtxRTC6705CanUpdate());
 
     rtc6705Enable();
 
-    delay(VTX_RTC6705_BOOT_DELAY);
-
-    vtxRTC6705Configure(vtxDevice);
+    configureDevice = vtxDevice;
+    if (!configurePending) {
+        configurePending = true;
+        dispatchAdd(&vtxRTC6705ConfigureDispatch, VTX_RTC6705_BOOT_DELAY * 1000);
+    }
 }
 #endif
 
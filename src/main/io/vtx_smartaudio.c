@@ -444,9 +444,7 @@ static void saSendFrame(uint8_t *buf, int len)
             break;
     }
 
-    for (int i = 0 ; i < len ; i++) {
-        serialWrite(smartAudioSerialPort, buf[i]);
-    }
+    serialWriteBuf(smartAudioSerialPort, buf, len);
 
     sa_lastTransmissionMs = millis();
     saStat.pktsent++;
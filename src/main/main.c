@@ -29,8 +29,14 @@
 
 void run(void);
 
+#ifdef SIMULATOR_BUILD
+int main(int argc, char *argv[])
+{
+    targetParseArgs(argc, argv);
+#else
 int main(void)
 {
+#endif
     init();
 
     run();
@@ -43,7 +49,11 @@ void FAST_CODE FAST_CODE_NOINLINE run(void)
     while (true) {
         scheduler();
         processLoopback();
-#ifdef SIMULATOR_BUILD
+#if defined(SIMULATOR_LOCKSTEP)
+        simulatorLockstepYield();
+#elif defined(SIMULATOR_EVENT_LOOP)
+        simulatorEventLoopWait();
+#elif defined(SIMULATOR_BUILD)
         delayMicroseconds_real(50); // max rate 20kHz
 #endif
     }
@@ -597,7 +597,8 @@ void fill_dir_sector(emfat_t *emfat, uint8_t *data, emfat_entry_t *entry, uint32
     }
 }
 
-void read_data_sector(emfat_t *emfat, uint8_t *data, uint32_t rel_sect)
+// Fill up to num_sectors consecutive data sectors, as long as they belong to the same file. Returns the number filled.
+int read_data_sectors(emfat_t *emfat, uint8_t *data, uint32_t rel_sect, int num_sectors)
 {
     emfat_entry_t *le;
     uint32_t cluster;
@@ -611,32 +612,42 @@ void read_data_sector(emfat_t *emfat, uint8_t *data, uint32_t rel_sect)
             int i;
             for (i = 0; i < SECT / 4; i++)
                 ((uint32_t *)data)[i] = 0xEFBEADDE;
-            return;
+            return 1;
         }
         emfat->priv.last_entry = le;
     }
 
     if (le->dir) {
         fill_dir_sector(emfat, data, le, rel_sect);
-        return;
+        return 1;
+    }
+
+    // Read the whole run of the file in one go, the file's clusters are contiguous
+    const uint32_t sectorsLeftInFile = (le->priv.last_reserved - cluster + 1) * SECT_PER_CLUST - rel_sect;
+    if ((uint32_t)num_sectors > sectorsLeftInFile) {
+        num_sectors = sectorsLeftInFile;
     }
 
     if (le->readcb == NULL) {
-        memset(data, 0, SECT);
+        memset(data, 0, num_sectors * SECT);
     } else {
         uint32_t offset = cluster - le->priv.first_clust;
         offset = offset * CLUST + rel_sect * SECT;
-        le->readcb(data, SECT, offset + le->offset, le);
+        le->readcb(data, num_sectors * SECT, offset + le->offset, le);
     }
 
-    return;
+    return num_sectors;
 }
 
 void emfat_read(emfat_t *emfat, uint8_t *data, uint32_t sector, int num_sectors)
 {
     while (num_sectors > 0) {
         if (sector >= emfat->priv.root_lba) {
-            read_data_sector(emfat, data, sector - emfat->priv.root_lba);
+            const int sectorsRead = read_data_sectors(emfat, data, sector - emfat->priv.root_lba, num_sectors);
+            data += sectorsRead * SECT;
+            num_sectors -= sectorsRead;
+            sector += sectorsRead;
+            continue;
         } else if (sector == 0) {
             read_mbr_sector(emfat, data);
         } else if (sector == emfat->priv.fsinfo_lba) {
@@ -22,8 +22,11 @@
  * Author: jflyper@github.com
  */
 
-#include "common/utils.h"
+#include "platform.h"
+
+#include "common/maths.h"
 #include "common/printf.h"
+#include "common/utils.h"
 
 #include "emfat.h"
 #include "emfat_file.h"
@@ -262,7 +265,7 @@ static const emfat_entry_t entriesPredefined[] =
 #define EMFAT_MAX_ENTRY (ENTRY_INDEX_BBL + EMFAT_MAX_LOG_ENTRY)
 
 static emfat_entry_t entries[EMFAT_MAX_ENTRY];
-static char logNames[EMFAT_MAX_LOG_ENTRY][8+3];
+static char logNames[EMFAT_MAX_LOG_ENTRY][8 + 1 + 3 + 1];
 
 emfat_t emfat;
 
@@ -280,15 +283,55 @@ static void emfat_add_log(emfat_entry_t *entry, int number, uint32_t offset, uin
     entry->readcb = bblog_read_proc;
 }
 
+#ifdef USE_FLASHFS_LOG_INDEX
+/*
+ * List the logs from the log index instead of scanning the flash, so they get their arming time too. Returns the
+ * number of logs listed, and the end of the last one in *end.
+ */
+static int emfat_find_indexed_log(emfat_entry_t *entry, int maxCount, uint32_t *end)
+{
+    int fileNumber = 0;
+
+    for (int i = 0; i < flashfsLogIndexCount() && fileNumber < maxCount; i++) {
+        flashfsLogIndexEntry_t indexEntry;
+
+        if (!flashfsLogIndexRead(i, &indexEntry) || indexEntry.size == 0) {
+            continue;
+        }
+
+        emfat_add_log(entry, fileNumber, indexEntry.start, indexEntry.size);
+        if (indexEntry.armTime) {
+            const uint32_t cmaTime = emfat_cma_time_from_unix(indexEntry.armTime);
+            entry->cma_time[0] = cmaTime;
+            entry->cma_time[1] = cmaTime;
+            entry->cma_time[2] = cmaTime;
+        }
+        *end = indexEntry.start + indexEntry.size;
+
+        ++fileNumber;
+        ++entry;
+    }
+
+    return fileNumber;
+}
+#endif
+
 static void emfat_find_log(emfat_entry_t *entry, int maxCount)
 {
     uint32_t limit  = flashfsIdentifyStartOfFreeSpace();
     uint32_t lastOffset = 0;
-    uint32_t currOffset = 0;
     int fileNumber = 0;
     uint8_t buffer[18];
 
-    for ( ; currOffset < limit ; currOffset += 2048) { // XXX 2048 = FREE_BLOCK_SIZE in io/flashfs.c
+#ifdef USE_FLASHFS_LOG_INDEX
+    // Only the logs that were never closed (e.g. by a power loss) are left to find by scanning
+    fileNumber = emfat_find_indexed_log(entry, maxCount, &lastOffset);
+    entry += fileNumber;
+#endif
+
+    uint32_t currOffset = lastOffset;
+
+    for ( ; currOffset < limit && fileNumber != maxCount ; currOffset += 2048) { // XXX 2048 = FREE_BLOCK_SIZE in io/flashfs.c
 
         flashfsReadAbs(currOffset, buffer, 18);
 
@@ -310,7 +353,7 @@ static void emfat_find_log(emfat_entry_t *entry, int maxCount)
     }
 
     if (fileNumber != maxCount && lastOffset != currOffset) {
-        emfat_add_log(entry, fileNumber, lastOffset, currOffset - lastOffset);
+        emfat_add_log(entry, fileNumber, lastOffset, MIN(currOffset, limit) - lastOffset);
     }
 }
 
@@ -236,6 +236,17 @@ static int8_t STORAGE_Write (uint8_t lun,
 {
 	UNUSED(lun);
 	LED1_ON;
+	if (blk_len > 1) {
+		// Let the card pre-erase the whole run and take it as one multi-block write
+		sdcardOperationStatus_e status;
+		while ((status = sdcard_beginWriteBlocks(blk_addr, blk_len)) == SDCARD_OPERATION_BUSY) {
+			sdcard_poll();
+		}
+		if (status != SDCARD_OPERATION_SUCCESS) {
+			LED1_OFF;
+			return -1;
+		}
+	}
 	for (int i = 0; i < blk_len; i++) {
 		while (sdcard_writeBlock(blk_addr + i, buf + (i * 512), NULL, NULL) != SDCARD_OPERATION_IN_PROGRESS) {
 			sdcard_poll();
@@ -26,20 +26,30 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
 #include "common/streambuf.h"
 #include "common/utils.h"
 #include "common/crc.h"
+#include "common/huffman.h"
 
 #include "drivers/system.h"
 
 #include "interface/msp.h"
+#include "interface/msp_protocol.h"
 #include "interface/cli.h"
 
+#include "io/flashfs.h"
 #include "io/serial.h"
 
 #include "msp/msp_serial.h"
 
 static mspPort_t mspPorts[MAX_MSP_PORT_COUNT];
+static uint8_t mspFirstPortIndex;
+
+static uint8_t mspSerialOutBuf[MSP_PORT_OUTBUF_SIZE];
+#ifdef USE_MSP_COMPRESSION
+static uint8_t mspSerialCompressedBuf[MSP_COMPRESSION_BUFFER_SIZE];
+#endif
 
 static void resetMspPort(mspPort_t *mspPortToReset, serialPort_t *serialPort, bool sharedWithTelemetry)
 {
@@ -380,12 +390,156 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
     return mspSerialSendFrame(msp, hdrBuf, hdrLen, sbufPtr(&packet->buf), dataLen, crcBuf, crcLen);
 }
 
+#ifdef USE_MSP_STREAMING
+// Messages that take no request payload and only report state, so they can be generated without a request
+static const uint16_t mspStreamableCommands[] = {
+    MSP_STATUS,
+    MSP_STATUS_EX,
+    MSP_RAW_IMU,
+    MSP_SERVO,
+    MSP_MOTOR,
+    MSP_RC,
+    MSP_RAW_GPS,
+    MSP_COMP_GPS,
+    MSP_ATTITUDE,
+    MSP_ALTITUDE,
+    MSP_ANALOG,
+    MSP_SONAR_ALTITUDE,
+    MSP_VOLTAGE_METERS,
+    MSP_CURRENT_METERS,
+    MSP_BATTERY_STATE,
+    MSP_ESC_SENSOR_DATA,
+    MSP_RX_LATENCY,
+    MSP_DEBUG,
+};
+
+#define MSP_STREAM_ITEM_HEADER_SIZE 4   // cmd (U16) + size (U16) in front of each batched payload
+#define MSP_STREAM_TOKENS_MAX       (MSP_STREAM_BATCH_SIZE + MSP_MAX_HEADER_SIZE + 2)
+
+static bool mspStreamIsStreamable(uint16_t cmd)
+{
+    for (unsigned i = 0; i < ARRAYLEN(mspStreamableCommands); i++) {
+        if (mspStreamableCommands[i] == cmd) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * MSP2_STREAM_SUBSCRIBE payload: budget in bytes per second (U16, 0 = no limit), followed by
+ * up to MSP_STREAM_MAX_ENTRIES pairs of cmd (U16) and interval in ms (U16).
+ * An empty list stops streaming on the port. Replies with the number of entries accepted.
+ */
+static mspResult_e mspSerialStreamSubscribe(mspPort_t *msp, sbuf_t *src, sbuf_t *dst)
+{
+    const int dataSize = sbufBytesRemaining(src);
+    if (dataSize < 2 || (dataSize - 2) % 4 != 0 || (dataSize - 2) / 4 > MSP_STREAM_MAX_ENTRIES) {
+        return MSP_RESULT_ERROR;
+    }
+
+    const uint16_t budget = sbufReadU16(src);
+    const uint8_t entryCount = (dataSize - 2) / 4;
+    const timeUs_t currentTimeUs = micros();
+    mspStreamEntry_t entries[MSP_STREAM_MAX_ENTRIES];
+
+    for (int i = 0; i < entryCount; i++) {
+        entries[i].cmd = sbufReadU16(src);
+        entries[i].intervalMs = sbufReadU16(src);
+        entries[i].nextDueUs = currentTimeUs;
+        if (!mspStreamIsStreamable(entries[i].cmd) || entries[i].intervalMs == 0) {
+            return MSP_RESULT_ERROR;
+        }
+    }
+
+    memcpy(msp->streamEntries, entries, entryCount * sizeof(mspStreamEntry_t));
+    msp->streamEntryCount = entryCount;
+    msp->streamBudget = budget;
+    msp->streamTokens = 0;
+    msp->streamLastRefillUs = currentTimeUs;
+    // The subscription can only arrive in an MSPv2 frame, push in the same framing
+    msp->streamVersion = msp->mspVersion;
+
+    sbufWriteU8(dst, entryCount);
+
+    return MSP_RESULT_ACK;
+}
+
+#ifdef USE_FLASHFS
+/*
+ * MSP2_DATAFLASH_STREAM payload: start address (U32), length (U32), flags (U8, bit 0 allows compression).
+ * A length of 0 stops the transfer, resuming is a new request from the first address not yet received.
+ * Replies with the start address and the length that will be sent, clipped to the used flash.
+ */
+static mspResult_e mspSerialDataflashStreamStart(mspPort_t *msp, sbuf_t *src, sbuf_t *dst)
+{
+    if (sbufBytesRemaining(src) < (int)(2 * sizeof(uint32_t))) {
+        return MSP_RESULT_ERROR;
+    }
+
+    const uint32_t address = sbufReadU32(src);
+    uint32_t length = sbufReadU32(src);
+    const uint8_t flags = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
+
+    const uint32_t flashfsSize = flashfsIsReady() ? flashfsGetSize() : 0;
+    if (address >= flashfsSize) {
+        length = 0;
+    } else if (length > flashfsSize - address) {
+        length = flashfsSize - address;
+    }
+
+    msp->dataflashStreamAddress = address;
+    msp->dataflashStreamEnd = address + length;
+    msp->dataflashStreamCompress = flags & 0x01;
+    msp->dataflashStreamVersion = msp->mspVersion;
+
+    sbufWriteU32(dst, address);
+    sbufWriteU32(dst, length);
+
+    return MSP_RESULT_ACK;
+}
+#endif
+#endif
+
+#ifdef USE_MSP_COMPRESSION
+// Points the reply at its compressed payload when the requester accepts one and it is smaller
+static void mspSerialCompressReply(mspPacket_t *reply)
+{
+    const int size = sbufBytesRemaining(&reply->buf);
+    if (size < MSP_COMPRESSION_MIN_SIZE) {
+        return;
+    }
+
+    // only sent compressed when that is smaller
+    huffmanState_t state = {
+        .bytesWritten = 0,
+        .outByte = mspSerialCompressedBuf + HUFFMAN_INFO_SIZE,
+        .outBufLen = MIN(size, MSP_COMPRESSION_BUFFER_SIZE) - (int)HUFFMAN_INFO_SIZE - 1,
+        .outBit = 0x80,
+    };
+    *state.outByte = 0;
+    if (huffmanEncodeBufStreaming(&state, sbufPtr(&reply->buf), size, huffmanTable) == -1) {
+        return;
+    }
+    if (state.outBit != 0x80) {
+        ++state.bytesWritten;
+    }
+
+    sbuf_t *buf = &reply->buf;
+    buf->ptr = mspSerialCompressedBuf;
+    buf->end = mspSerialCompressedBuf + HUFFMAN_INFO_SIZE + state.bytesWritten;
+    mspSerialCompressedBuf[0] = size & 0xff;
+    mspSerialCompressedBuf[1] = size >> 8;
+    reply->flags |= MSP2_FLAG_COMPRESSED;
+}
+#endif
+
 static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
 {
-    static uint8_t outBuf[MSP_PORT_OUTBUF_SIZE];
+    uint8_t *outBuf = mspSerialOutBuf;
 
     mspPacket_t reply = {
-        .buf = { .ptr = outBuf, .end = ARRAYEND(outBuf), },
+        .buf = { .ptr = outBuf, .end = ARRAYEND(mspSerialOutBuf), },
         .cmd = -1,
         .flags = 0,
         .result = 0,
@@ -402,10 +556,29 @@ static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspPr
     };
 
     mspPostProcessFnPtr mspPostProcessFn = NULL;
-    const mspResult_e status = mspProcessCommandFn(&command, &reply, &mspPostProcessFn);
+    mspResult_e status;
+#ifdef USE_MSP_STREAMING
+    if (command.cmd == MSP2_STREAM_SUBSCRIBE) {
+        // Subscriptions are per port, so handled here rather than by the command processor
+        status = mspSerialStreamSubscribe(msp, &command.buf, &reply.buf);
+    } else
+#ifdef USE_FLASHFS
+    if (command.cmd == MSP2_DATAFLASH_STREAM) {
+        status = mspSerialDataflashStreamStart(msp, &command.buf, &reply.buf);
+    } else
+#endif
+#endif
+    {
+        status = mspProcessCommandFn(&command, &reply, &mspPostProcessFn);
+    }
 
     if (status != MSP_RESULT_NO_REPLY) {
         sbufSwitchToReader(&reply.buf, outBufHead); // change streambuf direction
+#ifdef USE_MSP_COMPRESSION
+        if (msp->mspVersion != MSP_V1 && (command.flags & MSP2_FLAG_COMPRESSION_ACCEPTED)) {
+            mspSerialCompressReply(&reply);
+        }
+#endif
         mspSerialEncode(msp, &reply, msp->mspVersion);
     }
 
@@ -450,6 +623,15 @@ static void mspProcessPendingRequest(mspPort_t * mspPort)
     }
 }
 
+static void mspSerialProcessReceivedByte(mspPort_t *mspPort, uint8_t c, mspEvaluateNonMspData_e evaluateNonMspData)
+{
+    const bool consumed = mspSerialProcessReceivedData(mspPort, c);
+
+    if (!consumed && evaluateNonMspData == MSP_EVALUATE_NON_MSP_DATA) {
+        mspEvaluateNonMspData(mspPort, c);
+    }
+}
+
 static void mspSerialProcessReceivedReply(mspPort_t *msp, mspProcessReplyFnPtr mspProcessReplyFn)
 {
     mspPacket_t reply = {
@@ -469,16 +651,30 @@ static void mspSerialProcessReceivedReply(mspPort_t *msp, mspProcessReplyFnPtr m
 /*
  * Process MSP commands from serial ports configured as MSP ports.
  *
+ * Each port gets at most one command and MSP_PORT_RX_BYTES_PER_CALL received bytes per call,
+ * starting from a different port each time. Post processing of a command is deferred until
+ * its reply has been transmitted, instead of waiting for that while the other ports queue up.
+ *
  * Called periodically by the scheduler.
  */
 void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn)
 {
-    for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
-        mspPort_t * const mspPort = &mspPorts[portIndex];
+    for (uint8_t n = 0; n < MAX_MSP_PORT_COUNT; n++) {
+        mspPort_t * const mspPort = &mspPorts[(mspFirstPortIndex + n) % MAX_MSP_PORT_COUNT];
         if (!mspPort->port) {
             continue;
         }
 
+        if (mspPort->pendingPostProcessFn) {
+            // Commands after it on this port wait until it has run
+            if (isSerialTransmitBufferEmpty(mspPort->port)) {
+                const mspPostProcessFnPtr mspPostProcessFn = mspPort->pendingPostProcessFn;
+                mspPort->pendingPostProcessFn = NULL;
+                mspPostProcessFn(mspPort->port);
+            }
+            continue;
+        }
+
         mspPostProcessFnPtr mspPostProcessFn = NULL;
 
         if (serialRxBytesWaiting(mspPort->port)) {
@@ -486,12 +682,22 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
             mspPort->lastActivityMs = millis();
             mspPort->pendingRequest = MSP_PENDING_NONE;
 
-            while (serialRxBytesWaiting(mspPort->port)) {
-                const uint8_t c = serialRead(mspPort->port);
-                const bool consumed = mspSerialProcessReceivedData(mspPort, c);
+            uint32_t budget = MSP_PORT_RX_BYTES_PER_CALL;
+            while (budget && serialRxBytesWaiting(mspPort->port)) {
+                const uint8_t *data;
+                const uint32_t available = serialPeekContiguous(mspPort->port, &data);
 
-                if (!consumed && evaluateNonMspData == MSP_EVALUATE_NON_MSP_DATA) {
-                    mspEvaluateNonMspData(mspPort, c);
+                if (available) {
+                    // Parse in place, a whole USB packet at a time on VCP
+                    uint32_t count = 0;
+                    while (count < MIN(available, budget) && mspPort->c_state != MSP_COMMAND_RECEIVED) {
+                        mspSerialProcessReceivedByte(mspPort, data[count++], evaluateNonMspData);
+                    }
+                    serialSkip(mspPort->port, count);
+                    budget -= count;
+                } else {
+                    mspSerialProcessReceivedByte(mspPort, serialRead(mspPort->port), evaluateNonMspData);
+                    budget--;
                 }
 
                 if (mspPort->c_state == MSP_COMMAND_RECEIVED) {
@@ -506,17 +712,188 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
                 }
             }
 
-            if (mspPostProcessFn) {
-                waitForSerialPortToFinishTransmitting(mspPort->port);
-                mspPostProcessFn(mspPort->port);
-            }
+            mspPort->pendingPostProcessFn = mspPostProcessFn;
         }
         else {
             mspProcessPendingRequest(mspPort);
         }
     }
+
+    mspFirstPortIndex = (mspFirstPortIndex + 1) % MAX_MSP_PORT_COUNT;
+}
+
+#ifdef USE_MSP_STREAMING
+static void mspSerialStreamRefill(mspPort_t *msp, timeUs_t currentTimeUs)
+{
+    const timeDelta_t elapsedUs = cmpTimeUs(currentTimeUs, msp->streamLastRefillUs);
+    const int32_t tokens = (int64_t)msp->streamBudget * elapsedUs / 1000000;
+
+    if (msp->streamTokens + tokens >= MSP_STREAM_TOKENS_MAX) {
+        msp->streamTokens = MSP_STREAM_TOKENS_MAX;
+        msp->streamLastRefillUs = currentTimeUs;
+    } else if (tokens > 0) {
+        // Only consume the time that produced whole bytes, so low budgets do not lose the remainder
+        msp->streamTokens += tokens;
+        msp->streamLastRefillUs += (int64_t)tokens * 1000000 / msp->streamBudget;
+    }
+}
+
+static void mspSerialStreamSendBatch(mspPort_t *msp, timeUs_t currentTimeUs, mspProcessCommandFnPtr mspProcessCommandFn)
+{
+    static uint8_t batchBuf[MSP_STREAM_BATCH_SIZE];
+    sbuf_t batch = { .ptr = batchBuf, .end = ARRAYEND(batchBuf), };
+    uint32_t batchedEntries = 0;
+
+    for (int i = 0; i < msp->streamEntryCount; i++) {
+        mspStreamEntry_t *entry = &msp->streamEntries[i];
+        if (cmpTimeUs(currentTimeUs, entry->nextDueUs) < 0) {
+            continue;
+        }
+
+        mspPacket_t command = {
+            .buf = { .ptr = msp->inBuf, .end = msp->inBuf, },
+            .cmd = entry->cmd,
+            .flags = 0,
+            .result = 0,
+            .direction = MSP_DIRECTION_REQUEST,
+        };
+        mspPacket_t reply = {
+            .buf = { .ptr = mspSerialOutBuf, .end = ARRAYEND(mspSerialOutBuf), },
+            .cmd = -1,
+            .flags = 0,
+            .result = 0,
+            .direction = MSP_DIRECTION_REPLY,
+        };
+        mspPostProcessFnPtr mspPostProcessFn = NULL;
+
+        const mspResult_e status = mspProcessCommandFn(&command, &reply, &mspPostProcessFn);
+        const int dataLen = reply.buf.ptr - mspSerialOutBuf;
+        if (status != MSP_RESULT_ACK || dataLen + MSP_STREAM_ITEM_HEADER_SIZE > MSP_STREAM_BATCH_SIZE) {
+            // Never going to fit a batch, drop this interval
+            batchedEntries |= 1 << i;
+            continue;
+        }
+        if (dataLen + MSP_STREAM_ITEM_HEADER_SIZE > sbufBytesRemaining(&batch)) {
+            // Stays due and goes out in the next batch
+            break;
+        }
+
+        sbufWriteU16(&batch, entry->cmd);
+        sbufWriteU16(&batch, dataLen);
+        sbufWriteData(&batch, mspSerialOutBuf, dataLen);
+        batchedEntries |= 1 << i;
+    }
+
+    if (batch.ptr != batchBuf) {
+        mspPacket_t packet = {
+            .buf = { .ptr = batchBuf, .end = batch.ptr, },
+            .cmd = MSP2_STREAM_DATA,
+            .flags = 0,
+            .result = 0,
+            .direction = MSP_DIRECTION_REPLY,
+        };
+
+        const int frameLength = mspSerialEncode(msp, &packet, msp->streamVersion);
+        if (frameLength == 0) {
+            // No room in the transmit buffer, everything stays due
+            return;
+        }
+        if (msp->streamBudget) {
+            msp->streamTokens -= frameLength;
+        }
+    }
+
+    for (int i = 0; i < msp->streamEntryCount; i++) {
+        if (batchedEntries & (1 << i)) {
+            mspStreamEntry_t *entry = &msp->streamEntries[i];
+            entry->nextDueUs += entry->intervalMs * 1000;
+            if (cmpTimeUs(currentTimeUs, entry->nextDueUs) >= 0) {
+                // Fell more than an interval behind, do not try to catch up
+                entry->nextDueUs = currentTimeUs + entry->intervalMs * 1000;
+            }
+        }
+    }
 }
 
+#ifdef USE_FLASHFS
+#define MSP_DATAFLASH_STREAM_OVERHEAD (MSP_MAX_HEADER_SIZE + 1 + MSP_PORT_DATAFLASH_INFO_SIZE + sizeof(uint32_t))
+
+/*
+ * Send dataflash chunks while the transmit buffer has room for them. Reading the next chunk
+ * overlaps with the transmission of the previous one, so the transfer runs at the speed of the port.
+ */
+static void mspSerialDataflashStreamProcess(mspPort_t *msp)
+{
+    while (msp->dataflashStreamAddress < msp->dataflashStreamEnd) {
+        const uint32_t remaining = msp->dataflashStreamEnd - msp->dataflashStreamAddress;
+        const uint32_t txBytesFree = serialTxBytesFree(msp->port);
+        if (txBytesFree <= MSP_DATAFLASH_STREAM_OVERHEAD) {
+            break;
+        }
+        const uint16_t chunkSize = MIN(MIN(remaining, (uint32_t)MSP_DATAFLASH_STREAM_CHUNK_SIZE), txBytesFree - MSP_DATAFLASH_STREAM_OVERHEAD);
+        if (chunkSize < MIN(remaining, (uint32_t)MSP_DATAFLASH_STREAM_CHUNK_MIN)) {
+            // Wait for the port to drain rather than sending lots of small frames
+            break;
+        }
+
+        sbuf_t dst = { .ptr = mspSerialOutBuf, .end = mspSerialOutBuf + chunkSize + MSP_PORT_DATAFLASH_INFO_SIZE, };
+        const int bytesRead = mspFcSerializeDataflashChunk(&dst, msp->dataflashStreamAddress, chunkSize, msp->dataflashStreamCompress);
+        if (bytesRead <= 0) {
+            msp->dataflashStreamEnd = msp->dataflashStreamAddress;
+            break;
+        }
+        sbufWriteU32(&dst, crc32_update(0, mspSerialOutBuf, dst.ptr - mspSerialOutBuf));
+
+        mspPacket_t packet = {
+            .buf = { .ptr = mspSerialOutBuf, .end = dst.ptr, },
+            .cmd = MSP2_DATAFLASH_STREAM_DATA,
+            .flags = 0,
+            .result = 0,
+            .direction = MSP_DIRECTION_REPLY,
+        };
+        if (!mspSerialEncode(msp, &packet, msp->dataflashStreamVersion)) {
+            break;
+        }
+
+        msp->dataflashStreamAddress += bytesRead;
+    }
+}
+#endif
+
+/*
+ * Push the subscribed messages of each MSP port, at most one batch per port per call,
+ * and any dataflash transfer in progress.
+ *
+ * Called periodically by the scheduler, after mspSerialProcess().
+ */
+void mspSerialProcessStreams(timeUs_t currentTimeUs, mspProcessCommandFnPtr mspProcessCommandFn)
+{
+    for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
+        mspPort_t * const mspPort = &mspPorts[portIndex];
+        if (!mspPort->port) {
+            continue;
+        }
+
+#ifdef USE_FLASHFS
+        mspSerialDataflashStreamProcess(mspPort);
+#endif
+
+        if (!mspPort->streamEntryCount) {
+            continue;
+        }
+
+        if (mspPort->streamBudget) {
+            mspSerialStreamRefill(mspPort, currentTimeUs);
+            if (mspPort->streamTokens < 0) {
+                continue;
+            }
+        }
+
+        mspSerialStreamSendBatch(mspPort, currentTimeUs, mspProcessCommandFn);
+    }
+}
+#endif
+
 bool mspSerialWaiting(void)
 {
     for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
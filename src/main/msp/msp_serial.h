@@ -64,6 +64,7 @@ typedef enum {
 } mspPendingSystemRequest_e;
 
 #define MSP_PORT_INBUF_SIZE 192
+#define MSP_PORT_RX_BYTES_PER_CALL 256
 #ifdef USE_FLASHFS
 #ifdef STM32F1
 #define MSP_PORT_DATAFLASH_BUFFER_SIZE 1024
@@ -93,6 +94,29 @@ typedef struct __attribute__((packed)) {
 
 #define MSP_MAX_HEADER_SIZE     9
 
+// MSPv2 header flags
+#define MSP2_FLAG_COMPRESSION_ACCEPTED  0x02    // request: the reply may be compressed
+#define MSP2_FLAG_COMPRESSED            0x02    // reply: the uncompressed size (U16) followed by the Huffman coded payload
+
+#ifdef USE_MSP_COMPRESSION
+#define MSP_COMPRESSION_MIN_SIZE        64      // smaller replies are sent as they are
+#define MSP_COMPRESSION_BUFFER_SIZE     1024    // replies that do not fit compressed are sent as they are
+#endif
+
+#ifdef USE_MSP_STREAMING
+#define MSP_STREAM_MAX_ENTRIES      16
+#define MSP_STREAM_BATCH_SIZE       256
+
+#define MSP_DATAFLASH_STREAM_CHUNK_SIZE     1024
+#define MSP_DATAFLASH_STREAM_CHUNK_MIN      64
+
+typedef struct mspStreamEntry_s {
+    uint16_t cmd;
+    uint16_t intervalMs;
+    timeUs_t nextDueUs;
+} mspStreamEntry_t;
+#endif
+
 struct serialPort_s;
 typedef struct mspPort_s {
     struct serialPort_s *port; // null when port unused.
@@ -109,6 +133,21 @@ typedef struct mspPort_s {
     uint8_t checksum1;
     uint8_t checksum2;
     bool sharedWithTelemetry;
+    mspPostProcessFnPtr pendingPostProcessFn;   // run once the reply has been transmitted
+#ifdef USE_MSP_STREAMING
+    mspVersion_e streamVersion;
+    uint8_t streamEntryCount;
+    uint16_t streamBudget;          // bytes per second, 0 = limited by the transmit buffer only
+    int32_t streamTokens;           // bytes that may be sent now, refilled at streamBudget
+    timeUs_t streamLastRefillUs;
+    mspStreamEntry_t streamEntries[MSP_STREAM_MAX_ENTRIES];
+#ifdef USE_FLASHFS
+    uint32_t dataflashStreamAddress;    // next byte to send, streaming while below dataflashStreamEnd
+    uint32_t dataflashStreamEnd;
+    bool dataflashStreamCompress;
+    mspVersion_e dataflashStreamVersion;
+#endif
+#endif
 } mspPort_t;
 
 void mspSerialInit(void);
@@ -119,3 +158,4 @@ void mspSerialReleasePortIfAllocated(struct serialPort_s *serialPort);
 void mspSerialReleaseSharedTelemetryPorts(void);
 int mspSerialPush(uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direction);
 uint32_t mspSerialTxBytesFree(void);
+void mspSerialProcessStreams(timeUs_t currentTimeUs, mspProcessCommandFnPtr mspProcessCommandFn);
@@ -30,12 +30,13 @@
 
 #include "max7456.h"
 
-PG_REGISTER_WITH_RESET_FN(max7456Config_t, max7456Config, PG_MAX7456_CONFIG, 0);
+PG_REGISTER_WITH_RESET_FN(max7456Config_t, max7456Config, PG_MAX7456_CONFIG, 1);
 
 void pgResetFn_max7456Config(max7456Config_t *config)
 {
     config->clockConfig = MAX7456_CLOCK_CONFIG_DEFAULT;
     config->csTag = IO_TAG(MAX7456_SPI_CS_PIN);
     config->spiDevice = SPI_DEV_TO_CFG(spiDeviceByInstance(MAX7456_SPI_INSTANCE));
+    config->vsyncTag = IO_TAG(MAX7456_VSYNC_PIN);
 }
 #endif // USE_MAX7456
@@ -46,6 +46,7 @@ typedef void (pgResetFunc)(void * /* base */, int /* size */);
 typedef struct pgRegistry_s {
     pgn_t pgn;             // The parameter group number, the top 4 bits are reserved for version
     uint16_t size;         // Size of the group in RAM, the top 4 bits are reserved for flags
+    uint16_t elementSize;  // Size of each element of an array group, 0 for a single group
     uint8_t *address;      // Address of the group in RAM.
     uint8_t *copy;         // Address of the copy in RAM.
     uint8_t **ptr;         // The pointer to update after loading the record into ram.
@@ -121,6 +122,7 @@ extern const uint8_t __pg_resetdata_end[];
     const pgRegistry_t _name ##_Registry PG_REGISTER_ATTRIBUTES = {     \
         .pgn = _pgn | (_version << 12),                                 \
         .size = sizeof(_type) | PGR_SIZE_SYSTEM_FLAG,                   \
+        .elementSize = 0,                                               \
         .address = (uint8_t*)&_name ## _System,                         \
         .copy = (uint8_t*)&_name ## _Copy,                              \
         .ptr = 0,                                                       \
@@ -150,6 +152,7 @@ extern const uint8_t __pg_resetdata_end[];
     const pgRegistry_t _name ## _Registry PG_REGISTER_ATTRIBUTES = {    \
         .pgn = _pgn | (_version << 12),                                 \
         .size = (sizeof(_type) * _size) | PGR_SIZE_SYSTEM_FLAG,         \
+        .elementSize = sizeof(_type),                                   \
         .address = (uint8_t*)&_name ## _SystemArray,                    \
         .copy = (uint8_t*)&_name ## _CopyArray,                         \
         .ptr = 0,                                                       \
@@ -134,7 +134,15 @@
 #define PG_RX_SPI_CONFIG 537
 #define PG_BOARD_CONFIG 538
 #define PG_RCDEVICE_CONFIG 539
-#define PG_BETAFLIGHT_END 539
+#define PG_RPM_FILTER_CONFIG 540
+#define PG_THRUST_CURVE_CONFIG 541
+#define PG_GYRO_BIAS_TABLE 542
+#define PG_IDLE_CONTROL_CONFIG 543
+#define PG_DIRECT_SETPOINT_CONFIG 544
+#define PG_FLIGHT_SUMMARY_CONFIG 545
+#define PG_FLIGHT_SUMMARY_LOG 546
+#define PG_OFFLOAD_CONFIG 547
+#define PG_BETAFLIGHT_END 547
 
 
 // OSD configuration (subject to change)
@@ -25,11 +25,11 @@
 #include "pg/pg_ids.h"
 #include "pg/sdio.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(sdioConfig_t, sdioConfig, PG_SDIO_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(sdioConfig_t, sdioConfig, PG_SDIO_CONFIG, 1);
 
 PG_RESET_TEMPLATE(sdioConfig_t, sdioConfig,
     .clockBypass = 0,
-    .useCache = 0,
+    .useCache = 1,
 );
 
 #endif
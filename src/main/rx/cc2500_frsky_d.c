@@ -221,7 +221,7 @@ rx_spi_received_e frSkyDHandlePacket(uint8_t * const packet, uint8_t * const pro
                             nextChannel(1);
 #if defined(USE_RX_FRSKY_SPI_TELEMETRY)
                             if ((packet[3] % 4) == 2) {
-                                telemetryTimeUs = micros();
+                                telemetryTimeUs = frSkySpiPacketTimeUs();
                                 setRssiDbm(packet[18]);
                                 buildTelemetryFrame(packet);
                                 *protocolState = STATE_TELEMETRY;
@@ -232,7 +232,7 @@ rx_spi_received_e frSkyDHandlePacket(uint8_t * const packet, uint8_t * const pro
                                 *protocolState = STATE_UPDATE;
                             }
                             ret = RX_SPI_RECEIVED_DATA;
-                            lastPacketReceivedTime = currentPacketReceivedTime;
+                            lastPacketReceivedTime = frSkySpiPacketTimeUs();
                         }
                     }
                 }
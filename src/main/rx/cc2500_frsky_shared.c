@@ -32,7 +32,9 @@
 #include "pg/rx_spi.h"
 
 #include "drivers/rx/rx_cc2500.h"
+#include "drivers/exti.h"
 #include "drivers/io.h"
+#include "drivers/nvic.h"
 #include "drivers/time.h"
 
 #include "fc/config.h"
@@ -70,6 +72,10 @@ static handlePacketFn *handlePacket;
 static setRcDataFn *setRcData;
 
 IO_t gdoPin;
+#ifdef USE_EXTI
+static extiCallbackRec_t gdoExtiCallbackRec;
+static volatile timeUs_t gdoExtiTimeUs = 0;
+#endif
 static IO_t bindPin = DEFIO_IO(NONE);
 static IO_t frSkyLedPin;
 
@@ -111,6 +117,31 @@ void setRssiDbm(uint8_t value)
 #endif // USE_RX_FRSKY_SPI_TELEMETRY
 
 #if defined(USE_RX_FRSKY_SPI_PA_LNA)
+#ifdef USE_EXTI
+// GDO0 rises when a packet has been received (IOCFG0 = 0x01) and stays high until the FIFO is read,
+// so the edge times the packet that is waiting however late the RX task gets to it
+static void gdoExtiHandler(extiCallbackRec_t *cb)
+{
+    UNUSED(cb);
+
+    gdoExtiTimeUs = micros();
+}
+#endif
+
+// Receive time of the packet waiting in the FIFO, the hopping and telemetry slots are timed from it
+timeUs_t frSkySpiPacketTimeUs(void)
+{
+    const timeUs_t currentTimeUs = micros();
+#ifdef USE_EXTI
+    const timeUs_t packetTimeUs = gdoExtiTimeUs;
+    // without an edge for this packet, e.g. if the EXTI line is taken by another pin, use the time it was noticed
+    if (packetTimeUs && cmpTimeUs(currentTimeUs, packetTimeUs) < SYNC_DELAY_MAX) {
+        return packetTimeUs;
+    }
+#endif
+    return currentTimeUs;
+}
+
 void TxEnable(void)
 {
     IOHi(txEnPin);
@@ -557,7 +588,18 @@ bool frSkySpiInit(const rxSpiConfig_t *rxSpiConfig, rxRuntimeConfig_t *rxRuntime
     // gpio init here
     gdoPin = IOGetByTag(IO_TAG(RX_FRSKY_SPI_GDO_0_PIN));
     IOInit(gdoPin, OWNER_RX_SPI, 0);
+#ifdef USE_EXTI
+    EXTIHandlerInit(&gdoExtiCallbackRec, gdoExtiHandler);
+#ifdef STM32F7
+    EXTIConfig(gdoPin, &gdoExtiCallbackRec, NVIC_PRIO_MPU_INT_EXTI, IO_CONFIG(GPIO_MODE_INPUT, 0, GPIO_NOPULL));
+#else
     IOConfigGPIO(gdoPin, IOCFG_IN_FLOATING);
+    EXTIConfig(gdoPin, &gdoExtiCallbackRec, NVIC_PRIO_MPU_INT_EXTI, EXTI_Trigger_Rising);
+#endif
+    EXTIEnable(gdoPin, true);
+#else
+    IOConfigGPIO(gdoPin, IOCFG_IN_FLOATING);
+#endif
     frSkyLedPin = IOGetByTag(IO_TAG(RX_FRSKY_SPI_LED_PIN));
     IOInit(frSkyLedPin, OWNER_LED, 0);
     IOConfigGPIO(frSkyLedPin, IOCFG_OUT_PP);
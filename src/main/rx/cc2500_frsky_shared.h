@@ -54,6 +54,8 @@ extern int16_t rssiDbm;
 
 extern IO_t gdoPin;
 
+timeUs_t frSkySpiPacketTimeUs(void);
+
 void setRssiDbm(uint8_t value);
 
 void TxEnable(void);
@@ -233,10 +233,8 @@ static void smartPortWriteFrameFport(const smartPortPayload_t *payload)
 {
     framePosition = 0;
 
-    uint16_t checksum = 0;
-    smartPortSendByte(FPORT_RESPONSE_FRAME_LENGTH, &checksum, fportPort);
-    smartPortSendByte(FPORT_FRAME_TYPE_TELEMETRY_RESPONSE, &checksum, fportPort);
-    smartPortWriteFrameSerial(payload, fportPort, checksum);
+    static const uint8_t header[] = { FPORT_RESPONSE_FRAME_LENGTH, FPORT_FRAME_TYPE_TELEMETRY_RESPONSE };
+    smartPortWriteFrameSerial(payload, fportPort, header, sizeof(header));
 }
 #endif
 
@@ -280,7 +278,7 @@ static uint8_t fportFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
                     if (frameLength != FPORT_FRAME_PAYLOAD_LENGTH_CONTROL) {
                         reportFrameError(DEBUG_FPORT_ERROR_TYPE_SIZE);
                     } else {
-                        result = sbusChannelsDecode(rxRuntimeConfig, &frame->data.controlData.channels);
+                        result = sbusChannelsDecode(rxRuntimeConfig->channelData, &frame->data.controlData.channels);
 
                         setRssi(scaleRange(frame->data.controlData.rssi, 0, 100, 0, RSSI_MAX_VALUE), RSSI_SOURCE_RX_PROTOCOL);
 
@@ -28,6 +28,7 @@
 
 #include "build/build_config.h"
 #include "build/debug.h"
+#include "build/profile.h"
 
 #include "common/maths.h"
 #include "common/utils.h"
@@ -89,6 +90,7 @@ static bool rxIsInFailsafeMode = true;
 static uint8_t rxChannelCount;
 
 static timeUs_t rxNextUpdateAtUs = 0;
+static timeUs_t rxLastFrameTimeUs = 0;
 static uint32_t needRxSignalBefore = 0;
 static uint32_t needRxSignalMaxDelayUs;
 static uint32_t suspendRxSignalUntil = 0;
@@ -96,6 +98,8 @@ static uint8_t  skipRxSamples = 0;
 
 static int16_t rcRaw[MAX_SUPPORTED_RC_CHANNEL_COUNT];     // interval [1000;2000]
 int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];     // interval [1000;2000]
+
+TOPIC_DEFINE(rcChannels, rcChannels_t);
 uint32_t rcInvalidPulsPeriod[MAX_SUPPORTED_RC_CHANNEL_COUNT];
 
 #define MAX_INVALID_PULS_TIME    300
@@ -319,6 +323,11 @@ bool rxIsReceivingSignal(void)
     return rxSignalReceived;
 }
 
+bool rxIsFrameSignalled(void)
+{
+    return rxRuntimeConfig.rcFrameSignalled;
+}
+
 bool rxAreFlightChannelsValid(void)
 {
     return rxFlightChannelsValid;
@@ -363,13 +372,18 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
     } else
 #endif
     {
+        PROFILE_BEGIN(PROFILE_RX_DECODE);
         const uint8_t frameStatus = rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig);
+        PROFILE_END(PROFILE_RX_DECODE);
         if (frameStatus & RX_FRAME_COMPLETE) {
             rxIsInFailsafeMode = (frameStatus & RX_FRAME_FAILSAFE) != 0;
             bool rxFrameDropped = (frameStatus & RX_FRAME_DROPPED) != 0;
             signalReceived = !(rxIsInFailsafeMode || rxFrameDropped);
             if (signalReceived) {
                 needRxSignalBefore = currentTimeUs + needRxSignalMaxDelayUs;
+                if (rxRuntimeConfig.rcFrameTimeUsFn) {
+                    rxLastFrameTimeUs = rxRuntimeConfig.rcFrameTimeUsFn();
+                }
             }
 
             if (frameStatus & (RX_FRAME_FAILSAFE | RX_FRAME_DROPPED)) {
@@ -557,6 +571,8 @@ bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs)
     readRxChannelsApplyRanges();
     detectAndApplySignalLossBehaviour();
 
+    rcChannelsPublish((const rcChannels_t *)rcData, currentTimeUs);
+
     rcSampleIndex++;
 
     return true;
@@ -682,6 +698,12 @@ uint8_t getRssiPercent(void)
     return scaleRange(getRssi(), 0, RSSI_MAX_VALUE, 0, 100);
 }
 
+// Receive time of the frame behind the latest channel values, 0 if the driver does not timestamp its frames
+timeUs_t rxFrameTimeUs(void)
+{
+    return rxLastFrameTimeUs;
+}
+
 uint16_t rxGetRefreshRate(void)
 {
     return rxRuntimeConfig.rxRefreshRate;
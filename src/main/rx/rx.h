@@ -21,6 +21,7 @@
 #pragma once
 
 #include "common/time.h"
+#include "common/topic.h"
 
 #include "pg/pg.h"
 #include "pg/rx.h"
@@ -85,6 +86,12 @@ extern const char rcChannelLetters[];
 
 extern int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];       // interval [1000;2000]
 
+typedef struct rcChannels_s {
+    int16_t data[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+} rcChannels_t;
+
+TOPIC_DECLARE(rcChannels, rcChannels_t);
+
 #define RSSI_SCALE_MIN 1
 #define RSSI_SCALE_MAX 255
 
@@ -124,6 +131,7 @@ struct rxRuntimeConfig_s;
 typedef uint16_t (*rcReadRawDataFnPtr)(const struct rxRuntimeConfig_s *rxRuntimeConfig, uint8_t chan); // used by receiver driver to return channel data
 typedef uint8_t (*rcFrameStatusFnPtr)(struct rxRuntimeConfig_s *rxRuntimeConfig);
 typedef bool (*rcProcessFrameFnPtr)(const struct rxRuntimeConfig_s *rxRuntimeConfig);
+typedef timeUs_t (*rcFrameTimeUsFnPtr)(void); // time the last byte of the latest complete frame was received
 
 typedef struct rxRuntimeConfig_s {
     uint8_t             channelCount; // number of RC channels as reported by current input driver
@@ -131,8 +139,10 @@ typedef struct rxRuntimeConfig_s {
     rcReadRawDataFnPtr  rcReadRawFn;
     rcFrameStatusFnPtr  rcFrameStatusFn;
     rcProcessFrameFnPtr rcProcessFrameFn;
+    rcFrameTimeUsFnPtr  rcFrameTimeUsFn;  // NULL if the driver does not timestamp its frames
     uint16_t            *channelData;
     void                *frameData;
+    bool                rcFrameSignalled; // driver calls schedulerSignalTask(TASK_RX) when a frame has been received
 } rxRuntimeConfig_t;
 
 typedef enum {
@@ -151,8 +161,10 @@ extern rxRuntimeConfig_t rxRuntimeConfig; //!!TODO remove this extern, only need
 void rxInit(void);
 bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
 bool rxIsReceivingSignal(void);
+bool rxIsFrameSignalled(void);
 bool rxAreFlightChannelsValid(void);
 bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs);
+timeUs_t rxFrameTimeUs(void);
 
 struct rxConfig_s;
 
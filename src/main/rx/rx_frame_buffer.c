@@ -0,0 +1,74 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "rx/rx_frame_buffer.h"
+
+#define RX_FRAME_BUFFER_BARRIER() asm volatile ("": : :"memory") // compiler memory barrier
+
+// Called from the receive interrupt, returns the channel array to decode the new frame into
+uint16_t *rxFrameBufferWriteBegin(rxFrameBuffer_t *frameBuffer)
+{
+    const uint32_t sequence = frameBuffer->sequence + 1;
+    frameBuffer->sequence = sequence;
+    RX_FRAME_BUFFER_BARRIER();
+
+    return frameBuffer->channelData[((sequence + 1) >> 1) & 1];
+}
+
+void rxFrameBufferWriteEnd(rxFrameBuffer_t *frameBuffer, uint8_t frameStatus)
+{
+    const uint32_t sequence = frameBuffer->sequence;
+    frameBuffer->frameStatus[((sequence + 1) >> 1) & 1] = frameStatus;
+    RX_FRAME_BUFFER_BARRIER();
+    frameBuffer->sequence = sequence + 1;
+}
+
+// Called from the RX task, copies the latest frame if it has not been read yet and returns its rxFrameState_e
+uint8_t rxFrameBufferRead(const rxFrameBuffer_t *frameBuffer, uint16_t *channelData, uint8_t channelCount, uint32_t *lastFrame)
+{
+    uint32_t frame;
+    uint8_t frameStatus;
+    uint32_t start;
+
+    do {
+        start = frameBuffer->sequence;
+        frame = start >> 1;
+        if (frame == *lastFrame) {
+            return RX_FRAME_PENDING;
+        }
+        RX_FRAME_BUFFER_BARRIER();
+
+        memcpy(channelData, frameBuffer->channelData[frame & 1], channelCount * sizeof(uint16_t));
+        frameStatus = frameBuffer->frameStatus[frame & 1];
+
+        RX_FRAME_BUFFER_BARRIER();
+        // the half just copied is only rewritten once the frame after next has begun
+    } while (frameBuffer->sequence - (start & ~1) >= 3);
+
+    *lastFrame = frame;
+
+    return frameStatus;
+}
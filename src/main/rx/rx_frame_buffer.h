@@ -0,0 +1,41 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "rx/rx.h"
+
+/*
+ * Channel values decoded by a receive interrupt when a frame completes, and collected by the RX task.
+ *
+ * The interrupt always writes the half the task is not reading, so it never waits. The task retries
+ * the copy if the interrupt overtook it, which needs two more frames to arrive during the copy.
+ */
+typedef struct rxFrameBuffer_s {
+    volatile uint32_t sequence; // twice the number of published frames, plus one while a frame is being written
+    uint8_t frameStatus[2];
+    uint16_t channelData[2][MAX_SUPPORTED_RC_CHANNEL_COUNT];
+} rxFrameBuffer_t;
+
+uint16_t *rxFrameBufferWriteBegin(rxFrameBuffer_t *frameBuffer);
+void rxFrameBufferWriteEnd(rxFrameBuffer_t *frameBuffer, uint8_t frameStatus);
+uint8_t rxFrameBufferRead(const rxFrameBuffer_t *frameBuffer, uint16_t *channelData, uint8_t channelCount, uint32_t *lastFrame);
@@ -0,0 +1,98 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_RX_LATENCY_STATISTICS
+
+#include "rx/rx.h"
+
+#include "rx_latency.h"
+
+static rxLatencyStats_t rxLatency;
+
+static timeUs_t lastFrameTimeUs = 0;
+static timeUs_t pendingFrameTimeUs = 0;
+
+void rxLatencyReset(void)
+{
+    memset(&rxLatency, 0, sizeof(rxLatency));
+}
+
+// Called when rcCommand has been recomputed, latches the receive time of a frame not seen before
+void rxLatencyRcCommandUpdated(void)
+{
+    const timeUs_t frameTimeUs = rxFrameTimeUs();
+    if (frameTimeUs && frameTimeUs != lastFrameTimeUs) {
+        lastFrameTimeUs = frameTimeUs;
+        pendingFrameTimeUs = frameTimeUs;
+    }
+}
+
+// Called once the motor outputs have been written, so the latency includes the whole PID loop
+void rxLatencyMotorsUpdated(timeUs_t currentTimeUs)
+{
+    if (!pendingFrameTimeUs) {
+        return;
+    }
+
+    const timeDelta_t latencyUs = cmpTimeUs(currentTimeUs, pendingFrameTimeUs);
+    pendingFrameTimeUs = 0;
+    if (latencyUs < 0) {
+        return;
+    }
+
+    if (rxLatency.count == 0) {
+        rxLatency.minUs = latencyUs;
+    }
+    rxLatency.count++;
+    rxLatency.lastUs = latencyUs;
+    rxLatency.totalUs += latencyUs;
+    if (latencyUs < rxLatency.minUs) {
+        rxLatency.minUs = latencyUs;
+    }
+    if (latencyUs > rxLatency.maxUs) {
+        rxLatency.maxUs = latencyUs;
+    }
+
+    int bucket = latencyUs / RX_LATENCY_HISTOGRAM_BUCKET_US;
+    if (bucket >= RX_LATENCY_HISTOGRAM_BUCKET_COUNT) {
+        bucket = RX_LATENCY_HISTOGRAM_BUCKET_COUNT - 1;
+    }
+    if (rxLatency.histogram[bucket] < UINT16_MAX) {
+        rxLatency.histogram[bucket]++;
+    }
+}
+
+const rxLatencyStats_t *rxLatencyStats(void)
+{
+    return &rxLatency;
+}
+
+timeDelta_t rxLatencyAverageUs(void)
+{
+    return rxLatency.count ? rxLatency.totalUs / rxLatency.count : 0;
+}
+
+#endif
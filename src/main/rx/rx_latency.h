@@ -0,0 +1,44 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/time.h"
+
+#define RX_LATENCY_HISTOGRAM_BUCKET_COUNT   16
+#define RX_LATENCY_HISTOGRAM_BUCKET_US      500 // the last bucket collects everything above
+
+// Time from the end of a receiver frame to the first motor update computed from it
+typedef struct rxLatencyStats_s {
+    uint32_t count;
+    timeDelta_t lastUs;
+    timeDelta_t minUs;
+    timeDelta_t maxUs;
+    uint64_t totalUs;
+    uint16_t histogram[RX_LATENCY_HISTOGRAM_BUCKET_COUNT];
+} rxLatencyStats_t;
+
+void rxLatencyReset(void);
+void rxLatencyRcCommandUpdated(void);
+void rxLatencyMotorsUpdated(timeUs_t currentTimeUs);
+const rxLatencyStats_t *rxLatencyStats(void);
+timeDelta_t rxLatencyAverageUs(void);
@@ -41,9 +41,12 @@
 #include "pg/rx.h"
 
 #include "rx/rx.h"
+#include "rx/rx_frame_buffer.h"
 #include "rx/sbus.h"
 #include "rx/sbus_channels.h"
 
+#include "scheduler/scheduler.h"
+
 /*
  * Observations
  *
@@ -101,12 +104,36 @@ typedef union sbusFrame_u {
 
 typedef struct sbusFrameData_s {
     sbusFrame_t frame;
+    rxFrameBuffer_t frameBuffer;
+    uint32_t lastFrame;
     uint32_t startAtUs;
     uint16_t stateFlags;
     uint8_t position;
-    bool done;
 } sbusFrameData_t;
 
+static volatile timeUs_t sbusFrameTimeUs = 0;
+
+// Unpacks the channels as soon as the frame is complete, so the RX task only has to copy them
+static void sbusFrameDecode(sbusFrameData_t *sbusFrameData)
+{
+    const sbusChannels_t *channels = &sbusFrameData->frame.frame.channels;
+
+    DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_FLAGS, channels->flags);
+
+    if (channels->flags & SBUS_FLAG_SIGNAL_LOSS) {
+        sbusFrameData->stateFlags |= SBUS_STATE_SIGNALLOSS;
+    }
+    if (channels->flags & SBUS_FLAG_FAILSAFE_ACTIVE) {
+        sbusFrameData->stateFlags |= SBUS_STATE_FAILSAFE;
+    }
+
+    DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_STATE_FLAGS, sbusFrameData->stateFlags);
+
+    uint16_t *channelData = rxFrameBufferWriteBegin(&sbusFrameData->frameBuffer);
+    const uint8_t frameStatus = sbusChannelsDecode(channelData, channels);
+    rxFrameBufferWriteEnd(&sbusFrameData->frameBuffer, frameStatus);
+}
+
 
 // Receive ISR callback
 static void sbusDataReceive(uint16_t c, void *data)
@@ -130,10 +157,10 @@ static void sbusDataReceive(uint16_t c, void *data)
 
     if (sbusFrameData->position < SBUS_FRAME_SIZE) {
         sbusFrameData->frame.bytes[sbusFrameData->position++] = (uint8_t)c;
-        if (sbusFrameData->position < SBUS_FRAME_SIZE) {
-            sbusFrameData->done = false;
-        } else {
-            sbusFrameData->done = true;
+        if (sbusFrameData->position == SBUS_FRAME_SIZE) {
+            sbusFrameTimeUs = nowUs;
+            sbusFrameDecode(sbusFrameData);
+            schedulerSignalTask(TASK_RX);
             DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_TIME, sbusFrameTime);
         }
     }
@@ -142,25 +169,13 @@ static void sbusDataReceive(uint16_t c, void *data)
 static uint8_t sbusFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 {
     sbusFrameData_t *sbusFrameData = rxRuntimeConfig->frameData;
-    if (!sbusFrameData->done) {
-        return RX_FRAME_PENDING;
-    }
-    sbusFrameData->done = false;
-
-    DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_FLAGS, sbusFrameData->frame.frame.channels.flags);
-
-    if (sbusFrameData->frame.frame.channels.flags & SBUS_FLAG_SIGNAL_LOSS) {
-        sbusFrameData->stateFlags |= SBUS_STATE_SIGNALLOSS;
-        DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_STATE_FLAGS, sbusFrameData->stateFlags);
-    }
-    if (sbusFrameData->frame.frame.channels.flags & SBUS_FLAG_FAILSAFE_ACTIVE) {
-        sbusFrameData->stateFlags |= SBUS_STATE_FAILSAFE;
-        DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_STATE_FLAGS, sbusFrameData->stateFlags);
-    }
 
-    DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_STATE_FLAGS, sbusFrameData->stateFlags);
+    return rxFrameBufferRead(&sbusFrameData->frameBuffer, rxRuntimeConfig->channelData, SBUS_MAX_CHANNEL, &sbusFrameData->lastFrame);
+}
 
-    return sbusChannelsDecode(rxRuntimeConfig, &sbusFrameData->frame.frame.channels);
+static timeUs_t sbusFrameTimeUsFn(void)
+{
+    return sbusFrameTimeUs;
 }
 
 bool sbusInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
@@ -176,6 +191,8 @@ bool sbusInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
     rxRuntimeConfig->rxRefreshRate = 11000;
 
     rxRuntimeConfig->rcFrameStatusFn = sbusFrameStatus;
+    rxRuntimeConfig->rcFrameTimeUsFn = sbusFrameTimeUsFn;
+    rxRuntimeConfig->rcFrameSignalled = true;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
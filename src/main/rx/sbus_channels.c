@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -41,25 +42,35 @@
 #define SBUS_DIGITAL_CHANNEL_MIN 173
 #define SBUS_DIGITAL_CHANNEL_MAX 1812
 
-uint8_t sbusChannelsDecode(rxRuntimeConfig_t *rxRuntimeConfig, const sbusChannels_t *channels)
+// Unpacks the 16 channels of 11 bits shared by SBUS, FPort and CRSF, least significant bit first.
+// Each group of 8 channels fills 11 bytes, which are read as two 32 bit words and the 3 remaining bytes,
+// so every channel is one or two shifts instead of the byte by byte extraction of a packed bitfield.
+// Assumes a little endian target, as the bitfield layout did.
+void sbusChannelsUnpack(uint16_t *channelData, const uint8_t *packed)
 {
-    uint16_t *sbusChannelData = rxRuntimeConfig->channelData;
-    sbusChannelData[0] = channels->chan0;
-    sbusChannelData[1] = channels->chan1;
-    sbusChannelData[2] = channels->chan2;
-    sbusChannelData[3] = channels->chan3;
-    sbusChannelData[4] = channels->chan4;
-    sbusChannelData[5] = channels->chan5;
-    sbusChannelData[6] = channels->chan6;
-    sbusChannelData[7] = channels->chan7;
-    sbusChannelData[8] = channels->chan8;
-    sbusChannelData[9] = channels->chan9;
-    sbusChannelData[10] = channels->chan10;
-    sbusChannelData[11] = channels->chan11;
-    sbusChannelData[12] = channels->chan12;
-    sbusChannelData[13] = channels->chan13;
-    sbusChannelData[14] = channels->chan14;
-    sbusChannelData[15] = channels->chan15;
+    for (int group = 0; group < SBUS_PACKED_CHANNEL_COUNT / 8; group++) {
+        uint32_t w0, w1;
+        memcpy(&w0, packed, sizeof(w0));
+        memcpy(&w1, packed + 4, sizeof(w1));
+        const uint32_t w2 = packed[8] | (packed[9] << 8) | (packed[10] << 16);
+
+        channelData[0] = w0 & 0x7ff;
+        channelData[1] = (w0 >> 11) & 0x7ff;
+        channelData[2] = ((w0 >> 22) | (w1 << 10)) & 0x7ff;
+        channelData[3] = (w1 >> 1) & 0x7ff;
+        channelData[4] = (w1 >> 12) & 0x7ff;
+        channelData[5] = ((w1 >> 23) | (w2 << 9)) & 0x7ff;
+        channelData[6] = (w2 >> 2) & 0x7ff;
+        channelData[7] = (w2 >> 13) & 0x7ff;
+
+        channelData += 8;
+        packed += 11;
+    }
+}
+
+uint8_t sbusChannelsDecode(uint16_t *sbusChannelData, const sbusChannels_t *channels)
+{
+    sbusChannelsUnpack(sbusChannelData, channels->packed);
 
     if (channels->flags & SBUS_FLAG_CHANNEL_17) {
         sbusChannelData[16] = SBUS_DIGITAL_CHANNEL_MAX;
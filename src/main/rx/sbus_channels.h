@@ -27,30 +27,18 @@
 #define SBUS_FLAG_SIGNAL_LOSS       (1 << 2)
 #define SBUS_FLAG_FAILSAFE_ACTIVE   (1 << 3)
 
+#define SBUS_PACKED_CHANNEL_COUNT   16
+#define SBUS_PACKED_CHANNELS_LENGTH 22 // 11 bits per channel * 16 channels = 176 bits
+
 typedef struct sbusChannels_s {
-    // 176 bits of data (11 bits per channel * 16 channels) = 22 bytes.
-    unsigned int chan0 : 11;
-    unsigned int chan1 : 11;
-    unsigned int chan2 : 11;
-    unsigned int chan3 : 11;
-    unsigned int chan4 : 11;
-    unsigned int chan5 : 11;
-    unsigned int chan6 : 11;
-    unsigned int chan7 : 11;
-    unsigned int chan8 : 11;
-    unsigned int chan9 : 11;
-    unsigned int chan10 : 11;
-    unsigned int chan11 : 11;
-    unsigned int chan12 : 11;
-    unsigned int chan13 : 11;
-    unsigned int chan14 : 11;
-    unsigned int chan15 : 11;
+    uint8_t packed[SBUS_PACKED_CHANNELS_LENGTH];
     uint8_t flags;
 } __attribute__((__packed__)) sbusChannels_t;
 
 #define SBUS_CHANNEL_DATA_LENGTH sizeof(sbusChannels_t)
 
-uint8_t sbusChannelsDecode(rxRuntimeConfig_t *rxRuntimeConfig, const sbusChannels_t *channels);
+void sbusChannelsUnpack(uint16_t *channelData, const uint8_t *packed);
+uint8_t sbusChannelsDecode(uint16_t *sbusChannelData, const sbusChannels_t *channels);
 
 void sbusChannelsInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig);
 
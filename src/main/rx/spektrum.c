@@ -60,6 +60,7 @@ uint8_t rssi_channel;
 static uint8_t spek_chan_shift;
 static uint8_t spek_chan_mask;
 static bool rcFrameComplete = false;
+static volatile timeUs_t spekFrameTimeUs = 0;
 static bool spekHiRes = false;
 
 static volatile uint8_t spekFrame[SPEK_FRAME_SIZE];
@@ -97,6 +98,7 @@ static void spektrumDataReceive(uint16_t c, void *data)
         if (spekFramePosition < SPEK_FRAME_SIZE) {
             rcFrameComplete = false;
         } else {
+            spekFrameTimeUs = spekTime;
             rcFrameComplete = true;
         }
     }
@@ -105,6 +107,11 @@ static void spektrumDataReceive(uint16_t c, void *data)
 
 uint32_t spekChannelData[SPEKTRUM_MAX_SUPPORTED_CHANNEL_COUNT];
 
+static timeUs_t spektrumFrameTimeUsFn(void)
+{
+    return spekFrameTimeUs;
+}
+
 static uint8_t spektrumFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 {
     UNUSED(rxRuntimeConfig);
@@ -347,6 +354,7 @@ bool spektrumInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig
 
     rxRuntimeConfig->rcReadRawFn = spektrumReadRawRC;
     rxRuntimeConfig->rcFrameStatusFn = spektrumFrameStatus;
+    rxRuntimeConfig->rcFrameTimeUsFn = spektrumFrameTimeUsFn;
 
     serialPort = openSerialPort(portConfig->identifier,
         FUNCTION_RX_SERIAL,
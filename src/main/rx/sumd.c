@@ -53,6 +53,7 @@
 #define SUMD_BAUDRATE 115200
 
 static bool sumdFrameDone = false;
+static volatile timeUs_t sumdFrameTimeUs = 0;
 static uint16_t sumdChannels[SUMD_MAX_CHANNEL];
 static uint16_t crc;
 
@@ -82,8 +83,14 @@ static void sumdDataReceive(uint16_t c, void *data)
             crc = 0;
         }
     }
-    if (sumdIndex == 2)
+    if (sumdIndex == 2) {
+        if (c > SUMD_MAX_CHANNEL) {
+            // the frame would not fit the buffer the CRC is read from, wait for the next one
+            sumdIndex = 0;
+            return;
+        }
         sumdChannelCount = (uint8_t)c;
+    }
     if (sumdIndex < SUMD_BUFFSIZE)
         sumd[sumdIndex] = (uint8_t)c;
     sumdIndex++;
@@ -92,6 +99,7 @@ static void sumdDataReceive(uint16_t c, void *data)
     else
         if (sumdIndex == sumdChannelCount * 2 + 5) {
             sumdIndex = 0;
+            sumdFrameTimeUs = sumdTime;
             sumdFrameDone = true;
         }
 }
@@ -104,6 +112,11 @@ static void sumdDataReceive(uint16_t c, void *data)
 #define SUMD_FRAME_STATE_OK 0x01
 #define SUMD_FRAME_STATE_FAILSAFE 0x81
 
+static timeUs_t sumdFrameTimeUsFn(void)
+{
+    return sumdFrameTimeUs;
+}
+
 static uint8_t sumdFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 {
     UNUSED(rxRuntimeConfig);
@@ -161,6 +174,7 @@ bool sumdInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
 
     rxRuntimeConfig->rcReadRawFn = sumdReadRawRC;
     rxRuntimeConfig->rcFrameStatusFn = sumdFrameStatus;
+    rxRuntimeConfig->rcFrameTimeUsFn = sumdFrameTimeUsFn;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
@@ -28,6 +28,7 @@
 
 #include "build/build_config.h"
 #include "build/debug.h"
+#include "build/trace.h"
 
 #include "scheduler/scheduler.h"
 
@@ -46,6 +47,10 @@
 // 3 - time spent executing check function
 
 static FAST_RAM_ZERO_INIT cfTask_t *currentTask = NULL;
+static FAST_RAM_ZERO_INIT cfTask_t *interruptDrivenTask = NULL;
+
+static FAST_RAM_ZERO_INIT bool realtimeTaskPending;
+static FAST_RAM_ZERO_INIT timeUs_t realtimeTaskDueAt;    // when the next realtime task is due
 
 static FAST_RAM_ZERO_INIT uint32_t totalWaitingTasks;
 static FAST_RAM_ZERO_INIT uint32_t totalWaitingTasksSamples;
@@ -61,11 +66,142 @@ STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT int taskQueueSize = 0;
 
 STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT cfTask_t* taskQueueArray[TASK_COUNT + 1]; // extra item for NULL pointer at end of queue
 
+#ifdef USE_SCHEDULER_DEADLINE_QUEUE
+// Time-driven tasks are additionally kept in a binary min-heap ordered on their next
+// deadline (lastExecutedAt + desiredPeriod), so scheduler() only visits tasks that are due.
+// Event-driven tasks are kept in their own list, with a bitmask of the tasks that have been
+// signalled and are waiting to be executed. The checkFunc is only polled for tasks that
+// have not been signalled yet.
+#define EVENT_TASK_COUNT_MAX 32
+
+typedef struct {
+    timeUs_t deadline;
+    cfTask_t *task;
+} taskHeapEntry_t;
+
+STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT taskHeapEntry_t taskHeap[TASK_COUNT];
+STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT int taskHeapSize;
+
+STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT cfTask_t *eventTaskArray[EVENT_TASK_COUNT_MAX];
+STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT int eventTaskCount;
+STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT uint32_t eventTaskSignalledMask;
+
+// index of each task in either taskHeap or eventTaskArray
+static FAST_RAM_ZERO_INIT int8_t taskSlot[TASK_COUNT];
+
+static FAST_CODE bool deadlineBefore(timeUs_t a, timeUs_t b)
+{
+    return (timeDelta_t)(a - b) < 0;
+}
+
+static FAST_CODE void taskHeapSet(int index, taskHeapEntry_t entry)
+{
+    taskHeap[index] = entry;
+    taskSlot[entry.task - cfTasks] = index;
+}
+
+static FAST_CODE void taskHeapSiftUp(int index)
+{
+    const taskHeapEntry_t entry = taskHeap[index];
+    while (index > 0) {
+        const int parent = (index - 1) / 2;
+        if (!deadlineBefore(entry.deadline, taskHeap[parent].deadline)) {
+            break;
+        }
+        taskHeapSet(index, taskHeap[parent]);
+        index = parent;
+    }
+    taskHeapSet(index, entry);
+}
+
+static FAST_CODE void taskHeapSiftDown(int index)
+{
+    const taskHeapEntry_t entry = taskHeap[index];
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= taskHeapSize) {
+            break;
+        }
+        if (child + 1 < taskHeapSize && deadlineBefore(taskHeap[child + 1].deadline, taskHeap[child].deadline)) {
+            ++child;
+        }
+        if (!deadlineBefore(taskHeap[child].deadline, entry.deadline)) {
+            break;
+        }
+        taskHeapSet(index, taskHeap[child]);
+        index = child;
+    }
+    taskHeapSet(index, entry);
+}
+
+/*
+ * Recalculates the deadline of a time-driven task after lastExecutedAt or desiredPeriod changed
+ */
+static FAST_CODE void taskHeapUpdate(cfTask_t *task)
+{
+    const int index = taskSlot[task - cfTasks];
+    taskHeap[index].deadline = task->lastExecutedAt + task->desiredPeriod;
+    taskHeapSiftUp(index);
+    taskHeapSiftDown(taskSlot[task - cfTasks]);
+}
+
+static void readyQueueAdd(cfTask_t *task)
+{
+    if (task->checkFunc) {
+        eventTaskArray[eventTaskCount] = task;
+        taskSlot[task - cfTasks] = eventTaskCount;
+        eventTaskSignalledMask &= ~(1U << eventTaskCount);
+        ++eventTaskCount;
+    } else {
+        const taskHeapEntry_t entry = { .deadline = task->lastExecutedAt + task->desiredPeriod, .task = task };
+        taskHeap[taskHeapSize] = entry;
+        taskSlot[task - cfTasks] = taskHeapSize;
+        ++taskHeapSize;
+        taskHeapSiftUp(taskHeapSize - 1);
+    }
+}
+
+static void readyQueueRemove(cfTask_t *task)
+{
+    const int index = taskSlot[task - cfTasks];
+    if (task->checkFunc) {
+        if (index < eventTaskCount && eventTaskArray[index] == task) {
+            // move the last event task into the freed slot, keeping its signalled state
+            --eventTaskCount;
+            const uint32_t lastSignalled = eventTaskSignalledMask & (1U << eventTaskCount);
+            eventTaskSignalledMask &= ~((1U << index) | (1U << eventTaskCount));
+            if (index != eventTaskCount) {
+                eventTaskArray[index] = eventTaskArray[eventTaskCount];
+                taskSlot[eventTaskArray[index] - cfTasks] = index;
+                if (lastSignalled) {
+                    eventTaskSignalledMask |= 1U << index;
+                }
+            }
+            eventTaskArray[eventTaskCount] = NULL;
+        }
+    } else if (index < taskHeapSize && taskHeap[index].task == task) {
+        --taskHeapSize;
+        if (index != taskHeapSize) {
+            taskHeapSet(index, taskHeap[taskHeapSize]);
+            taskHeapSiftUp(index);
+            taskHeapSiftDown(taskSlot[taskHeap[index].task - cfTasks]);
+        }
+    }
+}
+#endif // USE_SCHEDULER_DEADLINE_QUEUE
+
 void queueClear(void)
 {
     memset(taskQueueArray, 0, sizeof(taskQueueArray));
     taskQueuePos = 0;
     taskQueueSize = 0;
+#ifdef USE_SCHEDULER_DEADLINE_QUEUE
+    memset(taskHeap, 0, sizeof(taskHeap));
+    taskHeapSize = 0;
+    memset(eventTaskArray, 0, sizeof(eventTaskArray));
+    eventTaskCount = 0;
+    eventTaskSignalledMask = 0;
+#endif
 }
 
 bool queueContains(cfTask_t *task)
@@ -83,11 +219,19 @@ bool queueAdd(cfTask_t *task)
     if ((taskQueueSize >= TASK_COUNT) || queueContains(task)) {
         return false;
     }
+#ifdef USE_SCHEDULER_DEADLINE_QUEUE
+    if (task->checkFunc && eventTaskCount >= EVENT_TASK_COUNT_MAX) {
+        return false;
+    }
+#endif
     for (int ii = 0; ii <= taskQueueSize; ++ii) {
         if (taskQueueArray[ii] == NULL || taskQueueArray[ii]->staticPriority < task->staticPriority) {
             memmove(&taskQueueArray[ii+1], &taskQueueArray[ii], sizeof(task) * (taskQueueSize - ii));
             taskQueueArray[ii] = task;
             ++taskQueueSize;
+#ifdef USE_SCHEDULER_DEADLINE_QUEUE
+            readyQueueAdd(task);
+#endif
             return true;
         }
     }
@@ -100,6 +244,9 @@ bool queueRemove(cfTask_t *task)
         if (taskQueueArray[ii] == task) {
             memmove(&taskQueueArray[ii], &taskQueueArray[ii+1], sizeof(task) * (taskQueueSize - ii));
             --taskQueueSize;
+#ifdef USE_SCHEDULER_DEADLINE_QUEUE
+            readyQueueRemove(task);
+#endif
             return true;
         }
     }
@@ -155,24 +302,47 @@ void getTaskInfo(cfTaskId_e taskId, cfTaskInfo_t * taskInfo)
 {
     taskInfo->taskName = cfTasks[taskId].taskName;
     taskInfo->subTaskName = cfTasks[taskId].subTaskName;
-    taskInfo->isEnabled = queueContains(&cfTasks[taskId]);
+    taskInfo->isEnabled = queueContains(&cfTasks[taskId]) || interruptDrivenTask == &cfTasks[taskId];
     taskInfo->desiredPeriod = cfTasks[taskId].desiredPeriod;
     taskInfo->staticPriority = cfTasks[taskId].staticPriority;
     taskInfo->maxExecutionTime = cfTasks[taskId].maxExecutionTime;
     taskInfo->totalExecutionTime = cfTasks[taskId].totalExecutionTime;
     taskInfo->averageExecutionTime = cfTasks[taskId].movingSumExecutionTime / MOVING_SUM_COUNT;
     taskInfo->latestDeltaTime = cfTasks[taskId].taskLatestDeltaTime;
+#ifdef USE_TASK_STATISTICS_HISTOGRAM
+    taskInfo->lateCount = cfTasks[taskId].lateCount;
+    memcpy(taskInfo->executionTimeHistogram, cfTasks[taskId].executionTimeHistogram, sizeof(taskInfo->executionTimeHistogram));
+#endif
 }
 #endif
 
 void rescheduleTask(cfTaskId_e taskId, uint32_t newPeriodMicros)
 {
-    if (taskId == TASK_SELF) {
-        cfTask_t *task = currentTask;
+    if (taskId == TASK_SELF || taskId < TASK_COUNT) {
+        cfTask_t *task = taskId == TASK_SELF ? currentTask : &cfTasks[taskId];
         task->desiredPeriod = MAX(SCHEDULER_DELAY_LIMIT, (timeDelta_t)newPeriodMicros);  // Limit delay to 100us (10 kHz) to prevent scheduler clogging
-    } else if (taskId < TASK_COUNT) {
+#ifdef USE_SCHEDULER_DEADLINE_QUEUE
+        if (!task->checkFunc && queueContains(task)) {
+            taskHeapUpdate(task);
+        }
+#endif
+    }
+}
+
+// Moves the next run of a time-driven task to dueAtUs, the runs after it keep the period of the task
+void schedulerAlignTask(cfTaskId_e taskId, timeUs_t dueAtUs)
+{
+    if (taskId < TASK_COUNT) {
         cfTask_t *task = &cfTasks[taskId];
-        task->desiredPeriod = MAX(SCHEDULER_DELAY_LIMIT, (timeDelta_t)newPeriodMicros);  // Limit delay to 100us (10 kHz) to prevent scheduler clogging
+        if (task->checkFunc || task == interruptDrivenTask) {
+            return;
+        }
+        task->lastExecutedAt = dueAtUs - task->desiredPeriod;
+#ifdef USE_SCHEDULER_DEADLINE_QUEUE
+        if (queueContains(task)) {
+            taskHeapUpdate(task);
+        }
+#endif
     }
 }
 
@@ -209,14 +379,15 @@ void schedulerResetTaskStatistics(cfTaskId_e taskId)
 #ifdef SKIP_TASK_STATISTICS
     UNUSED(taskId);
 #else
-    if (taskId == TASK_SELF) {
-        currentTask->movingSumExecutionTime = 0;
-        currentTask->totalExecutionTime = 0;
-        currentTask->maxExecutionTime = 0;
-    } else if (taskId < TASK_COUNT) {
-        cfTasks[taskId].movingSumExecutionTime = 0;
-        cfTasks[taskId].totalExecutionTime = 0;
-        cfTasks[taskId].maxExecutionTime = 0;
+    if (taskId == TASK_SELF || taskId < TASK_COUNT) {
+        cfTask_t *task = taskId == TASK_SELF ? currentTask : &cfTasks[taskId];
+        task->movingSumExecutionTime = 0;
+        task->totalExecutionTime = 0;
+        task->maxExecutionTime = 0;
+#ifdef USE_TASK_STATISTICS_HISTOGRAM
+        task->lateCount = 0;
+        memset(task->executionTimeHistogram, 0, sizeof(task->executionTimeHistogram));
+#endif
     }
 #endif
 }
@@ -234,9 +405,197 @@ void schedulerResetTaskMaxExecutionTime(cfTaskId_e taskId)
 #endif
 }
 
+#ifndef SKIP_TASK_STATISTICS
+static FAST_CODE void taskUpdateStatistics(cfTask_t *task, timeUs_t taskExecutionTime)
+{
+    task->movingSumExecutionTime += taskExecutionTime - task->movingSumExecutionTime / MOVING_SUM_COUNT;
+    task->totalExecutionTime += taskExecutionTime;   // time consumed by scheduler + task
+    task->maxExecutionTime = MAX(task->maxExecutionTime, taskExecutionTime);
+#ifdef USE_TASK_STATISTICS_HISTOGRAM
+    const int bucket = taskExecutionTime < 2 ? 0 : MIN(31 - __builtin_clz(taskExecutionTime), TASK_HISTOGRAM_BUCKET_COUNT - 1);
+    if (task->executionTimeHistogram[bucket] < UINT16_MAX) {
+        task->executionTimeHistogram[bucket]++;
+    }
+#endif
+}
+#endif
+
+#ifdef USE_TASK_STATISTICS_HISTOGRAM
+static FAST_CODE void taskCheckLate(cfTask_t *task)
+{
+    // event-driven tasks have no deadline, their desiredPeriod only limits how long they may starve
+    if (!task->checkFunc && task->taskLatestDeltaTime > 2 * task->desiredPeriod) {
+        task->lateCount++;
+    }
+}
+#endif
+
+/*
+ * Calls the checkFunc of an event driven task, returns true if the task has been signalled
+ */
+static FAST_CODE bool taskCheckEvent(cfTask_t *task, timeUs_t currentTimeUs)
+{
+    if (task->checkFuncPollPeriod) {
+        // only poll after a signal, or when the fallback period has expired
+        if (task->signalPending) {
+            task->signalPending = false;
+        } else if (cmpTimeUs(currentTimeUs, task->lastCheckedAt) < task->checkFuncPollPeriod) {
+            return false;
+        }
+        task->lastCheckedAt = currentTimeUs;
+    }
+
+#if defined(SCHEDULER_DEBUG)
+    const timeUs_t currentTimeBeforeCheckFuncCall = micros();
+#else
+    const timeUs_t currentTimeBeforeCheckFuncCall = currentTimeUs;
+#endif
+    if (!task->checkFunc(currentTimeBeforeCheckFuncCall, currentTimeBeforeCheckFuncCall - task->lastExecutedAt)) {
+        return false;
+    }
+#if defined(SCHEDULER_DEBUG)
+    DEBUG_SET(DEBUG_SCHEDULER, 3, micros() - currentTimeBeforeCheckFuncCall);
+#endif
+#ifndef SKIP_TASK_STATISTICS
+    if (calculateTaskStatistics) {
+        const uint32_t checkFuncExecutionTime = micros() - currentTimeBeforeCheckFuncCall;
+        checkFuncMovingSumExecutionTime += checkFuncExecutionTime - checkFuncMovingSumExecutionTime / MOVING_SUM_COUNT;
+        checkFuncTotalExecutionTime += checkFuncExecutionTime;   // time consumed by scheduler + task
+        checkFuncMaxExecutionTime = MAX(checkFuncMaxExecutionTime, checkFuncExecutionTime);
+    }
+#endif
+    task->lastSignaledAt = currentTimeBeforeCheckFuncCall;
+    task->taskAgeCycles = 1;
+    task->dynamicPriority = 1 + task->staticPriority;
+    return true;
+}
+
+#ifdef USE_SCHEDULER_DEADLINE_QUEUE
+/*
+ * Tasks are not visited in queue order, so ties in dynamicPriority are broken on staticPriority
+ * to select the same task as the linear scan of the priority ordered queue would
+ */
+static FAST_CODE bool taskPreferredForScheduling(const cfTask_t *task, const cfTask_t *selectedTask, uint16_t selectedTaskDynamicPriority, bool outsideRealtimeGuardInterval)
+{
+    if (task->dynamicPriority < selectedTaskDynamicPriority) {
+        return false;
+    }
+    if (task->dynamicPriority == selectedTaskDynamicPriority && (!selectedTask || task->staticPriority <= selectedTask->staticPriority)) {
+        return false;
+    }
+    return (outsideRealtimeGuardInterval) ||
+        (task->taskAgeCycles > 1) ||
+        (task->staticPriority == TASK_PRIORITY_REALTIME);
+}
+#endif
+
+/*
+ * Lets an event driven task be signalled with schedulerSignalTask() instead of having its checkFunc polled on every
+ * scheduler pass. The checkFunc is then called after a signal, or when pollPeriodUs has passed without one.
+ * A pollPeriodUs of 0 restores polling on every pass.
+ */
+void schedulerSetTaskSignalled(cfTaskId_e taskId, timeDelta_t pollPeriodUs)
+{
+    if (taskId < TASK_COUNT) {
+        cfTasks[taskId].checkFuncPollPeriod = pollPeriodUs;
+        cfTasks[taskId].signalPending = true;
+    }
+}
+
+/*
+ * Marks an event driven task as having work to do, can be called from interrupt handlers
+ */
+FAST_CODE void schedulerSignalTask(cfTaskId_e taskId)
+{
+    if (taskId < TASK_COUNT) {
+        cfTasks[taskId].signalPending = true;
+    }
+}
+
+/*
+ * Returns the time the current task can still run before a realtime task is due, negative if one is overdue.
+ * Long running tasks should check this and return early, continuing where they left off on their next invocation.
+ */
+timeDelta_t schedulerGetTimeRemaining(void)
+{
+    if (!realtimeTaskPending) {
+        return SCHEDULER_TIME_REMAINING_UNLIMITED;
+    }
+    return cmpTimeUs(realtimeTaskDueAt, micros());
+}
+
+bool schedulerTaskShouldYield(timeDelta_t requiredTimeUs)
+{
+    return schedulerGetTimeRemaining() < requiredTimeUs;
+}
+
+/*
+ * Returns the time until the next time driven task is due, 0 if a task is already waiting to be run.
+ * Lets a host build sleep between scheduler passes instead of spinning, event driven tasks that are
+ * polled must still be checked often enough by the caller.
+ */
+timeDelta_t schedulerGetTimeUntilNextTask(void)
+{
+    const timeUs_t currentTimeUs = micros();
+    timeDelta_t timeUntilNextTask = SCHEDULER_TIME_REMAINING_UNLIMITED;
+    for (const cfTask_t *task = queueFirst(); task != NULL; task = queueNext()) {
+        if (task->checkFunc) {
+            if (task->dynamicPriority > 0) {
+                return 0;
+            }
+        } else {
+            timeUntilNextTask = MIN(timeUntilNextTask, cmpTimeUs(task->lastExecutedAt + task->desiredPeriod, currentTimeUs));
+        }
+    }
+    return MAX(timeUntilNextTask, 0);
+}
+
+/*
+ * Removes a task from the task queue, it is run by calling schedulerExecuteInterruptDrivenTask() instead
+ */
+void schedulerSetInterruptDrivenTask(cfTaskId_e taskId)
+{
+    if (taskId < TASK_COUNT) {
+        queueRemove(&cfTasks[taskId]);
+        interruptDrivenTask = &cfTasks[taskId];
+    }
+}
+
+/*
+ * Runs the interrupt driven task outside of scheduler(), keeping its timing and statistics up to date
+ */
+FAST_CODE void schedulerExecuteInterruptDrivenTask(timeUs_t currentTimeUs)
+{
+    cfTask_t *task = interruptDrivenTask;
+    if (!task) {
+        return;
+    }
+
+    task->taskLatestDeltaTime = currentTimeUs - task->lastExecutedAt;
+    task->lastExecutedAt = currentTimeUs;
+#ifdef USE_TASK_STATISTICS_HISTOGRAM
+    taskCheckLate(task);
+#endif
+
+    TRACE_EVENT(TRACE_TASK_START, task - cfTasks, 0);
+#ifdef SKIP_TASK_STATISTICS
+    task->taskFunc(currentTimeUs);
+#else
+    if (calculateTaskStatistics) {
+        task->taskFunc(currentTimeUs);
+        taskUpdateStatistics(task, micros() - currentTimeUs);
+    } else {
+        task->taskFunc(currentTimeUs);
+    }
+#endif
+    TRACE_EVENT(TRACE_TASK_END, task - cfTasks, 0);
+}
+
 void schedulerInit(void)
 {
     calculateTaskStatistics = true;
+    interruptDrivenTask = NULL;
+    realtimeTaskPending = false;
     queueClear();
     queueAdd(&cfTasks[TASK_SYSTEM]);
 }
@@ -248,11 +607,15 @@ FAST_CODE void scheduler(void)
 
     // Check for realtime tasks
     bool outsideRealtimeGuardInterval = true;
+    realtimeTaskPending = false;
     for (const cfTask_t *task = queueFirst(); task != NULL && task->staticPriority >= TASK_PRIORITY_REALTIME; task = queueNext()) {
         const timeUs_t nextExecuteAt = task->lastExecutedAt + task->desiredPeriod;
+        if (!realtimeTaskPending || cmpTimeUs(nextExecuteAt, realtimeTaskDueAt) < 0) {
+            realtimeTaskDueAt = nextExecuteAt;
+            realtimeTaskPending = true;
+        }
         if ((timeDelta_t)(currentTimeUs - nextExecuteAt) >= 0) {
             outsideRealtimeGuardInterval = false;
-            break;
         }
     }
 
@@ -262,34 +625,62 @@ FAST_CODE void scheduler(void)
 
     // Update task dynamic priorities
     uint16_t waitingTasks = 0;
+#ifdef USE_SCHEDULER_DEADLINE_QUEUE
+    // Event driven tasks, checkFunc is only polled until the task has been signalled
+    for (int slot = 0; slot < eventTaskCount; ++slot) {
+        cfTask_t *task = eventTaskArray[slot];
+        if (eventTaskSignalledMask & (1U << slot)) {
+            // Increase priority for event driven tasks
+            task->taskAgeCycles = 1 + ((currentTimeUs - task->lastSignaledAt) / task->desiredPeriod);
+            task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
+        } else if (taskCheckEvent(task, currentTimeUs)) {
+            eventTaskSignalledMask |= 1U << slot;
+        } else {
+            task->taskAgeCycles = 0;
+            continue;
+        }
+        waitingTasks++;
+        if (taskPreferredForScheduling(task, selectedTask, selectedTaskDynamicPriority, outsideRealtimeGuardInterval)) {
+            selectedTaskDynamicPriority = task->dynamicPriority;
+            selectedTask = task;
+        }
+    }
+
+    // Time driven tasks, only the part of the heap that is due needs to be visited
+    int8_t dueStack[TASK_COUNT];
+    int dueStackSize = 0;
+    if (taskHeapSize > 0 && !deadlineBefore(currentTimeUs, taskHeap[0].deadline)) {
+        dueStack[dueStackSize++] = 0;
+    }
+    while (dueStackSize > 0) {
+        const int index = dueStack[--dueStackSize];
+        cfTask_t *task = taskHeap[index].task;
+        // dynamicPriority is last execution age (measured in desiredPeriods)
+        task->taskAgeCycles = ((currentTimeUs - task->lastExecutedAt) / task->desiredPeriod);
+        if (task->taskAgeCycles > 0) {
+            task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
+            waitingTasks++;
+            if (taskPreferredForScheduling(task, selectedTask, selectedTaskDynamicPriority, outsideRealtimeGuardInterval)) {
+                selectedTaskDynamicPriority = task->dynamicPriority;
+                selectedTask = task;
+            }
+        }
+        for (int child = 2 * index + 1; child <= 2 * index + 2 && child < taskHeapSize; ++child) {
+            if (!deadlineBefore(currentTimeUs, taskHeap[child].deadline)) {
+                dueStack[dueStackSize++] = child;
+            }
+        }
+    }
+#else
     for (cfTask_t *task = queueFirst(); task != NULL; task = queueNext()) {
         // Task has checkFunc - event driven
         if (task->checkFunc) {
-#if defined(SCHEDULER_DEBUG)
-            const timeUs_t currentTimeBeforeCheckFuncCall = micros();
-#else
-            const timeUs_t currentTimeBeforeCheckFuncCall = currentTimeUs;
-#endif
             // Increase priority for event driven tasks
             if (task->dynamicPriority > 0) {
                 task->taskAgeCycles = 1 + ((currentTimeUs - task->lastSignaledAt) / task->desiredPeriod);
                 task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
                 waitingTasks++;
-            } else if (task->checkFunc(currentTimeBeforeCheckFuncCall, currentTimeBeforeCheckFuncCall - task->lastExecutedAt)) {
-#if defined(SCHEDULER_DEBUG)
-                DEBUG_SET(DEBUG_SCHEDULER, 3, micros() - currentTimeBeforeCheckFuncCall);
-#endif
-#ifndef SKIP_TASK_STATISTICS
-                if (calculateTaskStatistics) {
-                    const uint32_t checkFuncExecutionTime = micros() - currentTimeBeforeCheckFuncCall;
-                    checkFuncMovingSumExecutionTime += checkFuncExecutionTime - checkFuncMovingSumExecutionTime / MOVING_SUM_COUNT;
-                    checkFuncTotalExecutionTime += checkFuncExecutionTime;   // time consumed by scheduler + task
-                    checkFuncMaxExecutionTime = MAX(checkFuncMaxExecutionTime, checkFuncExecutionTime);
-                }
-#endif
-                task->lastSignaledAt = currentTimeBeforeCheckFuncCall;
-                task->taskAgeCycles = 1;
-                task->dynamicPriority = 1 + task->staticPriority;
+            } else if (taskCheckEvent(task, currentTimeUs)) {
                 waitingTasks++;
             } else {
                 task->taskAgeCycles = 0;
@@ -315,6 +706,7 @@ FAST_CODE void scheduler(void)
             }
         }
     }
+#endif
 
     totalWaitingTasksSamples++;
     totalWaitingTasks += waitingTasks;
@@ -326,8 +718,21 @@ FAST_CODE void scheduler(void)
         selectedTask->taskLatestDeltaTime = currentTimeUs - selectedTask->lastExecutedAt;
         selectedTask->lastExecutedAt = currentTimeUs;
         selectedTask->dynamicPriority = 0;
+#ifdef USE_TASK_STATISTICS_HISTOGRAM
+        taskCheckLate(selectedTask);
+#endif
+#ifdef USE_SCHEDULER_DEADLINE_QUEUE
+        // update the ready structures before running the task, since the task may disable or reschedule itself
+        if (selectedTask->checkFunc) {
+            eventTaskSignalledMask &= ~(1U << taskSlot[selectedTask - cfTasks]);
+        } else {
+            selectedTask->taskAgeCycles = 0;
+            taskHeapUpdate(selectedTask);
+        }
+#endif
 
         // Execute task
+        TRACE_EVENT(TRACE_TASK_START, selectedTask - cfTasks, 0);
 #ifdef SKIP_TASK_STATISTICS
         selectedTask->taskFunc(currentTimeUs);
 #else
@@ -335,14 +740,13 @@ FAST_CODE void scheduler(void)
             const timeUs_t currentTimeBeforeTaskCall = micros();
             selectedTask->taskFunc(currentTimeBeforeTaskCall);
             const timeUs_t taskExecutionTime = micros() - currentTimeBeforeTaskCall;
-            selectedTask->movingSumExecutionTime += taskExecutionTime - selectedTask->movingSumExecutionTime / MOVING_SUM_COUNT;
-            selectedTask->totalExecutionTime += taskExecutionTime;   // time consumed by scheduler + task
-            selectedTask->maxExecutionTime = MAX(selectedTask->maxExecutionTime, taskExecutionTime);
+            taskUpdateStatistics(selectedTask, taskExecutionTime);
         } else {
             selectedTask->taskFunc(currentTimeUs);
         }
 
 #endif
+        TRACE_EVENT(TRACE_TASK_END, selectedTask - cfTasks, 0);
 #if defined(SCHEDULER_DEBUG)
         DEBUG_SET(DEBUG_SCHEDULER, 2, micros() - currentTimeUs - taskExecutionTime); // time spent in scheduler
     } else {
@@ -26,6 +26,10 @@
 #define TASK_PERIOD_MS(ms) ((ms) * 1000)
 #define TASK_PERIOD_US(us) (us)
 
+#define SCHEDULER_TIME_REMAINING_UNLIMITED INT32_MAX
+
+#define TASK_HISTOGRAM_BUCKET_COUNT 12  // bucket n counts execution times of [2^n, 2^(n+1)) us, the last bucket everything above
+
 
 typedef enum {
     TASK_PRIORITY_IDLE = 0,     // Disables dynamic scheduling, task is executed only if no other task is active this cycle
@@ -53,6 +57,10 @@ typedef struct {
     timeUs_t     maxExecutionTime;
     timeUs_t     totalExecutionTime;
     timeUs_t     averageExecutionTime;
+#ifdef USE_TASK_STATISTICS_HISTOGRAM
+    uint32_t     lateCount;
+    uint16_t     executionTimeHistogram[TASK_HISTOGRAM_BUCKET_COUNT];
+#endif
 } cfTaskInfo_t;
 
 typedef enum {
@@ -64,6 +72,9 @@ typedef enum {
     TASK_ATTITUDE,
     TASK_RX,
     TASK_SERIAL,
+#ifdef USE_SERIAL_PASSTHROUGH
+    TASK_SERIAL_PASSTHROUGH,
+#endif
     TASK_DISPATCH,
     TASK_BATTERY_VOLTAGE,
     TASK_BATTERY_CURRENT,
@@ -113,6 +124,9 @@ typedef enum {
 #ifdef USE_ESC_SENSOR
     TASK_ESC_SENSOR,
 #endif
+#ifdef USE_ESC_STATS
+    TASK_ESC_STATS,
+#endif
 #ifdef USE_CMS
     TASK_CMS,
 #endif
@@ -135,6 +149,14 @@ typedef enum {
     TASK_PINIOBOX,
 #endif
 
+#ifdef USE_BLACKBOX_DEFERRED_ENCODING
+    TASK_BLACKBOX,
+#endif
+
+#if defined(USE_OFFLOAD) && !defined(USE_OSD_SLAVE)
+    TASK_OFFLOAD,
+#endif
+
     /* Count of real tasks */
     TASK_COUNT,
 
@@ -158,12 +180,19 @@ typedef struct {
     timeDelta_t taskLatestDeltaTime;
     timeUs_t lastExecutedAt;        // last time of invocation
     timeUs_t lastSignaledAt;        // time of invocation event for event-driven tasks
+    timeDelta_t checkFuncPollPeriod; // if not zero, checkFunc is only polled after a signal or when this period expires
+    timeUs_t lastCheckedAt;         // last time checkFunc was polled
+    volatile bool signalPending;    // set by schedulerSignalTask()
 
 #ifndef SKIP_TASK_STATISTICS
     // Statistics
     timeUs_t movingSumExecutionTime;  // moving sum over 32 samples
     timeUs_t maxExecutionTime;
     timeUs_t totalExecutionTime;    // total time consumed by task since boot
+#ifdef USE_TASK_STATISTICS_HISTOGRAM
+    uint32_t lateCount;             // number of times a time-driven task was started more than one desiredPeriod late
+    uint16_t executionTimeHistogram[TASK_HISTOGRAM_BUCKET_COUNT];   // saturating log2 histogram of execution times
+#endif
 #endif
 } cfTask_t;
 
@@ -173,11 +202,19 @@ extern uint16_t averageSystemLoadPercent;
 void getCheckFuncInfo(cfCheckFuncInfo_t *checkFuncInfo);
 void getTaskInfo(cfTaskId_e taskId, cfTaskInfo_t *taskInfo);
 void rescheduleTask(cfTaskId_e taskId, uint32_t newPeriodMicros);
+void schedulerAlignTask(cfTaskId_e taskId, timeUs_t dueAtUs);
 void setTaskEnabled(cfTaskId_e taskId, bool newEnabledState);
 timeDelta_t getTaskDeltaTime(cfTaskId_e taskId);
 void schedulerSetCalulateTaskStatistics(bool calculateTaskStatistics);
 void schedulerResetTaskStatistics(cfTaskId_e taskId);
 void schedulerResetTaskMaxExecutionTime(cfTaskId_e taskId);
+void schedulerSetTaskSignalled(cfTaskId_e taskId, timeDelta_t pollPeriodUs);
+void schedulerSignalTask(cfTaskId_e taskId);
+timeDelta_t schedulerGetTimeRemaining(void);
+bool schedulerTaskShouldYield(timeDelta_t requiredTimeUs);
+timeDelta_t schedulerGetTimeUntilNextTask(void);
+void schedulerSetInterruptDrivenTask(cfTaskId_e taskId);
+void schedulerExecuteInterruptDrivenTask(timeUs_t currentTimeUs);
 
 void schedulerInit(void);
 void scheduler(void);
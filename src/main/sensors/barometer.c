@@ -169,7 +169,7 @@ bool baroDetect(baroDev_t *dev, baroSensor_e baroHardwareToUse)
 #ifdef USE_SPI
         dev->busdev.bustype = BUSTYPE_SPI;
         spiBusSetInstance(&dev->busdev, spiInstanceByDevice(SPI_CFG_TO_DEV(barometerConfig()->baro_spi_device)));
-        dev->busdev.busdev_u.spi.csnPin = IOGetByTag(barometerConfig()->baro_spi_csn);
+        spiBusSetCsPin(&dev->busdev, IOGetByTag(barometerConfig()->baro_spi_csn));
 #endif
         break;
 
@@ -20,6 +20,7 @@
 
 #include "stdbool.h"
 #include "stdint.h"
+#include "math.h"
 
 #include "platform.h"
 
@@ -70,10 +71,128 @@ static lowVoltageCutoff_t lowVoltageCutoff;
 static currentMeter_t currentMeter;
 static voltageMeter_t voltageMeter;
 
+TOPIC_DEFINE(batteryMeasurement, batteryMeasurement_t);
+
 static batteryState_e batteryState;
 static batteryState_e voltageState;
 static batteryState_e consumptionState;
 
+// precomputed in the battery voltage task, read by the mixer on every loop
+static float vbatPidCompensationFactor = 1.0f;
+static float vbatSagCompensationFactor = 1.0f;
+
+#ifdef USE_BATTERY_SAG_COMPENSATION
+/*
+ * Pack model V = V0 - I * R. The internal resistance R and the no-load voltage V0
+ * are estimated by recursive least squares over the voltage and current pairs
+ * sampled by the battery voltage task. The forgetting factor lets the estimate
+ * follow the pack as it discharges and warms up.
+ */
+#define BATTERY_MODEL_UPDATE_HZ             50      // TASK_BATTERY_VOLTAGE rate
+#define BATTERY_MODEL_FORGETTING_FACTOR     0.998f  // ~10s memory at 50Hz
+#define BATTERY_MODEL_P_V0_INIT             10.0f   // V^2
+#define BATTERY_MODEL_P_R_INIT              0.01f   // ohm^2
+#define BATTERY_MODEL_RESISTANCE_MAX        0.5f    // ohm
+#define BATTERY_MODEL_CURRENT_SPAN_MIN      500     // 5A of current excursion before the resistance is trusted
+#define BATTERY_MODEL_NO_LOAD_CUTOFF_HZ     1
+
+typedef struct batteryModel_s {
+    float v0;                   // V
+    float resistance;           // ohm
+    float p[2][2];              // covariance of (v0, resistance)
+    int32_t amperageMin;        // 0.01A
+    int32_t amperageMax;        // 0.01A
+    pt1Filter_t noLoadFilter;
+    float noLoadVoltage;        // V
+} batteryModel_t;
+
+static batteryModel_t batteryModel;
+
+static void batteryModelReset(float voltage)
+{
+    batteryModel.v0 = voltage;
+    batteryModel.resistance = 0.0f;
+    batteryModel.p[0][0] = BATTERY_MODEL_P_V0_INIT;
+    batteryModel.p[0][1] = 0.0f;
+    batteryModel.p[1][0] = 0.0f;
+    batteryModel.p[1][1] = BATTERY_MODEL_P_R_INIT;
+    batteryModel.amperageMin = INT32_MAX;
+    batteryModel.amperageMax = INT32_MIN;
+    pt1FilterInit(&batteryModel.noLoadFilter, pt1FilterGain(BATTERY_MODEL_NO_LOAD_CUTOFF_HZ, 1.0f / BATTERY_MODEL_UPDATE_HZ));
+    batteryModel.noLoadFilter.state = voltage;
+    batteryModel.noLoadVoltage = voltage;
+}
+
+static bool batteryModelIsValid(void)
+{
+    return batteryModel.amperageMax - batteryModel.amperageMin >= BATTERY_MODEL_CURRENT_SPAN_MIN;
+}
+
+static void batteryModelUpdate(uint16_t voltageDeciVolts, int32_t amperageCentiAmps)
+{
+    const float voltage = voltageDeciVolts * 0.1f;
+    const float amperage = amperageCentiAmps * 0.01f;
+
+    batteryModel.amperageMin = MIN(batteryModel.amperageMin, amperageCentiAmps);
+    batteryModel.amperageMax = MAX(batteryModel.amperageMax, amperageCentiAmps);
+
+    // regressor phi = (1, -I), P * phi and the gain K = P * phi / (lambda + phi' * P * phi)
+    const float pPhi0 = batteryModel.p[0][0] - batteryModel.p[0][1] * amperage;
+    const float pPhi1 = batteryModel.p[1][0] - batteryModel.p[1][1] * amperage;
+    const float denominator = BATTERY_MODEL_FORGETTING_FACTOR + pPhi0 - pPhi1 * amperage;
+    const float k0 = pPhi0 / denominator;
+    const float k1 = pPhi1 / denominator;
+
+    const float error = voltage - (batteryModel.v0 - batteryModel.resistance * amperage);
+    batteryModel.v0 += k0 * error;
+    batteryModel.resistance = constrainf(batteryModel.resistance + k1 * error, 0.0f, BATTERY_MODEL_RESISTANCE_MAX);
+
+    // P = (P - K * phi' * P) / lambda, phi' * P is (P * phi)' as P is symmetric
+    const float lambdaInverse = 1.0f / BATTERY_MODEL_FORGETTING_FACTOR;
+    batteryModel.p[0][0] = (batteryModel.p[0][0] - k0 * pPhi0) * lambdaInverse;
+    batteryModel.p[0][1] = (batteryModel.p[0][1] - k0 * pPhi1) * lambdaInverse;
+    batteryModel.p[1][0] = batteryModel.p[0][1];
+    batteryModel.p[1][1] = (batteryModel.p[1][1] - k1 * pPhi1) * lambdaInverse;
+
+    // without current changes the forgetting factor winds the covariance up, bound it to the initial uncertainty
+    if (batteryModel.p[0][0] > BATTERY_MODEL_P_V0_INIT || batteryModel.p[1][1] > BATTERY_MODEL_P_R_INIT) {
+        const float scale = MIN(BATTERY_MODEL_P_V0_INIT / batteryModel.p[0][0], BATTERY_MODEL_P_R_INIT / batteryModel.p[1][1]);
+        batteryModel.p[0][0] *= scale;
+        batteryModel.p[0][1] *= scale;
+        batteryModel.p[1][0] *= scale;
+        batteryModel.p[1][1] *= scale;
+    }
+
+    // the latest sample corrected for its own sag rather than v0, so the estimate does not lag a discharging pack
+    batteryModel.noLoadVoltage = pt1FilterApply(&batteryModel.noLoadFilter, voltage + amperage * batteryModel.resistance);
+}
+#endif
+
+static void batteryUpdateCompensation(void)
+{
+    float pidFactor = 1.0f;
+    float sagFactor = 1.0f;
+
+    if (batteryConfig()->voltageMeterSource != VOLTAGE_METER_NONE && batteryCellCount > 0) {
+        const float referenceVoltage = (float)batteryConfig()->vbatmaxcellvoltage * batteryCellCount;
+        float voltage = voltageMeter.filtered;
+#ifdef USE_BATTERY_SAG_COMPENSATION
+        if (batteryConfig()->vbatSagCompensation > 0 && batteryModelIsValid()) {
+            // compensate for the state of charge only, compensating the sag itself would draw more current and sag further
+            voltage = batteryModel.noLoadVoltage * 10.0f;
+            sagFactor = 1.0f + (constrainf(referenceVoltage / voltage, 1.0f, 1.33f) - 1.0f) * batteryConfig()->vbatSagCompensation / 100.0f;
+        }
+#endif
+        if (voltage > 0.0f) {
+            // Up to 33% PID gain. Should be fine for 4,2to 3,3 difference
+            pidFactor = constrainf(referenceVoltage / voltage, 1.0f, 1.33f);
+        }
+    }
+
+    vbatPidCompensationFactor = pidFactor;
+    vbatSagCompensationFactor = sagFactor;
+}
+
 #ifndef DEFAULT_CURRENT_METER_SOURCE
 #ifdef USE_VIRTUAL_CURRENT_METER
 #define DEFAULT_CURRENT_METER_SOURCE CURRENT_METER_VIRTUAL
@@ -90,7 +209,7 @@ static batteryState_e consumptionState;
 #define DEFAULT_VOLTAGE_METER_SOURCE VOLTAGE_METER_NONE
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 2);
+PG_REGISTER_WITH_RESET_TEMPLATE(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 3);
 
 PG_RESET_TEMPLATE(batteryConfig_t, batteryConfig,
     // voltage
@@ -111,13 +230,12 @@ PG_RESET_TEMPLATE(batteryConfig_t, batteryConfig,
     .consumptionWarningPercentage = 10,
     .vbathysteresis = 1,
 
-    .vbatfullcellvoltage = 41
+    .vbatfullcellvoltage = 41,
+    .vbatSagCompensation = 0
 );
 
 void batteryUpdateVoltage(timeUs_t currentTimeUs)
 {
-    UNUSED(currentTimeUs);
-
     switch (batteryConfig()->voltageMeterSource) {
 #ifdef USE_ESC_SENSOR
         case VOLTAGE_METER_ESC:
@@ -138,6 +256,20 @@ void batteryUpdateVoltage(timeUs_t currentTimeUs)
             break;
     }
 
+#ifdef USE_BATTERY_SAG_COMPENSATION
+    if (batteryCellCount > 0 && batteryConfig()->currentMeterSource != CURRENT_METER_NONE) {
+        batteryModelUpdate(voltageMeter.unfiltered, currentMeter.amperageLatest);
+    }
+#endif
+    batteryUpdateCompensation();
+
+    const batteryMeasurement_t measurement = {
+        .voltage = voltageMeter.filtered,
+        .amperage = currentMeter.amperage,
+        .mAhDrawn = currentMeter.mAhDrawn,
+    };
+    batteryMeasurementPublish(&measurement, currentTimeUs);
+
     if (debugMode == DEBUG_BATTERY) {
         debug[0] = voltageMeter.unfiltered;
         debug[1] = voltageMeter.filtered;
@@ -192,6 +324,9 @@ void batteryUpdatePresence(void)
         batteryCriticalVoltage = batteryCellCount * batteryConfig()->vbatmincellvoltage;
         lowVoltageCutoff.percentage = 100;
         lowVoltageCutoff.startTime = 0;
+#ifdef USE_BATTERY_SAG_COMPENSATION
+        batteryModelReset(voltageMeter.filtered * 0.1f);
+#endif
     } else if (
         voltageState != BATTERY_NOT_PRESENT
         && isVoltageStable
@@ -305,6 +440,11 @@ void batteryInit(void)
     lowVoltageCutoff.startTime = 0;
 
     voltageMeterReset(&voltageMeter);
+    vbatPidCompensationFactor = 1.0f;
+    vbatSagCompensationFactor = 1.0f;
+#ifdef USE_BATTERY_SAG_COMPENSATION
+    batteryModelReset(0.0f);
+#endif
     switch (batteryConfig()->voltageMeterSource) {
         case VOLTAGE_METER_ESC:
 #ifdef USE_ESC_SENSOR
@@ -420,13 +560,14 @@ void batteryUpdateCurrentMeter(timeUs_t currentTimeUs)
     }
 }
 
-float calculateVbatPidCompensation(void) {
-    float batteryScaler =  1.0f;
-    if (batteryConfig()->voltageMeterSource != VOLTAGE_METER_NONE && batteryCellCount > 0) {
-        // Up to 33% PID gain. Should be fine for 4,2to 3,3 difference
-        batteryScaler =  constrainf((( (float)batteryConfig()->vbatmaxcellvoltage * batteryCellCount ) / (float) voltageMeter.filtered), 1.0f, 1.33f);
-    }
-    return batteryScaler;
+float calculateVbatPidCompensation(void)
+{
+    return vbatPidCompensationFactor;
+}
+
+float getBatterySagCompensationFactor(void)
+{
+    return vbatSagCompensationFactor;
 }
 
 uint8_t calculateBatteryPercentageRemaining(void)
@@ -478,6 +619,20 @@ uint16_t getBatteryAverageCellVoltage(void)
     return voltageMeter.filtered / batteryCellCount;
 }
 
+#ifdef USE_BATTERY_SAG_COMPENSATION
+// in 0.01V steps
+uint16_t getBatteryNoLoadVoltage(void)
+{
+    return lrintf(batteryModel.noLoadVoltage * 100.0f);
+}
+
+// in milliohms
+uint16_t getBatteryResistance(void)
+{
+    return lrintf(batteryModel.resistance * 1000.0f);
+}
+#endif
+
 bool isAmperageConfigured(void)
 {
     return batteryConfig()->currentMeterSource != CURRENT_METER_NONE;
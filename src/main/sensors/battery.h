@@ -24,6 +24,7 @@
 
 #include "common/filter.h"
 #include "common/time.h"
+#include "common/topic.h"
 #include "sensors/current.h"
 #include "sensors/voltage.h"
 
@@ -47,6 +48,7 @@ typedef struct batteryConfig_s {
     uint8_t vbathysteresis;                 // hysteresis for alarm, default 1 = 0.1V
 
     uint8_t vbatfullcellvoltage;            // Cell voltage at which the battery is deemed to be "full" 0.1V units, default is 41 (4.1V)
+    uint8_t vbatSagCompensation;            // Percentage of the voltage drop since vbatmaxcellvoltage that the throttle is compensated for, 0 = off
 
 } batteryConfig_t;
 
@@ -66,6 +68,15 @@ typedef enum {
     BATTERY_INIT
 } batteryState_e;
 
+// Published by the voltage task, the current is the latest reading of the current task
+typedef struct batteryMeasurement_s {
+    uint16_t voltage;       // 0.1V filtered
+    int32_t amperage;       // 0.01A
+    int32_t mAhDrawn;
+} batteryMeasurement_t;
+
+TOPIC_DECLARE(batteryMeasurement, batteryMeasurement_t);
+
 void batteryInit(void);
 void batteryUpdateVoltage(timeUs_t currentTimeUs);
 void batteryUpdatePresence(void);
@@ -79,12 +90,17 @@ void batteryUpdateAlarms(void);
 struct rxConfig_s;
 
 float calculateVbatPidCompensation(void);
+float getBatterySagCompensationFactor(void);
 uint8_t calculateBatteryPercentageRemaining(void);
 bool isBatteryVoltageConfigured(void);
 uint16_t getBatteryVoltage(void);
 uint16_t getBatteryVoltageLatest(void);
 uint8_t getBatteryCellCount(void);
 uint16_t getBatteryAverageCellVoltage(void);
+#ifdef USE_BATTERY_SAG_COMPENSATION
+uint16_t getBatteryNoLoadVoltage(void);
+uint16_t getBatteryResistance(void);
+#endif
 
 bool isAmperageConfigured(void);
 int32_t getAmperage(void);
@@ -35,8 +35,8 @@
 
 #include "boardalignment.h"
 
-static bool standardBoardAlignment = true;     // board orientation correction
-static float boardRotation[3][3];              // matrix
+static FAST_RAM bool standardBoardAlignment = true;     // board orientation correction
+static FAST_RAM_ZERO_INIT float boardRotation[3][3];   // matrix
 
 // no template required since defaults are zero
 PG_REGISTER(boardAlignment_t, boardAlignment, PG_BOARD_ALIGNMENT, 0);
@@ -48,12 +48,11 @@ static bool isBoardAlignmentStandard(const boardAlignment_t *boardAlignment)
 
 void initBoardAlignment(const boardAlignment_t *boardAlignment)
 {
-    if (isBoardAlignmentStandard(boardAlignment)) {
+    standardBoardAlignment = isBoardAlignmentStandard(boardAlignment);
+    if (standardBoardAlignment) {
         return;
     }
 
-    standardBoardAlignment = false;
-
     fp_angles_t rotationAngles;
     rotationAngles.angles.roll  = degreesToRadians(boardAlignment->rollDegrees );
     rotationAngles.angles.pitch = degreesToRadians(boardAlignment->pitchDegrees);
@@ -126,3 +125,56 @@ FAST_CODE void alignSensors(float *dest, uint8_t rotation)
     if (!standardBoardAlignment)
         alignBoard(dest);
 }
+
+// Must be called after initBoardAlignment()
+void buildSensorAlignment(sensorAlignment_t *alignment, uint8_t rotation)
+{
+    // the columns of the combined rotation are the aligned unit vectors
+    for (int col = 0; col < XYZ_AXIS_COUNT; col++) {
+        float unit[XYZ_AXIS_COUNT] = { 0.0f, 0.0f, 0.0f };
+        unit[col] = 1.0f;
+        alignSensors(unit, rotation);
+        for (int row = 0; row < XYZ_AXIS_COUNT; row++) {
+            alignment->matrix[row][col] = unit[row];
+        }
+    }
+
+    // a board aligned in steps of 90 degrees leaves an axis permutation, which needs no multiplies
+    alignment->useMatrix = false;
+    for (int row = 0; row < XYZ_AXIS_COUNT; row++) {
+        int nonZero = 0;
+        for (int col = 0; col < XYZ_AXIS_COUNT; col++) {
+            const float value = alignment->matrix[row][col];
+            if (fabsf(value) > 0.001f) {
+                nonZero++;
+                alignment->axis[row] = col;
+                alignment->invert[row] = value < 0.0f;
+                if (fabsf(fabsf(value) - 1.0f) > 0.001f) {
+                    alignment->useMatrix = true;
+                }
+            }
+        }
+        if (nonZero != 1) {
+            alignment->useMatrix = true;
+        }
+    }
+}
+
+FAST_CODE void applySensorAlignment(float *dest, const sensorAlignment_t *alignment)
+{
+    const float x = dest[X];
+    const float y = dest[Y];
+    const float z = dest[Z];
+
+    if (alignment->useMatrix) {
+        dest[X] = alignment->matrix[X][X] * x + alignment->matrix[X][Y] * y + alignment->matrix[X][Z] * z;
+        dest[Y] = alignment->matrix[Y][X] * x + alignment->matrix[Y][Y] * y + alignment->matrix[Y][Z] * z;
+        dest[Z] = alignment->matrix[Z][X] * x + alignment->matrix[Z][Y] * y + alignment->matrix[Z][Z] * z;
+    } else {
+        const float src[XYZ_AXIS_COUNT] = { x, y, z };
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            const float value = src[alignment->axis[axis]];
+            dest[axis] = alignment->invert[axis] ? -value : value;
+        }
+    }
+}
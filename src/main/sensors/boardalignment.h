@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/axis.h"
+
 #include "pg/pg.h"
 
 typedef struct boardAlignment_s {
@@ -30,5 +32,15 @@ typedef struct boardAlignment_s {
 
 PG_DECLARE(boardAlignment_t, boardAlignment);
 
+// Sensor and board alignment folded into a single transform
+typedef struct sensorAlignment_s {
+    bool useMatrix;                     // otherwise dest[i] = +-src[axis[i]]
+    uint8_t axis[XYZ_AXIS_COUNT];
+    bool invert[XYZ_AXIS_COUNT];
+    float matrix[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT];
+} sensorAlignment_t;
+
 void alignSensors(float *dest, uint8_t rotation);
 void initBoardAlignment(const boardAlignment_t *boardAlignment);
+void buildSensorAlignment(sensorAlignment_t *alignment, uint8_t rotation);
+void applySensorAlignment(float *dest, const sensorAlignment_t *alignment);
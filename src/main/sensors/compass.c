@@ -20,10 +20,12 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <math.h>
 
 #include "platform.h"
 
 #include "common/axis.h"
+#include "common/maths.h"
 
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
@@ -46,6 +48,7 @@
 
 #include "sensors/boardalignment.h"
 #include "sensors/compass.h"
+#include "sensors/compass_calibration.h"
 #include "sensors/gyro.h"
 #include "sensors/sensors.h"
 
@@ -62,10 +65,21 @@ mag_t mag;                   // mag access functions
 #define COMPASS_INTERRUPT_TAG   IO_TAG_NONE
 #endif
 
-PG_REGISTER_WITH_RESET_FN(compassConfig_t, compassConfig, PG_COMPASS_CONFIG, 1);
+PG_REGISTER_WITH_RESET_FN(compassConfig_t, compassConfig, PG_COMPASS_CONFIG, 2);
+
+static void compassResetSoftIron(compassConfig_t *compassConfig)
+{
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        for (int j = 0; j < XYZ_AXIS_COUNT; j++) {
+            compassConfig->magSoftIron[i * XYZ_AXIS_COUNT + j] = (i == j) ? MAG_SOFT_IRON_SCALE : 0;
+        }
+    }
+}
 
 void pgResetFn_compassConfig(compassConfig_t *compassConfig)
 {
+    compassResetSoftIron(compassConfig);
+    compassConfig->mag_auto_calibration = true;
     compassConfig->mag_align = ALIGN_DEFAULT;
     compassConfig->mag_declination = 0;
     compassConfig->mag_hardware = MAG_DEFAULT;
@@ -115,6 +129,56 @@ void pgResetFn_compassConfig(compassConfig_t *compassConfig)
 static int16_t magADCRaw[XYZ_AXIS_COUNT];
 static uint8_t magInit = 0;
 
+#ifdef USE_MAG_AUTO_CALIBRATION
+// the fit is checked after this many accepted samples
+#define MAG_CALIBRATION_SOLVE_INTERVAL      50
+// a new fit replaces the configured one when the offset moves by this fraction of the field
+#define MAG_CALIBRATION_OFFSET_TOLERANCE    0.05f
+// or any soft iron gain moves by this much
+#define MAG_CALIBRATION_SOFT_IRON_TOLERANCE 20
+
+static magCalibrationSolver_t magCalibrationSolver;
+static bool magCalibrationSavePending;
+
+static void compassUpdateAutoCalibration(const float sample[XYZ_AXIS_COUNT])
+{
+    if (!magCalibrationSolverAddSample(&magCalibrationSolver, sample) || magCalibrationSolver.sampleCount % MAG_CALIBRATION_SOLVE_INTERVAL) {
+        return;
+    }
+
+    float offset[XYZ_AXIS_COUNT];
+    float softIron[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT];
+    if (!magCalibrationSolverGetResult(&magCalibrationSolver, offset, softIron)) {
+        return;
+    }
+
+    compassConfig_t *config = compassConfigMutable();
+    bool changed = false;
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        if (fabsf(offset[i] - config->magZero.raw[i]) > MAG_CALIBRATION_OFFSET_TOLERANCE * magCalibrationSolver.scale) {
+            changed = true;
+        }
+        for (int j = 0; j < XYZ_AXIS_COUNT; j++) {
+            if (ABS(lrintf(softIron[i][j] * MAG_SOFT_IRON_SCALE) - config->magSoftIron[i * XYZ_AXIS_COUNT + j]) > MAG_CALIBRATION_SOFT_IRON_TOLERANCE) {
+                changed = true;
+            }
+        }
+    }
+    if (!changed) {
+        return;
+    }
+
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        config->magZero.raw[i] = lrintf(offset[i]);
+        for (int j = 0; j < XYZ_AXIS_COUNT; j++) {
+            config->magSoftIron[i * XYZ_AXIS_COUNT + j] = lrintf(softIron[i][j] * MAG_SOFT_IRON_SCALE);
+        }
+    }
+    // the config is written once the craft lands
+    magCalibrationSavePending = true;
+}
+#endif
+
 #if !defined(SIMULATOR_BUILD)
 bool compassDetect(magDev_t *dev)
 {
@@ -139,7 +203,7 @@ bool compassDetect(magDev_t *dev)
     case BUSTYPE_SPI:
         busdev->bustype = BUSTYPE_SPI;
         spiBusSetInstance(busdev, spiInstanceByDevice(SPI_CFG_TO_DEV(compassConfig()->mag_spi_device)));
-        busdev->busdev_u.spi.csnPin = IOGetByTag(compassConfig()->mag_spi_csn);
+        spiBusSetCsPin(busdev, IOGetByTag(compassConfig()->mag_spi_csn));
 #endif
         break;
 
@@ -150,6 +214,7 @@ bool compassDetect(magDev_t *dev)
                 busdev->bustype = BUSTYPE_MPU_SLAVE;
                 busdev->busdev_u.mpuSlave.master = gyroSensorBus();
                 busdev->busdev_u.mpuSlave.address = compassConfig()->mag_i2c_address;
+                spiBusRegisterDevice(busdev);
             } else {
                 return false;
             }
@@ -275,6 +340,9 @@ bool compassInit(void)
     magDev.init(&magDev);
     LED1_OFF;
     magInit = 1;
+#ifdef USE_MAG_AUTO_CALIBRATION
+    magCalibrationSolverInit(&magCalibrationSolver);
+#endif
     if (compassConfig()->mag_align != ALIGN_DEFAULT) {
         magDev.magAlign = compassConfig()->mag_align;
     }
@@ -306,13 +374,40 @@ void compassUpdate(timeUs_t currentTimeUs)
             magZeroTempMin.raw[axis] = mag.magADC[axis];
             magZeroTempMax.raw[axis] = mag.magADC[axis];
         }
+        compassResetSoftIron(compassConfigMutable());
+#ifdef USE_MAG_AUTO_CALIBRATION
+        magCalibrationSolverInit(&magCalibrationSolver);
+        magCalibrationSavePending = false;
+#endif
         DISABLE_STATE(CALIBRATE_MAG);
     }
 
+#ifdef USE_MAG_AUTO_CALIBRATION
+    // the fit works on uncorrected samples so its result is a complete calibration
+    if (compassConfig()->mag_auto_calibration && tCal == 0) {
+        compassUpdateAutoCalibration(mag.magADC);
+    }
+    if (magCalibrationSavePending && !ARMING_FLAG(ARMED)) {
+        magCalibrationSavePending = false;
+        saveConfigAndNotify();
+    }
+#endif
+
     if (magInit) {              // we apply offset only once mag calibration is done
         mag.magADC[X] -= magZero->raw[X];
         mag.magADC[Y] -= magZero->raw[Y];
         mag.magADC[Z] -= magZero->raw[Z];
+
+        const int16_t *softIron = compassConfig()->magSoftIron;
+        float corrected[XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            corrected[axis] = (softIron[axis * XYZ_AXIS_COUNT + X] * mag.magADC[X]
+                + softIron[axis * XYZ_AXIS_COUNT + Y] * mag.magADC[Y]
+                + softIron[axis * XYZ_AXIS_COUNT + Z] * mag.magADC[Z]) * (1.0f / MAG_SOFT_IRON_SCALE);
+        }
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            mag.magADC[axis] = corrected[axis];
+        }
     }
 
     if (tCal != 0) {
@@ -44,6 +44,9 @@ typedef struct mag_s {
 
 extern mag_t mag;
 
+// mag_soft_iron is stored with this scale, 1000 is a gain of 1
+#define MAG_SOFT_IRON_SCALE 1000
+
 typedef struct compassConfig_s {
     int16_t mag_declination;                // Get your magnetic decliniation from here : http://magnetic-declination.com/
                                             // For example, -6deg 37min, = -637 Japan, format is [sign]dddmm (degreesminutes) default is zero.
@@ -56,6 +59,8 @@ typedef struct compassConfig_s {
     ioTag_t mag_spi_csn;
     ioTag_t interruptTag;
     flightDynamicsTrims_t magZero;
+    int16_t magSoftIron[XYZ_AXIS_COUNT * XYZ_AXIS_COUNT]; // row major, applied after magZero
+    uint8_t mag_auto_calibration;           // refine magZero and magSoftIron from the samples seen in flight
 } compassConfig_t;
 
 PG_DECLARE(compassConfig_t, compassConfig);
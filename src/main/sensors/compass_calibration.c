@@ -0,0 +1,239 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_MAG_AUTO_CALIBRATION
+
+#include "common/axis.h"
+#include "common/maths.h"
+
+#include "sensors/compass_calibration.h"
+
+// initial covariance, large so the first samples dominate the fit
+#define MAG_CALIBRATION_INITIAL_COVARIANCE  100.0f
+// a sample is used once its direction has moved this far from the last one, cos(10deg)
+#define MAG_CALIBRATION_MIN_DIRECTION_DOT   0.985f
+// samples needed before the fit is trusted
+#define MAG_CALIBRATION_MIN_SAMPLES         200
+// each axis must have been swept over this fraction of the field diameter
+#define MAG_CALIBRATION_MIN_SPAN            1.0f
+// the soft iron correction may stretch or squash an axis by at most this factor
+#define MAG_CALIBRATION_MAX_STRETCH         2.0f
+#define MAG_CALIBRATION_SQRT_ITERATIONS     12
+
+typedef float mat3_t[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT];
+
+void magCalibrationSolverInit(magCalibrationSolver_t *solver)
+{
+    memset(solver, 0, sizeof(*solver));
+    for (int i = 0; i < MAG_CALIBRATION_PARAMETER_COUNT; i++) {
+        solver->P[i][i] = MAG_CALIBRATION_INITIAL_COVARIANCE;
+    }
+}
+
+bool magCalibrationSolverAddSample(magCalibrationSolver_t *solver, const float sample[XYZ_AXIS_COUNT])
+{
+    const float length = sqrtf(sq(sample[X]) + sq(sample[Y]) + sq(sample[Z]));
+    if (length == 0.0f) {
+        return false;
+    }
+
+    float direction[XYZ_AXIS_COUNT];
+    float dot = 0.0f;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        direction[axis] = sample[axis] / length;
+        dot += direction[axis] * solver->lastDirection[axis];
+    }
+    if (solver->sampleCount > 0 && dot > MAG_CALIBRATION_MIN_DIRECTION_DOT) {
+        return false;
+    }
+    if (solver->sampleCount == UINT16_MAX) {
+        return false;
+    }
+
+    if (solver->scale == 0.0f) {
+        solver->scale = length;
+    }
+
+    float u[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        solver->lastDirection[axis] = direction[axis];
+        u[axis] = sample[axis] / solver->scale;
+        if (solver->sampleCount == 0 || u[axis] < solver->sampleMin[axis]) {
+            solver->sampleMin[axis] = u[axis];
+        }
+        if (solver->sampleCount == 0 || u[axis] > solver->sampleMax[axis]) {
+            solver->sampleMax[axis] = u[axis];
+        }
+    }
+
+    const float phi[MAG_CALIBRATION_PARAMETER_COUNT] = {
+        u[X] * u[X], u[Y] * u[Y], u[Z] * u[Z],
+        2.0f * u[X] * u[Y], 2.0f * u[X] * u[Z], 2.0f * u[Y] * u[Z],
+        u[X], u[Y], u[Z]
+    };
+
+    // standard recursive least squares step towards phi'theta = 1
+    float Pphi[MAG_CALIBRATION_PARAMETER_COUNT];
+    float denominator = 1.0f;
+    float error = 1.0f;
+    for (int i = 0; i < MAG_CALIBRATION_PARAMETER_COUNT; i++) {
+        Pphi[i] = 0.0f;
+        for (int j = 0; j < MAG_CALIBRATION_PARAMETER_COUNT; j++) {
+            Pphi[i] += solver->P[i][j] * phi[j];
+        }
+        denominator += phi[i] * Pphi[i];
+        error -= phi[i] * solver->theta[i];
+    }
+    for (int i = 0; i < MAG_CALIBRATION_PARAMETER_COUNT; i++) {
+        const float gain = Pphi[i] / denominator;
+        solver->theta[i] += gain * error;
+        for (int j = 0; j < MAG_CALIBRATION_PARAMETER_COUNT; j++) {
+            solver->P[i][j] -= gain * Pphi[j];
+        }
+    }
+
+    solver->sampleCount++;
+    return true;
+}
+
+static float mat3Inverse(const mat3_t m, mat3_t inverse)
+{
+    const float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+    const float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+    const float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+    const float det = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+    if (det == 0.0f) {
+        return 0.0f;
+    }
+    const float invDet = 1.0f / det;
+    inverse[0][0] = c00 * invDet;
+    inverse[1][0] = c01 * invDet;
+    inverse[2][0] = c02 * invDet;
+    inverse[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * invDet;
+    inverse[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * invDet;
+    inverse[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * invDet;
+    inverse[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * invDet;
+    inverse[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * invDet;
+    inverse[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * invDet;
+    return det;
+}
+
+// Symmetric square root of a positive definite matrix by the Denman-Beavers iteration.
+// The symmetric root maps the ellipsoid onto a sphere without rotating it, so the heading is kept.
+static bool mat3SquareRoot(const mat3_t m, mat3_t root)
+{
+    mat3_t y, z, yInverse, zInverse;
+    memcpy(y, m, sizeof(y));
+    memset(z, 0, sizeof(z));
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        z[i][i] = 1.0f;
+    }
+    for (int iteration = 0; iteration < MAG_CALIBRATION_SQRT_ITERATIONS; iteration++) {
+        if (mat3Inverse(y, yInverse) == 0.0f || mat3Inverse(z, zInverse) == 0.0f) {
+            return false;
+        }
+        for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+            for (int j = 0; j < XYZ_AXIS_COUNT; j++) {
+                y[i][j] = 0.5f * (y[i][j] + zInverse[i][j]);
+                z[i][j] = 0.5f * (z[i][j] + yInverse[i][j]);
+            }
+        }
+    }
+    memcpy(root, y, sizeof(y));
+    return true;
+}
+
+// The correction is softIron * (sample - offset), with det(softIron) = 1 so the field strength is kept.
+bool magCalibrationSolverGetResult(const magCalibrationSolver_t *solver, float offset[XYZ_AXIS_COUNT], float softIron[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT])
+{
+    if (solver->sampleCount < MAG_CALIBRATION_MIN_SAMPLES) {
+        return false;
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (solver->sampleMax[axis] - solver->sampleMin[axis] < MAG_CALIBRATION_MIN_SPAN) {
+            return false;
+        }
+    }
+
+    const float *theta = solver->theta;
+    const mat3_t a = {
+        { theta[0], theta[3], theta[4] },
+        { theta[3], theta[1], theta[5] },
+        { theta[4], theta[5], theta[2] }
+    };
+    mat3_t aInverse;
+    const float det = mat3Inverse(a, aInverse);
+    // positive definite, otherwise the fit is not an ellipsoid
+    if (det <= 0.0f || a[0][0] <= 0.0f || a[0][0] * a[1][1] - sq(a[0][1]) <= 0.0f) {
+        return false;
+    }
+
+    // centre c = -A^-1 b / 2, then (x - c)'A(x - c) = 1 + c'Ac
+    float centre[XYZ_AXIS_COUNT];
+    float k = 1.0f;
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        centre[i] = -0.5f * (aInverse[i][0] * theta[6] + aInverse[i][1] * theta[7] + aInverse[i][2] * theta[8]);
+    }
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        for (int j = 0; j < XYZ_AXIS_COUNT; j++) {
+            k += centre[i] * a[i][j] * centre[j];
+        }
+    }
+    if (k <= 0.0f) {
+        return false;
+    }
+
+    // normalise A/k to unit determinant, which leaves A/det(A)^(1/3) as k cancels out.
+    // The field strength is kept and only the shape of the ellipsoid is corrected.
+    mat3_t shape;
+    const float normalise = 1.0f / cbrtf(det);
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        for (int j = 0; j < XYZ_AXIS_COUNT; j++) {
+            shape[i][j] = a[i][j] * normalise;
+        }
+    }
+
+    mat3_t root;
+    if (!mat3SquareRoot(shape, root)) {
+        return false;
+    }
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        if (root[i][i] > MAG_CALIBRATION_MAX_STRETCH || root[i][i] < 1.0f / MAG_CALIBRATION_MAX_STRETCH) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        offset[i] = centre[i] * solver->scale;
+        for (int j = 0; j < XYZ_AXIS_COUNT; j++) {
+            softIron[i][j] = root[i][j];
+        }
+    }
+    return true;
+}
+
+#endif // USE_MAG_AUTO_CALIBRATION
@@ -0,0 +1,44 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/axis.h"
+
+// x'Ax + b'x = 1 with A symmetric: Axx, Ayy, Azz, Axy, Axz, Ayz, bx, by, bz
+#define MAG_CALIBRATION_PARAMETER_COUNT 9
+
+typedef struct magCalibrationSolver_s {
+    // recursive least squares estimate and its covariance
+    float theta[MAG_CALIBRATION_PARAMETER_COUNT];
+    float P[MAG_CALIBRATION_PARAMETER_COUNT][MAG_CALIBRATION_PARAMETER_COUNT];
+    // samples are divided by this to keep the fit well conditioned in float
+    float scale;
+    // direction of the last accepted sample, so a hovering craft does not flood the fit
+    float lastDirection[XYZ_AXIS_COUNT];
+    // coverage of the accepted samples, in scaled units
+    float sampleMin[XYZ_AXIS_COUNT];
+    float sampleMax[XYZ_AXIS_COUNT];
+    uint16_t sampleCount;
+} magCalibrationSolver_t;
+
+void magCalibrationSolverInit(magCalibrationSolver_t *solver);
+bool magCalibrationSolverAddSample(magCalibrationSolver_t *solver, const float sample[XYZ_AXIS_COUNT]);
+bool magCalibrationSolverGetResult(const magCalibrationSolver_t *solver, float offset[XYZ_AXIS_COUNT], float softIron[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT]);
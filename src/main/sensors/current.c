@@ -146,7 +146,8 @@ void currentMeterADCInit(void)
 void currentMeterADCRefresh(int32_t lastUpdateAt)
 {
 #ifdef USE_ADC
-    const uint16_t iBatSample = adcGetChannel(ADC_CURRENT);
+    // mean over the whole task period, so current spikes between two runs are integrated
+    const uint16_t iBatSample = adcGetChannelAverage(ADC_CURRENT);
     currentMeterADCState.amperageLatest = currentMeterADCToCentiamps(iBatSample);
     currentMeterADCState.amperage = currentMeterADCToCentiamps(biquadFilterApply(&adciBatFilter, iBatSample));
 
@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -32,6 +33,7 @@
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
 
+#include "common/crc.h"
 #include "common/maths.h"
 #include "common/utils.h"
 
@@ -40,6 +42,7 @@
 #include "drivers/serial_uart.h"
 
 #include "esc_sensor.h"
+#include "esc_stats.h"
 
 #include "fc/config.h"
 
@@ -100,8 +103,9 @@ typedef enum {
 } escSensorTriggerState_t;
 
 #define ESC_SENSOR_BAUDRATE 115200
-#define ESC_BOOTTIME 5000               // 5 seconds
-#define ESC_REQUEST_TIMEOUT 100         // 100 ms (data transfer takes only 900us)
+#define ESC_BOOTTIME_US 5000000         // 5 seconds
+// Until the request has gone out with the next DShot frame and the ESC has started to reply
+#define ESC_REQUEST_LATENCY_US 2500
 
 #define TELEMETRY_FRAME_SIZE 10
 static uint8_t telemetryBuffer[TELEMETRY_FRAME_SIZE] = { 0, };
@@ -114,8 +118,17 @@ static serialPort_t *escSensorPort = NULL;
 
 static escSensorData_t escSensorData[MAX_SUPPORTED_MOTORS];
 
+TOPIC_DEFINE(escTelemetry, escTelemetry_t);
+
+/*
+ * The telemetry of one motor is requested per slot. A slot ends when the frame is complete, or once the frame
+ * would have been received, and the next slot starts right after a complete frame. After a failed slot there is
+ * a gap of one frame time first, so that a late frame doesn't end up in the next slot.
+ */
 static escSensorTriggerState_t escSensorTriggerState = ESC_SENSOR_TRIGGER_STARTUP;
-static uint32_t escTriggerTimestamp;
+static timeUs_t escNextRequestAtUs;
+static timeUs_t escSlotEndsAtUs;
+static timeDelta_t escFrameTimeUs;
 static uint8_t escSensorMotor = 0;      // motor index
 
 static escSensorData_t combinedEscSensorData;
@@ -217,29 +230,15 @@ bool escSensorInit(void)
         escSensorData[i].dataAge = ESC_DATA_INVALID;
     }
 
-    return escSensorPort != NULL;
-}
+    // 10 bits per byte, with the start and stop bits
+    escFrameTimeUs = TELEMETRY_FRAME_SIZE * 10 * 1000000 / ESC_SENSOR_BAUDRATE;
 
-static uint8_t updateCrc8(uint8_t crc, uint8_t crc_seed)
-{
-    uint8_t crc_u = crc;
-    crc_u ^= crc_seed;
-
-    for (int i=0; i<8; i++) {
-        crc_u = ( crc_u & 0x80 ) ? 0x7 ^ ( crc_u << 1 ) : ( crc_u << 1 );
-    }
-
-    return (crc_u);
+    return escSensorPort != NULL;
 }
 
 uint8_t calculateCrc8(const uint8_t *Buf, const uint8_t BufLen)
 {
-    uint8_t crc = 0;
-    for (int i = 0; i < BufLen; i++) {
-        crc = updateCrc8(Buf[i], crc);
-    }
-
-    return crc;
+    return crc8_ccitt_update(0, Buf, BufLen);
 }
 
 static uint8_t decodeEscFrame(void)
@@ -262,6 +261,17 @@ static uint8_t decodeEscFrame(void)
 
         combinedDataNeedsUpdate = true;
 
+#ifdef USE_ESC_STATS
+        escStatsAddSample(escSensorMotor, ESC_STATS_TEMPERATURE, escSensorData[escSensorMotor].temperature);
+        escStatsAddSample(escSensorMotor, ESC_STATS_CURRENT, escSensorData[escSensorMotor].current);
+#ifdef USE_DSHOT_TELEMETRY
+        if (!useDshotTelemetry)
+#endif
+        {
+            escStatsAddSample(escSensorMotor, ESC_STATS_ERPM, escSensorData[escSensorMotor].rpm);
+        }
+#endif
+
         frameStatus = ESC_SENSOR_FRAME_COMPLETE;
 
         DEBUG_SET(DEBUG_ESC_SENSOR_RPM, escSensorMotor, calcEscRpm(escSensorData[escSensorMotor].rpm) / 10); // output actual rpm/10 to fit in 16bit signed.
@@ -282,6 +292,13 @@ static void increaseDataAge(void)
     }
 }
 
+static void publishEscTelemetry(timeUs_t currentTimeUs)
+{
+    escTelemetry_t telemetry;
+    memcpy(telemetry.motor, escSensorData, sizeof(telemetry.motor));
+    escTelemetryPublish(&telemetry, currentTimeUs);
+}
+
 static void selectNextMotor(void)
 {
     escSensorMotor++;
@@ -290,10 +307,44 @@ static void selectNextMotor(void)
     }
 }
 
-void escSensorProcess(timeUs_t currentTimeUs)
+// A DShot command is sent to the ESCs with the telemetry bit set, the replies of all ESCs collide on the wire
+static bool escSensorCommandIsProcessing(void)
 {
-    const timeMs_t currentTimeMs = currentTimeUs / 1000;
+#ifdef USE_DSHOT
+    return pwmDshotCommandIsProcessing();
+#else
+    return false;
+#endif
+}
+
+static void escSensorEndSlot(timeUs_t currentTimeUs, timeDelta_t gapUs)
+{
+    escNextRequestAtUs = currentTimeUs + gapUs;
+    escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
+}
+
+bool escSensorCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    UNUSED(currentDeltaTimeUs);
 
+    if (!escSensorPort || !pwmAreMotorsEnabled()) {
+        return false;
+    }
+
+    switch (escSensorTriggerState) {
+    case ESC_SENSOR_TRIGGER_STARTUP:
+        return currentTimeUs >= ESC_BOOTTIME_US;
+    case ESC_SENSOR_TRIGGER_READY:
+        return cmpTimeUs(currentTimeUs, escNextRequestAtUs) >= 0;
+    case ESC_SENSOR_TRIGGER_PENDING:
+        return isFrameComplete() || cmpTimeUs(currentTimeUs, escSlotEndsAtUs) >= 0 || escSensorCommandIsProcessing();
+    }
+
+    return false;
+}
+
+void escSensorProcess(timeUs_t currentTimeUs)
+{
     if (!escSensorPort || !pwmAreMotorsEnabled()) {
         return;
     }
@@ -301,13 +352,21 @@ void escSensorProcess(timeUs_t currentTimeUs)
     switch (escSensorTriggerState) {
         case ESC_SENSOR_TRIGGER_STARTUP:
             // Wait period of time before requesting telemetry (let the system boot first)
-            if (currentTimeMs >= ESC_BOOTTIME) {
-                escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
+            if (currentTimeUs >= ESC_BOOTTIME_US) {
+                escSensorEndSlot(currentTimeUs, 0);
             }
 
             break;
         case ESC_SENSOR_TRIGGER_READY:
-            escTriggerTimestamp = currentTimeMs;
+            if (escSensorCommandIsProcessing()) {
+                escSensorEndSlot(currentTimeUs, escFrameTimeUs);
+                break;
+            }
+            if (cmpTimeUs(currentTimeUs, escNextRequestAtUs) < 0) {
+                break;
+            }
+
+            escSlotEndsAtUs = currentTimeUs + ESC_REQUEST_LATENCY_US + escFrameTimeUs;
 
             startEscDataRead(telemetryBuffer, TELEMETRY_FRAME_SIZE);
             motorDmaOutput_t * const motor = getMotorDmaOutput(escSensorMotor);
@@ -318,19 +377,27 @@ void escSensorProcess(timeUs_t currentTimeUs)
 
             break;
         case ESC_SENSOR_TRIGGER_PENDING:
-            if (currentTimeMs < escTriggerTimestamp + ESC_REQUEST_TIMEOUT) {
+            if (escSensorCommandIsProcessing()) {
+                // The slot is lost to the replies to the command, ask the same ESC again afterwards
+                escSensorEndSlot(currentTimeUs, escFrameTimeUs);
+                break;
+            }
+
+            if (cmpTimeUs(currentTimeUs, escSlotEndsAtUs) < 0 || isFrameComplete()) {
                 uint8_t state = decodeEscFrame();
                 switch (state) {
                     case ESC_SENSOR_FRAME_COMPLETE:
+                        publishEscTelemetry(currentTimeUs);
                         selectNextMotor();
-                        escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
+                        escSensorEndSlot(currentTimeUs, 0);
 
                         break;
                     case ESC_SENSOR_FRAME_FAILED:
                         increaseDataAge();
+                        publishEscTelemetry(currentTimeUs);
 
                         selectNextMotor();
-                        escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
+                        escSensorEndSlot(currentTimeUs, escFrameTimeUs);
 
                         DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_CRC_ERRORS, ++totalCrcErrorCount);
                         break;
@@ -340,9 +407,10 @@ void escSensorProcess(timeUs_t currentTimeUs)
             } else {
                 // Move on to next ESC, we'll come back to this one
                 increaseDataAge();
+                publishEscTelemetry(currentTimeUs);
 
                 selectNextMotor();
-                escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
+                escSensorEndSlot(currentTimeUs, escFrameTimeUs);
 
                 DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_TIMEOUTS, ++totalTimeoutCount);
             }
@@ -21,6 +21,9 @@
 #pragma once
 
 #include "common/time.h"
+#include "common/topic.h"
+
+#include "drivers/pwm_output_counts.h"
 
 typedef struct escSensorConfig_s {
     uint8_t halfDuplex;             // Set to false to listen on the TX pin for telemetry data
@@ -39,11 +42,18 @@ typedef struct {
     int16_t rpm;         // 0.01erpm
 } escSensorData_t;
 
+typedef struct escTelemetry_s {
+    escSensorData_t motor[MAX_SUPPORTED_MOTORS];
+} escTelemetry_t;
+
+TOPIC_DECLARE(escTelemetry, escTelemetry_t);
+
 #define ESC_DATA_INVALID 255
 
 #define ESC_BATTERY_AGE_MAX 10
 
 bool escSensorInit(void);
+bool escSensorCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
 void escSensorProcess(timeUs_t currentTime);
 
 #define ESC_SENSOR_COMBINED 255
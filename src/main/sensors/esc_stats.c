@@ -0,0 +1,152 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_ESC_STATS
+
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "drivers/pwm_output.h"
+
+#include "flight/mixer.h"
+
+#include "sensors/esc_stats.h"
+
+typedef struct escStatsAccumulator_s {
+    int32_t min;
+    int32_t max;
+    int32_t sum;
+    uint16_t count;
+} escStatsAccumulator_t;
+
+static escStatsAccumulator_t escStatsAccumulators[MAX_SUPPORTED_MOTORS][ESC_STATS_VALUE_COUNT];
+static escStats_t escStats[MAX_SUPPORTED_MOTORS];
+static escStats_t escStatsCombined;
+static timeUs_t escStatsWindowStartUs;
+
+void escStatsAddSample(uint8_t motor, escStatsValue_e value, int32_t sample)
+{
+    if (motor >= MAX_SUPPORTED_MOTORS) {
+        return;
+    }
+
+    escStatsAccumulator_t *acc = &escStatsAccumulators[motor][value];
+    if (acc->count == 0) {
+        acc->min = sample;
+        acc->max = sample;
+        acc->sum = 0;
+    } else {
+        acc->min = MIN(acc->min, sample);
+        acc->max = MAX(acc->max, sample);
+    }
+    // the sums stay within range for the window length and the sample rates of both sources
+    if (acc->count < UINT16_MAX) {
+        acc->sum += sample;
+        acc->count++;
+    }
+}
+
+static void escStatsCloseWindow(void)
+{
+    const int motorCount = MIN(getMotorCount(), MAX_SUPPORTED_MOTORS);
+
+    memset(&escStatsCombined, 0, sizeof(escStatsCombined));
+    int32_t combinedAvgSum[ESC_STATS_VALUE_COUNT] = { 0 };
+    int combinedCount[ESC_STATS_VALUE_COUNT] = { 0 };
+
+    for (int motor = 0; motor < motorCount; motor++) {
+        escStats_t *stats = &escStats[motor];
+        stats->validMask = 0;
+        for (int value = 0; value < ESC_STATS_VALUE_COUNT; value++) {
+            escStatsAccumulator_t *acc = &escStatsAccumulators[motor][value];
+            if (acc->count == 0) {
+                continue;
+            }
+
+            escStatsRange_t *range = &stats->values[value];
+            range->min = acc->min;
+            range->max = acc->max;
+            range->avg = acc->sum / acc->count;
+            stats->validMask |= BIT(value);
+            acc->count = 0;
+
+            escStatsRange_t *combined = &escStatsCombined.values[value];
+            if (combinedCount[value] == 0) {
+                combined->min = range->min;
+                combined->max = range->max;
+            } else {
+                combined->min = MIN(combined->min, range->min);
+                combined->max = MAX(combined->max, range->max);
+            }
+            combinedAvgSum[value] += range->avg;
+            combinedCount[value]++;
+        }
+    }
+
+    for (int value = 0; value < ESC_STATS_VALUE_COUNT; value++) {
+        if (combinedCount[value]) {
+            escStatsCombined.values[value].avg = combinedAvgSum[value] / combinedCount[value];
+            escStatsCombined.validMask |= BIT(value);
+        }
+    }
+}
+
+void escStatsUpdate(timeUs_t currentTimeUs)
+{
+#ifdef USE_DSHOT_TELEMETRY
+    if (useDshotTelemetry) {
+        // the serial telemetry only reports one motor at a time, the DShot eRPM is current for all of them
+        for (int motor = 0; motor < getMotorCount(); motor++) {
+            const uint16_t erpm = getDshotTelemetry(motor);
+            if (erpm != DSHOT_TELEMETRY_INVALID) {
+                escStatsAddSample(motor, ESC_STATS_ERPM, erpm);
+            }
+        }
+    }
+#endif
+
+    if (cmpTimeUs(currentTimeUs, escStatsWindowStartUs) >= ESC_STATS_WINDOW_MS * 1000) {
+        escStatsCloseWindow();
+        escStatsWindowStartUs = currentTimeUs;
+    }
+}
+
+const escStats_t *getEscStats(uint8_t motor)
+{
+    if (motor == ESC_STATS_COMBINED) {
+        return &escStatsCombined;
+    }
+    if (motor < MIN(getMotorCount(), MAX_SUPPORTED_MOTORS)) {
+        return &escStats[motor];
+    }
+    return NULL;
+}
+
+bool escStatsIsValid(const escStats_t *stats, escStatsValue_e value)
+{
+    return stats && (stats->validMask & BIT(value));
+}
+#endif
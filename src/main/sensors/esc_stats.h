@@ -0,0 +1,62 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Per motor ESC telemetry statistics.
+ *
+ * The samples from the serial ESC telemetry and from bidirectional DShot
+ * are reduced to the minimum, maximum and average of each value over a
+ * fixed window. The statistics of the last complete window are published
+ * for the OSD, blackbox and telemetry.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+#define ESC_STATS_WINDOW_MS 1000
+
+#define ESC_STATS_COMBINED 255
+
+typedef enum {
+    ESC_STATS_TEMPERATURE = 0,  // C degrees
+    ESC_STATS_CURRENT,          // 0.01A
+    ESC_STATS_ERPM,             // 100 erpm
+    ESC_STATS_VALUE_COUNT
+} escStatsValue_e;
+
+typedef struct escStatsRange_s {
+    int32_t min;
+    int32_t max;
+    int32_t avg;
+} escStatsRange_t;
+
+typedef struct escStats_s {
+    escStatsRange_t values[ESC_STATS_VALUE_COUNT];
+    uint8_t validMask;          // bit per escStatsValue_e, set when the window had samples of it
+} escStats_t;
+
+void escStatsAddSample(uint8_t motor, escStatsValue_e value, int32_t sample);
+void escStatsUpdate(timeUs_t currentTimeUs);
+const escStats_t *getEscStats(uint8_t motor);
+bool escStatsIsValid(const escStats_t *stats, escStatsValue_e value);
@@ -27,10 +27,14 @@
 #include "platform.h"
 
 #include "build/debug.h"
+#include "build/profile.h"
 
 #include "common/axis.h"
 #include "common/maths.h"
 #include "common/filter.h"
+#ifdef USE_GYRO_FILTER_FIXED_POINT
+#include "common/filter_fixed.h"
+#endif
 
 #include "config/feature.h"
 
@@ -61,8 +65,10 @@
 #include "drivers/accgyro/gyro_sync.h"
 #include "drivers/bus_spi.h"
 #include "drivers/io.h"
+#include "drivers/time.h"
 
 #include "fc/config.h"
+#include "fc/perf_report.h"
 #include "fc/runtime_config.h"
 
 #include "io/beeper.h"
@@ -70,11 +76,19 @@
 
 #include "scheduler/scheduler.h"
 
+#include "blackbox/blackbox_gyro_capture.h"
+
 #include "sensors/boardalignment.h"
 #include "sensors/gyro.h"
 #ifdef USE_GYRO_DATA_ANALYSE
 #include "sensors/gyroanalyse.h"
 #endif
+#ifdef USE_DUAL_GYRO
+#include "sensors/gyro_fusion.h"
+#endif
+#ifdef USE_RPM_FILTER
+#include "sensors/rpm_filter.h"
+#endif
 #include "sensors/sensors.h"
 
 #ifdef USE_HARDWARE_REVISION_DETECTION
@@ -86,9 +100,11 @@
 #endif
 
 FAST_RAM_ZERO_INIT gyro_t gyro;
+
+TOPIC_DEFINE(gyroRates, gyroRates_t);
 static FAST_RAM_ZERO_INIT uint8_t gyroDebugMode;
 
-static uint8_t gyroToUse = 0;
+static FAST_RAM_ZERO_INIT uint8_t gyroToUse = 0;
 
 #ifdef USE_GYRO_OVERFLOW_CHECK
 static FAST_RAM_ZERO_INIT uint8_t overflowAxisMask;
@@ -98,42 +114,87 @@ static FAST_RAM_ZERO_INIT float gyroPrevious[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT timeUs_t accumulatedMeasurementTimeUs;
 static FAST_RAM_ZERO_INIT timeUs_t accumulationLastTimeSampledUs;
 
-static bool gyroHasOverflowProtection = true;
+static FAST_RAM bool gyroHasOverflowProtection = true;
 
 typedef struct gyroCalibration_s {
     float sum[XYZ_AXIS_COUNT];
     stdev_t var[XYZ_AXIS_COUNT];
+    int32_t cycles;
     int32_t cyclesRemaining;
 } gyroCalibration_t;
 
 bool firstArmingCalibrationWasStarted = false;
 
+#ifdef USE_GYRO_FILTER_FIXED_POINT
+// without an FPU the static filters run in fixed point, the samples are converted on the way in and out of the chain
+typedef int32_t gyroFilterSample_t;
+typedef pt1FilterBank3Fixed_t gyroPt1FilterBank_t;
+typedef biquadFilterBank3Fixed_t gyroBiquadFilterBank_t;
+#define gyroPt1FilterBankInit       pt1FilterBank3FixedInit
+#define gyroPt1FilterBankApply      pt1FilterBank3FixedApply
+#define gyroBiquadFilterBankInit    biquadFilterBank3FixedInit
+#define gyroBiquadFilterBankInitLPF biquadFilterBank3FixedInitLPF
+#define gyroBiquadFilterBankApply   biquadFilterBank3FixedApply
+#else
+typedef float gyroFilterSample_t;
+typedef pt1FilterBank3_t gyroPt1FilterBank_t;
+typedef biquadFilterBank3_t gyroBiquadFilterBank_t;
+#define gyroPt1FilterBankInit       pt1FilterBank3Init
+#define gyroPt1FilterBankApply      pt1FilterBank3Apply
+#define gyroBiquadFilterBankInit    biquadFilterBank3Init
+#define gyroBiquadFilterBankInitLPF biquadFilterBank3InitLPF
+#define gyroBiquadFilterBankApply   biquadFilterBank3Apply
+#endif
+
 typedef union gyroLowpassFilter_u {
-    pt1Filter_t pt1FilterState;
-    biquadFilter_t biquadFilterState;
+    gyroPt1FilterBank_t pt1FilterState;
+    gyroBiquadFilterBank_t biquadFilterState;
+#ifndef USE_GYRO_FILTER_FIXED_POINT
+    kalmanFilterBank3_t kalmanFilterState;
+#endif
 } gyroLowpassFilter_t;
 
+// Filter chain stages, each stage filters all three axes together
+typedef enum {
+    GYRO_FILTER_STAGE_NONE = 0,
+    GYRO_FILTER_STAGE_PT1,
+    GYRO_FILTER_STAGE_BIQUAD,
+    GYRO_FILTER_STAGE_KALMAN,
+} gyroFilterStage_e;
+
+struct gyroSensor_s;
+typedef void (*gyroFilterChainFnPtr)(struct gyroSensor_s *gyroSensor, float *gyroADCf);
+
 typedef struct gyroSensor_s {
     gyroDev_t gyroDev;
     gyroCalibration_t calibration;
+    sensorAlignment_t alignment;
 
     // lowpass gyro soft filter
-    filterApplyFnPtr lowpassFilterApplyFn;
-    gyroLowpassFilter_t lowpassFilter[XYZ_AXIS_COUNT];
+    uint8_t lowpassFilterStage;
+    gyroLowpassFilter_t lowpassFilter;
 
     // lowpass2 gyro soft filter
-    filterApplyFnPtr lowpass2FilterApplyFn;
-    gyroLowpassFilter_t lowpass2Filter[XYZ_AXIS_COUNT];
+    uint8_t lowpass2FilterStage;
+    gyroLowpassFilter_t lowpass2Filter;
 
     // notch filters
-    filterApplyFnPtr notchFilter1ApplyFn;
-    biquadFilter_t notchFilter1[XYZ_AXIS_COUNT];
+    uint8_t notchFilter1Stage;
+    gyroBiquadFilterBank_t notchFilter1;
+
+    uint8_t notchFilter2Stage;
+    gyroBiquadFilterBank_t notchFilter2;
 
-    filterApplyFnPtr notchFilter2ApplyFn;
-    biquadFilter_t notchFilter2[XYZ_AXIS_COUNT];
+#ifdef USE_GYRO_DATA_ANALYSE
+    uint8_t notchFilterDynStage;
+    biquadFilterBank3_t notchFilterDyn[DYN_NOTCH_COUNT_MAX];
+#endif
 
-    filterApplyFnPtr notchFilterDynApplyFn;
-    biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT];
+    // static filter stages, specialised for the configured stages
+    gyroFilterChainFnPtr filterChainFn;
+#ifdef GYRO_FILTER_CHAIN_FIXED
+    bool filterChainFixed;
+#endif
 
     // overflow and recovery
     timeUs_t overflowTimeUs;
@@ -141,16 +202,25 @@ typedef struct gyroSensor_s {
 #ifdef USE_YAW_SPIN_RECOVERY
     timeUs_t yawSpinTimeUs;
     bool yawSpinDetected;
+    float yawSpinTriggerThreshold;  // yaw_spin_threshold in ADC counts
+    float yawSpinResetThreshold;
 #endif // USE_YAW_SPIN_RECOVERY
+    uint8_t healthStatus;           // gyroHealth_e flags of the samples of the latest read
 
 #ifdef USE_GYRO_DATA_ANALYSE
     gyroAnalyseState_t gyroAnalyseState;
 #endif
+
+#ifdef USE_RPM_FILTER
+    rpmFilterBank_t rpmFilter;
+#endif
 } gyroSensor_t;
 
 STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT gyroSensor_t gyroSensor1;
 #ifdef USE_DUAL_GYRO
 STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT gyroSensor_t gyroSensor2;
+// with GYRO_CONFIG_USE_GYRO_FUSED the samples of both sensors are combined and filtered by gyroSensor1
+static FAST_RAM_ZERO_INIT gyroFusion_t gyroFusion;
 #endif
 
 #ifdef UNIT_TEST
@@ -159,6 +229,9 @@ STATIC_UNIT_TESTED gyroDev_t * const gyroDevPtr = &gyroSensor1.gyroDev;
 #endif
 
 static void gyroInitSensorFilters(gyroSensor_t *gyroSensor);
+#ifdef USE_GYRO_TEMP_COMPENSATION
+static void gyroTempCompInit(gyroSensor_t *gyroSensor);
+#endif
 static void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int type, uint16_t lpfHz);
 
 #define DEBUG_GYRO_CALIBRATION 3
@@ -175,7 +248,19 @@ static void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int typ
 #define GYRO_OVERFLOW_TRIGGER_THRESHOLD 31980  // 97.5% full scale (1950dps for 2000dps gyro)
 #define GYRO_OVERFLOW_RESET_THRESHOLD 30340    // 92.5% full scale (1850dps for 2000dps gyro)
 
-PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 4);
+// Threshold flags of the latest samples, set as each sample is calibrated and aligned
+typedef enum {
+    GYRO_HEALTH_OVERFLOW_X = GYRO_OVERFLOW_X,
+    GYRO_HEALTH_OVERFLOW_Y = GYRO_OVERFLOW_Y,
+    GYRO_HEALTH_OVERFLOW_Z = GYRO_OVERFLOW_Z,
+    GYRO_HEALTH_ABOVE_OVERFLOW_RESET = 0x08,    // on any axis
+    GYRO_HEALTH_YAW_SPIN = 0x10,
+    GYRO_HEALTH_ABOVE_YAW_SPIN_RESET = 0x20,
+} gyroHealth_e;
+
+#define GYRO_HEALTH_OVERFLOW (GYRO_HEALTH_OVERFLOW_X | GYRO_HEALTH_OVERFLOW_Y | GYRO_HEALTH_OVERFLOW_Z)
+
+PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 10);
 
 #ifndef GYRO_CONFIG_USE_GYRO_DEFAULT
 #define GYRO_CONFIG_USE_GYRO_DEFAULT GYRO_CONFIG_USE_GYRO_1
@@ -205,8 +290,57 @@ PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
     .yaw_spin_threshold = 1950,
     .dyn_notch_quality = 70,
     .dyn_notch_width_percent = 50,
+    .dyn_notch_count = 1,
+    .dyn_notch_analyser = DYN_NOTCH_ANALYSER_FFT,
+    .dyn_notch_bins = DYN_NOTCH_BINS_16,
+    .dyn_notch_sample_hz = 1333,
+    .gyro_use_fifo = false,
+    .dyn_lpf_gyro_min_hz = 0,
+    .dyn_lpf_gyro_max_hz = 500,
+    .gyro_kalman_r = 100,
 );
 
+#ifdef USE_GYRO_TEMP_COMPENSATION
+PG_REGISTER_WITH_RESET_TEMPLATE(gyroBiasTable_t, gyroBiasTable, PG_GYRO_BIAS_TABLE, 0);
+
+PG_RESET_TEMPLATE(gyroBiasTable_t, gyroBiasTable,
+    .gyro_temp_compensation = true,
+    .validMask = 0,
+);
+
+// the temperature is read from the gyro loop, so the read never competes with the gyro for the bus
+#define GYRO_TEMPERATURE_READ_INTERVAL_US   1000000
+// a still window of this length gives one bias sample
+#define GYRO_BIAS_LEARN_WINDOW_US           2000000
+// fraction of a learned sample taken into its bin
+#define GYRO_BIAS_LEARN_RATE                0.125f
+// the table is saved when a bin is first learned or moves by more than this, in LSB
+#define GYRO_BIAS_SAVE_THRESHOLD_LSB        2.0f
+// the boot calibration is shortened by this when the table covers the temperature
+#define GYRO_BIAS_QUICK_CALIBRATION_DIVIDER 4
+// the quick calibration keeps the table value while the measured zero is this close, in LSB
+#define GYRO_BIAS_SANITY_THRESHOLD_LSB      8.0f
+
+typedef struct gyroTemperatureCompensation_s {
+    uint32_t temperatureInterval;       // gyro samples between temperature reads
+    uint32_t temperatureCountdown;
+    bool quickCalibration;
+    // the zero from the boot calibration and the table value at that temperature
+    bool haveReference;
+    float referenceZero[XYZ_AXIS_COUNT];
+    float referenceBias[XYZ_AXIS_COUNT];
+    // still window being accumulated by the learning
+    float sum[XYZ_AXIS_COUNT];
+    stdev_t var[XYZ_AXIS_COUNT];
+    uint32_t windowSamples;
+    uint32_t windowCount;
+    int16_t windowTemperature;
+    bool savePending;
+} gyroTemperatureCompensation_t;
+
+static FAST_RAM_ZERO_INIT gyroTemperatureCompensation_t gyroTempComp;
+#endif
+
 
 const busDevice_t *gyroSensorBus(void)
 {
@@ -221,6 +355,98 @@ const busDevice_t *gyroSensorBus(void)
 #endif
 }
 
+#ifdef USE_GYRO_INTERRUPT_PID
+/*
+ * Registers a function to be called from the data ready interrupt of the gyro in use.
+ * Returns false if the gyro has no working data ready interrupt, or if the gyro cannot be read from that interrupt
+ * because a device accessed from the main loop shares its bus, the interrupt would break into its transfers.
+ */
+bool gyroSetDataReadyFn(sensorGyroDataReadyFuncPtr dataReadyFn)
+{
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH || gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) {
+        // only the interrupt of the first gyro would be used, the second one would be read out of step
+        return false;
+    }
+    gyroDev_t *gyroDev = gyroToUse == GYRO_CONFIG_USE_GYRO_2 ? &gyroSensor2.gyroDev : &gyroSensor1.gyroDev;
+#else
+    gyroDev_t *gyroDev = &gyroSensor1.gyroDev;
+#endif
+    if (gyroDev->mpuIntExtiTag == IO_TAG_NONE) {
+        return false;
+    }
+#ifdef USE_SPI
+    // an I2C bus is not tracked, so only a gyro alone on its SPI bus qualifies
+    if (gyroDev->bus.bustype != BUSTYPE_SPI || spiBusIsShared(&gyroDev->bus)) {
+        return false;
+    }
+#else
+    return false;
+#endif
+#ifdef USE_GYRO_FIFO
+    if (gyroDev->fifoEnabled) {
+        // the interrupt fires for every sample, not once for each batch
+        return false;
+    }
+#endif
+
+    // check the interrupt is actually firing before relying on it
+    gyroDev->dataReady = false;
+    delayMicroseconds(4 * gyro.targetLooptime);
+    if (!gyroDev->dataReady) {
+        return false;
+    }
+
+    gyroDev->dataReadyFn = dataReadyFn;
+    return true;
+}
+#endif
+
+#ifdef USE_GYRO_ODR_TRACKING
+static const gyroDev_t *gyroDevInUse(void)
+{
+#ifdef USE_DUAL_GYRO
+    return gyroToUse == GYRO_CONFIG_USE_GYRO_2 ? &gyroSensor2.gyroDev : &gyroSensor1.gyroDev;
+#else
+    return &gyroSensor1.gyroDev;
+#endif
+}
+
+// Data ready interrupts in a gyro loop, the interrupt fires for every sample of a FIFO read
+static int gyroDataReadyPerLoop(const gyroDev_t *gyroDev)
+{
+#ifdef USE_GYRO_FIFO
+    if (gyroDev->fifoEnabled) {
+        return gyroDev->mpuDividerDrops + 1;
+    }
+#else
+    UNUSED(gyroDev);
+#endif
+    return 1;
+}
+
+// The gyro loop time measured against the data ready interrupts, the target loop time until they are tracked
+float gyroGetMeasuredLooptimeUs(void)
+{
+    const gyroDev_t *gyroDev = gyroDevInUse();
+    if (!gyroOdrTrackerIsLocked(gyroDev)) {
+        return gyro.targetLooptime;
+    }
+    return gyroOdrTrackerPeriodUs(gyroDev) * gyroDataReadyPerLoop(gyroDev);
+}
+
+// Sets the estimated time of the data ready interrupt that completes the sample of the next gyro loop, if it is tracked
+bool gyroGetNextLoopDataReadyUs(timeUs_t *dataReadyAtUs)
+{
+    const gyroDev_t *gyroDev = gyroDevInUse();
+    if (!gyroOdrTrackerIsLocked(gyroDev)) {
+        return false;
+    }
+    *dataReadyAtUs = gyroOdrTrackerDataReadyAtUs(gyroDev, gyroDataReadyPerLoop(gyroDev));
+    return true;
+}
+#endif
+
 #ifdef USE_GYRO_REGISTER_DUMP
 const busDevice_t *gyroSensorBusByDevice(uint8_t whichSensor)
 {
@@ -263,6 +489,21 @@ const mpuDetectionResult_t *gyroMpuDetectionResult(void)
 #endif
 }
 
+#ifdef USE_GYRO_DATA_ANALYSE
+const gyroAnalyseState_t *gyroAnalyseState(void)
+{
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
+        return &gyroSensor2.gyroAnalyseState;
+    } else {
+        return &gyroSensor1.gyroAnalyseState;
+    }
+#else
+    return &gyroSensor1.gyroAnalyseState;
+#endif
+}
+#endif
+
 STATIC_UNIT_TESTED gyroSensor_e gyroDetect(gyroDev_t *dev)
 {
     gyroSensor_e gyroHardware = GYRO_DEFAULT;
@@ -471,10 +712,41 @@ static bool gyroInitSensor(gyroSensor_t *gyroSensor)
     gyro.targetLooptime = gyroSetSampleRate(&gyroSensor->gyroDev, gyroConfig()->gyro_hardware_lpf, gyroConfig()->gyro_sync_denom, gyroConfig()->gyro_use_32khz);
     gyroSensor->gyroDev.hardware_lpf = gyroConfig()->gyro_hardware_lpf;
     gyroSensor->gyroDev.hardware_32khz_lpf = gyroConfig()->gyro_32khz_hardware_lpf;
+    gyro.sampleLooptime = gyro.targetLooptime;
+#ifdef USE_GYRO_FIFO
+    switch (gyroHardware) {
+    case GYRO_MPU6500:
+    case GYRO_ICM20601:
+    case GYRO_ICM20602:
+    case GYRO_ICM20608G:
+    case GYRO_ICM20689:
+        // only worthwhile if samples are being dropped, the filter sample rate is shared so not when using both gyros
+        gyroSensor->gyroDev.useFifo = gyroConfig()->gyro_use_fifo && gyroSensor->gyroDev.mpuDividerDrops > 0
+            && gyroConfig()->gyro_to_use != GYRO_CONFIG_USE_GYRO_BOTH && gyroConfig()->gyro_to_use != GYRO_CONFIG_USE_GYRO_FUSED;
+        break;
+    default:
+        gyroSensor->gyroDev.useFifo = false;
+        break;
+    }
+#endif
     gyroSensor->gyroDev.initFn(&gyroSensor->gyroDev);
+#ifdef USE_GYRO_FIFO
+    if (gyroSensor->gyroDev.fifoEnabled) {
+        gyro.sampleLooptime = gyro.targetLooptime / (gyroSensor->gyroDev.mpuDividerDrops + 1);
+    }
+#endif
+#ifdef USE_GYRO_ODR_TRACKING
+    gyroOdrTrackerInit(&gyroSensor->gyroDev, (float)gyro.targetLooptime / gyroDataReadyPerLoop(&gyroSensor->gyroDev));
+#endif
     if (gyroConfig()->gyro_align != ALIGN_DEFAULT) {
         gyroSensor->gyroDev.gyroAlign = gyroConfig()->gyro_align;
     }
+    buildSensorAlignment(&gyroSensor->alignment, gyroSensor->gyroDev.gyroAlign);
+#ifdef USE_GYRO_TEMP_COMPENSATION
+    if (gyroSensor == &gyroSensor1) {
+        gyroTempCompInit(gyroSensor);
+    }
+#endif
 
     // As new gyros are supported, be sure to add them below based on whether they are subject to the overflow/inversion bug
     // Any gyro not explicitly defined will default to not having built-in overflow protection as a safe alternative.
@@ -506,6 +778,11 @@ static bool gyroInitSensor(gyroSensor_t *gyroSensor)
         break;
     }
 
+#ifdef USE_YAW_SPIN_RECOVERY
+    gyroSensor->yawSpinTriggerThreshold = gyroConfig()->yaw_spin_threshold / gyroSensor->gyroDev.scale;
+    gyroSensor->yawSpinResetThreshold = (gyroConfig()->yaw_spin_threshold - 100.0f) / gyroSensor->gyroDev.scale;
+#endif
+
     gyroInitSensorFilters(gyroSensor);
 
 #ifdef USE_GYRO_DATA_ANALYSE
@@ -546,8 +823,8 @@ bool gyroInit(void)
     gyroToUse = gyroConfig()->gyro_to_use;
 
 #if defined(USE_DUAL_GYRO) && defined(GYRO_1_CS_PIN)
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
-        gyroSensor1.gyroDev.bus.busdev_u.spi.csnPin = IOGetByTag(IO_TAG(GYRO_1_CS_PIN));
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH || gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) {
+        spiBusSetCsPin(&gyroSensor1.gyroDev.bus, IOGetByTag(IO_TAG(GYRO_1_CS_PIN)));
         IOInit(gyroSensor1.gyroDev.bus.busdev_u.spi.csnPin, OWNER_MPU_CS, RESOURCE_INDEX(0));
         IOHi(gyroSensor1.gyroDev.bus.busdev_u.spi.csnPin); // Ensure device is disabled, important when two devices are on the same bus.
         IOConfigGPIO(gyroSensor1.gyroDev.bus.busdev_u.spi.csnPin, SPI_IO_CS_CFG);
@@ -555,8 +832,8 @@ bool gyroInit(void)
 #endif
 
 #if defined(USE_DUAL_GYRO) && defined(GYRO_2_CS_PIN)
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
-        gyroSensor2.gyroDev.bus.busdev_u.spi.csnPin = IOGetByTag(IO_TAG(GYRO_2_CS_PIN));
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH || gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) {
+        spiBusSetCsPin(&gyroSensor2.gyroDev.bus, IOGetByTag(IO_TAG(GYRO_2_CS_PIN)));
         IOInit(gyroSensor2.gyroDev.bus.busdev_u.spi.csnPin, OWNER_MPU_CS, RESOURCE_INDEX(1));
         IOHi(gyroSensor2.gyroDev.bus.busdev_u.spi.csnPin); // Ensure device is disabled, important when two devices are on the same bus.
         IOConfigGPIO(gyroSensor2.gyroDev.bus.busdev_u.spi.csnPin, SPI_IO_CS_CFG);
@@ -580,7 +857,7 @@ bool gyroInit(void)
 #endif
     gyroSensor1.gyroDev.bus.bustype = BUSTYPE_SPI;
     spiBusSetInstance(&gyroSensor1.gyroDev.bus, GYRO_1_SPI_INSTANCE);
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH || gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) {
         ret = gyroInitSensor(&gyroSensor1);
         if (!ret) {
             return false; // TODO handle failure of first gyro detection better. - Perhaps update the config to use second gyro then indicate a new failure mode and reboot.
@@ -608,7 +885,7 @@ bool gyroInit(void)
 #endif
     gyroSensor2.gyroDev.bus.bustype = BUSTYPE_SPI;
     spiBusSetInstance(&gyroSensor2.gyroDev.bus, GYRO_2_SPI_INSTANCE);
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH || gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) {
         ret = gyroInitSensor(&gyroSensor2);
         if (!ret) {
             return false; // TODO handle failure of second gyro detection better. - Perhaps update the config to use first gyro then indicate a new failure mode and reboot.
@@ -619,8 +896,8 @@ bool gyroInit(void)
 
 #ifdef USE_DUAL_GYRO
     // Only allow using both gyros simultaneously if they are the same hardware type.
-    // If the user selected "BOTH" and they are not the same type, then reset to using only the first gyro.
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    // If the user selected "BOTH" or "FUSED" and they are not the same type, then reset to using only the first gyro.
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH || gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) {
         if (gyroSensor1.gyroDev.gyroHardware != gyroSensor2.gyroDev.gyroHardware) {
             gyroToUse = GYRO_CONFIG_USE_GYRO_1;
             gyroConfigMutable()->gyro_to_use = GYRO_CONFIG_USE_GYRO_1;
@@ -635,18 +912,18 @@ bool gyroInit(void)
 
 void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int type, uint16_t lpfHz)
 {
-    filterApplyFnPtr *lowpassFilterApplyFn;
+    uint8_t *lowpassFilterStage;
     gyroLowpassFilter_t *lowpassFilter = NULL;
 
     switch (slot) {
     case FILTER_LOWPASS:
-        lowpassFilterApplyFn = &gyroSensor->lowpassFilterApplyFn;
-        lowpassFilter = gyroSensor->lowpassFilter;
+        lowpassFilterStage = &gyroSensor->lowpassFilterStage;
+        lowpassFilter = &gyroSensor->lowpassFilter;
         break;
 
     case FILTER_LOWPASS2:
-        lowpassFilterApplyFn = &gyroSensor->lowpass2FilterApplyFn;
-        lowpassFilter = gyroSensor->lowpass2Filter;
+        lowpassFilterStage = &gyroSensor->lowpass2FilterStage;
+        lowpassFilter = &gyroSensor->lowpass2Filter;
         break;
 
     default:
@@ -654,30 +931,35 @@ void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int type, uint
     }
 
     // Establish some common constants
-    const uint32_t gyroFrequencyNyquist = 1000000 / 2 / gyro.targetLooptime;
-    const float gyroDt = gyro.targetLooptime * 1e-6f;
+    const uint32_t gyroFrequencyNyquist = 1000000 / 2 / gyro.sampleLooptime;
+    const float gyroDt = gyro.sampleLooptime * 1e-6f;
 
     // Gain could be calculated a little later as it is specific to the pt1/bqrcf2/fkf branches
     const float gain = pt1FilterGain(lpfHz, gyroDt);
 
-    // Dereference the pointer to null before checking valid cutoff and filter
+    // Disable the stage before checking valid cutoff and filter
     // type. It will be overridden for positive cases.
-    *lowpassFilterApplyFn = &nullFilterApply;
+    *lowpassFilterStage = GYRO_FILTER_STAGE_NONE;
 
     // If lowpass cutoff has been specified and is less than the Nyquist frequency
     if (lpfHz && lpfHz <= gyroFrequencyNyquist) {
         switch (type) {
+        case FILTER_KALMAN:
+#ifndef USE_GYRO_FILTER_FIXED_POINT
+            // the gains follow the noise, at the configured noise they are those of a PT1 at the cutoff
+            *lowpassFilterStage = GYRO_FILTER_STAGE_KALMAN;
+            kalmanFilterBank3Init(&lowpassFilter->kalmanFilterState, kalmanFilterProcessNoise(gain, gyroConfig()->gyro_kalman_r), gyroConfig()->gyro_kalman_r);
+            break;
+#endif
+            // no float filters without an FPU, the PT1 is the nearest
+            FALLTHROUGH;
         case FILTER_PT1:
-            *lowpassFilterApplyFn = (filterApplyFnPtr) pt1FilterApply;
-            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                pt1FilterInit(&lowpassFilter[axis].pt1FilterState, gain);
-            }
+            *lowpassFilterStage = GYRO_FILTER_STAGE_PT1;
+            gyroPt1FilterBankInit(&lowpassFilter->pt1FilterState, gain);
             break;
         case FILTER_BIQUAD:
-            *lowpassFilterApplyFn = (filterApplyFnPtr) biquadFilterApply;
-            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                biquadFilterInitLPF(&lowpassFilter[axis].biquadFilterState, lpfHz, gyro.targetLooptime);
-            }
+            *lowpassFilterStage = GYRO_FILTER_STAGE_BIQUAD;
+            gyroBiquadFilterBankInitLPF(&lowpassFilter->biquadFilterState, lpfHz, gyro.sampleLooptime);
             break;
         }
     }
@@ -685,7 +967,7 @@ void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int type, uint
 
 static uint16_t calculateNyquistAdjustedNotchHz(uint16_t notchHz, uint16_t notchCutoffHz)
 {
-    const uint32_t gyroFrequencyNyquist = 1000000 / 2 / gyro.targetLooptime;
+    const uint32_t gyroFrequencyNyquist = 1000000 / 2 / gyro.sampleLooptime;
     if (notchHz > gyroFrequencyNyquist) {
         if (notchCutoffHz < gyroFrequencyNyquist) {
             notchHz = gyroFrequencyNyquist;
@@ -708,31 +990,27 @@ void gyroInitSlewLimiter(gyroSensor_t *gyroSensor) {
 
 static void gyroInitFilterNotch1(gyroSensor_t *gyroSensor, uint16_t notchHz, uint16_t notchCutoffHz)
 {
-    gyroSensor->notchFilter1ApplyFn = nullFilterApply;
+    gyroSensor->notchFilter1Stage = GYRO_FILTER_STAGE_NONE;
 
     notchHz = calculateNyquistAdjustedNotchHz(notchHz, notchCutoffHz);
 
     if (notchHz != 0 && notchCutoffHz != 0) {
-        gyroSensor->notchFilter1ApplyFn = (filterApplyFnPtr)biquadFilterApply;
+        gyroSensor->notchFilter1Stage = GYRO_FILTER_STAGE_BIQUAD;
         const float notchQ = filterGetNotchQ(notchHz, notchCutoffHz);
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            biquadFilterInit(&gyroSensor->notchFilter1[axis], notchHz, gyro.targetLooptime, notchQ, FILTER_NOTCH);
-        }
+        gyroBiquadFilterBankInit(&gyroSensor->notchFilter1, notchHz, gyro.sampleLooptime, notchQ, FILTER_NOTCH);
     }
 }
 
 static void gyroInitFilterNotch2(gyroSensor_t *gyroSensor, uint16_t notchHz, uint16_t notchCutoffHz)
 {
-    gyroSensor->notchFilter2ApplyFn = nullFilterApply;
+    gyroSensor->notchFilter2Stage = GYRO_FILTER_STAGE_NONE;
 
     notchHz = calculateNyquistAdjustedNotchHz(notchHz, notchCutoffHz);
 
     if (notchHz != 0 && notchCutoffHz != 0) {
-        gyroSensor->notchFilter2ApplyFn = (filterApplyFnPtr)biquadFilterApply;
+        gyroSensor->notchFilter2Stage = GYRO_FILTER_STAGE_BIQUAD;
         const float notchQ = filterGetNotchQ(notchHz, notchCutoffHz);
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            biquadFilterInit(&gyroSensor->notchFilter2[axis], notchHz, gyro.targetLooptime, notchQ, FILTER_NOTCH);
-        }
+        gyroBiquadFilterBankInit(&gyroSensor->notchFilter2, notchHz, gyro.sampleLooptime, notchQ, FILTER_NOTCH);
     }
 }
 
@@ -744,18 +1022,241 @@ static bool isDynamicFilterActive(void)
 
 static void gyroInitFilterDynamicNotch(gyroSensor_t *gyroSensor)
 {
-    gyroSensor->notchFilterDynApplyFn = nullFilterApply;
+    gyroSensor->notchFilterDynStage = GYRO_FILTER_STAGE_NONE;
 
     if (isDynamicFilterActive()) {
-        gyroSensor->notchFilterDynApplyFn = (filterApplyFnPtr)biquadFilterApplyDF1; // must be this function, not DF2
+        gyroSensor->notchFilterDynStage = GYRO_FILTER_STAGE_BIQUAD; // applied as DF1, not DF2, since it is retuned on the fly
         const float notchQ = filterGetNotchQ(400, 390); //just any init value
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            biquadFilterInit(&gyroSensor->notchFilterDyn[axis], 400, gyro.targetLooptime, notchQ, FILTER_NOTCH);
+        for (int n = 0; n < DYN_NOTCH_COUNT_MAX; n++) {
+            biquadFilterBank3Init(&gyroSensor->notchFilterDyn[n], 400, gyro.sampleLooptime, notchQ, FILTER_NOTCH);
+        }
+    }
+}
+#endif
+
+__attribute__((always_inline)) static inline void gyroApplyLowpassStage(uint8_t stage, gyroLowpassFilter_t *filter, gyroFilterSample_t *samples)
+{
+    switch (stage) {
+    case GYRO_FILTER_STAGE_PT1:
+        gyroPt1FilterBankApply(&filter->pt1FilterState, samples);
+        break;
+    case GYRO_FILTER_STAGE_BIQUAD:
+        gyroBiquadFilterBankApply(&filter->biquadFilterState, samples);
+        break;
+#ifndef USE_GYRO_FILTER_FIXED_POINT
+    case GYRO_FILTER_STAGE_KALMAN:
+        kalmanFilterBank3Apply(&filter->kalmanFilterState, samples);
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+// Runs the three axes through the static filter stages, when the stages are constants the disabled ones compile away
+__attribute__((always_inline)) static inline void gyroApplyFilterChain(gyroSensor_t *gyroSensor, float *gyroADCf,
+    uint8_t notchFilter1Stage, uint8_t notchFilter2Stage, uint8_t lowpassFilterStage, uint8_t lowpass2FilterStage)
+{
+#ifdef USE_GYRO_FILTER_FIXED_POINT
+    gyroFilterSample_t samples[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        samples[axis] = filterFloatToFixed(gyroADCf[axis]);
+    }
+#else
+    gyroFilterSample_t *samples = gyroADCf;
+#endif
+
+    if (notchFilter1Stage != GYRO_FILTER_STAGE_NONE) {
+        gyroBiquadFilterBankApply(&gyroSensor->notchFilter1, samples);
+    }
+    if (notchFilter2Stage != GYRO_FILTER_STAGE_NONE) {
+        gyroBiquadFilterBankApply(&gyroSensor->notchFilter2, samples);
+    }
+    gyroApplyLowpassStage(lowpassFilterStage, &gyroSensor->lowpassFilter, samples);
+    gyroApplyLowpassStage(lowpass2FilterStage, &gyroSensor->lowpass2Filter, samples);
+
+#ifdef USE_GYRO_FILTER_FIXED_POINT
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroADCf[axis] = filterFixedToFloat(samples[axis]);
+    }
+#endif
+}
+
+static FAST_CODE void gyroFilterChainGeneric(gyroSensor_t *gyroSensor, float *gyroADCf)
+{
+    gyroApplyFilterChain(gyroSensor, gyroADCf, gyroSensor->notchFilter1Stage, gyroSensor->notchFilter2Stage,
+        gyroSensor->lowpassFilterStage, gyroSensor->lowpass2FilterStage);
+}
+
+#define NONE    GYRO_FILTER_STAGE_NONE
+#define PT1     GYRO_FILTER_STAGE_PT1
+#define BIQUAD  GYRO_FILTER_STAGE_BIQUAD
+
+// Specialised chains for the common combinations of notch1, notch2, lowpass and lowpass2
+#define GYRO_FILTER_CHAIN(notch1, notch2, lowpass, lowpass2) \
+static FAST_CODE void gyroFilterChain_ ## notch1 ## _ ## notch2 ## _ ## lowpass ## _ ## lowpass2(gyroSensor_t *gyroSensor, float *gyroADCf) \
+{ \
+    gyroApplyFilterChain(gyroSensor, gyroADCf, notch1, notch2, lowpass, lowpass2); \
+}
+
+GYRO_FILTER_CHAIN(NONE, NONE, NONE, NONE)
+GYRO_FILTER_CHAIN(NONE, NONE, PT1, NONE)
+GYRO_FILTER_CHAIN(NONE, NONE, PT1, PT1)
+GYRO_FILTER_CHAIN(NONE, NONE, BIQUAD, NONE)
+GYRO_FILTER_CHAIN(NONE, NONE, BIQUAD, PT1)
+GYRO_FILTER_CHAIN(BIQUAD, NONE, PT1, PT1)
+GYRO_FILTER_CHAIN(BIQUAD, BIQUAD, PT1, PT1)
+GYRO_FILTER_CHAIN(BIQUAD, BIQUAD, BIQUAD, PT1)
+
+typedef struct gyroFilterChain_s {
+    uint8_t notchFilter1Stage;
+    uint8_t notchFilter2Stage;
+    uint8_t lowpassFilterStage;
+    uint8_t lowpass2FilterStage;
+    gyroFilterChainFnPtr fn;
+} gyroFilterChain_t;
+
+#define GYRO_FILTER_CHAIN_ENTRY(notch1, notch2, lowpass, lowpass2) \
+    { notch1, notch2, lowpass, lowpass2, gyroFilterChain_ ## notch1 ## _ ## notch2 ## _ ## lowpass ## _ ## lowpass2 }
+
+static const gyroFilterChain_t gyroFilterChains[] = {
+    GYRO_FILTER_CHAIN_ENTRY(NONE, NONE, NONE, NONE),
+    GYRO_FILTER_CHAIN_ENTRY(NONE, NONE, PT1, NONE),
+    GYRO_FILTER_CHAIN_ENTRY(NONE, NONE, PT1, PT1),
+    GYRO_FILTER_CHAIN_ENTRY(NONE, NONE, BIQUAD, NONE),
+    GYRO_FILTER_CHAIN_ENTRY(NONE, NONE, BIQUAD, PT1),
+    GYRO_FILTER_CHAIN_ENTRY(BIQUAD, NONE, PT1, PT1),
+    GYRO_FILTER_CHAIN_ENTRY(BIQUAD, BIQUAD, PT1, PT1),
+    GYRO_FILTER_CHAIN_ENTRY(BIQUAD, BIQUAD, BIQUAD, PT1),
+};
+
+#undef GYRO_FILTER_CHAIN
+#undef GYRO_FILTER_CHAIN_ENTRY
+#undef NONE
+#undef PT1
+#undef BIQUAD
+
+static bool gyroFilterChainMatches(const gyroSensor_t *gyroSensor, uint8_t notchFilter1Stage, uint8_t notchFilter2Stage, uint8_t lowpassFilterStage, uint8_t lowpass2FilterStage)
+{
+    return gyroSensor->notchFilter1Stage == notchFilter1Stage && gyroSensor->notchFilter2Stage == notchFilter2Stage
+        && gyroSensor->lowpassFilterStage == lowpassFilterStage && gyroSensor->lowpass2FilterStage == lowpass2FilterStage;
+}
+
+// Selects the chain function once the stages are initialised, falling back to the generic chain for uncommon combinations
+static void gyroInitFilterChain(gyroSensor_t *gyroSensor)
+{
+#ifdef GYRO_FILTER_CHAIN_FIXED
+    gyroSensor->filterChainFixed = gyroFilterChainMatches(gyroSensor, GYRO_FILTER_CHAIN_FIXED);
+#endif
+    gyroSensor->filterChainFn = gyroFilterChainGeneric;
+    for (unsigned i = 0; i < ARRAYLEN(gyroFilterChains); i++) {
+        const gyroFilterChain_t *chain = &gyroFilterChains[i];
+        if (gyroFilterChainMatches(gyroSensor, chain->notchFilter1Stage, chain->notchFilter2Stage, chain->lowpassFilterStage, chain->lowpass2FilterStage)) {
+            gyroSensor->filterChainFn = chain->fn;
+            break;
         }
     }
 }
+
+// A target built for a fixed filter configuration can define GYRO_FILTER_CHAIN_FIXED as its four stages, eg
+// #define GYRO_FILTER_CHAIN_FIXED GYRO_FILTER_STAGE_NONE, GYRO_FILTER_STAGE_NONE, GYRO_FILTER_STAGE_PT1, GYRO_FILTER_STAGE_PT1
+static FAST_CODE void gyroApplyStaticFilters(gyroSensor_t *gyroSensor, float *gyroADCf)
+{
+#ifdef GYRO_FILTER_CHAIN_FIXED
+    // the chain the target is built for is inlined, other configurations still work through the chain function
+    if (gyroSensor->filterChainFixed) {
+        gyroApplyFilterChain(gyroSensor, gyroADCf, GYRO_FILTER_CHAIN_FIXED);
+        return;
+    }
 #endif
+    gyroSensor->filterChainFn(gyroSensor, gyroADCf);
+}
+
+#ifdef USE_DYN_LPF
+typedef union gyroDynLpfTable_u {
+    pt1GainTable_t pt1Gain;
+    biquadLowpassTable_t biquadLowpass;
+} gyroDynLpfTable_t;
+
+static FAST_RAM_ZERO_INIT uint8_t dynLpfStage;
+static FAST_RAM_ZERO_INIT float dynLpfMinHz;
+static FAST_RAM_ZERO_INIT float dynLpfRangeHz;
+static gyroDynLpfTable_t dynLpfTable;
 
+static bool gyroDynLpfEnabled(void)
+{
+    return gyroConfig()->dyn_lpf_gyro_min_hz > 0;
+}
+#endif
+
+// The first lowpass starts at the minimum cutoff of the dynamic lowpass when it is enabled
+static uint16_t gyroLowpassHz(void)
+{
+#ifdef USE_DYN_LPF
+    if (gyroDynLpfEnabled()) {
+        return gyroConfig()->dyn_lpf_gyro_min_hz;
+    }
+#endif
+    return gyroConfig()->gyro_lowpass_hz;
+}
+
+#ifdef USE_DYN_LPF
+// Builds the table of the first lowpass stage between the minimum and maximum cutoff, the stage is already initialised
+static void gyroInitDynLpf(void)
+{
+    dynLpfStage = GYRO_FILTER_STAGE_NONE;
+    if (!gyroDynLpfEnabled()) {
+        return;
+    }
+
+    const uint32_t gyroFrequencyNyquist = 1000000 / 2 / gyro.sampleLooptime;
+    const uint16_t minHz = gyroConfig()->dyn_lpf_gyro_min_hz;
+    const uint16_t maxHz = constrain(gyroConfig()->dyn_lpf_gyro_max_hz, minHz, gyroFrequencyNyquist);
+
+    dynLpfMinHz = minHz;
+    dynLpfRangeHz = maxHz - minHz;
+    switch (gyroSensor1.lowpassFilterStage) {
+    case GYRO_FILTER_STAGE_PT1:
+        pt1GainTableInit(&dynLpfTable.pt1Gain, minHz, maxHz, gyro.sampleLooptime * 1e-6f);
+        break;
+    case GYRO_FILTER_STAGE_BIQUAD:
+        biquadLowpassTableInit(&dynLpfTable.biquadLowpass, minHz, maxHz, gyro.sampleLooptime);
+        break;
+    default:
+        return;
+    }
+    dynLpfStage = gyroSensor1.lowpassFilterStage;
+}
+
+static FAST_CODE void gyroSensorUpdateDynLpf(gyroSensor_t *gyroSensor, float cutoffHz)
+{
+    switch (dynLpfStage) {
+    case GYRO_FILTER_STAGE_PT1:
+        gyroSensor->lowpassFilter.pt1FilterState.k = pt1GainFromTable(&dynLpfTable.pt1Gain, cutoffHz);
+        break;
+    case GYRO_FILTER_STAGE_BIQUAD:
+        biquadFilterBank3SetLowpassFromTable(&gyroSensor->lowpassFilter.biquadFilterState, &dynLpfTable.biquadLowpass, cutoffHz);
+        break;
+    default:
+        break;
+    }
+}
+
+// Moves the cutoff of the first lowpass between the minimum and maximum with the throttle, from 0 to 1
+FAST_CODE void gyroUpdateDynLpf(float throttle)
+{
+    if (dynLpfStage == GYRO_FILTER_STAGE_NONE) {
+        return;
+    }
+
+    const float cutoffHz = dynLpfMinHz + constrainf(throttle, 0.0f, 1.0f) * dynLpfRangeHz;
+    gyroSensorUpdateDynLpf(&gyroSensor1, cutoffHz);
+#ifdef USE_DUAL_GYRO
+    gyroSensorUpdateDynLpf(&gyroSensor2, cutoffHz);
+#endif
+    DEBUG_SET(DEBUG_DYN_LPF, 0, lrintf(cutoffHz));
+}
+#endif
 
 static void gyroInitSensorFilters(gyroSensor_t *gyroSensor)
 {
@@ -767,7 +1268,7 @@ static void gyroInitSensorFilters(gyroSensor_t *gyroSensor)
       gyroSensor,
       FILTER_LOWPASS,
       gyroConfig()->gyro_lowpass_type,
-      gyroConfig()->gyro_lowpass_hz
+      gyroLowpassHz()
     );
 
     gyroInitLowpassFilterLpf(
@@ -782,6 +1283,11 @@ static void gyroInitSensorFilters(gyroSensor_t *gyroSensor)
 #ifdef USE_GYRO_DATA_ANALYSE
     gyroInitFilterDynamicNotch(gyroSensor);
 #endif
+#ifdef USE_RPM_FILTER
+    rpmFilterBankInit(&gyroSensor->rpmFilter, gyro.sampleLooptime, gyro.targetLooptime);
+#endif
+
+    gyroInitFilterChain(gyroSensor);
 }
 
 void gyroInitFilters(void)
@@ -789,6 +1295,10 @@ void gyroInitFilters(void)
     gyroInitSensorFilters(&gyroSensor1);
 #ifdef USE_DUAL_GYRO
     gyroInitSensorFilters(&gyroSensor2);
+    gyroFusionInit(&gyroFusion, gyro.targetLooptime);
+#endif
+#ifdef USE_DYN_LPF
+    gyroInitDynLpf();
 #endif
 }
 
@@ -808,7 +1318,8 @@ FAST_CODE bool isGyroCalibrationComplete(void)
         case GYRO_CONFIG_USE_GYRO_2: {
             return isGyroSensorCalibrationComplete(&gyroSensor2);
         }
-        case GYRO_CONFIG_USE_GYRO_BOTH: {
+        case GYRO_CONFIG_USE_GYRO_BOTH:
+        case GYRO_CONFIG_USE_GYRO_FUSED: {
             return isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2);
         }
     }
@@ -817,6 +1328,148 @@ FAST_CODE bool isGyroCalibrationComplete(void)
 #endif
 }
 
+#ifdef USE_GYRO_TEMP_COMPENSATION
+static int gyroBiasTableBin(int16_t temperature)
+{
+    const int bin = (temperature - GYRO_BIAS_TABLE_TEMPERATURE_MIN) / GYRO_BIAS_TABLE_BIN_WIDTH;
+    if (temperature < GYRO_BIAS_TABLE_TEMPERATURE_MIN || bin >= GYRO_BIAS_TABLE_BINS) {
+        return -1;
+    }
+    return bin;
+}
+
+static bool gyroBiasTableBinValid(const gyroBiasTable_t *table, int bin)
+{
+    return bin >= 0 && bin < GYRO_BIAS_TABLE_BINS && (table->validMask & (1 << bin));
+}
+
+// Bias in LSB at the temperature, interpolated towards the neighbouring bin when it is learned
+STATIC_UNIT_TESTED bool gyroBiasTableLookup(const gyroBiasTable_t *table, int16_t temperature, float *bias)
+{
+    const int bin = gyroBiasTableBin(temperature);
+    if (!gyroBiasTableBinValid(table, bin)) {
+        return false;
+    }
+
+    const float centre = GYRO_BIAS_TABLE_TEMPERATURE_MIN + GYRO_BIAS_TABLE_BIN_WIDTH * (bin + 0.5f);
+    const int neighbour = temperature >= centre ? bin + 1 : bin - 1;
+    const float weight = gyroBiasTableBinValid(table, neighbour) ? fabsf(temperature - centre) / GYRO_BIAS_TABLE_BIN_WIDTH : 0.0f;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float value = table->bias[bin][axis];
+        const float neighbourValue = weight > 0.0f ? table->bias[neighbour][axis] : value;
+        bias[axis] = (value + (neighbourValue - value) * weight) / GYRO_BIAS_TABLE_SCALE;
+    }
+    return true;
+}
+
+static void gyroBiasTableLearn(int16_t temperature, const float *zero)
+{
+    const int bin = gyroBiasTableBin(temperature);
+    if (bin < 0) {
+        return;
+    }
+
+    gyroBiasTable_t *table = gyroBiasTableMutable();
+    const bool valid = gyroBiasTableBinValid(table, bin);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float current = (float)table->bias[bin][axis] / GYRO_BIAS_TABLE_SCALE;
+        const float updated = valid ? current + (zero[axis] - current) * GYRO_BIAS_LEARN_RATE : zero[axis];
+        if (!valid || fabsf(updated - current) > GYRO_BIAS_SAVE_THRESHOLD_LSB) {
+            gyroTempComp.savePending = true;
+        }
+        table->bias[bin][axis] = constrain(lrintf(updated * GYRO_BIAS_TABLE_SCALE), INT16_MIN, INT16_MAX);
+    }
+    table->validMask |= 1 << bin;
+}
+
+static void gyroTempCompInit(gyroSensor_t *gyroSensor)
+{
+    if (gyroSensor->gyroDev.temperatureFn) {
+        gyroSensor->gyroDev.temperatureFn(&gyroSensor->gyroDev, &gyroSensor->gyroDev.temperature);
+    }
+    gyroTempComp.temperatureInterval = MAX(GYRO_TEMPERATURE_READ_INTERVAL_US / gyro.targetLooptime, 1U);
+    gyroTempComp.temperatureCountdown = gyroTempComp.temperatureInterval;
+    gyroTempComp.windowSamples = MAX(GYRO_BIAS_LEARN_WINDOW_US / gyro.targetLooptime, 1U);
+    gyroTempComp.windowCount = 0;
+    gyroTempComp.haveReference = false;
+}
+
+static bool gyroTempCompActive(const gyroSensor_t *gyroSensor)
+{
+    return gyroSensor == &gyroSensor1 && gyroSensor->gyroDev.temperatureFn && gyroBiasTable()->gyro_temp_compensation;
+}
+
+// Moves the zero offset with the temperature, relative to the boot calibration
+static void gyroTempCompApply(gyroSensor_t *gyroSensor)
+{
+    float bias[XYZ_AXIS_COUNT];
+    if (!gyroTempComp.haveReference || !gyroBiasTableLookup(gyroBiasTable(), gyroSensor->gyroDev.temperature, bias)) {
+        return;
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroSensor->gyroDev.gyroZero[axis] = gyroTempComp.referenceZero[axis] + bias[axis] - gyroTempComp.referenceBias[axis];
+    }
+    gyroSensor->gyroDev.gyroZero[Z] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
+}
+
+// Accumulates still windows of raw samples while disarmed, each one is a bias sample for its bin
+static void gyroTempCompLearn(const gyroSensor_t *gyroSensor, uint8_t gyroMovementCalibrationThreshold)
+{
+    if (gyroTempComp.windowCount == 0) {
+        gyroTempComp.windowTemperature = gyroSensor->gyroDev.temperature;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyroTempComp.sum[axis] = 0.0f;
+            devClear(&gyroTempComp.var[axis]);
+        }
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroTempComp.sum[axis] += gyroSensor->gyroDev.gyroADCRaw[axis];
+        devPush(&gyroTempComp.var[axis], gyroSensor->gyroDev.gyroADCRaw[axis]);
+    }
+    if (++gyroTempComp.windowCount < gyroTempComp.windowSamples) {
+        return;
+    }
+    gyroTempComp.windowCount = 0;
+
+    if (gyroBiasTableBin(gyroTempComp.windowTemperature) != gyroBiasTableBin(gyroSensor->gyroDev.temperature)) {
+        return;
+    }
+    float zero[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (gyroMovementCalibrationThreshold && devStandardDeviation(&gyroTempComp.var[axis]) > gyroMovementCalibrationThreshold) {
+            return;
+        }
+        zero[axis] = gyroTempComp.sum[axis] / gyroTempComp.windowSamples;
+    }
+    gyroBiasTableLearn(gyroSensor->gyroDev.temperature, zero);
+}
+
+static FAST_CODE_NOINLINE void gyroTempCompUpdate(gyroSensor_t *gyroSensor)
+{
+    if (--gyroTempComp.temperatureCountdown == 0) {
+        gyroTempComp.temperatureCountdown = gyroTempComp.temperatureInterval;
+        gyroSensor->gyroDev.temperatureFn(&gyroSensor->gyroDev, &gyroSensor->gyroDev.temperature);
+        gyroTempCompApply(gyroSensor);
+    }
+    if (!ARMING_FLAG(ARMED)) {
+        gyroTempCompLearn(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
+    }
+}
+
+// Called from a task, the table is written once the craft is disarmed
+void gyroSaveBiasTableIfUpdated(void)
+{
+    if (gyroTempComp.savePending && !ARMING_FLAG(ARMED) && isGyroCalibrationComplete()) {
+        gyroTempComp.savePending = false;
+        writeEEPROM();
+    }
+}
+#else
+void gyroSaveBiasTableIfUpdated(void)
+{
+}
+#endif
+
 static bool isOnFinalGyroCalibrationCycle(const gyroCalibration_t *gyroCalibration)
 {
     return gyroCalibration->cyclesRemaining == 1;
@@ -829,12 +1482,22 @@ static int32_t gyroCalculateCalibratingCycles(void)
 
 static bool isOnFirstGyroCalibrationCycle(const gyroCalibration_t *gyroCalibration)
 {
-    return gyroCalibration->cyclesRemaining == gyroCalculateCalibratingCycles();
+    return gyroCalibration->cycles && gyroCalibration->cyclesRemaining == gyroCalibration->cycles;
 }
 
 static void gyroSetCalibrationCycles(gyroSensor_t *gyroSensor)
 {
-    gyroSensor->calibration.cyclesRemaining = gyroCalculateCalibratingCycles();
+    int32_t cycles = gyroCalculateCalibratingCycles();
+#ifdef USE_GYRO_TEMP_COMPENSATION
+    // a learned bias at this temperature only needs checking, not measuring
+    float bias[XYZ_AXIS_COUNT];
+    gyroTempComp.quickCalibration = gyroTempCompActive(gyroSensor) && gyroBiasTableLookup(gyroBiasTable(), gyroSensor->gyroDev.temperature, bias);
+    if (gyroTempComp.quickCalibration) {
+        cycles = MAX(cycles / GYRO_BIAS_QUICK_CALIBRATION_DIVIDER, 1);
+    }
+#endif
+    gyroSensor->calibration.cycles = cycles;
+    gyroSensor->calibration.cyclesRemaining = cycles;
 }
 
 void gyroStartCalibration(bool isFirstArmingCalibration)
@@ -886,15 +1549,37 @@ STATIC_UNIT_TESTED void performGyroCalibration(gyroSensor_t *gyroSensor, uint8_t
             }
 
             // please take care with exotic boardalignment !!
-            gyroSensor->gyroDev.gyroZero[axis] = gyroSensor->calibration.sum[axis] / gyroCalculateCalibratingCycles();
-            if (axis == Z) {
-              gyroSensor->gyroDev.gyroZero[axis] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
-            }
+            gyroSensor->gyroDev.gyroZero[axis] = gyroSensor->calibration.sum[axis] / gyroSensor->calibration.cycles;
         }
     }
 
     if (isOnFinalGyroCalibrationCycle(&gyroSensor->calibration)) {
-        schedulerResetTaskStatistics(TASK_SELF); // so calibration cycles do not pollute tasks statistics
+#ifdef USE_GYRO_TEMP_COMPENSATION
+        if (gyroTempCompActive(gyroSensor)) {
+            float *zero = gyroSensor->gyroDev.gyroZero;
+            float bias[XYZ_AXIS_COUNT];
+            gyroTempComp.haveReference = gyroBiasTableLookup(gyroBiasTable(), gyroSensor->gyroDev.temperature, bias);
+            if (gyroTempComp.haveReference && gyroTempComp.quickCalibration) {
+                bool agrees = true;
+                for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                    agrees = agrees && fabsf(zero[axis] - bias[axis]) < GYRO_BIAS_SANITY_THRESHOLD_LSB;
+                }
+                // the learned bias is averaged over much longer than the quick calibration
+                if (agrees) {
+                    memcpy(zero, bias, sizeof(bias));
+                }
+            }
+            if (!gyroTempComp.quickCalibration) {
+                gyroBiasTableLearn(gyroSensor->gyroDev.temperature, zero);
+                gyroTempComp.haveReference = gyroBiasTableLookup(gyroBiasTable(), gyroSensor->gyroDev.temperature, bias);
+            }
+            memcpy(gyroTempComp.referenceZero, zero, sizeof(gyroTempComp.referenceZero));
+            memcpy(gyroTempComp.referenceBias, bias, sizeof(gyroTempComp.referenceBias));
+        }
+#endif
+        gyroSensor->gyroDev.gyroZero[Z] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
+
+        schedulerResetTaskStatistics(TASK_GYROPID); // so calibration cycles do not pollute tasks statistics
         if (!firstArmingCalibrationWasStarted || (getArmingDisableFlags() & ~ARMING_DISABLED_CALIBRATING) == 0) {
             beeper(BEEPER_GYRO_CALIBRATED);
         }
@@ -924,10 +1609,7 @@ FAST_CODE int32_t gyroSlewLimiter(gyroSensor_t *gyroSensor, int axis)
 #ifdef USE_GYRO_OVERFLOW_CHECK
 static FAST_CODE_NOINLINE void handleOverflow(gyroSensor_t *gyroSensor, timeUs_t currentTimeUs)
 {
-    const float gyroOverflowResetRate = GYRO_OVERFLOW_RESET_THRESHOLD * gyroSensor->gyroDev.scale;
-    if ((abs(gyro.gyroADCf[X]) < gyroOverflowResetRate)
-          && (abs(gyro.gyroADCf[Y]) < gyroOverflowResetRate)
-          && (abs(gyro.gyroADCf[Z]) < gyroOverflowResetRate)) {
+    if (!(gyroSensor->healthStatus & GYRO_HEALTH_ABOVE_OVERFLOW_RESET)) {
         // if we have 50ms of consecutive OK gyro vales, then assume yaw readings are OK again and reset overflowDetected
         // reset requires good OK values on all axes
         if (cmpTimeUs(currentTimeUs, gyroSensor->overflowTimeUs) > 50000) {
@@ -950,18 +1632,7 @@ static FAST_CODE void checkForOverflow(gyroSensor_t *gyroSensor, timeUs_t curren
     } else {
 #ifndef SIMULATOR_BUILD
         // check for overflow in the axes set in overflowAxisMask
-        gyroOverflow_e overflowCheck = GYRO_OVERFLOW_NONE;
-        const float gyroOverflowTriggerRate = GYRO_OVERFLOW_TRIGGER_THRESHOLD * gyroSensor->gyroDev.scale;
-        if (abs(gyro.gyroADCf[X]) > gyroOverflowTriggerRate) {
-            overflowCheck |= GYRO_OVERFLOW_X;
-        }
-        if (abs(gyro.gyroADCf[Y]) > gyroOverflowTriggerRate) {
-            overflowCheck |= GYRO_OVERFLOW_Y;
-        }
-        if (abs(gyro.gyroADCf[Z]) > gyroOverflowTriggerRate) {
-            overflowCheck |= GYRO_OVERFLOW_Z;
-        }
-        if (overflowCheck & overflowAxisMask) {
+        if (gyroSensor->healthStatus & overflowAxisMask) {
             gyroSensor->overflowDetected = true;
             gyroSensor->overflowTimeUs = currentTimeUs;
 #ifdef USE_YAW_SPIN_RECOVERY
@@ -976,8 +1647,7 @@ static FAST_CODE void checkForOverflow(gyroSensor_t *gyroSensor, timeUs_t curren
 #ifdef USE_YAW_SPIN_RECOVERY
 static FAST_CODE_NOINLINE void handleYawSpin(gyroSensor_t *gyroSensor, timeUs_t currentTimeUs)
 {
-    const float yawSpinResetRate = gyroConfig()->yaw_spin_threshold - 100.0f;
-    if (abs(gyro.gyroADCf[Z]) < yawSpinResetRate) {
+    if (!(gyroSensor->healthStatus & GYRO_HEALTH_ABOVE_YAW_SPIN_RESET)) {
         // testing whether 20ms of consecutive OK gyro yaw values is enough
         if (cmpTimeUs(currentTimeUs, gyroSensor->yawSpinTimeUs) > 20000) {
             gyroSensor->yawSpinDetected = false;
@@ -1003,7 +1673,7 @@ static FAST_CODE void checkForYawSpin(gyroSensor_t *gyroSensor, timeUs_t current
     } else {
 #ifndef SIMULATOR_BUILD
         // check for spin on yaw axis only
-         if (abs(gyro.gyroADCf[Z]) > gyroConfig()->yaw_spin_threshold) {
+        if (gyroSensor->healthStatus & GYRO_HEALTH_YAW_SPIN) {
             gyroSensor->yawSpinDetected = true;
             gyroSensor->yawSpinTimeUs = currentTimeUs;
         }
@@ -1024,37 +1694,113 @@ static FAST_CODE void checkForYawSpin(gyroSensor_t *gyroSensor, timeUs_t current
 #undef GYRO_FILTER_FUNCTION_NAME
 #undef GYRO_FILTER_DEBUG_SET
 
-static FAST_CODE FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t *gyroSensor, timeUs_t currentTimeUs)
+#ifdef USE_GYRO_FIFO
+#define GYRO_FILTER_BATCH_FUNCTION_NAME filterGyroBatch
+#define GYRO_FILTER_DEBUG_SET(...)
+#include "gyro_filter_impl.h"
+#undef GYRO_FILTER_BATCH_FUNCTION_NAME
+#undef GYRO_FILTER_DEBUG_SET
+
+#define GYRO_FILTER_BATCH_FUNCTION_NAME filterGyroBatchDebug
+#define GYRO_FILTER_DEBUG_SET DEBUG_SET
+#include "gyro_filter_impl.h"
+#undef GYRO_FILTER_BATCH_FUNCTION_NAME
+#undef GYRO_FILTER_DEBUG_SET
+#endif
+
+// Compares the calibrated and aligned sample with the overflow and yaw spin thresholds, without branches
+static FAST_CODE uint8_t gyroSampleHealth(const gyroSensor_t *gyroSensor)
 {
-    if (!gyroSensor->gyroDev.readFn(&gyroSensor->gyroDev)) {
-        return;
-    }
-    gyroSensor->gyroDev.dataReady = false;
+    const float x = fabsf(gyroSensor->gyroDev.gyroADC[X]);
+    const float y = fabsf(gyroSensor->gyroDev.gyroADC[Y]);
+    const float z = fabsf(gyroSensor->gyroDev.gyroADC[Z]);
+
+    uint8_t health = (x > GYRO_OVERFLOW_TRIGGER_THRESHOLD) * GYRO_HEALTH_OVERFLOW_X
+        | (y > GYRO_OVERFLOW_TRIGGER_THRESHOLD) * GYRO_HEALTH_OVERFLOW_Y
+        | (z > GYRO_OVERFLOW_TRIGGER_THRESHOLD) * GYRO_HEALTH_OVERFLOW_Z
+        | ((x > GYRO_OVERFLOW_RESET_THRESHOLD) | (y > GYRO_OVERFLOW_RESET_THRESHOLD) | (z > GYRO_OVERFLOW_RESET_THRESHOLD)) * GYRO_HEALTH_ABOVE_OVERFLOW_RESET;
+#ifdef USE_YAW_SPIN_RECOVERY
+    health |= (z > gyroSensor->yawSpinTriggerThreshold) * GYRO_HEALTH_YAW_SPIN
+        | (z > gyroSensor->yawSpinResetThreshold) * GYRO_HEALTH_ABOVE_YAW_SPIN_RESET;
+#endif
+    return health;
+}
 
-    if (isGyroSensorCalibrationComplete(gyroSensor)) {
-        // move 16-bit gyro data into 32-bit variables to avoid overflows in calculations
+static FAST_CODE void gyroUpdateADC(gyroSensor_t *gyroSensor)
+{
+    // move 16-bit gyro data into 32-bit variables to avoid overflows in calculations
 
 #if defined(USE_GYRO_SLEW_LIMITER)
-        gyroSensor->gyroDev.gyroADC[X] = gyroSlewLimiter(gyroSensor, X) - gyroSensor->gyroDev.gyroZero[X];
-        gyroSensor->gyroDev.gyroADC[Y] = gyroSlewLimiter(gyroSensor, Y) - gyroSensor->gyroDev.gyroZero[Y];
-        gyroSensor->gyroDev.gyroADC[Z] = gyroSlewLimiter(gyroSensor, Z) - gyroSensor->gyroDev.gyroZero[Z];
+    gyroSensor->gyroDev.gyroADC[X] = gyroSlewLimiter(gyroSensor, X) - gyroSensor->gyroDev.gyroZero[X];
+    gyroSensor->gyroDev.gyroADC[Y] = gyroSlewLimiter(gyroSensor, Y) - gyroSensor->gyroDev.gyroZero[Y];
+    gyroSensor->gyroDev.gyroADC[Z] = gyroSlewLimiter(gyroSensor, Z) - gyroSensor->gyroDev.gyroZero[Z];
 #else
-        gyroSensor->gyroDev.gyroADC[X] = gyroSensor->gyroDev.gyroADCRaw[X] - gyroSensor->gyroDev.gyroZero[X];
-        gyroSensor->gyroDev.gyroADC[Y] = gyroSensor->gyroDev.gyroADCRaw[Y] - gyroSensor->gyroDev.gyroZero[Y];
-        gyroSensor->gyroDev.gyroADC[Z] = gyroSensor->gyroDev.gyroADCRaw[Z] - gyroSensor->gyroDev.gyroZero[Z];
+    gyroSensor->gyroDev.gyroADC[X] = gyroSensor->gyroDev.gyroADCRaw[X] - gyroSensor->gyroDev.gyroZero[X];
+    gyroSensor->gyroDev.gyroADC[Y] = gyroSensor->gyroDev.gyroADCRaw[Y] - gyroSensor->gyroDev.gyroZero[Y];
+    gyroSensor->gyroDev.gyroADC[Z] = gyroSensor->gyroDev.gyroADCRaw[Z] - gyroSensor->gyroDev.gyroZero[Z];
 #endif
 
-        alignSensors(gyroSensor->gyroDev.gyroADC, gyroSensor->gyroDev.gyroAlign);
-    } else {
-        performGyroCalibration(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
-        // still calibrating, so no need to further process gyro data
-        return;
+    applySensorAlignment(gyroSensor->gyroDev.gyroADC, &gyroSensor->alignment);
+
+    gyroSensor->healthStatus = gyroSampleHealth(gyroSensor);
+}
+
+#ifdef USE_GYRO_FIFO
+// Calibrates and aligns each sample of the last FIFO read, leaving the latest in gyroADCRaw and gyroADC
+static FAST_CODE void gyroUpdateADCBatch(gyroSensor_t *gyroSensor, float gyroADCBatch[GYRO_FIFO_MAX_SAMPLES][XYZ_AXIS_COUNT])
+{
+    // a threshold is crossed if any of the samples crosses it
+    uint8_t health = 0;
+    for (int i = 0; i < gyroSensor->gyroDev.fifoSampleCount; i++) {
+        gyroSensor->gyroDev.gyroADCRaw[X] = gyroSensor->gyroDev.fifoADCRaw[i][X];
+        gyroSensor->gyroDev.gyroADCRaw[Y] = gyroSensor->gyroDev.fifoADCRaw[i][Y];
+        gyroSensor->gyroDev.gyroADCRaw[Z] = gyroSensor->gyroDev.fifoADCRaw[i][Z];
+        gyroUpdateADC(gyroSensor);
+        health |= gyroSensor->healthStatus;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyroADCBatch[i][axis] = gyroSensor->gyroDev.gyroADC[axis];
+        }
     }
+    gyroSensor->healthStatus = health;
+}
+#endif
 
+// Whether the sample just read is the one the last read returned, the data ready interrupt not having fired since
+static FAST_CODE bool gyroSampleRepeated(gyroSensor_t *gyroSensor, timeUs_t currentTimeUs)
+{
+#ifdef USE_GYRO_ODR_TRACKING
+    return !gyroOdrTrackerUpdate(&gyroSensor->gyroDev) && gyroOdrTrackerAwaitingDataReady(&gyroSensor->gyroDev, currentTimeUs);
+#else
+    UNUSED(gyroSensor);
+    UNUSED(currentTimeUs);
+    return false;
+#endif
+}
+
+// The time the sample was taken if the data ready interrupts are tracked, the time of the loop otherwise
+static FAST_CODE timeUs_t gyroSampleTimeUs(const gyroSensor_t *gyroSensor, timeUs_t currentTimeUs)
+{
+#ifdef USE_GYRO_ODR_TRACKING
+    // both gyros are sampled in the same loop when using both, their interrupts are not in phase
+    if (gyroToUse != GYRO_CONFIG_USE_GYRO_BOTH && gyroOdrTrackerIsLocked(&gyroSensor->gyroDev)) {
+        return gyroOdrTrackerDataReadyAtUs(&gyroSensor->gyroDev, 0);
+    }
+#else
+    UNUSED(gyroSensor);
+#endif
+    return currentTimeUs;
+}
+
+static FAST_CODE timeDelta_t gyroUpdateSampleTime(timeUs_t currentTimeUs)
+{
     const timeDelta_t sampleDeltaUs = currentTimeUs - accumulationLastTimeSampledUs;
     accumulationLastTimeSampledUs = currentTimeUs;
     accumulatedMeasurementTimeUs += sampleDeltaUs;
+    return sampleDeltaUs;
+}
 
+static FAST_CODE void gyroCheckSensor(gyroSensor_t *gyroSensor, timeUs_t currentTimeUs)
+{
 #ifdef USE_GYRO_OVERFLOW_CHECK
     if (gyroConfig()->checkOverflow && !gyroHasOverflowProtection) {
         checkForOverflow(gyroSensor, currentTimeUs);
@@ -1067,18 +1813,176 @@ static FAST_CODE FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t *gyroSens
     }
 #endif
 
+#if !defined(USE_GYRO_OVERFLOW_CHECK) && !defined(USE_YAW_SPIN_RECOVERY)
+    UNUSED(gyroSensor);
+    UNUSED(currentTimeUs);
+#endif
+}
+
+static FAST_CODE void gyroFilterSensor(gyroSensor_t *gyroSensor, timeDelta_t sampleDeltaUs)
+{
     if (gyroDebugMode == DEBUG_NONE) {
         filterGyro(gyroSensor, sampleDeltaUs);
     } else {
         filterGyroDebug(gyroSensor, sampleDeltaUs);
     }
+}
 
+static FAST_CODE void gyroAnalyseSensor(gyroSensor_t *gyroSensor)
+{
 #ifdef USE_GYRO_DATA_ANALYSE
     if (isDynamicFilterActive()) {
+        PROFILE_BEGIN(PROFILE_GYRO_ANALYSE);
         gyroDataAnalyse(&gyroSensor->gyroAnalyseState, gyroSensor->notchFilterDyn);
+        PROFILE_END(PROFILE_GYRO_ANALYSE);
+    }
+#endif
+
+#ifdef USE_RPM_FILTER
+    rpmFilterBankUpdate(&gyroSensor->rpmFilter);
+#endif
+
+#if !defined(USE_GYRO_DATA_ANALYSE) && !defined(USE_RPM_FILTER)
+    UNUSED(gyroSensor);
+#endif
+}
+
+static FAST_CODE FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t *gyroSensor, timeUs_t currentTimeUs)
+{
+#ifdef USE_PERF_REPORT
+    const bool perfReportRunning = perfReportIsRunning();
+    const timeUs_t readStartUs = perfReportRunning ? micros() : 0;
+#endif
+    PROFILE_BEGIN(PROFILE_GYRO_READ);
+    const bool sampleRead = gyroSensor->gyroDev.readFn(&gyroSensor->gyroDev);
+    PROFILE_END(PROFILE_GYRO_READ);
+    if (!sampleRead) {
+        return;
+    }
+#ifdef USE_PERF_REPORT
+    if (perfReportRunning) {
+        perfReportGyroRead(gyroSensor->gyroDev.dataReadyAtUs, readStartUs);
+    }
+#endif
+    gyroSensor->gyroDev.dataReady = false;
+    if (gyroSampleRepeated(gyroSensor, currentTimeUs)) {
+        return;
+    }
+
+#ifdef USE_GYRO_FIFO
+    float gyroADCBatch[GYRO_FIFO_MAX_SAMPLES][XYZ_AXIS_COUNT];
+#endif
+
+    if (isGyroSensorCalibrationComplete(gyroSensor)) {
+#ifdef USE_GYRO_FIFO
+        if (gyroSensor->gyroDev.fifoEnabled) {
+            gyroUpdateADCBatch(gyroSensor, gyroADCBatch);
+        } else
+#endif
+        {
+            gyroUpdateADC(gyroSensor);
+        }
+    } else {
+        performGyroCalibration(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
+        // still calibrating, so no need to further process gyro data
+        return;
+    }
+#ifdef USE_GYRO_TEMP_COMPENSATION
+    if (gyroTempCompActive(gyroSensor)) {
+        gyroTempCompUpdate(gyroSensor);
+    }
+#endif
+
+    const timeDelta_t sampleDeltaUs = gyroUpdateSampleTime(gyroSampleTimeUs(gyroSensor, currentTimeUs));
+
+    gyroCheckSensor(gyroSensor, currentTimeUs);
+
+#ifdef USE_GYRO_FIFO
+    if (gyroSensor->gyroDev.fifoEnabled) {
+        const int sampleCount = gyroSensor->gyroDev.fifoSampleCount;
+        if (gyroDebugMode == DEBUG_NONE) {
+            filterGyroBatch(gyroSensor, gyroADCBatch, sampleCount, sampleDeltaUs / sampleCount);
+        } else {
+            filterGyroBatchDebug(gyroSensor, gyroADCBatch, sampleCount, sampleDeltaUs / sampleCount);
+        }
+    } else
+#endif
+    {
+        gyroFilterSensor(gyroSensor, sampleDeltaUs);
+    }
+
+    gyroAnalyseSensor(gyroSensor);
+}
+
+#ifdef USE_DUAL_GYRO
+// Reads a sensor for fusion, returns true if it has a new calibrated sample
+static FAST_CODE bool gyroReadSensorForFusion(gyroSensor_t *gyroSensor, timeUs_t currentTimeUs)
+{
+    if (!gyroSensor->gyroDev.readFn(&gyroSensor->gyroDev)) {
+        return false;
+    }
+    gyroSensor->gyroDev.dataReady = false;
+    if (gyroSampleRepeated(gyroSensor, currentTimeUs)) {
+        return false;
+    }
+
+    if (!isGyroSensorCalibrationComplete(gyroSensor)) {
+        performGyroCalibration(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
+        return false;
+    }
+    gyroUpdateADC(gyroSensor);
+    return true;
+}
+
+/*
+ * Combines the samples of both sensors before filtering, so that only the filters of gyroSensor1 run
+ */
+static FAST_CODE FAST_CODE_NOINLINE void gyroUpdateSensorsFused(timeUs_t currentTimeUs)
+{
+    const bool gyro1Read = gyroReadSensorForFusion(&gyroSensor1, currentTimeUs);
+    const bool gyro2Read = gyroReadSensorForFusion(&gyroSensor2, currentTimeUs);
+    if (!isGyroSensorCalibrationComplete(&gyroSensor1) || !isGyroSensorCalibrationComplete(&gyroSensor2) || !(gyro1Read || gyro2Read)) {
+        return;
+    }
+
+    // a sensor without a new sample contributes its previous one
+    float samples[GYRO_FUSION_SENSOR_COUNT][XYZ_AXIS_COUNT];
+    bool sampleValid[GYRO_FUSION_SENSOR_COUNT];
+    sampleValid[0] = !(gyroSensor1.healthStatus & GYRO_HEALTH_OVERFLOW);
+    sampleValid[1] = !(gyroSensor2.healthStatus & GYRO_HEALTH_OVERFLOW);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        samples[0][axis] = gyroSensor1.gyroDev.gyroADC[axis] * gyroSensor1.gyroDev.scale;
+        samples[1][axis] = gyroSensor2.gyroDev.gyroADC[axis] * gyroSensor2.gyroDev.scale;
+        DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, axis, lrintf(samples[0][axis] - samples[1][axis]));
     }
+
+    float fused[XYZ_AXIS_COUNT];
+    gyroFusionApply(&gyroFusion, samples, sampleValid, fused);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroSensor1.gyroDev.gyroADC[axis] = fused[axis] / gyroSensor1.gyroDev.scale;
+    }
+    gyroSensor1.healthStatus = gyroSampleHealth(&gyroSensor1);
+
+    const timeDelta_t sampleDeltaUs = gyroUpdateSampleTime(gyroSampleTimeUs(&gyroSensor1, currentTimeUs));
+    gyroCheckSensor(&gyroSensor1, currentTimeUs);
+    gyroFilterSensor(&gyroSensor1, sampleDeltaUs);
+    gyroAnalyseSensor(&gyroSensor1);
+}
 #endif
+
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+static FAST_CODE void gyroCaptureSample(timeUs_t currentTimeUs)
+{
+#ifdef USE_DUAL_GYRO
+    const gyroSensor_t *gyroSensor = gyroToUse == GYRO_CONFIG_USE_GYRO_2 ? &gyroSensor2 : &gyroSensor1;
+#else
+    const gyroSensor_t *gyroSensor = &gyroSensor1;
+#endif
+    if (isGyroSensorCalibrationComplete(gyroSensor)) {
+        blackboxGyroCaptureSample(currentTimeUs, gyroSensor->gyroDev.gyroADCRaw, gyro.gyroADCf);
+    }
 }
+#endif
 
 FAST_CODE void gyroUpdate(timeUs_t currentTimeUs)
 {
@@ -1134,6 +2038,20 @@ FAST_CODE void gyroUpdate(timeUs_t currentTimeUs)
         DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 1, lrintf(gyroSensor1.gyroDev.gyroADCf[Y] - gyroSensor2.gyroDev.gyroADCf[Y]));
         DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 2, lrintf(gyroSensor1.gyroDev.gyroADCf[Z] - gyroSensor2.gyroDev.gyroADCf[Z]));
         break;
+    case GYRO_CONFIG_USE_GYRO_FUSED:
+        gyroUpdateSensorsFused(currentTimeUs);
+        if (isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2)) {
+            gyro.gyroADCf[X] = gyroSensor1.gyroDev.gyroADCf[X];
+            gyro.gyroADCf[Y] = gyroSensor1.gyroDev.gyroADCf[Y];
+            gyro.gyroADCf[Z] = gyroSensor1.gyroDev.gyroADCf[Z];
+        }
+        DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 0, gyroSensor1.gyroDev.gyroADCRaw[X]);
+        DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 1, gyroSensor1.gyroDev.gyroADCRaw[Y]);
+        DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 2, gyroSensor2.gyroDev.gyroADCRaw[X]);
+        DEBUG_SET(DEBUG_DUAL_GYRO_RAW, 3, gyroSensor2.gyroDev.gyroADCRaw[Y]);
+        DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 1, lrintf(gyro.gyroADCf[X]));
+        DEBUG_SET(DEBUG_DUAL_GYRO_COMBINE, 2, lrintf(gyro.gyroADCf[Y]));
+        break;
     }
 #else
     gyroUpdateSensor(&gyroSensor1, currentTimeUs);
@@ -1141,6 +2059,15 @@ FAST_CODE void gyroUpdate(timeUs_t currentTimeUs)
     gyro.gyroADCf[Y] = gyroSensor1.gyroDev.gyroADCf[Y];
     gyro.gyroADCf[Z] = gyroSensor1.gyroDev.gyroADCf[Z];
 #endif
+
+    const gyroRates_t rates = { .dps = { gyro.gyroADCf[X], gyro.gyroADCf[Y], gyro.gyroADCf[Z] } };
+    gyroRatesPublish(&rates, currentTimeUs);
+
+#ifdef USE_BLACKBOX_GYRO_CAPTURE
+    if (blackboxGyroCaptureActive) {
+        gyroCaptureSample(currentTimeUs);
+    }
+#endif
 }
 
 bool gyroGetAccumulationAverage(float *accumulationAverage)
@@ -1163,6 +2090,12 @@ bool gyroGetAccumulationAverage(float *accumulationAverage)
 
 void gyroReadTemperature(void)
 {
+#ifdef USE_GYRO_TEMP_COMPENSATION
+    if (gyroTempCompActive(&gyroSensor1)) {
+        // already kept up to date by the gyro loop
+        return;
+    }
+#endif
     if (gyroSensor1.gyroDev.temperatureFn) {
         gyroSensor1.gyroDev.temperatureFn(&gyroSensor1.gyroDev, &gyroSensor1.gyroDev.temperature);
     }
@@ -1173,6 +2106,17 @@ int16_t gyroGetTemperature(void)
     return gyroSensor1.gyroDev.temperature;
 }
 
+// Rate of the sensor in use before the filters, deg/s
+FAST_CODE float gyroGetPrefilteredRate(int axis)
+{
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
+        return gyroSensor2.gyroDev.gyroADC[axis] * gyroSensor2.gyroDev.scale;
+    }
+#endif
+    return gyroSensor1.gyroDev.gyroADC[axis] * gyroSensor1.gyroDev.scale;
+}
+
 int16_t gyroRateDps(int axis)
 {
 #ifdef USE_DUAL_GYRO
@@ -1186,6 +2130,17 @@ int16_t gyroRateDps(int axis)
 #endif
 }
 
+// deg/s per LSB of the gyro in use
+float gyroScale(void)
+{
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
+        return gyroSensor2.gyroDev.scale;
+    }
+#endif
+    return gyroSensor1.gyroDev.scale;
+}
+
 bool gyroOverflowDetected(void)
 {
     return gyroSensor1.overflowDetected;
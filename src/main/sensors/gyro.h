@@ -22,6 +22,7 @@
 
 #include "common/axis.h"
 #include "common/time.h"
+#include "common/topic.h"
 #include "pg/pg.h"
 #include "drivers/bus.h"
 #include "drivers/sensor.h"
@@ -47,20 +48,39 @@ typedef enum {
 
 typedef struct gyro_s {
     uint32_t targetLooptime;
+    uint32_t sampleLooptime;    // interval of the samples fed through the filters, shorter than targetLooptime when reading the FIFO
     float gyroADCf[XYZ_AXIS_COUNT];
 } gyro_t;
 
 extern gyro_t gyro;
 
+typedef struct gyroRates_s {
+    float dps[XYZ_AXIS_COUNT];
+} gyroRates_t;
+
+TOPIC_DECLARE(gyroRates, gyroRates_t);
+
 typedef enum {
     GYRO_OVERFLOW_CHECK_NONE = 0,
     GYRO_OVERFLOW_CHECK_YAW,
     GYRO_OVERFLOW_CHECK_ALL_AXES
 } gyroOverflowCheck_e;
 
+typedef enum {
+    DYN_NOTCH_ANALYSER_FFT = 0,
+    DYN_NOTCH_ANALYSER_SDFT
+} dynNotchAnalyser_e;
+
+typedef enum {
+    DYN_NOTCH_BINS_16 = 0,
+    DYN_NOTCH_BINS_32,
+    DYN_NOTCH_BINS_64
+} dynNotchBins_e;
+
 #define GYRO_CONFIG_USE_GYRO_1      0
 #define GYRO_CONFIG_USE_GYRO_2      1
 #define GYRO_CONFIG_USE_GYRO_BOTH   2
+#define GYRO_CONFIG_USE_GYRO_FUSED  3
 
 typedef enum {
     FILTER_LOWPASS = 0,
@@ -98,26 +118,57 @@ typedef struct gyroConfig_s {
     uint16_t gyroCalibrationDuration;  // Gyro calibration duration in 1/100 second
     uint8_t dyn_notch_quality; // bandpass quality factor, 100 for steep sided bandpass
     uint8_t dyn_notch_width_percent;
+    uint8_t gyro_use_fifo;      // read all samples from the gyro FIFO and filter them, rather than just the latest
+    uint8_t dyn_notch_count;    // number of dynamic notches per axis, each following one of the largest spectral peaks
+    uint8_t dyn_notch_analyser; // periodic FFT, or sliding DFT updated with every sample
+    uint8_t dyn_notch_bins;     // frequency bins of the analyser, more bins give a finer resolution but a slower response
+    uint16_t dyn_notch_sample_hz; // rate the gyro is downsampled to for the analyser, Nyquist limits the highest notch
+    uint16_t dyn_lpf_gyro_min_hz; // cutoff of the first lowpass at zero throttle, 0 keeps the static gyro_lowpass_hz
+    uint16_t dyn_lpf_gyro_max_hz; // cutoff of the first lowpass at full throttle
+    uint16_t gyro_kalman_r;     // gyro noise variance, in (deg/s)^2, at which a KALMAN lowpass has the cutoff of its stage
 } gyroConfig_t;
 
 PG_DECLARE(gyroConfig_t, gyroConfig);
 
+// zero offset of the first gyro in 5degC bins from -10degC, learned while the craft is still
+#define GYRO_BIAS_TABLE_BINS            16
+#define GYRO_BIAS_TABLE_TEMPERATURE_MIN (-10)
+#define GYRO_BIAS_TABLE_BIN_WIDTH       5
+#define GYRO_BIAS_TABLE_SCALE           10      // bias is stored in 0.1 LSB
+
+typedef struct gyroBiasTable_s {
+    uint8_t gyro_temp_compensation;
+    uint16_t validMask;
+    int16_t bias[GYRO_BIAS_TABLE_BINS][XYZ_AXIS_COUNT];
+} gyroBiasTable_t;
+
+PG_DECLARE(gyroBiasTable_t, gyroBiasTable);
+
 bool gyroInit(void);
 
 void gyroInitFilters(void);
+void gyroUpdateDynLpf(float throttle);
 void gyroUpdate(timeUs_t currentTimeUs);
 bool gyroGetAccumulationAverage(float *accumulation);
 const busDevice_t *gyroSensorBus(void);
+bool gyroSetDataReadyFn(sensorGyroDataReadyFuncPtr dataReadyFn);
+float gyroGetMeasuredLooptimeUs(void);
+bool gyroGetNextLoopDataReadyUs(timeUs_t *dataReadyAtUs);
 struct mpuConfiguration_s;
 const struct mpuConfiguration_s *gyroMpuConfiguration(void);
 struct mpuDetectionResult_s;
 const struct mpuDetectionResult_s *gyroMpuDetectionResult(void);
+struct gyroAnalyseState_s;
+const struct gyroAnalyseState_s *gyroAnalyseState(void);
 void gyroStartCalibration(bool isFirstArmingCalibration);
 bool isFirstArmingGyroCalibrationRunning(void);
 bool isGyroCalibrationComplete(void);
 void gyroReadTemperature(void);
+void gyroSaveBiasTableIfUpdated(void);
 int16_t gyroGetTemperature(void);
+float gyroGetPrefilteredRate(int axis);
 int16_t gyroRateDps(int axis);
+float gyroScale(void);
 bool gyroOverflowDetected(void);
 bool gyroYawSpinDetected(void);
 uint16_t gyroAbsRateDps(int axis);
@@ -1,45 +1,123 @@
+#ifdef GYRO_FILTER_FUNCTION_NAME
 static FAST_CODE void GYRO_FILTER_FUNCTION_NAME(gyroSensor_t *gyroSensor, timeDelta_t sampleDeltaUs)
 {
+    float gyroADCf[XYZ_AXIS_COUNT];
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_RAW, axis, gyroSensor->gyroDev.gyroADCRaw[axis]);
         // scale gyro output to degrees per second
-        float gyroADCf = gyroSensor->gyroDev.gyroADC[axis] * gyroSensor->gyroDev.scale;
+        gyroADCf[axis] = gyroSensor->gyroDev.gyroADC[axis] * gyroSensor->gyroDev.scale;
         // DEBUG_GYRO_SCALED records the unfiltered, scaled gyro output
-        GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_SCALED, axis, lrintf(gyroADCf));
+        GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_SCALED, axis, lrintf(gyroADCf[axis]));
+    }
 
 #ifdef USE_GYRO_DATA_ANALYSE
-        if (isDynamicFilterActive()) {
-            if (axis == X) {
-                GYRO_FILTER_DEBUG_SET(DEBUG_FFT, 0, lrintf(gyroADCf)); // store raw data
-                GYRO_FILTER_DEBUG_SET(DEBUG_FFT_FREQ, 3, lrintf(gyroADCf)); // store raw data
-            }
-        }
+    const bool dynamicFilterActive = isDynamicFilterActive();
+    if (dynamicFilterActive) {
+        GYRO_FILTER_DEBUG_SET(DEBUG_FFT, 0, lrintf(gyroADCf[X])); // store raw data
+        GYRO_FILTER_DEBUG_SET(DEBUG_FFT_FREQ, 3, lrintf(gyroADCf[X])); // store raw data
+    }
 #endif
 
-        // apply static notch filters and software lowpass filters
-        gyroADCf = gyroSensor->notchFilter1ApplyFn((filter_t *)&gyroSensor->notchFilter1[axis], gyroADCf);
-        gyroADCf = gyroSensor->notchFilter2ApplyFn((filter_t *)&gyroSensor->notchFilter2[axis], gyroADCf);
-        gyroADCf = gyroSensor->lowpassFilterApplyFn((filter_t *)&gyroSensor->lowpassFilter[axis], gyroADCf);
-        gyroADCf = gyroSensor->lowpass2FilterApplyFn((filter_t *)&gyroSensor->lowpass2Filter[axis], gyroADCf);
+#ifdef USE_RPM_FILTER
+    PROFILE_BEGIN(PROFILE_GYRO_RPM_FILTER);
+    rpmFilterBankApply(&gyroSensor->rpmFilter, gyroADCf);
+    PROFILE_END(PROFILE_GYRO_RPM_FILTER);
+#endif
+
+    // apply static notch filters and software lowpass filters
+    PROFILE_BEGIN(PROFILE_GYRO_STATIC_FILTERS);
+    gyroApplyStaticFilters(gyroSensor, gyroADCf);
+    PROFILE_END(PROFILE_GYRO_STATIC_FILTERS);
 
 #ifdef USE_GYRO_DATA_ANALYSE
-        if (isDynamicFilterActive()) {
-            gyroDataAnalysePush(&gyroSensor->gyroAnalyseState, axis, gyroADCf);
-            gyroADCf = gyroSensor->notchFilterDynApplyFn((filter_t *)&gyroSensor->notchFilterDyn[axis], gyroADCf);
-            if (axis == X) {
-                GYRO_FILTER_DEBUG_SET(DEBUG_FFT, 1, lrintf(gyroADCf)); // store data after dynamic notch
-            }
+    if (dynamicFilterActive) {
+        PROFILE_BEGIN(PROFILE_GYRO_DYN_NOTCH);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyroDataAnalysePush(&gyroSensor->gyroAnalyseState, axis, gyroADCf[axis]);
+        }
+        for (int n = 0; n < gyroSensor->gyroAnalyseState.notchCount; n++) {
+            biquadFilterBank3ApplyDF1(&gyroSensor->notchFilterDyn[n], gyroADCf);
         }
+        PROFILE_END(PROFILE_GYRO_DYN_NOTCH);
+        GYRO_FILTER_DEBUG_SET(DEBUG_FFT, 1, lrintf(gyroADCf[X])); // store data after dynamic notch
+    }
 #endif
 
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         // DEBUG_GYRO_FILTERED records the scaled, filtered, after all software filtering has been applied.
-        GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_FILTERED, axis, lrintf(gyroADCf));
+        GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_FILTERED, axis, lrintf(gyroADCf[axis]));
 
-        gyroSensor->gyroDev.gyroADCf[axis] = gyroADCf;
+        gyroSensor->gyroDev.gyroADCf[axis] = gyroADCf[axis];
         if (!gyroSensor->overflowDetected) {
             // integrate using trapezium rule to avoid bias
-            accumulatedMeasurements[axis] += 0.5f * (gyroPrevious[axis] + gyroADCf) * sampleDeltaUs;
-            gyroPrevious[axis] = gyroADCf;
+            accumulatedMeasurements[axis] += 0.5f * (gyroPrevious[axis] + gyroADCf[axis]) * sampleDeltaUs;
+            gyroPrevious[axis] = gyroADCf[axis];
+        }
+    }
+}
+#endif
+
+#ifdef GYRO_FILTER_BATCH_FUNCTION_NAME
+// Filters a batch of samples read in one go from the gyro FIFO, oldest first. The samples are filtered in place.
+static FAST_CODE void GYRO_FILTER_BATCH_FUNCTION_NAME(gyroSensor_t *gyroSensor, float gyroADCBatch[GYRO_FIFO_MAX_SAMPLES][XYZ_AXIS_COUNT], int sampleCount, timeDelta_t sampleDeltaUs)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_RAW, axis, gyroSensor->gyroDev.gyroADCRaw[axis]);
+        GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_SCALED, axis, lrintf(gyroADCBatch[sampleCount - 1][axis] * gyroSensor->gyroDev.scale));
+    }
+
+#ifdef USE_GYRO_DATA_ANALYSE
+    const bool dynamicFilterActive = isDynamicFilterActive();
+    // the analysis runs once per batch, so it is fed the mean of the batch
+    const float analyseScale = 1.0f / sampleCount;
+#endif
+
+    float *gyroADCf = gyroADCBatch[0];
+    for (int i = 0; i < sampleCount; i++) {
+        gyroADCf = gyroADCBatch[i];
+        // scale gyro output to degrees per second
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyroADCf[axis] *= gyroSensor->gyroDev.scale;
+        }
+
+#ifdef USE_RPM_FILTER
+        PROFILE_BEGIN(PROFILE_GYRO_RPM_FILTER);
+        rpmFilterBankApply(&gyroSensor->rpmFilter, gyroADCf);
+        PROFILE_END(PROFILE_GYRO_RPM_FILTER);
+#endif
+
+        // apply static notch filters and software lowpass filters
+        PROFILE_BEGIN(PROFILE_GYRO_STATIC_FILTERS);
+        gyroApplyStaticFilters(gyroSensor, gyroADCf);
+        PROFILE_END(PROFILE_GYRO_STATIC_FILTERS);
+
+#ifdef USE_GYRO_DATA_ANALYSE
+        if (dynamicFilterActive) {
+            PROFILE_BEGIN(PROFILE_GYRO_DYN_NOTCH);
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                gyroDataAnalysePush(&gyroSensor->gyroAnalyseState, axis, gyroADCf[axis] * analyseScale);
+            }
+            for (int n = 0; n < gyroSensor->gyroAnalyseState.notchCount; n++) {
+                biquadFilterBank3ApplyDF1(&gyroSensor->notchFilterDyn[n], gyroADCf);
+            }
+            PROFILE_END(PROFILE_GYRO_DYN_NOTCH);
+        }
+#endif
+
+        if (!gyroSensor->overflowDetected) {
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                // integrate using trapezium rule to avoid bias
+                accumulatedMeasurements[axis] += 0.5f * (gyroPrevious[axis] + gyroADCf[axis]) * sampleDeltaUs;
+                gyroPrevious[axis] = gyroADCf[axis];
+            }
         }
     }
+
+    // the latest sample is the output
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        // DEBUG_GYRO_FILTERED records the scaled, filtered, after all software filtering has been applied.
+        GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_FILTERED, axis, lrintf(gyroADCf[axis]));
+        gyroSensor->gyroDev.gyroADCf[axis] = gyroADCf[axis];
+    }
 }
+#endif
@@ -0,0 +1,157 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_DUAL_GYRO
+
+#include "common/axis.h"
+#include "common/maths.h"
+
+#include "sensors/gyro_fusion.h"
+
+// the sensor weights are recalculated from the noise measured over this period
+#define GYRO_FUSION_WINDOW_US         100000
+// the sensors are considered to disagree when any axis differs by more than this
+#define GYRO_FUSION_DIVERGENCE_DPS    200.0f
+// a disagreement lasting this long rejects the noisier sensor
+#define GYRO_FUSION_DIVERGENCE_US     10000
+// a rejected sensor is used again once the sensors have agreed for this long
+#define GYRO_FUSION_RECOVERY_US       200000
+
+static uint16_t gyroFusionSamples(uint32_t periodUs, uint32_t looptimeUs)
+{
+    return constrain(periodUs / looptimeUs, 1, UINT16_MAX);
+}
+
+void gyroFusionInit(gyroFusion_t *fusion, uint32_t looptimeUs)
+{
+    for (int sensor = 0; sensor < GYRO_FUSION_SENSOR_COUNT; sensor++) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            devClear(&fusion->noise[sensor][axis]);
+            fusion->previousSample[sensor][axis] = 0.0f;
+        }
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        fusion->weight[axis] = 0.5f;
+    }
+    fusion->windowSamples = gyroFusionSamples(GYRO_FUSION_WINDOW_US, looptimeUs);
+    fusion->windowCount = 0;
+    fusion->divergenceSamples = gyroFusionSamples(GYRO_FUSION_DIVERGENCE_US, looptimeUs);
+    fusion->divergenceCount = 0;
+    fusion->recoverySamples = gyroFusionSamples(GYRO_FUSION_RECOVERY_US, looptimeUs);
+    fusion->recoveryCount = 0;
+    fusion->rejectedSensor = GYRO_FUSION_NO_SENSOR;
+}
+
+static void gyroFusionUpdateWeights(gyroFusion_t *fusion)
+{
+    float varianceSum[GYRO_FUSION_SENSOR_COUNT] = { 0.0f, 0.0f };
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float variance1 = devVariance(&fusion->noise[0][axis]);
+        const float variance2 = devVariance(&fusion->noise[1][axis]);
+        // inverse variance weighting gives the combination with the least noise
+        if (variance1 + variance2 > 0.0f) {
+            fusion->weight[axis] = variance2 / (variance1 + variance2);
+        }
+        varianceSum[0] += variance1;
+        varianceSum[1] += variance2;
+        devClear(&fusion->noise[0][axis]);
+        devClear(&fusion->noise[1][axis]);
+    }
+
+    // a working sensor always shows some noise, one that has output the same value for a whole window is stuck
+    for (int sensor = 0; sensor < GYRO_FUSION_SENSOR_COUNT; sensor++) {
+        if (varianceSum[sensor] == 0.0f && varianceSum[1 - sensor] > 0.0f) {
+            fusion->rejectedSensor = sensor;
+            fusion->recoveryCount = 0;
+        }
+    }
+}
+
+static void gyroFusionCheckDivergence(gyroFusion_t *fusion, const float samples[GYRO_FUSION_SENSOR_COUNT][XYZ_AXIS_COUNT])
+{
+    bool diverged = false;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (fabsf(samples[0][axis] - samples[1][axis]) > GYRO_FUSION_DIVERGENCE_DPS) {
+            diverged = true;
+        }
+    }
+
+    if (fusion->rejectedSensor == GYRO_FUSION_NO_SENSOR) {
+        fusion->divergenceCount = diverged ? fusion->divergenceCount + 1 : 0;
+        if (fusion->divergenceCount >= fusion->divergenceSamples) {
+            // there is no telling which sensor is right, so trust the one that has been less noisy
+            const float weightSum = fusion->weight[X] + fusion->weight[Y] + fusion->weight[Z];
+            fusion->rejectedSensor = (weightSum < XYZ_AXIS_COUNT * 0.5f) ? 0 : 1;
+            fusion->divergenceCount = 0;
+            fusion->recoveryCount = 0;
+        }
+    } else {
+        fusion->recoveryCount = diverged ? 0 : fusion->recoveryCount + 1;
+        if (fusion->recoveryCount >= fusion->recoverySamples) {
+            fusion->rejectedSensor = GYRO_FUSION_NO_SENSOR;
+            fusion->recoveryCount = 0;
+        }
+    }
+}
+
+/*
+ * Combines the latest samples of both sensors, in degrees per second, into one. A sample that is not valid, eg
+ * because its sensor overflowed, is left out.
+ */
+void gyroFusionApply(gyroFusion_t *fusion, const float samples[GYRO_FUSION_SENSOR_COUNT][XYZ_AXIS_COUNT], const bool sampleValid[GYRO_FUSION_SENSOR_COUNT], float *fused)
+{
+    for (int sensor = 0; sensor < GYRO_FUSION_SENSOR_COUNT; sensor++) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            if (sampleValid[sensor]) {
+                devPush(&fusion->noise[sensor][axis], samples[sensor][axis] - fusion->previousSample[sensor][axis]);
+            }
+            fusion->previousSample[sensor][axis] = samples[sensor][axis];
+        }
+    }
+    if (++fusion->windowCount >= fusion->windowSamples) {
+        gyroFusionUpdateWeights(fusion);
+        fusion->windowCount = 0;
+    }
+
+    if (sampleValid[0] && sampleValid[1]) {
+        gyroFusionCheckDivergence(fusion, samples);
+    }
+
+    int onlySensor = fusion->rejectedSensor == GYRO_FUSION_NO_SENSOR ? GYRO_FUSION_NO_SENSOR : 1 - fusion->rejectedSensor;
+    if (sampleValid[0] != sampleValid[1]) {
+        onlySensor = sampleValid[0] ? 0 : 1;
+    }
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (onlySensor == GYRO_FUSION_NO_SENSOR) {
+            fused[axis] = fusion->weight[axis] * samples[0][axis] + (1.0f - fusion->weight[axis]) * samples[1][axis];
+        } else {
+            fused[axis] = samples[onlySensor][axis];
+        }
+    }
+}
+#endif // USE_DUAL_GYRO
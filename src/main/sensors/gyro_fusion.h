@@ -0,0 +1,49 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "common/axis.h"
+#include "common/maths.h"
+
+#define GYRO_FUSION_SENSOR_COUNT 2
+#define GYRO_FUSION_NO_SENSOR    0xff
+
+typedef struct gyroFusion_s {
+    // noise of each sensor, as the variance of its sample to sample change over a window of samples
+    stdev_t noise[GYRO_FUSION_SENSOR_COUNT][XYZ_AXIS_COUNT];
+    float previousSample[GYRO_FUSION_SENSOR_COUNT][XYZ_AXIS_COUNT];
+    uint16_t windowSamples;
+    uint16_t windowCount;
+
+    // weight of the first sensor for each axis, the second sensor gets the remainder
+    float weight[XYZ_AXIS_COUNT];
+
+    // fault rejection, a sensor is rejected while the sensors disagree
+    uint16_t divergenceSamples;
+    uint16_t divergenceCount;
+    uint16_t recoverySamples;
+    uint16_t recoveryCount;
+    uint8_t rejectedSensor;
+} gyroFusion_t;
+
+void gyroFusionInit(gyroFusion_t *fusion, uint32_t looptimeUs);
+void gyroFusionApply(gyroFusion_t *fusion, const float samples[GYRO_FUSION_SENSOR_COUNT][XYZ_AXIS_COUNT], const bool sampleValid[GYRO_FUSION_SENSOR_COUNT], float *fused);
@@ -45,9 +45,8 @@
 // A sampling frequency of 1000 and max frequency of 500 at a window size of 32 gives 16 frequency bins each with a width 31.25Hz
 // Eg [0,31), [31,62), [62, 93) etc
 
-#define FFT_BIN_COUNT             (FFT_WINDOW_SIZE / 2)
-// for gyro loop >= 4KHz, analyse up to 666Hz, 16 bins each 41.625 Hz wide
-#define FFT_SAMPLING_RATE_HZ      1333
+// the window holds twice as many samples as there are bins, the smallest real FFT CMSIS supports has 32 points
+#define FFT_WINDOW_SIZE_MIN       32
 // following bin must be at least 2 times previous to indicate start of peak
 #define FFT_MIN_BIN_RISE          2
 // the desired approimate lower frequency when calculating bin offset
@@ -58,10 +57,19 @@
 #define DYN_NOTCH_MIN_CENTRE_HZ   125
 // lowest allowed notch cutoff frequency
 #define DYN_NOTCH_MIN_CUTOFF_HZ   105
+// a peak near one already being tracked is favoured by this factor, so that a notch does not jump between peaks of similar size
+#define DYN_NOTCH_PEAK_HYSTERESIS 1.5f
 // we need 4 steps for each axis
 #define DYN_NOTCH_CALC_TICKS      (XYZ_AXIS_COUNT * 4)
+// the sliding DFT needs only 2 steps for each axis, its spectrum is kept up to date sample by sample
+#define SDFT_CALC_TICKS           (XYZ_AXIS_COUNT * 2)
+// damping of the sliding DFT, stops rounding errors accumulating in its resonators
+#define SDFT_DAMPING              0.9999f
 
 static uint16_t FAST_RAM_ZERO_INIT fftSamplingRateHz;
+// number of samples analysed, and the number of frequency bins they give
+static uint8_t  FAST_RAM_ZERO_INIT fftWindowSize;
+static uint8_t  FAST_RAM_ZERO_INIT fftBinCount;
 // centre frequency of bandpass that constrains input to FFT
 static uint16_t FAST_RAM_ZERO_INIT fftBpfHz;
 // Hz per bin
@@ -71,8 +79,18 @@ static uint16_t FAST_RAM_ZERO_INIT dynNotchMaxCentreHz;
 static uint8_t  FAST_RAM_ZERO_INIT fftBinOffset;
 
 // Hanning window, see https://en.wikipedia.org/wiki/Window_function#Hann_.28Hanning.29_window
-static FAST_RAM_ZERO_INIT float hanningWindow[FFT_WINDOW_SIZE];
+static FAST_RAM_ZERO_INIT float hanningWindow[FFT_WINDOW_SIZE_MAX];
 static FAST_RAM_ZERO_INIT float dynamicNotchCutoff;
+// notch coefficients for the centre frequencies where the notch Q is constant
+static FAST_RAM_ZERO_INIT float dynNotchTableMinHz;
+static FAST_RAM_ZERO_INIT biquadNotchTable_t dynNotchTable;
+
+// sliding DFT, the bins below the analysed band are not tracked
+static FAST_RAM_ZERO_INIT uint8_t sdftStartBin;
+static FAST_RAM_ZERO_INIT uint8_t sdftBinCount;
+static FAST_RAM_ZERO_INIT float   sdftDampingPowN;
+static FAST_RAM_ZERO_INIT float   sdftTwiddleRe[SDFT_BIN_COUNT_MAX];
+static FAST_RAM_ZERO_INIT float   sdftTwiddleIm[SDFT_BIN_COUNT_MAX];
 
 void gyroDataAnalyseInit(uint32_t targetLooptimeUs)
 {
@@ -86,12 +104,16 @@ void gyroDataAnalyseInit(uint32_t targetLooptimeUs)
 
     const int gyroLoopRateHz = lrintf((1.0f / targetLooptimeUs) * 1e6f);
 
-    // If we get at least 3 samples then use the default FFT sample frequency
+    // If we get at least 3 samples then use the configured FFT sample frequency
     // otherwise we need to calculate a FFT sample frequency to ensure we get 3 samples (gyro loops < 4K)
-    fftSamplingRateHz = MIN((gyroLoopRateHz / 3), FFT_SAMPLING_RATE_HZ);
+    fftSamplingRateHz = MIN((gyroLoopRateHz / 3), gyroConfig()->dyn_notch_sample_hz);
+
+    // 16, 32 or 64 bins, limited by the buffers on targets short of RAM
+    fftWindowSize = MIN(FFT_WINDOW_SIZE_MIN << gyroConfig()->dyn_notch_bins, FFT_WINDOW_SIZE_MAX);
+    fftBinCount = fftWindowSize / 2;
 
     fftBpfHz = fftSamplingRateHz / 4;
-    fftResolution = (float)fftSamplingRateHz / FFT_WINDOW_SIZE;
+    fftResolution = (float)fftSamplingRateHz / fftWindowSize;
     dynNotchMaxCentreHz = fftSamplingRateHz / 2;
 
     // Calculate the FFT bin offset to try and get the lowest bin used
@@ -99,11 +121,27 @@ void gyroDataAnalyseInit(uint32_t targetLooptimeUs)
     // > 1333hz = 1, 889hz (2.67K) = 2, 666hz (2K) = 3
     fftBinOffset = MAX(1, lrintf(FFT_BIN_OFFSET_DESIRED_HZ / fftResolution - 1.5f));
 
-    for (int i = 0; i < FFT_WINDOW_SIZE; i++) {
-        hanningWindow[i] = (0.5f - 0.5f * cos_approx(2 * M_PIf * i / (FFT_WINDOW_SIZE - 1)));
+    for (int i = 0; i < fftWindowSize; i++) {
+        hanningWindow[i] = (0.5f - 0.5f * cos_approx(2 * M_PIf * i / (fftWindowSize - 1)));
     }
 
     dynamicNotchCutoff = (100.0f - gyroConfig()->dyn_notch_width_percent) / 100;
+
+    // the Hann window is applied to the spectrum, which needs the bins either side of those analysed
+    sdftStartBin = fftBinOffset - 1;
+    sdftBinCount = fftBinCount + 1;
+    sdftDampingPowN = 1.0f;
+    for (int i = 0; i < fftWindowSize; i++) {
+        sdftDampingPowN *= SDFT_DAMPING;
+    }
+    for (int k = 0; k < sdftBinCount; k++) {
+        sincos_approx(2 * M_PIf * k / fftWindowSize, &sdftTwiddleIm[k], &sdftTwiddleRe[k]);
+    }
+
+    // the notch Q only depends on the width while the cutoff is above DYN_NOTCH_MIN_CUTOFF_HZ
+    dynNotchTableMinHz = MAX(DYN_NOTCH_MIN_CENTRE_HZ, DYN_NOTCH_MIN_CUTOFF_HZ / dynamicNotchCutoff);
+    const float notchQ = filterGetNotchQ(dynNotchTableMinHz, dynNotchTableMinHz * dynamicNotchCutoff);
+    biquadNotchTableInit(&dynNotchTable, dynNotchTableMinHz, dynNotchMaxCentreHz, gyro.sampleLooptime, notchQ);
 }
 
 void gyroDataAnalyseStateInit(gyroAnalyseState_t *state, uint32_t targetLooptimeUs)
@@ -115,31 +153,73 @@ void gyroDataAnalyseStateInit(gyroAnalyseState_t *state, uint32_t targetLooptime
     state->maxSampleCount = samplingFrequency / fftSamplingRateHz;
     state->maxSampleCountRcp = 1.f / state->maxSampleCount;
 
-    arm_rfft_fast_init_f32(&state->fftInstance, FFT_WINDOW_SIZE);
+    arm_rfft_fast_init_f32(&state->fftInstance, fftWindowSize);
 
     // recalculation of filters takes 4 calls per axis => each filter gets updated every DYN_NOTCH_CALC_TICKS calls
     // at 4khz gyro loop rate this means 4khz / 4 / 3 = 333Hz => update every 3ms
     // for gyro rate > 16kHz, we have update frequency of 1kHz => 1ms
-    const float looptime = MAX(1000000u / fftSamplingRateHz, targetLooptimeUs * DYN_NOTCH_CALC_TICKS);
+    state->analyser = gyroConfig()->dyn_notch_analyser;
+    const uint8_t calcTicks = (state->analyser == DYN_NOTCH_ANALYSER_SDFT) ? SDFT_CALC_TICKS : DYN_NOTCH_CALC_TICKS;
+    const float looptime = MAX(1000000u / fftSamplingRateHz, targetLooptimeUs * calcTicks);
+    state->notchCount = constrain(gyroConfig()->dyn_notch_count, 1, DYN_NOTCH_COUNT_MAX);
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        // any init value
-        state->centerFreq[axis] = 200;
         biquadFilterInit(&state->gyroBandpassFilter[axis], fftBpfHz, 1000000 / fftSamplingRateHz, 0.01f * gyroConfig()->dyn_notch_quality, FILTER_BPF);
-        biquadFilterInitLPF(&state->detectedFrequencyFilter[axis], DYN_NOTCH_SMOOTH_FREQ_HZ, looptime);
+        for (int k = 0; k < SDFT_BIN_COUNT_MAX; k++) {
+            state->sdftRe[axis][k] = 0.0f;
+            state->sdftIm[axis][k] = 0.0f;
+        }
+        for (int n = 0; n < DYN_NOTCH_COUNT_MAX; n++) {
+            // any init value
+            state->centerFreq[axis][n] = 200;
+            biquadFilterInitLPF(&state->detectedFrequencyFilter[axis][n], DYN_NOTCH_SMOOTH_FREQ_HZ, looptime);
+        }
     }
 }
 
+uint16_t gyroDataAnalyseSamplingRateHz(void)
+{
+    return fftSamplingRateHz;
+}
+
+uint8_t gyroDataAnalyseBinCount(void)
+{
+    return fftBinCount;
+}
+
+// bins below this are not analysed, and are not kept up to date by the sliding DFT
+uint8_t gyroDataAnalyseBinOffset(void)
+{
+    return fftBinOffset;
+}
+
 void gyroDataAnalysePush(gyroAnalyseState_t *state, const int axis, const float sample)
 {
     state->oversampledGyroAccumulator[axis] += sample;
 }
 
-static void gyroDataAnalyseUpdate(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn);
+static void gyroDataAnalyseUpdate(gyroAnalyseState_t *state, biquadFilterBank3_t notchFilterDyn[DYN_NOTCH_COUNT_MAX]);
+static void gyroDataAnalyseUpdateSdft(gyroAnalyseState_t *state, biquadFilterBank3_t notchFilterDyn[DYN_NOTCH_COUNT_MAX]);
+
+/*
+ * Slides the DFT of one axis on by one sample, X(k) = e^(j2pik/N) * (r * X(k) + x(n) - r^N * x(n - N))
+ */
+static FAST_CODE void gyroDataAnalyseSdftPush(gyroAnalyseState_t *state, int axis, float sample, float oldSample)
+{
+    const float delta = sample - sdftDampingPowN * oldSample;
+    float *re = state->sdftRe[axis];
+    float *im = state->sdftIm[axis];
+    for (int k = sdftStartBin; k < sdftBinCount; k++) {
+        const float dampedRe = SDFT_DAMPING * re[k] + delta;
+        const float dampedIm = SDFT_DAMPING * im[k];
+        re[k] = sdftTwiddleRe[k] * dampedRe - sdftTwiddleIm[k] * dampedIm;
+        im[k] = sdftTwiddleRe[k] * dampedIm + sdftTwiddleIm[k] * dampedRe;
+    }
+}
 
 /*
  * Collect gyro data, to be analysed in gyroDataAnalyseUpdate function
  */
-void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn)
+void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilterBank3_t notchFilterDyn[DYN_NOTCH_COUNT_MAX])
 {
     // samples should have been pushed by `gyroDataAnalysePush`
     // if gyro sampling is > 1kHz, accumulate multiple samples
@@ -154,6 +234,9 @@ void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn)
             float sample = state->oversampledGyroAccumulator[axis] * state->maxSampleCountRcp;
             sample = biquadFilterApply(&state->gyroBandpassFilter[axis], sample);
 
+            if (state->analyser == DYN_NOTCH_ANALYSER_SDFT) {
+                gyroDataAnalyseSdftPush(state, axis, sample, state->downsampledGyroData[axis][state->circularBufferIdx]);
+            }
             state->downsampledGyroData[axis][state->circularBufferIdx] = sample;
             if (axis == 0) {
                 DEBUG_SET(DEBUG_FFT, 2, lrintf(sample));
@@ -162,15 +245,19 @@ void gyroDataAnalyse(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn)
             state->oversampledGyroAccumulator[axis] = 0;
         }
 
-        state->circularBufferIdx = (state->circularBufferIdx + 1) % FFT_WINDOW_SIZE;
+        state->circularBufferIdx = (state->circularBufferIdx + 1) % fftWindowSize;
 
         // We need DYN_NOTCH_CALC_TICKS tick to update all axis with newly sampled value
-        state->updateTicks = DYN_NOTCH_CALC_TICKS;
+        state->updateTicks = (state->analyser == DYN_NOTCH_ANALYSER_SDFT) ? SDFT_CALC_TICKS : DYN_NOTCH_CALC_TICKS;
     }
 
     // calculate FFT and update filters
     if (state->updateTicks > 0) {
-        gyroDataAnalyseUpdate(state, notchFilterDyn);
+        if (state->analyser == DYN_NOTCH_ANALYSER_SDFT) {
+            gyroDataAnalyseUpdateSdft(state, notchFilterDyn);
+        } else {
+            gyroDataAnalyseUpdate(state, notchFilterDyn);
+        }
         --state->updateTicks;
     }
 }
@@ -181,10 +268,110 @@ void arm_cfft_radix8by4_f32(arm_cfft_instance_f32 *S, float32_t *p1);
 void arm_radix8_butterfly_f32(float32_t *pSrc, uint16_t fftLen, const float32_t *pCoef, uint16_t twidCoefModifier);
 void arm_bitreversal_32(uint32_t *pSrc, const uint16_t bitRevLen, const uint16_t *pBitRevTable);
 
+static FAST_CODE void gyroDataAnalyseCalcFrequencies(gyroAnalyseState_t *state)
+{
+    // find the largest local maxima of the spectrum, one for each notch
+    uint8_t peakBin[DYN_NOTCH_COUNT_MAX];
+    float peakValue[DYN_NOTCH_COUNT_MAX];
+    int peakCount = 0;
+    const float *spectrum = state->spectrum[state->updateAxis];
+
+    for (int i = 1 + fftBinOffset; i < fftBinCount; i++) {
+        const float data = spectrum[i];
+        const float prevData = spectrum[i - 1];
+        const float nextData = (i + 1 < fftBinCount) ? spectrum[i + 1] : 0.0f;
+
+        // a peak must rise clearly above the lower of its neighbours
+        if (data <= prevData || data < nextData || data <= MIN(prevData, nextData) * FFT_MIN_BIN_RISE) {
+            continue;
+        }
+
+        float value = data;
+        for (int n = 0; n < state->notchCount; n++) {
+            if (fabsf(i * fftResolution - state->centerFreq[state->updateAxis][n]) < fftResolution) {
+                value *= DYN_NOTCH_PEAK_HYSTERESIS;
+                break;
+            }
+        }
+
+        // keep the peaks sorted by decreasing value, dropping the smallest once all notches are taken
+        int insertIdx = peakCount;
+        while (insertIdx > 0 && peakValue[insertIdx - 1] < value) {
+            insertIdx--;
+        }
+        if (insertIdx < state->notchCount) {
+            peakCount = MIN(peakCount + 1, state->notchCount);
+            for (int j = peakCount - 1; j > insertIdx; j--) {
+                peakBin[j] = peakBin[j - 1];
+                peakValue[j] = peakValue[j - 1];
+            }
+            peakBin[insertIdx] = i;
+            peakValue[insertIdx] = value;
+        }
+    }
+
+    // hand the peaks to the notches in order of frequency, so each notch follows the peak nearest to it
+    for (int n = 1; n < peakCount; n++) {
+        const uint8_t bin = peakBin[n];
+        int j = n;
+        for (; j > 0 && peakBin[j - 1] > bin; j--) {
+            peakBin[j] = peakBin[j - 1];
+        }
+        peakBin[j] = bin;
+    }
+
+    for (int n = 0; n < state->notchCount; n++) {
+        // if no peak, go to highest point to minimise delay
+        float centerFreq = dynNotchMaxCentreHz;
+
+        if (n < peakCount) {
+            // get weighted center of the peak and its neighbours (this way we have a better resolution than the bin width)
+            float fftSum = 0;
+            float fftWeightedSum = 0;
+            for (int i = peakBin[n] - 1; i <= MIN(peakBin[n] + 1, fftBinCount - 1); i++) {
+                const float data = spectrum[i];
+                const float cubedData = data * data * data;
+                fftSum += cubedData;
+                fftWeightedSum += cubedData * i;
+            }
+            const float fftMeanIndex = fftWeightedSum / fftSum;
+            // the index points at the center frequency of each bin so index 0 is actually 16.125Hz
+            centerFreq = constrain(fftMeanIndex * fftResolution, DYN_NOTCH_MIN_CENTRE_HZ, dynNotchMaxCentreHz);
+
+            if (state->updateAxis == 0 && n == 0) {
+                DEBUG_SET(DEBUG_FFT, 3, lrintf(fftMeanIndex * 100));
+            }
+        }
+
+        centerFreq = biquadFilterApply(&state->detectedFrequencyFilter[state->updateAxis][n], centerFreq);
+        centerFreq = constrain(centerFreq, DYN_NOTCH_MIN_CENTRE_HZ, dynNotchMaxCentreHz);
+        state->centerFreq[state->updateAxis][n] = centerFreq;
+    }
+
+    DEBUG_SET(DEBUG_FFT_FREQ, state->updateAxis, state->centerFreq[state->updateAxis][0]);
+}
+
+static FAST_CODE void gyroDataAnalyseUpdateFilters(gyroAnalyseState_t *state, biquadFilterBank3_t notchFilterDyn[DYN_NOTCH_COUNT_MAX])
+{
+    // calculate cutoffFreq and notch Q, update notch filters
+    // omega scale is shared by all the notches, which saves recalculating it for each one
+    const float omegaScale = 2.0f * M_PIf * gyro.sampleLooptime * 0.000001f;
+    for (int n = 0; n < state->notchCount; n++) {
+        const float centerFreq = state->centerFreq[state->updateAxis][n];
+        if (centerFreq >= dynNotchTableMinHz) {
+            biquadFilterBank3UpdateNotchFromTable(&notchFilterDyn[n], state->updateAxis, &dynNotchTable, centerFreq);
+        } else {
+            const float cutoffFreq = fmax(centerFreq * dynamicNotchCutoff, DYN_NOTCH_MIN_CUTOFF_HZ);
+            const float notchQ = filterGetNotchQ(centerFreq, cutoffFreq);
+            biquadFilterBank3UpdateNotch(&notchFilterDyn[n], state->updateAxis, centerFreq, omegaScale, notchQ);
+        }
+    }
+}
+
 /*
- * Analyse last gyro data from the last FFT_WINDOW_SIZE milliseconds
+ * Analyse the last fftWindowSize downsampled gyro samples
  */
-static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state, biquadFilter_t *notchFilterDyn)
+static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state, biquadFilterBank3_t notchFilterDyn[DYN_NOTCH_COUNT_MAX])
 {
     enum {
         STEP_ARM_CFFT_F32,
@@ -208,7 +395,7 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
     switch (state->updateStep) {
         case STEP_ARM_CFFT_F32:
         {
-            switch (FFT_BIN_COUNT) {
+            switch (fftBinCount) {
             case 16:
                 // 16us
                 arm_cfft_radix8by2_f32(Sint, state->fftData);
@@ -219,7 +406,7 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
                 break;
             case 64:
                 // 70us
-                arm_radix8_butterfly_f32(state->fftData, FFT_BIN_COUNT, Sint->pTwiddle, 1);
+                arm_radix8_butterfly_f32(state->fftData, fftBinCount, Sint->pTwiddle, 1);
                 break;
             }
             DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
@@ -244,7 +431,7 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
         case STEP_ARM_CMPLX_MAG_F32:
         {
             // 8us
-            arm_cmplx_mag_f32(state->rfftData, state->fftData, FFT_BIN_COUNT);
+            arm_cmplx_mag_f32(state->rfftData, state->spectrum[state->updateAxis], fftBinCount);
             DEBUG_SET(DEBUG_FFT_TIME, 2, micros() - startTime);
             state->updateStep++;
             FALLTHROUGH;
@@ -252,62 +439,14 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
         case STEP_CALC_FREQUENCIES:
         {
             // 13us
-            // calculate FFT centreFreq
-            float fftSum = 0;
-            float fftWeightedSum = 0;
-            bool fftIncreasing = false;
-
-            // iterate over fft data and calculate weighted indices
-            for (int i = 1 + fftBinOffset; i < FFT_BIN_COUNT; i++) {
-                const float data = state->fftData[i];
-                const float prevData = state->fftData[i - 1];
-
-                if (fftIncreasing || data > prevData * FFT_MIN_BIN_RISE) {
-                    float cubedData = data * data * data;
-
-                    // add previous bin before first rise
-                    if (!fftIncreasing) {
-                        cubedData += prevData * prevData * prevData;
-
-                        fftIncreasing = true;
-                    }
-
-                    fftSum += cubedData;
-                    // calculate weighted index starting at 1, not 0
-                    fftWeightedSum += cubedData * (i + 1);
-                }
-            }
-
-            // get weighted center of relevant frequency range (this way we have a better resolution than 31.25Hz)
-            // if no peak, go to highest point to minimise delay
-            float centerFreq = dynNotchMaxCentreHz;
-            float fftMeanIndex = 0;
-
-            if (fftSum > 0) {
-                // idx was shifted by 1 to start at 1, not 0
-                fftMeanIndex = (fftWeightedSum / fftSum) - 1;
-                // the index points at the center frequency of each bin so index 0 is actually 16.125Hz
-                centerFreq = constrain(fftMeanIndex * fftResolution, DYN_NOTCH_MIN_CENTRE_HZ, dynNotchMaxCentreHz);
-            }
-
-            centerFreq = biquadFilterApply(&state->detectedFrequencyFilter[state->updateAxis], centerFreq);
-            centerFreq = constrain(centerFreq, DYN_NOTCH_MIN_CENTRE_HZ, dynNotchMaxCentreHz);
-            state->centerFreq[state->updateAxis] = centerFreq;
-
-            if (state->updateAxis == 0) {
-               DEBUG_SET(DEBUG_FFT, 3, lrintf(fftMeanIndex * 100));
-            }
-            DEBUG_SET(DEBUG_FFT_FREQ, state->updateAxis, state->centerFreq[state->updateAxis]);
+            gyroDataAnalyseCalcFrequencies(state);
             DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
             break;
         }
         case STEP_UPDATE_FILTERS:
         {
             // 7us
-            // calculate cutoffFreq and notch Q, update notch filter
-            const float cutoffFreq = fmax(state->centerFreq[state->updateAxis] * dynamicNotchCutoff, DYN_NOTCH_MIN_CUTOFF_HZ);
-            const float notchQ = filterGetNotchQ(state->centerFreq[state->updateAxis], cutoffFreq);
-            biquadFilterUpdate(&notchFilterDyn[state->updateAxis], state->centerFreq[state->updateAxis], gyro.targetLooptime, notchQ, FILTER_NOTCH);
+            gyroDataAnalyseUpdateFilters(state, notchFilterDyn);
             DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
 
             state->updateAxis = (state->updateAxis + 1) % XYZ_AXIS_COUNT;
@@ -319,7 +458,7 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
             // 5us
             // apply hanning window to gyro samples and store result in fftData
             // hanning starts and ends with 0, could be skipped for minor speed improvement
-            const uint8_t ringBufIdx = FFT_WINDOW_SIZE - state->circularBufferIdx;
+            const uint8_t ringBufIdx = fftWindowSize - state->circularBufferIdx;
             arm_mult_f32(&state->downsampledGyroData[state->updateAxis][state->circularBufferIdx], &hanningWindow[0], &state->fftData[0], ringBufIdx);
             if (state->circularBufferIdx > 0) {
                 arm_mult_f32(&state->downsampledGyroData[state->updateAxis][0], &hanningWindow[ringBufIdx], &state->fftData[ringBufIdx], state->circularBufferIdx);
@@ -331,4 +470,57 @@ static FAST_CODE_NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state,
 
     state->updateStep = (state->updateStep + 1) % STEP_COUNT;
 }
+/*
+ * Magnitude of the Hann windowed sliding DFT of one axis. The window is applied to the spectrum, as the
+ * convolution of the bins with -1/4, 1/2, -1/4
+ */
+static FAST_CODE void gyroDataAnalyseSdftMagnitude(gyroAnalyseState_t *state)
+{
+    const float *re = state->sdftRe[state->updateAxis];
+    const float *im = state->sdftIm[state->updateAxis];
+    float *spectrum = state->spectrum[state->updateAxis];
+    for (int k = fftBinOffset; k < fftBinCount; k++) {
+        const float windowedRe = 0.5f * re[k] - 0.25f * (re[k - 1] + re[k + 1]);
+        const float windowedIm = 0.5f * im[k] - 0.25f * (im[k - 1] + im[k + 1]);
+        spectrum[k] = sqrtf(windowedRe * windowedRe + windowedIm * windowedIm);
+    }
+}
+
+/*
+ * Find the peaks of the sliding DFT spectrum and update the notches, one axis every 2 calls
+ */
+static FAST_CODE_NOINLINE void gyroDataAnalyseUpdateSdft(gyroAnalyseState_t *state, biquadFilterBank3_t notchFilterDyn[DYN_NOTCH_COUNT_MAX])
+{
+    enum {
+        STEP_SDFT_CALC_FREQUENCIES,
+        STEP_SDFT_UPDATE_FILTERS,
+        STEP_SDFT_COUNT
+    };
+
+    uint32_t startTime = 0;
+    if (debugMode == (DEBUG_FFT_TIME)) {
+        startTime = micros();
+    }
+
+    DEBUG_SET(DEBUG_FFT_TIME, 0, state->updateStep);
+    switch (state->updateStep) {
+        case STEP_SDFT_CALC_FREQUENCIES:
+        {
+            gyroDataAnalyseSdftMagnitude(state);
+            gyroDataAnalyseCalcFrequencies(state);
+            DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
+            break;
+        }
+        case STEP_SDFT_UPDATE_FILTERS:
+        {
+            gyroDataAnalyseUpdateFilters(state, notchFilterDyn);
+            DEBUG_SET(DEBUG_FFT_TIME, 1, micros() - startTime);
+
+            state->updateAxis = (state->updateAxis + 1) % XYZ_AXIS_COUNT;
+            break;
+        }
+    }
+
+    state->updateStep = (state->updateStep + 1) % STEP_SDFT_COUNT;
+}
 #endif // USE_GYRO_DATA_ANALYSE
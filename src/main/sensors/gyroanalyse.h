@@ -25,8 +25,18 @@
 #include "common/time.h"
 #include "common/filter.h"
 
+// the window size is chosen at run time by dyn_notch_bins, buffers are sized for the largest
+#ifdef STM32F3
 // max for F3 targets
-#define FFT_WINDOW_SIZE 32
+#define FFT_WINDOW_SIZE_MAX 32
+#else
+#define FFT_WINDOW_SIZE_MAX 128
+#endif
+// maximum number of spectral peaks tracked, and so dynamic notches applied, per axis
+#define DYN_NOTCH_COUNT_MAX 3
+// bins of the sliding DFT, from DC to Nyquist
+#define FFT_BIN_COUNT_MAX  (FFT_WINDOW_SIZE_MAX / 2)
+#define SDFT_BIN_COUNT_MAX (FFT_WINDOW_SIZE_MAX / 2 + 1)
 
 typedef struct gyroAnalyseState_s {
     // accumulator for oversampled data => no aliasing and less noise
@@ -40,23 +50,38 @@ typedef struct gyroAnalyseState_s {
 
     // downsampled gyro data circular buffer for frequency analysis
     uint8_t circularBufferIdx;
-    float downsampledGyroData[XYZ_AXIS_COUNT][FFT_WINDOW_SIZE];
+    float downsampledGyroData[XYZ_AXIS_COUNT][FFT_WINDOW_SIZE_MAX];
 
     // update state machine step information
     uint8_t updateTicks;
     uint8_t updateStep;
     uint8_t updateAxis;
 
+    // DYN_NOTCH_ANALYSER_FFT or DYN_NOTCH_ANALYSER_SDFT
+    uint8_t analyser;
+
     arm_rfft_fast_instance_f32 fftInstance;
-    float fftData[FFT_WINDOW_SIZE];
-    float rfftData[FFT_WINDOW_SIZE];
+    float fftData[FFT_WINDOW_SIZE_MAX];
+    float rfftData[FFT_WINDOW_SIZE_MAX];
+
+    // latest magnitude spectrum of each axis, kept for peak detection and for MSP_GYRO_SPECTRUM
+    float spectrum[XYZ_AXIS_COUNT][FFT_BIN_COUNT_MAX];
+
+    // sliding DFT, updated with each downsampled sample
+    float sdftRe[XYZ_AXIS_COUNT][SDFT_BIN_COUNT_MAX];
+    float sdftIm[XYZ_AXIS_COUNT][SDFT_BIN_COUNT_MAX];
 
-    biquadFilter_t detectedFrequencyFilter[XYZ_AXIS_COUNT];
-    uint16_t centerFreq[XYZ_AXIS_COUNT];
+    // number of peaks tracked per axis, peaks are held in order of increasing frequency
+    uint8_t notchCount;
+    biquadFilter_t detectedFrequencyFilter[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX];
+    uint16_t centerFreq[XYZ_AXIS_COUNT][DYN_NOTCH_COUNT_MAX];
 } gyroAnalyseState_t;
 
-STATIC_ASSERT(FFT_WINDOW_SIZE <= (uint8_t) -1, window_size_greater_than_underlying_type);
+STATIC_ASSERT(FFT_WINDOW_SIZE_MAX <= (uint8_t) -1, window_size_greater_than_underlying_type);
 
 void gyroDataAnalyseStateInit(gyroAnalyseState_t *gyroAnalyse, uint32_t targetLooptime);
 void gyroDataAnalysePush(gyroAnalyseState_t *gyroAnalyse, int axis, float sample);
-void gyroDataAnalyse(gyroAnalyseState_t *gyroAnalyse, biquadFilter_t *notchFilterDyn);
+void gyroDataAnalyse(gyroAnalyseState_t *gyroAnalyse, biquadFilterBank3_t notchFilterDyn[DYN_NOTCH_COUNT_MAX]);
+uint16_t gyroDataAnalyseSamplingRateHz(void);
+uint8_t gyroDataAnalyseBinCount(void);
+uint8_t gyroDataAnalyseBinOffset(void);
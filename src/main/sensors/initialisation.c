@@ -27,6 +27,9 @@
 #include "common/utils.h"
 
 #include "config/feature.h"
+
+#include "drivers/accgyro/accgyro_spi_dma.h"
+
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
 
@@ -57,6 +60,11 @@ bool sensorsAutodetect(void)
         accInit(gyro.targetLooptime);
     }
 
+#ifdef USE_GYRO_SPI_DMA
+    // gyro and accelerometer are configured, hand the gyro bus over to DMA reads
+    gyroSpiDmaEnable();
+#endif
+
 #ifdef USE_MAG
     compassInit();
 #endif
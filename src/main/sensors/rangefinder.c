@@ -64,6 +64,11 @@ int16_t rangefinderCfAltCm; // Complimentary Filter altitude
 
 rangefinder_t rangefinder;
 
+// Published by the detected driver
+TOPIC_DEFINE(rangefinderReading, rangefinderReading_t);
+
+static topicSubscriber_t rangefinderReadingSubscriber;
+
 #define RANGEFINDER_HARDWARE_TIMEOUT_MS         500     // Accept 500ms of non-responsive sensor, report HW failure otherwise
 
 #define RANGEFINDER_DYNAMIC_THRESHOLD           600     //Used to determine max. usable rangefinder disatance
@@ -259,7 +264,7 @@ static int16_t computePseudoSnr(int32_t newReading) {
 }
 
 /*
- * This is called periodically by the scheduler
+ * This is called periodically by the scheduler, to start a measurement or take the received bytes
  */
 // XXX Returns timeDelta_t for iNav for pseudo-RT scheduling.
 void rangefinderUpdate(timeUs_t currentTimeUs)
@@ -306,53 +311,52 @@ bool isSurfaceAltitudeValid() {
  */
 bool rangefinderProcess(float cosTiltAngle)
 {
-    if (rangefinder.dev.read) {
-        const int32_t distance = rangefinder.dev.read(&rangefinder.dev);
-
+    rangefinderReading_t reading;
+    int32_t distance;
+
+    if (rangefinderReadingRead(&reading, &rangefinderReadingSubscriber) == TOPIC_READ_NEW) {
+        distance = reading.distanceCm;
+    } else if (!rangefinderIsHealthy() && rangefinder.rawAltitude != RANGEFINDER_HARDWARE_FAILURE) {
+        // the driver stopped publishing, the HC-SR04 does when no echo comes back
+        distance = RANGEFINDER_HARDWARE_FAILURE;
+    } else {
         // If driver reported no new measurement - don't do anything
-        if (distance == RANGEFINDER_NO_NEW_DATA) {
-            return false;
-        }
-
-        if (distance >= 0) {
-            rangefinder.lastValidResponseTimeMs = millis();
-            rangefinder.rawAltitude = applyMedianFilter(distance);
-        }
-        else if (distance == RANGEFINDER_OUT_OF_RANGE) {
-            rangefinder.lastValidResponseTimeMs = millis();
-            rangefinder.rawAltitude = RANGEFINDER_OUT_OF_RANGE;
-        }
-        else {
-            // Invalid response / hardware failure
-            rangefinder.rawAltitude = RANGEFINDER_HARDWARE_FAILURE;
-        }
+        return false;
+    }
 
-        rangefinder.snr = computePseudoSnr(distance);
+    if (distance >= 0) {
+        rangefinder.lastValidResponseTimeMs = millis();
+        rangefinder.rawAltitude = applyMedianFilter(distance);
+    }
+    else if (distance == RANGEFINDER_OUT_OF_RANGE) {
+        rangefinder.lastValidResponseTimeMs = millis();
+        rangefinder.rawAltitude = RANGEFINDER_OUT_OF_RANGE;
+    }
+    else {
+        // Invalid response / hardware failure
+        rangefinder.rawAltitude = RANGEFINDER_HARDWARE_FAILURE;
+    }
 
-        if (rangefinder.snrThresholdReached == false && rangefinder.rawAltitude > 0) {
+    rangefinder.snr = computePseudoSnr(distance);
 
-            if (rangefinder.snr < RANGEFINDER_DYNAMIC_THRESHOLD && rangefinder.dynamicDistanceThreshold < rangefinder.rawAltitude) {
-                rangefinder.dynamicDistanceThreshold = rangefinder.rawAltitude * RANGEFINDER_DYNAMIC_FACTOR / 100;
-            }
+    if (rangefinder.snrThresholdReached == false && rangefinder.rawAltitude > 0) {
 
-            if (rangefinder.snr >= RANGEFINDER_DYNAMIC_THRESHOLD) {
-                rangefinder.snrThresholdReached = true;
-            }
+        if (rangefinder.snr < RANGEFINDER_DYNAMIC_THRESHOLD && rangefinder.dynamicDistanceThreshold < rangefinder.rawAltitude) {
+            rangefinder.dynamicDistanceThreshold = rangefinder.rawAltitude * RANGEFINDER_DYNAMIC_FACTOR / 100;
+        }
 
+        if (rangefinder.snr >= RANGEFINDER_DYNAMIC_THRESHOLD) {
+            rangefinder.snrThresholdReached = true;
         }
 
-        DEBUG_SET(DEBUG_RANGEFINDER, 3, rangefinder.snr);
+    }
 
-        DEBUG_SET(DEBUG_RANGEFINDER_QUALITY, 0, rangefinder.rawAltitude);
-        DEBUG_SET(DEBUG_RANGEFINDER_QUALITY, 1, rangefinder.snrThresholdReached);
-        DEBUG_SET(DEBUG_RANGEFINDER_QUALITY, 2, rangefinder.dynamicDistanceThreshold);
-        DEBUG_SET(DEBUG_RANGEFINDER_QUALITY, 3, isSurfaceAltitudeValid());
+    DEBUG_SET(DEBUG_RANGEFINDER, 3, rangefinder.snr);
 
-    }
-    else {
-        // Bad configuration
-        rangefinder.rawAltitude = RANGEFINDER_OUT_OF_RANGE;
-    }
+    DEBUG_SET(DEBUG_RANGEFINDER_QUALITY, 0, rangefinder.rawAltitude);
+    DEBUG_SET(DEBUG_RANGEFINDER_QUALITY, 1, rangefinder.snrThresholdReached);
+    DEBUG_SET(DEBUG_RANGEFINDER_QUALITY, 2, rangefinder.dynamicDistanceThreshold);
+    DEBUG_SET(DEBUG_RANGEFINDER_QUALITY, 3, isSurfaceAltitudeValid());
 
     /**
     * Apply tilt correction to the given raw sonar reading in order to compensate for the tilt of the craft when estimating
@@ -0,0 +1,158 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_RPM_FILTER
+
+#include "common/filter.h"
+#include "common/maths.h"
+
+#include "config/feature.h"
+
+#include "drivers/pwm_output.h"
+
+#include "flight/mixer.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#include "sensors/esc_sensor.h"
+#include "sensors/rpm_filter.h"
+
+// motor frequencies are held while the ESC telemetry for them is older than this many requests
+#define RPM_FILTER_ESC_DATA_AGE_MAX 10
+// the notches are kept this fraction of the gyro sample rate clear of Nyquist
+#define RPM_FILTER_MAX_HZ_FACTOR    0.48f
+
+// notch coefficients for the configured Q and gyro rate, shared by the banks of both gyros
+static FAST_RAM_ZERO_INIT biquadNotchTable_t rpmNotchTable;
+
+PG_REGISTER_WITH_RESET_TEMPLATE(rpmFilterConfig_t, rpmFilterConfig, PG_RPM_FILTER_CONFIG, 0);
+
+PG_RESET_TEMPLATE(rpmFilterConfig_t, rpmFilterConfig,
+    .rpm_notch_harmonics = 0,
+    .rpm_notch_min_hz = 100,
+    .rpm_notch_q = 500,
+    .rpm_lpf_hz = 150,
+);
+
+bool rpmHasMotorFrequencies(void)
+{
+#ifdef USE_DSHOT_TELEMETRY
+    if (useDshotTelemetry) {
+        return true;
+    }
+#endif
+    return feature(FEATURE_ESC_SENSOR);
+}
+
+// Reads the rotation frequency of a motor from the ESC telemetry, false while there is no current reading for it
+FAST_CODE bool rpmReadMotorFrequencyHz(int motor, float *frequencyHz)
+{
+#ifdef USE_DSHOT_TELEMETRY
+    if (useDshotTelemetry) {
+        // refreshed by every motor update
+        const uint16_t erpm = getDshotTelemetry(motor);
+        if (erpm == DSHOT_TELEMETRY_INVALID) {
+            return false;
+        }
+        *frequencyHz = calcEscRpm(erpm) / 60.0f;
+        return true;
+    }
+#endif
+    const escSensorData_t *escData = getEscSensorData(motor);
+    if (escData && escData->dataAge <= RPM_FILTER_ESC_DATA_AGE_MAX) {
+        *frequencyHz = calcEscRpm(escData->rpm) / 60.0f;
+        return true;
+    }
+    return false;
+}
+
+bool isRpmFilterEnabled(void)
+{
+    return rpmHasMotorFrequencies() && rpmFilterConfig()->rpm_notch_harmonics > 0;
+}
+
+void rpmFilterBankInit(rpmFilterBank_t *bank, uint32_t sampleLooptimeUs, uint32_t updateLooptimeUs)
+{
+    bank->harmonics = 0;
+    bank->motorCount = MIN(getMotorCount(), MAX_SUPPORTED_MOTORS);
+    bank->updateMotor = 0;
+
+    if (!isRpmFilterEnabled() || bank->motorCount == 0) {
+        return;
+    }
+
+    const rpmFilterConfig_t *config = rpmFilterConfig();
+    bank->harmonics = MIN(config->rpm_notch_harmonics, RPM_FILTER_HARMONICS_MAX);
+    bank->minHz = config->rpm_notch_min_hz;
+    bank->maxHz = RPM_FILTER_MAX_HZ_FACTOR * 1e6f / sampleLooptimeUs;
+    bank->q = config->rpm_notch_q / 100.0f;
+    biquadNotchTableInit(&rpmNotchTable, bank->minHz, bank->maxHz, sampleLooptimeUs, bank->q);
+
+    // each motor frequency is smoothed once every time its notches are retuned
+    const float motorUpdateDt = updateLooptimeUs * bank->motorCount * 0.000001f;
+    for (int motor = 0; motor < bank->motorCount; motor++) {
+        bank->motorFrequencyHz[motor] = 0.0f;
+        pt1FilterInit(&bank->motorFrequencyFilter[motor], pt1FilterGain(config->rpm_lpf_hz, motorUpdateDt));
+        for (int harmonic = 0; harmonic < bank->harmonics; harmonic++) {
+            biquadFilterBank3Init(&bank->notch[harmonic][motor], bank->minHz, sampleLooptimeUs, bank->q, FILTER_NOTCH);
+        }
+    }
+}
+
+// Applied as DF1, not DF2, since the notches are retuned on the fly
+FAST_CODE void rpmFilterBankApply(rpmFilterBank_t *bank, float *values)
+{
+    for (int harmonic = 0; harmonic < bank->harmonics; harmonic++) {
+        for (int motor = 0; motor < bank->motorCount; motor++) {
+            biquadFilterBank3ApplyDF1(&bank->notch[harmonic][motor], values);
+        }
+    }
+}
+
+/*
+ * Retunes the notches of one motor per call, so the cost is spread over the gyro loop. The motor frequency is read
+ * from the ESC telemetry and smoothed first. The coefficients come from the notch table, so the cost is bounded.
+ */
+FAST_CODE void rpmFilterBankUpdate(rpmFilterBank_t *bank)
+{
+    if (bank->harmonics == 0) {
+        return;
+    }
+
+    const int motor = bank->updateMotor;
+    // a motor without a current reading keeps its last frequency
+    rpmReadMotorFrequencyHz(motor, &bank->motorFrequencyHz[motor]);
+    pt1FilterApply(&bank->motorFrequencyFilter[motor], bank->motorFrequencyHz[motor]);
+
+    for (int harmonic = 0; harmonic < bank->harmonics; harmonic++) {
+        const float frequencyHz = constrainf(bank->motorFrequencyFilter[motor].state * (harmonic + 1), bank->minHz, bank->maxHz);
+        biquadFilterBank3SetNotchFromTable(&bank->notch[harmonic][motor], &rpmNotchTable, frequencyHz);
+    }
+
+    bank->updateMotor = (bank->updateMotor + 1) % bank->motorCount;
+}
+#endif // USE_RPM_FILTER
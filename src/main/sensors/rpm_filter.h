@@ -0,0 +1,61 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/filter.h"
+
+#include "drivers/pwm_output_counts.h"
+
+#include "pg/pg.h"
+
+#define RPM_FILTER_HARMONICS_MAX 3
+
+typedef struct rpmFilterConfig_s {
+    uint8_t  rpm_notch_harmonics;   // number of harmonics of each motor's rotation frequency to notch, 0 disables the filter
+    uint8_t  rpm_notch_min_hz;      // the notches are not moved below this frequency
+    uint16_t rpm_notch_q;           // notch quality factor * 100
+    uint16_t rpm_lpf_hz;            // cutoff of the lowpass smoothing the motor frequencies reported by the ESCs
+} rpmFilterConfig_t;
+
+PG_DECLARE(rpmFilterConfig_t, rpmFilterConfig);
+
+typedef struct rpmFilterBank_s {
+    uint8_t harmonics;
+    uint8_t motorCount;
+
+    // update state machine, the notches of one motor are retuned per update
+    uint8_t updateMotor;
+
+    float minHz;
+    float maxHz;
+    float q;
+
+    float motorFrequencyHz[MAX_SUPPORTED_MOTORS];
+    pt1Filter_t motorFrequencyFilter[MAX_SUPPORTED_MOTORS];
+    biquadFilterBank3_t notch[RPM_FILTER_HARMONICS_MAX][MAX_SUPPORTED_MOTORS];
+} rpmFilterBank_t;
+
+bool rpmHasMotorFrequencies(void);
+bool rpmReadMotorFrequencyHz(int motor, float *frequencyHz);
+bool isRpmFilterEnabled(void);
+void rpmFilterBankInit(rpmFilterBank_t *bank, uint32_t sampleLooptimeUs, uint32_t updateLooptimeUs);
+void rpmFilterBankApply(rpmFilterBank_t *bank, float *values);
+void rpmFilterBankUpdate(rpmFilterBank_t *bank);
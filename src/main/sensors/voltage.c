@@ -159,7 +159,7 @@ void voltageMeterADCRefresh(void)
         const voltageSensorADCConfig_t *config = voltageSensorADCConfig(i);
 
         uint8_t channel = voltageMeterAdcChannelMap[i];
-        uint16_t rawSample = adcGetChannel(channel);
+        uint16_t rawSample = adcGetChannelAverage(channel);
 
         uint16_t filteredSample = biquadFilterApply(&state->filter, rawSample);
 
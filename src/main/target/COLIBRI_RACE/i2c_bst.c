@@ -832,8 +832,8 @@ bool writeGpsPositionPrameToBST(void)
 
 bool writeRollPitchYawToBST(void)
 {
-    int16_t X = -attitude.values.pitch * (M_PIf / 1800.0f) * 10000;
-    int16_t Y = attitude.values.roll * (M_PIf / 1800.0f) * 10000;
+    int16_t X = -getAttitude()->values.pitch * (M_PIf / 1800.0f) * 10000;
+    int16_t Y = getAttitude()->values.roll * (M_PIf / 1800.0f) * 10000;
     int16_t Z = 0;//radiusHeading * 10000;
 
     bstMasterStartBuffer(PUBLIC_ADDRESS);
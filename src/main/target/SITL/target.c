@@ -25,6 +25,8 @@
 #include <string.h>
 
 #include <errno.h>
+#include <getopt.h>
+#include <poll.h>
 #include <time.h>
 
 #include "common/maths.h"
@@ -58,9 +60,37 @@ const timerHardware_t timerHardware[1]; // unused
 static fdm_packet fdmPkt;
 static servo_packet pwmPkt;
 
+// each instance moves its ports by the stride, so several can run on one host,
+// the UART ports of the last instance stay below the UDP ports of the first
+#define SIMULATOR_PWM_PORT              9002
+#define SIMULATOR_STATE_PORT            9003
+#define SIMULATOR_TCP_BASE_PORT         5760
+#define SIMULATOR_INSTANCE_PORT_STRIDE  10
+#define SIMULATOR_INSTANCE_MAX          ((SIMULATOR_PWM_PORT - SIMULATOR_TCP_BASE_PORT) / SIMULATOR_INSTANCE_PORT_STRIDE - 1)
+
+static int instanceId = 0;
+static const char *simulatorAddress = "127.0.0.1";
+static int pwmPort = -1;
+static int statePort = -1;
+static int tcpBasePort = -1;
+static char eepromFilename[256];
+
 static struct timespec start_time;
 static double simRate = 1.0;
-static pthread_t tcpWorker, udpWorker;
+// the event loop and lockstep receive the FDM packets in the main loop, the event loop also serves the TCP UARTs
+#if !defined(SIMULATOR_LOCKSTEP) && !defined(SIMULATOR_EVENT_LOOP)
+#define SIMULATOR_UDP_THREAD
+#endif
+#ifndef SIMULATOR_EVENT_LOOP
+#define SIMULATOR_TCP_THREAD
+#endif
+
+#ifdef SIMULATOR_TCP_THREAD
+static pthread_t tcpWorker;
+#endif
+#ifdef SIMULATOR_UDP_THREAD
+static pthread_t udpWorker;
+#endif
 static bool workerRunning = true;
 static udpLink_t stateLink, pwmLink;
 static pthread_mutex_t updateLock;
@@ -78,6 +108,9 @@ int lockMainPID(void) {
 void sendMotorUpdate() {
     udpSend(&pwmLink, &pwmPkt, sizeof(servo_packet));
 }
+
+static void updateSensors(const fdm_packet* pkt, double deltaSim);
+
 void updateState(const fdm_packet* pkt) {
     static double last_timestamp = 0; // in seconds
     static uint64_t last_realtime = 0; // in uS
@@ -99,6 +132,30 @@ void updateState(const fdm_packet* pkt) {
         return;
     }
 
+    updateSensors(pkt, deltaSim);
+
+    if (deltaSim < 0.02 && deltaSim > 0) { // simulator should run faster than 50Hz
+//        simRate = simRate * 0.5 + (1e6 * deltaSim / (realtime_now - last_realtime)) * 0.5;
+        struct timespec out_ts;
+        timeval_sub(&out_ts, &now_ts, &last_ts);
+        simRate = deltaSim / (out_ts.tv_sec + 1e-9*out_ts.tv_nsec);
+    }
+//    printf("simRate = %lf, millis64 = %lu, millis64_real = %lu, deltaSim = %lf\n", simRate, millis64(), millis64_real(), deltaSim*1e6);
+
+    last_timestamp = pkt->timestamp;
+    last_realtime = micros64_real();
+
+    last_ts.tv_sec = now_ts.tv_sec;
+    last_ts.tv_nsec = now_ts.tv_nsec;
+
+    pthread_mutex_unlock(&updateLock); // can send PWM output now
+
+#if defined(SIMULATOR_GYROPID_SYNC)
+    pthread_mutex_unlock(&mainLoopLock); // can run main loop
+#endif
+}
+
+static void updateSensors(const fdm_packet* pkt, double deltaSim) {
     int16_t x,y,z;
     x = constrain(-pkt->imu_linear_acceleration_xyz[0] * ACC_SCALE, -32767, 32767);
     y = constrain(-pkt->imu_linear_acceleration_xyz[1] * ACC_SCALE, -32767, 32767);
@@ -146,30 +203,90 @@ void updateState(const fdm_packet* pkt) {
 #if defined(SIMULATOR_IMU_SYNC)
     imuSetHasNewData(deltaSim*1e6);
     imuUpdateAttitude(micros());
+#else
+    UNUSED(deltaSim);
 #endif
+}
 
+#ifdef SIMULATOR_LOCKSTEP
+// The simulated time only moves with the FDM packets and the delays of the firmware,
+// so runs are deterministic and as fast as the host allows.
+#define LOCKSTEP_MAX_SCHEDULER_PASSES 64
 
-    if (deltaSim < 0.02 && deltaSim > 0) { // simulator should run faster than 50Hz
-//        simRate = simRate * 0.5 + (1e6 * deltaSim / (realtime_now - last_realtime)) * 0.5;
-        struct timespec out_ts;
-        timeval_sub(&out_ts, &now_ts, &last_ts);
-        simRate = deltaSim / (out_ts.tv_sec + 1e-9*out_ts.tv_nsec);
-    }
-//    printf("simRate = %lf, millis64 = %lu, millis64_real = %lu, deltaSim = %lf\n", simRate, millis64(), millis64_real(), deltaSim*1e6);
+static uint64_t lockstepTimeUs = 0;
+static double lockstepLastTimestamp;
+static bool lockstepStarted = false;
+static bool lockstepStepPending = false;
+static int lockstepSchedulerPasses;
 
-    last_timestamp = pkt->timestamp;
-    last_realtime = micros64_real();
+// Called after each scheduler pass. Each FDM packet advances the time by its timestamp step,
+// the motor outputs are replied once TASK_GYROPID has run for that step.
+void simulatorLockstepYield(void) {
+    if (lockstepStepPending) {
+        // the pass limit keeps a step shorter than the gyro period from stalling the simulator
+        if (cfTasks[TASK_GYROPID].lastExecutedAt != (timeUs_t)lockstepTimeUs && ++lockstepSchedulerPasses < LOCKSTEP_MAX_SCHEDULER_PASSES) {
+            return;
+        }
+        sendMotorUpdate();
+        lockstepStepPending = false;
+    }
 
-    last_ts.tv_sec = now_ts.tv_sec;
-    last_ts.tv_nsec = now_ts.tv_nsec;
+    // while the simulator is silent the scheduler keeps running at the frozen time, so serial is still served
+    if (udpRecv(&stateLink, &fdmPkt, sizeof(fdm_packet), 100) != sizeof(fdm_packet)) {
+        return;
+    }
 
-    pthread_mutex_unlock(&updateLock); // can send PWM output now
+    const double deltaSim = lockstepStarted ? fdmPkt.timestamp - lockstepLastTimestamp : 0;
+    if (deltaSim < 0) { // don't use old packet, but reply so the simulator does not stall
+        sendMotorUpdate();
+        return;
+    }
+    lockstepStarted = true;
+    lockstepLastTimestamp = fdmPkt.timestamp;
+    lockstepTimeUs += llrint(deltaSim * 1e6);
 
-#if defined(SIMULATOR_GYROPID_SYNC)
-    pthread_mutex_unlock(&mainLoopLock); // can run main loop
+    updateSensors(&fdmPkt, deltaSim);
+    lockstepStepPending = true;
+    lockstepSchedulerPasses = 0;
+}
 #endif
+
+#ifdef SIMULATOR_EVENT_LOOP
+// polled event driven tasks, like RX, are checked at least this often
+#define EVENT_LOOP_MAX_WAIT_US 1000
+#define EVENT_LOOP_TCP_SOCKET_COUNT (2 * SERIAL_PORT_COUNT)
+
+// Called after each scheduler pass. Serves the FDM packets and the TCP UARTs that arrived,
+// then sleeps until the next task is due or more data arrives.
+void simulatorEventLoopWait(void) {
+    while (udpRecv(&stateLink, &fdmPkt, sizeof(fdm_packet), 0) == sizeof(fdm_packet)) {
+        updateState(&fdmPkt);
+    }
+    dyad_update(); // does not block, the update timeout is 0
+
+    const timeDelta_t waitUs = MIN(schedulerGetTimeUntilNextTask(), EVENT_LOOP_MAX_WAIT_US);
+    if (waitUs <= 0) {
+        return;
+    }
+
+    struct pollfd fds[1 + EVENT_LOOP_TCP_SOCKET_COUNT];
+    int sockets[EVENT_LOOP_TCP_SOCKET_COUNT];
+    const int socketCount = tcpGetSockets(sockets, EVENT_LOOP_TCP_SOCKET_COUNT);
+    fds[0].fd = stateLink.fd;
+    fds[0].events = POLLIN;
+    for (int i = 0; i < socketCount; i++) {
+        fds[i + 1].fd = sockets[i];
+        fds[i + 1].events = POLLIN;
+    }
+
+    // the scheduler runs on the simulated time
+    const uint64_t waitNs = waitUs * 1e3 / (simRate > 0 ? simRate : 1.0);
+    const struct timespec timeout = { .tv_sec = waitNs / 1000000000, .tv_nsec = waitNs % 1000000000 };
+    ppoll(fds, 1 + socketCount, &timeout, NULL);
 }
+#endif
 
+#ifdef SIMULATOR_UDP_THREAD
 static void* udpThread(void* data) {
     UNUSED(data);
     int n = 0;
@@ -185,7 +302,9 @@ static void* udpThread(void* data) {
     printf("udpThread end!!\n");
     return NULL;
 }
+#endif
 
+#ifdef SIMULATOR_TCP_THREAD
 static void* tcpThread(void* data) {
     UNUSED(data);
 
@@ -201,6 +320,105 @@ static void* tcpThread(void* data) {
     printf("tcpThread end!!\n");
     return NULL;
 }
+#endif
+
+static void printUsage(const char *name)
+{
+    printf("usage: %s [options]\n"
+        "  -i, --instance ID        instance ID, moves the default ports by %d per instance (default 0, or $SITL_INSTANCE)\n"
+        "  -s, --sim-address ADDR   address of the simulator receiving the motors (default %s)\n"
+        "  -p, --pwm-port PORT      UDP port of the simulator receiving the motors (default %d)\n"
+        "  -f, --state-port PORT    UDP port receiving the FDM state (default %d)\n"
+        "  -t, --tcp-port PORT      UARTx binds TCP port PORT + x (default %d)\n"
+        "  -e, --eeprom FILE        config file (default %s, eeprom_<ID>.bin for other instances)\n",
+        name, SIMULATOR_INSTANCE_PORT_STRIDE, simulatorAddress,
+        SIMULATOR_PWM_PORT, SIMULATOR_STATE_PORT, SIMULATOR_TCP_BASE_PORT, EEPROM_FILENAME);
+}
+
+static int parsePort(const char *arg)
+{
+    const int port = atoi(arg);
+    if (port <= 0 || port > 65535) {
+        fprintf(stderr, "invalid port '%s'\n", arg);
+        exit(1);
+    }
+    return port;
+}
+
+void targetParseArgs(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        { "instance", required_argument, NULL, 'i' },
+        { "sim-address", required_argument, NULL, 's' },
+        { "pwm-port", required_argument, NULL, 'p' },
+        { "state-port", required_argument, NULL, 'f' },
+        { "tcp-port", required_argument, NULL, 't' },
+        { "eeprom", required_argument, NULL, 'e' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    const char *instance = getenv("SITL_INSTANCE");
+    int opt;
+    while ((opt = getopt_long(argc, argv, "i:s:p:f:t:e:h", options, NULL)) != -1) {
+        switch (opt) {
+        case 'i':
+            instance = optarg;
+            break;
+        case 's':
+            simulatorAddress = optarg;
+            break;
+        case 'p':
+            pwmPort = parsePort(optarg);
+            break;
+        case 'f':
+            statePort = parsePort(optarg);
+            break;
+        case 't':
+            tcpBasePort = parsePort(optarg);
+            break;
+        case 'e':
+            snprintf(eepromFilename, sizeof(eepromFilename), "%s", optarg);
+            break;
+        case 'h':
+            printUsage(argv[0]);
+            exit(0);
+        default:
+            printUsage(argv[0]);
+            exit(1);
+        }
+    }
+
+    if (instance) {
+        instanceId = atoi(instance);
+        if (instanceId < 0 || instanceId > SIMULATOR_INSTANCE_MAX) {
+            fprintf(stderr, "invalid instance '%s', 0 to %d\n", instance, SIMULATOR_INSTANCE_MAX);
+            exit(1);
+        }
+    }
+
+    const int portOffset = instanceId * SIMULATOR_INSTANCE_PORT_STRIDE;
+    if (pwmPort < 0) {
+        pwmPort = SIMULATOR_PWM_PORT + portOffset;
+    }
+    if (statePort < 0) {
+        statePort = SIMULATOR_STATE_PORT + portOffset;
+    }
+    if (tcpBasePort < 0) {
+        tcpBasePort = SIMULATOR_TCP_BASE_PORT + portOffset;
+    }
+    if (!eepromFilename[0]) {
+        if (instanceId == 0) {
+            snprintf(eepromFilename, sizeof(eepromFilename), "%s", EEPROM_FILENAME);
+        } else {
+            snprintf(eepromFilename, sizeof(eepromFilename), "eeprom_%d.bin", instanceId);
+        }
+    }
+    tcpSetBasePort(tcpBasePort);
+
+    printf("[system]Instance %d, motors to %s:%d, state on %d, UARTs on %d+, config in '%s'\n",
+        instanceId, simulatorAddress, pwmPort, statePort, tcpBasePort, eepromFilename);
+}
 
 // system
 void systemInit(void) {
@@ -222,23 +440,36 @@ void systemInit(void) {
         exit(1);
     }
 
+#ifdef SIMULATOR_TCP_THREAD
     ret = pthread_create(&tcpWorker, NULL, tcpThread, NULL);
     if (ret != 0) {
         printf("Create tcpWorker error!\n");
         exit(1);
     }
+#else
+    dyad_init();
+    dyad_setTickInterval(0.2f);
+    dyad_setUpdateTimeout(0);
+#endif
 
-    ret = udpInit(&pwmLink, "127.0.0.1", 9002, false);
+    ret = udpInit(&pwmLink, simulatorAddress, pwmPort, false);
     printf("init PwnOut UDP link...%d\n", ret);
 
-    ret = udpInit(&stateLink, NULL, 9003, true);
+    ret = udpInit(&stateLink, NULL, statePort, true);
     printf("start UDP server...%d\n", ret);
 
+#if defined(SIMULATOR_LOCKSTEP)
+    // the main loop receives the FDM packets itself
+    printf("[system]Lockstep with the simulator\n");
+#elif defined(SIMULATOR_EVENT_LOOP)
+    printf("[system]Event loop\n");
+#else
     ret = pthread_create(&udpWorker, NULL, udpThread, NULL);
     if (ret != 0) {
         printf("Create udpWorker error!\n");
         exit(1);
     }
+#endif
 
     // serial can't been slow down
     rescheduleTask(TASK_SERIAL, 1);
@@ -247,15 +478,23 @@ void systemInit(void) {
 void systemReset(void){
     printf("[system]Reset!\n");
     workerRunning = false;
+#ifdef SIMULATOR_TCP_THREAD
     pthread_join(tcpWorker, NULL);
+#endif
+#ifdef SIMULATOR_UDP_THREAD
     pthread_join(udpWorker, NULL);
+#endif
     exit(0);
 }
 void systemResetToBootloader(void) {
     printf("[system]ResetToBootloader!\n");
     workerRunning = false;
+#ifdef SIMULATOR_TCP_THREAD
     pthread_join(tcpWorker, NULL);
+#endif
+#ifdef SIMULATOR_UDP_THREAD
     pthread_join(udpWorker, NULL);
+#endif
     exit(0);
 }
 
@@ -298,6 +537,9 @@ uint64_t millis64_real() {
 }
 
 uint64_t micros64() {
+#ifdef SIMULATOR_LOCKSTEP
+    return lockstepTimeUs;
+#else
     static uint64_t last = 0;
     static uint64_t out = 0;
     uint64_t now = nanos64_real();
@@ -307,9 +549,13 @@ uint64_t micros64() {
 
     return out*1e-3;
 //    return micros64_real();
+#endif
 }
 
 uint64_t millis64() {
+#ifdef SIMULATOR_LOCKSTEP
+    return lockstepTimeUs / 1000;
+#else
     static uint64_t last = 0;
     static uint64_t out = 0;
     uint64_t now = nanos64_real();
@@ -319,6 +565,7 @@ uint64_t millis64() {
 
     return out*1e-6;
 //    return millis64_real();
+#endif
 }
 
 uint32_t micros(void) {
@@ -337,7 +584,11 @@ void microsleep(uint32_t usec) {
 }
 
 void delayMicroseconds(uint32_t us) {
+#ifdef SIMULATOR_LOCKSTEP
+    lockstepTimeUs += us;
+#else
     microsleep(us / simRate);
+#endif
 }
 
 void delayMicroseconds_real(uint32_t us) {
@@ -345,11 +596,15 @@ void delayMicroseconds_real(uint32_t us) {
 }
 
 void delay(uint32_t ms) {
+#ifdef SIMULATOR_LOCKSTEP
+    lockstepTimeUs += ms * 1000;
+#else
     uint64_t start = millis64();
 
     while ((millis64() - start) < ms) {
         microsleep(1000);
     }
+#endif
 }
 
 // Subtract the ‘struct timespec’ values X and Y,  storing the result in RESULT.
@@ -445,9 +700,11 @@ void pwmCompleteMotorUpdate(uint8_t motorCount) {
     pwmPkt.motor_speed[1] = motorsPwm[2] / outScale;
     pwmPkt.motor_speed[2] = motorsPwm[3] / outScale;
 
+#ifndef SIMULATOR_LOCKSTEP
     // get one "fdm_packet" can only send one "servo_packet"!!
     if (pthread_mutex_trylock(&updateLock) != 0) return;
     udpSend(&pwmLink, &pwmPkt, sizeof(servo_packet));
+#endif
 //    printf("[pwm]%u:%u,%u,%u,%u\n", idlePulse, motorsPwm[0], motorsPwm[1], motorsPwm[2], motorsPwm[3]);
 }
 
@@ -476,7 +733,7 @@ void FLASH_Unlock(void) {
     }
 
     // open or create
-    eepromFd = fopen(EEPROM_FILENAME,"r+");
+    eepromFd = fopen(eepromFilename,"r+");
     if (eepromFd != NULL) {
         // obtain file size:
         fseek(eepromFd , 0 , SEEK_END);
@@ -485,15 +742,15 @@ void FLASH_Unlock(void) {
 
         size_t n = fread(eepromData, 1, sizeof(eepromData), eepromFd);
         if (n == lSize) {
-            printf("[FLASH_Unlock] loaded '%s', size = %ld / %ld\n", EEPROM_FILENAME, lSize, sizeof(eepromData));
+            printf("[FLASH_Unlock] loaded '%s', size = %ld / %ld\n", eepromFilename, lSize, sizeof(eepromData));
         } else {
-            fprintf(stderr, "[FLASH_Unlock] failed to load '%s'\n", EEPROM_FILENAME);
+            fprintf(stderr, "[FLASH_Unlock] failed to load '%s'\n", eepromFilename);
             return;
         }
     } else {
-        printf("[FLASH_Unlock] created '%s', size = %ld\n", EEPROM_FILENAME, sizeof(eepromData));
-        if ((eepromFd = fopen(EEPROM_FILENAME, "w+")) == NULL) {
-            fprintf(stderr, "[FLASH_Unlock] failed to create '%s'\n", EEPROM_FILENAME);
+        printf("[FLASH_Unlock] created '%s', size = %ld\n", eepromFilename, sizeof(eepromData));
+        if ((eepromFd = fopen(eepromFilename, "w+")) == NULL) {
+            fprintf(stderr, "[FLASH_Unlock] failed to create '%s'\n", eepromFilename);
             return;
         }
         if (fwrite(eepromData, sizeof(eepromData), 1, eepromFd) != 1) {
@@ -509,7 +766,7 @@ void FLASH_Lock(void) {
         fwrite(eepromData, 1, sizeof(eepromData), eepromFd);
         fclose(eepromFd);
         eepromFd = NULL;
-        printf("[FLASH_Lock] saved '%s'\n", EEPROM_FILENAME);
+        printf("[FLASH_Lock] saved '%s'\n", eepromFilename);
     } else {
         fprintf(stderr, "[FLASH_Lock] eeprom is not unlocked\n");
     }
@@ -39,8 +39,14 @@
 //#define SIMULATOR_GYRO_SYNC
 //#define SIMULATOR_IMU_SYNC
 //#define SIMULATOR_GYROPID_SYNC
+//#define SIMULATOR_LOCKSTEP // each FDM packet advances the time by one step, the motors are replied after TASK_GYROPID ran
+#define SIMULATOR_EVENT_LOOP // single threaded, sleeps on the sockets until the next task is due instead of spinning
 
-// file name to save config
+#ifdef SIMULATOR_LOCKSTEP
+#undef SIMULATOR_EVENT_LOOP
+#endif
+
+// file name to save config, instances other than 0 default to eeprom_<instance>.bin
 #define EEPROM_FILENAME "eeprom.bin"
 #define EEPROM_IN_RAM
 #define EEPROM_SIZE     32768
@@ -265,3 +271,6 @@ uint64_t micros64(void);
 uint64_t millis64(void);
 
 int lockMainPID(void);
+void simulatorLockstepYield(void);
+void simulatorEventLoopWait(void);
+void targetParseArgs(int argc, char *argv[]);
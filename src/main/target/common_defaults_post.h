@@ -28,6 +28,10 @@
 #ifndef MAX7456_SPI_CS_PIN
 #define MAX7456_SPI_CS_PIN              NONE
 #endif
+
+#ifndef MAX7456_VSYNC_PIN
+#define MAX7456_VSYNC_PIN               NONE
+#endif
 #endif
 
 // pg/bus_i2c
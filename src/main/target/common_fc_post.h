@@ -34,6 +34,67 @@
 #undef USE_ESC_SENSOR
 #endif
 
+#ifndef USE_ESC_SENSOR
+#undef USE_RPM_FILTER
+#endif
+
+// the motor rpm is read through the RPM filter
+#ifndef USE_RPM_FILTER
+#undef USE_IDLE_CONTROL
+#endif
+
+// the dynamic lowpass retunes the float filter banks
+#ifdef USE_GYRO_FILTER_FIXED_POINT
+#undef USE_DYN_LPF
+#endif
+
+// Bidirectional DShot switches the motor timer channels to input capture, implemented for the F4 only
+#if !defined(STM32F4) || !defined(USE_DSHOT)
+#undef USE_DSHOT_TELEMETRY
+#endif
+
+// The profile probes and the event trace are only built for the F4 and F7, the F3 has no RAM to spare for them
+#if !defined(STM32F4) && !defined(STM32F7)
+#undef USE_PROFILE
+#undef USE_TRACE
+#endif
+
+#ifdef SKIP_TASK_STATISTICS
+#undef USE_TASK_STATISTICS_HISTOGRAM
+#endif
+
+#ifndef USE_BLACKBOX
+#undef USE_BLACKBOX_DEFERRED_ENCODING
+#undef USE_BLACKBOX_GYRO_CAPTURE
+#undef USE_BLACKBOX_TRIGGER
+#undef USE_BLACKBOX_RATE_CONTROL
+#undef USE_BLACKBOX_COMPRESSION
+#undef USE_BLACKBOX_MIRROR
+#undef USE_FLASHFS_LOG_INDEX
+#undef USE_FLASHFS_ERASE_AHEAD
+#endif
+
+#ifndef USE_FLASHFS
+#undef USE_FLASHFS_LOG_INDEX
+#undef USE_FLASHFS_ERASE_AHEAD
+#endif
+
+// Blackbox and MSP reply compression use the Huffman table of the compressed dataflash reads
+#ifndef USE_HUFFMAN
+#undef USE_BLACKBOX_COMPRESSION
+#undef USE_MSP_COMPRESSION
+#endif
+
+// DMA gyro reads are implemented for the F4 only, and need the target to assign the SPI DMA streams
+#if !defined(STM32F4) || !defined(GYRO_SPI_DMA_RX_STREAM) || !defined(GYRO_SPI_DMA_TX_STREAM)
+#undef USE_GYRO_SPI_DMA
+#endif
+
+// DMA bus jobs are implemented for the F4 only, and need the target to assign the SPI DMA streams
+#if !defined(STM32F4) || !(defined(SPI1_DMA_RX_STREAM) || defined(SPI2_DMA_RX_STREAM) || defined(SPI3_DMA_RX_STREAM))
+#undef USE_SPI_DMA
+#endif
+
 // XXX Followup implicit dependencies among DASHBOARD, display_xxx and USE_I2C.
 // XXX This should eventually be cleaned up.
 #ifndef USE_I2C
@@ -92,6 +153,10 @@
 #undef USE_SERIALRX_FPORT
 #endif
 
+#if defined(USE_TELEMETRY_HOTT)
+#define USE_SERIAL_TX_PACED
+#endif
+
 #if defined(USE_MSP_OVER_TELEMETRY)
 #if !defined(USE_TELEMETRY_SMARTPORT) && !defined(USE_TELEMETRY_CRSF)
 #undef USE_MSP_OVER_TELEMETRY
@@ -111,6 +176,14 @@
 #undef USE_TELEMETRY_SRXL
 #endif
 
+#ifndef USE_MSP_DISPLAYPORT
+#undef USE_DISPLAYPORT_FRAMEBUFFER
+#endif
+
+#if !defined(USE_MAX7456) || !defined(USE_EXTI)
+#undef USE_MAX7456_VSYNC
+#endif
+
 /* If either VTX_CONTROL or VTX_COMMON is undefined then remove common code and device drivers */
 #if !defined(USE_VTX_COMMON) || !defined(USE_VTX_CONTROL)
 #undef USE_VTX_COMMON
@@ -156,7 +229,7 @@
 #define USE_FLASH_M25P16
 #endif
 
-#if defined(USE_FLASH_M25P16)
+#if defined(USE_FLASH_M25P16) || defined(USE_FLASH_W25N01G)
 #define USE_FLASH
 #endif
 
@@ -167,3 +240,19 @@
 #if defined(USE_GPS_RESCUE)
 #define USE_GPS
 #endif
+
+#if defined(USE_GPS) || !defined(SKIP_SERIAL_PASSTHROUGH)
+#define USE_SERIAL_PASSTHROUGH
+#endif
+
+#if !defined(USE_MAG)
+#undef USE_MAG_AUTO_CALIBRATION
+#endif
+
+#if !defined(USE_ESC_SENSOR) && !defined(USE_DSHOT_TELEMETRY)
+#undef USE_ESC_STATS
+#endif
+
+#if !defined(USE_ADC)
+#undef USE_ADC_OVERSAMPLING
+#endif
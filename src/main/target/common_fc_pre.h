@@ -29,6 +29,8 @@
 //#pragma GCC diagnostic warning "-Wpadded"
 
 //#define SCHEDULER_DEBUG // define this to use scheduler debug[] values. Undefined by default for performance reasons
+//#define USE_PROFILE // define this to time code sections with the DWT cycle counter, F4 and F7 only. Undefined by default for performance reasons
+//#define USE_TRACE // define this to trace task switches, interrupts and DMA transfers to ITM or a RAM ring, F4 and F7 only. Undefined by default for performance reasons
 #define DEBUG_MODE DEBUG_NONE // change this to change initial debug mode
 
 #define I2C1_OVERCLOCK true
@@ -36,6 +38,8 @@
 
 #ifdef STM32F1
 #define MINIMAL_CLI
+// no FPU, so the static gyro filters run in fixed point
+#define USE_GYRO_FILTER_FIXED_POINT
 // Using RX DMA disables the use of receive callbacks
 #define USE_UART1_RX_DMA
 #define USE_UART1_TX_DMA
@@ -45,6 +49,7 @@
 #define MINIMAL_CLI
 #define USE_DSHOT
 #define USE_GYRO_DATA_ANALYSE
+#define USE_LED_STRIP_HALF_BUFFER_DMA
 #endif
 
 #ifdef STM32F4
@@ -59,10 +64,14 @@
 #define USE_ADC_INTERNAL
 #define USE_USB_CDC_HID
 #define USE_USB_MSC
+#define USE_PPM_CAPTURE_DMA             // Capture the PPM edges into a circular DMA ring and decode them in the RX task, when the pin has a timer DMA
 
 #if defined(STM32F40_41xxx) || defined(STM32F411xE)
 #define USE_OVERCLOCK
 #endif
+#if defined(STM32F411xE)
+#define USE_LED_STRIP_HALF_BUFFER_DMA   // Encode the LED colours into a short circular DMA buffer from the transfer interrupts
+#endif
 
 #endif // STM32F4
 
@@ -83,6 +92,46 @@
 #if defined(STM32F4) || defined(STM32F7)
 #define TASK_GYROPID_DESIRED_PERIOD     125 // 125us = 8kHz
 #define SCHEDULER_DELAY_LIMIT           10
+#define USE_SCHEDULER_DEADLINE_QUEUE    // Keep time-driven tasks in a deadline ordered heap instead of scanning the whole task queue
+#define USE_SWI
+#define USE_GYRO_INTERRUPT_PID          // Allow the PID loop to be run from the gyro data ready interrupt
+#define USE_TASK_STATISTICS_HISTOGRAM
+#define USE_TASK_LOAD_GOVERNOR
+#define USE_GYRO_FIFO                   // Read oversampled gyro data in bursts from the sensor FIFO
+#define USE_GYRO_ODR_TRACKING           // Track the gyro output data rate from the data ready interrupts and run the gyro loop in phase with it
+#define USE_RPM_FILTER                  // Notch the gyro at the motor frequencies and harmonics reported by the ESC telemetry
+#define USE_DSHOT_TELEMETRY             // Bidirectional DShot, read the eRPM reply of the ESCs after each frame
+#define USE_IDLE_CONTROL                // Hold the motors at a minimum rpm reported by the ESC telemetry
+#define USE_PID_CONTROLLER_VARIANTS     // Build the PID controller specialised for acro, acro with feedforward and level modes
+#define USE_RX_LATENCY_STATISTICS       // Measure the time from the end of a receiver frame to the motor update using it
+#define USE_MSP_STREAMING               // Push subscribed MSP messages in batched MSPv2 frames without a request per message
+#define USE_BLACKBOX_DEFERRED_ENCODING  // Only capture the blackbox state in the PID loop and encode it in TASK_BLACKBOX
+#define USE_BLACKBOX_GYRO_CAPTURE       // Optional blackbox log of only the unfiltered gyro at the full gyro rate
+#define USE_BLACKBOX_TRIGGER            // Optional blackbox logging at the full rate only around trigger events, from a RAM ring
+#define USE_BLACKBOX_RATE_CONTROL       // Lower the blackbox P frame rate while the log device cannot keep up
+#define USE_BLACKBOX_COMPRESSION        // Optional Huffman coding of the blackbox frames before they are written to the device
+#define USE_BLACKBOX_MIRROR             // Optional copy of a flash or SD card blackbox log on the blackbox serial port
+#define USE_FLASHFS_LOG_INDEX           // Keep an index of the blackbox logs in the last sector of the flash
+#define USE_FLASHFS_ERASE_AHEAD         // Optional incremental erase of the flash, in the background ahead of the new logs
+#define USE_CONFIG_JOURNAL              // Save only the changed PGs, appended after the stored config, and erase the config sector when full
+#define USE_OSD_ELEMENT_CACHE           // Reuse the formatted text of OSD elements whose value has not changed
+#define USE_DISPLAYPORT_FRAMEBUFFER     // Send only the changed characters to MSP displayport OSDs
+#define USE_MAX7456_VSYNC               // Run the OSD task once per video field when the MAX7456 VSYNC pin is wired
+#define USE_CLI_VALUE_INDEX             // Look up CLI settings by name with a binary search
+#define USE_MSP_PG_TRANSFER             // Read and write whole parameter groups over MSPv2
+#define USE_IMU_FAST_PROPAGATION        // Propagate the attitude with the gyro at the PID rate
+#define USE_MAG_AUTO_CALIBRATION        // Fit the magnetometer hard and soft iron correction in the background
+#define USE_GYRO_TEMP_COMPENSATION      // Learn the gyro zero offset per temperature and shorten the boot calibration
+#define USE_ESC_STATS                   // Per motor ESC temperature, current and eRPM statistics for the OSD, blackbox and telemetry
+#define USE_ADC_OVERSAMPLING            // Average every ADC conversion from a circular DMA ring instead of reading the latest one
+#define USE_BATTERY_SAG_COMPENSATION    // Estimate the pack internal resistance and compensate PID and throttle for the no-load voltage
+#define USE_PERF_REPORT                 // CLI and MSP report of the gyro loop latency and jitter, task load, bus errors and DMA conflicts while disarmed
+#define USE_DEBUG_CAPTURE               // Capture several debug modes every gyro loop into a RAM ring, read out over MSP
+#define USE_DYN_LPF                     // Optional gyro and D lowpass cutoffs following the throttle, retuned from gain and coefficient tables
+#define USE_DIRECT_SETPOINT             // Setpoints from a companion computer over MSPv2, flown by the next PID loop
+#define USE_FLIGHT_SUMMARY              // Gyro noise, motor saturation, dynamic notch and loop overrun summary of the last flights
+#define USE_OFFLOAD                     // Push the flight state and LED strip to a companion board running the OSD slave build
+#define USE_MSP_COMPRESSION             // Huffman compress the large MSPv2 replies when the request accepts it
 #else
 #define TASK_GYROPID_DESIRED_PERIOD     1000 // 1000us = 1kHz
 #define SCHEDULER_DELAY_LIMIT           100
@@ -110,6 +159,19 @@
 #define FAST_RAM
 #endif // USE_FAST_RAM
 
+// DMA buffers must be reachable by the DMA controllers and must not go stale in the data cache. The F7 DTCM is both,
+// the F3 and F4 CCM is not reachable by DMA and these MCUs have no data cache, so the buffers stay in main RAM there.
+#if defined(STM32F7) && defined(USE_FAST_RAM)
+#define DMA_RAM_ZERO_INIT           FAST_RAM_ZERO_INIT
+#define DMA_RAM                     FAST_RAM
+#else
+#define DMA_RAM_ZERO_INIT
+#define DMA_RAM
+#endif
+
+// DMA buffers outside DMA_RAM, aligned to whole data cache lines for dmaCacheClean() and dmaCacheInvalidate()
+#define DMA_ALIGNED                 __attribute__ ((aligned(32)))
+
 #ifdef STM32F4
 // Data in RAM which is guaranteed to not be reset on hot reboot
 #define PERSISTENT                  __attribute__ ((section(".persistent_data"), aligned(4)))
@@ -189,6 +251,7 @@
 #define USE_THROTTLE_BOOST
 #define USE_RC_SMOOTHING_FILTER
 #define USE_ITERM_RELAX
+#define USE_THRUST_CURVE        // Linearise the thrust of the motors with a configurable curve
 
 #ifdef USE_SERIALRX_SPEKTRUM
 #define USE_SPEKTRUM_BIND
@@ -63,6 +63,11 @@
 #define FAST_CODE_NOINLINE
 #define FAST_RAM_ZERO_INIT
 #define FAST_RAM
+#define DMA_RAM_ZERO_INIT
+#define DMA_RAM
+#define DMA_ALIGNED
+
+#define USE_OFFLOAD // receive the flight state pushed by the flight controller
 
 //CLI needs FC dependencies removed before we can compile it, disabling for now
 //#define USE_CLI
@@ -43,6 +43,7 @@
 #include "cms/cms.h"
 
 #include "drivers/nvic.h"
+#include "drivers/time.h"
 
 #include "fc/config.h"
 #include "fc/rc_modes.h"
@@ -65,7 +66,10 @@
 #include "telemetry/crsf.h"
 #include "telemetry/msp_shared.h"
 
-#define CRSF_CYCLETIME_US                   100000 // 100ms, 10 Hz
+// shortest gap between scheduled frames, 40 Hz
+#define CRSF_TELEMETRY_SLOT_US              25000
+// ad-hoc frames sent back to back before an overdue scheduled frame gets a slot
+#define CRSF_ADHOC_BURST_MAX                8
 #define CRSF_DEVICEINFO_VERSION             0x01
 #define CRSF_DEVICEINFO_PARAMETER_COUNT     0
 
@@ -245,9 +249,10 @@ void crsfFrameAttitude(sbuf_t *dst)
 {
      sbufWriteU8(dst, CRSF_FRAME_ATTITUDE_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
      sbufWriteU8(dst, CRSF_FRAMETYPE_ATTITUDE);
-     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude.values.pitch));
-     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude.values.roll));
-     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude.values.yaw));
+     const attitudeEulerAngles_t *attitude = getAttitude();
+     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude->values.pitch));
+     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude->values.roll));
+     sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude->values.yaw));
 }
 
 /*
@@ -344,7 +349,7 @@ static void crsfFrameDisplayPortClear(sbuf_t *dst)
 
 #define BV(x)  (1 << (x)) // bit value
 
-// schedule array to decide how often each type of frame is sent
+// each type of frame is due once per its interval, the earliest deadline is sent in each slot
 typedef enum {
     CRSF_FRAME_START_INDEX = 0,
     CRSF_FRAME_ATTITUDE_INDEX = CRSF_FRAME_START_INDEX,
@@ -354,8 +359,15 @@ typedef enum {
     CRSF_SCHEDULE_COUNT_MAX
 } crsfFrameTypeIndex_e;
 
-static uint8_t crsfScheduleCount;
-static uint8_t crsfSchedule[CRSF_SCHEDULE_COUNT_MAX];
+static const timeDelta_t crsfFrameIntervalUs[CRSF_SCHEDULE_COUNT_MAX] = {
+    [CRSF_FRAME_ATTITUDE_INDEX] = 50000,
+    [CRSF_FRAME_BATTERY_SENSOR_INDEX] = 500000,
+    [CRSF_FRAME_FLIGHT_MODE_INDEX] = 250000,
+    [CRSF_FRAME_GPS_INDEX] = 200000,
+};
+
+static uint8_t crsfScheduleMask;
+static timeUs_t crsfFrameDueAtUs[CRSF_SCHEDULE_COUNT_MAX];
 
 #if defined(USE_MSP_OVER_TELEMETRY)
 
@@ -381,39 +393,66 @@ void crsfSendMspResponse(uint8_t *payload)
 }
 #endif
 
-static void processCrsf(void)
+// Returns the enabled frame with the earliest deadline, -1 if none are enabled
+static int crsfEarliestFrame(timeUs_t currentTimeUs)
+{
+    int earliest = -1;
+    timeDelta_t earliestDueInUs = 0;
+    for (int i = CRSF_FRAME_START_INDEX; i < CRSF_SCHEDULE_COUNT_MAX; i++) {
+        if (!(crsfScheduleMask & BV(i))) {
+            continue;
+        }
+        const timeDelta_t dueInUs = cmpTimeUs(crsfFrameDueAtUs[i], currentTimeUs);
+        if (earliest < 0 || dueInUs < earliestDueInUs) {
+            earliest = i;
+            earliestDueInUs = dueInUs;
+        }
+    }
+    return earliest;
+}
+
+static bool crsfScheduledFrameIsDue(timeUs_t currentTimeUs)
 {
-    static uint8_t crsfScheduleIndex = 0;
+    const int earliest = crsfEarliestFrame(currentTimeUs);
+    return earliest >= 0 && cmpTimeUs(crsfFrameDueAtUs[earliest], currentTimeUs) <= 0;
+}
 
-    const uint8_t currentSchedule = crsfSchedule[crsfScheduleIndex];
+// Takes the frame to send in this slot
+STATIC_UNIT_TESTED int crsfScheduleNextFrame(timeUs_t currentTimeUs)
+{
+    const int next = crsfEarliestFrame(currentTimeUs);
+    if (next >= 0) {
+        // spare slots go to the earliest deadline too, so the next one is due an interval from now
+        crsfFrameDueAtUs[next] = currentTimeUs + crsfFrameIntervalUs[next];
+    }
+    return next;
+}
 
+static void processCrsf(timeUs_t currentTimeUs)
+{
     sbuf_t crsfPayloadBuf;
     sbuf_t *dst = &crsfPayloadBuf;
 
-    if (currentSchedule & BV(CRSF_FRAME_ATTITUDE_INDEX)) {
-        crsfInitializeFrame(dst);
+    crsfInitializeFrame(dst);
+    switch (crsfScheduleNextFrame(currentTimeUs)) {
+    case CRSF_FRAME_ATTITUDE_INDEX:
         crsfFrameAttitude(dst);
-        crsfFinalize(dst);
-    }
-    if (currentSchedule & BV(CRSF_FRAME_BATTERY_SENSOR_INDEX)) {
-        crsfInitializeFrame(dst);
+        break;
+    case CRSF_FRAME_BATTERY_SENSOR_INDEX:
         crsfFrameBatterySensor(dst);
-        crsfFinalize(dst);
-    }
-
-    if (currentSchedule & BV(CRSF_FRAME_FLIGHT_MODE_INDEX)) {
-        crsfInitializeFrame(dst);
+        break;
+    case CRSF_FRAME_FLIGHT_MODE_INDEX:
         crsfFrameFlightMode(dst);
-        crsfFinalize(dst);
-    }
+        break;
 #ifdef USE_GPS
-    if (currentSchedule & BV(CRSF_FRAME_GPS_INDEX)) {
-        crsfInitializeFrame(dst);
+    case CRSF_FRAME_GPS_INDEX:
         crsfFrameGps(dst);
-        crsfFinalize(dst);
-    }
+        break;
 #endif
-    crsfScheduleIndex = (crsfScheduleIndex + 1) % crsfScheduleCount;
+    default:
+        return;
+    }
+    crsfFinalize(dst);
 }
 
 void crsfScheduleDeviceInfoResponse(void)
@@ -437,18 +476,22 @@ void initCrsfTelemetry(void)
     cmsDisplayPortRegister(displayPortCrsfInit());
 #endif
 
-    int index = 0;
+    crsfScheduleMask = 0;
     if (sensors(SENSOR_ACC)) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_ATTITUDE_INDEX);
+        crsfScheduleMask |= BV(CRSF_FRAME_ATTITUDE_INDEX);
     }
     if (isBatteryVoltageConfigured() || isAmperageConfigured()) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_BATTERY_SENSOR_INDEX);
+        crsfScheduleMask |= BV(CRSF_FRAME_BATTERY_SENSOR_INDEX);
     }
-    crsfSchedule[index++] = BV(CRSF_FRAME_FLIGHT_MODE_INDEX);
+    crsfScheduleMask |= BV(CRSF_FRAME_FLIGHT_MODE_INDEX);
     if (feature(FEATURE_GPS)) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_GPS_INDEX);
+        crsfScheduleMask |= BV(CRSF_FRAME_GPS_INDEX);
+    }
+    // all frames are due at once, in the order above
+    const timeUs_t currentTimeUs = micros();
+    for (int i = CRSF_FRAME_START_INDEX; i < CRSF_SCHEDULE_COUNT_MAX; i++) {
+        crsfFrameDueAtUs[i] = currentTimeUs + i;
     }
-    crsfScheduleCount = (uint8_t)index;
 
  }
 
@@ -482,27 +525,13 @@ void crsfProcessDisplayPortCmd(uint8_t *frameStart)
 
 #endif
 
-/*
- * Called periodically by the scheduler
- */
-void handleCrsfTelemetry(timeUs_t currentTimeUs)
+// Sends a pending ad-hoc response frame, returns false if none are pending
+static bool processCrsfAdhoc(void)
 {
-    static uint32_t crsfLastCycleTime;
-
-    if (!crsfTelemetryEnabled) {
-        return;
-    }
-    // Give the receiver a chance to send any outstanding telemetry data.
-    // This needs to be done at high frequency, to enable the RX to send the telemetry frame
-    // in between the RX frames.
-    crsfRxSendTelemetryData();
-
-    // Send ad-hoc response frames as soon as possible
 #if defined(USE_MSP_OVER_TELEMETRY)
     if (mspReplyPending) {
         mspReplyPending = handleCrsfMspFrameBuffer(CRSF_FRAME_TX_MSP_FRAME_SIZE, &crsfSendMspResponse);
-        crsfLastCycleTime = currentTimeUs; // reset telemetry timing due to ad-hoc request
-        return;
+        return true;
     }
 #endif
 
@@ -513,8 +542,7 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs)
         crsfFrameDeviceInfo(dst);
         crsfFinalize(dst);
         deviceInfoReplyPending = false;
-        crsfLastCycleTime = currentTimeUs; // reset telemetry timing due to ad-hoc request
-        return;
+        return true;
     }
 
 #if defined(USE_CRSF_CMS_TELEMETRY)
@@ -525,8 +553,7 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs)
         crsfInitializeFrame(dst);
         crsfFrameDisplayPortClear(dst);
         crsfFinalize(dst);
-        crsfLastCycleTime = currentTimeUs;
-        return;
+        return true;
     }
     const int nextRow = crsfDisplayPortNextRow();
     if (nextRow >= 0) {
@@ -536,16 +563,42 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs)
         crsfFrameDisplayPortRow(dst, nextRow);
         crsfFinalize(dst);
         crsfDisplayPortScreen()->pendingTransport[nextRow] = false;
-        crsfLastCycleTime = currentTimeUs;
-        return;
+        return true;
     }
 #endif
 
-    // Actual telemetry data only needs to be sent at a low frequency, ie 10Hz
-    // Spread out scheduled frames evenly so each frame is sent at the same frequency.
-    if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / crsfScheduleCount)) {
+    return false;
+}
+
+/*
+ * Called periodically by the scheduler
+ */
+void handleCrsfTelemetry(timeUs_t currentTimeUs)
+{
+    static timeUs_t crsfLastCycleTime;
+    static uint8_t crsfAdhocFrameCount;
+
+    if (!crsfTelemetryEnabled) {
+        return;
+    }
+    // Give the receiver a chance to send any outstanding telemetry data.
+    // This needs to be done at high frequency, to enable the RX to send the telemetry frame
+    // in between the RX frames.
+    crsfRxSendTelemetryData();
+
+    // Send ad-hoc response frames as soon as possible, but let an overdue scheduled frame through a long burst
+    const bool scheduledFrameOverdue = crsfAdhocFrameCount >= CRSF_ADHOC_BURST_MAX && crsfScheduledFrameIsDue(currentTimeUs);
+    if (!scheduledFrameOverdue && processCrsfAdhoc()) {
+        crsfAdhocFrameCount++;
+        crsfLastCycleTime = currentTimeUs; // reset telemetry timing due to ad-hoc request
+        return;
+    }
+
+    // Scheduled frames share the slots by deadline, so each is sent at least at its own rate
+    if (scheduledFrameOverdue || cmpTimeUs(currentTimeUs, crsfLastCycleTime) >= CRSF_TELEMETRY_SLOT_US) {
         crsfLastCycleTime = currentTimeUs;
-        processCrsf();
+        crsfAdhocFrameCount = 0;
+        processCrsf(currentTimeUs);
     }
 }
 
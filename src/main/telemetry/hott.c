@@ -71,6 +71,7 @@
 #include "common/time.h"
 
 #include "drivers/serial.h"
+#include "drivers/serial_tx_paced.h"
 #include "drivers/time.h"
 
 #include "fc/runtime_config.h"
@@ -91,7 +92,7 @@
 
 #define HOTT_MESSAGE_PREPARATION_FREQUENCY_5_HZ ((1000 * 1000) / 5)
 #define HOTT_RX_SCHEDULE 4000
-#define HOTT_TX_DELAY_US 3000
+#define HOTT_TX_DELAY_MS 3
 #define MILLISECONDS_IN_A_SECOND 1000
 
 static uint32_t lastHoTTRequestCheckAt = 0;
@@ -99,12 +100,9 @@ static uint32_t lastMessagesPreparedAt = 0;
 static uint32_t lastHottAlarmSoundTime = 0;
 
 static bool hottIsSending = false;
+static bool hottResponsePending = false;
 
-static uint8_t *hottMsg = NULL;
-static uint8_t hottMsgRemainingBytesToSendCount;
-static uint8_t hottMsgCrc;
-
-#define HOTT_CRC_SIZE (sizeof(hottMsgCrc))
+#define HOTT_CRC_SIZE 1
 
 #define HOTT_BAUDRATE 19200
 #define HOTT_PORT_MODE MODE_RXTX // must be opened in RXTX so that TX and RX pins are allocated.
@@ -118,6 +116,10 @@ static portSharing_e hottPortSharing;
 static HOTT_GPS_MSG_t hottGPSMessage;
 static HOTT_EAM_MSG_t hottEAMMessage;
 
+// The requested message with its checksum, copied so that preparing the messages does not change it while it is sent
+static uint8_t hottTxBuffer[(sizeof(HOTT_GPS_MSG_t) > sizeof(HOTT_EAM_MSG_t) ? sizeof(HOTT_GPS_MSG_t) : sizeof(HOTT_EAM_MSG_t)) + HOTT_CRC_SIZE];
+static uint8_t hottTxLength;
+
 static void initialiseEAMMessage(HOTT_EAM_MSG_t *msg, size_t size)
 {
     memset(msg, 0, size);
@@ -293,15 +295,12 @@ void hottPrepareEAMResponse(HOTT_EAM_MSG_t *hottEAMMessage)
     hottEAMUpdateClimbrate(hottEAMMessage);
 }
 
-static void hottSerialWrite(uint8_t c)
-{
-    static uint8_t serialWrites = 0;
-    serialWrites++;
-    serialWrite(hottPort, c);
-}
-
 void freeHoTTTelemetryPort(void)
 {
+    serialTxPacedStop();
+    hottIsSending = false;
+    hottResponsePending = false;
+
     closeSerialPort(hottPort);
     hottPort = NULL;
     hottTelemetryEnabled = false;
@@ -348,8 +347,9 @@ static void hottConfigurePortForTX(void)
     } else {
         serialSetMode(hottPort, MODE_TX);
     }
+    // each byte is sent HOTT_TX_DELAY_MS after the previous one, the first one after the port has settled
+    serialTxPacedStart(hottPort, hottTxBuffer, hottTxLength, HOTT_TX_DELAY_MS);
     hottIsSending = true;
-    hottMsgCrc = 0;
 }
 
 static void hottConfigurePortForRX(void)
@@ -360,7 +360,7 @@ static void hottConfigurePortForRX(void)
     } else {
         serialSetMode(hottPort, MODE_RX);
     }
-    hottMsg = NULL;
+    hottResponsePending = false;
     hottIsSending = false;
     flushHottRxBuffer();
 }
@@ -394,8 +394,15 @@ static void hottSendResponse(uint8_t *buffer, int length)
         return;
     }
 
-    hottMsg = buffer;
-    hottMsgRemainingBytesToSendCount = length + HOTT_CRC_SIZE;
+    uint8_t crc = 0;
+    for (int i = 0; i < length; i++) {
+        crc += buffer[i];
+    }
+    memcpy(hottTxBuffer, buffer, length);
+    hottTxBuffer[length] = crc;
+    hottTxLength = length + HOTT_CRC_SIZE;
+
+    hottResponsePending = true;
 }
 
 static inline void hottSendGPSResponse(void)
@@ -497,28 +504,6 @@ static void hottCheckSerialData(uint32_t currentMicros)
     }
 }
 
-static void hottSendTelemetryData(void) {
-
-    if (!hottIsSending) {
-        hottConfigurePortForTX();
-        return;
-    }
-
-    if (hottMsgRemainingBytesToSendCount == 0) {
-        hottConfigurePortForRX();
-        return;
-    }
-
-    --hottMsgRemainingBytesToSendCount;
-    if (hottMsgRemainingBytesToSendCount == 0) {
-        hottSerialWrite(hottMsgCrc++);
-        return;
-    }
-
-    hottMsgCrc += *hottMsg;
-    hottSerialWrite(*hottMsg++);
-}
-
 static inline bool shouldPrepareHoTTMessages(uint32_t currentMicros)
 {
     return currentMicros - lastMessagesPreparedAt >= HOTT_MESSAGE_PREPARATION_FREQUENCY_5_HZ;
@@ -549,8 +534,6 @@ void checkHoTTTelemetryState(void)
 
 void handleHoTTTelemetry(timeUs_t currentTimeUs)
 {
-    static timeUs_t serialTimer;
-
     if (!hottTelemetryEnabled) {
         return;
     }
@@ -564,16 +547,15 @@ void handleHoTTTelemetry(timeUs_t currentTimeUs)
         hottCheckSerialData(currentTimeUs);
     }
 
-    if (!hottMsg)
+    if (!hottResponsePending) {
         return;
+    }
 
-    if (hottIsSending) {
-        if (currentTimeUs - serialTimer < HOTT_TX_DELAY_US) {
-            return;
-        }
+    if (!hottIsSending) {
+        hottConfigurePortForTX();
+    } else if (!serialTxPacedIsBusy()) {
+        hottConfigurePortForRX();
     }
-    hottSendTelemetryData();
-    serialTimer = currentTimeUs;
 }
 
 #endif
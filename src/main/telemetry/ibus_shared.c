@@ -166,11 +166,9 @@ static uint8_t transmitIbusPacket()
     }
     unsigned payloadLength = frameLength - IBUS_CHECKSUM_SIZE;
     uint16_t checksum = calculateChecksum(sendBuffer);
-    for (unsigned i = 0; i < payloadLength; i++) {
-        serialWrite(ibusSerialPort, sendBuffer[i]);
-    }
-    serialWrite(ibusSerialPort, checksum & 0xFF);
-    serialWrite(ibusSerialPort, checksum >> 8);
+    const uint8_t checksumBytes[IBUS_CHECKSUM_SIZE] = { checksum & 0xFF, checksum >> 8 };
+    serialWriteBuf(ibusSerialPort, sendBuffer, payloadLength);
+    serialWriteBuf(ibusSerialPort, checksumBytes, IBUS_CHECKSUM_SIZE);
     return frameLength;
 }
 
@@ -409,14 +407,14 @@ static void setValue(uint8_t* bufferPtr, uint8_t sensorType, uint8_t length)
         case IBUS_SENSOR_TYPE_ROLL:
         case IBUS_SENSOR_TYPE_PITCH:
         case IBUS_SENSOR_TYPE_YAW:
-            value.int16 = attitude.raw[sensorType - IBUS_SENSOR_TYPE_ROLL] *10;
+            value.int16 = getAttitude()->raw[sensorType - IBUS_SENSOR_TYPE_ROLL] *10;
             break;
         case IBUS_SENSOR_TYPE_ARMED:
             value.uint16 = ARMING_FLAG(ARMED) ? 1 : 0;
             break;
 #if defined(USE_TELEMETRY_IBUS_EXTENDED)
         case IBUS_SENSOR_TYPE_CMP_HEAD:
-            value.uint16 = DECIDEGREES_TO_DEGREES(attitude.values.yaw);
+            value.uint16 = DECIDEGREES_TO_DEGREES(getAttitude()->values.yaw);
             break;
         case IBUS_SENSOR_TYPE_VERTICAL_SPEED:
         case IBUS_SENSOR_TYPE_CLIMB_RATE:
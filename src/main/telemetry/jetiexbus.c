@@ -31,6 +31,7 @@
 #include "build/debug.h"
 #include "fc/runtime_config.h"
 
+#include "common/crc.h"
 #include "common/utils.h"
 #include "common/bitarray.h"
 
@@ -145,19 +146,17 @@ static uint8_t jetiExBusTelemetryFrame[40];
 static uint8_t jetiExBusTransceiveState = EXBUS_TRANS_RX;
 static uint8_t firstActiveSensor = 0;
 static uint32_t exSensorEnabled = 0;
+// the EX message of the next response is built while waiting for the request, which then only adds the packet ID and CRC
+static bool jetiExBusResponsePrepared = false;
 
-static uint8_t sendJetiExBusTelemetry(uint8_t packetID, uint8_t item);
+static void prepareJetiExBusTelemetry(void);
+static void sendJetiExBusTelemetry(uint8_t packetID);
 static uint8_t getNextActiveSensor(uint8_t currentSensor);
 
 // Jeti Ex Telemetry CRC calculations for a frame
 uint8_t calcCRC8(uint8_t *pt, uint8_t msgLen)
 {
-    uint8_t crc=0;
-    for (uint8_t mlen = 0; mlen < msgLen; mlen++) {
-        crc  ^= pt[mlen];
-        crc = crc ^ (crc << 1) ^ (crc << 2) ^ (0x0e090700 >> ((crc >> 3) & 0x18));
-    }
-    return(crc);
+    return crc8_ccitt_update(0, pt, msgLen);
 }
 
 /*
@@ -248,15 +247,15 @@ int32_t getSensorValue(uint8_t sensor)
         break;
 
     case EX_ROLL_ANGLE:
-        return attitude.values.roll;
+        return getAttitude()->values.roll;
         break;
 
     case EX_PITCH_ANGLE:
-        return attitude.values.pitch;
+        return getAttitude()->values.pitch;
         break;
 
     case EX_HEADING:
-        return attitude.values.yaw;
+        return getAttitude()->values.yaw;
         break;
 
     case EX_VARIO:
@@ -343,9 +342,12 @@ void checkJetiExBusTelemetryState(void)
 void handleJetiExBusTelemetry(void)
 {
     static uint16_t framesLost = 0; // only for debug
-    static uint8_t item = 0;
     uint32_t timeDiff;
 
+    if (!jetiExBusResponsePrepared && jetiExBusTransceiveState == EXBUS_TRANS_RX) {
+        prepareJetiExBusTelemetry();
+    }
+
     // Check if we shall reset frame position due to time
     if (jetiExBusRequestState == EXBUS_STATE_RECEIVED) {
 
@@ -363,7 +365,7 @@ void handleJetiExBusTelemetry(void)
             if (serialRxBytesWaiting(jetiExBusPort) == 0) {
                 serialSetMode(jetiExBusPort, MODE_TX);
                 jetiExBusTransceiveState = EXBUS_TRANS_TX;
-                item = sendJetiExBusTelemetry(jetiExBusRequestFrame[EXBUS_HEADER_PACKET_ID], item);
+                sendJetiExBusTelemetry(jetiExBusRequestFrame[EXBUS_HEADER_PACKET_ID]);
                 jetiExBusRequestState = EXBUS_STATE_PROCESSED;
                 return;
             }
@@ -383,8 +385,9 @@ void handleJetiExBusTelemetry(void)
     }
 }
 
-uint8_t sendJetiExBusTelemetry(uint8_t packetID, uint8_t item)
+void prepareJetiExBusTelemetry(void)
 {
+    static uint8_t item = 0;
     static uint8_t sensorDescriptionCounter = 0xFF;
     static uint8_t requestLoop = 0xFF;
     uint8_t *jetiExTelemetryFrame = &jetiExBusTelemetryFrame[EXBUS_HEADER_DATA];
@@ -400,20 +403,24 @@ uint8_t sendJetiExBusTelemetry(uint8_t packetID, uint8_t item)
         }
 
         createExTelemetryTextMessage(jetiExTelemetryFrame, sensorDescriptionCounter, &jetiExSensors[sensorDescriptionCounter]);
-        createExBusMessage(jetiExBusTelemetryFrame, jetiExTelemetryFrame, packetID);
         requestLoop--;
         if (requestLoop == 0){
             item = firstActiveSensor;
         }
     } else {
         item = createExTelemetryValueMessage(jetiExTelemetryFrame, item);
-        createExBusMessage(jetiExBusTelemetryFrame, jetiExTelemetryFrame, packetID);
     }
 
+    jetiExBusResponsePrepared = true;
+}
+
+void sendJetiExBusTelemetry(uint8_t packetID)
+{
+    createExBusMessage(jetiExBusTelemetryFrame, &jetiExBusTelemetryFrame[EXBUS_HEADER_DATA], packetID);
+
     serialWriteBuf(jetiExBusPort, jetiExBusTelemetryFrame, jetiExBusTelemetryFrame[EXBUS_HEADER_MSG_LEN]);
     jetiExBusTransceiveState = EXBUS_TRANS_IS_TX_COMPLETED;
-
-    return item;
+    jetiExBusResponsePrepared = false;
 }
 #endif // TELEMETRY
 #endif // SERIAL_RX
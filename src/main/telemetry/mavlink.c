@@ -91,30 +91,39 @@ static serialPortConfig_t *portConfig;
 static bool mavlinkTelemetryEnabled =  false;
 static portSharing_e mavlinkPortSharing;
 
-/* MAVLink datastream rates in Hz */
-static const uint8_t mavRates[] = {
-    [MAV_DATA_STREAM_EXTENDED_STATUS] = 2, //2Hz
-    [MAV_DATA_STREAM_RC_CHANNELS] = 5, //5Hz
-    [MAV_DATA_STREAM_POSITION] = 2, //2Hz
-    [MAV_DATA_STREAM_EXTRA1] = 10, //10Hz
-    [MAV_DATA_STREAM_EXTRA2] = 10 //2Hz
-};
-
-#define MAXSTREAMS (sizeof(mavRates) / sizeof(mavRates[0]))
-
-static uint8_t mavTicks[MAXSTREAMS];
+#define MAVLINK2_STX 0xFD
+#define MAVLINK2_NUM_HEADER_BYTES 10
+#define MAVLINK2_MAX_PACKET_LEN (MAVLINK2_NUM_HEADER_BYTES + MAVLINK_MAX_PAYLOAD_LEN + 2)
+
+// packets queued during one run are written to the port together
+#define MAVLINK_TX_BUFFER_SIZE MAVLINK2_MAX_PACKET_LEN
+
+// unused link capacity carried over to the next run, in runs
+#define MAVLINK_TX_BUDGET_MAX_RUNS 2
+
+static uint8_t mavTicks[MAVLINK_STREAM_COUNT];
 static mavlink_message_t mavMsg;
-static uint8_t mavBuffer[MAVLINK_MAX_PACKET_LEN];
+static uint8_t mavBuffer[MAVLINK2_MAX_PACKET_LEN];
 static uint32_t lastMavlinkMessage = 0;
 
-static int mavlinkStreamTrigger(enum MAV_DATA_STREAM streamNum)
+static uint8_t mavTxBuffer[MAVLINK_TX_BUFFER_SIZE];
+static uint16_t mavTxBufferLength;
+// bytes the link can still carry, refilled from the baud rate on each run
+static int32_t mavTxBudget;
+
+static int mavlinkStreamTrigger(mavlinkStream_e streamNum)
 {
-    uint8_t rate = (uint8_t) mavRates[streamNum];
+    uint8_t rate = telemetryConfig()->mavlink_stream_rates[streamNum];
     if (rate == 0) {
         return 0;
     }
 
     if (mavTicks[streamNum] == 0) {
+        if (mavTxBudget <= 0) {
+            // the link is saturated, try again on the next run
+            return 0;
+        }
+
         // we're triggering now, setup the next trigger point
         if (rate > TELEMETRY_MAVLINK_MAXRATE) {
             rate = TELEMETRY_MAVLINK_MAXRATE;
@@ -129,11 +138,65 @@ static int mavlinkStreamTrigger(enum MAV_DATA_STREAM streamNum)
     return 0;
 }
 
+static void mavlinkFlush(void)
+{
+    // drop the batch rather than block when the port is still busy
+    if (mavTxBufferLength && serialTxBytesFree(mavlinkPort) >= mavTxBufferLength) {
+        serialWriteBuf(mavlinkPort, mavTxBuffer, mavTxBufferLength);
+    }
+    mavTxBufferLength = 0;
+}
 
 static void mavlinkSerialWrite(uint8_t * buf, uint16_t length)
 {
-    for (int i = 0; i < length; i++)
-        serialWrite(mavlinkPort, buf[i]);
+    if (mavTxBufferLength + length > MAVLINK_TX_BUFFER_SIZE) {
+        mavlinkFlush();
+    }
+    memcpy(&mavTxBuffer[mavTxBufferLength], buf, length);
+    mavTxBufferLength += length;
+    mavTxBudget -= length;
+}
+
+// Frames the packed message as MAVLink 2, with the trailing zero bytes of the payload truncated
+static uint16_t mavlink2MsgToSendBuffer(uint8_t *buffer, const mavlink_message_t *msg)
+{
+    static const uint8_t mavlinkMessageCrcs[256] = MAVLINK_MESSAGE_CRCS;
+    const uint8_t *payload = (const uint8_t *)_MAV_PAYLOAD(msg);
+
+    uint8_t length = msg->len;
+    while (length > 1 && payload[length - 1] == 0) {
+        length--;
+    }
+
+    buffer[0] = MAVLINK2_STX;
+    buffer[1] = length;
+    buffer[2] = 0; // incompat_flags
+    buffer[3] = 0; // compat_flags
+    buffer[4] = msg->seq;
+    buffer[5] = msg->sysid;
+    buffer[6] = msg->compid;
+    buffer[7] = msg->msgid;
+    buffer[8] = 0;
+    buffer[9] = 0;
+    memcpy(&buffer[MAVLINK2_NUM_HEADER_BYTES], payload, length);
+
+    uint16_t checksum = crc_calculate(&buffer[1], MAVLINK2_NUM_HEADER_BYTES - 1 + length);
+    crc_accumulate(mavlinkMessageCrcs[msg->msgid], &checksum);
+    buffer[MAVLINK2_NUM_HEADER_BYTES + length] = checksum & 0xFF;
+    buffer[MAVLINK2_NUM_HEADER_BYTES + length + 1] = checksum >> 8;
+
+    return MAVLINK2_NUM_HEADER_BYTES + length + 2;
+}
+
+static void mavlinkSendMessage(void)
+{
+    uint16_t msgLength;
+    if (telemetryConfig()->mavlink_version == 2) {
+        msgLength = mavlink2MsgToSendBuffer(mavBuffer, &mavMsg);
+    } else {
+        msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
+    }
+    mavlinkSerialWrite(mavBuffer, msgLength);
 }
 
 void freeMAVLinkTelemetryPort(void)
@@ -193,8 +256,6 @@ void checkMAVLinkTelemetryState(void)
 
 void mavlinkSendSystemStatus(void)
 {
-    uint16_t msgLength;
-
     uint32_t onboardControlAndSensors = 35843;
 
     /*
@@ -252,13 +313,11 @@ void mavlinkSendSystemStatus(void)
         0,
         // errors_count4 Autopilot-specific errors
         0);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 }
 
 void mavlinkSendRCChannelsAndRSSI(void)
 {
-    uint16_t msgLength;
     mavlink_msg_rc_channels_raw_pack(0, 200, &mavMsg,
         // time_boot_ms Timestamp (milliseconds since system boot)
         millis(),
@@ -282,14 +341,12 @@ void mavlinkSendRCChannelsAndRSSI(void)
         (rxRuntimeConfig.channelCount >= 8) ? rcData[7] : 0,
         // rssi Receive signal strength indicator, 0: 0%, 255: 100%
         constrain(scaleRange(getRssi(), 0, RSSI_MAX_VALUE, 0, 255), 0, 255));
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 }
 
 #if defined(USE_GPS)
 void mavlinkSendPosition(void)
 {
-    uint16_t msgLength;
     uint8_t gpsFixType = 0;
 
     if (!sensors(SENSOR_GPS))
@@ -328,8 +385,7 @@ void mavlinkSendPosition(void)
         gpsSol.groundCourse * 10,
         // satellites_visible Number of satellites visible. If unknown, set to 255
         gpsSol.numSat);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 
     // Global position
     mavlink_msg_global_position_int_pack(0, 200, &mavMsg,
@@ -354,10 +410,9 @@ void mavlinkSendPosition(void)
         // Ground Z Speed (Altitude), expressed as m/s * 100
         0,
         // heading Current heading in degrees, in compass units (0..360, 0=north)
-        DECIDEGREES_TO_DEGREES(attitude.values.yaw)
+        DECIDEGREES_TO_DEGREES(getAttitude()->values.yaw)
     );
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 
     mavlink_msg_gps_global_origin_pack(0, 200, &mavMsg,
         // latitude Latitude (WGS84), expressed as * 1E7
@@ -366,36 +421,32 @@ void mavlinkSendPosition(void)
         GPS_home[LON],
         // altitude Altitude(WGS84), expressed as * 1000
         0);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 }
 #endif
 
 void mavlinkSendAttitude(void)
 {
-    uint16_t msgLength;
     mavlink_msg_attitude_pack(0, 200, &mavMsg,
         // time_boot_ms Timestamp (milliseconds since system boot)
         millis(),
         // roll Roll angle (rad)
-        DECIDEGREES_TO_RADIANS(attitude.values.roll),
+        DECIDEGREES_TO_RADIANS(getAttitude()->values.roll),
         // pitch Pitch angle (rad)
-        DECIDEGREES_TO_RADIANS(-attitude.values.pitch),
+        DECIDEGREES_TO_RADIANS(-getAttitude()->values.pitch),
         // yaw Yaw angle (rad)
-        DECIDEGREES_TO_RADIANS(attitude.values.yaw),
+        DECIDEGREES_TO_RADIANS(getAttitude()->values.yaw),
         // rollspeed Roll angular speed (rad/s)
         0,
         // pitchspeed Pitch angular speed (rad/s)
         0,
         // yawspeed Yaw angular speed (rad/s)
         0);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 }
 
 void mavlinkSendHUDAndHeartbeat(void)
 {
-    uint16_t msgLength;
     float mavAltitude = 0;
     float mavGroundSpeed = 0;
     float mavAirSpeed = 0;
@@ -433,15 +484,14 @@ void mavlinkSendHUDAndHeartbeat(void)
         // groundspeed Current ground speed in m/s
         mavGroundSpeed,
         // heading Current heading in degrees, in compass units (0..360, 0=north)
-        DECIDEGREES_TO_DEGREES(attitude.values.yaw),
+        DECIDEGREES_TO_DEGREES(getAttitude()->values.yaw),
         // throttle Current throttle setting in integer percent, 0 to 100
         scaleRange(constrain(rcData[THROTTLE], PWM_RANGE_MIN, PWM_RANGE_MAX), PWM_RANGE_MIN, PWM_RANGE_MAX, 0, 100),
         // alt Current altitude (MSL), in meters, if we have sonar or baro use them, otherwise use GPS (less accurate)
         mavAltitude,
         // climb Current climb rate in meters/second
         mavClimbRate);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 
 
     uint8_t mavModes = MAV_MODE_FLAG_MANUAL_INPUT_ENABLED;
@@ -525,34 +575,39 @@ void mavlinkSendHUDAndHeartbeat(void)
         mavCustomMode,
         // system_status System status flag, see MAV_STATE ENUM
         mavSystemState);
-    msgLength = mavlink_msg_to_send_buffer(mavBuffer, &mavMsg);
-    mavlinkSerialWrite(mavBuffer, msgLength);
+    mavlinkSendMessage();
 }
 
 void processMAVLinkTelemetry(void)
 {
     // is executed @ TELEMETRY_MAVLINK_MAXRATE rate
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTENDED_STATUS)) {
+    // one start bit, eight data bits and one stop bit per byte
+    const int32_t bytesPerRun = mavlinkPort->baudRate / 10 / TELEMETRY_MAVLINK_MAXRATE;
+    mavTxBudget = MIN(mavTxBudget + bytesPerRun, bytesPerRun * MAVLINK_TX_BUDGET_MAX_RUNS);
+
+    if (mavlinkStreamTrigger(MAVLINK_STREAM_EXTENDED_STATUS)) {
         mavlinkSendSystemStatus();
     }
 
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_RC_CHANNELS)) {
+    if (mavlinkStreamTrigger(MAVLINK_STREAM_RC_CHANNELS)) {
         mavlinkSendRCChannelsAndRSSI();
     }
 
 #ifdef USE_GPS
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_POSITION)) {
+    if (mavlinkStreamTrigger(MAVLINK_STREAM_POSITION)) {
         mavlinkSendPosition();
     }
 #endif
 
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA1)) {
+    if (mavlinkStreamTrigger(MAVLINK_STREAM_EXTRA1)) {
         mavlinkSendAttitude();
     }
 
-    if (mavlinkStreamTrigger(MAV_DATA_STREAM_EXTRA2)) {
+    if (mavlinkStreamTrigger(MAVLINK_STREAM_EXTRA2)) {
         mavlinkSendHUDAndHeartbeat();
     }
+
+    mavlinkFlush();
 }
 
 void handleMAVLinkTelemetry(void)
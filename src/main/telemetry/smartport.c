@@ -72,12 +72,14 @@
 #include "sensors/barometer.h"
 #include "sensors/compass.h"
 #include "sensors/esc_sensor.h"
+#include "sensors/esc_stats.h"
 #include "sensors/gyro.h"
 
 #include "rx/rx.h"
 
 #include "telemetry/telemetry.h"
 #include "telemetry/smartport.h"
+#include "telemetry/telemetry_values.h"
 #include "telemetry/msp_shared.h"
 
 #define SMARTPORT_MIN_TELEMETRY_RESPONSE_DELAY_US 500
@@ -148,6 +150,8 @@ enum
 #define MAX_DATAIDS 17
 
 static uint16_t frSkyDataIdTable[MAX_DATAIDS];
+// the slot of each data identifier, sent stalest first
+static telemetrySlot_t frSkyDataIdSlots[MAX_DATAIDS];
 
 #ifdef USE_ESC_SENSOR
 // number of sensors to send between sending the ESC sensors
@@ -271,19 +275,21 @@ smartPortPayload_t *smartPortDataReceive(uint16_t c, bool *clearToSend, smartPor
     return NULL;
 }
 
-void smartPortSendByte(uint8_t c, uint16_t *checksum, serialPort_t *port)
+static uint8_t *smartPortStuffByte(uint8_t c, uint16_t *checksum, uint8_t *dst)
 {
     // smart port escape sequence
     if (c == FSSP_DLE || c == FSSP_START_STOP) {
-        serialWrite(port, FSSP_DLE);
-        serialWrite(port, c ^ FSSP_DLE_XOR);
+        *dst++ = FSSP_DLE;
+        *dst++ = c ^ FSSP_DLE_XOR;
     } else {
-        serialWrite(port, c);
+        *dst++ = c;
     }
 
     if (checksum != NULL) {
         *checksum += c;
     }
+
+    return dst;
 }
 
 bool smartPortPayloadContainsMSP(const smartPortPayload_t *payload)
@@ -292,19 +298,31 @@ bool smartPortPayloadContainsMSP(const smartPortPayload_t *payload)
 }
 
 
-void smartPortWriteFrameSerial(const smartPortPayload_t *payload, serialPort_t *port, uint16_t checksum)
+// Stuffs the header, payload and checksum into one buffer, so the port sends the frame in a single transfer
+void smartPortWriteFrameSerial(const smartPortPayload_t *payload, serialPort_t *port, const uint8_t *header, uint8_t headerLength)
 {
-    uint8_t *data = (uint8_t *)payload;
+    // every byte may need escaping
+    uint8_t frame[2 * (SMARTPORT_FRAME_HEADER_MAX + sizeof(smartPortPayload_t) + 1)];
+    uint8_t *dst = frame;
+    uint16_t checksum = 0;
+
+    headerLength = MIN(headerLength, SMARTPORT_FRAME_HEADER_MAX);
+    for (unsigned i = 0; i < headerLength; i++) {
+        dst = smartPortStuffByte(header[i], &checksum, dst);
+    }
+    const uint8_t *data = (const uint8_t *)payload;
     for (unsigned i = 0; i < sizeof(smartPortPayload_t); i++) {
-        smartPortSendByte(*data++, &checksum, port);
+        dst = smartPortStuffByte(*data++, &checksum, dst);
     }
     checksum = 0xff - ((checksum & 0xff) + (checksum >> 8));
-    smartPortSendByte((uint8_t)checksum, NULL, port);
+    dst = smartPortStuffByte((uint8_t)checksum, NULL, dst);
+
+    serialWriteBuf(port, frame, dst - frame);
 }
 
 static void smartPortWriteFrameInternal(const smartPortPayload_t *payload)
 {
-    smartPortWriteFrameSerial(payload, smartPortSerialPort, 0);
+    smartPortWriteFrameSerial(payload, smartPortSerialPort, NULL, 0);
 }
 
 static void smartPortSendPackage(uint16_t id, uint32_t val)
@@ -321,24 +339,27 @@ static bool reportExtendedEscSensors(void) {
     return feature(FEATURE_ESC_SENSOR) && telemetryConfig()->smartport_use_extra_sensors;
 }
 
-#define ADD_SENSOR(dataId) frSkyDataIdTableInfo.table[frSkyDataIdTableInfo.index++] = dataId
+#define ADD_SENSOR(dataId, valueId, priority) do { \
+    telemetrySlotInit(&frSkyDataIdSlots[frSkyDataIdTableInfo.index], valueId, priority); \
+    frSkyDataIdTableInfo.table[frSkyDataIdTableInfo.index++] = dataId; \
+} while (0)
 
 static void initSmartPortSensors(void)
 {
     frSkyDataIdTableInfo.index = 0;
 
-    ADD_SENSOR(FSSP_DATAID_T1);
-    ADD_SENSOR(FSSP_DATAID_T2);
+    ADD_SENSOR(FSSP_DATAID_T1, TELEMETRY_VALUE_NONE, 1);
+    ADD_SENSOR(FSSP_DATAID_T2, TELEMETRY_VALUE_NONE, 1);
 
     if (isBatteryVoltageConfigured()) {
 #ifdef USE_ESC_SENSOR
         if (!reportExtendedEscSensors())
 #endif
         {
-            ADD_SENSOR(FSSP_DATAID_VFAS);
+            ADD_SENSOR(FSSP_DATAID_VFAS, TELEMETRY_VALUE_VOLTAGE, 3);
         }
 
-        ADD_SENSOR(FSSP_DATAID_A4);
+        ADD_SENSOR(FSSP_DATAID_A4, TELEMETRY_VALUE_CELL_VOLTAGE, 2);
     }
 
     if (isAmperageConfigured()) {
@@ -346,31 +367,31 @@ static void initSmartPortSensors(void)
         if (!reportExtendedEscSensors())
 #endif
         {
-            ADD_SENSOR(FSSP_DATAID_CURRENT);
+            ADD_SENSOR(FSSP_DATAID_CURRENT, TELEMETRY_VALUE_CURRENT, 3);
         }
 
-        ADD_SENSOR(FSSP_DATAID_FUEL);
+        ADD_SENSOR(FSSP_DATAID_FUEL, TELEMETRY_VALUE_MAH_DRAWN, 2);
     }
 
     if (sensors(SENSOR_ACC)) {
-        ADD_SENSOR(FSSP_DATAID_HEADING);
-        ADD_SENSOR(FSSP_DATAID_ACCX);
-        ADD_SENSOR(FSSP_DATAID_ACCY);
-        ADD_SENSOR(FSSP_DATAID_ACCZ);
+        ADD_SENSOR(FSSP_DATAID_HEADING, TELEMETRY_VALUE_HEADING, 2);
+        ADD_SENSOR(FSSP_DATAID_ACCX, TELEMETRY_VALUE_ACC_X, 1);
+        ADD_SENSOR(FSSP_DATAID_ACCY, TELEMETRY_VALUE_ACC_Y, 1);
+        ADD_SENSOR(FSSP_DATAID_ACCZ, TELEMETRY_VALUE_ACC_Z, 1);
     }
 
     if (sensors(SENSOR_BARO)) {
-        ADD_SENSOR(FSSP_DATAID_ALTITUDE);
-        ADD_SENSOR(FSSP_DATAID_VARIO);
+        ADD_SENSOR(FSSP_DATAID_ALTITUDE, TELEMETRY_VALUE_ALTITUDE, 3);
+        ADD_SENSOR(FSSP_DATAID_VARIO, TELEMETRY_VALUE_VARIO, 3);
     }
 
 #ifdef USE_GPS
     if (feature(FEATURE_GPS)) {
-        ADD_SENSOR(FSSP_DATAID_SPEED);
-        ADD_SENSOR(FSSP_DATAID_LATLONG);
-        ADD_SENSOR(FSSP_DATAID_LATLONG); // twice (one for lat, one for long)
-        ADD_SENSOR(FSSP_DATAID_HOME_DIST);
-        ADD_SENSOR(FSSP_DATAID_GPS_ALT);
+        ADD_SENSOR(FSSP_DATAID_SPEED, TELEMETRY_VALUE_GPS_SPEED, 2);
+        ADD_SENSOR(FSSP_DATAID_LATLONG, TELEMETRY_VALUE_GPS_LATITUDE, 2);
+        ADD_SENSOR(FSSP_DATAID_LATLONG, TELEMETRY_VALUE_GPS_LONGITUDE, 2); // twice (one for lat, one for long)
+        ADD_SENSOR(FSSP_DATAID_HOME_DIST, TELEMETRY_VALUE_HOME_DISTANCE, 2);
+        ADD_SENSOR(FSSP_DATAID_GPS_ALT, TELEMETRY_VALUE_GPS_ALTITUDE, 1);
     }
 #endif
 
@@ -480,6 +501,8 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
     UNUSED(payload);
 #endif
 
+    telemetryValuesUpdate(millis());
+
     bool doRun = true;
     while (doRun && *clearToSend) {
         // Ensure we won't get stuck in the loop if there happens to be nothing available to send in a timely manner - dump the slot if we loop in there for too long.
@@ -502,45 +525,43 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
         }
 #endif
 
-        // we can send back any data we want, our tables keep track of the order and frequency of each data type we send
-        frSkyTableInfo_t * tableInfo = &frSkyDataIdTableInfo;
+        // we can send back any data we want, the slots send the stalest values first and the ESC table is sent in turn
+        uint16_t id;
+        telemetryValueId_e valueId = TELEMETRY_VALUE_NONE;
 
 #ifdef USE_ESC_SENSOR
+        frSkyTableInfo_t *escTableInfo = &frSkyEscDataIdTableInfo;
+        bool sendEscSensor = false;
         if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            // send ESC sensors
-            tableInfo = &frSkyEscDataIdTableInfo;
-            if (tableInfo->index == tableInfo->size) { // end of ESC table, return to other sensors
-                tableInfo->index = 0;
+            if (escTableInfo->index == escTableInfo->size) { // end of ESC table, return to other sensors
+                escTableInfo->index = 0;
                 smartPortIdCycleCnt = 0;
                 smartPortIdOffset++;
                 if (smartPortIdOffset == getMotorCount() + 1) { // each motor and ESC_SENSOR_COMBINED
                     smartPortIdOffset = 0;
                 }
+            } else {
+                sendEscSensor = true;
             }
         }
-        if (smartPortIdCycleCnt < ESC_SENSOR_PERIOD) {
-            // send other sensors
-            tableInfo = &frSkyDataIdTableInfo;
+        if (sendEscSensor) {
+            id = escTableInfo->table[escTableInfo->index++] + smartPortIdOffset;
+        } else
 #endif
-            if (tableInfo->index == tableInfo->size) { // end of table reached, loop back
-                tableInfo->index = 0;
+        {
+            const int slot = telemetrySlotSelect(frSkyDataIdSlots, frSkyDataIdTableInfo.size, millis());
+            if (slot < 0) {
+                *clearToSend = false;
+
+                return;
             }
-#ifdef USE_ESC_SENSOR
+            id = frSkyDataIdTable[slot];
+            valueId = frSkyDataIdSlots[slot].valueId;
         }
-#endif
-        uint16_t id = tableInfo->table[tableInfo->index];
-#ifdef USE_ESC_SENSOR
-        if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            id += smartPortIdOffset;
-        }
-#endif
         smartPortIdCycleCnt++;
-        tableInfo->index++;
 
         int32_t tmpi;
         uint32_t tmp2 = 0;
-        uint16_t vfasVoltage;
-        uint8_t cellCount;
 
 #ifdef USE_ESC_SENSOR
         escSensorData_t *escData;
@@ -548,12 +569,11 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
 
         switch (id) {
             case FSSP_DATAID_VFAS       :
-                vfasVoltage = getBatteryVoltage();
                 if (telemetryConfig()->report_cell_voltage) {
-                    cellCount = getBatteryCellCount();
-                    vfasVoltage = cellCount ? getBatteryVoltage() / cellCount : 0;
+                    smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_CELL_VOLTAGE)); // given in 0.01V
+                } else {
+                    smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_VOLTAGE) * 10); // given in 0.1V, convert to volts
                 }
-                smartPortSendPackage(id, vfasVoltage * 10); // given in 0.1V, convert to volts
                 *clearToSend = false;
                 break;
 #ifdef USE_ESC_SENSOR
@@ -573,7 +593,7 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                 break;
 #endif
             case FSSP_DATAID_CURRENT    :
-                smartPortSendPackage(id, getAmperage() / 10); // given in 10mA steps, unknown requested unit
+                smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_CURRENT) / 10); // given in 10mA steps, unknown requested unit
                 *clearToSend = false;
                 break;
 #ifdef USE_ESC_SENSOR
@@ -592,6 +612,17 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                 }
                 break;
             case FSSP_DATAID_RPM        :
+#ifdef USE_ESC_STATS
+                {
+                    // averaged over the last statistics window and all motors
+                    const escStats_t *escStats = getEscStats(ESC_STATS_COMBINED);
+                    if (escStatsIsValid(escStats, ESC_STATS_ERPM)) {
+                        smartPortSendPackage(id, calcEscRpm(escStats->values[ESC_STATS_ERPM].avg));
+                        *clearToSend = false;
+                        break;
+                    }
+                }
+#endif
                 escData = getEscSensorData(ESC_SENSOR_COMBINED);
                 if (escData != NULL) {
                     smartPortSendPackage(id, calcEscRpm(escData->rpm));
@@ -613,6 +644,17 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                 }
                 break;
             case FSSP_DATAID_TEMP        :
+#ifdef USE_ESC_STATS
+                {
+                    // a single polled sample can miss the peak of the hottest ESC
+                    const escStats_t *escStats = getEscStats(ESC_STATS_COMBINED);
+                    if (escStatsIsValid(escStats, ESC_STATS_TEMPERATURE)) {
+                        smartPortSendPackage(id, escStats->values[ESC_STATS_TEMPERATURE].max);
+                        *clearToSend = false;
+                        break;
+                    }
+                }
+#endif
                 escData = getEscSensorData(ESC_SENSOR_COMBINED);
                 if (escData != NULL) {
                     smartPortSendPackage(id, escData->temperature);
@@ -635,31 +677,31 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                 break;
 #endif
             case FSSP_DATAID_ALTITUDE   :
-                smartPortSendPackage(id, getEstimatedAltitude()); // unknown given unit, requested 100 = 1 meter
+                smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_ALTITUDE)); // unknown given unit, requested 100 = 1 meter
                 *clearToSend = false;
                 break;
             case FSSP_DATAID_FUEL       :
-                smartPortSendPackage(id, getMAhDrawn()); // given in mAh, unknown requested unit
+                smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_MAH_DRAWN)); // given in mAh, unknown requested unit
                 *clearToSend = false;
                 break;
             case FSSP_DATAID_VARIO      :
-                smartPortSendPackage(id, getEstimatedVario()); // unknown given unit but requested in 100 = 1m/s
+                smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_VARIO)); // unknown given unit but requested in 100 = 1m/s
                 *clearToSend = false;
                 break;
             case FSSP_DATAID_HEADING    :
-                smartPortSendPackage(id, attitude.values.yaw * 10); // given in 10*deg, requested in 10000 = 100 deg
+                smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_HEADING) * 10); // given in 10*deg, requested in 10000 = 100 deg
                 *clearToSend = false;
                 break;
             case FSSP_DATAID_ACCX       :
-                smartPortSendPackage(id, lrintf(100 * acc.accADC[X] / acc.dev.acc_1G)); // Multiply by 100 to show as x.xx g on Taranis
+                smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_ACC_X)); // given in 0.01G to show as x.xx g on Taranis
                 *clearToSend = false;
                 break;
             case FSSP_DATAID_ACCY       :
-                smartPortSendPackage(id, lrintf(100 * acc.accADC[Y] / acc.dev.acc_1G));
+                smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_ACC_Y));
                 *clearToSend = false;
                 break;
             case FSSP_DATAID_ACCZ       :
-                smartPortSendPackage(id, lrintf(100 * acc.accADC[Z] / acc.dev.acc_1G));
+                smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_ACC_Z));
                 *clearToSend = false;
                 break;
             case FSSP_DATAID_T1         :
@@ -758,51 +800,51 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                 break;
 #ifdef USE_GPS
             case FSSP_DATAID_SPEED      :
-                if (STATE(GPS_FIX)) {
+                if (telemetryValueIsValid(TELEMETRY_VALUE_GPS_SPEED)) {
                     //convert to knots: 1cm/s = 0.0194384449 knots
                     //Speed should be sent in knots/1000 (GPS speed is in cm/s)
-                    uint32_t tmpui = gpsSol.groundSpeed * 1944 / 100;
+                    uint32_t tmpui = telemetryValue(TELEMETRY_VALUE_GPS_SPEED) * 1944 / 100;
                     smartPortSendPackage(id, tmpui);
                     *clearToSend = false;
                 }
                 break;
             case FSSP_DATAID_LATLONG    :
-                if (STATE(GPS_FIX)) {
+                if (telemetryValueIsValid(TELEMETRY_VALUE_GPS_LATITUDE)) {
                     uint32_t tmpui = 0;
                     // the same ID is sent twice, one for longitude, one for latitude
                     // the MSB of the sent uint32_t helps FrSky keep track
-                    // the even/odd bit of our counter helps us keep track
-                    if (tableInfo->index & 1) {
-                        tmpui = abs(gpsSol.llh.lon);  // now we have unsigned value and one bit to spare
+                    // the value of the slot tells us which one this is
+                    if (valueId == TELEMETRY_VALUE_GPS_LONGITUDE) {
+                        const int32_t lon = telemetryValue(TELEMETRY_VALUE_GPS_LONGITUDE);
+                        tmpui = abs(lon);  // now we have unsigned value and one bit to spare
                         tmpui = (tmpui + tmpui / 2) / 25 | 0x80000000;  // 6/100 = 1.5/25, division by power of 2 is fast
-                        if (gpsSol.llh.lon < 0) tmpui |= 0x40000000;
+                        if (lon < 0) tmpui |= 0x40000000;
                     }
                     else {
-                        tmpui = abs(gpsSol.llh.lat);  // now we have unsigned value and one bit to spare
+                        const int32_t lat = telemetryValue(TELEMETRY_VALUE_GPS_LATITUDE);
+                        tmpui = abs(lat);  // now we have unsigned value and one bit to spare
                         tmpui = (tmpui + tmpui / 2) / 25;  // 6/100 = 1.5/25, division by power of 2 is fast
-                        if (gpsSol.llh.lat < 0) tmpui |= 0x40000000;
+                        if (lat < 0) tmpui |= 0x40000000;
                     }
                     smartPortSendPackage(id, tmpui);
                     *clearToSend = false;
                 }
                 break;
             case FSSP_DATAID_HOME_DIST  :
-                if (STATE(GPS_FIX)) {
-                    smartPortSendPackage(id, GPS_distanceToHome);
+                if (telemetryValueIsValid(TELEMETRY_VALUE_HOME_DISTANCE)) {
+                    smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_HOME_DISTANCE));
                      *clearToSend = false;
                 }
                 break;
             case FSSP_DATAID_GPS_ALT    :
-                if (STATE(GPS_FIX)) {
-                    smartPortSendPackage(id, gpsSol.llh.alt * 100); // given in 0.1m , requested in 10 = 1m (should be in mm, probably a bug in opentx, tested on 2.0.1.7)
+                if (telemetryValueIsValid(TELEMETRY_VALUE_GPS_ALTITUDE)) {
+                    smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_GPS_ALTITUDE) * 100); // given in 0.1m , requested in 10 = 1m (should be in mm, probably a bug in opentx, tested on 2.0.1.7)
                     *clearToSend = false;
                 }
                 break;
 #endif
             case FSSP_DATAID_A4         :
-                cellCount = getBatteryCellCount();
-                vfasVoltage = cellCount ? (getBatteryVoltage() * 10 / cellCount) : 0; // given in 0.1V, convert to volts
-                smartPortSendPackage(id, vfasVoltage);
+                smartPortSendPackage(id, telemetryValue(TELEMETRY_VALUE_CELL_VOLTAGE)); // given in 0.01V
                 *clearToSend = false;
                 break;
             default:
@@ -32,6 +32,8 @@
 
 #define SMARTPORT_MSP_TX_BUF_SIZE 256
 #define SMARTPORT_MSP_RX_BUF_SIZE 64
+// longest header written ahead of a frame, e.g. the FPort length and type
+#define SMARTPORT_FRAME_HEADER_MAX 2
 
 enum
 {
@@ -73,6 +75,5 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *hasRe
 smartPortPayload_t *smartPortDataReceive(uint16_t c, bool *clearToSend, smartPortCheckQueueEmptyFn *checkQueueEmpty, bool withChecksum);
 
 struct serialPort_s;
-void smartPortWriteFrameSerial(const smartPortPayload_t *payload, struct serialPort_s *port, uint16_t checksum);
-void smartPortSendByte(uint8_t c, uint16_t *checksum, struct serialPort_s *port);
+void smartPortWriteFrameSerial(const smartPortPayload_t *payload, struct serialPort_s *port, const uint8_t *header, uint8_t headerLength);
 bool smartPortPayloadContainsMSP(const smartPortPayload_t *payload);
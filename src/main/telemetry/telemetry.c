@@ -32,6 +32,7 @@
 #include "pg/pg_ids.h"
 #include "pg/rx.h"
 
+#include "drivers/time.h"
 #include "drivers/timer.h"
 #include "drivers/serial.h"
 #include "drivers/serial_softserial.h"
@@ -47,6 +48,7 @@
 #include "rx/rx.h"
 
 #include "telemetry/telemetry.h"
+#include "telemetry/telemetry_values.h"
 #include "telemetry/frsky_hub.h"
 #include "telemetry/hott.h"
 #include "telemetry/smartport.h"
@@ -58,7 +60,7 @@
 #include "telemetry/ibus.h"
 #include "telemetry/msp_shared.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 2);
+PG_REGISTER_WITH_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 3);
 
 PG_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig,
     .telemetry_inverted = false,
@@ -77,6 +79,14 @@ PG_RESET_TEMPLATE(telemetryConfig_t, telemetryConfig,
             IBUS_SENSOR_TYPE_EXTERNAL_VOLTAGE
     },
     .smartport_use_extra_sensors = false,
+    .mavlink_version = 1,
+    .mavlink_stream_rates = {
+        [MAVLINK_STREAM_EXTENDED_STATUS] = 2,
+        [MAVLINK_STREAM_RC_CHANNELS] = 5,
+        [MAVLINK_STREAM_POSITION] = 2,
+        [MAVLINK_STREAM_EXTRA1] = 10,
+        [MAVLINK_STREAM_EXTRA2] = 10,
+    },
 );
 
 void telemetryInit(void)
@@ -190,6 +200,8 @@ void telemetryCheckState(void)
 
 void telemetryProcess(uint32_t currentTime)
 {
+    telemetryValuesUpdate(millis());
+
 #ifdef USE_TELEMETRY_FRSKY_HUB
     handleFrSkyHubTelemetry(currentTime);
 #else
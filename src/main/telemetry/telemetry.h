@@ -41,6 +41,17 @@ typedef enum {
     FRSKY_UNIT_IMPERIALS
 } frskyUnit_e;
 
+typedef enum {
+    MAVLINK_STREAM_EXTENDED_STATUS = 0,
+    MAVLINK_STREAM_RC_CHANNELS,
+    MAVLINK_STREAM_POSITION,
+    MAVLINK_STREAM_EXTRA1,
+    MAVLINK_STREAM_EXTRA2,
+    MAVLINK_STREAM_COUNT
+} mavlinkStream_e;
+
+#define MAVLINK_STREAM_RATE_MAX 50
+
 typedef struct telemetryConfig_s {
     int16_t gpsNoFixLatitude;
     int16_t gpsNoFixLongitude;
@@ -54,6 +65,8 @@ typedef struct telemetryConfig_s {
     uint8_t report_cell_voltage;
     uint8_t flysky_sensors[IBUS_SENSOR_COUNT];
     uint8_t smartport_use_extra_sensors;
+    uint8_t mavlink_version;
+    uint8_t mavlink_stream_rates[MAVLINK_STREAM_COUNT]; // Hz, 0 disables the stream
 } telemetryConfig_t;
 
 PG_DECLARE(telemetryConfig_t, telemetryConfig);
@@ -0,0 +1,181 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_TELEMETRY
+
+#include "common/axis.h"
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "fc/runtime_config.h"
+
+#include "flight/imu.h"
+#include "flight/position.h"
+
+#include "io/gps.h"
+
+#include "sensors/acceleration.h"
+#include "sensors/battery.h"
+#include "sensors/sensors.h"
+
+#include "telemetry/telemetry_values.h"
+
+// the values are refreshed at most this often, however many protocols read them
+#define TELEMETRY_VALUES_UPDATE_INTERVAL_MS 10
+// the staleness of a slot whose value has not changed since it was sent counts for this much less
+#define TELEMETRY_UNCHANGED_AGE_DIVIDER 4
+// limits the staleness so the scores cannot overflow
+#define TELEMETRY_SLOT_MAX_AGE_MS 60000
+
+// smallest step counted as a change, so sensor noise does not keep a value fresh
+static const uint8_t telemetryValueDeadband[TELEMETRY_VALUE_COUNT] = {
+    [TELEMETRY_VALUE_VOLTAGE] = 1,
+    [TELEMETRY_VALUE_CELL_VOLTAGE] = 2,
+    [TELEMETRY_VALUE_CURRENT] = 10,
+    [TELEMETRY_VALUE_MAH_DRAWN] = 1,
+    [TELEMETRY_VALUE_FUEL_PERCENT] = 1,
+    [TELEMETRY_VALUE_ALTITUDE] = 10,
+    [TELEMETRY_VALUE_VARIO] = 10,
+    [TELEMETRY_VALUE_ROLL] = 10,
+    [TELEMETRY_VALUE_PITCH] = 10,
+    [TELEMETRY_VALUE_HEADING] = 10,
+    [TELEMETRY_VALUE_ACC_X] = 5,
+    [TELEMETRY_VALUE_ACC_Y] = 5,
+    [TELEMETRY_VALUE_ACC_Z] = 5,
+    [TELEMETRY_VALUE_GPS_LATITUDE] = 10,
+    [TELEMETRY_VALUE_GPS_LONGITUDE] = 10,
+    [TELEMETRY_VALUE_GPS_ALTITUDE] = 10,
+    [TELEMETRY_VALUE_GPS_SPEED] = 10,
+    [TELEMETRY_VALUE_GPS_SATS] = 1,
+    [TELEMETRY_VALUE_HOME_DISTANCE] = 1,
+};
+
+static telemetryValue_t telemetryValues[TELEMETRY_VALUE_COUNT];
+static timeMs_t telemetryValuesUpdatedAtMs;
+static bool telemetryValuesUpdated;
+
+static void telemetryValueSet(telemetryValueId_e id, int32_t value, bool valid, timeMs_t currentTimeMs)
+{
+    telemetryValue_t *entry = &telemetryValues[id];
+    if (valid && (!entry->valid || abs(value - entry->changedValue) >= telemetryValueDeadband[id])) {
+        entry->changedValue = value;
+        entry->changedAtMs = currentTimeMs;
+    }
+    entry->value = value;
+    entry->valid = valid;
+}
+
+void telemetryValuesUpdate(timeMs_t currentTimeMs)
+{
+    if (telemetryValuesUpdated && currentTimeMs - telemetryValuesUpdatedAtMs < TELEMETRY_VALUES_UPDATE_INTERVAL_MS) {
+        return;
+    }
+    telemetryValuesUpdated = true;
+    telemetryValuesUpdatedAtMs = currentTimeMs;
+
+    const bool voltageValid = isBatteryVoltageConfigured();
+    const uint16_t voltage = getBatteryVoltage();
+    const uint8_t cellCount = getBatteryCellCount();
+    telemetryValueSet(TELEMETRY_VALUE_VOLTAGE, voltage, voltageValid, currentTimeMs);
+    telemetryValueSet(TELEMETRY_VALUE_CELL_VOLTAGE, cellCount ? voltage * 10 / cellCount : 0, voltageValid, currentTimeMs);
+    telemetryValueSet(TELEMETRY_VALUE_FUEL_PERCENT, calculateBatteryPercentageRemaining(), voltageValid, currentTimeMs);
+
+    const bool amperageValid = isAmperageConfigured();
+    telemetryValueSet(TELEMETRY_VALUE_CURRENT, getAmperage(), amperageValid, currentTimeMs);
+    telemetryValueSet(TELEMETRY_VALUE_MAH_DRAWN, getMAhDrawn(), amperageValid, currentTimeMs);
+
+    telemetryValueSet(TELEMETRY_VALUE_ALTITUDE, getEstimatedAltitude(), true, currentTimeMs);
+    telemetryValueSet(TELEMETRY_VALUE_VARIO, getEstimatedVario(), true, currentTimeMs);
+
+    const bool accValid = sensors(SENSOR_ACC);
+    const attitudeEulerAngles_t *attitude = getAttitude();
+    telemetryValueSet(TELEMETRY_VALUE_ROLL, attitude->values.roll, accValid, currentTimeMs);
+    telemetryValueSet(TELEMETRY_VALUE_PITCH, attitude->values.pitch, accValid, currentTimeMs);
+    telemetryValueSet(TELEMETRY_VALUE_HEADING, attitude->values.yaw, accValid, currentTimeMs);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const int32_t accCentiG = accValid && acc.dev.acc_1G ? lrintf(100 * acc.accADC[axis] / acc.dev.acc_1G) : 0;
+        telemetryValueSet(TELEMETRY_VALUE_ACC_X + axis, accCentiG, accValid, currentTimeMs);
+    }
+
+#ifdef USE_GPS
+    const bool fixValid = STATE(GPS_FIX);
+    telemetryValueSet(TELEMETRY_VALUE_GPS_LATITUDE, gpsSol.llh.lat, fixValid, currentTimeMs);
+    telemetryValueSet(TELEMETRY_VALUE_GPS_LONGITUDE, gpsSol.llh.lon, fixValid, currentTimeMs);
+    telemetryValueSet(TELEMETRY_VALUE_GPS_ALTITUDE, gpsSol.llh.alt, fixValid, currentTimeMs);
+    telemetryValueSet(TELEMETRY_VALUE_GPS_SPEED, gpsSol.groundSpeed, fixValid, currentTimeMs);
+    telemetryValueSet(TELEMETRY_VALUE_GPS_SATS, gpsSol.numSat, sensors(SENSOR_GPS), currentTimeMs);
+    telemetryValueSet(TELEMETRY_VALUE_HOME_DISTANCE, GPS_distanceToHome, fixValid, currentTimeMs);
+#endif
+}
+
+int32_t telemetryValue(telemetryValueId_e id)
+{
+    return telemetryValues[id].value;
+}
+
+bool telemetryValueIsValid(telemetryValueId_e id)
+{
+    return telemetryValues[id].valid;
+}
+
+void telemetrySlotInit(telemetrySlot_t *slot, telemetryValueId_e valueId, uint8_t priority)
+{
+    slot->valueId = valueId;
+    slot->priority = priority;
+    slot->sentAtMs = 0;
+}
+
+// Picks the slot whose value is stalest by priority, preferring values that changed since they were sent.
+// Slots with an invalid value are skipped. The selected slot is marked as sent, -1 if none can be sent.
+int telemetrySlotSelect(telemetrySlot_t *slots, int count, timeMs_t currentTimeMs)
+{
+    int selected = -1;
+    uint32_t selectedScore = 0;
+    for (int i = 0; i < count; i++) {
+        const telemetrySlot_t *slot = &slots[i];
+        uint32_t age = MIN(currentTimeMs - slot->sentAtMs, (uint32_t)TELEMETRY_SLOT_MAX_AGE_MS);
+        if (slot->valueId != TELEMETRY_VALUE_NONE) {
+            const telemetryValue_t *entry = &telemetryValues[slot->valueId];
+            if (!entry->valid) {
+                continue;
+            }
+            if ((int32_t)(entry->changedAtMs - slot->sentAtMs) <= 0) {
+                age /= TELEMETRY_UNCHANGED_AGE_DIVIDER;
+            }
+        }
+        const uint32_t score = (age + 1) * slot->priority;
+        if (selected < 0 || score > selectedScore) {
+            selected = i;
+            selectedScore = score;
+        }
+    }
+    if (selected >= 0) {
+        slots[selected].sentAtMs = currentTimeMs;
+    }
+    return selected;
+}
+#endif
@@ -0,0 +1,80 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Shared telemetry value cache.
+ *
+ * The sensor values reported by telemetry are read and converted once per
+ * update into a table, with the time each value last changed. Protocol
+ * encoders read the converted values and use the change times to choose
+ * which of their slots to send next.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+typedef enum {
+    TELEMETRY_VALUE_VOLTAGE = 0,    // 0.1V
+    TELEMETRY_VALUE_CELL_VOLTAGE,   // 0.01V, average per cell
+    TELEMETRY_VALUE_CURRENT,        // 0.01A
+    TELEMETRY_VALUE_MAH_DRAWN,      // mAh
+    TELEMETRY_VALUE_FUEL_PERCENT,   // percent remaining
+    TELEMETRY_VALUE_ALTITUDE,       // cm
+    TELEMETRY_VALUE_VARIO,          // cm/s
+    TELEMETRY_VALUE_ROLL,           // decidegrees
+    TELEMETRY_VALUE_PITCH,          // decidegrees
+    TELEMETRY_VALUE_HEADING,        // decidegrees
+    TELEMETRY_VALUE_ACC_X,          // 0.01G
+    TELEMETRY_VALUE_ACC_Y,          // 0.01G
+    TELEMETRY_VALUE_ACC_Z,          // 0.01G
+    TELEMETRY_VALUE_GPS_LATITUDE,   // degrees * 10000000
+    TELEMETRY_VALUE_GPS_LONGITUDE,  // degrees * 10000000
+    TELEMETRY_VALUE_GPS_ALTITUDE,   // gpsSol.llh.alt units
+    TELEMETRY_VALUE_GPS_SPEED,      // gpsSol.groundSpeed units
+    TELEMETRY_VALUE_GPS_SATS,       // satellites used
+    TELEMETRY_VALUE_HOME_DISTANCE,  // m
+    TELEMETRY_VALUE_COUNT,
+    TELEMETRY_VALUE_NONE = 0xFF     // slot without a single cached source, always treated as changed
+} telemetryValueId_e;
+
+typedef struct telemetryValue_s {
+    int32_t value;
+    int32_t changedValue;           // value when the change time was last set
+    timeMs_t changedAtMs;
+    bool valid;                     // the source is present, e.g. GPS values need a fix
+} telemetryValue_t;
+
+// A value a protocol can send, with the weight given to its staleness
+typedef struct telemetrySlot_s {
+    uint8_t valueId;                // telemetryValueId_e
+    uint8_t priority;
+    timeMs_t sentAtMs;
+} telemetrySlot_t;
+
+void telemetryValuesUpdate(timeMs_t currentTimeMs);
+int32_t telemetryValue(telemetryValueId_e id);
+bool telemetryValueIsValid(telemetryValueId_e id);
+
+void telemetrySlotInit(telemetrySlot_t *slot, telemetryValueId_e valueId, uint8_t priority);
+int telemetrySlotSelect(telemetrySlot_t *slots, int count, timeMs_t currentTimeMs);
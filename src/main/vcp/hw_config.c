@@ -329,9 +329,10 @@ uint32_t CDC_Send_FreeBytes(void)
  * Output         : None.
  * Return         : None.
  *******************************************************************************/
+static uint8_t receiveOffset = 0;
+
 uint32_t CDC_Receive_DATA(uint8_t* recvBuf, uint32_t len)
 {
-    static uint8_t offset = 0;
     uint8_t i;
 
     if (len > receiveLength) {
@@ -339,18 +340,10 @@ uint32_t CDC_Receive_DATA(uint8_t* recvBuf, uint32_t len)
     }
 
     for (i = 0; i < len; i++) {
-        recvBuf[i] = (uint8_t)(receiveBuffer[i + offset]);
+        recvBuf[i] = (uint8_t)(receiveBuffer[i + receiveOffset]);
     }
 
-    receiveLength -= len;
-    offset += len;
-
-    /* re-enable the rx endpoint which we had set to receive 0 bytes */
-    if (receiveLength == 0) {
-        SetEPRxCount(ENDP3, 64);
-        SetEPRxStatus(ENDP3, EP_RX_VALID);
-        offset = 0;
-    }
+    CDC_Receive_Skip(len);
 
     return len;
 }
@@ -360,6 +353,36 @@ uint32_t CDC_Receive_BytesAvailable(void)
     return receiveLength;
 }
 
+/*******************************************************************************
+ * Function Name  : CDC_Receive_PeekContiguous.
+ * Description    : expose the received USB packet in place
+ * Input          : data: set to the first received byte.
+ * Output         : None.
+ * Return         : number of bytes available at *data.
+ *******************************************************************************/
+uint32_t CDC_Receive_PeekContiguous(const uint8_t **data)
+{
+    *data = &receiveBuffer[receiveOffset];
+    return receiveLength;
+}
+
+void CDC_Receive_Skip(uint32_t count)
+{
+    if (count > receiveLength) {
+        count = receiveLength;
+    }
+
+    receiveLength -= count;
+    receiveOffset += count;
+
+    /* re-enable the rx endpoint which we had set to receive 0 bytes */
+    if (receiveLength == 0) {
+        SetEPRxCount(ENDP3, 64);
+        SetEPRxStatus(ENDP3, EP_RX_VALID);
+        receiveOffset = 0;
+    }
+}
+
 /*******************************************************************************
  * Function Name  : usbIsConfigured.
  * Description    : Determines if USB VCP is configured or not
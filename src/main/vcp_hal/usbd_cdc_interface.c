@@ -357,6 +357,31 @@ uint32_t CDC_Receive_BytesAvailable(void)
     return rxAvailable;
 }
 
+// The received USB packet is handed out in place, the endpoint is re-armed once all of it is skipped
+uint32_t CDC_Receive_PeekContiguous(const uint8_t **data)
+{
+    if (rxBuffPtr == NULL) {
+        return 0;
+    }
+    *data = rxBuffPtr;
+    return rxAvailable;
+}
+
+void CDC_Receive_Skip(uint32_t count)
+{
+    if (rxBuffPtr == NULL || count == 0) {
+        return;
+    }
+    if (count > rxAvailable) {
+        count = rxAvailable;
+    }
+    rxBuffPtr += count;
+    rxAvailable -= count;
+    if (rxAvailable < 1) {
+        USBD_CDC_ReceivePacket(&USBD_Device);
+    }
+}
+
 uint32_t CDC_Send_FreeBytes(void)
 {
     /*
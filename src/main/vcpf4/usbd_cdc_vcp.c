@@ -245,6 +245,26 @@ uint32_t CDC_Receive_BytesAvailable(void)
     return APP_Tx_ptr_out > APP_Tx_ptr_in ? APP_TX_DATA_SIZE - APP_Tx_ptr_out + APP_Tx_ptr_in : APP_Tx_ptr_in - APP_Tx_ptr_out;
 }
 
+/*******************************************************************************
+ * Function Name  : CDC_Receive_PeekContiguous.
+ * Description    : expose the received data in place, up to the end of the circular buffer
+ * Input          : data: set to the first received byte.
+ * Output         : None.
+ * Return         : number of bytes available at *data.
+ *******************************************************************************/
+uint32_t CDC_Receive_PeekContiguous(const uint8_t **data)
+{
+    const uint32_t ptrIn = APP_Tx_ptr_in;
+
+    *data = &APP_Tx_Buffer[APP_Tx_ptr_out];
+    return ptrIn >= APP_Tx_ptr_out ? ptrIn - APP_Tx_ptr_out : APP_TX_DATA_SIZE - APP_Tx_ptr_out;
+}
+
+void CDC_Receive_Skip(uint32_t count)
+{
+    APP_Tx_ptr_out = (APP_Tx_ptr_out + count) % APP_TX_DATA_SIZE;
+}
+
 /**
  * @brief  VCP_DataRx
  *         Data received over USB OUT endpoint are sent over CDC interface
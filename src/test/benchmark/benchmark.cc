@@ -0,0 +1,175 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Host side timing of the flight critical code.
+ *
+ * Usage: <benchmark> [--baseline FILE] [--save FILE] [--tolerance PERCENT]
+ *
+ * Each result is printed in ns per call. With --baseline, results slower than
+ * the baseline by more than the tolerance are reported as regressions and the
+ * exit status is 1. With --save, the results are appended to FILE in the
+ * baseline format, one "name ns" pair per line.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "benchmark.h"
+
+#define BENCHMARK_NAME_LENGTH_MAX   64
+#define BENCHMARK_BASELINE_COUNT_MAX 64
+
+volatile float benchmarkSink;
+
+typedef struct benchmarkBaseline_s {
+    char name[BENCHMARK_NAME_LENGTH_MAX];
+    double nsPerCall;
+} benchmarkBaseline_t;
+
+static benchmarkBaseline_t baselines[BENCHMARK_BASELINE_COUNT_MAX];
+static int baselineCount;
+static double tolerancePercent = 15;
+static FILE *saveFile;
+static int regressionCount;
+
+static benchmarkTrace_t trace;
+
+// deterministic noise, so that every run sees the same trace
+static float benchmarkNoise(void)
+{
+    static uint32_t seed = 0x12345678;
+    seed = seed * 1664525 + 1013904223;
+    return (float)(seed >> 8) / (1 << 24) * 2.0f - 1.0f;
+}
+
+static void benchmarkTraceInit(void)
+{
+    const float dT = 1.0f / BENCHMARK_TRACE_RATE_HZ;
+    // response of the quad to the setpoint
+    const float responseK = dT / (0.02f + dT);
+    float response[3] = { 0, 0, 0 };
+    float motorPhase = 0;
+
+    for (int i = 0; i < BENCHMARK_TRACE_LENGTH; i++) {
+        const float t = i * dT;
+
+        // a roll at 800 deg/s, a pitch sweep and a slow yaw
+        trace.setpoint[0][i] = (t > 0.2f && t < 0.65f) ? 800.0f : 40.0f * sinf(2 * M_PI * 0.8f * t);
+        trace.setpoint[1][i] = 300.0f * sinf(2 * M_PI * 1.5f * t);
+        trace.setpoint[2][i] = 150.0f * sinf(2 * M_PI * 0.5f * t);
+
+        // punch out after the roll
+        trace.throttle[i] = (t > 0.7f && t < 0.85f) ? 0.95f : 0.35f + 0.1f * sinf(2 * M_PI * 0.7f * t);
+
+        // motor noise and its second harmonic, frequency and amplitude rising with the throttle
+        const float motorHz = 150.0f + 250.0f * trace.throttle[i];
+        motorPhase += 2 * M_PI * motorHz * dT;
+        const float motorNoise = (20.0f + 60.0f * trace.throttle[i]) * (sinf(motorPhase) + 0.4f * sinf(2 * motorPhase));
+        // frame resonance
+        const float frameNoise = 8.0f * sinf(2 * M_PI * 110.0f * t);
+
+        for (int axis = 0; axis < 3; axis++) {
+            response[axis] += responseK * (trace.setpoint[axis][i] - response[axis]);
+            trace.gyro[axis][i] = response[axis] + motorNoise * (1.0f - 0.3f * axis) + frameNoise + 3.0f * benchmarkNoise();
+        }
+    }
+}
+
+const benchmarkTrace_t *benchmarkTrace(void)
+{
+    return &trace;
+}
+
+uint64_t benchmarkNowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static const benchmarkBaseline_t *benchmarkFindBaseline(const char *name)
+{
+    for (int i = 0; i < baselineCount; i++) {
+        if (strcmp(baselines[i].name, name) == 0) {
+            return &baselines[i];
+        }
+    }
+    return NULL;
+}
+
+void benchmarkReport(const char *name, double nsPerCall)
+{
+    const benchmarkBaseline_t *baseline = benchmarkFindBaseline(name);
+    if (baseline) {
+        const double changePercent = (nsPerCall - baseline->nsPerCall) * 100 / baseline->nsPerCall;
+        const bool regressed = changePercent > tolerancePercent;
+        printf("%-40s %10.2f ns/call %+7.1f%%%s\n", name, nsPerCall, changePercent, regressed ? "  REGRESSION" : "");
+        if (regressed) {
+            regressionCount++;
+        }
+    } else {
+        printf("%-40s %10.2f ns/call\n", name, nsPerCall);
+    }
+
+    if (saveFile) {
+        fprintf(saveFile, "%s %.2f\n", name, nsPerCall);
+    }
+}
+
+static void benchmarkLoadBaseline(const char *fileName)
+{
+    FILE *file = fopen(fileName, "r");
+    if (!file) {
+        // no baseline yet, the results are only printed
+        return;
+    }
+    char line[128];
+    while (baselineCount < BENCHMARK_BASELINE_COUNT_MAX && fgets(line, sizeof(line), file)) {
+        benchmarkBaseline_t *baseline = &baselines[baselineCount];
+        if (sscanf(line, "%63s %lf", baseline->name, &baseline->nsPerCall) == 2 && baseline->nsPerCall > 0) {
+            baselineCount++;
+        }
+    }
+    fclose(file);
+}
+
+int main(int argc, char *argv[])
+{
+    for (int i = 1; i < argc - 1; i += 2) {
+        if (strcmp(argv[i], "--baseline") == 0) {
+            benchmarkLoadBaseline(argv[i + 1]);
+        } else if (strcmp(argv[i], "--save") == 0) {
+            saveFile = fopen(argv[i + 1], "a");
+        } else if (strcmp(argv[i], "--tolerance") == 0) {
+            tolerancePercent = atof(argv[i + 1]);
+        }
+    }
+
+    benchmarkTraceInit();
+    benchmarkMain();
+
+    if (saveFile) {
+        fclose(saveFile);
+    }
+    return regressionCount > 0 ? 1 : 0;
+}
@@ -0,0 +1,65 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+// samples in the input trace, one second of flight at 8kHz
+#define BENCHMARK_TRACE_LENGTH  8000
+#define BENCHMARK_TRACE_RATE_HZ 8000
+// the fastest of this many passes over the trace is reported, the others are disturbed by the host
+#define BENCHMARK_PASSES        25
+
+typedef struct benchmarkTrace_s {
+    float gyro[3][BENCHMARK_TRACE_LENGTH];      // deg/s
+    float setpoint[3][BENCHMARK_TRACE_LENGTH];  // deg/s
+    float throttle[BENCHMARK_TRACE_LENGTH];     // 0..1
+} benchmarkTrace_t;
+
+// a quad flying through stick inputs, with motor noise that follows the throttle
+const benchmarkTrace_t *benchmarkTrace(void);
+
+// written by the benchmarked code so that the compiler cannot discard it
+extern volatile float benchmarkSink;
+
+uint64_t benchmarkNowNs(void);
+void benchmarkReport(const char *name, double nsPerCall);
+
+// runs fn(i) for each sample of the trace, the body of each benchmark
+template <typename F> void benchmarkRun(const char *name, F fn)
+{
+    uint64_t fastestNs = UINT64_MAX;
+    for (int pass = 0; pass < BENCHMARK_PASSES; pass++) {
+        const uint64_t startNs = benchmarkNowNs();
+        for (int i = 0; i < BENCHMARK_TRACE_LENGTH; i++) {
+            fn(i);
+        }
+        const uint64_t elapsedNs = benchmarkNowNs() - startNs;
+        if (elapsedNs < fastestNs) {
+            fastestNs = elapsedNs;
+        }
+    }
+    benchmarkReport(name, (double)fastestNs / BENCHMARK_TRACE_LENGTH);
+}
+
+// implemented by each benchmark
+void benchmarkMain(void);
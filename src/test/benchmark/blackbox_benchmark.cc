@@ -0,0 +1,99 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "blackbox/blackbox.h"
+    #include "blackbox/blackbox_encoding.h"
+    #include "common/axis.h"
+
+    #include "drivers/serial.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    PG_REGISTER(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 0);
+    int32_t blackboxHeaderBudget;
+
+    void serialWrite(serialPort_t *, uint8_t) { }
+    bool isSerialTransmitBufferEmpty(const serialPort_t *) { return true; }
+
+    // frames are encoded into a ring instead of a device
+    static uint8_t writeBuffer[256];
+    static uint8_t writePos;
+
+    void blackboxWrite(uint8_t value) { writeBuffer[writePos++] = value; }
+    int blackboxWriteString(const char *s)
+    {
+        const int length = strlen(s);
+        for (int i = 0; i < length; i++) {
+            blackboxWrite(s[i]);
+        }
+        return length;
+    }
+}
+
+#include "benchmark.h"
+
+static int32_t delta(const float *samples, int i)
+{
+    return (int32_t)samples[i] - (int32_t)samples[i > 0 ? i - 1 : 0];
+}
+
+void benchmarkMain(void)
+{
+    const benchmarkTrace_t *trace = benchmarkTrace();
+
+    // gyro deltas between consecutive samples, as written in P frames
+    benchmarkRun("blackboxWriteSignedVBArray", [&](int i) {
+        int32_t values[XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            values[axis] = delta(trace->gyro[axis], i);
+        }
+        blackboxWriteSignedVBArray(values, XYZ_AXIS_COUNT);
+        benchmarkSink = writePos;
+    });
+
+    benchmarkRun("blackboxWriteTag8_8SVB", [&](int i) {
+        int32_t values[8];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            values[axis] = delta(trace->setpoint[axis], i);
+            values[axis + XYZ_AXIS_COUNT] = delta(trace->gyro[axis], i);
+        }
+        values[6] = (int32_t)(trace->throttle[i] * 1000) - (int32_t)(trace->throttle[i > 0 ? i - 1 : 0] * 1000);
+        values[7] = 0;
+        blackboxWriteTag8_8SVB(values, 8);
+        benchmarkSink = writePos;
+    });
+
+    benchmarkRun("blackboxWriteTag2_3S32", [&](int i) {
+        int32_t values[XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            values[axis] = delta(trace->setpoint[axis], i);
+        }
+        blackboxWriteTag2_3S32(values);
+        benchmarkSink = writePos;
+    });
+}
@@ -0,0 +1,68 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/filter.h"
+    #include "common/maths.h"
+}
+
+#include "benchmark.h"
+
+void benchmarkMain(void)
+{
+    const benchmarkTrace_t *trace = benchmarkTrace();
+    const uint32_t looptimeUs = 1000000 / BENCHMARK_TRACE_RATE_HZ;
+
+    biquadFilter_t biquad;
+    biquadFilterInitLPF(&biquad, 100, looptimeUs);
+    benchmarkRun("biquadFilterApply", [&](int i) {
+        benchmarkSink = biquadFilterApply(&biquad, trace->gyro[0][i]);
+    });
+
+    biquadFilterInitLPF(&biquad, 100, looptimeUs);
+    benchmarkRun("biquadFilterApplyDF1", [&](int i) {
+        benchmarkSink = biquadFilterApplyDF1(&biquad, trace->gyro[0][i]);
+    });
+
+    biquadFilter_t notch;
+    biquadFilterInit(&notch, 260, looptimeUs, filterGetNotchQ(260, 160), FILTER_NOTCH);
+    benchmarkRun("biquadFilterApply.notch", [&](int i) {
+        benchmarkSink = biquadFilterApply(&notch, trace->gyro[0][i]);
+    });
+
+    pt1Filter_t pt1;
+    pt1FilterInit(&pt1, pt1FilterGain(100, looptimeUs * 1e-6f));
+    benchmarkRun("pt1FilterApply", [&](int i) {
+        benchmarkSink = pt1FilterApply(&pt1, trace->gyro[0][i]);
+    });
+
+    benchmarkRun("sin_approx", [&](int i) {
+        benchmarkSink = sin_approx(DEGREES_TO_RADIANS(trace->gyro[0][i] * 0.1f));
+    });
+
+    benchmarkRun("atan2_approx", [&](int i) {
+        benchmarkSink = atan2_approx(trace->gyro[0][i], trace->gyro[1][i]);
+    });
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+    #include "common/axis.h"
+    #include "common/filter.h"
+
+    #include "config/feature.h"
+    #include "drivers/accgyro/accgyro.h"
+    #include "drivers/accgyro/accgyro_fake.h"
+    #include "io/beeper.h"
+    #include "pg/pg.h"
+    #include "scheduler/scheduler.h"
+    #include "sensors/acceleration.h"
+    #include "sensors/gyro.h"
+    #include "sensors/sensors.h"
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+
+    extern gyroDev_t * const gyroDevPtr;
+
+    static timeUs_t currentTimeUs;
+
+    uint32_t micros(void) { return currentTimeUs; }
+    void beeper(beeperMode_e) { }
+    uint8_t detectedSensors[] = { GYRO_NONE, ACC_NONE };
+    timeDelta_t getGyroUpdateRate(void) { return gyro.targetLooptime; }
+    void sensorsSet(uint32_t) { }
+    void schedulerResetTaskStatistics(cfTaskId_e) { }
+    int getArmingDisableFlags(void) { return 0; }
+    uint8_t armingFlags = 0;
+    void writeEEPROM(void) { }
+    bool feature(uint32_t mask) { return mask == FEATURE_DYNAMIC_FILTER; }
+
+    void gyroDataAnalyseBenchmarkInit(uint8_t analyser, uint32_t looptimeUs);
+    float gyroDataAnalyseBenchmarkUpdate(float x, float y, float z);
+}
+
+#include "benchmark.h"
+
+static void gyroDataAnalyseBenchmark(const char *name, uint8_t analyser)
+{
+    const benchmarkTrace_t *trace = benchmarkTrace();
+
+    gyroDataAnalyseBenchmarkInit(analyser, gyro.targetLooptime);
+    benchmarkRun(name, [&](int i) {
+        benchmarkSink = gyroDataAnalyseBenchmarkUpdate(trace->gyro[X][i], trace->gyro[Y][i], trace->gyro[Z][i]);
+    });
+}
+
+void benchmarkMain(void)
+{
+    const benchmarkTrace_t *trace = benchmarkTrace();
+    const timeDelta_t looptimeUs = 1000000 / BENCHMARK_TRACE_RATE_HZ;
+
+    pgResetAll();
+    gyroInit();
+
+    // the filters only run once the gyro is calibrated, calibrate on a still gyro
+    fakeGyroSet(gyroDevPtr, 0, 0, 0);
+    while (!isGyroCalibrationComplete()) {
+        currentTimeUs += looptimeUs;
+        gyroUpdate(currentTimeUs);
+    }
+
+    benchmarkRun("gyroUpdate.filterGyro", [&](int i) {
+        fakeGyroSet(gyroDevPtr,
+            lrintf(trace->gyro[X][i] / gyroDevPtr->scale),
+            lrintf(trace->gyro[Y][i] / gyroDevPtr->scale),
+            lrintf(trace->gyro[Z][i] / gyroDevPtr->scale));
+        currentTimeUs += looptimeUs;
+        gyroUpdate(currentTimeUs);
+        benchmarkSink = gyro.gyroADCf[X];
+    });
+
+    gyroDataAnalyseBenchmark("gyroDataAnalyse.fft", DYN_NOTCH_ANALYSER_FFT);
+    gyroDataAnalyseBenchmark("gyroDataAnalyse.sdft", DYN_NOTCH_ANALYSER_SDFT);
+}
@@ -0,0 +1,68 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// arm_math.h does not build as C++ on 64 bit hosts, the analyser is driven from C
+
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/axis.h"
+#include "common/filter.h"
+#include "common/utils.h"
+
+#include "sensors/gyro.h"
+#include "sensors/gyroanalyse.h"
+
+static gyroAnalyseState_t state;
+static biquadFilterBank3_t notchFilterDyn[DYN_NOTCH_COUNT_MAX];
+
+void gyroDataAnalyseBenchmarkInit(uint8_t analyser, uint32_t looptimeUs)
+{
+    gyroConfigMutable()->dyn_notch_analyser = analyser;
+    gyroDataAnalyseStateInit(&state, looptimeUs);
+    for (int n = 0; n < DYN_NOTCH_COUNT_MAX; n++) {
+        biquadFilterBank3Init(&notchFilterDyn[n], 200, looptimeUs, filterGetNotchQ(200, 150), FILTER_NOTCH);
+    }
+}
+
+float gyroDataAnalyseBenchmarkUpdate(float x, float y, float z)
+{
+    gyroDataAnalysePush(&state, X, x);
+    gyroDataAnalysePush(&state, Y, y);
+    gyroDataAnalysePush(&state, Z, z);
+    gyroDataAnalyse(&state, notchFilterDyn);
+    return state.centerFreq[X][0];
+}
+
+// host version of the Cortex-M assembly in arm_bitreversal2.S
+void arm_bitreversal_32(uint32_t *pSrc, const uint16_t bitRevLen, const uint16_t *pBitRevTable)
+{
+    for (int i = 0; i < bitRevLen; i += 2) {
+        const uint32_t a = pBitRevTable[i] >> 2;
+        const uint32_t b = pBitRevTable[i + 1] >> 2;
+        uint32_t tmp = pSrc[a];
+        pSrc[a] = pSrc[b];
+        pSrc[b] = tmp;
+        tmp = pSrc[a + 1];
+        pSrc[a + 1] = pSrc[b + 1];
+        pSrc[b + 1] = tmp;
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+    #include "common/axis.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "drivers/pwm_output.h"
+    #include "drivers/time.h"
+    #include "drivers/timer.h"
+
+    #include "fc/config.h"
+    #include "fc/controlrate_profile.h"
+    #include "fc/fc_core.h"
+    #include "fc/fc_rc.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/failsafe.h"
+    #include "flight/mixer.h"
+    #include "flight/mixer_tricopter.h"
+    #include "flight/pid.h"
+
+    #include "io/beeper.h"
+
+    #include "rx/rx.h"
+
+    #include "sensors/battery.h"
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+
+    PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
+
+    pidAxisData_t pidData[3];
+    float rcCommand[4];
+    int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+
+    static pidProfile_t pidProfile;
+    pidProfile_t *currentPidProfile = &pidProfile;
+    static controlRateConfig_t controlRateProfile;
+    controlRateConfig_t *currentControlRateProfile = &controlRateProfile;
+
+    bool feature(uint32_t) { return false; }
+    bool isAirmodeActive(void) { return true; }
+    bool isFlipOverAfterCrashMode(void) { return false; }
+    bool isMotorsReversed(void) { return false; }
+    bool failsafeIsActive(void) { return false; }
+    float getRcDeflection(int) { return 0; }
+    float getRcDeflectionAbs(int) { return 0; }
+    float calculateVbatPidCompensation(void) { return 1.0f; }
+    void pidResetITerm(void) { }
+    void pidUpdateAntiGravityThrottleFilter(float) { }
+    void beeperConfirmationBeeps(uint8_t) { }
+    void delay(timeMs_t) { }
+    void delayMicroseconds(timeUs_t) { }
+    bool isMotorProtocolDshot(void) { return false; }
+    bool pwmAreMotorsEnabled(void) { return true; }
+    void pwmWriteMotor(uint8_t, float) { }
+    void pwmShutdownPulsesForAllMotors(uint8_t) { }
+    void pwmCompleteMotorUpdate(uint8_t) { }
+    ioTag_t timerioTagGetByUsage(timerUsageFlag_e, uint8_t) { return 0; }
+    void parseRcChannels(const char *, rxConfig_t *) { }
+    void mixerTricopterInit(void) { }
+    bool mixerTricopterIsServoSaturated(float) { return false; }
+    float mixerTricopterMotorCorrection(int) { return 0; }
+}
+
+#include "benchmark.h"
+
+void benchmarkMain(void)
+{
+    const benchmarkTrace_t *trace = benchmarkTrace();
+
+    pgResetAll();
+    pidProfile.pidSumLimit = PIDSUM_LIMIT;
+    pidProfile.pidSumLimitYaw = PIDSUM_LIMIT_YAW;
+    mixerInit(MIXER_QUADX);
+    mixerConfigureOutput();
+    ENABLE_ARMING_FLAG(ARMED);
+
+    timeUs_t currentTimeUs = 0;
+    benchmarkRun("mixTable", [&](int i) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            // the PID sum follows the error between the setpoint and the gyro
+            pidData[axis].Sum = (trace->setpoint[axis][i] - trace->gyro[axis][i]) * 0.5f;
+        }
+        rcCommand[THROTTLE] = 1000 + 1000 * trace->throttle[i];
+        currentTimeUs += 1000000 / BENCHMARK_TRACE_RATE_HZ;
+        mixTable(currentTimeUs, 0);
+        benchmarkSink = motor[0];
+    });
+}
@@ -0,0 +1,222 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+extern "C" {
+    #include "parser_benchmark.h"
+}
+
+#include "benchmark.h"
+
+// frames in each stream, at the frame rate of the protocols a few seconds of flight
+#define PARSER_STREAM_FRAMES        2000
+// one frame in this many is damaged in the corrupted stream
+#define PARSER_CORRUPTION_INTERVAL  8
+
+typedef enum {
+    CORRUPTION_BIT_FLIP = 0,
+    CORRUPTION_BYTE_DROPPED,
+    CORRUPTION_BYTE_INSERTED,
+    CORRUPTION_TRUNCATED,
+    CORRUPTION_COUNT
+} corruption_e;
+
+typedef struct parserBurst_s {
+    std::vector<uint8_t> bytes;
+    uint32_t sequence;
+    bool corrupted;
+} parserBurst_t;
+
+typedef struct parserStreamResult_s {
+    int intactFrames;
+    int intactDecoded;
+    int wrongDecoded;           // frames accepted that are not the intact frame just received
+    int resyncCount;
+    int resyncFramesLostTotal;
+    int resyncFramesLostMax;
+    uint64_t resyncUsTotal;
+    uint64_t resyncUsMax;
+} parserStreamResult_t;
+
+// deterministic, so that every run sees the same corruption
+static uint32_t parserRandom(void)
+{
+    static uint32_t seed = 0x2545F491;
+    seed = seed * 1664525 + 1013904223;
+    return seed >> 8;
+}
+
+static std::vector<parserBurst_t> parserStream(parserId_e parser, bool corrupted)
+{
+    std::vector<parserBurst_t> stream(PARSER_STREAM_FRAMES);
+    for (int i = 0; i < PARSER_STREAM_FRAMES; i++) {
+        parserBurst_t *burst = &stream[i];
+        uint8_t frame[PARSER_FRAME_SIZE_MAX];
+        const int length = parserEncodeFrame(parser, frame, i);
+        burst->bytes.assign(frame, frame + length);
+        burst->sequence = i;
+        burst->corrupted = corrupted && i % PARSER_CORRUPTION_INTERVAL == PARSER_CORRUPTION_INTERVAL - 1;
+        if (!burst->corrupted) {
+            continue;
+        }
+
+        const int position = parserRandom() % length;
+        switch ((i / PARSER_CORRUPTION_INTERVAL) % CORRUPTION_COUNT) {
+        case CORRUPTION_BIT_FLIP:
+            burst->bytes[position] ^= 1 << (parserRandom() % 8);
+            break;
+        case CORRUPTION_BYTE_DROPPED:
+            burst->bytes.erase(burst->bytes.begin() + position);
+            break;
+        case CORRUPTION_BYTE_INSERTED:
+            burst->bytes.insert(burst->bytes.begin() + position, parserRandom() & 0xFF);
+            break;
+        case CORRUPTION_TRUNCATED:
+            burst->bytes.resize(position);
+            break;
+        }
+    }
+    return stream;
+}
+
+static void parserReceiveStream(const std::vector<parserBurst_t> &stream)
+{
+    uint32_t sequence;
+    for (const parserBurst_t &burst : stream) {
+        parserReceiveBurst(burst.bytes.data(), burst.bytes.size());
+        if (parserPollFrame(&sequence)) {
+            benchmarkSink = sequence;
+        }
+    }
+}
+
+// Receives the stream once, checking every decoded frame and how long the parser takes to recover from each corruption
+static parserStreamResult_t parserCheckStream(const std::vector<parserBurst_t> &stream)
+{
+    parserStreamResult_t result = {};
+    bool resyncing = false;
+    uint64_t corruptedAtUs = 0;
+    int framesLost = 0;
+
+    for (const parserBurst_t &burst : stream) {
+        parserReceiveBurst(burst.bytes.data(), burst.bytes.size());
+        uint32_t sequence;
+        const bool decoded = parserPollFrame(&sequence);
+        const bool intactDecoded = decoded && !burst.corrupted && sequence == burst.sequence;
+
+        if (!burst.corrupted) {
+            result.intactFrames++;
+        }
+        if (intactDecoded) {
+            result.intactDecoded++;
+        } else if (decoded) {
+            result.wrongDecoded++;
+        }
+
+        if (burst.corrupted) {
+            if (!resyncing) {
+                // the frame ended at the start of the idle gap
+                resyncing = true;
+                corruptedAtUs = parserTimeUs();
+                framesLost = 0;
+            }
+        } else if (resyncing) {
+            if (intactDecoded) {
+                const uint64_t resyncUs = parserTimeUs() - corruptedAtUs;
+                result.resyncCount++;
+                result.resyncUsTotal += resyncUs;
+                result.resyncUsMax = std::max(result.resyncUsMax, resyncUs);
+                result.resyncFramesLostTotal += framesLost;
+                result.resyncFramesLostMax = std::max(result.resyncFramesLostMax, framesLost);
+                resyncing = false;
+            } else {
+                framesLost++;
+            }
+        }
+    }
+    return result;
+}
+
+// the fastest pass over the stream, in ns per byte
+static double parserBenchmarkStream(const std::vector<parserBurst_t> &stream)
+{
+    size_t byteCount = 0;
+    for (const parserBurst_t &burst : stream) {
+        byteCount += burst.bytes.size();
+    }
+
+    uint64_t fastestNs = UINT64_MAX;
+    for (int pass = 0; pass < BENCHMARK_PASSES; pass++) {
+        const uint64_t startNs = benchmarkNowNs();
+        parserReceiveStream(stream);
+        const uint64_t elapsedNs = benchmarkNowNs() - startNs;
+        if (elapsedNs < fastestNs) {
+            fastestNs = elapsedNs;
+        }
+    }
+    return (double)fastestNs / byteCount;
+}
+
+static void parserBenchmark(parserId_e parser)
+{
+    char name[64];
+
+    parserInit(parser);
+
+    const std::vector<parserBurst_t> clean = parserStream(parser, false);
+    const parserStreamResult_t cleanResult = parserCheckStream(clean);
+    if (cleanResult.intactDecoded != cleanResult.intactFrames || cleanResult.wrongDecoded) {
+        // nothing else can be trusted if a clean stream does not decode
+        printf("%s: %d of %d frames of the clean stream decoded, %d wrong\n",
+            parserName(parser), cleanResult.intactDecoded, cleanResult.intactFrames, cleanResult.wrongDecoded);
+        exit(1);
+    }
+
+    const std::vector<parserBurst_t> corrupted = parserStream(parser, true);
+    const parserStreamResult_t result = parserCheckStream(corrupted);
+
+    snprintf(name, sizeof(name), "%s.receiveByte", parserName(parser));
+    const double cleanNsPerByte = parserBenchmarkStream(clean);
+    benchmarkReport(name, cleanNsPerByte);
+    snprintf(name, sizeof(name), "%s.receiveByteCorrupted", parserName(parser));
+    benchmarkReport(name, parserBenchmarkStream(corrupted));
+
+    const int resyncCount = std::max(result.resyncCount, 1);
+    printf("    %.1f MB/s, %d of %d intact frames decoded, %d damaged frames accepted,"
+        " resync after %.2f frames (max %d) %.1f ms (max %.1f ms)\n",
+        1000 / cleanNsPerByte, result.intactDecoded, result.intactFrames, result.wrongDecoded,
+        (double)result.resyncFramesLostTotal / resyncCount, result.resyncFramesLostMax,
+        (double)result.resyncUsTotal / resyncCount / 1000, (double)result.resyncUsMax / 1000);
+}
+
+void benchmarkMain(void)
+{
+    for (int parser = 0; parser < PARSER_COUNT; parser++) {
+        parserBenchmark((parserId_e)parser);
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * The serial RX protocol parsers driven on the host, for the parser benchmark and fuzz target.
+ *
+ * Bytes are received at the baud rate of the protocol, as bursts separated by the idle gap the protocol
+ * uses to find the start of a frame. The RC frames encoded here carry a sequence number in their first
+ * two channels, so that a decoded frame can be matched with the one that was sent.
+ */
+
+#define PARSER_FRAME_SIZE_MAX   64
+
+typedef enum {
+    PARSER_CRSF = 0,
+    PARSER_SBUS,
+    PARSER_IBUS,
+    PARSER_SUMD,
+    PARSER_COUNT
+} parserId_e;
+
+const char *parserName(parserId_e parser);
+parserId_e parserFindByName(const char *name);
+
+void parserInit(parserId_e parser);
+int parserEncodeFrame(parserId_e parser, uint8_t *frame, uint32_t sequence);
+void parserReceiveBurst(const uint8_t *data, int length);
+bool parserPollFrame(uint32_t *sequence);
+uint64_t parserTimeUs(void);
@@ -0,0 +1,346 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The parsers and the firmware they call back into, shared by the parser benchmark and the fuzz target
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "build/debug.h"
+
+#include "common/crc.h"
+#include "common/utils.h"
+
+#include "drivers/serial.h"
+#include "drivers/time.h"
+
+#include "interface/crsf_protocol.h"
+
+#include "io/serial.h"
+
+#include "pg/rx.h"
+
+#include "rx/rx.h"
+#include "rx/crsf.h"
+#include "rx/ibus.h"
+#include "rx/sbus.h"
+#include "rx/sbus_channels.h"
+#include "rx/sumd.h"
+
+#include "scheduler/scheduler.h"
+
+#include "telemetry/ibus_shared.h"
+#include "telemetry/telemetry.h"
+
+#include "parser_benchmark.h"
+
+// the sequence number is split over the first two channels, added to the lowest value of the channel
+#define PARSER_SEQUENCE_BITS    10
+#define PARSER_SEQUENCE_MASK    ((1 << PARSER_SEQUENCE_BITS) - 1)
+
+#define PARSER_SBUS_CHANNEL_MIN 172
+#define PARSER_IBUS_CHANNEL_MIN 1000
+#define PARSER_SUMD_CHANNEL_MIN 900
+#define PARSER_CHANNEL_MID      992
+
+#define IBUS_CHANNEL_COUNT      14
+#define SUMD_CHANNEL_COUNT      16
+
+typedef struct parserProtocol_s {
+    const char *name;
+    bool (*init)(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig);
+    int (*encodeFrame)(uint8_t *frame, uint32_t sequence);
+    uint16_t (*readChannel)(uint8_t channel);
+    uint16_t channelMin;
+    uint32_t byteTimeNs;    // start, data, parity and stop bits at the baud rate
+    uint32_t idleGapUs;     // between the end of a frame and the start of the next
+} parserProtocol_t;
+
+uint8_t debugMode;
+int16_t debug[DEBUG16_VALUE_COUNT];
+rssiSource_e rssiSource;
+serialPort_t *telemetrySharedPort;
+extern uint16_t crsfChannelData[];
+
+static const parserProtocol_t *protocol;
+static rxConfig_t parserRxConfig;
+static rxRuntimeConfig_t parserRxRuntimeConfig;
+static serialPort_t serialPort;
+static serialReceiveCallbackPtr receiveCallback;
+static void *receiveCallbackData;
+static uint64_t timeNs;
+
+uint32_t micros(void)
+{
+    return timeNs / 1000;
+}
+
+uint32_t millis(void)
+{
+    return timeNs / 1000000;
+}
+
+serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function)
+{
+    static serialPortConfig_t portConfig = { .identifier = SERIAL_PORT_USART1 };
+
+    UNUSED(function);
+    return &portConfig;
+}
+
+serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFunction_e function, serialReceiveCallbackPtr callback,
+    void *callbackData, uint32_t baudrate, portMode_e mode, portOptions_e options)
+{
+    UNUSED(identifier);
+    UNUSED(function);
+    UNUSED(baudrate);
+    UNUSED(mode);
+    UNUSED(options);
+
+    receiveCallback = callback;
+    receiveCallbackData = callbackData;
+    return &serialPort;
+}
+
+bool isSerialPortShared(const serialPortConfig_t *portConfig, uint16_t functionMask, serialPortFunction_e sharedWithFunction)
+{
+    UNUSED(portConfig);
+    UNUSED(functionMask);
+    UNUSED(sharedWithFunction);
+    return false;
+}
+
+bool telemetryCheckRxPortShared(const serialPortConfig_t *portConfig)
+{
+    UNUSED(portConfig);
+    return false;
+}
+
+void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+{
+    UNUSED(instance);
+    UNUSED(data);
+    UNUSED(count);
+}
+
+// the rest of ibus_shared.c is the iBUS telemetry, which needs most of the firmware
+bool isChecksumOkIa6b(const uint8_t *ibusPacket, const uint8_t length)
+{
+    uint16_t checksum = 0xFFFF;
+    for (int i = 0; i < ibusPacket[0] - 2; i++) {
+        checksum -= ibusPacket[i];
+    }
+    return (checksum >> 8) == ibusPacket[length - 1] && (checksum & 0xFF) == ibusPacket[length - 2];
+}
+
+uint8_t respondToIbusRequest(uint8_t const * const ibusPacket)
+{
+    UNUSED(ibusPacket);
+    return 0;
+}
+
+void initSharedIbusTelemetry(serialPort_t *port)
+{
+    UNUSED(port);
+}
+
+void schedulerSignalTask(cfTaskId_e taskId)
+{
+    UNUSED(taskId);
+}
+
+// the channels of an RC frame, packed as SBUS and the CRSF RC channels payload do
+static void parserPackChannels(uint8_t *packed, const uint16_t *channels)
+{
+    memset(packed, 0, SBUS_PACKED_CHANNELS_LENGTH);
+    for (int i = 0; i < SBUS_PACKED_CHANNEL_COUNT * 11; i++) {
+        if (channels[i / 11] & (1 << (i % 11))) {
+            packed[i / 8] |= 1 << (i % 8);
+        }
+    }
+}
+
+static void parserSequenceChannels(uint16_t *channels, int count, uint16_t channelMin, uint16_t channelMid, uint32_t sequence)
+{
+    for (int i = 0; i < count; i++) {
+        channels[i] = channelMid;
+    }
+    channels[0] = channelMin + (sequence & PARSER_SEQUENCE_MASK);
+    channels[1] = channelMin + ((sequence >> PARSER_SEQUENCE_BITS) & PARSER_SEQUENCE_MASK);
+}
+
+static int crsfEncodeFrame(uint8_t *frame, uint32_t sequence)
+{
+    uint16_t channels[SBUS_PACKED_CHANNEL_COUNT];
+    parserSequenceChannels(channels, SBUS_PACKED_CHANNEL_COUNT, PARSER_SBUS_CHANNEL_MIN, PARSER_CHANNEL_MID, sequence);
+
+    frame[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    frame[1] = CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC;
+    frame[2] = CRSF_FRAMETYPE_RC_CHANNELS_PACKED;
+    parserPackChannels(&frame[3], channels);
+    frame[3 + CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE] = crc8_dvb_s2_update(0, &frame[2], CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + 1);
+    return CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + 4;
+}
+
+static uint16_t crsfReadChannel(uint8_t channel)
+{
+    return crsfChannelData[channel];
+}
+
+static int sbusEncodeFrame(uint8_t *frame, uint32_t sequence)
+{
+    uint16_t channels[SBUS_PACKED_CHANNEL_COUNT];
+    parserSequenceChannels(channels, SBUS_PACKED_CHANNEL_COUNT, PARSER_SBUS_CHANNEL_MIN, PARSER_CHANNEL_MID, sequence);
+
+    frame[0] = 0x0F;
+    parserPackChannels(&frame[1], channels);
+    frame[1 + SBUS_PACKED_CHANNELS_LENGTH] = 0;     // flags
+    frame[2 + SBUS_PACKED_CHANNELS_LENGTH] = 0;     // end byte
+    return SBUS_PACKED_CHANNELS_LENGTH + 3;
+}
+
+static uint16_t sbusReadChannel(uint8_t channel)
+{
+    return parserRxRuntimeConfig.channelData[channel];
+}
+
+// the IA6B frame, the length, the command and the channels, followed by the checksum
+static int ibusEncodeFrame(uint8_t *frame, uint32_t sequence)
+{
+    uint16_t channels[IBUS_CHANNEL_COUNT];
+    parserSequenceChannels(channels, IBUS_CHANNEL_COUNT, PARSER_IBUS_CHANNEL_MIN, 1500, sequence);
+
+    const int length = 2 + IBUS_CHANNEL_COUNT * 2 + 2;
+    frame[0] = length;
+    frame[1] = 0x40;
+    for (int i = 0; i < IBUS_CHANNEL_COUNT; i++) {
+        frame[2 + i * 2] = channels[i] & 0xFF;
+        frame[3 + i * 2] = channels[i] >> 8;
+    }
+    uint16_t checksum = 0xFFFF;
+    for (int i = 0; i < length - 2; i++) {
+        checksum -= frame[i];
+    }
+    frame[length - 2] = checksum & 0xFF;
+    frame[length - 1] = checksum >> 8;
+    return length;
+}
+
+static uint16_t rcReadChannel(uint8_t channel)
+{
+    return parserRxRuntimeConfig.rcReadRawFn(&parserRxRuntimeConfig, channel);
+}
+
+// the channels are sent in 1/8 us
+static int sumdEncodeFrame(uint8_t *frame, uint32_t sequence)
+{
+    uint16_t channels[SUMD_CHANNEL_COUNT];
+    parserSequenceChannels(channels, SUMD_CHANNEL_COUNT, PARSER_SUMD_CHANNEL_MIN, 1500, sequence);
+
+    const int length = 3 + SUMD_CHANNEL_COUNT * 2;
+    frame[0] = 0xA8;
+    frame[1] = 0x01;
+    frame[2] = SUMD_CHANNEL_COUNT;
+    for (int i = 0; i < SUMD_CHANNEL_COUNT; i++) {
+        frame[3 + i * 2] = (channels[i] * 8) >> 8;
+        frame[4 + i * 2] = (channels[i] * 8) & 0xFF;
+    }
+    uint16_t crc = 0;
+    for (int i = 0; i < length; i++) {
+        crc = crc16_ccitt(crc, frame[i]);
+    }
+    frame[length] = crc >> 8;
+    frame[length + 1] = crc & 0xFF;
+    return length + 2;
+}
+
+static const parserProtocol_t parserProtocols[PARSER_COUNT] = {
+    [PARSER_CRSF] = { "crsf", crsfRxInit, crsfEncodeFrame, crsfReadChannel, PARSER_SBUS_CHANNEL_MIN, 10 * 1000000000ULL / 420000, 6000 },
+    [PARSER_SBUS] = { "sbus", sbusInit, sbusEncodeFrame, sbusReadChannel, PARSER_SBUS_CHANNEL_MIN, 12 * 1000000000ULL / 100000, 6000 },
+    [PARSER_IBUS] = { "ibus", ibusInit, ibusEncodeFrame, rcReadChannel, PARSER_IBUS_CHANNEL_MIN, 10 * 1000000000ULL / 115200, 4200 },
+    [PARSER_SUMD] = { "sumd", sumdInit, sumdEncodeFrame, rcReadChannel, PARSER_SUMD_CHANNEL_MIN, 10 * 1000000000ULL / 115200, 6800 },
+};
+
+const char *parserName(parserId_e parser)
+{
+    return parserProtocols[parser].name;
+}
+
+// Returns PARSER_COUNT if there is no parser of that name
+parserId_e parserFindByName(const char *name)
+{
+    parserId_e parser = 0;
+    while (parser < PARSER_COUNT && strcmp(parserProtocols[parser].name, name) != 0) {
+        parser++;
+    }
+    return parser;
+}
+
+// Starts receiving a protocol, after an idle line that ends any frame left incomplete by the last one
+void parserInit(parserId_e parser)
+{
+    protocol = &parserProtocols[parser];
+
+    memset(&parserRxConfig, 0, sizeof(parserRxConfig));
+    parserRxConfig.midrc = 1500;
+    memset(&parserRxRuntimeConfig, 0, sizeof(parserRxRuntimeConfig));
+    protocol->init(&parserRxConfig, &parserRxRuntimeConfig);
+
+    timeNs += 100 * 1000000ULL;
+}
+
+// Encodes an RC frame carrying the sequence number, returns its length
+int parserEncodeFrame(parserId_e parser, uint8_t *frame, uint32_t sequence)
+{
+    return parserProtocols[parser].encodeFrame(frame, sequence);
+}
+
+// Receives the bytes back to back, followed by the idle gap of the protocol
+void parserReceiveBurst(const uint8_t *data, int length)
+{
+    for (int i = 0; i < length; i++) {
+        // the receive interrupt runs once the stop bits are in
+        timeNs += protocol->byteTimeNs;
+        receiveCallback(data[i], receiveCallbackData);
+    }
+    timeNs += protocol->idleGapUs * 1000ULL;
+}
+
+// Polls the parser as the RX task does, returns true and the sequence number if an RC frame completed
+bool parserPollFrame(uint32_t *sequence)
+{
+    const uint8_t frameStatus = parserRxRuntimeConfig.rcFrameStatusFn(&parserRxRuntimeConfig);
+    if (!(frameStatus & RX_FRAME_COMPLETE)) {
+        return false;
+    }
+
+    const uint16_t low = protocol->readChannel(0) - protocol->channelMin;
+    const uint16_t high = protocol->readChannel(1) - protocol->channelMin;
+    *sequence = ((uint32_t)(high & PARSER_SEQUENCE_MASK) << PARSER_SEQUENCE_BITS) | (low & PARSER_SEQUENCE_MASK);
+    return true;
+}
+
+uint64_t parserTimeUs(void)
+{
+    return timeNs / 1000;
+}
@@ -0,0 +1,99 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "pg/pg.h"
+
+    #include "fc/runtime_config.h"
+
+    #include "flight/imu.h"
+    #include "flight/pid.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/gyro.h"
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+
+    gyro_t gyro;
+    attitudeEulerAngles_t attitude;
+}
+
+#include "benchmark.h"
+
+static const benchmarkTrace_t *trace;
+static int sampleIndex;
+
+extern "C" {
+    const attitudeEulerAngles_t *getAttitude(void) { return &attitude; }
+    float getThrottlePIDAttenuation(void) { return 1.0f; }
+    float getMotorMixRange(void) { return 0.5f; }
+    float getSetpointRate(int axis) { return trace->setpoint[axis][sampleIndex]; }
+    bool mixerIsOutputSaturated(int, float) { return false; }
+    float getRcDeflection(int axis) { return trace->setpoint[axis][sampleIndex] / 1000.0f; }
+    float getRcDeflectionAbs(int axis) { return ABS(getRcDeflection(axis)); }
+    void systemBeep(bool) { }
+    bool gyroOverflowDetected(void) { return false; }
+    void beeperConfirmationBeeps(uint8_t) { }
+}
+
+static void pidBenchmark(const char *name, pidProfile_t *pidProfile)
+{
+    const rollAndPitchTrims_t trims = { { 0, 0 } };
+    timeUs_t currentTimeUs = 0;
+
+    pidInit(pidProfile);
+    benchmarkRun(name, [&](int i) {
+        sampleIndex = i;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyro.gyroADCf[axis] = trace->gyro[axis][i];
+        }
+        currentTimeUs += targetPidLooptime;
+        pidController(pidProfile, &trims, currentTimeUs);
+        benchmarkSink = pidData[FD_ROLL].Sum;
+    });
+}
+
+void benchmarkMain(void)
+{
+    trace = benchmarkTrace();
+
+    pgResetAll();
+    gyro.targetLooptime = 1000000 / BENCHMARK_TRACE_RATE_HZ;
+    pidProfile_t *pidProfile = pidProfilesMutable(0);
+
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+
+    pidBenchmark("pidController.acro", pidProfile);
+
+    ENABLE_FLIGHT_MODE(ANGLE_MODE);
+    pidBenchmark("pidController.angle", pidProfile);
+    DISABLE_FLIGHT_MODE(ANGLE_MODE);
+}
@@ -0,0 +1,176 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Fuzz target of the serial RX protocol parsers, and the replay of captured streams through them.
+ *
+ * An input is a byte selecting the parser, followed by bursts of received bytes. A burst is a length byte and
+ * that many bytes, received back to back at the baud rate of the protocol and followed by its idle gap.
+ *
+ * Built with libFuzzer by the fuzz goal of src/test/Makefile:
+ *
+ *   parser_fuzz [libFuzzer options] [CORPUS_DIR...]
+ *
+ * Built without, by the parser_replay goal, it replays captured streams in the same format, reporting the
+ * throughput of the parser, the frames decoded and the longest stretch of the stream without a frame:
+ *
+ *   parser_replay [--parser NAME] STREAM...
+ *
+ * With --parser the streams are of that protocol and start with their first burst.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "parser_benchmark.h"
+
+typedef struct parserReplayResult_s {
+    size_t byteCount;
+    int burstCount;
+    int frameCount;
+    int burstsWithoutFrameMax;
+    uint64_t timeWithoutFrameMaxUs;
+} parserReplayResult_t;
+
+static void parserReplay(parserId_e parser, const uint8_t *data, size_t size, parserReplayResult_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    parserInit(parser);
+
+    int burstsWithoutFrame = 0;
+    uint64_t lastFrameAtUs = parserTimeUs();
+    size_t offset = 0;
+    while (offset < size) {
+        // a burst cut short by the end of the input is still received
+        const size_t available = size - offset - 1;
+        const int length = data[offset] < available ? data[offset] : (int)available;
+        parserReceiveBurst(&data[offset + 1], length);
+        offset += length + 1;
+        result->byteCount += length;
+        result->burstCount++;
+
+        uint32_t sequence;
+        if (parserPollFrame(&sequence)) {
+            result->frameCount++;
+            burstsWithoutFrame = 0;
+            lastFrameAtUs = parserTimeUs();
+        } else {
+            burstsWithoutFrame++;
+            if (burstsWithoutFrame > result->burstsWithoutFrameMax) {
+                result->burstsWithoutFrameMax = burstsWithoutFrame;
+                result->timeWithoutFrameMaxUs = parserTimeUs() - lastFrameAtUs;
+            }
+        }
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (size < 1) {
+        return 0;
+    }
+
+    parserReplayResult_t result;
+    parserReplay(data[0] % PARSER_COUNT, &data[1], size - 1, &result);
+    return 0;
+}
+
+#ifdef PARSER_REPLAY
+
+static uint8_t *parserReadFile(const char *fileName, size_t *size)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (!file) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t *data = malloc(*size ? *size : 1);
+    if (data && fread(data, 1, *size, file) != *size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+static uint64_t parserNowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+int main(int argc, char *argv[])
+{
+    parserId_e parser = PARSER_COUNT;
+    int status = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--parser") == 0 && i + 1 < argc) {
+            parser = parserFindByName(argv[++i]);
+            if (parser == PARSER_COUNT) {
+                fprintf(stderr, "Unknown parser %s\n", argv[i]);
+                return 1;
+            }
+            continue;
+        }
+
+        size_t size;
+        uint8_t *data = parserReadFile(argv[i], &size);
+        if (!data) {
+            fprintf(stderr, "Cannot read %s\n", argv[i]);
+            status = 1;
+            continue;
+        }
+
+        // the parser is selected by the first byte as for the fuzz target, unless given
+        const bool selectByte = parser == PARSER_COUNT;
+        if (selectByte && size < 1) {
+            free(data);
+            continue;
+        }
+        const parserId_e streamParser = selectByte ? data[0] % PARSER_COUNT : parser;
+        const uint8_t *stream = selectByte ? &data[1] : data;
+        const size_t streamSize = selectByte ? size - 1 : size;
+
+        parserReplayResult_t result;
+        const uint64_t startNs = parserNowNs();
+        parserReplay(streamParser, stream, streamSize, &result);
+        const uint64_t elapsedNs = parserNowNs() - startNs;
+
+        printf("%s: %s, %zu bytes in %d bursts, %.2f ns/byte, %d frames decoded,"
+            " longest without a frame %d bursts %.1f ms\n",
+            argv[i], parserName(streamParser), result.byteCount, result.burstCount,
+            result.byteCount ? (double)elapsedNs / result.byteCount : 0, result.frameCount,
+            result.burstsWithoutFrameMax, result.timeWithoutFrameMaxUs / 1000.0);
+        free(data);
+    }
+
+    return status;
+}
+
+#endif
@@ -0,0 +1,429 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Replays a flight log through the firmware gyro filtering, PID controller and mixer on the host.
+ *
+ * The log is read as the CSV written by blackbox_decode. The unfiltered gyro comes from the debug[0..2]
+ * fields of a log recorded with debug_mode = GYRO_SCALED, the setpoint from setpoint[0..2] and the
+ * throttle from rcCommand[3]. The pipeline runs at the rate of the log, so log with blackbox_p_ratio
+ * at the pid loop rate.
+ *
+ *   replay [--gyro-field NAME] [--output FILE] LOG.csv
+ *
+ * Writes the raw and filtered gyro, D term, PID sum and motor outputs of each sample as CSV, then prints
+ * the filter latency estimated by cross correlation and the CPU time of each stage.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "platform.h"
+
+#include "build/debug.h"
+#include "common/axis.h"
+#include "common/maths.h"
+
+#include "config/feature.h"
+#include "drivers/accgyro/accgyro.h"
+#include "drivers/accgyro/accgyro_fake.h"
+#include "drivers/pwm_output.h"
+#include "drivers/time.h"
+#include "drivers/timer.h"
+
+#include "fc/config.h"
+#include "fc/controlrate_profile.h"
+#include "fc/fc_core.h"
+#include "fc/fc_rc.h"
+#include "fc/rc_controls.h"
+#include "fc/rc_modes.h"
+#include "fc/runtime_config.h"
+
+#include "flight/failsafe.h"
+#include "flight/imu.h"
+#include "flight/mixer.h"
+#include "flight/mixer_tricopter.h"
+#include "flight/pid.h"
+
+#include "io/beeper.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#include "rx/rx.h"
+
+#include "scheduler/scheduler.h"
+
+#include "sensors/acceleration.h"
+#include "sensors/battery.h"
+#include "sensors/gyro.h"
+#include "sensors/sensors.h"
+
+// latency search window, in samples
+#define REPLAY_LATENCY_MAX_LAG 64
+
+typedef struct replaySample_s {
+    uint32_t timeUs;
+    float gyroRaw[XYZ_AXIS_COUNT];
+    float setpoint[XYZ_AXIS_COUNT];
+    float throttle;
+    float gyroFiltered[XYZ_AXIS_COUNT];
+} replaySample_t;
+
+typedef enum {
+    REPLAY_STAGE_GYRO = 0,
+    REPLAY_STAGE_PID,
+    REPLAY_STAGE_MIXER,
+    REPLAY_STAGE_COUNT
+} replayStage_e;
+
+static const char * const replayStageNames[REPLAY_STAGE_COUNT] = { "gyro", "pid", "mixer" };
+
+// firmware state and stubs of the parts that are not replayed
+
+uint8_t debugMode;
+int16_t debug[DEBUG16_VALUE_COUNT];
+
+PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
+
+float rcCommand[4];
+int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+attitudeEulerAngles_t attitude;
+uint8_t detectedSensors[] = { GYRO_NONE, ACC_NONE };
+
+static controlRateConfig_t controlRateProfile;
+controlRateConfig_t *currentControlRateProfile = &controlRateProfile;
+pidProfile_t *currentPidProfile;
+
+extern gyroDev_t * const gyroDevPtr;
+
+static const replaySample_t *currentSample;
+static timeUs_t currentTimeUs;
+
+uint32_t micros(void) { return currentTimeUs; }
+uint32_t millis(void) { return currentTimeUs / 1000; }
+void delay(timeMs_t ms) { UNUSED(ms); }
+void delayMicroseconds(timeUs_t us) { UNUSED(us); }
+bool feature(uint32_t mask) { return mask == FEATURE_DYNAMIC_FILTER; }
+void beeper(beeperMode_e mode) { UNUSED(mode); }
+void beeperConfirmationBeeps(uint8_t beepCount) { UNUSED(beepCount); }
+void systemBeep(bool on) { UNUSED(on); }
+void schedulerResetTaskStatistics(cfTaskId_e taskId) { UNUSED(taskId); }
+void writeEEPROM(void) { }
+const attitudeEulerAngles_t *getAttitude(void) { return &attitude; }
+float getSetpointRate(int axis) { return currentSample->setpoint[axis]; }
+float getRcDeflection(int axis) { return currentSample->setpoint[axis] / 1000.0f; }
+float getRcDeflectionAbs(int axis) { return fabsf(getRcDeflection(axis)); }
+float getThrottlePIDAttenuation(void) { return 1.0f; }
+float calculateVbatPidCompensation(void) { return 1.0f; }
+bool isAirmodeActive(void) { return true; }
+bool isFlipOverAfterCrashMode(void) { return false; }
+bool isMotorsReversed(void) { return false; }
+bool failsafeIsActive(void) { return false; }
+bool isMotorProtocolDshot(void) { return false; }
+bool pwmAreMotorsEnabled(void) { return true; }
+void pwmWriteMotor(uint8_t index, float value) { UNUSED(index); UNUSED(value); }
+void pwmShutdownPulsesForAllMotors(uint8_t motorCount) { UNUSED(motorCount); }
+void pwmCompleteMotorUpdate(uint8_t motorCount) { UNUSED(motorCount); }
+ioTag_t timerioTagGetByUsage(timerUsageFlag_e usageFlag, uint8_t index) { UNUSED(usageFlag); UNUSED(index); return 0; }
+void parseRcChannels(const char *input, rxConfig_t *rxConfig) { UNUSED(input); UNUSED(rxConfig); }
+void mixerTricopterInit(void) { }
+bool mixerTricopterIsServoSaturated(float errorRate) { UNUSED(errorRate); return false; }
+float mixerTricopterMotorCorrection(int motor) { UNUSED(motor); return 0; }
+
+// CSV parsing
+
+#define REPLAY_LINE_LENGTH_MAX 8192
+#define REPLAY_FIELD_COUNT_MAX 256
+
+static int splitCsvLine(char *line, char *fields[REPLAY_FIELD_COUNT_MAX])
+{
+    int count = 0;
+    char *field = line;
+    while (field && count < REPLAY_FIELD_COUNT_MAX) {
+        char *next = strchr(field, ',');
+        if (next) {
+            *next++ = '\0';
+        }
+        while (*field == ' ') {
+            field++;
+        }
+        field[strcspn(field, "\r\n")] = '\0';
+        fields[count++] = field;
+        field = next;
+    }
+    return count;
+}
+
+static int findField(char *fields[], int fieldCount, const char *name)
+{
+    for (int i = 0; i < fieldCount; i++) {
+        if (strcmp(fields[i], name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int findIndexedField(char *fields[], int fieldCount, const char *name, int index)
+{
+    char indexedName[64];
+    snprintf(indexedName, sizeof(indexedName), "%s[%d]", name, index);
+    return findField(fields, fieldCount, indexedName);
+}
+
+static replaySample_t *readLog(FILE *log, const char *gyroField, int *sampleCount)
+{
+    static char line[REPLAY_LINE_LENGTH_MAX];
+    char *fields[REPLAY_FIELD_COUNT_MAX];
+
+    if (!fgets(line, sizeof(line), log)) {
+        fprintf(stderr, "empty log\n");
+        return NULL;
+    }
+    const int headerCount = splitCsvLine(line, fields);
+    const int timeIndex = findField(fields, headerCount, "time (us)");
+    const int throttleIndex = findIndexedField(fields, headerCount, "rcCommand", THROTTLE);
+    int gyroIndex[XYZ_AXIS_COUNT];
+    int setpointIndex[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroIndex[axis] = findIndexedField(fields, headerCount, gyroField, axis);
+        setpointIndex[axis] = findIndexedField(fields, headerCount, "setpoint", axis);
+        if (gyroIndex[axis] < 0) {
+            fprintf(stderr, "log has no %s[%d] field\n", gyroField, axis);
+            return NULL;
+        }
+    }
+    if (timeIndex < 0) {
+        fprintf(stderr, "log has no time field\n");
+        return NULL;
+    }
+
+    int capacity = 4096;
+    replaySample_t *samples = malloc(capacity * sizeof(replaySample_t));
+    int count = 0;
+    while (fgets(line, sizeof(line), log)) {
+        const int fieldCount = splitCsvLine(line, fields);
+        if (fieldCount != headerCount) {
+            continue;
+        }
+        if (count == capacity) {
+            capacity *= 2;
+            samples = realloc(samples, capacity * sizeof(replaySample_t));
+        }
+        replaySample_t *sample = &samples[count++];
+        memset(sample, 0, sizeof(*sample));
+        sample->timeUs = strtoul(fields[timeIndex], NULL, 10);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            sample->gyroRaw[axis] = strtof(fields[gyroIndex[axis]], NULL);
+            sample->setpoint[axis] = setpointIndex[axis] < 0 ? 0 : strtof(fields[setpointIndex[axis]], NULL);
+        }
+        sample->throttle = throttleIndex < 0 ? PWM_RANGE_MIN : strtof(fields[throttleIndex], NULL);
+    }
+    *sampleCount = count;
+    return samples;
+}
+
+// the median sample interval, robust against the gaps of dropped frames
+static uint32_t logLooptime(const replaySample_t *samples, int sampleCount)
+{
+    const int count = MIN(sampleCount - 1, 1001);
+    uint32_t *deltas = malloc(count * sizeof(uint32_t));
+    for (int i = 0; i < count; i++) {
+        deltas[i] = samples[i + 1].timeUs - samples[i].timeUs;
+    }
+    for (int i = 1; i < count; i++) {
+        const uint32_t delta = deltas[i];
+        int j = i;
+        for (; j > 0 && deltas[j - 1] > delta; j--) {
+            deltas[j] = deltas[j - 1];
+        }
+        deltas[j] = delta;
+    }
+    const uint32_t looptime = deltas[count / 2];
+    free(deltas);
+    return looptime;
+}
+
+// Delay of the filtered gyro behind the raw gyro, in samples, from the peak of their cross correlation
+static float estimateLatency(const replaySample_t *samples, int sampleCount, int axis)
+{
+    float correlation[REPLAY_LATENCY_MAX_LAG + 1];
+    int bestLag = 0;
+    for (int lag = 0; lag <= REPLAY_LATENCY_MAX_LAG; lag++) {
+        double sum = 0;
+        for (int i = lag; i < sampleCount; i++) {
+            sum += (double)samples[i - lag].gyroRaw[axis] * samples[i].gyroFiltered[axis];
+        }
+        correlation[lag] = sum / (sampleCount - lag);
+        if (correlation[lag] > correlation[bestLag]) {
+            bestLag = lag;
+        }
+    }
+    if (bestLag == 0 || bestLag == REPLAY_LATENCY_MAX_LAG) {
+        return bestLag;
+    }
+    // parabolic interpolation of the peak
+    const float left = correlation[bestLag - 1];
+    const float centre = correlation[bestLag];
+    const float right = correlation[bestLag + 1];
+    const float denominator = left - 2 * centre + right;
+    return denominator == 0 ? bestLag : bestLag + 0.5f * (left - right) / denominator;
+}
+
+static uint64_t nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: replay [--gyro-field NAME] [--output FILE] LOG.csv\n");
+    exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *gyroField = "debug";
+    const char *outputName = NULL;
+    const char *logName = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--gyro-field") == 0 && i + 1 < argc) {
+            gyroField = argv[++i];
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputName = argv[++i];
+        } else if (argv[i][0] != '-' && !logName) {
+            logName = argv[i];
+        } else {
+            usage();
+        }
+    }
+    if (!logName) {
+        usage();
+    }
+
+    FILE *log = fopen(logName, "r");
+    if (!log) {
+        perror(logName);
+        return 1;
+    }
+    int sampleCount = 0;
+    replaySample_t *samples = readLog(log, gyroField, &sampleCount);
+    fclose(log);
+    if (!samples) {
+        return 1;
+    }
+    if (sampleCount < 2 * REPLAY_LATENCY_MAX_LAG) {
+        fprintf(stderr, "log is too short, %d samples\n", sampleCount);
+        return 1;
+    }
+    FILE *output = outputName ? fopen(outputName, "w") : stdout;
+    if (!output) {
+        perror(outputName);
+        return 1;
+    }
+
+    // run the gyro at the rate of the log, in steps of the 8kHz gyro sample period
+    const uint32_t looptimeUs = logLooptime(samples, sampleCount);
+    pgResetAll();
+    gyroConfigMutable()->gyro_sync_denom = constrain((looptimeUs + 62) / 125, 1, 32);
+    pidConfigMutable()->pid_process_denom = 1;
+    gyroInit();
+    if (gyro.targetLooptime != looptimeUs) {
+        fprintf(stderr, "log interval %uus, replaying at %uus\n", looptimeUs, gyro.targetLooptime);
+    }
+
+    currentPidProfile = pidProfilesMutable(0);
+    pidInit(currentPidProfile);
+    mixerInit(MIXER_QUADX);
+    mixerConfigureOutput();
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+
+    // the filters only run once the gyro is calibrated, calibrate on a still gyro
+    fakeGyroSet(gyroDevPtr, 0, 0, 0);
+    while (!isGyroCalibrationComplete()) {
+        currentTimeUs += gyro.targetLooptime;
+        gyroUpdate(currentTimeUs);
+    }
+
+    fprintf(output, "time (us),gyroRaw[0],gyroRaw[1],gyroRaw[2],gyroFiltered[0],gyroFiltered[1],gyroFiltered[2],"
+        "dterm[0],dterm[1],dterm[2],pidSum[0],pidSum[1],pidSum[2],motor[0],motor[1],motor[2],motor[3]\n");
+
+    const rollAndPitchTrims_t trims = { .values = { 0, 0 } };
+    uint64_t stageNs[REPLAY_STAGE_COUNT] = { 0 };
+    for (int i = 0; i < sampleCount; i++) {
+        replaySample_t *sample = &samples[i];
+        currentSample = sample;
+        currentTimeUs += gyro.targetLooptime;
+
+        fakeGyroSet(gyroDevPtr,
+            constrain(lrintf(sample->gyroRaw[X] / gyroDevPtr->scale), INT16_MIN, INT16_MAX),
+            constrain(lrintf(sample->gyroRaw[Y] / gyroDevPtr->scale), INT16_MIN, INT16_MAX),
+            constrain(lrintf(sample->gyroRaw[Z] / gyroDevPtr->scale), INT16_MIN, INT16_MAX));
+        uint64_t startNs = nowNs();
+        gyroUpdate(currentTimeUs);
+        uint64_t endNs = nowNs();
+        stageNs[REPLAY_STAGE_GYRO] += endNs - startNs;
+
+        startNs = endNs;
+        pidController(currentPidProfile, &trims, currentTimeUs);
+        endNs = nowNs();
+        stageNs[REPLAY_STAGE_PID] += endNs - startNs;
+
+        rcCommand[THROTTLE] = sample->throttle;
+        startNs = endNs;
+        mixTable(currentTimeUs, currentPidProfile->vbatPidCompensation);
+        endNs = nowNs();
+        stageNs[REPLAY_STAGE_MIXER] += endNs - startNs;
+
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            sample->gyroFiltered[axis] = gyro.gyroADCf[axis];
+        }
+        fprintf(output, "%u,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.1f,%.1f,%.1f,%.1f\n", sample->timeUs,
+            sample->gyroRaw[X], sample->gyroRaw[Y], sample->gyroRaw[Z],
+            gyro.gyroADCf[X], gyro.gyroADCf[Y], gyro.gyroADCf[Z],
+            pidData[FD_ROLL].D, pidData[FD_PITCH].D, pidData[FD_YAW].D,
+            pidData[FD_ROLL].Sum, pidData[FD_PITCH].Sum, pidData[FD_YAW].Sum,
+            motor[0], motor[1], motor[2], motor[3]);
+    }
+    if (output != stdout) {
+        fclose(output);
+    }
+
+    fprintf(stderr, "%d samples at %uus\n", sampleCount, gyro.targetLooptime);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float latency = estimateLatency(samples, sampleCount, axis);
+        fprintf(stderr, "latency[%d] %6.1fus\n", axis, latency * gyro.targetLooptime);
+    }
+    for (int stage = 0; stage < REPLAY_STAGE_COUNT; stage++) {
+        fprintf(stderr, "%-6s %8.1fns/sample\n", replayStageNames[stage], (double)stageNs[stage] / sampleCount);
+    }
+
+    free(samples);
+    return 0;
+}
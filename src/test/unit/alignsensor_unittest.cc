@@ -265,3 +265,45 @@ TEST(AlignSensorTest, ClockwiseTwoSeventyDegreesFlip)
 {
     testCWFlip(CW270_DEG_FLIP, 270);
 }
+
+static void testCombinedAlignment(bool expectMatrix)
+{
+    for (uint8_t rotation = CW0_DEG; rotation <= CW270_DEG_FLIP; rotation++) {
+        sensorAlignment_t alignment;
+        buildSensorAlignment(&alignment, rotation);
+        EXPECT_EQ(expectMatrix, alignment.useMatrix) << "Rotation " << (int)rotation;
+
+        float expected[3] = { 3.0f, -7.0f, 11.0f };
+        float combined[3] = { 3.0f, -7.0f, 11.0f };
+        alignSensors(expected, rotation);
+        applySensorAlignment(combined, &alignment);
+
+        for (int axis = 0; axis < 3; axis++) {
+            EXPECT_NEAR(expected[axis], combined[axis], 1e-4f) << "Rotation " << (int)rotation << " axis " << axis;
+        }
+    }
+}
+
+TEST(AlignSensorTest, CombinedAlignmentStandardBoard)
+{
+    const boardAlignment_t board = { 0, 0, 0 };
+    initBoardAlignment(&board);
+    testCombinedAlignment(false);
+}
+
+TEST(AlignSensorTest, CombinedAlignmentRightAngleBoard)
+{
+    const boardAlignment_t board = { 180, 0, 90 };
+    initBoardAlignment(&board);
+    testCombinedAlignment(false);
+}
+
+TEST(AlignSensorTest, CombinedAlignmentCustomBoard)
+{
+    const boardAlignment_t board = { 5, -10, 45 };
+    initBoardAlignment(&board);
+    testCombinedAlignment(true);
+
+    const boardAlignment_t standardBoard = { 0, 0, 0 };
+    initBoardAlignment(&standardBoard);
+}
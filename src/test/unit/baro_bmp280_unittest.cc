@@ -144,10 +144,15 @@ TEST(baroBmp280Test, TestBmp280CalculateZeroP)
 extern "C" {
 
 void delay(uint32_t) {}
+uint32_t millis(void) { return 0; }
 bool busReadRegisterBuffer(const busDevice_t*, uint8_t, uint8_t*, uint8_t) {return true;}
+bool busReadRegisterBufferStart(const busDevice_t*, uint8_t, uint8_t*, uint8_t) {return true;}
+bool busWriteRegisterStart(const busDevice_t*, uint8_t, uint8_t) {return true;}
+bool busBusy(const busDevice_t*, bool*) {return false;}
 bool busWriteRegister(const busDevice_t*, uint8_t, uint8_t) {return true;}
+bool busSubmitJob(const busDevice_t*, const busSegment_t*, busJobCallbackFn, uint32_t) {return false;}
 
-void spiSetDivisor() {
+void spiBusSetDivisor() {
 }
 
 void spiPreinitCsByIO() {
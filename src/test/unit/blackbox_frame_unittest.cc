@@ -0,0 +1,549 @@
+/*
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Round trip and throughput of the main frame encoders: a synthetic flight is encoded with writeIntraframe() and
+ * writeInterframe(), decoded back and compared, and the bytes and time per frame are reported.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <chrono>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "blackbox/blackbox.h"
+    #include "blackbox/blackbox_fielddefs.h"
+    #include "blackbox/blackbox_io.h"
+
+    #include "build/debug.h"
+
+    #include "common/utils.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/rx.h"
+
+    #include "drivers/accgyro/accgyro.h"
+    #include "drivers/accgyro/gyro_sync.h"
+    #include "drivers/serial.h"
+
+    #include "flight/failsafe.h"
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+
+    #include "fc/config.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+
+    #include "io/gps.h"
+    #include "io/serial.h"
+
+    #include "rx/rx.h"
+
+    #include "sensors/battery.h"
+    #include "sensors/gyro.h"
+    #include "sensors/sensors.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define FLIGHT_ITERATIONS 4096
+#define I_INTERVAL 32
+#define MIN_MOTOR 1000
+#define VBAT_REFERENCE 1680
+
+static std::vector<uint8_t> logData;
+
+// Decoder of the main frames, independent of the encoders but for the field list
+class MainFrameDecoder {
+public:
+    MainFrameDecoder(const uint8_t *data, size_t length) : data(data), length(length), position(0) {}
+
+    bool atEnd(void) const { return position >= length; }
+
+    uint8_t readByte(void)
+    {
+        return position < length ? data[position++] : 0;
+    }
+
+    uint32_t readUnsignedVB(void)
+    {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            const uint8_t byte = readByte();
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+        return value;
+    }
+
+    int32_t readSignedVB(void)
+    {
+        const uint32_t zigzag = readUnsignedVB();
+        return (int32_t)((zigzag >> 1) ^ -(int32_t)(zigzag & 1));
+    }
+
+    void readTag2_3S32(int32_t *values)
+    {
+        const uint8_t lead = readByte();
+        switch (lead >> 6) {
+        case 0:
+            for (int i = 0; i < 3; i++) {
+                values[i] = signExtend((lead >> (4 - 2 * i)) & 0x03, 2);
+            }
+            break;
+        case 1: {
+            values[0] = signExtend(lead & 0x0F, 4);
+            const uint8_t byte = readByte();
+            values[1] = signExtend(byte >> 4, 4);
+            values[2] = signExtend(byte & 0x0F, 4);
+            break;
+        }
+        case 2:
+            values[0] = signExtend(lead & 0x3F, 6);
+            values[1] = signExtend(readByte() & 0x3F, 6);
+            values[2] = signExtend(readByte() & 0x3F, 6);
+            break;
+        case 3:
+            for (int i = 0; i < 3; i++) {
+                const int bytes = ((lead >> (2 * i)) & 0x03) + 1;
+                uint32_t value = 0;
+                for (int b = 0; b < bytes; b++) {
+                    value |= (uint32_t)readByte() << (8 * b);
+                }
+                values[i] = signExtend(value, 8 * bytes);
+            }
+            break;
+        }
+    }
+
+    void readTag8_4S16(int32_t *values)
+    {
+        const uint8_t selector = readByte();
+        uint8_t buffer = 0;
+        bool nibble = false;   // the low nibble of buffer is still to be read
+
+        for (int i = 0; i < 4; i++) {
+            switch ((selector >> (2 * i)) & 0x03) {
+            case 0:
+                values[i] = 0;
+                break;
+            case 1:
+                if (!nibble) {
+                    buffer = readByte();
+                    values[i] = signExtend(buffer >> 4, 4);
+                    nibble = true;
+                } else {
+                    values[i] = signExtend(buffer & 0x0F, 4);
+                    nibble = false;
+                }
+                break;
+            case 2:
+                if (!nibble) {
+                    values[i] = signExtend(readByte(), 8);
+                } else {
+                    const uint8_t high = buffer & 0x0F;
+                    buffer = readByte();
+                    values[i] = signExtend((high << 4) | (buffer >> 4), 8);
+                }
+                break;
+            case 3:
+                if (!nibble) {
+                    const uint8_t high = readByte();
+                    values[i] = signExtend((high << 8) | readByte(), 16);
+                } else {
+                    const uint8_t high = buffer & 0x0F;
+                    const uint8_t middle = readByte();
+                    buffer = readByte();
+                    values[i] = signExtend((high << 12) | (middle << 4) | (buffer >> 4), 16);
+                }
+                break;
+            }
+        }
+    }
+
+    void readTag8_8SVB(int32_t *values, int count)
+    {
+        if (count == 1) {
+            values[0] = readSignedVB();
+            return;
+        }
+        const uint8_t header = readByte();
+        for (int i = 0; i < count; i++) {
+            values[i] = (header & (1 << i)) ? readSignedVB() : 0;
+        }
+    }
+
+private:
+    static int32_t signExtend(uint32_t value, int bits)
+    {
+        if (bits >= 32) {
+            return (int32_t)value;
+        }
+        const uint32_t sign = 1u << (bits - 1);
+        value &= (sign << 1) - 1;
+        return (int32_t)((value ^ sign) - sign);
+    }
+
+    const uint8_t *data;
+    size_t length;
+    size_t position;
+};
+
+typedef std::vector<int32_t> frameValues_t;
+
+// Values of one logged iteration of a synthetic flight
+static frameValues_t flightFrame(uint32_t iteration, bool highResolution)
+{
+    static uint32_t noiseSeed = 12345;
+    frameValues_t values(blackboxMainFieldCount());
+    const float t = iteration * 0.000125f;
+    const float scale = highResolution ? BLACKBOX_HIGH_RESOLUTION_SCALE : 1;
+
+    for (int i = 0; i < blackboxMainFieldCount(); i++) {
+        blackboxMainFieldEncoding_t encoding;
+        blackboxGetMainFieldEncoding(i, &encoding);
+
+        noiseSeed = noiseSeed * 1103515245 + 12345;
+        const int32_t noise = (int32_t)((noiseSeed >> 16) & 0x0F) - 8;
+        const float wave = sinf(t * (3 + i) * 2 * M_PIf + i);
+
+        if (encoding.iteration) {
+            values[i] = iteration;
+        } else if (encoding.Ppredict == FLIGHT_LOG_FIELD_PREDICTOR_STRAIGHT_LINE) {
+            values[i] = 1000 + iteration * 125 + noise / 4;
+        } else if (encoding.Ipredict == FLIGHT_LOG_FIELD_PREDICTOR_VBATREF) {
+            values[i] = VBAT_REFERENCE - 60 - iteration / 256 + noise / 8;
+        } else if (encoding.Ipredict != FLIGHT_LOG_FIELD_PREDICTOR_0 || encoding.Iencode != FLIGHT_LOG_FIELD_ENCODING_SIGNED_VB) {
+            // Motors, servos, throttle and the other unsigned fields
+            values[i] = lrintf(1400 + 300 * wave) + noise;
+        } else {
+            // Gyro, setpoint, PID terms and the like
+            values[i] = lrintf(scale * (250 * wave + noise));
+        }
+    }
+    return values;
+}
+
+static void encodeFrame(const frameValues_t &values, bool intraframe)
+{
+    for (int i = 0; i < blackboxMainFieldCount(); i++) {
+        blackboxSetMainFieldValue(i, values[i]);
+    }
+    blackboxFrameBegin();
+    if (intraframe) {
+        writeIntraframe(values[0]);
+    } else {
+        writeInterframe();
+    }
+    blackboxFrameEnd();
+}
+
+static int32_t intraframePrediction(const blackboxMainFieldEncoding_t &encoding, const frameValues_t &frame)
+{
+    switch (encoding.Ipredict) {
+    case FLIGHT_LOG_FIELD_PREDICTOR_MOTOR_0:
+        // The first motor comes first
+        for (int i = 0; i < blackboxMainFieldCount(); i++) {
+            blackboxMainFieldEncoding_t motor;
+            blackboxGetMainFieldEncoding(i, &motor);
+            if (motor.Ipredict == FLIGHT_LOG_FIELD_PREDICTOR_MINMOTOR) {
+                return frame[i];
+            }
+        }
+        return 0;
+    case FLIGHT_LOG_FIELD_PREDICTOR_MINTHROTTLE:
+        return motorConfig()->minthrottle;
+    case FLIGHT_LOG_FIELD_PREDICTOR_1500:
+        return 1500;
+    case FLIGHT_LOG_FIELD_PREDICTOR_VBATREF:
+        return VBAT_REFERENCE;
+    case FLIGHT_LOG_FIELD_PREDICTOR_MINMOTOR:
+        return MIN_MOTOR;
+    case FLIGHT_LOG_FIELD_PREDICTOR_0:
+    default:
+        return 0;
+    }
+}
+
+static frameValues_t decodeIntraframe(MainFrameDecoder &decoder)
+{
+    EXPECT_EQ('I', decoder.readByte());
+
+    frameValues_t frame(blackboxMainFieldCount());
+    for (int i = 0; i < blackboxMainFieldCount(); i++) {
+        blackboxMainFieldEncoding_t encoding;
+        blackboxGetMainFieldEncoding(i, &encoding);
+
+        int32_t value;
+        switch (encoding.Iencode) {
+        case FLIGHT_LOG_FIELD_ENCODING_UNSIGNED_VB:
+            value = decoder.readUnsignedVB();
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_NEG_14BIT: {
+            const uint32_t bits = decoder.readUnsignedVB();
+            value = -(int32_t)((bits & 0x2000) ? (bits | 0xFFFFC000) : bits);
+            break;
+        }
+        case FLIGHT_LOG_FIELD_ENCODING_SIGNED_VB:
+        default:
+            value = decoder.readSignedVB();
+            break;
+        }
+        frame[i] = value + intraframePrediction(encoding, frame);
+    }
+    return frame;
+}
+
+static frameValues_t decodeInterframe(MainFrameDecoder &decoder, const frameValues_t &last, const frameValues_t &lastLast)
+{
+    EXPECT_EQ('P', decoder.readByte());
+
+    frameValues_t frame(blackboxMainFieldCount());
+    int32_t deltas[8];
+    int groupStart = -1;
+
+    for (int i = 0; i < blackboxMainFieldCount(); i++) {
+        blackboxMainFieldEncoding_t encoding;
+        blackboxGetMainFieldEncoding(i, &encoding);
+
+        if (encoding.Pencode == FLIGHT_LOG_FIELD_ENCODING_NULL) {
+            frame[i] = last[i] + 1;
+            continue;
+        }
+
+        switch (encoding.Pencode) {
+        case FLIGHT_LOG_FIELD_ENCODING_TAG2_3S32:
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_4S16:
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_8SVB:
+            if (groupStart < 0) {
+                groupStart = i;
+            }
+            if (!encoding.groupEnd) {
+                continue;
+            }
+            if (encoding.Pencode == FLIGHT_LOG_FIELD_ENCODING_TAG2_3S32) {
+                decoder.readTag2_3S32(deltas);
+            } else if (encoding.Pencode == FLIGHT_LOG_FIELD_ENCODING_TAG8_4S16) {
+                decoder.readTag8_4S16(deltas);
+            } else {
+                decoder.readTag8_8SVB(deltas, i - groupStart + 1);
+            }
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_SIGNED_VB:
+        default:
+            groupStart = i;
+            deltas[0] = decoder.readSignedVB();
+            break;
+        }
+
+        for (int field = groupStart; field <= i; field++) {
+            blackboxMainFieldEncoding_t fieldEncoding;
+            blackboxGetMainFieldEncoding(field, &fieldEncoding);
+
+            int32_t prediction;
+            switch (fieldEncoding.Ppredict) {
+            case FLIGHT_LOG_FIELD_PREDICTOR_STRAIGHT_LINE:
+                prediction = 2 * last[field] - lastLast[field];
+                break;
+            case FLIGHT_LOG_FIELD_PREDICTOR_AVERAGE_2:
+                prediction = (last[field] + lastLast[field]) / 2;
+                break;
+            case FLIGHT_LOG_FIELD_PREDICTOR_PREVIOUS:
+            default:
+                prediction = last[field];
+                break;
+            }
+            frame[field] = prediction + deltas[field - groupStart];
+        }
+        groupStart = -1;
+    }
+    return frame;
+}
+
+static void startFlight(bool highResolution)
+{
+    blackboxConfigMutable()->high_resolution = highResolution;
+    blackboxStartMainFrames();
+    logData.clear();
+}
+
+static void runRoundTrip(bool highResolution)
+{
+    startFlight(highResolution);
+
+    std::vector<frameValues_t> flight;
+    for (uint32_t iteration = 0; iteration < FLIGHT_ITERATIONS; iteration++) {
+        flight.push_back(flightFrame(iteration, highResolution));
+        encodeFrame(flight.back(), iteration % I_INTERVAL == 0);
+    }
+
+    MainFrameDecoder decoder(logData.data(), logData.size());
+    frameValues_t last, lastLast;
+    for (uint32_t iteration = 0; iteration < FLIGHT_ITERATIONS; iteration++) {
+        frameValues_t frame;
+        if (iteration % I_INTERVAL == 0) {
+            frame = decodeIntraframe(decoder);
+            lastLast = frame;
+        } else {
+            frame = decodeInterframe(decoder, last, lastLast);
+            lastLast = last;
+        }
+        last = frame;
+
+        ASSERT_EQ(flight[iteration], frame) << "iteration " << iteration;
+    }
+    EXPECT_TRUE(decoder.atEnd());
+}
+
+static void runBenchmark(const char *name, bool highResolution)
+{
+    startFlight(highResolution);
+
+    std::vector<frameValues_t> flight;
+    for (uint32_t iteration = 0; iteration < FLIGHT_ITERATIONS; iteration++) {
+        flight.push_back(flightFrame(iteration, highResolution));
+    }
+
+    size_t bytes[2] = { 0, 0 };
+    int frames[2] = { 0, 0 };
+    std::chrono::steady_clock::duration time[2] = {};
+
+    for (uint32_t iteration = 0; iteration < FLIGHT_ITERATIONS; iteration++) {
+        const int intraframe = iteration % I_INTERVAL == 0;
+        const size_t start = logData.size();
+
+        const auto begin = std::chrono::steady_clock::now();
+        encodeFrame(flight[iteration], intraframe);
+        time[intraframe] += std::chrono::steady_clock::now() - begin;
+
+        bytes[intraframe] += logData.size() - start;
+        frames[intraframe]++;
+    }
+
+    for (int intraframe = 1; intraframe >= 0; intraframe--) {
+        const double ns = std::chrono::duration<double, std::nano>(time[intraframe]).count();
+        printf("%s %c frames: %d fields, %.1f bytes/frame, %.0f ns/frame\n", name, intraframe ? 'I' : 'P',
+            blackboxMainFieldCount(), (double)bytes[intraframe] / frames[intraframe], ns / frames[intraframe]);
+    }
+}
+
+class BlackboxFrameTest : public ::testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        pidProfile.pid[PID_ROLL].D = 30;
+        pidProfile.pid[PID_PITCH].D = 32;
+        pidProfile.pid[PID_YAW].D = 0;
+        batteryConfigMutable()->voltageMeterSource = VOLTAGE_METER_ADC;
+        batteryConfigMutable()->currentMeterSource = CURRENT_METER_ADC;
+        rxConfigMutable()->rssi_channel = 8;
+        debugMode = DEBUG_GYRO_RAW;
+        motorOutputLow = MIN_MOTOR;
+    }
+
+    pidProfile_t pidProfile;
+};
+
+TEST_F(BlackboxFrameTest, RoundTrip)
+{
+    currentPidProfile = &pidProfile;
+    runRoundTrip(false);
+}
+
+TEST_F(BlackboxFrameTest, RoundTripHighResolution)
+{
+    currentPidProfile = &pidProfile;
+    runRoundTrip(true);
+}
+
+TEST_F(BlackboxFrameTest, Benchmark)
+{
+    currentPidProfile = &pidProfile;
+    runBenchmark("default", false);
+    runBenchmark("high resolution", true);
+}
+
+// STUBS
+extern "C" {
+
+PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
+PG_REGISTER(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
+PG_REGISTER(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 0);
+PG_REGISTER(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 0);
+PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+PG_REGISTER_ARRAY(modeActivationCondition_t, MAX_MODE_ACTIVATION_CONDITION_COUNT, modeActivationConditions, PG_MODE_ACTIVATION_PROFILE, 0);
+
+uint8_t armingFlags;
+uint8_t stateFlags;
+const uint32_t baudRates[] = {0, 9600, 19200, 38400, 57600, 115200, 230400, 250000,
+        400000, 460800, 500000, 921600, 1000000, 1500000, 2000000, 2470000}; // see baudRate_e
+uint8_t debugMode;
+int32_t blackboxHeaderBudget;
+gpsSolutionData_t gpsSol;
+int32_t GPS_home[2];
+
+gyro_t gyro;
+gyroDev_t gyroDev;
+
+float motorOutputHigh, motorOutputLow;
+float motor_disarmed[MAX_SUPPORTED_MOTORS];
+pidProfile_t *currentPidProfile;
+uint32_t targetPidLooptime;
+
+boxBitmask_t rcModeActivationMask;
+
+void mspSerialAllocatePorts(void) {}
+uint32_t getArmingBeepTimeMicros(void) {return 0;}
+uint16_t getBatteryVoltageLatest(void) {return VBAT_REFERENCE;}
+uint8_t getMotorCount(void) {return 4;}
+bool areMotorsRunning(void) { return false; }
+bool IS_RC_MODE_ACTIVE(boxId_e) {return false;}
+bool isModeActivationConditionPresent(boxId_e) {return false;}
+uint32_t millis(void) {return 0;}
+bool sensors(uint32_t mask) {return mask == SENSOR_ACC;}
+void serialWrite(serialPort_t *, uint8_t value)
+{
+    logData.push_back(value);
+}
+void serialWriteBuf(serialPort_t *, const uint8_t *data, int count)
+{
+    logData.insert(logData.end(), data, data + count);
+}
+uint32_t serialTxBytesFree(const serialPort_t *) {return 0;}
+bool isSerialTransmitBufferEmpty(const serialPort_t *) {return false;}
+bool feature(uint32_t) {return false;}
+void mspSerialReleasePortIfAllocated(serialPort_t *) {}
+serialPortConfig_t *findSerialPortConfig(serialPortFunction_e ) {return NULL;}
+serialPort_t *findSharedSerialPort(uint16_t , serialPortFunction_e ) {return NULL;}
+serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {return NULL;}
+void closeSerialPort(serialPort_t *) {}
+portSharing_e determinePortSharing(const serialPortConfig_t *, serialPortFunction_e ) {return PORTSHARING_UNUSED;}
+failsafePhase_e failsafePhase(void) {return FAILSAFE_IDLE;}
+bool rxAreFlightChannelsValid(void) {return false;}
+bool rxIsReceivingSignal(void) {return false;}
+bool schedulerTaskShouldYield(timeDelta_t) {return false;}
+
+}
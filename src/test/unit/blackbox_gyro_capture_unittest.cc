@@ -0,0 +1,143 @@
+/*
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "blackbox/blackbox_gyro_capture.h"
+
+    #include "drivers/serial.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define WRITE_BUFFER_SIZE 512
+static uint8_t writeBuffer[WRITE_BUFFER_SIZE];
+static int writePos;
+static int framesWritten;
+
+static void resetWriteBuffer(void)
+{
+    memset(writeBuffer, 0, sizeof(writeBuffer));
+    writePos = 0;
+    framesWritten = 0;
+}
+
+static void captureSample(timeUs_t time, int16_t x, int16_t y, int16_t z)
+{
+    const int16_t raw[3] = { x, y, z };
+    const float filtered[3] = { x / 10.0f, y / 10.0f, z / 10.0f };
+    blackboxGyroCaptureSample(time, raw, filtered);
+}
+
+TEST(BlackboxGyroCaptureTest, NothingCapturedWhenEmpty)
+{
+    resetWriteBuffer();
+    blackboxGyroCaptureReset(false);
+
+    EXPECT_FALSE(blackboxGyroCaptureEncode());
+    EXPECT_EQ(0, writePos);
+}
+
+TEST(BlackboxGyroCaptureTest, RawBlockIsDeltaCoded)
+{
+    resetWriteBuffer();
+    blackboxGyroCaptureReset(false);
+
+    captureSample(1000, 10, -1, 0);
+    captureSample(1125, 12, -1, -3);
+
+    EXPECT_TRUE(blackboxGyroCaptureEncode());
+    EXPECT_EQ(1, framesWritten);
+
+    const uint8_t expected[] = {
+        'R', 2, 0,
+        0xe8, 0x07, 20, 1, 0,   // absolute time 1000 and zigzag coded values
+        125, 4, 0, 5,           // deltas
+    };
+    EXPECT_EQ((int)sizeof(expected), writePos);
+    EXPECT_EQ(0, memcmp(expected, writeBuffer, sizeof(expected)));
+}
+
+TEST(BlackboxGyroCaptureTest, FilteredValuesFollowRaw)
+{
+    resetWriteBuffer();
+    blackboxGyroCaptureReset(true);
+
+    captureSample(10, 100, 0, -100);
+
+    EXPECT_TRUE(blackboxGyroCaptureEncode());
+
+    // gyroADCf is logged in 0.1 deg/s, so it equals the raw value here
+    const uint8_t expected[] = {
+        'R', 1, 0,
+        10, 0xc8, 0x01, 0, 0xc7, 0x01,
+        0xc8, 0x01, 0, 0xc7, 0x01,
+    };
+    EXPECT_EQ((int)sizeof(expected), writePos);
+    EXPECT_EQ(0, memcmp(expected, writeBuffer, sizeof(expected)));
+}
+
+TEST(BlackboxGyroCaptureTest, DroppedSamplesAreReported)
+{
+    resetWriteBuffer();
+    blackboxGyroCaptureReset(false);
+
+    // The ring holds one sample less than its size
+    for (int i = 0; i < 70; i++) {
+        captureSample(i, 0, 0, 0);
+    }
+
+    EXPECT_TRUE(blackboxGyroCaptureEncode());
+    EXPECT_EQ(4, framesWritten);
+
+    // 63 samples in blocks of 16, the first one reports the drops
+    EXPECT_EQ('R', writeBuffer[0]);
+    EXPECT_EQ(16, writeBuffer[1]);
+    EXPECT_EQ(7, writeBuffer[2]);
+
+    resetWriteBuffer();
+    captureSample(100, 0, 0, 0);
+    EXPECT_TRUE(blackboxGyroCaptureEncode());
+    EXPECT_EQ(1, writeBuffer[1]);
+    EXPECT_EQ(0, writeBuffer[2]);
+}
+
+// STUBS
+extern "C" {
+int32_t blackboxHeaderBudget;
+void blackboxWrite(uint8_t value)
+{
+    EXPECT_LT(writePos, WRITE_BUFFER_SIZE);
+    writeBuffer[writePos++] = value;
+}
+int blackboxWriteString(const char *s)
+{
+    const int length = strlen(s);
+    for (int i = 0; i < length; i++) {
+        blackboxWrite(s[i]);
+    }
+    return length;
+}
+void blackboxFrameBegin(void) {}
+void blackboxFrameEnd(void) { framesWritten++; }
+void serialWrite(serialPort_t *, uint8_t) {}
+bool isSerialTransmitBufferEmpty(const serialPort_t *) { return true; }
+}
@@ -0,0 +1,222 @@
+/*
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "blackbox/blackbox.h"
+    #include "blackbox/blackbox_trigger.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define DEVICE_BUFFER_SIZE 4096
+static uint8_t deviceBuffer[DEVICE_BUFFER_SIZE];
+static int devicePos;
+
+static void resetDevice(void)
+{
+    memset(deviceBuffer, 0, sizeof(deviceBuffer));
+    devicePos = 0;
+}
+
+// Writes a frame of length bytes of value, the first one being the frame type
+static void writeFrame(bool keyframe, uint32_t iteration, timeUs_t time, uint8_t value, int length = 4)
+{
+    uint8_t frame[64];
+    frame[0] = keyframe ? 'I' : 'P';
+    memset(frame + 1, value, length - 1);
+
+    blackboxTriggerFrameStart();
+    if (keyframe) {
+        blackboxTriggerMarkKeyframe(iteration, time);
+    }
+    blackboxTriggerWrite(frame, length);
+    blackboxTriggerFrameEnd();
+}
+
+TEST(BlackboxTriggerTest, BuffersUntilTriggered)
+{
+    resetDevice();
+    blackboxTriggerInit(true, 100, 50, 0);
+
+    writeFrame(true, 0, 0, 1);
+    writeFrame(false, 1, 1000, 2);
+    EXPECT_EQ(0, devicePos);
+
+    blackboxTriggerFire(2000);
+    EXPECT_TRUE(blackboxTriggerIsTriggered());
+    blackboxTriggerDrain(2000);
+
+    const uint8_t expected[] = { 'I', 1, 1, 1, 'P', 2, 2, 2 };
+    EXPECT_EQ((int)sizeof(expected), devicePos);
+    EXPECT_EQ(0, memcmp(expected, deviceBuffer, sizeof(expected)));
+
+    // Frames of the post trigger window are written straight through
+    writeFrame(false, 2, 3000, 3);
+    blackboxTriggerDrain(3000);
+    EXPECT_EQ((int)sizeof(expected) + 4, devicePos);
+    EXPECT_EQ('P', deviceBuffer[sizeof(expected)]);
+
+    // and the buffering restarts once it is over
+    EXPECT_FALSE(blackboxTriggerDrain(60000));
+    EXPECT_FALSE(blackboxTriggerIsTriggered());
+    writeFrame(false, 3, 61000, 4);
+    blackboxTriggerDrain(61000);
+    EXPECT_EQ((int)sizeof(expected) + 4, devicePos);
+}
+
+TEST(BlackboxTriggerTest, BackgroundFramesAreNotRepeated)
+{
+    resetDevice();
+    blackboxTriggerInit(true, 100, 0, 1000);
+
+    // The first I frame is a background frame
+    writeFrame(true, 0, 0, 1);
+    EXPECT_EQ(4, devicePos);
+    writeFrame(false, 1, 100, 2);
+    EXPECT_EQ(4, devicePos);
+
+    blackboxTriggerFire(200);
+    blackboxTriggerDrain(200);
+
+    // The ring continues right after the background frame
+    const uint8_t expected[] = { 'I', 1, 1, 1, 'P', 2, 2, 2 };
+    EXPECT_EQ((int)sizeof(expected), devicePos);
+    EXPECT_EQ(0, memcmp(expected, deviceBuffer, sizeof(expected)));
+}
+
+TEST(BlackboxTriggerTest, OnlyThePreTriggerWindowIsWritten)
+{
+    resetDevice();
+    blackboxTriggerInit(true, 100, 0, 0);
+
+    writeFrame(true, 0, 0, 1);
+    writeFrame(false, 1, 50000, 2);
+    writeFrame(true, 2, 100000, 3);
+    writeFrame(false, 3, 150000, 4);
+    writeFrame(true, 4, 200000, 5);
+
+    blackboxTriggerFire(210000);
+    blackboxTriggerDrain(210000);
+
+    // A resume event for iteration 2 at 100000us, followed by the window from the I frame before it
+    const uint8_t expected[] = {
+        'E', FLIGHT_LOG_EVENT_LOGGING_RESUME, 2, 0xa0, 0x8d, 0x06,
+        'I', 3, 3, 3, 'P', 4, 4, 4, 'I', 5, 5, 5,
+    };
+    EXPECT_EQ((int)sizeof(expected), devicePos);
+    EXPECT_EQ(0, memcmp(expected, deviceBuffer, sizeof(expected)));
+}
+
+TEST(BlackboxTriggerTest, FramesWithoutKeyframeAreDropped)
+{
+    resetDevice();
+    blackboxTriggerInit(true, 100, 0, 0);
+
+    // Evict everything by overfilling the ring with a single I frame and its P frames
+    writeFrame(true, 0, 0, 1);
+    for (int i = 0; i < BLACKBOX_TRIGGER_BUFFER_SIZE / 4; i++) {
+        writeFrame(false, i + 1, i, 2);
+    }
+    writeFrame(false, 0, 0, 3);
+
+    blackboxTriggerFire(100);
+    blackboxTriggerDrain(100);
+    EXPECT_EQ(0, devicePos);
+
+    // The next I frame is preceded by a resume event
+    writeFrame(true, 10, 200, 4);
+    EXPECT_FALSE(blackboxTriggerDrain(200));
+}
+
+TEST(BlackboxTriggerTest, BacklogHoldsTheHeaderAndFirstFrames)
+{
+    resetDevice();
+    blackboxTriggerInit(false, 100, 0, 0);
+    blackboxTriggerBacklogStart(0);
+    EXPECT_TRUE(blackboxTriggerIsBacklogged());
+    EXPECT_TRUE(blackboxTriggerIsEnabled());
+
+    const uint8_t header[] = { 'H', ' ', 'x', '\n' };
+    blackboxTriggerBacklogWrite(header, sizeof(header));
+    EXPECT_EQ(BLACKBOX_TRIGGER_BUFFER_SIZE - sizeof(header), blackboxTriggerBacklogFree());
+
+    // The header is passed on while it is written, but the backlog lasts until the frames after it are written
+    EXPECT_FALSE(blackboxTriggerDrain(100));
+    EXPECT_EQ((int)sizeof(header), devicePos);
+    EXPECT_TRUE(blackboxTriggerIsEnabled());
+
+    blackboxTriggerBacklogHeaderEnd();
+    EXPECT_FALSE(blackboxTriggerIsBacklogged());
+    writeFrame(true, 0, 200, 1);
+    writeFrame(false, 1, 300, 2);
+    EXPECT_EQ((int)sizeof(header), devicePos);
+
+    EXPECT_FALSE(blackboxTriggerDrain(300));
+    const uint8_t expected[] = { 'H', ' ', 'x', '\n', 'I', 1, 1, 1, 'P', 2, 2, 2 };
+    EXPECT_EQ((int)sizeof(expected), devicePos);
+    EXPECT_EQ(0, memcmp(expected, deviceBuffer, sizeof(expected)));
+
+    // Once the device caught up, trigger logging stays off as configured
+    EXPECT_FALSE(blackboxTriggerIsEnabled());
+    EXPECT_FALSE(blackboxTriggerIsTriggered());
+}
+
+TEST(BlackboxTriggerTest, BacklogReturnsToBuffering)
+{
+    resetDevice();
+    blackboxTriggerInit(true, 100, 0, 0);
+    blackboxTriggerBacklogStart(0);
+
+    const uint8_t header[] = { 'H', '\n' };
+    blackboxTriggerBacklogWrite(header, sizeof(header));
+    blackboxTriggerBacklogHeaderEnd();
+    writeFrame(true, 0, 100, 1);
+    blackboxTriggerDrain(100);
+    EXPECT_EQ((int)sizeof(header) + 4, devicePos);
+
+    // With trigger logging enabled, the frames after the backlog are buffered again
+    EXPECT_TRUE(blackboxTriggerIsEnabled());
+    EXPECT_FALSE(blackboxTriggerIsTriggered());
+    writeFrame(false, 1, 200, 2);
+    blackboxTriggerDrain(200);
+    EXPECT_EQ((int)sizeof(header) + 4, devicePos);
+
+    // and the ring continues where the backlog ended
+    blackboxTriggerFire(300);
+    blackboxTriggerDrain(300);
+    EXPECT_EQ((int)sizeof(header) + 8, devicePos);
+    EXPECT_EQ('P', deviceBuffer[sizeof(header) + 4]);
+}
+
+// STUBS
+extern "C" {
+void blackboxDeviceWrite(const uint8_t *data, int length)
+{
+    EXPECT_LE(devicePos + length, DEVICE_BUFFER_SIZE);
+    memcpy(&deviceBuffer[devicePos], data, length);
+    devicePos += length;
+}
+uint32_t blackboxDeviceWriteBufferFree(void)
+{
+    return DEVICE_BUFFER_SIZE - devicePos;
+}
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/boot_arena.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// The arena is never freed, so the tests run in order against the one arena of BOOT_ARENA_SIZE 256
+TEST(BootArenaTest, Empty)
+{
+    EXPECT_EQ(256, bootArenaSize());
+    EXPECT_EQ(0, bootArenaUsed());
+    EXPECT_EQ(0, bootArenaAllocationCount());
+}
+
+TEST(BootArenaTest, AllocationsAreRoundedAndRecorded)
+{
+    uint8_t *first = (uint8_t *)bootArenaAllocate(10, "FIRST");
+    uint8_t *second = (uint8_t *)bootArenaAllocate(40, "SECOND");
+
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    EXPECT_EQ(first + 32, second);
+
+    EXPECT_EQ(96, bootArenaUsed());
+    EXPECT_EQ(2, bootArenaAllocationCount());
+    EXPECT_STREQ("FIRST", bootArenaGetAllocation(0)->owner);
+    EXPECT_EQ(32, bootArenaGetAllocation(0)->size);
+    EXPECT_STREQ("SECOND", bootArenaGetAllocation(1)->owner);
+    EXPECT_EQ(64, bootArenaGetAllocation(1)->size);
+}
+
+TEST(BootArenaTest, FullArenaRefuses)
+{
+    EXPECT_EQ(nullptr, bootArenaAllocate(161, "TOO_BIG"));
+    EXPECT_EQ(96, bootArenaUsed());
+
+    EXPECT_NE(nullptr, bootArenaAllocate(160, "REST"));
+    EXPECT_EQ(256, bootArenaUsed());
+    EXPECT_EQ(nullptr, bootArenaAllocate(1, "MORE"));
+    EXPECT_EQ(3, bootArenaAllocationCount());
+}
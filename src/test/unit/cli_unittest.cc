@@ -166,6 +166,8 @@ static const box_t boxes[] = { { 0, "DUMMYBOX", 0 } };
 const box_t *findBoxByPermanentId(uint8_t) { return &boxes[0]; }
 const box_t *findBoxByBoxId(boxId_e) { return &boxes[0]; }
 
+void settingGetName(const clivalue_t *value, char *name) { strcpy(name, value->name); }
+
 int8_t unitTestDataArray[3];
 
 void pgResetFn_unitTestData(int8_t *ptr) {
@@ -220,6 +222,7 @@ void serialPassthrough(serialPort_t *, serialPort_t *, serialConsumer *, serialC
 uint32_t millis(void) { return 0; }
 uint8_t getBatteryCellCount(void) { return 1; }
 void servoMixerLoadMix(int) {}
+void servoMixerCompileRules(void) {}
 const char * getBatteryStateString(void){ return "_getBatteryStateString_"; }
 
 uint32_t stackTotalSize(void) { return 0x4000; }
@@ -0,0 +1,84 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "common/crc.h"
+    #include "common/streambuf.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static const uint8_t checkData[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+// the bitwise CRC-8 DVB-S2 the table replaced
+static uint8_t crc8DvbS2Bitwise(uint8_t crc, uint8_t a)
+{
+    crc ^= a;
+    for (int ii = 0; ii < 8; ++ii) {
+        crc = (crc & 0x80) ? (crc << 1) ^ 0xD5 : crc << 1;
+    }
+    return crc;
+}
+
+TEST(CrcTest, CheckValues)
+{
+    EXPECT_EQ(0xBC, crc8_dvb_s2_update(0, checkData, sizeof(checkData)));
+    EXPECT_EQ(0xF4, crc8_ccitt_update(0, checkData, sizeof(checkData)));
+    EXPECT_EQ(0x31C3, crc16_ccitt_update(0, checkData, sizeof(checkData)));
+    EXPECT_EQ(0xCBF43926, crc32_update(0, checkData, sizeof(checkData)));
+}
+
+TEST(CrcTest, ByteAndBlockAgree)
+{
+    uint8_t crc8 = 0;
+    uint16_t crc16 = 0;
+    for (unsigned ii = 0; ii < sizeof(checkData); ii++) {
+        crc8 = crc8_dvb_s2(crc8, checkData[ii]);
+        crc16 = crc16_ccitt(crc16, checkData[ii]);
+    }
+    EXPECT_EQ(crc8_dvb_s2_update(0, checkData, sizeof(checkData)), crc8);
+    EXPECT_EQ(crc16_ccitt_update(0, checkData, sizeof(checkData)), crc16);
+
+    // continuing a CRC over a split block
+    EXPECT_EQ(0xCBF43926, crc32_update(crc32_update(0, checkData, 4), checkData + 4, sizeof(checkData) - 4));
+}
+
+TEST(CrcTest, Crc8DvbS2MatchesBitwise)
+{
+    for (int crc = 0; crc < 256; crc++) {
+        for (int a = 0; a < 256; a++) {
+            ASSERT_EQ(crc8DvbS2Bitwise(crc, a), crc8_dvb_s2(crc, a));
+        }
+    }
+}
+
+TEST(CrcTest, SbufAppend)
+{
+    uint8_t buffer[16];
+    sbuf_t sbuf = { buffer, buffer + sizeof(buffer) };
+    sbufWriteData(&sbuf, checkData, sizeof(checkData));
+    crc8_dvb_s2_sbuf_append(&sbuf, buffer);
+    EXPECT_EQ(0xBC, buffer[sizeof(checkData)]);
+
+    sbuf.ptr = buffer + sizeof(checkData);
+    crc16_ccitt_sbuf_append(&sbuf, buffer);
+    EXPECT_EQ(0x31C3, buffer[sizeof(checkData)] | buffer[sizeof(checkData) + 1] << 8);
+}
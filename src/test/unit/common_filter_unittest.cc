@@ -24,6 +24,9 @@
 
 extern "C" {
     #include "common/filter.h"
+    #include "common/filter_fixed.h"
+    #include "common/utils.h"
+    #include "common/maths.h"
 }
 
 #include "unittest_macros.h"
@@ -114,3 +117,257 @@ TEST(FilterUnittest, TestSlewFilter)
     slewFilterApply(&filter, 200.0f);
     EXPECT_EQ(200, filter.state);
 }
+
+TEST(FilterUnittest, TestPt1FilterBank3Apply)
+{
+    pt1Filter_t filter;
+    pt1FilterBank3_t bank;
+    pt1FilterInit(&filter, pt1FilterGain(100, 0.001f));
+    pt1FilterBank3Init(&bank, pt1FilterGain(100, 0.001f));
+
+    static const float inputs[] = { 100.0f, -250.0f, 30.0f, 0.0f };
+    for (unsigned i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        float values[FILTER_BANK_SIZE] = { inputs[i], 2 * inputs[i], -inputs[i] };
+        pt1FilterBank3Apply(&bank, values);
+        const float expected = pt1FilterApply(&filter, inputs[i]);
+        EXPECT_FLOAT_EQ(expected, values[0]);
+        EXPECT_FLOAT_EQ(2 * expected, values[1]);
+        EXPECT_FLOAT_EQ(-expected, values[2]);
+    }
+}
+
+TEST(FilterUnittest, TestBiquadFilterBank3Apply)
+{
+    biquadFilter_t filter;
+    biquadFilter_t filterDF1;
+    biquadFilterBank3_t bank;
+    biquadFilterBank3_t bankDF1;
+    biquadFilterInit(&filter, 200, 1000, 2.0f, FILTER_NOTCH);
+    biquadFilterInit(&filterDF1, 200, 1000, 2.0f, FILTER_NOTCH);
+    biquadFilterBank3Init(&bank, 200, 1000, 2.0f, FILTER_NOTCH);
+    biquadFilterBank3Init(&bankDF1, 200, 1000, 2.0f, FILTER_NOTCH);
+
+    for (int i = 0; i < 20; i++) {
+        const float input = 100.0f * sinf(i * 0.7f);
+        float values[FILTER_BANK_SIZE] = { input, input, input };
+        float valuesDF1[FILTER_BANK_SIZE] = { input, input, input };
+        biquadFilterBank3Apply(&bank, values);
+        biquadFilterBank3ApplyDF1(&bankDF1, valuesDF1);
+        const float expected = biquadFilterApply(&filter, input);
+        const float expectedDF1 = biquadFilterApplyDF1(&filterDF1, input);
+        for (int j = 0; j < FILTER_BANK_SIZE; j++) {
+            EXPECT_FLOAT_EQ(expected, values[j]);
+            EXPECT_FLOAT_EQ(expectedDF1, valuesDF1[j]);
+        }
+    }
+}
+
+TEST(FilterUnittest, TestBiquadFilterBank3Update)
+{
+    biquadFilter_t filter;
+    biquadFilterBank3_t bank;
+    biquadFilterInit(&filter, 300, 1000, 2.0f, FILTER_NOTCH);
+    biquadFilterBank3Init(&bank, 200, 1000, 2.0f, FILTER_NOTCH);
+
+    // retune only the second filter of the bank
+    biquadFilterBank3Update(&bank, 1, 300, 1000, 2.0f, FILTER_NOTCH);
+    EXPECT_FLOAT_EQ(filter.b1, bank.b1[1]);
+    EXPECT_FLOAT_EQ(filter.a1, bank.a1[1]);
+    EXPECT_NE(bank.b1[0], bank.b1[1]);
+    EXPECT_FLOAT_EQ(bank.b1[0], bank.b1[2]);
+}
+
+TEST(FilterUnittest, TestBiquadFilterBank3UpdateNotch)
+{
+    biquadFilter_t filter;
+    biquadFilterBank3_t bank;
+    biquadFilterInit(&filter, 300, 125, 2.0f, FILTER_NOTCH);
+    biquadFilterBank3Init(&bank, 200, 125, 2.0f, FILTER_NOTCH);
+
+    biquadFilterBank3UpdateNotch(&bank, 2, 300, 2.0f * M_PIf * 125 * 0.000001f, 2.0f);
+    EXPECT_FLOAT_EQ(filter.b0, bank.b0[2]);
+    EXPECT_FLOAT_EQ(filter.b1, bank.b1[2]);
+    EXPECT_FLOAT_EQ(filter.b2, bank.b2[2]);
+    EXPECT_FLOAT_EQ(filter.a1, bank.a1[2]);
+    EXPECT_FLOAT_EQ(filter.a2, bank.a2[2]);
+    EXPECT_FLOAT_EQ(bank.b1[0], bank.b1[1]);
+}
+
+TEST(FilterUnittest, TestBiquadFilterBank3SetNotchFromTable)
+{
+    static biquadNotchTable_t table;
+    biquadNotchTableInit(&table, 100, 3840, 125, 3.0f);
+
+    biquadFilter_t filter;
+    biquadFilterBank3_t bank;
+    biquadFilterBank3Init(&bank, 100, 125, 3.0f, FILTER_NOTCH);
+
+    // between entries the coefficients are interpolated
+    const float frequencies[] = { 100, 211, 1234, 3000, 3840 };
+    for (unsigned i = 0; i < ARRAYLEN(frequencies); i++) {
+        biquadFilterInit(&filter, frequencies[i], 125, 3.0f, FILTER_NOTCH);
+        biquadFilterBank3SetNotchFromTable(&bank, &table, frequencies[i]);
+        for (int axis = 0; axis < FILTER_BANK_SIZE; axis++) {
+            EXPECT_NEAR(filter.b0, bank.b0[axis], 1e-4);
+            EXPECT_NEAR(filter.b1, bank.b1[axis], 1e-4);
+            EXPECT_NEAR(filter.b2, bank.b2[axis], 1e-4);
+            EXPECT_NEAR(filter.a1, bank.a1[axis], 1e-4);
+            EXPECT_NEAR(filter.a2, bank.a2[axis], 1e-4);
+        }
+    }
+
+    // out of range frequencies are clamped to the ends of the table
+    biquadFilterInit(&filter, 100, 125, 3.0f, FILTER_NOTCH);
+    biquadFilterBank3UpdateNotchFromTable(&bank, 1, &table, 20);
+    EXPECT_NEAR(filter.a1, bank.a1[1], 1e-6);
+    biquadFilterInit(&filter, 3840, 125, 3.0f, FILTER_NOTCH);
+    biquadFilterBank3UpdateNotchFromTable(&bank, 1, &table, 5000);
+    EXPECT_NEAR(filter.a1, bank.a1[1], 1e-6);
+}
+
+TEST(FilterUnittest, TestPt1GainFromTable)
+{
+    pt1GainTable_t table;
+    pt1GainTableInit(&table, 80, 500, 0.000125f);
+
+    const uint16_t cutoffs[] = { 80, 97, 250, 433, 500 };
+    for (unsigned i = 0; i < ARRAYLEN(cutoffs); i++) {
+        EXPECT_NEAR(pt1FilterGain(cutoffs[i], 0.000125f), pt1GainFromTable(&table, cutoffs[i]), 1e-4);
+    }
+
+    // out of range cutoffs are clamped to the ends of the table
+    EXPECT_FLOAT_EQ(pt1GainFromTable(&table, 80), pt1GainFromTable(&table, 10));
+    EXPECT_FLOAT_EQ(pt1GainFromTable(&table, 500), pt1GainFromTable(&table, 1000));
+}
+
+TEST(FilterUnittest, TestBiquadFilterBank3SetLowpassFromTable)
+{
+    biquadLowpassTable_t table;
+    biquadLowpassTableInit(&table, 80, 500, 125);
+
+    biquadFilter_t filter;
+    biquadFilterBank3_t bank;
+    biquadFilterBank3InitLPF(&bank, 80, 125);
+
+    // the zeros are worked out from the interpolated poles
+    const float cutoffs[] = { 80, 97, 250, 433, 500 };
+    for (unsigned i = 0; i < ARRAYLEN(cutoffs); i++) {
+        biquadFilterInitLPF(&filter, cutoffs[i], 125);
+        biquadFilterBank3SetLowpassFromTable(&bank, &table, cutoffs[i]);
+        for (int axis = 0; axis < FILTER_BANK_SIZE; axis++) {
+            EXPECT_NEAR(filter.b0, bank.b0[axis], 1e-5);
+            EXPECT_NEAR(filter.b1, bank.b1[axis], 1e-5);
+            EXPECT_NEAR(filter.b2, bank.b2[axis], 1e-5);
+            EXPECT_NEAR(filter.a1, bank.a1[axis], 1e-4);
+            EXPECT_NEAR(filter.a2, bank.a2[axis], 1e-4);
+        }
+    }
+
+    // unity gain at DC
+    float values[FILTER_BANK_SIZE];
+    for (int i = 0; i < 2000; i++) {
+        values[0] = values[1] = values[2] = 100.0f;
+        biquadFilterBank3Apply(&bank, values);
+    }
+    EXPECT_NEAR(100.0f, values[0], 1e-2);
+}
+
+TEST(FilterUnittest, TestPt1FilterBank3FixedApply)
+{
+    pt1Filter_t filter;
+    pt1FilterBank3Fixed_t bank;
+    pt1FilterInit(&filter, pt1FilterGain(100, 0.001f));
+    pt1FilterBank3FixedInit(&bank, pt1FilterGain(100, 0.001f));
+
+    for (int i = 0; i < 50; i++) {
+        const float input = (i < 25) ? 500.0f : -120.0f;
+        int32_t values[FILTER_BANK_SIZE] = { filterFloatToFixed(input), filterFloatToFixed(-input), 0 };
+        pt1FilterBank3FixedApply(&bank, values);
+        const float expected = pt1FilterApply(&filter, input);
+        EXPECT_NEAR(expected, filterFixedToFloat(values[0]), 0.001f);
+        EXPECT_NEAR(-expected, filterFixedToFloat(values[1]), 0.001f);
+        EXPECT_EQ(0, values[2]);
+    }
+}
+
+TEST(FilterUnittest, TestBiquadFilterBank3FixedApply)
+{
+    biquadFilter_t notch;
+    biquadFilter_t lowpass;
+    biquadFilterBank3Fixed_t notchBank;
+    biquadFilterBank3Fixed_t lowpassBank;
+    biquadFilterInit(&notch, 200, 1000, 2.0f, FILTER_NOTCH);
+    biquadFilterInitLPF(&lowpass, 50, 1000);
+    biquadFilterBank3FixedInit(&notchBank, 200, 1000, 2.0f, FILTER_NOTCH);
+    biquadFilterBank3FixedInitLPF(&lowpassBank, 50, 1000);
+
+    for (int i = 0; i < 200; i++) {
+        const float input = 1500.0f * sinf(i * 0.7f) + 300.0f;
+        int32_t values[FILTER_BANK_SIZE] = { filterFloatToFixed(input), filterFloatToFixed(input), filterFloatToFixed(input) };
+        biquadFilterBank3FixedApply(&notchBank, values);
+        biquadFilterBank3FixedApply(&lowpassBank, values);
+        const float expected = biquadFilterApplyDF1(&lowpass, biquadFilterApplyDF1(&notch, input));
+        for (int j = 0; j < FILTER_BANK_SIZE; j++) {
+            EXPECT_NEAR(expected, filterFixedToFloat(values[j]), 0.01f);
+        }
+    }
+}
+
+TEST(FilterUnittest, TestKalmanFilterBank3Init)
+{
+    const float k = pt1FilterGain(100, 0.000125f);
+    kalmanFilterBank3_t bank;
+    kalmanFilterBank3Init(&bank, kalmanFilterProcessNoise(k, 100.0f), 100.0f);
+
+    // at the configured noise the rate gain is the PT1 gain
+    for (int i = 0; i < FILTER_BANK_SIZE; i++) {
+        EXPECT_NEAR(k, bank.alpha[i], 1e-5);
+        EXPECT_GT(bank.beta[i], 0.0f);
+        EXPECT_LT(bank.beta[i], bank.alpha[i]);
+    }
+}
+
+TEST(FilterUnittest, TestKalmanFilterBank3FollowsRamp)
+{
+    const float k = pt1FilterGain(100, 0.000125f);
+    pt1Filter_t pt1;
+    kalmanFilterBank3_t bank;
+    pt1FilterInit(&pt1, k);
+    kalmanFilterBank3Init(&bank, kalmanFilterProcessNoise(k, 100.0f), 100.0f);
+
+    // a ramp is followed without lag once settled, a PT1 lags by (1 - k) / k samples
+    float values[FILTER_BANK_SIZE];
+    float pt1Output = 0.0f;
+    for (int i = 0; i < 2000; i++) {
+        const float input = 0.5f * i;
+        values[0] = input;
+        values[1] = -input;
+        values[2] = 0.0f;
+        kalmanFilterBank3Apply(&bank, values);
+        pt1Output = pt1FilterApply(&pt1, input);
+    }
+    const float input = 0.5f * 1999;
+    EXPECT_NEAR(input, values[0], 0.01f);
+    EXPECT_NEAR(-input, values[1], 0.01f);
+    EXPECT_FLOAT_EQ(0.0f, values[2]);
+    EXPECT_NEAR(input - 0.5f * (1.0f - k) / k, pt1Output, 0.01f);
+}
+
+TEST(FilterUnittest, TestKalmanFilterBank3AdaptsToNoise)
+{
+    const float k = pt1FilterGain(100, 0.000125f);
+    kalmanFilterBank3_t bank;
+    kalmanFilterBank3Init(&bank, kalmanFilterProcessNoise(k, 100.0f), 100.0f);
+
+    // x is noisier than configured, y is quieter and z is as configured, the noise is uniform so its variance is amplitude^2 / 3
+    uint32_t seed = 1;
+    for (int i = 0; i < 100 * KALMAN_WINDOW_SIZE; i++) {
+        seed = seed * 1664525 + 1013904223;
+        const float noise = (int32_t)seed / 2147483648.0f;
+        float values[FILTER_BANK_SIZE] = { 4 * sqrtf(300.0f) * noise, sqrtf(300.0f) / 4 * noise, sqrtf(300.0f) * noise };
+        kalmanFilterBank3Apply(&bank, values);
+    }
+    EXPECT_LT(bank.alpha[0], 0.7f * k);
+    EXPECT_GT(bank.alpha[1], 1.4f * k);
+    EXPECT_NEAR(k, bank.alpha[2], 0.2f * k);
+}
@@ -0,0 +1,131 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "sensors/compass_calibration.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define FIELD_STRENGTH 500.0f
+
+static magCalibrationSolver_t solver;
+
+static const float hardIron[XYZ_AXIS_COUNT] = { 120.0f, -60.0f, 35.0f };
+// symmetric, so its inverse is the correction the solver should find
+static const float distortion[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT] = {
+    { 1.20f, 0.10f, 0.00f },
+    { 0.10f, 0.90f, 0.05f },
+    { 0.00f, 0.05f, 1.00f }
+};
+
+static void distortedSample(const float field[XYZ_AXIS_COUNT], float sample[XYZ_AXIS_COUNT])
+{
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        sample[i] = hardIron[i];
+        for (int j = 0; j < XYZ_AXIS_COUNT; j++) {
+            sample[i] += distortion[i][j] * field[j];
+        }
+    }
+}
+
+// field directions spread over the whole sphere
+static void addSphereSamples(int count)
+{
+    for (int i = 0; i < count; i++) {
+        const float z = 1.0f - 2.0f * (i + 0.5f) / count;
+        const float r = sqrtf(1.0f - z * z);
+        const float longitude = i * 2.39996323f;
+        const float field[XYZ_AXIS_COUNT] = { FIELD_STRENGTH * r * cosf(longitude), FIELD_STRENGTH * r * sinf(longitude), FIELD_STRENGTH * z };
+        float sample[XYZ_AXIS_COUNT];
+        distortedSample(field, sample);
+        magCalibrationSolverAddSample(&solver, sample);
+    }
+}
+
+TEST(CompassCalibrationUnittest, TestNoResultWithoutSamples)
+{
+    magCalibrationSolverInit(&solver);
+    float offset[XYZ_AXIS_COUNT];
+    float softIron[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT];
+    EXPECT_FALSE(magCalibrationSolverGetResult(&solver, offset, softIron));
+}
+
+TEST(CompassCalibrationUnittest, TestRepeatedDirectionIgnored)
+{
+    magCalibrationSolverInit(&solver);
+    const float sample[XYZ_AXIS_COUNT] = { 100.0f, 200.0f, 300.0f };
+    EXPECT_TRUE(magCalibrationSolverAddSample(&solver, sample));
+    EXPECT_FALSE(magCalibrationSolverAddSample(&solver, sample));
+    EXPECT_EQ(1, solver.sampleCount);
+}
+
+TEST(CompassCalibrationUnittest, TestRecoversHardAndSoftIron)
+{
+    magCalibrationSolverInit(&solver);
+    addSphereSamples(1000);
+
+    float offset[XYZ_AXIS_COUNT];
+    float softIron[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT];
+    ASSERT_TRUE(magCalibrationSolverGetResult(&solver, offset, softIron));
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        EXPECT_NEAR(hardIron[axis], offset[axis], 1.0f);
+    }
+
+    // the correction undoes the distortion, scaled to keep the volume
+    const float volumeScale = cbrtf(1.20f * (0.90f * 1.00f - 0.05f * 0.05f) - 0.10f * (0.10f * 1.00f));
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        for (int j = 0; j < XYZ_AXIS_COUNT; j++) {
+            float product = 0.0f;
+            for (int k = 0; k < XYZ_AXIS_COUNT; k++) {
+                product += softIron[i][k] * distortion[k][j];
+            }
+            EXPECT_NEAR(i == j ? volumeScale : 0.0f, product, 0.01f);
+        }
+    }
+}
+
+TEST(CompassCalibrationUnittest, TestNoResultFromLevelFlight)
+{
+    magCalibrationSolverInit(&solver);
+    // yawing while level only sweeps the horizontal axes
+    for (int i = 0; i < 1000; i++) {
+        const float heading = i * 0.3f;
+        const float field[XYZ_AXIS_COUNT] = { 250.0f * cosf(heading), 250.0f * sinf(heading), 430.0f };
+        float sample[XYZ_AXIS_COUNT];
+        distortedSample(field, sample);
+        magCalibrationSolverAddSample(&solver, sample);
+    }
+
+    float offset[XYZ_AXIS_COUNT];
+    float softIron[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT];
+    EXPECT_FALSE(magCalibrationSolverGetResult(&solver, offset, softIron));
+}
@@ -0,0 +1,354 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "config/config_eeprom.h"
+    #include "config/config_streamer.h"
+
+    #include "drivers/system.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    typedef struct testConfigA_s {
+        uint32_t value;
+        uint8_t data[20];
+    } testConfigA_t;
+
+    typedef struct testConfigB_s {
+        uint16_t value;
+    } testConfigB_t;
+
+    typedef struct testProfile_s {
+        uint16_t p;
+        uint16_t i;
+        uint8_t data[36];
+    } testProfile_t;
+
+    #define TEST_PROFILE_COUNT 3
+
+    PG_DECLARE(testConfigA_t, testConfigA);
+    PG_DECLARE(testConfigB_t, testConfigB);
+    PG_DECLARE_ARRAY(testProfile_t, TEST_PROFILE_COUNT, testProfiles);
+
+    PG_REGISTER(testConfigA_t, testConfigA, PG_MOTOR_CONFIG, 0);
+    PG_REGISTER(testConfigB_t, testConfigB, PG_SERIAL_CONFIG, 0);
+    PG_REGISTER_ARRAY(testProfile_t, TEST_PROFILE_COUNT, testProfiles, PG_PID_PROFILE, 0);
+
+    #define TEST_EEPROM_SIZE 1024
+
+    uint8_t eepromData[TEST_EEPROM_SIZE] __attribute__((aligned(4)));
+}
+
+// The config area of the linker script
+__asm__(
+    ".globl __config_start\n"
+    ".set __config_start, eepromData\n"
+    ".globl __config_end\n"
+    ".set __config_end, eepromData + 1024\n"
+);
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static int eraseCount;
+static int programWordCount;
+
+static void resetEeprom(void)
+{
+    memset(eepromData, 0xFF, sizeof(eepromData));
+    eraseCount = 0;
+    programWordCount = 0;
+}
+
+TEST(ConfigEepromTest, FirstSaveWritesTheWholeConfig)
+{
+    resetEeprom();
+    EXPECT_FALSE(isEEPROMStructureValid());
+
+    testConfigAMutable()->value = 1234;
+    testConfigBMutable()->value = 56;
+    writeConfigToEEPROM();
+
+    EXPECT_EQ(1, eraseCount);
+    EXPECT_TRUE(isEEPROMStructureValid());
+
+    memset(testConfigAMutable(), 0, sizeof(testConfigA_t));
+    memset(testConfigBMutable(), 0, sizeof(testConfigB_t));
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(1234, testConfigA()->value);
+    EXPECT_EQ(56, testConfigB()->value);
+}
+
+TEST(ConfigEepromTest, SaveAppendsOnlyTheChangedPgs)
+{
+    resetEeprom();
+    writeConfigToEEPROM();
+    const uint16_t storedSize = getEEPROMConfigSize();
+
+    // Nothing changed, nothing written
+    programWordCount = 0;
+    writeConfigToEEPROM();
+    EXPECT_EQ(0, programWordCount);
+    EXPECT_EQ(1, eraseCount);
+
+    testConfigBMutable()->value = 789;
+    writeConfigToEEPROM();
+
+    // One record of B: 6 byte header, 2 bytes of PG and a 2 byte CRC, padded to 12 bytes
+    EXPECT_EQ(1, eraseCount);
+    EXPECT_EQ(3, programWordCount);
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_LT(storedSize, getEEPROMConfigSize());
+
+    testConfigAMutable()->value = 0;
+    testConfigBMutable()->value = 0;
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(789, testConfigB()->value);
+
+    // The latest record of the PG wins
+    testConfigBMutable()->value = 790;
+    writeConfigToEEPROM();
+    testConfigBMutable()->value = 0;
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(790, testConfigB()->value);
+    EXPECT_EQ(1, eraseCount);
+}
+
+TEST(ConfigEepromTest, FullJournalIsCompacted)
+{
+    resetEeprom();
+    writeConfigToEEPROM();
+
+    for (int i = 0; i < 200; i++) {
+        testConfigAMutable()->value = i;
+        writeConfigToEEPROM();
+
+        testConfigAMutable()->value = 0;
+        EXPECT_TRUE(loadEEPROM());
+        EXPECT_EQ((uint32_t)i, testConfigA()->value);
+    }
+
+    // Each record of A takes 32 bytes, so the journal filled up and was compacted a few times
+    EXPECT_LT(2, eraseCount);
+    EXPECT_GT(20, eraseCount);
+}
+
+TEST(ConfigEepromTest, TornRecordEndsTheJournal)
+{
+    resetEeprom();
+    testConfigBMutable()->value = 1;
+    writeConfigToEEPROM();
+    const uint16_t storedSize = getEEPROMConfigSize();
+
+    testConfigBMutable()->value = 2;
+    writeConfigToEEPROM();
+    EXPECT_TRUE(isEEPROMStructureValid());
+    const uint16_t journalSize = getEEPROMConfigSize();
+
+    // Lose the last word of the record, as if the power went while it was programmed
+    memset(&eepromData[journalSize - 4], 0xFF, 4);
+
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_EQ(storedSize, getEEPROMConfigSize());
+    testConfigBMutable()->value = 0;
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(1, testConfigB()->value);
+
+    // The torn record can't be programmed over, so the next save writes the whole config
+    testConfigBMutable()->value = 3;
+    writeConfigToEEPROM();
+    EXPECT_EQ(2, eraseCount);
+    testConfigBMutable()->value = 0;
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(3, testConfigB()->value);
+}
+
+TEST(ConfigEepromTest, CorruptedRecordResetsOnlyItsPg)
+{
+    resetEeprom();
+    testConfigAMutable()->value = 1234;
+    testConfigBMutable()->value = 56;
+    writeConfigToEEPROM();
+
+    // Flip a bit in the PG data of the record of A, which comes first
+    eepromData[2 + 6 + 1] ^= 0x01;
+
+    EXPECT_TRUE(isEEPROMStructureValid());
+    testConfigAMutable()->value = 0;
+    testConfigBMutable()->value = 0;
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(0, testConfigA()->value);
+    EXPECT_EQ(56, testConfigB()->value);
+}
+
+static void setTestProfiles(void)
+{
+    for (int i = 0; i < TEST_PROFILE_COUNT; i++) {
+        testProfile_t *profile = testProfilesMutable(i);
+        profile->p = 45;
+        profile->i = 80;
+        for (unsigned j = 0; j < sizeof(profile->data); j++) {
+            profile->data[j] = j;
+        }
+    }
+    testProfilesMutable(1)->p = 50;
+    testProfilesMutable(2)->i = 90;
+    testProfilesMutable(2)->data[30] = 0xAA;
+}
+
+TEST(ConfigEepromTest, ProfilesAreStoredAsDeltas)
+{
+    resetEeprom();
+    setTestProfiles();
+    testProfile_t expected[TEST_PROFILE_COUNT];
+    memcpy(expected, testProfiles(0), sizeof(expected));
+
+    writeConfigToEEPROM();
+    EXPECT_TRUE(isEEPROMStructureValid());
+
+    // The first profile is stored whole, then the run count and a 3 byte run header for each changed byte of the others
+    EXPECT_EQ(2 + (6 + 24 + 2) + (6 + 2 + 2) + (6 + 2 + 40 + (1 + 3 + 1) + (1 + 3 + 1 + 3 + 1) + 2) + 2, getEEPROMConfigSize());
+
+    memset(testProfilesMutable(0), 0, sizeof(expected));
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(0, memcmp(expected, testProfiles(0), sizeof(expected)));
+}
+
+TEST(ConfigEepromTest, ChangedProfileIsJournaled)
+{
+    resetEeprom();
+    setTestProfiles();
+    writeConfigToEEPROM();
+
+    programWordCount = 0;
+    writeConfigToEEPROM();
+    EXPECT_EQ(0, programWordCount);
+
+    testProfilesMutable(1)->data[0] = 0x55;
+    writeConfigToEEPROM();
+    EXPECT_EQ(1, eraseCount);
+    EXPECT_LT(0, programWordCount);
+
+    testProfile_t expected[TEST_PROFILE_COUNT];
+    memcpy(expected, testProfiles(0), sizeof(expected));
+    memset(testProfilesMutable(0), 0, sizeof(expected));
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(0, memcmp(expected, testProfiles(0), sizeof(expected)));
+}
+
+TEST(ConfigEepromTest, UnrelatedProfilesAreStoredWhole)
+{
+    resetEeprom();
+    uint8_t *bytes = (uint8_t *)testProfilesMutable(0);
+    for (unsigned i = 0; i < TEST_PROFILE_COUNT * sizeof(testProfile_t); i++) {
+        bytes[i] = i * 7;
+    }
+    testProfile_t expected[TEST_PROFILE_COUNT];
+    memcpy(expected, testProfiles(0), sizeof(expected));
+
+    writeConfigToEEPROM();
+    EXPECT_EQ(2 + (6 + 24 + 2) + (6 + 2 + 2) + (6 + sizeof(expected) + 2) + 2, getEEPROMConfigSize());
+
+    memset(testProfilesMutable(0), 0, sizeof(expected));
+    EXPECT_TRUE(loadEEPROM());
+    EXPECT_EQ(0, memcmp(expected, testProfiles(0), sizeof(expected)));
+}
+
+// STUBS
+
+extern "C" {
+
+void failureMode(failureMode_e mode)
+{
+    UNUSED(mode);
+    FAIL();
+}
+
+// Behaves like NOR flash: erasing sets every bit, programming can only clear them
+static int programWord(config_streamer_t *c, uint32_t value)
+{
+    if (c->address == (uintptr_t)eepromData) {
+        memset(eepromData, 0xFF, sizeof(eepromData));
+        eraseCount++;
+    }
+    if (c->address < (uintptr_t)eepromData || c->address + sizeof(value) > (uintptr_t)ARRAYEND(eepromData)) {
+        return -2;
+    }
+    uint32_t *word = (uint32_t *)c->address;
+    *word &= value;
+    programWordCount++;
+    c->address += sizeof(value);
+    return 0;
+}
+
+void config_streamer_init(config_streamer_t *c)
+{
+    memset(c, 0, sizeof(*c));
+}
+
+void config_streamer_start(config_streamer_t *c, uintptr_t base, int size)
+{
+    c->address = base;
+    c->size = size;
+    c->unlocked = true;
+    c->err = 0;
+}
+
+int config_streamer_write(config_streamer_t *c, const uint8_t *p, uint32_t size)
+{
+    for (const uint8_t *pat = p; pat != p + size; pat++) {
+        c->buffer.b[c->at++] = *pat;
+
+        if (c->at == sizeof(c->buffer)) {
+            c->err = programWord(c, c->buffer.w);
+            c->at = 0;
+        }
+    }
+    return c->err;
+}
+
+int config_streamer_flush(config_streamer_t *c)
+{
+    if (c->at != 0) {
+        memset(c->buffer.b + c->at, 0, sizeof(c->buffer) - c->at);
+        c->err = programWord(c, c->buffer.w);
+        c->at = 0;
+    }
+    return c->err;
+}
+
+int config_streamer_finish(config_streamer_t *c)
+{
+    c->unlocked = false;
+    return c->err;
+}
+
+int config_streamer_status(config_streamer_t *c)
+{
+    return c->err;
+}
+
+}
@@ -0,0 +1,105 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+    #include "build/debug_capture.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// The ring holds DEBUG_CAPTURE_BUFFER_VALUES 64, 16 samples of one mode or 8 of two
+
+TEST(DebugCaptureTest, InvalidModesAreRefused)
+{
+    const uint8_t none[] = { DEBUG_NONE };
+    const uint8_t duplicate[] = { DEBUG_GYRO_RAW, DEBUG_GYRO_RAW };
+    const uint8_t tooMany[] = { DEBUG_GYRO_RAW, DEBUG_PIDLOOP, DEBUG_FFT, DEBUG_RTH, DEBUG_USB };
+    const uint8_t unknown[] = { DEBUG_COUNT };
+
+    EXPECT_FALSE(debugCaptureStart(none, 1, 0));
+    EXPECT_FALSE(debugCaptureStart(duplicate, 2, 0));
+    EXPECT_FALSE(debugCaptureStart(tooMany, 5, 0));
+    EXPECT_FALSE(debugCaptureStart(unknown, 1, 0));
+    EXPECT_FALSE(debugCaptureStart(none, 0, 0));
+    EXPECT_EQ(DEBUG_CAPTURE_IDLE, debugCaptureGetState());
+}
+
+TEST(DebugCaptureTest, CapturesModesOtherThanDebugMode)
+{
+    debugMode = DEBUG_GYRO_RAW;
+    const uint8_t modes[] = { DEBUG_PIDLOOP, DEBUG_GYRO_RAW };
+    ASSERT_TRUE(debugCaptureStart(modes, 2, 3));
+    EXPECT_EQ(8, debugCaptureCapacity());
+
+    for (int i = 0; i < 3; i++) {
+        DEBUG_SET(DEBUG_PIDLOOP, 1, 10 + i);
+        DEBUG_SET(DEBUG_GYRO_RAW, 3, 20 + i);
+        DEBUG_SET(DEBUG_FFT, 0, 99);
+        debugCaptureSample();
+    }
+
+    // the debug mode is still set as before
+    EXPECT_EQ(22, debug[3]);
+    EXPECT_EQ(0, debug[0]);
+
+    // stops by itself after 3 samples
+    EXPECT_EQ(DEBUG_CAPTURE_STOPPED, debugCaptureGetState());
+    DEBUG_SET(DEBUG_PIDLOOP, 1, 50);
+    debugCaptureSample();
+    EXPECT_EQ(3, debugCaptureSamplesTaken());
+    ASSERT_EQ(3, debugCaptureSamplesHeld());
+    EXPECT_EQ(2, debugCaptureModeCount());
+    EXPECT_EQ(DEBUG_PIDLOOP, debugCaptureMode(0));
+
+    for (int i = 0; i < 3; i++) {
+        const int16_t *sample = debugCaptureGetSample(i);
+        ASSERT_NE(nullptr, sample);
+        EXPECT_EQ(10 + i, sample[1]);
+        EXPECT_EQ(20 + i, sample[DEBUG16_VALUE_COUNT + 3]);
+    }
+    EXPECT_EQ(nullptr, debugCaptureGetSample(3));
+}
+
+TEST(DebugCaptureTest, RingKeepsTheLatestSamples)
+{
+    debugMode = DEBUG_NONE;
+    const uint8_t modes[] = { DEBUG_FFT };
+    ASSERT_TRUE(debugCaptureStart(modes, 1, 0));
+    EXPECT_EQ(16, debugCaptureCapacity());
+
+    for (int i = 0; i < 20; i++) {
+        DEBUG_SET(DEBUG_FFT, 0, i);
+        debugCaptureSample();
+    }
+    EXPECT_EQ(DEBUG_CAPTURE_RUNNING, debugCaptureGetState());
+    // not readable while running
+    EXPECT_EQ(nullptr, debugCaptureGetSample(0));
+
+    debugCaptureStop();
+    EXPECT_EQ(20, debugCaptureSamplesTaken());
+    ASSERT_EQ(16, debugCaptureSamplesHeld());
+    for (int i = 0; i < 16; i++) {
+        EXPECT_EQ(4 + i, debugCaptureGetSample(i)[0]);
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "fc/direct_setpoint.h"
+    #include "fc/rc_modes.h"
+
+    #include "pg/pg.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static bool testModeActive;
+static bool testFailsafeActive;
+
+static directSetpoint_t testSetpoint(uint32_t senderTimeUs)
+{
+    directSetpoint_t setpoint = {};
+    setpoint.senderTimeUs = senderTimeUs;
+    setpoint.mode = DIRECT_SETPOINT_RATE;
+    setpoint.axis[0] = 100;
+    setpoint.axis[2] = -50;
+    setpoint.throttle = 1500;
+    return setpoint;
+}
+
+// The state is kept between the tests, they run in order
+TEST(DirectSetpointTest, NotFlownOutsideTheMode)
+{
+    pgResetAll();
+
+    directSetpoint_t setpoint = testSetpoint(1);
+    setpoint.mode = DIRECT_SETPOINT_MODE_COUNT;
+    EXPECT_FALSE(directSetpointReceive(&setpoint, 1000));
+
+    directSetpoint_t flown;
+    EXPECT_FALSE(directSetpointUpdate(&flown, 1000));
+
+    setpoint = testSetpoint(1);
+    EXPECT_TRUE(directSetpointReceive(&setpoint, 1000));
+    EXPECT_FALSE(directSetpointUpdate(&flown, 1100));
+    EXPECT_FALSE(directSetpointIsActive());
+    EXPECT_EQ(1, directSetpointGetStats()->received);
+    EXPECT_EQ(0, directSetpointGetStats()->flown);
+}
+
+TEST(DirectSetpointTest, FlownWithLatency)
+{
+    testModeActive = true;
+
+    directSetpoint_t setpoint = testSetpoint(2);
+    directSetpointReceive(&setpoint, 2000);
+
+    directSetpoint_t flown;
+    ASSERT_TRUE(directSetpointUpdate(&flown, 2300));
+    EXPECT_TRUE(directSetpointIsActive());
+    EXPECT_EQ(100, flown.axis[0]);
+    EXPECT_EQ(-50, flown.axis[2]);
+    EXPECT_EQ(1500, flown.throttle);
+
+    // flown again by the next loops, the latency only counts once
+    ASSERT_TRUE(directSetpointUpdate(&flown, 2400));
+
+    setpoint = testSetpoint(3);
+    directSetpointReceive(&setpoint, 3000);
+    ASSERT_TRUE(directSetpointUpdate(&flown, 3100));
+
+    const directSetpointStats_t *stats = directSetpointGetStats();
+    EXPECT_EQ(3, stats->received);
+    EXPECT_EQ(2, stats->flown);
+    EXPECT_EQ(3, stats->lastSenderTimeUs);
+    EXPECT_EQ(100, stats->latencyLastUs);
+    EXPECT_EQ(300, stats->latencyMaxUs);
+    EXPECT_EQ(200, directSetpointLatencyAverageUs());
+}
+
+TEST(DirectSetpointTest, TimeoutFallsBackToTheSticks)
+{
+    directSetpoint_t flown;
+    EXPECT_TRUE(directSetpointUpdate(&flown, 3000 + 100000));
+    EXPECT_FALSE(directSetpointUpdate(&flown, 3000 + 100001));
+    EXPECT_FALSE(directSetpointUpdate(&flown, 3000 + 200000));
+    EXPECT_FALSE(directSetpointIsActive());
+    EXPECT_EQ(1, directSetpointGetStats()->timeouts);
+
+    // the failsafe procedure only starts when configured
+    EXPECT_FALSE(directSetpointFailsafeRequested());
+    directSetpointConfigMutable()->direct_setpoint_failsafe = true;
+    EXPECT_TRUE(directSetpointFailsafeRequested());
+
+    // the failsafe flies until it has recovered, the new setpoints end the request
+    testFailsafeActive = true;
+    directSetpoint_t setpoint = testSetpoint(4);
+    directSetpointReceive(&setpoint, 300000);
+    EXPECT_FALSE(directSetpointUpdate(&flown, 300100));
+    EXPECT_FALSE(directSetpointFailsafeRequested());
+
+    testFailsafeActive = false;
+    EXPECT_TRUE(directSetpointUpdate(&flown, 300200));
+    EXPECT_EQ(4, directSetpointGetStats()->lastSenderTimeUs);
+    EXPECT_EQ(200, directSetpointGetStats()->latencyLastUs);
+}
+
+TEST(DirectSetpointTest, ModeOffEndsTheFailsafeRequest)
+{
+    directSetpoint_t flown;
+    EXPECT_FALSE(directSetpointUpdate(&flown, 500000));
+    EXPECT_TRUE(directSetpointFailsafeRequested());
+
+    testModeActive = false;
+    EXPECT_FALSE(directSetpointUpdate(&flown, 500100));
+    EXPECT_FALSE(directSetpointFailsafeRequested());
+    EXPECT_EQ(2, directSetpointGetStats()->timeouts);
+}
+
+// STUBS
+
+extern "C" {
+    bool IS_RC_MODE_ACTIVE(boxId_e) { return testModeActive; }
+    bool failsafeIsActive(void) { return testFailsafeActive; }
+}
@@ -0,0 +1,147 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "io/displayport_framebuffer.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static displayPortFramebuffer_t fb;
+
+static void syncAll(void)
+{
+    displayPortFramebufferClearSent(&fb);
+    displayPortFramebufferRun_t run;
+    while (displayPortFramebufferNextRun(&fb, &run, 30, 10)) {
+        displayPortFramebufferRunSent(&fb, &run);
+    }
+}
+
+TEST(DisplayPortFramebufferTest, NewScreenIsClearedAndBlank)
+{
+    displayPortFramebufferInit(&fb, 13, 30);
+
+    // a blank screen only needs the clear
+    EXPECT_FALSE(displayPortFramebufferIsSynced(&fb));
+    EXPECT_TRUE(fb.clearPending);
+
+    syncAll();
+    EXPECT_TRUE(displayPortFramebufferIsSynced(&fb));
+}
+
+TEST(DisplayPortFramebufferTest, UnchangedWritesSendNothing)
+{
+    displayPortFramebufferInit(&fb, 13, 30);
+    displayPortFramebufferWrite(&fb, 2, 3, "HELLO");
+    syncAll();
+
+    // a frame that clears and writes the same text again
+    displayPortFramebufferClear(&fb);
+    displayPortFramebufferWrite(&fb, 2, 3, "HELLO");
+
+    displayPortFramebufferRun_t run;
+    EXPECT_FALSE(displayPortFramebufferNextRun(&fb, &run, 30, 10));
+    EXPECT_TRUE(displayPortFramebufferIsSynced(&fb));
+}
+
+TEST(DisplayPortFramebufferTest, RunCoversOnlyTheChangedCharacters)
+{
+    displayPortFramebufferInit(&fb, 13, 30);
+    displayPortFramebufferWrite(&fb, 0, 5, "ALT 100M");
+    syncAll();
+
+    displayPortFramebufferWrite(&fb, 0, 5, "ALT 105M");
+
+    displayPortFramebufferRun_t run;
+    EXPECT_TRUE(displayPortFramebufferNextRun(&fb, &run, 30, 10));
+    EXPECT_EQ(5, run.row);
+    EXPECT_EQ(6, run.col);
+    EXPECT_EQ(1, run.len);
+    EXPECT_EQ('5', run.text[0]);
+
+    // the run is sent again until it is marked as sent
+    EXPECT_TRUE(displayPortFramebufferNextRun(&fb, &run, 30, 10));
+    displayPortFramebufferRunSent(&fb, &run);
+    EXPECT_FALSE(displayPortFramebufferNextRun(&fb, &run, 30, 10));
+}
+
+TEST(DisplayPortFramebufferTest, SmallGapsAreMergedIntoOneRun)
+{
+    displayPortFramebufferInit(&fb, 13, 30);
+    syncAll();
+
+    displayPortFramebufferWrite(&fb, 0, 0, "A");
+    displayPortFramebufferWrite(&fb, 4, 0, "B");
+    displayPortFramebufferWrite(&fb, 20, 0, "C");
+
+    displayPortFramebufferRun_t run;
+    EXPECT_TRUE(displayPortFramebufferNextRun(&fb, &run, 30, 10));
+    EXPECT_EQ(0, run.col);
+    EXPECT_EQ(5, run.len);
+    displayPortFramebufferRunSent(&fb, &run);
+
+    EXPECT_TRUE(displayPortFramebufferNextRun(&fb, &run, 30, 10));
+    EXPECT_EQ(20, run.col);
+    EXPECT_EQ(1, run.len);
+    displayPortFramebufferRunSent(&fb, &run);
+
+    EXPECT_FALSE(displayPortFramebufferNextRun(&fb, &run, 30, 10));
+}
+
+TEST(DisplayPortFramebufferTest, RunIsLimitedToTheMaximumLength)
+{
+    displayPortFramebufferInit(&fb, 13, 30);
+    syncAll();
+
+    displayPortFramebufferWrite(&fb, 0, 1, "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789");
+
+    displayPortFramebufferRun_t run;
+    EXPECT_TRUE(displayPortFramebufferNextRun(&fb, &run, 16, 10));
+    EXPECT_EQ(0, run.col);
+    EXPECT_EQ(16, run.len);
+    displayPortFramebufferRunSent(&fb, &run);
+
+    // the write was truncated at the end of the row
+    EXPECT_TRUE(displayPortFramebufferNextRun(&fb, &run, 16, 10));
+    EXPECT_EQ(16, run.col);
+    EXPECT_EQ(14, run.len);
+}
+
+TEST(DisplayPortFramebufferTest, InvalidateSendsTheWholeScreenAgain)
+{
+    displayPortFramebufferInit(&fb, 13, 30);
+    displayPortFramebufferWrite(&fb, 1, 12, "END");
+    syncAll();
+
+    displayPortFramebufferInvalidate(&fb);
+    EXPECT_TRUE(fb.clearPending);
+
+    displayPortFramebufferClearSent(&fb);
+    displayPortFramebufferRun_t run;
+    EXPECT_TRUE(displayPortFramebufferNextRun(&fb, &run, 30, 10));
+    EXPECT_EQ(12, run.row);
+    EXPECT_EQ(1, run.col);
+    EXPECT_EQ(3, run.len);
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "sensors/esc_stats.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define WINDOW_US (ESC_STATS_WINDOW_MS * 1000)
+
+TEST(EscStatsTest, WindowIsPublished)
+{
+    escStatsUpdate(WINDOW_US);
+
+    escStatsAddSample(0, ESC_STATS_TEMPERATURE, 40);
+    escStatsAddSample(0, ESC_STATS_TEMPERATURE, 50);
+    escStatsAddSample(0, ESC_STATS_TEMPERATURE, 60);
+    escStatsAddSample(1, ESC_STATS_TEMPERATURE, 70);
+    escStatsAddSample(1, ESC_STATS_CURRENT, 1500);
+
+    // nothing is published before the window ends
+    escStatsUpdate(WINDOW_US + WINDOW_US / 2);
+    EXPECT_FALSE(escStatsIsValid(getEscStats(0), ESC_STATS_TEMPERATURE));
+
+    escStatsUpdate(2 * WINDOW_US);
+    const escStats_t *stats = getEscStats(0);
+    ASSERT_TRUE(escStatsIsValid(stats, ESC_STATS_TEMPERATURE));
+    EXPECT_FALSE(escStatsIsValid(stats, ESC_STATS_CURRENT));
+    EXPECT_EQ(40, stats->values[ESC_STATS_TEMPERATURE].min);
+    EXPECT_EQ(60, stats->values[ESC_STATS_TEMPERATURE].max);
+    EXPECT_EQ(50, stats->values[ESC_STATS_TEMPERATURE].avg);
+
+    const escStats_t *combined = getEscStats(ESC_STATS_COMBINED);
+    ASSERT_TRUE(escStatsIsValid(combined, ESC_STATS_TEMPERATURE));
+    ASSERT_TRUE(escStatsIsValid(combined, ESC_STATS_CURRENT));
+    EXPECT_EQ(40, combined->values[ESC_STATS_TEMPERATURE].min);
+    EXPECT_EQ(70, combined->values[ESC_STATS_TEMPERATURE].max);
+    EXPECT_EQ(60, combined->values[ESC_STATS_TEMPERATURE].avg);
+    EXPECT_EQ(1500, combined->values[ESC_STATS_CURRENT].max);
+
+    // an empty window clears the statistics
+    escStatsUpdate(3 * WINDOW_US);
+    EXPECT_FALSE(escStatsIsValid(getEscStats(0), ESC_STATS_TEMPERATURE));
+    EXPECT_FALSE(escStatsIsValid(getEscStats(ESC_STATS_COMBINED), ESC_STATS_TEMPERATURE));
+}
+
+TEST(EscStatsTest, MotorOutOfRange)
+{
+    EXPECT_EQ(NULL, getEscStats(4));
+    EXPECT_FALSE(escStatsIsValid(NULL, ESC_STATS_ERPM));
+}
+
+// STUBS
+
+extern "C" {
+
+uint8_t getMotorCount(void) { return 4; }
+
+}
@@ -0,0 +1,335 @@
+/*
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "drivers/flash.h"
+
+    #include "io/flashfs.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define FLASH_SECTOR_SIZE 4096
+#define FLASH_SECTORS 4
+static uint8_t flashData[FLASH_SECTORS * FLASH_SECTOR_SIZE];
+static uint32_t programAddress;
+static bool flashBusy;
+static int eraseSectorCount;
+static uint32_t programStart;
+static int programContinueCount;
+
+// The program operations of the flash, as the address range and the number of buffers each was made of
+typedef struct programOperation_s {
+    uint32_t start;
+    uint32_t end;
+    int bufferCount;
+} programOperation_t;
+
+static programOperation_t programOperations[64];
+static int programOperationCount;
+
+static flashGeometry_t flashGeometry = {
+    .sectors = FLASH_SECTORS,
+    .pageSize = 256,
+    .sectorSize = FLASH_SECTOR_SIZE,
+    .totalSize = FLASH_SECTORS * FLASH_SECTOR_SIZE,
+    .pagesPerSector = FLASH_SECTOR_SIZE / 256,
+    .flashType = FLASH_TYPE_NOR,
+};
+
+static void writeLog(uint32_t length, uint32_t armTime)
+{
+    const uint32_t start = flashfsGetOffset();
+    for (uint32_t i = 0; i < length; i++) {
+        flashfsWriteByte(i);
+    }
+    flashfsFlushSync();
+
+    const flashfsLogIndexEntry_t entry = {
+        .start = start,
+        .size = length,
+        .armTime = armTime,
+        .duration = 10,
+        .magic = 0,
+    };
+    EXPECT_TRUE(flashfsLogIndexAppend(&entry));
+}
+
+TEST(FlashfsTest, LogIndexTakesTheLastSector)
+{
+    memset(flashData, 0xFF, sizeof(flashData));
+    flashfsInit();
+
+    EXPECT_EQ((uint32_t)(FLASH_SECTORS - 1) * FLASH_SECTOR_SIZE, flashfsGetSize());
+    EXPECT_EQ(0, flashfsLogIndexCount());
+}
+
+TEST(FlashfsTest, LogIndexIsFoundAgain)
+{
+    memset(flashData, 0xFF, sizeof(flashData));
+    flashfsInit();
+
+    writeLog(300, 1000);
+    writeLog(2000, 2000);
+    writeLog(100, 3000);
+    EXPECT_EQ(3, flashfsLogIndexCount());
+
+    // After a restart
+    flashfsInit();
+    EXPECT_EQ(3, flashfsLogIndexCount());
+
+    flashfsLogIndexEntry_t entry;
+    EXPECT_TRUE(flashfsLogIndexRead(1, &entry));
+    EXPECT_EQ(300u, entry.start);
+    EXPECT_EQ(2000u, entry.size);
+    EXPECT_EQ(2000u, entry.armTime);
+    EXPECT_EQ(10, entry.duration);
+    EXPECT_EQ(FLASHFS_LOG_INDEX_ENTRY_MAGIC, entry.magic);
+    EXPECT_FALSE(flashfsLogIndexRead(3, &entry));
+
+    // and the logs continue in the free block after the last one
+    EXPECT_EQ(4096u, flashfsGetOffset());
+}
+
+TEST(FlashfsTest, LogIndexSectorWithOtherData)
+{
+    // Logs of a firmware without the index fill the whole flash
+    memset(flashData, 0x55, sizeof(flashData));
+    flashfsInit();
+
+    EXPECT_EQ(0, flashfsLogIndexCount());
+    const flashfsLogIndexEntry_t entry = { 0, 0, 0, 0, 0 };
+    EXPECT_FALSE(flashfsLogIndexAppend(&entry));
+
+    // Until the flash is erased
+    flashfsEraseCompletely();
+    EXPECT_TRUE(flashfsLogIndexAppend(&entry));
+    EXPECT_EQ(1, flashfsLogIndexCount());
+}
+
+TEST(FlashfsTest, AsyncWritesProgramWholePages)
+{
+    memset(flashData, 0xFF, sizeof(flashData));
+    flashfsInit();
+
+    // Some writes unaligned with the pages, at the pace of a blackbox log
+    uint8_t frame[100];
+    uint8_t value = 0;
+    programOperationCount = 0;
+    for (int i = 0; i < 30; i++) {
+        for (unsigned j = 0; j < sizeof(frame); j++) {
+            frame[j] = value++;
+        }
+        flashfsWrite(frame, sizeof(frame), false);
+        flashfsFlushAsync(false);
+    }
+
+    EXPECT_EQ(11, programOperationCount);
+    for (int i = 0; i < programOperationCount; i++) {
+        EXPECT_EQ(i * 256u, programOperations[i].start);
+        EXPECT_EQ((i + 1) * 256u, programOperations[i].end);
+        EXPECT_EQ(1, programOperations[i].bufferCount);
+    }
+
+    // The rest of the page only when forced
+    EXPECT_TRUE(flashfsFlushAsync(true));
+    EXPECT_EQ(12, programOperationCount);
+    EXPECT_EQ(3000u, programOperations[11].end);
+    EXPECT_EQ(3000u, flashfsGetOffset());
+
+    for (int i = 0; i < 3000; i++) {
+        EXPECT_EQ((uint8_t)i, flashData[i]);
+    }
+}
+
+TEST(FlashfsTest, EraseRangeRunsInTheBackground)
+{
+    memset(flashData, 0x00, sizeof(flashData));
+    flashBusy = false;
+    flashfsInit();
+
+    // Nothing is issued while the flash is busy
+    flashBusy = true;
+    eraseSectorCount = 0;
+    flashfsEraseRange(0, 2 * FLASH_SECTOR_SIZE);
+    EXPECT_EQ(0, eraseSectorCount);
+    EXPECT_FALSE(flashfsIsReady());
+
+    // Then a sector each time the flash is idle
+    flashBusy = false;
+    EXPECT_FALSE(flashfsIsReady());
+    EXPECT_EQ(1, eraseSectorCount);
+    EXPECT_FALSE(flashfsIsReady());
+    EXPECT_EQ(1, eraseSectorCount);
+
+    flashBusy = false;
+    EXPECT_FALSE(flashfsIsReady());
+    EXPECT_EQ(2, eraseSectorCount);
+
+    flashBusy = false;
+    EXPECT_TRUE(flashfsIsReady());
+    EXPECT_EQ(2, eraseSectorCount);
+    EXPECT_EQ(0xFF, flashData[2 * FLASH_SECTOR_SIZE - 1]);
+    EXPECT_EQ(0x00, flashData[2 * FLASH_SECTOR_SIZE]);
+}
+
+TEST(FlashfsTest, IncrementalEraseResumesAfterARestart)
+{
+    memset(flashData, 0xFF, sizeof(flashData));
+    flashBusy = false;
+    flashfsInit();
+    writeLog(10000, 1000);
+
+    // The logs are gone right away, the log index is erased first
+    flashfsEraseIncrementally();
+    EXPECT_EQ(0u, flashfsGetOffset());
+    EXPECT_EQ(0, flashfsLogIndexCount());
+    EXPECT_EQ(3u * FLASH_SECTOR_SIZE, flashfsGetEraseAheadRemaining());
+    EXPECT_TRUE(flashfsIsEOF());
+    EXPECT_FALSE(flashfsEraseAheadUpdate());
+    EXPECT_EQ(3u * FLASH_SECTOR_SIZE, flashfsGetEraseAheadRemaining());
+
+    // A new log fits in the sector erased ahead of it
+    flashBusy = false;
+    EXPECT_FALSE(flashfsEraseAheadUpdate());
+    EXPECT_EQ(2u * FLASH_SECTOR_SIZE, flashfsGetEraseAheadRemaining());
+    EXPECT_FALSE(flashfsIsEOF());
+    writeLog(100, 2000);
+
+    // After a restart
+    flashBusy = false;
+    flashfsInit();
+    EXPECT_EQ(2u * FLASH_SECTOR_SIZE, flashfsGetEraseAheadRemaining());
+    EXPECT_EQ(2048u, flashfsGetOffset());
+    EXPECT_EQ(1, flashfsLogIndexCount());
+
+    flashBusy = false;
+    EXPECT_FALSE(flashfsEraseAheadUpdate());
+    flashBusy = false;
+    EXPECT_TRUE(flashfsEraseAheadUpdate());
+    EXPECT_EQ(0u, flashfsGetEraseAheadRemaining());
+    for (int i = FLASH_SECTOR_SIZE; i < 3 * FLASH_SECTOR_SIZE; i++) {
+        EXPECT_EQ(0xFF, flashData[i]);
+    }
+    EXPECT_EQ(99, flashData[99]);
+}
+
+TEST(FlashfsTest, NandIsErasedBlockByBlock)
+{
+    flashGeometry.flashType = FLASH_TYPE_NAND;
+    memset(flashData, 0x00, sizeof(flashData));
+    flashBusy = false;
+    flashfsInit();
+    EXPECT_EQ((uint32_t)FLASH_SECTORS * FLASH_SECTOR_SIZE, flashfsGetSize());
+
+    // There is no chip erase, the sectors are erased in the background
+    eraseSectorCount = 0;
+    flashfsEraseCompletely();
+    EXPECT_EQ(1, eraseSectorCount);
+    for (int i = 1; i < FLASH_SECTORS; i++) {
+        flashBusy = false;
+        EXPECT_FALSE(flashfsIsReady());
+        EXPECT_EQ(i + 1, eraseSectorCount);
+    }
+
+    flashBusy = false;
+    EXPECT_TRUE(flashfsIsReady());
+    EXPECT_EQ(FLASH_SECTORS, eraseSectorCount);
+    for (unsigned i = 0; i < sizeof(flashData); i++) {
+        EXPECT_EQ(0xFF, flashData[i]);
+    }
+
+    flashGeometry.flashType = FLASH_TYPE_NOR;
+}
+
+// STUBS
+extern "C" {
+bool flashIsReady(void)
+{
+    return !flashBusy;
+}
+
+bool flashWaitForReady(uint32_t timeoutMillis)
+{
+    UNUSED(timeoutMillis);
+    return true;
+}
+
+void flashEraseSector(uint32_t address)
+{
+    memset(&flashData[address], 0xFF, FLASH_SECTOR_SIZE);
+    eraseSectorCount++;
+    flashBusy = true;
+}
+
+void flashEraseCompletely(void)
+{
+    memset(flashData, 0xFF, sizeof(flashData));
+}
+
+void flashPageProgramBegin(uint32_t address)
+{
+    programAddress = programStart = address;
+    programContinueCount = 0;
+}
+
+void flashPageProgramContinue(const uint8_t *data, int length)
+{
+    // Programming only clears bits
+    for (int i = 0; i < length; i++) {
+        flashData[programAddress++] &= data[i];
+    }
+    programContinueCount++;
+}
+
+void flashPageProgramFinish(void)
+{
+    if (programOperationCount < (int)ARRAYLEN(programOperations)) {
+        programOperations[programOperationCount++] = { programStart, programAddress, programContinueCount };
+    }
+}
+
+void flashPageProgram(uint32_t address, const uint8_t *data, int length)
+{
+    flashPageProgramBegin(address);
+    flashPageProgramContinue(data, length);
+    flashPageProgramFinish();
+}
+
+int flashReadBytes(uint32_t address, uint8_t *buffer, int length)
+{
+    memcpy(buffer, &flashData[address], length);
+    return length;
+}
+
+void flashFlush(void)
+{
+}
+
+const flashGeometry_t *flashGetGeometry(void)
+{
+    return &flashGeometry;
+}
+}
@@ -43,6 +43,7 @@ extern "C" {
     #include "flight/mixer.h"
     #include "flight/pid.h"
     #include "flight/imu.h"
+    #include "flight/position.h"
 
     #include "io/gps.h"
 
@@ -56,9 +57,13 @@ extern "C" {
 
     void imuComputeRotationMatrix(void);
     void imuUpdateEulerAngles(void);
+    void imuUpdateSmallAngleState(void);
+    void updateAltitudeEstimate(int32_t measuredAltitude, float dT, bool resetAltitude);
 
     extern quaternion q;
+    extern attitudeEulerAngles_t attitude;
     extern float rMat[3][3];
+    extern uint32_t simulatedSensors;
 
     PG_REGISTER(rcControlsConfig_t, rcControlsConfig, PG_RC_CONTROLS_CONFIG, 0);
     PG_REGISTER(barometerConfig_t, barometerConfig, PG_BAROMETER_CONFIG, 0);
@@ -169,7 +174,7 @@ TEST(FlightImuTest, TestSmallAngle)
     memset(rMat, 0.0, sizeof(float) * 9);
 
     // when
-    imuUpdateEulerAngles();
+    imuUpdateSmallAngleState();
 
     // expect
     EXPECT_EQ(0, STATE(SMALL_ANGLE));
@@ -181,7 +186,7 @@ TEST(FlightImuTest, TestSmallAngle)
     rMat[2][2] = r1;
 
     // when
-    imuUpdateEulerAngles();
+    imuUpdateSmallAngleState();
 
     // expect
     EXPECT_EQ(SMALL_ANGLE, STATE(SMALL_ANGLE));
@@ -190,12 +195,89 @@ TEST(FlightImuTest, TestSmallAngle)
     memset(rMat, 0.0, sizeof(float) * 9);
 
     // when
-    imuUpdateEulerAngles();
+    imuUpdateSmallAngleState();
 
     // expect
     EXPECT_EQ(0, STATE(SMALL_ANGLE));
 }
 
+TEST(FlightImuTest, TestPropagateAttitude)
+{
+    // given
+    imuConfigMutable()->small_angle = 25;
+    imuConfigure(0, 0);
+    q.w = 1.0f;
+    q.x = 0.0f;
+    q.y = 0.0f;
+    q.z = 0.0f;
+    imuComputeRotationMatrix();
+    imuUpdateEulerAngles();
+    simulatedSensors = SENSOR_ACC;
+    acc.isAccelUpdatedAtLeastOnce = true;
+    gyro.gyroADCf[X] = 45.0f;
+    gyro.gyroADCf[Y] = 0.0f;
+    gyro.gyroADCf[Z] = 0.0f;
+
+    // when rolling at 45 deg/s for one second without a level mode
+    for (int i = 0; i < 1000; i++) {
+        imuPropagateAttitude(1000);
+    }
+
+    // expect the quaternion to follow, with the Euler angles only computed when they are read
+    EXPECT_NEAR(cosf(DEGREES_TO_RADIANS(45.0f) / 2), q.w, 1e-3f);
+    EXPECT_NEAR(sinf(DEGREES_TO_RADIANS(45.0f) / 2), q.x, 1e-3f);
+    EXPECT_EQ(0, attitude.values.roll);
+    EXPECT_NEAR(450, getAttitude()->values.roll, 2);
+    EXPECT_EQ(0, getAttitude()->values.pitch);
+    EXPECT_NEAR(cosf(DEGREES_TO_RADIANS(45.0f)), getCosTiltAngle(), 1e-3f);
+
+    // cleanup
+    simulatedSensors = 0;
+    memset(&gyro, 0, sizeof(gyro));
+    memset(&acc, 0, sizeof(acc));
+}
+
+TEST(FlightImuTest, TestAltitudeEstimate)
+{
+    // given
+    const float dT = 0.025f;
+    accVelScale = 1e-4f;    // 1 m/s/s per unit
+    imuResetAccelerationSum();
+
+    // when first updated
+    updateAltitudeEstimate(100, dT, false);
+
+    // expect the measurement
+    EXPECT_EQ(100, getEstimatedAltitude());
+    EXPECT_EQ(0, getEstimatedVario());
+
+    // when climbing at a steady 1 m/s for 20 s
+    for (int i = 1; i <= 800; i++) {
+        updateAltitudeEstimate(100 + 100 * i * dT, dT, false);
+    }
+
+    // expect the estimate to track the climb
+    EXPECT_NEAR(2100, getEstimatedAltitude(), 5);
+    EXPECT_NEAR(100, getEstimatedVario(), 2);
+
+    // when accelerating upwards at 10 m/s/s for one update
+    accSum[Z] = 10;
+    accSumCount = 1;
+    accTimeSum = dT * 1e6f;
+    updateAltitudeEstimate(2100 + 100 * dT, dT, false);
+
+    // expect the vario to follow without waiting for the measurement
+    EXPECT_NEAR(125, getEstimatedVario(), 2);
+    EXPECT_EQ(0, accSumCount);
+
+    // when the altitude reference changes
+    updateAltitudeEstimate(0, dT, true);
+
+    // expect the altitude to restart from the measurement, keeping the vario
+    EXPECT_EQ(0, getEstimatedAltitude());
+    EXPECT_NEAR(125, getEstimatedVario(), 2);
+}
+
 // STUBS
 
 extern "C" {
@@ -228,10 +310,11 @@ uint16_t disableFlightMode(flightModeFlags_e mask)
     return flightModeFlags &= ~(mask);
 }
 
+uint32_t simulatedSensors;
+
 bool sensors(uint32_t mask)
 {
-    UNUSED(mask);
-    return false;
+    return simulatedSensors & mask;
 };
 
 uint32_t millis(void) { return 0; }
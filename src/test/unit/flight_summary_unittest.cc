@@ -0,0 +1,192 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "config/feature.h"
+
+    #include "fc/flight_summary.h"
+    #include "fc/runtime_config.h"
+
+    #include "pg/pg.h"
+
+    #include "scheduler/scheduler.h"
+
+    #include "sensors/gyro.h"
+
+    gyro_t gyro;
+    uint8_t armingFlags;
+    uint16_t averageSystemLoadPercent;
+
+    static float prefilteredRate[XYZ_AXIS_COUNT];
+    static bool outputSaturated;
+    static timeDelta_t gyroTaskDeltaUs;
+    static timeUs_t currentTimeUs;
+    static int eepromWrites;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Runs a flight of the given loops with a square wave at the loop rate on every axis, about 0 deg/s
+static void fly(int loops, float prefilteredAmplitude, float filteredAmplitude)
+{
+    flightSummaryStart();
+    for (int i = 0; i < loops; i++) {
+        const float sign = (i & 1) ? -1.0f : 1.0f;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            prefilteredRate[axis] = sign * prefilteredAmplitude;
+            gyro.gyroADCf[axis] = sign * filteredAmplitude;
+        }
+        flightSummaryUpdate();
+        currentTimeUs += gyro.targetLooptime;
+    }
+    flightSummaryFinish(currentTimeUs);
+}
+
+static void resetFlightSummary(void)
+{
+    pgResetAll();
+    gyro.targetLooptime = 125;
+    outputSaturated = false;
+    gyroTaskDeltaUs = 125;
+    averageSystemLoadPercent = 0;
+    eepromWrites = 0;
+    armingFlags = 0;
+}
+
+TEST(FlightSummaryUnittest, NoFlights)
+{
+    resetFlightSummary();
+
+    EXPECT_EQ(0, flightSummaryCount());
+    EXPECT_EQ(nullptr, flightSummaryGet(0));
+}
+
+TEST(FlightSummaryUnittest, NoiseBeforeAndAfterTheFilters)
+{
+    resetFlightSummary();
+
+    fly(8000 * 3, 20.0f, 5.0f);
+
+    ASSERT_EQ(1, flightSummaryCount());
+    const flightSummary_t *summary = flightSummaryGet(0);
+    EXPECT_EQ(1, summary->flightNumber);
+    EXPECT_EQ(3, summary->durationS);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        // the motion lowpass removes almost nothing at the loop rate
+        EXPECT_NEAR(200, summary->gyroNoisePrefilteredRms[axis], 2);
+        EXPECT_NEAR(50, summary->gyroNoiseFilteredRms[axis], 1);
+    }
+    EXPECT_EQ(0, summary->motorSaturationPermille);
+    EXPECT_EQ(0, summary->loopOverruns);
+    EXPECT_EQ(0, summary->dynNotchMinHz);
+    EXPECT_EQ(0, summary->dynNotchMaxHz);
+}
+
+TEST(FlightSummaryUnittest, SaturationOverrunsAndLoad)
+{
+    resetFlightSummary();
+
+    outputSaturated = true;
+    gyroTaskDeltaUs = 251;
+    averageSystemLoadPercent = 37;
+    fly(2000, 0, 0);
+
+    const flightSummary_t *summary = flightSummaryGet(0);
+    EXPECT_EQ(1000, summary->motorSaturationPermille);
+    EXPECT_EQ(2000, summary->loopOverruns);
+    EXPECT_EQ(37, summary->maxLoadPercent);
+    EXPECT_EQ(0, summary->gyroNoisePrefilteredRms[FD_ROLL]);
+
+    // a loop one looptime late is not an overrun
+    gyroTaskDeltaUs = 250;
+    fly(100, 0, 0);
+    EXPECT_EQ(0, flightSummaryGet(0)->loopOverruns);
+}
+
+TEST(FlightSummaryUnittest, LogKeepsTheNewestFlights)
+{
+    resetFlightSummary();
+
+    for (int flight = 1; flight <= FLIGHT_SUMMARY_COUNT + 2; flight++) {
+        fly(8000 * flight, 0, 0);
+    }
+
+    ASSERT_EQ(FLIGHT_SUMMARY_COUNT, flightSummaryCount());
+    for (int i = 0; i < FLIGHT_SUMMARY_COUNT; i++) {
+        EXPECT_EQ((uint32_t)(FLIGHT_SUMMARY_COUNT + 2 - i), flightSummaryGet(i)->flightNumber);
+        EXPECT_EQ(FLIGHT_SUMMARY_COUNT + 2 - i, flightSummaryGet(i)->durationS);
+    }
+    EXPECT_EQ(nullptr, flightSummaryGet(FLIGHT_SUMMARY_COUNT));
+
+    flightSummaryClear();
+    EXPECT_EQ(0, flightSummaryCount());
+}
+
+TEST(FlightSummaryUnittest, FlightWithoutLoopsIsNotLogged)
+{
+    resetFlightSummary();
+
+    flightSummaryStart();
+    flightSummaryFinish(currentTimeUs);
+    EXPECT_EQ(0, flightSummaryCount());
+
+    // finishing without a start is ignored too
+    fly(10, 0, 0);
+    flightSummaryFinish(currentTimeUs);
+    EXPECT_EQ(1, flightSummaryCount());
+}
+
+TEST(FlightSummaryUnittest, SavedOnceDisarmedWhenEnabled)
+{
+    resetFlightSummary();
+
+    fly(10, 0, 0);
+    flightSummarySaveIfPending();
+    EXPECT_EQ(0, eepromWrites);
+
+    flightSummaryConfigMutable()->flight_summary_save = true;
+    fly(10, 0, 0);
+    armingFlags = ARMED;
+    flightSummarySaveIfPending();
+    EXPECT_EQ(0, eepromWrites);
+
+    armingFlags = 0;
+    flightSummarySaveIfPending();
+    flightSummarySaveIfPending();
+    EXPECT_EQ(1, eepromWrites);
+}
+
+// STUBS
+
+extern "C" {
+    float gyroGetPrefilteredRate(int axis) { return prefilteredRate[axis]; }
+    bool mixerIsOutputSaturated(int, float) { return outputSaturated; }
+    timeDelta_t getTaskDeltaTime(cfTaskId_e) { return gyroTaskDeltaUs; }
+    bool feature(uint32_t) { return false; }
+    void writeEEPROM(void) { eepromWrites++; }
+    timeUs_t micros(void) { return currentTimeUs; }
+}
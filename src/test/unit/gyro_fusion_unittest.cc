@@ -0,0 +1,125 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "sensors/gyro_fusion.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// 1kHz, so the 100ms noise window is 100 samples
+#define LOOPTIME_US 1000
+
+static gyroFusion_t fusion;
+static const bool bothValid[GYRO_FUSION_SENSOR_COUNT] = { true, true };
+
+// alternates each sensor about a common rate with its own noise amplitude
+static void applyNoisySamples(int count, float rate, float noise1, float noise2, float *fused)
+{
+    for (int i = 0; i < count; i++) {
+        const float sign = (i & 1) ? 1.0f : -1.0f;
+        float samples[GYRO_FUSION_SENSOR_COUNT][XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            samples[0][axis] = rate + sign * noise1;
+            samples[1][axis] = rate + sign * noise2;
+        }
+        gyroFusionApply(&fusion, samples, bothValid, fused);
+    }
+}
+
+TEST(GyroFusionUnittest, TestEqualWeightsInitially)
+{
+    gyroFusionInit(&fusion, LOOPTIME_US);
+    const float samples[GYRO_FUSION_SENSOR_COUNT][XYZ_AXIS_COUNT] = { { 10, 20, 30 }, { 20, 40, 60 } };
+    float fused[XYZ_AXIS_COUNT];
+    gyroFusionApply(&fusion, samples, bothValid, fused);
+    EXPECT_FLOAT_EQ(15, fused[X]);
+    EXPECT_FLOAT_EQ(30, fused[Y]);
+    EXPECT_FLOAT_EQ(45, fused[Z]);
+}
+
+TEST(GyroFusionUnittest, TestInverseVarianceWeights)
+{
+    gyroFusionInit(&fusion, LOOPTIME_US);
+    float fused[XYZ_AXIS_COUNT];
+    // sensor 2 has twice the noise amplitude, so four times the variance
+    applyNoisySamples(100, 0, 1, 2, fused);
+    EXPECT_NEAR(0.8f, fusion.weight[X], 1e-3f);
+    EXPECT_NEAR(0.8f, fusion.weight[Z], 1e-3f);
+    EXPECT_EQ(GYRO_FUSION_NO_SENSOR, fusion.rejectedSensor);
+}
+
+TEST(GyroFusionUnittest, TestInvalidSampleIgnored)
+{
+    gyroFusionInit(&fusion, LOOPTIME_US);
+    const float samples[GYRO_FUSION_SENSOR_COUNT][XYZ_AXIS_COUNT] = { { 10, 20, 30 }, { 2000, 2000, 2000 } };
+    const bool sampleValid[GYRO_FUSION_SENSOR_COUNT] = { true, false };
+    float fused[XYZ_AXIS_COUNT];
+    gyroFusionApply(&fusion, samples, sampleValid, fused);
+    EXPECT_FLOAT_EQ(10, fused[X]);
+    EXPECT_FLOAT_EQ(30, fused[Z]);
+}
+
+TEST(GyroFusionUnittest, TestDivergentSensorRejected)
+{
+    gyroFusionInit(&fusion, LOOPTIME_US);
+    float fused[XYZ_AXIS_COUNT];
+    // sensor 1 is the noisier, so it is the one rejected
+    applyNoisySamples(100, 0, 2, 1, fused);
+
+    // disagree for less than the 10ms needed for rejection
+    float samples[GYRO_FUSION_SENSOR_COUNT][XYZ_AXIS_COUNT] = { { 500, 500, 500 }, { 0, 0, 0 } };
+    for (int i = 0; i < 9; i++) {
+        samples[1][X] = (i & 1) ? 1.0f : -1.0f;
+        gyroFusionApply(&fusion, samples, bothValid, fused);
+    }
+    EXPECT_EQ(GYRO_FUSION_NO_SENSOR, fusion.rejectedSensor);
+
+    samples[1][X] = 0;
+    gyroFusionApply(&fusion, samples, bothValid, fused);
+    EXPECT_EQ(0, fusion.rejectedSensor);
+    EXPECT_FLOAT_EQ(0, fused[X]);
+
+    // recovers after agreeing for 200ms
+    applyNoisySamples(199, 0, 2, 1, fused);
+    EXPECT_EQ(0, fusion.rejectedSensor);
+    applyNoisySamples(1, 0, 2, 1, fused);
+    EXPECT_EQ(GYRO_FUSION_NO_SENSOR, fusion.rejectedSensor);
+}
+
+TEST(GyroFusionUnittest, TestStuckSensorRejected)
+{
+    gyroFusionInit(&fusion, LOOPTIME_US);
+    float fused[XYZ_AXIS_COUNT];
+    // sensor 2 outputs a constant value
+    applyNoisySamples(100, 0, 1, 0, fused);
+    EXPECT_EQ(1, fusion.rejectedSensor);
+    applyNoisySamples(1, 5, 1, 0, fused);
+    EXPECT_FLOAT_EQ(5 - 1, fused[Y]);
+}
@@ -0,0 +1,136 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/accgyro/accgyro.h"
+    #include "drivers/accgyro/gyro_sync.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define NOMINAL_PERIOD_US   125.0f
+
+static gyroDev_t gyroDev;
+
+// The data ready interrupts of a gyro whose clock runs at periodUs of the MCU clock, with some interrupt latency
+static float dataReadyAtUs;
+
+static void initGyro(void)
+{
+    memset(&gyroDev, 0, sizeof(gyroDev));
+    gyroOdrTrackerInit(&gyroDev, NOMINAL_PERIOD_US);
+    dataReadyAtUs = 1000;
+}
+
+static void dataReady(float periodUs, int count)
+{
+    for (int i = 0; i < count; i++) {
+        dataReadyAtUs += periodUs;
+        const timeUs_t latencyUs = gyroDev.dataReadyCount % 3;
+        gyroSyncDataReady(&gyroDev, (timeUs_t)dataReadyAtUs + latencyUs);
+    }
+}
+
+TEST(GyroSyncUnittest, TracksDriftedRate)
+{
+    initGyro();
+
+    // the gyro clock is 0.4% slow
+    const float periodUs = 125.5f;
+    for (int i = 0; i < 2000; i++) {
+        dataReady(periodUs, 1);
+        EXPECT_EQ(1, gyroOdrTrackerUpdate(&gyroDev));
+    }
+
+    EXPECT_TRUE(gyroOdrTrackerIsLocked(&gyroDev));
+    EXPECT_NEAR(periodUs, gyroOdrTrackerPeriodUs(&gyroDev), 0.05f);
+
+    // the prediction is within the latency jitter of the interrupt
+    const float nextDataReadyAtUs = dataReadyAtUs + periodUs;
+    EXPECT_NEAR(nextDataReadyAtUs, gyroOdrTrackerDataReadyAtUs(&gyroDev, 1), 2);
+}
+
+TEST(GyroSyncUnittest, MissedUpdates)
+{
+    initGyro();
+
+    // the loop only gets to every other interrupt
+    const float periodUs = 124.6f;
+    for (int i = 0; i < 1000; i++) {
+        dataReady(periodUs, 2);
+        EXPECT_EQ(2, gyroOdrTrackerUpdate(&gyroDev));
+    }
+
+    EXPECT_TRUE(gyroOdrTrackerIsLocked(&gyroDev));
+    EXPECT_NEAR(periodUs, gyroOdrTrackerPeriodUs(&gyroDev), 0.05f);
+    EXPECT_NEAR(dataReadyAtUs + 2 * periodUs, gyroOdrTrackerDataReadyAtUs(&gyroDev, 2), 2);
+}
+
+TEST(GyroSyncUnittest, RepeatedSample)
+{
+    initGyro();
+
+    for (int i = 0; i < 100; i++) {
+        dataReady(NOMINAL_PERIOD_US, 1);
+        gyroOdrTrackerUpdate(&gyroDev);
+    }
+    ASSERT_TRUE(gyroOdrTrackerIsLocked(&gyroDev));
+
+    // read again before the next interrupt
+    EXPECT_EQ(0, gyroOdrTrackerUpdate(&gyroDev));
+    EXPECT_TRUE(gyroOdrTrackerAwaitingDataReady(&gyroDev, dataReadyAtUs + 50));
+
+    // the interrupt stopped, the reads are not held back
+    EXPECT_FALSE(gyroOdrTrackerAwaitingDataReady(&gyroDev, dataReadyAtUs + 1000));
+
+    // a new interrupt
+    dataReady(NOMINAL_PERIOD_US, 1);
+    EXPECT_FALSE(gyroOdrTrackerAwaitingDataReady(&gyroDev, dataReadyAtUs + 10));
+    EXPECT_EQ(1, gyroOdrTrackerUpdate(&gyroDev));
+}
+
+TEST(GyroSyncUnittest, RelocksAfterPhaseJump)
+{
+    initGyro();
+
+    for (int i = 0; i < 100; i++) {
+        dataReady(NOMINAL_PERIOD_US, 1);
+        gyroOdrTrackerUpdate(&gyroDev);
+    }
+    ASSERT_TRUE(gyroOdrTrackerIsLocked(&gyroDev));
+
+    // the gyro was reset, its interrupts restart at another phase
+    dataReadyAtUs += NOMINAL_PERIOD_US * 10.6f;
+    dataReady(NOMINAL_PERIOD_US, 1);
+    gyroOdrTrackerUpdate(&gyroDev);
+    EXPECT_FALSE(gyroOdrTrackerIsLocked(&gyroDev));
+
+    for (int i = 0; i < 100; i++) {
+        dataReady(NOMINAL_PERIOD_US, 1);
+        gyroOdrTrackerUpdate(&gyroDev);
+    }
+    EXPECT_TRUE(gyroOdrTrackerIsLocked(&gyroDev));
+    EXPECT_NEAR(dataReadyAtUs + NOMINAL_PERIOD_US, gyroOdrTrackerDataReadyAtUs(&gyroDev, 1), 2);
+}
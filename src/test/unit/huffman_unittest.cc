@@ -16,6 +16,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
 extern "C" {
     #include "common/huffman.h"
@@ -546,6 +547,89 @@ TEST(HuffmanUnittest, TestHuffmanDecode)
     EXPECT_EQ(0x07, (int)outBuf[7]);
 }
 
+TEST(HuffmanUnittest, TestHuffmanEncodeStreamingOverflow)
+{
+    const uint8_t inBuf[4] = {0,1,2,3};
+    // 11 101 1001 10001, 14 bits
+    huffmanState_t state = {
+        .bytesWritten = 0,
+        .outByte = outBuf,
+        .outBufLen = 2,
+        .outBit = 0x80,
+    };
+    EXPECT_EQ(0, huffmanEncodeBufStreaming(&state, inBuf, 1, huffmanTable));
+    EXPECT_EQ(0x20, state.outBit);
+    EXPECT_EQ(0xc0, (int)outBuf[0]);
+
+    // a chunk that does not fit leaves the state as it was
+    const uint8_t tooLong[2] = {0xf9, 0xf9};
+    EXPECT_EQ(-1, huffmanEncodeBufStreaming(&state, tooLong, 2, huffmanTable));
+    EXPECT_EQ(0, state.bytesWritten);
+    EXPECT_EQ(outBuf, state.outByte);
+    EXPECT_EQ(0x20, state.outBit);
+    EXPECT_EQ(0xc0, (int)outBuf[0]);
+
+    EXPECT_EQ(0, huffmanEncodeBufStreaming(&state, inBuf + 1, 3, huffmanTable));
+    EXPECT_EQ(1, state.bytesWritten);
+    EXPECT_EQ(0x02, state.outBit);
+    EXPECT_EQ(0xec, (int)outBuf[0]);
+    EXPECT_EQ(0xc4, (int)outBuf[1]);
+
+    // the last partly filled byte has to fit too
+    EXPECT_EQ(-1, huffmanEncodeBuf(outBuf, 1, inBuf, 4, huffmanTable));
+}
+
+TEST(HuffmanUnittest, TestHuffmanDecodeTable)
+{
+    static huffmanDecodeTable_t decodeTable;
+    huffmanDecodeTableInit(&decodeTable, huffmanTable);
+
+    // 0x00 is 11, 0x10 is 011001, longer codes are not in the table
+    EXPECT_EQ(0x00 << 4 | 2, decodeTable.fast[0xc0]);
+    EXPECT_EQ(0x00 << 4 | 2, decodeTable.fast[0xff]);
+    EXPECT_EQ(0x10 << 4 | 6, decodeTable.fast[0x64]);
+    EXPECT_EQ(0x10 << 4 | 6, decodeTable.fast[0x67]);
+    EXPECT_EQ(0, decodeTable.fast[0x00]);
+
+    const uint8_t inBuf[5] = {0xec, 0xc6, 0x0e, 0xb8, 0xd8};
+    EXPECT_EQ(8, huffmanDecode(outBuf, OUTBUF_LEN, inBuf, 5, huffmanTable, &decodeTable));
+    for (int ii = 0; ii < 8; ++ii) {
+        EXPECT_EQ(ii, (int)outBuf[ii]);
+    }
+
+    // the EOF code ends the stream
+    const uint8_t withEof[3] = {0xe0, 0x00, 0x0a}; // 11 101 000000000000 101
+    EXPECT_EQ(2, huffmanDecode(outBuf, OUTBUF_LEN, withEof, 3, huffmanTable, &decodeTable));
+}
+
+TEST(HuffmanUnittest, TestHuffmanRoundTrip)
+{
+    static huffmanDecodeTable_t decodeTable;
+    huffmanDecodeTableInit(&decodeTable, huffmanTable);
+
+    // every character, with the long codes between the short ones
+    uint8_t inBuf[512];
+    for (int ii = 0; ii < 256; ++ii) {
+        inBuf[2 * ii] = ii;
+        inBuf[2 * ii + 1] = ii & 0x03;
+    }
+
+    uint8_t compressed[1024];
+    const int compressedLen = huffmanEncodeBuf(compressed, sizeof(compressed), inBuf, sizeof(inBuf), huffmanTable);
+    ASSERT_GT(compressedLen, 0);
+
+    uint8_t decoded[512];
+    EXPECT_EQ(512, huffmanDecode(decoded, sizeof(decoded), compressed, compressedLen, huffmanTable, &decodeTable));
+    EXPECT_EQ(0, memcmp(inBuf, decoded, sizeof(inBuf)));
+
+    // the reference decoder agrees
+    EXPECT_EQ(512, huffmanDecodeBuf(decoded, sizeof(decoded), compressed, compressedLen, sizeof(inBuf), huffmanTree));
+    EXPECT_EQ(0, memcmp(inBuf, decoded, sizeof(inBuf)));
+
+    // a truncated stream decodes as far as it goes
+    EXPECT_GT(huffmanDecode(decoded, sizeof(decoded), compressed, compressedLen / 2, huffmanTable, &decodeTable), 0);
+}
+
 // STUBS
 
 extern "C" {
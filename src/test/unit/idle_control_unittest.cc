@@ -0,0 +1,144 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "flight/idle_control.h"
+
+    #include "pg/pg.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static bool testHasMotorFrequencies;
+static bool testMotorFrequencyCurrent[4];
+static float testMotorFrequencyHz[4];
+
+static void initIdleControl(void)
+{
+    pgResetAll();
+    idleControlConfigMutable()->idle_min_rpm = 1200;
+    idleControlConfigMutable()->idle_p = 5;
+    idleControlConfigMutable()->idle_i = 50;
+    idleControlConfigMutable()->idle_max_increase = 5;
+    testHasMotorFrequencies = true;
+    for (int motor = 0; motor < 4; motor++) {
+        testMotorFrequencyCurrent[motor] = true;
+        testMotorFrequencyHz[motor] = 40;
+    }
+    // 1 ms PID loop, 3 per Hz proportional, 0.03 per Hz per loop integral, 50 most
+    idleControlInit(1000, 2000, 1000);
+}
+
+TEST(IdleControlUnittest, TestDisabled)
+{
+    initIdleControl();
+    idleControlConfigMutable()->idle_min_rpm = 0;
+    idleControlInit(1000, 2000, 1000);
+    testMotorFrequencyHz[0] = 0;
+    idleControlUpdate(true);
+    EXPECT_FLOAT_EQ(1000, idleControlApply(0, 1000));
+
+    // without the motor frequencies from the telemetry the controller is off too
+    initIdleControl();
+    testHasMotorFrequencies = false;
+    idleControlInit(1000, 2000, 1000);
+    testMotorFrequencyHz[0] = 0;
+    idleControlUpdate(true);
+    EXPECT_FLOAT_EQ(1000, idleControlApply(0, 1000));
+}
+
+TEST(IdleControlUnittest, TestRaisesSlowMotor)
+{
+    initIdleControl();
+
+    // 19 Hz is 1 Hz below the minimum of 1200 rpm
+    testMotorFrequencyHz[1] = 19;
+    idleControlUpdate(true);
+    EXPECT_FLOAT_EQ(1000, idleControlApply(0, 1000));
+    EXPECT_FLOAT_EQ(1003.03f, idleControlApply(1, 1000));
+
+    // the floor only raises the output, and not the disarm command below idle
+    EXPECT_FLOAT_EQ(1500, idleControlApply(1, 1500));
+    EXPECT_FLOAT_EQ(48, idleControlApply(1, 48));
+
+    idleControlUpdate(true);
+    EXPECT_FLOAT_EQ(1003.06f, idleControlApply(1, 1000));
+}
+
+TEST(IdleControlUnittest, TestClampsIncrease)
+{
+    initIdleControl();
+
+    testMotorFrequencyHz[2] = 0;
+    for (int i = 0; i < 1000; i++) {
+        idleControlUpdate(true);
+    }
+    EXPECT_FLOAT_EQ(1050, idleControlApply(2, 1000));
+
+    // the integral is clamped too, so it drains from the most as soon as the motor is fast enough
+    testMotorFrequencyHz[2] = 30;
+    idleControlUpdate(true);
+    EXPECT_FLOAT_EQ(1019.7f, idleControlApply(2, 1000));
+}
+
+TEST(IdleControlUnittest, TestStaleTelemetryHoldsFloor)
+{
+    initIdleControl();
+
+    testMotorFrequencyHz[3] = 19;
+    idleControlUpdate(true);
+    testMotorFrequencyCurrent[3] = false;
+    testMotorFrequencyHz[3] = 0;
+    idleControlUpdate(true);
+    EXPECT_FLOAT_EQ(1003.03f, idleControlApply(3, 1000));
+}
+
+TEST(IdleControlUnittest, TestResetWhenInactive)
+{
+    initIdleControl();
+
+    testMotorFrequencyHz[0] = 19;
+    idleControlUpdate(true);
+    idleControlUpdate(false);
+    EXPECT_FLOAT_EQ(1000, idleControlApply(0, 1000));
+
+    idleControlUpdate(true);
+    EXPECT_FLOAT_EQ(1003.03f, idleControlApply(0, 1000));
+}
+
+// STUBS
+
+extern "C" {
+    bool feature(uint32_t) { return false; }
+    uint8_t getMotorCount(void) { return 4; }
+    bool rpmHasMotorFrequencies(void) { return testHasMotorFrequencies; }
+    bool rpmReadMotorFrequencyHz(int motor, float *frequencyHz)
+    {
+        if (!testMotorFrequencyCurrent[motor]) {
+            return false;
+        }
+        *frequencyHz = testMotorFrequencyHz[motor];
+        return true;
+    }
+}
@@ -19,6 +19,7 @@
 #include <stdbool.h>
 
 #include <limits.h>
+#include <string.h>
 
 extern "C" {
     #include "platform.h"
@@ -29,6 +30,8 @@ extern "C" {
 
     #include "io/serial.h"
 
+    #include "scheduler/scheduler.h"
+
     void serialInit(bool softserialEnabled, serialPortIdentifier_e serialPortToDisable);
 }
 
@@ -47,6 +50,102 @@ TEST(IoSerialTest, TestFindPortConfig)
     EXPECT_EQ(NULL, portConfig);
 }
 
+// a port receives from rx and transmits into tx, the receive buffer wraps after rxWrapIndex
+typedef struct fakePort_s {
+    serialPort_t port;
+    bool canPeek;
+    uint8_t rx[64];
+    uint32_t rxLength;
+    uint32_t rxIndex;
+    uint32_t rxWrapIndex;
+    uint8_t tx[64];
+    uint32_t txLength;
+    uint32_t txSize;
+} fakePort_t;
+
+static fakePort_t fakeLeft;
+static fakePort_t fakeRight;
+static bool taskEnabled[TASK_COUNT];
+static uint8_t consumed[64];
+static uint32_t consumedLength;
+
+static void fakePortInit(fakePort_t *fake, bool canPeek, const char *received, uint32_t rxWrapIndex, uint32_t txSize)
+{
+    memset(fake, 0, sizeof(*fake));
+    fake->canPeek = canPeek;
+    fake->rxLength = strlen(received);
+    memcpy(fake->rx, received, fake->rxLength);
+    fake->rxWrapIndex = rxWrapIndex;
+    fake->txSize = txSize;
+}
+
+static void consumer(uint8_t c)
+{
+    consumed[consumedLength++] = c;
+}
+
+TEST(IoSerialTest, TestPassthroughStopsOtherTasks)
+{
+    // given
+    fakePortInit(&fakeLeft, true, "", 0, 64);
+    fakePortInit(&fakeRight, true, "", 0, 64);
+    for (int taskId = 0; taskId < TASK_COUNT; taskId++) {
+        taskEnabled[taskId] = true;
+    }
+
+    // when
+    serialPassthrough(&fakeLeft.port, &fakeRight.port, NULL, NULL);
+
+    // then
+    EXPECT_TRUE(serialPassthroughIsActive());
+    for (int taskId = 0; taskId < TASK_COUNT; taskId++) {
+        EXPECT_EQ(taskId == TASK_SERIAL_PASSTHROUGH, taskEnabled[taskId]);
+    }
+}
+
+TEST(IoSerialTest, TestPassthroughForwardsBothWays)
+{
+    // given
+    fakePortInit(&fakeLeft, true, "hello world", 4, 64);
+    fakePortInit(&fakeRight, false, "abc", 0, 64);
+    consumedLength = 0;
+    serialPassthrough(&fakeLeft.port, &fakeRight.port, consumer, NULL);
+
+    // when
+    serialPassthroughUpdate(0);
+
+    // then
+    EXPECT_EQ(11, fakeRight.txLength);
+    EXPECT_EQ(0, memcmp("hello world", fakeRight.tx, 11));
+    EXPECT_EQ(3, fakeLeft.txLength);
+    EXPECT_EQ(0, memcmp("abc", fakeLeft.tx, 3));
+    EXPECT_EQ(11, consumedLength);
+    EXPECT_EQ(0, memcmp("hello world", consumed, 11));
+}
+
+TEST(IoSerialTest, TestPassthroughLeavesWhatDoesNotFit)
+{
+    // given
+    fakePortInit(&fakeLeft, true, "0123456789", 0, 64);
+    fakePortInit(&fakeRight, true, "", 0, 6);
+    serialPassthrough(&fakeLeft.port, &fakeRight.port, NULL, NULL);
+
+    // when
+    serialPassthroughUpdate(0);
+
+    // then
+    EXPECT_EQ(6, fakeRight.txLength);
+    EXPECT_EQ(6, fakeLeft.rxIndex);
+
+    // when
+    fakeRight.txLength = 0;
+    serialPassthroughUpdate(0);
+
+    // then
+    EXPECT_EQ(4, fakeRight.txLength);
+    EXPECT_EQ(0, memcmp("6789", fakeRight.tx, 4));
+}
+
 
 // STUBS
 extern "C" {
@@ -58,9 +157,35 @@ extern "C" {
 
     bool telemetryCheckRxPortShared(const serialPortConfig_t *) { return false; }
 
-    uint32_t serialRxBytesWaiting(const serialPort_t *) { return 0; }
-    uint8_t serialRead(serialPort_t *) { return 0; }
-    void serialWrite(serialPort_t *, uint8_t) {}
+    uint32_t serialRxBytesWaiting(const serialPort_t *instance) {
+        const fakePort_t *fake = (const fakePort_t *)instance;
+        return fake->rxLength - fake->rxIndex;
+    }
+    uint8_t serialRead(serialPort_t *instance) {
+        fakePort_t *fake = (fakePort_t *)instance;
+        return fake->rx[fake->rxIndex++];
+    }
+    uint32_t serialPeekContiguous(const serialPort_t *instance, const uint8_t **data) {
+        const fakePort_t *fake = (const fakePort_t *)instance;
+        if (!fake->canPeek) {
+            return 0;
+        }
+        *data = &fake->rx[fake->rxIndex];
+        const uint32_t end = fake->rxIndex < fake->rxWrapIndex ? fake->rxWrapIndex : fake->rxLength;
+        return end - fake->rxIndex;
+    }
+    void serialSkip(serialPort_t *instance, uint32_t count) {
+        ((fakePort_t *)instance)->rxIndex += count;
+    }
+    void serialWrite(serialPort_t *instance, uint8_t ch) {
+        fakePort_t *fake = (fakePort_t *)instance;
+        fake->tx[fake->txLength++] = ch;
+    }
+    void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count) {
+        fakePort_t *fake = (fakePort_t *)instance;
+        memcpy(&fake->tx[fake->txLength], data, count);
+        fake->txLength += count;
+    }
 
     serialPort_t *usbVcpOpen(void) { return NULL; }
 
@@ -74,9 +199,14 @@ extern "C" {
 
     void serialSetCtrlLineStateCb(serialPort_t *, void (*)(void *, uint16_t ), void *) {}
     void serialSetCtrlLineState(serialPort_t *, uint16_t ) {}
-    uint32_t serialTxBytesFree(const serialPort_t *) {return 1;}
+    uint32_t serialTxBytesFree(const serialPort_t *instance) {
+        const fakePort_t *fake = (const fakePort_t *)instance;
+        return fake->txSize - fake->txLength;
+    }
 
     void serialSetBaudRateCb(serialPort_t *, void (*)(serialPort_t *context, uint32_t baud), serialPort_t *) {}
 
     void pinioSet(int, bool) {}
+
+    void setTaskEnabled(cfTaskId_e taskId, bool enabled) { taskEnabled[taskId] = enabled; }
 }
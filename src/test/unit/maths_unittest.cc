@@ -202,6 +202,12 @@ void expectVectorsAreEqual(struct fp_vector *a, struct fp_vector *b, float absTo
     EXPECT_NEAR(a->Z, b->Z, absTol);
 }
 
+TEST(MathsUnittest, TestInvSqrt)
+{
+    EXPECT_FLOAT_EQ(0.5f, invSqrt(4.0f));
+    EXPECT_FLOAT_EQ(1.0f / sqrtf(3.0f), invSqrt(3.0f));
+}
+
 TEST(MathsUnittest, TestRotateVectorWithNoAngle)
 {
     fp_vector vector = {1.0f, 0.0f, 0.0f};
@@ -247,6 +253,27 @@ TEST(MathsUnittest, TestFastTrigonometrySinCos)
     EXPECT_LE(cosError, 3.5e-6);
 }
 
+TEST(MathsUnittest, TestFastTrigonometrySinCosTogether)
+{
+    double sinError = 0;
+    double cosError = 0;
+    for (float x = -10 * M_PI; x < 10 * M_PI; x += M_PI / 300) {
+        float sinx, cosx;
+        sincos_approx(x, &sinx, &cosx);
+        sinError = MAX(sinError, fabs(sinx - sinf(x)));
+        cosError = MAX(cosError, fabs(cosx - cosf(x)));
+        EXPECT_EQ(sin_approx(x), sinx);
+    }
+    printf("sincos_approx maximum absolute error = %e, %e\n", sinError, cosError);
+    EXPECT_LE(sinError, 3e-6);
+    EXPECT_LE(cosError, 3e-6);
+
+    float sinx = 1, cosx = 1;
+    sincos_approx(1000, &sinx, &cosx);
+    EXPECT_EQ(0, sinx);
+    EXPECT_EQ(0, cosx);
+}
+
 TEST(MathsUnittest, TestFastTrigonometryATan2)
 {
     double error = 0;
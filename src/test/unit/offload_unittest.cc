@@ -0,0 +1,159 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/color.h"
+    #include "common/streambuf.h"
+
+    #include "io/offload.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static uint8_t frame[64];
+
+static sbuf_t *startFrame(sbuf_t *sbuf)
+{
+    return sbufInit(sbuf, frame, frame + sizeof(frame));
+}
+
+static bool receiveFrame(sbuf_t *sbuf, timeUs_t currentTimeUs)
+{
+    sbufSwitchToReader(sbuf, frame);
+    return offloadProcessRecord(sbuf, currentTimeUs);
+}
+
+TEST(OffloadUnittest, StateRoundTrip)
+{
+    const offloadState_t state = {
+        .armingFlags = 0x05,
+        .flightModeFlags = 0x1234,
+        .stateFlags = 0x02,
+        .attitude = { -450, 900, 1799 },
+        .batteryVoltage = 168,
+        .amperage = -150,
+        .mAhDrawn = 1234,
+        .rssi = 1023,
+        .altitudeCm = -2500,
+        .varioCms = -75,
+    };
+
+    sbuf_t sbuf;
+    offloadWriteState(startFrame(&sbuf), &state);
+    EXPECT_EQ(29, sbuf.ptr - frame);
+    EXPECT_TRUE(receiveFrame(&sbuf, 1000));
+
+    const offloadData_t *data = offloadGetData();
+    EXPECT_EQ(1000, data->stateReceivedAtUs);
+    EXPECT_EQ(state.armingFlags, data->state.armingFlags);
+    EXPECT_EQ(state.flightModeFlags, data->state.flightModeFlags);
+    EXPECT_EQ(state.stateFlags, data->state.stateFlags);
+    for (int axis = 0; axis < 3; axis++) {
+        EXPECT_EQ(state.attitude[axis], data->state.attitude[axis]);
+    }
+    EXPECT_EQ(state.batteryVoltage, data->state.batteryVoltage);
+    EXPECT_EQ(state.amperage, data->state.amperage);
+    EXPECT_EQ(state.mAhDrawn, data->state.mAhDrawn);
+    EXPECT_EQ(state.rssi, data->state.rssi);
+    EXPECT_EQ(state.altitudeCm, data->state.altitudeCm);
+    EXPECT_EQ(state.varioCms, data->state.varioCms);
+}
+
+TEST(OffloadUnittest, GpsRoundTrip)
+{
+    const offloadGps_t gps = {
+        .numSat = 12,
+        .lat = -337654321,
+        .lon = 1512345678,
+        .altitudeCm = 4567,
+        .groundSpeed = 250,
+        .groundCourse = 3599,
+    };
+
+    sbuf_t sbuf;
+    offloadWriteGps(startFrame(&sbuf), &gps);
+    EXPECT_TRUE(receiveFrame(&sbuf, 2000));
+
+    const offloadData_t *data = offloadGetData();
+    EXPECT_EQ(2000, data->gpsReceivedAtUs);
+    EXPECT_EQ(gps.numSat, data->gps.numSat);
+    EXPECT_EQ(gps.lat, data->gps.lat);
+    EXPECT_EQ(gps.lon, data->gps.lon);
+    EXPECT_EQ(gps.altitudeCm, data->gps.altitudeCm);
+    EXPECT_EQ(gps.groundSpeed, data->gps.groundSpeed);
+    EXPECT_EQ(gps.groundCourse, data->gps.groundCourse);
+}
+
+TEST(OffloadUnittest, LedsAreSentInFrames)
+{
+    hsvColor_t leds[12];
+    for (int i = 0; i < 12; i++) {
+        leds[i].h = i * 30;
+        leds[i].s = i;
+        leds[i].v = 255 - i;
+    }
+
+    sbuf_t sbuf;
+    EXPECT_EQ(OFFLOAD_LEDS_PER_FRAME, offloadWriteLeds(startFrame(&sbuf), 12, 0, leds));
+    EXPECT_TRUE(receiveFrame(&sbuf, 0));
+    EXPECT_EQ(4, offloadWriteLeds(startFrame(&sbuf), 12, 8, &leds[8]));
+    EXPECT_TRUE(receiveFrame(&sbuf, 0));
+
+    const offloadData_t *data = offloadGetData();
+    EXPECT_EQ(12, data->ledCount);
+    for (int i = 0; i < 12; i++) {
+        EXPECT_EQ(leds[i].h, data->leds[i].h);
+        EXPECT_EQ(leds[i].s, data->leds[i].s);
+        EXPECT_EQ(leds[i].v, data->leds[i].v);
+    }
+}
+
+TEST(OffloadUnittest, LedsBeyondTheStripAreIgnored)
+{
+    const hsvColor_t leds[OFFLOAD_LEDS_PER_FRAME] = { { 1, 2, 3 } };
+
+    sbuf_t sbuf;
+    offloadWriteLeds(startFrame(&sbuf), OFFLOAD_LED_COUNT + 10, OFFLOAD_LED_COUNT + 2, leds);
+    EXPECT_TRUE(receiveFrame(&sbuf, 0));
+    EXPECT_EQ(OFFLOAD_LED_COUNT, offloadGetData()->ledCount);
+}
+
+TEST(OffloadUnittest, BadFramesAreRejected)
+{
+    sbuf_t sbuf;
+
+    // empty
+    startFrame(&sbuf);
+    EXPECT_FALSE(receiveFrame(&sbuf, 0));
+
+    // unknown record
+    sbufWriteU8(startFrame(&sbuf), OFFLOAD_RECORD_COUNT);
+    EXPECT_FALSE(receiveFrame(&sbuf, 0));
+
+    // truncated state, the last state stays
+    const timeUs_t stateReceivedAtUs = offloadGetData()->stateReceivedAtUs;
+    sbufWriteU8(startFrame(&sbuf), OFFLOAD_RECORD_STATE);
+    sbufWriteU32(&sbuf, 0);
+    EXPECT_FALSE(receiveFrame(&sbuf, 5000));
+    EXPECT_EQ(stateReceivedAtUs, offloadGetData()->stateReceivedAtUs);
+}
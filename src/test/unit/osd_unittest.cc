@@ -61,6 +61,7 @@ extern "C" {
 
     uint16_t rssi;
     attitudeEulerAngles_t attitude;
+    const attitudeEulerAngles_t *getAttitude(void) { return &attitude; }
     pidProfile_t *currentPidProfile;
     int16_t debug[DEBUG16_VALUE_COUNT];
     int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
@@ -757,6 +758,58 @@ TEST(OsdTest, TestElementAltitude)
     displayPortTestBufferSubstring(23, 7, "   -.7%c", SYM_M);
 }
 
+/*
+ * Tests the artificial horizon OSD element.
+ */
+TEST(OsdTest, TestElementArtificialHorizon)
+{
+    // given
+    sensorsSet(SENSOR_ACC);
+    osdConfigMutable()->item_pos[OSD_ARTIFICIAL_HORIZON] = OSD_POS(10, 2) | VISIBLE_FLAG;
+    osdConfigMutable()->ahMaxPitch = 20;
+    osdConfigMutable()->ahMaxRoll = 40;
+
+    // when
+    attitude.values.roll = 0;
+    attitude.values.pitch = 0;
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    // a level horizon is drawn across all columns, 4 rows below the element position
+    for (int x = 6; x <= 14; x++) {
+        displayPortTestBufferSubstring(x, 6, "%c", SYM_AH_BAR9_0 + 5);
+    }
+
+    // when
+    // rolled beyond the configured limit
+    attitude.values.roll = 900;
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    // the horizon tilts by the maximum roll
+    displayPortTestBufferSubstring(6, 9, "%c", SYM_AH_BAR9_0 + 3);
+    displayPortTestBufferSubstring(10, 6, "%c", SYM_AH_BAR9_0 + 5);
+    displayPortTestBufferSubstring(14, 3, "%c", SYM_AH_BAR9_0 + 7);
+
+    // when
+    // the pitch limit is set to 0
+    osdConfigMutable()->ahMaxPitch = 0;
+    attitude.values.roll = 0;
+    attitude.values.pitch = 150;
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    // the horizon stays level
+    displayPortTestBufferSubstring(10, 6, "%c", SYM_AH_BAR9_0 + 5);
+
+    osdConfigMutable()->item_pos[OSD_ARTIFICIAL_HORIZON] = 0;
+    attitude.values.pitch = 0;
+    sensorsClear(SENSOR_ACC);
+}
+
 /*
  * Tests the core temperature OSD element.
  */
@@ -1037,4 +1090,6 @@ extern "C" {
     }
 
     bool pidOsdAntiGravityActive(void) { return false; }
+
+    bool schedulerTaskShouldYield(timeDelta_t) { return false; }
 }
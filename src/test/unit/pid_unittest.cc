@@ -63,6 +63,7 @@ extern "C" {
 
     gyro_t gyro;
     attitudeEulerAngles_t attitude;
+    const attitudeEulerAngles_t *getAttitude(void) { return &attitude; }
 
     float getThrottlePIDAttenuation(void) { return simulatedThrottlePIDAttenuation; }
     float getMotorMixRange(void) { return simulatedMotorMixRange; }
@@ -458,6 +459,79 @@ TEST(pidControllerTest, testCrashRecoveryMode) {
     // Add additional verifications
 }
 
+TEST(pidControllerTest, testYawPidDenom) {
+    resetTest();
+    pidProfile->yawRateAccelLimit = 0;
+    pidInit(pidProfile);
+    pidStabilisationState(PID_STABILISATION_ON);
+    ENABLE_ARMING_FLAG(ARMED);
+
+    // yaw on every PID loop
+    simulatedSetpointRate[FD_YAW] = 100;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    const float yawP = pidData[FD_YAW].P;
+    const float yawI = pidData[FD_YAW].I;
+    EXPECT_GT(yawP, 0);
+    EXPECT_GT(yawI, 0);
+
+    // yaw on every second PID loop integrates over both
+    resetTest();
+    pidProfile->yawRateAccelLimit = 0;
+    pidConfigMutable()->pid_yaw_denom = 2;
+    pidInit(pidProfile);
+    pidStabilisationState(PID_STABILISATION_ON);
+    ENABLE_ARMING_FLAG(ARMED);
+
+    simulatedSetpointRate[FD_YAW] = 100;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    EXPECT_FLOAT_EQ(yawP, pidData[FD_YAW].P);
+    EXPECT_FLOAT_EQ(2 * yawI, pidData[FD_YAW].I);
+
+    // the yaw output is held in between while roll still updates
+    simulatedSetpointRate[FD_ROLL] = 100;
+    simulatedSetpointRate[FD_YAW] = 200;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    EXPECT_GT(pidData[FD_ROLL].P, 0);
+    EXPECT_FLOAT_EQ(yawP, pidData[FD_YAW].P);
+    EXPECT_FLOAT_EQ(2 * yawI, pidData[FD_YAW].I);
+
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    EXPECT_FLOAT_EQ(2 * yawP, pidData[FD_YAW].P);
+}
+
+TEST(pidControllerTest, testFilterUpdateKeepsState) {
+    resetTest();
+    // the filters are only set up with a PID looptime
+    pidConfigMutable()->pid_process_denom = 1;
+    pidProfile->dterm_filter_type = FILTER_PT1;
+    pidInit(pidProfile);
+    pidStabilisationState(PID_STABILISATION_ON);
+    ENABLE_ARMING_FLAG(ARMED);
+
+    // after a step in the gyro the D-term decays as the lowpass settles
+    gyro.gyroADCf[FD_ROLL] = 100;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    float dterm = pidData[FD_ROLL].D;
+    EXPECT_LT(dterm, 0);
+
+    // retuned over the next loops, the lowpass carries on from where it was
+    pidProfile->dterm_lowpass_hz = 80;
+    pidUpdateFilters(pidProfile);
+    for (int loop = 0; loop < 5; loop++) {
+        pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+        EXPECT_LT(pidData[FD_ROLL].D, 0);
+        EXPECT_GT(pidData[FD_ROLL].D, dterm);
+        dterm = pidData[FD_ROLL].D;
+    }
+
+    // an init resets the lowpass, which kicks the D-term the other way
+    pidInitFilters(pidProfile);
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    EXPECT_GT(pidData[FD_ROLL].D, 0);
+
+    pidConfigMutable()->pid_process_denom = 0;
+}
+
 TEST(pidControllerTest, pidSetpointTransition) {
 // TODO
 }
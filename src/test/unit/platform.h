@@ -31,6 +31,9 @@
 #define FAST_CODE_NOINLINE
 #define FAST_RAM_ZERO_INIT
 #define FAST_RAM
+#define DMA_RAM_ZERO_INIT
+#define DMA_RAM
+#define DMA_ALIGNED
 
 #define MAX_PROFILE_COUNT 3
 #define USE_MAG
@@ -659,6 +659,61 @@ TEST(RCDeviceTest, Test5KeyOSDCableSimulationWithout5KeyFeatureSupport)
     clearResponseBuff();
 }
 
+static int pipelinedResponses;
+static rcdeviceResponseStatus_e pipelinedResults[MAX_WAITING_RESPONSES];
+
+static void countPipelinedResponse(rcdeviceResponseParseContext_t *ctx)
+{
+    pipelinedResults[pipelinedResponses++] = ctx->result;
+}
+
+TEST(RCDeviceTest, TestPipelinedRequests)
+{
+    runcamDevice_t device;
+
+    memset(&testData, 0, sizeof(testData));
+    testData.isRunCamSplitOpenPortSupported = true;
+    testData.isRunCamSplitPortConfigurated = true;
+    testData.isAllowBufferReadWrite = true;
+    runcamDeviceInit(&device);
+    watingResponseQueue.headPos = 0;
+    watingResponseQueue.tailPos = 0;
+    watingResponseQueue.itemCount = 0;
+    pipelinedResponses = 0;
+
+    // both responses arrive together, after some noise, and are matched to the requests in order
+    uint8_t responses[] = { 0x55, 0x00, 0xCC, 0xA5, 0xCC, 0xA6 };
+    addResponseData(responses, sizeof(responses), false);
+    runcamDeviceSimulate5KeyOSDCableButtonPress(&device, RCDEVICE_PROTOCOL_5KEY_SIMULATION_SET, countPipelinedResponse);
+    runcamDeviceSimulate5KeyOSDCableButtonRelease(&device, countPipelinedResponse);
+    EXPECT_EQ(2, watingResponseQueue.itemCount);
+    EXPECT_TRUE(rcdeviceResponseDue(millis()));
+
+    rcdeviceReceive(millis() * 1000);
+    EXPECT_EQ(2, pipelinedResponses);
+    EXPECT_EQ(RCDEVICE_RESP_SUCCESS, pipelinedResults[0]);
+    EXPECT_EQ(RCDEVICE_RESP_INCORRECT_CRC, pipelinedResults[1]);
+    EXPECT_EQ(0, watingResponseQueue.itemCount);
+    EXPECT_FALSE(rcdeviceResponseDue(millis()));
+    clearResponseBuff();
+
+    // a request that can't be queued is not sent
+    for (int i = 0; i < MAX_WAITING_RESPONSES + 1; i++) {
+        runcamDeviceSimulate5KeyOSDCableButtonRelease(&device, countPipelinedResponse);
+    }
+    EXPECT_EQ(MAX_WAITING_RESPONSES, watingResponseQueue.itemCount);
+
+    // the timeout is due without any data
+    EXPECT_FALSE(rcdeviceResponseDue(millis()));
+    testData.millis += 201;
+    EXPECT_TRUE(rcdeviceResponseDue(millis()));
+    pipelinedResponses = 0;
+    rcdeviceReceive(millis() * 1000);
+    EXPECT_EQ(MAX_WAITING_RESPONSES, pipelinedResponses);
+    EXPECT_EQ(RCDEVICE_RESP_TIMEOUT, pipelinedResults[0]);
+    EXPECT_EQ(0, watingResponseQueue.itemCount);
+}
+
 extern "C" {
     serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFunction_e functionMask, serialReceiveCallbackPtr callback, void *callbackData, uint32_t baudRate, portMode_e mode, portOptions_e options)
     {
@@ -673,12 +728,8 @@ extern "C" {
             s.vTable = NULL;
 
             // common serial initialisation code should move to serialPort::init()
-            s.rxBufferHead = s.rxBufferTail = 0;
-            s.txBufferHead = s.txBufferTail = 0;
-            s.rxBufferSize = 0;
-            s.txBufferSize = 0;
-            s.rxBuffer = s.rxBuffer;
-            s.txBuffer = s.txBuffer;
+            byteRingInit(&s.rxRing, NULL, 0);
+            byteRingInit(&s.txRing, NULL, 0);
 
             // callback works for IRQ-based RX ONLY
             s.rxCallback = callback;
@@ -729,6 +780,22 @@ extern "C" {
         return 0;
     }
 
+    uint32_t serialPeekContiguous(const serialPort_t *instance, const uint8_t **data)
+    {
+        UNUSED(instance);
+
+        const uint8_t bufIndex = testData.indexOfCurrentRespBuf;
+        *data = &testData.responesBufs[bufIndex][testData.responseDataReadPos];
+        return serialRxBytesWaiting(instance);
+    }
+
+    void serialSkip(serialPort_t *instance, uint32_t count)
+    {
+        UNUSED(instance);
+
+        testData.responseDataReadPos += MIN(count, serialRxBytesWaiting(instance));
+    }
+
     uint8_t serialRead(serialPort_t *instance) 
     { 
         UNUSED(instance);
@@ -0,0 +1,173 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/ring_buffer.h"
+
+    RING_BUFFER_DEFINE(wordRing, uint16_t)
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(RingBufferUnittest, TestPushPop)
+{
+    uint8_t buffer[8];
+    byteRing_t ring;
+    byteRingInit(&ring, buffer, sizeof(buffer));
+
+    EXPECT_EQ(8, byteRingSize(&ring));
+    EXPECT_TRUE(byteRingIsEmpty(&ring));
+    EXPECT_EQ(0, byteRingCount(&ring));
+    EXPECT_EQ(8, byteRingFree(&ring));
+
+    uint8_t value = 0xaa;
+    EXPECT_FALSE(byteRingPop(&ring, &value));
+    EXPECT_EQ(0xaa, value);
+
+    // the whole buffer is usable
+    for (int i = 0; i < 8; i++) {
+        EXPECT_TRUE(byteRingPush(&ring, i));
+    }
+    EXPECT_FALSE(byteRingPush(&ring, 8));
+    EXPECT_EQ(8, byteRingCount(&ring));
+    EXPECT_EQ(0, byteRingFree(&ring));
+
+    for (int i = 0; i < 8; i++) {
+        EXPECT_TRUE(byteRingPop(&ring, &value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_TRUE(byteRingIsEmpty(&ring));
+}
+
+TEST(RingBufferUnittest, TestIndicesWrap)
+{
+    uint8_t buffer[4];
+    byteRing_t ring;
+    byteRingInit(&ring, buffer, sizeof(buffer));
+
+    // the indices run freely, so they also wrap around their own range
+    ring.head = ring.tail = UINT32_MAX - 1;
+
+    uint8_t value;
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(byteRingPush(&ring, i));
+        EXPECT_TRUE(byteRingPush(&ring, i + 100));
+        EXPECT_EQ(2, byteRingCount(&ring));
+        EXPECT_TRUE(byteRingPop(&ring, &value));
+        EXPECT_EQ(i, value);
+        EXPECT_TRUE(byteRingPop(&ring, &value));
+        EXPECT_EQ(i + 100, value);
+    }
+    EXPECT_TRUE(byteRingIsEmpty(&ring));
+}
+
+TEST(RingBufferUnittest, TestSpans)
+{
+    uint8_t buffer[8];
+    byteRing_t ring;
+    byteRingInit(&ring, buffer, sizeof(buffer));
+
+    uint8_t *writeSpan;
+    const uint8_t *readSpan;
+
+    EXPECT_EQ(8, byteRingWriteSpan(&ring, &writeSpan));
+    EXPECT_EQ(buffer, writeSpan);
+    EXPECT_EQ(0, byteRingReadSpan(&ring, &readSpan));
+
+    for (int i = 0; i < 6; i++) {
+        writeSpan[i] = i;
+    }
+    byteRingCommit(&ring, 6);
+    EXPECT_EQ(6, byteRingReadSpan(&ring, &readSpan));
+    EXPECT_EQ(buffer, readSpan);
+    byteRingConsume(&ring, 5);
+
+    // the free space wraps, the write span stops at the end of the buffer
+    EXPECT_EQ(2, byteRingWriteSpan(&ring, &writeSpan));
+    EXPECT_EQ(buffer + 6, writeSpan);
+    writeSpan[0] = 6;
+    writeSpan[1] = 7;
+    byteRingCommit(&ring, 2);
+
+    EXPECT_EQ(5, byteRingWriteSpan(&ring, &writeSpan));
+    EXPECT_EQ(buffer, writeSpan);
+    writeSpan[0] = 8;
+    byteRingCommit(&ring, 1);
+
+    // and so does the read span
+    EXPECT_EQ(3, byteRingReadSpan(&ring, &readSpan));
+    EXPECT_EQ(buffer + 5, readSpan);
+    EXPECT_EQ(5, readSpan[0]);
+    byteRingConsume(&ring, 3);
+    EXPECT_EQ(1, byteRingReadSpan(&ring, &readSpan));
+    EXPECT_EQ(8, readSpan[0]);
+}
+
+TEST(RingBufferUnittest, TestBulk)
+{
+    uint8_t buffer[16];
+    byteRing_t ring;
+    byteRingInit(&ring, buffer, sizeof(buffer));
+
+    uint8_t data[32];
+    for (int i = 0; i < 32; i++) {
+        data[i] = i;
+    }
+    uint8_t out[20];
+
+    EXPECT_EQ(10, byteRingPushBulk(&ring, data, 10));
+    EXPECT_EQ(7, byteRingPopBulk(&ring, out, 7));
+    EXPECT_EQ(0, memcmp(data, out, 7));
+
+    // across the end of the buffer, and only as much as fits
+    EXPECT_EQ(13, byteRingPushBulk(&ring, data + 10, 20));
+    EXPECT_EQ(16, byteRingCount(&ring));
+    EXPECT_EQ(0, byteRingPushBulk(&ring, data, 1));
+
+    EXPECT_EQ(16, byteRingPopBulk(&ring, out, 20));
+    EXPECT_EQ(0, memcmp(data + 7, out, 16));
+    EXPECT_EQ(0, byteRingPopBulk(&ring, out, 1));
+}
+
+TEST(RingBufferUnittest, TestOtherElementType)
+{
+    uint16_t buffer[4];
+    wordRing_t ring;
+    wordRingInit(&ring, buffer, 4);
+
+    const uint16_t data[3] = { 1000, 2000, 3000 };
+    EXPECT_EQ(3, wordRingPushBulk(&ring, data, 3));
+    uint16_t value;
+    EXPECT_TRUE(wordRingPop(&ring, &value));
+    EXPECT_EQ(1000, value);
+    EXPECT_EQ(2, wordRingPushBulk(&ring, data, 3));
+    EXPECT_FALSE(wordRingPush(&ring, 4000));
+
+    uint16_t out[4];
+    EXPECT_EQ(4, wordRingPopBulk(&ring, out, 4));
+    EXPECT_EQ(2000, out[0]);
+    EXPECT_EQ(3000, out[1]);
+    EXPECT_EQ(1000, out[2]);
+    EXPECT_EQ(2000, out[3]);
+}
@@ -0,0 +1,151 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/axis.h"
+    #include "common/filter.h"
+    #include "common/maths.h"
+
+    #include "pg/pg.h"
+
+    #include "sensors/esc_sensor.h"
+    #include "sensors/rpm_filter.h"
+
+    bool escSensorFeature = true;
+    uint8_t testMotorCount = 4;
+    escSensorData_t testEscData[MAX_SUPPORTED_MOTORS];
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static rpmFilterBank_t bank;
+
+static void setMotorRpm(int rpm)
+{
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        testEscData[i].dataAge = 0;
+        // calcEscRpm() is stubbed to pass the rpm through
+        testEscData[i].rpm = rpm;
+    }
+}
+
+TEST(RpmFilterUnittest, TestDisabled)
+{
+    pgResetAll();
+    rpmFilterBankInit(&bank, 125, 125);
+    EXPECT_EQ(0, bank.harmonics);
+
+    rpmFilterConfigMutable()->rpm_notch_harmonics = 2;
+    escSensorFeature = false;
+    rpmFilterBankInit(&bank, 125, 125);
+    EXPECT_EQ(0, bank.harmonics);
+    escSensorFeature = true;
+
+    // a disabled filter leaves the gyro untouched
+    float values[FILTER_BANK_SIZE] = { 1.0f, 2.0f, 3.0f };
+    rpmFilterBankApply(&bank, values);
+    rpmFilterBankUpdate(&bank);
+    EXPECT_FLOAT_EQ(1.0f, values[0]);
+    EXPECT_FLOAT_EQ(3.0f, values[2]);
+}
+
+TEST(RpmFilterUnittest, TestNotchesFollowMotors)
+{
+    pgResetAll();
+    rpmFilterConfigMutable()->rpm_notch_harmonics = 2;
+    rpmFilterBankInit(&bank, 125, 125);
+    EXPECT_EQ(2, bank.harmonics);
+    EXPECT_EQ(4, bank.motorCount);
+
+    // 12000rpm is 200Hz, with its second harmonic at 400Hz
+    setMotorRpm(12000);
+    for (int i = 0; i < 10000; i++) {
+        rpmFilterBankUpdate(&bank);
+    }
+
+    biquadFilter_t fundamental;
+    biquadFilter_t harmonic;
+    biquadFilterInit(&fundamental, 200, 125, 5.0f, FILTER_NOTCH);
+    biquadFilterInit(&harmonic, 400, 125, 5.0f, FILTER_NOTCH);
+    for (int motor = 0; motor < 4; motor++) {
+        EXPECT_NEAR(fundamental.b1, bank.notch[0][motor].b1[0], 1e-4);
+        EXPECT_NEAR(fundamental.a2, bank.notch[0][motor].a2[2], 1e-4);
+        EXPECT_NEAR(harmonic.b1, bank.notch[1][motor].b1[1], 1e-4);
+    }
+
+    // stale telemetry holds the notches, and idle motors leave them at the minimum frequency
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        testEscData[i].dataAge = ESC_DATA_INVALID;
+        testEscData[i].rpm = 0;
+    }
+    for (int i = 0; i < 10000; i++) {
+        rpmFilterBankUpdate(&bank);
+    }
+    EXPECT_NEAR(fundamental.b1, bank.notch[0][0].b1[0], 1e-4);
+
+    setMotorRpm(0);
+    for (int i = 0; i < 10000; i++) {
+        rpmFilterBankUpdate(&bank);
+    }
+    biquadFilter_t minimum;
+    biquadFilterInit(&minimum, 100, 125, 5.0f, FILTER_NOTCH);
+    EXPECT_NEAR(minimum.b1, bank.notch[0][0].b1[0], 1e-4);
+    EXPECT_NEAR(minimum.b1, bank.notch[1][3].b1[0], 1e-4);
+}
+
+TEST(RpmFilterUnittest, TestApplyRemovesMotorNoise)
+{
+    pgResetAll();
+    rpmFilterConfigMutable()->rpm_notch_harmonics = 1;
+    rpmFilterBankInit(&bank, 125, 125);
+    setMotorRpm(12000);
+    for (int i = 0; i < 10000; i++) {
+        rpmFilterBankUpdate(&bank);
+    }
+
+    // 200Hz motor noise sampled at 8kHz
+    float peak = 0;
+    for (int i = 0; i < 4000; i++) {
+        const float noise = sinf(2 * M_PIf * 200 * i * 0.000125f);
+        float values[FILTER_BANK_SIZE] = { noise, noise, noise };
+        rpmFilterBankApply(&bank, values);
+        if (i > 2000) {
+            peak = MAX(peak, fabsf(values[Z]));
+        }
+    }
+    EXPECT_LT(peak, 0.01f);
+}
+
+// STUBS
+
+extern "C" {
+bool feature(uint32_t) { return escSensorFeature; }
+uint8_t getMotorCount(void) { return testMotorCount; }
+escSensorData_t *getEscSensorData(uint8_t motorNumber) { return &testEscData[motorNumber]; }
+int calcEscRpm(int erpm) { return erpm; }
+}
@@ -38,17 +38,21 @@ extern "C" {
 
     #include "rx/rx.h"
     #include "rx/crsf.h"
+    #include "rx/sbus_channels.h"
+
+    #include "scheduler/scheduler.h"
 
     #include "telemetry/msp_shared.h"
 
     void crsfDataReceive(uint16_t c);
     uint8_t crsfFrameCRC(void);
-    uint8_t crsfFrameStatus(void);
+    bool crsfRcFrameDecode(void);
+    uint8_t crsfFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig);
     uint16_t crsfReadRawRC(const rxRuntimeConfig_t *rxRuntimeConfig, uint8_t chan);
 
     extern bool crsfFrameDone;
     extern crsfFrame_t crsfFrame;
-    extern uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
+    extern uint16_t crsfChannelData[CRSF_MAX_CHANNEL];
 
     uint32_t dummyTimeUs;
 
@@ -118,7 +122,6 @@ TEST(CrossFireTest, CRC)
 
 TEST(CrossFireTest, TestCrsfFrameStatus)
 {
-    crsfFrameDone = true;
     crsfFrame.frame.deviceAddress = CRSF_ADDRESS_CRSF_RECEIVER;
     crsfFrame.frame.frameLength = 0;
     crsfFrame.frame.type = CRSF_FRAMETYPE_RC_CHANNELS_PACKED;
@@ -126,9 +129,9 @@ TEST(CrossFireTest, TestCrsfFrameStatus)
     const uint8_t crc = crsfFrameCRC();
     crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE] = crc;
 
-    const uint8_t status = crsfFrameStatus();
+    EXPECT_TRUE(crsfRcFrameDecode());
+    const uint8_t status = crsfFrameStatus(NULL);
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
-    EXPECT_EQ(false, crsfFrameDone);
 
     EXPECT_EQ(CRSF_ADDRESS_CRSF_RECEIVER, crsfFrame.frame.deviceAddress);
     EXPECT_EQ(CRSF_FRAMETYPE_RC_CHANNELS_PACKED, crsfFrame.frame.type);
@@ -146,7 +149,6 @@ TEST(CrossFireTest, TestCrsfFrameStatus)
  */
 TEST(CrossFireTest, TestCrsfFrameStatusUnpacking)
 {
-    crsfFrameDone = true;
     crsfFrame.frame.deviceAddress = CRSF_ADDRESS_CRSF_RECEIVER;
     crsfFrame.frame.frameLength = CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC;;
     crsfFrame.frame.type = CRSF_FRAMETYPE_RC_CHANNELS_PACKED;
@@ -176,9 +178,9 @@ TEST(CrossFireTest, TestCrsfFrameStatusUnpacking)
     const uint8_t crc = crsfFrameCRC();
     crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE] = crc;
 
-    const uint8_t status = crsfFrameStatus();
+    EXPECT_TRUE(crsfRcFrameDecode());
+    const uint8_t status = crsfFrameStatus(NULL);
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
-    EXPECT_EQ(false, crsfFrameDone);
 
     EXPECT_EQ(CRSF_ADDRESS_CRSF_RECEIVER, crsfFrame.frame.deviceAddress);
     EXPECT_EQ(CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC, crsfFrame.frame.frameLength);
@@ -201,6 +203,55 @@ TEST(CrossFireTest, TestCrsfFrameStatusUnpacking)
     EXPECT_EQ(0, crsfChannelData[15]);
 }
 
+// Reference unpacking, one bit at a time, least significant bit first
+static uint16_t unpackChannelBitwise(const uint8_t *packed, int channel)
+{
+    uint16_t value = 0;
+    for (int bit = 0; bit < 11; bit++) {
+        const int index = channel * 11 + bit;
+        if (packed[index / 8] & (1 << (index % 8))) {
+            value |= 1 << bit;
+        }
+    }
+    return value;
+}
+
+TEST(CrossFireTest, TestChannelUnpackingBitExact)
+{
+    uint8_t packed[SBUS_PACKED_CHANNELS_LENGTH];
+    uint16_t channelData[SBUS_PACKED_CHANNEL_COUNT];
+
+    // every single bit set on its own, so a bit landing in the wrong channel or position is caught
+    for (int bit = 0; bit < SBUS_PACKED_CHANNELS_LENGTH * 8; bit++) {
+        memset(packed, 0, sizeof(packed));
+        packed[bit / 8] = 1 << (bit % 8);
+        sbusChannelsUnpack(channelData, packed);
+        for (int i = 0; i < SBUS_PACKED_CHANNEL_COUNT; i++) {
+            EXPECT_EQ(unpackChannelBitwise(packed, i), channelData[i]);
+        }
+    }
+
+    // pseudo random payloads
+    uint32_t seed = 0x12345678;
+    for (int n = 0; n < 1000; n++) {
+        for (int i = 0; i < SBUS_PACKED_CHANNELS_LENGTH; i++) {
+            seed = seed * 1664525 + 1013904223;
+            packed[i] = seed >> 24;
+        }
+        sbusChannelsUnpack(channelData, packed);
+        for (int i = 0; i < SBUS_PACKED_CHANNEL_COUNT; i++) {
+            EXPECT_EQ(unpackChannelBitwise(packed, i), channelData[i]);
+        }
+    }
+
+    // all bits set
+    memset(packed, 0xff, sizeof(packed));
+    sbusChannelsUnpack(channelData, packed);
+    for (int i = 0; i < SBUS_PACKED_CHANNEL_COUNT; i++) {
+        EXPECT_EQ(0x7ff, channelData[i]);
+    }
+}
+
 const uint8_t capturedData[] = {
     0x00,0x18,0x16,0xBD,0x08,0x9F,0xF4,0xAE,0xF7,0xBD,0xEF,0x7D,0xEF,0xFB,0xAD,0xFD,0x45,0x2B,0x5A,0x01,0x00,0x00,0x00,0x00,0x00,0x6C,
     0x00,0x18,0x16,0xBD,0x08,0x9F,0xF4,0xAA,0xF7,0xBD,0xEF,0x7D,0xEF,0xFB,0xAD,0xFD,0x45,0x2B,0x5A,0x01,0x00,0x00,0x00,0x00,0x00,0x94,
@@ -219,12 +270,11 @@ TEST(CrossFireTest, TestCapturedData)
     //const int frameCount = sizeof(capturedData) / sizeof(crsfRcChannelsFrame_t);
     const crsfRcChannelsFrame_t *framePtr = (const crsfRcChannelsFrame_t*)capturedData;
     crsfFrame = *(const crsfFrame_t*)framePtr;
-    crsfFrameDone = true;
-    uint8_t status = crsfFrameStatus();
-    EXPECT_EQ(RX_FRAME_COMPLETE, status);
-    EXPECT_EQ(false, crsfFrameDone);
+    EXPECT_TRUE(crsfRcFrameDecode());
+    uint8_t status = crsfFrameStatus(NULL);
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
-    EXPECT_EQ(false, crsfFrameDone);
+    // a frame is handed to the RX task only once
+    EXPECT_EQ(RX_FRAME_PENDING, crsfFrameStatus(NULL));
     EXPECT_EQ(CRSF_ADDRESS_BROADCAST, crsfFrame.frame.deviceAddress);
     EXPECT_EQ(CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC, crsfFrame.frame.frameLength);
     EXPECT_EQ(CRSF_FRAMETYPE_RC_CHANNELS_PACKED, crsfFrame.frame.type);
@@ -241,12 +291,9 @@ TEST(CrossFireTest, TestCapturedData)
 
     ++framePtr;
     crsfFrame = *(const crsfFrame_t*)framePtr;
-    crsfFrameDone = true;
-    status = crsfFrameStatus();
-    EXPECT_EQ(RX_FRAME_COMPLETE, status);
-    EXPECT_EQ(false, crsfFrameDone);
+    EXPECT_TRUE(crsfRcFrameDecode());
+    status = crsfFrameStatus(NULL);
     EXPECT_EQ(RX_FRAME_COMPLETE, status);
-    EXPECT_EQ(false, crsfFrameDone);
     EXPECT_EQ(CRSF_ADDRESS_BROADCAST, crsfFrame.frame.deviceAddress);
     EXPECT_EQ(CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC, crsfFrame.frame.frameLength);
     EXPECT_EQ(CRSF_FRAMETYPE_RC_CHANNELS_PACKED, crsfFrame.frame.type);
@@ -292,4 +339,5 @@ void crsfScheduleMspResponse(void) {};
 bool bufferMspFrame(uint8_t *, int) {return true;}
 bool isBatteryVoltageAvailable(void) { return true; }
 bool isAmperageAvailable(void) { return true; }
+void schedulerSignalTask(cfTaskId_e) {}
 }
@@ -0,0 +1,101 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "rx/rx.h"
+    #include "rx/rx_frame_buffer.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static void publishFrame(rxFrameBuffer_t *frameBuffer, uint16_t value, uint8_t frameStatus)
+{
+    uint16_t *channelData = rxFrameBufferWriteBegin(frameBuffer);
+    for (int i = 0; i < MAX_SUPPORTED_RC_CHANNEL_COUNT; i++) {
+        channelData[i] = value + i;
+    }
+    rxFrameBufferWriteEnd(frameBuffer, frameStatus);
+}
+
+TEST(RxFrameBufferTest, NothingPublished)
+{
+    rxFrameBuffer_t frameBuffer;
+    memset(&frameBuffer, 0, sizeof(frameBuffer));
+    uint32_t lastFrame = 0;
+    uint16_t channelData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+
+    EXPECT_EQ(RX_FRAME_PENDING, rxFrameBufferRead(&frameBuffer, channelData, MAX_SUPPORTED_RC_CHANNEL_COUNT, &lastFrame));
+}
+
+TEST(RxFrameBufferTest, EachFrameReadOnce)
+{
+    rxFrameBuffer_t frameBuffer;
+    memset(&frameBuffer, 0, sizeof(frameBuffer));
+    uint32_t lastFrame = 0;
+    uint16_t channelData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+
+    publishFrame(&frameBuffer, 1000, RX_FRAME_COMPLETE);
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxFrameBufferRead(&frameBuffer, channelData, MAX_SUPPORTED_RC_CHANNEL_COUNT, &lastFrame));
+    EXPECT_EQ(1000, channelData[0]);
+    EXPECT_EQ(1017, channelData[17]);
+    EXPECT_EQ(RX_FRAME_PENDING, rxFrameBufferRead(&frameBuffer, channelData, MAX_SUPPORTED_RC_CHANNEL_COUNT, &lastFrame));
+
+    publishFrame(&frameBuffer, 1200, RX_FRAME_COMPLETE | RX_FRAME_FAILSAFE);
+    EXPECT_EQ(RX_FRAME_COMPLETE | RX_FRAME_FAILSAFE, rxFrameBufferRead(&frameBuffer, channelData, MAX_SUPPORTED_RC_CHANNEL_COUNT, &lastFrame));
+    EXPECT_EQ(1200, channelData[0]);
+}
+
+TEST(RxFrameBufferTest, LatestFrameWins)
+{
+    rxFrameBuffer_t frameBuffer;
+    memset(&frameBuffer, 0, sizeof(frameBuffer));
+    uint32_t lastFrame = 0;
+    uint16_t channelData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+
+    publishFrame(&frameBuffer, 1000, RX_FRAME_COMPLETE);
+    publishFrame(&frameBuffer, 1100, RX_FRAME_COMPLETE);
+    publishFrame(&frameBuffer, 1200, RX_FRAME_COMPLETE | RX_FRAME_DROPPED);
+    EXPECT_EQ(RX_FRAME_COMPLETE | RX_FRAME_DROPPED, rxFrameBufferRead(&frameBuffer, channelData, 4, &lastFrame));
+    EXPECT_EQ(1200, channelData[0]);
+    EXPECT_EQ(1203, channelData[3]);
+}
+
+TEST(RxFrameBufferTest, WriteInProgressKeepsLastFrame)
+{
+    rxFrameBuffer_t frameBuffer;
+    memset(&frameBuffer, 0, sizeof(frameBuffer));
+    uint32_t lastFrame = 0;
+    uint16_t channelData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+
+    publishFrame(&frameBuffer, 1000, RX_FRAME_COMPLETE);
+
+    // an interrupt that has started but not finished decoding must not disturb the published frame
+    uint16_t *writing = rxFrameBufferWriteBegin(&frameBuffer);
+    writing[0] = 2000;
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxFrameBufferRead(&frameBuffer, channelData, MAX_SUPPORTED_RC_CHANNEL_COUNT, &lastFrame));
+    EXPECT_EQ(1000, channelData[0]);
+
+    rxFrameBufferWriteEnd(&frameBuffer, RX_FRAME_COMPLETE);
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxFrameBufferRead(&frameBuffer, channelData, 1, &lastFrame));
+    EXPECT_EQ(2000, channelData[0]);
+}
@@ -0,0 +1,394 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+
+extern "C" {
+    #include "platform.h"
+    #include "scheduler/scheduler.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+const int TEST_PID_LOOP_TIME = 650;
+const int TEST_UPDATE_ACCEL_TIME = 192;
+const int TEST_HANDLE_SERIAL_TIME = 30;
+const int TEST_UPDATE_RX_MAIN_TIME = 1;
+
+extern "C" {
+    cfTask_t * unittest_scheduler_selectedTask;
+    uint16_t unittest_scheduler_waitingTasks;
+
+    // set up micros() to simulate time
+    uint32_t simulatedTime = 0;
+    uint32_t micros(void) { return simulatedTime; }
+
+    bool rxFrameReady = false;
+    int rxUpdateCheckCount = 0;
+    bool disableSerialWhenRun = false;
+    timeDelta_t serialTimeRemaining = 0;
+
+    void taskMainPidLoop(timeUs_t) { simulatedTime += TEST_PID_LOOP_TIME; }
+    void taskUpdateAccelerometer(timeUs_t) { simulatedTime += TEST_UPDATE_ACCEL_TIME; }
+    void taskHandleSerial(timeUs_t)
+    {
+        serialTimeRemaining = schedulerGetTimeRemaining();
+        simulatedTime += TEST_HANDLE_SERIAL_TIME;
+        if (disableSerialWhenRun) {
+            setTaskEnabled(TASK_SELF, false);
+        }
+    }
+    bool rxUpdateCheck(timeUs_t, timeDelta_t) { rxUpdateCheckCount++; return rxFrameReady; }
+    void taskUpdateRxMain(timeUs_t) { simulatedTime += TEST_UPDATE_RX_MAIN_TIME; rxFrameReady = false; }
+
+    typedef struct {
+        timeUs_t deadline;
+        cfTask_t *task;
+    } taskHeapEntry_t;
+
+    extern taskHeapEntry_t taskHeap[];
+    extern int taskHeapSize;
+    extern int eventTaskCount;
+    extern uint32_t eventTaskSignalledMask;
+
+    extern void queueClear(void);
+
+    cfTask_t cfTasks[TASK_COUNT] = {
+        [TASK_SYSTEM] = {
+            .taskName = "SYSTEM",
+            .taskFunc = taskSystemLoad,
+            .desiredPeriod = TASK_PERIOD_HZ(10),
+            .staticPriority = TASK_PRIORITY_MEDIUM_HIGH,
+        },
+        [TASK_MAIN] = {
+            .taskName = "MAIN",
+        },
+        [TASK_GYROPID] = {
+            .taskName = "PID",
+            .subTaskName = "GYRO",
+            .taskFunc = taskMainPidLoop,
+            .desiredPeriod = 1000,
+            .staticPriority = TASK_PRIORITY_REALTIME,
+        },
+        [TASK_ACCEL] = {
+            .taskName = "ACCEL",
+            .taskFunc = taskUpdateAccelerometer,
+            .desiredPeriod = 10000,
+            .staticPriority = TASK_PRIORITY_MEDIUM,
+        },
+        [TASK_ATTITUDE] = {
+            .taskName = "ATTITUDE",
+        },
+        [TASK_RX] = {
+            .taskName = "RX",
+            .checkFunc = rxUpdateCheck,
+            .taskFunc = taskUpdateRxMain,
+            .desiredPeriod = TASK_PERIOD_HZ(50),
+            .staticPriority = TASK_PRIORITY_HIGH,
+        },
+        [TASK_SERIAL] = {
+            .taskName = "SERIAL",
+            .taskFunc = taskHandleSerial,
+            .desiredPeriod = TASK_PERIOD_HZ(100),
+            .staticPriority = TASK_PRIORITY_LOW,
+        },
+    };
+}
+
+static void disableAllTasks(void)
+{
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        setTaskEnabled(static_cast<cfTaskId_e>(taskId), false);
+    }
+}
+
+static void resetTask(cfTaskId_e taskId, timeUs_t lastExecutedAt)
+{
+    cfTasks[taskId].lastExecutedAt = lastExecutedAt;
+    cfTasks[taskId].dynamicPriority = 0;
+    cfTasks[taskId].taskAgeCycles = 0;
+}
+
+TEST(SchedulerDeadlineQueueUnittest, TestHeapOrder)
+{
+    queueClear();
+    resetTask(TASK_SYSTEM, 0);      // due at 100000
+    resetTask(TASK_GYROPID, 500);   // due at 1500
+    resetTask(TASK_ACCEL, 0);       // due at 10000
+    resetTask(TASK_SERIAL, 0);      // due at 10000
+
+    setTaskEnabled(TASK_SYSTEM, true);
+    setTaskEnabled(TASK_ACCEL, true);
+    setTaskEnabled(TASK_SERIAL, true);
+    setTaskEnabled(TASK_GYROPID, true);
+    setTaskEnabled(TASK_RX, true);
+
+    // event driven tasks are not put in the heap
+    EXPECT_EQ(4, taskHeapSize);
+    EXPECT_EQ(1, eventTaskCount);
+    EXPECT_EQ(&cfTasks[TASK_GYROPID], taskHeap[0].task);
+    EXPECT_EQ(1500u, taskHeap[0].deadline);
+
+    // rescheduling moves the task within the heap
+    rescheduleTask(TASK_SYSTEM, 1000);
+    EXPECT_EQ(&cfTasks[TASK_SYSTEM], taskHeap[0].task);
+    EXPECT_EQ(1000u, taskHeap[0].deadline);
+
+    setTaskEnabled(TASK_SYSTEM, false);
+    EXPECT_EQ(3, taskHeapSize);
+    EXPECT_EQ(&cfTasks[TASK_GYROPID], taskHeap[0].task);
+
+    setTaskEnabled(TASK_GYROPID, false);
+    EXPECT_EQ(2, taskHeapSize);
+    EXPECT_EQ(10000u, taskHeap[0].deadline);
+
+    rescheduleTask(TASK_SYSTEM, TASK_PERIOD_HZ(10));
+}
+
+TEST(SchedulerDeadlineQueueUnittest, TestSingleTask)
+{
+    queueClear();
+    resetTask(TASK_GYROPID, 1000);
+    setTaskEnabled(TASK_GYROPID, true);
+    simulatedTime = 1500;
+    scheduler();
+    EXPECT_EQ(static_cast<cfTask_t*>(0), unittest_scheduler_selectedTask);
+    EXPECT_EQ(0, unittest_scheduler_waitingTasks);
+
+    simulatedTime = 4000;
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_GYROPID], unittest_scheduler_selectedTask);
+    EXPECT_EQ(3000, cfTasks[TASK_GYROPID].taskLatestDeltaTime);
+    EXPECT_EQ(4000u, cfTasks[TASK_GYROPID].lastExecutedAt);
+    EXPECT_EQ(0, cfTasks[TASK_GYROPID].dynamicPriority);
+    // deadline moves on after execution
+    EXPECT_EQ(5000u, taskHeap[0].deadline);
+}
+
+TEST(SchedulerDeadlineQueueUnittest, TestTwoTasks)
+{
+    queueClear();
+    static const uint32_t startTime = 4000;
+    simulatedTime = startTime;
+    resetTask(TASK_GYROPID, simulatedTime);
+    resetTask(TASK_ACCEL, simulatedTime - TEST_UPDATE_ACCEL_TIME);
+    setTaskEnabled(TASK_ACCEL, true);
+    setTaskEnabled(TASK_GYROPID, true);
+
+    scheduler();
+    EXPECT_EQ(static_cast<cfTask_t*>(0), unittest_scheduler_selectedTask);
+
+    simulatedTime += 1000;
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_GYROPID], unittest_scheduler_selectedTask);
+    EXPECT_EQ(1, unittest_scheduler_waitingTasks);
+
+    simulatedTime = startTime + 10500; // TASK_GYROPID and TASK_ACCEL desiredPeriods have elapsed
+    // of the two TASK_GYROPID should run first
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_GYROPID], unittest_scheduler_selectedTask);
+    EXPECT_EQ(2, unittest_scheduler_waitingTasks);
+    // and finally TASK_ACCEL should now run
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_ACCEL], unittest_scheduler_selectedTask);
+}
+
+TEST(SchedulerDeadlineQueueUnittest, TestEqualDynamicPriority)
+{
+    queueClear();
+    simulatedTime = 50000;
+    resetTask(TASK_GYROPID, simulatedTime - 1000);  // age 1, dynamic priority 7
+    resetTask(TASK_ACCEL, simulatedTime - 20000);   // age 2, dynamic priority 7
+    setTaskEnabled(TASK_ACCEL, true);
+    setTaskEnabled(TASK_GYROPID, true);
+
+    // same dynamic priority, the task with the higher static priority is chosen like in the linear queue
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_GYROPID], unittest_scheduler_selectedTask);
+    EXPECT_EQ(2, unittest_scheduler_waitingTasks);
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_ACCEL], unittest_scheduler_selectedTask);
+}
+
+TEST(SchedulerDeadlineQueueUnittest, TestEventTask)
+{
+    queueClear();
+    simulatedTime = 100000;
+    resetTask(TASK_RX, simulatedTime);
+    resetTask(TASK_SERIAL, simulatedTime);
+    setTaskEnabled(TASK_RX, true);
+    setTaskEnabled(TASK_SERIAL, true);
+
+    rxFrameReady = false;
+    rxUpdateCheckCount = 0;
+    scheduler();
+    EXPECT_EQ(static_cast<cfTask_t*>(0), unittest_scheduler_selectedTask);
+    EXPECT_EQ(1, rxUpdateCheckCount);
+    EXPECT_EQ(0u, eventTaskSignalledMask);
+
+    // make TASK_SERIAL overdue, it has a higher dynamic priority than the freshly signalled TASK_RX
+    simulatedTime += 6 * TASK_PERIOD_HZ(100);
+    rxFrameReady = true;
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_SERIAL], unittest_scheduler_selectedTask);
+    EXPECT_EQ(2, unittest_scheduler_waitingTasks);
+    EXPECT_EQ(2, rxUpdateCheckCount);
+    EXPECT_EQ(1u, eventTaskSignalledMask);
+
+    // TASK_RX is signalled, so its checkFunc is not polled again
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_RX], unittest_scheduler_selectedTask);
+    EXPECT_EQ(2, rxUpdateCheckCount);
+    EXPECT_EQ(0u, eventTaskSignalledMask);
+
+    scheduler();
+    EXPECT_EQ(static_cast<cfTask_t*>(0), unittest_scheduler_selectedTask);
+    EXPECT_EQ(3, rxUpdateCheckCount);
+}
+
+TEST(SchedulerDeadlineQueueUnittest, TestTaskDisablesItself)
+{
+    queueClear();
+    simulatedTime = 200000;
+    resetTask(TASK_GYROPID, simulatedTime);
+    resetTask(TASK_SERIAL, simulatedTime - TASK_PERIOD_HZ(100));
+    setTaskEnabled(TASK_GYROPID, true);
+    setTaskEnabled(TASK_SERIAL, true);
+
+    disableSerialWhenRun = true;
+    scheduler();
+    disableSerialWhenRun = false;
+    EXPECT_EQ(&cfTasks[TASK_SERIAL], unittest_scheduler_selectedTask);
+    EXPECT_EQ(1, taskHeapSize);
+    EXPECT_EQ(&cfTasks[TASK_GYROPID], taskHeap[0].task);
+
+    simulatedTime += 1000;
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_GYROPID], unittest_scheduler_selectedTask);
+
+    disableAllTasks();
+    EXPECT_EQ(0, taskHeapSize);
+    EXPECT_EQ(0, eventTaskCount);
+}
+
+TEST(SchedulerDeadlineQueueUnittest, TestTaskStatisticsHistogram)
+{
+    queueClear();
+    schedulerSetCalulateTaskStatistics(true);
+    schedulerResetTaskStatistics(TASK_GYROPID);
+    schedulerResetTaskStatistics(TASK_ACCEL);
+    simulatedTime = 300000;
+    resetTask(TASK_GYROPID, simulatedTime - 1000);
+    resetTask(TASK_ACCEL, simulatedTime - 10000);
+    setTaskEnabled(TASK_GYROPID, true);
+    setTaskEnabled(TASK_ACCEL, true);
+
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_GYROPID], unittest_scheduler_selectedTask);
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_ACCEL], unittest_scheduler_selectedTask);
+
+    cfTaskInfo_t taskInfo;
+    getTaskInfo(TASK_GYROPID, &taskInfo);
+    EXPECT_EQ(1, taskInfo.executionTimeHistogram[9]);  // 650us is in [512, 1024)
+    EXPECT_EQ(0u, taskInfo.lateCount);
+    getTaskInfo(TASK_ACCEL, &taskInfo);
+    EXPECT_EQ(1, taskInfo.executionTimeHistogram[7]);  // 192us is in [128, 256)
+
+    // a gap of more than two periods means TASK_GYROPID started more than one period late
+    simulatedTime += 2500;
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_GYROPID], unittest_scheduler_selectedTask);
+    getTaskInfo(TASK_GYROPID, &taskInfo);
+    EXPECT_EQ(2, taskInfo.executionTimeHistogram[9]);
+    EXPECT_EQ(1u, taskInfo.lateCount);
+
+    schedulerResetTaskStatistics(TASK_GYROPID);
+    getTaskInfo(TASK_GYROPID, &taskInfo);
+    EXPECT_EQ(0, taskInfo.executionTimeHistogram[9]);
+    EXPECT_EQ(0u, taskInfo.lateCount);
+
+    disableAllTasks();
+}
+
+TEST(SchedulerDeadlineQueueUnittest, TestTimeRemaining)
+{
+    queueClear();
+    simulatedTime = 400000;
+    resetTask(TASK_SERIAL, simulatedTime - TASK_PERIOD_HZ(100));
+    setTaskEnabled(TASK_SERIAL, true);
+
+    // no realtime task, so no limit
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_SERIAL], unittest_scheduler_selectedTask);
+    EXPECT_EQ(SCHEDULER_TIME_REMAINING_UNLIMITED, serialTimeRemaining);
+
+    // TASK_GYROPID is due 700us from now
+    simulatedTime += TASK_PERIOD_HZ(100);
+    resetTask(TASK_GYROPID, simulatedTime - 300);
+    setTaskEnabled(TASK_GYROPID, true);
+    scheduler();
+    EXPECT_EQ(&cfTasks[TASK_SERIAL], unittest_scheduler_selectedTask);
+    EXPECT_EQ(700, serialTimeRemaining);
+    EXPECT_FALSE(schedulerTaskShouldYield(600));
+    EXPECT_TRUE(schedulerTaskShouldYield(700));
+
+    disableAllTasks();
+}
+
+TEST(SchedulerDeadlineQueueUnittest, TestSignalledTask)
+{
+    queueClear();
+    simulatedTime = 500000;
+    resetTask(TASK_RX, simulatedTime);
+    setTaskEnabled(TASK_RX, true);
+    schedulerSetTaskSignalled(TASK_RX, 5000);
+
+    // the first pass always polls
+    rxFrameReady = false;
+    rxUpdateCheckCount = 0;
+    scheduler();
+    EXPECT_EQ(1, rxUpdateCheckCount);
+
+    // no signal, checkFunc is not polled until the poll period has expired
+    simulatedTime += 1000;
+    scheduler();
+    EXPECT_EQ(1, rxUpdateCheckCount);
+
+    // signalled, checkFunc is polled right away and the task runs
+    schedulerSignalTask(TASK_RX);
+    rxFrameReady = true;
+    scheduler();
+    EXPECT_EQ(2, rxUpdateCheckCount);
+    EXPECT_EQ(&cfTasks[TASK_RX], unittest_scheduler_selectedTask);
+
+    simulatedTime += 1000;
+    scheduler();
+    EXPECT_EQ(2, rxUpdateCheckCount);
+
+    // fallback poll
+    simulatedTime += 5000;
+    scheduler();
+    EXPECT_EQ(3, rxUpdateCheckCount);
+
+    schedulerSetTaskSignalled(TASK_RX, 0);
+    disableAllTasks();
+}
@@ -44,6 +44,7 @@ extern "C" {
     struct gyroSensor_s;
     STATIC_UNIT_TESTED void performGyroCalibration(struct gyroSensor_s *gyroSensor, uint8_t gyroMovementCalibrationThreshold);
     STATIC_UNIT_TESTED bool fakeGyroRead(gyroDev_t *gyro);
+    STATIC_UNIT_TESTED bool gyroBiasTableLookup(const gyroBiasTable_t *table, int16_t temperature, float *bias);
 
     uint8_t debugMode;
     int16_t debug[DEBUG16_VALUE_COUNT];
@@ -150,6 +151,162 @@ TEST(SensorGyro, Update)
     EXPECT_FLOAT_EQ(90 * gyroDevPtr->scale, gyro.gyroADCf[Z]);
 }
 
+TEST(SensorGyro, BiasTableLookup)
+{
+    gyroBiasTable_t table;
+    memset(&table, 0, sizeof(table));
+    float bias[XYZ_AXIS_COUNT];
+    EXPECT_EQ(false, gyroBiasTableLookup(&table, 27, bias));
+
+    // bins 6 and 7 cover 20 to 25 and 25 to 30 degrees
+    table.validMask = (1 << 6) | (1 << 7);
+    table.bias[6][X] = 50;
+    table.bias[6][Y] = 60;
+    table.bias[6][Z] = 70;
+    table.bias[7][X] = 70;
+    table.bias[7][Y] = 80;
+    table.bias[7][Z] = 90;
+    EXPECT_EQ(true, gyroBiasTableLookup(&table, 27, bias));
+    // half a degree from the centre of bin 7, a tenth of the way towards bin 6
+    EXPECT_FLOAT_EQ(6.8f, bias[X]);
+    EXPECT_FLOAT_EQ(7.8f, bias[Y]);
+    EXPECT_FLOAT_EQ(8.8f, bias[Z]);
+
+    // no neighbour above bin 7, so its own value is used
+    EXPECT_EQ(true, gyroBiasTableLookup(&table, 29, bias));
+    EXPECT_FLOAT_EQ(7.0f, bias[X]);
+
+    EXPECT_EQ(false, gyroBiasTableLookup(&table, 31, bias));
+    EXPECT_EQ(false, gyroBiasTableLookup(&table, -40, bias));
+    EXPECT_EQ(false, gyroBiasTableLookup(&table, 120, bias));
+}
+
+TEST(SensorGyro, CalibrateQuickWithBiasTable)
+{
+    pgResetAll();
+    gyroInit();
+    // the fake gyro reads 25 degrees, bin 7
+    gyroDevPtr->temperature = 25;
+    gyroBiasTableMutable()->validMask = 1 << 7;
+    gyroBiasTableMutable()->bias[7][X] = 52;
+    gyroBiasTableMutable()->bias[7][Y] = 61;
+    gyroBiasTableMutable()->bias[7][Z] = 69;
+
+    static const int gyroMovementCalibrationThreshold = 32;
+    gyroStartCalibration(false);
+    int cycles = 0;
+    while (!isGyroCalibrationComplete()) {
+        fakeGyroSet(gyroDevPtr, 5, 6, 7);
+        gyroDevPtr->readFn(gyroDevPtr);
+        performGyroCalibration(gyroSensorPtr, gyroMovementCalibrationThreshold);
+        cycles++;
+    }
+    // the short calibration agrees with the table, so the table value is used
+    EXPECT_EQ(true, cycles < 1000);
+    EXPECT_FLOAT_EQ(5.2f, gyroDevPtr->gyroZero[X]);
+    EXPECT_FLOAT_EQ(6.1f, gyroDevPtr->gyroZero[Y]);
+    EXPECT_FLOAT_EQ(6.9f, gyroDevPtr->gyroZero[Z]);
+}
+
+static bool fakeGyroReadFifo(gyroDev_t *gyro)
+{
+    // three samples, rising by 10 each time
+    for (int i = 0; i < 3; i++) {
+        gyro->fifoADCRaw[i][X] = 15 + 10 * i;
+        gyro->fifoADCRaw[i][Y] = 26 + 10 * i;
+        gyro->fifoADCRaw[i][Z] = 97 + 10 * i;
+    }
+    gyro->fifoSampleCount = 3;
+    gyro->gyroADCRaw[X] = gyro->fifoADCRaw[2][X];
+    gyro->gyroADCRaw[Y] = gyro->fifoADCRaw[2][Y];
+    gyro->gyroADCRaw[Z] = gyro->fifoADCRaw[2][Z];
+    return true;
+}
+
+TEST(SensorGyro, UpdateFifo)
+{
+    pgResetAll();
+    // turn off filters
+    gyroConfigMutable()->gyro_lowpass_hz = 0;
+    gyroConfigMutable()->gyro_lowpass2_hz = 0;
+    gyroConfigMutable()->gyro_soft_notch_hz_1 = 0;
+    gyroConfigMutable()->gyro_soft_notch_hz_2 = 0;
+    gyroInit();
+    gyroDevPtr->readFn = fakeGyroRead;
+    gyroStartCalibration(false);
+
+    timeUs_t currentTimeUs = 0;
+    while (!isGyroCalibrationComplete()) {
+        fakeGyroSet(gyroDevPtr, 5, 6, 7);
+        gyroUpdate(currentTimeUs);
+    }
+    // zero output and accumulation before the FIFO read
+    fakeGyroSet(gyroDevPtr, 5, 6, 7);
+    gyroUpdate(currentTimeUs);
+    float accumulated[XYZ_AXIS_COUNT];
+    gyroGetAccumulationAverage(accumulated);
+
+    gyroDevPtr->readFn = fakeGyroReadFifo;
+    gyroDevPtr->fifoEnabled = true;
+    currentTimeUs += 300;
+    gyroUpdate(currentTimeUs);
+    // the output is the latest sample, with gyroADCRaw left at the latest sample too
+    EXPECT_EQ(35, gyroDevPtr->gyroADCRaw[X]);
+    EXPECT_FLOAT_EQ(30 * gyroDevPtr->scale, gyro.gyroADCf[X]);
+    EXPECT_FLOAT_EQ(40 * gyroDevPtr->scale, gyro.gyroADCf[Y]);
+    EXPECT_FLOAT_EQ(110 * gyroDevPtr->scale, gyro.gyroADCf[Z]);
+
+    // every sample is integrated, at a third of the loop interval
+    EXPECT_EQ(true, gyroGetAccumulationAverage(accumulated));
+    const float expected = 0.5f * (0 + 10) + 0.5f * (10 + 20) + 0.5f * (20 + 30);
+    EXPECT_FLOAT_EQ(expected * gyroDevPtr->scale / 3, accumulated[X]);
+    gyroDevPtr->fifoEnabled = false;
+}
+
+TEST(SensorGyro, YawSpinRecovery)
+{
+    pgResetAll();
+    gyroConfigMutable()->gyro_lowpass_hz = 0;
+    gyroConfigMutable()->gyro_lowpass2_hz = 0;
+    gyroConfigMutable()->gyro_soft_notch_hz_1 = 0;
+    gyroConfigMutable()->gyro_soft_notch_hz_2 = 0;
+    gyroConfigMutable()->yaw_spin_threshold = 500;
+    gyroInit();
+    gyroDevPtr->readFn = fakeGyroRead;
+    gyroStartCalibration(false);
+
+    timeUs_t currentTimeUs = 0;
+    while (!isGyroCalibrationComplete()) {
+        fakeGyroSet(gyroDevPtr, 5, 6, 7);
+        gyroUpdate(currentTimeUs);
+    }
+    EXPECT_FALSE(gyroYawSpinDetected());
+
+    // the fake gyro scale is 1dps, the spin is detected on the sample that crosses the threshold
+    fakeGyroSet(gyroDevPtr, 5, 6, 7 + 450);
+    gyroUpdate(currentTimeUs);
+    EXPECT_FALSE(gyroYawSpinDetected());
+    fakeGyroSet(gyroDevPtr, 5, 6, 7 - 550);
+    gyroUpdate(currentTimeUs);
+    EXPECT_TRUE(gyroYawSpinDetected());
+
+    // between the reset and trigger thresholds keeps the spin
+    currentTimeUs += 30000;
+    fakeGyroSet(gyroDevPtr, 5, 6, 7 + 450);
+    gyroUpdate(currentTimeUs);
+    EXPECT_TRUE(gyroYawSpinDetected());
+
+    // it is cleared after 20ms below the reset threshold
+    fakeGyroSet(gyroDevPtr, 5, 6, 7);
+    currentTimeUs += 10000;
+    gyroUpdate(currentTimeUs);
+    EXPECT_TRUE(gyroYawSpinDetected());
+    currentTimeUs += 15000;
+    fakeGyroSet(gyroDevPtr, 5, 6, 7);
+    gyroUpdate(currentTimeUs);
+    EXPECT_FALSE(gyroYawSpinDetected());
+}
+
 // STUBS
 
 extern "C" {
@@ -161,4 +318,6 @@ timeDelta_t getGyroUpdateRate(void) {return gyro.targetLooptime;}
 void sensorsSet(uint32_t) {}
 void schedulerResetTaskStatistics(cfTaskId_e) {}
 int getArmingDisableFlags(void) {return 0;}
+uint8_t armingFlags = 0;
+void writeEEPROM(void) {}
 }
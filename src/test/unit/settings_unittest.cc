@@ -0,0 +1,83 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/utils.h"
+
+    #include "interface/settings.h"
+
+    #include "sensors/current.h"
+    #include "sensors/voltage.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(SettingsTest, PrefixedNamesAreRestored)
+{
+    char name[SETTING_MAX_NAME_LENGTH];
+
+    const clivalue_t *value = findValueByName("gyro_lowpass_hz", strlen("gyro_lowpass_hz"));
+    ASSERT_NE(nullptr, value);
+    settingGetName(value, name);
+    EXPECT_STREQ("gyro_lowpass_hz", name);
+
+    // the longest matching prefix is the token
+    value = findValueByName("GPS_RESCUE_ANGLE", strlen("GPS_RESCUE_ANGLE"));
+    ASSERT_NE(nullptr, value);
+    settingGetName(value, name);
+    EXPECT_STREQ("gps_rescue_angle", name);
+
+    // names without a common prefix are stored whole
+    value = findValueByName("mid_rc", strlen("mid_rc"));
+    ASSERT_NE(nullptr, value);
+    settingGetName(value, name);
+    EXPECT_STREQ("mid_rc", name);
+}
+
+TEST(SettingsTest, FindMatchesWholeName)
+{
+    EXPECT_EQ(nullptr, findValueByName("gyro_", strlen("gyro_")));
+    EXPECT_EQ(nullptr, findValueByName("gyro_lowpass_hzz", strlen("gyro_lowpass_hzz")));
+    EXPECT_NE(nullptr, findValueByName("gyro_lowpass_hz = 100", strlen("gyro_lowpass_hz")));
+}
+
+TEST(SettingsTest, AllNamesAreFoundAndUnique)
+{
+    for (unsigned i = 0; i < valueTableEntryCount; i++) {
+        char name[SETTING_MAX_NAME_LENGTH];
+        settingGetName(&valueTable[i], name);
+        EXPECT_LT(strlen(name), (size_t)SETTING_MAX_NAME_LENGTH - 1) << name;
+        EXPECT_GT(name[0], ' ') << i;
+        EXPECT_EQ(&valueTable[i], findValueByName(name, strlen(name))) << name;
+    }
+}
+
+// STUBS
+
+extern "C" {
+const char * const currentMeterSourceNames[] = { "NONE" };
+const char * const voltageMeterSourceNames[] = { "NONE" };
+const char * const debugModeNames[] = { "NONE" };
+}
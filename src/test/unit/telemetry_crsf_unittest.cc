@@ -53,6 +53,8 @@ extern "C" {
     #include "rx/rx.h"
     #include "rx/crsf.h"
 
+    #include "scheduler/scheduler.h"
+
     #include "sensors/battery.h"
     #include "sensors/sensors.h"
     #include "sensors/acceleration.h"
@@ -68,6 +70,8 @@ extern "C" {
     int32_t testmAhDrawn = 0;
 
     serialPort_t *telemetrySharedPort;
+    STATIC_UNIT_TESTED int crsfScheduleNextFrame(timeUs_t currentTimeUs);
+    extern attitudeEulerAngles_t attitude;
     PG_REGISTER(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 0);
     PG_REGISTER(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 0);
     PG_REGISTER(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 0);
@@ -273,6 +277,30 @@ TEST(TelemetryCrsfTest, TestFlightMode)
     EXPECT_EQ(crfsCrc(frame, frameLen), frame[7]);
 }
 
+TEST(TelemetryCrsfTest, TestSchedule)
+{
+    sensorsSet(SENSOR_ACC);
+    initCrsfTelemetry();
+
+    // frame indexes are attitude, battery, flight mode and GPS
+    int sent[4] = { 0, 0, 0, 0 };
+    for (int slot = 0; slot < 40; slot++) {
+        const int frame = crsfScheduleNextFrame(slot * 25000);
+        ASSERT_GE(frame, 0);
+        ASSERT_LT(frame, 4);
+        sent[frame]++;
+        if (slot < 4) {
+            // all frames are due at the start, in order
+            EXPECT_EQ(slot, frame);
+        }
+    }
+    // one second of slots, each frame at least at its own rate and the spare slots to attitude
+    EXPECT_EQ(29, sent[0]);
+    EXPECT_EQ(2, sent[1]);
+    EXPECT_EQ(4, sent[2]);
+    EXPECT_EQ(5, sent[3]);
+}
+
 // STUBS
 
 extern "C" {
@@ -285,6 +313,7 @@ uint16_t batteryWarningVoltage;
 uint8_t useHottAlarmSoundPeriod (void) { return 0; }
 
 attitudeEulerAngles_t attitude = { { 0, 0, 0 } };     // absolute angle inclination in multiple of 0.1 degree    180 deg = 1800
+const attitudeEulerAngles_t *getAttitude(void) { return &attitude; }
 
 uint16_t GPS_distanceToHome;        // distance to home point in meters
 gpsSolutionData_t gpsSol;
@@ -339,5 +368,6 @@ bool handleMspFrame(uint8_t *, int)  { return false; }
 void crsfScheduleMspResponse(void) {};
 bool isBatteryVoltageConfigured(void) { return true; }
 bool isAmperageConfigured(void) { return true; }
+void schedulerSignalTask(cfTaskId_e) {}
 
 }
@@ -207,10 +207,21 @@ uint8_t serialRead(serialPort_t *instance)
     return 0;
 }
 
-void serialWrite(serialPort_t *instance, uint8_t ch)
+bool serialTxPacedStart(serialPort_t *port, const uint8_t *data, uint8_t length, uint8_t intervalMs)
 {
-    UNUSED(instance);
-    UNUSED(ch);
+    UNUSED(port);
+    UNUSED(data);
+    UNUSED(length);
+    UNUSED(intervalMs);
+
+    return true;
+}
+
+void serialTxPacedStop(void) {}
+
+bool serialTxPacedIsBusy(void)
+{
+    return false;
 }
 
 void serialSetMode(serialPort_t *instance, portMode_e mode)
@@ -51,6 +51,7 @@ extern "C" {
     telemetryConfig_t telemetryConfig_System;
     batteryConfig_s batteryConfig_System;
     attitudeEulerAngles_t attitude = EULER_INITIALIZE;
+    const attitudeEulerAngles_t *getAttitude(void) { return &attitude; }
     acc_t acc;
     baro_t baro;
     gpsSolutionData_t gpsSol;
@@ -238,6 +239,13 @@ void serialWrite(serialPort_t *instance, uint8_t ch)
     //printf("w: %02d 0x%02x\n", serialWriteStub.pos, ch);
 }
 
+void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+{
+    while (count--) {
+        serialWrite(instance, *data++);
+    }
+}
+
 
 uint32_t serialRxBytesWaiting(const serialPort_t *instance)
 {
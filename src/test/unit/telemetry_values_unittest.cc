@@ -0,0 +1,141 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "fc/runtime_config.h"
+
+    #include "flight/imu.h"
+
+    #include "io/gps.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/sensors.h"
+
+    #include "telemetry/telemetry_values.h"
+
+    uint16_t testBatteryVoltage = 0;
+    int32_t testAmperage = 0;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(TelemetryValuesTest, ValuesAreConverted)
+{
+    testBatteryVoltage = 168;
+    acc.dev.acc_1G = 512;
+    acc.accADC[Z] = 1024;
+    telemetryValuesUpdate(1000);
+
+    EXPECT_EQ(168, telemetryValue(TELEMETRY_VALUE_VOLTAGE));
+    // four cells in 0.01V
+    EXPECT_EQ(420, telemetryValue(TELEMETRY_VALUE_CELL_VOLTAGE));
+    EXPECT_EQ(200, telemetryValue(TELEMETRY_VALUE_ACC_Z));
+
+    // refreshed at most every 10ms
+    testBatteryVoltage = 160;
+    telemetryValuesUpdate(1005);
+    EXPECT_EQ(168, telemetryValue(TELEMETRY_VALUE_VOLTAGE));
+    telemetryValuesUpdate(1010);
+    EXPECT_EQ(160, telemetryValue(TELEMETRY_VALUE_VOLTAGE));
+}
+
+TEST(TelemetryValuesTest, InvalidValuesAreNotSelected)
+{
+    DISABLE_STATE(GPS_FIX);
+    telemetryValuesUpdate(2000);
+    EXPECT_FALSE(telemetryValueIsValid(TELEMETRY_VALUE_GPS_SPEED));
+
+    telemetrySlot_t slots[1];
+    telemetrySlotInit(&slots[0], TELEMETRY_VALUE_GPS_SPEED, 1);
+    EXPECT_EQ(-1, telemetrySlotSelect(slots, 1, 2000));
+
+    ENABLE_STATE(GPS_FIX);
+    telemetryValuesUpdate(2010);
+    EXPECT_EQ(0, telemetrySlotSelect(slots, 1, 2010));
+}
+
+TEST(TelemetryValuesTest, ChangedValuesAreSentFirst)
+{
+    testBatteryVoltage = 168;
+    testAmperage = 1000;
+    telemetryValuesUpdate(3000);
+
+    telemetrySlot_t slots[2];
+    telemetrySlotInit(&slots[0], TELEMETRY_VALUE_VOLTAGE, 1);
+    telemetrySlotInit(&slots[1], TELEMETRY_VALUE_CURRENT, 1);
+    // both sent in turn
+    EXPECT_EQ(0, telemetrySlotSelect(slots, 2, 3000));
+    EXPECT_EQ(1, telemetrySlotSelect(slots, 2, 3000));
+
+    // the current changes, the voltage stays within its deadband
+    testAmperage = 2000;
+    telemetryValuesUpdate(3100);
+    EXPECT_EQ(1, telemetrySlotSelect(slots, 2, 3100));
+
+    // the unchanged voltage is sent once it is stale enough
+    EXPECT_EQ(0, telemetrySlotSelect(slots, 2, 3200));
+}
+
+TEST(TelemetryValuesTest, PriorityWeightsStaleness)
+{
+    telemetrySlot_t slots[2];
+    telemetrySlotInit(&slots[0], TELEMETRY_VALUE_NONE, 1);
+    telemetrySlotInit(&slots[1], TELEMETRY_VALUE_NONE, 3);
+
+    int sent[2] = { 0, 0 };
+    for (int i = 0; i < 400; i++) {
+        const int slot = telemetrySlotSelect(slots, 2, 4000 + i * 10);
+        ASSERT_GE(slot, 0);
+        sent[slot]++;
+    }
+    EXPECT_EQ(100, sent[0]);
+    EXPECT_EQ(300, sent[1]);
+}
+
+// STUBS
+
+extern "C" {
+
+uint8_t stateFlags;
+acc_t acc;
+gpsSolutionData_t gpsSol;
+uint16_t GPS_distanceToHome;
+static attitudeEulerAngles_t testAttitude;
+
+bool isBatteryVoltageConfigured(void) { return true; }
+uint16_t getBatteryVoltage(void) { return testBatteryVoltage; }
+uint8_t getBatteryCellCount(void) { return 4; }
+uint8_t calculateBatteryPercentageRemaining(void) { return 67; }
+bool isAmperageConfigured(void) { return true; }
+int32_t getAmperage(void) { return testAmperage; }
+int32_t getMAhDrawn(void) { return 0; }
+int32_t getEstimatedAltitude(void) { return 0; }
+int16_t getEstimatedVario(void) { return 0; }
+const attitudeEulerAngles_t *getAttitude(void) { return &testAttitude; }
+
+bool sensors(uint32_t mask) { return mask == SENSOR_ACC || mask == SENSOR_GPS; }
+
+}
@@ -0,0 +1,92 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "flight/thrust_curve.h"
+
+    #include "pg/pg.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(ThrustCurveUnittest, TestDisabled)
+{
+    pgResetAll();
+    thrustCurveInit(1070, 2000);
+
+    EXPECT_FLOAT_EQ(1500, thrustCurveApply(1500));
+    EXPECT_FLOAT_EQ(1500, thrustCurveInverse(1500));
+}
+
+TEST(ThrustCurveUnittest, TestApply)
+{
+    pgResetAll();
+    thrustCurveConfigMutable()->thrust_curve_points = 3;
+    thrustCurveConfigMutable()->thrust_curve[0] = 0;
+    thrustCurveConfigMutable()->thrust_curve[1] = 70;
+    thrustCurveConfigMutable()->thrust_curve[2] = 100;
+    thrustCurveInit(1000, 2000);
+
+    // the end points and the points in between are exact, between them the curve is linear
+    EXPECT_FLOAT_EQ(1000, thrustCurveApply(1000));
+    EXPECT_FLOAT_EQ(1700, thrustCurveApply(1500));
+    EXPECT_FLOAT_EQ(2000, thrustCurveApply(2000));
+    EXPECT_FLOAT_EQ(1350, thrustCurveApply(1250));
+    EXPECT_FLOAT_EQ(1850, thrustCurveApply(1750));
+
+    // below idle, such as the disarm command, the output is passed through, above full it is held
+    EXPECT_FLOAT_EQ(900, thrustCurveApply(900));
+    EXPECT_FLOAT_EQ(2000, thrustCurveApply(2100));
+}
+
+TEST(ThrustCurveUnittest, TestInverse)
+{
+    pgResetAll();
+    thrustCurveConfigMutable()->thrust_curve_points = 4;
+    thrustCurveConfigMutable()->thrust_curve[0] = 0;
+    thrustCurveConfigMutable()->thrust_curve[1] = 50;
+    thrustCurveConfigMutable()->thrust_curve[2] = 80;
+    thrustCurveConfigMutable()->thrust_curve[3] = 100;
+    thrustCurveInit(48, 2047);
+
+    for (float output = 48; output <= 2047; output += 37) {
+        EXPECT_NEAR(output, thrustCurveInverse(thrustCurveApply(output)), 0.01f);
+    }
+}
+
+TEST(ThrustCurveUnittest, TestMonotonic)
+{
+    pgResetAll();
+    thrustCurveConfigMutable()->thrust_curve_points = 3;
+    thrustCurveConfigMutable()->thrust_curve[0] = 0;
+    thrustCurveConfigMutable()->thrust_curve[1] = 60;
+    thrustCurveConfigMutable()->thrust_curve[2] = 40;
+    thrustCurveInit(1000, 2000);
+
+    // a point below the one before it is raised to it
+    EXPECT_FLOAT_EQ(1600, thrustCurveApply(1500));
+    EXPECT_FLOAT_EQ(1600, thrustCurveApply(2000));
+}
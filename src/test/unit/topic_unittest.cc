@@ -0,0 +1,120 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/topic.h"
+
+    typedef struct testValue_s {
+        uint32_t a;
+        uint32_t b;
+    } testValue_t;
+
+    TOPIC_DECLARE(test, testValue_t);
+
+    static testValue_t testTopicValue;
+    topic_t testTopic = { 0, 0, sizeof(testValue_t), &testTopicValue };
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static void resetTopic(void)
+{
+    testTopic.sequence = 0;
+    testTopic.timestamp = 0;
+    memset(&testTopicValue, 0, sizeof(testTopicValue));
+}
+
+TEST(TopicTest, NothingPublished)
+{
+    resetTopic();
+    topicSubscriber_t subscriber = {};
+    testValue_t value = { 7, 7 };
+
+    EXPECT_FALSE(testHasNew(&subscriber));
+    EXPECT_EQ(TOPIC_READ_NONE, testRead(&value, &subscriber));
+    EXPECT_EQ(7, value.a);
+}
+
+TEST(TopicTest, SnapshotIsNewOnce)
+{
+    resetTopic();
+    topicSubscriber_t subscriber = {};
+    const testValue_t published = { 1, 2 };
+    testPublish(&published, 1000);
+
+    EXPECT_TRUE(testHasNew(&subscriber));
+    EXPECT_EQ(1, topicPublishCount(&testTopic));
+
+    testValue_t value = {};
+    EXPECT_EQ(TOPIC_READ_NEW, testRead(&value, &subscriber));
+    EXPECT_EQ(1, value.a);
+    EXPECT_EQ(2, value.b);
+    EXPECT_EQ(1000, subscriber.timestamp);
+
+    EXPECT_FALSE(testHasNew(&subscriber));
+    EXPECT_EQ(TOPIC_READ_UNCHANGED, testRead(&value, &subscriber));
+
+    const testValue_t next = { 3, 4 };
+    testPublish(&next, 2000);
+    EXPECT_EQ(TOPIC_READ_NEW, testRead(&value, &subscriber));
+    EXPECT_EQ(3, value.a);
+    EXPECT_EQ(2000, subscriber.timestamp);
+}
+
+TEST(TopicTest, SubscribersAreIndependent)
+{
+    resetTopic();
+    topicSubscriber_t first = {};
+    topicSubscriber_t second = {};
+    const testValue_t published = { 5, 6 };
+    testPublish(&published, 10);
+
+    testValue_t value;
+    EXPECT_EQ(TOPIC_READ_NEW, testRead(&value, &first));
+    EXPECT_TRUE(testHasNew(&second));
+    EXPECT_EQ(TOPIC_READ_NEW, testRead(&value, &second));
+    EXPECT_EQ(TOPIC_READ_UNCHANGED, testRead(&value, &first));
+}
+
+TEST(TopicTest, ReadDuringPublishIsBusy)
+{
+    resetTopic();
+    topicSubscriber_t subscriber = {};
+    const testValue_t published = { 1, 2 };
+    testPublish(&published, 10);
+
+    // an interrupt reading while the publish of the next value is half way
+    testTopic.sequence++;
+    testTopicValue.a = 3;
+
+    testValue_t value = { 9, 9 };
+    EXPECT_TRUE(testHasNew(&subscriber));
+    EXPECT_EQ(TOPIC_READ_BUSY, testRead(&value, &subscriber));
+    EXPECT_EQ(9, value.a);
+    EXPECT_EQ(0, subscriber.sequence);
+
+    testTopic.sequence++;
+    EXPECT_EQ(TOPIC_READ_NEW, testRead(&value, &subscriber));
+    EXPECT_EQ(3, value.a);
+    EXPECT_EQ(2, value.b);
+}
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <string.h>
+#include <stdarg.h>
 
 extern "C" {
     #include "drivers/display.h"
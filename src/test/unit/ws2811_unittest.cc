@@ -100,5 +100,5 @@ void ws2811LedStripHardwareInit(ioTag_t ioTag) {
     UNUSED(ioTag);
 }
 
-void ws2811LedStripDMAEnable(void) {}
+bool ws2811LedStripDMAEnable(void) { return true; }
 }
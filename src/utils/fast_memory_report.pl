@@ -0,0 +1,165 @@
+#!/usr/bin/perl
+use warnings;
+use strict;
+
+# This script reports where the FAST_CODE and FAST_RAM symbols landed in a GNU ld map file and how much
+# ITCM, DTCM and CCM is left, and fails when one of the given hot path symbols is not in fast memory.
+#
+# Usage: fast_memory_report.pl <map file> [--code <symbol> ...] [--data <symbol> ...]
+#
+# Hot code is only checked when the target places FAST_CODE in ITCM, hot data only when the target places
+# FAST_RAM in DTCM or CCM, targets without the fast memory keep everything in flash and main RAM by design.
+
+my @fastRegionNames = ('ITCM_RAM', 'DTCM_RAM', 'CCM');
+my %fastSectionKinds = (
+    '.tcm_code' => 'code',
+    '.fastram_data' => 'data',
+    '.fastram_bss' => 'data',
+);
+
+my $mapFile = shift @ARGV or die "Usage: $0 <map file> [--code <symbol> ...] [--data <symbol> ...]\n";
+
+my %hotSymbols = (code => [], data => []);
+my $kind;
+for my $arg (@ARGV) {
+    if ($arg eq '--code' || $arg eq '--data') {
+        $kind = substr($arg, 2);
+    } elsif (defined $kind) {
+        push @{$hotSymbols{$kind}}, $arg;
+    } else {
+        die "Unexpected argument $arg\n";
+    }
+}
+
+open(my $map, '<', $mapFile) or die "Cannot open $mapFile: $!\n";
+
+my %regions;            # name => [origin, length]
+my @regionOrder;
+my %regionUsed;
+my %symbolAddresses;
+my @fastInputSections;  # [output section, object, address, size, [symbols]]
+
+my $inMemoryConfiguration = 0;
+my $inMemoryMap = 0;
+my $outputSection;
+my $pendingName;
+my $inputSection;
+
+while (my $line = <$map>) {
+    chomp $line;
+
+    if ($line =~ /^Memory Configuration/) {
+        $inMemoryConfiguration = 1;
+        next;
+    }
+    if ($line =~ /^Linker script and memory map/) {
+        $inMemoryConfiguration = 0;
+        $inMemoryMap = 1;
+        next;
+    }
+
+    if ($inMemoryConfiguration) {
+        if ($line =~ /^(\w+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)/i) {
+            $regions{$1} = [hex($2), hex($3)];
+            push @regionOrder, $1;
+        }
+        next;
+    }
+    next unless $inMemoryMap;
+
+    # long section names are wrapped, the address and size follow on the next line
+    if (defined $pendingName) {
+        $line = $pendingName . $line;
+        undef $pendingName;
+    }
+    if ($line =~ /^(\s?\.\S+)$/) {
+        $pendingName = $1;
+        next;
+    }
+
+    if ($line =~ /^(\.\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)/i) {
+        # output section
+        $outputSection = $1;
+        undef $inputSection;
+        my ($address, $size) = (hex($2), hex($3));
+        my $region = regionOf($address);
+        $regionUsed{$region} += $size if defined $region && $size;
+    } elsif ($line =~ /^ (\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+)/i) {
+        # input section, sections of the fast memory kinds are tracked with their symbols
+        my ($name, $address, $size, $object) = ($1, hex($2), hex($3), $4);
+        undef $inputSection;
+        (my $baseName = $name) =~ s/^(\.\w+).*/$1/;
+        if ($size && exists $fastSectionKinds{$baseName}) {
+            $inputSection = [$outputSection, $object, $address, $size, []];
+            push @fastInputSections, $inputSection;
+        }
+    } elsif ($line =~ /^\s+0x([0-9a-f]+)\s+([A-Za-z_][\w.\$]*)$/i) {
+        # symbol
+        $symbolAddresses{$2} = hex($1);
+        push @{$inputSection->[4]}, $2 if defined $inputSection;
+    }
+}
+close($map);
+
+sub regionOf {
+    my ($address) = @_;
+    for my $name (@regionOrder) {
+        my ($origin, $length) = @{$regions{$name}};
+        return $name if $name ne '*default*' && $address >= $origin && $address < $origin + $length;
+    }
+    return undef;
+}
+
+my @fastRegions = grep { exists $regions{$_} } @fastRegionNames;
+my %fastRegion = map { $_ => 1 } @fastRegions;
+
+print "Fast memory:\n";
+if (!@fastRegions) {
+    print "  none\n";
+}
+for my $name (@fastRegions) {
+    my $length = $regions{$name}[1];
+    my $used = $regionUsed{$name} // 0;
+    printf "  %-12s %7d of %7d bytes used, %7d free\n", $name, $used, $length, $length - $used;
+}
+
+my %kindPlaced = (code => 0, data => 0);
+for my $kind ('code', 'data') {
+    printf "\n%s symbols:\n", $kind eq 'code' ? 'FAST_CODE' : 'FAST_RAM';
+    my $found = 0;
+    for my $section (@fastInputSections) {
+        my ($output, $object, $address, $size, $symbols) = @$section;
+        (my $baseName = $output) =~ s/^(\.\w+).*/$1/;
+        next unless ($fastSectionKinds{$baseName} // '') eq $kind;
+        my $region = regionOf($address) // 'none';
+        $kindPlaced{$kind} = 1 if $fastRegion{$region};
+        printf "  %-12s 0x%08x %6d  %s\n", $region, $address, $size, $object;
+        printf "      %s\n", $_ for @$symbols;
+        $found = 1;
+    }
+    print "  none\n" unless $found;
+}
+
+my $failed = 0;
+print "\nHot path symbols:\n";
+for my $kind ('code', 'data') {
+    for my $symbol (@{$hotSymbols{$kind}}) {
+        my $address = $symbolAddresses{$symbol};
+        my $region = defined $address ? regionOf($address) // 'none' : 'missing';
+        my $status;
+        if (!$kindPlaced{$kind}) {
+            $status = 'not checked, no fast memory for ' . $kind;
+        } elsif ($fastRegion{$region}) {
+            $status = 'ok';
+        } else {
+            $status = 'NOT IN FAST MEMORY';
+            $failed = 1;
+        }
+        printf "  %-24s %-12s %s\n", $symbol, $region, $status;
+    }
+}
+
+if ($failed) {
+    print "\nHot path symbols fell out of fast memory, check FAST_CODE, FAST_CODE_NOINLINE and FAST_RAM.\n";
+    exit 1;
+}
@@ -0,0 +1,97 @@
+#!/usr/bin/perl
+use warnings;
+use strict;
+
+# This script converts an event trace, see src/main/build/trace.h, into the Chrome trace event JSON that
+# chrome://tracing and ui.perfetto.dev open as a timeline.
+#
+# Usage: trace_to_json.pl [--itm] [--clock-hz <hz>] [--task-names <name,name,...>] <trace file> > trace.json
+#
+# The trace file holds the events as read over MSP2_TRACE, 8 bytes each, or with --itm the raw SWO capture of
+# ITM stimulus port 0. The clock defaults to 168MHz, use the SystemCoreClock reported by MSP2_TRACE. Tasks are
+# named by their cfTaskId_e unless --task-names lists the names in that order.
+
+my @eventTypes = ('TASK_START', 'TASK_END', 'ISR_ENTER', 'ISR_EXIT', 'DMA_START', 'DMA_COMPLETE');
+my @isrNames = ('GYRO_EXTI', 'MOTOR_DMA', 'UART');
+
+my $itm = 0;
+my $clockHz = 168000000;
+my @taskNames;
+my $traceFile;
+
+while (my $arg = shift @ARGV) {
+    if ($arg eq '--itm') {
+        $itm = 1;
+    } elsif ($arg eq '--clock-hz') {
+        $clockHz = shift @ARGV or die "--clock-hz needs a value\n";
+    } elsif ($arg eq '--task-names') {
+        @taskNames = split(/,/, shift @ARGV // '');
+    } elsif (!defined $traceFile) {
+        $traceFile = $arg;
+    } else {
+        die "Unexpected argument $arg\n";
+    }
+}
+die "Usage: $0 [--itm] [--clock-hz <hz>] [--task-names <name,name,...>] <trace file>\n" unless defined $traceFile;
+
+open(my $in, '<:raw', $traceFile) or die "Cannot open $traceFile: $!\n";
+my $data = do { local $/; <$in> };
+close($in);
+
+my @words;
+if ($itm) {
+    # ITM packets, only the 32 bit writes to stimulus port 0 are ours, anything else is skipped by its size
+    my $position = 0;
+    while ($position < length($data)) {
+        my $header = ord(substr($data, $position, 1));
+        my $size = $header & 3;
+        if ($size == 0) {
+            # synchronisation, overflow or timestamp packets, a continuation bit extends them
+            $position++;
+            while (($header & 0x80) && $position < length($data)) {
+                $header = ord(substr($data, $position++, 1));
+            }
+            next;
+        }
+        my $length = $size == 3 ? 4 : $size;
+        last if $position + 1 + $length > length($data);
+        if (($header & 0x04) == 0 && ($header >> 3) == 0 && $length == 4) {
+            push @words, unpack('V', substr($data, $position + 1, 4));
+        }
+        $position += 1 + $length;
+    }
+} else {
+    @words = unpack('V*', $data);
+}
+
+my @events;
+my $lastCycles;
+my $cycleBase = 0;
+for (my $i = 0; $i + 1 < @words; $i += 2) {
+    my ($cycles, $event) = @words[$i, $i + 1];
+    # the cycle counter wraps every few seconds, the events are in order
+    $cycleBase += 2**32 if defined $lastCycles && $cycles < $lastCycles;
+    $lastCycles = $cycles;
+    push @events, [$cycleBase + $cycles, $event & 0xff, ($event >> 8) & 0xff, $event >> 16];
+}
+exit 0 unless @events;
+
+my $firstCycles = $events[0][0];
+my @json;
+for my $event (@events) {
+    my ($cycles, $type, $id, $arg) = @$event;
+    my $ts = sprintf('%.3f', ($cycles - $firstCycles) * 1e6 / $clockHz);
+    my $typeName = $eventTypes[$type] // "TYPE_$type";
+    if ($typeName =~ /^TASK_(START|END)$/) {
+        my $name = $taskNames[$id] // "TASK_$id";
+        push @json, sprintf('{"name":"%s","cat":"task","ph":"%s","ts":%s,"pid":1,"tid":"tasks"}', $name, $1 eq 'START' ? 'B' : 'E', $ts);
+    } elsif ($typeName =~ /^ISR_(ENTER|EXIT)$/) {
+        my $name = ($isrNames[$id] // "ISR_$id") . " $arg";
+        push @json, sprintf('{"name":"%s","cat":"isr","ph":"%s","ts":%s,"pid":1,"tid":"%s"}', $name, $1 eq 'ENTER' ? 'B' : 'E', $ts, $isrNames[$id] // "ISR_$id");
+    } else {
+        my $name = ($isrNames[$id] // "ISR_$id") . " $typeName $arg";
+        push @json, sprintf('{"name":"%s","cat":"dma","ph":"i","s":"t","ts":%s,"pid":1,"tid":"dma"}', $name, $ts);
+    }
+}
+
+print "[\n", join(",\n", @json), "\n]\n";